@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "rz_test.h"
+
+/*
+ * A baseline is a plain text file with one line per successful test:
+ *
+ *   <time elapsed in us>\t<peak rss in KiB>\t<test file>\t<test name>
+ *
+ * The test file is stored relative to the db/ directory so that baselines
+ * can be shared between checkouts.
+ */
+
+// Differences below these are considered noise, whatever the tolerance
+#define PERF_MIN_TIME_DELTA 100000 // us
+#define PERF_MIN_RSS_DELTA  4096 // KiB
+
+static void baseline_kv_free(HtPPKv *kv) {
+	free(kv->key);
+	free(kv->value);
+}
+
+RZ_API RzTestBaseline *rz_test_baseline_new(void) {
+	RzTestBaseline *baseline = RZ_NEW0(RzTestBaseline);
+	if (!baseline) {
+		return NULL;
+	}
+	baseline->entries = ht_pp_new(NULL, baseline_kv_free, NULL);
+	if (!baseline->entries) {
+		free(baseline);
+		return NULL;
+	}
+	return baseline;
+}
+
+RZ_API void rz_test_baseline_free(RzTestBaseline *baseline) {
+	if (!baseline) {
+		return;
+	}
+	ht_pp_free(baseline->entries);
+	free(baseline);
+}
+
+/**
+ * \brief Build the key identifying \p test in a baseline file
+ */
+RZ_API char *rz_test_baseline_key(RzTest *test) {
+	rz_return_val_if_fail(test, NULL);
+	char *name = rz_test_test_name(test);
+	if (!name) {
+		return NULL;
+	}
+	const char *path = test->path;
+	const char *db = strstr(path, "db" RZ_SYS_DIR);
+	while (db) {
+		if (db == path || db[-1] == RZ_SYS_DIR[0]) {
+			path = db + 3;
+		}
+		db = strstr(db + 3, "db" RZ_SYS_DIR);
+	}
+	char *key = rz_str_newf("%s\t%s", path, name);
+	free(name);
+	if (!key) {
+		return NULL;
+	}
+	// keep the key on a single line, the tab between path and name is the only one
+	rz_str_replace_ch(key, '\n', ' ', true);
+	rz_str_replace_ch(key, '\r', ' ', true);
+	char *sep = strchr(key, '\t');
+	rz_str_replace_ch(sep + 1, '\t', ' ', true);
+#if __WINDOWS__
+	rz_str_replace_ch(key, '\\', '/', true);
+#endif
+	return key;
+}
+
+RZ_API bool rz_test_baseline_load(RzTestBaseline *baseline, const char *file) {
+	rz_return_val_if_fail(baseline && file, false);
+	char *content = rz_file_slurp(file, NULL);
+	if (!content) {
+		return false;
+	}
+	bool ret = true;
+	ut64 linenum = 0;
+	char *line = content;
+	while (line && *line) {
+		linenum++;
+		char *next = strchr(line, '\n');
+		if (next) {
+			*next++ = '\0';
+		}
+		rz_str_trim_tail(line);
+		if (!*line || *line == '#') {
+			line = next;
+			continue;
+		}
+		char *end;
+		ut64 time_elapsed = strtoull(line, &end, 10);
+		ut64 peak_rss = 0;
+		bool valid = *end == '\t';
+		if (valid) {
+			peak_rss = strtoull(end + 1, &end, 10);
+			valid = *end == '\t' && strchr(end + 1, '\t');
+		}
+		if (!valid) {
+			eprintf("%s:%" PFMT64u ": Error: Malformed baseline line.\n", file, linenum);
+			ret = false;
+			break;
+		}
+		RzTestPerfEntry *entry = RZ_NEW(RzTestPerfEntry);
+		if (!entry) {
+			ret = false;
+			break;
+		}
+		entry->time_elapsed = time_elapsed;
+		entry->peak_rss = peak_rss;
+		ht_pp_update(baseline->entries, end + 1, entry);
+		line = next;
+	}
+	free(content);
+	return ret;
+}
+
+/**
+ * \brief Write the time and memory of all successful \p results to \p file
+ */
+RZ_API bool rz_test_baseline_save(RzPVector /*<RzTestResultInfo *>*/ *results, const char *file) {
+	rz_return_val_if_fail(results && file, false);
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	void **it;
+	rz_pvector_foreach (results, it) {
+		RzTestResultInfo *result = *it;
+		if (result->result != RZ_TEST_RESULT_OK && result->result != RZ_TEST_RESULT_FIXED) {
+			continue;
+		}
+		char *key = rz_test_baseline_key(result->test);
+		if (!key) {
+			continue;
+		}
+		rz_strbuf_appendf(&sb, "%" PFMT64u "\t%" PFMT64u "\t%s\n", result->time_elapsed, result->peak_rss, key);
+		free(key);
+	}
+	bool ret = rz_file_dump(file, (const ut8 *)rz_strbuf_get(&sb), rz_strbuf_length(&sb), false);
+	rz_strbuf_fini(&sb);
+	return ret;
+}
+
+RZ_API RzTestPerfEntry *rz_test_baseline_get(RzTestBaseline *baseline, RzTest *test) {
+	rz_return_val_if_fail(baseline && test, NULL);
+	char *key = rz_test_baseline_key(test);
+	if (!key) {
+		return NULL;
+	}
+	RzTestPerfEntry *entry = ht_pp_find(baseline->entries, key, NULL);
+	free(key);
+	return entry;
+}
+
+static bool value_regressed(ut64 base, ut64 cur, ut64 tolerance, ut64 min_delta) {
+	if (!base || !cur || cur <= base || cur - base < min_delta) {
+		return false;
+	}
+	return (cur - base) * 100 > base * tolerance;
+}
+
+/**
+ * \brief Compare a result against its baseline entry
+ * \param tolerance allowed growth in percent
+ * \param time set to whether the time elapsed regressed, may be NULL
+ * \param rss set to whether the peak rss regressed, may be NULL
+ * \return true if either of the two regressed
+ */
+RZ_API bool rz_test_perf_regressed(RzTestPerfEntry *base, RzTestResultInfo *result, ut64 tolerance, bool *time, bool *rss) {
+	rz_return_val_if_fail(base && result, false);
+	bool t = value_regressed(base->time_elapsed, result->time_elapsed, tolerance, PERF_MIN_TIME_DELTA);
+	bool r = value_regressed(base->peak_rss, result->peak_rss, tolerance, PERF_MIN_RSS_DELTA);
+	if (time) {
+		*time = t;
+	}
+	if (rss) {
+		*rss = r;
+	}
+	return t || r;
+}
@@ -531,6 +531,13 @@ RZ_API RzTestResultInfo *rz_test_run_test(RzTestRunConfig *config, RzTest *test)
 	}
 	}
 	ret->time_elapsed = rz_time_now_mono() - start_time;
+	if (test->type != RZ_TEST_TYPE_ASM && ret->proc_out) {
+		ret->peak_rss = ret->proc_out->peak_rss;
+	}
+	if (success && test->type == RZ_TEST_TYPE_CMD && !rz_test_check_cmd_budget(test->cmd_test, ret)) {
+		ret->over_budget = true;
+		success = false;
+	}
 	bool broken = rz_test_broken(test);
 #if ASAN
 #if !RZ_ASSERT_STDOUT
@@ -549,6 +556,22 @@ RZ_API RzTestResultInfo *rz_test_run_test(RzTestRunConfig *config, RzTest *test)
 	return ret;
 }
 
+/**
+ * \brief Check the optional MAX_TIME and MAX_RSS budgets of \p test against a finished run
+ * \return false if any of the declared budgets was exceeded
+ */
+RZ_API bool rz_test_check_cmd_budget(RzCmdTest *test, RzTestResultInfo *result) {
+	rz_return_val_if_fail(test && result, false);
+	if (test->max_time.set && result->time_elapsed > test->max_time.value * 1000) {
+		return false;
+	}
+	// peak_rss is 0 where the platform cannot measure it, never fail on that
+	if (test->max_rss.set && result->peak_rss > test->max_rss.value) {
+		return false;
+	}
+	return true;
+}
+
 RZ_API void rz_test_test_result_info_free(RzTestResultInfo *result) {
 	if (!result) {
 		return;
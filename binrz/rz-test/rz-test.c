@@ -19,11 +19,13 @@
 #define RZ_ASM_CMD_DEFAULT     "rz-asm"
 #define JSON_TEST_FILE_DEFAULT "bins/elf/crackme0x00b"
 #define TIMEOUT_DEFAULT        960
+#define TOLERANCE_DEFAULT      25
 
-#define STRV(x)             #x
-#define STR(x)              STRV(x)
-#define WORKERS_DEFAULT_STR STR(WORKERS_DEFAULT)
-#define TIMEOUT_DEFAULT_STR STR(TIMEOUT_DEFAULT)
+#define STRV(x)               #x
+#define STR(x)                STRV(x)
+#define WORKERS_DEFAULT_STR   STR(WORKERS_DEFAULT)
+#define TIMEOUT_DEFAULT_STR   STR(TIMEOUT_DEFAULT)
+#define TOLERANCE_DEFAULT_STR STR(TOLERANCE_DEFAULT)
 
 typedef struct rz_testfile_counts_t {
 	ut64 tests_left; // count of remaining tests
@@ -55,6 +57,7 @@ static void *worker_th(RzTestState *state);
 static void print_state(RzTestState *state, ut64 prev_completed);
 static void print_log(RzTestState *state, ut64 prev_completed, ut64 prev_paths_completed);
 static void interact(RzTestState *state);
+static bool print_regressions(RzTestState *state, RzTestBaseline *baseline, ut64 tolerance);
 static bool interact_fix(RzTestResultInfo *result, RzPVector *fixup_results);
 static void interact_break(RzTestResultInfo *result, RzPVector *fixup_results);
 static void interact_commands(RzTestResultInfo *result, RzPVector *fixup_results);
@@ -80,7 +83,10 @@ static int help(bool verbose) {
 			" -o [file]    output test run information in JSON format to file\n"
 			" -e [dir]     exclude a particular directory while testing (this option can appear many times)\n"
 			" -s [num]     number of expected successful tests\n"
-			" -x [num]     number of expected failed tests"
+			" -x [num]     number of expected failed tests\n"
+			" -b [file]    compare time and memory of the tests against the given baseline\n"
+			" -B [file]    save time and memory of the successful tests as a new baseline\n"
+			" -T [percent] tolerance for -b before a test counts as regressed (default is " TOLERANCE_DEFAULT_STR ")"
 			"\n"
 			"Supported test types: @json @unit @fuzz @cmds\n"
 			"OS/Arch for archos tests: " RZ_TEST_ARCH_OS "\n");
@@ -195,6 +201,10 @@ int rz_test_main(int argc, const char **argv) {
 	char *json_test_file = NULL;
 	char *output_file = NULL;
 	char *fuzz_dir = NULL;
+	char *baseline_file = NULL;
+	char *baseline_out_file = NULL;
+	ut64 tolerance = TOLERANCE_DEFAULT;
+	RzTestBaseline *baseline = NULL;
 	RzPVector *except_dir = rz_pvector_new(free);
 	const char *rz_test_dir = NULL;
 	ut64 timeout_sec = TIMEOUT_DEFAULT;
@@ -223,7 +233,7 @@ int rz_test_main(int argc, const char **argv) {
 #endif
 
 	RzGetopt opt;
-	rz_getopt_init(&opt, argc, (const char **)argv, "hqvj:r:m:f:C:LnVt:F:io:e:s:x:");
+	rz_getopt_init(&opt, argc, (const char **)argv, "hqvj:r:m:f:C:LnVt:F:io:e:s:x:b:B:T:");
 
 	int c;
 	while ((c = rz_getopt_next(&opt)) != -1) {
@@ -311,6 +321,21 @@ int rz_test_main(int argc, const char **argv) {
 				goto beach;
 			}
 			break;
+		case 'b':
+			free(baseline_file);
+			baseline_file = strdup(opt.arg);
+			break;
+		case 'B':
+			free(baseline_out_file);
+			baseline_out_file = strdup(opt.arg);
+			break;
+		case 'T':
+			if (!rz_num_is_valid_input(NULL, opt.arg)) {
+				RZ_LOG_ERROR("Tolerance is invalid\n");
+				goto beach;
+			}
+			tolerance = rz_num_math(NULL, opt.arg);
+			break;
 		default:
 			ret = help(false);
 			goto beach;
@@ -340,6 +365,22 @@ int rz_test_main(int argc, const char **argv) {
 		fuzz_dir = rz_file_abspath_rel(cwd, fuzz_dir);
 		free(tmp);
 	}
+	if (baseline_file) {
+		char *tmp = rz_file_abspath_rel(cwd, baseline_file);
+		baseline = rz_test_baseline_new();
+		if (!baseline || !rz_test_baseline_load(baseline, tmp)) {
+			eprintf("Failed to load baseline from \"%s\"\n", tmp);
+			free(tmp);
+			ret = -1;
+			goto beach;
+		}
+		free(tmp);
+	}
+	if (baseline_out_file) {
+		char *tmp = baseline_out_file;
+		baseline_out_file = rz_file_abspath_rel(cwd, baseline_out_file);
+		free(tmp);
+	}
 
 	if (!rz_subprocess_init()) {
 		eprintf("Subprocess init failed\n");
@@ -574,6 +615,15 @@ int rz_test_main(int argc, const char **argv) {
 		free(results);
 	}
 
+	if (baseline_out_file && !rz_test_baseline_save(&state.results, baseline_out_file)) {
+		eprintf("Failed to save baseline to \"%s\"\n", baseline_out_file);
+		ret = 1;
+	}
+
+	if (baseline && print_regressions(&state, baseline, tolerance)) {
+		ret = 1;
+	}
+
 	if (interactive) {
 		interact(&state);
 	}
@@ -604,6 +654,9 @@ beach:
 	free(rz_asm_cmd);
 	free(json_test_file);
 	free(fuzz_dir);
+	free(baseline_file);
+	free(baseline_out_file);
+	rz_test_baseline_free(baseline);
 	rz_pvector_free(except_dir);
 #if __WINDOWS__
 	if (old_cp) {
@@ -657,7 +710,9 @@ static void test_result_to_json(PJ *pj, RzTestResultInfo *result) {
 	}
 	pj_kb(pj, "run_failed", result->run_failed);
 	pj_kn(pj, "time_elapsed", result->time_elapsed);
+	pj_kn(pj, "peak_rss", result->peak_rss);
 	pj_kb(pj, "timeout", result->timeout);
+	pj_kb(pj, "over_budget", result->over_budget);
 	pj_end(pj);
 }
 
@@ -795,6 +850,16 @@ static void print_result_diff(RzTestRunConfig *config, RzTestResultInfo *result)
 		if (result->proc_out->ret != 0) {
 			printf("-- exit status: " Color_RED "%d" Color_RESET "\n", result->proc_out->ret);
 		}
+		if (result->over_budget) {
+			RzCmdTest *test = result->test->cmd_test;
+			printf("-- over budget\n");
+			if (test->max_time.set) {
+				printf("time: %" PFMT64u " ms (MAX_TIME=%" PFMT64u ")\n", result->time_elapsed / 1000, test->max_time.value);
+			}
+			if (test->max_rss.set) {
+				printf("rss: %" PFMT64u " KiB (MAX_RSS=%" PFMT64u ")\n", result->peak_rss, test->max_rss.value);
+			}
+		}
 		break;
 	}
 	case RZ_TEST_TYPE_ASM: {
@@ -892,6 +957,9 @@ static void print_new_results(RzTestState *state, ut64 prev_completed) {
 		if (result->timeout) {
 			printf(Color_CYAN " TIMEOUT" Color_RESET);
 		}
+		if (result->over_budget) {
+			printf(Color_CYAN " BUDGET" Color_RESET);
+		}
 		printf(" %s " Color_YELLOW "%s" Color_RESET "\n", result->test->path, name);
 		if (result->result == RZ_TEST_RESULT_FAILED || (state->verbose && result->result == RZ_TEST_RESULT_BROKEN)) {
 			print_result_diff(&state->run_config, result);
@@ -950,6 +1018,38 @@ static void print_log(RzTestState *state, ut64 prev_completed, ut64 prev_paths_c
 	}
 }
 
+static bool print_regressions(RzTestState *state, RzTestBaseline *baseline, ut64 tolerance) {
+	ut64 count = 0;
+	void **it;
+	rz_pvector_foreach (&state->results, it) {
+		RzTestResultInfo *result = *it;
+		if (result->result != RZ_TEST_RESULT_OK && result->result != RZ_TEST_RESULT_FIXED) {
+			continue;
+		}
+		RzTestPerfEntry *base = rz_test_baseline_get(baseline, result->test);
+		bool time, rss;
+		if (!base || !rz_test_perf_regressed(base, result, tolerance, &time, &rss)) {
+			continue;
+		}
+		char *name = rz_test_test_name(result->test);
+		printf(Color_MAGENTA "[RG]" Color_RESET " %s " Color_YELLOW "%s" Color_RESET "\n", result->test->path, name ? name : "");
+		free(name);
+		if (time) {
+			printf("-- time: %" PFMT64u " ms (baseline %" PFMT64u " ms)\n",
+				result->time_elapsed / 1000, base->time_elapsed / 1000);
+		}
+		if (rss) {
+			printf("-- rss: %" PFMT64u " KiB (baseline %" PFMT64u " KiB)\n",
+				result->peak_rss, base->peak_rss);
+		}
+		count++;
+	}
+	if (count) {
+		printf("%" PFMT64u " tests regressed by more than %" PFMT64u "%% against the baseline.\n", count, tolerance);
+	}
+	return count > 0;
+}
+
 static void interact(RzTestState *state) {
 	void **it;
 	RzPVector failed_results;
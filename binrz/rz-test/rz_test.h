@@ -62,6 +62,8 @@ typedef struct rz_test_cmd_test_t {
 	RzCmdTestStringRecord regexp_err;
 	RzCmdTestBoolRecord broken;
 	RzCmdTestNumRecord timeout;
+	RzCmdTestNumRecord max_time; // budget in milliseconds
+	RzCmdTestNumRecord max_rss; // budget in KiB
 	ut64 run_line;
 	bool load_plugins;
 } RzCmdTest;
@@ -76,6 +78,8 @@ typedef struct rz_test_cmd_test_t {
 	macro_str ("FILE", file) \
 	macro_str ("ARGS", args) \
 	macro_int ("TIMEOUT", timeout) \
+	macro_int ("MAX_TIME", max_time) \
+	macro_int ("MAX_RSS", max_rss) \
 	macro_str ("SOURCE", source) \
 	macro_str ("CMDS", cmds) \
 	macro_str ("EXPECT", expect) \
@@ -170,13 +174,24 @@ typedef struct rz_test_test_result_info_t {
 	RzTestResult result;
 	bool timeout;
 	bool run_failed; // something went seriously wrong (e.g. rizin not found)
-	ut64 time_elapsed;
+	bool over_budget; // MAX_TIME or MAX_RSS of a cmd test exceeded
+	ut64 time_elapsed; // in microseconds
+	ut64 peak_rss; // peak resident set size of the test process in KiB, 0 if unknown
 	union {
 		RzSubprocessOutput *proc_out; // for test->type == RZ_TEST_TYPE_CMD, RZ_TEST_TYPE_JSON or RZ_TEST_TYPE_FUZZ
 		RzAsmTestOutput *asm_out; // for test->type == RZ_TEST_TYPE_ASM
 	};
 } RzTestResultInfo;
 
+typedef struct rz_test_perf_entry_t {
+	ut64 time_elapsed; // in microseconds
+	ut64 peak_rss; // in KiB
+} RzTestPerfEntry;
+
+typedef struct rz_test_baseline_t {
+	HtPP *entries; // char * (test key) => RzTestPerfEntry *
+} RzTestBaseline;
+
 RZ_API RzCmdTest *rz_test_cmd_test_new(void);
 RZ_API void rz_test_cmd_test_free(RzCmdTest *test);
 RZ_API RzPVector *rz_test_load_cmd_test_file(const char *file);
@@ -213,6 +228,15 @@ RZ_API void rz_test_test_free(RzTest *test);
 RZ_API char *rz_test_test_name(RzTest *test);
 RZ_API bool rz_test_test_broken(RzTest *test);
 RZ_API RzTestResultInfo *rz_test_run_test(RzTestRunConfig *config, RzTest *test);
+RZ_API bool rz_test_check_cmd_budget(RzCmdTest *test, RzTestResultInfo *result);
 RZ_API void rz_test_test_result_info_free(RzTestResultInfo *result);
 
+RZ_API RzTestBaseline *rz_test_baseline_new(void);
+RZ_API void rz_test_baseline_free(RzTestBaseline *baseline);
+RZ_API char *rz_test_baseline_key(RzTest *test);
+RZ_API bool rz_test_baseline_load(RzTestBaseline *baseline, const char *file);
+RZ_API bool rz_test_baseline_save(RzPVector /*<RzTestResultInfo *>*/ *results, const char *file);
+RZ_API RzTestPerfEntry *rz_test_baseline_get(RzTestBaseline *baseline, RzTest *test);
+RZ_API bool rz_test_perf_regressed(RzTestPerfEntry *base, RzTestResultInfo *result, ut64 tolerance, bool *time, bool *rss);
+
 #endif // RIZIN_RZTEST_H
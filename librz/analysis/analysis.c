@@ -34,6 +34,13 @@ static void meta_unset_for(RzEvent *ev, int type, void *user, void *data) {
 	rz_meta_space_unset_for(analysis, se->data.unset.space);
 }
 
+static void meta_rename_for(RzEvent *ev, int type, void *user, void *data) {
+	RzSpaces *s = (RzSpaces *)ev->user;
+	RzAnalysis *analysis = container_of(s, RzAnalysis, meta_spaces);
+	// the items refer to their space by name once serialized
+	rz_analysis_mark_dirty(analysis, &analysis->gen.meta, 0, UT64_MAX);
+}
+
 static void meta_count_for(RzEvent *ev, int type, void *user, void *data) {
 	RzSpaces *s = (RzSpaces *)ev->user;
 	RzAnalysis *analysis = container_of(s, RzAnalysis, meta_spaces);
@@ -87,6 +94,7 @@ RZ_API RzAnalysis *rz_analysis_new(void) {
 	rz_spaces_init(&analysis->meta_spaces, "CS");
 	rz_event_hook(analysis->meta_spaces.event, RZ_SPACE_EVENT_UNSET, meta_unset_for, NULL);
 	rz_event_hook(analysis->meta_spaces.event, RZ_SPACE_EVENT_COUNT, meta_count_for, NULL);
+	rz_event_hook(analysis->meta_spaces.event, RZ_SPACE_EVENT_RENAME, meta_rename_for, NULL);
 
 	rz_analysis_hint_storage_init(analysis);
 	rz_interval_tree_init(&analysis->meta, rz_meta_item_free);
@@ -96,6 +104,7 @@ RZ_API RzAnalysis *rz_analysis_new(void) {
 	analysis->sdb_cc = sdb_ns(analysis->sdb, "cc", 1);
 	analysis->sdb_classes = sdb_ns(analysis->sdb, "classes", 1);
 	analysis->sdb_classes_attrs = sdb_ns(analysis->sdb_classes, "attrs", 1);
+	rz_analysis_class_methods_init(analysis);
 	analysis->sdb_noret = sdb_ns(analysis->sdb, "noreturn", 1);
 	(void)rz_analysis_xrefs_init(analysis);
 	analysis->diff_thbb = RZ_ANALYSIS_THRESHOLDBB;
@@ -123,6 +132,13 @@ RZ_API RzAnalysis *rz_analysis_new(void) {
 	analysis->global_var_tree = NULL;
 	analysis->il_vm = NULL;
 	analysis->hash = rz_hash_new();
+	analysis->read_ahead.addr = UT64_MAX;
+	rz_analysis_fcn_set_read_ahead_size(analysis, RZ_ANALYSIS_READ_AHEAD_DEFAULT_SIZE);
+	rz_analysis_op_cache_init(analysis);
+	rz_analysis_dirty_init(analysis);
+	analysis->snapshot_lock = rz_th_lock_new(false);
+	analysis->block_slab = rz_slab_new(sizeof(RzAnalysisBlock), RZ_ANALYSIS_ARENA_BLOCKS_PER_CHUNK);
+	analysis->fcn_slab = rz_slab_new(sizeof(RzAnalysisFunction), RZ_ANALYSIS_ARENA_FCNS_PER_CHUNK);
 	return analysis;
 }
 
@@ -160,11 +176,11 @@ RZ_API RzAnalysis *rz_analysis_free(RzAnalysis *a) {
 	rz_platform_target_free(a->arch_target);
 	rz_platform_target_index_free(a->platform_target);
 	rz_reg_free(a->reg);
-	ht_up_free(a->ht_xrefs_from);
-	ht_up_free(a->ht_xrefs_to);
+	rz_analysis_xrefs_fini(a);
 	ht_up_free(a->type_links);
 	rz_list_free(a->leaddrs);
 	rz_type_db_free(a->typedb);
+	rz_analysis_class_methods_fini(a);
 	sdb_free(a->sdb);
 	if (a->esil) {
 		rz_analysis_esil_free(a->esil);
@@ -174,6 +190,17 @@ RZ_API RzAnalysis *rz_analysis_free(RzAnalysis *a) {
 	rz_list_free(a->imports);
 	rz_str_constpool_fini(&a->constpool);
 	ht_pp_free(a->ht_global_var);
+	free(a->read_ahead.buf);
+	rz_analysis_op_cache_fini(a);
+	rz_buf_free(a->emu_mem);
+	rz_analysis_emu_prof_free(a->emu_prof);
+	// all the blocks and functions are gone at this point
+	rz_slab_free(a->block_slab);
+	rz_slab_free(a->fcn_slab);
+	rz_analysis_dirty_fini(a);
+	sdb_free(a->serialize_cache);
+	rz_analysis_snapshot_release(a->snapshot);
+	rz_th_lock_free(a->snapshot_lock);
 	free(a);
 	return NULL;
 }
@@ -196,6 +223,7 @@ RZ_API bool rz_analysis_use(RzAnalysis *analysis, const char *name) {
 				continue;
 			}
 			plugin_fini(analysis);
+			rz_analysis_op_cache_invalidate(analysis);
 			analysis->cur = h;
 			if (h->init && !h->init(&analysis->plugin_data)) {
 				RZ_LOG_ERROR("analysis plugin '%s' failed to initialize.\n", h->name);
@@ -228,6 +256,41 @@ RZ_API bool rz_analysis_set_reg_profile(RzAnalysis *analysis) {
 	return ret;
 }
 
+/**
+ * \brief Make emulation write into copy-on-write pages over io instead of into io itself
+ *
+ * While enabled, memory written by esil and il emulation only lives in analysis->emu_mem,
+ * so emulating does not grow io.cache or modify the file.
+ * Disabling commits all written pages into io.
+ *
+ * \return false if the pages could not be created or not all of them could be committed
+ */
+RZ_API bool rz_analysis_set_emu_cow(RzAnalysis *analysis, bool enable) {
+	rz_return_val_if_fail(analysis, false);
+	if (enable) {
+		if (analysis->emu_mem) {
+			return true;
+		}
+		RzBuffer *io = rz_buf_new_with_io(&analysis->iob);
+		if (!io) {
+			return false;
+		}
+		analysis->emu_mem = rz_buf_new_cow(io);
+		rz_buf_free(io);
+		return analysis->emu_mem != NULL;
+	}
+	if (!analysis->emu_mem) {
+		return true;
+	}
+	bool succ = rz_buf_cow_commit(analysis->emu_mem);
+	if (!succ) {
+		RZ_LOG_WARN("Not all emulated memory could be written into io\n");
+	}
+	rz_buf_free(analysis->emu_mem);
+	analysis->emu_mem = NULL;
+	return succ;
+}
+
 static bool analysis_set_os(RzAnalysis *analysis, const char *os) {
 	rz_return_val_if_fail(analysis, false);
 	if (!os || !*os) {
@@ -311,6 +374,10 @@ RZ_API int rz_analysis_get_address_bits(RzAnalysis *analysis) {
 }
 
 RZ_API void rz_analysis_set_cpu(RzAnalysis *analysis, const char *cpu) {
+	rz_analysis_op_cache_invalidate(analysis);
+	if (analysis->il_vm) {
+		rz_analysis_il_vm_cache_invalidate(analysis->il_vm);
+	}
 	free(analysis->cpu);
 	analysis->cpu = cpu ? strdup(cpu) : NULL;
 	int v = rz_analysis_archinfo(analysis, RZ_ANALYSIS_ARCHINFO_ALIGN);
@@ -325,6 +392,9 @@ RZ_API void rz_analysis_set_cpu(RzAnalysis *analysis, const char *cpu) {
 }
 
 RZ_API int rz_analysis_set_big_endian(RzAnalysis *analysis, int bigend) {
+	if (analysis->big_endian != bigend) {
+		rz_analysis_op_cache_invalidate(analysis);
+	}
 	analysis->big_endian = bigend;
 	if (analysis->reg) {
 		analysis->reg->big_endian = bigend;
@@ -436,11 +506,13 @@ RZ_API void rz_analysis_purge(RzAnalysis *analysis) {
 	rz_analysis_hint_clear(analysis);
 	rz_interval_tree_fini(&analysis->meta);
 	rz_interval_tree_init(&analysis->meta, rz_meta_item_free);
+	rz_analysis_mark_dirty(analysis, &analysis->gen.meta, 0, UT64_MAX);
 	rz_type_db_purge(analysis->typedb);
 	ht_up_free(analysis->type_links);
 	analysis->type_links = ht_up_new0();
 	sdb_reset(analysis->sdb_classes);
 	sdb_reset(analysis->sdb_classes_attrs);
+	rz_analysis_class_methods_reset(analysis);
 	sdb_reset(analysis->sdb_cc);
 	sdb_reset(analysis->sdb_noret);
 	rz_list_free(analysis->fcns);
@@ -448,6 +520,28 @@ RZ_API void rz_analysis_purge(RzAnalysis *analysis) {
 	rz_analysis_purge_imports(analysis);
 }
 
+/**
+ * \brief Returns the memory taken by the blocks and functions allocated while analysis.arena is enabled
+ *
+ * \param blocks Filled with the stats of the blocks, if not NULL
+ * \param fcns   Filled with the stats of the functions, if not NULL
+ */
+RZ_API void rz_analysis_arena_stats(RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSlabStats *blocks, RZ_NULLABLE RzSlabStats *fcns) {
+	rz_return_if_fail(analysis);
+	if (blocks) {
+		memset(blocks, 0, sizeof(*blocks));
+		if (analysis->block_slab) {
+			rz_slab_stats(analysis->block_slab, blocks);
+		}
+	}
+	if (fcns) {
+		memset(fcns, 0, sizeof(*fcns));
+		if (analysis->fcn_slab) {
+			rz_slab_stats(analysis->fcn_slab, fcns);
+		}
+	}
+}
+
 RZ_API int rz_analysis_archinfo(RzAnalysis *analysis, int query) {
 	rz_return_val_if_fail(analysis, -1);
 	switch (query) {
@@ -44,8 +44,10 @@ RZ_API void rz_analysis_block_ref(RzAnalysisBlock *bb) {
 
 #define DFLT_NINSTR 3
 
+#define BLOCK_MEM_SIZE(b) (sizeof(RzAnalysisBlock) + (b)->op_pos_size * sizeof(ut16))
+
 static RzAnalysisBlock *block_new(RzAnalysis *a, ut64 addr, ut64 size) {
-	RzAnalysisBlock *block = RZ_NEW0(RzAnalysisBlock);
+	RzAnalysisBlock *block = a->use_arena && a->block_slab ? rz_slab_alloc(a->block_slab) : RZ_NEW0(RzAnalysisBlock);
 	if (!block) {
 		return NULL;
 	}
@@ -64,6 +66,7 @@ static RzAnalysisBlock *block_new(RzAnalysis *a, ut64 addr, ut64 size) {
 	if (size) {
 		rz_analysis_block_update_hash(block);
 	}
+	RZ_MEM_TRACK(RZ_MEM_ACCOUNT_ANALYSIS, block, BLOCK_MEM_SIZE(block));
 	return block;
 }
 
@@ -79,7 +82,14 @@ static void block_free(RzAnalysisBlock *block) {
 	rz_list_free(block->fcns);
 	free(block->op_pos);
 	free(block->parent_reg_arena);
-	free(block);
+	RZ_MEM_UNTRACK(block);
+	// analysis.arena may have been toggled since the block was created
+	RzSlab *slab = block->analysis ? block->analysis->block_slab : NULL;
+	if (slab && rz_slab_owns(slab, block)) {
+		rz_slab_release(slab, block);
+	} else {
+		free(block);
+	}
 }
 
 void __block_free_rb(RBNode *node, void *user) {
@@ -180,9 +190,73 @@ RZ_API RzAnalysisBlock *rz_analysis_create_block(RzAnalysis *analysis, ut64 addr
 		return NULL;
 	}
 	rz_rbtree_aug_insert(&analysis->bb_tree, &block->addr, &block->_rb, __bb_addr_cmp, NULL, __max_end);
+	rz_analysis_mark_dirty(analysis, &analysis->gen.blocks, addr, addr + size - 1);
 	return block;
 }
 
+/**
+ * \brief Creates a block which is not part of the block tree yet, see rz_analysis_blocks_link_all()
+ */
+RZ_IPI RzAnalysisBlock *rz_analysis_block_new_unlinked(RzAnalysis *analysis, ut64 addr, ut64 size) {
+	return block_new(analysis, addr, size);
+}
+
+/**
+ * \brief Frees a block created by rz_analysis_block_new_unlinked() which has not been linked
+ */
+RZ_IPI void rz_analysis_block_free_unlinked(RzAnalysisBlock *block) {
+	block_free(block);
+}
+
+static int block_addr_cmp(const void *a, const void *b) {
+	const RzAnalysisBlock *x = a, *y = b;
+	return x->addr < y->addr ? -1 : (x->addr > y->addr ? 1 : 0);
+}
+
+/**
+ * \brief Inserts all the unlinked \p blocks in the block tree
+ *
+ * When the tree is empty the blocks are sorted and the tree is built in O(n),
+ * otherwise they are inserted one by one.
+ * Blocks at the address of another block are freed, \p blocks is emptied in any case.
+ *
+ * \return false if some block has been freed instead of inserted
+ */
+RZ_IPI bool rz_analysis_blocks_link_all(RzAnalysis *analysis, RzPVector /*<RzAnalysisBlock *>*/ *blocks) {
+	rz_return_val_if_fail(analysis && blocks, false);
+	rz_pvector_sort(blocks, block_addr_cmp);
+	size_t count = rz_pvector_len(blocks);
+	bool unique = true;
+	for (size_t i = 0; unique && i + 1 < count; i++) {
+		unique = ((RzAnalysisBlock *)rz_pvector_at(blocks, i))->addr < ((RzAnalysisBlock *)rz_pvector_at(blocks, i + 1))->addr;
+	}
+	RBNode **nodes = !analysis->bb_tree && unique && count ? RZ_NEWS(RBNode *, count) : NULL;
+	if (nodes) {
+		for (size_t i = 0; i < count; i++) {
+			nodes[i] = &((RzAnalysisBlock *)rz_pvector_at(blocks, i))->_rb;
+		}
+		bool built = rz_rbtree_aug_bulk_load(&analysis->bb_tree, nodes, count, __max_end);
+		free(nodes);
+		if (built) {
+			rz_pvector_clear(blocks);
+			return true;
+		}
+	}
+	bool ret = true;
+	void **it;
+	rz_pvector_foreach (blocks, it) {
+		RzAnalysisBlock *block = *it;
+		if (rz_analysis_get_block_at(analysis, block->addr)) {
+			block_free(block);
+			ret = false;
+			continue;
+		}
+		rz_rbtree_aug_insert(&analysis->bb_tree, &block->addr, &block->_rb, __bb_addr_cmp, NULL, __max_end);
+	}
+	rz_pvector_clear(blocks);
+	return ret;
+}
+
 RZ_API void rz_analysis_delete_block(RzAnalysisBlock *bb) {
 	rz_analysis_block_ref(bb);
 	while (!rz_list_empty(bb->fcns)) {
@@ -203,11 +277,14 @@ RZ_API void rz_analysis_block_set_size(RzAnalysisBlock *block, ut64 size) {
 		if (fcn->meta._min != UT64_MAX && fcn->meta._max == block->addr + block->size) {
 			fcn->meta._max = block->addr + size;
 		}
+		rz_analysis_function_cfg_invalidate(fcn);
 	}
 
 	// Do the actual resize
+	ut64 touched = RZ_MAX(block->size, size);
 	block->size = size;
 	rz_rbtree_aug_update_sum(block->analysis->bb_tree, &block->addr, &block->_rb, __bb_addr_cmp, NULL, __max_end);
+	rz_analysis_mark_dirty(block->analysis, &block->analysis->gen.blocks, block->addr, block->addr + touched - 1);
 }
 
 RZ_API bool rz_analysis_block_relocate(RzAnalysisBlock *block, ut64 addr, ut64 size) {
@@ -225,6 +302,7 @@ RZ_API bool rz_analysis_block_relocate(RzAnalysisBlock *block, ut64 addr, ut64 s
 	RzAnalysisFunction *fcn;
 	RzListIter *iter;
 	rz_list_foreach (block->fcns, iter, fcn) {
+		rz_analysis_function_cfg_invalidate(fcn);
 		if (fcn->meta._min != UT64_MAX) {
 			if (addr + size > fcn->meta._max) {
 				// we extend after the maximum, so we are the maximum afterwards.
@@ -245,10 +323,12 @@ RZ_API bool rz_analysis_block_relocate(RzAnalysisBlock *block, ut64 addr, ut64 s
 	}
 
 	rz_rbtree_aug_delete(&block->analysis->bb_tree, &block->addr, __bb_addr_cmp, NULL, NULL, NULL, __max_end);
+	rz_analysis_mark_dirty(block->analysis, &block->analysis->gen.blocks, block->addr, block->addr + block->size - 1);
 	block->addr = addr;
 	block->size = size;
 	rz_analysis_block_update_hash(block);
 	rz_rbtree_aug_insert(&block->analysis->bb_tree, &block->addr, &block->_rb, __bb_addr_cmp, NULL, __max_end);
+	rz_analysis_mark_dirty(block->analysis, &block->analysis->gen.blocks, addr, addr + size - 1);
 	return true;
 }
 
@@ -377,6 +457,8 @@ RZ_API void rz_analysis_block_unref(RzAnalysisBlock *bb) {
 	if (bb->ref < 1) {
 		RzAnalysis *analysis = bb->analysis;
 		assert(!bb->fcns || rz_list_empty(bb->fcns));
+		// blocks may still point to bb in _jump_bb or _fail_bb
+		rz_analysis_mark_dirty(analysis, &analysis->gen.blocks, bb->addr, bb->addr + bb->size - 1);
 		rz_rbtree_aug_delete(&analysis->bb_tree, &bb->addr, __bb_addr_cmp, NULL, __block_free_rb, NULL, __max_end);
 	}
 }
@@ -406,81 +488,160 @@ RZ_API bool rz_analysis_block_successor_addrs_foreach(RzAnalysisBlock *block, Rz
 #undef CB_ADDR
 }
 
-typedef struct rz_analysis_block_recurse_context_t {
+/*
+ * Set of visited blocks of the rz_analysis_block_recurse*() traversals.
+ * A traversal gets a new mark and stores it in the blocks it visits, so no
+ * memory has to be allocated or cleared. Traversals started from the callback
+ * of another one can't reuse the marks and fall back to a table of addresses.
+ */
+typedef struct {
 	RzAnalysis *analysis;
-	RzPVector /*<RzAnalysisBlock>*/ to_visit;
-	HtUP *visited;
-} RzAnalysisBlockRecurseContext;
+	HtUP *visited; // NULL if the marks of the blocks are used
+	ut32 mark;
+} BlockVisitSet;
+
+static bool visit_set_init(BlockVisitSet *set, RzAnalysis *analysis) {
+	set->analysis = analysis;
+	set->visited = NULL;
+	set->mark = 0;
+	if (analysis->block_visit_busy) {
+		set->visited = ht_up_new0();
+		return set->visited != NULL;
+	}
+	analysis->block_visit_busy = true;
+	if (++analysis->block_visit_mark == 0) {
+		// wrapped around, forget the marks of earlier traversals
+		RBIter iter;
+		RzAnalysisBlock *block;
+		rz_rbtree_foreach (analysis->bb_tree, iter, block, RzAnalysisBlock, _rb) {
+			block->_visit_mark = 0;
+		}
+		analysis->block_visit_mark = 1;
+	}
+	set->mark = analysis->block_visit_mark;
+	return true;
+}
 
-static bool block_recurse_successor_cb(ut64 addr, void *user) {
-	RzAnalysisBlockRecurseContext *ctx = user;
-	if (ht_up_find_kv(ctx->visited, addr, NULL)) {
-		// already visited
-		return true;
+static void visit_set_fini(BlockVisitSet *set) {
+	if (set->visited) {
+		ht_up_free(set->visited);
+	} else if (set->mark) {
+		set->analysis->block_visit_busy = false;
 	}
-	ht_up_insert(ctx->visited, addr, NULL);
-	RzAnalysisBlock *block = rz_analysis_get_block_at(ctx->analysis, addr);
-	if (!block) {
-		return true;
+}
+
+static inline bool visit_set_has(BlockVisitSet *set, RzAnalysisBlock *block) {
+	return set->visited ? ht_up_find_kv(set->visited, block->addr, NULL) != NULL : block->_visit_mark == set->mark;
+}
+
+static inline void visit_set_add(BlockVisitSet *set, RzAnalysisBlock *block) {
+	if (set->visited) {
+		ht_up_insert(set->visited, block->addr, NULL);
+	} else {
+		block->_visit_mark = set->mark;
+	}
+}
+
+/*
+ * Block at the jump or fail address of \p block, remembered in \p cached.
+ * Creating, moving or freeing blocks bumps gen.blocks, after that the blocks
+ * are looked up again.
+ */
+static RzAnalysisBlock *successor_block(RzAnalysisBlock *block, ut64 addr, RzAnalysisBlock **cached) {
+	RzAnalysis *analysis = block->analysis;
+	if (block->_succ_gen != analysis->gen.blocks) {
+		block->_jump_bb = NULL;
+		block->_fail_bb = NULL;
+		block->_succ_gen = analysis->gen.blocks;
+	}
+	if (!*cached || (*cached)->addr != addr) {
+		*cached = rz_analysis_get_block_at(analysis, addr);
+	}
+	return *cached;
+}
+
+static inline RzAnalysisBlock *jump_block(RzAnalysisBlock *block) {
+	return block->jump == UT64_MAX ? NULL : successor_block(block, block->jump, &block->_jump_bb);
+}
+
+static inline RzAnalysisBlock *fail_block(RzAnalysisBlock *block) {
+	return block->fail == UT64_MAX ? NULL : successor_block(block, block->fail, &block->_fail_bb);
+}
+
+static inline void visit_push(BlockVisitSet *set, RzPVector *to_visit, RzAnalysisBlock *block) {
+	if (!block || visit_set_has(set, block)) {
+		return;
+	}
+	visit_set_add(set, block);
+	rz_pvector_push(to_visit, block);
+}
+
+static void push_successors(BlockVisitSet *set, RzPVector *to_visit, RzAnalysisBlock *block) {
+	visit_push(set, to_visit, jump_block(block));
+	visit_push(set, to_visit, fail_block(block));
+	if (block->switch_op && block->switch_op->cases) {
+		RzListIter *iter;
+		RzAnalysisCaseOp *caseop;
+		rz_list_foreach (block->switch_op->cases, iter, caseop) {
+			if (caseop->jump != UT64_MAX) {
+				visit_push(set, to_visit, rz_analysis_get_block_at(set->analysis, caseop->jump));
+			}
+		}
 	}
-	rz_pvector_push(&ctx->to_visit, block);
-	return true;
 }
 
 RZ_API bool rz_analysis_block_recurse(RzAnalysisBlock *block, RzAnalysisBlockCb cb, void *user) {
 	bool breaked = false;
-	RzAnalysisBlockRecurseContext ctx;
-	ctx.analysis = block->analysis;
-	rz_pvector_init(&ctx.to_visit, NULL);
-	ctx.visited = ht_up_new0();
-	if (!ctx.visited) {
+	BlockVisitSet set;
+	RzPVector to_visit;
+	rz_pvector_init(&to_visit, NULL);
+	if (!visit_set_init(&set, block->analysis)) {
 		goto beach;
 	}
 
-	ht_up_insert(ctx.visited, block->addr, NULL);
-	rz_pvector_push(&ctx.to_visit, block);
+	visit_set_add(&set, block);
+	rz_pvector_push(&to_visit, block);
 
-	while (!rz_pvector_empty(&ctx.to_visit)) {
-		RzAnalysisBlock *cur = rz_pvector_pop(&ctx.to_visit);
+	while (!rz_pvector_empty(&to_visit)) {
+		RzAnalysisBlock *cur = rz_pvector_pop(&to_visit);
 		breaked = !cb(cur, user);
 		if (breaked) {
 			break;
 		}
-		rz_analysis_block_successor_addrs_foreach(cur, block_recurse_successor_cb, &ctx);
+		push_successors(&set, &to_visit, cur);
 	}
 
 beach:
-	ht_up_free(ctx.visited);
-	rz_pvector_clear(&ctx.to_visit);
+	visit_set_fini(&set);
+	rz_pvector_clear(&to_visit);
 	return !breaked;
 }
 
 RZ_API bool rz_analysis_block_recurse_followthrough(RzAnalysisBlock *block, RzAnalysisBlockCb cb, void *user) {
 	bool breaked = false;
-	RzAnalysisBlockRecurseContext ctx;
-	ctx.analysis = block->analysis;
-	rz_pvector_init(&ctx.to_visit, NULL);
-	ctx.visited = ht_up_new0();
-	if (!ctx.visited) {
+	BlockVisitSet set;
+	RzPVector to_visit;
+	rz_pvector_init(&to_visit, NULL);
+	if (!visit_set_init(&set, block->analysis)) {
 		goto beach;
 	}
 
-	ht_up_insert(ctx.visited, block->addr, NULL);
-	rz_pvector_push(&ctx.to_visit, block);
+	visit_set_add(&set, block);
+	rz_pvector_push(&to_visit, block);
 
-	while (!rz_pvector_empty(&ctx.to_visit)) {
-		RzAnalysisBlock *cur = rz_pvector_pop(&ctx.to_visit);
+	while (!rz_pvector_empty(&to_visit)) {
+		RzAnalysisBlock *cur = rz_pvector_pop(&to_visit);
 		bool b = !cb(cur, user);
 		if (b) {
 			breaked = true;
 		} else {
-			rz_analysis_block_successor_addrs_foreach(cur, block_recurse_successor_cb, &ctx);
+			push_successors(&set, &to_visit, cur);
 		}
 	}
 
 beach:
-	ht_up_free(ctx.visited);
-	rz_pvector_clear(&ctx.to_visit);
+	visit_set_fini(&set);
+	rz_pvector_clear(&to_visit);
 	return !breaked;
 }
 
@@ -492,17 +653,16 @@ typedef struct {
 RZ_API bool rz_analysis_block_recurse_depth_first(RzAnalysisBlock *block, RzAnalysisBlockCb cb, RZ_NULLABLE RzAnalysisBlockCb on_exit, void *user) {
 	rz_return_val_if_fail(block && cb, true);
 	bool breaked = false;
-	HtUP *visited = ht_up_new0();
-	if (!visited) {
-		goto beach;
-	}
-	RzAnalysis *analysis = block->analysis;
+	BlockVisitSet set;
 	RzVector path;
 	rz_vector_init(&path, sizeof(RecurseDepthFirstCtx), NULL, NULL);
+	if (!visit_set_init(&set, block->analysis)) {
+		goto beach;
+	}
 	RzAnalysisBlock *cur_bb = block;
 	RecurseDepthFirstCtx ctx = { cur_bb, NULL };
 	rz_vector_push(&path, &ctx);
-	ht_up_insert(visited, cur_bb->addr, NULL);
+	visit_set_add(&set, cur_bb);
 	breaked = !cb(cur_bb, user);
 	if (breaked) {
 		goto beach;
@@ -510,35 +670,39 @@ RZ_API bool rz_analysis_block_recurse_depth_first(RzAnalysisBlock *block, RzAnal
 	do {
 		RecurseDepthFirstCtx *cur_ctx = rz_vector_index_ptr(&path, path.len - 1);
 		cur_bb = cur_ctx->bb;
-		if (cur_bb->jump != UT64_MAX && !ht_up_find_kv(visited, cur_bb->jump, NULL)) {
-			cur_bb = rz_analysis_get_block_at(analysis, cur_bb->jump);
-		} else if (cur_bb->fail != UT64_MAX && !ht_up_find_kv(visited, cur_bb->fail, NULL)) {
-			cur_bb = rz_analysis_get_block_at(analysis, cur_bb->fail);
-		} else {
+		// a successor without block ends the visit of cur_bb, like an exit
+		RzAnalysisBlock *next = NULL;
+		bool found = false;
+		if (cur_bb->jump != UT64_MAX) {
+			next = jump_block(cur_bb);
+			found = !next || !visit_set_has(&set, next);
+		}
+		if (!found && cur_bb->fail != UT64_MAX) {
+			next = fail_block(cur_bb);
+			found = !next || !visit_set_has(&set, next);
+		}
+		if (!found) {
 			if (cur_bb->switch_op && !cur_ctx->switch_it) {
 				cur_ctx->switch_it = rz_list_head(cur_bb->switch_op->cases);
 			} else if (cur_ctx->switch_it) {
 				cur_ctx->switch_it = rz_list_iter_get_next(cur_ctx->switch_it);
 			}
-			if (cur_ctx->switch_it) {
+			next = NULL;
+			while (cur_ctx->switch_it) {
 				RzAnalysisCaseOp *cop = rz_list_iter_get_data(cur_ctx->switch_it);
-				while (ht_up_find_kv(visited, cop->jump, NULL)) {
-					cur_ctx->switch_it = rz_list_iter_get_next(cur_ctx->switch_it);
-					if (!cur_ctx->switch_it) {
-						cop = NULL;
-						break;
-					}
-					cop = rz_list_iter_get_data(cur_ctx->switch_it);
+				next = rz_analysis_get_block_at(block->analysis, cop->jump);
+				if (!next || !visit_set_has(&set, next)) {
+					break;
 				}
-				cur_bb = cop ? rz_analysis_get_block_at(analysis, cop->jump) : NULL;
-			} else {
-				cur_bb = NULL;
+				next = NULL;
+				cur_ctx->switch_it = rz_list_iter_get_next(cur_ctx->switch_it);
 			}
 		}
+		cur_bb = next;
 		if (cur_bb) {
 			RecurseDepthFirstCtx ctx = { cur_bb, NULL };
 			rz_vector_push(&path, &ctx);
-			ht_up_insert(visited, cur_bb->addr, NULL);
+			visit_set_add(&set, cur_bb);
 			bool breaked = !cb(cur_bb, user);
 			if (breaked) {
 				break;
@@ -552,7 +716,7 @@ RZ_API bool rz_analysis_block_recurse_depth_first(RzAnalysisBlock *block, RzAnal
 	} while (!rz_vector_empty(&path));
 
 beach:
-	ht_up_free(visited);
+	visit_set_fini(&set);
 	rz_vector_clear(&path);
 	return !breaked;
 }
@@ -577,6 +741,11 @@ RZ_API void rz_analysis_block_add_switch_case(RzAnalysisBlock *block, ut64 switc
 		block->switch_op = rz_analysis_switch_op_new(switch_addr, 0, 0, 0);
 	}
 	rz_analysis_switch_op_add_case(block->switch_op, case_addr, case_value, case_addr);
+	RzAnalysisFunction *fcn;
+	RzListIter *iter;
+	rz_list_foreach (block->fcns, iter, fcn) {
+		rz_analysis_function_cfg_invalidate(fcn);
+	}
 }
 
 RZ_API bool rz_analysis_block_op_starts_at(RzAnalysisBlock *bb, ut64 addr) {
@@ -677,39 +846,127 @@ beach:
 	return ret;
 }
 
-RZ_API bool rz_analysis_block_was_modified(RzAnalysisBlock *block) {
-	rz_return_val_if_fail(block, false);
-	if (!block->analysis->iob.read_at) {
-		return false;
+/* blocks less than this apart are read at once */
+#define BLOCKS_HASH_GAP 0x100
+/* most bytes read at once, unless a single block is bigger */
+#define BLOCKS_HASH_SPAN 0x10000
+
+typedef bool (*BlockHashCb)(RzAnalysisBlock *block, ut32 hash, void *user);
+
+static int block_ptr_addr_cmp(const void *a, const void *b) {
+	const RzAnalysisBlock *ba = *(const RzAnalysisBlock **)a;
+	const RzAnalysisBlock *bb = *(const RzAnalysisBlock **)b;
+	return RZ_NUM_CMP(ba->addr, bb->addr);
+}
+
+static bool blocks_hash_read(RzAnalysis *analysis, ut64 addr, ut8 *buf, ut64 len) {
+	return analysis->iob.read_at(analysis->iob.io, addr, buf, len);
+}
+
+/*
+ * Calls cb with the hash of the current bytes of each readable block,
+ * returning false as soon as cb does. Blocks lying close to each other are
+ * read with a single read of the range they span.
+ */
+static bool blocks_hash_foreach(RzAnalysis *analysis, RzAnalysisBlock **blocks, size_t count, BlockHashCb cb, void *user) {
+	if (!analysis->iob.read_at || !count) {
+		return true;
 	}
-	ut8 *buf = malloc(block->size);
-	if (!buf) {
-		return false;
+	RzAnalysisBlock **sorted = blocks;
+	if (count > 1) {
+		sorted = RZ_NEWS(RzAnalysisBlock *, count);
+		if (!sorted) {
+			return true;
+		}
+		memcpy(sorted, blocks, count * sizeof(RzAnalysisBlock *));
+		qsort(sorted, count, sizeof(RzAnalysisBlock *), block_ptr_addr_cmp);
 	}
-	if (!block->analysis->iob.read_at(block->analysis->iob.io, block->addr, buf, block->size)) {
-		free(buf);
-		return false;
+	bool ret = true;
+	ut8 *buf = NULL;
+	ut64 buf_size = 0;
+	size_t i = 0;
+	while (ret && i < count) {
+		// extend the run [i, j) while the range it spans stays small
+		ut64 from = sorted[i]->addr;
+		ut64 to = from + sorted[i]->size;
+		size_t j = i + 1;
+		for (; j < count; j++) {
+			RzAnalysisBlock *b = sorted[j];
+			ut64 b_end = RZ_MAX(to, b->addr + b->size);
+			if (b->addr > to + BLOCKS_HASH_GAP || b_end - from > BLOCKS_HASH_SPAN) {
+				break;
+			}
+			to = b_end;
+		}
+		if (!buf || to - from > buf_size) {
+			ut8 *tmp = realloc(buf, RZ_MAX(to - from, 1));
+			if (!tmp) {
+				break;
+			}
+			buf = tmp;
+			buf_size = to - from;
+		}
+		bool run_read = blocks_hash_read(analysis, from, buf, to - from);
+		for (; ret && i < j; i++) {
+			RzAnalysisBlock *b = sorted[i];
+			const ut8 *at = buf + (b->addr - from);
+			if (!run_read) {
+				// the range between the blocks may be unmapped, try the block alone
+				if (!blocks_hash_read(analysis, b->addr, buf, b->size)) {
+					continue;
+				}
+				at = buf;
+			}
+			ret = cb(b, rz_hash_xxhash(analysis->hash, at, b->size), user);
+		}
+		i = j;
 	}
-	ut32 cur_hash = rz_hash_xxhash(block->analysis->hash, buf, block->size);
 	free(buf);
-	return block->bbhash != cur_hash;
+	if (sorted != blocks) {
+		free(sorted);
+	}
+	return ret;
+}
+
+static bool block_update_hash_cb(RzAnalysisBlock *block, ut32 hash, void *user) {
+	block->bbhash = hash;
+	return true;
+}
+
+static bool block_was_modified_cb(RzAnalysisBlock *block, ut32 hash, void *user) {
+	// stop at the first modified block
+	return block->bbhash == hash;
+}
+
+/**
+ * \brief Check whether the bytes of any of \p blocks changed since their hashes were last updated
+ *
+ * Blocks whose bytes cannot be read are not considered modified.
+ */
+RZ_API bool rz_analysis_blocks_were_modified(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzAnalysisBlock **blocks, size_t count) {
+	rz_return_val_if_fail(analysis && blocks, false);
+	return !blocks_hash_foreach(analysis, blocks, count, block_was_modified_cb, NULL);
+}
+
+/**
+ * \brief Update the hashes of the bytes of all of \p blocks
+ *
+ * Same as calling rz_analysis_block_update_hash() on each block, but blocks
+ * close to each other are read at once.
+ */
+RZ_API void rz_analysis_blocks_update_hash(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzAnalysisBlock **blocks, size_t count) {
+	rz_return_if_fail(analysis && blocks);
+	blocks_hash_foreach(analysis, blocks, count, block_update_hash_cb, NULL);
+}
+
+RZ_API bool rz_analysis_block_was_modified(RzAnalysisBlock *block) {
+	rz_return_val_if_fail(block, false);
+	return rz_analysis_blocks_were_modified(block->analysis, &block, 1);
 }
 
 RZ_API void rz_analysis_block_update_hash(RzAnalysisBlock *block) {
 	rz_return_if_fail(block);
-	if (!block->analysis->iob.read_at) {
-		return;
-	}
-	ut8 *buf = malloc(block->size);
-	if (!buf) {
-		return;
-	}
-	if (!block->analysis->iob.read_at(block->analysis->iob.io, block->addr, buf, block->size)) {
-		free(buf);
-		return;
-	}
-	block->bbhash = rz_hash_xxhash(block->analysis->hash, buf, block->size);
-	free(buf);
+	rz_analysis_blocks_update_hash(block->analysis, &block, 1);
 }
 
 typedef struct {
@@ -1035,6 +1292,7 @@ RZ_API bool rz_analysis_block_set_op_offset(RzAnalysisBlock *block, size_t i, ut
 			}
 			block->op_pos_size = new_pos_size;
 			block->op_pos = tmp_op_pos;
+			RZ_MEM_TRACK(RZ_MEM_ACCOUNT_ANALYSIS, block, BLOCK_MEM_SIZE(block));
 		}
 		block->op_pos[i - 1] = v;
 		return true;
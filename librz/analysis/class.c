@@ -14,6 +14,8 @@ static void rz_analysis_class_vtable_delete_class(RzAnalysis *analysis, const ch
 static void rz_analysis_class_base_rename_class(RzAnalysis *analysis, const char *class_name_old, const char *class_name_new);
 static void rz_analysis_class_method_rename_class(RzAnalysis *analysis, const char *old_class_name, const char *new_class_name);
 static void rz_analysis_class_vtable_rename_class(RzAnalysis *analysis, const char *old_class_name, const char *new_class_name);
+static void class_methods_invalidate(RzAnalysis *analysis, const char *class_name);
+static void class_methods_set(RzAnalysis *analysis, const char *class_name, const char *meth_name, const char *content);
 
 static const char *key_class(const char *name) {
 	return name;
@@ -104,6 +106,7 @@ RZ_API void rz_analysis_class_delete(RzAnalysis *analysis, const char *name) {
 	rz_analysis_class_base_delete_class(analysis, class_name_sanitized);
 	rz_analysis_class_method_delete_class(analysis, class_name_sanitized);
 	rz_analysis_class_vtable_delete_class(analysis, class_name_sanitized);
+	class_methods_invalidate(analysis, class_name_sanitized);
 
 	if (!sdb_remove(analysis->sdb_classes, key_class(class_name_sanitized), 0)) {
 		free(class_name_sanitized);
@@ -213,6 +216,8 @@ RZ_API RzAnalysisClassErr rz_analysis_class_rename(RzAnalysis *analysis, const c
 	rz_analysis_class_base_rename_class(analysis, old_name, new_name);
 	rz_analysis_class_method_rename_class(analysis, old_name, new_name);
 	rz_analysis_class_vtable_rename_class(analysis, old_name, new_name);
+	class_methods_invalidate(analysis, old_name_sanitized);
+	class_methods_invalidate(analysis, new_name_sanitized);
 
 	if (!rename_key(analysis->sdb_classes, key_class(old_name_sanitized), key_class(new_name_sanitized))) {
 		err = RZ_ANALYSIS_CLASS_ERR_NONEXISTENT_CLASS;
@@ -330,6 +335,9 @@ static RzAnalysisClassErr rz_analysis_class_set_attr_raw(RzAnalysis *analysis, c
 		sdb_set(analysis->sdb_classes_attrs, key, content, 0);
 		free(key);
 	}
+	if (attr_type == RZ_ANALYSIS_CLASS_ATTR_TYPE_METHOD) {
+		class_methods_set(analysis, class_name, attr_id, content);
+	}
 
 	RzEventClassAttrSet event = {
 		.attr = {
@@ -386,6 +394,9 @@ static RzAnalysisClassErr rz_analysis_class_delete_attr_raw(RzAnalysis *analysis
 		}
 		free(key);
 	}
+	if (attr_type == RZ_ANALYSIS_CLASS_ATTR_TYPE_METHOD) {
+		class_methods_invalidate(analysis, class_name);
+	}
 
 	RzEventClassAttr event = {
 		.class_name = class_name,
@@ -435,6 +446,10 @@ static RzAnalysisClassErr rz_analysis_class_rename_attr_raw(RzAnalysis *analysis
 
 	sdb_array_add(analysis->sdb_classes_attrs, key, attr_id_new, 0);
 	free(key);
+	if (attr_type == RZ_ANALYSIS_CLASS_ATTR_TYPE_METHOD) {
+		// the renamed method moved to the end of the array
+		class_methods_invalidate(analysis, class_name);
+	}
 
 	key = key_attr_content(class_name, attr_type_str, attr_id_old);
 	if (key) {
@@ -636,55 +651,12 @@ RZ_API bool rz_analysis_class_method_exists(RzAnalysis *analysis, const char *cl
 	if (!content) {
 		return false;
 	}
-
+	free(content);
 	return true;
 }
 
-RZ_API bool rz_analysis_class_method_exists_by_addr(RzAnalysis *analysis, const char *class_name, ut64 addr) {
-	RzVector *vec = rz_analysis_class_method_get_all(analysis, class_name);
-	if (!vec) {
-		return false;
-	}
-	RzAnalysisMethod *meth;
-	rz_vector_foreach(vec, meth) {
-		if (meth->addr == addr) {
-			rz_vector_free(vec);
-			return true;
-		}
-	}
-	rz_vector_free(vec);
-	return false;
-}
-
-RZ_API RzAnalysisClassErr rz_analysis_class_method_get_by_addr(RzAnalysis *analysis, const char *class_name, ut64 addr, RzAnalysisMethod *method) {
-	RzVector *vec = rz_analysis_class_method_get_all(analysis, class_name);
-	if (!vec) {
-		return RZ_ANALYSIS_CLASS_ERR_OTHER;
-	}
-	RzAnalysisMethod *meth;
-	rz_vector_foreach(vec, meth) {
-		if (meth->addr == addr) {
-			method->name = rz_str_new(meth->name);
-			method->addr = meth->addr;
-			method->method_type = meth->method_type;
-			method->vtable_offset = meth->vtable_offset;
-			method->real_name = rz_str_new(meth->real_name);
-			rz_vector_free(vec);
-			return RZ_ANALYSIS_CLASS_ERR_SUCCESS;
-		}
-	}
-	rz_vector_free(vec);
-	return RZ_ANALYSIS_CLASS_ERR_OTHER;
-}
-
-// if the method exists: store it in *meth and return RZ_ANALYSIS_CLASS_ERR_SUCCESS
-// else return the error, contents of *meth are undefined
-RZ_API RzAnalysisClassErr rz_analysis_class_method_get(RzAnalysis *analysis, const char *class_name, const char *meth_name, RzAnalysisMethod *meth) {
-	char *content = rz_analysis_class_get_attr(analysis, class_name, RZ_ANALYSIS_CLASS_ATTR_TYPE_METHOD, meth_name, false);
-	if (!content) {
-		return RZ_ANALYSIS_CLASS_ERR_NONEXISTENT_ATTR;
-	}
-
+// parse the content of the attr of the method meth_name, takes ownership of content
+static RzAnalysisClassErr method_parse(char *content, const char *meth_name, RzAnalysisMethod *meth) {
 	char *cur = content;
 	char *next;
 	sdb_anext(cur, &next);
@@ -726,44 +698,223 @@ RZ_API RzAnalysisClassErr rz_analysis_class_method_get(RzAnalysis *analysis, con
 	return RZ_ANALYSIS_CLASS_ERR_SUCCESS;
 }
 
+static void method_copy(RzAnalysisMethod *dst, const RzAnalysisMethod *src) {
+	dst->name = rz_str_new(src->name);
+	dst->real_name = rz_str_new(src->real_name);
+	dst->addr = src->addr;
+	dst->vtable_offset = src->vtable_offset;
+	dst->method_type = src->method_type;
+}
+
 static void rz_analysis_class_method_fini_proxy(void *e, void *user) {
 	(void)user;
 	RzAnalysisMethod *meth = e;
 	rz_analysis_class_method_fini(meth);
 }
 
-RZ_API RzVector /*<RzAnalysisMethod>*/ *rz_analysis_class_method_get_all(RzAnalysis *analysis, const char *class_name) {
-	RzVector *vec = rz_vector_new(sizeof(RzAnalysisMethod), rz_analysis_class_method_fini_proxy, NULL);
-	if (!vec) {
-		return NULL;
+/*
+ * The methods of a class parsed from sdb_classes_attrs, built the first time
+ * the class is queried and kept in RzAnalysis.class_methods. Setting a method
+ * updates the table in place, any other change to the methods of the class
+ * drops it to be built again.
+ */
+typedef struct {
+	RzVector /*<RzAnalysisMethod>*/ methods; ///< in the order of the attr array
+	HtPU *by_name; ///< method name => index in methods
+	HtUU *by_addr; ///< address => index in methods of the first method there
+} ClassMethods;
+
+static void class_methods_free(ClassMethods *cm) {
+	if (!cm) {
+		return;
 	}
+	rz_vector_fini(&cm->methods);
+	ht_pu_free(cm->by_name);
+	ht_uu_free(cm->by_addr);
+	free(cm);
+}
 
-	char *class_name_sanitized = rz_str_sanitize_sdb_key(class_name);
-	if (!class_name_sanitized) {
-		rz_vector_free(vec);
+static void class_methods_kv_free(HtPPKv *kv) {
+	free(kv->key);
+	class_methods_free(kv->value);
+}
+
+static bool class_methods_push(ClassMethods *cm, RzAnalysisMethod *meth) {
+	ut64 idx = rz_vector_len(&cm->methods);
+	if (!rz_vector_push(&cm->methods, meth)) {
+		return false;
+	}
+	ht_pu_insert(cm->by_name, meth->name, idx);
+	ht_uu_insert(cm->by_addr, meth->addr, idx);
+	return true;
+}
+
+static ClassMethods *class_methods_build(RzAnalysis *analysis, const char *class_name) {
+	ClassMethods *cm = RZ_NEW0(ClassMethods);
+	if (!cm) {
 		return NULL;
 	}
-	char *key = key_attr_type_attrs(class_name_sanitized, attr_type_id(RZ_ANALYSIS_CLASS_ATTR_TYPE_METHOD));
-	if (!key) {
-		rz_vector_free(vec);
-		free(class_name_sanitized);
+	rz_vector_init(&cm->methods, sizeof(RzAnalysisMethod), rz_analysis_class_method_fini_proxy, NULL);
+	cm->by_name = ht_pu_new0();
+	cm->by_addr = ht_uu_new0();
+	char *key = key_attr_type_attrs(class_name, attr_type_id(RZ_ANALYSIS_CLASS_ATTR_TYPE_METHOD));
+	if (!cm->by_name || !cm->by_addr || !key) {
+		free(key);
+		class_methods_free(cm);
 		return NULL;
 	}
 	char *array = sdb_get(analysis->sdb_classes_attrs, key, 0);
 	free(key);
-	free(class_name_sanitized);
 
-	rz_vector_reserve(vec, (size_t)sdb_alen(array));
+	rz_vector_reserve(&cm->methods, (size_t)sdb_alen(array));
 	char *cur;
 	sdb_aforeach(cur, array) {
+		char *content = rz_analysis_class_get_attr_raw(analysis, class_name, RZ_ANALYSIS_CLASS_ATTR_TYPE_METHOD, cur, false);
 		RzAnalysisMethod meth;
-		if (rz_analysis_class_method_get(analysis, class_name, cur, &meth) == RZ_ANALYSIS_CLASS_ERR_SUCCESS) {
-			rz_vector_push(vec, &meth);
+		if (content && method_parse(content, cur, &meth) == RZ_ANALYSIS_CLASS_ERR_SUCCESS && !class_methods_push(cm, &meth)) {
+			rz_analysis_class_method_fini(&meth);
 		}
 		sdb_aforeach_next(cur);
 	}
 	free(array);
+	return cm;
+}
 
+// class_name must be sanitized
+static ClassMethods *class_methods_get(RzAnalysis *analysis, const char *class_name) {
+	if (!analysis->class_methods) {
+		return NULL;
+	}
+	ClassMethods *cm = ht_pp_find(analysis->class_methods, class_name, NULL);
+	if (cm) {
+		return cm;
+	}
+	cm = class_methods_build(analysis, class_name);
+	if (cm && !ht_pp_insert(analysis->class_methods, class_name, cm)) {
+		class_methods_free(cm);
+		return NULL;
+	}
+	return cm;
+}
+
+static ClassMethods *class_methods_get_unsanitized(RzAnalysis *analysis, const char *class_name) {
+	char *class_name_sanitized = rz_str_sanitize_sdb_key(class_name);
+	if (!class_name_sanitized) {
+		return NULL;
+	}
+	ClassMethods *cm = class_methods_get(analysis, class_name_sanitized);
+	free(class_name_sanitized);
+	return cm;
+}
+
+static void class_methods_invalidate(RzAnalysis *analysis, const char *class_name) {
+	if (analysis->class_methods) {
+		ht_pp_delete(analysis->class_methods, class_name);
+	}
+}
+
+// all ids must be sanitized, called after the attr of the method has been set to content
+static void class_methods_set(RzAnalysis *analysis, const char *class_name, const char *meth_name, const char *content) {
+	ClassMethods *cm = analysis->class_methods ? ht_pp_find(analysis->class_methods, class_name, NULL) : NULL;
+	if (!cm) {
+		return;
+	}
+	RzAnalysisMethod meth;
+	char *dup = strdup(content);
+	if (!dup || method_parse(dup, meth_name, &meth) != RZ_ANALYSIS_CLASS_ERR_SUCCESS) {
+		class_methods_invalidate(analysis, class_name);
+		return;
+	}
+	bool found = false;
+	ut64 idx = ht_pu_find(cm->by_name, meth_name, &found);
+	if (!found) {
+		if (!class_methods_push(cm, &meth)) {
+			rz_analysis_class_method_fini(&meth);
+			class_methods_invalidate(analysis, class_name);
+		}
+		return;
+	}
+	RzAnalysisMethod *old = rz_vector_index_ptr(&cm->methods, idx);
+	if (old->addr != meth.addr) {
+		// the first method at both addresses may change
+		rz_analysis_class_method_fini(&meth);
+		class_methods_invalidate(analysis, class_name);
+		return;
+	}
+	rz_analysis_class_method_fini(old);
+	*old = meth;
+}
+
+RZ_IPI void rz_analysis_class_methods_init(RzAnalysis *analysis) {
+	analysis->class_methods = ht_pp_new(NULL, class_methods_kv_free, NULL);
+}
+
+RZ_IPI void rz_analysis_class_methods_fini(RzAnalysis *analysis) {
+	ht_pp_free(analysis->class_methods);
+	analysis->class_methods = NULL;
+}
+
+/**
+ * \brief Drop the method tables of all classes, to be called when sdb_classes_attrs is changed directly
+ */
+RZ_IPI void rz_analysis_class_methods_reset(RzAnalysis *analysis) {
+	rz_analysis_class_methods_fini(analysis);
+	rz_analysis_class_methods_init(analysis);
+}
+
+RZ_API bool rz_analysis_class_method_exists_by_addr(RzAnalysis *analysis, const char *class_name, ut64 addr) {
+	ClassMethods *cm = class_methods_get_unsanitized(analysis, class_name);
+	if (!cm) {
+		return false;
+	}
+	bool found = false;
+	ht_uu_find(cm->by_addr, addr, &found);
+	return found;
+}
+
+RZ_API RzAnalysisClassErr rz_analysis_class_method_get_by_addr(RzAnalysis *analysis, const char *class_name, ut64 addr, RzAnalysisMethod *method) {
+	ClassMethods *cm = class_methods_get_unsanitized(analysis, class_name);
+	if (!cm) {
+		return RZ_ANALYSIS_CLASS_ERR_OTHER;
+	}
+	bool found = false;
+	ut64 idx = ht_uu_find(cm->by_addr, addr, &found);
+	if (!found) {
+		return RZ_ANALYSIS_CLASS_ERR_OTHER;
+	}
+	method_copy(method, rz_vector_index_ptr(&cm->methods, idx));
+	return RZ_ANALYSIS_CLASS_ERR_SUCCESS;
+}
+
+// if the method exists: store it in *meth and return RZ_ANALYSIS_CLASS_ERR_SUCCESS
+// else return the error, contents of *meth are undefined
+RZ_API RzAnalysisClassErr rz_analysis_class_method_get(RzAnalysis *analysis, const char *class_name, const char *meth_name, RzAnalysisMethod *meth) {
+	char *content = rz_analysis_class_get_attr(analysis, class_name, RZ_ANALYSIS_CLASS_ATTR_TYPE_METHOD, meth_name, false);
+	if (!content) {
+		return RZ_ANALYSIS_CLASS_ERR_NONEXISTENT_ATTR;
+	}
+	return method_parse(content, meth_name, meth);
+}
+
+RZ_API RzVector /*<RzAnalysisMethod>*/ *rz_analysis_class_method_get_all(RzAnalysis *analysis, const char *class_name) {
+	ClassMethods *cm = class_methods_get_unsanitized(analysis, class_name);
+	if (!cm) {
+		return NULL;
+	}
+	RzVector *vec = rz_vector_new(sizeof(RzAnalysisMethod), rz_analysis_class_method_fini_proxy, NULL);
+	if (!vec) {
+		return NULL;
+	}
+	rz_vector_reserve(vec, rz_vector_len(&cm->methods));
+	RzAnalysisMethod *meth;
+	rz_vector_foreach(&cm->methods, meth) {
+		RzAnalysisMethod *copy = rz_vector_push(vec, NULL);
+		if (!copy) {
+			rz_vector_free(vec);
+			return NULL;
+		}
+		method_copy(copy, meth);
+	}
 	return vec;
 }
 
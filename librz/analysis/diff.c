@@ -173,113 +173,288 @@ RZ_API bool rz_analysis_diff_bb(RzAnalysis *analysis, RzAnalysisFunction *fcn, R
 	return true;
 }
 
-RZ_API int rz_analysis_diff_fcn(RzAnalysis *analysis, RzList *fcns1, RzList *fcns2) {
-	RzAnalysisFunction *fcn, *fcn2, *mfcn, *mfcn2;
-	RzListIter *iter, *iter2;
-	double t, ot, sizes_div;
+/*
+ * Functions are paired in two passes: first by name, then every function left
+ * gets the most similar one left in the other list. The similarities of a
+ * batch of functions are computed in parallel against the state at the start
+ * of the batch, then the pairs are made in list order like a single thread
+ * would: a pair whose candidate got taken in the meantime is computed again.
+ */
 
-	if (!analysis) {
+#define DIFF_FCN_BATCH 256
+
+typedef struct {
+	RzAnalysisFunction *fcn;
+	size_t index; ///< position in the second list
+} DiffCand;
+
+typedef struct {
+	RzAnalysisFunction *fcn;
+	RzAnalysisFunction *fcn2; ///< pair of fcn, NULL if none
+	double dist;
+	bool ok; ///< whether dist could be computed
+} DiffPair;
+
+typedef struct {
+	DiffCand *cands; ///< candidates of the second list, sorted by fingerprint size
+	size_t n_cands;
+	DiffPair *pairs;
+} DiffFcnCtx;
+
+static void diff_fcn_pair(RzAnalysis *analysis, RzAnalysisFunction *fcn, RzAnalysisFunction *fcn2, double t) {
+	fcn->diff->dist = fcn2->diff->dist = t;
+	RZ_FREE(fcn->fingerprint);
+	RZ_FREE(fcn2->fingerprint);
+	fcn->diff->addr = fcn2->addr;
+	fcn2->diff->addr = fcn->addr;
+	fcn->diff->size = fcn2->fingerprint_size;
+	fcn2->diff->size = fcn->fingerprint_size;
+	RZ_FREE(fcn->diff->name);
+	if (fcn2->name) {
+		fcn->diff->name = strdup(fcn2->name);
+	}
+	RZ_FREE(fcn2->diff->name);
+	if (fcn->name) {
+		fcn2->diff->name = strdup(fcn->name);
+	}
+	rz_analysis_diff_bb(analysis, fcn, fcn2);
+}
+
+static void diff_fcn_for(RzThreadTaskPool *pool, size_t count, RzThreadRangeFunction fn, void *user) {
+	if (!pool || !rz_th_task_pool_parallel_for(pool, 0, count, 0, fn, user)) {
+		fn(0, count, user);
+	}
+}
+
+static void diff_fcn_named_range(size_t from, size_t to, void *user) {
+	DiffPair *pairs = user;
+	for (size_t i = from; i < to; i++) {
+		DiffPair *pair = &pairs[i];
+		pair->ok = rz_diff_levenstein_distance(pair->fcn->fingerprint, pair->fcn->fingerprint_size,
+			pair->fcn2->fingerprint, pair->fcn2->fingerprint_size, NULL, &pair->dist);
+	}
+}
+
+/*
+ * Pairs each function of fcns1 with the first one of fcns2 having the same
+ * name, or no name at all.
+ */
+static bool diff_fcn_named(RzAnalysis *analysis, RzList *fcns1, RzList *fcns2, RzThreadTaskPool *pool) {
+	RzAnalysisFunction *fcn, *fcn2;
+	RzListIter *iter;
+	size_t n2 = rz_list_length(fcns2);
+	RzAnalysisFunction **list2 = RZ_NEWS(RzAnalysisFunction *, RZ_MAX(n2, 1));
+	DiffPair *pairs = RZ_NEWS0(DiffPair, RZ_MAX(rz_list_length(fcns1), 1));
+	HtPU *names = ht_pu_new0();
+	if (!list2 || !pairs || !names) {
+		free(list2);
+		free(pairs);
+		ht_pu_free(names);
 		return false;
 	}
-	if (analysis->cur && analysis->cur->diff_fcn) {
-		return (analysis->cur->diff_fcn(analysis, fcns1, fcns2));
+	size_t i = 0, unnamed = SIZE_MAX;
+	rz_list_foreach (fcns2, iter, fcn2) {
+		if (!fcn2->name) {
+			unnamed = RZ_MIN(unnamed, i);
+		} else if (!ht_pu_find(names, fcn2->name, NULL)) {
+			ht_pu_insert(names, fcn2->name, i + 1);
+		}
+		list2[i++] = fcn2;
 	}
-	/* Compare functions with the same name */
+	size_t n = 0;
 	rz_list_foreach (fcns1, iter, fcn) {
-		rz_list_foreach (fcns2, iter2, fcn2) {
-			if (fcn->name && fcn2->name && strcmp(fcn->name, fcn2->name)) {
-				continue;
-			}
-			rz_diff_levenstein_distance(fcn->fingerprint, fcn->fingerprint_size,
-				fcn2->fingerprint, fcn2->fingerprint_size, NULL, &t);
-			/* Set flag in matched functions */
-			fcn->diff->type = fcn2->diff->type = (t >= RZ_ANALYSIS_DIFF_THRESHOLD)
-				? RZ_ANALYSIS_DIFF_TYPE_MATCH
-				: RZ_ANALYSIS_DIFF_TYPE_UNMATCH;
-			fcn->diff->dist = fcn2->diff->dist = t;
-			RZ_FREE(fcn->fingerprint);
-			RZ_FREE(fcn2->fingerprint);
-			fcn->diff->addr = fcn2->addr;
-			fcn2->diff->addr = fcn->addr;
-			fcn->diff->size = fcn2->fingerprint_size;
-			fcn2->diff->size = fcn->fingerprint_size;
-			RZ_FREE(fcn->diff->name);
-			if (fcn2->name) {
-				fcn->diff->name = strdup(fcn2->name);
-			}
-			RZ_FREE(fcn2->diff->name);
-			if (fcn->name) {
-				fcn2->diff->name = strdup(fcn->name);
-			}
-			rz_analysis_diff_bb(analysis, fcn, fcn2);
-			break;
+		size_t j = 0;
+		if (fcn->name) {
+			j = ht_pu_find(names, fcn->name, NULL);
+			j = j ? RZ_MIN(j - 1, unnamed) : unnamed;
+		}
+		if (j < n2) {
+			pairs[n].fcn = fcn;
+			pairs[n].fcn2 = list2[j];
+			n++;
 		}
 	}
-	/* Compare remaining functions */
-	rz_list_foreach (fcns1, iter, fcn) {
-		if (fcn->diff->type != RZ_ANALYSIS_DIFF_TYPE_NULL) {
-			continue;
-		} else if (!fcn->fingerprint_size) {
-			continue;
-		} else if (fcn->type != RZ_ANALYSIS_FCN_TYPE_FCN && fcn->type != RZ_ANALYSIS_FCN_TYPE_SYM) {
+	ht_pu_free(names);
+	free(list2);
+
+	diff_fcn_for(pool, n, diff_fcn_named_range, pairs);
+	double t = 0.0;
+	for (i = 0; i < n; i++) {
+		fcn = pairs[i].fcn;
+		fcn2 = pairs[i].fcn2;
+		// a function paired twice had its fingerprint freed by its first pair
+		if (pairs[i].ok && fcn->fingerprint && fcn2->fingerprint) {
+			t = pairs[i].dist;
+		}
+		/* Set flag in matched functions */
+		fcn->diff->type = fcn2->diff->type = (t >= RZ_ANALYSIS_DIFF_THRESHOLD)
+			? RZ_ANALYSIS_DIFF_TYPE_MATCH
+			: RZ_ANALYSIS_DIFF_TYPE_UNMATCH;
+		diff_fcn_pair(analysis, fcn, fcn2, t);
+	}
+	free(pairs);
+	return true;
+}
+
+static bool diff_fcn_is_candidate(RzAnalysisFunction *fcn) {
+	return fcn->diff->type == RZ_ANALYSIS_DIFF_TYPE_NULL && fcn->fingerprint_size &&
+		(fcn->type == RZ_ANALYSIS_FCN_TYPE_FCN || fcn->type == RZ_ANALYSIS_FCN_TYPE_SYM);
+}
+
+static int diff_cand_size_cmp(const void *a, const void *b) {
+	const DiffCand *x = a, *y = b;
+	if (x->fcn->fingerprint_size != y->fcn->fingerprint_size) {
+		return RZ_NUM_CMP(x->fcn->fingerprint_size, y->fcn->fingerprint_size);
+	}
+	return RZ_NUM_CMP(x->index, y->index);
+}
+
+static int diff_cand_index_cmp(const void *a, const void *b) {
+	const DiffCand *x = a, *y = b;
+	return RZ_NUM_CMP(x->index, y->index);
+}
+
+#define DIFF_CAND_SIZE_CMP(size, cand) RZ_NUM_CMP(size, (cand).fcn->fingerprint_size)
+
+/*
+ * Finds the pair of pair->fcn among the candidates left: the first one in
+ * list order which is similar enough, or else the most similar one.
+ * Candidates of a size out of [size / 2, size * 2] can't be similar enough,
+ * so only the ones between these bounds of the sorted candidates are scored.
+ */
+static void diff_fcn_best(DiffFcnCtx *ctx, DiffPair *pair) {
+	RzAnalysisFunction *fcn = pair->fcn;
+	size_t from, to;
+	rz_array_lower_bound(ctx->cands, ctx->n_cands, fcn->fingerprint_size / 2, from, DIFF_CAND_SIZE_CMP);
+	rz_array_upper_bound(ctx->cands, ctx->n_cands, fcn->fingerprint_size * 2, to, DIFF_CAND_SIZE_CMP);
+	pair->fcn2 = NULL;
+	pair->dist = 0.0;
+	DiffCand *range = to > from ? RZ_NEWS(DiffCand, to - from) : NULL;
+	if (!range) {
+		return;
+	}
+	size_t n = 0;
+	for (size_t i = from; i < to; i++) {
+		if (ctx->cands[i].fcn->diff->type == RZ_ANALYSIS_DIFF_TYPE_NULL) {
+			range[n++] = ctx->cands[i];
+		}
+	}
+	qsort(range, n, sizeof(DiffCand), diff_cand_index_cmp);
+
+	double t, ot = 0.0, sizes_div;
+	for (size_t i = 0; i < n; i++) {
+		RzAnalysisFunction *fcn2 = range[i].fcn;
+		if (fcn->fingerprint_size > fcn2->fingerprint_size) {
+			sizes_div = fcn2->fingerprint_size;
+			sizes_div /= fcn->fingerprint_size;
+		} else {
+			sizes_div = fcn->fingerprint_size;
+			sizes_div /= fcn2->fingerprint_size;
+		}
+		if (sizes_div < RZ_ANALYSIS_DIFF_THRESHOLD) {
 			continue;
 		}
-		ot = 0.0;
-		mfcn = mfcn2 = NULL;
-		rz_list_foreach (fcns2, iter2, fcn2) {
-			if (fcn2->diff->type != RZ_ANALYSIS_DIFF_TYPE_NULL) {
-				continue;
-			} else if (!fcn2->fingerprint_size) {
-				continue;
-			} else if (fcn2->type != RZ_ANALYSIS_FCN_TYPE_FCN && fcn2->type != RZ_ANALYSIS_FCN_TYPE_SYM) {
-				continue;
+		// only a pair more similar than the best one so far matters
+		ut32 max = (1.0 - ot) * RZ_MAX(fcn->fingerprint_size, fcn2->fingerprint_size);
+		rz_diff_levenstein_distance_max(fcn->fingerprint, fcn->fingerprint_size, fcn2->fingerprint, fcn2->fingerprint_size, max, NULL, &t);
+		if (t > ot) {
+			ot = t;
+			pair->fcn2 = fcn2;
+			pair->dist = t;
+			if (ot >= RZ_ANALYSIS_DIFF_THRESHOLD) {
+				break;
 			}
-			if (fcn->fingerprint_size > fcn2->fingerprint_size) {
-				sizes_div = fcn2->fingerprint_size;
-				sizes_div /= fcn->fingerprint_size;
-			} else {
-				sizes_div = fcn->fingerprint_size;
-				sizes_div /= fcn2->fingerprint_size;
+		}
+	}
+	free(range);
+}
+
+static void diff_fcn_best_range(size_t from, size_t to, void *user) {
+	DiffFcnCtx *ctx = user;
+	for (size_t i = from; i < to; i++) {
+		diff_fcn_best(ctx, &ctx->pairs[i]);
+	}
+}
+
+// Pairs each function left of fcns1 with the most similar function left of fcns2
+static bool diff_fcn_similar(RzAnalysis *analysis, RzList *fcns1, RzList *fcns2, RzThreadTaskPool *pool) {
+	RzAnalysisFunction *fcn, *fcn2;
+	RzListIter *iter;
+	DiffFcnCtx ctx = { 0 };
+	ctx.cands = RZ_NEWS(DiffCand, RZ_MAX(rz_list_length(fcns2), 1));
+	ctx.pairs = RZ_NEWS0(DiffPair, DIFF_FCN_BATCH);
+	if (!ctx.cands || !ctx.pairs) {
+		free(ctx.cands);
+		free(ctx.pairs);
+		return false;
+	}
+	size_t i = 0;
+	rz_list_foreach (fcns2, iter, fcn2) {
+		if (diff_fcn_is_candidate(fcn2)) {
+			ctx.cands[ctx.n_cands].fcn = fcn2;
+			ctx.cands[ctx.n_cands].index = i;
+			ctx.n_cands++;
+		}
+		i++;
+	}
+	qsort(ctx.cands, ctx.n_cands, sizeof(DiffCand), diff_cand_size_cmp);
+
+	iter = rz_list_iterator(fcns1);
+	while (iter) {
+		size_t n = 0;
+		for (; iter && n < DIFF_FCN_BATCH; iter = rz_list_iter_get_next(iter)) {
+			fcn = rz_list_iter_get_data(iter);
+			if (diff_fcn_is_candidate(fcn)) {
+				ctx.pairs[n++].fcn = fcn;
 			}
-			if (sizes_div < RZ_ANALYSIS_DIFF_THRESHOLD) {
+		}
+		diff_fcn_for(pool, n, diff_fcn_best_range, &ctx);
+		for (i = 0; i < n; i++) {
+			DiffPair *pair = &ctx.pairs[i];
+			fcn = pair->fcn;
+			if (fcn->diff->type != RZ_ANALYSIS_DIFF_TYPE_NULL) {
+				// paired as the candidate of a previous function of the same list
 				continue;
 			}
-			rz_diff_levenstein_distance(fcn->fingerprint, fcn->fingerprint_size, fcn2->fingerprint, fcn2->fingerprint_size, NULL, &t);
-			if (t > ot) {
-				ot = t;
-				mfcn = fcn;
-				mfcn2 = fcn2;
-				if (ot >= RZ_ANALYSIS_DIFF_THRESHOLD) {
-					break;
-				}
+			if (pair->fcn2 && pair->fcn2->diff->type != RZ_ANALYSIS_DIFF_TYPE_NULL) {
+				diff_fcn_best(&ctx, pair);
+			}
+			if (!pair->fcn2) {
+				continue;
 			}
-		}
-		if (mfcn && mfcn2) {
-			mfcn->diff->dist = mfcn2->diff->dist = ot;
 			/* Set flag in matched functions */
-			mfcn->diff->type = mfcn2->diff->type = (ot > RZ_ANALYSIS_DIFF_THRESHOLD)
+			fcn->diff->type = pair->fcn2->diff->type = (pair->dist > RZ_ANALYSIS_DIFF_THRESHOLD)
 				? RZ_ANALYSIS_DIFF_TYPE_MATCH
 				: RZ_ANALYSIS_DIFF_TYPE_UNMATCH;
-			RZ_FREE(mfcn->fingerprint);
-			RZ_FREE(mfcn2->fingerprint);
-			mfcn->diff->addr = mfcn2->addr;
-			mfcn2->diff->addr = mfcn->addr;
-			mfcn->diff->size = mfcn2->fingerprint_size;
-			mfcn2->diff->size = mfcn->fingerprint_size;
-			RZ_FREE(mfcn->diff->name);
-			if (mfcn2->name) {
-				mfcn->diff->name = strdup(mfcn2->name);
-			}
-			RZ_FREE(mfcn2->diff->name);
-			if (mfcn->name) {
-				mfcn2->diff->name = strdup(mfcn->name);
-			}
-			rz_analysis_diff_bb(analysis, mfcn, mfcn2);
+			diff_fcn_pair(analysis, fcn, pair->fcn2, pair->dist);
 		}
 	}
+	free(ctx.cands);
+	free(ctx.pairs);
 	return true;
 }
 
+/**
+ * \brief Pairs the functions of \p fcns1 with the ones of \p fcns2, in parallel on \p pool if given
+ *
+ * The result is the same as the one of rz_analysis_diff_fcn() whatever the
+ * number of threads.
+ */
+RZ_API int rz_analysis_diff_fcn_parallel(RzAnalysis *analysis, RzList *fcns1, RzList *fcns2, RZ_NULLABLE RzThreadTaskPool *pool) {
+	if (!analysis) {
+		return false;
+	}
+	if (analysis->cur && analysis->cur->diff_fcn) {
+		return (analysis->cur->diff_fcn(analysis, fcns1, fcns2));
+	}
+	return diff_fcn_named(analysis, fcns1, fcns2, pool) &&
+		diff_fcn_similar(analysis, fcns1, fcns2, pool);
+}
+
+RZ_API int rz_analysis_diff_fcn(RzAnalysis *analysis, RzList *fcns1, RzList *fcns2) {
+	return rz_analysis_diff_fcn_parallel(analysis, fcns1, fcns2, NULL);
+}
+
 RZ_API int rz_analysis_diff_eval(RzAnalysis *analysis) {
 	if (analysis && analysis->cur && analysis->cur->diff_eval) {
 		return (analysis->cur->diff_eval(analysis));
@@ -13,7 +13,7 @@ typedef struct dwarf_parse_context_t {
 	const RzBinDwarfDie *all_dies;
 	const ut64 count;
 	Sdb *sdb;
-	HtUP /*<ut64 offset, DwarfDie *die>*/ *die_map;
+	RzBinDwarfDebugInfo *info; ///< to look up the DIEs by offset
 	HtUP /*<offset, RzBinDwarfLocList*>*/ *locations;
 	char *lang; // for demangling
 } Context;
@@ -261,7 +261,7 @@ static st32 parse_type(Context *ctx, const ut64 offset, RzStrBuf *strbuf, ut64 *
 		return -1;
 	}
 	set_u_add(visited, offset);
-	RzBinDwarfDie *die = ht_up_find(ctx->die_map, offset, NULL);
+	RzBinDwarfDie *die = rz_bin_dwarf_debug_info_get_die(ctx->info, offset);
 	if (!die) {
 		return -1;
 	}
@@ -542,7 +542,7 @@ static void parse_structure_type(Context *ctx, ut64 idx) {
 	// if it is definition of previous declaration (TODO Fix, big ugly hotfix addition)
 	st32 spec_attr_idx = find_attr_idx(die, DW_AT_specification);
 	if (spec_attr_idx != -1) {
-		RzBinDwarfDie *decl_die = ht_up_find(ctx->die_map, die->attr_values[spec_attr_idx].reference, NULL);
+		RzBinDwarfDie *decl_die = rz_bin_dwarf_debug_info_get_die(ctx->info, die->attr_values[spec_attr_idx].reference);
 		if (!decl_die) {
 			rz_type_base_type_free(base_type);
 			return;
@@ -808,7 +808,7 @@ static bool prefer_linkage_name(char *lang) {
 }
 
 static void parse_abstract_origin(Context *ctx, ut64 offset, RzStrBuf *type, const char **name) {
-	RzBinDwarfDie *die = ht_up_find(ctx->die_map, offset, NULL);
+	RzBinDwarfDie *die = rz_bin_dwarf_debug_info_get_die(ctx->info, offset);
 	if (die) {
 		size_t i;
 		ut64 size = 0;
@@ -1429,7 +1429,7 @@ static void parse_function(Context *ctx, ut64 idx) {
 			break;
 		case DW_AT_specification: /* reference to declaration DIE with more info */
 		{
-			RzBinDwarfDie *spec_die = ht_up_find(ctx->die_map, val->reference, NULL);
+			RzBinDwarfDie *spec_die = rz_bin_dwarf_debug_info_get_die(ctx->info, val->reference);
 			if (spec_die) {
 				fcn.name = get_specification_die_name(spec_die); /* I assume that if specification has a name, this DIE hasn't */
 				get_spec_die_type(ctx, spec_die, &ret_type);
@@ -1596,6 +1596,9 @@ static void parse_type_entry(Context *ctx, ut64 idx) {
  * \brief Parses type and function information out of DWARF entries
  *        and stores them to the sdb for further use
  *
+ * If the debug info was parsed by rz_bin_dwarf_parse_info_lazy(), the units
+ * are decoded one at a time and unloaded once processed.
+ *
  * \param analysis
  * \param ctx
  */
@@ -1603,14 +1606,17 @@ RZ_API void rz_analysis_dwarf_process_info(const RzAnalysis *analysis, RzAnalysi
 	rz_return_if_fail(ctx && analysis);
 	Sdb *dwarf_sdb = sdb_ns(analysis->sdb, "dwarf", 1);
 	size_t i, j;
-	const RzBinDwarfDebugInfo *info = ctx->info;
+	RzBinDwarfDebugInfo *info = ctx->info;
 	for (i = 0; i < info->count; i++) {
-		RzBinDwarfCompUnit *unit = &info->comp_units[i];
+		RzBinDwarfCompUnit *unit = rz_bin_dwarf_debug_info_get_unit(info, i);
+		if (!unit) {
+			continue;
+		}
 		Context dw_context = { // context per unit?
 			.analysis = analysis,
 			.all_dies = unit->dies,
 			.count = unit->count,
-			.die_map = info->lookup_table,
+			.info = info,
 			.sdb = dwarf_sdb,
 			.locations = ctx->loc,
 			.lang = NULL
@@ -1618,6 +1624,7 @@ RZ_API void rz_analysis_dwarf_process_info(const RzAnalysis *analysis, RzAnalysi
 		for (j = 0; j < unit->count; j++) {
 			parse_type_entry(&dw_context, j);
 		}
+		rz_bin_dwarf_debug_info_unload_unit(info, i);
 	}
 }
 
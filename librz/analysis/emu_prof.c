@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+
+/**
+ * \file emu_prof.c
+ * Counting profiler for esil and il emulation, enabled with emu.profile.
+ *
+ * Every emulated instruction is accounted at its address with the time it
+ * took, and accesses to emulated memory are accounted separately, so the
+ * time spent in the op handlers is the difference of both.
+ * Times are in microseconds from rz_time_now_mono().
+ */
+
+static void insn_kv_free(HtUPKv *kv) {
+	free(kv->value);
+}
+
+/**
+ * \brief Start or stop profiling emulation in \p analysis
+ *
+ * Enabling always starts with an empty profile, disabling drops it.
+ */
+RZ_API bool rz_analysis_emu_prof_enable(RZ_NONNULL RzAnalysis *analysis, bool enable) {
+	rz_return_val_if_fail(analysis, false);
+	rz_analysis_emu_prof_free(analysis->emu_prof);
+	analysis->emu_prof = NULL;
+	if (!enable) {
+		return true;
+	}
+	RzAnalysisEmuProf *prof = RZ_NEW0(RzAnalysisEmuProf);
+	if (!prof) {
+		return false;
+	}
+	prof->insns = ht_up_new(NULL, insn_kv_free, NULL);
+	if (!prof->insns) {
+		free(prof);
+		return false;
+	}
+	analysis->emu_prof = prof;
+	return true;
+}
+
+RZ_API void rz_analysis_emu_prof_free(RZ_NULLABLE RzAnalysisEmuProf *prof) {
+	if (!prof) {
+		return;
+	}
+	ht_up_free(prof->insns);
+	free(prof);
+}
+
+/**
+ * \brief Drop everything recorded so far, keeping the profiler enabled
+ */
+RZ_API void rz_analysis_emu_prof_reset(RZ_NONNULL RzAnalysisEmuProf *prof) {
+	rz_return_if_fail(prof);
+	HtUP *insns = ht_up_new(NULL, insn_kv_free, NULL);
+	if (!insns) {
+		return;
+	}
+	ht_up_free(prof->insns);
+	int depth = prof->depth;
+	memset(prof, 0, sizeof(*prof));
+	prof->insns = insns;
+	prof->depth = depth;
+}
+
+/**
+ * Account one execution of the instruction at \p addr that took \p time
+ */
+RZ_IPI void rz_analysis_emu_prof_insn(RzAnalysisEmuProf *prof, ut64 addr, ut64 time) {
+	RzAnalysisEmuProfInsn *insn = ht_up_find(prof->insns, addr, NULL);
+	if (!insn) {
+		insn = RZ_NEW0(RzAnalysisEmuProfInsn);
+		if (!insn) {
+			return;
+		}
+		insn->addr = addr;
+		if (!ht_up_insert(prof->insns, addr, insn)) {
+			free(insn);
+			return;
+		}
+	}
+	insn->hits++;
+	insn->time += time;
+	prof->hits++;
+	prof->time_exec += time;
+}
+
+/**
+ * Account an access of \p len bytes to emulated memory that took \p time
+ */
+RZ_IPI void rz_analysis_emu_prof_mem(RzAnalysisEmuProf *prof, bool write, ut64 len, ut64 time) {
+	if (write) {
+		prof->mem_writes++;
+		prof->mem_write_bytes += len;
+	} else {
+		prof->mem_reads++;
+		prof->mem_read_bytes += len;
+	}
+	prof->time_mem += time;
+}
+
+static bool insn_collect_cb(void *user, const ut64 k, const void *v) {
+	return !!rz_pvector_push(user, (void *)v);
+}
+
+static int insn_cmp(const void *a, const void *b) {
+	const RzAnalysisEmuProfInsn *x = a;
+	const RzAnalysisEmuProfInsn *y = b;
+	if (x->time != y->time) {
+		return x->time < y->time ? 1 : -1;
+	}
+	if (x->hits != y->hits) {
+		return x->hits < y->hits ? 1 : -1;
+	}
+	return RZ_NUM_CMP(x->addr, y->addr);
+}
+
+/**
+ * \brief Get all profiled instructions, the most expensive first
+ * \return vector of entries borrowed from \p prof, valid until it is reset
+ */
+RZ_API RZ_OWN RzPVector /*<RzAnalysisEmuProfInsn *>*/ *rz_analysis_emu_prof_insns(RZ_NONNULL RzAnalysisEmuProf *prof) {
+	rz_return_val_if_fail(prof, NULL);
+	RzPVector *r = rz_pvector_new(NULL);
+	if (!r) {
+		return NULL;
+	}
+	rz_pvector_reserve(r, prof->insns->count);
+	ht_up_foreach(prof->insns, insn_collect_cb, r);
+	rz_pvector_sort(r, insn_cmp);
+	return r;
+}
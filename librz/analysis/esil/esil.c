@@ -82,6 +82,63 @@ static void esil_ops_free(HtPPKv *kv) {
 	free(kv->value);
 }
 
+/**
+ * An esil expression split into its words once, with the operations already
+ * looked up, so running it again does not need to tokenize the string nor to
+ * hash every word.
+ */
+typedef enum {
+	ESIL_TOKEN_PUSH, ///< anything that is not an operation is pushed as is
+	ESIL_TOKEN_OP,
+	ESIL_TOKEN_IF, ///< "?{", the only operation still run while skipping
+	ESIL_TOKEN_ELSE, ///< "}{"
+	ESIL_TOKEN_ENDIF, ///< "}"
+} EsilTokenKind;
+
+typedef struct {
+	EsilTokenKind kind;
+	const char *word; ///< points into EsilCompiled.words
+	RzAnalysisEsilOp *op;
+	size_t end; ///< offset of the separator after the word in EsilCompiled.expr
+} EsilToken;
+
+typedef struct {
+	char *expr; ///< the source expression, to validate the cache
+	char *words; ///< copy of expr with the separators replaced by '\0'
+	EsilToken *tokens; ///< NULL if the expression can only be interpreted
+	size_t count;
+} EsilCompiled;
+
+#define ESIL_COMPILED_MAX   0x8000
+#define ESIL_WORD_MAX       63
+
+static void esil_compiled_free(EsilCompiled *c) {
+	if (!c) {
+		return;
+	}
+	free(c->expr);
+	free(c->words);
+	free(c->tokens);
+	free(c);
+}
+
+static void esil_compiled_kv_free(HtUPKv *kv) {
+	esil_compiled_free(kv->value);
+}
+
+static void esil_compiled_clear(RzAnalysisEsil *esil) {
+	if (!esil->compiled) {
+		return;
+	}
+	if (esil->compiled_busy) {
+		esil->compiled_stale = true;
+		return;
+	}
+	ht_up_free(esil->compiled);
+	esil->compiled = NULL;
+	esil->compiled_stale = false;
+}
+
 RZ_API RzAnalysisEsil *rz_analysis_esil_new(int stacksize, int iotrap, unsigned int addrsize) {
 	RzAnalysisEsil *esil = RZ_NEW0(RzAnalysisEsil);
 	if (!esil) {
@@ -121,6 +178,8 @@ RZ_API bool rz_analysis_esil_set_op(RzAnalysisEsil *esil, const char *op, RzAnal
 			free(eop);
 			return false;
 		}
+		// compiled expressions may push this word as a value
+		esil_compiled_clear(esil);
 	}
 	eop->push = push;
 	eop->pop = pop;
@@ -169,6 +228,8 @@ RZ_API void rz_analysis_esil_free(RzAnalysisEsil *esil) {
 	}
 	ht_pp_free(esil->ops);
 	esil->ops = NULL;
+	ht_up_free(esil->compiled);
+	esil->compiled = NULL;
 	rz_analysis_esil_interrupts_fini(esil);
 	rz_analysis_esil_sources_fini(esil);
 	sdb_free(esil->stats);
@@ -202,6 +263,31 @@ static bool alignCheck(RzAnalysisEsil *esil, ut64 addr) {
 	return !(dataAlign > 0 && addr % dataAlign);
 }
 
+static void esil_io_read(RzAnalysis *analysis, ut64 addr, ut8 *buf, int len) {
+	RzAnalysisEmuProf *prof = analysis->emu_prof;
+	ut64 start = prof ? rz_time_now_mono() : 0;
+	if (analysis->emu_mem) {
+		rz_buf_read_at(analysis->emu_mem, addr, buf, len);
+	} else {
+		(void)analysis->iob.read_at(analysis->iob.io, addr, buf, len);
+	}
+	if (prof) {
+		rz_analysis_emu_prof_mem(prof, false, len, rz_time_now_mono() - start);
+	}
+}
+
+static bool esil_io_write(RzAnalysis *analysis, ut64 addr, const ut8 *buf, int len) {
+	RzAnalysisEmuProf *prof = analysis->emu_prof;
+	ut64 start = prof ? rz_time_now_mono() : 0;
+	bool ret = analysis->emu_mem
+		? rz_buf_write_at(analysis->emu_mem, addr, buf, len) == len
+		: analysis->iob.write_at(analysis->iob.io, addr, buf, len);
+	if (prof) {
+		rz_analysis_emu_prof_mem(prof, true, len, rz_time_now_mono() - start);
+	}
+	return ret;
+}
+
 static int internal_esil_mem_read(RzAnalysisEsil *esil, ut64 addr, ut8 *buf, int len) {
 	rz_return_val_if_fail(esil && esil->analysis && esil->analysis->iob.io, 0);
 
@@ -219,7 +305,7 @@ static int internal_esil_mem_read(RzAnalysisEsil *esil, ut64 addr, ut8 *buf, int
 		}
 	}
 	// TODO: Check if error return from read_at.(on previous version of r2 this call always return len)
-	(void)esil->analysis->iob.read_at(esil->analysis->iob.io, addr, buf, len);
+	esil_io_read(esil->analysis, addr, buf, len);
 	// check if request address is mapped , if don't fire trap and esil ioer callback
 	// now with siol, read_at return true/false can't be used to check error vs len
 	if (!esil->analysis->iob.is_valid_offset(esil->analysis->iob.io, addr, false)) {
@@ -244,7 +330,7 @@ static int internal_esil_mem_read_no_null(RzAnalysisEsil *esil, ut64 addr, ut8 *
 		return false;
 	}
 	// TODO: Check if error return from read_at.(on previous version of r2 this call always return len)
-	(void)esil->analysis->iob.read_at(esil->analysis->iob.io, addr, buf, len);
+	esil_io_read(esil->analysis, addr, buf, len);
 	// check if request address is mapped , if don't fire trap and esil ioer callback
 	// now with siol, read_at return true/false can't be used to check error vs len
 	if (!esil->analysis->iob.is_valid_offset(esil->analysis->iob.io, addr, false)) {
@@ -298,7 +384,7 @@ static int internal_esil_mem_write(RzAnalysisEsil *esil, ut64 addr, const ut8 *b
 			}
 		}
 	}
-	if (esil->analysis->iob.write_at(esil->analysis->iob.io, addr, buf, len)) {
+	if (esil_io_write(esil->analysis, addr, buf, len)) {
 		ret = len;
 	}
 	// check if request address is mapped , if don't fire trap and esil ioer callback
@@ -324,7 +410,7 @@ static int internal_esil_mem_write_no_null(RzAnalysisEsil *esil, ut64 addr, cons
 		return 0;
 	}
 	addr &= esil->addrmask;
-	if (esil->analysis->iob.write_at(esil->analysis->iob.io, addr, buf, len)) {
+	if (esil_io_write(esil->analysis, addr, buf, len)) {
 		ret = len;
 	}
 	// check if request address is mapped , if don't fire trap and esil ioer callback
@@ -2864,6 +2950,23 @@ static bool iscommand(RzAnalysisEsil *esil, const char *word, RzAnalysisEsilOp *
 	return false;
 }
 
+static bool runop(RzAnalysisEsil *esil, const char *word, RzAnalysisEsilOp *op) {
+	if (esil->cb.hook_command) {
+		if (esil->cb.hook_command(esil, word)) {
+			return 1; // XXX cannot return != 1
+		}
+	}
+	rz_strbuf_set(&esil->current_opstr, word);
+	// so this is basically just sharing what's the operation with the operation
+	// useful for wrappers
+	const bool ret = op->code(esil);
+	rz_strbuf_fini(&esil->current_opstr);
+	if (!ret) {
+		ESIL_LOG("%s returned 0\n", word);
+	}
+	return ret;
+}
+
 static bool runword(RzAnalysisEsil *esil, const char *word) {
 	RzAnalysisEsilOp *op = NULL;
 	if (!word) {
@@ -2898,20 +3001,7 @@ static bool runword(RzAnalysisEsil *esil, const char *word) {
 	if (iscommand(esil, word, &op)) {
 		// run action
 		if (op) {
-			if (esil->cb.hook_command) {
-				if (esil->cb.hook_command(esil, word)) {
-					return 1; // XXX cannot return != 1
-				}
-			}
-			rz_strbuf_set(&esil->current_opstr, word);
-			// so this is basically just sharing what's the operation with the operation
-			// useful for wrappers
-			const bool ret = op->code(esil);
-			rz_strbuf_fini(&esil->current_opstr);
-			if (!ret) {
-				ESIL_LOG("%s returned 0\n", word);
-			}
-			return ret;
+			return runop(esil, word, op);
 		}
 	}
 	if (!*word || *word == ',') {
@@ -2995,32 +3085,205 @@ static bool __stepOut(RzAnalysisEsil *esil, const char *cmd) {
 	return false;
 }
 
-RZ_API bool rz_analysis_esil_parse(RzAnalysisEsil *esil, const char *str) {
+/**
+ * Split \p str into tokens. Only plain comma separated lists of words are
+ * compiled, anything with quirks of the string interpreter (';', "#!",
+ * empty or too long words) gets an entry without tokens and keeps being
+ * interpreted, so both ways always behave the same.
+ */
+static EsilCompiled *esil_compile(RzAnalysisEsil *esil, const char *str) {
+	EsilCompiled *c = RZ_NEW0(EsilCompiled);
+	if (!c || !(c->expr = strdup(str))) {
+		free(c);
+		return NULL;
+	}
+	if (strchr(str, ';') || strstr(str, "#!")) {
+		return c;
+	}
+	size_t count = 1;
+	for (const char *p = str; *p; p++) {
+		count += *p == ',';
+	}
+	c->words = strdup(str);
+	c->tokens = RZ_NEWS0(EsilToken, count);
+	if (!c->words || !c->tokens) {
+		esil_compiled_free(c);
+		return NULL;
+	}
+	char *word = c->words;
+	for (size_t i = 0; i < count; i++) {
+		char *sep = strchr(word, ',');
+		if (sep) {
+			*sep = '\0';
+		}
+		size_t len = strlen(word);
+		if (!len || len >= ESIL_WORD_MAX) {
+			RZ_FREE(c->words);
+			RZ_FREE(c->tokens);
+			return c;
+		}
+		EsilToken *tok = &c->tokens[i];
+		tok->word = word;
+		tok->end = word - c->words + len;
+		if (!strcmp(word, "}{")) {
+			tok->kind = ESIL_TOKEN_ELSE;
+		} else if (!strcmp(word, "}")) {
+			tok->kind = ESIL_TOKEN_ENDIF;
+		} else if (iscommand(esil, word, &tok->op)) {
+			tok->kind = !strcmp(word, "?{") ? ESIL_TOKEN_IF : ESIL_TOKEN_OP;
+		} else {
+			tok->kind = ESIL_TOKEN_PUSH;
+		}
+		word += len + 1;
+	}
+	c->count = count;
+	return c;
+}
+
+/**
+ * Returns the compiled form of \p str cached for esil->address, compiling
+ * it if needed. NULL means the expression is interpreted.
+ */
+static EsilCompiled *esil_compiled_get(RzAnalysisEsil *esil, const char *str) {
+	EsilCompiled *c = esil->compiled ? ht_up_find(esil->compiled, esil->address, NULL) : NULL;
+	if (c && !strcmp(c->expr, str)) {
+		return c->tokens ? c : NULL;
+	}
+	if (esil->compiled_busy) {
+		// an expression is being run from the cache, replacing entries could free it
+		return NULL;
+	}
+	if (!esil->compiled || esil->compiled->count >= ESIL_COMPILED_MAX) {
+		ht_up_free(esil->compiled);
+		esil->compiled = ht_up_new(NULL, esil_compiled_kv_free, NULL);
+		if (!esil->compiled) {
+			return NULL;
+		}
+	}
+	c = esil_compile(esil, str);
+	if (!c || !ht_up_update(esil->compiled, esil->address, c)) {
+		esil_compiled_free(c);
+		return NULL;
+	}
+	return c->tokens ? c : NULL;
+}
+
+/**
+ * Same as runword() but with the word already classified
+ */
+static bool runtoken(RzAnalysisEsil *esil, const EsilToken *tok) {
+	esil->parse_goto_count--;
+	if (esil->parse_goto_count < 1) {
+		ESIL_LOG("ESIL infinite loop detected\n");
+		esil->trap = 1; // INTERNAL ERROR
+		esil->parse_stop = 1; // INTERNAL ERROR
+		return false;
+	}
+	switch (tok->kind) {
+	case ESIL_TOKEN_ELSE:
+		if (esil->skip == 1) {
+			esil->skip = 0;
+		} else if (esil->skip == 0) {
+			esil->skip = 1;
+		}
+		return true;
+	case ESIL_TOKEN_ENDIF:
+		if (esil->skip) {
+			esil->skip--;
+		}
+		return true;
+	case ESIL_TOKEN_IF:
+		return runop(esil, tok->word, tok->op);
+	default:
+		break;
+	}
+	if (esil->skip) {
+		return true;
+	}
+	if (tok->kind == ESIL_TOKEN_OP) {
+		return runop(esil, tok->word, tok->op);
+	}
+	if (!rz_analysis_esil_push(esil, tok->word)) {
+		ESIL_LOG("ESIL stack is full\n");
+		esil->trap = 1;
+		esil->trap_code = 1;
+	}
+	return true;
+}
+
+static void parse_reset(RzAnalysisEsil *esil) {
+	esil->repeat = 0;
+	esil->skip = 0;
+	esil->parse_goto = -1;
+	esil->parse_stop = 0;
+	esil->parse_goto_count = esil->analysis ? esil->analysis->esil_goto_limit : RZ_ANALYSIS_ESIL_GOTO_LIMIT;
+}
+
+/**
+ * Runs a compiled expression exactly like the loop of rz_analysis_esil_parse()
+ * would run its string.
+ */
+static bool parse_compiled(RzAnalysisEsil *esil, const EsilCompiled *c) {
+loop:
+	parse_reset(esil);
+	for (size_t i = 0; i < c->count;) {
+		if (!runtoken(esil, &c->tokens[i])) {
+			return false;
+		}
+		if (esil->repeat) {
+			goto loop;
+		}
+		if (esil->parse_goto != -1) {
+			if (esil->parse_goto < 0 || (size_t)esil->parse_goto >= c->count) {
+				ESIL_LOG("Cannot find word %d\n", esil->parse_goto);
+				return false;
+			}
+			i = esil->parse_goto;
+			esil->parse_goto = -1;
+			continue;
+		}
+		if (esil->parse_stop) {
+			if (esil->parse_stop == 2 && i + 1 < c->count) {
+				RZ_LOG_DEBUG("[esil at 0x%08" PFMT64x "] TODO: %s\n", esil->address, c->expr + c->tokens[i].end + 1);
+			}
+			return false;
+		}
+		i++;
+	}
+	return true;
+}
+
+static bool esil_parse(RzAnalysisEsil *esil, const char *str) {
 	int wordi = 0;
 	int dorunword;
 	char word[64];
 	const char *ostr = str;
-	rz_return_val_if_fail(esil && RZ_STR_ISNOTEMPTY(str), 0);
 
 	if (__stepOut(esil, esil->cmd_step)) {
 		(void)__stepOut(esil, esil->cmd_step_out);
 		return true;
 	}
-	const char *hashbang = strstr(str, "#!");
 	esil->trap = 0;
 	if (esil->cmd && esil->cmd_todo) {
 		if (!strncmp(str, "TODO", 4)) {
 			esil->cmd(esil, esil->cmd_todo, esil->address, 0);
 		}
 	}
+	EsilCompiled *compiled = esil_compiled_get(esil, str);
+	if (compiled) {
+		esil->compiled_busy++;
+		bool ret = parse_compiled(esil, compiled);
+		if (!--esil->compiled_busy && esil->compiled_stale) {
+			esil_compiled_clear(esil);
+		}
+		__stepOut(esil, esil->cmd_step_out);
+		return ret;
+	}
+	const char *hashbang = strstr(str, "#!");
 loop:
-	esil->repeat = 0;
-	esil->skip = 0;
-	esil->parse_goto = -1;
-	esil->parse_stop = 0;
+	parse_reset(esil);
 	// memleak or failing aetr test. wat du
 	//	rz_analysis_esil_stack_free (esil);
-	esil->parse_goto_count = esil->analysis ? esil->analysis->esil_goto_limit : RZ_ANALYSIS_ESIL_GOTO_LIMIT;
 	str = ostr;
 repeat:
 	wordi = 0;
@@ -3092,6 +3355,25 @@ repeat:
 	return 1;
 }
 
+RZ_API bool rz_analysis_esil_parse(RzAnalysisEsil *esil, const char *str) {
+	rz_return_val_if_fail(esil && RZ_STR_ISNOTEMPTY(str), 0);
+	RzAnalysisEmuProf *prof = esil->analysis ? esil->analysis->emu_prof : NULL;
+	if (!prof || prof->depth) {
+		// nested expressions are part of the outermost one
+		return esil_parse(esil, str);
+	}
+	prof->depth++;
+	ut64 start = rz_time_now_mono();
+	bool ret = esil_parse(esil, str);
+	// the expression may have toggled emu.profile
+	prof = esil->analysis->emu_prof;
+	if (prof && prof->depth) {
+		prof->depth--;
+		rz_analysis_emu_prof_insn(prof, esil->address, rz_time_now_mono() - start);
+	}
+	return ret;
+}
+
 RZ_API bool rz_analysis_esil_runword(RzAnalysisEsil *esil, const char *word) {
 	(void)runword(esil, word);
 	// for some reasons this is called twice in the original code from condret.
@@ -4,9 +4,6 @@
 
 #include <rz_analysis.h>
 
-#define CMP_REG_CHANGE(x, y) ((x) - ((RzAnalysisEsilRegChange *)(y))->idx)
-#define CMP_MEM_CHANGE(x, y) ((x) - ((RzAnalysisEsilMemChange *)(y))->idx)
-
 static int ocbs_set = false;
 static RzAnalysisEsilCallbacks ocbs = { 0 };
 
@@ -21,104 +18,138 @@ static inline bool esil_add_reg_trace(RzAnalysisEsilTrace *etrace, RzILTraceRegO
 	return rz_analysis_il_trace_add_reg(instr_trace, reg);
 }
 
-static void htup_vector_free(HtUPKv *kv) {
-	rz_vector_free(kv->value);
+// memory of the emulation, see emu.cow
+static void trace_mem_read(RzAnalysis *analysis, ut64 addr, ut8 *buf, ut64 len) {
+	if (analysis->emu_mem) {
+		rz_buf_read_at(analysis->emu_mem, addr, buf, len);
+		return;
+	}
+	analysis->iob.read_at(analysis->iob.io, addr, buf, len);
+}
+
+static void trace_mem_write(RzAnalysis *analysis, ut64 addr, const ut8 *buf, ut64 len) {
+	if (analysis->emu_mem) {
+		rz_buf_write_at(analysis->emu_mem, addr, buf, len);
+		return;
+	}
+	analysis->iob.write_at(analysis->iob.io, addr, buf, len);
 }
 
 RZ_API RzAnalysisEsilTrace *rz_analysis_esil_trace_new(RzAnalysisEsil *esil) {
-	rz_return_val_if_fail(esil && esil->stack_addr && esil->stack_size, NULL);
-	size_t i;
+	rz_return_val_if_fail(esil, NULL);
 	RzAnalysisEsilTrace *trace = RZ_NEW0(RzAnalysisEsilTrace);
 	if (!trace) {
 		return NULL;
 	}
-	trace->registers = ht_up_new(NULL, htup_vector_free, NULL);
-	if (!trace->registers) {
-		RZ_LOG_ERROR("esil: Cannot allocate hashmap for trace registers\n");
-		goto error;
-	}
-	trace->memory = ht_up_new(NULL, htup_vector_free, NULL);
-	if (!trace->memory) {
-		RZ_LOG_ERROR("esil: Cannot allocate hashmap for trace memory\n");
-		goto error;
-	}
+	rz_pvector_init(&trace->changes, free);
+	rz_vector_init(&trace->checkpoints, sizeof(ut64), NULL, NULL);
 	trace->instructions = rz_pvector_new((RzPVectorFree)rz_analysis_il_trace_instruction_free);
 	if (!trace->instructions) {
 		RZ_LOG_ERROR("esil: Cannot allocate vector for trace instructions\n");
-		goto error;
-	}
-	// Save initial ESIL stack memory
-	trace->stack_addr = esil->stack_addr;
-	trace->stack_size = esil->stack_size;
-	trace->stack_data = malloc(esil->stack_size);
-	if (!trace->stack_data) {
-		RZ_LOG_ERROR("esil: Cannot allocate stack for trace\n");
-		goto error;
-	}
-	esil->analysis->iob.read_at(esil->analysis->iob.io, trace->stack_addr,
-		trace->stack_data, trace->stack_size);
-	// Save initial registers arenas
-	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
-		RzRegArena *a = esil->analysis->reg->regset[i].arena;
-		RzRegArena *b = rz_reg_arena_new(a->size);
-		if (!b) {
-			RZ_LOG_ERROR("esil: Cannot allocate register arena for trace\n");
-			goto error;
-		}
-		if (b->bytes && a->bytes && b->size > 0) {
-			memcpy(b->bytes, a->bytes, b->size);
-		}
-		trace->arena[i] = b;
+		rz_analysis_esil_trace_free(trace);
+		return NULL;
 	}
 	return trace;
-error:
-	rz_analysis_esil_trace_free(trace);
-	return NULL;
 }
 
 RZ_API void rz_analysis_esil_trace_free(RzAnalysisEsilTrace *trace) {
 	if (!trace) {
 		return;
 	}
-	size_t i;
-	ht_up_free(trace->registers);
-	ht_up_free(trace->memory);
-	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
-		rz_reg_arena_free(trace->arena[i]);
-	}
-	free(trace->stack_data);
+	rz_pvector_fini(&trace->changes);
+	rz_vector_fini(&trace->checkpoints);
 	rz_pvector_free(trace->instructions);
 	trace->instructions = NULL;
 	RZ_FREE(trace);
 }
 
-static void add_reg_change(RzAnalysisEsilTrace *trace, int idx, RzRegItem *ri, ut64 data) {
-	ut64 addr = ri->offset | (ri->arena << 16);
-	RzVector *vreg = ht_up_find(trace->registers, addr, NULL);
-	if (!vreg) {
-		vreg = rz_vector_new(sizeof(RzAnalysisEsilRegChange), NULL, NULL);
-		if (!vreg) {
-			RZ_LOG_ERROR("Creating a register vector.\n");
-			return;
+static RzAnalysisEsilTraceChange *change_at(RzAnalysisEsilTrace *trace, ut64 pos) {
+	RzAnalysisEsilTraceChange *chunk = rz_pvector_at(&trace->changes, (pos - trace->changes_base) / RZ_ANALYSIS_ESIL_TRACE_CHUNK_SIZE);
+	return &chunk[pos % RZ_ANALYSIS_ESIL_TRACE_CHUNK_SIZE];
+}
+
+/**
+ * Drop the oldest chunk of the log, unless it still has changes of the current instruction.
+ * States before the last change in it can't be restored afterwards.
+ */
+static void drop_oldest_chunk(RzAnalysisEsilTrace *trace) {
+	RzAnalysisEsilTraceChange *chunk = rz_pvector_at(&trace->changes, 0);
+	int last_idx = chunk[RZ_ANALYSIS_ESIL_TRACE_CHUNK_SIZE - 1].idx;
+	if (last_idx > trace->idx) {
+		return;
+	}
+	free(rz_pvector_remove_at(&trace->changes, 0));
+	trace->changes_base += RZ_ANALYSIS_ESIL_TRACE_CHUNK_SIZE;
+	for (int i = trace->start_idx; i < last_idx && i < rz_pvector_len(trace->instructions); i++) {
+		rz_analysis_il_trace_instruction_free(rz_pvector_at(trace->instructions, i));
+		rz_pvector_set(trace->instructions, i, NULL);
+	}
+	trace->start_idx = last_idx;
+}
+
+/**
+ * Append a new change to the end of the log, which is also where the current state is.
+ */
+static RzAnalysisEsilTraceChange *add_change(RzAnalysisEsilTrace *trace, int idx) {
+	if (!(trace->changes_count % RZ_ANALYSIS_ESIL_TRACE_CHUNK_SIZE)) {
+		if (trace->max_changes && !rz_pvector_empty(&trace->changes) &&
+			trace->changes_count - trace->changes_base >= trace->max_changes) {
+			drop_oldest_chunk(trace);
+		}
+		RzAnalysisEsilTraceChange *chunk = RZ_NEWS(RzAnalysisEsilTraceChange, RZ_ANALYSIS_ESIL_TRACE_CHUNK_SIZE);
+		if (!chunk || !rz_pvector_push(&trace->changes, chunk)) {
+			RZ_LOG_ERROR("esil: Cannot allocate chunk for trace changes\n");
+			free(chunk);
+			return NULL;
 		}
-		ht_up_insert(trace->registers, addr, vreg);
 	}
-	RzAnalysisEsilRegChange reg = { idx, data };
-	rz_vector_push(vreg, &reg);
+	RzAnalysisEsilTraceChange *c = change_at(trace, trace->changes_count++);
+	trace->changes_applied = trace->changes_count;
+	c->idx = idx;
+	return c;
 }
 
-static void add_mem_change(RzAnalysisEsilTrace *trace, int idx, ut64 addr, ut8 data) {
-	RzVector *vmem = ht_up_find(trace->memory, addr, NULL);
-	if (!vmem) {
-		vmem = rz_vector_new(sizeof(RzAnalysisEsilMemChange), NULL, NULL);
-		if (!vmem) {
-			RZ_LOG_ERROR("Creating a memory vector.\n");
-			return;
+static void add_reg_change(RzAnalysis *analysis, RzAnalysisEsilTrace *trace, int idx, RzRegItem *ri, ut64 old, ut64 data) {
+	RzAnalysisEsilTraceChange *c = add_change(trace, idx);
+	if (!c) {
+		return;
+	}
+	c->size = 0;
+	c->reg = rz_str_constpool_get(&analysis->constpool, ri->name);
+	c->addr = 0;
+	c->old = old;
+	c->data = data;
+}
+
+/**
+ * \return the value of the pc in the state at the end of the log, or \p fallback if there is none
+ */
+static ut64 logged_pc(RzAnalysis *analysis, RzAnalysisEsilTrace *trace, RzRegItem *pc_ri, ut64 fallback) {
+	// every instruction adds a pc change, so this only goes back a single instruction
+	const char *pc = rz_str_constpool_get(&analysis->constpool, pc_ri->name);
+	for (ut64 pos = trace->changes_count; pos > trace->changes_base; pos--) {
+		RzAnalysisEsilTraceChange *c = change_at(trace, pos - 1);
+		if (c->reg == pc) {
+			return c->data;
 		}
-		ht_up_insert(trace->memory, addr, vmem);
 	}
-	RzAnalysisEsilMemChange mem = { idx, data };
-	rz_vector_push(vmem, &mem);
+	return fallback;
+}
+
+static void add_mem_change(RzAnalysis *analysis, RzAnalysisEsilTrace *trace, int idx, ut64 addr, const ut8 *data, ut8 size) {
+	RzAnalysisEsilTraceChange *c = add_change(trace, idx);
+	if (!c) {
+		return;
+	}
+	ut8 buf[sizeof(ut64)] = { 0 };
+	trace_mem_read(analysis, addr, buf, size);
+	c->size = size;
+	c->reg = NULL;
+	c->addr = addr;
+	c->old = rz_read_le64(buf);
+	memset(buf, 0, sizeof(buf));
+	memcpy(buf, data, size);
+	c->data = rz_read_le64(buf);
 }
 
 static int trace_hook_reg_read(RzAnalysisEsil *esil, const char *name, ut64 *res, int *size) {
@@ -170,7 +201,10 @@ static int trace_hook_reg_write(RzAnalysisEsil *esil, const char *name, ut64 *va
 	}
 
 	RzRegItem *ri = rz_reg_get(esil->analysis->reg, name, -1);
-	add_reg_change(esil->trace, esil->trace->idx + 1, ri, *val);
+	if (ri) {
+		ut64 old = rz_reg_get_value(esil->analysis->reg, ri);
+		add_reg_change(esil->analysis, esil->trace, esil->trace->idx + 1, ri, old, *val);
+	}
 	if (ocbs.hook_reg_write) {
 		RzAnalysisEsilCallbacks cbs = esil->cb;
 		esil->cb = ocbs;
@@ -241,8 +275,8 @@ static int trace_hook_mem_write(RzAnalysisEsil *esil, ut64 addr, const ut8 *buf,
 		RZ_FREE(mem_write);
 	}
 
-	for (i = 0; i < len; i++) {
-		add_mem_change(esil->trace, esil->trace->idx + 1, addr + i, buf[i]);
+	for (i = 0; i < len; i += sizeof(ut64)) {
+		add_mem_change(esil->analysis, esil->trace, esil->trace->idx + 1, addr + i, buf + i, RZ_MIN(sizeof(ut64), len - i));
 	}
 
 	if (ocbs.hook_mem_write) {
@@ -297,8 +331,24 @@ RZ_API void rz_analysis_esil_trace_op(RzAnalysisEsil *esil, RZ_NONNULL RzAnalysi
 	RzILTraceInstruction *instruction = rz_analysis_il_trace_instruction_new(op->addr);
 	rz_pvector_push(esil->trace->instructions, instruction);
 
+	RzAnalysisEsilTrace *trace = esil->trace;
 	RzRegItem *pc_ri = rz_reg_get(esil->analysis->reg, "PC", -1);
-	add_reg_change(esil->trace, esil->trace->idx, pc_ri, op->addr);
+	ut64 pc = pc_ri ? rz_reg_get_value(esil->analysis->reg, pc_ri) : 0;
+	if (pc_ri) {
+		add_reg_change(esil->analysis, trace, trace->idx, pc_ri, logged_pc(esil->analysis, trace, pc_ri, pc), op->addr);
+	}
+	if (!(trace->idx % RZ_ANALYSIS_ESIL_TRACE_CHECKPOINT)) {
+		// all changes so far make up the state at idx
+		ut64 pos = trace->changes_count;
+		rz_vector_push(&trace->checkpoints, &pos);
+	}
+	if (pc_ri) {
+		// The state at idx has the pc at the instruction, but while emulating it,
+		// the pc may already point to the next one.
+		if (pc != op->addr) {
+			add_reg_change(esil->analysis, trace, trace->idx + 1, pc_ri, op->addr, pc);
+		}
+	}
 	/* set hooks */
 	esil->verbose = 0;
 	esil->cb.hook_reg_read = trace_hook_reg_read;
@@ -318,58 +368,55 @@ RZ_API void rz_analysis_esil_trace_op(RzAnalysisEsil *esil, RZ_NONNULL RzAnalysi
 	esil->trace->end_idx++;
 }
 
-static bool restore_memory_cb(void *user, const ut64 key, const void *value) {
-	size_t index;
-	RzAnalysisEsil *esil = user;
-	RzVector *vmem = (RzVector *)value;
-
-	rz_vector_upper_bound(vmem, esil->trace->idx, index, CMP_MEM_CHANGE);
-	if (index > 0 && index <= vmem->len) {
-		RzAnalysisEsilMemChange *c = rz_vector_index_ptr(vmem, index - 1);
-		esil->analysis->iob.write_at(esil->analysis->iob.io, key, &c->data, 1);
+static void change_apply(RzAnalysisEsil *esil, RzAnalysisEsilTraceChange *c, bool undo) {
+	ut64 val = undo ? c->old : c->data;
+	if (c->reg) {
+		RzRegItem *ri = rz_reg_get(esil->analysis->reg, c->reg, -1);
+		if (ri) {
+			rz_reg_set_value(esil->analysis->reg, ri, val);
+		}
+		return;
 	}
-	return true;
+	ut8 buf[sizeof(ut64)];
+	rz_write_le64(buf, val);
+	trace_mem_write(esil->analysis, c->addr, buf, c->size);
 }
 
-static bool restore_register(RzAnalysisEsil *esil, RzRegItem *ri, int idx) {
-	size_t index;
-	RzVector *vreg = ht_up_find(esil->trace->registers, ri->offset | (ri->arena << 16), NULL);
-	if (vreg) {
-		rz_vector_upper_bound(vreg, idx, index, CMP_REG_CHANGE);
-		if (index > 0 && index <= vreg->len) {
-			RzAnalysisEsilRegChange *c = rz_vector_index_ptr(vreg, index - 1);
-			rz_reg_set_value(esil->analysis->reg, ri, c->data);
-		}
-	}
-	return true;
+/**
+ * \return the number of changes that make up the state at \p idx
+ */
+static ut64 changes_at_idx(RzAnalysisEsilTrace *trace, int idx) {
+	// start at the closest indexed index below and skip the remaining changes
+	ut64 pos = trace->changes_base;
+	size_t cp = idx / RZ_ANALYSIS_ESIL_TRACE_CHECKPOINT;
+	if (!rz_vector_empty(&trace->checkpoints)) {
+		cp = RZ_MIN(cp, rz_vector_len(&trace->checkpoints) - 1);
+		pos = RZ_MAX(pos, *(ut64 *)rz_vector_index_ptr(&trace->checkpoints, cp));
+	}
+	while (pos < trace->changes_count && change_at(trace, pos)->idx <= idx) {
+		pos++;
+	}
+	return pos;
 }
 
+/**
+ * \brief Restore registers and memory to the state at trace index \p idx
+ *
+ * Only the changes between the current and the requested state are undone or redone.
+ * \p idx is clamped to the indices that are still held by the trace.
+ */
 RZ_API void rz_analysis_esil_trace_restore(RzAnalysisEsil *esil, int idx) {
-	rz_return_if_fail(esil);
-	size_t i;
+	rz_return_if_fail(esil && esil->trace);
 	RzAnalysisEsilTrace *trace = esil->trace;
-	// Restore initial state when going backward
-	if (idx < esil->trace->idx) {
-		// Restore initial registers value
-		for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
-			RzRegArena *a = esil->analysis->reg->regset[i].arena;
-			RzRegArena *b = trace->arena[i];
-			if (a && b) {
-				memcpy(a->bytes, b->bytes, a->size);
-			}
-		}
-		// Restore initial stack memory
-		esil->analysis->iob.write_at(esil->analysis->iob.io, trace->stack_addr,
-			trace->stack_data, trace->stack_size);
-	}
-	// Apply latest changes to registers and memory
-	esil->trace->idx = idx;
-	RzListIter *iter;
-	RzRegItem *ri;
-	rz_list_foreach (esil->analysis->reg->allregs, iter, ri) {
-		restore_register(esil, ri, idx);
-	}
-	ht_up_foreach(trace->memory, restore_memory_cb, esil);
+	idx = RZ_MAX(RZ_MIN(idx, trace->end_idx), trace->start_idx);
+	ut64 pos = changes_at_idx(trace, idx);
+	while (trace->changes_applied > pos) {
+		change_apply(esil, change_at(trace, --trace->changes_applied), true);
+	}
+	while (trace->changes_applied < pos) {
+		change_apply(esil, change_at(trace, trace->changes_applied++), false);
+	}
+	trace->idx = idx;
 }
 
 static void print_instruction_ops(RzILTraceInstruction *instruction, int idx, RzILTraceInsOp focus) {
@@ -442,7 +489,9 @@ RZ_API void rz_analysis_esil_trace_list(RzAnalysisEsil *esil) {
 	void **iter;
 	rz_pvector_foreach (esil->trace->instructions, iter) {
 		instruction_trace = *iter;
-		print_instruction_trace(instruction_trace, idx);
+		if (instruction_trace) {
+			print_instruction_trace(instruction_trace, idx);
+		}
 		idx++;
 	}
 	rz_cons_printf("idx=%d\n", idx - 1);
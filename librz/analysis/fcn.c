@@ -8,7 +8,6 @@
 #include <rz_util.h>
 #include <rz_list.h>
 
-#define READ_AHEAD 1
 #define SDB_KEY_BB "bb.0x%" PFMT64x ".0x%" PFMT64x
 // XXX must be configurable by the user
 #define JMPTBL_LEA_SEARCH_SZ 64
@@ -45,46 +44,73 @@ RZ_API const char *rz_analysis_fcntype_tostring(int type) {
 	return "unk";
 }
 
-#if READ_AHEAD
-static ut64 cache_addr = UT64_MAX;
-
-// TODO: move into io :?
+/**
+ * \brief Read \p len bytes at \p addr, going through the analysis read-ahead window
+ *
+ * On a miss the whole window (analysis.readahead bytes) is filled starting at
+ * \p addr with one single io read, so the following instructions of the same
+ * block are decoded without going back to io.
+ */
 static int read_ahead(RzAnalysis *analysis, ut64 addr, ut8 *buf, int len) {
-	static ut8 cache[1024];
-	const int cache_len = sizeof(cache);
-
+	RzAnalysisReadAhead *ra = &analysis->read_ahead;
 	if (len < 1) {
 		return 0;
 	}
-	if (len > cache_len) {
-		int a = analysis->iob.read_at(analysis->iob.io, addr, buf, len); // double read
-		memcpy(cache, buf, cache_len);
-		cache_addr = addr;
-		return a;
+	if (!ra->buf || len > ra->size) {
+		return analysis->iob.read_at(analysis->iob.io, addr, buf, len);
 	}
-
-	ut64 addr_end = UT64_ADD_OVFCHK(addr, len) ? UT64_MAX : addr + len;
-	ut64 cache_addr_end = UT64_ADD_OVFCHK(cache_addr, cache_len) ? UT64_MAX : cache_addr + cache_len;
-	bool isCached = ((addr != UT64_MAX) && (addr >= cache_addr) && (addr_end < cache_addr_end));
-	if (isCached) {
-		memcpy(buf, cache + (addr - cache_addr), len);
-	} else {
-		analysis->iob.read_at(analysis->iob.io, addr, cache, sizeof(cache));
-		memcpy(buf, cache, len);
-		cache_addr = addr;
+	if (addr != UT64_MAX && ra->addr != UT64_MAX && addr >= ra->addr &&
+		addr - ra->addr < ra->len && ra->len - (addr - ra->addr) >= len) {
+		memcpy(buf, ra->buf + (addr - ra->addr), len);
+		return len;
+	}
+	size_t size = ra->size;
+	if (UT64_ADD_OVFCHK(addr, size)) {
+		size = UT64_MAX - addr + 1;
+		if (size < len) {
+			return analysis->iob.read_at(analysis->iob.io, addr, buf, len);
+		}
 	}
+	analysis->iob.read_at(analysis->iob.io, addr, ra->buf, (int)size);
+	ra->addr = addr;
+	ra->len = size;
+	memcpy(buf, ra->buf, len);
 	return len;
 }
-#else
-static int read_ahead(RzAnalysis *analysis, ut64 addr, ut8 *buf, int len) {
-	return analysis->iob.read_at(analysis->iob.io, addr, buf, len);
+
+/**
+ * \brief Drop the contents of the read-ahead window, e.g. after the underlying data has changed
+ */
+RZ_API void rz_analysis_fcn_invalidate_read_ahead_cache(RzAnalysis *analysis) {
+	rz_return_if_fail(analysis);
+	analysis->read_ahead.addr = UT64_MAX;
+	analysis->read_ahead.len = 0;
 }
-#endif
 
-RZ_API void rz_analysis_fcn_invalidate_read_ahead_cache(void) {
-#if READ_AHEAD
-	cache_addr = UT64_MAX;
-#endif
+/**
+ * \brief Resize the read-ahead window used by basic-block analysis
+ *
+ * \param size new size in bytes, 0 disables read-ahead entirely
+ */
+RZ_API bool rz_analysis_fcn_set_read_ahead_size(RzAnalysis *analysis, size_t size) {
+	rz_return_val_if_fail(analysis && size <= ST32_MAX, false);
+	RzAnalysisReadAhead *ra = &analysis->read_ahead;
+	rz_analysis_fcn_invalidate_read_ahead_cache(analysis);
+	if (size == ra->size) {
+		return true;
+	}
+	if (!size) {
+		RZ_FREE(ra->buf);
+		ra->size = 0;
+		return true;
+	}
+	ut8 *buf = realloc(ra->buf, size);
+	if (!buf) {
+		return false;
+	}
+	ra->buf = buf;
+	ra->size = size;
+	return true;
 }
 
 RZ_API int rz_analysis_function_resize(RzAnalysisFunction *fcn, int newsize) {
@@ -597,6 +623,11 @@ static RzAnalysisBBEndCause run_basic_block_analysis(RzAnalysisTaskItem *item, R
 	}
 	is_amd64 = is_x86 ? fcn->cc && !strcmp(fcn->cc, "amd64") : false;
 	bool can_jmpmid = analysis->opt.jmpmid && (is_dalvik || is_x86);
+	// esil is only looked at to spot arm's "mov lr, pc", skip rendering it elsewhere
+	RzAnalysisOpMask op_mask = RZ_ANALYSIS_OP_MASK_VAL | RZ_ANALYSIS_OP_MASK_HINT;
+	if (is_arm) {
+		op_mask |= RZ_ANALYSIS_OP_MASK_ESIL;
+	}
 
 	RzRegItem *variadic_reg = NULL;
 	if (is_amd64) {
@@ -727,7 +758,7 @@ static RzAnalysisBBEndCause run_basic_block_analysis(RzAnalysisTaskItem *item, R
 			gotoBeach(RZ_ANALYSIS_RET_ERROR)
 		}
 		rz_analysis_op_fini(&op);
-		if ((oplen = rz_analysis_op(analysis, &op, at, buf, bytes_read, RZ_ANALYSIS_OP_MASK_ESIL | RZ_ANALYSIS_OP_MASK_VAL | RZ_ANALYSIS_OP_MASK_HINT)) < 1) {
+		if ((oplen = rz_analysis_op(analysis, &op, at, buf, bytes_read, op_mask)) < 1) {
 			RZ_LOG_DEBUG("Invalid instruction at 0x%" PFMT64x " with %d bits\n", at, analysis->bits);
 			// gotoBeach (RZ_ANALYSIS_RET_ERROR);
 			// RET_END causes infinite loops somehow
@@ -1413,7 +1444,7 @@ static RzAnalysisBBEndCause run_basic_block_analysis(RzAnalysisTaskItem *item, R
 			break;
 		case RZ_ANALYSIS_OP_TYPE_RET:
 			if (op.family == RZ_ANALYSIS_OP_FAMILY_PRIV) {
-				fcn->type = RZ_ANALYSIS_FCN_TYPE_INT;
+				rz_analysis_function_set_fcntype(fcn, RZ_ANALYSIS_FCN_TYPE_INT);
 			}
 			if (last_is_push && analysis->opt.pushret) {
 				op.type = RZ_ANALYSIS_OP_TYPE_JMP;
@@ -1497,6 +1528,52 @@ RZ_API bool rz_analysis_task_item_new(RZ_NONNULL RzAnalysis *analysis, RZ_NONNUL
 	return rz_vector_push(tasks, &item);
 }
 
+/**
+ * \brief Adds a new task item for each address of \p addrs to the `tasks` parameter.
+ *
+ * Same as calling `rz_analysis_task_item_new` on each address in order, but the
+ * addresses already in `tasks` are looked up in a table built once, so that adding
+ * the thousands of cases of a big switch doesn't rescan `tasks` every time.
+ *
+ * \param analysis Pointer to RzAnalysis instance.
+ * \param tasks Pointer to RzVector to add the new RzAnalysisTaskItems to.
+ * \param fcn Pointer to RzAnalysisFunction in which analysis will be performed on.
+ * \param block Pointer to RzAnalysisBlock in which analysis will be performed on. If null, analysis will take care of block creation.
+ * \param addrs Addresses where analysis will start from
+ * \param count Number of addresses in \p addrs
+ */
+RZ_API bool rz_analysis_task_items_new(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzVector *tasks, RZ_NONNULL RzAnalysisFunction *fcn, RZ_NULLABLE RzAnalysisBlock *block, RZ_NONNULL const ut64 *addrs, size_t count) {
+	rz_return_val_if_fail(analysis && tasks && fcn && (addrs || !count), false);
+	if (count < 16 && rz_vector_len(tasks) < 16) {
+		for (size_t i = 0; i < count; i++) {
+			if (!rz_analysis_task_item_new(analysis, tasks, fcn, block, addrs[i])) {
+				return false;
+			}
+		}
+		return true;
+	}
+	HtUP *queued = ht_up_new(NULL, NULL, NULL);
+	if (!queued) {
+		return false;
+	}
+	bool ret = rz_vector_reserve(tasks, rz_vector_len(tasks) + count) != NULL;
+	RzAnalysisTaskItem *it;
+	rz_vector_foreach(tasks, it) {
+		ht_up_insert(queued, it->start_address, NULL);
+	}
+	for (size_t i = 0; ret && i < count; i++) {
+		bool found = false;
+		ht_up_find(queued, addrs[i], &found);
+		if (found) {
+			continue;
+		}
+		RzAnalysisTaskItem item = { fcn, block, fcn->stack, addrs[i] };
+		ret = rz_vector_push(tasks, &item) && ht_up_insert(queued, addrs[i], NULL);
+	}
+	ht_up_free(queued);
+	return ret;
+}
+
 /**
  * \brief Runs analysis on the task items.
  *
@@ -1602,23 +1679,24 @@ RZ_API void rz_analysis_del_jmprefs(RzAnalysis *analysis, RzAnalysisFunction *fc
 	rz_list_free(xrefs);
 }
 
+// stops at the first item marking data
+static bool not_data_meta_cb(RzIntervalNode *node, void *user) {
+	RzAnalysisMetaItem *meta = node->data;
+	switch (meta->type) {
+	case RZ_META_TYPE_DATA:
+	case RZ_META_TYPE_STRING:
+	case RZ_META_TYPE_FORMAT:
+		return false;
+	default:
+		return true;
+	}
+}
+
 /* Does NOT invalidate read-ahead cache. */
 RZ_API int rz_analysis_fcn(RzAnalysis *analysis, RzAnalysisFunction *fcn, ut64 addr, ut64 len, int reftype) {
-	RzPVector *metas = rz_meta_get_all_in(analysis, addr, RZ_META_TYPE_ANY);
-	void **it;
-	rz_pvector_foreach (metas, it) {
-		RzAnalysisMetaItem *meta = ((RzIntervalNode *)*it)->data;
-		switch (meta->type) {
-		case RZ_META_TYPE_DATA:
-		case RZ_META_TYPE_STRING:
-		case RZ_META_TYPE_FORMAT:
-			rz_pvector_free(metas);
-			return 0;
-		default:
-			break;
-		}
+	if (!rz_meta_foreach_in(analysis, addr, RZ_META_TYPE_ANY, not_data_meta_cb, NULL)) {
+		return 0;
 	}
-	rz_pvector_free(metas);
 	if (analysis->opt.norevisit) {
 		if (!analysis->visited) {
 			analysis->visited = set_u_new();
@@ -1635,7 +1713,7 @@ RZ_API int rz_analysis_fcn(RzAnalysis *analysis, RzAnalysisFunction *fcn, ut64 a
 		}
 	}
 	/* defines fcn. or loc. prefix */
-	fcn->type = (reftype == RZ_ANALYSIS_XREF_TYPE_CODE) ? RZ_ANALYSIS_FCN_TYPE_LOC : RZ_ANALYSIS_FCN_TYPE_FCN;
+	rz_analysis_function_set_fcntype(fcn, (reftype == RZ_ANALYSIS_XREF_TYPE_CODE) ? RZ_ANALYSIS_FCN_TYPE_LOC : RZ_ANALYSIS_FCN_TYPE_FCN);
 	if (fcn->addr == UT64_MAX) {
 		fcn->addr = addr;
 	}
@@ -1937,9 +2015,8 @@ RZ_API bool rz_analysis_function_set_type(RzAnalysis *a, RZ_NONNULL RzAnalysisFu
 		if (index < args_count) {
 			RzCallableArg *arg = *rz_pvector_index_ptr(callable->args, index);
 			if (arg) {
-				free(var->name);
 				if (arg->name) {
-					var->name = strdup(arg->name);
+					var->name = rz_str_constpool_get(&a->constpool, arg->name);
 				}
 				rz_type_free(var->type);
 				var->type = rz_type_clone(arg->type);
@@ -2339,7 +2416,7 @@ static void update_analysis(RzAnalysis *analysis, RzList *fcns, HtUP *reachable)
 	RzAnalysisFunction *fcn;
 	bool old_jmpmid = analysis->opt.jmpmid;
 	analysis->opt.jmpmid = true;
-	rz_analysis_fcn_invalidate_read_ahead_cache();
+	rz_analysis_fcn_invalidate_read_ahead_cache(analysis);
 	rz_list_foreach (fcns, it, fcn) {
 		// Recurse through blocks of function, mark reachable,
 		// analyze edges that don't have a block
@@ -68,7 +68,7 @@ static void label_addrs_kv_free(HtPPKv *kv) {
 }
 
 RZ_API RzAnalysisFunction *rz_analysis_function_new(RzAnalysis *analysis) {
-	RzAnalysisFunction *fcn = RZ_NEW0(RzAnalysisFunction);
+	RzAnalysisFunction *fcn = analysis->use_arena && analysis->fcn_slab ? rz_slab_alloc(analysis->fcn_slab) : RZ_NEW0(RzAnalysisFunction);
 	if (!fcn) {
 		return NULL;
 	}
@@ -86,6 +86,7 @@ RZ_API RzAnalysisFunction *rz_analysis_function_new(RzAnalysis *analysis) {
 	fcn->inst_vars = ht_up_new(NULL, inst_vars_kv_free, NULL);
 	fcn->labels = ht_up_new(NULL, labels_kv_free, NULL);
 	fcn->label_addrs = ht_pp_new(NULL, label_addrs_kv_free, NULL);
+	RZ_MEM_TRACK(RZ_MEM_ACCOUNT_ANALYSIS, fcn, sizeof(RzAnalysisFunction));
 	return fcn;
 }
 
@@ -102,6 +103,7 @@ RZ_API void rz_analysis_function_free(void *_fcn) {
 		rz_analysis_block_unref(block);
 	}
 	rz_list_free(fcn->bbs);
+	rz_analysis_function_cfg_invalidate(fcn);
 
 	RzAnalysis *analysis = fcn->analysis;
 	if (ht_up_find(analysis->ht_addr_fun, fcn->addr, NULL) == _fcn) {
@@ -123,7 +125,12 @@ RZ_API void rz_analysis_function_free(void *_fcn) {
 	free(fcn->fingerprint);
 	rz_analysis_diff_free(fcn->diff);
 	rz_list_free(fcn->imports);
-	free(fcn);
+	RZ_MEM_UNTRACK(fcn);
+	if (analysis->fcn_slab && rz_slab_owns(analysis->fcn_slab, fcn)) {
+		rz_slab_release(analysis->fcn_slab, fcn);
+	} else {
+		free(fcn);
+	}
 }
 
 RZ_API bool rz_analysis_add_function(RzAnalysis *analysis, RzAnalysisFunction *fcn) {
@@ -140,6 +147,8 @@ RZ_API bool rz_analysis_add_function(RzAnalysis *analysis, RzAnalysisFunction *f
 	rz_list_append(analysis->fcns, fcn);
 	ht_pp_insert(analysis->ht_name_fun, fcn->name, fcn);
 	ht_up_insert(analysis->ht_addr_fun, fcn->addr, fcn);
+	// the name shows up wherever the entrypoint is referenced
+	rz_analysis_mark_dirty(analysis, &analysis->gen.fcns, 0, UT64_MAX);
 	return true;
 }
 
@@ -178,7 +187,10 @@ RZ_API RzAnalysisFunction *rz_analysis_create_function(RzAnalysis *analysis, con
 }
 
 RZ_API bool rz_analysis_function_delete(RzAnalysisFunction *fcn) {
-	return rz_list_delete_data(fcn->analysis->fcns, fcn);
+	RzAnalysis *analysis = fcn->analysis;
+	// the name shows up wherever the entrypoint is referenced
+	rz_analysis_mark_dirty(analysis, &analysis->gen.fcns, 0, UT64_MAX);
+	return rz_list_delete_data(analysis->fcns, fcn);
 }
 
 RZ_API RzAnalysisFunction *rz_analysis_get_function_at(RzAnalysis *analysis, ut64 addr) {
@@ -234,6 +246,9 @@ RZ_API bool rz_analysis_function_relocate(RzAnalysisFunction *fcn, ut64 addr) {
 
 	fcn->addr = addr;
 	ht_up_insert(fcn->analysis->ht_addr_fun, addr, fcn);
+	rz_analysis_function_cfg_invalidate(fcn);
+	// the name shows up wherever the entrypoint is referenced
+	rz_analysis_mark_dirty(fcn->analysis, &fcn->analysis->gen.fcns, 0, UT64_MAX);
 	return true;
 }
 
@@ -258,9 +273,37 @@ RZ_API bool rz_analysis_function_rename(RzAnalysisFunction *fcn, const char *nam
 		// only re-insert if it really was in the tree before
 		ht_pp_insert(analysis->ht_name_fun, fcn->name, fcn);
 	}
+	// the name shows up wherever the entrypoint is referenced
+	rz_analysis_mark_dirty(analysis, &analysis->gen.fcns, 0, UT64_MAX);
 	return true;
 }
 
+static void ensure_fcn_range(RzAnalysisFunction *fcn);
+
+// the whole body, adding or removing a block moves the boundaries of the function
+static void mark_fcn_range_dirty(RzAnalysisFunction *fcn) {
+	ensure_fcn_range(fcn);
+	ut64 from = RZ_MIN(fcn->meta._min, fcn->addr);
+	ut64 to = fcn->meta._max == UT64_MAX ? fcn->addr : RZ_MAX(fcn->meta._max - 1, fcn->addr);
+	rz_analysis_mark_dirty(fcn->analysis, &fcn->analysis->gen.fcns, from, to);
+}
+
+RZ_API void rz_analysis_function_set_bits(RzAnalysisFunction *fcn, int bits) {
+	if (fcn->bits == bits) {
+		return;
+	}
+	fcn->bits = bits;
+	mark_fcn_range_dirty(fcn);
+}
+
+RZ_API void rz_analysis_function_set_fcntype(RzAnalysisFunction *fcn, int type) {
+	if (fcn->type == type) {
+		return;
+	}
+	fcn->type = type;
+	mark_fcn_range_dirty(fcn);
+}
+
 RZ_API void rz_analysis_function_add_block(RzAnalysisFunction *fcn, RzAnalysisBlock *bb) {
 	if (rz_list_contains(bb->fcns, fcn)) {
 		return;
@@ -268,6 +311,7 @@ RZ_API void rz_analysis_function_add_block(RzAnalysisFunction *fcn, RzAnalysisBl
 	rz_list_append(bb->fcns, fcn); // associate the given fcn with this bb
 	rz_analysis_block_ref(bb);
 	rz_list_append(fcn->bbs, bb);
+	rz_analysis_function_cfg_invalidate(fcn);
 
 	if (fcn->meta._min != UT64_MAX) {
 		if (bb->addr + bb->size > fcn->meta._max) {
@@ -277,6 +321,7 @@ RZ_API void rz_analysis_function_add_block(RzAnalysisFunction *fcn, RzAnalysisBl
 			fcn->meta._min = bb->addr;
 		}
 	}
+	mark_fcn_range_dirty(fcn);
 
 	if (fcn->analysis->cb.on_fcn_bb_new) {
 		fcn->analysis->cb.on_fcn_bb_new(fcn->analysis, fcn->analysis->core, fcn, bb);
@@ -284,6 +329,7 @@ RZ_API void rz_analysis_function_add_block(RzAnalysisFunction *fcn, RzAnalysisBl
 }
 
 RZ_API void rz_analysis_function_remove_block(RzAnalysisFunction *fcn, RzAnalysisBlock *bb) {
+	mark_fcn_range_dirty(fcn);
 	rz_list_delete_data(bb->fcns, fcn);
 
 	if (fcn->meta._min != UT64_MAX && (fcn->meta._min == bb->addr || fcn->meta._max == bb->addr + bb->size)) {
@@ -292,6 +338,7 @@ RZ_API void rz_analysis_function_remove_block(RzAnalysisFunction *fcn, RzAnalysi
 	}
 
 	rz_list_delete_data(fcn->bbs, bb);
+	rz_analysis_function_cfg_invalidate(fcn);
 	rz_analysis_block_unref(bb);
 }
 
@@ -365,14 +412,20 @@ RZ_API bool rz_analysis_function_contains(RzAnalysisFunction *fcn, ut64 addr) {
 
 RZ_API bool rz_analysis_function_was_modified(RzAnalysisFunction *fcn) {
 	rz_return_val_if_fail(fcn, false);
+	size_t count = rz_list_length(fcn->bbs);
+	RzAnalysisBlock **blocks = RZ_NEWS(RzAnalysisBlock *, RZ_MAX(count, 1));
+	if (!blocks) {
+		return false;
+	}
 	RzListIter *it;
 	RzAnalysisBlock *bb;
+	size_t i = 0;
 	rz_list_foreach (fcn->bbs, it, bb) {
-		if (rz_analysis_block_was_modified(bb)) {
-			return true;
-		}
+		blocks[i++] = bb;
 	}
-	return false;
+	bool ret = rz_analysis_blocks_were_modified(fcn->analysis, blocks, count);
+	free(blocks);
+	return ret;
 }
 
 RZ_API RZ_BORROW RzList *rz_analysis_function_list(RzAnalysis *analysis) {
@@ -0,0 +1,619 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+
+/**
+ * \file function_cfg.c
+ * Dominators, natural loops and strongly connected components of functions.
+ *
+ * Everything is computed at once on the blocks of the function turned into a
+ * RzGraphCSR, and cached in the function until its blocks change. Changes of
+ * the block lists bump RzAnalysisFunction.bbs_generation, but the analysis
+ * also assigns jump and fail of the blocks directly, so the successors are
+ * additionally checked against a hash taken when building.
+ */
+
+#define NONE UT32_MAX
+
+static void cfg_free(RzAnalysisFunctionCFG *cfg) {
+	if (!cfg) {
+		return;
+	}
+	rz_graph_csr_free(cfg->graph);
+	free(cfg->idom);
+	free(cfg->dom_pre);
+	free(cfg->dom_post);
+	free(cfg->loop_header);
+	free(cfg->loop_parent);
+	free(cfg->loop_depth);
+	free(cfg->scc);
+	free(cfg);
+}
+
+/**
+ * Drop the cached control flow facts of \p fcn after a change of its blocks.
+ */
+RZ_IPI void rz_analysis_function_cfg_invalidate(RzAnalysisFunction *fcn) {
+	fcn->bbs_generation++;
+	cfg_free(fcn->cfg);
+	fcn->cfg = NULL;
+}
+
+static inline ut64 hash_step(ut64 h, ut64 v) {
+	// FNV-1a over 64 bit words
+	return (h ^ v) * 0x100000001b3ULL;
+}
+
+static bool hash_successor_cb(ut64 addr, void *user) {
+	ut64 *h = user;
+	*h = hash_step(*h, addr);
+	return true;
+}
+
+static ut64 blocks_signature(RzAnalysisFunction *fcn) {
+	ut64 h = hash_step(0xcbf29ce484222325ULL, fcn->addr);
+	RzListIter *it;
+	RzAnalysisBlock *bb;
+	rz_list_foreach (fcn->bbs, it, bb) {
+		h = hash_step(h, bb->addr);
+		h = hash_step(h, bb->size);
+		rz_analysis_block_successor_addrs_foreach(bb, hash_successor_cb, &h);
+		h = hash_step(h, UT64_MAX);
+	}
+	return h;
+}
+
+static int block_ptr_cmp(const void *a, const void *b) {
+	const RzAnalysisBlock *x = *(const RzAnalysisBlock **)a, *y = *(const RzAnalysisBlock **)b;
+	return x->addr < y->addr ? -1 : (x->addr > y->addr ? 1 : 0);
+}
+
+static ut32 find_block(RzAnalysisBlock **blocks, ut32 n, ut64 addr) {
+	ut32 lo = 0, hi = n;
+	while (lo < hi) {
+		ut32 mid = lo + (hi - lo) / 2;
+		if (blocks[mid]->addr < addr) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo < n && blocks[lo]->addr == addr ? lo : NONE;
+}
+
+typedef struct {
+	RzGraphCSRBuilder *builder;
+	RzAnalysisBlock **blocks;
+	ut32 n;
+	ut32 from;
+	ut32 *seen; ///< last source with an edge to each block, to drop duplicate edges
+	bool ok;
+} BuildCtx;
+
+static bool add_successor_cb(ut64 addr, void *user) {
+	BuildCtx *ctx = user;
+	ut32 to = find_block(ctx->blocks, ctx->n, addr);
+	if (to == NONE || ctx->seen[to] == ctx->from) {
+		return true;
+	}
+	ctx->seen[to] = ctx->from;
+	ctx->ok &= rz_graph_csr_builder_add_edge(ctx->builder, ctx->from, to);
+	return true;
+}
+
+static RzGraphCSR *build_graph(RzAnalysisFunction *fcn) {
+	ut32 n = rz_list_length(fcn->bbs);
+	RzAnalysisBlock **blocks = RZ_NEWS(RzAnalysisBlock *, n + 1);
+	ut32 *seen = RZ_NEWS(ut32, n + 1);
+	RzGraphCSRBuilder *builder = rz_graph_csr_builder_new();
+	RzGraphCSR *g = NULL;
+	if (!blocks || !seen || !builder) {
+		goto beach;
+	}
+	RzListIter *it;
+	RzAnalysisBlock *bb;
+	ut32 i = 0;
+	rz_list_foreach (fcn->bbs, it, bb) {
+		blocks[i++] = bb;
+	}
+	qsort(blocks, n, sizeof(RzAnalysisBlock *), block_ptr_cmp);
+	for (i = 0; i < n; i++) {
+		if (rz_graph_csr_builder_add_node(builder, blocks[i]) == NONE) {
+			goto beach;
+		}
+		seen[i] = NONE;
+	}
+	BuildCtx ctx = { builder, blocks, n, 0, seen, true };
+	for (i = 0; i < n && ctx.ok; i++) {
+		ctx.from = i;
+		rz_analysis_block_successor_addrs_foreach(blocks[i], add_successor_cb, &ctx);
+	}
+	if (ctx.ok) {
+		g = rz_graph_csr_builder_build(builder);
+	}
+beach:
+	rz_graph_csr_builder_free(builder);
+	free(seen);
+	free(blocks);
+	return g;
+}
+
+typedef struct {
+	ut32 *dfnum; ///< preorder number of each block in the dfs from the entry, NONE if unreachable
+	ut32 *vertex; ///< block of each preorder number
+	ut32 *parent; ///< parent of each block in the dfs tree
+	ut32 count;
+} DfsOrder;
+
+static void order_discover(ut32 n, RzGraphCSRVisitor *vis) {
+	DfsOrder *o = vis->data;
+	o->dfnum[n] = o->count;
+	o->vertex[o->count++] = n;
+}
+
+static void order_tree_edge(ut32 from, ut32 to, ut32 nth, RzGraphCSRVisitor *vis) {
+	DfsOrder *o = vis->data;
+	o->parent[to] = from;
+}
+
+// evaluates the forest of the Lengauer-Tarjan algorithm, with path compression
+static ut32 lt_eval(ut32 v, ut32 *ancestor, ut32 *label, const ut32 *semi, ut32 *stack) {
+	if (ancestor[v] == NONE) {
+		return v;
+	}
+	ut32 depth = 0;
+	ut32 x = v;
+	while (ancestor[ancestor[x]] != NONE) {
+		stack[depth++] = x;
+		x = ancestor[x];
+	}
+	while (depth) {
+		x = stack[--depth];
+		ut32 a = ancestor[x];
+		if (semi[label[a]] < semi[label[x]]) {
+			label[x] = label[a];
+		}
+		ancestor[x] = ancestor[a];
+	}
+	return label[v];
+}
+
+// Lengauer-Tarjan, see "A Fast Algorithm for Finding Dominators in a Flowgraph"
+static bool compute_idom(RzAnalysisFunctionCFG *cfg, DfsOrder *o) {
+	const RzGraphCSR *g = cfg->graph;
+	ut32 n = g->n_nodes;
+	ut32 *semi = RZ_NEWS(ut32, n + 1);
+	ut32 *ancestor = RZ_NEWS(ut32, n + 1);
+	ut32 *label = RZ_NEWS(ut32, n + 1);
+	ut32 *bucket = RZ_NEWS(ut32, n + 1); ///< first block of the bucket of each block
+	ut32 *bucket_next = RZ_NEWS(ut32, n + 1);
+	ut32 *stack = RZ_NEWS(ut32, n + 1);
+	bool ret = false;
+	if (!semi || !ancestor || !label || !bucket || !bucket_next || !stack) {
+		goto beach;
+	}
+	for (ut32 v = 0; v < n; v++) {
+		semi[v] = o->dfnum[v];
+		ancestor[v] = NONE;
+		label[v] = v;
+		bucket[v] = NONE;
+		cfg->idom[v] = NONE;
+	}
+	for (ut32 i = o->count; i-- > 1;) {
+		ut32 w = o->vertex[i];
+		const ut32 *preds = rz_graph_csr_in_nodes(g, w);
+		ut32 n_preds = rz_graph_csr_in_degree(g, w);
+		for (ut32 j = 0; j < n_preds; j++) {
+			ut32 v = preds[j];
+			if (o->dfnum[v] == NONE) {
+				continue;
+			}
+			ut32 u = lt_eval(v, ancestor, label, semi, stack);
+			if (semi[u] < semi[w]) {
+				semi[w] = semi[u];
+			}
+		}
+		ut32 s = o->vertex[semi[w]];
+		bucket_next[w] = bucket[s];
+		bucket[s] = w;
+		ut32 p = o->parent[w];
+		ancestor[w] = p;
+		for (ut32 v = bucket[p]; v != NONE; v = bucket_next[v]) {
+			ut32 u = lt_eval(v, ancestor, label, semi, stack);
+			cfg->idom[v] = semi[u] < semi[v] ? u : p;
+		}
+		bucket[p] = NONE;
+	}
+	for (ut32 i = 1; i < o->count; i++) {
+		ut32 w = o->vertex[i];
+		if (cfg->idom[w] != o->vertex[semi[w]]) {
+			cfg->idom[w] = cfg->idom[cfg->idom[w]];
+		}
+	}
+	ret = true;
+beach:
+	free(semi);
+	free(ancestor);
+	free(label);
+	free(bucket);
+	free(bucket_next);
+	free(stack);
+	return ret;
+}
+
+typedef struct {
+	ut32 *pre;
+	ut32 *post;
+	ut32 pre_count;
+	ut32 post_count;
+} DomNumbering;
+
+static void dom_discover(ut32 n, RzGraphCSRVisitor *vis) {
+	DomNumbering *d = vis->data;
+	d->pre[n] = d->pre_count++;
+}
+
+static void dom_finish(ut32 n, RzGraphCSRVisitor *vis) {
+	DomNumbering *d = vis->data;
+	d->post[n] = d->post_count++;
+}
+
+// numbers the dominator tree so that dominance is checked in O(1)
+static bool number_dom_tree(RzAnalysisFunctionCFG *cfg) {
+	ut32 n = cfg->graph->n_nodes;
+	for (ut32 v = 0; v < n; v++) {
+		cfg->dom_pre[v] = NONE;
+		cfg->dom_post[v] = NONE;
+	}
+	if (cfg->entry == NONE) {
+		return true;
+	}
+	RzGraphCSRBuilder *b = rz_graph_csr_builder_new();
+	if (!b) {
+		return false;
+	}
+	bool ok = true;
+	for (ut32 v = 0; v < n && ok; v++) {
+		ok = rz_graph_csr_builder_add_node(b, NULL) != NONE;
+	}
+	for (ut32 v = 0; v < n && ok; v++) {
+		if (cfg->idom[v] != NONE) {
+			ok = rz_graph_csr_builder_add_edge(b, cfg->idom[v], v);
+		}
+	}
+	RzGraphCSR *tree = ok ? rz_graph_csr_builder_build(b) : NULL;
+	rz_graph_csr_builder_free(b);
+	if (!tree) {
+		return false;
+	}
+	DomNumbering d = { cfg->dom_pre, cfg->dom_post, 0, 0 };
+	RzGraphCSRVisitor vis = { 0 };
+	vis.discover_node = dom_discover;
+	vis.finish_node = dom_finish;
+	vis.data = &d;
+	rz_graph_csr_dfs_node(tree, cfg->entry, &vis);
+	rz_graph_csr_free(tree);
+	return true;
+}
+
+static ut32 outermost_loop(const RzAnalysisFunctionCFG *cfg, ut32 v) {
+	ut32 l = cfg->loop_header[v];
+	if (l == NONE) {
+		return v;
+	}
+	while (cfg->loop_parent[l] != NONE) {
+		l = cfg->loop_parent[l];
+	}
+	return l;
+}
+
+// natural loops of the back edges, innermost headers (highest preorder) first
+static bool compute_loops(RzAnalysisFunctionCFG *cfg, DfsOrder *o) {
+	const RzGraphCSR *g = cfg->graph;
+	ut32 n = g->n_nodes;
+	for (ut32 v = 0; v < n; v++) {
+		cfg->loop_header[v] = NONE;
+		cfg->loop_parent[v] = NONE;
+		cfg->loop_depth[v] = 0;
+	}
+	ut32 *work = RZ_NEWS(ut32, g->n_edges + 1);
+	if (!work) {
+		return false;
+	}
+	for (ut32 i = o->count; i-- > 0;) {
+		ut32 h = o->vertex[i];
+		const ut32 *preds = rz_graph_csr_in_nodes(g, h);
+		ut32 n_preds = rz_graph_csr_in_degree(g, h);
+		ut32 n_work = 0;
+		bool is_header = false;
+		for (ut32 j = 0; j < n_preds; j++) {
+			ut32 u = preds[j];
+			if (o->dfnum[u] == NONE || !rz_analysis_function_cfg_dominates(cfg, h, u)) {
+				continue;
+			}
+			is_header = true;
+			if (u != h) {
+				work[n_work++] = u;
+			}
+		}
+		if (!is_header) {
+			continue;
+		}
+		cfg->n_loops++;
+		cfg->loop_header[h] = h;
+		while (n_work) {
+			ut32 x = outermost_loop(cfg, work[--n_work]);
+			if (x == h) {
+				continue;
+			}
+			if (cfg->loop_header[x] == NONE) {
+				cfg->loop_header[x] = h;
+			} else {
+				// header of a nested loop, its body has been walked already
+				cfg->loop_parent[x] = h;
+			}
+			const ut32 *xpreds = rz_graph_csr_in_nodes(g, x);
+			ut32 n_xpreds = rz_graph_csr_in_degree(g, x);
+			for (ut32 j = 0; j < n_xpreds; j++) {
+				// every edge is pushed at most once, when its destination joins the loop
+				if (o->dfnum[xpreds[j]] != NONE) {
+					work[n_work++] = xpreds[j];
+				}
+			}
+		}
+	}
+	free(work);
+	// outer headers have lower preorder numbers
+	for (ut32 i = 0; i < o->count; i++) {
+		ut32 v = o->vertex[i];
+		if (cfg->loop_header[v] == v) {
+			ut32 p = cfg->loop_parent[v];
+			cfg->loop_depth[v] = p == NONE ? 1 : cfg->loop_depth[p] + 1;
+		}
+	}
+	for (ut32 v = 0; v < n; v++) {
+		ut32 h = cfg->loop_header[v];
+		if (h != NONE && h != v) {
+			cfg->loop_depth[v] = cfg->loop_depth[h];
+		}
+	}
+	return true;
+}
+
+// iterative Tarjan
+static bool compute_sccs(RzAnalysisFunctionCFG *cfg) {
+	const RzGraphCSR *g = cfg->graph;
+	ut32 n = g->n_nodes;
+	ut32 *index = RZ_NEWS(ut32, n + 1);
+	ut32 *low = RZ_NEWS(ut32, n + 1);
+	ut32 *stack = RZ_NEWS(ut32, n + 1); ///< nodes whose component is not known yet
+	ut32 *call = RZ_NEWS(ut32, n + 1); ///< nodes being visited
+	ut32 *pos = RZ_NEWS(ut32, n + 1); ///< next successor of each node being visited
+	bool ret = false;
+	if (!index || !low || !stack || !call || !pos) {
+		goto beach;
+	}
+	for (ut32 v = 0; v < n; v++) {
+		index[v] = NONE;
+		cfg->scc[v] = NONE;
+	}
+	ut32 next_index = 0, sp = 0;
+	for (ut32 root = 0; root < n; root++) {
+		if (index[root] != NONE) {
+			continue;
+		}
+		ut32 depth = 0;
+		call[depth] = root;
+		pos[depth++] = 0;
+		index[root] = low[root] = next_index++;
+		stack[sp++] = root;
+		while (depth) {
+			ut32 v = call[depth - 1];
+			ut32 nth = pos[depth - 1];
+			if (nth < rz_graph_csr_out_degree(g, v)) {
+				pos[depth - 1]++;
+				ut32 w = rz_graph_csr_out_nodes(g, v)[nth];
+				if (index[w] == NONE) {
+					index[w] = low[w] = next_index++;
+					stack[sp++] = w;
+					call[depth] = w;
+					pos[depth++] = 0;
+				} else if (cfg->scc[w] == NONE && index[w] < low[v]) {
+					low[v] = index[w];
+				}
+				continue;
+			}
+			depth--;
+			if (low[v] == index[v]) {
+				ut32 w;
+				do {
+					w = stack[--sp];
+					cfg->scc[w] = cfg->n_sccs;
+				} while (w != v);
+				cfg->n_sccs++;
+			}
+			if (depth) {
+				ut32 p = call[depth - 1];
+				if (low[v] < low[p]) {
+					low[p] = low[v];
+				}
+			}
+		}
+	}
+	ret = true;
+beach:
+	free(index);
+	free(low);
+	free(stack);
+	free(call);
+	free(pos);
+	return ret;
+}
+
+static RzAnalysisFunctionCFG *cfg_build(RzAnalysisFunction *fcn, ut64 signature) {
+	RzAnalysisFunctionCFG *cfg = RZ_NEW0(RzAnalysisFunctionCFG);
+	if (!cfg) {
+		return NULL;
+	}
+	cfg->bbs_generation = fcn->bbs_generation;
+	cfg->signature = signature;
+	cfg->graph = build_graph(fcn);
+	if (!cfg->graph) {
+		cfg_free(cfg);
+		return NULL;
+	}
+	ut32 n = cfg->graph->n_nodes;
+	cfg->idom = RZ_NEWS(ut32, n + 1);
+	cfg->dom_pre = RZ_NEWS(ut32, n + 1);
+	cfg->dom_post = RZ_NEWS(ut32, n + 1);
+	cfg->loop_header = RZ_NEWS(ut32, n + 1);
+	cfg->loop_parent = RZ_NEWS(ut32, n + 1);
+	cfg->loop_depth = RZ_NEWS(ut32, n + 1);
+	cfg->scc = RZ_NEWS(ut32, n + 1);
+	DfsOrder o = { RZ_NEWS(ut32, n + 1), RZ_NEWS(ut32, n + 1), RZ_NEWS(ut32, n + 1), 0 };
+	bool ok = cfg->idom && cfg->dom_pre && cfg->dom_post && cfg->loop_header &&
+		cfg->loop_parent && cfg->loop_depth && cfg->scc && o.dfnum && o.vertex && o.parent;
+	if (ok) {
+		for (ut32 v = 0; v < n; v++) {
+			o.dfnum[v] = NONE;
+			o.parent[v] = NONE;
+		}
+		cfg->entry = NONE;
+		RzGraphCSR *g = cfg->graph;
+		for (ut32 v = 0; v < n; v++) {
+			if (((RzAnalysisBlock *)g->data[v])->addr == fcn->addr) {
+				cfg->entry = v;
+				break;
+			}
+		}
+		if (cfg->entry != NONE) {
+			RzGraphCSRVisitor vis = { 0 };
+			vis.discover_node = order_discover;
+			vis.tree_edge = order_tree_edge;
+			vis.data = &o;
+			rz_graph_csr_dfs_node(g, cfg->entry, &vis);
+		}
+		ok = compute_idom(cfg, &o) && number_dom_tree(cfg) && compute_loops(cfg, &o) && compute_sccs(cfg);
+	}
+	free(o.dfnum);
+	free(o.vertex);
+	free(o.parent);
+	if (!ok) {
+		cfg_free(cfg);
+		return NULL;
+	}
+	return cfg;
+}
+
+/**
+ * \brief Get the dominators, loops and strongly connected components of \p fcn
+ *
+ * They are computed at the first call and kept until the blocks of \p fcn
+ * change. The result is owned by \p fcn and must not be used after its blocks
+ * are modified.
+ *
+ * \return NULL if the computation failed
+ */
+RZ_API RZ_BORROW const RzAnalysisFunctionCFG *rz_analysis_function_get_cfg(RZ_NONNULL RzAnalysisFunction *fcn) {
+	rz_return_val_if_fail(fcn, NULL);
+	ut64 signature = blocks_signature(fcn);
+	RzAnalysisFunctionCFG *cfg = fcn->cfg;
+	if (cfg && cfg->bbs_generation == fcn->bbs_generation && cfg->signature == signature && cfg->graph) {
+		return cfg;
+	}
+	cfg_free(cfg);
+	fcn->cfg = cfg_build(fcn, signature);
+	return fcn->cfg;
+}
+
+/**
+ * \brief Index of the block at \p addr in \p cfg, UT32_MAX if there is none
+ */
+RZ_API ut32 rz_analysis_function_cfg_index(RZ_NONNULL const RzAnalysisFunctionCFG *cfg, ut64 addr) {
+	rz_return_val_if_fail(cfg && cfg->graph, NONE);
+	return find_block((RzAnalysisBlock **)cfg->graph->data, cfg->graph->n_nodes, addr);
+}
+
+/**
+ * \brief true if every path from the entry to the block \p b goes through the block \p a
+ *
+ * A block dominates itself, unreachable blocks neither dominate nor are dominated.
+ */
+RZ_API bool rz_analysis_function_cfg_dominates(RZ_NONNULL const RzAnalysisFunctionCFG *cfg, ut32 a, ut32 b) {
+	rz_return_val_if_fail(cfg && cfg->graph, false);
+	ut32 n = cfg->graph->n_nodes;
+	if (a >= n || b >= n || cfg->dom_pre[a] == NONE || cfg->dom_pre[b] == NONE) {
+		return false;
+	}
+	return cfg->dom_pre[a] <= cfg->dom_pre[b] && cfg->dom_post[b] <= cfg->dom_post[a];
+}
+
+static ut32 cfg_index_of(RzAnalysisFunction *fcn, ut64 addr, const RzAnalysisFunctionCFG **cfg) {
+	*cfg = rz_analysis_function_get_cfg(fcn);
+	return *cfg ? rz_analysis_function_cfg_index(*cfg, addr) : NONE;
+}
+
+/**
+ * \brief Immediate dominator of the block at \p addr in \p fcn
+ * \return NULL for the entry block, unreachable blocks and addresses that aren't a block of \p fcn
+ */
+RZ_API RZ_BORROW RzAnalysisBlock *rz_analysis_function_idom(RZ_NONNULL RzAnalysisFunction *fcn, ut64 addr) {
+	rz_return_val_if_fail(fcn, NULL);
+	const RzAnalysisFunctionCFG *cfg;
+	ut32 i = cfg_index_of(fcn, addr, &cfg);
+	if (i == NONE || cfg->idom[i] == NONE) {
+		return NULL;
+	}
+	return cfg->graph->data[cfg->idom[i]];
+}
+
+/**
+ * \brief true if the block at \p a dominates the block at \p b in \p fcn
+ */
+RZ_API bool rz_analysis_function_dominates(RZ_NONNULL RzAnalysisFunction *fcn, ut64 a, ut64 b) {
+	rz_return_val_if_fail(fcn, false);
+	const RzAnalysisFunctionCFG *cfg;
+	ut32 ia = cfg_index_of(fcn, a, &cfg);
+	ut32 ib = cfg ? rz_analysis_function_cfg_index(cfg, b) : NONE;
+	return ia != NONE && ib != NONE && rz_analysis_function_cfg_dominates(cfg, ia, ib);
+}
+
+/**
+ * \brief Header of the innermost natural loop containing the block at \p addr
+ * \return NULL if the block is not part of a loop
+ */
+RZ_API RZ_BORROW RzAnalysisBlock *rz_analysis_function_loop_header(RZ_NONNULL RzAnalysisFunction *fcn, ut64 addr) {
+	rz_return_val_if_fail(fcn, NULL);
+	const RzAnalysisFunctionCFG *cfg;
+	ut32 i = cfg_index_of(fcn, addr, &cfg);
+	if (i == NONE || cfg->loop_header[i] == NONE) {
+		return NULL;
+	}
+	return cfg->graph->data[cfg->loop_header[i]];
+}
+
+/**
+ * \brief Number of natural loops containing the block at \p addr
+ */
+RZ_API ut32 rz_analysis_function_loop_depth(RZ_NONNULL RzAnalysisFunction *fcn, ut64 addr) {
+	rz_return_val_if_fail(fcn, 0);
+	const RzAnalysisFunctionCFG *cfg;
+	ut32 i = cfg_index_of(fcn, addr, &cfg);
+	return i == NONE ? 0 : cfg->loop_depth[i];
+}
+
+/**
+ * \brief Strongly connected component of the block at \p addr
+ *
+ * Blocks with the same component reach each other. Components are numbered in
+ * reverse topological order, so edges never go to a component with a higher number.
+ *
+ * \return the component or UT32_MAX if \p addr is not a block of \p fcn
+ */
+RZ_API ut32 rz_analysis_function_scc(RZ_NONNULL RzAnalysisFunction *fcn, ut64 addr) {
+	rz_return_val_if_fail(fcn, NONE);
+	const RzAnalysisFunctionCFG *cfg;
+	ut32 i = cfg_index_of(fcn, addr, &cfg);
+	return i == NONE ? NONE : cfg->scc[i];
+}
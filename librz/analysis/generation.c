@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+
+/**
+ * \file generation.c
+ * Change tracking for the analysis tables.
+ *
+ * Every mutation of functions, blocks, xrefs, hints or metadata bumps the
+ * counter of its table and the total in RzAnalysis.gen, and remembers the
+ * address range it touched. Derived caches store the total they were built
+ * at and ask for the ranges changed since then, dropping everything only
+ * when the history they need is gone.
+ */
+
+#define DIRTY_RANGES_MAX 256
+
+// [a_from, a_to] and [b_from, b_to] overlap or are adjacent
+static bool ranges_touch(ut64 a_from, ut64 a_to, ut64 b_from, ut64 b_to) {
+	return (a_to == UT64_MAX || b_from <= a_to + 1) && (b_to == UT64_MAX || a_from <= b_to + 1);
+}
+
+RZ_IPI void rz_analysis_dirty_init(RzAnalysis *analysis) {
+	rz_vector_init(&analysis->dirty, sizeof(RzAnalysisDirtyRange), NULL, NULL);
+	analysis->dirty_floor = 0;
+}
+
+RZ_IPI void rz_analysis_dirty_fini(RzAnalysis *analysis) {
+	rz_vector_fini(&analysis->dirty);
+}
+
+/**
+ * \brief Record a mutation of the table counted by \p counter over [\p from, \p to]
+ */
+RZ_IPI void rz_analysis_mark_dirty(RzAnalysis *analysis, ut64 *counter, ut64 from, ut64 to) {
+	(*counter)++;
+	analysis->gen.total++;
+	if (to < from) {
+		to = from;
+	}
+	RzAnalysisDirtyRange *last = rz_vector_empty(&analysis->dirty) ? NULL : rz_vector_tail(&analysis->dirty);
+	if (last && ranges_touch(last->from, last->to, from, to)) {
+		// overlapping or adjacent to the previous change, grow it instead of logging a new one
+		last->from = RZ_MIN(last->from, from);
+		last->to = RZ_MAX(last->to, to);
+		last->generation = analysis->gen.total;
+		return;
+	}
+	if (rz_vector_len(&analysis->dirty) >= DIRTY_RANGES_MAX) {
+		size_t drop = DIRTY_RANGES_MAX / 2;
+		RzAnalysisDirtyRange *r = rz_vector_index_ptr(&analysis->dirty, drop - 1);
+		analysis->dirty_floor = r->generation;
+		rz_vector_remove_range(&analysis->dirty, 0, drop, NULL);
+	}
+	RzAnalysisDirtyRange *r = rz_vector_push(&analysis->dirty, NULL);
+	if (!r) {
+		// losing a range must not go unnoticed
+		analysis->dirty_floor = analysis->gen.total;
+		return;
+	}
+	r->generation = analysis->gen.total;
+	r->from = from;
+	r->to = to;
+}
+
+/**
+ * \brief Total number of mutations of the analysis tables so far
+ */
+RZ_API ut64 rz_analysis_generation(RZ_NONNULL RzAnalysis *analysis) {
+	rz_return_val_if_fail(analysis, 0);
+	return analysis->gen.total;
+}
+
+/**
+ * \brief Get the addresses touched by the mutations after \p generation
+ *
+ * \param generation a value returned by rz_analysis_generation() earlier
+ * \param from set to the lowest touched address, or UT64_MAX if nothing changed
+ * \param to set to the highest touched address, or 0 if nothing changed
+ * \return false if the changes are too old to be known, the caller has to assume everything changed
+ */
+RZ_API bool rz_analysis_dirty_since(RZ_NONNULL RzAnalysis *analysis, ut64 generation, RZ_NONNULL RZ_OUT ut64 *from, RZ_NONNULL RZ_OUT ut64 *to) {
+	rz_return_val_if_fail(analysis && from && to, false);
+	*from = UT64_MAX;
+	*to = 0;
+	if (generation >= analysis->gen.total) {
+		return true;
+	}
+	if (generation < analysis->dirty_floor) {
+		return false;
+	}
+	RzAnalysisDirtyRange *r;
+	rz_vector_foreach_prev(&analysis->dirty, r) {
+		if (r->generation <= generation) {
+			break;
+		}
+		*from = RZ_MIN(*from, r->from);
+		*to = RZ_MAX(*to, r->to);
+	}
+	return true;
+}
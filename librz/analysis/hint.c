@@ -73,6 +73,8 @@ void rz_analysis_hint_storage_init(RzAnalysis *a) {
 	a->addr_hints = ht_up_new(NULL, addr_hint_record_ht_free, NULL);
 	a->arch_hints = NULL;
 	a->bits_hints = NULL;
+	a->arch_hints_cache.valid = false;
+	a->bits_hints_cache.valid = false;
 }
 
 // used in analysis.c, but no API needed
@@ -85,6 +87,7 @@ void rz_analysis_hint_storage_fini(RzAnalysis *a) {
 RZ_API void rz_analysis_hint_clear(RzAnalysis *a) {
 	rz_analysis_hint_storage_fini(a);
 	rz_analysis_hint_storage_init(a);
+	rz_analysis_mark_dirty(a, &a->gen.hints, 0, UT64_MAX);
 }
 
 typedef struct {
@@ -103,6 +106,7 @@ static bool addr_hint_range_delete_cb(void *user, const ut64 key, const void *va
 }
 
 RZ_API void rz_analysis_hint_del(RzAnalysis *a, ut64 addr, ut64 size) {
+	rz_analysis_mark_dirty(a, &a->gen.hints, addr, size > 1 ? addr + size - 1 : addr);
 	if (size <= 1) {
 		// only single address
 		ht_up_delete(a->addr_hints, addr);
@@ -148,6 +152,7 @@ static void unset_addr_hint_record(RzAnalysis *analysis, RzAnalysisAddrHintType
 		if (record->type == type) {
 			addr_hint_record_fini(record, NULL);
 			rz_vector_remove_at(records, i, NULL);
+			rz_analysis_mark_dirty(analysis, &analysis->gen.hints, addr, addr);
 			return;
 		}
 	}
@@ -163,6 +168,7 @@ static RzAnalysisAddrHintRecord *ensure_addr_hint_record(RzAnalysis *analysis, R
 		}
 		ht_up_insert(analysis->addr_hints, addr, records);
 	}
+	rz_analysis_mark_dirty(analysis, &analysis->gen.hints, addr, addr);
 	void *pos;
 	rz_vector_foreach(records, pos) {
 		RzAnalysisAddrHintRecord *record = pos;
@@ -185,6 +191,26 @@ static RzAnalysisAddrHintRecord *ensure_addr_hint_record(RzAnalysis *analysis, R
 		setcode \
 	} while (0)
 
+/*
+ * Find the record of \p tree in effect at \p addr. Consecutive lookups mostly
+ * fall in the same range, between two records, which is remembered in \p cache
+ * so they need no tree search.
+ */
+static RzAnalysisRangedHintRecordBase *ranged_hint_record_at(RBTree tree, RzAnalysisRangedHintCache *cache, ut64 addr) {
+	if (cache->valid && addr >= cache->from && addr <= cache->to) {
+		return cache->record;
+	}
+	RBNode *node = rz_rbtree_upper_bound(tree, &addr, ranged_hint_record_cmp, NULL);
+	RzAnalysisRangedHintRecordBase *record = node ? container_of(node, RzAnalysisRangedHintRecordBase, rb) : NULL;
+	ut64 next_addr = addr + 1;
+	RBNode *next = addr != UT64_MAX ? rz_rbtree_lower_bound(tree, &next_addr, ranged_hint_record_cmp, NULL) : NULL;
+	cache->from = record ? record->addr : 0;
+	cache->to = next ? container_of(next, RzAnalysisRangedHintRecordBase, rb)->addr - 1 : UT64_MAX;
+	cache->record = record;
+	cache->valid = true;
+	return record;
+}
+
 static RzAnalysisRangedHintRecordBase *ensure_ranged_hint_record(RBTree *tree, ut64 addr, size_t sz) {
 	RBNode *node = rz_rbtree_find(*tree, &addr, ranged_hint_record_cmp, NULL);
 	if (node) {
@@ -283,6 +309,9 @@ RZ_API void rz_analysis_hint_set_arch(RzAnalysis *a, ut64 addr, const char *arch
 	}
 	free(record->arch);
 	record->arch = arch ? strdup(arch) : NULL;
+	a->arch_hints_cache.valid = false;
+	// ranged hints hold until the next one
+	rz_analysis_mark_dirty(a, &a->gen.hints, addr, UT64_MAX);
 }
 
 RZ_API void rz_analysis_hint_set_bits(RzAnalysis *a, ut64 addr, int bits) {
@@ -291,6 +320,8 @@ RZ_API void rz_analysis_hint_set_bits(RzAnalysis *a, ut64 addr, int bits) {
 		return;
 	}
 	record->bits = bits;
+	a->bits_hints_cache.valid = false;
+	rz_analysis_mark_dirty(a, &a->gen.hints, addr, UT64_MAX);
 	if (a->hint_cbs.on_bits) {
 		a->hint_cbs.on_bits(a, addr, bits, true);
 	}
@@ -361,11 +392,17 @@ RZ_API void rz_analysis_hint_unset_stackframe(RzAnalysis *a, ut64 addr) {
 }
 
 RZ_API void rz_analysis_hint_unset_arch(RzAnalysis *a, ut64 addr) {
-	rz_rbtree_delete(&a->arch_hints, &addr, ranged_hint_record_cmp, NULL, arch_hint_record_free_rb, NULL);
+	if (rz_rbtree_delete(&a->arch_hints, &addr, ranged_hint_record_cmp, NULL, arch_hint_record_free_rb, NULL)) {
+		a->arch_hints_cache.valid = false;
+		rz_analysis_mark_dirty(a, &a->gen.hints, addr, UT64_MAX);
+	}
 }
 
 RZ_API void rz_analysis_hint_unset_bits(RzAnalysis *a, ut64 addr) {
-	rz_rbtree_delete(&a->bits_hints, &addr, ranged_hint_record_cmp, NULL, bits_hint_record_free_rb, NULL);
+	if (rz_rbtree_delete(&a->bits_hints, &addr, ranged_hint_record_cmp, NULL, bits_hint_record_free_rb, NULL)) {
+		a->bits_hints_cache.valid = false;
+		rz_analysis_mark_dirty(a, &a->gen.hints, addr, UT64_MAX);
+	}
 }
 
 RZ_API void rz_analysis_hint_free(RzAnalysisHint *h) {
@@ -380,14 +417,13 @@ RZ_API void rz_analysis_hint_free(RzAnalysisHint *h) {
 }
 
 RZ_API RZ_NULLABLE RZ_BORROW const char *rz_analysis_hint_arch_at(RzAnalysis *analysis, ut64 addr, RZ_NULLABLE ut64 *hint_addr) {
-	RBNode *node = rz_rbtree_upper_bound(analysis->arch_hints, &addr, ranged_hint_record_cmp, NULL);
-	if (!node) {
+	RzAnalysisArchHintRecord *record = (RzAnalysisArchHintRecord *)ranged_hint_record_at(analysis->arch_hints, &analysis->arch_hints_cache, addr);
+	if (!record) {
 		if (hint_addr) {
 			*hint_addr = UT64_MAX;
 		}
 		return NULL;
 	}
-	RzAnalysisArchHintRecord *record = (RzAnalysisArchHintRecord *)container_of(node, RzAnalysisRangedHintRecordBase, rb);
 	if (hint_addr) {
 		*hint_addr = record->base.addr;
 	}
@@ -395,14 +431,13 @@ RZ_API RZ_NULLABLE RZ_BORROW const char *rz_analysis_hint_arch_at(RzAnalysis *an
 }
 
 RZ_API int rz_analysis_hint_bits_at(RzAnalysis *analysis, ut64 addr, RZ_NULLABLE ut64 *hint_addr) {
-	RBNode *node = rz_rbtree_upper_bound(analysis->bits_hints, &addr, ranged_hint_record_cmp, NULL);
-	if (!node) {
+	RzAnalysisBitsHintRecord *record = (RzAnalysisBitsHintRecord *)ranged_hint_record_at(analysis->bits_hints, &analysis->bits_hints_cache, addr);
+	if (!record) {
 		if (hint_addr) {
 			*hint_addr = UT64_MAX;
 		}
 		return 0;
 	}
-	RzAnalysisBitsHintRecord *record = (RzAnalysisBitsHintRecord *)container_of(node, RzAnalysisRangedHintRecordBase, rb);
 	if (hint_addr) {
 		*hint_addr = record->base.addr;
 	}
@@ -126,6 +126,7 @@ RZ_API void rz_analysis_il_vm_free(RZ_NULLABLE RzAnalysisILVM *vm) {
 	if (!vm) {
 		return;
 	}
+	ht_up_free(vm->op_cache);
 	rz_il_vm_free(vm->vm);
 	rz_il_reg_binding_free(vm->reg_binding);
 	rz_buf_free(vm->io_buf);
@@ -229,39 +230,192 @@ RZ_API bool rz_analysis_il_vm_sync_to_reg(RzAnalysisILVM *vm, RZ_NONNULL RzReg *
 }
 
 /**
- * Perform a single step in the VM
- *
- * If given, this syncs the contents of \p reg into the vm.
- * Then it disassembles an instruction at the program counter of the vm and executes it.
- * Finally, if no error occured, the contents are optionally synced back to \p reg.
+ * Lifted instruction kept in RzAnalysisILVM.op_cache.
  *
- * \return and indicator for which error occured, if any
+ * Entries remember the bytes they were lifted from, which are read anyway
+ * for every step, so code written by the vm itself or by the user never
+ * hits a stale entry. Plugin, bits and endianness are compared too, cpu
+ * changes flush the whole cache.
  */
-RZ_API RzAnalysisILStepResult rz_analysis_il_vm_step(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzAnalysisILVM *vm, RZ_NULLABLE RzReg *reg) {
-	rz_return_val_if_fail(analysis && vm, false);
-	RzAnalysisPlugin *cur = analysis->cur;
-	if (!cur || !analysis->read_at) {
-		return RZ_ANALYSIS_IL_STEP_RESULT_NOT_SET_UP;
+typedef struct rz_analysis_il_op_cache_entry_t {
+	RzAnalysisPlugin *plugin;
+	int bits;
+	int big_endian;
+	int size; ///< size of the instruction as given by the plugin
+	ut8 bytes[RZ_ANALYSIS_OP_CACHE_BYTES];
+	RzILOpEffect *il_op;
+	RzILCompiledEffect *compiled; ///< il_op compiled for the vm, NULL if it must be evaluated as a tree
+} RzAnalysisILOpCacheEntry;
+
+static void il_op_cache_entry_free(HtUPKv *kv) {
+	RzAnalysisILOpCacheEntry *entry = kv->value;
+	if (entry) {
+		rz_il_compiled_effect_free(entry->compiled);
+		rz_il_op_effect_free(entry->il_op);
+		free(entry);
+	}
+}
+
+/**
+ * \brief Drop all the lifted instructions cached in \p vm
+ */
+RZ_API void rz_analysis_il_vm_cache_invalidate(RZ_NONNULL RzAnalysisILVM *vm) {
+	rz_return_if_fail(vm);
+	ht_up_free(vm->op_cache);
+	vm->op_cache = NULL;
+}
+
+static RzAnalysisILOpCacheEntry *il_op_cache_get(RzAnalysis *analysis, RzAnalysisILVM *vm, ut64 addr, const ut8 *code) {
+	RzAnalysisILOpCacheEntry *entry = vm->op_cache ? ht_up_find(vm->op_cache, addr, NULL) : NULL;
+	if (!entry || entry->plugin != analysis->cur || entry->bits != analysis->bits ||
+		entry->big_endian != analysis->big_endian || memcmp(entry->bytes, code, entry->size)) {
+		return NULL;
+	}
+	return entry;
+}
+
+/**
+ * Take ownership of the lifted \p op and cache it for \p addr.
+ * \return the new entry or NULL if \p op could not be cached, in which case it is left untouched
+ */
+static RzAnalysisILOpCacheEntry *il_op_cache_put(RzAnalysis *analysis, RzAnalysisILVM *vm, ut64 addr, const ut8 *code, RzAnalysisOp *op) {
+	if (op->size < 1 || op->size > RZ_ANALYSIS_OP_CACHE_BYTES) {
+		return NULL;
+	}
+	if (!vm->op_cache || vm->op_cache->count >= RZ_ANALYSIS_IL_OP_CACHE_SIZE) {
+		ht_up_free(vm->op_cache);
+		vm->op_cache = ht_up_new(NULL, il_op_cache_entry_free, NULL);
+		if (!vm->op_cache) {
+			return NULL;
+		}
+	}
+	RzAnalysisILOpCacheEntry *entry = RZ_NEW(RzAnalysisILOpCacheEntry);
+	if (!entry) {
+		return NULL;
+	}
+	entry->plugin = analysis->cur;
+	entry->bits = analysis->bits;
+	entry->big_endian = analysis->big_endian;
+	entry->size = op->size;
+	memcpy(entry->bytes, code, op->size);
+	entry->il_op = op->il_op;
+	entry->compiled = rz_il_compile_effect(vm->vm, op->il_op);
+	// replaces (and frees) any older lifting at the same address
+	if (!ht_up_update(vm->op_cache, addr, entry)) {
+		rz_il_compiled_effect_free(entry->compiled);
+		free(entry);
+		return NULL;
+	}
+	op->il_op = NULL;
+	return entry;
+}
+
+/**
+ * Make mem 0 of \p vm use analysis->emu_mem if emu.cow is enabled and io otherwise.
+ */
+static void sync_emu_mem(RzAnalysis *analysis, RzAnalysisILVM *vm) {
+	RzBuffer *want = analysis->emu_mem ? analysis->emu_mem : vm->io_buf;
+	RzILMem *mem = rz_il_vm_get_mem(vm->vm, 0);
+	if (!mem || mem->buf == want) {
+		return;
+	}
+	RzILMem *nmem = rz_il_mem_new(want, mem->key_len);
+	if (nmem) {
+		rz_il_vm_add_mem(vm->vm, 0, nmem);
+	}
+}
+
+/**
+ * Account the memory accesses of the last step from the events of \p vm.
+ * The il memory can't be timed separately, only the volume is counted.
+ */
+static void prof_il_events(RzAnalysisEmuProf *prof, RzILVM *vm) {
+	RzListIter *it;
+	RzILEvent *evt;
+	rz_list_foreach (vm->events, it, evt) {
+		switch (evt->type) {
+		case RZ_IL_EVENT_MEM_READ:
+			rz_analysis_emu_prof_mem(prof, false, rz_bv_len(evt->data.mem_read.value) / 8, 0);
+			break;
+		case RZ_IL_EVENT_MEM_WRITE:
+			rz_analysis_emu_prof_mem(prof, true, rz_bv_len(evt->data.mem_write.new_value) / 8, 0);
+			break;
+		default:
+			break;
+		}
 	}
+}
 
+/**
+ * Step \p vm once, reading the code from \p mem if given and through analysis->read_at otherwise.
+ * If \p lock is given, it is held while anything in \p analysis is used for lifting.
+ */
+static RzAnalysisILStepResult vm_step(RzAnalysis *analysis, RzAnalysisILVM *vm, RZ_NULLABLE RzReg *reg,
+	RZ_NULLABLE RzBuffer *mem, RZ_NULLABLE RzThreadLock *lock) {
 	if (reg) {
 		rz_analysis_il_vm_sync_from_reg(vm, reg);
 	}
 	ut64 addr = rz_bv_to_ut64(vm->vm->pc);
+	// concurrent steps of rz_analysis_il_vm_batch_run() are not profiled
+	RzAnalysisEmuProf *prof = lock ? NULL : analysis->emu_prof;
+	ut64 start = prof ? rz_time_now_mono() : 0;
 
-	ut8 code[32] = { 0 };
-	analysis->read_at(analysis, addr, code, sizeof(code));
+	ut8 code[RZ_ANALYSIS_OP_CACHE_BYTES] = { 0 };
+	if (mem) {
+		// emulated code may have been written by the emulation itself
+		rz_buf_read_at(mem, addr, code, sizeof(code));
+	} else {
+		analysis->read_at(analysis, addr, code, sizeof(code));
+	}
+	if (lock) {
+		rz_th_lock_enter(lock);
+	}
+	// same as in rz_analysis_op(), the entries must be checked against the bits at addr
+	if (analysis->coreb.archbits) {
+		analysis->coreb.archbits(analysis->coreb.core, addr);
+	}
+	bool hinted = !!rz_analysis_addr_hints_at(analysis, addr);
+	RzAnalysisILOpCacheEntry *entry = hinted ? NULL : il_op_cache_get(analysis, vm, addr, code);
 	RzAnalysisOp op = { 0 };
-	int r = rz_analysis_op(analysis, &op, addr, code, sizeof(code), RZ_ANALYSIS_OP_MASK_IL | RZ_ANALYSIS_OP_MASK_HINT);
-	RzILOpEffect *ilop = r < 0 ? NULL : op.il_op;
+	RzILOpEffect *ilop;
+	RzILCompiledEffect *compiled = NULL;
+	int size;
+	if (entry) {
+		ilop = entry->il_op;
+		compiled = entry->compiled;
+		size = entry->size;
+	} else {
+		ut64 lift_start = prof ? rz_time_now_mono() : 0;
+		int r = rz_analysis_op(analysis, &op, addr, code, sizeof(code), RZ_ANALYSIS_OP_MASK_IL | RZ_ANALYSIS_OP_MASK_HINT);
+		ilop = r < 0 ? NULL : op.il_op;
+		size = op.size;
+		if (ilop && !hinted) {
+			// on success the cache owns ilop and op.il_op is reset
+			entry = il_op_cache_put(analysis, vm, addr, code, &op);
+			compiled = entry ? entry->compiled : NULL;
+		}
+		if (prof) {
+			prof->time_lift += rz_time_now_mono() - lift_start;
+		}
+	}
+	if (lock) {
+		rz_th_lock_leave(lock);
+	}
 
 	RzAnalysisILStepResult res;
 	if (ilop) {
-		bool succ = rz_il_vm_step(vm->vm, ilop, addr + (op.size > 0 ? op.size : 1));
+		ut64 next = addr + (size > 0 ? size : 1);
+		bool succ = compiled
+			? rz_il_vm_step_compiled(vm->vm, compiled, next)
+			: rz_il_vm_step(vm->vm, ilop, next);
 		res = succ ? RZ_ANALYSIS_IL_STEP_RESULT_SUCCESS : RZ_ANALYSIS_IL_STEP_IL_RUNTIME_ERROR;
 		if (reg) {
 			rz_analysis_il_vm_sync_to_reg(vm, reg);
 		}
+		if (prof) {
+			prof_il_events(prof, vm->vm);
+			rz_analysis_emu_prof_insn(prof, addr, rz_time_now_mono() - start);
+		}
 	} else {
 		res = RZ_ANALYSIS_IL_STEP_INVALID_OP;
 	}
@@ -270,6 +424,28 @@ RZ_API RzAnalysisILStepResult rz_analysis_il_vm_step(RZ_NONNULL RzAnalysis *anal
 	return res;
 }
 
+/**
+ * Perform a single step in the VM
+ *
+ * If given, this syncs the contents of \p reg into the vm.
+ * Then it disassembles an instruction at the program counter of the vm and executes it.
+ * Finally, if no error occured, the contents are optionally synced back to \p reg.
+ *
+ * Lifted instructions are cached in \p vm, together with their compiled form
+ * from rz_il_compile_effect(), so running the same code again only executes it.
+ * Addresses with hints are always lifted from scratch.
+ *
+ * \return and indicator for which error occured, if any
+ */
+RZ_API RzAnalysisILStepResult rz_analysis_il_vm_step(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzAnalysisILVM *vm, RZ_NULLABLE RzReg *reg) {
+	rz_return_val_if_fail(analysis && vm, false);
+	if (!analysis->cur || !analysis->read_at) {
+		return RZ_ANALYSIS_IL_STEP_RESULT_NOT_SET_UP;
+	}
+	sync_emu_mem(analysis, vm);
+	return vm_step(analysis, vm, reg, analysis->emu_mem, NULL);
+}
+
 /// @}
 
 /////////////////////////////////////////////////////////
@@ -307,3 +483,302 @@ RZ_API void rz_analysis_il_vm_cleanup(RzAnalysis *analysis) {
 }
 
 /// @}
+
+/////////////////////////////////////////////////////////
+/**
+ * \name Batch emulation
+ * @{
+ */
+
+static void batch_reg_fini(void *e, void *user) {
+	RzAnalysisILBatchReg *r = e;
+	free(r->name);
+}
+
+/**
+ * \brief Create a job for rz_analysis_il_vm_batch_run() that stops at \p until or after \p max_steps instructions
+ */
+RZ_API RZ_OWN RzAnalysisILBatchJob *rz_analysis_il_batch_job_new(ut64 until, ut64 max_steps) {
+	RzAnalysisILBatchJob *job = RZ_NEW0(RzAnalysisILBatchJob);
+	if (!job) {
+		return NULL;
+	}
+	rz_vector_init(&job->regs, sizeof(RzAnalysisILBatchReg), batch_reg_fini, NULL);
+	rz_vector_init(&job->final_regs, sizeof(RzAnalysisILBatchReg), batch_reg_fini, NULL);
+	job->until = until;
+	job->max_steps = max_steps;
+	job->result = RZ_ANALYSIS_IL_STEP_RESULT_NOT_SET_UP;
+	return job;
+}
+
+RZ_API void rz_analysis_il_batch_job_free(RZ_NULLABLE RzAnalysisILBatchJob *job) {
+	if (!job) {
+		return;
+	}
+	rz_vector_fini(&job->regs);
+	rz_vector_fini(&job->final_regs);
+	rz_buf_free(job->mem);
+	free(job);
+}
+
+/**
+ * \brief Set register \p name to \p value in the start state of \p job
+ */
+RZ_API bool rz_analysis_il_batch_job_set_reg(RZ_NONNULL RzAnalysisILBatchJob *job, RZ_NONNULL const char *name, ut64 value) {
+	rz_return_val_if_fail(job && name, false);
+	RzAnalysisILBatchReg r = { strdup(name), value };
+	if (!r.name || !rz_vector_push(&job->regs, &r)) {
+		free(r.name);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Read-only view of a buffer shared between threads, every access to it is done with the lock held.
+ * Each user gets its own view, so seeking does not interfere.
+ */
+typedef struct {
+	RzBuffer *buf;
+	RzThreadLock *lock; ///< NULL once the batch is over and the buffer is not shared anymore
+	ut64 offset;
+} LockedBuf;
+
+static bool buf_locked_init(RzBuffer *b, const void *user) {
+	LockedBuf *priv = RZ_NEW0(LockedBuf);
+	if (!priv) {
+		return false;
+	}
+	*priv = *(const LockedBuf *)user;
+	rz_buf_ref(priv->buf);
+	b->priv = priv;
+	return true;
+}
+
+static bool buf_locked_fini(RzBuffer *b) {
+	LockedBuf *priv = b->priv;
+	rz_buf_free(priv->buf);
+	RZ_FREE(b->priv);
+	return true;
+}
+
+static ut64 buf_locked_size(RzBuffer *b) {
+	return UT64_MAX;
+}
+
+static st64 buf_locked_read(RzBuffer *b, ut8 *buf, ut64 len) {
+	LockedBuf *priv = b->priv;
+	if (priv->lock) {
+		rz_th_lock_enter(priv->lock);
+	}
+	st64 r = rz_buf_read_at(priv->buf, priv->offset, buf, len);
+	if (priv->lock) {
+		rz_th_lock_leave(priv->lock);
+	}
+	if (r > 0) {
+		priv->offset += r;
+	}
+	return r;
+}
+
+static st64 buf_locked_write(RzBuffer *b, const ut8 *buf, ut64 len) {
+	return -1;
+}
+
+static st64 buf_locked_seek(RzBuffer *b, st64 addr, int whence) {
+	LockedBuf *priv = b->priv;
+	priv->offset = rz_seek_offset(priv->offset, UT64_MAX, addr, whence);
+	return RZ_MIN(priv->offset, ST64_MAX);
+}
+
+static const RzBufferMethods buffer_locked_methods = {
+	.init = buf_locked_init,
+	.fini = buf_locked_fini,
+	.read = buf_locked_read,
+	.write = buf_locked_write,
+	.get_size = buf_locked_size,
+	.seek = buf_locked_seek
+};
+
+/**
+ * Emulation context of one worker, reused for all the jobs it picks up
+ */
+typedef struct {
+	RzAnalysisILVM *vm;
+	RzBuffer *base; ///< LockedBuf over the shared memory
+} BatchWorker;
+
+typedef struct {
+	RzAnalysis *analysis;
+	RzPVector /*<RzAnalysisILBatchJob *>*/ *jobs;
+	RzThreadTaskPool *pool;
+	RzThreadLock *lock; ///< serializes io, lifting and picking the next job
+	size_t next_job;
+	BatchWorker *workers;
+	const char *pc_name;
+} Batch;
+
+static void batch_set_reg(Batch *batch, RzILVM *vm, RzAnalysisILBatchReg *r) {
+	if (!strcmp(r->name, "PC") || (batch->pc_name && !strcmp(r->name, batch->pc_name))) {
+		rz_bv_set_from_ut64(vm->pc, r->value);
+		return;
+	}
+	RzILVar *var = rz_il_vm_get_var(vm, RZ_IL_VAR_KIND_GLOBAL, r->name);
+	if (!var) {
+		return;
+	}
+	RzILVal *val = NULL;
+	switch (var->sort.type) {
+	case RZ_IL_TYPE_PURE_BITVECTOR:
+		val = rz_il_value_new_bitv(rz_bv_new_from_ut64(var->sort.props.bv.length, r->value));
+		break;
+	case RZ_IL_TYPE_PURE_BOOL:
+		val = rz_il_value_new_bool(rz_il_bool_new(r->value != 0));
+		break;
+	}
+	if (val) {
+		rz_il_vm_set_global_var(vm, r->name, val);
+	}
+}
+
+static void batch_get_regs(RzAnalysisILVM *vm, RzAnalysisILBatchJob *job) {
+	rz_vector_clear(&job->final_regs);
+	for (size_t i = 0; i < vm->reg_binding->regs_count; i++) {
+		const char *name = vm->reg_binding->regs[i].name;
+		RzILVal *val = rz_il_vm_get_var_value(vm->vm, RZ_IL_VAR_KIND_GLOBAL, name);
+		if (!val) {
+			continue;
+		}
+		RzAnalysisILBatchReg r = { strdup(name), 0 };
+		switch (val->type) {
+		case RZ_IL_TYPE_PURE_BITVECTOR:
+			r.value = rz_bv_to_ut64(val->data.bv);
+			break;
+		case RZ_IL_TYPE_PURE_BOOL:
+			r.value = val->data.b->b;
+			break;
+		}
+		if (!r.name || !rz_vector_push(&job->final_regs, &r)) {
+			free(r.name);
+		}
+	}
+}
+
+static void batch_run_job(Batch *batch, BatchWorker *w, RzAnalysisILBatchJob *job) {
+	RzILVM *vm = w->vm->vm;
+	rz_buf_free(job->mem);
+	job->mem = rz_buf_new_cow(w->base);
+	RzILMem *mem = rz_il_vm_get_mem(vm, 0);
+	RzILMem *nmem = job->mem && mem ? rz_il_mem_new(job->mem, mem->key_len) : NULL;
+	if (!nmem) {
+		job->result = RZ_ANALYSIS_IL_STEP_RESULT_NOT_SET_UP;
+		return;
+	}
+	rz_il_vm_add_mem(vm, 0, nmem);
+
+	rz_th_lock_enter(batch->lock);
+	rz_analysis_il_vm_sync_from_reg(w->vm, batch->analysis->reg);
+	rz_th_lock_leave(batch->lock);
+	RzAnalysisILBatchReg *r;
+	rz_vector_foreach(&job->regs, r) {
+		batch_set_reg(batch, vm, r);
+	}
+
+	job->steps = 0;
+	job->result = RZ_ANALYSIS_IL_STEP_RESULT_SUCCESS;
+	while (job->steps < job->max_steps && rz_bv_to_ut64(vm->pc) != job->until) {
+		if (batch->pool && rz_th_task_pool_is_breaked(batch->pool)) {
+			break;
+		}
+		job->result = vm_step(batch->analysis, w->vm, NULL, job->mem, batch->lock);
+		if (job->result != RZ_ANALYSIS_IL_STEP_RESULT_SUCCESS) {
+			break;
+		}
+		job->steps++;
+	}
+	job->pc = rz_bv_to_ut64(vm->pc);
+	batch_get_regs(w->vm, job);
+}
+
+static void batch_worker_run(size_t from, size_t to, void *user) {
+	Batch *batch = user;
+	for (size_t i = from; i < to; i++) {
+		BatchWorker *w = &batch->workers[i];
+		while (true) {
+			rz_th_lock_enter(batch->lock);
+			size_t j = batch->next_job++;
+			rz_th_lock_leave(batch->lock);
+			if (j >= rz_pvector_len(batch->jobs)) {
+				break;
+			}
+			batch_run_job(batch, w, rz_pvector_at(batch->jobs, j));
+		}
+	}
+}
+
+/**
+ * \brief Run all \p jobs independently of each other, in parallel on \p pool if given
+ *
+ * Every job starts from the contents of analysis->reg with its own registers
+ * set on top and is emulated until its stop condition is met. The memory of a
+ * job is a cow view over io (or analysis->emu_mem with emu.cow), so
+ * the jobs never see each other's writes and the io is never modified.
+ *
+ * Each worker of the pool emulates in its own vm, with its own cache of lifted
+ * instructions. Lifting and io reads can't run concurrently, so they are
+ * serialized, which makes this pay off for code that is executed many times,
+ * like loops or the same function with many different inputs.
+ *
+ * \return whether all jobs could be set up and run, the individual results are in the jobs
+ */
+RZ_API bool rz_analysis_il_vm_batch_run(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzPVector /*<RzAnalysisILBatchJob *>*/ *jobs, RZ_NULLABLE RzThreadTaskPool *pool) {
+	rz_return_val_if_fail(analysis && jobs, false);
+	if (!analysis->cur || !analysis->cur->il_config || !analysis->read_at) {
+		return false;
+	}
+	if (rz_pvector_empty(jobs)) {
+		return true;
+	}
+	size_t n_workers = pool ? RZ_MIN(rz_th_task_pool_size(pool), rz_pvector_len(jobs)) : 1;
+	Batch batch = {
+		.analysis = analysis,
+		.jobs = jobs,
+		.pool = pool,
+		.lock = rz_th_lock_new(true),
+		.workers = RZ_NEWS0(BatchWorker, RZ_MAX(n_workers, 1)),
+		.pc_name = rz_reg_get_name(analysis->reg, RZ_REG_NAME_PC)
+	};
+	LockedBuf shared = {
+		.buf = analysis->emu_mem ? rz_buf_ref(analysis->emu_mem) : rz_buf_new_with_io(&analysis->iob),
+		.lock = batch.lock
+	};
+	bool succ = batch.lock && batch.workers && shared.buf;
+	// vms are set up here because the plugin is asked for its il config
+	for (size_t i = 0; succ && i < n_workers; i++) {
+		BatchWorker *w = &batch.workers[i];
+		w->vm = rz_analysis_il_vm_new(analysis, NULL);
+		w->base = rz_buf_new_with_methods(&buffer_locked_methods, &shared);
+		succ = w->vm && w->base;
+	}
+	if (succ) {
+		if (!pool || (!rz_th_task_pool_parallel_for(pool, 0, n_workers, 1, batch_worker_run, &batch) && !rz_th_task_pool_is_breaked(pool))) {
+			// runs the jobs the pool did not pick up, if any
+			batch_worker_run(0, 1, &batch);
+		}
+	}
+	for (size_t i = 0; batch.workers && i < n_workers; i++) {
+		BatchWorker *w = &batch.workers[i];
+		if (w->base) {
+			// the jobs' memories stay readable without the lock
+			((LockedBuf *)w->base->priv)->lock = NULL;
+		}
+		rz_buf_free(w->base);
+		rz_analysis_il_vm_free(w->vm);
+	}
+	free(batch.workers);
+	rz_buf_free(shared.buf);
+	rz_th_lock_free(batch.lock);
+	return succ;
+}
+
+/// @}
@@ -11,10 +11,6 @@
  * 4. reg.write name & data
  **/
 
-static void htup_vector_free(HtUPKv *kv) {
-	rz_vector_free(kv->value);
-}
-
 /**
  * Create a new trace to collect infos
  * \param analysis pointer to RzAnalysis
@@ -23,48 +19,23 @@ static void htup_vector_free(HtUPKv *kv) {
  */
 RZ_API RzAnalysisRzilTrace *rz_analysis_rzil_trace_new(RzAnalysis *analysis, RZ_NONNULL RzAnalysisILVM *rzil) {
 	rz_return_val_if_fail(rzil, NULL);
-	size_t i;
 	RzAnalysisEsilTrace *trace = RZ_NEW0(RzAnalysisEsilTrace);
 	if (!trace) {
 		return NULL;
 	}
 
-	// TODO : maybe we could remove memory && register in rzil trace ?
-	trace->registers = ht_up_new(NULL, htup_vector_free, NULL);
-	if (!trace->registers) {
-		RZ_LOG_ERROR("rzil: Cannot allocate hasmap for trace registers\n");
-		goto error;
-	}
-	trace->memory = ht_up_new(NULL, htup_vector_free, NULL);
-	if (!trace->memory) {
-		RZ_LOG_ERROR("rzil: Cannot allocate hasmap for trace memory\n");
-		goto error;
-	}
+	// TODO : maybe we could remove the change log in rzil trace ?
+	rz_pvector_init(&trace->changes, free);
+	rz_vector_init(&trace->checkpoints, sizeof(ut64), NULL, NULL);
 	trace->instructions = rz_pvector_new((RzPVectorFree)rz_analysis_il_trace_instruction_free);
 	if (!trace->instructions) {
 		RZ_LOG_ERROR("rzil: Cannot allocate vector for trace instructions\n");
-		goto error;
+		rz_analysis_rzil_trace_free(trace);
+		return NULL;
 	}
 
 	// TODO : Integrate with stack panel in the future
-
-	// Save initial registers arenas
-	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
-		RzRegArena *a = analysis->reg->regset[i].arena;
-		RzRegArena *b = rz_reg_arena_new(a->size);
-		if (!b) {
-			RZ_LOG_ERROR("rzil: Cannot allocate register arena for trace\n");
-			goto error;
-		}
-		if (b->bytes && a->bytes && b->size > 0) {
-			memcpy(b->bytes, a->bytes, b->size);
-		}
-		trace->arena[i] = b;
-	}
 	return trace;
-error:
-	rz_analysis_esil_trace_free(trace);
-	return NULL;
 }
 
 /**
@@ -72,19 +43,7 @@ error:
  * \param trace trace to be free
  */
 RZ_API void rz_analysis_rzil_trace_free(RzAnalysisEsilTrace *trace) {
-	size_t i;
-	if (!trace) {
-		return;
-	}
-
-	ht_up_free(trace->registers);
-	ht_up_free(trace->memory);
-	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
-		rz_reg_arena_free(trace->arena[i]);
-	}
-	rz_pvector_free(trace->instructions);
-	trace->instructions = NULL;
-	RZ_FREE(trace);
+	rz_analysis_esil_trace_free(trace);
 }
 
 /**
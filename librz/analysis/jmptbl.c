@@ -62,6 +62,48 @@ static inline bool jmptable_size_is_invalid(RzAnalysisJmpTableParams *params) {
 		params->table_count * params->entry_size > ST32_MAX;
 }
 
+/**
+ * Readable range the last valid case target was found in, cases of a table
+ * usually point into the same map so most of them don't need a map lookup.
+ */
+typedef struct {
+	RzAnalysis *analysis;
+	ut64 from;
+	ut64 to; ///< inclusive, the range is empty if from > to
+} CaseTargetRange;
+
+static void case_target_range_init(CaseTargetRange *r, RzAnalysis *analysis) {
+	r->analysis = analysis;
+	r->from = UT64_MAX;
+	r->to = 0;
+}
+
+static bool case_target_is_valid(CaseTargetRange *r, ut64 addr) {
+	if (addr >= r->from && addr <= r->to) {
+		return true;
+	}
+	RzIOBind *iob = &r->analysis->iob;
+	if (!iob->is_valid_offset(iob->io, addr, 0)) {
+		return false;
+	}
+	if (iob->io->va) {
+		// the visible part of the map is what rz_io_is_valid_offset() checked
+		const RzSkylineItem *part = rz_skyline_get_item(&iob->io->map_skyline, addr);
+		if (part && part->itv.size) {
+			r->from = part->itv.addr;
+			r->to = rz_itv_end(part->itv) - 1;
+		}
+	}
+	return true;
+}
+
+static void add_case_tasks(RzAnalysis *analysis, RzAnalysisJmpTableParams *params, RzAnalysisFunction *fcn, RzVector /*<ut64>*/ *targets) {
+	if (!params->tasks) {
+		return;
+	}
+	rz_analysis_task_items_new(analysis, params->tasks, fcn, NULL, rz_vector_index_ptr(targets, 0), rz_vector_len(targets));
+}
+
 /**
  * \brief Marks for analysis jump table cases with a space optimization for multiple cases corresponding to the same address
  *
@@ -103,6 +145,10 @@ RZ_API bool rz_analysis_walkthrough_casetbl(RZ_NONNULL RzAnalysis *analysis, RZ_
 		free(casetbl);
 		return false;
 	}
+	CaseTargetRange range;
+	case_target_range_init(&range, analysis);
+	RzVector targets;
+	rz_vector_init(&targets, sizeof(ut64), NULL, NULL);
 	for (case_idx = 0; case_idx < params->table_count; case_idx++) {
 		jmpptr_idx = casetbl[case_idx];
 
@@ -128,11 +174,11 @@ RZ_API bool rz_analysis_walkthrough_casetbl(RZ_NONNULL RzAnalysis *analysis, RZ_
 		if (jmpptr == 0 || jmpptr == UT32_MAX || jmpptr == UT64_MAX) {
 			break;
 		}
-		if (!analysis->iob.is_valid_offset(analysis->iob.io, jmpptr, 0)) {
+		if (!case_target_is_valid(&range, jmpptr)) {
 			st32 jmpdelta = (st32)jmpptr;
 			// jump tables where sign extended movs are used
 			jmpptr = params->jmptbl_off + jmpdelta;
-			if (!analysis->iob.is_valid_offset(analysis->iob.io, jmpptr, 0)) {
+			if (!case_target_is_valid(&range, jmpptr)) {
 				break;
 			}
 		}
@@ -147,8 +193,10 @@ RZ_API bool rz_analysis_walkthrough_casetbl(RZ_NONNULL RzAnalysis *analysis, RZ_
 		rz_analysis_hint_set_immbase(analysis, jmpptr_idx_off, 10);
 
 		apply_case(analysis, block, params->jmp_address, params->entry_size, jmpptr, case_idx + params->case_shift, params->jmptbl_loc + jmpptr_idx * params->entry_size);
-		rz_analysis_task_item_new(analysis, params->tasks, fcn, NULL, jmpptr);
+		rz_vector_push(&targets, &jmpptr);
 	}
+	add_case_tasks(analysis, params, fcn, &targets);
+	rz_vector_fini(&targets);
 
 	if (case_idx > 0) {
 		if (params->default_case == 0) {
@@ -195,6 +243,10 @@ RZ_API bool rz_analysis_walkthrough_jmptbl(RZ_NONNULL RzAnalysis *analysis, RZ_N
 	bool is_arm = analysis->cur->arch && !strncmp(analysis->cur->arch, "arm", 3);
 	// eprintf ("JMPTBL AT 0x%"PFMT64x"\n", jmptbl_loc);
 	analysis->iob.read_at(analysis->iob.io, params->jmptbl_loc, jmptbl, params->table_count * params->entry_size);
+	CaseTargetRange range;
+	case_target_range_init(&range, analysis);
+	RzVector targets;
+	rz_vector_init(&targets, sizeof(ut64), NULL, NULL);
 	for (offs = 0; offs + params->entry_size - 1 < params->table_count * params->entry_size; offs += params->entry_size) {
 		switch (params->entry_size) {
 		case 1:
@@ -224,11 +276,11 @@ RZ_API bool rz_analysis_walkthrough_jmptbl(RZ_NONNULL RzAnalysis *analysis, RZ_N
 			jmpptr = params->jmp_address + 4 + (jmpptr * 2); // tbh [pc, r2, lsl 1]  // assume lsl 1
 		} else if (params->entry_size == 1 && is_arm) {
 			jmpptr = params->jmp_address + 4 + (jmpptr * 2); // lbb [pc, r2]  // assume lsl 1
-		} else if (!analysis->iob.is_valid_offset(analysis->iob.io, jmpptr, 0)) {
+		} else if (!case_target_is_valid(&range, jmpptr)) {
 			st32 jmpdelta = (st32)jmpptr;
 			// jump tables where sign extended movs are used
 			jmpptr = params->jmptbl_off + jmpdelta;
-			if (!analysis->iob.is_valid_offset(analysis->iob.io, jmpptr, 0)) {
+			if (!case_target_is_valid(&range, jmpptr)) {
 				break;
 			}
 		}
@@ -238,8 +290,10 @@ RZ_API bool rz_analysis_walkthrough_jmptbl(RZ_NONNULL RzAnalysis *analysis, RZ_N
 			}
 		}
 		apply_case(analysis, block, params->jmp_address, params->entry_size, jmpptr, (offs / params->entry_size) + params->case_shift, params->jmptbl_loc + offs);
-		rz_analysis_task_item_new(analysis, params->tasks, fcn, NULL, jmpptr);
+		rz_vector_push(&targets, &jmpptr);
 	}
+	add_case_tasks(analysis, params, fcn, &targets);
+	rz_vector_fini(&targets);
 
 	if (offs > 0) {
 		if (params->default_case == 0) {
@@ -414,11 +468,15 @@ RZ_API bool rz_analysis_walkthrough_arm_jmptbl_style(RZ_NONNULL RzAnalysis *anal
 		params->table_count = analysis->opt.jmptbl_maxcount;
 	}
 
+	RzVector targets;
+	rz_vector_init(&targets, sizeof(ut64), NULL, NULL);
 	for (offs = 0; offs + params->entry_size - 1 < params->table_count * params->entry_size; offs += params->entry_size) {
 		jmpptr = params->jmptbl_loc + offs;
 		apply_case(analysis, block, params->jmp_address, params->entry_size, jmpptr, offs / params->entry_size, params->jmptbl_loc + offs);
-		rz_analysis_task_item_new(analysis, params->tasks, fcn, NULL, jmpptr);
+		rz_vector_push(&targets, &jmpptr);
 	}
+	add_case_tasks(analysis, params, fcn, &targets);
+	rz_vector_fini(&targets);
 
 	if (offs > 0) {
 		if (params->default_case == 0 || params->default_case == UT32_MAX) {
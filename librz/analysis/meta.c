@@ -100,20 +100,27 @@ static RzPVector *collect_nodes_intersect(RzAnalysis *analysis, RzAnalysisMetaTy
 	return ctx.result;
 }
 
+typedef struct {
+	RzAnalysisMetaType type;
+	const RzSpace *space;
+
+	RzIntervalIterCb cb;
+	void *user;
+} ForeachCtx;
+
+static bool foreach_node_cb(RzIntervalNode *node, void *user) {
+	ForeachCtx *ctx = user;
+	if (!item_matches_filter(node->data, ctx->type, ctx->space)) {
+		return true;
+	}
+	return ctx->cb(node, ctx->user);
+}
+
 static inline bool is_string_with_zeroes(RzAnalysisMetaType type, int subtype) {
 	return type == RZ_META_TYPE_STRING && subtype != RZ_STRING_ENC_8BIT && subtype != RZ_STRING_ENC_UTF8;
 }
 
-static bool meta_set(RzAnalysis *a, RzAnalysisMetaType type, int subtype, ut64 from, ut64 to, const char *str) {
-	if (to < from) {
-		return false;
-	}
-	RzSpace *space = rz_spaces_current(&a->meta_spaces);
-	RzIntervalNode *node = find_node_at(a, type, space, from);
-	RzAnalysisMetaItem *item = node ? node->data : RZ_NEW0(RzAnalysisMetaItem);
-	if (!item) {
-		return false;
-	}
+static bool meta_item_set(RzAnalysisMetaItem *item, RzAnalysisMetaType type, int subtype, const RzSpace *space, ut64 from, ut64 to, const char *str) {
 	item->type = type;
 	item->subtype = subtype;
 	item->space = space;
@@ -124,7 +131,20 @@ static bool meta_set(RzAnalysis *a, RzAnalysisMetaType type, int subtype, ut64 f
 	} else {
 		item->str = str ? strdup(str) : NULL;
 	}
-	if (str && !item->str) {
+	return !str || item->str;
+}
+
+static bool meta_set(RzAnalysis *a, RzAnalysisMetaType type, int subtype, ut64 from, ut64 to, const char *str) {
+	if (to < from) {
+		return false;
+	}
+	RzSpace *space = rz_spaces_current(&a->meta_spaces);
+	RzIntervalNode *node = find_node_at(a, type, space, from);
+	RzAnalysisMetaItem *item = node ? node->data : RZ_NEW0(RzAnalysisMetaItem);
+	if (!item) {
+		return false;
+	}
+	if (!meta_item_set(item, type, subtype, space, from, to, str)) {
 		if (!node) { // If we just created this
 			free(item);
 		}
@@ -135,6 +155,7 @@ static bool meta_set(RzAnalysis *a, RzAnalysisMetaType type, int subtype, ut64 f
 	} else if (node->end != to) {
 		rz_interval_tree_resize(&a->meta, node, from, to);
 	}
+	rz_analysis_mark_dirty(a, &a->gen.meta, from, to);
 	return true;
 }
 
@@ -179,7 +200,9 @@ static void del(RzAnalysis *a, RzAnalysisMetaType type, const RzSpace *space, ut
 	}
 	void **it;
 	rz_pvector_foreach (victims, it) {
-		rz_interval_tree_delete(&a->meta, *it, true);
+		RzIntervalNode *node = *it;
+		rz_analysis_mark_dirty(a, &a->gen.meta, node->start, node->end);
+		rz_interval_tree_delete(&a->meta, node, true);
 	}
 	rz_pvector_free(victims);
 }
@@ -204,6 +227,94 @@ RZ_API bool rz_meta_set_with_subtype(RzAnalysis *m, RzAnalysisMetaType type, int
 	return meta_set(m, type, subtype, addr, end, str);
 }
 
+typedef struct {
+	RzIntervalTreeEntry entry;
+	size_t index;
+} BulkEntry;
+
+static int bulk_entry_cmp(const void *a, const void *b) {
+	const BulkEntry *x = a, *y = b;
+	int r = RZ_NUM_CMP(x->entry.start, y->entry.start);
+	return r ? r : RZ_NUM_CMP(x->index, y->index);
+}
+
+/**
+ * \brief Set many meta items of type \p type in the current space at once
+ *
+ * The result is the same as calling rz_meta_set_with_subtype() for each of
+ * \p items in order, so of several items at the same address only the last
+ * one is kept. If there is no meta item yet, as when the strings of a binary
+ * are applied, the tree is built in a single pass instead of searching it
+ * for every item.
+ *
+ * \return false if some item could not be set
+ */
+RZ_API bool rz_meta_set_bulk(RZ_NONNULL RzAnalysis *a, RzAnalysisMetaType type, RZ_NULLABLE const RzAnalysisMetaBulkItem *items, size_t count) {
+	rz_return_val_if_fail(a && (items || !count), false);
+	if (!count) {
+		return true;
+	}
+	bool ret = true;
+	BulkEntry *entries = a->meta.root ? NULL : RZ_NEWS(BulkEntry, count);
+	if (!entries) {
+		// existing items may be overwritten, each one needs a lookup
+		for (size_t i = 0; i < count; i++) {
+			ret &= rz_meta_set_with_subtype(a, type, items[i].subtype, items[i].addr, items[i].size, items[i].str);
+		}
+		return ret;
+	}
+	RzSpace *space = rz_spaces_current(&a->meta_spaces);
+	size_t n = 0;
+	ut64 from = UT64_MAX;
+	ut64 to = 0;
+	for (size_t i = 0; i < count; i++) {
+		const RzAnalysisMetaBulkItem *bi = &items[i];
+		if (!bi->size) {
+			ret = false;
+			continue;
+		}
+		ut64 end = bi->addr + bi->size - 1;
+		if (end < bi->addr) {
+			end = UT64_MAX;
+		}
+		RzAnalysisMetaItem *item = RZ_NEW0(RzAnalysisMetaItem);
+		if (!item || !meta_item_set(item, type, bi->subtype, space, bi->addr, end, bi->str)) {
+			free(item);
+			ret = false;
+			continue;
+		}
+		entries[n].entry.start = bi->addr;
+		entries[n].entry.end = end;
+		entries[n].entry.data = item;
+		entries[n].index = i;
+		n++;
+		from = RZ_MIN(from, bi->addr);
+		to = RZ_MAX(to, end);
+	}
+	qsort(entries, n, sizeof(BulkEntry), bulk_entry_cmp);
+	// keep the last of the items at the same address, packing the entries for the tree
+	RzIntervalTreeEntry *packed = (RzIntervalTreeEntry *)entries;
+	size_t m = 0;
+	for (size_t i = 0; i < n; i++) {
+		if (i + 1 < n && entries[i + 1].entry.start == entries[i].entry.start) {
+			a->meta.free(entries[i].entry.data);
+			continue;
+		}
+		RzIntervalTreeEntry entry = entries[i].entry;
+		packed[m++] = entry;
+	}
+	if (!rz_interval_tree_bulk_load(&a->meta, packed, m)) {
+		for (size_t i = 0; i < m; i++) {
+			a->meta.free(packed[i].data);
+		}
+		ret = false;
+	} else if (m) {
+		rz_analysis_mark_dirty(a, &a->gen.meta, from, to);
+	}
+	free(entries);
+	return ret;
+}
+
 RZ_API RzAnalysisMetaItem *rz_meta_get_at(RzAnalysis *a, ut64 addr, RzAnalysisMetaType type, RZ_OUT RZ_NULLABLE ut64 *size) {
 	RzIntervalNode *node = find_node_at(a, type, rz_spaces_current(&a->meta_spaces), addr);
 	if (node && size) {
@@ -233,6 +344,52 @@ RZ_API RzPVector *rz_meta_get_all_intersect(RzAnalysis *a, ut64 start, ut64 size
 	return collect_nodes_intersect(a, type, rz_spaces_current(&a->meta_spaces), start, end);
 }
 
+/**
+ * \brief Call \p cb for the nodes of the items with type \p type starting at \p at in the current space
+ *
+ * Unlike rz_meta_get_all_at(), nothing is allocated. Iteration stops as
+ * soon as \p cb returns false.
+ *
+ * \return false if \p cb stopped the iteration
+ */
+RZ_API bool rz_meta_foreach_at(RZ_NONNULL RzAnalysis *a, ut64 at, RzAnalysisMetaType type, RZ_NONNULL RzIntervalIterCb cb, void *user) {
+	rz_return_val_if_fail(a && cb, false);
+	ForeachCtx ctx = { type, rz_spaces_current(&a->meta_spaces), cb, user };
+	return rz_interval_tree_all_at(&a->meta, at, foreach_node_cb, &ctx);
+}
+
+/**
+ * \brief Call \p cb for the nodes of the items with type \p type containing \p at in the current space
+ *
+ * Unlike rz_meta_get_all_in(), nothing is allocated. Iteration stops as
+ * soon as \p cb returns false.
+ *
+ * \return false if \p cb stopped the iteration
+ */
+RZ_API bool rz_meta_foreach_in(RZ_NONNULL RzAnalysis *a, ut64 at, RzAnalysisMetaType type, RZ_NONNULL RzIntervalIterCb cb, void *user) {
+	rz_return_val_if_fail(a && cb, false);
+	ForeachCtx ctx = { type, rz_spaces_current(&a->meta_spaces), cb, user };
+	return rz_interval_tree_all_in(&a->meta, at, true, foreach_node_cb, &ctx);
+}
+
+/**
+ * \brief Call \p cb for the nodes of the items with type \p type intersecting [start, start + size) in the current space
+ *
+ * Unlike rz_meta_get_all_intersect(), nothing is allocated. Iteration stops
+ * as soon as \p cb returns false.
+ *
+ * \return false if \p cb stopped the iteration
+ */
+RZ_API bool rz_meta_foreach_intersect(RZ_NONNULL RzAnalysis *a, ut64 start, ut64 size, RzAnalysisMetaType type, RZ_NONNULL RzIntervalIterCb cb, void *user) {
+	rz_return_val_if_fail(a && size && cb, false);
+	ut64 end = start + size - 1;
+	if (end < start) {
+		end = UT64_MAX;
+	}
+	ForeachCtx ctx = { type, rz_spaces_current(&a->meta_spaces), cb, user };
+	return rz_interval_tree_all_intersect(&a->meta, start, end, true, foreach_node_cb, &ctx);
+}
+
 RZ_API const char *rz_meta_type_to_string(int type) {
 	switch (type) {
 	case RZ_META_TYPE_DATA: return "Cd";
@@ -269,6 +426,7 @@ RZ_API void rz_meta_rebase(RzAnalysis *analysis, ut64 diff) {
 	}
 	old.free = NULL;
 	rz_interval_tree_fini(&old);
+	rz_analysis_mark_dirty(analysis, &analysis->gen.meta, 0, UT64_MAX);
 }
 
 RZ_API void rz_meta_space_unset_for(RzAnalysis *a, const RzSpace *space) {
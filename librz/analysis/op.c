@@ -111,6 +111,9 @@ RZ_API int rz_analysis_op(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, con
 			op->size = 1;
 			return -1;
 		}
+		if (rz_analysis_op_cache_get(analysis, op, &ret, addr, data, len, mask)) {
+			goto hint;
+		}
 		ret = analysis->cur->op(analysis, op, addr, data, len, mask);
 		if (ret < 1) {
 			op->type = RZ_ANALYSIS_OP_TYPE_ILL;
@@ -120,6 +123,7 @@ RZ_API int rz_analysis_op(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, con
 		if (op->nopcode < 1) {
 			op->nopcode = 1;
 		}
+		rz_analysis_op_cache_put(analysis, op, ret, addr, data, len, mask);
 	} else if (!memcmp(data, "\xff\xff\xff\xff", RZ_MIN(4, len))) {
 		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
 	} else {
@@ -131,6 +135,7 @@ RZ_API int rz_analysis_op(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, con
 	if (!op->mnemonic && (mask & RZ_ANALYSIS_OP_MASK_DISASM)) {
 		RZ_LOG_DEBUG("Warning: unhandled RZ_ANALYSIS_OP_MASK_DISASM in rz_analysis_op\n");
 	}
+hint:
 	if (mask & RZ_ANALYSIS_OP_MASK_HINT) {
 		RzAnalysisHint *hint = rz_analysis_hint_get(analysis, addr);
 		if (hint) {
@@ -0,0 +1,595 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+
+/**
+ * \file op_cache.c
+ * Memoization of rz_analysis_op() results.
+ *
+ * Entries are keyed by address and remember the bytes they were decoded
+ * from, so patched code never hits a stale entry and no write tracking is
+ * needed. Everything else that influences the decoding (plugin, cpu, bits,
+ * endianness, register profile) either is part of the entry or flushes the
+ * whole cache when it changes.
+ *
+ * Cached values hold RzRegItem pointers, which is why entries also record
+ * the RzReg generation: a stale entry is never handed out, even when the
+ * profile was replaced behind RzAnalysis' back (e.g. by the debugger).
+ */
+
+typedef struct rz_analysis_op_cache_entry_t {
+	RzAnalysisOpMask mask;
+	RzAnalysisPlugin *plugin;
+	RzReg *reg; ///< owner of the RzRegItem pointers in the op values
+	ut32 reg_generation;
+	int bits;
+	int big_endian;
+	int ret;
+	int nbytes; ///< min(len, RZ_ANALYSIS_OP_CACHE_BYTES) of the original call
+	ut8 bytes[RZ_ANALYSIS_OP_CACHE_BYTES];
+	RzAnalysisOp op;
+} RzAnalysisOpCacheEntry;
+
+static void op_clone(RzAnalysisOp *dst, const RzAnalysisOp *src) {
+	*dst = *src;
+	dst->mnemonic = src->mnemonic ? strdup(src->mnemonic) : NULL;
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(src->src); i++) {
+		dst->src[i] = src->src[i] ? rz_analysis_value_copy(src->src[i]) : NULL;
+	}
+	dst->dst = src->dst ? rz_analysis_value_copy(src->dst) : NULL;
+	dst->access = NULL;
+	if (src->access) {
+		RzListIter *it;
+		RzAnalysisValue *val;
+		dst->access = rz_list_newf((RzListFree)rz_analysis_value_free);
+		rz_list_foreach (src->access, it, val) {
+			rz_list_append(dst->access, rz_analysis_value_copy(val));
+		}
+	}
+	rz_strbuf_init(&dst->esil);
+	rz_strbuf_copy(&dst->esil, (RzStrBuf *)&src->esil);
+	rz_strbuf_init(&dst->opex);
+	rz_strbuf_copy(&dst->opex, (RzStrBuf *)&src->opex);
+	dst->switch_op = NULL;
+	dst->il_op = NULL;
+}
+
+static void entry_free(HtUPKv *kv) {
+	RzAnalysisOpCacheEntry *entry = kv->value;
+	if (entry) {
+		rz_analysis_op_fini(&entry->op);
+		free(entry);
+	}
+}
+
+static int entry_nbytes(int len) {
+	return RZ_MIN(len, RZ_ANALYSIS_OP_CACHE_BYTES);
+}
+
+RZ_API void rz_analysis_op_cache_init(RzAnalysis *analysis) {
+	rz_return_if_fail(analysis);
+	RzAnalysisOpCache *cache = &analysis->op_cache;
+	memset(cache, 0, sizeof(*cache));
+	cache->max_entries = RZ_ANALYSIS_OP_CACHE_DEFAULT_SIZE;
+}
+
+RZ_API void rz_analysis_op_cache_fini(RzAnalysis *analysis) {
+	rz_return_if_fail(analysis);
+	ht_up_free(analysis->op_cache.entries);
+	analysis->op_cache.entries = NULL;
+}
+
+/**
+ * \brief Drop all the cached ops
+ */
+RZ_API void rz_analysis_op_cache_invalidate(RzAnalysis *analysis) {
+	rz_return_if_fail(analysis);
+	RzAnalysisOpCache *cache = &analysis->op_cache;
+	if (cache->entries && cache->entries->count) {
+		ht_up_free(cache->entries);
+		cache->entries = NULL;
+	}
+}
+
+RZ_API void rz_analysis_op_cache_enable(RzAnalysis *analysis, bool enable) {
+	rz_return_if_fail(analysis);
+	if (!enable) {
+		rz_analysis_op_cache_invalidate(analysis);
+	}
+	analysis->op_cache.enabled = enable;
+}
+
+/**
+ * \brief Set the maximum number of ops kept in the cache
+ *
+ * When the limit is reached the cache is flushed as a whole, which is much
+ * cheaper to maintain than any per-entry replacement policy.
+ */
+RZ_API void rz_analysis_op_cache_set_max_entries(RzAnalysis *analysis, size_t max_entries) {
+	rz_return_if_fail(analysis);
+	analysis->op_cache.max_entries = max_entries;
+	if (analysis->op_cache.entries && analysis->op_cache.entries->count > max_entries) {
+		rz_analysis_op_cache_invalidate(analysis);
+	}
+}
+
+RZ_API void rz_analysis_op_cache_reset_stats(RzAnalysis *analysis) {
+	rz_return_if_fail(analysis);
+	analysis->op_cache.hits = 0;
+	analysis->op_cache.misses = 0;
+}
+
+static bool op_cacheable(RzAnalysisOpMask mask) {
+	// RzILOpEffect trees can't be duplicated and the disasm text depends on asm.* options
+	return !(mask & (RZ_ANALYSIS_OP_MASK_IL | RZ_ANALYSIS_OP_MASK_DISASM));
+}
+
+/**
+ * \brief Fill \p op with the cached decoding of \p data at \p addr, if any
+ *
+ * The cached op is the plain plugin output, so callers must still apply
+ * the RZ_ANALYSIS_OP_MASK_HINT step on top of it.
+ */
+RZ_IPI bool rz_analysis_op_cache_get(RzAnalysis *analysis, RzAnalysisOp *op, int *ret, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask) {
+	RzAnalysisOpCache *cache = &analysis->op_cache;
+	if (!cache->enabled || !op_cacheable(mask)) {
+		return false;
+	}
+	mask &= ~RZ_ANALYSIS_OP_MASK_HINT;
+	RzAnalysisOpCacheEntry *entry = cache->entries ? ht_up_find(cache->entries, addr, NULL) : NULL;
+	int nbytes = entry_nbytes(len);
+	if (!entry || entry->mask != mask || entry->plugin != analysis->cur || entry->bits != analysis->bits ||
+		entry->reg != analysis->reg || (entry->reg && entry->reg_generation != entry->reg->generation) ||
+		entry->big_endian != analysis->big_endian || entry->nbytes != nbytes || memcmp(entry->bytes, data, nbytes)) {
+		cache->misses++;
+		return false;
+	}
+	cache->hits++;
+	op_clone(op, &entry->op);
+	*ret = entry->ret;
+	return true;
+}
+
+RZ_IPI void rz_analysis_op_cache_put(RzAnalysis *analysis, const RzAnalysisOp *op, int ret, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask) {
+	RzAnalysisOpCache *cache = &analysis->op_cache;
+	if (!cache->enabled || !cache->max_entries || !op_cacheable(mask) || op->switch_op || op->il_op) {
+		return;
+	}
+	if (!cache->entries) {
+		cache->entries = ht_up_new(NULL, entry_free, NULL);
+		if (!cache->entries) {
+			return;
+		}
+	} else if (cache->entries->count >= cache->max_entries) {
+		ht_up_free(cache->entries);
+		cache->entries = ht_up_new(NULL, entry_free, NULL);
+		if (!cache->entries) {
+			return;
+		}
+	}
+	RzAnalysisOpCacheEntry *entry = RZ_NEW(RzAnalysisOpCacheEntry);
+	if (!entry) {
+		return;
+	}
+	entry->mask = mask & ~RZ_ANALYSIS_OP_MASK_HINT;
+	entry->plugin = analysis->cur;
+	entry->reg = analysis->reg;
+	entry->reg_generation = analysis->reg ? analysis->reg->generation : 0;
+	entry->bits = analysis->bits;
+	entry->big_endian = analysis->big_endian;
+	entry->ret = ret;
+	entry->nbytes = entry_nbytes(len);
+	memcpy(entry->bytes, data, entry->nbytes);
+	op_clone(&entry->op, op);
+	// replaces (and frees) any older decoding at the same address
+	if (!ht_up_update(cache->entries, addr, entry)) {
+		rz_analysis_op_fini(&entry->op);
+		free(entry);
+	}
+}
+
+/*
+ * On-disk format of the cache, used by rz_analysis_op_cache_save() and
+ * rz_analysis_op_cache_load(). All the integers are uleb128, strings are
+ * their length + 1 (0 for NULL) followed by the bytes. Registers are
+ * stored by name and looked up again in the profile when loading.
+ *
+ * header: magic, format version, plugin name, plugin version, cpu
+ * entry:  addr, mask, bits, big_endian, ret, nbytes, bytes, op
+ */
+
+#define OP_CACHE_FILE_MAGIC   "rzoc"
+#define OP_CACHE_FILE_VERSION 1
+
+#define OP_CACHE_FILE_SCALARS(X) \
+	X(type) \
+	X(prefix) \
+	X(type2) \
+	X(stackop) \
+	X(cond) \
+	X(size) \
+	X(nopcode) \
+	X(cycles) \
+	X(failcycles) \
+	X(family) \
+	X(id) \
+	X(eob) \
+	X(sign) \
+	X(delay) \
+	X(jump) \
+	X(fail) \
+	X(direction) \
+	X(ptr) \
+	X(val) \
+	X(ptrsize) \
+	X(stackptr) \
+	X(refptr) \
+	X(mmio_address) \
+	X(scale) \
+	X(disp) \
+	X(datatype)
+
+typedef struct {
+	RzVector /*<ut8>*/ *out;
+	RzAnalysis *analysis;
+	ut64 saved;
+} OpCacheWriter;
+
+typedef struct {
+	const ut8 *p;
+	const ut8 *end;
+	bool ok; ///< false once anything was malformed
+	bool stale; ///< the current entry refers to registers missing from the profile
+} OpCacheReader;
+
+static void file_write_uleb(RzVector *out, ut64 v) {
+	ut8 tmp[10];
+	size_t len = 0;
+	do {
+		ut8 byte = v & 0x7f;
+		v >>= 7;
+		tmp[len++] = v ? byte | 0x80 : byte;
+	} while (v);
+	rz_vector_insert_range(out, rz_vector_len(out), tmp, len);
+}
+
+static void file_write_str(RzVector *out, const char *s) {
+	size_t len = s ? strlen(s) : 0;
+	file_write_uleb(out, s ? len + 1 : 0);
+	if (len) {
+		rz_vector_insert_range(out, rz_vector_len(out), (void *)s, len);
+	}
+}
+
+static void file_write_value(RzVector *out, const RzAnalysisValue *v) {
+	file_write_uleb(out, v->type);
+	file_write_uleb(out, v->access);
+	file_write_uleb(out, v->absolute);
+	file_write_uleb(out, v->memref);
+	file_write_uleb(out, v->base);
+	file_write_uleb(out, v->delta);
+	file_write_uleb(out, v->imm);
+	file_write_uleb(out, v->mul);
+	file_write_uleb(out, v->plugin_specific);
+	file_write_str(out, v->seg ? v->seg->name : NULL);
+	file_write_str(out, v->reg ? v->reg->name : NULL);
+	file_write_str(out, v->regdelta ? v->regdelta->name : NULL);
+}
+
+static void file_write_value_opt(RzVector *out, const RzAnalysisValue *v) {
+	file_write_uleb(out, !!v);
+	if (v) {
+		file_write_value(out, v);
+	}
+}
+
+static bool value_is_empty(const RzAnalysisValue *v) {
+	return !v->type && !v->access && !v->absolute && !v->memref && !v->base && !v->delta && !v->imm &&
+		!v->mul && !v->seg && !v->reg && !v->regdelta && !v->plugin_specific;
+}
+
+static bool file_write_entry_cb(void *user, const ut64 addr, const void *value) {
+	OpCacheWriter *w = user;
+	const RzAnalysisOpCacheEntry *entry = value;
+	RzAnalysis *analysis = w->analysis;
+	if (entry->plugin != analysis->cur || entry->reg != analysis->reg ||
+		(entry->reg && entry->reg_generation != entry->reg->generation)) {
+		// would never be handed out again anyway
+		return true;
+	}
+	RzVector *out = w->out;
+	const RzAnalysisOp *op = &entry->op;
+	file_write_uleb(out, addr);
+	file_write_uleb(out, entry->mask);
+	file_write_uleb(out, entry->bits);
+	file_write_uleb(out, entry->big_endian);
+	file_write_uleb(out, entry->ret);
+	file_write_uleb(out, entry->nbytes);
+	rz_vector_insert_range(out, rz_vector_len(out), (void *)entry->bytes, entry->nbytes);
+#define X(field) file_write_uleb(out, (ut64)op->field);
+	OP_CACHE_FILE_SCALARS(X)
+#undef X
+	// most plugins leave them all empty
+	ut64 vals_mask = 0;
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(op->analysis_vals); i++) {
+		vals_mask |= value_is_empty(&op->analysis_vals[i]) ? 0 : 1ull << i;
+	}
+	file_write_uleb(out, vals_mask);
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(op->analysis_vals); i++) {
+		if (vals_mask & (1ull << i)) {
+			file_write_value(out, &op->analysis_vals[i]);
+		}
+	}
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(op->src); i++) {
+		file_write_value_opt(out, op->src[i]);
+	}
+	file_write_value_opt(out, op->dst);
+	file_write_uleb(out, rz_list_length(op->access));
+	if (op->access) {
+		RzListIter *it;
+		RzAnalysisValue *val;
+		rz_list_foreach (op->access, it, val) {
+			file_write_value(out, val);
+		}
+	}
+	file_write_str(out, op->reg);
+	file_write_str(out, op->ireg);
+	file_write_str(out, op->mnemonic);
+	file_write_str(out, rz_strbuf_get((RzStrBuf *)&op->esil));
+	file_write_str(out, rz_strbuf_get((RzStrBuf *)&op->opex));
+	w->saved++;
+	return true;
+}
+
+/**
+ * \brief Write the cached ops to \p path, to be loaded in a later session
+ *
+ * Only the ops decoded by the current plugin with the current register
+ * profile are written. The file is meant to be keyed by the caller on the
+ * contents of the analyzed file, the plugin and cpu are checked on load.
+ *
+ * \return true if the file was written
+ */
+RZ_API bool rz_analysis_op_cache_save(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL const char *path) {
+	rz_return_val_if_fail(analysis && path, false);
+	if (!analysis->cur) {
+		return false;
+	}
+	RzVector out;
+	rz_vector_init(&out, sizeof(ut8), NULL, NULL);
+	rz_vector_insert_range(&out, 0, OP_CACHE_FILE_MAGIC, strlen(OP_CACHE_FILE_MAGIC));
+	file_write_uleb(&out, OP_CACHE_FILE_VERSION);
+	file_write_str(&out, analysis->cur->name);
+	file_write_str(&out, analysis->cur->version);
+	file_write_str(&out, analysis->cpu);
+	OpCacheWriter w = { .out = &out, .analysis = analysis };
+	if (analysis->op_cache.entries) {
+		ht_up_foreach(analysis->op_cache.entries, file_write_entry_cb, &w);
+	}
+	bool ok = rz_vector_len(&out) <= ST32_MAX && rz_file_dump(path, rz_vector_head(&out), (int)rz_vector_len(&out), false);
+	RZ_LOG_DEBUG("op cache: saved %" PFMT64u " ops to %s\n", w.saved, path);
+	rz_vector_fini(&out);
+	return ok;
+}
+
+static ut64 file_read_uleb(OpCacheReader *r) {
+	ut64 v = 0;
+	for (ut32 shift = 0; r->p < r->end && shift < 64; shift += 7) {
+		ut8 byte = *r->p++;
+		v |= (ut64)(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			return v;
+		}
+	}
+	r->ok = false;
+	return 0;
+}
+
+static bool file_read_bytes(OpCacheReader *r, void *dst, size_t len) {
+	if (!r->ok || len > (size_t)(r->end - r->p)) {
+		r->ok = false;
+		return false;
+	}
+	memcpy(dst, r->p, len);
+	r->p += len;
+	return true;
+}
+
+/**
+ * Read a string, NULL is returned for a NULL string and on errors
+ */
+static char *file_read_str(OpCacheReader *r) {
+	ut64 len = file_read_uleb(r);
+	if (!len) {
+		return NULL;
+	}
+	char *s = malloc(len);
+	if (!s || !file_read_bytes(r, s, len - 1)) {
+		r->ok = false;
+		free(s);
+		return NULL;
+	}
+	s[len - 1] = '\0';
+	return s;
+}
+
+static bool file_str_matches(OpCacheReader *r, const char *expected) {
+	char *s = file_read_str(r);
+	bool eq = r->ok && (s ? expected && !strcmp(s, expected) : !expected);
+	free(s);
+	return eq;
+}
+
+static RzRegItem *file_read_reg(OpCacheReader *r, RzReg *reg) {
+	char *name = file_read_str(r);
+	if (!name) {
+		return NULL;
+	}
+	RzRegItem *item = reg ? rz_reg_get(reg, name, -1) : NULL;
+	if (!item) {
+		// the profile changed, the entry can't be used
+		r->stale = true;
+	}
+	free(name);
+	return item;
+}
+
+static void file_read_value(OpCacheReader *r, RzReg *reg, RzAnalysisValue *v) {
+	v->type = file_read_uleb(r);
+	v->access = file_read_uleb(r);
+	v->absolute = file_read_uleb(r);
+	v->memref = file_read_uleb(r);
+	v->base = file_read_uleb(r);
+	v->delta = file_read_uleb(r);
+	v->imm = file_read_uleb(r);
+	v->mul = file_read_uleb(r);
+	v->plugin_specific = file_read_uleb(r);
+	v->seg = file_read_reg(r, reg);
+	v->reg = file_read_reg(r, reg);
+	v->regdelta = file_read_reg(r, reg);
+}
+
+static RzAnalysisValue *file_read_value_new(OpCacheReader *r, RzReg *reg) {
+	RzAnalysisValue *v = rz_analysis_value_new();
+	if (!v) {
+		r->ok = false;
+		return NULL;
+	}
+	file_read_value(r, reg, v);
+	return v;
+}
+
+static RzAnalysisValue *file_read_value_opt(OpCacheReader *r, RzReg *reg) {
+	return file_read_uleb(r) ? file_read_value_new(r, reg) : NULL;
+}
+
+static const char *file_read_interned(OpCacheReader *r, RzAnalysis *analysis) {
+	char *s = file_read_str(r);
+	const char *interned = s ? rz_str_constpool_get(&analysis->constpool, s) : NULL;
+	free(s);
+	return interned;
+}
+
+static void file_read_strbuf(OpCacheReader *r, RzStrBuf *sb) {
+	char *s = file_read_str(r);
+	if (s) {
+		rz_strbuf_set(sb, s);
+		free(s);
+	}
+}
+
+static RzAnalysisOpCacheEntry *file_read_entry(OpCacheReader *r, RzAnalysis *analysis, ut64 *addr) {
+	RzAnalysisOpCacheEntry *entry = RZ_NEW0(RzAnalysisOpCacheEntry);
+	if (!entry) {
+		r->ok = false;
+		return NULL;
+	}
+	RzAnalysisOp *op = &entry->op;
+	rz_analysis_op_init(op);
+	r->stale = false;
+	*addr = file_read_uleb(r);
+	entry->mask = file_read_uleb(r);
+	entry->bits = file_read_uleb(r);
+	entry->big_endian = file_read_uleb(r);
+	entry->ret = (int)file_read_uleb(r);
+	entry->nbytes = file_read_uleb(r);
+	if (entry->nbytes < 0 || entry->nbytes > RZ_ANALYSIS_OP_CACHE_BYTES) {
+		r->ok = false;
+		goto err;
+	}
+	file_read_bytes(r, entry->bytes, entry->nbytes);
+#define X(field) op->field = file_read_uleb(r);
+	OP_CACHE_FILE_SCALARS(X)
+#undef X
+	ut64 vals_mask = file_read_uleb(r);
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(op->analysis_vals); i++) {
+		if (vals_mask & (1ull << i)) {
+			file_read_value(r, analysis->reg, &op->analysis_vals[i]);
+		}
+	}
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(op->src); i++) {
+		op->src[i] = file_read_value_opt(r, analysis->reg);
+	}
+	op->dst = file_read_value_opt(r, analysis->reg);
+	ut64 naccess = file_read_uleb(r);
+	if (naccess) {
+		op->access = rz_list_newf((RzListFree)rz_analysis_value_free);
+	}
+	for (ut64 i = 0; op->access && i < naccess && r->ok; i++) {
+		rz_list_append(op->access, file_read_value_new(r, analysis->reg));
+	}
+	op->reg = file_read_interned(r, analysis);
+	op->ireg = file_read_interned(r, analysis);
+	op->mnemonic = file_read_str(r);
+	file_read_strbuf(r, &op->esil);
+	file_read_strbuf(r, &op->opex);
+	op->addr = *addr;
+	if (!r->ok || r->stale) {
+		goto err;
+	}
+	entry->plugin = analysis->cur;
+	entry->reg = analysis->reg;
+	entry->reg_generation = analysis->reg ? analysis->reg->generation : 0;
+	return entry;
+err:
+	rz_analysis_op_fini(op);
+	free(entry);
+	return NULL;
+}
+
+/**
+ * \brief Fill the cache with the ops written by rz_analysis_op_cache_save()
+ *
+ * Nothing is loaded if the file was written for another plugin or cpu.
+ * Ops already in the cache are kept, and loading stops once the cache is
+ * full. Since every entry remembers the bytes it was decoded from, a file
+ * saved for a different binary only results in cache misses.
+ *
+ * \return true if the file was read and matched the current plugin and cpu
+ */
+RZ_API bool rz_analysis_op_cache_load(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL const char *path) {
+	rz_return_val_if_fail(analysis && path, false);
+	RzAnalysisOpCache *cache = &analysis->op_cache;
+	if (!cache->enabled || !cache->max_entries || !analysis->cur) {
+		return false;
+	}
+	size_t size;
+	ut8 *data = (ut8 *)rz_file_slurp(path, &size);
+	if (!data) {
+		return false;
+	}
+	OpCacheReader r = { .p = data, .end = data + size, .ok = true };
+	char magic[sizeof(OP_CACHE_FILE_MAGIC) - 1];
+	if (!file_read_bytes(&r, magic, sizeof(magic)) || memcmp(magic, OP_CACHE_FILE_MAGIC, sizeof(magic)) ||
+		file_read_uleb(&r) != OP_CACHE_FILE_VERSION ||
+		!file_str_matches(&r, analysis->cur->name) ||
+		!file_str_matches(&r, analysis->cur->version) ||
+		!file_str_matches(&r, analysis->cpu)) {
+		free(data);
+		return false;
+	}
+	if (!cache->entries) {
+		cache->entries = ht_up_new(NULL, entry_free, NULL);
+	}
+	ut64 loaded = 0;
+	while (cache->entries && r.ok && r.p < r.end && cache->entries->count < cache->max_entries) {
+		ut64 addr;
+		RzAnalysisOpCacheEntry *entry = file_read_entry(&r, analysis, &addr);
+		if (!entry) {
+			if (!r.ok) {
+				RZ_LOG_WARN("op cache: %s is truncated or malformed\n", path);
+			}
+			continue;
+		}
+		if (!ht_up_insert(cache->entries, addr, entry)) {
+			rz_analysis_op_fini(&entry->op);
+			free(entry);
+			continue;
+		}
+		loaded++;
+	}
+	RZ_LOG_DEBUG("op cache: loaded %" PFMT64u " ops from %s\n", loaded, path);
+	free(data);
+	return true;
+}
@@ -1496,11 +1496,15 @@ jmp $$ + 4 + ( [delta] * 2 )
 		break;
 	}
 	if (thumb && rz_arm_it_apply_cond(&ctx->it, insn)) {
-		op->mnemonic = rz_str_newf("%s%s%s%s",
-			rz_analysis_optype_to_string(op->type),
-			cc_name(insn->detail->arm.cc),
-			insn->op_str[0] ? " " : "",
-			insn->op_str);
+		if (op->mnemonic) {
+			// only present when RZ_ANALYSIS_OP_MASK_DISASM was requested
+			free(op->mnemonic);
+			op->mnemonic = rz_str_newf("%s%s%s%s",
+				rz_analysis_optype_to_string(op->type),
+				cc_name(insn->detail->arm.cc),
+				insn->op_str[0] ? " " : "",
+				insn->op_str);
+		}
 		op->cond = (RzTypeCond)insn->detail->arm.cc;
 	}
 }
@@ -2422,6 +2426,7 @@ RzAnalysisPlugin rz_analysis_plugin_arm_cs = {
 	.preludes = analysis_preludes,
 	.bits = 16 | 32 | 64,
 	.address_bits = address_bits,
+	.concurrent_op = true,
 	.op = &analysis_op,
 	.il_config = il_config,
 	.init = &init,
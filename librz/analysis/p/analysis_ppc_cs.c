@@ -207,6 +207,15 @@ static void opex(RzStrBuf *buf, csh handle, cs_insn *insn) {
 #define ARG(n)     getarg2(&gop, n, "")
 #define ARG2(n, m) getarg2(&gop, n, m)
 
+// only render the esil string (and its operand strings) when it was requested
+#undef esilprintf
+#define esilprintf(op, fmt, ...) \
+	do { \
+		if (mask & RZ_ANALYSIS_OP_MASK_ESIL) { \
+			rz_strbuf_setf(&op->esil, fmt, ##__VA_ARGS__); \
+		} \
+	} while (0)
+
 static char *get_reg_profile(RzAnalysis *analysis) {
 	const char *p = NULL;
 	if (analysis->bits == 32) {
@@ -1291,9 +1300,6 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 		if (mask & RZ_ANALYSIS_OP_MASK_VAL) {
 			op_fillval(op, handle, insn);
 		}
-		if (!(mask & RZ_ANALYSIS_OP_MASK_ESIL)) {
-			rz_strbuf_fini(&op->esil);
-		}
 		cs_free(insn, n);
 		// cs_close (&handle);
 	}
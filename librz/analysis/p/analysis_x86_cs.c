@@ -3730,6 +3730,7 @@ RzAnalysisPlugin rz_analysis_plugin_x86_cs = {
 	.license = "BSD",
 	.arch = "x86",
 	.bits = 16 | 32 | 64,
+	.concurrent_op = true,
 	.op = &analop,
 	.preludes = analysis_preludes,
 	.archinfo = archinfo,
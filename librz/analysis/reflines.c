@@ -25,6 +25,22 @@ static int cmp_by_ref_lvl(const RzAnalysisRefline *a, const RzAnalysisRefline *b
 	return (a->level < b->level) - (a->level > b->level);
 }
 
+// stops at the first item that is not code, giving its size
+static bool skip_meta_cb(RzIntervalNode *node, void *user) {
+	RzAnalysisMetaItem *meta = node->data;
+	switch (meta->type) {
+	case RZ_META_TYPE_DATA:
+	case RZ_META_TYPE_STRING:
+	case RZ_META_TYPE_HIDE:
+	case RZ_META_TYPE_FORMAT:
+	case RZ_META_TYPE_MAGIC:
+		*(ut64 *)user = rz_meta_node_size(node);
+		return false;
+	default:
+		return true;
+	}
+}
+
 static ReflineEnd *refline_end_new(ut64 val, bool is_from, RzAnalysisRefline *ref) {
 	ReflineEnd *re = RZ_NEW0(struct refline_end);
 	if (!re) {
@@ -124,32 +140,12 @@ RZ_API RzList *rz_analysis_reflines_get(RzAnalysis *analysis, ut64 addr, const u
 		}
 		addr += sz;
 		{
-			RzPVector *metas = rz_meta_get_all_at(analysis, addr);
-			if (metas) {
-				void **it;
-				ut64 skip = 0;
-				rz_pvector_foreach (metas, it) {
-					RzIntervalNode *node = *it;
-					RzAnalysisMetaItem *meta = node->data;
-					switch (meta->type) {
-					case RZ_META_TYPE_DATA:
-					case RZ_META_TYPE_STRING:
-					case RZ_META_TYPE_HIDE:
-					case RZ_META_TYPE_FORMAT:
-					case RZ_META_TYPE_MAGIC:
-						skip = rz_meta_node_size(node);
-						goto do_skip;
-					default:
-						break;
-					}
-				}
-			do_skip:
-				rz_pvector_free(metas);
-				if (skip) {
-					ptr += skip;
-					addr += skip;
-					goto __next;
-				}
+			ut64 skip = 0;
+			rz_meta_foreach_at(analysis, addr, RZ_META_TYPE_ANY, skip_meta_cb, &skip);
+			if (skip) {
+				ptr += skip;
+				addr += skip;
+				goto __next;
 			}
 		}
 		if (!analysis->iob.is_valid_offset(analysis->iob.io, addr, RZ_PERM_X)) {
@@ -746,13 +746,16 @@ RZ_API char *rz_analysis_rtti_itanium_demangle_class_name(RVTableContext *contex
 	}
 
 	char *result = NULL;
+	// going through the file makes the demangler cache of the bin serve the repeated names
+	RzBin *bin = context->analysis->binb.bin;
+	RzBinFile *bf = bin ? rz_bin_cur(bin) : NULL;
 
 	if (name[0] != '_') {
 		char *to_demangle = rz_str_newf("_Z%s", name);
-		result = context->analysis->binb.demangle(NULL, "cxx", to_demangle, 0, false);
+		result = context->analysis->binb.demangle(bf, "cxx", to_demangle, 0, false);
 		free(to_demangle);
 	} else {
-		result = context->analysis->binb.demangle(NULL, "cxx", name, 0, false);
+		result = context->analysis->binb.demangle(bf, "cxx", name, 0, false);
 	}
 
 	return result;
@@ -796,39 +799,60 @@ static void recovery_apply_vtable(RVTableContext *context, const char *class_nam
 	}
 }
 
+static void type_name_kv_free(HtUPKv *kv) {
+	free(kv->value);
+}
+
+/**
+ * @brief Get the demangled name of the type info at \p addr
+ *
+ * @param names names by type info address, already known or read before, NULL for unreadable ones
+ */
+static const char *recovery_type_name(RVTableContext *context, HtUP *names, ut64 addr) {
+	bool found = false;
+	const char *name = ht_up_find(names, addr, &found);
+	if (found) {
+		return name;
+	}
+	class_type_info info = { 0 };
+	char *read = NULL;
+	if (rtti_itanium_read_type_name(context, addr + VT_WORD_SIZE(context), &info)) { // offset to name
+		read = info.name;
+	}
+	ht_up_insert(names, addr, read);
+	return read;
+}
+
+static void add_class_base(RVTableContext *context, HtUP *names, const class_type_info *cti, ut64 base_addr) {
+	const char *name = recovery_type_name(context, names, base_addr);
+	if (!name) {
+		return;
+	}
+	// TODO in future, store the RTTI offset from vtable and use it
+	RzAnalysisBaseClass base = { .class_name = strdup(name), .offset = 0 };
+	rz_analysis_class_base_set(context->analysis, cti->name, &base);
+	rz_analysis_class_base_fini(&base);
+}
+
 /**
  * @brief Add any base class information about the type into analysis/classes
  *
  * @param context
+ * @param names cache of the type names, see recovery_type_name()
  * @param cti
  */
-static void add_class_bases(RVTableContext *context, const class_type_info *cti) {
-	class_type_info base_info;
+static void add_class_bases(RVTableContext *context, HtUP *names, const class_type_info *cti) {
 	int i;
 
 	switch (cti->type) {
 	case RZ_TYPEINFO_TYPE_SI_CLASS: {
 		si_class_type_info *si_class = (void *)cti;
-		ut64 base_addr = si_class->base_class_addr;
-		base_addr += VT_WORD_SIZE(context); // offset to name
-		if (rtti_itanium_read_type_name(context, base_addr, &base_info)) {
-			// TODO in future, store the RTTI offset from vtable and use it
-			RzAnalysisBaseClass base = { .class_name = base_info.name, .offset = 0 };
-			rz_analysis_class_base_set(context->analysis, cti->name, &base);
-			rz_analysis_class_base_fini(&base);
-		}
+		add_class_base(context, names, cti, si_class->base_class_addr);
 	} break;
 	case RZ_TYPEINFO_TYPE_VMI_CLASS: {
 		vmi_class_type_info *vmi_class = (void *)cti;
 		for (i = 0; i < vmi_class->vmi_base_count; i++) {
-			base_class_type_info *base_class_info = vmi_class->vmi_bases + i;
-			ut64 base_addr = base_class_info->base_class_addr + VT_WORD_SIZE(context); // offset to name
-			if (rtti_itanium_read_type_name(context, base_addr, &base_info)) {
-				// TODO in future, store the RTTI offset from vtable and use it
-				RzAnalysisBaseClass base = { .class_name = base_info.name, .offset = 0 };
-				rz_analysis_class_base_set(context->analysis, cti->name, &base);
-				rz_analysis_class_base_fini(&base);
-			}
+			add_class_base(context, names, cti, vmi_class->vmi_bases[i].base_class_addr);
 		}
 	} break;
 	default: // other types have no parent classes
@@ -860,8 +884,13 @@ static void detect_constructor_destructor(RzAnalysis *analysis, class_type_info
 RZ_API void rz_analysis_rtti_itanium_recover_all(RVTableContext *context, RzList *vtables) {
 	RzList /*<class_type_info>*/ *rtti_list = rz_list_new();
 	rtti_list->free = rtti_itanium_type_info_free;
-	// to escape multiple same infos from multiple inheritance
-	SetU *unique_rttis = set_u_new();
+	// to escape multiple same infos from multiple inheritance, the bases of
+	// the classes are mostly other classes found here so their names are reused
+	HtUP *names = ht_up_new(NULL, type_name_kv_free, NULL);
+	if (!names) {
+		rz_list_free(rtti_list);
+		return;
+	}
 
 	RzListIter *iter;
 	RVTableInfo *vtable;
@@ -878,19 +907,19 @@ RZ_API void rz_analysis_rtti_itanium_recover_all(RVTableContext *context, RzList
 		detect_constructor_destructor(context->analysis, cti);
 
 		// we only need one of a kind
-		if (set_u_contains(unique_rttis, cti->typeinfo_addr)) {
+		if (ht_up_find(names, cti->typeinfo_addr, NULL)) {
 			rtti_itanium_type_info_free(cti);
 		} else {
-			set_u_add(unique_rttis, cti->typeinfo_addr);
+			ht_up_insert(names, cti->typeinfo_addr, strdup(cti->name));
 			rz_list_append(rtti_list, cti);
 		}
 	}
 
 	class_type_info *cti;
 	rz_list_foreach (rtti_list, iter, cti) {
-		add_class_bases(context, cti);
+		add_class_bases(context, names, cti);
 	}
 
-	set_u_free(unique_rttis);
+	ht_up_free(names);
 	rz_list_free(rtti_list);
 }
@@ -23,6 +23,7 @@
  *   /functions
  *     0x<addr>={name:<str>, bits?:<int>, type:<int>, cc?:<str>, stack:<int>, maxstack:<int>,
  *               ninstr:<int>, pure?:<bool>, bp_frame?:<bool>, bp_off?:<st64>, noreturn?:<bool>,
+ *               vars_pending?:<bool>,
  *               fingerprint?:"<base64>", diff?:<RzAnalysisDiff>, bbs:[<ut64>], imports?:[<str>], vars?:[<RzAnalysisVar>],
  *               labels?: {<str>:<ut64>}}
  *   /xrefs
@@ -61,6 +62,31 @@
  *
  */
 
+typedef bool (*JsonEntryLoadCb)(void *user, const char *k, RzJson *json);
+
+/*
+ * The namespaces holding one json value per entry are parsed first, possibly on
+ * several threads, then installed here one entry after another.
+ */
+static bool json_entries_load(RzVector /*<RzSerializeJsonEntry>*/ *entries, JsonEntryLoadCb cb, void *user) {
+	RzSerializeJsonEntry *entry;
+	rz_vector_foreach(entries, entry) {
+		if (!cb(user, entry->key, entry->json)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool json_entries_parse_db(RzVector /*<RzSerializeJsonEntry>*/ *entries, Sdb *db, RZ_NULLABLE RzSerializeResultInfo *res) {
+	if (!rz_serialize_json_entries_init(entries, db)) {
+		RZ_SERIALIZE_ERR(res, "failed to read entries");
+		return false;
+	}
+	rz_serialize_json_entries_parse(&entries, 1, NULL);
+	return true;
+}
+
 RZ_API void rz_serialize_analysis_diff_save(RZ_NONNULL PJ *j, RZ_NONNULL RzAnalysisDiff *diff) {
 	pj_o(j);
 	switch (diff->type) {
@@ -341,18 +367,13 @@ typedef struct {
 	RzAnalysis *analysis;
 	RzKeyParser *parser;
 	RzSerializeAnalDiffParser diff_parser;
+	RzPVector /*<RzAnalysisBlock *>*/ blocks; ///< linked to the block tree at once after parsing
 } BlockLoadCtx;
 
-static bool block_load_cb(void *user, const char *k, const char *v) {
+static bool block_load_cb(void *user, const char *k, RzJson *json) {
 	BlockLoadCtx *ctx = user;
 
-	char *json_str = strdup(v);
-	if (!json_str) {
-		return true;
-	}
-	RzJson *json = rz_json_parse(json_str);
 	if (!json || json->type != RZ_JSON_OBJECT) {
-		free(json_str);
 		return false;
 	}
 
@@ -487,8 +508,6 @@ static bool block_load_cb(void *user, const char *k, const char *v) {
 		default:
 			break;
 	})
-	rz_json_free(json);
-	free(json_str);
 
 	errno = 0;
 	ut64 addr = strtoull(k, NULL, 0);
@@ -496,10 +515,14 @@ static bool block_load_cb(void *user, const char *k, const char *v) {
 		goto error;
 	}
 
-	RzAnalysisBlock *block = rz_analysis_create_block(ctx->analysis, addr, proto.size);
+	RzAnalysisBlock *block = rz_analysis_block_new_unlinked(ctx->analysis, addr, proto.size);
 	if (!block) {
 		goto error;
 	}
+	if (!rz_pvector_push(&ctx->blocks, block)) {
+		rz_analysis_block_free_unlinked(block);
+		goto error;
+	}
 	block->jump = proto.jump;
 	block->fail = proto.fail;
 	block->traced = proto.traced;
@@ -527,8 +550,9 @@ error:
 	return false;
 }
 
-RZ_API bool rz_serialize_analysis_blocks_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RzSerializeAnalDiffParser diff_parser, RZ_NULLABLE RzSerializeResultInfo *res) {
+static bool blocks_load(RzVector /*<RzSerializeJsonEntry>*/ *entries, RzAnalysis *analysis, RzSerializeAnalDiffParser diff_parser, RZ_NULLABLE RzSerializeResultInfo *res) {
 	BlockLoadCtx ctx = { analysis, rz_key_parser_new(), diff_parser };
+	rz_pvector_init(&ctx.blocks, NULL);
 	if (!ctx.parser) {
 		RZ_SERIALIZE_ERR(res, "parser init failed");
 		return false;
@@ -547,11 +571,23 @@ RZ_API bool rz_serialize_analysis_blocks_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzA
 	rz_key_parser_add(ctx.parser, "parent_stackptr", BLOCK_FIELD_PARENT_STACKPTR);
 	rz_key_parser_add(ctx.parser, "cmpval", BLOCK_FIELD_CMPVAL);
 	rz_key_parser_add(ctx.parser, "cmpreg", BLOCK_FIELD_CMPREG);
-	bool ret = sdb_foreach(db, block_load_cb, &ctx);
+	bool ret = json_entries_load(entries, block_load_cb, &ctx);
 	rz_key_parser_free(ctx.parser);
 	if (!ret) {
 		RZ_SERIALIZE_ERR(res, "basic blocks parsing failed");
 	}
+	if (!rz_analysis_blocks_link_all(analysis, &ctx.blocks) && ret) {
+		RZ_SERIALIZE_ERR(res, "basic blocks overlap existing ones");
+		ret = false;
+	}
+	rz_pvector_fini(&ctx.blocks);
+	return ret;
+}
+
+RZ_API bool rz_serialize_analysis_blocks_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RzSerializeAnalDiffParser diff_parser, RZ_NULLABLE RzSerializeResultInfo *res) {
+	RzVector entries;
+	bool ret = json_entries_parse_db(&entries, db, res) && blocks_load(&entries, analysis, diff_parser, res);
+	rz_serialize_json_entries_fini(&entries);
 	return ret;
 }
 
@@ -933,16 +969,10 @@ typedef struct {
 	RzKeyParser *parser;
 } GlobalVarCtx;
 
-static bool global_var_load_cb(void *user, const char *k, const char *v) {
+static bool global_var_load_cb(void *user, const char *k, RzJson *json) {
 	GlobalVarCtx *ctx = user;
 
-	char *json_str = strdup(v);
-	if (!json_str) {
-		return true;
-	}
-	RzJson *json = rz_json_parse(json_str);
 	if (!json || json->type != RZ_JSON_OBJECT) {
-		free(json_str);
 		return false;
 	}
 
@@ -1032,7 +1062,7 @@ beach:
 	return false;
 }
 
-RZ_API bool rz_serialize_analysis_global_var_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
+static bool global_vars_load(RzVector /*<RzSerializeJsonEntry>*/ *entries, RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
 	GlobalVarCtx ctx = {
 		.analysis = analysis,
 		.parser = rz_serialize_analysis_global_var_parser_new(),
@@ -1043,7 +1073,7 @@ RZ_API bool rz_serialize_analysis_global_var_load(RZ_NONNULL Sdb *db, RZ_NONNULL
 		ret = false;
 		goto beach;
 	}
-	ret = sdb_foreach(db, global_var_load_cb, &ctx);
+	ret = json_entries_load(entries, global_var_load_cb, &ctx);
 	if (!ret) {
 		RZ_SERIALIZE_ERR(res, "functions parsing failed");
 	}
@@ -1052,6 +1082,13 @@ beach:
 	return ret;
 }
 
+RZ_API bool rz_serialize_analysis_global_var_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
+	RzVector entries;
+	bool ret = json_entries_parse_db(&entries, db, res) && global_vars_load(&entries, analysis, res);
+	rz_serialize_json_entries_fini(&entries);
+	return ret;
+}
+
 static bool store_label_cb(void *j, const ut64 k, const void *v) {
 	pj_kn(j, v, k);
 	return true;
@@ -1087,6 +1124,9 @@ static void function_store(RZ_NONNULL Sdb *db, const char *key, RzAnalysisFuncti
 	if (function->is_noreturn) {
 		pj_kb(j, "noreturn", true);
 	}
+	if (function->vars_pending) {
+		pj_kb(j, "vars_pending", true);
+	}
 	if (function->fingerprint) {
 		char *b64 = rz_base64_encode_dyn(function->fingerprint, function->fingerprint_size);
 		if (b64) {
@@ -1161,6 +1201,7 @@ enum {
 	FUNCTION_FIELD_BP_FRAME,
 	FUNCTION_FIELD_BP_OFF,
 	FUNCTION_FIELD_NORETURN,
+	FUNCTION_FIELD_VARS_PENDING,
 	FUNCTION_FIELD_FINGERPRINT,
 	FUNCTION_FIELD_DIFF,
 	FUNCTION_FIELD_BBS,
@@ -1176,16 +1217,10 @@ typedef struct {
 	RzSerializeAnalVarParser var_parser;
 } FunctionLoadCtx;
 
-static bool function_load_cb(void *user, const char *k, const char *v) {
+static bool function_load_cb(void *user, const char *k, RzJson *json) {
 	FunctionLoadCtx *ctx = user;
 
-	char *json_str = strdup(v);
-	if (!json_str) {
-		return true;
-	}
-	RzJson *json = rz_json_parse(json_str);
 	if (!json || json->type != RZ_JSON_OBJECT) {
-		free(json_str);
 		return false;
 	}
 
@@ -1265,6 +1300,12 @@ static bool function_load_cb(void *user, const char *k, const char *v) {
 			}
 			noreturn = child->num.u_value ? true : false;
 			break;
+		case FUNCTION_FIELD_VARS_PENDING:
+			if (child->type != RZ_JSON_BOOLEAN) {
+				break;
+			}
+			function->vars_pending = child->num.u_value ? true : false;
+			break;
 		case FUNCTION_FIELD_FINGERPRINT:
 			if (child->type != RZ_JSON_STRING) {
 				break;
@@ -1385,12 +1426,10 @@ static bool function_load_cb(void *user, const char *k, const char *v) {
 	}
 
 beach:
-	rz_json_free(json);
-	free(json_str);
 	return ret;
 }
 
-RZ_API bool rz_serialize_analysis_functions_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RzSerializeAnalDiffParser diff_parser, RZ_NULLABLE RzSerializeResultInfo *res) {
+static bool functions_load(RzVector /*<RzSerializeJsonEntry>*/ *entries, RzAnalysis *analysis, RzSerializeAnalDiffParser diff_parser, RZ_NULLABLE RzSerializeResultInfo *res) {
 	FunctionLoadCtx ctx = {
 		.analysis = analysis,
 		.parser = rz_key_parser_new(),
@@ -1414,13 +1453,14 @@ RZ_API bool rz_serialize_analysis_functions_load(RZ_NONNULL Sdb *db, RZ_NONNULL
 	rz_key_parser_add(ctx.parser, "bp_frame", FUNCTION_FIELD_BP_FRAME);
 	rz_key_parser_add(ctx.parser, "bp_off", FUNCTION_FIELD_BP_OFF);
 	rz_key_parser_add(ctx.parser, "noreturn", FUNCTION_FIELD_NORETURN);
+	rz_key_parser_add(ctx.parser, "vars_pending", FUNCTION_FIELD_VARS_PENDING);
 	rz_key_parser_add(ctx.parser, "fingerprint", FUNCTION_FIELD_FINGERPRINT);
 	rz_key_parser_add(ctx.parser, "diff", FUNCTION_FIELD_DIFF);
 	rz_key_parser_add(ctx.parser, "bbs", FUNCTION_FIELD_BBS);
 	rz_key_parser_add(ctx.parser, "imports", FUNCTION_FIELD_IMPORTS);
 	rz_key_parser_add(ctx.parser, "vars", FUNCTION_FIELD_VARS);
 	rz_key_parser_add(ctx.parser, "labels", FUNCTION_FIELD_LABELS);
-	ret = sdb_foreach(db, function_load_cb, &ctx);
+	ret = json_entries_load(entries, function_load_cb, &ctx);
 	if (!ret) {
 		RZ_SERIALIZE_ERR(res, "functions parsing failed");
 	}
@@ -1430,6 +1470,13 @@ beach:
 	return ret;
 }
 
+RZ_API bool rz_serialize_analysis_functions_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RzSerializeAnalDiffParser diff_parser, RZ_NULLABLE RzSerializeResultInfo *res) {
+	RzVector entries;
+	bool ret = json_entries_parse_db(&entries, db, res) && functions_load(&entries, analysis, diff_parser, res);
+	rz_serialize_json_entries_fini(&entries);
+	return ret;
+}
+
 RZ_API void rz_serialize_analysis_function_noreturn_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis) {
 	sdb_copy(analysis->sdb_noret, db);
 }
@@ -1440,41 +1487,57 @@ RZ_API bool rz_serialize_analysis_function_noreturn_load(RZ_NONNULL Sdb *db, RZ_
 	return true;
 }
 
-static bool store_xref_cb(void *j, const ut64 k, const void *v) {
-	const RzAnalysisXRef *xref = v;
-	pj_o(j);
-	pj_kn(j, "to", k);
-	if (xref->type != RZ_ANALYSIS_XREF_TYPE_NULL) {
-		char type[2] = { xref->type, '\0' };
-		pj_ks(j, "type", type);
+typedef struct {
+	Sdb *db;
+	PJ *j;
+	ut64 from;
+} XRefsSaveCtx;
+
+static void store_xrefs_list(XRefsSaveCtx *ctx) {
+	char key[0x20];
+	if (!ctx->j) {
+		return;
 	}
-	pj_end(j);
-	return true;
+	pj_end(ctx->j);
+	if (snprintf(key, sizeof(key), "0x%" PFMT64x, ctx->from) >= 0) {
+		sdb_set(ctx->db, key, pj_string(ctx->j), 0);
+	}
+	pj_free(ctx->j);
+	ctx->j = NULL;
 }
 
-static bool store_xrefs_list_cb(void *db, const ut64 k, const void *v) {
-	char key[0x20];
-	if (snprintf(key, sizeof(key), "0x%" PFMT64x, k) < 0) {
-		return false;
+static bool store_xref_cb(void *user, const RzAnalysisXRef *xref) {
+	XRefsSaveCtx *ctx = user;
+	// xrefs come sorted by source, so each source address is one array
+	if (ctx->j && ctx->from != xref->from) {
+		store_xrefs_list(ctx);
 	}
-	PJ *j = pj_new();
-	if (!j) {
-		return false;
+	if (!ctx->j) {
+		ctx->j = pj_new();
+		if (!ctx->j) {
+			return false;
+		}
+		ctx->from = xref->from;
+		pj_a(ctx->j);
+	}
+	PJ *j = ctx->j;
+	pj_o(j);
+	pj_kn(j, "to", xref->to);
+	if (xref->type != RZ_ANALYSIS_XREF_TYPE_NULL) {
+		char type[2] = { xref->type, '\0' };
+		pj_ks(j, "type", type);
 	}
-	pj_a(j);
-	HtUP *ht = (HtUP *)v;
-	ht_up_foreach(ht, store_xref_cb, j);
 	pj_end(j);
-	sdb_set(db, key, pj_string(j), 0);
-	pj_free(j);
 	return true;
 }
 
 RZ_API void rz_serialize_analysis_xrefs_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis) {
-	ht_up_foreach(analysis->ht_xrefs_from, store_xrefs_list_cb, db);
+	XRefsSaveCtx ctx = { db, NULL, 0 };
+	rz_analysis_xrefs_foreach(analysis, store_xref_cb, &ctx);
+	store_xrefs_list(&ctx);
 }
 
-static bool xrefs_load_cb(void *user, const char *k, const char *v) {
+static bool xrefs_load_cb(void *user, const char *k, RzJson *json) {
 	RzAnalysis *analysis = user;
 
 	errno = 0;
@@ -1483,13 +1546,7 @@ static bool xrefs_load_cb(void *user, const char *k, const char *v) {
 		return false;
 	}
 
-	char *json_str = strdup(v);
-	if (!json_str) {
-		return true;
-	}
-	RzJson *json = rz_json_parse(json_str);
 	if (!json || json->type != RZ_JSON_ARRAY) {
-		free(json_str);
 		return false;
 	}
 
@@ -1526,27 +1583,27 @@ static bool xrefs_load_cb(void *user, const char *k, const char *v) {
 		rz_analysis_xrefs_set(analysis, from, to, type);
 	}
 
-	rz_json_free(json);
-	free(json_str);
-
 	return true;
 error:
-	rz_json_free(json);
-	free(json_str);
 	return false;
 }
 
-RZ_API bool rz_serialize_analysis_xrefs_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
-	bool ret = sdb_foreach(db, xrefs_load_cb, analysis);
+static bool xrefs_load(RzVector /*<RzSerializeJsonEntry>*/ *entries, RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
+	bool ret = json_entries_load(entries, xrefs_load_cb, analysis);
 	if (!ret) {
 		RZ_SERIALIZE_ERR(res, "xrefs parsing failed");
 	}
 	return ret;
 }
 
-RZ_API void rz_serialize_analysis_meta_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis) {
-	rz_serialize_spaces_save(sdb_ns(db, "spaces", true), &analysis->meta_spaces);
+RZ_API bool rz_serialize_analysis_xrefs_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
+	RzVector entries;
+	bool ret = json_entries_parse_db(&entries, db, res) && xrefs_load(&entries, analysis, res);
+	rz_serialize_json_entries_fini(&entries);
+	return ret;
+}
 
+static void meta_entries_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis) {
 	if (rz_interval_tree_empty(&analysis->meta)) {
 		return;
 	}
@@ -1637,8 +1694,19 @@ RZ_API void rz_serialize_analysis_meta_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAna
 	pj_free(j);
 }
 
-static bool meta_load_cb(void *user, const char *k, const char *v) {
-	RzAnalysis *analysis = user;
+RZ_API void rz_serialize_analysis_meta_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis) {
+	rz_serialize_spaces_save(sdb_ns(db, "spaces", true), &analysis->meta_spaces);
+	meta_entries_save(db, analysis);
+}
+
+typedef struct {
+	RzAnalysis *analysis;
+	RzVector /*<RzIntervalTreeEntry>*/ entries; ///< collected to build the meta tree at once
+} MetaLoadCtx;
+
+static bool meta_load_cb(void *user, const char *k, RzJson *json) {
+	MetaLoadCtx *ctx = user;
+	RzAnalysis *analysis = ctx->analysis;
 
 	errno = 0;
 	ut64 addr = strtoull(k, NULL, 0);
@@ -1646,13 +1714,7 @@ static bool meta_load_cb(void *user, const char *k, const char *v) {
 		return false;
 	}
 
-	char *json_str = strdup(v);
-	if (!json_str) {
-		return true;
-	}
-	RzJson *json = rz_json_parse(json_str);
 	if (!json || json->type != RZ_JSON_ARRAY) {
-		free(json_str);
 		return false;
 	}
 
@@ -1753,20 +1815,27 @@ static bool meta_load_cb(void *user, const char *k, const char *v) {
 		if (end < addr) {
 			end = UT64_MAX;
 		}
-		rz_interval_tree_insert(&analysis->meta, addr, end, item);
+		RzIntervalTreeEntry *entry = rz_vector_push(&ctx->entries, NULL);
+		if (!entry) {
+			analysis->meta.free(item);
+			break;
+		}
+		entry->start = addr;
+		entry->end = end;
+		entry->data = item;
 	}
 
-	rz_json_free(json);
-	free(json_str);
-
 	return true;
 error:
-	rz_json_free(json);
-	free(json_str);
 	return false;
 }
 
-RZ_API bool rz_serialize_analysis_meta_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
+static int meta_entry_cmp(const void *a, const void *b) {
+	const RzIntervalTreeEntry *x = a, *y = b;
+	return x->start < y->start ? -1 : (x->start > y->start ? 1 : 0);
+}
+
+static bool meta_load(Sdb *db, RzVector /*<RzSerializeJsonEntry>*/ *entries, RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
 	Sdb *spaces_db = sdb_ns(db, "spaces", false);
 	if (!spaces_db) {
 		RZ_SERIALIZE_ERR(res, "missing meta spaces namespace");
@@ -1775,10 +1844,26 @@ RZ_API bool rz_serialize_analysis_meta_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAna
 	if (!rz_serialize_spaces_load(spaces_db, &analysis->meta_spaces, false, res)) {
 		return false;
 	}
-	bool ret = sdb_foreach(db, meta_load_cb, analysis);
+	MetaLoadCtx ctx = { .analysis = analysis };
+	rz_vector_init(&ctx.entries, sizeof(RzIntervalTreeEntry), NULL, NULL);
+	bool ret = json_entries_load(entries, meta_load_cb, &ctx);
 	if (!ret) {
 		RZ_SERIALIZE_ERR(res, "meta parsing failed");
 	}
+	// sdb iterates in hash order, sorting first makes the tree build linear
+	rz_vector_sort(&ctx.entries, meta_entry_cmp, false);
+	if (!rz_interval_tree_bulk_load(&analysis->meta, rz_vector_head(&ctx.entries), rz_vector_len(&ctx.entries))) {
+		RZ_SERIALIZE_ERR(res, "meta tree building failed");
+		ret = false;
+	}
+	rz_vector_fini(&ctx.entries);
+	return ret;
+}
+
+RZ_API bool rz_serialize_analysis_meta_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
+	RzVector entries;
+	bool ret = json_entries_parse_db(&entries, db, res) && meta_load(db, &entries, analysis, res);
+	rz_serialize_json_entries_fini(&entries);
 	return ret;
 }
 
@@ -2138,6 +2223,7 @@ RZ_API bool rz_serialize_analysis_classes_load(RZ_NONNULL Sdb *db, RZ_NONNULL Rz
 	sdb_reset(analysis->sdb_classes);
 	sdb_reset(analysis->sdb_classes_attrs);
 	sdb_copy(db, analysis->sdb_classes);
+	rz_analysis_class_methods_reset(analysis);
 	return true;
 }
 
@@ -2191,13 +2277,58 @@ RZ_API bool rz_serialize_analysis_cc_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnaly
 	return true;
 }
 
+typedef void (*NamespaceSaveCb)(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis);
+
+/*
+ * Save a namespace whose table bumps \p generation on every change. The result
+ * is kept in analysis->serialize_cache and copied as is by the next saves
+ * until the counter moves, which is much cheaper than generating the json again.
+ */
+static void namespace_save_cached(Sdb *db, RzAnalysis *analysis, const char *ns, ut64 generation, NamespaceSaveCb save) {
+	if (!analysis->serialize_cache) {
+		analysis->serialize_cache = sdb_new0();
+	}
+	Sdb *cache = analysis->serialize_cache;
+	if (!cache) {
+		save(db, analysis);
+		return;
+	}
+	Sdb *cached = sdb_ns(cache, ns, false);
+	if (cached && sdb_exists(cache, ns) && sdb_num_get(cache, ns, NULL) == generation) {
+		sdb_copy(cached, db);
+		return;
+	}
+	save(db, analysis);
+	if (cached) {
+		sdb_reset(cached);
+	} else {
+		cached = sdb_ns(cache, ns, true);
+	}
+	if (!cached) {
+		sdb_unset(cache, ns, 0);
+		return;
+	}
+	sdb_copy(db, cached);
+	sdb_num_set(cache, ns, generation, 0);
+}
+
+/**
+ * \brief Save all of \p analysis into \p db
+ *
+ * The xrefs, meta and hints are only serialized again if they changed since the
+ * previous call, so that saving a big project repeatedly mostly costs the
+ * functions and blocks.
+ */
 RZ_API void rz_serialize_analysis_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis) {
-	rz_serialize_analysis_xrefs_save(sdb_ns(db, "xrefs", true), analysis);
+	namespace_save_cached(sdb_ns(db, "xrefs", true), analysis, "xrefs", analysis->gen.xrefs, rz_serialize_analysis_xrefs_save);
 	rz_serialize_analysis_blocks_save(sdb_ns(db, "blocks", true), analysis);
 	rz_serialize_analysis_functions_save(sdb_ns(db, "functions", true), analysis);
 	rz_serialize_analysis_function_noreturn_save(sdb_ns(db, "noreturn", true), analysis);
-	rz_serialize_analysis_meta_save(sdb_ns(db, "meta", true), analysis);
-	rz_serialize_analysis_hints_save(sdb_ns(db, "hints", true), analysis);
+	Sdb *meta_db = sdb_ns(db, "meta", true);
+	namespace_save_cached(meta_db, analysis, "meta", analysis->gen.meta, meta_entries_save);
+	// spaces are not counted by gen.meta, saved after so they are not cached
+	rz_serialize_spaces_save(sdb_ns(meta_db, "spaces", true), &analysis->meta_spaces);
+	namespace_save_cached(sdb_ns(db, "hints", true), analysis, "hints", analysis->gen.hints, rz_serialize_analysis_hints_save);
 	rz_serialize_analysis_classes_save(sdb_ns(db, "classes", true), analysis);
 	rz_serialize_analysis_types_save(sdb_ns(db, "types", true), analysis);
 	rz_serialize_analysis_callables_save(sdb_ns(db, "callables", true), analysis);
@@ -2207,8 +2338,39 @@ RZ_API void rz_serialize_analysis_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis
 	rz_serialize_analysis_global_var_save(sdb_ns(db, "vars", true), analysis);
 }
 
-RZ_API bool rz_serialize_analysis_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
+enum {
+	PARSED_NS_XREFS,
+	PARSED_NS_BLOCKS,
+	PARSED_NS_FUNCTIONS,
+	PARSED_NS_META,
+	PARSED_NS_VARS,
+	PARSED_NS_COUNT
+};
+
+static const char *parsed_ns_names[PARSED_NS_COUNT] = {
+	[PARSED_NS_XREFS] = "xrefs",
+	[PARSED_NS_BLOCKS] = "blocks",
+	[PARSED_NS_FUNCTIONS] = "functions",
+	[PARSED_NS_META] = "meta",
+	[PARSED_NS_VARS] = "vars",
+};
+
+/**
+ * \brief Load the analysis from \p db, parsing the biggest namespaces on \p pool
+ *
+ * The json values of the xrefs, blocks, functions, meta and global variables
+ * don't depend on each other, so they are all parsed in parallel before being
+ * installed into \p analysis in the same order as rz_serialize_analysis_load().
+ *
+ * \param pool Workers to parse on, everything is done by the caller if NULL
+ */
+RZ_API bool rz_serialize_analysis_load_parallel(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzThreadTaskPool *pool, RZ_NULLABLE RzSerializeResultInfo *res) {
+	rz_return_val_if_fail(db && analysis, false);
 	bool ret = false;
+	Sdb *parsed_dbs[PARSED_NS_COUNT];
+	RzVector parsed[PARSED_NS_COUNT];
+	RzVector *parsed_ptrs[PARSED_NS_COUNT];
+	size_t parsed_count = 0;
 	RzSerializeAnalDiffParser diff_parser = rz_serialize_analysis_diff_parser_new();
 	if (!diff_parser) {
 		goto beach;
@@ -2216,11 +2378,31 @@ RZ_API bool rz_serialize_analysis_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis
 
 	rz_analysis_purge(analysis);
 
+	for (; parsed_count < PARSED_NS_COUNT; parsed_count++) {
+		const char *ns = parsed_ns_names[parsed_count];
+		parsed_dbs[parsed_count] = sdb_ns(db, ns, false);
+		if (!parsed_dbs[parsed_count]) {
+			RZ_SERIALIZE_ERR(res, "missing %s namespace", ns);
+			goto beach;
+		}
+		parsed_ptrs[parsed_count] = &parsed[parsed_count];
+		if (!rz_serialize_json_entries_init(&parsed[parsed_count], parsed_dbs[parsed_count])) {
+			RZ_SERIALIZE_ERR(res, "failed to read %s entries", ns);
+			parsed_count++;
+			goto beach;
+		}
+	}
+	rz_serialize_json_entries_parse(parsed_ptrs, PARSED_NS_COUNT, pool);
+
 	Sdb *subdb;
 #define SUB(ns, call) RZ_SERIALIZE_SUB_DO(db, subdb, res, ns, call, goto beach;)
-	SUB("xrefs", rz_serialize_analysis_xrefs_load(subdb, analysis, res));
+	if (!xrefs_load(&parsed[PARSED_NS_XREFS], analysis, res)) {
+		goto beach;
+	}
 
-	SUB("blocks", rz_serialize_analysis_blocks_load(subdb, analysis, diff_parser, res));
+	if (!blocks_load(&parsed[PARSED_NS_BLOCKS], analysis, diff_parser, res)) {
+		goto beach;
+	}
 
 	SUB("classes", rz_serialize_analysis_classes_load(subdb, analysis, res));
 	SUB("types", rz_serialize_analysis_types_load(subdb, analysis, res));
@@ -2228,7 +2410,9 @@ RZ_API bool rz_serialize_analysis_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis
 	SUB("typelinks", rz_serialize_analysis_typelinks_load(subdb, analysis, res));
 
 	// All bbs have ref=1 now
-	SUB("functions", rz_serialize_analysis_functions_load(subdb, analysis, diff_parser, res));
+	if (!functions_load(&parsed[PARSED_NS_FUNCTIONS], analysis, diff_parser, res)) {
+		goto beach;
+	}
 	SUB("noreturn", rz_serialize_analysis_function_noreturn_load(subdb, analysis, res));
 	// BB's refs have increased if they are part of a function.
 	// We must subtract from each to hold our invariant again.
@@ -2247,14 +2431,26 @@ RZ_API bool rz_serialize_analysis_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis
 	}
 	rz_pvector_clear(&orphaned_bbs); // unrefs all
 
-	SUB("meta", rz_serialize_analysis_meta_load(subdb, analysis, res));
+	if (!meta_load(parsed_dbs[PARSED_NS_META], &parsed[PARSED_NS_META], analysis, res)) {
+		goto beach;
+	}
 	SUB("hints", rz_serialize_analysis_hints_load(subdb, analysis, res));
 	SUB("imports", rz_serialize_analysis_imports_load(subdb, analysis, res));
 	SUB("cc", rz_serialize_analysis_cc_load(subdb, analysis, res));
-	SUB("vars", rz_serialize_analysis_global_var_load(subdb, analysis, res));
+	if (!global_vars_load(&parsed[PARSED_NS_VARS], analysis, res)) {
+		goto beach;
+	}
+#undef SUB
 
 	ret = true;
 beach:
+	for (size_t i = 0; i < parsed_count; i++) {
+		rz_serialize_json_entries_fini(&parsed[i]);
+	}
 	rz_serialize_analysis_diff_parser_free(diff_parser);
 	return ret;
 }
+
+RZ_API bool rz_serialize_analysis_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
+	return rz_serialize_analysis_load_parallel(db, analysis, NULL, res);
+}
@@ -0,0 +1,450 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+
+/**
+ * \file snapshot.c
+ * Read-only snapshots of the functions, blocks and xrefs for concurrent readers.
+ *
+ * The thread mutating the analysis publishes a snapshot with
+ * rz_analysis_snapshot_publish() at points where the tables are consistent,
+ * and any other thread acquires the last one published with
+ * rz_analysis_snapshot_acquire(). A snapshot never changes and is freed when
+ * its last reference is released, so readers never wait for the analysis
+ * and never see a table in the middle of a change, at the cost of reading
+ * the state of the last publication.
+ *
+ * A snapshot is made of a part for the functions and blocks and a part for
+ * the xrefs. Publishing rebuilds a part only if its tables changed since the
+ * previous snapshot, according to RzAnalysis.gen, and shares it otherwise.
+ */
+
+/**
+ * Reference count of a snapshot or of one of its parts, the last reference
+ * may be released by any thread.
+ */
+typedef struct {
+	ut32 count;
+	RzThreadLock *lock;
+} SnapshotRef;
+
+struct rz_analysis_snapshot_t {
+	SnapshotRef ref;
+	ut64 generation; ///< RzAnalysis.gen.total when published
+	struct snapshot_code_t *code;
+	struct snapshot_xrefs_t *xrefs;
+};
+
+typedef struct snapshot_code_t {
+	SnapshotRef ref;
+	ut64 fcns_gen; ///< RzAnalysis.gen.fcns this was built at
+	ut64 blocks_gen; ///< RzAnalysis.gen.blocks this was built at
+	RzVector /*<RzAnalysisSnapshotFunction>*/ functions; ///< sorted by addr
+	RzVector /*<RzAnalysisSnapshotBlock>*/ blocks; ///< sorted by addr
+	ut64 max_block_size;
+	ut64 *addrs; ///< storage of RzAnalysisSnapshotFunction.blocks and RzAnalysisSnapshotBlock.fcns
+} SnapshotCode;
+
+typedef struct snapshot_xrefs_t {
+	SnapshotRef ref;
+	ut64 gen; ///< RzAnalysis.gen.xrefs this was built at
+	RzVector /*<RzAnalysisXRef>*/ by_from; ///< sorted by (from, to)
+	RzVector /*<RzAnalysisXRef>*/ by_to; ///< sorted by (to, from)
+} SnapshotXRefs;
+
+static bool ref_init(SnapshotRef *ref) {
+	ref->count = 1;
+	ref->lock = rz_th_lock_new(false);
+	return ref->lock != NULL;
+}
+
+static void ref_inc(SnapshotRef *ref) {
+	rz_th_lock_enter(ref->lock);
+	ref->count++;
+	rz_th_lock_leave(ref->lock);
+}
+
+// true if the last reference was dropped, the lock is freed then
+static bool ref_dec(SnapshotRef *ref) {
+	rz_th_lock_enter(ref->lock);
+	bool last = !--ref->count;
+	rz_th_lock_leave(ref->lock);
+	if (last) {
+		rz_th_lock_free(ref->lock);
+	}
+	return last;
+}
+
+static int ut64_cmp(const void *a, const void *b) {
+	ut64 x = *(const ut64 *)a;
+	ut64 y = *(const ut64 *)b;
+	return x < y ? -1 : x > y;
+}
+
+static int snapshot_fcn_cmp(const void *a, const void *b) {
+	return ut64_cmp(&((const RzAnalysisSnapshotFunction *)a)->addr, &((const RzAnalysisSnapshotFunction *)b)->addr);
+}
+
+static int xref_to_cmp(const void *a, const void *b) {
+	const RzAnalysisXRef *x = a, *y = b;
+	int r = ut64_cmp(&x->to, &y->to);
+	return r ? r : ut64_cmp(&x->from, &y->from);
+}
+
+#define FCN_ADDR_CMP(x, y)   ((x) < ((RzAnalysisSnapshotFunction *)(y))->addr ? -1 : (x) > ((RzAnalysisSnapshotFunction *)(y))->addr)
+#define BLOCK_ADDR_CMP(x, y) ((x) < ((RzAnalysisSnapshotBlock *)(y))->addr ? -1 : (x) > ((RzAnalysisSnapshotBlock *)(y))->addr)
+#define XREF_FROM_CMP(x, y)  ((x) < ((RzAnalysisXRef *)(y))->from ? -1 : (x) > ((RzAnalysisXRef *)(y))->from)
+#define XREF_TO_CMP(x, y)    ((x) < ((RzAnalysisXRef *)(y))->to ? -1 : (x) > ((RzAnalysisXRef *)(y))->to)
+
+static void snapshot_fcn_fini(void *e, void *user) {
+	RzAnalysisSnapshotFunction *fcn = e;
+	free((char *)fcn->name);
+}
+
+static void code_unref(SnapshotCode *code) {
+	if (!code || !ref_dec(&code->ref)) {
+		return;
+	}
+	rz_vector_fini(&code->functions);
+	rz_vector_fini(&code->blocks);
+	free(code->addrs);
+	free(code);
+}
+
+static SnapshotCode *code_new(RzAnalysis *analysis) {
+	SnapshotCode *code = RZ_NEW0(SnapshotCode);
+	if (!code) {
+		return NULL;
+	}
+	if (!ref_init(&code->ref)) {
+		free(code);
+		return NULL;
+	}
+	code->fcns_gen = analysis->gen.fcns;
+	code->blocks_gen = analysis->gen.blocks;
+	rz_vector_init(&code->functions, sizeof(RzAnalysisSnapshotFunction), snapshot_fcn_fini, NULL);
+	rz_vector_init(&code->blocks, sizeof(RzAnalysisSnapshotBlock), NULL, NULL);
+
+	// every membership is both in the blocks of a function and in the functions of a block
+	size_t addrs_count = 0;
+	RzListIter *it;
+	RzAnalysisFunction *fcn;
+	rz_list_foreach (analysis->fcns, it, fcn) {
+		addrs_count += rz_list_length(fcn->bbs);
+	}
+	addrs_count *= 2;
+	if (addrs_count && !(code->addrs = RZ_NEWS(ut64, addrs_count))) {
+		goto fail;
+	}
+	size_t fcns_count = rz_list_length(analysis->fcns);
+	if (fcns_count && !rz_vector_reserve(&code->functions, fcns_count)) {
+		goto fail;
+	}
+
+	size_t used = 0;
+	rz_list_foreach (analysis->fcns, it, fcn) {
+		RzAnalysisSnapshotFunction *sf = rz_vector_push(&code->functions, NULL);
+		if (!sf) {
+			goto fail;
+		}
+		memset(sf, 0, sizeof(*sf));
+		sf->addr = fcn->addr;
+		sf->name = fcn->name ? strdup(fcn->name) : NULL;
+		sf->type = fcn->type;
+		sf->bits = fcn->bits;
+		sf->min_addr = rz_analysis_function_min_addr(fcn);
+		sf->max_addr = rz_analysis_function_max_addr(fcn);
+		size_t count = rz_list_length(fcn->bbs);
+		if (!count || count > addrs_count - used) {
+			continue;
+		}
+		ut64 *addrs = code->addrs + used;
+		RzListIter *bit;
+		RzAnalysisBlock *block;
+		size_t i = 0;
+		rz_list_foreach (fcn->bbs, bit, block) {
+			addrs[i++] = block->addr;
+		}
+		qsort(addrs, count, sizeof(ut64), ut64_cmp);
+		sf->blocks = addrs;
+		sf->blocks_count = count;
+		used += count;
+	}
+	rz_vector_sort(&code->functions, snapshot_fcn_cmp, false);
+
+	RBIter rit;
+	RzAnalysisBlock *block;
+	rz_rbtree_foreach (analysis->bb_tree, rit, block, RzAnalysisBlock, _rb) {
+		RzAnalysisSnapshotBlock *sb = rz_vector_push(&code->blocks, NULL);
+		if (!sb) {
+			goto fail;
+		}
+		memset(sb, 0, sizeof(*sb));
+		sb->addr = block->addr;
+		sb->size = block->size;
+		sb->jump = block->jump;
+		sb->fail = block->fail;
+		sb->ninstr = block->ninstr;
+		code->max_block_size = RZ_MAX(code->max_block_size, block->size);
+		size_t count = rz_list_length(block->fcns);
+		if (!count || count > addrs_count - used) {
+			continue;
+		}
+		ut64 *addrs = code->addrs + used;
+		size_t i = 0;
+		rz_list_foreach (block->fcns, it, fcn) {
+			addrs[i++] = fcn->addr;
+		}
+		qsort(addrs, count, sizeof(ut64), ut64_cmp);
+		sb->fcns = addrs;
+		sb->fcns_count = count;
+		used += count;
+	}
+	return code;
+
+fail:
+	code_unref(code);
+	return NULL;
+}
+
+static void xrefs_unref(SnapshotXRefs *xrefs) {
+	if (!xrefs || !ref_dec(&xrefs->ref)) {
+		return;
+	}
+	rz_vector_fini(&xrefs->by_from);
+	rz_vector_fini(&xrefs->by_to);
+	free(xrefs);
+}
+
+static bool xref_push_cb(void *user, const RzAnalysisXRef *xref) {
+	return rz_vector_push(user, (void *)xref) != NULL;
+}
+
+static SnapshotXRefs *xrefs_new(RzAnalysis *analysis) {
+	SnapshotXRefs *xrefs = RZ_NEW0(SnapshotXRefs);
+	if (!xrefs) {
+		return NULL;
+	}
+	if (!ref_init(&xrefs->ref)) {
+		free(xrefs);
+		return NULL;
+	}
+	xrefs->gen = analysis->gen.xrefs;
+	rz_vector_init(&xrefs->by_from, sizeof(RzAnalysisXRef), NULL, NULL);
+	rz_vector_init(&xrefs->by_to, sizeof(RzAnalysisXRef), NULL, NULL);
+	ut64 count = rz_analysis_xrefs_count(analysis);
+	if ((count && (!rz_vector_reserve(&xrefs->by_from, count) || !rz_vector_reserve(&xrefs->by_to, count))) ||
+		!rz_analysis_xrefs_foreach(analysis, xref_push_cb, &xrefs->by_from) ||
+		rz_vector_len(&xrefs->by_from) > count) {
+		xrefs_unref(xrefs);
+		return NULL;
+	}
+	// by_from is already sorted by (from, to) when iterated
+	if (count) {
+		memcpy(xrefs->by_to.a, xrefs->by_from.a, rz_vector_len(&xrefs->by_from) * sizeof(RzAnalysisXRef));
+	}
+	xrefs->by_to.len = rz_vector_len(&xrefs->by_from);
+	rz_vector_sort(&xrefs->by_to, xref_to_cmp, false);
+	return xrefs;
+}
+
+static void snapshot_free(RzAnalysisSnapshot *snap) {
+	code_unref(snap->code);
+	xrefs_unref(snap->xrefs);
+	free(snap);
+}
+
+/**
+ * \brief Publish a snapshot of the current functions, blocks and xrefs
+ *
+ * Must be called from the thread mutating the analysis, while the tables are
+ * in a consistent state. Does nothing if they didn't change since the last
+ * publication, and only rebuilds the parts of the snapshot that changed.
+ *
+ * \return false if the snapshot couldn't be built, the previous one stays published
+ */
+RZ_API bool rz_analysis_snapshot_publish(RZ_NONNULL RzAnalysis *analysis) {
+	rz_return_val_if_fail(analysis, false);
+	if (!analysis->snapshot_lock) {
+		return false;
+	}
+	// only this thread writes the pointer, no need to lock for reading it
+	RzAnalysisSnapshot *prev = analysis->snapshot;
+	if (prev && prev->generation == analysis->gen.total) {
+		return true;
+	}
+	RzAnalysisSnapshot *snap = RZ_NEW0(RzAnalysisSnapshot);
+	if (!snap) {
+		return false;
+	}
+	if (!ref_init(&snap->ref)) {
+		free(snap);
+		return false;
+	}
+	snap->generation = analysis->gen.total;
+	if (prev && prev->code->fcns_gen == analysis->gen.fcns && prev->code->blocks_gen == analysis->gen.blocks) {
+		snap->code = prev->code;
+		ref_inc(&snap->code->ref);
+	} else {
+		snap->code = code_new(analysis);
+	}
+	if (prev && prev->xrefs->gen == analysis->gen.xrefs) {
+		snap->xrefs = prev->xrefs;
+		ref_inc(&snap->xrefs->ref);
+	} else {
+		snap->xrefs = xrefs_new(analysis);
+	}
+	if (!snap->code || !snap->xrefs) {
+		rz_analysis_snapshot_release(snap);
+		return false;
+	}
+	rz_th_lock_enter(analysis->snapshot_lock);
+	analysis->snapshot = snap;
+	rz_th_lock_leave(analysis->snapshot_lock);
+	rz_analysis_snapshot_release(prev);
+	return true;
+}
+
+/**
+ * \brief Get the last snapshot published, from any thread
+ *
+ * \return a reference to release with rz_analysis_snapshot_release(), or NULL if none was published yet
+ */
+RZ_API RZ_OWN RzAnalysisSnapshot *rz_analysis_snapshot_acquire(RZ_NONNULL RzAnalysis *analysis) {
+	rz_return_val_if_fail(analysis, NULL);
+	if (!analysis->snapshot_lock) {
+		return NULL;
+	}
+	rz_th_lock_enter(analysis->snapshot_lock);
+	RzAnalysisSnapshot *snap = analysis->snapshot;
+	if (snap) {
+		ref_inc(&snap->ref);
+	}
+	rz_th_lock_leave(analysis->snapshot_lock);
+	return snap;
+}
+
+/**
+ * \brief Release a reference to \p snap, which may outlive the RzAnalysis it comes from
+ */
+RZ_API void rz_analysis_snapshot_release(RZ_NULLABLE RzAnalysisSnapshot *snap) {
+	if (!snap || !ref_dec(&snap->ref)) {
+		return;
+	}
+	snapshot_free(snap);
+}
+
+/**
+ * \brief RzAnalysis.gen.total when \p snap was published
+ */
+RZ_API ut64 rz_analysis_snapshot_generation(RZ_NONNULL const RzAnalysisSnapshot *snap) {
+	rz_return_val_if_fail(snap, 0);
+	return snap->generation;
+}
+
+/**
+ * \brief Get all the functions of \p snap, sorted by address
+ */
+RZ_API RZ_BORROW const RzAnalysisSnapshotFunction *rz_analysis_snapshot_functions(RZ_NONNULL const RzAnalysisSnapshot *snap, RZ_NONNULL RZ_OUT size_t *count) {
+	rz_return_val_if_fail(snap && count, NULL);
+	*count = rz_vector_len(&snap->code->functions);
+	return *count ? rz_vector_index_ptr(&snap->code->functions, 0) : NULL;
+}
+
+/**
+ * \brief Get the function of \p snap whose entrypoint is \p addr
+ */
+RZ_API RZ_BORROW const RzAnalysisSnapshotFunction *rz_analysis_snapshot_function_at(RZ_NONNULL const RzAnalysisSnapshot *snap, ut64 addr) {
+	rz_return_val_if_fail(snap, NULL);
+	const RzVector *functions = &snap->code->functions;
+	size_t i;
+	rz_vector_lower_bound(functions, addr, i, FCN_ADDR_CMP);
+	if (i >= rz_vector_len(functions)) {
+		return NULL;
+	}
+	const RzAnalysisSnapshotFunction *fcn = rz_vector_index_ptr((RzVector *)functions, i);
+	return fcn->addr == addr ? fcn : NULL;
+}
+
+/**
+ * \brief Get the blocks of \p snap containing \p addr, sorted by address
+ */
+RZ_API RZ_OWN RzPVector /*<const RzAnalysisSnapshotBlock *>*/ *rz_analysis_snapshot_blocks_in(RZ_NONNULL const RzAnalysisSnapshot *snap, ut64 addr) {
+	rz_return_val_if_fail(snap, NULL);
+	RzPVector *r = rz_pvector_new(NULL);
+	if (!r) {
+		return NULL;
+	}
+	const SnapshotCode *code = snap->code;
+	if (!code->max_block_size) {
+		return r;
+	}
+	// the blocks starting before addr - max_block_size + 1 can't reach addr
+	ut64 lowest = addr >= code->max_block_size ? addr - code->max_block_size + 1 : 0;
+	size_t i;
+	rz_vector_lower_bound(&code->blocks, lowest, i, BLOCK_ADDR_CMP);
+	for (; i < rz_vector_len(&code->blocks); i++) {
+		RzAnalysisSnapshotBlock *block = rz_vector_index_ptr((RzVector *)&code->blocks, i);
+		if (block->addr > addr) {
+			break;
+		}
+		if (addr - block->addr < block->size) {
+			rz_pvector_push(r, block);
+		}
+	}
+	return r;
+}
+
+/**
+ * \brief Get the functions of \p snap having a block containing \p addr, sorted by address
+ */
+RZ_API RZ_OWN RzPVector /*<const RzAnalysisSnapshotFunction *>*/ *rz_analysis_snapshot_functions_in(RZ_NONNULL const RzAnalysisSnapshot *snap, ut64 addr) {
+	rz_return_val_if_fail(snap, NULL);
+	RzPVector *blocks = rz_analysis_snapshot_blocks_in(snap, addr);
+	RzPVector *r = rz_pvector_new(NULL);
+	if (!blocks || !r) {
+		rz_pvector_free(blocks);
+		rz_pvector_free(r);
+		return NULL;
+	}
+	void **it;
+	rz_pvector_foreach (blocks, it) {
+		const RzAnalysisSnapshotBlock *block = *it;
+		for (size_t i = 0; i < block->fcns_count; i++) {
+			const RzAnalysisSnapshotFunction *fcn = rz_analysis_snapshot_function_at(snap, block->fcns[i]);
+			if (fcn && !rz_pvector_contains(r, (void *)fcn)) {
+				rz_pvector_push(r, (void *)fcn);
+			}
+		}
+	}
+	rz_pvector_free(blocks);
+	rz_pvector_sort(r, snapshot_fcn_cmp);
+	return r;
+}
+
+/**
+ * \brief Get the xrefs of \p snap from \p addr, sorted by destination
+ */
+RZ_API RZ_BORROW const RzAnalysisXRef *rz_analysis_snapshot_xrefs_from(RZ_NONNULL const RzAnalysisSnapshot *snap, ut64 addr, RZ_NONNULL RZ_OUT size_t *count) {
+	rz_return_val_if_fail(snap && count, NULL);
+	const RzVector *v = &snap->xrefs->by_from;
+	size_t lo, hi;
+	rz_vector_lower_bound(v, addr, lo, XREF_FROM_CMP);
+	rz_vector_upper_bound(v, addr, hi, XREF_FROM_CMP);
+	*count = hi - lo;
+	return *count ? rz_vector_index_ptr((RzVector *)v, lo) : NULL;
+}
+
+/**
+ * \brief Get the xrefs of \p snap to \p addr, sorted by source
+ */
+RZ_API RZ_BORROW const RzAnalysisXRef *rz_analysis_snapshot_xrefs_to(RZ_NONNULL const RzAnalysisSnapshot *snap, ut64 addr, RZ_NONNULL RZ_OUT size_t *count) {
+	rz_return_val_if_fail(snap && count, NULL);
+	const RzVector *v = &snap->xrefs->by_to;
+	size_t lo, hi;
+	rz_vector_lower_bound(v, addr, lo, XREF_TO_CMP);
+	rz_vector_upper_bound(v, addr, hi, XREF_TO_CMP);
+	*count = hi - lo;
+	return *count ? rz_vector_index_ptr((RzVector *)v, lo) : NULL;
+}
@@ -508,6 +508,8 @@ static RzType *parse_structure(const RzTypeDB *typedb, RzPdbTpiStream *stream, R
 		free(struct_member);
 	}
 	base_type->size = rz_bin_pdb_get_type_val(type);
+	// the members were filled in after the type was saved
+	rz_type_db_invalidate_layouts(typedb);
 	if (base_type->attrs == RZ_TYPE_TYPECLASS_INVALID) {
 		base_type->attrs = RZ_TYPE_TYPECLASS_NONE;
 		rz_list_append(stream->print_type, base_type);
@@ -641,6 +643,8 @@ static RzType *parse_union(const RzTypeDB *typedb, RzPdbTpiStream *stream, RzPdb
 		free(union_member);
 	}
 	base_type->size = rz_bin_pdb_get_type_val(type);
+	// the members were filled in after the type was saved
+	rz_type_db_invalidate_layouts(typedb);
 	if (base_type->attrs == RZ_TYPE_TYPECLASS_INVALID) {
 		base_type->attrs = RZ_TYPE_TYPECLASS_NONE;
 		rz_list_append(stream->print_type, base_type);
@@ -811,10 +815,13 @@ RZ_API void rz_parse_pdb_types(const RzTypeDB *typedb, const RzPdb *pdb) {
 		return;
 	}
 
-	RBIter it;
-	RzPdbTpiType *type;
-	rz_rbtree_foreach (stream->types, it, type, RzPdbTpiType, rb) {
-		if (type && is_parsable_type(type->leaf_type)) {
+	// only the records that make types are decoded, the others on demand while parsing these
+	for (ut32 index = stream->header.TypeIndexBegin; index < stream->header.TypeIndexEnd; index++) {
+		if (!is_parsable_type(rz_bin_pdb_get_type_leaf(stream, index))) {
+			continue;
+		}
+		RzPdbTpiType *type = rz_bin_pdb_get_type_by_index(stream, index);
+		if (type) {
 			parse_types(typedb, stream, type);
 		}
 	}
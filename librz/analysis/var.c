@@ -108,6 +108,13 @@ RZ_API void rz_analysis_var_resolve_overlaps(RzAnalysisVar *var) {
 	rz_pvector_free(cloned_vars);
 }
 
+// variables show up in the function header and at their accesses
+static void mark_vars_dirty(RzAnalysisFunction *fcn) {
+	ut64 from = RZ_MIN(rz_analysis_function_min_addr(fcn), fcn->addr);
+	ut64 to = rz_analysis_function_max_addr(fcn);
+	rz_analysis_mark_dirty(fcn->analysis, &fcn->analysis->gen.fcns, from, to == UT64_MAX ? fcn->addr : to - 1);
+}
+
 RZ_API RzAnalysisVar *rz_analysis_function_set_var(RzAnalysisFunction *fcn, int delta, char kind, RZ_BORROW RZ_NULLABLE const RzType *type, int size, bool isarg, RZ_NONNULL const char *name) {
 	rz_return_val_if_fail(fcn && name, NULL);
 	RzAnalysisVar *existing = rz_analysis_function_get_var_byname(fcn, name);
@@ -146,16 +153,15 @@ RZ_API RzAnalysisVar *rz_analysis_function_set_var(RzAnalysisFunction *fcn, int
 		rz_vector_init(&var->accesses, sizeof(RzAnalysisVarAccess), NULL, NULL);
 		rz_vector_init(&var->constraints, sizeof(RzTypeConstraint), NULL, NULL);
 	} else {
-		free(var->name);
-		free(var->regname);
 		if (var->type != type) {
 			// only free if not assigning the own type to itself
 			rz_type_free(var->type);
 			var->type = NULL;
 		}
 	}
-	var->name = strdup(name);
-	var->regname = reg ? strdup(reg->name) : NULL; // TODO: no strdup here? pool? or not keep regname at all?
+	// names repeat a lot across functions (arg_8h, var_10h, rdi...), keep a single copy of each
+	var->name = rz_str_constpool_get(&fcn->analysis->constpool, name);
+	var->regname = reg ? rz_str_constpool_get(&fcn->analysis->constpool, reg->name) : NULL;
 	if (!var->type || var->type != type) {
 		// only clone if we don't already own this type (and didn't free it above)
 		var->type = var_type_clone_or_default_type(fcn->analysis, type, size);
@@ -164,6 +170,7 @@ RZ_API RzAnalysisVar *rz_analysis_function_set_var(RzAnalysisFunction *fcn, int
 	var->isarg = isarg;
 	var->delta = delta;
 	rz_analysis_var_resolve_overlaps(var);
+	mark_vars_dirty(fcn);
 	return var;
 }
 
@@ -174,6 +181,7 @@ RZ_API void rz_analysis_var_set_type(RzAnalysisVar *var, RZ_OWN RzType *type, bo
 	if (resolve_overlaps) {
 		rz_analysis_var_resolve_overlaps(var);
 	}
+	mark_vars_dirty(var->fcn);
 }
 
 static void var_free(RzAnalysisVar *var) {
@@ -183,8 +191,6 @@ static void var_free(RzAnalysisVar *var) {
 	rz_type_free(var->type);
 	rz_analysis_var_clear_accesses(var);
 	rz_vector_fini(&var->constraints);
-	free(var->name);
-	free(var->regname);
 	free(var->comment);
 	free(var);
 }
@@ -198,6 +204,7 @@ RZ_API void rz_analysis_var_delete(RzAnalysisVar *var) {
 		if (v == var) {
 			rz_pvector_remove_at(&fcn->vars, i);
 			var_free(v);
+			mark_vars_dirty(fcn);
 			return;
 		}
 	}
@@ -211,6 +218,7 @@ RZ_API void rz_analysis_function_delete_vars_by_kind(RzAnalysisFunction *fcn, Rz
 		if (var->kind == kind) {
 			rz_pvector_remove_at(&fcn->vars, i);
 			var_free(var);
+			mark_vars_dirty(fcn);
 			continue;
 		}
 		i++;
@@ -224,6 +232,8 @@ RZ_API void rz_analysis_function_delete_all_vars(RzAnalysisFunction *fcn) {
 	}
 	rz_pvector_clear(&fcn->vars);
 	fcn->argnum = 0;
+	// also called while freeing the function, when its blocks may be gone already
+	rz_analysis_mark_dirty(fcn->analysis, &fcn->analysis->gen.fcns, 0, UT64_MAX);
 }
 
 RZ_API void rz_analysis_function_delete_unused_vars(RzAnalysisFunction *fcn) {
@@ -242,6 +252,7 @@ RZ_API void rz_analysis_function_delete_var(RzAnalysisFunction *fcn, RzAnalysisV
 	rz_return_if_fail(fcn && var);
 	rz_pvector_remove_data(&fcn->vars, var);
 	var_free(var);
+	mark_vars_dirty(fcn);
 }
 
 RZ_API RZ_BORROW RzAnalysisVar *rz_analysis_function_get_var_byname(RzAnalysisFunction *fcn, const char *name) {
@@ -357,12 +368,12 @@ RZ_API bool rz_analysis_var_rename(RzAnalysisVar *var, const char *new_name, boo
 		}
 		return false;
 	}
-	char *nn = strdup(new_name);
+	const char *nn = rz_str_constpool_get(&var->fcn->analysis->constpool, new_name);
 	if (!nn) {
 		return false;
 	}
-	free(var->name);
 	var->name = nn;
+	mark_vars_dirty(var->fcn);
 	return true;
 }
 
@@ -65,21 +65,123 @@ RZ_API bool rz_analysis_vtable_begin(RzAnalysis *analysis, RVTableContext *conte
 	return true;
 }
 
-static bool vtable_addr_in_text_section(RVTableContext *context, ut64 curAddress) {
+typedef struct {
+	ut64 from;
+	ut64 to;
+	bool text; ///< pointers into it can be virtual methods
+	bool rtti; ///< pointers into it can be RTTI
+	bool first; ///< no section before it in the list overlaps it
+} VTableSection;
+
+/*
+ * State of a vtable search: the sections of the binary flattened into an
+ * array, in the order rz_bin_get_section_at() looks them up, and the
+ * contents of the section being scanned, so checking a word costs no io.
+ */
+typedef struct {
+	RVTableContext *context;
+	RzVector /*<VTableSection>*/ sections; ///< empty if looked up through the bin
+	const VTableSection *last; ///< last section found
+	ut8 *buf;
+	ut64 buf_addr;
+	ut64 buf_size;
+} VTableScan;
+
+static bool section_can_contain_rtti(RzBinSection *section);
+
+static void vtable_scan_init(VTableScan *scan, RVTableContext *context) {
+	memset(scan, 0, sizeof(*scan));
+	scan->context = context;
+	rz_vector_init(&scan->sections, sizeof(VTableSection), NULL, NULL);
+}
+
+static void vtable_scan_fini(VTableScan *scan) {
+	rz_vector_fini(&scan->sections);
+	free(scan->buf);
+}
+
+static bool vtable_scan_load_sections(VTableScan *scan, RzList /*<RzBinSection *>*/ *sections) {
+	RzBinObject *o = rz_bin_cur_object(scan->context->analysis->binb.bin);
+	RzListIter *iter;
+	RzBinSection *section;
+	rz_list_foreach (sections, iter, section) {
+		if (section->is_segment) {
+			continue;
+		}
+		VTableSection *s = rz_vector_push(&scan->sections, NULL);
+		if (!s) {
+			rz_vector_clear(&scan->sections);
+			return false;
+		}
+		s->from = rz_bin_object_addr_with_base(o, section->vaddr);
+		s->to = s->from + section->vsize;
+		s->text = strstr(section->name, "text") && (section->perm & 1) != 0;
+		s->rtti = section_can_contain_rtti(section);
+		s->first = true;
+		VTableSection *prev;
+		rz_vector_foreach_prev(&scan->sections, prev) {
+			if (prev != s && prev->from < s->to && s->from < prev->to) {
+				s->first = false;
+				break;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+ * Same as get_vsect_at(), \p section is set to NULL if there is no section at
+ * addr. Returns false if the section table is not available.
+ */
+static bool vtable_scan_section_at(VTableScan *scan, ut64 addr, const VTableSection **section) {
+	if (rz_vector_empty(&scan->sections)) {
+		return false;
+	}
+	const VTableSection *s = scan->last;
+	if (s && s->first && addr >= s->from && addr < s->to) {
+		*section = s;
+		return true;
+	}
+	*section = NULL;
+	rz_vector_foreach(&scan->sections, s) {
+		if (addr >= s->from && addr < s->to) {
+			scan->last = s;
+			*section = s;
+			break;
+		}
+	}
+	return true;
+}
+
+static bool vtable_scan_read_addr(VTableScan *scan, ut64 addr, ut64 *value) {
+	RVTableContext *context = scan->context;
+	if (scan->buf && addr >= scan->buf_addr && addr - scan->buf_addr <= scan->buf_size - context->word_size) {
+		*value = rz_read_ble(scan->buf + (addr - scan->buf_addr), context->analysis->big_endian, context->word_size * 8);
+		return true;
+	}
+	return context->read_addr(context->analysis, addr, value);
+}
+
+static bool vtable_addr_in_text_section(VTableScan *scan, ut64 curAddress) {
+	const VTableSection *s;
+	if (vtable_scan_section_at(scan, curAddress, &s)) {
+		return s && s->text;
+	}
 	// section of the curAddress
-	RzBinSection *value = context->analysis->binb.get_vsect_at(context->analysis->binb.bin, curAddress);
+	RzAnalysis *analysis = scan->context->analysis;
+	RzBinSection *value = analysis->binb.get_vsect_at(analysis->binb.bin, curAddress);
 	// If the pointed value lies in .text section
 	return value && strstr(value->name, "text") && (value->perm & 1) != 0;
 }
 
-static bool vtable_is_value_in_text_section(RVTableContext *context, ut64 curAddress, ut64 *value) {
+static bool vtable_is_value_in_text_section(VTableScan *scan, ut64 curAddress, ut64 *value) {
 	// value at the current address
 	ut64 curAddressValue;
-	if (!context->read_addr(context->analysis, curAddress, &curAddressValue)) {
+	if (!vtable_scan_read_addr(scan, curAddress, &curAddressValue)) {
 		return false;
 	}
 	// if the value is in text section
-	bool ret = vtable_addr_in_text_section(context, curAddressValue);
+	bool ret = vtable_addr_in_text_section(scan, curAddressValue);
 	if (value) {
 		*value = curAddressValue;
 	}
@@ -109,22 +211,31 @@ static bool section_can_contain_rtti(RzBinSection *section) {
 		rz_str_endswith(section->name, "__const");
 }
 
-static bool vtable_is_addr_vtable_start_itanium(RVTableContext *context, RzBinSection *section, ut64 curAddress) {
+static bool vtable_addr_can_contain_rtti(VTableScan *scan, ut64 addr) {
+	const VTableSection *s;
+	if (vtable_scan_section_at(scan, addr, &s)) {
+		return s && s->rtti;
+	}
+	RzAnalysis *analysis = scan->context->analysis;
+	return section_can_contain_rtti(analysis->binb.get_vsect_at(analysis->binb.bin, addr));
+}
+
+static bool vtable_is_addr_vtable_start_itanium(VTableScan *scan, ut64 curAddress) {
+	RVTableContext *context = scan->context;
 	ut64 value;
 	if (!curAddress || curAddress == UT64_MAX) {
 		return false;
 	}
-	if (curAddress && !vtable_is_value_in_text_section(context, curAddress, NULL)) { // Vtable beginning referenced from the code
+	if (curAddress && !vtable_is_value_in_text_section(scan, curAddress, NULL)) { // Vtable beginning referenced from the code
 		return false;
 	}
-	if (!context->read_addr(context->analysis, curAddress - context->word_size, &value)) { // get the RTTI pointer
+	if (!vtable_scan_read_addr(scan, curAddress - context->word_size, &value)) { // get the RTTI pointer
 		return false;
 	}
-	RzBinSection *rtti_section = context->analysis->binb.get_vsect_at(context->analysis->binb.bin, value);
-	if (value && !section_can_contain_rtti(rtti_section)) { // RTTI ptr must point somewhere in the data section
+	if (value && !vtable_addr_can_contain_rtti(scan, value)) { // RTTI ptr must point somewhere in the data section
 		return false;
 	}
-	if (!context->read_addr(context->analysis, curAddress - 2 * context->word_size, &value)) { // Offset to top
+	if (!vtable_scan_read_addr(scan, curAddress - 2 * context->word_size, &value)) { // Offset to top
 		return false;
 	}
 	if ((st32)value > 0) { // Offset to top has to be negative
@@ -133,57 +244,55 @@ static bool vtable_is_addr_vtable_start_itanium(RVTableContext *context, RzBinSe
 	return true;
 }
 
-static bool vtable_is_addr_vtable_start_msvc(RVTableContext *context, ut64 curAddress) {
+static bool vtable_is_addr_vtable_start_msvc(VTableScan *scan, ut64 curAddress) {
+	RVTableContext *context = scan->context;
 	RzAnalysisXRef *xref;
-	RzListIter *xrefIter;
 
 	if (!curAddress || curAddress == UT64_MAX) {
 		return false;
 	}
-	if (curAddress && !vtable_is_value_in_text_section(context, curAddress, NULL)) {
+	if (curAddress && !vtable_is_value_in_text_section(scan, curAddress, NULL)) {
 		return false;
 	}
 	// total xref's to curAddress
-	RzList *xrefs = rz_analysis_xrefs_get_to(context->analysis, curAddress);
-	if (rz_list_empty(xrefs)) {
-		rz_list_free(xrefs);
+	RzVector *xrefs = rz_analysis_xrefs_get_to_vec(context->analysis, curAddress);
+	if (!xrefs) {
 		return false;
 	}
-	rz_list_foreach (xrefs, xrefIter, xref) {
+	bool ret = false;
+	rz_vector_foreach(xrefs, xref) {
 		// section in which currenct xref lies
-		if (vtable_addr_in_text_section(context, xref->from)) {
+		if (vtable_addr_in_text_section(scan, xref->from)) {
 			ut8 buf[VTABLE_BUFF_SIZE];
 			context->analysis->iob.read_at(context->analysis->iob.io, xref->from, buf, sizeof(buf));
 
 			RzAnalysisOp analop = { 0 };
 			rz_analysis_op(context->analysis, &analop, xref->from, buf, sizeof(buf), RZ_ANALYSIS_OP_MASK_BASIC);
-
-			if (analop.type == RZ_ANALYSIS_OP_TYPE_MOV || analop.type == RZ_ANALYSIS_OP_TYPE_LEA) {
-				rz_list_free(xrefs);
-				rz_analysis_op_fini(&analop);
-				return true;
-			}
-
+			ret = analop.type == RZ_ANALYSIS_OP_TYPE_MOV || analop.type == RZ_ANALYSIS_OP_TYPE_LEA;
 			rz_analysis_op_fini(&analop);
+			if (ret) {
+				break;
+			}
 		}
 	}
-	rz_list_free(xrefs);
-	return false;
+	rz_vector_free(xrefs);
+	return ret;
 }
 
-static bool vtable_is_addr_vtable_start(RVTableContext *context, RzBinSection *section, ut64 curAddress) {
-	if (context->abi == RZ_ANALYSIS_CPP_ABI_MSVC) {
-		return vtable_is_addr_vtable_start_msvc(context, curAddress);
+static bool vtable_is_addr_vtable_start(VTableScan *scan, ut64 curAddress) {
+	if (scan->context->abi == RZ_ANALYSIS_CPP_ABI_MSVC) {
+		return vtable_is_addr_vtable_start_msvc(scan, curAddress);
 	}
-	if (context->abi == RZ_ANALYSIS_CPP_ABI_ITANIUM) {
-		return vtable_is_addr_vtable_start_itanium(context, section, curAddress);
+	if (scan->context->abi == RZ_ANALYSIS_CPP_ABI_ITANIUM) {
+		return vtable_is_addr_vtable_start_itanium(scan, curAddress);
 	}
 	rz_return_val_if_reached(false);
 }
 
-RZ_API RVTableInfo *rz_analysis_vtable_parse_at(RVTableContext *context, ut64 addr) {
+static RVTableInfo *vtable_parse_at(VTableScan *scan, ut64 addr) {
+	RVTableContext *context = scan->context;
 	ut64 offset_to_top;
-	if (!context->read_addr(context->analysis, addr - 2 * context->word_size, &offset_to_top)) {
+	if (!vtable_scan_read_addr(scan, addr - 2 * context->word_size, &offset_to_top)) {
 		return NULL;
 	}
 
@@ -197,7 +306,7 @@ RZ_API RVTableInfo *rz_analysis_vtable_parse_at(RVTableContext *context, ut64 ad
 	rz_vector_init(&vtable->methods, sizeof(RVTableMethodInfo), NULL, NULL);
 
 	RVTableMethodInfo meth;
-	while (vtable_is_value_in_text_section(context, addr, &meth.addr)) {
+	while (vtable_is_value_in_text_section(scan, addr, &meth.addr)) {
 		meth.vtable_offset = addr - vtable->saddr;
 		if (!rz_vector_push(&vtable->methods, &meth)) {
 			break;
@@ -206,16 +315,42 @@ RZ_API RVTableInfo *rz_analysis_vtable_parse_at(RVTableContext *context, ut64 ad
 		addr += context->word_size;
 
 		// a ref means the vtable has ended
-		RzList *ll = rz_analysis_xrefs_get_to(context->analysis, addr);
-		if (!rz_list_empty(ll)) {
-			rz_list_free(ll);
+		RzVector *xrefs = rz_analysis_xrefs_get_to_vec(context->analysis, addr);
+		bool referenced = xrefs && !rz_vector_empty(xrefs);
+		rz_vector_free(xrefs);
+		if (referenced) {
 			break;
 		}
-		rz_list_free(ll);
 	}
 	return vtable;
 }
 
+RZ_API RVTableInfo *rz_analysis_vtable_parse_at(RVTableContext *context, ut64 addr) {
+	VTableScan scan;
+	vtable_scan_init(&scan, context);
+	RVTableInfo *vtable = vtable_parse_at(&scan, addr);
+	vtable_scan_fini(&scan);
+	return vtable;
+}
+
+/*
+ * Read the whole section into the scan buffer. On failure the words are
+ * read one by one from io as before.
+ */
+static void vtable_scan_load_buffer(VTableScan *scan, ut64 addr, ut64 size) {
+	RzAnalysis *analysis = scan->context->analysis;
+	RZ_FREE(scan->buf);
+	scan->buf_addr = addr;
+	scan->buf_size = size;
+	if (size < scan->context->word_size) {
+		return;
+	}
+	scan->buf = malloc(size);
+	if (scan->buf && !analysis->iob.read_at(analysis->iob.io, addr, scan->buf, size)) {
+		RZ_FREE(scan->buf);
+	}
+}
+
 RZ_API RzList *rz_analysis_vtable_search(RVTableContext *context) {
 	RzAnalysis *analysis = context->analysis;
 	if (!analysis) {
@@ -233,6 +368,10 @@ RZ_API RzList *rz_analysis_vtable_search(RVTableContext *context) {
 		return NULL;
 	}
 
+	VTableScan scan;
+	vtable_scan_init(&scan, context);
+	vtable_scan_load_sections(&scan, sections);
+
 	rz_cons_break_push(NULL, NULL);
 
 	RzListIter *iter;
@@ -252,6 +391,7 @@ RZ_API RzList *rz_analysis_vtable_search(RVTableContext *context) {
 		if (ss > ST32_MAX) {
 			break;
 		}
+		vtable_scan_load_buffer(&scan, startAddress, section->vsize);
 		while (startAddress <= endAddress) {
 			if (rz_cons_is_breaked()) {
 				break;
@@ -260,8 +400,8 @@ RZ_API RzList *rz_analysis_vtable_search(RVTableContext *context) {
 				break;
 			}
 
-			if (vtable_is_addr_vtable_start(context, section, startAddress)) {
-				RVTableInfo *vtable = rz_analysis_vtable_parse_at(context, startAddress);
+			if (vtable_is_addr_vtable_start(&scan, startAddress)) {
+				RVTableInfo *vtable = vtable_parse_at(&scan, startAddress);
 				if (vtable) {
 					rz_list_append(vtables, vtable);
 					ut64 size = rz_analysis_vtable_info_get_size(context, vtable);
@@ -276,6 +416,7 @@ RZ_API RzList *rz_analysis_vtable_search(RVTableContext *context) {
 	}
 
 	rz_cons_break_pop();
+	vtable_scan_fini(&scan);
 
 	if (rz_list_empty(vtables)) {
 		// stripped binary?
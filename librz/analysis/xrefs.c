@@ -21,6 +21,403 @@ refs 10->20 C 16->10 J 20->10 C
 // XXX: is it possible to have multiple type for the same (from, to) pair?
 //      if it is, things need to be adjusted
 
+/**
+ * \file xrefs.c
+ * Xrefs are kept twice, in an index keyed by the source and in one keyed by
+ * the destination address. Each index is made of two parts:
+ *
+ * - a compact immutable array of (key, other, type) records sorted by
+ *   (key, other), delta-encoded as uleb128 in blocks of XREF_BLOCK_RECORDS
+ *   records so that a lookup only decodes a single block or two;
+ * - a small write buffer (a red-black tree of pending records) taking all
+ *   the insertions, updates and deletions, merged into the array once it
+ *   grows past a fraction of the array size.
+ *
+ * Compared to a hashtable of hashtables of heap-allocated RzAnalysisXRef
+ * this brings the cost of a reference from ~150 bytes down to ~10.
+ */
+
+#define XREF_BLOCK_RECORDS 64
+#define XREF_PENDING_MIN   0x1000
+#define XREF_PENDING_MAX   0x40000
+#define XREF_TOMBSTONE     0xff ///< pending type of a record deleted from the array
+
+typedef struct {
+	ut64 key; ///< key of the first record of the block
+	size_t offset; ///< offset of the first record in the encoded data
+} XRefBlock;
+
+typedef struct {
+	ut64 key;
+	ut64 other;
+	ut8 type;
+	RBNode rb;
+} XRefPending;
+
+struct rz_analysis_xref_index_t {
+	ut8 *data; ///< encoded records
+	size_t data_size;
+	XRefBlock *blocks;
+	size_t blocks_count;
+	size_t records; ///< number of records in data
+	RBTree pending;
+	size_t pending_count;
+	ut64 count; ///< number of live xrefs, with pending changes applied
+};
+
+typedef bool (*XRefIndexCb)(void *user, ut64 key, ut64 other, RzAnalysisXRefType type);
+
+static inline size_t uleb_write(ut8 *dst, ut64 v) {
+	size_t n = 0;
+	do {
+		ut8 b = v & 0x7f;
+		v >>= 7;
+		dst[n++] = v ? b | 0x80 : b;
+	} while (v);
+	return n;
+}
+
+static inline const ut8 *uleb_read(const ut8 *src, ut64 *v) {
+	ut64 r = 0;
+	int shift = 0;
+	ut8 b;
+	do {
+		b = *src++;
+		r |= (ut64)(b & 0x7f) << shift;
+		shift += 7;
+	} while (b & 0x80 && shift < 64);
+	*v = r;
+	return src;
+}
+
+typedef struct {
+	const RzAnalysisXRefIndex *idx;
+	size_t i; ///< index of the next record
+	const ut8 *p;
+	ut64 key;
+	ut64 other;
+	ut8 type;
+} XRefCursor;
+
+static void cursor_seek_block(XRefCursor *c, const RzAnalysisXRefIndex *idx, size_t block) {
+	c->idx = idx;
+	c->i = block * XREF_BLOCK_RECORDS;
+	c->p = block < idx->blocks_count ? idx->data + idx->blocks[block].offset : NULL;
+	c->key = 0;
+	c->other = 0;
+	c->type = 0;
+}
+
+static bool cursor_next(XRefCursor *c) {
+	if (c->i >= c->idx->records) {
+		return false;
+	}
+	if (!(c->i % XREF_BLOCK_RECORDS)) {
+		// every block is encoded from scratch
+		c->p = c->idx->data + c->idx->blocks[c->i / XREF_BLOCK_RECORDS].offset;
+		c->key = 0;
+		c->other = 0;
+	}
+	ut64 dkey, dother;
+	c->p = uleb_read(c->p, &dkey);
+	c->p = uleb_read(c->p, &dother);
+	c->key += dkey;
+	// zigzag encoded, "other" only increases within the same key
+	c->other += (dother >> 1) ^ -(st64)(dother & 1);
+	c->type = *c->p++;
+	c->i++;
+	return true;
+}
+
+/**
+ * Place the cursor right before the first record whose key is >= \p key
+ */
+static void cursor_seek(XRefCursor *c, const RzAnalysisXRefIndex *idx, ut64 key) {
+	// find the first block starting at or after key, records of key may begin in the previous one
+	size_t lo = 0, hi = idx->blocks_count;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (idx->blocks[mid].key < key) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	cursor_seek_block(c, idx, lo ? lo - 1 : 0);
+	XRefCursor prev;
+	do {
+		prev = *c;
+	} while (cursor_next(c) && c->key < key);
+	*c = prev;
+}
+
+static bool index_array_find(const RzAnalysisXRefIndex *idx, ut64 key, ut64 other) {
+	if (!idx->records) {
+		return false;
+	}
+	XRefCursor c;
+	cursor_seek(&c, idx, key);
+	while (cursor_next(&c) && c.key == key) {
+		if (c.other == other) {
+			return true;
+		}
+		if (c.other > other) {
+			break;
+		}
+	}
+	return false;
+}
+
+static int pending_cmp(const void *incoming, const RBNode *in_tree, void *user) {
+	const XRefPending *a = incoming;
+	const XRefPending *b = container_of(in_tree, const XRefPending, rb);
+	if (a->key != b->key) {
+		return a->key < b->key ? -1 : 1;
+	}
+	if (a->other != b->other) {
+		return a->other < b->other ? -1 : 1;
+	}
+	return 0;
+}
+
+static void pending_free(RBNode *node, void *user) {
+	free(container_of(node, XRefPending, rb));
+}
+
+static XRefPending *pending_find(RzAnalysisXRefIndex *idx, ut64 key, ut64 other) {
+	XRefPending probe = { .key = key, .other = other };
+	RBNode *node = rz_rbtree_find(idx->pending, &probe, pending_cmp, NULL);
+	return node ? container_of(node, XRefPending, rb) : NULL;
+}
+
+typedef struct {
+	ut8 *data;
+	size_t size;
+	size_t capacity;
+	XRefBlock *blocks;
+	size_t blocks_count;
+	size_t blocks_capacity;
+	size_t records;
+	ut64 key;
+	ut64 other;
+} XRefEncoder;
+
+static bool encoder_push(XRefEncoder *e, ut64 key, ut64 other, ut8 type) {
+	// two uleb128 of at most 10 bytes and the type
+	if (e->size + 21 > e->capacity) {
+		size_t capacity = e->capacity ? e->capacity * 2 : 0x1000;
+		ut8 *data = realloc(e->data, capacity);
+		if (!data) {
+			return false;
+		}
+		e->data = data;
+		e->capacity = capacity;
+	}
+	if (!(e->records % XREF_BLOCK_RECORDS)) {
+		if (e->blocks_count == e->blocks_capacity) {
+			size_t capacity = e->blocks_capacity ? e->blocks_capacity * 2 : 0x40;
+			XRefBlock *blocks = realloc(e->blocks, capacity * sizeof(XRefBlock));
+			if (!blocks) {
+				return false;
+			}
+			e->blocks = blocks;
+			e->blocks_capacity = capacity;
+		}
+		e->blocks[e->blocks_count].key = key;
+		e->blocks[e->blocks_count].offset = e->size;
+		e->blocks_count++;
+		e->key = 0;
+		e->other = 0;
+	}
+	st64 dother = (st64)(other - e->other);
+	e->size += uleb_write(e->data + e->size, key - e->key);
+	e->size += uleb_write(e->data + e->size, ((ut64)dother << 1) ^ (ut64)(dother >> 63));
+	e->data[e->size++] = type;
+	e->key = key;
+	e->other = other;
+	e->records++;
+	return true;
+}
+
+/**
+ * Rebuild the encoded array with all the pending changes applied
+ */
+static bool index_merge(RzAnalysisXRefIndex *idx) {
+	if (!idx->pending) {
+		return true;
+	}
+	XRefEncoder e = { 0 };
+	XRefCursor c;
+	cursor_seek_block(&c, idx, 0);
+	bool has_rec = cursor_next(&c);
+	RBIter it = rz_rbtree_first(idx->pending);
+	while (has_rec || rz_rbtree_iter_has(&it)) {
+		XRefPending *pend = rz_rbtree_iter_has(&it) ? rz_rbtree_iter_get(&it, XRefPending, rb) : NULL;
+		int d = !has_rec ? 1 : !pend ? -1 : c.key != pend->key ? (c.key < pend->key ? -1 : 1) : c.other != pend->other ? (c.other < pend->other ? -1 : 1) : 0;
+		bool ok = true;
+		if (d < 0) {
+			ok = encoder_push(&e, c.key, c.other, c.type);
+		} else if (pend->type != XREF_TOMBSTONE) {
+			ok = encoder_push(&e, pend->key, pend->other, pend->type);
+		}
+		if (!ok) {
+			free(e.data);
+			free(e.blocks);
+			return false;
+		}
+		if (d <= 0) {
+			has_rec = cursor_next(&c);
+		}
+		if (d >= 0) {
+			rz_rbtree_iter_next(&it);
+		}
+	}
+	free(idx->data);
+	free(idx->blocks);
+	idx->data = e.data;
+	if (e.size) {
+		// give back the doubling slack
+		ut8 *data = realloc(e.data, e.size);
+		idx->data = data ? data : e.data;
+	}
+	idx->data_size = e.size;
+	idx->blocks = e.blocks;
+	idx->blocks_count = e.blocks_count;
+	idx->records = e.records;
+	rz_rbtree_free(idx->pending, pending_free, NULL);
+	idx->pending = NULL;
+	idx->pending_count = 0;
+	return true;
+}
+
+static RzAnalysisXRefIndex *index_new(void) {
+	return RZ_NEW0(RzAnalysisXRefIndex);
+}
+
+static void index_free(RzAnalysisXRefIndex *idx) {
+	if (!idx) {
+		return;
+	}
+	rz_rbtree_free(idx->pending, pending_free, NULL);
+	free(idx->data);
+	free(idx->blocks);
+	free(idx);
+}
+
+static bool index_set(RzAnalysisXRefIndex *idx, ut64 key, ut64 other, ut8 type) {
+	XRefPending *pend = pending_find(idx, key, other);
+	if (pend) {
+		if (pend->type == XREF_TOMBSTONE) {
+			idx->count++;
+		}
+		pend->type = type;
+		return true;
+	}
+	pend = RZ_NEW0(XRefPending);
+	if (!pend) {
+		return false;
+	}
+	pend->key = key;
+	pend->other = other;
+	pend->type = type;
+	if (!index_array_find(idx, key, other)) {
+		idx->count++;
+	}
+	rz_rbtree_insert(&idx->pending, pend, &pend->rb, pending_cmp, NULL);
+	idx->pending_count++;
+	size_t limit = RZ_MAX(XREF_PENDING_MIN, RZ_MIN(XREF_PENDING_MAX, idx->records / 8));
+	if (idx->pending_count >= limit) {
+		index_merge(idx);
+	}
+	return true;
+}
+
+static void index_del(RzAnalysisXRefIndex *idx, ut64 key, ut64 other) {
+	bool in_array = index_array_find(idx, key, other);
+	XRefPending *pend = pending_find(idx, key, other);
+	if (pend) {
+		if (pend->type != XREF_TOMBSTONE) {
+			idx->count--;
+		}
+		if (in_array) {
+			pend->type = XREF_TOMBSTONE;
+		} else {
+			XRefPending probe = { .key = key, .other = other };
+			rz_rbtree_delete(&idx->pending, &probe, pending_cmp, NULL, pending_free, NULL);
+			idx->pending_count--;
+		}
+		return;
+	}
+	if (!in_array) {
+		return;
+	}
+	pend = RZ_NEW0(XRefPending);
+	if (!pend) {
+		// merge right away so the deletion can't get lost
+		index_merge(idx);
+		pend = RZ_NEW0(XRefPending);
+		if (!pend) {
+			return;
+		}
+	}
+	pend->key = key;
+	pend->other = other;
+	pend->type = XREF_TOMBSTONE;
+	rz_rbtree_insert(&idx->pending, pend, &pend->rb, pending_cmp, NULL);
+	idx->pending_count++;
+	idx->count--;
+}
+
+/**
+ * Walk the records whose key is in [\p min, \p max] in (key, other) order,
+ * merging the encoded array with the pending changes on the fly.
+ */
+static bool index_foreach_range(const RzAnalysisXRefIndex *idx, ut64 min, ut64 max, XRefIndexCb cb, void *user) {
+	XRefCursor c;
+	if (!min) {
+		cursor_seek_block(&c, idx, 0);
+	} else {
+		cursor_seek(&c, idx, min);
+	}
+	bool has_rec = cursor_next(&c) && c.key <= max;
+	XRefPending probe = { .key = min, .other = 0 };
+	RBIter it = !min ? rz_rbtree_first(idx->pending) : rz_rbtree_lower_bound_forward(idx->pending, &probe, pending_cmp, NULL);
+	XRefPending *pend = rz_rbtree_iter_has(&it) ? rz_rbtree_iter_get(&it, XRefPending, rb) : NULL;
+	if (pend && pend->key > max) {
+		pend = NULL;
+	}
+	while (has_rec || pend) {
+		int d = !has_rec ? 1 : !pend ? -1 : c.key != pend->key ? (c.key < pend->key ? -1 : 1) : c.other != pend->other ? (c.other < pend->other ? -1 : 1) : 0;
+		if (d < 0) {
+			if (!cb(user, c.key, c.other, c.type)) {
+				return false;
+			}
+		} else if (pend->type != XREF_TOMBSTONE) {
+			if (!cb(user, pend->key, pend->other, pend->type)) {
+				return false;
+			}
+		}
+		if (d <= 0) {
+			has_rec = cursor_next(&c) && c.key <= max;
+		}
+		if (d >= 0) {
+			rz_rbtree_iter_next(&it);
+			pend = rz_rbtree_iter_has(&it) ? rz_rbtree_iter_get(&it, XRefPending, rb) : NULL;
+			if (pend && pend->key > max) {
+				pend = NULL;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * Walk all the records of \p key (or all of them if \p all is set) in (key, other) order
+ */
+static bool index_foreach(const RzAnalysisXRefIndex *idx, bool all, ut64 key, XRefIndexCb cb, void *user) {
+	return all ? index_foreach_range(idx, 0, UT64_MAX, cb, user) : index_foreach_range(idx, key, key, cb, user);
+}
+
 static RzAnalysisXRef *rz_analysis_xref_new(ut64 from, ut64 to, ut64 type) {
 	RzAnalysisXRef *xref = RZ_NEW(RzAnalysisXRef);
 	if (xref) {
@@ -31,36 +428,32 @@ static RzAnalysisXRef *rz_analysis_xref_new(ut64 from, ut64 to, ut64 type) {
 	return xref;
 }
 
-static void rz_analysis_xref_free(RzAnalysisXRef *xref) {
-	free(xref);
-}
-
 RZ_API RzList *rz_analysis_xref_list_new() {
 	return rz_list_newf((RzListFree)free);
 }
 
-static void xrefs_ht_free(HtUPKv *kv) {
-	ht_up_free(kv->value);
-}
-
-static void xrefs_ref_free(HtUPKv *kv) {
-	rz_analysis_xref_free(kv->value);
+typedef struct {
+	bool from2to; ///< whether the index is keyed by the source address
+	RzAnalysisXRefCb cb;
+	void *user;
+} XRefForeachCtx;
+
+static bool foreach_xref_cb(void *user, ut64 key, ut64 other, RzAnalysisXRefType type) {
+	XRefForeachCtx *ctx = user;
+	RzAnalysisXRef xref = {
+		.from = ctx->from2to ? key : other,
+		.to = ctx->from2to ? other : key,
+		.type = type
+	};
+	return ctx->cb(ctx->user, &xref);
 }
 
-static bool appendRef(void *u, const ut64 k, const void *v) {
-	RzList *list = (RzList *)u;
-	RzAnalysisXRef *xref = (RzAnalysisXRef *)v;
+static bool append_xref_cb(void *user, const RzAnalysisXRef *xref) {
 	RzAnalysisXRef *cloned = rz_analysis_xref_new(xref->from, xref->to, xref->type);
-	if (cloned) {
-		rz_list_append(list, cloned);
-		return true;
+	if (!cloned) {
+		return false;
 	}
-	return false;
-}
-
-static bool mylistrefs_cb(void *list, const ut64 k, const void *v) {
-	HtUP *ht = (HtUP *)v;
-	ht_up_foreach(ht, appendRef, list);
+	rz_list_append((RzList *)user, cloned);
 	return true;
 }
 
@@ -84,33 +477,22 @@ static void sortxrefs(RzList *list) {
 	rz_list_sort(list, (RzListComparator)ref_cmp);
 }
 
-static void listxrefs(HtUP *m, ut64 addr, RzList *list) {
-	if (addr == UT64_MAX) {
-		ht_up_foreach(m, mylistrefs_cb, list);
-	} else {
-		HtUP *d = ht_up_find(m, addr, NULL);
-		if (d) {
-			ht_up_foreach(d, appendRef, list);
-		}
-	}
+static bool listxrefs(RzAnalysisXRefIndex *idx, bool from2to, ut64 addr, RzList *list) {
+	XRefForeachCtx ctx = { from2to, append_xref_cb, list };
+	return index_foreach(idx, addr == UT64_MAX, addr, foreach_xref_cb, &ctx);
 }
 
-static bool set_xref(HtUP *m, RzAnalysisXRef *xref, bool from2to) {
-	ut64 key1 = from2to ? xref->from : xref->to;
-	HtUP *ht = ht_up_find(m, key1, NULL);
-	if (!ht) {
-		// RzAnalysis::ht_xrefs_to is responsible for releasing of pointers.
-		HtUPKvFreeFunc cb = from2to ? NULL : xrefs_ref_free;
-		ht = ht_up_new(NULL, cb, NULL);
-		if (!ht) {
-			return false;
-		}
-		if (!ht_up_insert(m, key1, ht)) {
-			return false;
-		}
-	}
-	ut64 key2 = from2to ? xref->to : xref->from;
-	return ht_up_update(ht, key2, xref);
+static bool push_xref_cb(void *user, const RzAnalysisXRef *xref) {
+	return rz_vector_push((RzVector *)user, (void *)xref);
+}
+
+static bool vecxrefs(RzAnalysisXRefIndex *idx, bool from2to, ut64 addr, RzVector *vec) {
+	XRefForeachCtx ctx = { from2to, push_xref_cb, vec };
+	return index_foreach(idx, false, addr, foreach_xref_cb, &ctx);
+}
+
+static RzVector *xref_vec_new(void) {
+	return rz_vector_new(sizeof(RzAnalysisXRef), NULL, NULL);
 }
 
 // Set a cross reference from FROM to TO.
@@ -126,22 +508,19 @@ RZ_API bool rz_analysis_xrefs_set(RzAnalysis *analysis, ut64 from, ut64 to, RzAn
 			return false;
 		}
 	}
-	RzAnalysisXRef *xref = rz_analysis_xref_new(from, to, type);
-	if (!xref) {
-		return false;
+	if (type == -1) {
+		type = RZ_ANALYSIS_XREF_TYPE_CODE;
 	}
-	if (!set_xref(analysis->ht_xrefs_from, xref, true)) {
-		// Pointer isn't added to <ht_xrefs_from> so we have to release it
-		rz_analysis_xref_free(xref);
+	if (!index_set(analysis->xrefs_from, from, to, type)) {
 		return false;
 	}
-	if (!set_xref(analysis->ht_xrefs_to, xref, false)) {
-		// Delete the entry in <ht_xrefs_from>
-		rz_analysis_xrefs_deln(analysis, from, to, type);
-		// Pointer isn't added to <ht_xrefs_to> so we have to release it
-		rz_analysis_xref_free(xref);
+	if (!index_set(analysis->xrefs_to, to, from, type)) {
+		// Delete the entry in <xrefs_from>
+		index_del(analysis->xrefs_from, from, to);
 		return false;
 	}
+	rz_analysis_mark_dirty(analysis, &analysis->gen.xrefs, from, from);
+	rz_analysis_mark_dirty(analysis, &analysis->gen.xrefs, to, to);
 	return true;
 }
 
@@ -149,25 +528,16 @@ RZ_API bool rz_analysis_xrefs_deln(RzAnalysis *analysis, ut64 from, ut64 to, RzA
 	if (!analysis) {
 		return false;
 	}
-	HtUP *ht1 = ht_up_find(analysis->ht_xrefs_from, from, NULL);
-	if (ht1) {
-		ht_up_delete(ht1, to);
-	}
-	HtUP *ht2 = ht_up_find(analysis->ht_xrefs_to, to, NULL);
-	if (ht2) {
-		ht_up_delete(ht2, from);
-	}
+	index_del(analysis->xrefs_from, from, to);
+	index_del(analysis->xrefs_to, to, from);
+	rz_analysis_mark_dirty(analysis, &analysis->gen.xrefs, from, from);
+	rz_analysis_mark_dirty(analysis, &analysis->gen.xrefs, to, to);
 	return true;
 }
 
 RZ_API bool rz_analysis_xref_del(RzAnalysis *analysis, ut64 from, ut64 to) {
-	bool res = false;
-	res |= rz_analysis_xrefs_deln(analysis, from, to, RZ_ANALYSIS_XREF_TYPE_NULL);
-	res |= rz_analysis_xrefs_deln(analysis, from, to, RZ_ANALYSIS_XREF_TYPE_CODE);
-	res |= rz_analysis_xrefs_deln(analysis, from, to, RZ_ANALYSIS_XREF_TYPE_CALL);
-	res |= rz_analysis_xrefs_deln(analysis, from, to, RZ_ANALYSIS_XREF_TYPE_DATA);
-	res |= rz_analysis_xrefs_deln(analysis, from, to, RZ_ANALYSIS_XREF_TYPE_STRING);
-	return res;
+	// the type is not part of the key, one deletion is enough
+	return rz_analysis_xrefs_deln(analysis, from, to, RZ_ANALYSIS_XREF_TYPE_NULL);
 }
 
 RZ_API RzList *rz_analysis_xrefs_get_to(RzAnalysis *analysis, ut64 addr) {
@@ -175,8 +545,8 @@ RZ_API RzList *rz_analysis_xrefs_get_to(RzAnalysis *analysis, ut64 addr) {
 	if (!list) {
 		return NULL;
 	}
-	listxrefs(analysis->ht_xrefs_to, addr, list);
-	sortxrefs(list);
+	// already sorted by (from, to)
+	listxrefs(analysis->xrefs_to, false, addr, list);
 	if (rz_list_empty(list)) {
 		rz_list_free(list);
 		list = NULL;
@@ -189,8 +559,7 @@ RZ_API RzList *rz_analysis_xrefs_get_from(RzAnalysis *analysis, ut64 addr) {
 	if (!list) {
 		return NULL;
 	}
-	listxrefs(analysis->ht_xrefs_from, addr, list);
-	sortxrefs(list);
+	listxrefs(analysis->xrefs_from, true, addr, list);
 	if (rz_list_empty(list)) {
 		rz_list_free(list);
 		list = NULL;
@@ -198,6 +567,37 @@ RZ_API RzList *rz_analysis_xrefs_get_from(RzAnalysis *analysis, ut64 addr) {
 	return list;
 }
 
+/**
+ * \brief Get the xrefs pointing to \p addr, sorted by source
+ *
+ * Same as rz_analysis_xrefs_get_to() with the xrefs stored inline, so
+ * getting and walking them costs a single allocation.
+ *
+ * \return RzVector <RzAnalysisXRef>, empty if there is no xref
+ */
+RZ_API RZ_OWN RzVector /*<RzAnalysisXRef>*/ *rz_analysis_xrefs_get_to_vec(RZ_NONNULL RzAnalysis *analysis, ut64 addr) {
+	rz_return_val_if_fail(analysis, NULL);
+	RzVector *vec = xref_vec_new();
+	if (vec) {
+		vecxrefs(analysis->xrefs_to, false, addr, vec);
+	}
+	return vec;
+}
+
+/**
+ * \brief Get the xrefs going out of \p addr, sorted by destination
+ *
+ * \return RzVector <RzAnalysisXRef>, empty if there is no xref
+ */
+RZ_API RZ_OWN RzVector /*<RzAnalysisXRef>*/ *rz_analysis_xrefs_get_from_vec(RZ_NONNULL RzAnalysis *analysis, ut64 addr) {
+	rz_return_val_if_fail(analysis, NULL);
+	RzVector *vec = xref_vec_new();
+	if (vec) {
+		vecxrefs(analysis->xrefs_from, true, addr, vec);
+	}
+	return vec;
+}
+
 /**
  * \brief Get list of all xrefs.
  * \param analysis RzAnalysis instance
@@ -207,12 +607,82 @@ RZ_API RZ_OWN RzList *rz_analysis_xrefs_list(RzAnalysis *analysis) {
 	rz_return_val_if_fail(analysis, NULL);
 	RzList *list = rz_analysis_xref_list_new();
 	if (list) {
-		listxrefs(analysis->ht_xrefs_from, UT64_MAX, list);
-		sortxrefs(list);
+		listxrefs(analysis->xrefs_from, true, UT64_MAX, list);
 	}
 	return list;
 }
 
+/**
+ * \brief Call \p cb for every xref going out of \p addr, sorted by destination
+ *
+ * Unlike rz_analysis_xrefs_get_from() nothing is allocated. The xref passed
+ * to \p cb is only valid during the call and \p cb must not add or remove
+ * xrefs.
+ *
+ * \return false if \p cb stopped the iteration by returning false
+ */
+RZ_API bool rz_analysis_xrefs_foreach_from(RZ_NONNULL RzAnalysis *analysis, ut64 addr, RZ_NONNULL RzAnalysisXRefCb cb, void *user) {
+	rz_return_val_if_fail(analysis && cb, false);
+	XRefForeachCtx ctx = { true, cb, user };
+	return index_foreach(analysis->xrefs_from, false, addr, foreach_xref_cb, &ctx);
+}
+
+/**
+ * \brief Call \p cb for every xref pointing to \p addr, sorted by source
+ *
+ * Same rules as rz_analysis_xrefs_foreach_from() apply.
+ */
+RZ_API bool rz_analysis_xrefs_foreach_to(RZ_NONNULL RzAnalysis *analysis, ut64 addr, RZ_NONNULL RzAnalysisXRefCb cb, void *user) {
+	rz_return_val_if_fail(analysis && cb, false);
+	XRefForeachCtx ctx = { false, cb, user };
+	return index_foreach(analysis->xrefs_to, false, addr, foreach_xref_cb, &ctx);
+}
+
+/**
+ * \brief Call \p cb for every xref, sorted by (source, destination)
+ *
+ * Same rules as rz_analysis_xrefs_foreach_from() apply.
+ */
+RZ_API bool rz_analysis_xrefs_foreach(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzAnalysisXRefCb cb, void *user) {
+	rz_return_val_if_fail(analysis && cb, false);
+	XRefForeachCtx ctx = { true, cb, user };
+	return index_foreach(analysis->xrefs_from, true, 0, foreach_xref_cb, &ctx);
+}
+
+static bool collect_xref_cb(void *user, ut64 key, ut64 other, RzAnalysisXRefType type) {
+	RzAnalysisXRef *xref = rz_vector_push((RzVector *)user, NULL);
+	if (!xref) {
+		return false;
+	}
+	xref->from = key;
+	xref->to = other;
+	xref->type = type;
+	return true;
+}
+
+/**
+ * \brief Delete all the xrefs going out of [\p from, \p to)
+ *
+ * \return The number of deleted xrefs
+ */
+RZ_API ut64 rz_analysis_xrefs_del_from_range(RZ_NONNULL RzAnalysis *analysis, ut64 from, ut64 to) {
+	rz_return_val_if_fail(analysis, 0);
+	if (from >= to) {
+		return 0;
+	}
+	RzVector xrefs;
+	rz_vector_init(&xrefs, sizeof(RzAnalysisXRef), NULL, NULL);
+	// the indices can't be changed while walking them
+	index_foreach_range(analysis->xrefs_from, from, to - 1, collect_xref_cb, &xrefs);
+	RzAnalysisXRef *xref;
+	rz_vector_foreach(&xrefs, xref) {
+		rz_analysis_xref_del(analysis, xref->from, xref->to);
+	}
+	ut64 count = rz_vector_len(&xrefs);
+	rz_vector_fini(&xrefs);
+	return count;
+}
+
 RZ_API const char *rz_analysis_xrefs_type_tostring(RzAnalysisXRefType type) {
 	switch (type) {
 	case RZ_ANALYSIS_XREF_TYPE_CODE:
@@ -243,39 +713,29 @@ RZ_API RzAnalysisXRefType rz_analysis_xrefs_type(char ch) {
 }
 
 RZ_API bool rz_analysis_xrefs_init(RzAnalysis *analysis) {
-	ht_up_free(analysis->ht_xrefs_from);
-	analysis->ht_xrefs_from = NULL;
-	ht_up_free(analysis->ht_xrefs_to);
-	analysis->ht_xrefs_to = NULL;
-
-	HtUP *tmp = ht_up_new(NULL, xrefs_ht_free, NULL);
-	if (!tmp) {
-		return false;
-	}
-	analysis->ht_xrefs_from = tmp;
-
-	tmp = ht_up_new(NULL, xrefs_ht_free, NULL);
-	if (!tmp) {
-		ht_up_free(analysis->ht_xrefs_from);
-		analysis->ht_xrefs_from = NULL;
+	rz_analysis_xrefs_fini(analysis);
+	analysis->xrefs_from = index_new();
+	analysis->xrefs_to = index_new();
+	if (!analysis->xrefs_from || !analysis->xrefs_to) {
+		rz_analysis_xrefs_fini(analysis);
 		return false;
 	}
-	analysis->ht_xrefs_to = tmp;
 	return true;
 }
 
-static bool count_cb(void *user, const ut64 k, const void *v) {
-	(*(ut64 *)user) += ((HtUP *)v)->count;
-	return true;
+RZ_API void rz_analysis_xrefs_fini(RzAnalysis *analysis) {
+	rz_return_if_fail(analysis);
+	index_free(analysis->xrefs_from);
+	analysis->xrefs_from = NULL;
+	index_free(analysis->xrefs_to);
+	analysis->xrefs_to = NULL;
 }
 
 RZ_API ut64 rz_analysis_xrefs_count(RzAnalysis *analysis) {
-	ut64 ret = 0;
-	ht_up_foreach(analysis->ht_xrefs_to, count_cb, &ret);
-	return ret;
+	return analysis->xrefs_to->count;
 }
 
-static RzList *fcn_get_refs(RzAnalysisFunction *fcn, HtUP *ht) {
+static RzList *fcn_get_refs(RzAnalysisFunction *fcn, RzAnalysisXRefIndex *idx, bool from2to) {
 	RzListIter *iter;
 	RzAnalysisBlock *bb;
 	RzList *list = rz_analysis_xref_list_new();
@@ -287,21 +747,60 @@ static RzList *fcn_get_refs(RzAnalysisFunction *fcn, HtUP *ht) {
 
 		for (i = 0; i < bb->ninstr; i++) {
 			ut64 at = bb->addr + rz_analysis_block_get_op_offset(bb, i);
-			listxrefs(ht, at, list);
+			listxrefs(idx, from2to, at, list);
 		}
 	}
 	sortxrefs(list);
 	return list;
 }
 
+static RzVector *fcn_get_refs_vec(RzAnalysisFunction *fcn, RzAnalysisXRefIndex *idx, bool from2to) {
+	RzVector *vec = xref_vec_new();
+	if (!vec) {
+		return NULL;
+	}
+	RzListIter *iter;
+	RzAnalysisBlock *bb;
+	rz_list_foreach (fcn->bbs, iter, bb) {
+		for (int i = 0; i < bb->ninstr; i++) {
+			ut64 at = bb->addr + rz_analysis_block_get_op_offset(bb, i);
+			vecxrefs(idx, from2to, at, vec);
+		}
+	}
+	rz_vector_sort(vec, (RzVectorComparator)ref_cmp, false);
+	return vec;
+}
+
+/**
+ * \brief Get the xrefs going out of the instructions of \p fcn, sorted by (source, destination)
+ *
+ * Same as rz_analysis_function_get_xrefs_from() with the xrefs stored inline.
+ *
+ * \return RzVector <RzAnalysisXRef>
+ */
+RZ_API RZ_OWN RzVector /*<RzAnalysisXRef>*/ *rz_analysis_function_get_xrefs_from_vec(RZ_NONNULL RzAnalysisFunction *fcn) {
+	rz_return_val_if_fail(fcn, NULL);
+	return fcn_get_refs_vec(fcn, fcn->analysis->xrefs_from, true);
+}
+
+/**
+ * \brief Get the xrefs pointing to the instructions of \p fcn, sorted by (source, destination)
+ *
+ * \return RzVector <RzAnalysisXRef>
+ */
+RZ_API RZ_OWN RzVector /*<RzAnalysisXRef>*/ *rz_analysis_function_get_xrefs_to_vec(RZ_NONNULL RzAnalysisFunction *fcn) {
+	rz_return_val_if_fail(fcn, NULL);
+	return fcn_get_refs_vec(fcn, fcn->analysis->xrefs_to, false);
+}
+
 RZ_API RzList *rz_analysis_function_get_xrefs_from(RzAnalysisFunction *fcn) {
 	rz_return_val_if_fail(fcn, NULL);
-	return fcn_get_refs(fcn, fcn->analysis->ht_xrefs_from);
+	return fcn_get_refs(fcn, fcn->analysis->xrefs_from, true);
 }
 
 RZ_API RzList *rz_analysis_function_get_xrefs_to(RzAnalysisFunction *fcn) {
 	rz_return_val_if_fail(fcn, NULL);
-	return fcn_get_refs(fcn, fcn->analysis->ht_xrefs_to);
+	return fcn_get_refs(fcn, fcn->analysis->xrefs_to, false);
 }
 
 RZ_API const char *rz_analysis_ref_type_tostring(RzAnalysisXRefType t) {
@@ -4,6 +4,8 @@
 #include <stdio.h>
 #include <rz_asm.h>
 
+#define EQU_KEY_MAX 256 ///< longer keys are looked for in every string
+
 RZ_API RzAsmCode *rz_asm_code_new(void) {
 	return RZ_NEW0(RzAsmCode);
 }
@@ -11,6 +13,8 @@ RZ_API RzAsmCode *rz_asm_code_new(void) {
 RZ_API void *rz_asm_code_free(RzAsmCode *acode) {
 	if (acode) {
 		rz_list_free(acode->equs);
+		ht_pp_free(acode->equs_by_key);
+		rz_vector_free(acode->equs_lens);
 		free(acode->bytes);
 		free(acode->assembly);
 		free(acode);
@@ -38,28 +42,86 @@ static RzAsmEqu *__asm_equ_new(const char *key, const char *value) {
 RZ_API bool rz_asm_code_set_equ(RzAsmCode *code, const char *key, const char *value) {
 	rz_return_val_if_fail(code && key && value, false);
 
-	if (code->equs) {
-		RzAsmEqu *equ;
-		RzListIter *iter;
-		rz_list_foreach (code->equs, iter, equ) {
-			if (!strcmp(equ->key, key)) {
-				free(equ->value);
-				equ->value = strdup(value);
-				return true;
-			}
-		}
-	} else {
+	if (!code->equs) {
 		code->equs = rz_list_newf((RzListFree)rz_asm_equ_item_free);
+		code->equs_by_key = ht_pp_new0();
+		code->equs_lens = rz_vector_new(sizeof(size_t), NULL, NULL);
+		if (!code->equs || !code->equs_by_key || !code->equs_lens) {
+			RZ_FREE_CUSTOM(code->equs, rz_list_free);
+			RZ_FREE_CUSTOM(code->equs_by_key, ht_pp_free);
+			RZ_FREE_CUSTOM(code->equs_lens, rz_vector_free);
+			return false;
+		}
+	}
+	RzAsmEqu *equ = ht_pp_find(code->equs_by_key, key, NULL);
+	if (equ) {
+		free(equ->value);
+		equ->value = strdup(value);
+		return true;
+	}
+	equ = __asm_equ_new(key, value);
+	if (!equ || !rz_list_append(code->equs, equ)) {
+		rz_asm_equ_item_free(equ);
+		return false;
+	}
+	equ->index = rz_list_length(code->equs) - 1;
+	ht_pp_insert(code->equs_by_key, key, equ);
+	size_t len = strlen(key);
+	size_t *l;
+	rz_vector_foreach(code->equs_lens, l) {
+		if (*l == len) {
+			return true;
+		}
 	}
-	rz_list_append(code->equs, __asm_equ_new(key, value));
+	rz_vector_push(code->equs_lens, &len);
 	return true;
 }
 
+// the first equ at or after the index from whose key is in str
+static RzAsmEqu *equ_next_in(RzAsmCode *code, const char *str, size_t from) {
+	RzAsmEqu *found = NULL;
+	char key[EQU_KEY_MAX];
+	size_t len = strlen(str);
+	for (size_t off = 0; off < len; off++) {
+		size_t *l;
+		rz_vector_foreach(code->equs_lens, l) {
+			if (!*l || *l > len - off) {
+				continue;
+			}
+			memcpy(key, str + off, *l);
+			key[*l] = 0;
+			RzAsmEqu *equ = ht_pp_find(code->equs_by_key, key, NULL);
+			if (equ && equ->index >= from && (!found || equ->index < found->index)) {
+				found = equ;
+			}
+		}
+	}
+	return found;
+}
+
+/**
+ * \brief Replaces the keys of the equs in \p str, one equ after the other in definition order
+ *
+ * Only the equs whose key is in the string at their turn are replaced, they are
+ * found with the key index instead of looking for every key of the list.
+ */
 RZ_API char *rz_asm_code_equ_replace(RzAsmCode *code, char *str) {
 	rz_return_val_if_fail(code && str, NULL);
+	if (!code->equs) {
+		return str;
+	}
 	RzAsmEqu *equ;
 	RzListIter *iter;
-	rz_list_foreach (code->equs, iter, equ) {
+	size_t *l;
+	rz_vector_foreach(code->equs_lens, l) {
+		if (*l >= EQU_KEY_MAX) {
+			rz_list_foreach (code->equs, iter, equ) {
+				str = rz_str_replace(str, equ->key, equ->value, true);
+			}
+			return str;
+		}
+	}
+	for (size_t from = 0; str && (equ = equ_next_in(code, str, from)); from = equ->index + 1) {
 		str = rz_str_replace(str, equ->key, equ->value, true);
 	}
 	return str;
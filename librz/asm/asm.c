@@ -526,6 +526,57 @@ RZ_API int rz_asm_disassemble(RzAsm *a, RzAsmOp *op, const ut8 *buf, int len) {
 	return ret;
 }
 
+/**
+ * \brief Disassemble up to \p n instructions of \p buf, starting at a->pc
+ *
+ * Plugins implementing RzAsmPlugin.disassemble_batch decode the whole batch
+ * with a single setup and without allocating anything per instruction, the
+ * others are called once per instruction. Invalid instructions take one byte,
+ * like in rz_asm_mdisassemble(). a->pc is left unchanged.
+ *
+ * \param text if not NULL, the text of every instruction is appended to it,
+ * nul-terminated, at RzAsmInsn.asm_off. Linear sweeps that only need the sizes
+ * can skip the rendering by passing NULL.
+ * \return the number of instructions written to \p insns
+ */
+RZ_API int rz_asm_disassemble_batch(RZ_NONNULL RzAsm *a, RZ_NONNULL const ut8 *buf, int len, RZ_NONNULL RZ_OUT RzAsmInsn *insns, int n, RZ_NULLABLE RzStrBuf *text) {
+	rz_return_val_if_fail(a && buf && insns, 0);
+	const ut64 pc = a->pc;
+	// the output filter and bit shifting only exist in rz_asm_disassemble()
+	const bool batch = a->cur && a->cur->disassemble_batch && !a->ofilter && !a->bitshift;
+	int count = 0;
+	int idx = 0;
+	while (count < n && idx < len) {
+		rz_asm_set_pc(a, pc + idx);
+		if (batch) {
+			int decoded = a->cur->disassemble_batch(a, insns + count, n - count, buf + idx, len - idx, text);
+			if (decoded > 0) {
+				for (int i = 0; i < decoded; i++) {
+					idx += insns[count + i].size;
+				}
+				count += decoded;
+				continue;
+			}
+		}
+		RzAsmOp op;
+		RzAsmInsn *insn = &insns[count++];
+		int ret = rz_asm_disassemble(a, &op, buf + idx, len - idx);
+		insn->addr = pc + idx;
+		insn->invalid = ret < 1;
+		insn->size = ret < 1 ? 1 : ret;
+		insn->asm_off = -1;
+		if (text) {
+			const char *str = rz_asm_op_get_asm(&op);
+			insn->asm_off = rz_strbuf_length(text);
+			rz_strbuf_append_n(text, str, strlen(str) + 1);
+		}
+		rz_asm_op_fini(&op);
+		idx += insn->size;
+	}
+	rz_asm_set_pc(a, pc);
+	return count;
+}
+
 typedef int (*Ase)(RzAsm *a, RzAsmOp *op, const char *buf);
 
 static bool assemblerMatches(RzAsm *a, RzAsmPlugin *h) {
@@ -679,6 +730,29 @@ RZ_API RzAsmCode *rz_asm_mdisassemble(RzAsm *a, const ut8 *buf, int len) {
 	if (!(buf_asm = rz_strbuf_new(NULL))) {
 		return rz_asm_code_free(acode);
 	}
+	if (addrbytes == 1 && !a->ofilter) {
+		RzAsmInsn insns[64];
+		RzStrBuf text;
+		rz_strbuf_init(&text);
+		for (idx = 0; idx < len;) {
+			rz_asm_set_pc(a, pc + idx);
+			int count = rz_asm_disassemble_batch(a, buf + idx, len - idx, insns, RZ_ARRAY_SIZE(insns), &text);
+			if (count < 1) {
+				break;
+			}
+			for (int i = 0; i < count; i++) {
+				rz_strbuf_append(buf_asm, rz_strbuf_get(&text) + insns[i].asm_off);
+				rz_strbuf_append(buf_asm, "\n");
+				idx += insns[i].size;
+			}
+			rz_asm_set_pc(a, insns[count - 1].addr);
+			rz_strbuf_fini(&text);
+		}
+		rz_strbuf_fini(&text);
+		acode->assembly = rz_strbuf_drain(buf_asm);
+		acode->len = idx;
+		return acode;
+	}
 	RzAsmOp op;
 	rz_asm_op_init(&op);
 	for (idx = 0; idx + addrbytes <= len; idx += (addrbytes * ret)) {
@@ -730,12 +804,101 @@ static void *__dup_val(const void *v) {
 	return (void *)strdup((char *)v);
 }
 
+/*
+ * The bytes assembled for a line in a previous stage, reused while the line
+ * and the state of the assembler stay the same.
+ */
+typedef struct {
+	char *str; ///< NULL if nothing is cached
+	char *cpu;
+	RzAsmPlugin *cur;
+	ut64 pc;
+	int bits;
+	int syntax;
+	int big_endian;
+	ut8 *bytes;
+	int size;
+} AsmLineCache;
+
+static void asm_line_cache_fini(AsmLineCache *c) {
+	free(c->str);
+	free(c->cpu);
+	free(c->bytes);
+	memset(c, 0, sizeof(*c));
+}
+
+static void asm_line_caches_free(AsmLineCache *cache, size_t count) {
+	if (!cache) {
+		return;
+	}
+	for (size_t i = 0; i < count; i++) {
+		asm_line_cache_fini(&cache[i]);
+	}
+	free(cache);
+}
+
+static int asm_line_assemble(RzAsm *a, RzAsmOp *op, AsmLineCache *c, const char *str) {
+	if (c->str && c->pc == a->pc && c->cur == a->cur && c->bits == a->bits &&
+		c->syntax == a->syntax && c->big_endian == a->big_endian &&
+		!strcmp(c->str, str) && !strcmp(c->cpu ? c->cpu : "", a->cpu ? a->cpu : "")) {
+		rz_asm_op_set_buf(op, c->bytes, c->size);
+		op->size = c->size;
+		return c->size;
+	}
+	asm_line_cache_fini(c);
+	int ret = rz_asm_assemble(a, op, str);
+	if (ret < 1 || op->buf_inc || rz_strbuf_length(&op->buf) != ret) {
+		return ret;
+	}
+	c->bytes = rz_mem_dup(rz_strbuf_get(&op->buf), ret);
+	c->str = strdup(str);
+	c->cpu = a->cpu ? strdup(a->cpu) : NULL;
+	if (!c->bytes || !c->str || (a->cpu && !c->cpu)) {
+		asm_line_cache_fini(c);
+		return ret;
+	}
+	c->cur = a->cur;
+	c->pc = a->pc;
+	c->bits = a->bits;
+	c->syntax = a->syntax;
+	c->big_endian = a->big_endian;
+	c->size = ret;
+	return ret;
+}
+
+// the first c at or after from, the position found is remembered in *at for the next tokens
+static char *asm_next_chr(char *from, char c, char **at) {
+	if (!*at || *at < from) {
+		char *p = strchr(from, c);
+		*at = p ? p : from + strlen(from);
+	}
+	return **at ? *at : NULL;
+}
+
+// makes room for size bytes in the output, zeroing the new bytes
+static bool asm_code_reserve(RzAsmCode *acode, size_t *capacity, size_t size) {
+	if (size <= *capacity) {
+		return true;
+	}
+	size_t cap = RZ_MAX(*capacity * 2, size);
+	ut8 *bytes = realloc(acode->bytes, cap);
+	if (!bytes) {
+		return false;
+	}
+	memset(bytes + *capacity, 0, cap - *capacity);
+	acode->bytes = bytes;
+	*capacity = cap;
+	return true;
+}
+
 RZ_API RzAsmCode *rz_asm_massemble(RzAsm *a, const char *assembly) {
 	int num, stage, ret, idx, ctr, i, linenum = 0;
 	char *lbuf = NULL, *ptr2, *ptr = NULL, *ptr_start = NULL;
 	const char *asmcpu = NULL;
 	RzAsmCode *acode = NULL;
 	RzAsmOp op = { 0 };
+	AsmLineCache *cache = NULL;
+	size_t capacity = 64;
 	ut64 off, pc;
 
 	char *buf_token = NULL;
@@ -762,7 +925,7 @@ RZ_API RzAsmCode *rz_asm_massemble(RzAsm *a, const char *assembly) {
 		return rz_asm_code_free(acode);
 	}
 	rz_str_ncpy(acode->assembly, assembly, sizeof(acode->assembly) - 1);
-	if (!(acode->bytes = calloc(1, 64))) {
+	if (!(acode->bytes = calloc(1, capacity))) {
 		free(tokens);
 		return rz_asm_code_free(acode);
 	}
@@ -808,10 +971,11 @@ RZ_API RzAsmCode *rz_asm_massemble(RzAsm *a, const char *assembly) {
 	bool labels = !!strchr(lbuf, ':');
 
 	/* Tokenize */
+	char *semi = NULL, *nl = NULL, *cr = NULL;
 	for (tokens[0] = lbuf, ctr = 0;
-		((ptr = strchr(tokens[ctr], ';')) ||
-			(ptr = strchr(tokens[ctr], '\n')) ||
-			(ptr = strchr(tokens[ctr], '\r')));) {
+		((ptr = asm_next_chr(tokens[ctr], ';', &semi)) ||
+			(ptr = asm_next_chr(tokens[ctr], '\n', &nl)) ||
+			(ptr = asm_next_chr(tokens[ctr], '\r', &cr)));) {
 		if (ctr + 1 >= tokens_size) {
 			const size_t new_tokens_size = tokens_size * 2;
 			if (sizeof(char *) * new_tokens_size <= sizeof(char *) * tokens_size) {
@@ -842,6 +1006,9 @@ RZ_API RzAsmCode *rz_asm_massemble(RzAsm *a, const char *assembly) {
 #define STAGES 5
 	pc = a->pc;
 	bool inComment = false;
+	if (!(cache = RZ_NEWS0(AsmLineCache, ctr + 1))) {
+		goto fail;
+	}
 	for (stage = 0; stage < STAGES; stage++) {
 		if (stage < 2 && !labels) {
 			continue;
@@ -1040,25 +1207,15 @@ RZ_API RzAsmCode *rz_asm_massemble(RzAsm *a, const char *assembly) {
 					goto fail;
 				}
 			} else { /* Instruction */
-				char *str = ptr_start;
-				rz_str_trim(str);
-				if (acode->equs) {
-					if (!*ptr_start) {
-						continue;
-					}
-					str = rz_asm_code_equ_replace(acode, strdup(ptr_start));
-					rz_asm_op_fini(&op);
-					rz_asm_op_init(&op);
-					ret = rz_asm_assemble(a, &op, str);
-					free(str);
-				} else {
-					if (!*ptr_start) {
-						continue;
-					}
-					rz_asm_op_fini(&op);
-					rz_asm_op_init(&op);
-					ret = rz_asm_assemble(a, &op, ptr_start);
+				rz_str_trim(ptr_start);
+				if (!*ptr_start) {
+					continue;
 				}
+				char *str = acode->equs ? rz_asm_code_equ_replace(acode, strdup(ptr_start)) : NULL;
+				rz_asm_op_fini(&op);
+				rz_asm_op_init(&op);
+				ret = asm_line_assemble(a, &op, &cache[i], str ? str : ptr_start);
+				free(str);
 			}
 			if (stage == STAGES - 1) {
 				if (ret < 1) {
@@ -1066,17 +1223,18 @@ RZ_API RzAsmCode *rz_asm_massemble(RzAsm *a, const char *assembly) {
 					goto fail;
 				}
 				acode->len = idx + ret;
-				char *newbuf = realloc(acode->bytes, (idx + ret) * 2);
-				if (!newbuf) {
+				if (!asm_code_reserve(acode, &capacity, (size_t)idx + RZ_MAX(ret, rz_strbuf_length(&op.buf)) + 1)) {
 					goto fail;
 				}
-				acode->bytes = (ut8 *)newbuf;
 				memcpy(acode->bytes + idx, rz_strbuf_get(&op.buf), rz_strbuf_length(&op.buf));
-				memset(acode->bytes + idx + ret, 0, idx + ret);
 				if (op.buf_inc && rz_buf_size(op.buf_inc) > 1) {
 					char *inc = rz_buf_to_string(op.buf_inc);
 					rz_buf_free(op.buf_inc);
 					op.buf_inc = NULL;
+					if (inc && !asm_code_reserve(acode, &capacity, (size_t)idx + ret + strlen(inc) / 2 + 2)) {
+						free(inc);
+						goto fail;
+					}
 					if (inc) {
 						ret += rz_hex_str2bin(inc, acode->bytes + idx + ret);
 						free(inc);
@@ -1085,11 +1243,13 @@ RZ_API RzAsmCode *rz_asm_massemble(RzAsm *a, const char *assembly) {
 			}
 		}
 	}
+	asm_line_caches_free(cache, ctr + 1);
 	rz_asm_op_fini(&op);
 	free(lbuf);
 	free(tokens);
 	return acode;
 fail:
+	asm_line_caches_free(cache, ctr + 1);
 	rz_asm_op_fini(&op);
 	free(lbuf);
 	free(tokens);
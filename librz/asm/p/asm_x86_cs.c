@@ -22,10 +22,9 @@ static int check_features(RzAsm *a, cs_insn *insn);
 
 #include "asm_x86_vm.c"
 
-static int disassemble(RzAsm *a, RzAsmOp *op, const ut8 *buf, int len) {
+static bool setup(RzAsm *a) {
 	static int omode = 0;
 	int mode, ret;
-	ut64 off = a->pc;
 
 	mode = (a->bits == 64) ? CS_MODE_64 : (a->bits == 32) ? CS_MODE_32
 		: (a->bits == 16)                             ? CS_MODE_16
@@ -34,14 +33,11 @@ static int disassemble(RzAsm *a, RzAsmOp *op, const ut8 *buf, int len) {
 		cs_close(&cd);
 		cd = 0;
 	}
-	if (op) {
-		op->size = 0;
-	}
 	omode = mode;
 	if (cd == 0) {
 		ret = cs_open(CS_ARCH_X86, mode, &cd);
 		if (ret) {
-			return 0;
+			return false;
 		}
 	}
 	if (a->features && *a->features) {
@@ -63,6 +59,33 @@ static int disassemble(RzAsm *a, RzAsmOp *op, const ut8 *buf, int len) {
 	} else {
 		cs_option(cd, CS_OPT_SYNTAX, CS_OPT_SYNTAX_INTEL);
 	}
+	return true;
+}
+
+static void insn_to_string(RzAsm *a, cs_insn *insn, char *str, size_t size) {
+	snprintf(str, size, "%s%s%s", insn->mnemonic, insn->op_str[0] ? " " : "", insn->op_str);
+	char *ptrstr = strstr(str, "ptr ");
+	if (ptrstr) {
+		memmove(ptrstr, ptrstr + 4, strlen(ptrstr + 4) + 1);
+	}
+	if (a->syntax == RZ_ASM_SYNTAX_JZ) {
+		if (!strncmp(str, "je ", 3)) {
+			memcpy(str, "jz", 2);
+		} else if (!strncmp(str, "jne ", 4)) {
+			memcpy(str, "jnz", 3);
+		}
+	}
+}
+
+static int disassemble(RzAsm *a, RzAsmOp *op, const ut8 *buf, int len) {
+	ut64 off = a->pc;
+
+	if (op) {
+		op->size = 0;
+	}
+	if (!setup(a)) {
+		return 0;
+	}
 	if (!op) {
 		return true;
 	}
@@ -79,33 +102,49 @@ static int disassemble(RzAsm *a, RzAsmOp *op, const ut8 *buf, int len) {
 		}
 	}
 	if (op->size == 0 && n > 0 && insn->size > 0) {
-		char *ptrstr;
+		char str[sizeof(insn->mnemonic) + sizeof(insn->op_str) + 1];
 		op->size = insn->size;
-		char *buf_asm = sdb_fmt("%s%s%s",
-			insn->mnemonic, insn->op_str[0] ? " " : "",
-			insn->op_str);
-		ptrstr = strstr(buf_asm, "ptr ");
-		if (ptrstr) {
-			memmove(ptrstr, ptrstr + 4, strlen(ptrstr + 4) + 1);
-		}
-		rz_asm_op_set_asm(op, buf_asm);
+		insn_to_string(a, insn, str, sizeof(str));
+		rz_asm_op_set_asm(op, str);
 	} else {
 		decompile_vm(a, op, buf, len);
 	}
-	if (a->syntax == RZ_ASM_SYNTAX_JZ) {
-		char *buf_asm = rz_strbuf_get(&op->buf_asm);
-		if (!strncmp(buf_asm, "je ", 3)) {
-			memcpy(buf_asm, "jz", 2);
-		} else if (!strncmp(buf_asm, "jne ", 4)) {
-			memcpy(buf_asm, "jnz", 3);
-		}
-	}
 	if (insn) {
 		cs_free(insn, n);
 	}
 	return op->size;
 }
 
+static int disassemble_batch(RzAsm *a, RzAsmInsn *insns, int max_insns, const ut8 *buf, int len, RzStrBuf *text) {
+	// features need the details of every instruction, which is what batches avoid
+	if ((a->features && *a->features) || !setup(a)) {
+		return 0;
+	}
+	cs_insn *insn = cs_malloc(cd);
+	if (!insn) {
+		return 0;
+	}
+	const ut8 *code = buf;
+	size_t size = len;
+	uint64_t addr = a->pc;
+	int count = 0;
+	while (count < max_insns && cs_disasm_iter(cd, &code, &size, &addr, insn) && insn->size > 0) {
+		RzAsmInsn *out = &insns[count++];
+		out->addr = insn->address;
+		out->size = insn->size;
+		out->invalid = false;
+		out->asm_off = -1;
+		if (text) {
+			char str[sizeof(insn->mnemonic) + sizeof(insn->op_str) + 1];
+			insn_to_string(a, insn, str, sizeof(str));
+			out->asm_off = rz_strbuf_length(text);
+			rz_strbuf_append_n(text, str, strlen(str) + 1);
+		}
+	}
+	cs_free(insn, 1);
+	return count;
+}
+
 RzAsmPlugin rz_asm_plugin_x86_cs = {
 	.name = "x86",
 	.desc = "Capstone X86 disassembler",
@@ -118,6 +157,7 @@ RzAsmPlugin rz_asm_plugin_x86_cs = {
 	.fini = the_end,
 	.mnemonics = mnemonics,
 	.disassemble = &disassemble,
+	.disassemble_batch = &disassemble_batch,
 	.features = "vm,3dnow,aes,adx,avx,avx2,avx512,bmi,bmi2,cmov,"
 		    "f16c,fma,fma4,fsgsbase,hle,mmx,rtm,sha,sse1,sse2,"
 		    "sse3,sse41,sse42,sse4a,ssse3,pclmul,xop"
@@ -0,0 +1,478 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/**
+ * \file bcache.c
+ * On-disk cache of the items parsed by the bin plugins (bin.cache.dir).
+ *
+ * Each cache file holds the sections, symbols, imports, relocs and strings of
+ * one RzBinObject exactly as rz_bin_object_set_items() left them, so a hit
+ * skips the plugin and all the post-processing. The file name is the sha256
+ * of the file contents together with everything that influences the parsed
+ * items (plugin and its version, rizin version, load options, filtering and
+ * string search settings), so a stale entry is simply never found.
+ *
+ * All integers are little endian, strings are a ut32 length followed by the
+ * bytes, with a length of UT32_MAX meaning NULL. Lists are a ut32 count
+ * followed by the elements, with a count of UT32_MAX meaning no list.
+ */
+
+#include <rz_bin.h>
+#include <rz_hash.h>
+#include "i/private.h"
+
+#define BIN_CACHE_MAGIC   "RZBCACHE"
+#define BIN_CACHE_VERSION 1
+#define BIN_CACHE_NONE    UT32_MAX
+
+/**
+ * \brief Path of the cache file for the object \p o of \p bf, or NULL if the cache is disabled
+ */
+RZ_IPI RZ_OWN char *rz_bin_cache_path(RZ_NONNULL RzBinFile *bf, RZ_NONNULL RzBinObject *o) {
+	rz_return_val_if_fail(bf && o && o->plugin, NULL);
+	RzBin *bin = bf->rbin;
+	if (RZ_STR_ISEMPTY(bin->cache_dir) || !bf->buf || !bin->hash) {
+		return NULL;
+	}
+	RzHashCfg *md = rz_hash_cfg_new_with_algo(bin->hash, "sha256", NULL, 0);
+	if (!md) {
+		return NULL;
+	}
+	ut8 chunk[0x10000];
+	ut64 size = rz_buf_size(bf->buf);
+	for (ut64 at = 0; at < size;) {
+		st64 r = rz_buf_read_at(bf->buf, at, chunk, RZ_MIN(sizeof(chunk), size - at));
+		if (r <= 0) {
+			rz_hash_cfg_free(md);
+			return NULL;
+		}
+		rz_hash_cfg_update(md, chunk, r);
+		at += r;
+	}
+	RzBinObjectLoadOptions *opts = &o->opts;
+	char *params = rz_str_newf("%s|%s|%s|%" PFMT64x "|%" PFMT64x "|%d%d%d%d%d|%d|%" PFMT64x "|%d|%d|%" PFMT64x "|%d|%d|%d|%s",
+		RZ_VERSION, o->plugin->name, rz_str_get(o->plugin->version),
+		opts->baseaddr, opts->loadaddr, opts->patch_relocs, opts->big_endian,
+		opts->elf_load_sections, opts->elf_checks_sections, opts->elf_checks_segments,
+		bin->filter, bin->filter_rules, bin->minstrlen, bin->maxstrlen, bin->maxstrbuf, bin->rawstr,
+		bin->debase64, bin->strseach_check_ascii_freq, rz_str_get(bin->strenc));
+	if (!params) {
+		rz_hash_cfg_free(md);
+		return NULL;
+	}
+	rz_hash_cfg_update(md, (const ut8 *)params, strlen(params));
+	free(params);
+	rz_hash_cfg_final(md);
+	char *digest = rz_hash_cfg_get_result_string(md, "sha256", NULL, false);
+	rz_hash_cfg_free(md);
+	if (!digest) {
+		return NULL;
+	}
+	char *path = rz_str_newf("%s" RZ_SYS_DIR "%s.rzbc", bin->cache_dir, digest);
+	free(digest);
+	return path;
+}
+
+static void write_bytes(RzVector *out, const void *data, size_t len) {
+	rz_vector_insert_range(out, out->len, (void *)data, len);
+}
+
+static void write_u32(RzVector *out, ut32 v) {
+	ut8 tmp[4];
+	rz_write_le32(tmp, v);
+	write_bytes(out, tmp, sizeof(tmp));
+}
+
+static void write_u64(RzVector *out, ut64 v) {
+	ut8 tmp[8];
+	rz_write_le64(tmp, v);
+	write_bytes(out, tmp, sizeof(tmp));
+}
+
+static void write_str(RzVector *out, const char *s) {
+	if (!s) {
+		write_u32(out, BIN_CACHE_NONE);
+		return;
+	}
+	size_t len = strlen(s);
+	write_u32(out, (ut32)len);
+	write_bytes(out, s, len);
+}
+
+static void write_section(RzVector *out, RzBinSection *s) {
+	write_str(out, s->name);
+	write_u64(out, s->size);
+	write_u64(out, s->vsize);
+	write_u64(out, s->vaddr);
+	write_u64(out, s->paddr);
+	write_u32(out, s->perm);
+	write_u64(out, s->align);
+	write_str(out, s->arch);
+	write_u64(out, s->type);
+	write_u64(out, s->flags);
+	write_str(out, s->format);
+	write_u32(out, (ut32)s->bits);
+	write_u32(out, s->has_strings | s->is_data << 1 | s->is_segment << 2);
+}
+
+static void write_symbol(RzVector *out, RzBinSymbol *s) {
+	write_str(out, s->name);
+	write_str(out, s->dname);
+	write_str(out, s->libname);
+	write_str(out, s->classname);
+	write_str(out, s->forwarder);
+	write_str(out, s->bind);
+	write_str(out, s->type);
+	write_str(out, s->rtype);
+	write_str(out, s->visibility_str);
+	write_u32(out, s->is_imported);
+	write_u64(out, s->vaddr);
+	write_u64(out, s->paddr);
+	write_u32(out, s->size);
+	write_u32(out, s->ordinal);
+	write_u32(out, s->visibility);
+	write_u32(out, (ut32)s->bits);
+	write_u64(out, s->method_flags);
+	write_u32(out, (ut32)s->dup_count);
+}
+
+static void write_import(RzVector *out, RzBinImport *imp) {
+	write_str(out, imp->name);
+	write_str(out, imp->libname);
+	write_str(out, imp->bind);
+	write_str(out, imp->type);
+	write_str(out, imp->classname);
+	write_str(out, imp->descriptor);
+	write_u32(out, imp->ordinal);
+	write_u32(out, imp->visibility);
+}
+
+static void write_reloc(RzVector *out, RzBinReloc *r) {
+	write_u32(out, r->type);
+	// imports and symbols are referenced by name and resolved again on load
+	write_str(out, r->import ? r->import->name : NULL);
+	write_str(out, r->symbol ? r->symbol->name : NULL);
+	write_u64(out, (ut64)r->addend);
+	write_u64(out, r->vaddr);
+	write_u64(out, r->paddr);
+	write_u64(out, r->target_vaddr);
+	write_u32(out, r->visibility);
+	write_u32(out, r->additive | r->is_ifunc << 1);
+}
+
+static void write_string(RzVector *out, RzBinString *s) {
+	write_str(out, s->string);
+	write_u64(out, s->vaddr);
+	write_u64(out, s->paddr);
+	write_u32(out, s->ordinal);
+	write_u32(out, s->size);
+	write_u32(out, s->length);
+	write_u32(out, (ut8)s->type);
+}
+
+#define WRITE_LIST(out, list, fn) \
+	do { \
+		if (!(list)) { \
+			write_u32(out, BIN_CACHE_NONE); \
+			break; \
+		} \
+		write_u32(out, rz_list_length(list)); \
+		RzListIter *it; \
+		void *item; \
+		rz_list_foreach ((list), it, item) { \
+			fn(out, item); \
+		} \
+	} while (0)
+
+/**
+ * \brief Store the items of \p o into the cache file at \p path
+ */
+RZ_IPI bool rz_bin_cache_save(RZ_NONNULL RzBinObject *o, RZ_NONNULL const char *path) {
+	rz_return_val_if_fail(o && path, false);
+	RzVector out;
+	rz_vector_init(&out, 1, NULL, NULL);
+	write_bytes(&out, BIN_CACHE_MAGIC, 8);
+	write_u32(&out, BIN_CACHE_VERSION);
+	WRITE_LIST(&out, o->sections, write_section);
+	WRITE_LIST(&out, o->symbols, write_symbol);
+	WRITE_LIST(&out, o->imports, write_import);
+	if (o->relocs) {
+		write_u32(&out, (ut32)o->relocs->relocs_count);
+		for (size_t i = 0; i < o->relocs->relocs_count; i++) {
+			write_reloc(&out, &o->relocs->relocs[i]);
+		}
+	} else {
+		write_u32(&out, BIN_CACHE_NONE);
+	}
+	WRITE_LIST(&out, o->strings ? o->strings->list : NULL, write_string);
+
+	// write to a temporary file first, so concurrent readers never see a partial entry
+	bool ret = false;
+	char *tmp = rz_str_newf("%s.%d", path, rz_sys_getpid());
+	char *dir = rz_file_dirname(path);
+	if (tmp && dir && out.len <= INT_MAX && (rz_file_is_directory(dir) || rz_sys_mkdirp(dir))) {
+		ret = rz_file_dump(tmp, out.a, (int)out.len, false) && !rename(tmp, path);
+		if (!ret) {
+			rz_file_rm(tmp);
+		}
+	}
+	free(dir);
+	free(tmp);
+	rz_vector_fini(&out);
+	return ret;
+}
+
+#undef WRITE_LIST
+
+typedef struct {
+	RzBin *bin;
+	const ut8 *buf;
+	size_t size;
+	size_t pos;
+	bool error;
+} CacheReader;
+
+static const ut8 *read_bytes(CacheReader *r, size_t len) {
+	if (r->error || r->size - r->pos < len) {
+		r->error = true;
+		return NULL;
+	}
+	const ut8 *p = r->buf + r->pos;
+	r->pos += len;
+	return p;
+}
+
+static ut32 read_u32(CacheReader *r) {
+	const ut8 *p = read_bytes(r, 4);
+	return p ? rz_read_le32(p) : 0;
+}
+
+static ut64 read_u64(CacheReader *r) {
+	const ut8 *p = read_bytes(r, 8);
+	return p ? rz_read_le64(p) : 0;
+}
+
+static char *read_str(CacheReader *r) {
+	ut32 len = read_u32(r);
+	if (len == BIN_CACHE_NONE) {
+		return NULL;
+	}
+	const ut8 *p = read_bytes(r, len);
+	return p ? rz_str_ndup((const char *)p, len) : NULL;
+}
+
+/// read a string that must live as long as the RzBin, like the ones plugins put in const fields
+static const char *read_const_str(CacheReader *r) {
+	char *s = read_str(r);
+	if (!s) {
+		return NULL;
+	}
+	const char *ret = rz_str_constpool_get(&r->bin->constpool, s);
+	free(s);
+	return ret;
+}
+
+static void *read_section(CacheReader *r) {
+	RzBinSection *s = RZ_NEW0(RzBinSection);
+	if (!s) {
+		r->error = true;
+		return NULL;
+	}
+	s->name = read_str(r);
+	s->size = read_u64(r);
+	s->vsize = read_u64(r);
+	s->vaddr = read_u64(r);
+	s->paddr = read_u64(r);
+	s->perm = read_u32(r);
+	s->align = read_u64(r);
+	s->arch = read_const_str(r);
+	s->type = read_u64(r);
+	s->flags = read_u64(r);
+	s->format = read_str(r);
+	s->bits = (int)read_u32(r);
+	ut32 flags = read_u32(r);
+	s->has_strings = flags & 1;
+	s->is_data = flags & 2;
+	s->is_segment = flags & 4;
+	return s;
+}
+
+static void *read_symbol(CacheReader *r) {
+	RzBinSymbol *s = RZ_NEW0(RzBinSymbol);
+	if (!s) {
+		r->error = true;
+		return NULL;
+	}
+	s->name = read_str(r);
+	s->dname = read_str(r);
+	s->libname = read_str(r);
+	s->classname = read_str(r);
+	s->forwarder = read_const_str(r);
+	s->bind = read_const_str(r);
+	s->type = read_const_str(r);
+	s->rtype = read_const_str(r);
+	s->visibility_str = read_str(r);
+	s->is_imported = read_u32(r);
+	s->vaddr = read_u64(r);
+	s->paddr = read_u64(r);
+	s->size = read_u32(r);
+	s->ordinal = read_u32(r);
+	s->visibility = read_u32(r);
+	s->bits = (int)read_u32(r);
+	s->method_flags = read_u64(r);
+	s->dup_count = (int)read_u32(r);
+	return s;
+}
+
+static void *read_import(CacheReader *r) {
+	RzBinImport *imp = RZ_NEW0(RzBinImport);
+	if (!imp) {
+		r->error = true;
+		return NULL;
+	}
+	imp->name = read_str(r);
+	imp->libname = read_str(r);
+	imp->bind = read_const_str(r);
+	imp->type = read_const_str(r);
+	imp->classname = read_str(r);
+	imp->descriptor = read_str(r);
+	imp->ordinal = read_u32(r);
+	imp->visibility = read_u32(r);
+	return imp;
+}
+
+static void *read_string(CacheReader *r) {
+	RzBinString *s = RZ_NEW0(RzBinString);
+	if (!s) {
+		r->error = true;
+		return NULL;
+	}
+	s->string = read_str(r);
+	s->vaddr = read_u64(r);
+	s->paddr = read_u64(r);
+	s->ordinal = read_u32(r);
+	s->size = read_u32(r);
+	s->length = read_u32(r);
+	s->type = (char)read_u32(r);
+	return s;
+}
+
+static RzList *read_list(CacheReader *r, void *(*read_item)(CacheReader *), RzListFree free_item) {
+	ut32 count = read_u32(r);
+	if (r->error || count == BIN_CACHE_NONE) {
+		return NULL;
+	}
+	RzList *list = rz_list_newf(free_item);
+	if (!list) {
+		r->error = true;
+		return NULL;
+	}
+	for (ut32 i = 0; i < count && !r->error; i++) {
+		void *item = read_item(r);
+		if (item) {
+			rz_list_append(list, item);
+		}
+	}
+	return list;
+}
+
+static RzList *read_relocs(CacheReader *r, RzList *imports_list, RzList *symbols_list) {
+	ut32 count = read_u32(r);
+	if (r->error || count == BIN_CACHE_NONE) {
+		return NULL;
+	}
+	HtPP *imports = ht_pp_new0();
+	HtPP *symbols = ht_pp_new0();
+	RzList *list = rz_list_newf((RzListFree)rz_bin_reloc_free);
+	if (!imports || !symbols || !list) {
+		r->error = true;
+		goto beach;
+	}
+	RzListIter *it;
+	RzBinImport *imp;
+	rz_list_foreach (imports_list, it, imp) {
+		if (imp->name) {
+			ht_pp_insert(imports, imp->name, imp);
+		}
+	}
+	RzBinSymbol *sym;
+	rz_list_foreach (symbols_list, it, sym) {
+		if (sym->name) {
+			ht_pp_insert(symbols, sym->name, sym);
+		}
+	}
+	for (ut32 i = 0; i < count && !r->error; i++) {
+		RzBinReloc *reloc = RZ_NEW0(RzBinReloc);
+		if (!reloc || !rz_list_append(list, reloc)) {
+			free(reloc);
+			r->error = true;
+			break;
+		}
+		reloc->type = read_u32(r);
+		char *name = read_str(r);
+		reloc->import = name ? ht_pp_find(imports, name, NULL) : NULL;
+		free(name);
+		name = read_str(r);
+		reloc->symbol = name ? ht_pp_find(symbols, name, NULL) : NULL;
+		free(name);
+		reloc->addend = (st64)read_u64(r);
+		reloc->vaddr = read_u64(r);
+		reloc->paddr = read_u64(r);
+		reloc->target_vaddr = read_u64(r);
+		reloc->visibility = read_u32(r);
+		ut32 flags = read_u32(r);
+		reloc->additive = flags & 1;
+		reloc->is_ifunc = flags & 2;
+	}
+beach:
+	ht_pp_free(imports);
+	ht_pp_free(symbols);
+	return list;
+}
+
+/**
+ * \brief Load the items of \p o from the cache file at \p path
+ *
+ * \return false if there is no valid cache entry, in which case \p o is left untouched
+ */
+RZ_IPI bool rz_bin_cache_load(RZ_NONNULL RzBin *bin, RZ_NONNULL RzBinObject *o, RZ_NONNULL const char *path) {
+	rz_return_val_if_fail(bin && o && path, false);
+	size_t size;
+	char *buf = rz_file_slurp(path, &size);
+	if (!buf) {
+		return false;
+	}
+	CacheReader r = { bin, (const ut8 *)buf, size, 0, false };
+	const ut8 *magic = read_bytes(&r, 8);
+	if (!magic || memcmp(magic, BIN_CACHE_MAGIC, 8) || read_u32(&r) != BIN_CACHE_VERSION) {
+		free(buf);
+		return false;
+	}
+	RzList *sections = read_list(&r, read_section, (RzListFree)rz_bin_section_free);
+	RzList *symbols = read_list(&r, read_symbol, (RzListFree)rz_bin_symbol_free);
+	RzList *imports = read_list(&r, read_import, (RzListFree)rz_bin_import_free);
+	// relocs are resolved against the new lists
+	RzList *relocs = read_relocs(&r, imports, symbols);
+	RzList *strings = read_list(&r, read_string, rz_bin_string_free);
+	free(buf);
+	if (r.error || r.pos != r.size) {
+		rz_list_free(sections);
+		rz_list_free(symbols);
+		rz_list_free(imports);
+		rz_list_free(relocs);
+		rz_list_free(strings);
+		return false;
+	}
+	// some plugins already populate the sections when asked for the size
+	rz_list_free(o->sections);
+	o->sections = sections;
+	rz_list_free(o->symbols);
+	o->symbols = symbols;
+	rz_list_free(o->imports);
+	o->imports = imports;
+	rz_bin_reloc_storage_free(o->relocs);
+	o->relocs = relocs ? rz_bin_reloc_storage_new(relocs) : NULL;
+	rz_bin_string_database_free(o->strings);
+	o->strings = strings ? rz_bin_string_database_new(strings) : NULL;
+	return true;
+}
@@ -519,6 +519,8 @@ RZ_IPI void rz_bin_class_free(RzBinClass *k) {
 
 RZ_API RzBinClass *rz_bin_file_add_class(RzBinFile *bf, const char *name, const char *super, int view) {
 	rz_return_val_if_fail(name && bf && bf->o, NULL);
+	// make sure the classes of the plugin are there before adding to them
+	rz_bin_object_get_classes(bf->o);
 	RzBinClass *c = __getClass(bf, name);
 	if (c) {
 		if (super) {
@@ -7,24 +7,33 @@
 
 #define UTIL_STR_SCAN_OPT_BUFFER_SIZE 2048
 #define RAW_FILE_ALIGNMENT            0x10000
+// ranges are split in chunks of this size, so a single big section doesn't keep one thread busy alone
+#define STRING_SEARCH_CHUNK_SIZE 0x100000
+// bytes scanned past the end of a chunk, where the scan of the next chunk is expected to catch up
+#define STRING_SEARCH_CHUNK_OVERLAP (4 * UTIL_STR_SCAN_OPT_BUFFER_SIZE)
+// bytes probed one by one by two scans after which they are in the same state
+#define STRING_SEARCH_SYNC_GAP 17
 
 typedef struct search_interval_t {
 	ut64 paddr;
 	ut64 psize;
+	ut64 scan_end; ///< end of the scanned bytes, past paddr + psize by the overlap
+	ut64 range_end; ///< end of the range the interval was split from
+	bool first; ///< the interval starts a new range
+	RzList /*<RzBinString *>*/ *results; ///< strings found between paddr and scan_end
 } SearchInterval;
 
 typedef struct shared_data_t {
 	RzThreadLock *lock;
 	RzBinFile *bf;
-	HtUP *strings_db;
-} SharedData;
-
-typedef struct search_thread_data_t {
-	RzThreadQueue *intervals;
-	RzList *results;
+	ut64 boffset;
 	size_t min_length;
 	RzStrEnc encoding;
 	bool check_ascii_freq;
+} SharedData;
+
+typedef struct search_thread_data_t {
+	RzThreadRing *intervals;
 	SharedData *shared;
 	RzAtomicBool *loop;
 } SearchThreadData;
@@ -36,11 +45,58 @@ static st64 shared_data_read_at(SharedData *sd, ut64 addr, ut8 *buf, ut64 size)
 	return ret;
 }
 
-static bool shared_ht_up_insert(SharedData *sd, const ut64 key, void *value) {
+/**
+ * Returns the \p size bytes at \p addr, borrowed from the buffer whenever
+ * possible, otherwise copied into a new buffer stored in \p copy.
+ */
+static const ut8 *shared_data_get_at(SharedData *sd, ut64 addr, ut64 size, ut8 **copy) {
+	*copy = NULL;
+	ut64 len = size;
 	rz_th_lock_enter(sd->lock);
-	bool ret = ht_up_insert(sd->strings_db, key, value);
+	const ut8 *data = rz_buf_borrow_at(sd->bf->buf, addr, &len);
 	rz_th_lock_leave(sd->lock);
-	return ret;
+	if (data && len >= size) {
+		return data;
+	}
+	*copy = calloc(size, 1);
+	if (!*copy) {
+		return NULL;
+	}
+	shared_data_read_at(sd, addr, *copy, size);
+	return *copy;
+}
+
+static void search_interval_free(SearchInterval *itv) {
+	if (!itv) {
+		return;
+	}
+	rz_list_free(itv->results);
+	free(itv);
+}
+
+/**
+ * Splits [paddr, paddr + psize) in chunks of STRING_SEARCH_CHUNK_SIZE bytes appended to \p chunks.
+ */
+static bool push_search_range(RzPVector /*<SearchInterval *>*/ *chunks, ut64 paddr, ut64 psize) {
+	ut64 range_end = paddr + psize;
+	for (ut64 from = paddr; from < range_end; from += STRING_SEARCH_CHUNK_SIZE) {
+		SearchInterval *itv = RZ_NEW0(SearchInterval);
+		if (!itv) {
+			RZ_LOG_ERROR("bin_file_strings: cannot allocate SearchInterval.\n");
+			return false;
+		}
+		itv->paddr = from;
+		itv->psize = RZ_MIN(STRING_SEARCH_CHUNK_SIZE, range_end - from);
+		itv->scan_end = RZ_MIN(from + itv->psize + STRING_SEARCH_CHUNK_OVERLAP, range_end);
+		itv->range_end = range_end;
+		itv->first = from == paddr;
+		if (!rz_pvector_push(chunks, itv)) {
+			free(itv);
+			RZ_LOG_ERROR("bin_file_strings: cannot append SearchInterval to list.\n");
+			return false;
+		}
+	}
+	return true;
 }
 
 static bool is_data_section(RzBinFile *a, RzBinSection *s) {
@@ -73,80 +129,72 @@ static RzBinString *to_bin_string(RzDetectedString *src) {
 	return dst;
 }
 
-static RzList *string_scan_range(SearchThreadData *std, const ut64 paddr, const ut64 size) {
-	RzList *found = rz_list_newf((RzListFree)free);
-	if (!found) {
+static RzList *string_scan_range(SharedData *sd, const ut64 paddr, const ut64 size) {
+	RzList *results = rz_list_newf(rz_bin_string_free);
+	RzList *found = rz_list_newf((RzListFree)rz_detected_string_free);
+	if (!results || !found) {
+		rz_list_free(results);
+		rz_list_free(found);
 		return NULL;
 	}
 
 	RzUtilStrScanOptions scan_opt = {
 		.buf_size = UTIL_STR_SCAN_OPT_BUFFER_SIZE,
 		.max_uni_blocks = 4,
-		.min_str_length = std->min_length,
+		.min_str_length = sd->min_length,
 		.prefer_big_endian = false,
-		.check_ascii_freq = std->check_ascii_freq,
+		.check_ascii_freq = sd->check_ascii_freq,
 	};
 
-	ut8 *buf = calloc(size, 1);
+	ut8 *copy = NULL;
+	const ut8 *buf = shared_data_get_at(sd, paddr, size, &copy);
 	if (!buf) {
 		RZ_LOG_ERROR("bin_file_strings: cannot allocate string seac buffer.\n");
+		rz_list_free(results);
+		rz_list_free(found);
 		return NULL;
 	}
 
-	shared_data_read_at(std->shared, paddr, buf, size);
-
 	ut64 end = paddr + size;
-	int count = rz_scan_strings_raw(buf, found, &scan_opt, paddr, end, std->encoding);
-	free(buf);
+	rz_scan_strings_raw(buf, found, &scan_opt, paddr, end, sd->encoding);
+	free(copy);
+
+	RzBinFile *bf = sd->bf; // this data is always RO
+	RzDetectedString *detected = NULL;
+	while ((detected = rz_list_pop_head(found))) {
+		RzBinString *bstr = to_bin_string(detected);
+		if (!bstr || !rz_list_append(results, bstr)) {
+			rz_bin_string_free(bstr);
+			RZ_FREE_CUSTOM(results, rz_list_free);
+			break;
+		} else if (!bf->o) {
+			continue;
+		}
 
-	if (count <= 0) {
-		RZ_FREE_CUSTOM(found, rz_list_free);
+		// find virt address.
+		bstr->paddr += sd->boffset;
+		bstr->vaddr = rz_bin_object_p2v(bf->o, bstr->paddr);
 	}
-	return found;
+	rz_list_free(found);
+	return results;
 }
 
 static void *search_string_thread_runner(SearchThreadData *std) {
 	SearchInterval *itv = NULL;
-	RzDetectedString *detected = NULL;
-	ut64 paddr = 0, psize = 0;
-	bool loop = true;
-	RzBinFile *bf = std->shared->bf; // this data is always RO
 
-	do {
-		itv = rz_th_queue_pop(std->intervals, false);
+	while (rz_atomic_bool_get(std->loop)) {
+		// the ring is shared, so a thread done with its chunk just takes the next one
+		itv = rz_th_ring_pop(std->intervals);
 		if (!itv) {
 			break;
 		}
-		paddr = itv->paddr;
-		psize = itv->psize;
-		free(itv);
-		RZ_LOG_DEBUG("[%p] searching between [0x%08" PFMT64x " : 0x%08" PFMT64x "]\n", std, paddr, paddr + psize);
-
-		RzList *list = string_scan_range(std, paddr, psize);
-		while (list && rz_atomic_bool_get(std->loop)) {
-			detected = rz_list_pop_head(list);
-			if (!detected) {
-				break;
-			}
-
-			RzBinString *bstr = to_bin_string(detected);
-			if (!bstr || !rz_list_append(std->results, bstr)) {
-				rz_bin_string_free(bstr);
-				loop = false;
-				break;
-			} else if (!bf->o) {
-				continue;
-			}
-
-			// find virt address.
-			bstr->paddr += bf->o->boffset;
-			bstr->vaddr = rz_bin_object_p2v(bf->o, bstr->paddr);
+		RZ_LOG_DEBUG("[%p] searching between [0x%08" PFMT64x " : 0x%08" PFMT64x "]\n", std, itv->paddr, itv->paddr + itv->psize);
 
-			shared_ht_up_insert(std->shared, bstr->vaddr, bstr);
+		itv->results = string_scan_range(std->shared, itv->paddr, itv->scan_end - itv->paddr);
+		if (!itv->results) {
+			break;
 		}
-
-		rz_list_free(list);
-	} while (loop && rz_atomic_bool_get(std->loop));
+	}
 
 	RZ_LOG_DEBUG("[%p] died\n", std);
 	return NULL;
@@ -156,7 +204,6 @@ static void bin_file_string_search_free(SearchThreadData *std) {
 	if (!std) {
 		return;
 	}
-	rz_list_free(std->results);
 	rz_atomic_bool_free(std->loop);
 	free(std);
 }
@@ -178,36 +225,15 @@ static void interrupt_pool(RzThreadPool *pool) {
 	}
 }
 
-static bool create_string_search_thread(RzThreadPool *pool, size_t min_length, RzThreadQueue *intervals, SharedData *shared) {
-	RzStrEnc encoding = RZ_STRING_ENC_GUESS;
-	RzBinPlugin *plugin = rz_bin_file_cur_plugin(shared->bf);
-	bool check_ascii_freq = false;
-
-	if (!min_length) {
-		min_length = plugin && plugin->minstrlen > 0 ? plugin->minstrlen : 4;
-	}
-
-	if (shared->bf->rbin) {
-		encoding = rz_str_enc_string_as_type(shared->bf->rbin->strenc);
-		check_ascii_freq = shared->bf->rbin->strseach_check_ascii_freq;
-	}
-
+static bool create_string_search_thread(RzThreadPool *pool, RzThreadRing *intervals, SharedData *shared) {
 	SearchThreadData *std = RZ_NEW0(SearchThreadData);
 	if (!std) {
 		RZ_LOG_ERROR("bin_file_strings: cannot allocate SearchThreadData.\n");
 		return false;
 	}
 
-	std->results = rz_list_newf(rz_bin_string_free);
-	if (!std->results) {
-		bin_file_string_search_free(std);
-		return false;
-	}
 	std->shared = shared;
-	std->check_ascii_freq = check_ascii_freq;
-	std->encoding = encoding;
 	std->intervals = intervals;
-	std->min_length = min_length;
 	std->loop = rz_atomic_bool_new(true);
 
 	RzThread *thread = rz_th_new((RzThreadFunction)search_string_thread_runner, std);
@@ -225,6 +251,122 @@ static bool create_string_search_thread(RzThreadPool *pool, size_t min_length, R
 	return true;
 }
 
+static ut64 string_start(const SharedData *sd, const RzBinString *bstr) {
+	return bstr->paddr - sd->boffset;
+}
+
+static ut64 string_end(const SharedData *sd, const RzBinString *bstr) {
+	return bstr->paddr - sd->boffset + bstr->size;
+}
+
+/**
+ * Moves \p it past the strings which may have been probed at or before \p addr
+ * (the scanner can move the start of a string back by a few bytes) and
+ * returns the end of the bytes they cover, where the scan resumed.
+ */
+static ut64 strings_covered_end(const SharedData *sd, RzListIter **it, ut64 addr, ut64 end) {
+	for (; *it; *it = rz_list_iter_get_next(*it)) {
+		const RzBinString *bstr = rz_list_iter_get_data(*it);
+		ut64 start = string_start(sd, bstr);
+		if ((start < 3 ? 0 : start - 3) > addr) {
+			break;
+		}
+		end = RZ_MAX(end, string_end(sd, bstr));
+	}
+	return end;
+}
+
+/**
+ * \brief Finds where the scan of a chunk, started in the middle of the range,
+ * is in the same state as the scan of the previous chunk which ran past it.
+ *
+ * This is either the first string found by both with the same size, or the
+ * first byte after STRING_SEARCH_SYNC_GAP bytes probed one by one by both.
+ * Only the strings of \p prev ending before \p reliable_end are considered,
+ * the scan of the previous chunk may have cut the ones reaching its end.
+ *
+ * \return the address, UT64_MAX if there is none within the overlap
+ */
+static ut64 find_sync_addr(const SharedData *sd, const RzList *prev, const RzList *cur, ut64 start, ut64 reliable_end) {
+	ut64 common = UT64_MAX;
+	RzListIter *it_p, *it_c;
+	RzBinString *bp, *bc;
+	rz_list_foreach (prev, it_p, bp) {
+		if (string_end(sd, bp) >= reliable_end) {
+			break;
+		}
+		rz_list_foreach (cur, it_c, bc) {
+			if (bc->paddr > bp->paddr) {
+				break;
+			} else if (bc->paddr == bp->paddr && bc->size == bp->size) {
+				common = string_start(sd, bp);
+				break;
+			}
+		}
+		if (common != UT64_MAX) {
+			break;
+		}
+	}
+
+	it_p = rz_list_iterator(prev);
+	it_c = rz_list_iterator(cur);
+	ut64 addr = start, gap_start = start, covered = 0;
+	while (addr < reliable_end && addr < common) {
+		covered = strings_covered_end(sd, &it_p, addr, covered);
+		covered = strings_covered_end(sd, &it_c, addr, covered);
+		if (covered > addr) {
+			addr = gap_start = covered;
+			continue;
+		} else if (addr - gap_start + 1 >= STRING_SEARCH_SYNC_GAP) {
+			return addr;
+		}
+		addr++;
+	}
+	return common;
+}
+
+/**
+ * \brief Appends to \p results the strings of \p itv the scan of the whole range would have found
+ *
+ * The strings of the previous chunk \p prev found past its end are taken
+ * until the scan of \p itv catches up with them, when it doesn't, the
+ * chunk is scanned once more from where the previous strings ended.
+ * \p resume tracks where the scan of the whole range would continue.
+ */
+static bool merge_interval_results(SharedData *sd, RzList *results, SearchInterval *prev, SearchInterval *itv, ut64 *resume) {
+	RzBinString *bstr;
+	if (itv->first) {
+		*resume = itv->paddr;
+	} else if (prev->results) {
+		ut64 reliable_end = prev->scan_end < prev->range_end ? prev->scan_end : UT64_MAX;
+		ut64 sync = itv->results ? find_sync_addr(sd, prev->results, itv->results, itv->paddr, reliable_end) : UT64_MAX;
+		while ((bstr = rz_list_first(prev->results)) && string_start(sd, bstr) < sync &&
+			(sync != UT64_MAX || string_end(sd, bstr) < reliable_end)) {
+			*resume = string_end(sd, bstr);
+			rz_list_append(results, rz_list_pop_head(prev->results));
+		}
+		if (sync == UT64_MAX) {
+			RZ_LOG_DEBUG("bin_file_strings: rescanning [0x%08" PFMT64x " : 0x%08" PFMT64x "]\n", *resume, itv->scan_end);
+			rz_list_free(itv->results);
+			itv->results = *resume < itv->scan_end ? string_scan_range(sd, *resume, itv->scan_end - *resume) : rz_list_newf(rz_bin_string_free);
+		} else {
+			while ((bstr = rz_list_first(itv->results)) && string_start(sd, bstr) < sync) {
+				rz_bin_string_free(rz_list_pop_head(itv->results));
+			}
+		}
+	}
+	if (!itv->results) {
+		return false;
+	}
+	// the rest is merged with the next chunk
+	ut64 end = itv->paddr + itv->psize;
+	while ((bstr = rz_list_first(itv->results)) && string_start(sd, bstr) < end) {
+		*resume = string_end(sd, bstr);
+		rz_list_append(results, rz_list_pop_head(itv->results));
+	}
+	return true;
+}
+
 static int string_compare_sort(const RzBinString *a, const RzBinString *b) {
 	if (b->paddr > a->paddr) {
 		return -1;
@@ -327,7 +469,8 @@ RZ_API RZ_OWN RzList *rz_bin_file_strings(RZ_NONNULL RzBinFile *bf, size_t min_l
 
 	HtUP *strings_db = NULL;
 	RzList *results = NULL;
-	RzThreadQueue *intervals = NULL;
+	RzPVector *chunks = NULL;
+	RzThreadRing *intervals = NULL;
 	RzThreadPool *pool = NULL;
 	RzThreadLock *lock = NULL;
 	ut64 max_interval = 0;
@@ -354,15 +497,9 @@ RZ_API RZ_OWN RzList *rz_bin_file_strings(RZ_NONNULL RzBinFile *bf, size_t min_l
 		goto fail;
 	}
 
-	intervals = rz_th_queue_new(RZ_THREAD_QUEUE_UNLIMITED, (RzListFree)free);
-	if (!intervals) {
-		RZ_LOG_ERROR("bin_file_strings: cannot allocate intervals queue.\n");
-		goto fail;
-	}
-
-	strings_db = ht_up_new0();
-	if (!strings_db) {
-		RZ_LOG_ERROR("bin_file_strings: cannot allocate string map.\n");
+	chunks = rz_pvector_new((RzPVectorFree)search_interval_free);
+	if (!chunks) {
+		RZ_LOG_ERROR("bin_file_strings: cannot allocate intervals list.\n");
 		goto fail;
 	}
 
@@ -384,24 +521,8 @@ RZ_API RZ_OWN RzList *rz_bin_file_strings(RZ_NONNULL RzBinFile *bf, size_t min_l
 			goto fail;
 		}
 
-		for (ut64 from = 0; from < bf->size; from += section_size) {
-			SearchInterval *itv = RZ_NEW0(SearchInterval);
-			if (!itv) {
-				RZ_LOG_ERROR("bin_file_strings: cannot allocate SearchInterval.\n");
-				goto fail;
-			}
-
-			itv->paddr = from;
-			itv->psize = section_size;
-			if ((itv->paddr + itv->psize) > bf->size) {
-				itv->psize = bf->size - itv->paddr;
-			}
-
-			if (!rz_th_queue_push(intervals, itv, true)) {
-				free(itv);
-				RZ_LOG_ERROR("bin_file_strings: cannot append SearchInterval to list.\n");
-				goto fail;
-			}
+		if (!push_search_range(chunks, 0, bf->size)) {
+			goto fail;
 		}
 	} else if (bf->o && !rz_list_empty(bf->o->sections)) {
 		// returns only the strings found on the RzBinFile but within the data section
@@ -422,35 +543,40 @@ RZ_API RZ_OWN RzList *rz_bin_file_strings(RZ_NONNULL RzBinFile *bf, size_t min_l
 				continue;
 			}
 
-			SearchInterval *itv = RZ_NEW0(SearchInterval);
-			if (!itv) {
-				RZ_LOG_ERROR("bin_file_strings: cannot allocate SearchInterval.\n");
-				goto fail;
-			}
-
-			itv->paddr = section->paddr;
-			itv->psize = section->size;
-			if ((itv->paddr + itv->psize) > bf->size) {
-				itv->psize = bf->size - itv->paddr;
-			}
-
-			if (!rz_th_queue_push(intervals, itv, true)) {
-				free(itv);
-				RZ_LOG_ERROR("bin_file_strings: cannot append SearchInterval to list.\n");
+			ut64 psize = RZ_MIN(section->size, bf->size - section->paddr);
+			if (!push_search_range(chunks, section->paddr, psize)) {
 				goto fail;
 			}
 		}
 	}
 
+	// the ring only borrows the intervals, they are owned by chunks
+	intervals = rz_th_ring_new(RZ_MAX(rz_pvector_len(chunks), 1), NULL);
+	if (!intervals) {
+		RZ_LOG_ERROR("bin_file_strings: cannot allocate intervals queue.\n");
+		goto fail;
+	}
+	void **it;
+	rz_pvector_foreach (chunks, it) {
+		rz_th_ring_push(intervals, *it);
+	}
+
 	SharedData shared = {
 		.lock = lock,
 		.bf = bf,
-		.strings_db = strings_db,
+		.boffset = bf->o ? bf->o->boffset : 0,
+		.min_length = min_length,
+		.encoding = RZ_STRING_ENC_GUESS,
+		.check_ascii_freq = false,
 	};
+	if (bf->rbin) {
+		shared.encoding = rz_str_enc_string_as_type(bf->rbin->strenc);
+		shared.check_ascii_freq = bf->rbin->strseach_check_ascii_freq;
+	}
 
 	RZ_LOG_VERBOSE("bin_file_strings: using %u threads\n", (ut32)pool_size);
 	for (size_t i = 0; i < pool_size; ++i) {
-		if (!create_string_search_thread(pool, min_length, intervals, &shared)) {
+		if (!create_string_search_thread(pool, intervals, &shared)) {
 			interrupt_pool(pool);
 			goto fail;
 		}
@@ -464,18 +590,30 @@ RZ_API RZ_OWN RzList *rz_bin_file_strings(RZ_NONNULL RzBinFile *bf, size_t min_l
 		goto fail;
 	}
 
-	for (ut32 i = 0; i < pool_size; ++i) {
-		RzThread *th = rz_th_pool_get_thread(pool, i);
-		if (!th) {
-			continue;
-		}
-		SearchThreadData *std = (SearchThreadData *)rz_th_get_user(th);
-		if (std) {
-			rz_list_join(results, std->results);
+	ut64 resume = 0;
+	SearchInterval *prev = NULL;
+	rz_pvector_foreach (chunks, it) {
+		SearchInterval *itv = *it;
+		if (!merge_interval_results(&shared, results, prev, itv, &resume)) {
+			RZ_LOG_ERROR("bin_file_strings: cannot search strings in [0x%08" PFMT64x " : 0x%08" PFMT64x "].\n",
+				itv->paddr, itv->paddr + itv->psize);
 		}
+		prev = itv;
 	}
 
 	if (!raw_strings) {
+		// built only now, since the threads would have had to lock it for every string
+		strings_db = ht_up_new0();
+		if (!strings_db) {
+			RZ_LOG_ERROR("bin_file_strings: cannot allocate string map.\n");
+			RZ_FREE_CUSTOM(results, rz_list_free);
+			goto fail;
+		}
+		RzListIter *iter;
+		RzBinString *bstr;
+		rz_list_foreach (results, iter, bstr) {
+			ht_up_insert(strings_db, bstr->vaddr, bstr);
+		}
 		scan_cfstring_table(bf, strings_db, results, max_interval);
 	}
 	rz_list_sort(results, (RzListComparator)string_compare_sort);
@@ -504,6 +642,7 @@ fail:
 	}
 	ht_up_free(strings_db);
 	rz_th_lock_free(lock);
-	rz_th_queue_free(intervals);
+	rz_th_ring_free(intervals);
+	rz_pvector_free(chunks);
 	return results;
 }
@@ -147,6 +147,7 @@ RZ_API RzBinImport *rz_bin_import_clone(RzBinImport *o) {
 
 RZ_API void rz_bin_import_free(RzBinImport *imp) {
 	if (imp) {
+		RZ_MEM_UNTRACK(imp);
 		RZ_FREE(imp->name);
 		RZ_FREE(imp->libname);
 		RZ_FREE(imp->classname);
@@ -188,6 +189,7 @@ RZ_API void rz_bin_symbol_free(RzBinSymbol *sym) {
 		return;
 	}
 
+	RZ_MEM_UNTRACK(sym);
 	free(sym->name);
 	free(sym->dname);
 	free(sym->libname);
@@ -203,6 +205,7 @@ RZ_API void rz_bin_reloc_free(RzBinReloc *reloc) {
 RZ_API void rz_bin_string_free(void *_str) {
 	RzBinString *str = (RzBinString *)_str;
 	if (str) {
+		RZ_MEM_UNTRACK(str);
 		free(str->string);
 		free(str);
 	}
@@ -248,6 +251,7 @@ RZ_API RzBinFile *rz_bin_reload(RzBin *bin, RzBinFile *bf, ut64 baseaddr) {
 
 RZ_API RzBinFile *rz_bin_open_buf(RzBin *bin, RzBuffer *buf, RzBinOptions *opt) {
 	rz_return_val_if_fail(bin && opt, NULL);
+	RZ_TRACE_BEGIN("bin", opt->filename ? opt->filename : "");
 
 	RzListIter *it;
 	RzBinXtrPlugin *xtr;
@@ -283,11 +287,13 @@ RZ_API RzBinFile *rz_bin_open_buf(RzBin *bin, RzBuffer *buf, RzBinOptions *opt)
 		bf = rz_bin_file_new_from_buffer(bin, bin->file, buf,
 			&opt->obj_opts, opt->fd, opt->pluginname);
 		if (!bf) {
+			RZ_TRACE_END("bin");
 			return NULL;
 		}
 	}
 	rz_bin_file_set_cur_binfile(bin, bf);
 	rz_id_storage_set(bin->ids, bin->cur, bf->id);
+	RZ_TRACE_END("bin");
 	return bf;
 }
 
@@ -357,17 +363,37 @@ RZ_IPI RzBinPlugin *rz_bin_get_binplugin_by_name(RzBin *bin, const char *name) {
 	return NULL;
 }
 
+static bool magics_match(const RzBinMagic *magics, const ut8 *head, size_t head_size) {
+	for (; magics->size; magics++) {
+		if (magics->size <= head_size && !memcmp(head, magics->bytes, magics->size)) {
+			return true;
+		}
+	}
+	return false;
+}
+
 RZ_API RzBinPlugin *rz_bin_get_binplugin_by_buffer(RzBin *bin, RzBuffer *buf) {
 	RzBinPlugin *plugin;
 	RzListIter *it;
 
 	rz_return_val_if_fail(bin && buf, NULL);
 
+	// The head is read once, so that the plugins declaring their magic bytes
+	// are not probed at all when the buffer cannot be of their format.
+	ut8 head[RZ_BIN_MAGIC_MAX];
+	st64 head_size = rz_buf_read_at(buf, 0, head, sizeof(head));
+	if (head_size < 0) {
+		head_size = 0;
+	}
 	rz_list_foreach (bin->plugins, it, plugin) {
-		if (plugin->check_buffer) {
-			if (plugin->check_buffer(buf)) {
-				return plugin;
-			}
+		if (!plugin->check_buffer) {
+			continue;
+		}
+		if (plugin->magics && !magics_match(plugin->magics, head, head_size)) {
+			continue;
+		}
+		if (plugin->check_buffer(buf)) {
+			return plugin;
 		}
 	}
 	return NULL;
@@ -475,6 +501,7 @@ RZ_API void rz_bin_free(RzBin *bin) {
 	free(bin->force);
 	free(bin->srcdir);
 	free(bin->strenc);
+	free(bin->cache_dir);
 	// rz_bin_free_bin_files (bin);
 	rz_list_free(bin->binfiles);
 	rz_list_free(bin->binxtrs);
@@ -931,7 +958,7 @@ RZ_API RzBuffer *rz_bin_create(RzBin *bin, const char *p,
 RZ_API RzList * /*<RzBinClass>*/ rz_bin_get_classes(RzBin *bin) {
 	rz_return_val_if_fail(bin, NULL);
 	RzBinObject *o = rz_bin_cur_object(bin);
-	return o ? o->classes : NULL;
+	return o ? (RzList *)rz_bin_object_get_classes(o) : NULL;
 }
 
 RZ_API ut64 rz_bin_get_size(RzBin *bin) {
@@ -1163,6 +1190,7 @@ RZ_IPI RzBinSection *rz_bin_section_new(const char *name) {
 
 RZ_IPI void rz_bin_section_free(RzBinSection *bs) {
 	if (bs) {
+		RZ_MEM_UNTRACK(bs);
 		free(bs->name);
 		free(bs->format);
 		free(bs);
@@ -1290,10 +1318,18 @@ RZ_API const RzBinLdrPlugin *rz_bin_ldrplugin_get(RzBin *bin, const char *name)
 	return NULL;
 }
 
+static char *demangle_cached(RzBinFile *bf, const char *language, const char *symbol, RzDemanglerHandler handler) {
+	RzBin *bin = bf ? bf->rbin : NULL;
+	if (!bin || !bin->demangler) {
+		return handler(symbol);
+	}
+	return rz_demangler_resolve_cached(bin->demangler, symbol, language, handler);
+}
+
 #if WITH_GPL
-static char *bin_demangle_cxx(RzBinFile *bf, const char *symbol, ut64 vaddr) {
-	char *out = rz_demangler_cxx(symbol);
-	if (!out || !bf) {
+static char *bin_demangle_cxx(RzBinFile *bf, const char *symbol, ut64 vaddr, bool add_methods) {
+	char *out = demangle_cached(bf, "c++", symbol, rz_demangler_cxx);
+	if (!out || !bf || !add_methods) {
 		return out;
 	}
 	char *sign = (char *)strchr(out, '(');
@@ -1331,35 +1367,30 @@ static char *bin_demangle_cxx(RzBinFile *bf, const char *symbol, ut64 vaddr) {
 	return out;
 }
 
-static char *bin_demangle_rust(RzBinFile *binfile, const char *symbol, ut64 vaddr) {
+static char *bin_demangle_rust(RzBinFile *binfile, const char *symbol, ut64 vaddr, bool add_methods) {
 	char *str = NULL;
-	if (!(str = bin_demangle_cxx(binfile, symbol, vaddr))) {
+	if (!(str = bin_demangle_cxx(binfile, symbol, vaddr, add_methods))) {
 		return str;
 	}
 	free(str);
-	return rz_demangler_rust(symbol);
+	return demangle_cached(binfile, "rust", symbol, rz_demangler_rust);
 }
 #endif
 
+typedef struct {
+	const char *symbol; ///< the symbol without the prefixes added by rizin and the library name
+	const char *language;
+	const char *lib; ///< library the symbol belongs to, or NULL
+	RzBinLanguage type;
+} DemangleRequest;
+
 /**
- * \brief Demangles a symbol based on the language or the RzBinFile data
- *
- * This function demangles a symbol based on the language or the RzBinFile data
- * When C++ or rust is selected as the language, it will add methods into the
- * RzBinFile structure based on the demangled symbol.
- * When libs is set to true, the demangled symbol will be appended to the
- * library name <libname>_<demangled symbol>.
- *
- * \param bf RzBinFile data to be used for demangling
- * \param language Language to be used for demanglind
- * \param symbol Symbol to be demangled
- * \param vaddr vaddr of the \p symbol to be demangled
- * \param libs Append the library name to the demangled symbol, if set to true
- * \return char* Demangled name of the \p symbol
+ * Strip \p symbol of everything that is not part of the mangled name and find its language
+ * \return false if there is nothing to demangle
  */
-RZ_API RZ_OWN char *rz_bin_demangle(RZ_NULLABLE RzBinFile *bf, RZ_NULLABLE const char *language, RZ_NULLABLE const char *symbol, ut64 vaddr, bool libs) {
+static bool demangle_prepare(RzBinFile *bf, const char *language, const char *symbol, DemangleRequest *req) {
 	if (RZ_STR_ISEMPTY(symbol)) {
-		return NULL;
+		return false;
 	}
 
 	RzBinLanguage type = RZ_BIN_LANGUAGE_UNKNOWN;
@@ -1411,7 +1442,7 @@ RZ_API RZ_OWN char *rz_bin_demangle(RZ_NULLABLE RzBinFile *bf, RZ_NULLABLE const
 	}
 
 	if (RZ_STR_ISEMPTY(symbol)) {
-		return NULL;
+		return false;
 	}
 
 	if (!strncmp(symbol, "__", 2)) {
@@ -1429,10 +1460,20 @@ RZ_API RZ_OWN char *rz_bin_demangle(RZ_NULLABLE RzBinFile *bf, RZ_NULLABLE const
 		language = rz_bin_language_to_string(type);
 	}
 	if (!language) {
-		return NULL;
+		return false;
 	}
+	req->symbol = symbol;
+	req->language = language;
+	req->lib = lib;
+	req->type = type;
+	return true;
+}
+
+static char *demangle_request(RzBinFile *bf, const DemangleRequest *req, ut64 vaddr, bool add_methods) {
+	RzBin *bin = bf ? bf->rbin : NULL;
+	const char *symbol = req->symbol;
 	char *demangled = NULL;
-	switch (type) {
+	switch (req->type) {
 	case RZ_BIN_LANGUAGE_UNKNOWN: return NULL;
 	case RZ_BIN_LANGUAGE_KOTLIN:
 		/* fall-thru */
@@ -1440,22 +1481,89 @@ RZ_API RZ_OWN char *rz_bin_demangle(RZ_NULLABLE RzBinFile *bf, RZ_NULLABLE const
 		/* fall-thru */
 	case RZ_BIN_LANGUAGE_DART:
 		/* fall-thru */
-	case RZ_BIN_LANGUAGE_JAVA: demangled = rz_demangler_java(symbol); break;
-	case RZ_BIN_LANGUAGE_OBJC: demangled = rz_demangler_objc(symbol); break;
-	case RZ_BIN_LANGUAGE_MSVC: demangled = rz_demangler_msvc(symbol); break;
+	case RZ_BIN_LANGUAGE_JAVA: demangled = demangle_cached(bf, "java", symbol, rz_demangler_java); break;
+	case RZ_BIN_LANGUAGE_OBJC: demangled = demangle_cached(bf, "objc", symbol, rz_demangler_objc); break;
+	case RZ_BIN_LANGUAGE_MSVC: demangled = demangle_cached(bf, "msvc", symbol, rz_demangler_msvc); break;
 #if WITH_GPL
-	case RZ_BIN_LANGUAGE_RUST: demangled = bin_demangle_rust(bf, symbol, vaddr); break;
-	case RZ_BIN_LANGUAGE_CXX: demangled = bin_demangle_cxx(bf, symbol, vaddr); break;
+	case RZ_BIN_LANGUAGE_RUST: demangled = bin_demangle_rust(bf, symbol, vaddr, add_methods); break;
+	case RZ_BIN_LANGUAGE_CXX: demangled = bin_demangle_cxx(bf, symbol, vaddr, add_methods); break;
 #else
 	case RZ_BIN_LANGUAGE_RUST: demangled = NULL; break;
 	case RZ_BIN_LANGUAGE_CXX: demangled = NULL; break;
 #endif
-	default: rz_demangler_resolve(bin->demangler, symbol, language, &demangled);
+	default:
+		if (bin) {
+			rz_demangler_resolve(bin->demangler, symbol, req->language, &demangled);
+		}
+	}
+	return demangled;
+}
+
+/**
+ * \brief Demangles a symbol based on the language or the RzBinFile data
+ *
+ * This function demangles a symbol based on the language or the RzBinFile data
+ * When C++ or rust is selected as the language, it will add methods into the
+ * RzBinFile structure based on the demangled symbol.
+ * When libs is set to true, the demangled symbol will be appended to the
+ * library name <libname>_<demangled symbol>.
+ *
+ * \param bf RzBinFile data to be used for demangling
+ * \param language Language to be used for demanglind
+ * \param symbol Symbol to be demangled
+ * \param vaddr vaddr of the \p symbol to be demangled
+ * \param libs Append the library name to the demangled symbol, if set to true
+ * \return char* Demangled name of the \p symbol
+ */
+RZ_API RZ_OWN char *rz_bin_demangle(RZ_NULLABLE RzBinFile *bf, RZ_NULLABLE const char *language, RZ_NULLABLE const char *symbol, ut64 vaddr, bool libs) {
+	DemangleRequest req;
+	if (!demangle_prepare(bf, language, symbol, &req)) {
+		return NULL;
 	}
-	if (libs && demangled && lib) {
-		char *d = rz_str_newf("%s_%s", lib, demangled);
+	char *demangled = demangle_request(bf, &req, vaddr, true);
+	if (libs && demangled && req.lib) {
+		char *d = rz_str_newf("%s_%s", req.lib, demangled);
 		free(demangled);
 		demangled = d;
 	}
 	return demangled;
 }
+
+typedef struct {
+	RzBinFile *bf;
+	const char *language;
+	const char **symbols;
+} DemangleBatchCtx;
+
+static void demangle_batch_range(size_t from, size_t to, void *user) {
+	DemangleBatchCtx *ctx = user;
+	for (size_t i = from; i < to; i++) {
+		DemangleRequest req;
+		if (demangle_prepare(ctx->bf, ctx->language, ctx->symbols[i], &req)) {
+			free(demangle_request(ctx->bf, &req, 0, false));
+		}
+	}
+}
+
+/**
+ * \brief Demangles many symbols at once, so the next rz_bin_demangle() calls for them find their results in the cache
+ *
+ * The demangling work is split among the workers of \p pool. The other effects of
+ * rz_bin_demangle(), like adding C++ methods to \p bf, still happen when it is called.
+ *
+ * \param bf RzBinFile the symbols belong to
+ * \param language Language to be used for demangling, like for rz_bin_demangle()
+ * \param symbols Symbols to be demangled, exactly as they will be passed to rz_bin_demangle()
+ * \param count Number of symbols
+ * \param pool Pool doing the work, NULL to demangle everything in the calling thread
+ */
+RZ_API void rz_bin_demangle_batch(RZ_NONNULL RzBinFile *bf, RZ_NULLABLE const char *language, RZ_NONNULL const char **symbols, size_t count, RZ_NULLABLE RzThreadTaskPool *pool) {
+	rz_return_if_fail(bf && symbols);
+	if (!bf->rbin || !bf->rbin->demangler || !bf->rbin->demangler->cache_size) {
+		return;
+	}
+	DemangleBatchCtx ctx = { .bf = bf, .language = language, .symbols = symbols };
+	if (!pool || !rz_th_task_pool_parallel_for(pool, 0, count, 64, demangle_batch_range, &ctx)) {
+		demangle_batch_range(0, count, &ctx);
+	}
+}
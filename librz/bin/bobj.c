@@ -102,6 +102,54 @@ static int reloc_target_cmp(const void *a, const void *b) {
 
 #undef CMP_CHECK
 
+static bool page_index_build(RzBinRelocPageIndex *index, const ut64 *addrs, size_t count) {
+	memset(index, 0, sizeof(*index));
+	if (!count) {
+		return true;
+	}
+	index->base = addrs[0];
+	ut64 range = addrs[count - 1] - index->base;
+	// start with the usual page size and grow it until there are no more pages than addresses
+	index->shift = 12;
+	while (index->shift < 63 && (range >> index->shift) >= count) {
+		index->shift++;
+	}
+	index->count = (size_t)(range >> index->shift) + 1;
+	index->first = RZ_NEWS(size_t, index->count + 1);
+	if (!index->first) {
+		return false;
+	}
+	size_t j = 0;
+	for (size_t p = 0; p < index->count; p++) {
+		ut64 start = index->base + ((ut64)p << index->shift);
+		while (j < count && addrs[j] < start) {
+			j++;
+		}
+		index->first[p] = j;
+	}
+	index->first[index->count] = count;
+	return true;
+}
+
+#define ADDR_CMP(x, y) RZ_NUM_CMP(x, y)
+
+/// Index of the first address >= addr, or count if there is none
+static size_t page_index_lower_bound(const RzBinRelocPageIndex *index, const ut64 *addrs, size_t count, ut64 addr) {
+	if (!count || addr <= index->base) {
+		return 0;
+	}
+	ut64 page = (addr - index->base) >> index->shift;
+	if (page >= index->count) {
+		return count;
+	}
+	size_t lo = index->first[page];
+	size_t i;
+	rz_array_lower_bound(addrs + lo, index->first[page + 1] - lo, addr, i, ADDR_CMP);
+	return lo + i;
+}
+
+#undef ADDR_CMP
+
 RZ_API RzBinRelocStorage *rz_bin_reloc_storage_new(RZ_OWN RzList *relocs) {
 	RzBinRelocStorage *ret = RZ_NEW0(RzBinRelocStorage);
 	if (!ret) {
@@ -110,63 +158,95 @@ RZ_API RzBinRelocStorage *rz_bin_reloc_storage_new(RZ_OWN RzList *relocs) {
 	RzPVector sorter;
 	rz_pvector_init(&sorter, NULL);
 	rz_pvector_reserve(&sorter, rz_list_length(relocs));
-	RzPVector target_sorter;
-	rz_pvector_init(&target_sorter, NULL);
-	rz_pvector_reserve(&target_sorter, rz_list_length(relocs));
 	RzListIter *it;
 	RzBinReloc *reloc;
 	rz_list_foreach (relocs, it, reloc) {
 		rz_pvector_push(&sorter, reloc);
+	}
+	rz_pvector_sort(&sorter, reloc_cmp);
+	size_t count = rz_pvector_len(&sorter);
+	// copy the relocs into one flat array, which is way more cache friendly to walk
+	// than millions of individual allocations
+	if (count) {
+		ret->relocs = RZ_NEWS(RzBinReloc, count);
+		ret->vaddrs = RZ_NEWS(ut64, count);
+		if (!ret->relocs || !ret->vaddrs) {
+			goto fail;
+		}
+	}
+	size_t target_count = 0;
+	for (size_t i = 0; i < count; i++) {
+		reloc = rz_pvector_at(&sorter, i);
+		ret->relocs[i] = *reloc;
+		ret->vaddrs[i] = reloc->vaddr;
 		if (rz_bin_reloc_has_target(reloc)) {
-			rz_pvector_push(&target_sorter, reloc);
+			target_count++;
 		}
 	}
-	relocs->free = NULL; // ownership of relocs transferred
-	rz_list_free(relocs);
-	rz_pvector_sort(&sorter, reloc_cmp);
-	ret->relocs_count = rz_pvector_len(&sorter);
-	ret->relocs = (RzBinReloc **)rz_pvector_flush(&sorter);
+	ret->relocs_count = count;
+	if (!page_index_build(&ret->vaddr_pages, ret->vaddrs, count)) {
+		goto fail;
+	}
+	rz_pvector_clear(&sorter);
+	rz_pvector_reserve(&sorter, target_count);
+	for (size_t i = 0; i < count; i++) {
+		if (rz_bin_reloc_has_target(&ret->relocs[i])) {
+			rz_pvector_push(&sorter, &ret->relocs[i]);
+		}
+	}
+	rz_pvector_sort(&sorter, reloc_target_cmp);
+	ret->target_relocs_count = rz_pvector_len(&sorter);
+	ret->target_relocs = (RzBinReloc **)rz_pvector_flush(&sorter);
+	if (ret->target_relocs_count) {
+		ret->target_vaddrs = RZ_NEWS(ut64, ret->target_relocs_count);
+		if (!ret->target_vaddrs) {
+			goto fail;
+		}
+		for (size_t i = 0; i < ret->target_relocs_count; i++) {
+			ret->target_vaddrs[i] = ret->target_relocs[i]->target_vaddr;
+		}
+	}
+	if (!page_index_build(&ret->target_pages, ret->target_vaddrs, ret->target_relocs_count)) {
+		goto fail;
+	}
 	rz_pvector_fini(&sorter);
-	rz_pvector_sort(&target_sorter, reloc_target_cmp);
-	ret->target_relocs_count = rz_pvector_len(&target_sorter);
-	ret->target_relocs = (RzBinReloc **)rz_pvector_flush(&target_sorter);
-	rz_pvector_fini(&target_sorter);
+	// ownership of relocs transferred, their contents now live in the storage
+	relocs->free = (RzListFree)rz_bin_reloc_free;
+	rz_list_free(relocs);
 	return ret;
+fail:
+	rz_pvector_fini(&sorter);
+	relocs->free = (RzListFree)rz_bin_reloc_free;
+	rz_list_free(relocs);
+	rz_bin_reloc_storage_free(ret);
+	return NULL;
 }
 
 RZ_API void rz_bin_reloc_storage_free(RzBinRelocStorage *storage) {
 	if (!storage) {
 		return;
 	}
-	for (size_t i = 0; i < storage->relocs_count; i++) {
-		rz_bin_reloc_free(storage->relocs[i]);
-	}
 	free(storage->relocs);
+	free(storage->vaddrs);
+	free(storage->vaddr_pages.first);
 	free(storage->target_relocs);
+	free(storage->target_vaddrs);
+	free(storage->target_pages.first);
 	free(storage);
 }
 
-static int reloc_vaddr_cmp(ut64 ref, RzBinReloc *reloc) {
-	return RZ_NUM_CMP(ref, reloc->vaddr);
-}
-
 /// Get the reloc with the lowest vaddr that starts inside the given interval
 RZ_API RzBinReloc *rz_bin_reloc_storage_get_reloc_in(RzBinRelocStorage *storage, ut64 vaddr, ut64 size) {
 	rz_return_val_if_fail(storage && size >= 1, NULL);
 	if (!storage->relocs) {
 		return NULL;
 	}
-	size_t i;
-	rz_array_lower_bound(storage->relocs, storage->relocs_count, vaddr, i, reloc_vaddr_cmp);
+	size_t i = page_index_lower_bound(&storage->vaddr_pages, storage->vaddrs, storage->relocs_count, vaddr);
 	if (i >= storage->relocs_count) {
 		return NULL;
 	}
-	RzBinReloc *r = storage->relocs[i];
-	return r->vaddr >= vaddr && r->vaddr < vaddr + size ? r : NULL;
-}
-
-static int reloc_target_vaddr_cmp(ut64 ref, RzBinReloc *reloc) {
-	return RZ_NUM_CMP(ref, reloc->target_vaddr);
+	ut64 rv = storage->vaddrs[i];
+	return rv >= vaddr && rv < vaddr + size ? &storage->relocs[i] : NULL;
 }
 
 /// Get a reloc that points exactly to vaddr or NULL
@@ -175,14 +255,15 @@ RZ_API RzBinReloc *rz_bin_reloc_storage_get_reloc_to(RzBinRelocStorage *storage,
 	if (!storage->target_relocs) {
 		return NULL;
 	}
-	size_t i;
-	rz_array_upper_bound(storage->target_relocs, storage->target_relocs_count, vaddr, i, reloc_target_vaddr_cmp);
+	// the last one of all the relocs pointing to vaddr is the one right before the first reloc pointing after it
+	size_t i = vaddr == UT64_MAX
+		? storage->target_relocs_count
+		: page_index_lower_bound(&storage->target_pages, storage->target_vaddrs, storage->target_relocs_count, vaddr + 1);
 	if (!i) {
 		return NULL;
 	}
 	i--;
-	RzBinReloc *r = storage->target_relocs[i];
-	return r->target_vaddr == vaddr ? r : NULL;
+	return storage->target_vaddrs[i] == vaddr ? storage->target_relocs[i] : NULL;
 }
 
 RZ_IPI void rz_bin_object_free(RzBinObject *o) {
@@ -206,11 +287,12 @@ RZ_IPI void rz_bin_object_free(RzBinObject *o) {
 	rz_list_free(o->classes);
 	ht_pp_free(o->classes_ht);
 	ht_pp_free(o->methods_ht);
-	rz_bin_source_line_info_free(o->lines);
+	rz_bin_source_line_index_free(o->lines);
 	rz_list_free(o->mem);
 	for (ut32 i = 0; i < RZ_BIN_SPECIAL_SYMBOL_LAST; i++) {
 		free(o->binsym[i]);
 	}
+	rz_th_lock_free(o->lazy_lock);
 	free(o);
 }
 
@@ -389,6 +471,193 @@ static void rz_bin_object_rebuild_classes_ht(RzBinObject *o) {
 	}
 }
 
+#define LAZY_IMPORTS (1 << 0)
+#define LAZY_SYMBOLS (1 << 1)
+#define LAZY_RELOCS  (1 << 2)
+#define LAZY_LANG    (1 << 3)
+#define LAZY_CLASSES (1 << 4)
+#define LAZY_ALL     (LAZY_IMPORTS | LAZY_SYMBOLS | LAZY_RELOCS | LAZY_LANG | LAZY_CLASSES)
+
+static void object_load_imports(RzBinFile *bf, RzBinObject *o) {
+	RzBinPlugin *p = o->plugin;
+	if (p->imports) {
+		rz_list_free(o->imports);
+		o->imports = p->imports(bf);
+		if (o->imports) {
+			rz_warn_if_fail(o->imports->free);
+		}
+	}
+}
+
+static void object_index_import_symbols(RzBinObject *o) {
+	ht_pp_free(o->import_name_symbols);
+	o->import_name_symbols = ht_pp_new0();
+	if (!o->import_name_symbols) {
+		return;
+	}
+	RzBinSymbol *sym;
+	RzListIter *it;
+	rz_list_foreach (o->symbols, it, sym) {
+		if (!sym->is_imported || !sym->name || !*sym->name) {
+			continue;
+		}
+		ht_pp_insert(o->import_name_symbols, sym->name, sym);
+	}
+}
+
+static void object_load_symbols(RzBinFile *bf, RzBinObject *o) {
+	RzBin *bin = bf->rbin;
+	RzBinPlugin *p = o->plugin;
+	if (p->symbols) {
+		o->symbols = p->symbols(bf);
+		if (o->symbols) {
+			rz_warn_if_fail(o->symbols->free);
+			REBASE_PADDR(o, o->symbols, RzBinSymbol);
+			if (bin->filter) {
+				rz_bin_filter_symbols(bf, o->symbols);
+			}
+			object_index_import_symbols(o);
+		}
+	}
+}
+
+static void object_load_relocs(RzBinFile *bf, RzBinObject *o) {
+	RzBin *bin = bf->rbin;
+	RzBinPlugin *p = o->plugin;
+	if (bin->filter_rules & (RZ_BIN_REQ_RELOCS | RZ_BIN_REQ_IMPORTS)) {
+		if (p->relocs) {
+			RzList *l = p->relocs(bf);
+			if (l) {
+				REBASE_PADDR(o, l, RzBinReloc);
+				o->relocs = rz_bin_reloc_storage_new(l);
+			}
+		}
+	}
+}
+
+static void object_load_classes(RzBinFile *bf, RzBinObject *o) {
+	RzBin *bin = bf->rbin;
+	RzBinPlugin *p = o->plugin;
+	if (bin->filter_rules & (RZ_BIN_REQ_CLASSES | RZ_BIN_REQ_CLASSES_SOURCES)) {
+		if (p->classes) {
+			RzList *classes = p->classes(bf);
+			if (classes) {
+				// XXX we should probably merge them instead
+				rz_list_free(o->classes);
+				o->classes = classes;
+				rz_bin_object_rebuild_classes_ht(o);
+			}
+
+			if (o->lang == RZ_BIN_LANGUAGE_SWIFT) {
+				o->classes = classes_from_symbols(bf);
+			}
+		} else {
+			RzList *classes = classes_from_symbols(bf);
+			if (classes) {
+				o->classes = classes;
+			}
+		}
+
+		if (bin->filter) {
+			filter_classes(bf, o->classes);
+		}
+
+		// cache addr=class+method
+		if (o->classes) {
+			RzList *klasses = o->classes;
+			RzListIter *iter, *iter2;
+			RzBinClass *klass;
+			RzBinSymbol *method;
+			if (!o->addrzklassmethod) {
+				// this is slow. must be optimized, but at least its cached
+				o->addrzklassmethod = ht_up_new0();
+				rz_list_foreach (klasses, iter, klass) {
+					rz_list_foreach (klass->methods, iter2, method) {
+						ht_up_insert(o->addrzklassmethod, method->vaddr, method);
+					}
+				}
+			}
+		}
+	}
+}
+
+#if WITH_MEM_ACCOUNTING
+static size_t str_mem_size(const char *s) {
+	return s ? strlen(s) + 1 : 0;
+}
+
+/**
+ * Count the items loaded so far in the bin memory accounting.
+ * Items that were already counted are just updated.
+ */
+static void object_mem_track(RzBinObject *o) {
+	RzListIter *it;
+	RzBinSymbol *sym;
+	rz_list_foreach (o->symbols, it, sym) {
+		RZ_MEM_TRACK(RZ_MEM_ACCOUNT_BIN, sym, sizeof(RzBinSymbol) + str_mem_size(sym->name) + str_mem_size(sym->dname));
+	}
+	RzBinImport *imp;
+	rz_list_foreach (o->imports, it, imp) {
+		RZ_MEM_TRACK(RZ_MEM_ACCOUNT_BIN, imp, sizeof(RzBinImport) + str_mem_size(imp->name));
+	}
+	RzBinSection *sec;
+	rz_list_foreach (o->sections, it, sec) {
+		RZ_MEM_TRACK(RZ_MEM_ACCOUNT_BIN, sec, sizeof(RzBinSection) + str_mem_size(sec->name));
+	}
+	RzBinString *str;
+	if (o->strings) {
+		rz_list_foreach (o->strings->list, it, str) {
+			RZ_MEM_TRACK(RZ_MEM_ACCOUNT_BIN, str, sizeof(RzBinString) + str_mem_size(str->string));
+		}
+	}
+}
+#else
+#define object_mem_track(o) ((void)0)
+#endif
+
+/**
+ * Load the \p items that were deferred by bin.lazy and are still missing.
+ * The lock is recursive because loading the classes goes through
+ * rz_bin_file_add_class(), which asks for the classes again.
+ */
+static void object_materialize(RzBinObject *o, ut32 items) {
+	if (!o->lazy_lock) {
+		return;
+	}
+	rz_th_lock_enter(o->lazy_lock);
+	// the language and the classes are detected from the imports and the symbols
+	if (items & LAZY_CLASSES) {
+		items |= LAZY_LANG;
+	}
+	if (items & LAZY_LANG) {
+		items |= LAZY_IMPORTS | LAZY_SYMBOLS;
+	}
+	items &= o->lazy_pending & ~o->lazy_loading;
+	if (items) {
+		RzBinFile *bf = o->lazy_bf;
+		o->lazy_loading |= items;
+		if (items & LAZY_IMPORTS) {
+			object_load_imports(bf, o);
+		}
+		if (items & LAZY_SYMBOLS) {
+			object_load_symbols(bf, o);
+		}
+		if (items & LAZY_RELOCS) {
+			object_load_relocs(bf, o);
+		}
+		if (items & LAZY_LANG) {
+			o->lang = rz_bin_language_detect(bf);
+		}
+		if (items & LAZY_CLASSES) {
+			object_load_classes(bf, o);
+		}
+		o->lazy_loading &= ~items;
+		o->lazy_pending &= ~items;
+		object_mem_track(o);
+	}
+	rz_th_lock_leave(o->lazy_lock);
+}
+
 RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 	rz_return_val_if_fail(bf && o && o->plugin, false);
 
@@ -397,6 +666,18 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 	int minlen = (bf->rbin->minstrlen > 0) ? bf->rbin->minstrlen : p->minstrlen;
 	bf->o = o;
 
+	char *cache_path = rz_bin_cache_path(bf, o);
+	ut32 deferred = 0;
+	// everything is needed right away to fill the cache
+	if (bin->lazy && !cache_path) {
+		if (!o->lazy_lock) {
+			o->lazy_lock = rz_th_lock_new(true);
+		}
+		if (o->lazy_lock) {
+			deferred = LAZY_ALL;
+		}
+	}
+
 	if (p->file_type) {
 		int type = p->file_type(bf);
 		if (type == RZ_BIN_TYPE_CORE) {
@@ -415,6 +696,11 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 	if (p->size) {
 		o->size = p->size(bf);
 	}
+	// on a hit, the cache replaces the plugin for sections, symbols, imports, relocs and strings
+	bool cached = cache_path && rz_bin_cache_load(bin, o, cache_path);
+	if (cached) {
+		object_index_import_symbols(o);
+	}
 	// XXX this is expensive because is O(n^n)
 	if (p->binsym) {
 		for (size_t i = 0; i < RZ_BIN_SPECIAL_SYMBOL_LAST; i++) {
@@ -444,38 +730,16 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 			REBASE_PADDR(o, o->fields, RzBinField);
 		}
 	}
-	if (p->imports) {
-		rz_list_free(o->imports);
-		o->imports = p->imports(bf);
-		if (o->imports) {
-			rz_warn_if_fail(o->imports->free);
-		}
+	if (!cached && !(deferred & LAZY_IMPORTS)) {
+		object_load_imports(bf, o);
 	}
-	if (p->symbols) {
-		o->symbols = p->symbols(bf);
-		if (o->symbols) {
-			rz_warn_if_fail(o->symbols->free);
-			REBASE_PADDR(o, o->symbols, RzBinSymbol);
-			if (bin->filter) {
-				rz_bin_filter_symbols(bf, o->symbols);
-			}
-			o->import_name_symbols = ht_pp_new0();
-			if (o->import_name_symbols) {
-				RzBinSymbol *sym;
-				RzListIter *it;
-				rz_list_foreach (o->symbols, it, sym) {
-					if (!sym->is_imported || !sym->name || !*sym->name) {
-						continue;
-					}
-					ht_pp_insert(o->import_name_symbols, sym->name, sym);
-				}
-			}
-		}
+	if (!cached && !(deferred & LAZY_SYMBOLS)) {
+		object_load_symbols(bf, o);
 	}
 	if (p->libs) {
 		o->libs = p->libs(bf);
 	}
-	if (p->sections) {
+	if (!cached && p->sections) {
 		// XXX sections are populated by call to size
 		if (!o->sections) {
 			o->sections = p->sections(bf);
@@ -488,16 +752,10 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 
 	o->info = p->info ? p->info(bf) : NULL;
 
-	if (bin->filter_rules & (RZ_BIN_REQ_RELOCS | RZ_BIN_REQ_IMPORTS)) {
-		if (p->relocs) {
-			RzList *l = p->relocs(bf);
-			if (l) {
-				REBASE_PADDR(o, l, RzBinReloc);
-				o->relocs = rz_bin_reloc_storage_new(l);
-			}
-		}
+	if (!cached && !(deferred & LAZY_RELOCS)) {
+		object_load_relocs(bf, o);
 	}
-	if (bin->filter_rules & RZ_BIN_REQ_STRINGS) {
+	if (!cached && bin->filter_rules & RZ_BIN_REQ_STRINGS) {
 		RzList *strings;
 		if (p->strings) {
 			strings = p->strings(bf);
@@ -525,51 +783,20 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 		}
 	}
 
-	o->lang = rz_bin_language_detect(bf);
-
-	if (bin->filter_rules & (RZ_BIN_REQ_CLASSES | RZ_BIN_REQ_CLASSES_SOURCES)) {
-		if (p->classes) {
-			RzList *classes = p->classes(bf);
-			if (classes) {
-				// XXX we should probably merge them instead
-				rz_list_free(o->classes);
-				o->classes = classes;
-				rz_bin_object_rebuild_classes_ht(o);
-			}
-
-			if (o->lang == RZ_BIN_LANGUAGE_SWIFT) {
-				o->classes = classes_from_symbols(bf);
-			}
-		} else {
-			RzList *classes = classes_from_symbols(bf);
-			if (classes) {
-				o->classes = classes;
-			}
-		}
-
-		if (bin->filter) {
-			filter_classes(bf, o->classes);
-		}
+	if (!(deferred & LAZY_LANG)) {
+		o->lang = rz_bin_language_detect(bf);
+	}
 
-		// cache addr=class+method
-		if (o->classes) {
-			RzList *klasses = o->classes;
-			RzListIter *iter, *iter2;
-			RzBinClass *klass;
-			RzBinSymbol *method;
-			if (!o->addrzklassmethod) {
-				// this is slow. must be optimized, but at least its cached
-				o->addrzklassmethod = ht_up_new0();
-				rz_list_foreach (klasses, iter, klass) {
-					rz_list_foreach (klass->methods, iter2, method) {
-						ht_up_insert(o->addrzklassmethod, method->vaddr, method);
-					}
-				}
-			}
-		}
+	if (!(deferred & LAZY_CLASSES)) {
+		object_load_classes(bf, o);
 	}
 	if (p->lines) {
-		o->lines = p->lines(bf);
+		RzBinSourceLineInfo *lines = p->lines(bf);
+		if (lines) {
+			rz_bin_source_line_index_free(o->lines);
+			o->lines = rz_bin_source_line_index_new_from_info(lines);
+			rz_bin_source_line_info_free(lines);
+		}
 	}
 	if (p->get_sdb) {
 		Sdb *new_kv = p->get_sdb(bf);
@@ -584,12 +811,20 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 	if (p->resources) {
 		o->resources = p->resources(bf);
 	}
+	object_mem_track(o);
+	o->lazy_bf = bf;
+	o->lazy_pending = deferred;
+	if (cache_path && !cached && !rz_bin_cache_save(o, cache_path)) {
+		RZ_LOG_WARN("Cannot write the bin cache to %s\n", cache_path);
+	}
+	free(cache_path);
 	return true;
 }
 
 RZ_API RzBinRelocStorage *rz_bin_object_patch_relocs(RzBinFile *bf, RzBinObject *o) {
 	rz_return_val_if_fail(bf && o, NULL);
 
+	object_materialize(o, LAZY_RELOCS);
 	static bool first = true;
 	// rz_bin_object_set_items set o->relocs but there we don't have access
 	// to io so we need to be run from bin_relocs, free the previous reloc and get
@@ -609,12 +844,57 @@ RZ_API RzBinRelocStorage *rz_bin_object_patch_relocs(RzBinFile *bf, RzBinObject
 	return o->relocs;
 }
 
+/**
+ * \brief Load the part of the file holding \p vaddr when the plugin left it out, like an image of a dyld shared cache
+ *
+ * The sections, symbols and classes already loaded are fetched again from the plugin.
+ *
+ * \return true if something new was loaded
+ */
+RZ_API bool rz_bin_object_load_vaddr(RZ_NONNULL RzBinFile *bf, RZ_NONNULL RzBinObject *o, ut64 vaddr) {
+	rz_return_val_if_fail(bf && o, false);
+	RzBinPlugin *p = o->plugin;
+	if (!p || !p->load_vaddr) {
+		return false;
+	}
+	if (o->lazy_lock) {
+		rz_th_lock_enter(o->lazy_lock);
+	}
+	bool loaded = p->load_vaddr(bf, vaddr);
+	if (loaded) {
+		if (p->sections) {
+			rz_list_free(o->sections);
+			o->sections = p->sections(bf);
+			REBASE_PADDR(o, o->sections, RzBinSection);
+			if (bf->rbin->filter) {
+				rz_bin_filter_sections(bf, o->sections);
+			}
+		}
+		// the items still pending will include the new part anyway when they get loaded
+		if (!(o->lazy_pending & LAZY_SYMBOLS)) {
+			rz_list_free(o->symbols);
+			o->symbols = NULL;
+			object_load_symbols(bf, o);
+		}
+		if (!(o->lazy_pending & LAZY_CLASSES)) {
+			ht_up_free(o->addrzklassmethod);
+			o->addrzklassmethod = NULL;
+			object_load_classes(bf, o);
+		}
+	}
+	if (o->lazy_lock) {
+		rz_th_lock_leave(o->lazy_lock);
+	}
+	return loaded;
+}
+
 /**
  * \brief Find the symbol that represents the given import
  * This is necessary for example to determine the address of an import.
  */
 RZ_API RzBinSymbol *rz_bin_object_get_symbol_of_import(RzBinObject *o, RzBinImport *imp) {
 	rz_return_val_if_fail(o && imp && imp->name, NULL);
+	object_materialize(o, LAZY_SYMBOLS);
 	if (!o->import_name_symbols) {
 		return NULL;
 	}
@@ -725,6 +1005,7 @@ RZ_API const RzList *rz_bin_object_get_fields(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_get_imports(RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	object_materialize(obj, LAZY_IMPORTS);
 	return obj->imports;
 }
 
@@ -789,6 +1070,7 @@ RZ_API RzList *rz_bin_object_get_segments(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_get_classes(RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	object_materialize(obj, LAZY_CLASSES);
 	return obj->classes;
 }
 
@@ -816,9 +1098,28 @@ RZ_API const RzList *rz_bin_object_get_mem(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_get_symbols(RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	object_materialize(obj, LAZY_SYMBOLS);
 	return obj->symbols;
 }
 
+/**
+ * \brief Get the relocations of the binary object, without patching them.
+ */
+RZ_API RzBinRelocStorage *rz_bin_object_get_relocs(RzBinObject *obj) {
+	rz_return_val_if_fail(obj, NULL);
+	object_materialize(obj, LAZY_RELOCS);
+	return obj->relocs;
+}
+
+/**
+ * \brief Get the language the binary object was written in, as detected from its symbols.
+ */
+RZ_API RzBinLanguage rz_bin_object_get_language(RzBinObject *obj) {
+	rz_return_val_if_fail(obj, RZ_BIN_LANGUAGE_UNKNOWN);
+	object_materialize(obj, LAZY_LANG);
+	return obj->lang;
+}
+
 /**
  * \brief Get a list of \p RzBinResource representing the resources in the binary object.
  */
@@ -869,6 +1170,103 @@ RZ_API RZ_BORROW RzBinString *rz_bin_object_get_string_at(RZ_NONNULL RzBinObject
 	return ht_up_find(obj->strings->phys, address, NULL);
 }
 
+static void string_table_free(RZ_NULLABLE RzBinStrTable *table) {
+	if (!table) {
+		return;
+	}
+	free(table->strings);
+	free(table->max_end);
+	free(table);
+}
+
+static int string_vaddr_cmp(const void *a, const void *b) {
+	const RzBinString *sa = *(RzBinString *const *)a, *sb = *(RzBinString *const *)b;
+	return sa->vaddr < sb->vaddr ? -1 : sa->vaddr > sb->vaddr;
+}
+
+static int string_paddr_cmp(const void *a, const void *b) {
+	const RzBinString *sa = *(RzBinString *const *)a, *sb = *(RzBinString *const *)b;
+	return sa->paddr < sb->paddr ? -1 : sa->paddr > sb->paddr;
+}
+
+static RzBinStrTable *string_table_new(RzList /*<RzBinString *>*/ *list, bool is_va) {
+	RzBinStrTable *table = RZ_NEW0(RzBinStrTable);
+	if (!table) {
+		return NULL;
+	}
+	size_t n = rz_list_length(list);
+	table->strings = RZ_NEWS(RzBinString *, RZ_MAX(n, 1));
+	table->max_end = RZ_NEWS(ut64, RZ_MAX(n, 1));
+	if (!table->strings || !table->max_end) {
+		string_table_free(table);
+		return NULL;
+	}
+	RzListIter *it;
+	RzBinString *bstr;
+	rz_list_foreach (list, it, bstr) {
+		table->strings[table->count++] = bstr;
+	}
+	qsort(table->strings, table->count, sizeof(RzBinString *), is_va ? string_vaddr_cmp : string_paddr_cmp);
+	ut64 max_end = 0;
+	for (size_t i = 0; i < table->count; i++) {
+		bstr = table->strings[i];
+		max_end = RZ_MAX(max_end, (is_va ? bstr->vaddr : bstr->paddr) + bstr->size);
+		table->max_end[i] = max_end;
+	}
+	return table;
+}
+
+/**
+ * \brief Find the string of \p table containing \p address, starting the
+ * closest before it
+ *
+ * The strings starting before \p address are found by binary search and
+ * walked backwards only while some of them may still reach \p address, so
+ * without overlapping strings this is O(log n).
+ */
+static RzBinString *string_table_find(RzBinStrTable *table, ut64 address, bool is_va) {
+	size_t lo = 0, hi = table->count;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		RzBinString *bstr = table->strings[mid];
+		if ((is_va ? bstr->vaddr : bstr->paddr) <= address) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	while (lo-- > 0 && table->max_end[lo] > address) {
+		RzBinString *bstr = table->strings[lo];
+		if ((is_va ? bstr->vaddr : bstr->paddr) + bstr->size > address) {
+			return bstr;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * \brief Return the RzBinString of the RzBinObject string database whose bytes contain \p address
+ *
+ * Unlike rz_bin_object_get_string_at(), \p address does not need to be
+ * the start of the string. The strings are sorted by address on the first
+ * lookup after the database changes, then each lookup is a binary search.
+ */
+RZ_API RZ_BORROW RzBinString *rz_bin_object_get_string_in(RZ_NONNULL RzBinObject *obj, ut64 address, bool is_va) {
+	rz_return_val_if_fail(obj, NULL);
+	RzBinStrDb *db = obj->strings;
+	if (!db) {
+		return NULL;
+	}
+	RzBinStrTable **table = is_va ? &db->virt_sorted : &db->phys_sorted;
+	if (!*table) {
+		*table = string_table_new(db->list, is_va);
+		if (!*table) {
+			return NULL;
+		}
+	}
+	return string_table_find(*table, address, is_va);
+}
+
 /**
  * \brief Return true if the binary object \p obj is big endian.
  */
@@ -1080,6 +1478,8 @@ RZ_IPI void rz_bin_string_database_free(RZ_NULLABLE RzBinStrDb *db) {
 	rz_list_free(db->list);
 	ht_up_free(db->phys);
 	ht_up_free(db->virt);
+	string_table_free(db->phys_sorted);
+	string_table_free(db->virt_sorted);
 	free(db);
 }
 
@@ -1093,6 +1493,8 @@ RZ_IPI void rz_bin_string_database_free(RZ_NULLABLE RzBinStrDb *db) {
  */
 RZ_API bool rz_bin_string_database_add(RZ_NONNULL RzBinStrDb *db, RZ_NONNULL RzBinString *bstr) {
 	rz_return_val_if_fail(db && bstr, false);
+	RZ_FREE_CUSTOM(db->phys_sorted, string_table_free);
+	RZ_FREE_CUSTOM(db->virt_sorted, string_table_free);
 
 	if (!rz_list_append(db->list, bstr)) {
 		RZ_LOG_ERROR("rz_bin: Cannot add RzBinString in RzBinStrDb (list)\n");
@@ -1122,6 +1524,8 @@ RZ_API bool rz_bin_string_database_remove(RZ_NONNULL RzBinStrDb *db, ut64 addres
 		return false;
 	}
 
+	RZ_FREE_CUSTOM(db->phys_sorted, string_table_free);
+	RZ_FREE_CUSTOM(db->virt_sorted, string_table_free);
 	ht_up_delete(db->virt, bstr->vaddr);
 	ht_up_delete(db->phys, bstr->paddr);
 	rz_list_delete_data(db->list, bstr);
@@ -191,16 +191,498 @@ RZ_API const RzBinSourceLineSample *rz_bin_source_line_info_get_next(const RzBin
 	return next;
 }
 
+/*
+ * RzBinSourceLineIndex holds the same samples as RzBinSourceLineInfo, sorted
+ * the same way, but delta-encoded as uleb128 in blocks of LINE_BLOCK_SAMPLES
+ * samples, each block being encoded from scratch so a lookup only decodes a
+ * block or two. Each sample is encoded relative to the previous one as the
+ * address delta, the zigzag line delta, the column and the file id + 1, 0
+ * meaning no file.
+ */
+
+#define LINE_BLOCK_SAMPLES 64
+
+typedef struct {
+	ut64 address; ///< address of the first sample of the block
+	size_t offset; ///< offset of the first sample in the encoded data
+} LineBlock;
+
+struct rz_bin_source_line_index_t {
+	ut8 *data; ///< encoded samples
+	size_t data_size;
+	LineBlock *blocks;
+	size_t blocks_count;
+	size_t samples_count;
+	RzPVector /*<const char *>*/ files; ///< strings of filename_pool, by file id
+	RzStrConstPool filename_pool;
+};
+
+/**
+ * Samples pushed in increasing order, encoded like a single block
+ */
+typedef struct {
+	RzVector /*<ut8>*/ data;
+	size_t count;
+} LineRun;
+
+struct rz_bin_source_line_index_builder_t {
+	RzVector /*<LineRun>*/ runs;
+	RzBinSourceLineSample last; ///< last sample of the last run
+	HtPU /*<char *, ut64>*/ *file_ids;
+	RzPVector /*<const char *>*/ files; ///< strings of filename_pool, by file id
+	RzStrConstPool filename_pool;
+};
+
+static inline size_t uleb_write(ut8 *dst, ut64 v) {
+	size_t n = 0;
+	do {
+		ut8 b = v & 0x7f;
+		v >>= 7;
+		dst[n++] = v ? b | 0x80 : b;
+	} while (v);
+	return n;
+}
+
+static inline const ut8 *uleb_read(const ut8 *src, ut64 *v) {
+	ut64 r = 0;
+	int shift = 0;
+	ut8 b;
+	do {
+		b = *src++;
+		r |= (ut64)(b & 0x7f) << shift;
+		shift += 7;
+	} while (b & 0x80 && shift < 64);
+	*v = r;
+	return src;
+}
+
+/**
+ * \brief Encodes \p s relative to \p prev into \p dst, which must hold at least 40 bytes
+ */
+static size_t line_sample_encode(ut8 *dst, const RzBinSourceLineSample *prev, const RzBinSourceLineSample *s, ut64 file_id) {
+	st64 dline = (st64)s->line - (st64)prev->line;
+	size_t n = uleb_write(dst, s->address - prev->address);
+	n += uleb_write(dst + n, ((ut64)dline << 1) ^ (ut64)(dline >> 63));
+	n += uleb_write(dst + n, s->column);
+	n += uleb_write(dst + n, file_id);
+	return n;
+}
+
+static const ut8 *line_sample_decode(const ut8 *src, RzBinSourceLineSample *s, ut64 *file_id, const RzPVector *files) {
+	ut64 daddr, dline, column;
+	src = uleb_read(src, &daddr);
+	src = uleb_read(src, &dline);
+	src = uleb_read(src, &column);
+	src = uleb_read(src, file_id);
+	s->address += daddr;
+	s->line += (ut32)((dline >> 1) ^ -(st64)(dline & 1));
+	s->column = (ut32)column;
+	s->file = *file_id ? rz_pvector_at(files, *file_id - 1) : NULL;
+	return src;
+}
+
+static void line_run_fini(void *e, void *user) {
+	LineRun *run = e;
+	rz_vector_fini(&run->data);
+}
+
+/**
+ * \brief Creates an empty builder
+ */
+RZ_API RZ_OWN RzBinSourceLineIndexBuilder *rz_bin_source_line_index_builder_new(void) {
+	RzBinSourceLineIndexBuilder *builder = RZ_NEW0(RzBinSourceLineIndexBuilder);
+	if (!builder) {
+		return NULL;
+	}
+	builder->file_ids = ht_pu_new0();
+	if (!builder->file_ids || !rz_str_constpool_init(&builder->filename_pool)) {
+		ht_pu_free(builder->file_ids);
+		free(builder);
+		return NULL;
+	}
+	rz_vector_init(&builder->runs, sizeof(LineRun), line_run_fini, NULL);
+	rz_pvector_init(&builder->files, NULL);
+	return builder;
+}
+
+RZ_API void rz_bin_source_line_index_builder_free(RZ_NULLABLE RzBinSourceLineIndexBuilder *builder) {
+	if (!builder) {
+		return;
+	}
+	rz_vector_fini(&builder->runs);
+	ht_pu_free(builder->file_ids);
+	rz_pvector_fini(&builder->files);
+	rz_str_constpool_fini(&builder->filename_pool);
+	free(builder);
+}
+
+static bool builder_file_id(RzBinSourceLineIndexBuilder *builder, const char *file, ut64 *id, const char **pooled) {
+	if (!file) {
+		*id = 0;
+		*pooled = NULL;
+		return true;
+	}
+	bool found;
+	ut64 index = ht_pu_find(builder->file_ids, file, &found);
+	if (!found) {
+		const char *str = rz_str_constpool_get(&builder->filename_pool, file);
+		index = rz_pvector_len(&builder->files);
+		if (!str || !rz_pvector_push(&builder->files, (void *)str) || !ht_pu_insert(builder->file_ids, file, index)) {
+			return false;
+		}
+	}
+	*id = index + 1;
+	*pooled = rz_pvector_at(&builder->files, index);
+	return true;
+}
+
+/**
+ * \brief Adds a sample to the builder, see rz_bin_source_line_info_builder_push_sample()
+ *
+ * Samples pushed in increasing order, as a line number program produces them
+ * within a sequence, are appended to the same run, which is merged with the
+ * others when the index is built.
+ */
+RZ_API bool rz_bin_source_line_index_builder_push_sample(RZ_NONNULL RzBinSourceLineIndexBuilder *builder, RZ_NONNULL const RzBinSourceLineSample *sample) {
+	rz_return_val_if_fail(builder && sample, false);
+	RzBinSourceLineSample s = *sample;
+	ut64 file_id;
+	if (!builder_file_id(builder, sample->file, &file_id, &s.file)) {
+		return false;
+	}
+	LineRun *run = rz_vector_empty(&builder->runs) ? NULL : rz_vector_tail(&builder->runs);
+	RzBinSourceLineSample zero = { 0 };
+	const RzBinSourceLineSample *prev = &builder->last;
+	if (!run || line_sample_cmp(prev, &s) > 0) {
+		run = rz_vector_push(&builder->runs, NULL);
+		if (!run) {
+			return false;
+		}
+		rz_vector_init(&run->data, sizeof(ut8), NULL, NULL);
+		run->count = 0;
+		prev = &zero;
+	}
+	ut8 buf[40];
+	size_t n = line_sample_encode(buf, prev, &s, file_id);
+	if (!rz_vector_insert_range(&run->data, rz_vector_len(&run->data), buf, n)) {
+		return false;
+	}
+	run->count++;
+	builder->last = s;
+	return true;
+}
+
+typedef struct {
+	const ut8 *p;
+	size_t left; ///< samples left to decode
+	RzBinSourceLineSample sample; ///< last decoded sample
+	ut64 file_id;
+} LineRunCursor;
+
+static bool run_cursor_next(LineRunCursor *c, const RzPVector *files) {
+	if (!c->left) {
+		return false;
+	}
+	c->p = line_sample_decode(c->p, &c->sample, &c->file_id, files);
+	c->left--;
+	return true;
+}
+
+static bool heap_less(LineRunCursor *cursors, size_t a, size_t b) {
+	int cmp = line_sample_cmp(&cursors[a].sample, &cursors[b].sample);
+	// keep the order of the runs for equal samples
+	return cmp < 0 || (!cmp && a < b);
+}
+
+static void heap_sift_down(size_t *heap, size_t count, size_t i, LineRunCursor *cursors) {
+	while (true) {
+		size_t min = i, l = 2 * i + 1, r = 2 * i + 2;
+		if (l < count && heap_less(cursors, heap[l], heap[min])) {
+			min = l;
+		}
+		if (r < count && heap_less(cursors, heap[r], heap[min])) {
+			min = r;
+		}
+		if (min == i) {
+			return;
+		}
+		size_t tmp = heap[i];
+		heap[i] = heap[min];
+		heap[min] = tmp;
+		i = min;
+	}
+}
+
+typedef struct {
+	RzVector /*<ut8>*/ data;
+	RzVector /*<LineBlock>*/ blocks;
+	RzBinSourceLineSample prev;
+	size_t count;
+} LineEncoder;
+
+static bool encoder_push(LineEncoder *enc, const RzBinSourceLineSample *s, ut64 file_id) {
+	if (!(enc->count % LINE_BLOCK_SAMPLES)) {
+		LineBlock *block = rz_vector_push(&enc->blocks, NULL);
+		if (!block) {
+			return false;
+		}
+		block->address = s->address;
+		block->offset = rz_vector_len(&enc->data);
+		memset(&enc->prev, 0, sizeof(enc->prev));
+	}
+	ut8 buf[40];
+	size_t n = line_sample_encode(buf, &enc->prev, s, file_id);
+	if (!rz_vector_insert_range(&enc->data, rz_vector_len(&enc->data), buf, n)) {
+		return false;
+	}
+	enc->prev = *s;
+	enc->count++;
+	return true;
+}
+
+/**
+ * \brief Merges the runs of samples into the final index and frees the builder
+ */
+RZ_API RZ_OWN RzBinSourceLineIndex *rz_bin_source_line_index_builder_build_and_free(RZ_NONNULL RZ_OWN RzBinSourceLineIndexBuilder *builder) {
+	rz_return_val_if_fail(builder, NULL);
+	RzBinSourceLineIndex *index = NULL;
+	size_t runs_count = rz_vector_len(&builder->runs);
+	LineRunCursor *cursors = RZ_NEWS0(LineRunCursor, runs_count + 1);
+	size_t *heap = RZ_NEWS(size_t, runs_count + 1);
+	LineEncoder enc = { 0 };
+	rz_vector_init(&enc.data, sizeof(ut8), NULL, NULL);
+	rz_vector_init(&enc.blocks, sizeof(LineBlock), NULL, NULL);
+	if (!cursors || !heap) {
+		goto beach;
+	}
+	size_t heap_count = 0;
+	for (size_t i = 0; i < runs_count; i++) {
+		LineRun *run = rz_vector_index_ptr(&builder->runs, i);
+		cursors[i].p = rz_vector_head(&run->data);
+		cursors[i].left = run->count;
+		if (run_cursor_next(&cursors[i], &builder->files)) {
+			heap[heap_count++] = i;
+		}
+	}
+	for (size_t i = heap_count / 2; i-- > 0;) {
+		heap_sift_down(heap, heap_count, i, cursors);
+	}
+	while (heap_count) {
+		LineRunCursor *c = &cursors[heap[0]];
+		const RzBinSourceLineSample *s = &c->sample;
+		// closing sample but there are others that are not closing so this is dropped,
+		// like rz_bin_source_line_info_builder_build_and_fini() does
+		if (!enc.count || enc.prev.address != s->address || !rz_bin_source_line_sample_is_closing(s)) {
+			if (!encoder_push(&enc, s, c->file_id)) {
+				goto beach;
+			}
+		}
+		if (!run_cursor_next(c, &builder->files)) {
+			heap[0] = heap[--heap_count];
+		}
+		heap_sift_down(heap, heap_count, 0, cursors);
+	}
+	index = RZ_NEW0(RzBinSourceLineIndex);
+	if (!index) {
+		goto beach;
+	}
+	rz_vector_shrink(&enc.data);
+	rz_vector_shrink(&enc.blocks);
+	index->samples_count = enc.count;
+	index->data_size = rz_vector_len(&enc.data);
+	index->data = rz_vector_flush(&enc.data);
+	index->blocks_count = rz_vector_len(&enc.blocks);
+	index->blocks = rz_vector_flush(&enc.blocks);
+	// move the strings out of the builder
+	index->files = builder->files;
+	index->filename_pool = builder->filename_pool;
+	rz_pvector_init(&builder->files, NULL);
+	rz_str_constpool_init(&builder->filename_pool);
+beach:
+	rz_vector_fini(&enc.data);
+	rz_vector_fini(&enc.blocks);
+	free(heap);
+	free(cursors);
+	rz_bin_source_line_index_builder_free(builder);
+	return index;
+}
+
+/**
+ * \brief Creates an index holding the same samples as \p sli
+ */
+RZ_API RZ_OWN RzBinSourceLineIndex *rz_bin_source_line_index_new_from_info(RZ_NONNULL const RzBinSourceLineInfo *sli) {
+	rz_return_val_if_fail(sli, NULL);
+	RzBinSourceLineIndexBuilder *builder = rz_bin_source_line_index_builder_new();
+	if (!builder) {
+		return NULL;
+	}
+	for (size_t i = 0; i < sli->samples_count; i++) {
+		if (!rz_bin_source_line_index_builder_push_sample(builder, &sli->samples[i])) {
+			rz_bin_source_line_index_builder_free(builder);
+			return NULL;
+		}
+	}
+	return rz_bin_source_line_index_builder_build_and_free(builder);
+}
+
+RZ_API void rz_bin_source_line_index_free(RZ_NULLABLE RzBinSourceLineIndex *index) {
+	if (!index) {
+		return;
+	}
+	free(index->data);
+	free(index->blocks);
+	rz_pvector_fini(&index->files);
+	rz_str_constpool_fini(&index->filename_pool);
+	free(index);
+}
+
+RZ_API size_t rz_bin_source_line_index_count(RZ_NONNULL const RzBinSourceLineIndex *index) {
+	rz_return_val_if_fail(index, 0);
+	return index->samples_count;
+}
+
+typedef struct {
+	const RzBinSourceLineIndex *index;
+	size_t i; ///< index of the next sample
+	const ut8 *p;
+	RzBinSourceLineSample sample;
+} LineCursor;
+
+static void line_cursor_seek_block(LineCursor *c, const RzBinSourceLineIndex *index, size_t block) {
+	c->index = index;
+	c->i = block * LINE_BLOCK_SAMPLES;
+	c->p = NULL;
+}
+
+static bool line_cursor_next(LineCursor *c) {
+	const RzBinSourceLineIndex *index = c->index;
+	if (c->i >= index->samples_count) {
+		return false;
+	}
+	if (!(c->i % LINE_BLOCK_SAMPLES)) {
+		// every block is encoded from scratch
+		c->p = index->data + index->blocks[c->i / LINE_BLOCK_SAMPLES].offset;
+		memset(&c->sample, 0, sizeof(c->sample));
+	}
+	ut64 file_id;
+	c->p = line_sample_decode(c->p, &c->sample, &file_id, &index->files);
+	c->i++;
+	return true;
+}
+
+/**
+ * \brief Calls \p cb on all the samples, sorted by address
+ *
+ * \return false if \p cb stopped the iteration
+ */
+RZ_API bool rz_bin_source_line_index_foreach(RZ_NONNULL const RzBinSourceLineIndex *index, RZ_NONNULL RzBinSourceLineSampleCb cb, void *user) {
+	rz_return_val_if_fail(index && cb, false);
+	LineCursor c;
+	line_cursor_seek_block(&c, index, 0);
+	while (line_cursor_next(&c)) {
+		if (!cb(user, &c.sample)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * \brief Calls \p cb on the samples that affect \p addr
+ *
+ * These are the samples at the highest address less or equal to \p addr,
+ * the same as rz_bin_source_line_info_get_first_at() and rz_bin_source_line_info_get_next() return.
+ *
+ * \return false if \p cb stopped the iteration
+ */
+RZ_API bool rz_bin_source_line_index_foreach_at(RZ_NONNULL const RzBinSourceLineIndex *index, ut64 addr, RZ_NONNULL RzBinSourceLineSampleCb cb, void *user) {
+	rz_return_val_if_fail(index && cb, false);
+	// find the last block starting at or before addr
+	size_t lo = 0, hi = index->blocks_count;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (index->blocks[mid].address <= addr) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	if (!lo) {
+		return true;
+	}
+	size_t block = lo - 1;
+	// the address of the samples affecting addr is the last one <= addr of this block,
+	// remember where the first sample at it begins to not decode the block again
+	LineCursor c, start;
+	line_cursor_seek_block(&c, index, block);
+	start = c;
+	ut64 target = index->blocks[block].address;
+	while (true) {
+		LineCursor prev = c;
+		if (!line_cursor_next(&c) || c.sample.address > addr) {
+			break;
+		}
+		if (c.sample.address != target) {
+			target = c.sample.address;
+			start = prev;
+		}
+	}
+	if (block && index->blocks[block].address == target) {
+		// the samples at that address may begin in the previous blocks
+		while (block && index->blocks[block].address == target) {
+			block--;
+		}
+		line_cursor_seek_block(&start, index, block);
+	}
+	bool first = true;
+	while (line_cursor_next(&start) && start.sample.address <= target) {
+		if (start.sample.address < target) {
+			continue;
+		}
+		if (first && rz_bin_source_line_sample_is_closing(&start.sample)) {
+			// the closing sample is alone at its address
+			break;
+		}
+		first = false;
+		if (!cb(user, &start.sample)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+typedef struct {
+	ut64 addr;
+	bool want_file;
+	RzBinSourceLineSample sample;
+	bool found;
+} ExactSampleCtx;
+
+static bool exact_sample_cb(void *user, const RzBinSourceLineSample *sample) {
+	ExactSampleCtx *ctx = user;
+	if (sample->address != ctx->addr) {
+		// consider only exact matches, not inside of samples
+		return false;
+	}
+	if (ctx->want_file && !sample->file) {
+		return true;
+	}
+	ctx->sample = *sample;
+	ctx->found = true;
+	return false;
+}
+
 RZ_API bool rz_bin_addr2line(RzBin *bin, ut64 addr, char *file, int len, int *line) {
 	rz_return_val_if_fail(bin, false);
 	if (!bin->cur || !bin->cur->o || !bin->cur->o->lines) {
 		return false;
 	}
-	const RzBinSourceLineSample *s = rz_bin_source_line_info_get_first_at(bin->cur->o->lines, addr);
-	if (!s || s->address != addr) {
-		// consider only exact matches, not inside of samples
+	ExactSampleCtx ctx = { .addr = addr };
+	rz_bin_source_line_index_foreach_at(bin->cur->o->lines, addr, exact_sample_cb, &ctx);
+	if (!ctx.found) {
 		return false;
 	}
+	const RzBinSourceLineSample *s = &ctx.sample;
 	if (line) {
 		*line = s->line;
 	}
@@ -219,17 +701,12 @@ RZ_API char *rz_bin_addr2text(RzBin *bin, ut64 addr, int origin) {
 	if (!bin->cur || !bin->cur->o || !bin->cur->o->lines) {
 		return NULL;
 	}
-	const RzBinSourceLineSample *s = rz_bin_source_line_info_get_first_at(bin->cur->o->lines, addr);
-	if (s && s->address != addr) {
-		// consider only exact matches, not inside of samples
-		return NULL;
-	}
-	while (s && !s->file) {
-		s = rz_bin_source_line_info_get_next(bin->cur->o->lines, s);
-	}
-	if (!s) {
+	ExactSampleCtx ctx = { .addr = addr, .want_file = true };
+	rz_bin_source_line_index_foreach_at(bin->cur->o->lines, addr, exact_sample_cb, &ctx);
+	if (!ctx.found) {
 		return NULL;
 	}
+	const RzBinSourceLineSample *s = &ctx.sample;
 	const char *file_nopath;
 	if (origin > 1) {
 		file_nopath = s->file;
@@ -835,28 +835,44 @@ RZ_API void rz_bin_dwarf_line_header_reset_regs(const RzBinDwarfLineHeader *hdr,
 	regs->isa = 0;
 }
 
-static void store_line_sample(RzBinSourceLineInfoBuilder *bob, const RzBinDwarfLineHeader *hdr, RzBinDwarfSMRegisters *regs,
+/**
+ * \brief Where the line samples produced by running the line ops go
+ */
+typedef struct {
+	RzBinSourceLineInfoBuilder *bob; ///< if not NULL, the samples are pushed to it
+	RzBinSourceLineSampleCb cb; ///< otherwise they are passed to this callback
+	void *user;
+	bool stop; ///< set when cb asked to stop
+} LineSink;
+
+static void line_sink_push(LineSink *sink, ut64 address, ut32 line, ut32 column, const char *file) {
+	if (sink->bob) {
+		rz_bin_source_line_info_builder_push_sample(sink->bob, address, line, column, file);
+		return;
+	}
+	RzBinSourceLineSample sample = { .address = address, .line = line, .column = column, .file = file };
+	if (!sink->stop && !sink->cb(sink->user, &sample)) {
+		sink->stop = true;
+	}
+}
+
+static void store_line_sample(LineSink *sink, const RzBinDwarfLineHeader *hdr, RzBinDwarfSMRegisters *regs,
 	RZ_NULLABLE RzBinDwarfDebugInfo *info, RZ_NULLABLE RzBinDwarfLineFileCache fnc) {
 	const char *file = NULL;
 	if (regs->file) {
 		file = get_full_file_path(info, hdr, fnc, regs->file - 1);
 	}
-	rz_bin_source_line_info_builder_push_sample(bob, regs->address, (ut32)regs->line, (ut32)regs->column, file);
+	line_sink_push(sink, regs->address, (ut32)regs->line, (ut32)regs->column, file);
 }
 
-/**
- * \brief Execute a single line op on regs and optionally store the resulting line info in bob
- * \param fnc if not null, filenames will be resolved to their full paths using this cache.
- */
-RZ_API bool rz_bin_dwarf_line_op_run(const RzBinDwarfLineHeader *hdr, RzBinDwarfSMRegisters *regs, RzBinDwarfLineOp *op,
-	RZ_NULLABLE RzBinSourceLineInfoBuilder *bob, RZ_NULLABLE RzBinDwarfDebugInfo *info, RZ_NULLABLE RzBinDwarfLineFileCache fnc) {
-	rz_return_val_if_fail(hdr && regs && op, false);
+static bool line_op_run(const RzBinDwarfLineHeader *hdr, RzBinDwarfSMRegisters *regs, RzBinDwarfLineOp *op,
+	RZ_NULLABLE LineSink *sink, RZ_NULLABLE RzBinDwarfDebugInfo *info, RZ_NULLABLE RzBinDwarfLineFileCache fnc) {
 	switch (op->type) {
 	case RZ_BIN_DWARF_LINE_OP_TYPE_STD:
 		switch (op->opcode) {
 		case DW_LNS_copy:
-			if (bob) {
-				store_line_sample(bob, hdr, regs, info, fnc);
+			if (sink) {
+				store_line_sample(sink, hdr, regs, info, fnc);
 			}
 			regs->basic_block = DWARF_FALSE;
 			break;
@@ -901,9 +917,9 @@ RZ_API bool rz_bin_dwarf_line_op_run(const RzBinDwarfLineHeader *hdr, RzBinDwarf
 		switch (op->opcode) {
 		case DW_LNE_end_sequence:
 			regs->end_sequence = DWARF_TRUE;
-			if (bob) {
+			if (sink) {
 				// closing entry
-				rz_bin_source_line_info_builder_push_sample(bob, regs->address, 0, 0, NULL);
+				line_sink_push(sink, regs->address, 0, 0, NULL);
 			}
 			rz_bin_dwarf_line_header_reset_regs(hdr, regs);
 			break;
@@ -922,8 +938,8 @@ RZ_API bool rz_bin_dwarf_line_op_run(const RzBinDwarfLineHeader *hdr, RzBinDwarf
 	case RZ_BIN_DWARF_LINE_OP_TYPE_SPEC:
 		regs->address += rz_bin_dwarf_line_header_get_spec_op_advance_pc(hdr, op->opcode);
 		regs->line += rz_bin_dwarf_line_header_get_spec_op_advance_line(hdr, op->opcode);
-		if (bob) {
-			store_line_sample(bob, hdr, regs, info, fnc);
+		if (sink) {
+			store_line_sample(sink, hdr, regs, info, fnc);
 		}
 		regs->basic_block = DWARF_FALSE;
 		regs->prologue_end = DWARF_FALSE;
@@ -936,9 +952,20 @@ RZ_API bool rz_bin_dwarf_line_op_run(const RzBinDwarfLineHeader *hdr, RzBinDwarf
 	return true;
 }
 
+/**
+ * \brief Execute a single line op on regs and optionally store the resulting line info in bob
+ * \param fnc if not null, filenames will be resolved to their full paths using this cache.
+ */
+RZ_API bool rz_bin_dwarf_line_op_run(const RzBinDwarfLineHeader *hdr, RzBinDwarfSMRegisters *regs, RzBinDwarfLineOp *op,
+	RZ_NULLABLE RzBinSourceLineInfoBuilder *bob, RZ_NULLABLE RzBinDwarfDebugInfo *info, RZ_NULLABLE RzBinDwarfLineFileCache fnc) {
+	rz_return_val_if_fail(hdr && regs && op, false);
+	LineSink sink = { .bob = bob };
+	return line_op_run(hdr, regs, op, bob ? &sink : NULL, info, fnc);
+}
+
 static size_t parse_opcodes(const ut8 *obuf,
 	size_t len, const RzBinDwarfLineHeader *hdr, RzVector *ops_out,
-	RzBinDwarfSMRegisters *regs, RZ_NULLABLE RzBinSourceLineInfoBuilder *bob, RZ_NULLABLE RzBinDwarfDebugInfo *info,
+	RzBinDwarfSMRegisters *regs, RZ_NULLABLE LineSink *sink, RZ_NULLABLE RzBinDwarfDebugInfo *info,
 	RZ_NULLABLE RzBinDwarfLineFileCache fnc, bool big_endian, ut8 target_addr_size) {
 	const ut8 *buf, *buf_end;
 	ut8 opcode;
@@ -949,7 +976,7 @@ static size_t parse_opcodes(const ut8 *obuf,
 	buf = obuf;
 	buf_end = obuf + len;
 
-	while (buf < buf_end) {
+	while (buf < buf_end && !(sink && sink->stop)) {
 		opcode = *buf++;
 		RzBinDwarfLineOp op = { 0 };
 		if (!opcode) {
@@ -964,8 +991,8 @@ static size_t parse_opcodes(const ut8 *obuf,
 		if (!buf) {
 			break;
 		}
-		if (bob) {
-			rz_bin_dwarf_line_op_run(hdr, regs, &op, bob, info, fnc);
+		if (sink) {
+			line_op_run(hdr, regs, &op, sink, info, fnc);
 		}
 		if (ops_out) {
 			rz_vector_push(ops_out, &op);
@@ -993,8 +1020,12 @@ static void line_unit_free(RzBinDwarfLineUnit *unit) {
 	free(unit);
 }
 
+/**
+ * \param sink if not NULL, the line samples are passed to it instead of being collected in the
+ *             result, whose units are not kept either
+ */
 static RzBinDwarfLineInfo *parse_line_raw(RzBinFile *binfile, const ut8 *obuf,
-	ut64 len, RzBinDwarfLineInfoMask mask, bool big_endian, RZ_NULLABLE RzBinDwarfDebugInfo *info) {
+	ut64 len, RzBinDwarfLineInfoMask mask, bool big_endian, RZ_NULLABLE RzBinDwarfDebugInfo *info, RZ_NULLABLE LineSink *sink) {
 	// Dwarf 3 Standard 6.2 Line Number Information
 	rz_return_val_if_fail(binfile && obuf, NULL);
 
@@ -1019,12 +1050,16 @@ static RzBinDwarfLineInfo *parse_line_raw(RzBinFile *binfile, const ut8 *obuf,
 	}
 
 	RzBinSourceLineInfoBuilder bob;
-	if (mask & RZ_BIN_DWARF_LINE_INFO_MASK_LINES) {
+	LineSink bob_sink = { .bob = &bob };
+	if (sink) {
+		mask = RZ_BIN_DWARF_LINE_INFO_MASK_LINES;
+	} else if (mask & RZ_BIN_DWARF_LINE_INFO_MASK_LINES) {
 		rz_bin_source_line_info_builder_init(&bob);
+		sink = &bob_sink;
 	}
 
 	// each iteration we read one header AKA comp. unit
-	while (buf <= buf_end) {
+	while (buf <= buf_end && !(sink && sink->stop)) {
 		RzBinDwarfLineUnit *unit = RZ_NEW0(RzBinDwarfLineUnit);
 		if (!unit) {
 			break;
@@ -1077,7 +1112,7 @@ static RzBinDwarfLineInfo *parse_line_raw(RzBinFile *binfile, const ut8 *obuf,
 			// reads one whole sequence
 			tmp_read = parse_opcodes(buf, buf_size - bytes_read, &unit->header,
 				(mask & RZ_BIN_DWARF_LINE_INFO_MASK_OPS) ? &ops : NULL, &regs,
-				(mask & RZ_BIN_DWARF_LINE_INFO_MASK_LINES) ? &bob : NULL,
+				(mask & RZ_BIN_DWARF_LINE_INFO_MASK_LINES) ? sink : NULL,
 				info, fnc, big_endian, target_addr_size);
 			bytes_read += tmp_read;
 			buf += tmp_read; // Move in the buffer forward
@@ -1095,9 +1130,13 @@ static RzBinDwarfLineInfo *parse_line_raw(RzBinFile *binfile, const ut8 *obuf,
 			line_unit_free(unit);
 			break;
 		}
+		if (sink && sink != &bob_sink) {
+			line_unit_free(unit);
+			continue;
+		}
 		rz_list_push(li->units, unit);
 	}
-	if (mask & RZ_BIN_DWARF_LINE_INFO_MASK_LINES) {
+	if (sink == &bob_sink) {
 		li->lines = rz_bin_source_line_info_builder_build_and_fini(&bob);
 	}
 	return li;
@@ -1380,6 +1419,43 @@ static void free_attr_value(RzBinDwarfAttrValue *val) {
 	};
 }
 
+/**
+ * \brief Where the DIEs of a compilation unit are in .debug_info
+ */
+typedef struct {
+	size_t data; ///< offset of the first DIE of the unit
+	size_t data_end; ///< offset after the last DIE of the unit
+	size_t first_abbr_idx; ///< index of the first abbreviation of the unit in the abbrev array
+	bool loaded; ///< whether the DIEs of the unit are decoded
+} UnitSource;
+
+/**
+ * \brief What is needed to decode the DIEs of the compilation units
+ *
+ * It is kept by the lazily parsed debug info to decode the units on demand.
+ */
+struct rz_bin_dwarf_info_source_t {
+	ut8 *buf; ///< .debug_info contents
+	size_t len;
+	ut8 *debug_str; ///< .debug_str contents
+	size_t debug_str_len;
+	bool big_endian;
+	const RzBinDwarfDebugAbbrev *da; ///< borrowed, see rz_bin_dwarf_parse_info_lazy()
+	RzVector /*<UnitSource>*/ units; ///< one for each element of RzBinDwarfDebugInfo.comp_units
+};
+
+typedef struct rz_bin_dwarf_info_source_t InfoSource;
+
+static void info_source_free(InfoSource *src) {
+	if (!src) {
+		return;
+	}
+	free(src->buf);
+	free(src->debug_str);
+	rz_vector_fini(&src->units);
+	free(src);
+}
+
 static void free_die(RzBinDwarfDie *die) {
 	size_t i;
 	if (!die) {
@@ -1414,6 +1490,7 @@ RZ_API void rz_bin_dwarf_debug_info_free(RzBinDwarfDebugInfo *inf) {
 	ht_up_free(inf->line_info_offset_comp_dir);
 	ht_up_free(inf->lookup_table);
 	free(inf->comp_units);
+	info_source_free(inf->source);
 	free(inf);
 }
 
@@ -1711,7 +1788,6 @@ static const ut8 *parse_attr_value(const ut8 *obuf, int obuf_len,
 /**
  * \param buf Start of the DIE data
  * \param buf_end
- * \param info debug info where the line_info_offset_comp_dir will be populated if such an entry is found
  * \param abbrev Abbreviation of the DIE
  * \param hdr Unit header
  * \param die DIE to store the parsed info into
@@ -1719,11 +1795,9 @@ static const ut8 *parse_attr_value(const ut8 *obuf, int obuf_len,
  * \param debug_str_len Length of the string section
  * \return const ut8* Updated buffer
  */
-static const ut8 *parse_die(const ut8 *buf, const ut8 *buf_end, RzBinDwarfDebugInfo *info, RzBinDwarfAbbrevDecl *abbrev,
+static const ut8 *parse_die(const ut8 *buf, const ut8 *buf_end, RzBinDwarfAbbrevDecl *abbrev,
 	RzBinDwarfCompUnitHdr *hdr, RzBinDwarfDie *die, const ut8 *debug_str, size_t debug_str_len, bool big_endian) {
 	size_t i;
-	const char *comp_dir = NULL;
-	ut64 line_info_offset = UT64_MAX;
 	if (abbrev->count) {
 		for (i = 0; i < abbrev->count - 1; i++) {
 			memset(&die->attr_values[i], 0, sizeof(die->attr_values[i]));
@@ -1731,24 +1805,33 @@ static const ut8 *parse_die(const ut8 *buf, const ut8 *buf_end, RzBinDwarfDebugI
 			buf = parse_attr_value(buf, buf_end - buf, &abbrev->defs[i],
 				&die->attr_values[i], hdr, debug_str, debug_str_len, big_endian);
 
-			RzBinDwarfAttrValue *attribute = &die->attr_values[i];
-
-			if (attribute->attr_name == DW_AT_comp_dir && (attribute->attr_form == DW_FORM_strp || attribute->attr_form == DW_FORM_string) && attribute->string.content) {
-				comp_dir = attribute->string.content;
-			}
-			if (attribute->attr_name == DW_AT_stmt_list) {
-				if (attribute->kind == DW_AT_KIND_CONSTANT) {
-					line_info_offset = attribute->uconstant;
-				} else if (attribute->kind == DW_AT_KIND_REFERENCE) {
-					line_info_offset = attribute->reference;
-				}
-			}
 			die->count++;
 		}
 	}
+	return buf;
+}
 
-	// If this is a compilation unit dir attribute, we want to cache it so the line info parsing
-	// which will need this info can quickly look it up.
+/**
+ * \brief Caches the DW_AT_comp_dir of \p die by its DW_AT_stmt_list, if it has both
+ *
+ * The line info parsing, which needs this info, can then quickly look it up.
+ */
+static void index_comp_dir(RzBinDwarfDebugInfo *info, const RzBinDwarfDie *die) {
+	const char *comp_dir = NULL;
+	ut64 line_info_offset = UT64_MAX;
+	for (size_t i = 0; i < die->count; i++) {
+		const RzBinDwarfAttrValue *attribute = &die->attr_values[i];
+		if (attribute->attr_name == DW_AT_comp_dir && (attribute->attr_form == DW_FORM_strp || attribute->attr_form == DW_FORM_string) && attribute->string.content) {
+			comp_dir = attribute->string.content;
+		}
+		if (attribute->attr_name == DW_AT_stmt_list) {
+			if (attribute->kind == DW_AT_KIND_CONSTANT) {
+				line_info_offset = attribute->uconstant;
+			} else if (attribute->kind == DW_AT_KIND_REFERENCE) {
+				line_info_offset = attribute->reference;
+			}
+		}
+	}
 	if (comp_dir && line_info_offset != UT64_MAX) {
 		char *name = strdup(comp_dir);
 		if (name) {
@@ -1757,30 +1840,31 @@ static const ut8 *parse_die(const ut8 *buf, const ut8 *buf_end, RzBinDwarfDebugI
 			}
 		}
 	}
-
-	return buf;
 }
 
 /**
  * @brief Reads throught comp_unit buffer and parses all its DIEntries
  *
+ * It only touches \p unit, so distinct units can be parsed in parallel.
+ *
  * @param buf_start Start of the compilation unit data
+ * @param buf_end End of the compilation unit data
  * @param unit Unit to store the newly parsed information
  * @param abbrevs Parsed abbrev section info of *all* abbreviations
  * @param first_abbr_idx index for first abbrev of the current comp unit in abbrev array
  * @param debug_str Ptr to string section start
  * @param debug_str_len Length of the string section
+ * @param max_dies Stop after parsing this number of DIEs
  *
  * @return const ut8* Update buffer
  */
-static const ut8 *parse_comp_unit(RzBinDwarfDebugInfo *info, const ut8 *buf_start,
+static const ut8 *parse_comp_unit(const ut8 *buf_start, const ut8 *buf_end,
 	RzBinDwarfCompUnit *unit, const RzBinDwarfDebugAbbrev *abbrevs,
-	size_t first_abbr_idx, const ut8 *debug_str, size_t debug_str_len, bool big_endian) {
+	size_t first_abbr_idx, const ut8 *debug_str, size_t debug_str_len, bool big_endian, size_t max_dies) {
 
 	const ut8 *buf = buf_start;
-	const ut8 *buf_end = buf_start + unit->hdr.length - unit->hdr.header_size;
 
-	while (buf && buf < buf_end && buf >= buf_start) {
+	while (buf && buf < buf_end && buf >= buf_start && unit->count < max_dies) {
 		if (unit->count && unit->capacity == unit->count) {
 			expand_cu(unit);
 		}
@@ -1819,7 +1903,7 @@ static const ut8 *parse_comp_unit(RzBinDwarfDebugInfo *info, const ut8 *buf_star
 		die->tag = abbrev->tag;
 		die->has_children = abbrev->has_children;
 
-		buf = parse_die(buf, buf_end, info, abbrev, &unit->hdr, die, debug_str, debug_str_len, big_endian);
+		buf = parse_die(buf, buf_end, abbrev, &unit->hdr, die, debug_str, debug_str_len, big_endian);
 		if (!buf) {
 			return NULL;
 		}
@@ -1884,33 +1968,13 @@ static int expand_info(RzBinDwarfDebugInfo *info) {
 }
 
 /**
- * @brief Parses whole .debug_info section
- *
- * @param da Parsed Abbreviations
- * @param obuf .debug_info section buffer start
- * @param len length of the section buffer
- * @param debug_str start of the .debug_str section
- * @param debug_str_len length of the debug_str section
- * @param big_endian
- * @return RZ_API* parse_info_raw Parsed information
+ * \brief Reads the headers of all the compilation units, without decoding their DIEs
  */
-static RzBinDwarfDebugInfo *parse_info_raw(RzBinDwarfDebugAbbrev *da,
-	const ut8 *obuf, size_t len,
-	const ut8 *debug_str, size_t debug_str_len, bool big_endian) {
-
-	rz_return_val_if_fail(da && obuf, false);
-
+static bool scan_comp_units(RzBinDwarfDebugInfo *info, InfoSource *src) {
+	const RzBinDwarfDebugAbbrev *da = src->da;
+	const ut8 *obuf = src->buf;
 	const ut8 *buf = obuf;
-	const ut8 *buf_end = obuf + len;
-
-	RzBinDwarfDebugInfo *info = RZ_NEW0(RzBinDwarfDebugInfo);
-	if (!info) {
-		return NULL;
-	}
-	if (!init_debug_info(info)) {
-		goto cleanup;
-	}
-	int unit_idx = 0;
+	const ut8 *buf_end = obuf + src->len;
 
 	while (buf < buf_end) {
 		if (info->count >= info->capacity) {
@@ -1918,22 +1982,15 @@ static RzBinDwarfDebugInfo *parse_info_raw(RzBinDwarfDebugAbbrev *da,
 				break;
 			}
 		}
-
-		RzBinDwarfCompUnit *unit = &info->comp_units[unit_idx];
-		if (init_comp_unit(unit) < 0) {
-			unit_idx--;
-			goto cleanup;
-		}
-		info->count++;
-
+		RzBinDwarfCompUnit *unit = &info->comp_units[info->count];
 		unit->offset = buf - obuf;
 		// small redundancy, because it was easiest solution at a time
 		unit->hdr.unit_offset = buf - obuf;
 
-		buf = info_comp_unit_read_hdr(buf, buf_end, &unit->hdr, big_endian);
+		const ut8 *data = info_comp_unit_read_hdr(buf, buf_end, &unit->hdr, src->big_endian);
 
-		if (unit->hdr.length > len) {
-			goto cleanup;
+		if (unit->hdr.length > src->len) {
+			return false;
 		}
 
 		if (da->decls->count >= da->capacity) {
@@ -1947,22 +2004,136 @@ static RzBinDwarfDebugInfo *parse_info_raw(RzBinDwarfDebugAbbrev *da,
 		RzBinDwarfAbbrevDecl key = { .offset = unit->hdr.abbrev_offset };
 		RzBinDwarfAbbrevDecl *abbrev_start = bsearch(&key, da->decls, da->count, sizeof(key), abbrev_cmp);
 		if (!abbrev_start) {
-			goto cleanup;
+			return false;
 		}
+		UnitSource *us = rz_vector_push(&src->units, NULL);
+		if (!us) {
+			return false;
+		}
+		info->count++;
+
+		// the length field is not included in the unit length
+		ut64 unit_size = unit->hdr.length + (unit->hdr.is_64bit ? 12 : 4);
+		ut64 left = buf_end - buf;
 		// They point to the same array object, so should be def. behaviour
-		size_t first_abbr_idx = abbrev_start - da->decls;
+		us->first_abbr_idx = abbrev_start - da->decls;
+		us->data_end = (buf - obuf) + RZ_MIN(unit_size, left);
+		us->data = RZ_MIN(data - obuf, us->data_end);
+		us->loaded = false;
+		if (unit_size >= left) {
+			break;
+		}
+		buf += unit_size;
+	}
+	return true;
+}
 
-		buf = parse_comp_unit(info, buf, unit, da, first_abbr_idx, debug_str, debug_str_len, big_endian);
+static bool load_comp_unit(const InfoSource *src, RzBinDwarfCompUnit *unit, const UnitSource *us, size_t max_dies) {
+	if (init_comp_unit(unit) < 0) {
+		return false;
+	}
+	return parse_comp_unit(src->buf + us->data, src->buf + us->data_end, unit, src->da,
+		       us->first_abbr_idx, src->debug_str, src->debug_str_len, src->big_endian, max_dies) != NULL;
+}
 
-		if (!buf) {
+static void unload_comp_unit(RzBinDwarfCompUnit *unit) {
+	free_comp_unit(unit);
+	unit->count = 0;
+	unit->capacity = 0;
+}
+
+static void index_comp_unit_dies(RzBinDwarfDebugInfo *info, RzBinDwarfCompUnit *unit) {
+	for (size_t i = 0; i < unit->count; i++) {
+		RzBinDwarfDie *die = &unit->dies[i];
+		ht_up_insert(info->lookup_table, die->offset, die);
+	}
+	info->n_dwarf_dies += unit->count;
+}
+
+typedef struct {
+	RzBinDwarfDebugInfo *info;
+	const InfoSource *src;
+} ParseUnitsCtx;
+
+static void parse_units_range(size_t from, size_t to, void *user) {
+	ParseUnitsCtx *ctx = user;
+	for (size_t i = from; i < to; i++) {
+		UnitSource *us = rz_vector_index_ptr((RzVector *)&ctx->src->units, i);
+		us->loaded = load_comp_unit(ctx->src, &ctx->info->comp_units[i], us, SIZE_MAX);
+	}
+}
+
+/**
+ * @brief Parses whole .debug_info section
+ *
+ * The unit headers are read first, then the units are decoded one by one, or
+ * in parallel on \p pool. When \p lazy is set, only the first DIE of each unit
+ * is decoded, to get its directory, and the rest is left to
+ * rz_bin_dwarf_debug_info_get_unit().
+ *
+ * @param src The sections to parse
+ * @param pool Pool to decode the units on, can be NULL
+ * @param lazy Whether to decode the DIEs on demand
+ * @return RZ_API* parse_info_raw Parsed information
+ */
+static RzBinDwarfDebugInfo *parse_info_raw(InfoSource *src, RzThreadTaskPool *pool, bool lazy) {
+	RzBinDwarfDebugInfo *info = RZ_NEW0(RzBinDwarfDebugInfo);
+	if (!info) {
+		return NULL;
+	}
+	if (!init_debug_info(info) || !scan_comp_units(info, src)) {
+		goto cleanup;
+	}
+
+	size_t i;
+	if (lazy) {
+		for (i = 0; i < info->count; i++) {
+			RzBinDwarfCompUnit *unit = &info->comp_units[i];
+			// DW_AT_comp_dir is in the unit DIE, which comes first
+			if (!load_comp_unit(src, unit, rz_vector_index_ptr(&src->units, i), 1)) {
+				goto cleanup;
+			}
+			if (unit->count) {
+				index_comp_dir(info, &unit->dies[0]);
+			}
+			unload_comp_unit(unit);
+		}
+		info->lookup_table = ht_up_new(NULL, NULL, NULL);
+		if (!info->lookup_table) {
 			goto cleanup;
 		}
+		return info;
+	}
 
-		info->n_dwarf_dies += unit->count;
-
-		unit_idx++;
+	ParseUnitsCtx ctx = { .info = info, .src = src };
+	if (pool && info->count > 1) {
+		if (!rz_th_task_pool_parallel_for(pool, 0, info->count, 1, parse_units_range, &ctx)) {
+			goto cleanup;
+		}
+	} else {
+		parse_units_range(0, info->count, &ctx);
+	}
+	for (i = 0; i < info->count; i++) {
+		UnitSource *us = rz_vector_index_ptr(&src->units, i);
+		if (!us->loaded) {
+			goto cleanup;
+		}
+		info->n_dwarf_dies += info->comp_units[i].count;
 	}
 
+	info->lookup_table = ht_up_new_size(info->n_dwarf_dies, NULL, NULL, NULL);
+	if (!info->lookup_table) {
+		goto cleanup;
+	}
+	// build hashtable after whole parsing because of possible relocations
+	info->n_dwarf_dies = 0;
+	for (i = 0; i < info->count; i++) {
+		RzBinDwarfCompUnit *unit = &info->comp_units[i];
+		for (size_t j = 0; j < unit->count; j++) {
+			index_comp_dir(info, &unit->dies[j]);
+		}
+		index_comp_unit_dies(info, unit);
+	}
 	return info;
 
 cleanup:
@@ -2065,6 +2236,25 @@ static ut8 *get_section_bytes(RzBinFile *binfile, const char *sect_name, size_t
 	return buf;
 }
 
+static RzBinDwarfDebugInfo *parse_info(RzBinFile *binfile, RzBinDwarfDebugAbbrev *da, RzThreadTaskPool *pool, bool lazy) {
+	InfoSource *src = RZ_NEW0(InfoSource);
+	if (!src) {
+		return NULL;
+	}
+	rz_vector_init(&src->units, sizeof(UnitSource), NULL, NULL);
+	src->da = da;
+	src->big_endian = binfile->o && binfile->o->info && binfile->o->info->big_endian;
+	src->debug_str = get_section_bytes(binfile, "debug_str", &src->debug_str_len);
+	src->buf = get_section_bytes(binfile, "debug_info", &src->len);
+	RzBinDwarfDebugInfo *info = src->buf ? parse_info_raw(src, pool, lazy) : NULL;
+	if (info && lazy) {
+		info->source = src;
+	} else {
+		info_source_free(src);
+	}
+	return info;
+}
+
 /**
  * @brief Parses .debug_info section
  *
@@ -2074,43 +2264,112 @@ static ut8 *get_section_bytes(RzBinFile *binfile, const char *sect_name, size_t
  */
 RZ_API RzBinDwarfDebugInfo *rz_bin_dwarf_parse_info(RzBinFile *binfile, RzBinDwarfDebugAbbrev *da) {
 	rz_return_val_if_fail(binfile && da, NULL);
-	RzBinDwarfDebugInfo *info = NULL;
+	return parse_info(binfile, da, NULL, false);
+}
+
+/**
+ * \brief Parses .debug_info section, decoding the compilation units in parallel on \p pool
+ *
+ * The result is the same as rz_bin_dwarf_parse_info().
+ *
+ * \param pool Pool to decode the units on, NULL to decode them on the calling thread
+ * \return NULL on error or if \p pool was breaked
+ */
+RZ_API RZ_OWN RzBinDwarfDebugInfo *rz_bin_dwarf_parse_info_parallel(RZ_NONNULL RzBinFile *binfile, RZ_NONNULL RzBinDwarfDebugAbbrev *da, RZ_NULLABLE RzThreadTaskPool *pool) {
+	rz_return_val_if_fail(binfile && da, NULL);
+	return parse_info(binfile, da, pool, false);
+}
 
-	size_t debug_str_len = 0;
-	ut8 *debug_str_buf = get_section_bytes(binfile, "debug_str", &debug_str_len);
+/**
+ * \brief Reads the compilation unit headers of .debug_info, leaving their DIEs to decode on demand
+ *
+ * The units have no DIEs until they are loaded by rz_bin_dwarf_debug_info_get_unit()
+ * or rz_bin_dwarf_debug_info_get_die(), and lookup_table only holds the DIEs of the
+ * loaded units. The directories of the units are available right away.
+ * The result is not thread safe and \p da must outlive it.
+ */
+RZ_API RZ_OWN RzBinDwarfDebugInfo *rz_bin_dwarf_parse_info_lazy(RZ_NONNULL RzBinFile *binfile, RZ_NONNULL RzBinDwarfDebugAbbrev *da) {
+	rz_return_val_if_fail(binfile && da, NULL);
+	return parse_info(binfile, da, NULL, true);
+}
 
-	size_t len;
-	ut8 *buf = get_section_bytes(binfile, "debug_info", &len);
-	if (!buf) {
-		goto cave_debug_str_buf;
+/**
+ * \brief Returns the compilation unit at \p index, decoding its DIEs if they are not yet
+ *
+ * \return The unit, or NULL if its DIEs are malformed
+ */
+RZ_API RZ_BORROW RzBinDwarfCompUnit *rz_bin_dwarf_debug_info_get_unit(RZ_NONNULL RzBinDwarfDebugInfo *info, size_t index) {
+	rz_return_val_if_fail(info && index < info->count, NULL);
+	RzBinDwarfCompUnit *unit = &info->comp_units[index];
+	InfoSource *src = info->source;
+	if (!src) {
+		return unit;
+	}
+	UnitSource *us = rz_vector_index_ptr(&src->units, index);
+	if (us->loaded) {
+		return unit;
+	}
+	if (!load_comp_unit(src, unit, us, SIZE_MAX)) {
+		unload_comp_unit(unit);
+		return NULL;
 	}
-	info = parse_info_raw(da, buf, len, debug_str_buf, debug_str_len,
-		binfile->o && binfile->o->info && binfile->o->info->big_endian);
-	if (!info) {
-		goto cave_buf;
+	us->loaded = true;
+	index_comp_unit_dies(info, unit);
+	return unit;
+}
+
+/**
+ * \brief Frees the DIEs of the unit at \p index of a lazily parsed debug info
+ *
+ * They are decoded again the next time they are needed. The DIEs of a
+ * debug info not parsed by rz_bin_dwarf_parse_info_lazy() are never freed.
+ */
+RZ_API void rz_bin_dwarf_debug_info_unload_unit(RZ_NONNULL RzBinDwarfDebugInfo *info, size_t index) {
+	rz_return_if_fail(info && index < info->count);
+	InfoSource *src = info->source;
+	if (!src) {
+		return;
 	}
-	info->lookup_table = ht_up_new_size(info->n_dwarf_dies, NULL, NULL, NULL);
-	if (!info->lookup_table) {
-		rz_bin_dwarf_debug_info_free(info);
-		info = NULL;
-		goto cave_buf;
+	UnitSource *us = rz_vector_index_ptr(&src->units, index);
+	if (!us->loaded) {
+		return;
 	}
-	// build hashtable after whole parsing because of possible relocations
-	if (info) {
-		size_t i, j;
-		for (i = 0; i < info->count; i++) {
-			RzBinDwarfCompUnit *unit = &info->comp_units[i];
-			for (j = 0; j < unit->count; j++) {
-				RzBinDwarfDie *die = &unit->dies[j];
-				ht_up_insert(info->lookup_table, die->offset, die); // optimization for further processing}
-			}
+	RzBinDwarfCompUnit *unit = &info->comp_units[index];
+	for (size_t i = 0; i < unit->count; i++) {
+		ht_up_delete(info->lookup_table, unit->dies[i].offset);
+	}
+	info->n_dwarf_dies -= unit->count;
+	unload_comp_unit(unit);
+	us->loaded = false;
+}
+
+/**
+ * \brief Returns the DIE at \p offset in .debug_info, decoding its unit if needed
+ */
+RZ_API RZ_BORROW RzBinDwarfDie *rz_bin_dwarf_debug_info_get_die(RZ_NONNULL RzBinDwarfDebugInfo *info, ut64 offset) {
+	rz_return_val_if_fail(info, NULL);
+	RzBinDwarfDie *die = ht_up_find(info->lookup_table, offset, NULL);
+	if (die || !info->source) {
+		return die;
+	}
+	// the units are sorted by offset, look for the last one starting before offset
+	size_t lo = 0, hi = info->count;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (info->comp_units[mid].offset <= offset) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
 		}
 	}
-cave_buf:
-	free(buf);
-cave_debug_str_buf:
-	free(debug_str_buf);
-	return info;
+	if (!lo) {
+		return NULL;
+	}
+	UnitSource *us = rz_vector_index_ptr(&info->source->units, lo - 1);
+	if (us->loaded || !rz_bin_dwarf_debug_info_get_unit(info, lo - 1)) {
+		return NULL;
+	}
+	return ht_up_find(info->lookup_table, offset, NULL);
 }
 
 /**
@@ -2124,11 +2383,35 @@ RZ_API RzBinDwarfLineInfo *rz_bin_dwarf_parse_line(RzBinFile *binfile, RZ_NULLAB
 		return NULL;
 	}
 	// Actually parse the section
-	RzBinDwarfLineInfo *r = parse_line_raw(binfile, buf, len, mask, binfile->o && binfile->o->info && binfile->o->info->big_endian, info);
+	RzBinDwarfLineInfo *r = parse_line_raw(binfile, buf, len, mask, binfile->o && binfile->o->info && binfile->o->info->big_endian, info, NULL);
 	free(buf);
 	return r;
 }
 
+/**
+ * \brief Runs all the line number programs of .debug_line, passing each line sample to \p cb
+ *
+ * Unlike rz_bin_dwarf_parse_line(), nothing is kept in memory besides the
+ * program being run, so the samples can be streamed into a compact structure
+ * like RzBinSourceLineIndexBuilder.
+ *
+ * \param info if not NULL, filenames can get resolved to absolute paths using the compilation unit dirs from it
+ * \return false if there is no line information or if \p cb stopped the iteration
+ */
+RZ_API bool rz_bin_dwarf_line_foreach_sample(RZ_NONNULL RzBinFile *binfile, RZ_NULLABLE RzBinDwarfDebugInfo *info, RZ_NONNULL RzBinSourceLineSampleCb cb, void *user) {
+	rz_return_val_if_fail(binfile && cb, false);
+	size_t len;
+	ut8 *buf = get_section_bytes(binfile, "debug_line", &len);
+	if (!buf) {
+		return false;
+	}
+	LineSink sink = { .cb = cb, .user = user };
+	RzBinDwarfLineInfo *r = parse_line_raw(binfile, buf, len, RZ_BIN_DWARF_LINE_INFO_MASK_LINES, binfile->o && binfile->o->info && binfile->o->info->big_endian, info, &sink);
+	free(buf);
+	rz_bin_dwarf_line_info_free(r);
+	return !sink.stop;
+}
+
 RZ_API RzList /*<RzBinDwarfARangeSet>*/ *rz_bin_dwarf_parse_aranges(RzBinFile *binfile) {
 	rz_return_val_if_fail(binfile, NULL);
 	size_t len;
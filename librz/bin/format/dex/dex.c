@@ -476,9 +476,27 @@ static bool dex_create_relocations(RzBinDex *dex) {
 	return dex->relocs_buffer;
 }
 
+/**
+ * \brief Reads a whole table of little endian 32 bits values with a single read
+ */
+static ut32 *dex_read_le32_table(RzBuffer *buf, ut64 offset, ut32 count) {
+	ut64 size = (ut64)count * sizeof(ut32);
+	ut32 *table = malloc(size);
+	if (!table) {
+		return NULL;
+	}
+	if (rz_buf_read_at(buf, offset, (ut8 *)table, size) != size) {
+		free(table);
+		return NULL;
+	}
+	for (ut32 i = 0; i < count; ++i) {
+		table[i] = rz_read_le32(&table[i]);
+	}
+	return table;
+}
+
 static bool dex_parse(RzBinDex *dex, ut64 base, RzBuffer *buf) {
 	ut64 offset = 0;
-	st64 read = 0;
 	st64 buffer_size = rz_buf_size(buf);
 	if (buffer_size < 116) {
 		// 116 bytes is the smalled dex that can be built.
@@ -530,35 +548,25 @@ static bool dex_parse(RzBinDex *dex, ut64 base, RzBuffer *buf) {
 	read_le32_or_fail(buf, dex->data_size, dex_parse_bad);
 	read_le32_or_fail(buf, dex->data_offset, dex_parse_bad);
 
-	/* Strings */
-	offset = dex->string_ids_offset;
-	if (!rz_pvector_reserve(dex->strings, dex->string_ids_size)) {
-		goto dex_parse_bad;
-	}
-	for (ut32 i = 0; i < dex->string_ids_size; ++i, offset += sizeof(ut32)) {
-		ut32 string_offset = 0;
-		read_le32_at_or_fail(buf, string_offset, offset, dex_parse_bad);
-
-		if (rz_buf_seek(buf, string_offset, RZ_BUF_SET) < 0) {
+	/* Strings, only the offsets are read here and each string is decoded on first use */
+	dex->base = base;
+	dex->buf = rz_buf_ref(buf);
+	if (dex->string_ids_size) {
+		dex->string_offsets = dex_read_le32_table(buf, dex->string_ids_offset, dex->string_ids_size);
+		if (!dex->string_offsets || !rz_pvector_reserve(dex->strings, dex->string_ids_size)) {
 			goto dex_parse_bad;
 		}
-		DexString *string = dex_string_new(buf, base + string_offset, &read);
-		if (!string) {
-			goto dex_parse_bad;
+		for (ut32 i = 0; i < dex->string_ids_size; ++i) {
+			rz_pvector_push(dex->strings, NULL);
 		}
-		rz_pvector_push(dex->strings, string);
 	}
 
 	/* Type Ids */
-	dex->types = RZ_NEWS0(DexTypeId, dex->type_ids_size);
-	if (!dex->types) {
-		goto dex_parse_bad;
-	}
-	if (rz_buf_seek(buf, dex->type_ids_offset, RZ_BUF_SET) < 0) {
-		goto dex_parse_bad;
-	}
-	for (ut32 i = 0; i < dex->type_ids_size; ++i) {
-		read_le32_or_fail(buf, dex->types[i], dex_parse_bad);
+	if (dex->type_ids_size) {
+		dex->types = dex_read_le32_table(buf, dex->type_ids_offset, dex->type_ids_size);
+		if (!dex->types) {
+			goto dex_parse_bad;
+		}
 	}
 
 	/* Proto Ids */
@@ -652,6 +660,9 @@ RZ_API void rz_bin_dex_free(RZ_NULLABLE RzBinDex *dex) {
 	}
 
 	rz_pvector_free(dex->strings);
+	rz_th_lock_free(dex->strings_lock);
+	rz_buf_free(dex->buf);
+	free(dex->string_offsets);
 	rz_pvector_free(dex->proto_ids);
 	rz_pvector_free(dex->field_ids);
 	rz_pvector_free(dex->method_ids);
@@ -679,6 +690,11 @@ RZ_API RZ_OWN RzBinDex *rz_bin_dex_new(RZ_NONNULL RzBuffer *buf, ut64 base, RZ_N
 		rz_bin_dex_free(dex);
 		return NULL;
 	}
+	dex->strings_lock = rz_th_lock_new(false);
+	if (!dex->strings_lock) {
+		rz_bin_dex_free(dex);
+		return NULL;
+	}
 	dex->proto_ids = rz_pvector_new((RzPVectorFree)dex_proto_id_free);
 	if (!dex->proto_ids) {
 		rz_bin_dex_free(dex);
@@ -729,6 +745,27 @@ RZ_API char *rz_bin_dex_access_flags_readable(ut32 access_flags) {
 	return sb ? rz_strbuf_drain(sb) : NULL;
 }
 
+/**
+ * \brief Returns the string with the given index, decoding it on first use
+ */
+static DexString *dex_resolve_string_id_native(RzBinDex *dex, ut32 string_idx) {
+	if (string_idx >= rz_pvector_len(dex->strings)) {
+		return NULL;
+	}
+	rz_th_lock_enter(dex->strings_lock);
+	DexString *string = (DexString *)rz_pvector_at(dex->strings, string_idx);
+	if (!string) {
+		ut32 string_offset = dex->string_offsets[string_idx];
+		st64 read = 0;
+		if (rz_buf_seek(dex->buf, string_offset, RZ_BUF_SET) >= 0) {
+			string = dex_string_new(dex->buf, dex->base + string_offset, &read);
+			rz_pvector_set(dex->strings, string_idx, string);
+		}
+	}
+	rz_th_lock_leave(dex->strings_lock);
+	return string;
+}
+
 /**
  * \brief Returns a RzList<RzBinString*> containing the dex strings
  */
@@ -736,15 +773,18 @@ RZ_API RZ_OWN RzList /*<RzBinString*>*/ *rz_bin_dex_strings(RZ_NONNULL RzBinDex
 	rz_return_val_if_fail(dex, NULL);
 
 	DexString *string;
-	void **it;
 	RzList *strings = rz_list_newf(rz_bin_string_free);
 	if (!strings) {
 		return NULL;
 	}
 
 	ut32 ordinal = 0;
-	rz_pvector_foreach (dex->strings, it) {
-		string = (DexString *)*it;
+	for (ut32 i = 0; i < rz_pvector_len(dex->strings); ++i) {
+		string = dex_resolve_string_id_native(dex, i);
+		if (!string) {
+			ordinal++;
+			continue;
+		}
 		RzBinString *bstr = RZ_NEW0(RzBinString);
 		if (!bstr) {
 			continue;
@@ -764,13 +804,6 @@ RZ_API RZ_OWN RzList /*<RzBinString*>*/ *rz_bin_dex_strings(RZ_NONNULL RzBinDex
 	return strings;
 }
 
-static inline DexString *dex_resolve_string_id_native(RzBinDex *dex, ut32 string_idx) {
-	if (string_idx >= rz_pvector_len(dex->strings)) {
-		return NULL;
-	}
-	return (DexString *)rz_pvector_at(dex->strings, string_idx);
-}
-
 static char *dex_resolve_string_id(RzBinDex *dex, ut32 string_idx) {
 	DexString *string = dex_resolve_string_id_native(dex, string_idx);
 	if (!string) {
@@ -1900,12 +1933,11 @@ RZ_API RZ_OWN char *rz_bin_dex_resolve_field_by_idx(RZ_NONNULL RzBinDex *dex, ut
 RZ_API ut64 rz_bin_dex_resolve_string_offset_by_idx(RZ_NONNULL RzBinDex *dex, ut32 string_idx) {
 	rz_return_val_if_fail(dex, UT64_MAX);
 
-	DexString *string = dex_resolve_string_id_native(dex, string_idx);
-	if (!string) {
+	if (string_idx >= dex->string_ids_size) {
 		RZ_LOG_INFO("cannot find string with index %u\n", string_idx);
 		return UT64_MAX;
 	}
-	return RZ_DEX_VIRT_ADDRESS + string->offset;
+	return RZ_DEX_VIRT_ADDRESS + dex->base + dex->string_offsets[string_idx];
 }
 
 /**
@@ -187,7 +187,11 @@ typedef struct dex_t {
 	ut32 data_offset;
 
 	/* lists */
-	RzPVector /*<DexString>*/ *strings;
+	RzPVector /*<DexString>*/ *strings; ///< decoded on first use, NULL until then
+	ut32 *string_offsets; ///< string_ids table, read at once
+	RzThreadLock *strings_lock; ///< serializes the decoding of the strings
+	RzBuffer *buf; ///< reference to the parsed buffer, to decode the strings
+	ut64 base;
 	RzPVector /*<DexProtoId>*/ *proto_ids;
 	RzPVector /*<DexFieldId>*/ *field_ids;
 	RzPVector /*<DexMethodId>*/ *method_ids;
@@ -7,6 +7,31 @@
 #include "dmp64.h"
 #include "../pe/pe_specs.h"
 
+/**
+ * Append the physical pages at \p start, stored at \p file_offset, extending
+ * the last descriptor when they directly follow it both in memory and in
+ * the file.
+ */
+static bool dmp64_add_pages(struct rz_bin_dmp64_obj_t *obj, ut64 start, ut64 file_offset, ut64 size) {
+	dmp_page_desc *last = rz_list_last(obj->pages);
+	if (last && last->start + last->size == start && last->file_offset + last->size == file_offset) {
+		last->size += size;
+		return true;
+	}
+	dmp_page_desc *page = RZ_NEW0(dmp_page_desc);
+	if (!page) {
+		return false;
+	}
+	page->start = start;
+	page->file_offset = file_offset;
+	page->size = size;
+	if (!rz_list_append(obj->pages, page)) {
+		free(page);
+		return false;
+	}
+	return true;
+}
+
 static bool rz_bin_dmp64_init_triage(struct rz_bin_dmp64_obj_t *obj) {
 	if (rz_buf_size(obj->b) < sizeof(dmp64_header) + sizeof(dmp64_triage)) {
 		return false;
@@ -47,7 +72,7 @@ static bool rz_bin_dmp64_init_triage(struct rz_bin_dmp64_obj_t *obj) {
 }
 
 static int rz_bin_dmp64_init_memory_runs(struct rz_bin_dmp64_obj_t *obj) {
-	int i, j;
+	int i;
 	dmp64_p_memory_desc *mem_desc = &obj->header->PhysicalMemoryBlock;
 	if (!memcmp(mem_desc, DMP_UNUSED_MAGIC, 4)) {
 		RZ_LOG_ERROR("Invalid PhysicalMemoryDescriptor magic\n");
@@ -74,17 +99,16 @@ static int rz_bin_dmp64_init_memory_runs(struct rz_bin_dmp64_obj_t *obj) {
 	ut64 base = sizeof(dmp64_header);
 	for (i = 0; i < num_runs; i++) {
 		dmp_p_memory_run *run = &(runs[i]);
-		for (j = 0; j < run->PageCount; j++) {
-			dmp_page_desc *page = RZ_NEW0(dmp_page_desc);
-			if (!page) {
-				free(runs);
-				return false;
-			}
-			page->start = (run->BasePage + j) * DMP_PAGE_SIZE;
-			page->file_offset = base + num_page * DMP_PAGE_SIZE;
-			rz_list_append(obj->pages, page);
-			num_page++;
+		if (!run->PageCount) {
+			continue;
 		}
+		// one descriptor per run, so that a dump of many GB is still a handful of maps
+		if (UT64_MUL_OVFCHK(run->BasePage, DMP_PAGE_SIZE) || UT64_MUL_OVFCHK(run->PageCount, DMP_PAGE_SIZE) ||
+			!dmp64_add_pages(obj, run->BasePage * DMP_PAGE_SIZE, base + num_page * DMP_PAGE_SIZE, run->PageCount * DMP_PAGE_SIZE)) {
+			free(runs);
+			return false;
+		}
+		num_page += run->PageCount;
 	}
 	if (mem_desc->NumberOfPages != num_page) {
 		RZ_LOG_WARN("The number of pages in the structure does not match with the counted one.\n");
@@ -211,37 +235,28 @@ static int rz_bin_dmp64_init_bmp_pages(struct rz_bin_dmp64_obj_t *obj) {
 	ut64 paddr_base = obj->bmp_header->FirstPage;
 	ut64 num_pages = obj->bmp_header->Pages;
 	RzBitmap *bitmap = rz_bitmap_new(num_pages);
+	if (!bitmap) {
+		return false;
+	}
 	rz_bitmap_set_bytes(bitmap, obj->bitmap, num_pages / 8);
 
 	ut64 num_bitset = 0;
-	ut64 i;
-	bool create_new_page = true;
-	dmp_page_desc *page;
-	for (i = 0; i < num_pages; i++) {
-		if (!rz_bitmap_test(bitmap, i)) {
-			create_new_page = true;
-			continue;
-		}
-		if (!create_new_page) {
-			page->size += DMP_PAGE_SIZE;
-			num_bitset++;
-			continue;
+	// every run of present pages is a single page descriptor
+	for (ut64 i = rz_bitmap_next_set(bitmap, 0), end; i < num_pages; i = rz_bitmap_next_set(bitmap, end)) {
+		end = rz_bitmap_next_unset(bitmap, i);
+		if (UT64_MUL_OVFCHK(end, DMP_PAGE_SIZE)) {
+			break;
 		}
-		page = RZ_NEW0(dmp_page_desc);
+		dmp_page_desc *page = RZ_NEW0(dmp_page_desc);
 		if (!page) {
 			rz_bitmap_free(bitmap);
 			return false;
 		}
-		if (UT64_MUL_OVFCHK(i, DMP_PAGE_SIZE)) {
-			free(page);
-			break;
-		}
 		page->start = i * DMP_PAGE_SIZE;
 		page->file_offset = paddr_base + num_bitset * DMP_PAGE_SIZE;
-		page->size = DMP_PAGE_SIZE;
+		page->size = (end - i) * DMP_PAGE_SIZE;
 		rz_list_append(obj->pages, page);
-		num_bitset++;
-		create_new_page = false;
+		num_bitset += end - i;
 	}
 	if (obj->bmp_header->TotalPresentPages != num_bitset) {
 		RZ_LOG_ERROR("The total present pages number in the header does not match with the counted one.\n");
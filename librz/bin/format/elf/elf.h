@@ -120,7 +120,8 @@ typedef struct rz_bin_elf_section_t {
 	ut64 offset;
 	ut64 rva;
 	ut64 size;
-	char *name;
+	const char *name; ///< owned unless name_borrowed
+	bool name_borrowed; ///< name points into the mapped section header string table
 	bool is_valid;
 } RzBinElfSection;
 
@@ -137,7 +138,8 @@ typedef struct rz_bin_elf_symbol_t {
 	ut32 ordinal;
 	const char *bind;
 	const char *type;
-	RZ_OWN char *name;
+	const char *name; ///< owned unless name_borrowed
+	bool name_borrowed; ///< name points into a mapped string table
 } RzBinElfSymbol;
 
 typedef struct rz_bin_elf_reloc_t {
@@ -359,6 +361,7 @@ bool Elf_(rz_bin_elf_has_sections)(RZ_NONNULL ELFOBJ *bin);
 RZ_BORROW const char *Elf_(rz_bin_elf_strtab_get)(RZ_NONNULL RzBinElfStrtab *strtab, ut64 index);
 RZ_OWN RzBinElfStrtab *Elf_(rz_bin_elf_strtab_new)(RZ_NONNULL ELFOBJ *bin, ut64 offset, ut64 size);
 RZ_OWN char *Elf_(rz_bin_elf_strtab_get_dup)(RZ_NONNULL RzBinElfStrtab *strtab, ut64 index);
+RZ_NULLABLE const char *Elf_(rz_bin_elf_strtab_get_slice)(RZ_NONNULL RzBinElfStrtab *strtab, ut64 index, RZ_NONNULL RZ_OUT bool *borrowed);
 bool Elf_(rz_bin_elf_strtab_has_index)(RZ_NONNULL RzBinElfStrtab *strtab, ut64 index);
 void Elf_(rz_bin_elf_strtab_free)(RzBinElfStrtab *ptr);
 
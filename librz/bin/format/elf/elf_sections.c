@@ -118,7 +118,9 @@ static bool create_section_plt(ELFOBJ *bin, RzVector *result) {
 
 static void rz_bin_elf_section_free(void *e, RZ_UNUSED void *user) {
 	RzBinElfSection *ptr = e;
-	free(ptr->name);
+	if (!ptr->name_borrowed) {
+		free((char *)ptr->name);
+	}
 }
 
 static RzVector *get_sections_from_dt_dynamic(ELFOBJ *bin) {
@@ -198,7 +200,7 @@ static bool set_elf_section_name(ELFOBJ *bin, RzBinElfSection *section, Elf_(Shd
 		return true;
 	}
 
-	section->name = Elf_(rz_bin_elf_strtab_get_dup)(bin->shstrtab, shdr->sh_name);
+	section->name = Elf_(rz_bin_elf_strtab_get_slice)(bin->shstrtab, shdr->sh_name, &section->name_borrowed);
 	if (section->name) {
 		return true;
 	}
@@ -314,7 +316,7 @@ RZ_OWN RzList *Elf_(rz_bin_elf_section_flag_to_rzlist)(ut64 flag) {
 }
 
 static RzBinElfSection convert_elf_section(ELFOBJ *bin, RzBinObjectLoadOptions *options, Elf_(Shdr) * shdr, size_t pos) {
-	RzBinElfSection section;
+	RzBinElfSection section = { 0 };
 
 	if (!set_elf_section(bin, options, &section, shdr, pos)) {
 		RZ_LOG_WARN("The section %zu at 0x%" PFMT64x " seems to be invalid.\n", pos, section.offset);
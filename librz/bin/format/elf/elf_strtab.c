@@ -29,15 +29,26 @@ RZ_OWN RzBinElfStrtab *Elf_(rz_bin_elf_strtab_new)(RZ_NONNULL ELFOBJ *bin, ut64
 	}
 
 	result->size = size;
-	result->data = RZ_NEWS(char, size);
-	if (!result->data) {
-		Elf_(rz_bin_elf_strtab_free)(result);
-		return NULL;
-	}
-
-	if (rz_buf_read_at(bin->b, offset, (ut8 *)result->data, size) < 0) {
-		Elf_(rz_bin_elf_strtab_free)(result);
-		return NULL;
+	result->borrowed = false;
+
+	// mapped files give direct access to the table, no need to copy it
+	ut64 len = size;
+	const ut8 *data = rz_buf_borrow_at(bin->b, offset, &len);
+	if (data && len == size) {
+		result->data = (const char *)data;
+		result->borrowed = true;
+	} else {
+		char *copy = RZ_NEWS(char, size);
+		result->data = copy;
+		if (!copy) {
+			Elf_(rz_bin_elf_strtab_free)(result);
+			return NULL;
+		}
+
+		if (rz_buf_read_at(bin->b, offset, (ut8 *)copy, size) < 0) {
+			Elf_(rz_bin_elf_strtab_free)(result);
+			return NULL;
+		}
 	}
 
 	if (result->data[0] != '\0' || result->data[size - 1] != '\0') {
@@ -64,6 +75,25 @@ RZ_OWN char *Elf_(rz_bin_elf_strtab_get_dup)(RZ_NONNULL RzBinElfStrtab *strtab,
 	return result;
 }
 
+/**
+ * \brief Get the string at \p index, borrowed from the file memory if possible
+ *
+ * \param borrowed Set to true if the returned string lives as long as the file buffer and must not be freed,
+ * false if it is an owned copy
+ * \return The string, which must be duplicated before being modified, or NULL
+ */
+RZ_NULLABLE const char *Elf_(rz_bin_elf_strtab_get_slice)(RZ_NONNULL RzBinElfStrtab *strtab, ut64 index, RZ_NONNULL RZ_OUT bool *borrowed) {
+	rz_return_val_if_fail(strtab && borrowed, NULL);
+
+	if (strtab->borrowed) {
+		*borrowed = true;
+		return Elf_(rz_bin_elf_strtab_get)(strtab, index);
+	}
+
+	*borrowed = false;
+	return Elf_(rz_bin_elf_strtab_get_dup)(strtab, index);
+}
+
 bool Elf_(rz_bin_elf_strtab_has_index)(RZ_NONNULL RzBinElfStrtab *strtab, ut64 index) {
 	rz_return_val_if_fail(strtab, false);
 	return index < strtab->size;
@@ -74,6 +104,8 @@ void Elf_(rz_bin_elf_strtab_free)(RzBinElfStrtab *ptr) {
 		return;
 	}
 
-	free(ptr->data);
+	if (!ptr->borrowed) {
+		free((char *)ptr->data);
+	}
 	free(ptr);
 }
@@ -8,8 +8,9 @@
 #define _INCLUDE_STRTAB_H_
 
 struct rz_bin_elf_strtab {
-	char *data;
+	const char *data;
 	size_t size;
+	bool borrowed; ///< data points into the memory of the file buffer instead of an owned copy
 };
 
 #endif
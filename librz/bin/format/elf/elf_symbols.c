@@ -168,6 +168,25 @@ static bool get_symbol_entry_aux(ELFOBJ *bin, ut64 offset, Elf_(Sym) * result) {
 #endif
 }
 
+static void get_symbol_entry_from_bytes(ELFOBJ *bin, const ut8 *data, Elf_(Sym) * result) {
+	bool be = bin->big_endian;
+#if RZ_BIN_ELF64
+	result->st_name = rz_read_ble32(data, be);
+	result->st_info = data[4];
+	result->st_other = data[5];
+	result->st_shndx = rz_read_ble16(data + 6, be);
+	result->st_value = rz_read_ble64(data + 8, be);
+	result->st_size = rz_read_ble64(data + 16, be);
+#else
+	result->st_name = rz_read_ble32(data, be);
+	result->st_value = rz_read_ble32(data + 4, be);
+	result->st_size = rz_read_ble32(data + 8, be);
+	result->st_info = data[12];
+	result->st_other = data[13];
+	result->st_shndx = rz_read_ble16(data + 14, be);
+#endif
+}
+
 static bool get_symbol_entry(ELFOBJ *bin, ut64 offset, Elf_(Sym) * result) {
 	if (!get_symbol_entry_aux(bin, offset, result)) {
 		RZ_LOG_WARN("Failed to read symbol entry at 0x%" PFMT64x ".\n", offset);
@@ -204,7 +223,7 @@ static bool set_elf_symbol_name(ELFOBJ *bin, struct symbols_segment *segment, Rz
 		return false;
 	}
 
-	elf_symbol->name = Elf_(rz_bin_elf_strtab_get_dup)(segment->strtab, symbol->st_name);
+	elf_symbol->name = Elf_(rz_bin_elf_strtab_get_slice)(segment->strtab, symbol->st_name, &elf_symbol->name_borrowed);
 	if (!elf_symbol->name) {
 		return false;
 	}
@@ -249,12 +268,25 @@ static bool has_already_been_processed(ELFOBJ *bin, ut64 offset, HtUU *set) {
 
 static void elf_symbol_fini(void *e, RZ_UNUSED void *user) {
 	RzBinElfSymbol *ptr = e;
-	free(ptr->name);
+	if (!ptr->name_borrowed) {
+		free((char *)ptr->name);
+	}
 }
 
 static bool compute_symbols_from_segment(ELFOBJ *bin, RzVector *result, struct symbols_segment *segment, RzBinElfSymbolFilter filter, HtUU *set) {
 	ut64 offset = segment->offset + segment->entry_size;
 
+	// decode the entries straight from the file memory when it is mapped
+	const ut8 *table = NULL;
+	if (segment->entry_size >= sizeof(Elf_(Sym)) && segment->number &&
+		segment->number <= UT64_MAX / segment->entry_size && !UT64_ADD_OVFCHK(segment->offset, segment->number * segment->entry_size)) {
+		ut64 len = segment->number * segment->entry_size;
+		table = rz_buf_borrow_at(bin->b, segment->offset, &len);
+		if (len != segment->number * segment->entry_size) {
+			table = NULL;
+		}
+	}
+
 	for (size_t i = 1; i < segment->number; i++) {
 		if (has_already_been_processed(bin, offset, set)) {
 			offset += segment->entry_size;
@@ -266,7 +298,9 @@ static bool compute_symbols_from_segment(ELFOBJ *bin, RzVector *result, struct s
 		}
 
 		Elf_(Sym) entry;
-		if (!get_symbol_entry(bin, offset, &entry)) {
+		if (table) {
+			get_symbol_entry_from_bytes(bin, table + i * segment->entry_size, &entry);
+		} else if (!get_symbol_entry(bin, offset, &entry)) {
 			return false;
 		}
 
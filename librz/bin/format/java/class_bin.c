@@ -71,10 +71,34 @@ static const ConstPool *java_class_constant_pool_at(RzBinJavaClass *bin, ut32 in
 	return NULL;
 }
 
+/**
+ * \brief Returns the decoded utf8 string at the given constant pool index
+ *
+ * Each string is decoded once and kept in the class, so the symbols, the
+ * imports and the fields referring to the same names share the work.
+ */
+static const char *java_class_constant_pool_string_at(RzBinJavaClass *bin, ut32 index) {
+	const ConstPool *cpool = java_class_constant_pool_at(bin, index);
+	if (!cpool || !java_constant_pool_is_string(cpool) || !bin->constant_pool_strings) {
+		return NULL;
+	}
+	rz_th_lock_enter(bin->constant_pool_lock);
+	char *string = bin->constant_pool_strings[index];
+	if (!string) {
+		string = java_constant_pool_stringify(cpool);
+		bin->constant_pool_strings[index] = string;
+	}
+	rz_th_lock_leave(bin->constant_pool_lock);
+	return string;
+}
+
 static char *java_class_constant_pool_stringify_at(RzBinJavaClass *bin, ut32 index) {
 	const ConstPool *cpool = java_class_constant_pool_at(bin, index);
 	if (!cpool) {
 		return NULL;
+	} else if (java_constant_pool_is_string(cpool) && bin->constant_pool_strings) {
+		const char *string = java_class_constant_pool_string_at(bin, index);
+		return string ? strdup(string) : NULL;
 	}
 	return java_constant_pool_stringify(cpool);
 }
@@ -295,6 +319,15 @@ RZ_API RZ_OWN RzBinJavaClass *rz_bin_java_class_new(RZ_NONNULL RzBuffer *buf, ut
 		return NULL;
 	}
 
+	if (bin->constant_pool_count) {
+		bin->constant_pool_strings = RZ_NEWS0(char *, bin->constant_pool_count);
+		bin->constant_pool_lock = rz_th_lock_new(false);
+		if (!bin->constant_pool_strings || !bin->constant_pool_lock) {
+			rz_bin_java_class_free(bin);
+			return NULL;
+		}
+	}
+
 	java_set_sdb(kv, bin, offset, size);
 
 	return bin;
@@ -414,6 +447,13 @@ RZ_API void rz_bin_java_class_free(RZ_NULLABLE RzBinJavaClass *bin) {
 		}
 		free(bin->constant_pool);
 	}
+	if (bin->constant_pool_strings) {
+		for (ut32 i = 0; i < bin->constant_pool_count; ++i) {
+			free(bin->constant_pool_strings[i]);
+		}
+		free(bin->constant_pool_strings);
+	}
+	rz_th_lock_free(bin->constant_pool_lock);
 	if (bin->interfaces) {
 		for (ut32 i = 0; i < bin->interfaces_count; ++i) {
 			java_interface_free(bin->interfaces[i]);
@@ -1058,7 +1098,9 @@ RZ_API RZ_OWN RzList *rz_bin_java_class_methods_as_symbols(RZ_NONNULL RzBinJavaC
 	}
 
 	char *method_name = NULL;
-	if (bin->methods) {
+	if (bin->methods && bin->methods_count) {
+		char *classname = rz_bin_java_class_name(bin);
+		char *libname = rz_demangler_java(classname);
 		for (ut32 i = 0; i < bin->methods_count; ++i) {
 			const Method *method = bin->methods[i];
 			if (!method) {
@@ -1070,7 +1112,7 @@ RZ_API RZ_OWN RzList *rz_bin_java_class_methods_as_symbols(RZ_NONNULL RzBinJavaC
 				RZ_LOG_ERROR("java bin: can't resolve method with constant pool index %u\n", method->name_index);
 				continue;
 			}
-			method_name = java_constant_pool_stringify(cpool);
+			method_name = java_class_constant_pool_stringify_at(bin, method->name_index);
 			if (!method_name) {
 				continue;
 			}
@@ -1096,7 +1138,7 @@ RZ_API RZ_OWN RzList *rz_bin_java_class_methods_as_symbols(RZ_NONNULL RzBinJavaC
 				desc = strdup("(?)V");
 			}
 
-			symbol->classname = rz_bin_java_class_name(bin);
+			symbol->classname = rz_str_new(classname);
 			symbol->dname = rz_str_newf("%s%s", method_name, desc);
 			symbol->name = add_class_name_to_name(method_name, symbol->classname);
 			symbol->size = size;
@@ -1105,12 +1147,14 @@ RZ_API RZ_OWN RzList *rz_bin_java_class_methods_as_symbols(RZ_NONNULL RzBinJavaC
 			symbol->ordinal = rz_list_length(list);
 			symbol->visibility = method->access_flags;
 			symbol->visibility_str = java_method_access_flags_readable(method);
-			symbol->libname = rz_demangler_java(symbol->classname);
+			symbol->libname = rz_str_new(libname);
 			symbol->method_flags = java_access_flags_to_bin_flags(method->access_flags);
 			free(desc);
 			free(method_name);
 			rz_list_append(list, symbol);
 		}
+		free(libname);
+		free(classname);
 	}
 	return list;
 }
@@ -1233,7 +1277,8 @@ RZ_API RZ_OWN RzList *rz_bin_java_class_fields_as_symbols(RZ_NONNULL RzBinJavaCl
 	}
 
 	char *field_name = NULL;
-	if (bin->fields) {
+	if (bin->fields && bin->fields_count) {
+		char *classname = rz_bin_java_class_name(bin);
 		for (ut32 i = 0; i < bin->fields_count; ++i) {
 			const Field *field = bin->fields[i];
 			if (!field) {
@@ -1245,7 +1290,7 @@ RZ_API RZ_OWN RzList *rz_bin_java_class_fields_as_symbols(RZ_NONNULL RzBinJavaCl
 				RZ_LOG_ERROR("java bin: can't resolve field with constant pool index %u\n", field->name_index);
 				continue;
 			}
-			field_name = java_constant_pool_stringify(cpool);
+			field_name = java_class_constant_pool_stringify_at(bin, field->name_index);
 			if (!field_name) {
 				continue;
 			}
@@ -1255,7 +1300,7 @@ RZ_API RZ_OWN RzList *rz_bin_java_class_fields_as_symbols(RZ_NONNULL RzBinJavaCl
 				free(field_name);
 				continue;
 			}
-			symbol->classname = rz_bin_java_class_name(bin);
+			symbol->classname = rz_str_new(classname);
 			symbol->name = add_class_name_to_name(field_name, symbol->classname);
 			symbol->size = 0;
 			symbol->bind = java_field_is_global(field) ? RZ_BIN_BIND_GLOBAL_STR : RZ_BIN_BIND_LOCAL_STR;
@@ -1267,6 +1312,7 @@ RZ_API RZ_OWN RzList *rz_bin_java_class_fields_as_symbols(RZ_NONNULL RzBinJavaCl
 			free(field_name);
 			rz_list_append(list, symbol);
 		}
+		free(classname);
 	}
 	return list;
 }
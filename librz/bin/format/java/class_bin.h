@@ -61,6 +61,8 @@ typedef struct java_class_t {
 	ut64 methods_offset;
 	ut64 attributes_offset;
 	ut64 class_end_offset;
+	char **constant_pool_strings; ///< decoded utf8 entries of the constant pool, filled on first use
+	RzThreadLock *constant_pool_lock; ///< protects constant_pool_strings
 } RzBinJavaClass;
 
 RZ_API RZ_OWN RzBinJavaClass *rz_bin_java_class_new(RZ_NONNULL RzBuffer *buf, ut64 offset, RZ_NONNULL Sdb *kv);
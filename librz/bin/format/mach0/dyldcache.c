@@ -585,9 +585,6 @@ static RzList *create_cache_bins(RzDyldCache *cache) {
 		}
 
 		for (j = 0; j < hdr->imagesCount; j++) {
-			if (deps && !deps[j]) {
-				continue;
-			}
 			ut64 pa = va2pa(img[j].address, hdr->mappingCount, &cache->maps[maps_index], cache->buf, 0, NULL, NULL);
 			if (pa == UT64_MAX) {
 				continue;
@@ -606,6 +603,8 @@ static RzList *create_cache_bins(RzDyldCache *cache) {
 				bin->hdr_offset = hdr_offset;
 				bin->symbols_off = symbols_off;
 				bin->va = img[j].address;
+				// the images left out by the filter stay in the table to be loaded on demand
+				bin->loaded = !deps || deps[j];
 				if (rz_buf_read_at(cache->buf, img[j].pathFileOffset, (ut8 *)&file, sizeof(file)) == sizeof(file)) {
 					file[255] = 0;
 					char *last_slash = strrchr(file, '/');
@@ -644,12 +643,107 @@ static RzList *create_cache_bins(RzDyldCache *cache) {
 		rz_list_free(bins);
 		bins = NULL;
 	}
+	cache->filtered = deps != NULL;
 	RZ_FREE(deps);
 	RZ_FREE(target_libs);
 	rz_list_free(target_lib_names);
 	return bins;
 }
 
+static int bin_va_cmp(const void *a, const void *b) {
+	const RzDyldBinImage *ba = a;
+	const RzDyldBinImage *bb = b;
+	return ba->va < bb->va ? -1 : (ba->va > bb->va ? 1 : 0);
+}
+
+#define BIN_VA_CMP(x, y) ((x) < ((const RzDyldBinImage *)(y))->va ? -1 : ((x) > ((const RzDyldBinImage *)(y))->va ? 1 : 0))
+
+static RzDyldBinImage *bin_by_va(RzDyldCache *cache, ut64 va) {
+	size_t index;
+	rz_pvector_upper_bound(&cache->bins_by_va, va, index, BIN_VA_CMP);
+	if (!index) {
+		return NULL;
+	}
+	return rz_pvector_at(&cache->bins_by_va, index - 1);
+}
+
+/**
+ * Index the images by address and take the size of their text from
+ * the images text table, to find the image of an address cheaply.
+ */
+static void index_cache_bins(RzDyldCache *cache) {
+	RzListIter *iter;
+	RzDyldBinImage *bin;
+	rz_pvector_init(&cache->bins_by_va, NULL);
+	if (!rz_pvector_reserve(&cache->bins_by_va, rz_list_length(cache->bins))) {
+		return;
+	}
+	rz_list_foreach (cache->bins, iter, bin) {
+		rz_pvector_push(&cache->bins_by_va, bin);
+	}
+	rz_pvector_sort(&cache->bins_by_va, bin_va_cmp);
+
+	cache_hdr_t *hdr = cache->hdr;
+	if (!hdr->imagesTextCount || !hdr->imagesTextOffset || hdr->imagesTextCount > UT32_MAX) {
+		return;
+	}
+	ut64 total_size = hdr->imagesTextCount * sizeof(cache_text_info_t);
+	cache_text_info_t *text_infos = malloc(total_size);
+	if (!text_infos) {
+		return;
+	}
+	if (rz_buf_fread_at(cache->buf, hdr->imagesTextOffset, (ut8 *)text_infos, "16clii", hdr->imagesTextCount) == total_size) {
+		for (ut64 i = 0; i < hdr->imagesTextCount; i++) {
+			bin = bin_by_va(cache, text_infos[i].loadAddress);
+			if (bin && bin->va == text_infos[i].loadAddress) {
+				bin->text_size = text_infos[i].textSegmentSize;
+			}
+		}
+	}
+	free(text_infos);
+}
+
+/**
+ * \brief Leave out all the images that were not selected by RZ_DYLDCACHE_FILTER
+ *
+ * Their sections, symbols and classes are only listed once they are loaded,
+ * by setting RzDyldBinImage.loaded on the image found with rz_dyldcache_image_at().
+ * Without a filter, no image is loaded at first.
+ */
+RZ_API void rz_dyldcache_set_lazy(RzDyldCache *cache) {
+	rz_return_if_fail(cache);
+	if (cache->filtered) {
+		return;
+	}
+	RzListIter *iter;
+	RzDyldBinImage *bin;
+	rz_list_foreach (cache->bins, iter, bin) {
+		bin->loaded = false;
+	}
+}
+
+/**
+ * \brief Find the image whose text holds \p vaddr
+ *
+ * \param vaddr address including the slide
+ * \return the image or NULL if \p vaddr is not inside the text of any image
+ */
+RZ_API RzDyldBinImage *rz_dyldcache_image_at(RzDyldCache *cache, ut64 vaddr) {
+	rz_return_val_if_fail(cache, NULL);
+	ut64 va = vaddr - rz_dyldcache_get_slide(cache);
+	RzDyldBinImage *bin = bin_by_va(cache, va);
+	if (!bin) {
+		return NULL;
+	}
+	if (bin->text_size) {
+		return va < bin->va + bin->text_size ? bin : NULL;
+	}
+	// without the images text table, the image is assumed to extend up to the next one
+	size_t count = rz_pvector_len(&cache->bins_by_va);
+	RzDyldBinImage *last = rz_pvector_at(&cache->bins_by_va, count - 1);
+	return bin != last ? bin : NULL;
+}
+
 static ut32 dumb_ctzll(ut64 x) {
 	ut64 result = 0;
 	int i, j;
@@ -1187,6 +1281,7 @@ RZ_API RzDyldCache *rz_dyldcache_new_buf(RzBuffer *buf) {
 	if (!cache->bins) {
 		goto cupertino;
 	}
+	index_cache_bins(cache);
 	cache->locsym = rz_dyld_locsym_new(cache);
 	cache->rebase_infos = get_rebase_infos(cache);
 	return cache;
@@ -1327,6 +1422,7 @@ RZ_API void rz_dyldcache_free(RzDyldCache *cache) {
 		return;
 	}
 
+	rz_pvector_fini(&cache->bins_by_va);
 	rz_list_free(cache->bins);
 	cache->bins = NULL;
 	rz_buf_free(cache->buf);
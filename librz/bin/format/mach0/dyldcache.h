@@ -88,6 +88,8 @@ typedef struct rz_bin_dyld_image_t {
 	ut64 va;
 	ut32 nlist_start_index;
 	ut32 nlist_count;
+	ut64 text_size; ///< size of the __TEXT segment starting at va, 0 if unknown
+	bool loaded; ///< its sections, symbols and classes are listed, see rz_dyldcache_set_lazy()
 } RzDyldBinImage;
 
 typedef struct rz_dyldcache_t {
@@ -102,6 +104,8 @@ typedef struct rz_dyldcache_t {
 	ut32 n_maps;
 
 	RzList *bins;
+	RzPVector /*<RzDyldBinImage>*/ bins_by_va; ///< the same images as bins, sorted by va
+	bool filtered; ///< the images were selected by RZ_DYLDCACHE_FILTER
 	RzBuffer *buf;
 	RzDyldRebaseInfos *rebase_infos;
 	cache_accel_t *accel;
@@ -116,6 +120,8 @@ RZ_API void rz_dyldcache_free(RzDyldCache *cache);
 RZ_API ut64 rz_dyldcache_va2pa(RzDyldCache *cache, uint64_t vaddr, ut32 *offset, ut32 *left);
 RZ_API ut64 rz_dyldcache_get_slide(RzDyldCache *cache);
 RZ_API objc_cache_opt_info *rz_dyldcache_get_objc_opt_info(RzBinFile *bf, RzDyldCache *cache);
+RZ_API void rz_dyldcache_set_lazy(RzDyldCache *cache);
+RZ_API RzDyldBinImage *rz_dyldcache_image_at(RzDyldCache *cache, ut64 vaddr);
 RZ_API void rz_dyldcache_symbols_from_locsym(RzDyldCache *cache, RzDyldBinImage *bin, RzList *symbols, SetU *hash);
 
 RZ_API RzBuffer *rz_dyldcache_new_rebasing_buf(RzDyldCache *cache);
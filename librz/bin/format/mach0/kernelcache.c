@@ -281,6 +281,7 @@ static st64 buf_read(RzBuffer *b, ut8 *buf, ut64 len) {
 
 static st64 buf_write(RzBuffer *b, const ut8 *buf, ut64 len) {
 	BufCtx *ctx = b->priv;
+	MACH0_(chained_fixups_cache_reset)(ctx->obj->mach0);
 	return rz_buf_write_at(ctx->obj->cache_buf, ctx->off, buf, len);
 }
 
@@ -40,6 +40,7 @@ typedef struct rz_xnu_kernelcache_obj_t {
 	bool rebase_info_populated;
 	bool rebasing_buffer;
 	bool kexts_initialized;
+	bool lazy_kexts; ///< only list the sections and symbols of the kexts whose address was accessed, see bin.lazy
 } RzXNUKernelCacheObj;
 
 RZ_API bool rz_xnu_kernelcache_buf_is_kernelcache(RzBuffer *b);
@@ -2040,6 +2040,9 @@ static int init_items(struct MACH0_(obj_t) * bin) {
 		(bin->hdr.cpusubtype & ~CPU_SUBTYPE_MASK) == CPU_SUBTYPE_ARM64E) {
 		reconstruct_chained_fixup(bin);
 	}
+	if (bin->chained_starts) {
+		MACH0_(chained_fixups_cache_init)(bin);
+	}
 	return true;
 }
 
@@ -2092,6 +2095,7 @@ void *MACH0_(mach0_free)(struct MACH0_(obj_t) * mo) {
 		}
 		free(mo->chained_starts);
 	}
+	MACH0_(chained_fixups_cache_fini)(mo);
 	rz_pvector_free(mo->patchable_relocs);
 	rz_skiplist_free(mo->relocs);
 	rz_hash_free(mo->hash);
@@ -126,6 +126,8 @@ struct MACH0_(obj_t) {
 	int nsegs;
 	struct rz_dyld_chained_starts_in_segment **chained_starts;
 	ut32 nchained_starts;
+	HtUP /*<ut64, RzVector<ChainedFixup> *>*/ *chained_fixups; ///< fixups of the pages read so far, by segment index << 32 | page index
+	RzThreadLock *chained_fixups_lock;
 	struct MACH0_(section) * sects;
 	int nsects;
 	struct MACH0_(nlist) * symtab;
@@ -240,6 +242,9 @@ RZ_API void MACH0_(rebase_buffer)(struct MACH0_(obj_t) * obj, ut64 off, ut8 *buf
 RZ_API RzBuffer *MACH0_(new_rebasing_and_stripping_buf)(struct MACH0_(obj_t) * obj);
 RZ_API bool MACH0_(needs_rebasing_and_stripping)(struct MACH0_(obj_t) * obj);
 RZ_API bool MACH0_(segment_needs_rebasing_and_stripping)(struct MACH0_(obj_t) * obj, size_t seg_index);
+RZ_API void MACH0_(chained_fixups_cache_init)(struct MACH0_(obj_t) * obj);
+RZ_API void MACH0_(chained_fixups_cache_fini)(struct MACH0_(obj_t) * obj);
+RZ_API void MACH0_(chained_fixups_cache_reset)(struct MACH0_(obj_t) * obj);
 
 RZ_API bool MACH0_(needs_reloc_patching)(struct MACH0_(obj_t) * obj);
 RZ_API ut64 MACH0_(reloc_targets_vfile_size)(struct MACH0_(obj_t) * obj);
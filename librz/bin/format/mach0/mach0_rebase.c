@@ -21,6 +21,205 @@
 #define IS_PTR_AUTH(x) ((x & (1ULL << 63)) != 0)
 #define IS_PTR_BIND(x) ((x & (1ULL << 62)) != 0)
 
+/*
+ * Fixups of a page, found by walking its chain from the start given by the
+ * chained starts. The pages are only walked when they are first read, and
+ * the result is kept in obj->chained_fixups as reading the chain again is
+ * what costs, a link at a time.
+ */
+typedef struct {
+	ut64 paddr; ///< where the pointer is in the file
+	ut64 value; ///< pointer to write there
+} ChainedFixup;
+
+#define CHAINED_FIXUP_CMP(x, elem) RZ_NUM_CMP(x, ((ChainedFixup *)(elem))->paddr)
+
+static void walk_page_chain(struct MACH0_(obj_t) * obj, int i, ut64 page_idx, RzVector /*<ChainedFixup>*/ *out) {
+	struct rz_dyld_chained_starts_in_segment *starts = obj->chained_starts[i];
+	ut64 start = obj->segs[i].fileoff;
+	ut64 end = start + obj->segs[i].filesize;
+	ut64 cursor = start + page_idx * starts->page_size + starts->page_start[page_idx];
+	while (cursor < end) {
+		ut8 tmp[8];
+		if (rz_buf_read_at(obj->b, cursor, tmp, 8) != 8) {
+			break;
+		}
+		ut64 raw_ptr = rz_read_le64(tmp);
+		bool is_auth = IS_PTR_AUTH(raw_ptr);
+		ut64 ptr_value = raw_ptr;
+		ut64 delta;
+		ut64 stride = 8;
+		switch (starts->pointer_format) {
+		case DYLD_CHAINED_PTR_ARM64E: {
+			bool is_bind = IS_PTR_BIND(raw_ptr);
+			if (is_auth && is_bind) {
+				struct dyld_chained_ptr_arm64e_auth_bind *p =
+					(struct dyld_chained_ptr_arm64e_auth_bind *)&raw_ptr;
+				delta = p->next;
+			} else if (!is_auth && is_bind) {
+				struct dyld_chained_ptr_arm64e_bind *p =
+					(struct dyld_chained_ptr_arm64e_bind *)&raw_ptr;
+				delta = p->next;
+			} else if (is_auth && !is_bind) {
+				struct dyld_chained_ptr_arm64e_auth_rebase *p =
+					(struct dyld_chained_ptr_arm64e_auth_rebase *)&raw_ptr;
+				delta = p->next;
+				ptr_value = p->target + obj->baddr;
+			} else {
+				struct dyld_chained_ptr_arm64e_rebase *p =
+					(struct dyld_chained_ptr_arm64e_rebase *)&raw_ptr;
+				delta = p->next;
+				ptr_value = ((ut64)p->high8 << 56) | p->target;
+			}
+			break;
+		}
+		case DYLD_CHAINED_PTR_64_KERNEL_CACHE:
+		case DYLD_CHAINED_PTR_ARM64E_KERNEL: {
+			stride = 4;
+			if (is_auth) {
+				struct dyld_chained_ptr_arm64e_cache_auth_rebase *p =
+					(struct dyld_chained_ptr_arm64e_cache_auth_rebase *)&raw_ptr;
+				delta = p->next;
+				ptr_value = p->target + obj->baddr;
+			} else {
+				struct dyld_chained_ptr_arm64e_cache_rebase *p =
+					(struct dyld_chained_ptr_arm64e_cache_rebase *)&raw_ptr;
+				delta = p->next;
+				ptr_value = ((ut64)p->high8 << 56) | p->target;
+				ptr_value += obj->baddr;
+			}
+			break;
+		}
+		case DYLD_CHAINED_PTR_64_OFFSET: {
+			stride = 4;
+			struct dyld_chained_ptr_64_bind *bind =
+				(struct dyld_chained_ptr_64_bind *)&raw_ptr;
+			if (bind->bind) {
+				delta = bind->next;
+			} else {
+				struct dyld_chained_ptr_64_rebase *p =
+					(struct dyld_chained_ptr_64_rebase *)&raw_ptr;
+				delta = p->next;
+				ptr_value = obj->baddr + (((ut64)p->high8 << 56) | p->target);
+			}
+			break;
+		}
+		case DYLD_CHAINED_PTR_ARM64E_USERLAND24: {
+			stride = 8;
+			struct dyld_chained_ptr_arm64e_bind24 *bind =
+				(struct dyld_chained_ptr_arm64e_bind24 *)&raw_ptr;
+			if (bind->bind) {
+				delta = bind->next;
+			} else {
+				if (bind->auth) {
+					struct dyld_chained_ptr_arm64e_auth_rebase *p =
+						(struct dyld_chained_ptr_arm64e_auth_rebase *)&raw_ptr;
+					delta = p->next;
+					ptr_value = p->target + obj->baddr;
+				} else {
+					struct dyld_chained_ptr_arm64e_rebase *p =
+						(struct dyld_chained_ptr_arm64e_rebase *)&raw_ptr;
+					delta = p->next;
+					ptr_value = obj->baddr + (((ut64)p->high8 << 56) | p->target);
+				}
+			}
+			break;
+		}
+		default:
+			RZ_LOG_WARN("Unsupported Mach-O pointer format: %u at paddr 0x%" PFMT64x "\n",
+				starts->pointer_format, cursor);
+			goto break_it_all;
+		}
+		ChainedFixup fixup = { cursor, ptr_value };
+		rz_vector_push(out, &fixup);
+		cursor += delta * stride;
+		if (!delta) {
+			break;
+		}
+		continue;
+	break_it_all:
+		break;
+	}
+}
+
+static void chained_fixups_free_kv(HtUPKv *kv) {
+	rz_vector_free(kv->value);
+}
+
+/**
+ * \brief Sets up the cache of the walked fixup chains, once the chained starts are known
+ */
+RZ_API void MACH0_(chained_fixups_cache_init)(struct MACH0_(obj_t) * obj) {
+	rz_return_if_fail(obj);
+	obj->chained_fixups = ht_up_new(NULL, chained_fixups_free_kv, NULL);
+	obj->chained_fixups_lock = rz_th_lock_new(false);
+	if (!obj->chained_fixups || !obj->chained_fixups_lock) {
+		MACH0_(chained_fixups_cache_fini)(obj);
+	}
+}
+
+RZ_API void MACH0_(chained_fixups_cache_fini)(struct MACH0_(obj_t) * obj) {
+	rz_return_if_fail(obj);
+	ht_up_free(obj->chained_fixups);
+	obj->chained_fixups = NULL;
+	rz_th_lock_free(obj->chained_fixups_lock);
+	obj->chained_fixups_lock = NULL;
+}
+
+/**
+ * \brief Forgets the walked fixup chains, to be called when the file is written to
+ */
+RZ_API void MACH0_(chained_fixups_cache_reset)(struct MACH0_(obj_t) * obj) {
+	rz_return_if_fail(obj);
+	if (!obj->chained_fixups) {
+		return;
+	}
+	rz_th_lock_enter(obj->chained_fixups_lock);
+	ht_up_free(obj->chained_fixups);
+	obj->chained_fixups = ht_up_new(NULL, chained_fixups_free_kv, NULL);
+	rz_th_lock_leave(obj->chained_fixups_lock);
+}
+
+static void patch_fixups(RzVector /*<ChainedFixup>*/ *fixups, ut64 off, ut8 *buf, ut64 eob) {
+	size_t j;
+	rz_vector_lower_bound(fixups, off, j, CHAINED_FIXUP_CMP);
+	for (; j < rz_vector_len(fixups); j++) {
+		ChainedFixup *fixup = rz_vector_index_ptr(fixups, j);
+		if (fixup->paddr + 8 > eob) {
+			break;
+		}
+		rz_write_le64(&buf[fixup->paddr - off], fixup->value);
+	}
+}
+
+static void rebase_page(struct MACH0_(obj_t) * obj, int i, ut64 page_idx, ut64 off, ut8 *buf, ut64 eob) {
+	if (!obj->chained_fixups) {
+		RzVector fixups;
+		rz_vector_init(&fixups, sizeof(ChainedFixup), NULL, NULL);
+		walk_page_chain(obj, i, page_idx, &fixups);
+		patch_fixups(&fixups, off, buf, eob);
+		rz_vector_fini(&fixups);
+		return;
+	}
+	ut64 key = ((ut64)i << 32) | page_idx;
+	rz_th_lock_enter(obj->chained_fixups_lock);
+	RzVector *fixups = obj->chained_fixups ? ht_up_find(obj->chained_fixups, key, NULL) : NULL;
+	if (!fixups && obj->chained_fixups) {
+		fixups = rz_vector_new(sizeof(ChainedFixup), NULL, NULL);
+		if (fixups) {
+			walk_page_chain(obj, i, page_idx, fixups);
+			if (!ht_up_insert(obj->chained_fixups, key, fixups)) {
+				rz_vector_free(fixups);
+				fixups = NULL;
+			}
+		}
+	}
+	if (fixups) {
+		patch_fixups(fixups, off, buf, eob);
+	}
+	rz_th_lock_leave(obj->chained_fixups_lock);
+}
+
 RZ_API void MACH0_(rebase_buffer)(struct MACH0_(obj_t) * obj, ut64 off, ut8 *buf, ut64 count) {
 	rz_return_if_fail(obj && buf);
 	ut64 eob = off + count;
@@ -41,114 +240,10 @@ RZ_API void MACH0_(rebase_buffer)(struct MACH0_(obj_t) * obj, ut64 off, ut8 *buf
 			if (page_idx >= obj->chained_starts[i]->page_count) {
 				break;
 			}
-			ut16 page_start = obj->chained_starts[i]->page_start[page_idx];
-			if (page_start == DYLD_CHAINED_PTR_START_NONE) {
+			if (obj->chained_starts[i]->page_start[page_idx] == DYLD_CHAINED_PTR_START_NONE) {
 				continue;
 			}
-			ut64 cursor = start + page_idx * page_size + page_start;
-			while (cursor < eob && cursor < end) {
-				ut8 tmp[8];
-				if (rz_buf_read_at(obj->b, cursor, tmp, 8) != 8) {
-					break;
-				}
-				ut64 raw_ptr = rz_read_le64(tmp);
-				bool is_auth = IS_PTR_AUTH(raw_ptr);
-				ut64 ptr_value = raw_ptr;
-				ut64 delta;
-				ut64 stride = 8;
-				switch (obj->chained_starts[i]->pointer_format) {
-				case DYLD_CHAINED_PTR_ARM64E: {
-					bool is_bind = IS_PTR_BIND(raw_ptr);
-					if (is_auth && is_bind) {
-						struct dyld_chained_ptr_arm64e_auth_bind *p =
-							(struct dyld_chained_ptr_arm64e_auth_bind *)&raw_ptr;
-						delta = p->next;
-					} else if (!is_auth && is_bind) {
-						struct dyld_chained_ptr_arm64e_bind *p =
-							(struct dyld_chained_ptr_arm64e_bind *)&raw_ptr;
-						delta = p->next;
-					} else if (is_auth && !is_bind) {
-						struct dyld_chained_ptr_arm64e_auth_rebase *p =
-							(struct dyld_chained_ptr_arm64e_auth_rebase *)&raw_ptr;
-						delta = p->next;
-						ptr_value = p->target + obj->baddr;
-					} else {
-						struct dyld_chained_ptr_arm64e_rebase *p =
-							(struct dyld_chained_ptr_arm64e_rebase *)&raw_ptr;
-						delta = p->next;
-						ptr_value = ((ut64)p->high8 << 56) | p->target;
-					}
-					break;
-				}
-				case DYLD_CHAINED_PTR_64_KERNEL_CACHE:
-				case DYLD_CHAINED_PTR_ARM64E_KERNEL: {
-					stride = 4;
-					if (is_auth) {
-						struct dyld_chained_ptr_arm64e_cache_auth_rebase *p =
-							(struct dyld_chained_ptr_arm64e_cache_auth_rebase *)&raw_ptr;
-						delta = p->next;
-						ptr_value = p->target + obj->baddr;
-					} else {
-						struct dyld_chained_ptr_arm64e_cache_rebase *p =
-							(struct dyld_chained_ptr_arm64e_cache_rebase *)&raw_ptr;
-						delta = p->next;
-						ptr_value = ((ut64)p->high8 << 56) | p->target;
-						ptr_value += obj->baddr;
-					}
-					break;
-				}
-				case DYLD_CHAINED_PTR_64_OFFSET: {
-					stride = 4;
-					struct dyld_chained_ptr_64_bind *bind =
-						(struct dyld_chained_ptr_64_bind *)&raw_ptr;
-					if (bind->bind) {
-						delta = bind->next;
-					} else {
-						struct dyld_chained_ptr_64_rebase *p =
-							(struct dyld_chained_ptr_64_rebase *)&raw_ptr;
-						delta = p->next;
-						ptr_value = obj->baddr + (((ut64)p->high8 << 56) | p->target);
-					}
-					break;
-				}
-				case DYLD_CHAINED_PTR_ARM64E_USERLAND24: {
-					stride = 8;
-					struct dyld_chained_ptr_arm64e_bind24 *bind =
-						(struct dyld_chained_ptr_arm64e_bind24 *)&raw_ptr;
-					if (bind->bind) {
-						delta = bind->next;
-					} else {
-						if (bind->auth) {
-							struct dyld_chained_ptr_arm64e_auth_rebase *p =
-								(struct dyld_chained_ptr_arm64e_auth_rebase *)&raw_ptr;
-							delta = p->next;
-							ptr_value = p->target + obj->baddr;
-						} else {
-							struct dyld_chained_ptr_arm64e_rebase *p =
-								(struct dyld_chained_ptr_arm64e_rebase *)&raw_ptr;
-							delta = p->next;
-							ptr_value = obj->baddr + (((ut64)p->high8 << 56) | p->target);
-						}
-					}
-					break;
-				}
-				default:
-					RZ_LOG_WARN("Unsupported Mach-O pointer format: %u at paddr 0x%" PFMT64x "\n",
-						obj->chained_starts[i]->pointer_format, cursor);
-					goto break_it_all;
-				}
-				ut64 in_buf = cursor - off;
-				if (cursor >= off && cursor <= eob - 8) {
-					rz_write_le64(&buf[in_buf], ptr_value);
-				}
-				cursor += delta * stride;
-				if (!delta) {
-					break;
-				}
-				continue;
-			break_it_all:
-				break;
-			}
+			rebase_page(obj, i, page_idx, off, buf, eob);
 		}
 	}
 }
@@ -192,6 +287,7 @@ static st64 buf_read(RzBuffer *b, ut8 *buf, ut64 len) {
 
 static st64 buf_write(RzBuffer *b, const ut8 *buf, ut64 len) {
 	BufCtx *ctx = b->priv;
+	MACH0_(chained_fixups_cache_reset)(ctx->obj);
 	return rz_buf_write_at(ctx->obj->b, ctx->off, buf, len);
 }
 
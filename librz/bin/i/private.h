@@ -30,6 +30,10 @@ RZ_IPI RzBinObject *rz_bin_object_new(RzBinFile *binfile, RzBinPlugin *plugin, R
 RZ_IPI RzBinObject *rz_bin_object_get_cur(RzBin *bin);
 RZ_IPI RzBinObject *rz_bin_object_find_by_arch_bits(RzBinFile *binfile, const char *arch, int bits, const char *name);
 
+RZ_IPI RZ_OWN char *rz_bin_cache_path(RZ_NONNULL RzBinFile *bf, RZ_NONNULL RzBinObject *o);
+RZ_IPI bool rz_bin_cache_save(RZ_NONNULL RzBinObject *o, RZ_NONNULL const char *path);
+RZ_IPI bool rz_bin_cache_load(RZ_NONNULL RzBin *bin, RZ_NONNULL RzBinObject *o, RZ_NONNULL const char *path);
+
 RZ_IPI void rz_bin_class_free(RzBinClass *c);
 RZ_IPI RzBinSymbol *rz_bin_class_add_method(RzBinFile *binfile, const char *classname, const char *name, int nargs);
 RZ_IPI void rz_bin_class_add_field(RzBinFile *binfile, const char *classname, const char *name);
@@ -37,10 +41,18 @@ RZ_IPI void rz_bin_class_add_field(RzBinFile *binfile, const char *classname, co
 RZ_IPI RzBinFile *rz_bin_file_xtr_load_buffer(RzBin *bin, RzBinXtrPlugin *xtr, const char *filename, RzBuffer *buf, RzBinObjectLoadOptions *obj_opts, int idx, int fd);
 RZ_IPI RzBinFile *rz_bin_file_new_from_buffer(RzBin *bin, const char *file, RzBuffer *buf, RzBinObjectLoadOptions *opts, int fd, const char *pluginname);
 
+typedef struct {
+	RzBinString **strings; ///< sorted by address
+	ut64 *max_end; ///< max_end[i] is the largest end address of strings[0] to strings[i]
+	size_t count;
+} RzBinStrTable;
+
 struct rz_bin_string_database_t {
 	RzList /*<RzBinString*>*/ *list; ///< Contains all the strings in list form
 	HtUP /*<ut64, RzBinString*>*/ *phys; ///< Contains all the strings but mapped by physical address
 	HtUP /*<ut64, RzBinString*>*/ *virt; ///< Contains all the strings but mapped by virtual address
+	RzBinStrTable *phys_sorted; ///< for the lookups inside strings, built on first use, NULL when outdated
+	RzBinStrTable *virt_sorted; ///< same as phys_sorted, by virtual address
 };
 
 #endif
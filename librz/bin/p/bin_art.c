@@ -205,6 +205,11 @@ static RzList *sections(RzBinFile *bf) {
 	return ret;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("art\n"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_art = {
 	.name = "art",
 	.desc = "Android Runtime",
@@ -213,6 +218,7 @@ RzBinPlugin rz_bin_plugin_art = {
 	.load_buffer = &load_buffer,
 	.destroy = &destroy,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.baddr = &baddr,
 	.maps = &rz_bin_maps_of_file_sections,
 	.sections = &sections,
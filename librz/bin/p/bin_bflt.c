@@ -252,6 +252,11 @@ static RzList *strings(RzBinFile *bf) {
 	return rz_bin_file_strings(bf, 0, false);
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("bFLT"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_bflt = {
 	.name = "bflt",
 	.desc = "bFLT uClinux executable",
@@ -259,6 +264,7 @@ RzBinPlugin rz_bin_plugin_bflt = {
 	.load_buffer = &load_buffer,
 	.destroy = &destroy,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.virtual_files = &virtual_files,
 	.maps = &maps,
 	.entries = &entries,
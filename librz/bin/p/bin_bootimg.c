@@ -240,6 +240,11 @@ static RzList *sections(RzBinFile *bf) {
 	return ret;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("ANDROID!"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_bootimg = {
 	.name = "bootimg",
 	.desc = "Android Boot Image",
@@ -248,6 +253,7 @@ RzBinPlugin rz_bin_plugin_bootimg = {
 	.load_buffer = &load_buffer,
 	.destroy = &destroy,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.baddr = &baddr,
 	.maps = rz_bin_maps_of_file_sections,
 	.sections = &sections,
@@ -100,6 +100,11 @@ static RzBuffer *create(RzBin *bin, const ut8 *code, int codelen, const ut8 *dat
 	return buf;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC(CGCMAG),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_cgc = {
 	.name = "cgc",
 	.desc = "CGC format rz_bin plugin",
@@ -107,6 +112,7 @@ RzBinPlugin rz_bin_plugin_cgc = {
 	.get_sdb = &get_sdb,
 	.load_buffer = load_buffer,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.baddr = &baddr,
 	.boffset = &boffset,
 	.binsym = &binsym,
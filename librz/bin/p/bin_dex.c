@@ -237,6 +237,11 @@ static RzList *maps(RzBinFile *bf) {
 	return maps;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("dex\n"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_dex = {
 	.name = "dex",
 	.desc = "dex bin plugin",
@@ -245,6 +250,7 @@ RzBinPlugin rz_bin_plugin_dex = {
 	.load_buffer = &load_buffer,
 	.destroy = &destroy,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.baddr = &baddr,
 	.binsym = &binsym,
 	.entries = &entrypoints,
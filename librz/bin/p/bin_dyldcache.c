@@ -74,10 +74,27 @@ static bool load_buffer(RzBinFile *bf, RzBinObject *obj, RzBuffer *buf, Sdb *sdb
 	if (!cache) {
 		return false;
 	}
+	if (bf->rbin && bf->rbin->lazy) {
+		rz_dyldcache_set_lazy(cache);
+	}
 	obj->bin_obj = cache;
 	return true;
 }
 
+static bool load_vaddr(RzBinFile *bf, ut64 vaddr) {
+	RzDyldCache *cache = (RzDyldCache *)bf->o->bin_obj;
+	if (!cache) {
+		return false;
+	}
+	RzDyldBinImage *bin = rz_dyldcache_image_at(cache, vaddr);
+	if (!bin || bin->loaded) {
+		return false;
+	}
+	RZ_LOG_INFO("dyldcache: loading %s\n", bin->file ? bin->file : "unnamed image");
+	bin->loaded = true;
+	return true;
+}
+
 static RzList *entries(RzBinFile *bf) {
 	RzBinAddr *ptr = NULL;
 	RzList *ret = rz_list_newf(free);
@@ -310,6 +327,9 @@ static RzList *sections(RzBinFile *bf) {
 	RzListIter *iter;
 	RzDyldBinImage *bin;
 	rz_list_foreach (cache->bins, iter, bin) {
+		if (!bin->loaded) {
+			continue;
+		}
 		sections_from_bin(ret, bf, bin);
 	}
 	ut64 slide = rz_dyldcache_get_slide(cache);
@@ -336,6 +356,9 @@ static RzList *symbols(RzBinFile *bf) {
 	RzListIter *iter;
 	RzDyldBinImage *bin;
 	rz_list_foreach (cache->bins, iter, bin) {
+		if (!bin->loaded) {
+			continue;
+		}
 		SetU *hash = set_u_new();
 		if (!hash) {
 			rz_list_free(ret);
@@ -393,6 +416,9 @@ static RzList *classes(RzBinFile *bf) {
 
 	ut32 num_of_unnamed_class = 0;
 	rz_list_foreach (cache->bins, iter, bin) {
+		if (!bin->loaded) {
+			continue;
+		}
 		struct MACH0_(obj_t) *mach0 = bin_to_mach0(bf, bin);
 		if (!mach0) {
 			goto beach;
@@ -656,6 +682,7 @@ RzBinPlugin rz_bin_plugin_dyldcache = {
 	.classes = &classes,
 	.header = &header,
 	.info = &info,
+	.load_vaddr = &load_vaddr,
 };
 
 #ifndef RZ_PLUGIN_INCORE
@@ -15,12 +15,18 @@ static ut64 get_elf_vaddr64(RzBinFile *bf, ut64 baddr, ut64 paddr, ut64 vaddr) {
 	return bin->baddr - bin->boffset + vaddr;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC(ELFMAG),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_elf64 = {
 	.name = "elf64",
 	.desc = "elf64 bin plugin",
 	.license = "LGPL3",
 	.get_sdb = &get_sdb,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.load_buffer = &load_buffer,
 	.baddr = &baddr,
 	.boffset = &boffset,
@@ -228,6 +228,11 @@ static char *enrich_asm(RzBinFile *bf, const char *asm_str, int asm_len) {
 	return NULL;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("\xca\xfe\xba\xbe"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_java = {
 	.name = "java",
 	.desc = "java bin plugin",
@@ -236,6 +241,7 @@ RzBinPlugin rz_bin_plugin_java = {
 	.load_buffer = &load_buffer,
 	.destroy = &destroy,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.baddr = &baddr,
 	.binsym = &binsym,
 	.entries = &entrypoints,
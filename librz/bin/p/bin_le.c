@@ -153,12 +153,20 @@ static RzList *strings(RzBinFile *bf) {
 	return rz_bin_file_strings(bf, 0, false);
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("LX"),
+	RZ_BIN_MAGIC("LE"),
+	RZ_BIN_MAGIC("MZ"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_le = {
 	.name = "le",
 	.desc = "LE/LX format plugin",
 	.author = "GustavoLCR",
 	.license = "LGPL3",
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.load_buffer = &load_buffer,
 	.destroy = &destroy,
 	.info = &info,
@@ -852,6 +852,12 @@ static RzList *strings(RzBinFile *bf) {
 	return rz_bin_file_strings(bf, 4, false);
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("\xce\xfa\xed\xfe"),
+	RZ_BIN_MAGIC("\xfe\xed\xfa\xce"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_mach0 = {
 	.name = "mach0",
 	.desc = "mach0 bin plugin",
@@ -860,6 +866,7 @@ RzBinPlugin rz_bin_plugin_mach0 = {
 	.load_buffer = &load_buffer,
 	.destroy = &destroy,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.baddr = &baddr,
 	.binsym = &binsym,
 	.entries = &entries,
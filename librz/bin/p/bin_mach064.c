@@ -291,6 +291,12 @@ static RzList *strings(RzBinFile *bf) {
 	return rz_bin_file_strings(bf, 4, false);
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("\xfe\xed\xfa\xcf"),
+	RZ_BIN_MAGIC("\xcf\xfa\xed\xfe"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_mach064 = {
 	.name = "mach064",
 	.desc = "mach064 bin plugin",
@@ -299,6 +305,7 @@ RzBinPlugin rz_bin_plugin_mach064 = {
 	.load_buffer = &load_buffer,
 	.destroy = &destroy,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.baddr = &baddr,
 	.binsym = binsym,
 	.entries = &entries,
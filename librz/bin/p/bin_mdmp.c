@@ -464,6 +464,11 @@ static RzList *strings(RzBinFile *bf) {
 	return rz_bin_file_strings(bf, 0, false);
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC(MDMP_MAGIC),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_mdmp = {
 	.name = "mdmp",
 	.desc = "Minidump format rz_bin plugin",
@@ -476,6 +481,7 @@ RzBinPlugin rz_bin_plugin_mdmp = {
 	.libs = &libs,
 	.load_buffer = &load_buffer,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.mem = &mem,
 	.relocs = &relocs,
 	.maps = &maps,
@@ -202,6 +202,11 @@ static RzBuffer *create(RzBin *bin, const ut8 *code, int codelen, const ut8 *dat
 	return buf;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("MENUET0"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_menuet = {
 	.name = "menuet",
 	.desc = "Menuet/KolibriOS bin plugin",
@@ -209,6 +214,7 @@ RzBinPlugin rz_bin_plugin_menuet = {
 	.load_buffer = &load_buffer,
 	.size = &size,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.baddr = &baddr,
 	.entries = &entries,
 	.maps = &rz_bin_maps_of_file_sections,
@@ -254,6 +254,11 @@ static RzList *relocs(RzBinFile *bf) {
 	return ret;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("MZ"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_mz = {
 	.name = "mz",
 	.desc = "MZ bin plugin",
@@ -262,6 +267,7 @@ RzBinPlugin rz_bin_plugin_mz = {
 	.load_buffer = &load,
 	.destroy = &destroy,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.binsym = &binsym,
 	.entries = &entries,
 	.maps = &rz_bin_maps_of_file_sections,
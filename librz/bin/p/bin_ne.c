@@ -115,12 +115,18 @@ RzList *relocs(RzBinFile *bf) {
 	return rz_bin_ne_get_relocs(bf->o->bin_obj);
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("MZ"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_ne = {
 	.name = "ne",
 	.desc = "NE format plugin",
 	.author = "GustavoLCR",
 	.license = "LGPL3",
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.load_buffer = &load_buffer,
 	.destroy = &destroy,
 	.header = &header,
@@ -220,6 +220,11 @@ static ut64 baddr(RzBinFile *bf) {
 	return 0;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC(INES_MAGIC),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_nes = {
 	.name = "nes",
 	.desc = "NES",
@@ -227,6 +232,7 @@ RzBinPlugin rz_bin_plugin_nes = {
 	.load_buffer = &load_buffer,
 	.baddr = &baddr,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.entries = &entries,
 	.maps = &rz_bin_maps_of_file_sections,
 	.sections = sections,
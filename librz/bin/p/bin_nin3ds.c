@@ -127,12 +127,18 @@ static RzBinInfo *info(RzBinFile *bf) {
 	return ret;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("FIRM"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_nin3ds = {
 	.name = "nin3ds",
 	.desc = "Nintendo 3DS FIRM format rz_bin plugin",
 	.license = "LGPL3",
 	.load_buffer = &load_buffer,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.entries = &entries,
 	.maps = &rz_bin_maps_of_file_sections,
 	.sections = &sections,
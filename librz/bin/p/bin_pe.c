@@ -456,6 +456,11 @@ static void header(RzBinFile *bf) {
 	}
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("MZ"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_pe = {
 	.name = "pe",
 	.desc = "PE bin plugin",
@@ -464,6 +469,7 @@ RzBinPlugin rz_bin_plugin_pe = {
 	.load_buffer = &load_buffer,
 	.destroy = &destroy,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.baddr = &baddr,
 	.binsym = &binsym,
 	.entries = &entries,
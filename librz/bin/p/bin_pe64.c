@@ -545,6 +545,11 @@ static RzList *trycatch(RzBinFile *bf) {
 	return tclist;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("MZ"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_pe64 = {
 	.name = "pe64",
 	.desc = "PE64 (PE32+) bin plugin",
@@ -553,6 +558,7 @@ RzBinPlugin rz_bin_plugin_pe64 = {
 	.load_buffer = &load_buffer,
 	.destroy = &destroy,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.baddr = &baddr,
 	.binsym = &binsym,
 	.entries = &entries,
@@ -182,12 +182,18 @@ static RzList *entries(RzBinFile *bf) {
 	return ret;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("PBLAPP\x00\x00"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_pebble = {
 	.name = "pebble",
 	.desc = "Pebble Watch App",
 	.license = "LGPL",
 	.load_buffer = &load_buffer,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.baddr = &baddr,
 	.entries = entries,
 	.maps = &rz_bin_maps_of_file_sections,
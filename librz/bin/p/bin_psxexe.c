@@ -113,12 +113,18 @@ static RzList *strings(RzBinFile *bf) {
 	return rz_bin_file_strings(bf, 20, true);
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC(PSXEXE_ID),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_psxexe = {
 	.name = "psxexe",
 	.desc = "Sony PlayStation 1 Executable",
 	.license = "LGPL3",
 	.load_buffer = &load_buffer,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.info = &info,
 	.maps = &rz_bin_maps_of_file_sections,
 	.sections = &sections,
@@ -307,6 +307,11 @@ static ut64 get_vaddr(RzBinFile *bf, ut64 baddr, ut64 paddr, ut64 vaddr) {
 }
 
 // Declaration of the plugin
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC(QNX_MAGIC),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_qnx = {
 	.name = "qnx",
 	.desc = "QNX executable file support",
@@ -317,6 +322,7 @@ RzBinPlugin rz_bin_plugin_qnx = {
 	.baddr = &baddr,
 	.author = "deepakchethan",
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.header = &header,
 	.get_sdb = &get_sdb,
 	.entries = &entries,
@@ -453,12 +453,18 @@ static RzBinSourceLineInfo *lines(RzBinFile *bf) {
 	return rz_bin_source_line_info_builder_build_and_fini(&alice);
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("\x02\xff\x01\xff"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_symbols = {
 	.name = "symbols",
 	.desc = "Apple Symbols file",
 	.license = "MIT",
 	.load_buffer = &load_buffer,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.symbols = &symbols,
 	.maps = &rz_bin_maps_of_file_sections,
 	.sections = &sections,
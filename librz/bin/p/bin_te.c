@@ -149,6 +149,11 @@ static bool check_buffer(RzBuffer *b) {
 	return false;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("VZ"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_te = {
 	.name = "te",
 	.desc = "TE bin plugin", // Terse Executable format
@@ -157,6 +162,7 @@ RzBinPlugin rz_bin_plugin_te = {
 	.load_buffer = &load_buffer,
 	.destroy = &destroy,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.baddr = &baddr,
 	.binsym = &binsym,
 	.entries = &entries,
@@ -532,6 +532,11 @@ static RzList *entries(RzBinFile *bf) {
 	return ret;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC(VICE_MAGIC),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_vsf = {
 	.name = "vsf",
 	.desc = "VICE Snapshot File",
@@ -539,6 +544,7 @@ RzBinPlugin rz_bin_plugin_vsf = {
 	.get_sdb = &get_sdb,
 	.load_buffer = &load_buffer,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.entries = &entries,
 	.maps = &rz_bin_maps_of_file_sections,
 	.sections = sections,
@@ -324,6 +324,11 @@ static RzBuffer *create(RzBin *bin, const ut8 *code, int codelen, const ut8 *dat
 	return buf;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC(RZ_BIN_WASM_MAGIC_BYTES),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_wasm = {
 	.name = "wasm",
 	.desc = "WebAssembly bin plugin",
@@ -332,6 +337,7 @@ RzBinPlugin rz_bin_plugin_wasm = {
 	.size = &size,
 	.destroy = &destroy,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.baddr = &baddr,
 	.binsym = &binsym,
 	.entries = &entries,
@@ -353,6 +353,11 @@ static ut64 baddr(RzBinFile *bf) {
 	return obj->header.base;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("XBEH"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_xbe = {
 	.name = "xbe",
 	.desc = "Microsoft Xbox xbe format rz_bin plugin",
@@ -360,6 +365,7 @@ RzBinPlugin rz_bin_plugin_xbe = {
 	.load_buffer = &load_buffer,
 	.destroy = &destroy,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.baddr = &baddr,
 	.binsym = &binsym,
 	.entries = &entries,
@@ -32,7 +32,9 @@ typedef struct _RKext {
 	char *name;
 	ut64 mod_info;
 	ut64 vaddr;
-	struct MACH0_(obj_t) * mach0;
+	struct MACH0_(obj_t) * mach0; ///< parsed on first use, see kext_mach0()
+	bool shared_mach0; ///< mach0 is parsed from the whole cache buffer instead of a slice of it
+	bool loaded; ///< sections and symbols are listed, false until its address is accessed with bin.lazy
 	bool own_name;
 	ut64 pa2va_exec;
 	ut64 pa2va_data;
@@ -109,7 +111,8 @@ static RStubsInfo *get_stubs_info(struct MACH0_(obj_t) * mach0, ut64 paddr, RzXN
 static int prot2perm(int x);
 
 static void rz_kext_free(RKext *kext);
-static void rz_kext_fill_text_range(RKext *kext);
+static bool rz_kext_fill_text_range(RzXNUKernelCacheObj *obj, RKext *kext);
+static struct MACH0_(obj_t) * kext_mach0(RzXNUKernelCacheObj *obj, RKext *kext);
 static int kexts_sort_vaddr_func(const void *a, const void *b);
 static struct MACH0_(obj_t) * create_kext_mach0(RzXNUKernelCacheObj *obj, RKext *kext);
 static struct MACH0_(obj_t) * create_kext_shared_mach0(RzXNUKernelCacheObj *obj, RKext *kext);
@@ -172,6 +175,7 @@ static bool load_buffer(RzBinFile *bf, RzBinObject *o, RzBuffer *buf, Sdb *sdb)
 	obj->pa2va_exec = prelink_range->pa2va_exec;
 	obj->pa2va_data = prelink_range->pa2va_data;
 
+	obj->lazy_kexts = bf->rbin && bf->rbin->lazy;
 	o->bin_obj = obj;
 
 	if (rz_xnu_kernelcache_needs_rebasing(obj)) {
@@ -218,6 +222,27 @@ static void ensure_kexts_initialized(RzXNUKernelCacheObj *obj) {
 	}
 
 	obj->kexts = rz_kext_index_new(kexts);
+
+	int i;
+	RKext *kext;
+	rz_kext_index_foreach(obj->kexts, i, kext) {
+		kext->loaded = !obj->lazy_kexts;
+	}
+}
+
+static bool load_vaddr(RzBinFile *bf, ut64 vaddr) {
+	RzXNUKernelCacheObj *obj = (RzXNUKernelCacheObj *)bf->o->bin_obj;
+	if (!obj) {
+		return false;
+	}
+	ensure_kexts_initialized(obj);
+	RKext *kext = obj->kexts ? rz_kext_index_vget(obj->kexts, vaddr) : NULL;
+	if (!kext || kext->loaded) {
+		return false;
+	}
+	RZ_LOG_INFO("kernelcache: loading %s\n", kext->name);
+	kext->loaded = true;
+	return true;
 }
 
 static RPrelinkRange *get_prelink_info_range_from_mach0(struct MACH0_(obj_t) * mach0) {
@@ -368,14 +393,11 @@ static RzList *filter_kexts(RzXNUKernelCacheObj *obj) {
 		}
 		prev_kext = kext;
 
-		kext->mach0 = create_kext_mach0(obj, kext);
-		if (!kext->mach0) {
+		if (!rz_kext_fill_text_range(obj, kext)) {
 			rz_kext_free(kext);
 			continue;
 		}
 
-		rz_kext_fill_text_range(kext);
-
 		rz_list_push(kexts, kext);
 	}
 
@@ -495,13 +517,11 @@ static RzList *carve_kexts(RzXNUKernelCacheObj *obj) {
 		kext->vaddr = K_RPTR(bytes);
 		kext->range.offset = kext->vaddr - pa2va_exec;
 
-		kext->mach0 = create_kext_mach0(obj, kext);
-		if (!kext->mach0) {
+		if (!rz_kext_fill_text_range(obj, kext)) {
 			rz_kext_free(kext);
 			continue;
 		}
 
-		rz_kext_fill_text_range(kext);
 		kext->vaddr = K_PPTR(kext->vaddr);
 		kext->pa2va_exec = pa2va_exec;
 		kext->pa2va_data = pa2va_data;
@@ -611,15 +631,14 @@ static RzList *kexts_from_load_commands(RzXNUKernelCacheObj *obj) {
 		kext->vaddr = vaddr;
 		kext->range.offset = paddr;
 
-		kext->mach0 = create_kext_shared_mach0(obj, kext);
-		if (!kext->mach0) {
+		kext->shared_mach0 = true;
+		if (!rz_kext_fill_text_range(obj, kext)) {
 			free(padded_name);
 			rz_kext_free(kext);
 			cursor += cmdsize;
 			continue;
 		}
 
-		rz_kext_fill_text_range(kext);
 		kext->vaddr = K_PPTR(kext->vaddr);
 		kext->pa2va_exec = obj->pa2va_exec;
 		kext->pa2va_data = obj->pa2va_data;
@@ -656,23 +675,63 @@ static void rz_kext_free(RKext *kext) {
 	RZ_FREE(kext);
 }
 
-static void rz_kext_fill_text_range(RKext *kext) {
-	struct section_t *sections = NULL;
-	if (!(sections = MACH0_(get_sections)(kext->mach0))) {
-		return;
+/*
+ * Only the __TEXT_EXEC.__text section of the kext is looked up in its load
+ * commands to index it, parsing the whole Mach-O of every kext is left to
+ * kext_mach0() for the kexts whose sections or symbols are listed.
+ */
+static bool rz_kext_fill_text_range(RzXNUKernelCacheObj *obj, RKext *kext) {
+	ut64 at = kext->range.offset;
+	ut8 hdr[sizeof(struct MACH0_(mach_header))];
+	if (rz_buf_read_at(obj->cache_buf, at, hdr, sizeof(hdr)) != sizeof(hdr)) {
+		return false;
 	}
-
-	int i = 0;
-	for (; !sections[i].last; i++) {
-		if (strstr(sections[i].name, "__TEXT_EXEC.__text")) {
-			kext->text_range.offset = sections[i].offset;
-			kext->text_range.size = sections[i].size;
-			kext->vaddr = sections[i].addr;
+	ut32 magic = rz_read_le32(hdr);
+	if (magic != MH_MAGIC_64) {
+		// not listed by sections() and symbols() anyway
+		return magic == MH_CIGAM_64 || magic == MH_MAGIC || magic == MH_CIGAM || magic == FAT_MAGIC || magic == FAT_CIGAM;
+	}
+	ut32 ncmds = rz_read_le32(hdr + 16);
+	ut64 cursor = at + sizeof(hdr);
+	for (ut32 i = 0; i < ncmds; i++) {
+		ut8 cmd[72];
+		if (rz_buf_read_at(obj->cache_buf, cursor, cmd, 8) != 8) {
 			break;
 		}
+		ut32 cmdsize = rz_read_le32(cmd + 4);
+		if (cmdsize < 8) {
+			break;
+		}
+		if (rz_read_le32(cmd) == LC_SEGMENT_64 && cmdsize >= sizeof(cmd) &&
+			rz_buf_read_at(obj->cache_buf, cursor, cmd, sizeof(cmd)) == sizeof(cmd) &&
+			!strncmp((char *)cmd + 8, "__TEXT_EXEC", 16)) {
+			ut32 nsects = rz_read_le32(cmd + 64);
+			ut64 sect_at = cursor + sizeof(cmd);
+			for (ut32 j = 0; j < nsects && sect_at + 80 <= cursor + cmdsize; j++, sect_at += 80) {
+				ut8 sect[80];
+				if (rz_buf_read_at(obj->cache_buf, sect_at, sect, sizeof(sect)) != sizeof(sect)) {
+					break;
+				}
+				if (!strncmp((char *)sect, "__text", 6)) {
+					kext->vaddr = rz_read_le64(sect + 32);
+					kext->text_range.size = rz_read_le64(sect + 40);
+					kext->text_range.offset = rz_read_le32(sect + 48);
+					return true;
+				}
+			}
+		}
+		cursor += cmdsize;
 	}
+	return true;
+}
 
-	RZ_FREE(sections);
+static struct MACH0_(obj_t) * kext_mach0(RzXNUKernelCacheObj *obj, RKext *kext) {
+	if (!kext->mach0) {
+		kext->mach0 = kext->shared_mach0
+			? create_kext_shared_mach0(obj, kext)
+			: create_kext_mach0(obj, kext);
+	}
+	return kext->mach0;
 }
 
 static int kexts_sort_vaddr_func(const void *a, const void *b) {
@@ -1064,9 +1123,13 @@ static RzList *sections(RzBinFile *bf) {
 		rz_buf_read_at(kobj->cache_buf, kext->range.offset, magicbytes, 4);
 		int magic = rz_read_le32(magicbytes);
 		switch (magic) {
-		case MH_MAGIC_64:
-			sections_from_mach0(ret, kext->mach0, bf, kext->range.offset, kext->name, kobj);
+		case MH_MAGIC_64: {
+			struct MACH0_(obj_t) *mach0 = kext->loaded ? kext_mach0(kobj, kext) : NULL;
+			if (mach0) {
+				sections_from_mach0(ret, mach0, bf, kext->range.offset, kext->name, kobj);
+			}
 			break;
+		}
 		default:
 			eprintf("Unknown sub-bin\n");
 			break;
@@ -1227,13 +1290,18 @@ static RzList *symbols(RzBinFile *bf) {
 		rz_buf_read_at(obj->cache_buf, kext->range.offset, magicbytes, 4);
 		int magic = rz_read_le32(magicbytes);
 		switch (magic) {
-		case MH_MAGIC_64:
-			symbols_from_mach0(ret, kext->mach0, bf, kext->range.offset, rz_list_length(ret));
+		case MH_MAGIC_64: {
+			struct MACH0_(obj_t) *mach0 = kext->loaded ? kext_mach0(obj, kext) : NULL;
+			if (!mach0) {
+				break;
+			}
+			symbols_from_mach0(ret, mach0, bf, kext->range.offset, rz_list_length(ret));
 			symbols_from_stubs(ret, kernel_syms_by_addr, obj, bf, kext, rz_list_length(ret));
-			process_constructors(obj, kext->mach0, ret, kext->range.offset, false, RZ_K_CONSTRUCTOR_TO_SYMBOL, kext_short_name(kext));
+			process_constructors(obj, mach0, ret, kext->range.offset, false, RZ_K_CONSTRUCTOR_TO_SYMBOL, kext_short_name(kext));
 			process_kmod_init_term(obj, kext, ret, &inits, &terms);
 
 			break;
+		}
 		default:
 			eprintf("Unknown sub-bin\n");
 			break;
@@ -1627,7 +1695,7 @@ static ut64 extract_addr_from_code(ut8 *arm64_code, ut64 vaddr) {
 }
 
 static void symbols_from_stubs(RzList *ret, HtPP *kernel_syms_by_addr, RzXNUKernelCacheObj *obj, RzBinFile *bf, RKext *kext, int ordinal) {
-	RStubsInfo *stubs_info = get_stubs_info(kext->mach0, kext->range.offset, obj);
+	RStubsInfo *stubs_info = get_stubs_info(kext_mach0(obj, kext), kext->range.offset, obj);
 	if (!stubs_info) {
 		return;
 	}
@@ -1929,6 +1997,11 @@ static void rz_rebase_info_free(RzXNUKernelCacheRebaseInfo *info) {
 	RZ_FREE(info);
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("\xcf\xfa\xed\xfe"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_xnu_kernelcache = {
 	.name = "kernelcache",
 	.desc = "kernelcache bin plugin",
@@ -1942,7 +2015,9 @@ RzBinPlugin rz_bin_plugin_xnu_kernelcache = {
 	.symbols = &symbols,
 	.sections = &sections,
 	.check_buffer = &check_buffer,
-	.info = &info
+	.magics = magics,
+	.info = &info,
+	.load_vaddr = &load_vaddr,
 };
 
 #ifndef RZ_PLUGIN_INCORE
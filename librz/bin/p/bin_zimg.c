@@ -54,6 +54,11 @@ static RzBinInfo *info(RzBinFile *bf) {
 	return ret;
 }
 
+static const RzBinMagic magics[] = {
+	RZ_BIN_MAGIC("\x00\x00\xa0\xe1\x00\x00\xa0\xe1"),
+	{ 0 }
+};
+
 RzBinPlugin rz_bin_plugin_zimg = {
 	.name = "zimg",
 	.desc = "zimg format bin plugin",
@@ -61,6 +66,7 @@ RzBinPlugin rz_bin_plugin_zimg = {
 	.get_sdb = &get_sdb,
 	.load_buffer = &load_buffer,
 	.check_buffer = &check_buffer,
+	.magics = magics,
 	.baddr = &baddr,
 	.info = &info,
 };
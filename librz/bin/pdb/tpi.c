@@ -708,6 +708,8 @@ RZ_IPI void free_tpi_stream(RzPdbTpiStream *stream) {
 	}
 	rz_rbtree_free(stream->types, free_tpi_rbtree, NULL);
 	rz_list_free(stream->print_type);
+	rz_vector_fini(&stream->records);
+	rz_buf_free(stream->buf);
 	free(stream);
 }
 
@@ -1796,6 +1798,38 @@ static bool parse_tpi_stream_header(RzPdbTpiStream *s, RzBuffer *buf) {
 		rz_buf_read_le32(buf, &s->header.HashAdjBufferLength);
 }
 
+/**
+ * Only the offset and the leaf type of each record are read here,
+ * the records are decoded by rz_bin_pdb_get_type_by_index() when needed.
+ */
+static bool index_tpi_records(RzPdbTpiStream *s, RzBuffer *buf) {
+	if (s->header.TypeIndexEnd < s->header.TypeIndexBegin) {
+		return false;
+	}
+	ut64 offset = rz_buf_tell(buf);
+	ut64 end = offset + s->header.TypeRecordBytes;
+	if (end > rz_buf_size(buf) || end > UT32_MAX) {
+		return false;
+	}
+	ut32 count = s->header.TypeIndexEnd - s->header.TypeIndexBegin;
+	// every record has at least its length and leaf type
+	if (count > s->header.TypeRecordBytes / 4 || !rz_vector_reserve(&s->records, count)) {
+		return false;
+	}
+	for (ut32 i = 0; i < count; i++) {
+		ut16 length;
+		RzPdbTpiRecord *rec = rz_vector_push(&s->records, NULL);
+		if (!rz_buf_read_le16_at(buf, offset, &length) || length < 2 || offset + 2 + length > end ||
+			!rz_buf_read_le16_at(buf, offset + 2, &rec->leaf_type)) {
+			return false;
+		}
+		rec->offset = (ut32)offset;
+		rec->invalid = false;
+		offset += 2 + length;
+	}
+	return true;
+}
+
 RZ_IPI bool parse_tpi_stream(RzPdb *pdb, RzPdbMsfStream *stream) {
 	if (!pdb || !stream) {
 		return false;
@@ -1811,6 +1845,7 @@ RZ_IPI bool parse_tpi_stream(RzPdb *pdb, RzPdbMsfStream *stream) {
 		return false;
 	}
 	s->types = NULL;
+	rz_vector_init(&s->records, sizeof(RzPdbTpiRecord), NULL, NULL);
 	RzBuffer *buf = stream->stream_data;
 	if (!parse_tpi_stream_header(s, buf)) {
 		return false;
@@ -1819,25 +1854,39 @@ RZ_IPI bool parse_tpi_stream(RzPdb *pdb, RzPdbMsfStream *stream) {
 		RZ_LOG_ERROR("Corrupted TPI stream.\n");
 		return false;
 	}
-	RzPdbTpiType *type;
-	for (ut32 i = s->header.TypeIndexBegin; i < s->header.TypeIndexEnd; i++) {
-		type = RZ_NEW0(RzPdbTpiType);
-		if (!type) {
-			continue;
-		}
-		type->type_index = i;
-		if (!parse_tpi_types(buf, type) || !type->type_data) {
-			RZ_LOG_ERROR("Parse TPI type error. idx in stream: 0x%" PFMT32x "\n", i);
-			RZ_FREE(type);
-			return false;
-		}
-		rz_rbtree_insert(&s->types, &type->type_index, &type->rb, tpi_type_node_cmp, NULL);
+	if (!index_tpi_records(s, buf)) {
+		RZ_LOG_ERROR("Corrupted TPI stream records.\n");
+		return false;
 	}
+	s->buf = rz_buf_ref(buf);
 	return true;
 }
 
+static RzPdbTpiType *decode_tpi_record(RzPdbTpiStream *stream, ut32 index) {
+	RzPdbTpiRecord *rec = rz_vector_index_ptr(&stream->records, index - stream->header.TypeIndexBegin);
+	if (rec->invalid) {
+		return NULL;
+	}
+	RzPdbTpiType *type = RZ_NEW0(RzPdbTpiType);
+	if (!type) {
+		return NULL;
+	}
+	type->type_index = index;
+	if (rz_buf_seek(stream->buf, rec->offset, RZ_BUF_SET) < 0 || !parse_tpi_types(stream->buf, type) || !type->type_data) {
+		RZ_LOG_ERROR("Parse TPI type error. idx in stream: 0x%" PFMT32x "\n", index);
+		free(type);
+		rec->invalid = true;
+		return NULL;
+	}
+	rz_rbtree_insert(&stream->types, &type->type_index, &type->rb, tpi_type_node_cmp, NULL);
+	return type;
+}
+
 /**
  * \brief Get RzPdbTpiType that matches tpi stream index
+ *
+ * The type record is decoded on the first call for \p index.
+ *
  * \param stream TPI Stream
  * \param index TPI Stream Index
  */
@@ -1849,12 +1898,28 @@ RZ_API RZ_BORROW RzPdbTpiType *rz_bin_pdb_get_type_by_index(RZ_NONNULL RzPdbTpiS
 
 	RBNode *node = rz_rbtree_find(stream->types, &index, tpi_type_node_cmp, NULL);
 	if (!node) {
-		if (!is_simple_type(stream, index)) {
-			return NULL;
-		} else {
+		if (is_simple_type(stream, index)) {
 			return parse_simple_type(stream, index);
 		}
+		if (index - stream->header.TypeIndexBegin < rz_vector_len(&stream->records)) {
+			return decode_tpi_record(stream, index);
+		}
+		return NULL;
 	}
 	RzPdbTpiType *type = container_of(node, RzPdbTpiType, rb);
 	return type;
 }
+
+/**
+ * \brief Get the leaf type of the record at \p index without decoding the record
+ *
+ * \return the leaf type or 0 if \p index is not the index of a record
+ */
+RZ_API ut16 rz_bin_pdb_get_type_leaf(RZ_NONNULL RzPdbTpiStream *stream, ut32 index) {
+	rz_return_val_if_fail(stream, 0);
+	if (index < stream->header.TypeIndexBegin || index - stream->header.TypeIndexBegin >= rz_vector_len(&stream->records)) {
+		return 0;
+	}
+	RzPdbTpiRecord *rec = rz_vector_index_ptr(&stream->records, index - stream->header.TypeIndexBegin);
+	return rec->leaf_type;
+}
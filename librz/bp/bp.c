@@ -36,6 +36,7 @@ RZ_API RzBreakpoint *rz_bp_new(RZ_BORROW RZ_NONNULL RzBreakpointContext *ctx) {
 	bp->traces = rz_bp_traptrace_new();
 	bp->cb_printf = (PrintfCallback)printf;
 	bp->bps = rz_list_newf((RzListFree)rz_bp_item_free);
+	rz_interval_tree_init(&bp->bps_tree, NULL);
 	bp->plugins = rz_list_newf((RzListFree)free);
 	bp->nhwbps = 0;
 	for (i = 0; bp_static_plugins[i]; i++) {
@@ -46,6 +47,7 @@ RZ_API RzBreakpoint *rz_bp_new(RZ_BORROW RZ_NONNULL RzBreakpointContext *ctx) {
 }
 
 RZ_API RzBreakpoint *rz_bp_free(RzBreakpoint *bp) {
+	rz_interval_tree_fini(&bp->bps_tree);
 	rz_list_free(bp->bps);
 	rz_list_free(bp->plugins);
 	rz_list_free(bp->traces);
@@ -101,14 +103,23 @@ repeat:
  */
 RZ_API RZ_BORROW RzBreakpointItem *rz_bp_get_at(RZ_NONNULL RzBreakpoint *bp, ut64 addr) {
 	rz_return_val_if_fail(bp, NULL);
-	RzListIter *iter;
-	RzBreakpointItem *b;
-	rz_list_foreach (bp->bps, iter, b) {
-		if (b->addr == addr) {
-			return b;
-		}
+	return rz_interval_tree_at(&bp->bps_tree, addr);
+}
+
+typedef struct {
+	ut64 addr;
+	int perm;
+	RzBreakpointItem *found;
+} BpLookup;
+
+static bool bp_ending_at_cb(RzIntervalNode *node, void *user) {
+	BpLookup *lookup = user;
+	RzBreakpointItem *b = node->data;
+	if (!b->hw && node->end == lookup->addr) {
+		lookup->found = b;
+		return false;
 	}
-	return NULL;
+	return true;
 }
 
 /**
@@ -118,35 +129,34 @@ RZ_API RZ_BORROW RzBreakpointItem *rz_bp_get_at(RZ_NONNULL RzBreakpoint *bp, ut6
  */
 RZ_API RZ_BORROW RzBreakpointItem *rz_bp_get_ending_at(RZ_NONNULL RzBreakpoint *bp, ut64 addr) {
 	rz_return_val_if_fail(bp, NULL);
-	RzListIter *iter;
-	RzBreakpointItem *b;
-	rz_list_foreach (bp->bps, iter, b) {
-		if (!b->hw && b->addr + b->size == addr) {
-			return b;
-		}
+	if (!addr) {
+		return NULL;
 	}
-	return NULL;
-}
-
-static inline bool inRange(RzBreakpointItem *b, ut64 addr) {
-	return (addr >= b->addr && addr < (b->addr + b->size));
+	// the breakpoint ending at addr contains the byte before it
+	BpLookup lookup = { .addr = addr };
+	rz_interval_tree_all_in(&bp->bps_tree, addr - 1, false, bp_ending_at_cb, &lookup);
+	return lookup.found;
 }
 
 static inline bool matchProt(RzBreakpointItem *b, int perm) {
 	return (!perm || (perm && b->perm));
 }
 
-RZ_API RzBreakpointItem *rz_bp_get_in(RzBreakpoint *bp, ut64 addr, int perm) {
-	RzBreakpointItem *b;
-	RzListIter *iter;
-	rz_list_foreach (bp->bps, iter, b) {
-		// eprintf ("---ataddr--- 0x%08"PFMT64x" %d %d %x\n", b->addr, b->size, b->recoil, b->perm);
-		// Check addr within range and provided perm matches (or null)
-		if (inRange(b, addr) && matchProt(b, perm)) {
-			return b;
-		}
+static bool bp_in_cb(RzIntervalNode *node, void *user) {
+	BpLookup *lookup = user;
+	RzBreakpointItem *b = node->data;
+	if (matchProt(b, lookup->perm)) {
+		lookup->found = b;
+		return false;
 	}
-	return NULL;
+	return true;
+}
+
+RZ_API RzBreakpointItem *rz_bp_get_in(RzBreakpoint *bp, ut64 addr, int perm) {
+	// Check addr within range and provided perm matches (or null)
+	BpLookup lookup = { .addr = addr, .perm = perm };
+	rz_interval_tree_all_in(&bp->bps_tree, addr, false, bp_in_cb, &lookup);
+	return lookup.found;
 }
 
 RZ_API RzBreakpointItem *rz_bp_enable(RzBreakpoint *bp, ut64 addr, int set, int count) {
@@ -173,6 +183,13 @@ RZ_API int rz_bp_stepy_continuation(RzBreakpoint *bp) {
 	return bp->stepcont;
 }
 
+static void bp_index_remove(RzBreakpoint *bp, RzBreakpointItem *b) {
+	RzIntervalNode *node = rz_interval_tree_node_at_data(&bp->bps_tree, b->addr, b);
+	if (node) {
+		rz_interval_tree_delete(&bp->bps_tree, node, false);
+	}
+}
+
 static void unlinkBreakpoint(RzBreakpoint *bp, RzBreakpointItem *b) {
 	int i;
 	for (i = 0; i < bp->bps_idx_count; i++) {
@@ -180,6 +197,7 @@ static void unlinkBreakpoint(RzBreakpoint *bp, RzBreakpointItem *b) {
 			bp->bps_idx[i] = NULL;
 		}
 	}
+	bp_index_remove(bp, b);
 	rz_list_delete_data(bp->bps, b);
 }
 
@@ -212,6 +230,7 @@ RZ_IPI void rz_bp_item_insert(RzBreakpoint *bp, RzBreakpointItem *b) {
 	bp->bps_idx[i] = b;
 	bp->nbps++;
 	rz_list_append(bp->bps, b);
+	rz_interval_tree_insert(&bp->bps_tree, b->addr, b->addr + b->size, b);
 }
 
 /* TODO: detect overlapping of breakpoints */
@@ -303,6 +322,8 @@ RZ_API RzBreakpointItem *rz_bp_add_hw(RzBreakpoint *bp, ut64 addr, int size, int
 RZ_API bool rz_bp_del_all(RzBreakpoint *bp) {
 	int i;
 	if (!rz_list_empty(bp->bps)) {
+		rz_interval_tree_fini(&bp->bps_tree);
+		rz_interval_tree_init(&bp->bps_tree, NULL);
 		rz_list_purge(bp->bps);
 		for (i = 0; i < bp->bps_idx_count; i++) {
 			bp->bps_idx[i] = NULL;
@@ -313,17 +334,12 @@ RZ_API bool rz_bp_del_all(RzBreakpoint *bp) {
 }
 
 RZ_API bool rz_bp_del(RzBreakpoint *bp, ut64 addr) {
-	RzListIter *iter;
-	RzBreakpointItem *b;
-	/* No _safe loop necessary because we return immediately after the delete. */
-	rz_list_foreach (bp->bps, iter, b) {
-		if (b->addr == addr) {
-			unlinkBreakpoint(bp, b);
-			// rz_list_delete (bp->bps, iter);
-			return true;
-		}
+	RzBreakpointItem *b = rz_bp_get_at(bp, addr);
+	if (!b) {
+		return false;
 	}
-	return false;
+	unlinkBreakpoint(bp, b);
+	return true;
 }
 
 RZ_API int rz_bp_set_trace(RzBreakpoint *bp, ut64 addr, int set) {
@@ -352,9 +368,13 @@ RZ_API RzBreakpointItem *rz_bp_get_index(RzBreakpoint *bp, int idx) {
 }
 
 RZ_API int rz_bp_get_index_at(RzBreakpoint *bp, ut64 addr) {
+	RzBreakpointItem *b = rz_bp_get_at(bp, addr);
+	if (!b) {
+		return -1;
+	}
 	int i;
 	for (i = 0; i < bp->bps_idx_count; i++) {
-		if (bp->bps_idx[i] && bp->bps_idx[i]->addr == addr) {
+		if (bp->bps_idx[i] == b) {
 			return i;
 		}
 	}
@@ -363,6 +383,9 @@ RZ_API int rz_bp_get_index_at(RzBreakpoint *bp, ut64 addr) {
 
 RZ_API int rz_bp_del_index(RzBreakpoint *bp, int idx) {
 	if (idx >= 0 && idx < bp->bps_idx_count) {
+		if (bp->bps_idx[idx]) {
+			bp_index_remove(bp, bp->bps_idx[idx]);
+		}
 		rz_list_delete_data(bp->bps, bp->bps_idx[idx]);
 		bp->bps_idx[idx] = 0;
 		return true;
@@ -413,6 +436,25 @@ RZ_API bool rz_bp_is_valid(RzBreakpoint *bp, RzBreakpointItem *b) {
 	return bp->ctx.is_mapped(b->addr, b->perm, bp->ctx.user);
 }
 
+/**
+ * \brief Move \p item, which must belong to \p bp, to \p addr
+ *
+ * The address of an item must only be changed through this function
+ * so the lookups by address keep finding it.
+ */
+RZ_API bool rz_bp_item_set_addr(RZ_NONNULL RzBreakpoint *bp, RZ_NONNULL RzBreakpointItem *item, ut64 addr) {
+	rz_return_val_if_fail(bp && item, false);
+	if (item->addr == addr) {
+		return true;
+	}
+	RzIntervalNode *node = rz_interval_tree_node_at_data(&bp->bps_tree, item->addr, item);
+	item->addr = addr;
+	if (node) {
+		return rz_interval_tree_resize(&bp->bps_tree, node, addr, addr + item->size);
+	}
+	return rz_interval_tree_insert(&bp->bps_tree, addr, addr + item->size, item);
+}
+
 /**
  * \brief set the condition for a RzBreakpointItem
  *
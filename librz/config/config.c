@@ -27,7 +27,7 @@ RZ_API RZ_OWN RzConfigNode *rz_config_node_clone(RzConfigNode *n) {
 	cn->desc = n->desc ? strdup(n->desc) : NULL;
 	cn->value = strdup(n->value ? n->value : "");
 	cn->i_value = n->i_value;
-	cn->flags = n->flags;
+	cn->flags = n->flags & ~CN_STATIC_DESC;
 	cn->setter = n->setter;
 	cn->options = rz_list_clone(n->options);
 	return cn;
@@ -39,7 +39,9 @@ RZ_API void rz_config_node_free(RZ_NULLABLE void *n) {
 		return;
 	}
 	free(node->name);
-	free(node->desc);
+	if (!(node->flags & CN_STATIC_DESC)) {
+		free(node->desc);
+	}
 	free(node->value);
 	rz_list_free(node->options);
 	free(node);
@@ -194,6 +196,13 @@ static bool __is_true_or_false(const char *s) {
 	return s && (!rz_str_casecmp(s, "true") || !rz_str_casecmp(s, "false"));
 }
 
+// only count real changes, writing back the same value keeps dependent caches valid
+static void update_generation(RzConfig *cfg, RzConfigNode *node, const char *ov) {
+	if (node && (!ov || !node->value || strcmp(ov, node->value))) {
+		cfg->generation++;
+	}
+}
+
 /**
  * Writes the boolean \p value in the config variable of \p name only and only if
  * the variable is boolean.
@@ -254,6 +263,7 @@ RZ_API RzConfigNode *rz_config_set_b(RzConfig *cfg, RZ_NONNULL const char *name,
 			node->value = strdup(ov ? ov : "");
 		}
 	}
+	update_generation(cfg, node, ov);
 
 beach:
 	free(ov);
@@ -347,6 +357,7 @@ RZ_API RzConfigNode *rz_config_set(RzConfig *cfg, RZ_NONNULL const char *name, c
 			return NULL;
 		}
 	}
+	update_generation(cfg, node, ov);
 beach:
 	free(ov);
 	return node;
@@ -383,8 +394,31 @@ RZ_API const char *rz_config_desc(RzConfig *cfg, RZ_NONNULL const char *name, RZ
 RZ_API const char *rz_config_node_desc(RzConfigNode *node, RZ_NULLABLE const char *desc) {
 	rz_return_val_if_fail(node, NULL);
 	if (desc) {
-		free(node->desc);
+		if (!(node->flags & CN_STATIC_DESC)) {
+			free(node->desc);
+		}
 		node->desc = strdup(desc);
+		node->flags &= ~CN_STATIC_DESC;
+	}
+	return node->desc;
+}
+
+/**
+ * \brief Like rz_config_node_desc(), but \p desc is referenced instead of copied
+ *
+ * Meant for the descriptions of the tables of variables registered at startup,
+ * so \p desc must outlive the node, e.g. a string literal. It is only copied
+ * once the description is changed again through rz_config_node_desc() or the
+ * node is cloned.
+ */
+RZ_API const char *rz_config_node_desc_static(RzConfigNode *node, RZ_NULLABLE const char *desc) {
+	rz_return_val_if_fail(node, NULL);
+	if (desc) {
+		if (!(node->flags & CN_STATIC_DESC)) {
+			free(node->desc);
+		}
+		node->desc = (char *)desc;
+		node->flags |= CN_STATIC_DESC;
 	}
 	return node->desc;
 }
@@ -464,6 +498,7 @@ RZ_API RzConfigNode *rz_config_set_i(RzConfig *cfg, const char *name, const ut64
 			node->value = strdup(ov ? ov : "");
 		}
 	}
+	update_generation(cfg, node, ov);
 beach:
 	free(ov);
 	return node;
@@ -487,14 +522,27 @@ RZ_API bool rz_config_readonly(RzConfig *cfg, const char *key) {
 	return false;
 }
 
+static HtPP *config_ht_new(void) {
+	// the keys are the names owned by the nodes, no need to copy them
+	HtPPOptions opt = {
+		.cmp = (HtPPListComparator)strcmp,
+		.hashfn = (HtPPHashFunction)sdb_hash,
+		.calcsizeK = (HtPPCalcSizeK)strlen,
+		.elem_size = sizeof(HtPPKv),
+	};
+	return ht_pp_new_opt(&opt);
+}
+
 RZ_API RzConfig *rz_config_new(void *user) {
 	RzConfig *cfg = RZ_NEW0(RzConfig);
 	if (!cfg) {
 		return NULL;
 	}
-	cfg->ht = ht_pp_new0();
+	cfg->ht = config_ht_new();
 	cfg->nodes = rz_list_newf((RzListFree)rz_config_node_free);
-	if (!cfg->nodes) {
+	if (!cfg->ht || !cfg->nodes) {
+		ht_pp_free(cfg->ht);
+		rz_list_free(cfg->nodes);
 		RZ_FREE(cfg);
 		return NULL;
 	}
@@ -513,7 +561,7 @@ RZ_API RzConfig *rz_config_clone(RzConfig *cfg) {
 	}
 	rz_list_foreach (cfg->nodes, iter, node) {
 		RzConfigNode *nn = rz_config_node_clone(node);
-		ht_pp_insert(c->ht, node->name, nn);
+		ht_pp_insert(c->ht, nn->name, nn);
 		rz_list_append(c->nodes, nn);
 	}
 	c->lock = cfg->lock;
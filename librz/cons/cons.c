@@ -11,6 +11,8 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include "screen_private.h"
+#include "grep_private.h"
 
 #define COUNT_LINES 1
 #define CTX(x)      I.context->x
@@ -51,6 +53,7 @@ static void break_stack_free(void *ptr) {
 
 static void cons_stack_free(void *ptr) {
 	RzConsStack *s = (RzConsStack *)ptr;
+	RZ_MEM_UNTRACK(s->buf);
 	free(s->buf);
 	if (s->grep) {
 		RZ_FREE(s->grep->str);
@@ -84,6 +87,7 @@ static RzConsStack *cons_stack_dump(bool recreate) {
 				free(data);
 				return NULL;
 			}
+			RZ_MEM_TRACK(RZ_MEM_ACCOUNT_CONS, CTX(buffer), CTX(buffer_sz));
 		} else {
 			CTX(buffer) = NULL;
 		}
@@ -94,6 +98,7 @@ static RzConsStack *cons_stack_dump(bool recreate) {
 static void cons_stack_load(RzConsStack *data, bool free_current) {
 	rz_return_if_fail(data);
 	if (free_current) {
+		RZ_MEM_UNTRACK(CTX(buffer));
 		free(CTX(buffer));
 	}
 	CTX(buffer) = data->buf;
@@ -166,12 +171,9 @@ static inline void __cons_write_ll(const char *buf, int len) {
 #endif
 }
 
-static inline void __cons_write(const char *obuf, int olen) {
+static inline void __cons_write_nodamage(const char *obuf, int olen) {
 	const size_t bucket = 64 * 1024;
 	size_t i;
-	if (olen < 0) {
-		olen = strlen(obuf);
-	}
 	for (i = 0; (i + bucket) < olen; i += bucket) {
 		__cons_write_ll(obuf + i, bucket);
 	}
@@ -180,6 +182,16 @@ static inline void __cons_write(const char *obuf, int olen) {
 	}
 }
 
+static inline void __cons_write(const char *obuf, int olen) {
+	if (olen < 0) {
+		olen = strlen(obuf);
+	}
+	if (I.damage && I.screen) {
+		screen_track_write(I.screen, obuf, olen);
+	}
+	__cons_write_nodamage(obuf, olen);
+}
+
 RZ_API RzColor rz_cons_color_random(ut8 alpha) {
 	RzColor rcolor = { 0 };
 	if (CTX(color_mode) > COLOR_MODE_16) {
@@ -647,6 +659,7 @@ RZ_API RzCons *rz_cons_new(void) {
 	I.pager = NULL; /* no pager by default */
 	I.mouse = 0;
 	I.show_vals = false;
+	I.screen = screen_new();
 	rz_cons_reset();
 	rz_cons_rgb_init();
 
@@ -672,12 +685,17 @@ RZ_API RzCons *rz_cons_free(void) {
 	}
 	RZ_FREE(I.input->readbuffer);
 	RZ_FREE(I.input);
+	RZ_MEM_UNTRACK(CTX(buffer));
 	RZ_FREE(CTX(buffer));
 	RZ_FREE(I.break_word);
 	cons_context_deinit(I.context);
 	RZ_FREE(CTX(lastOutput));
 	CTX(lastLength) = 0;
 	RZ_FREE(I.pager);
+	screen_free(I.screen);
+	I.screen = NULL;
+	rz_th_task_pool_free(I.grep_pool);
+	I.grep_pool = NULL;
 	return NULL;
 }
 
@@ -698,6 +716,7 @@ static bool palloc(int moar) {
 			CTX(buffer_sz) = new_sz;
 			CTX(buffer) = temp;
 			(CTX(buffer))[0] = '\0';
+			RZ_MEM_TRACK(RZ_MEM_ACCOUNT_CONS, temp, new_sz);
 		}
 	} else if (moar + CTX(buffer_len) > CTX(buffer_sz)) {
 		char *new_buffer;
@@ -706,11 +725,14 @@ static bool palloc(int moar) {
 			return false;
 		}
 		CTX(buffer_sz) += moar + MOAR;
+		RZ_MEM_UNTRACK(CTX(buffer));
 		new_buffer = realloc(CTX(buffer), CTX(buffer_sz));
 		if (new_buffer) {
 			CTX(buffer) = new_buffer;
+			RZ_MEM_TRACK(RZ_MEM_ACCOUNT_CONS, new_buffer, CTX(buffer_sz));
 		} else {
 			CTX(buffer_sz) = old_buffer_sz;
+			RZ_MEM_TRACK(RZ_MEM_ACCOUNT_CONS, CTX(buffer), old_buffer_sz);
 			return false;
 		}
 	}
@@ -844,6 +866,7 @@ RZ_API void rz_cons_filter(void) {
 		int newlen = 0;
 		char *input = rz_str_ndup(CTX(buffer), CTX(buffer_len));
 		char *res = rz_cons_html_filter(input, &newlen);
+		RZ_MEM_UNTRACK(CTX(buffer));
 		free(CTX(buffer));
 		CTX(buffer) = res;
 		CTX(buffer_len) = newlen;
@@ -1064,6 +1087,64 @@ RZ_API void rz_cons_flush(void) {
 	}
 }
 
+static bool stream_allowed(void) {
+	if (!I.stream_chunk || CTX(noflush) || I.null || I.filter || I.is_html || (I.teefile && *I.teefile)) {
+		return false;
+	}
+	// captured output (e.g. rz_core_cmd_str()) needs all of it
+	if (!rz_stack_is_empty(CTX(cons_stack))) {
+		return false;
+	}
+	// so does grep, unless it only filters lines
+	if ((CTX(grep).str || CTX(grep).nstrings > 0 || CTX(grep).tokens_used || CTX(grep).less || CTX(grep).json) &&
+		!grep_can_stream(&CTX(grep))) {
+		return false;
+	}
+	// so does the pager
+	return !(rz_cons_is_interactive() && I.fdout == 1 && I.pager && *I.pager);
+}
+
+/* only the complete lines are grepped and written, the rest stays for the next chunk */
+static void flush_stream_grep(void) {
+	RzStrBuf out;
+	rz_strbuf_init(&out);
+	size_t done = grep_stream(&I, &out);
+	if (rz_strbuf_length(&out)) {
+		__cons_write(rz_strbuf_get(&out), rz_strbuf_length(&out));
+	}
+	rz_strbuf_fini(&out);
+	memmove(CTX(buffer), CTX(buffer) + done, CTX(buffer_len) - done);
+	CTX(buffer_len) -= done;
+	(CTX(buffer))[CTX(buffer_len)] = '\0';
+}
+
+/**
+ * \brief Write out the buffer early if it grew above scr.stream bytes
+ *
+ * Without this, nothing is written before the command ends and
+ * rz_cons_flush() is called, so big outputs are kept in memory entirely.
+ * This must only be called where the output produced so far is not looked
+ * at anymore, for example at the beginning of a new line in a print loop.
+ * Greps only filtering lines (e.g. pd~call) are applied to each chunk.
+ * Nothing happens if the output is captured, filtered, paged or grepped
+ * in any other way.
+ */
+RZ_API void rz_cons_flush_stream(void) {
+	if (CTX(buffer_len) < I.stream_chunk || !stream_allowed()) {
+		return;
+	}
+	if (CTX(grep).nstrings > 0) {
+		flush_stream_grep();
+	} else {
+		__cons_write(CTX(buffer), CTX(buffer_len));
+		// the buffer is reused for the next chunk, so it stays bounded
+		(CTX(buffer))[0] = '\0';
+		CTX(buffer_len) = 0;
+	}
+	I.lastline = CTX(buffer);
+	ctx_rowcol_calc_reset();
+}
+
 RZ_API void rz_cons_visual_flush(void) {
 	if (CTX(noflush)) {
 		return;
@@ -1094,6 +1175,23 @@ static int real_strlen(const char *ptr, int len) {
 	return ansilen - diff;
 }
 
+/* write to the terminal, or to the row being built when diffing the frame */
+static void visual_out(RzConsScreen *frame, const char *buf, int len) {
+	if (!frame) {
+		__cons_write(buf, len);
+		return;
+	}
+	if (len < 0) {
+		len = strlen(buf);
+	}
+	// rows are delimited with screen_frame_row(), not newlines
+	if (len > 0 && *buf == '\n') {
+		buf++;
+		len--;
+	}
+	screen_frame_add(frame, buf, len);
+}
+
 RZ_API void rz_cons_visual_write(char *buffer) {
 	char white[1024];
 	int cols = I.columns;
@@ -1101,10 +1199,19 @@ RZ_API void rz_cons_visual_write(char *buffer) {
 	bool break_lines = I.break_lines;
 	const char *endptr;
 	char *nl, *ptr = buffer, *pptr;
+	RzConsScreen *frame = NULL;
 
 	if (I.null) {
 		return;
 	}
+	if (I.damage && I.screen && !break_lines) {
+		size_t skip;
+		if (screen_frame_begin(I.screen, buffer, I.rows, cols, &skip)) {
+			frame = I.screen;
+			buffer += skip;
+			ptr = buffer;
+		}
+	}
 	memset(&white, ' ', sizeof(white));
 	while ((nl = strchr(ptr, '\n'))) {
 		int len = ((int)(size_t)(nl - ptr)) + 1;
@@ -1116,6 +1223,9 @@ RZ_API void rz_cons_visual_write(char *buffer) {
 		pptr = ptr > buffer ? ptr - 1 : ptr;
 		plen = ptr > buffer ? len : len - 1;
 
+		if (frame && lines > 0) {
+			screen_frame_row(frame);
+		}
 		if (break_lines) {
 			lines_needed = alen / cols + (alen % cols == 0 ? 0 : 1);
 		}
@@ -1126,21 +1236,24 @@ RZ_API void rz_cons_visual_write(char *buffer) {
 			len = endptr - ptr;
 			plen = ptr > buffer ? len : len - 1;
 			if (lines > 0) {
-				__cons_write(pptr, plen);
+				visual_out(frame, pptr, plen);
 				if (len != olen) {
-					__cons_write(RZ_CONS_CLEAR_FROM_CURSOR_TO_END, -1);
-					__cons_write(Color_RESET, strlen(Color_RESET));
+					// the rows below are part of the frame too, only clear this one
+					visual_out(frame, frame ? RZ_CONS_CLEAR_TO_EOL : RZ_CONS_CLEAR_FROM_CURSOR_TO_END, -1);
+					visual_out(frame, Color_RESET, strlen(Color_RESET));
 				}
 			}
 		} else {
 			if (lines > 0) {
 				int w = cols - (alen % cols == 0 ? cols : alen % cols);
-				__cons_write(pptr, plen);
+				visual_out(frame, pptr, plen);
 				if (I.blankline && w > 0) {
 					if (w > sizeof(white) - 1) {
 						w = sizeof(white) - 1;
 					}
-					__cons_write(white, w);
+					visual_out(frame, white, w);
+				} else if (frame && w > 0) {
+					visual_out(frame, RZ_CONS_CLEAR_TO_EOL, -1);
 				}
 			}
 			// TRICK to empty columns.. maybe buggy in w32
@@ -1162,9 +1275,19 @@ RZ_API void rz_cons_visual_write(char *buffer) {
 			cols = sizeof(white);
 		}
 		while (--lines >= 0) {
-			__cons_write(white, cols);
+			if (frame) {
+				screen_frame_row(frame);
+			}
+			visual_out(frame, white, cols);
 		}
 	}
+	if (frame) {
+		RzStrBuf out;
+		rz_strbuf_init(&out);
+		screen_frame_end(frame, &out);
+		__cons_write_nodamage(rz_strbuf_get(&out), rz_strbuf_length(&out));
+		rz_strbuf_fini(&out);
+	}
 }
 
 RZ_API void rz_cons_printf_list(const char *format, va_list ap) {
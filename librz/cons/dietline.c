@@ -1345,6 +1345,8 @@ RZ_API const char *rz_line_readline_cb(RzLineReadCallback cb, void *user) {
 	bool enable_yank_pop = false;
 
 	RzCons *cons = rz_cons_singleton();
+	// the prompt is written straight to the terminal
+	rz_cons_screen_invalidate();
 
 	if (!I.hud || (I.hud && !I.hud->activate)) {
 		I.buffer.index = I.buffer.length = 0;
@@ -5,6 +5,7 @@
 #include <rz_cons.h>
 #include <rz_util/rz_print.h>
 #include <sdb.h>
+#include "grep_private.h"
 
 #define I(x) rz_cons_singleton()->x
 
@@ -460,6 +461,342 @@ static int cmp(const void *a, const void *b) {
 	return strcmp(a, b);
 }
 
+/* the words are lowercased once for case insensitive greps, the callers lowercase the lines */
+static void grep_words_case(RzConsGrep *grep) {
+	if (!grep->icase) {
+		return;
+	}
+	for (int i = 0; i < grep->nstrings; i++) {
+		rz_str_case(grep->strings[i], false);
+	}
+}
+
+static bool grep_words_match(const RzConsGrep *grep, const char *in) {
+	if (grep->nstrings <= 0) {
+		return true;
+	}
+	bool hit = grep->neg;
+	int ampfail = grep->amp;
+	for (int i = 0; i < grep->nstrings; i++) {
+		const char *p = rz_strstr_ansi(in, grep->strings[i]);
+		if (!p) {
+			ampfail = 0;
+			continue;
+		}
+		if (grep->begin) {
+			hit = (p == in);
+			if (grep->neg) {
+				hit = !hit;
+			}
+		} else {
+			hit = !grep->neg;
+		}
+		// TODO: optimize without strlen without breaking t/feat_grep (grep end)
+		if (grep->end && (strlen(grep->strings[i]) != strlen(p))) {
+			hit = 0;
+		}
+		if (!grep->amp) {
+			break;
+		}
+	}
+	if (grep->amp) {
+		hit = ampfail;
+	}
+	return hit;
+}
+
+static char *grep_highlight(const RzConsGrep *grep, char *str) {
+	for (int i = 0; i < grep->nstrings; i++) {
+		char *newstr = rz_str_newf(Color_INVERT "%s" Color_RESET, grep->strings[i]);
+		if (str && newstr) {
+			if (grep->icase) {
+				str = rz_str_replace_icase(str, grep->strings[i], newstr, 1, 1);
+			} else {
+				str = rz_str_replace(str, grep->strings[i], newstr, 1);
+			}
+		}
+		free(newstr);
+	}
+	return str;
+}
+
+/*
+ * Whether the grep only keeps or drops each line by itself, without columns,
+ * line numbers, sorting or anything else needing the other lines.
+ * Such greps can be applied to any part of the output, in any order.
+ */
+static bool grep_filters_lines_only(const RzConsGrep *grep) {
+	return grep->nstrings > 0 && grep->range_line == 2 && !grep->tokens_used && grep->sort == -1 &&
+		!grep->less && !grep->json && !grep->hud && !grep->zoom;
+}
+
+/* appends the matching complete lines of buf to ob, returns their number or -1 */
+static int grep_lines_filter(const RzCons *cons, const RzConsGrep *grep, const char *buf, size_t len, RzStrBuf *ob) {
+	const char *end = buf + len;
+	char *line = NULL, *lower = NULL;
+	size_t size = 0;
+	int lines = 0;
+	const char *nl;
+	for (const char *in = buf; in < end && (nl = memchr(in, '\n', end - in)); in = nl + 1) {
+		int l = nl - in;
+		if (!l) {
+			continue;
+		}
+		if (l + 1 > size) {
+			size = l + 1;
+			free(line);
+			free(lower);
+			line = malloc(size);
+			lower = grep->icase ? malloc(size) : NULL;
+			if (!line || (grep->icase && !lower)) {
+				lines = -1;
+				break;
+			}
+		}
+		memcpy(line, in, l);
+		line[l] = '\0';
+		int tl = l;
+		if (!cons->grep_color && memchr(line, 0x1b, l)) {
+			tl = rz_str_ansi_filter(line, NULL, NULL, l);
+			if (tl < 0) {
+				lines = -1;
+				break;
+			}
+		}
+		if (!tl) {
+			continue;
+		}
+		const char *match = line;
+		if (grep->icase) {
+			memcpy(lower, line, tl + 1);
+			rz_str_case(lower, false);
+			match = lower;
+		}
+		if (!grep_words_match(grep, match)) {
+			continue;
+		}
+		if (cons->grep_highlight) {
+			char *str = grep_highlight(grep, rz_str_ndup(line, tl));
+			if (str) {
+				rz_strbuf_append(ob, str);
+				rz_strbuf_append(ob, "\n");
+			}
+			free(str);
+		} else {
+			line[tl] = '\n';
+			rz_strbuf_append_n(ob, line, tl + 1);
+		}
+		lines++;
+	}
+	free(line);
+	free(lower);
+	return lines;
+}
+
+#define GREP_PARALLEL_MIN  (4 << 20)
+#define GREP_PARALLEL_PART (1 << 20)
+
+typedef struct {
+	const char *buf;
+	size_t len;
+	RzStrBuf ob;
+	int lines; ///< as returned by grep_lines_filter()
+	bool done;
+} GrepPart;
+
+typedef struct {
+	const RzCons *cons;
+	const RzConsGrep *grep;
+	GrepPart *parts;
+} GrepParallelCtx;
+
+static void grep_part(const GrepParallelCtx *ctx, GrepPart *part) {
+	part->lines = grep_lines_filter(ctx->cons, ctx->grep, part->buf, part->len, &part->ob);
+	part->done = true;
+}
+
+static void grep_parts_range(size_t from, size_t to, void *user) {
+	GrepParallelCtx *ctx = user;
+	for (size_t i = from; i < to; i++) {
+		grep_part(ctx, &ctx->parts[i]);
+	}
+}
+
+/* grep_lines_filter() on parts of about GREP_PARALLEL_PART bytes ending with a newline, kept in order */
+static int grep_lines_filter_parallel(RzCons *cons, const RzConsGrep *grep, const char *buf, size_t len, RzStrBuf *ob) {
+	size_t count = len / GREP_PARALLEL_PART + 1;
+	GrepPart *parts = RZ_NEWS0(GrepPart, count);
+	if (!parts) {
+		return grep_lines_filter(cons, grep, buf, len, ob);
+	}
+	size_t n = 0;
+	for (const char *in = buf, *end = buf + len; in < end; n++) {
+		const char *nl = len - (in - buf) > GREP_PARALLEL_PART ? memchr(in + GREP_PARALLEL_PART, '\n', end - in - GREP_PARALLEL_PART) : NULL;
+		const char *next = nl ? nl + 1 : end;
+		parts[n].buf = in;
+		parts[n].len = next - in;
+		rz_strbuf_init(&parts[n].ob);
+		in = next;
+	}
+	if (!cons->grep_pool) {
+		cons->grep_pool = rz_th_task_pool_new(RZ_THREAD_POOL_ALL_CORES);
+	}
+	GrepParallelCtx ctx = { cons, grep, parts };
+	if (cons->grep_pool) {
+		// on failure some parts may be left, they are grepped below
+		rz_th_task_pool_parallel_for(cons->grep_pool, 0, n, 1, grep_parts_range, &ctx);
+	}
+	int lines = 0;
+	for (size_t i = 0; i < n; i++) {
+		GrepPart *part = &parts[i];
+		if (!part->done) {
+			grep_part(&ctx, part);
+		}
+		if (part->lines < 0 || lines < 0) {
+			lines = -1;
+		} else {
+			rz_strbuf_append_n(ob, rz_strbuf_get(&part->ob), rz_strbuf_length(&part->ob));
+			lines += part->lines;
+		}
+		rz_strbuf_fini(&part->ob);
+	}
+	free(parts);
+	return lines;
+}
+
+/*
+ * Applies a grep for which grep_filters_lines_only() is true to the complete
+ * lines of buf, appending the kept ones to ob.
+ * Returns the number of lines kept, or -1 on failure.
+ */
+static int grep_lines(RzCons *cons, RzConsGrep *grep, const char *buf, size_t len, RzStrBuf *ob) {
+	grep_words_case(grep);
+	if (len >= GREP_PARALLEL_MIN) {
+		return grep_lines_filter_parallel(cons, grep, buf, len, ob);
+	}
+	return grep_lines_filter(cons, grep, buf, len, ob);
+}
+
+/**
+ * \brief Whether the grep of \p grep can be applied while the output is streamed
+ */
+RZ_IPI bool grep_can_stream(RZ_NONNULL const RzConsGrep *grep) {
+	return grep_filters_lines_only(grep) && !grep->counter;
+}
+
+/**
+ * \brief Greps the complete lines at the beginning of the buffer, see rz_cons_flush_stream()
+ *
+ * Must only be called when grep_can_stream() is true.
+ *
+ * \param out receives the lines kept by the grep
+ * \return the number of bytes of the buffer grepped, which can be dropped from it
+ */
+RZ_IPI size_t grep_stream(RZ_NONNULL RzCons *cons, RZ_NONNULL RzStrBuf *out) {
+	const char *buf = cons->context->buffer;
+	size_t len = cons->context->buffer_len;
+	while (len && buf[len - 1] != '\n') {
+		len--;
+	}
+	if (!len || grep_lines(cons, &cons->context->grep, buf, len, out) < 0) {
+		return 0;
+	}
+	return len;
+}
+
+/* any grep but the line filters of grep_lines(), rz_cons_grep_line() is called on every line */
+static bool grep_lines_all(RzCons *cons, RzConsGrep *grep, const char *buf, int len, RzStrBuf *ob) {
+	const char *in = buf;
+	int ret, total_lines = 0, l = 0, tl = 0;
+	bool show = false;
+	// used to count lines and change negative grep.line values
+	while ((int)(size_t)(in - buf) < len) {
+		char *p = strchr(in, '\n');
+		if (!p) {
+			break;
+		}
+		l = p - in;
+		if (l > 0) {
+			in += l + 1;
+		} else {
+			in++;
+		}
+		total_lines++;
+	}
+	if (!grep->range_line && grep->line < 0) {
+		grep->line = total_lines + grep->line;
+	}
+	if (grep->range_line == 1) {
+		if (grep->f_line < 0) {
+			grep->f_line = total_lines + grep->f_line;
+		}
+		if (grep->l_line <= 0) {
+			grep->l_line = total_lines + grep->l_line;
+		}
+	}
+	bool is_range_line_grep_only = grep->range_line != 2 && !*grep->str;
+	in = buf;
+	while ((int)(size_t)(in - buf) < len) {
+		char *p = strchr(in, '\n');
+		if (!p) {
+			break;
+		}
+		l = p - in;
+		if ((!l && is_range_line_grep_only) || l > 0) {
+			char *tline = rz_str_ndup(in, l);
+			if (cons->grep_color) {
+				tl = l;
+			} else {
+				tl = rz_str_ansi_filter(tline, NULL, NULL, l);
+			}
+			if (tl < 0) {
+				ret = -1;
+			} else {
+				ret = rz_cons_grep_line(tline, tl);
+				if (!grep->range_line) {
+					if (grep->line == cons->lines) {
+						show = true;
+					}
+				} else if (grep->range_line == 1) {
+					if (grep->f_line == cons->lines) {
+						show = true;
+					}
+					if (grep->l_line == cons->lines) {
+						show = false;
+					}
+				} else {
+					show = true;
+				}
+			}
+			if ((!ret && is_range_line_grep_only) || ret > 0) {
+				if (show) {
+					char *str = rz_str_ndup(tline, ret);
+					if (cons->grep_highlight) {
+						str = grep_highlight(grep, str);
+					}
+					if (str) {
+						rz_strbuf_append(ob, str);
+						rz_strbuf_append(ob, "\n");
+					}
+					free(str);
+				}
+				if (!grep->range_line) {
+					show = false;
+				}
+				cons->lines++;
+			} else if (ret < 0) {
+				free(tline);
+				return false;
+			}
+			free(tline);
+			in += l + 1;
+		} else {
+			in++;
+		}
+	}
+	return true;
+}
+
 RZ_API void rz_cons_grepbuf(void) {
 	RzCons *cons = rz_cons_singleton();
 	cons->context->row = 0;
@@ -468,11 +805,9 @@ RZ_API void rz_cons_grepbuf(void) {
 	const char *buf = cons->context->buffer;
 	const int len = cons->context->buffer_len;
 	RzConsGrep *grep = &cons->context->grep;
-	const char *in = buf;
-	int ret, total_lines = 0, l = 0, tl = 0;
-	bool show = false;
 	if (cons->filter) {
 		cons->context->buffer_len = 0;
+		RZ_MEM_UNTRACK(cons->context->buffer);
 		RZ_FREE(cons->context->buffer);
 		return;
 	}
@@ -489,6 +824,7 @@ RZ_API void rz_cons_grepbuf(void) {
 		strcpy(in, cons->context->buffer);
 		char *out = rz_str_scale(in, grep->zoom * 2, grep->zoomy ? grep->zoomy : grep->zoom);
 		if (out) {
+			RZ_MEM_UNTRACK(cons->context->buffer);
 			free(cons->context->buffer);
 			cons->context->buffer = out;
 			cons->context->buffer_len = strlen(out);
@@ -548,6 +884,7 @@ RZ_API void rz_cons_grepbuf(void) {
 			if (!out) {
 				return;
 			}
+			RZ_MEM_UNTRACK(cons->context->buffer);
 			free(cons->context->buffer);
 			cons->context->buffer = out;
 			cons->context->buffer_len = strlen(out);
@@ -579,6 +916,7 @@ RZ_API void rz_cons_grepbuf(void) {
 			if (cons->context->buffer) {
 				cons->context->buffer[0] = 0;
 			}
+			RZ_MEM_UNTRACK(cons->context->buffer);
 			RZ_FREE(cons->context->buffer);
 		}
 		return;
@@ -591,101 +929,16 @@ RZ_API void rz_cons_grepbuf(void) {
 	RzStrBuf *ob = rz_strbuf_new("");
 	// if we modify cons->lines we should update I.context->buffer too
 	cons->lines = 0;
-	// used to count lines and change negative grep.line values
-	while ((int)(size_t)(in - buf) < len) {
-		char *p = strchr(in, '\n');
-		if (!p) {
-			break;
-		}
-		l = p - in;
-		if (l > 0) {
-			in += l + 1;
-		} else {
-			in++;
-		}
-		total_lines++;
-	}
-	if (!grep->range_line && grep->line < 0) {
-		grep->line = total_lines + grep->line;
-	}
-	if (grep->range_line == 1) {
-		if (grep->f_line < 0) {
-			grep->f_line = total_lines + grep->f_line;
-		}
-		if (grep->l_line <= 0) {
-			grep->l_line = total_lines + grep->l_line;
-		}
-	}
-	bool is_range_line_grep_only = grep->range_line != 2 && !*grep->str;
-	in = buf;
-	while ((int)(size_t)(in - buf) < len) {
-		char *p = strchr(in, '\n');
-		if (!p) {
-			break;
-		}
-		l = p - in;
-		if ((!l && is_range_line_grep_only) || l > 0) {
-			char *tline = rz_str_ndup(in, l);
-			if (cons->grep_color) {
-				tl = l;
-			} else {
-				tl = rz_str_ansi_filter(tline, NULL, NULL, l);
-			}
-			if (tl < 0) {
-				ret = -1;
-			} else {
-				ret = rz_cons_grep_line(tline, tl);
-				if (!grep->range_line) {
-					if (grep->line == cons->lines) {
-						show = true;
-					}
-				} else if (grep->range_line == 1) {
-					if (grep->f_line == cons->lines) {
-						show = true;
-					}
-					if (grep->l_line == cons->lines) {
-						show = false;
-					}
-				} else {
-					show = true;
-				}
-			}
-			if ((!ret && is_range_line_grep_only) || ret > 0) {
-				if (show) {
-					char *str = rz_str_ndup(tline, ret);
-					if (cons->grep_highlight) {
-						int i;
-						for (i = 0; i < grep->nstrings; i++) {
-							char *newstr = rz_str_newf(Color_INVERT "%s" Color_RESET, grep->strings[i]);
-							if (str && newstr) {
-								if (grep->icase) {
-									str = rz_str_replace_icase(str, grep->strings[i], newstr, 1, 1);
-								} else {
-									str = rz_str_replace(str, grep->strings[i], newstr, 1);
-								}
-							}
-							free(newstr);
-						}
-					}
-					if (str) {
-						rz_strbuf_append(ob, str);
-						rz_strbuf_append(ob, "\n");
-					}
-					free(str);
-				}
-				if (!grep->range_line) {
-					show = false;
-				}
-				cons->lines++;
-			} else if (ret < 0) {
-				free(tline);
-				return;
-			}
-			free(tline);
-			in += l + 1;
-		} else {
-			in++;
+	if (grep_filters_lines_only(grep)) {
+		int lines = grep_lines(cons, grep, buf, len, ob);
+		if (lines < 0) {
+			rz_strbuf_free(ob);
+			return;
 		}
+		cons->lines = lines;
+	} else if (!grep_lines_all(cons, grep, buf, len, ob)) {
+		rz_strbuf_free(ob);
+		return;
 	}
 
 	cons->context->buffer_len = rz_strbuf_length(ob);
@@ -748,7 +1001,6 @@ RZ_API int rz_cons_grep_line(char *buf, int len) {
 	RzConsGrep *grep = &cons->context->grep;
 	const char *delims = " |,;=\t";
 	char *tok = NULL;
-	bool hit = grep->neg;
 	int outlen = 0;
 	bool use_tok = false;
 	size_t i;
@@ -764,43 +1016,11 @@ RZ_API int rz_cons_grep_line(char *buf, int len) {
 	}
 	memcpy(in, buf, len);
 
-	if (grep->nstrings > 0) {
-		int ampfail = grep->amp;
-		if (grep->icase) {
-			rz_str_case(in, false);
-		}
-		for (i = 0; i < grep->nstrings; i++) {
-			char *str = grep->strings[i];
-			if (grep->icase) {
-				rz_str_case(str, false);
-			}
-			const char *p = rz_strstr_ansi(in, grep->strings[i]);
-			if (!p) {
-				ampfail = 0;
-				continue;
-			}
-			if (grep->begin) {
-				hit = (p == in);
-				if (grep->neg) {
-					hit = !hit;
-				}
-			} else {
-				hit = !grep->neg;
-			}
-			// TODO: optimize without strlen without breaking t/feat_grep (grep end)
-			if (grep->end && (strlen(grep->strings[i]) != strlen(p))) {
-				hit = 0;
-			}
-			if (!grep->amp) {
-				break;
-			}
-		}
-		if (grep->amp) {
-			hit = ampfail;
-		}
-	} else {
-		hit = 1;
+	grep_words_case(grep);
+	if (grep->icase) {
+		rz_str_case(in, false);
 	}
+	bool hit = grep_words_match(grep, in);
 
 	if (hit) {
 		if (!grep->range_line) {
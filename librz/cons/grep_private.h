@@ -0,0 +1,10 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#ifndef GREP_PRIVATE_H
+#define GREP_PRIVATE_H
+
+RZ_IPI bool grep_can_stream(RZ_NONNULL const RzConsGrep *grep);
+RZ_IPI size_t grep_stream(RZ_NONNULL RzCons *cons, RZ_NONNULL RzStrBuf *out);
+
+#endif
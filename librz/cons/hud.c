@@ -109,8 +109,128 @@ static bool __matchString(char *entry, char *filter, char *mask, const int mask_
 	return true;
 }
 
-static RzList *hud_filter(RzList *list, char *user_input, int top_entry_n, int *current_entry_n, char **selected_entry) {
+// lists shorter than this are scanned on every keystroke, it's faster than indexing them
+#define HUD_INDEX_MIN_ENTRIES 4096
+
+/**
+ * Trigram index of the entries of a hud, to only check the entries
+ * containing every trigram of a word of the filter instead of all of them.
+ */
+typedef struct {
+	RzPVector /*<char *>*/ entries; ///< borrowed from the list shown, in the same order
+	HtUP /*<ut64, RzVector<ut32> *>*/ *grams; ///< trigram => ascending indices of the entries containing it, NULL if not indexed
+	RzPVector /*<char *>*/ candidates; ///< result of the last hud_candidates()
+} HudIndex;
+
+static inline ut64 hud_gram(const char *s) {
+	return (ut64)tolower((ut8)s[0]) | (ut64)tolower((ut8)s[1]) << 8 | (ut64)tolower((ut8)s[2]) << 16;
+}
+
+static void hud_gram_free_kv(HtUPKv *kv) {
+	rz_vector_free(kv->value);
+}
+
+static bool hud_index_entry(HudIndex *idx, const char *entry, ut32 n) {
+	char *text = strdup(entry);
+	if (!text) {
+		return false;
+	}
+	// matching is done on the entry without colors, see __matchString()
+	rz_str_ansi_filter(text, NULL, NULL, -1);
+	size_t len = strlen(text);
+	for (size_t i = 0; i + 3 <= len; i++) {
+		ut64 gram = hud_gram(text + i);
+		RzVector *posting = ht_up_find(idx->grams, gram, NULL);
+		if (!posting) {
+			posting = rz_vector_new(sizeof(ut32), NULL, NULL);
+			if (!posting || !ht_up_insert(idx->grams, gram, posting)) {
+				rz_vector_free(posting);
+				free(text);
+				return false;
+			}
+		}
+		// the same trigram may appear twice in an entry
+		if (rz_vector_empty(posting) || *(ut32 *)rz_vector_tail(posting) != n) {
+			rz_vector_push(posting, &n);
+		}
+	}
+	free(text);
+	return true;
+}
+
+static void hud_index_init(HudIndex *idx, RzList *list) {
+	rz_pvector_init(&idx->entries, NULL);
+	rz_pvector_init(&idx->candidates, NULL);
+	idx->grams = NULL;
+	rz_pvector_reserve(&idx->entries, rz_list_length(list));
 	RzListIter *iter;
+	char *entry;
+	rz_list_foreach (list, iter, entry) {
+		rz_pvector_push(&idx->entries, entry);
+	}
+	if (rz_pvector_len(&idx->entries) < HUD_INDEX_MIN_ENTRIES || rz_pvector_len(&idx->entries) > UT32_MAX) {
+		return;
+	}
+	idx->grams = ht_up_new(NULL, hud_gram_free_kv, NULL);
+	if (!idx->grams) {
+		return;
+	}
+	for (ut32 i = 0; i < rz_pvector_len(&idx->entries); i++) {
+		if (!hud_index_entry(idx, rz_pvector_at(&idx->entries, i), i)) {
+			ht_up_free(idx->grams);
+			idx->grams = NULL;
+			return;
+		}
+	}
+}
+
+static void hud_index_fini(HudIndex *idx) {
+	ht_up_free(idx->grams);
+	rz_pvector_fini(&idx->entries);
+	rz_pvector_fini(&idx->candidates);
+}
+
+/**
+ * Get the entries that may match \p filter, in the order of the list.
+ * Every word of the filter must be in a matching entry, so all its trigrams
+ * too: the entries having the rarest of them are enough to check.
+ */
+static RzPVector *hud_candidates(HudIndex *idx, const char *filter) {
+	if (!idx->grams) {
+		return &idx->entries;
+	}
+	RzVector *rarest = NULL;
+	const char *word = filter;
+	while (*word) {
+		size_t len = strcspn(word, " ");
+		for (size_t i = 0; i + 3 <= len; i++) {
+			RzVector *posting = ht_up_find(idx->grams, hud_gram(word + i), NULL);
+			if (!posting) {
+				rz_pvector_clear(&idx->candidates);
+				return &idx->candidates;
+			}
+			if (!rarest || rz_vector_len(posting) < rz_vector_len(rarest)) {
+				rarest = posting;
+			}
+		}
+		word += len;
+		word += strspn(word, " ");
+	}
+	if (!rarest) {
+		// only words too short for trigrams
+		return &idx->entries;
+	}
+	rz_pvector_clear(&idx->candidates);
+	rz_pvector_reserve(&idx->candidates, rz_vector_len(rarest));
+	ut32 *n;
+	rz_vector_foreach(rarest, n) {
+		rz_pvector_push(&idx->candidates, rz_pvector_at(&idx->entries, *n));
+	}
+	return &idx->candidates;
+}
+
+static RzList *hud_filter(RzPVector *entries, char *user_input, int top_entry_n, int *current_entry_n, char **selected_entry) {
+	void **iter;
 	char *current_entry;
 	char mask[HUD_BUF_SIZE];
 	char *p, *x;
@@ -119,7 +239,8 @@ static RzList *hud_filter(RzList *list, char *user_input, int top_entry_n, int *
 	int counter = 0;
 	bool first_line = true;
 	RzList *res = rz_list_newf(free);
-	rz_list_foreach (list, iter, current_entry) {
+	rz_pvector_foreach (entries, iter) {
+		current_entry = *iter;
 		memset(mask, 0, HUD_BUF_SIZE);
 		if (*user_input && !__matchString(current_entry, user_input, mask, HUD_BUF_SIZE)) {
 			continue;
@@ -205,6 +326,8 @@ RZ_API char *rz_cons_hud(RzList *list, const char *prompt) {
 	RzListIter *iter;
 
 	HtPP *ht = ht_pp_new(NULL, (HtPPKvFreeFunc)mht_free_kv, (HtPPCalcSizeV)strlen);
+	HudIndex idx;
+	hud_index_init(&idx, list);
 	RzLineHud *hud = (RzLineHud *)RZ_NEW(RzLineHud);
 	hud->activate = 0;
 	hud->vi = 0;
@@ -236,7 +359,7 @@ RZ_API char *rz_cons_hud(RzList *list, const char *prompt) {
 		bool found = false;
 		filtered_list = ht_pp_find(ht, user_input, &found);
 		if (!found) {
-			filtered_list = hud_filter(list, user_input,
+			filtered_list = hud_filter(hud_candidates(&idx, user_input), user_input,
 				hud->top_entry_n, &(hud->current_entry_n), &selected_entry);
 #if HUD_CACHE
 			ht_pp_insert(ht, user_input, filtered_list);
@@ -264,7 +387,10 @@ RZ_API char *rz_cons_hud(RzList *list, const char *prompt) {
 					rz_cons_enable_mouse(false);
 					rz_cons_show_cursor(true);
 					rz_cons_set_raw(false);
-					return strdup(selected_entry);
+					char *res = strdup(selected_entry);
+					hud_index_fini(&idx);
+					ht_pp_free(ht);
+					return res;
 				}
 			} else {
 				goto _beach;
@@ -277,6 +403,7 @@ _beach:
 	rz_cons_show_cursor(true);
 	rz_cons_enable_mouse(false);
 	rz_cons_set_raw(false);
+	hud_index_fini(&idx);
 	ht_pp_free(ht);
 	return NULL;
 }
@@ -31,6 +31,7 @@ RZ_API int rz_cons_less_str(const char *str, const char *exitkeys) {
 	const char *sreg;
 	RzList **mla;
 
+	rz_cons_screen_invalidate();
 	// rcons kills str after flushing the buffer, so we must keep a copy
 	char *ostr = strdup(str);
 	if (!ostr) {
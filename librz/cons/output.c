@@ -30,6 +30,7 @@ RZ_API void rz_cons_w32_clear(void) {
 		rz_cons_strcat(Color_RESET RZ_CONS_CLEAR_SCREEN);
 		return;
 	}
+	rz_cons_screen_invalidate();
 	if (I->is_wine == 1) {
 		rz_xwrite(1, "\033[0;0H\033[0m\033[2J", 6 + 4 + 4);
 	}
@@ -0,0 +1,295 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/**
+ * \file screen.c
+ * Damage tracking for full screen frames (scr.damage).
+ *
+ * The rows of the last frame written by rz_cons_visual_write() are kept
+ * together with the colors active at their beginning. The next frame only
+ * emits the rows that differ, starting from the first differing column,
+ * with absolute cursor moves in between.
+ *
+ * This only works as long as nothing else touched the terminal, so every
+ * other write goes through screen_track_write() and forgets the frame unless
+ * it just moved the cursor home or changed colors.
+ */
+
+#include <rz_cons.h>
+#include <rz_util.h>
+#include "screen_private.h"
+
+#define SGR_STATE_MAX 256
+
+typedef struct {
+	char *bytes;
+	size_t len;
+	char *sgr; ///< color sequences active at the beginning of the row
+} ScreenRow;
+
+struct rz_cons_screen_t {
+	RzVector /*<ScreenRow>*/ rows; ///< rows on the terminal, valid only if valid is set
+	RzVector /*<ScreenRow>*/ next; ///< rows of the frame being built
+	RzStrBuf cur; ///< row being built
+	RzStrBuf sgr; ///< color sequences active at the end of the last finished row
+	bool building;
+	bool valid;
+	bool at_origin; ///< the cursor was moved home and nothing was written after
+	int nrows;
+	int ncols;
+};
+
+static void screen_row_fini(void *e, void *user) {
+	ScreenRow *r = e;
+	free(r->bytes);
+	free(r->sgr);
+}
+
+/* length of the CSI escape sequence at p, 0 if it is something else or truncated */
+static size_t csi_len(const char *p, size_t n) {
+	size_t i = 2;
+	if (n < 3 || p[0] != 0x1b || p[1] != '[') {
+		return 0;
+	}
+	while (i < n && p[i] >= 0x20 && p[i] <= 0x3f) {
+		i++;
+	}
+	return i < n && p[i] >= 0x40 && p[i] <= 0x7e ? i + 1 : 0;
+}
+
+static bool csi_is_sgr(const char *p, size_t l) {
+	return p[l - 1] == 'm';
+}
+
+static bool csi_is_home(const char *p, size_t l) {
+	size_t i;
+	if (p[l - 1] != 'H') {
+		return false;
+	}
+	for (i = 2; i < l - 1; i++) {
+		if (p[i] != '0' && p[i] != '1' && p[i] != ';') {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* keep track of the colors set by a SGR sequence, a reset forgets all previous ones */
+static void sgr_feed(RzStrBuf *state, const char *p, size_t l) {
+	if ((l == 3) || (l == 4 && p[2] == '0')) {
+		rz_strbuf_set(state, "");
+		return;
+	}
+	if (rz_strbuf_length(state) + l > SGR_STATE_MAX) {
+		// too many attributes stacked, keep the newest one
+		rz_strbuf_set(state, "");
+	}
+	rz_strbuf_append_n(state, p, l);
+}
+
+RZ_IPI RzConsScreen *screen_new(void) {
+	RzConsScreen *s = RZ_NEW0(RzConsScreen);
+	if (!s) {
+		return NULL;
+	}
+	rz_vector_init(&s->rows, sizeof(ScreenRow), screen_row_fini, NULL);
+	rz_vector_init(&s->next, sizeof(ScreenRow), screen_row_fini, NULL);
+	rz_strbuf_init(&s->cur);
+	rz_strbuf_init(&s->sgr);
+	return s;
+}
+
+RZ_IPI void screen_free(RZ_NULLABLE RzConsScreen *s) {
+	if (!s) {
+		return;
+	}
+	rz_vector_fini(&s->rows);
+	rz_vector_fini(&s->next);
+	rz_strbuf_fini(&s->cur);
+	rz_strbuf_fini(&s->sgr);
+	free(s);
+}
+
+/**
+ * \brief Forget the last frame, the next one is written entirely
+ */
+RZ_IPI void screen_invalidate(RZ_NONNULL RzConsScreen *s) {
+	rz_vector_clear(&s->rows);
+	s->valid = false;
+	s->at_origin = false;
+}
+
+/**
+ * \brief Account for \p buf being written to the terminal outside of a frame
+ */
+RZ_IPI void screen_track_write(RZ_NONNULL RzConsScreen *s, const char *buf, size_t len) {
+	size_t i = 0, l;
+	bool home = false;
+	if (!len) {
+		return;
+	}
+	while (i < len) {
+		l = csi_len(buf + i, len - i);
+		if (!l || !(csi_is_sgr(buf + i, l) || csi_is_home(buf + i, l))) {
+			// anything else may have drawn over the frame
+			screen_invalidate(s);
+			return;
+		}
+		home |= csi_is_home(buf + i, l);
+		i += l;
+	}
+	s->at_origin |= home;
+}
+
+/**
+ * \brief Start building a frame of \p rows x \p cols out of \p frame
+ *
+ * \param skip set to the number of bytes of \p frame to skip before the first row
+ * \return false if the frame cannot be diffed and must be written as is
+ */
+RZ_IPI bool screen_frame_begin(RZ_NONNULL RzConsScreen *s, const char *frame, int rows, int cols, RZ_OUT size_t *skip) {
+	size_t i = 0, l, len = strlen(frame);
+	bool origin = s->at_origin;
+	*skip = 0;
+	l = csi_len(frame, len);
+	if (l && csi_is_home(frame, l)) {
+		origin = true;
+		*skip = i = l;
+	}
+	if (!origin) {
+		screen_invalidate(s);
+		return false;
+	}
+	// only colors can be handled, any cursor movement or erase breaks the rows
+	while ((i += strcspn(frame + i, "\x1b")) < len) {
+		l = csi_len(frame + i, len - i);
+		if (!l || !csi_is_sgr(frame + i, l)) {
+			screen_invalidate(s);
+			return false;
+		}
+		i += l;
+	}
+	if (rows != s->nrows || cols != s->ncols) {
+		screen_invalidate(s);
+		s->nrows = rows;
+		s->ncols = cols;
+	}
+	rz_vector_clear(&s->next);
+	rz_strbuf_set(&s->cur, "");
+	rz_strbuf_set(&s->sgr, "");
+	s->building = false;
+	return true;
+}
+
+static void screen_frame_finish_row(RzConsScreen *s) {
+	if (!s->building) {
+		return;
+	}
+	ScreenRow *r = rz_vector_push(&s->next, NULL);
+	if (!r) {
+		return;
+	}
+	r->sgr = strdup(rz_strbuf_get(&s->sgr));
+	r->len = rz_strbuf_length(&s->cur);
+	r->bytes = rz_strbuf_drain_nofree(&s->cur);
+	size_t i = 0, l;
+	while ((i += strcspn(r->bytes + i, "\x1b")) < r->len) {
+		l = csi_len(r->bytes + i, r->len - i);
+		if (!l) {
+			break;
+		}
+		sgr_feed(&s->sgr, r->bytes + i, l);
+		i += l;
+	}
+	s->building = false;
+}
+
+/**
+ * \brief Start the next row of the frame
+ */
+RZ_IPI void screen_frame_row(RZ_NONNULL RzConsScreen *s) {
+	screen_frame_finish_row(s);
+	s->building = true;
+}
+
+/**
+ * \brief Append \p buf to the current row of the frame
+ */
+RZ_IPI void screen_frame_add(RZ_NONNULL RzConsScreen *s, const char *buf, size_t len) {
+	rz_strbuf_append_n(&s->cur, buf, len);
+}
+
+/* skip the beginning that \p row shares with \p old, returns the offset in
+ * row->bytes to restart from and sets the column there and the colors */
+static size_t row_common_prefix(const ScreenRow *row, const ScreenRow *old, int *col, RzStrBuf *sgr) {
+	size_t i = 0, start = 0, l;
+	int c = 0;
+	*col = 0;
+	while (i < row->len && i < old->len) {
+		if (row->bytes[i] == 0x1b) {
+			l = csi_len(row->bytes + i, row->len - i);
+			if (!l || i + l > old->len || memcmp(row->bytes + i, old->bytes + i, l)) {
+				break;
+			}
+			sgr_feed(sgr, row->bytes + i, l);
+			i += l;
+			start = i;
+			continue;
+		}
+		ut8 ch = row->bytes[i];
+		// only plain ascii is known to take exactly one column
+		if (ch != (ut8)old->bytes[i] || ch < 0x20 || ch >= 0x7f) {
+			break;
+		}
+		i++;
+		c++;
+		start = i;
+		*col = c;
+	}
+	return start;
+}
+
+/**
+ * \brief Finish the frame and put in \p out what has to be written for it
+ */
+RZ_IPI void screen_frame_end(RZ_NONNULL RzConsScreen *s, RZ_NONNULL RzStrBuf *out) {
+	screen_frame_finish_row(s);
+	size_t i, n = rz_vector_len(&s->next);
+	RzStrBuf sgr;
+	rz_strbuf_init(&sgr);
+	for (i = 0; i < n; i++) {
+		const ScreenRow *row = rz_vector_index_ptr(&s->next, i);
+		const ScreenRow *old = s->valid && i < rz_vector_len(&s->rows) ? rz_vector_index_ptr(&s->rows, i) : NULL;
+		if (old && (!old->sgr || !row->sgr || strcmp(old->sgr, row->sgr))) {
+			old = NULL;
+		}
+		if (old && old->len == row->len && !memcmp(old->bytes, row->bytes, row->len)) {
+			continue;
+		}
+		int col = 0;
+		rz_strbuf_set(&sgr, row->sgr ? row->sgr : "");
+		size_t start = old ? row_common_prefix(row, old, &col, &sgr) : 0;
+		rz_strbuf_appendf(out, "\x1b[%d;%dH" Color_RESET, (int)i + 1, col + 1);
+		rz_strbuf_append(out, rz_strbuf_get(&sgr));
+		rz_strbuf_append_n(out, row->bytes + start, row->len - start);
+	}
+	rz_strbuf_fini(&sgr);
+	RzVector tmp = s->rows;
+	s->rows = s->next;
+	s->next = tmp;
+	rz_vector_clear(&s->next);
+	s->valid = true;
+	s->at_origin = false;
+}
+
+/**
+ * \brief Forget what is on the screen, the next visual frame is written entirely
+ *
+ * Use it after writing to the terminal without going through RzCons.
+ */
+RZ_API void rz_cons_screen_invalidate(void) {
+	RzCons *cons = rz_cons_singleton();
+	if (cons->screen) {
+		screen_invalidate(cons->screen);
+	}
+}
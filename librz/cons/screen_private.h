@@ -0,0 +1,16 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#ifndef SCREEN_PRIVATE_H
+#define SCREEN_PRIVATE_H
+
+RZ_IPI RzConsScreen *screen_new(void);
+RZ_IPI void screen_free(RZ_NULLABLE RzConsScreen *s);
+RZ_IPI void screen_invalidate(RZ_NONNULL RzConsScreen *s);
+RZ_IPI void screen_track_write(RZ_NONNULL RzConsScreen *s, const char *buf, size_t len);
+RZ_IPI bool screen_frame_begin(RZ_NONNULL RzConsScreen *s, const char *frame, int rows, int cols, RZ_OUT size_t *skip);
+RZ_IPI void screen_frame_row(RZ_NONNULL RzConsScreen *s);
+RZ_IPI void screen_frame_add(RZ_NONNULL RzConsScreen *s, const char *buf, size_t len);
+RZ_IPI void screen_frame_end(RZ_NONNULL RzConsScreen *s, RZ_NONNULL RzStrBuf *out);
+
+#endif
@@ -50,6 +50,12 @@ static const char *mousemodes[] = {
 #define BODY_SUMMARY  0x2
 #define BODY_COMMENTS 0x4
 
+/* graphs with more nodes (dummies included) get a barycenter ordering
+ * before the crossing matrix sweeps */
+#define LAYOUT_BARYCENTER_MIN_NODES 256
+#define LAYOUT_BARYCENTER_PASSES    4
+#define LAYOUT_ORDERS_MAX           64
+
 #define NORMALIZE_MOV(x) ((x) < 0 ? -1 : ((x) > 0 ? 1 : 0))
 
 /* don't use macros for this */
@@ -646,9 +652,9 @@ static void remove_cycles(RzAGraph *g) {
 	}
 }
 
-static void add_sorted(RzGraphNode *n, RzGraphVisitor *vis) {
-	RzList *l = (RzList *)vis->data;
-	rz_list_prepend(l, n);
+static void add_sorted(ut32 n, RzGraphCSRVisitor *vis) {
+	RzVector *l = (RzVector *)vis->data;
+	rz_vector_push(l, &n);
 }
 
 /* assign a layer to each node of the graph.
@@ -658,33 +664,40 @@ static void add_sorted(RzGraphNode *n, RzGraphVisitor *vis) {
  * that can lead to that node and thus you can easily compute the layer based
  * on the layer of these "parent" nodes. */
 static void assign_layers(const RzAGraph *g) {
-	RzGraphVisitor layer_vis = {
-		NULL, NULL, NULL, NULL, NULL, NULL
-	};
-	const RzGraphNode *gn;
-	const RzListIter *it;
-	RzANode *n;
-	RzList *topological_sort = rz_list_new();
+	RzGraphCSRVisitor layer_vis = { 0 };
+	RzVector finished;
+	ut32 *gi;
 
-	layer_vis.data = topological_sort;
-	layer_vis.finish_node = (RzGraphNodeCallback)add_sorted;
-	rz_graph_dfs(g->graph, &layer_vis);
+	// the callgraph can be huge, so walk it by index
+	RzGraphCSR *csr = rz_graph_csr_new_from_graph(g->graph);
+	if (!csr) {
+		return;
+	}
+	rz_vector_init(&finished, sizeof(ut32), NULL, NULL);
+	rz_vector_reserve(&finished, csr->n_nodes);
+	layer_vis.data = &finished;
+	layer_vis.finish_node = add_sorted;
+	rz_graph_csr_dfs(csr, &layer_vis);
 
-	graph_foreach_anode (topological_sort, it, gn, n) {
-		const RzList *innodes = rz_graph_innodes(g->graph, gn);
-		RzListIter *it;
-		RzGraphNode *prev;
-		RzANode *preva;
+	rz_vector_foreach_prev(&finished, gi) {
+		RzANode *n = csr->data[*gi];
+		if (!n) {
+			continue;
+		}
+		const ut32 *innodes = rz_graph_csr_in_nodes(csr, *gi);
+		ut32 i, n_in = rz_graph_csr_in_degree(csr, *gi);
 
 		n->layer = 0;
-		graph_foreach_anode (innodes, it, prev, preva) {
-			if (preva->layer + 1 > n->layer) {
+		for (i = 0; i < n_in; i++) {
+			RzANode *preva = csr->data[innodes[i]];
+			if (preva && preva->layer + 1 > n->layer) {
 				n->layer = preva->layer + 1;
 			}
 		}
 	}
 
-	rz_list_free(topological_sort);
+	rz_vector_fini(&finished);
+	rz_graph_csr_free(csr);
 }
 
 static int find_edge(const RzGraphEdge *a, const RzGraphEdge *b) {
@@ -780,11 +793,92 @@ static void create_layers(RzAGraph *g) {
 	}
 }
 
+typedef struct {
+	RzGraphNode *gn;
+	int pos;
+	double key;
+} BaryItem;
+
+static int bary_item_cmp(const void *a, const void *b) {
+	const BaryItem *x = a, *y = b;
+	if (x->key != y->key) {
+		return x->key < y->key ? -1 : 1;
+	}
+	return x->pos - y->pos;
+}
+
+/* sort layer i by the mean position of the neighbours of each node in the
+ * previous (from_up) or next layer. Nodes without such neighbours keep their
+ * position as key. */
+static bool layer_barycenter(const RzGraph *g, const struct layer_t layers[], int i, int from_up, BaryItem *items) {
+	int j, len = layers[i].n_nodes;
+	for (j = 0; j < len; j++) {
+		RzGraphNode *gn = layers[i].nodes[j];
+		const RzList *neigh = from_up ? rz_graph_innodes(g, gn) : rz_graph_get_neighbours(g, gn);
+		const RzListIter *it;
+		RzGraphNode *gk;
+		int sum = 0, cnt = 0;
+		rz_list_foreach (neigh, it, gk) {
+			const RzANode *ak = get_anode(gk);
+			if (gk == gn || !ak) {
+				continue;
+			}
+			sum += ak->pos_in_layer;
+			cnt++;
+		}
+		items[j].gn = gn;
+		items[j].pos = j;
+		items[j].key = cnt ? (double)sum / cnt : j;
+	}
+	qsort(items, len, sizeof(BaryItem), bary_item_cmp);
+	bool changed = false;
+	for (j = 0; j < len; j++) {
+		changed |= items[j].pos != j;
+		layers[i].nodes[j] = items[j].gn;
+		get_anode(items[j].gn)->pos_in_layer = j;
+	}
+	return changed;
+}
+
+/* barycenter heuristic: linear in the number of edges per sweep, gives a good
+ * starting point to the crossing matrix sweeps on big graphs */
+static void barycenter_sweeps(const RzAGraph *g) {
+	int i, pass, maxlen = 0;
+	for (i = 0; i < g->n_layers; i++) {
+		maxlen = RZ_MAX(maxlen, g->layers[i].n_nodes);
+	}
+	BaryItem *items = RZ_NEWS(BaryItem, maxlen + 1);
+	if (!items) {
+		return;
+	}
+	for (pass = 0; pass < LAYOUT_BARYCENTER_PASSES; pass++) {
+		bool changed = false;
+		for (i = 1; i < g->n_layers; i++) {
+			changed |= layer_barycenter(g->graph, g->layers, i, true, items);
+		}
+		for (i = g->n_layers - 2; i >= 0; i--) {
+			changed |= layer_barycenter(g->graph, g->layers, i, false, items);
+		}
+		if (!changed || rz_cons_is_breaked()) {
+			break;
+		}
+	}
+	free(items);
+}
+
 /* layer-by-layer sweep */
 /* it permutes each layer, trying to find the best ordering for each layer
  * to minimize the number of crossing edges */
 static void minimize_crossings(const RzAGraph *g) {
 	int i, cross_changed, max_changes = 4096;
+	ut64 deadline = UT64_MAX;
+
+	if (g->layout_budget > 0) {
+		deadline = rz_time_now_mono() + (ut64)g->layout_budget * RZ_USEC_PER_MSEC;
+	}
+	if (g->graph->n_nodes >= LAYOUT_BARYCENTER_MIN_NODES) {
+		barycenter_sweeps(g);
+	}
 
 	do {
 		cross_changed = false;
@@ -792,7 +886,7 @@ static void minimize_crossings(const RzAGraph *g) {
 
 		for (i = 0; i < g->n_layers; i++) {
 			int rc = layer_sweep(g->graph, g->layers, g->n_layers, i, true);
-			if (rc == -1) {
+			if (rc == -1 || rz_time_now_mono() > deadline) {
 				return;
 			}
 			cross_changed |= !!rc;
@@ -807,7 +901,7 @@ static void minimize_crossings(const RzAGraph *g) {
 
 		for (i = g->n_layers - 1; i >= 0; i--) {
 			int rc = layer_sweep(g->graph, g->layers, g->n_layers, i, false);
-			if (rc == -1) {
+			if (rc == -1 || rz_time_now_mono() > deadline) {
 				return;
 			}
 			cross_changed |= !!rc;
@@ -815,6 +909,134 @@ static void minimize_crossings(const RzAGraph *g) {
 	} while (cross_changed && max_changes);
 }
 
+/* ordering of the layers found by minimize_crossings, node indexes layer after layer */
+typedef struct {
+	int n_nodes;
+	int *idx;
+} AGraphLayoutOrder;
+
+static void layout_order_free(HtUPKv *kv) {
+	AGraphLayoutOrder *o = kv->value;
+	if (o) {
+		free(o->idx);
+		free(o);
+	}
+}
+
+static ut64 fnv1a_int(ut64 h, int v) {
+	ut32 u = (ut32)v;
+	int i;
+	for (i = 0; i < 4; i++) {
+		h ^= (u >> (i * 8)) & 0xff;
+		h *= 0x100000001b3ULL;
+	}
+	return h;
+}
+
+/* hash of everything minimize_crossings looks at: nodes, their layers and the
+ * edges once dummies are in place. Node sizes and bodies are not part of it,
+ * so a graph reloaded after a comment or a rename hits the same order. */
+static ut64 layout_shape_hash(const RzAGraph *g) {
+	const RzList *nodes = rz_graph_get_nodes(g->graph);
+	const RzListIter *it, *itk;
+	RzGraphNode *gn, *gk;
+	RzANode *n;
+	ut64 h = 0xcbf29ce484222325ULL;
+	h = fnv1a_int(h, g->n_layers);
+	h = fnv1a_int(h, g->graph->n_nodes);
+	graph_foreach_anode (nodes, it, gn, n) {
+		h = fnv1a_int(h, gn->idx);
+		h = fnv1a_int(h, n->layer);
+		h = fnv1a_int(h, n->is_dummy);
+		rz_list_foreach (rz_graph_get_neighbours(g->graph, gn), itk, gk) {
+			h = fnv1a_int(h, gk->idx);
+		}
+		h = fnv1a_int(h, -1);
+	}
+	return h;
+}
+
+static void layout_order_save(RzAGraph *g, ut64 shape) {
+	int i, j, k = 0;
+	if (!g->layout_orders) {
+		g->layout_orders = ht_up_new(NULL, layout_order_free, NULL);
+		if (!g->layout_orders) {
+			return;
+		}
+	} else if (g->layout_orders->count >= LAYOUT_ORDERS_MAX) {
+		ht_up_free(g->layout_orders);
+		g->layout_orders = ht_up_new(NULL, layout_order_free, NULL);
+		if (!g->layout_orders) {
+			return;
+		}
+	}
+	AGraphLayoutOrder *o = RZ_NEW0(AGraphLayoutOrder);
+	if (!o) {
+		return;
+	}
+	o->n_nodes = g->graph->n_nodes;
+	o->idx = RZ_NEWS(int, o->n_nodes + 1);
+	if (!o->idx) {
+		free(o);
+		return;
+	}
+	for (i = 0; i < g->n_layers; i++) {
+		for (j = 0; j < g->layers[i].n_nodes && k < o->n_nodes; j++) {
+			o->idx[k++] = g->layers[i].nodes[j]->idx;
+		}
+	}
+	ht_up_update(g->layout_orders, shape, o);
+}
+
+/* put the layers back in the order saved for a graph with the same shape,
+ * returns false and leaves the layers untouched if there is none */
+static bool layout_order_restore(RzAGraph *g, ut64 shape) {
+	AGraphLayoutOrder *o = g->layout_orders ? ht_up_find(g->layout_orders, shape, NULL) : NULL;
+	if (!o || o->n_nodes != g->graph->n_nodes) {
+		return false;
+	}
+	const RzList *nodes = rz_graph_get_nodes(g->graph);
+	const RzListIter *it;
+	RzGraphNode *gn;
+	RzANode *n;
+	int i, j, k = 0, max_idx = 0;
+	graph_foreach_anode (nodes, it, gn, n) {
+		max_idx = RZ_MAX(max_idx, gn->idx);
+	}
+	RzGraphNode **by_idx = RZ_NEWS0(RzGraphNode *, max_idx + 1);
+	if (!by_idx) {
+		return false;
+	}
+	graph_foreach_anode (nodes, it, gn, n) {
+		by_idx[gn->idx] = gn;
+	}
+	// check everything before touching the layers, a hash collision must not break the graph
+	for (i = 0; i < g->n_layers; i++) {
+		for (j = 0; j < g->layers[i].n_nodes; j++, k++) {
+			int idx = k < o->n_nodes ? o->idx[k] : -1;
+			gn = idx >= 0 && idx <= max_idx ? by_idx[idx] : NULL;
+			if (!gn || get_anode(gn)->layer != i) {
+				free(by_idx);
+				return false;
+			}
+			by_idx[idx] = NULL;
+		}
+	}
+	graph_foreach_anode (nodes, it, gn, n) {
+		by_idx[gn->idx] = gn;
+	}
+	k = 0;
+	for (i = 0; i < g->n_layers; i++) {
+		for (j = 0; j < g->layers[i].n_nodes; j++, k++) {
+			gn = by_idx[o->idx[k]];
+			g->layers[i].nodes[j] = gn;
+			get_anode(gn)->pos_in_layer = j;
+		}
+	}
+	free(by_idx);
+	return true;
+}
+
 static int find_dist(const struct dist_t *a, const struct dist_t *b) {
 	return a->from == b->from && a->to == b->to ? 0 : 1;
 }
@@ -1965,7 +2187,15 @@ static void set_layout(RzAGraph *g) {
 	assign_layers(g);
 	create_dummy_nodes(g);
 	create_layers(g);
-	minimize_crossings(g);
+	if (g->layers) {
+		ut64 shape = layout_shape_hash(g);
+		if (!layout_order_restore(g, shape)) {
+			minimize_crossings(g);
+			if (!rz_cons_is_breaked()) {
+				layout_order_save(g, shape);
+			}
+		}
+	}
 
 	if (rz_cons_is_breaked()) {
 		rz_cons_break_end();
@@ -3912,6 +4142,7 @@ RZ_API void rz_agraph_free(RzAGraph *g) {
 		rz_list_free(g->dummy_nodes);
 		rz_graph_free(g->graph);
 		rz_list_free(g->edges);
+		ht_up_free(g->layout_orders);
 		rz_agraph_set_title(g, NULL);
 		sdb_free(g->db);
 		rz_cons_canvas_free(g->can);
@@ -4176,6 +4407,7 @@ RZ_API int rz_core_visual_graph(RzCore *core, RzAGraph *g, RzAnalysisFunction *_
 	}
 	g->can = can;
 	g->movspeed = rz_config_get_i(core->config, "graph.scroll");
+	g->layout_budget = rz_config_get_i(core->config, "graph.layout.budget");
 	g->show_node_titles = rz_config_get_i(core->config, "graph.ntitles");
 	g->show_node_body = rz_config_get_i(core->config, "graph.body");
 	g->on_curnode_change = (RzANodeCallback)seek_to_node;
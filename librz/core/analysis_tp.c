@@ -7,41 +7,100 @@
 #include <rz_util.h>
 #include <ht_uu.h>
 #include <rz_core.h>
+#include "core_private.h"
 #define LOOP_MAX 10
 
-static bool analysis_emul_init(RzCore *core, RzConfigHold *hc, RzDebugTrace **dt, RzAnalysisEsilTrace **et, RzAnalysisRzilTrace **rt) {
-	if (!core->analysis->esil) {
-		return false;
-	}
-	*dt = core->dbg->trace;
-	*et = core->analysis->esil->trace;
+/**
+ * Emulation setup shared by the type matching of any number of functions in a row
+ */
+struct rz_core_type_match_emul_t {
+	RzConfigHold *hc;
+	RzDebugTrace *dt; ///< trace of the debugger to restore afterwards
+	RzAnalysisEsilTrace *et; ///< trace of the esil to restore afterwards
+};
 
+/**
+ * Start over with empty traces for emulating a function of \p ninstr instructions
+ */
+static bool emul_traces_reset(RzCore *core, int ninstr) {
+	// dbg.trace was set for the previous one
+	bool enabled = core->dbg->trace ? core->dbg->trace->enabled : false;
+	rz_debug_trace_free(core->dbg->trace);
+	rz_analysis_esil_trace_free(core->analysis->esil->trace);
 	core->dbg->trace = rz_debug_trace_new();
 	core->analysis->esil->trace = rz_analysis_esil_trace_new(core->analysis->esil);
+	if (!core->dbg->trace || !core->analysis->esil->trace) {
+		return false;
+	}
+	// Reserve room to avoid rehashing
+	core->dbg->trace->enabled = enabled;
+	rz_debug_trace_reserve(core->dbg->trace, ninstr);
+	return true;
+}
 
-	rz_config_hold_i(hc, "esil.romem", "dbg.trace",
-		"esil.nonull", "dbg.follow", NULL);
-	rz_config_set(core->config, "esil.romem", "true");
-	rz_config_set(core->config, "dbg.trace", "true");
-	rz_config_set(core->config, "esil.nonull", "true");
-	rz_config_set_i(core->config, "dbg.follow", false);
+/**
+ * \brief Restore everything that was changed by rz_core_analysis_type_match_emul_begin()
+ */
+RZ_IPI void rz_core_analysis_type_match_emul_end(RzCore *core, RZ_NULLABLE RzCoreTypeMatchEmul *emul) {
+	if (!emul) {
+		return;
+	}
+	rz_config_hold_restore(emul->hc);
+	rz_config_hold_free(emul->hc);
+	rz_debug_trace_free(core->dbg->trace);
+	if (core->analysis->esil) {
+		rz_analysis_esil_trace_free(core->analysis->esil->trace);
+		core->analysis->esil->trace = emul->et;
+	}
+	core->dbg->trace = emul->dt;
+	free(emul);
+}
+
+/**
+ * \brief Prepare emulating functions for rz_core_analysis_type_match_emul()
+ *
+ * The emulation settings are applied once here instead of for every
+ * function, which adds up when all functions are matched, like in aaft.
+ *
+ * \return the setup to pass on and finally to rz_core_analysis_type_match_emul_end(),
+ * NULL if the esil is not set up or its stack is not initialized
+ */
+RZ_IPI RZ_OWN RzCoreTypeMatchEmul *rz_core_analysis_type_match_emul_begin(RzCore *core) {
+	if (!core->analysis->esil) {
+		return NULL;
+	}
 	const char *bp = rz_reg_get_name(core->analysis->reg, RZ_REG_NAME_BP);
 	const char *sp = rz_reg_get_name(core->analysis->reg, RZ_REG_NAME_SP);
 	if ((bp && !rz_reg_getv(core->analysis->reg, bp)) && (sp && !rz_reg_getv(core->analysis->reg, sp))) {
 		eprintf("Stack isn't initialized.\n");
 		eprintf("Try running aei and aeim commands before aft for default stack initialization\n");
-		return false;
+		return NULL;
+	}
+	RzCoreTypeMatchEmul *emul = RZ_NEW0(RzCoreTypeMatchEmul);
+	if (!emul) {
+		return NULL;
+	}
+	emul->hc = rz_config_hold_new(core->config);
+	if (!emul->hc) {
+		free(emul);
+		return NULL;
+	}
+	emul->dt = core->dbg->trace;
+	emul->et = core->analysis->esil->trace;
+	core->dbg->trace = NULL;
+	core->analysis->esil->trace = NULL;
+	if (!emul_traces_reset(core, 0)) {
+		rz_core_analysis_type_match_emul_end(core, emul);
+		return NULL;
 	}
-	return (core->dbg->trace && core->analysis->esil->trace);
-}
 
-static void analysis_emul_restore(RzCore *core, RzConfigHold *hc, RzDebugTrace *dt, RzAnalysisEsilTrace *et, RzAnalysisRzilTrace *rt) {
-	rz_config_hold_restore(hc);
-	rz_config_hold_free(hc);
-	rz_debug_trace_free(core->dbg->trace);
-	rz_analysis_esil_trace_free(core->analysis->esil->trace);
-	core->analysis->esil->trace = et;
-	core->dbg->trace = dt;
+	rz_config_hold_i(emul->hc, "esil.romem", "dbg.trace",
+		"esil.nonull", "dbg.follow", NULL);
+	rz_config_set(core->config, "esil.romem", "true");
+	rz_config_set(core->config, "dbg.trace", "true");
+	rz_config_set(core->config, "esil.nonull", "true");
+	rz_config_set_i(core->config, "dbg.follow", false);
+	return emul;
 }
 
 static bool type_pos_hit(RzAnalysis *analysis, RzILTraceInstruction *instr_trace, bool in_stack, int size, const char *place) {
@@ -527,11 +586,6 @@ static void type_match(RzCore *core, char *fcn_name, ut64 addr, ut64 baddr, cons
 	rz_cons_break_pop();
 }
 
-static int bb_cmpaddr(const void *_a, const void *_b) {
-	const RzAnalysisBlock *a = _a, *b = _b;
-	return a->addr > b->addr ? 1 : (a->addr < b->addr ? -1 : 0);
-}
-
 void free_op_cache_kv(HtUPKv *kv) {
 	rz_analysis_op_free(kv->value);
 }
@@ -813,40 +867,24 @@ void propagate_types_among_used_variables(RzCore *core, HtUP *op_cache, RzAnalys
 	}
 }
 
-RZ_API void rz_core_analysis_type_match(RzCore *core, RzAnalysisFunction *fcn, HtUU *loop_table) {
+/**
+ * \brief Match the types in \p fcn by emulating it with the setup \p emul
+ *
+ * This is rz_core_analysis_type_match() for matching many functions in a row.
+ */
+RZ_IPI void rz_core_analysis_type_match_emul(RzCore *core, RZ_NONNULL RzCoreTypeMatchEmul *emul, RzAnalysisFunction *fcn, HtUU *loop_table) {
 	RzListIter *it;
 
-	rz_return_if_fail(core && core->analysis && fcn);
-
-	if (!core->analysis->esil) {
-		eprintf("Please run aeim\n");
-		return;
-	}
+	rz_return_if_fail(core && core->analysis && emul && fcn);
 
 	RzAnalysis *analysis = core->analysis;
 	RzReg *reg = analysis->reg;
 	const int mininstrsz = rz_analysis_archinfo(analysis, RZ_ANALYSIS_ARCHINFO_MIN_OP_SIZE);
 	const int minopcode = RZ_MAX(1, mininstrsz);
-	RzConfigHold *hc = rz_config_hold_new(core->config);
-	if (!hc) {
-		return;
-	}
-	RzDebugTrace *dt = NULL;
-	RzAnalysisEsilTrace *et = NULL;
-	RzAnalysisRzilTrace *rt = NULL;
-	if (!analysis_emul_init(core, hc, &dt, &et, &rt) || !fcn) {
-		analysis_emul_restore(core, hc, dt, et, rt);
+	if (!analysis->esil || !emul_traces_reset(core, fcn->ninstr)) {
 		return;
 	}
 
-	// Reserve bigger ht to avoid rehashing
-	HtPPOptions opt;
-	RzDebugTrace *dtrace = core->dbg->trace;
-	opt = dtrace->ht->opt;
-	ht_pp_free(dtrace->ht);
-	dtrace->ht = ht_pp_new_size(fcn->ninstr, opt.dupvalue, opt.freefn, opt.calcsizeV);
-	dtrace->ht->opt = opt;
-
 	// Create a new context to store the return type propagation state
 	struct ReturnTypeAnalysisCtx retctx = {
 		.resolved = false,
@@ -957,5 +995,18 @@ out_function:
 	free(retctx.ret_reg);
 	ht_up_free(op_cache);
 	rz_cons_break_pop();
-	analysis_emul_restore(core, hc, dt, et, rt);
+}
+
+RZ_API void rz_core_analysis_type_match(RzCore *core, RzAnalysisFunction *fcn, HtUU *loop_table) {
+	rz_return_if_fail(core && core->analysis && fcn);
+	if (!core->analysis->esil) {
+		eprintf("Please run aeim\n");
+		return;
+	}
+	RzCoreTypeMatchEmul *emul = rz_core_analysis_type_match_emul_begin(core);
+	if (!emul) {
+		return;
+	}
+	rz_core_analysis_type_match_emul(core, emul, fcn, loop_table);
+	rz_core_analysis_type_match_emul_end(core, emul);
 }
@@ -11,29 +11,24 @@
 #include <rz_basefind.h>
 #include <rz_th.h>
 
+// number of candidate bases scored at once by each thread (the histogram uses 4 bytes per base)
+#define BASEFIND_WINDOW_BASES (1 << 20)
+
 typedef struct basefind_addresses_t {
 	ut64 *ptr;
 	ut32 size;
 } BaseFindArray;
 
-typedef struct basefind_data_t {
-	ut32 score;
-	ut64 start;
-	ut64 end;
-	BaseFindArray *array;
-} BaseFindData;
-
 typedef struct basefind_thread_data_t {
 	ut32 id;
 	ut64 current;
 	ut64 base_start;
 	ut64 base_end;
 	ut64 alignment;
-	ut64 io_size;
 	ut32 score_min;
 	RzThreadLock *lock;
 	RzList *scores;
-	HtUU *pointers;
+	BaseFindArray *pointers;
 	BaseFindArray *array;
 	RzAtomicBool *loop;
 } BaseFindThreadData;
@@ -96,14 +91,9 @@ static void basefind_array_free(BaseFindArray *array) {
 	free(array);
 }
 
-static bool basefind_array_has(const BaseFindArray *array, ut64 value) {
-	// half-interval search should be better here.
-	for (ut32 i = 0; i < array->size; ++i) {
-		if (array->ptr[i] == value) {
-			return true;
-		}
-	}
-	return false;
+static int basefind_address_compare(const void *a, const void *b) {
+	ut64 x = *(const ut64 *)a, y = *(const ut64 *)b;
+	return x < y ? -1 : (x > y ? 1 : 0);
 }
 
 static BaseFindArray *basefind_create_array_of_addresses(RzCore *core, ut32 min_string_len) {
@@ -118,7 +108,6 @@ static BaseFindArray *basefind_create_array_of_addresses(RzCore *core, ut32 min_
 		}
 	}
 
-	// if this list is sorted we can improve speed via half-interval search
 	strings = rz_bin_file_strings(current, min_string_len, true);
 	if (!strings || rz_list_empty(strings)) {
 		RZ_LOG_ERROR("basefind: cannot find strings in binary with a minimum size of %u.\n", min_string_len);
@@ -151,6 +140,16 @@ static BaseFindArray *basefind_create_array_of_addresses(RzCore *core, ut32 min_
 	}
 	RZ_LOG_INFO("basefind: located %u strings\n", array->size);
 
+	// the scoring walks the offsets in increasing order and counts each one once
+	qsort(array->ptr, array->size, sizeof(ut64), basefind_address_compare);
+	ut32 unique = 0;
+	for (i = 0; i < array->size; i++) {
+		if (!unique || array->ptr[unique - 1] != array->ptr[i]) {
+			array->ptr[unique++] = array->ptr[i];
+		}
+	}
+	array->size = unique;
+
 error:
 	rz_list_free(strings);
 	if (alloc) {
@@ -161,43 +160,52 @@ error:
 	return array;
 }
 
-static HtUU *basefind_create_pointer_map(RzCore *core, ut32 pointer_size) {
+/**
+ * Reads every word of the file as a pointer and returns them sorted, a
+ * pointer found N times appears N times so it counts N times in the score.
+ */
+static BaseFindArray *basefind_create_array_of_pointers(RzCore *core, ut32 pointer_size) {
 	rz_return_val_if_fail(pointer_size == sizeof(ut32) || pointer_size == sizeof(ut64), NULL);
 
-	HtUU *map = ht_uu_new0();
-	if (!map) {
-		RZ_LOG_ERROR("basefind: cannot allocate hashmap for pointer.\n");
+	ut64 io_size = rz_io_size(core->io);
+	ut64 n_pointers = (io_size + pointer_size - 1) / pointer_size;
+	if (n_pointers > UT32_MAX) {
+		RZ_LOG_ERROR("basefind: too many pointers to load.\n");
 		return NULL;
 	}
 
-	ut8 buffer[sizeof(ut64)];
-	ut64 io_size = rz_io_size(core->io);
-	ut64 address = 0;
-	bool big_endian = rz_config_get_b(core->config, "cfg.bigendian");
-
-	for (ut64 pos = 0; pos < io_size; pos += pointer_size) {
-		rz_io_pread_at(core->io, pos, buffer, pointer_size);
-		address = pointer_size == sizeof(ut64) ? rz_read_ble64(buffer, big_endian) : rz_read_ble32(buffer, big_endian);
-		ut64 value = ht_uu_find(map, address, NULL) + 1;
-		ht_uu_insert(map, address, value);
+	BaseFindArray *array = RZ_NEW0(BaseFindArray);
+	ut8 *buffer = malloc(0x10000);
+	if (!array || !buffer || !(array->ptr = RZ_NEWS(ut64, RZ_MAX(n_pointers, 1)))) {
+		RZ_LOG_ERROR("basefind: cannot allocate array of pointers.\n");
+		basefind_array_free(array);
+		free(buffer);
+		return NULL;
 	}
-	RZ_LOG_INFO("basefind: located %u pointers\n", map->count);
-
-	return map;
-}
+	array->size = n_pointers;
 
-static bool basefind_pointer_map_iter(BaseFindData *bfd, const ut64 address, const ut64 hits) {
-	if (rz_cons_is_breaked()) {
-		return false;
-	}
-	if (address < bfd->start || address >= bfd->end) {
-		return true;
+	bool big_endian = rz_config_get_b(core->config, "cfg.bigendian");
+	ut32 block = 0x10000 / pointer_size;
+	for (ut64 i = 0; i < array->size; i += block) {
+		ut32 count = RZ_MIN(block, array->size - i);
+		rz_io_pread_at(core->io, (ut64)i * pointer_size, buffer, count * pointer_size);
+		for (ut32 j = 0; j < count; j++) {
+			const ut8 *word = buffer + j * pointer_size;
+			array->ptr[i + j] = pointer_size == sizeof(ut64) ? rz_read_ble64(word, big_endian) : rz_read_ble32(word, big_endian);
+		}
 	}
-	ut64 offset = address - bfd->start;
-	if (basefind_array_has(bfd->array, offset)) {
-		bfd->score += hits;
+	free(buffer);
+
+	qsort(array->ptr, array->size, sizeof(ut64), basefind_address_compare);
+	ut32 unique = 0;
+	for (ut32 i = 0; i < array->size; i++) {
+		if (!i || array->ptr[i - 1] != array->ptr[i]) {
+			unique++;
+		}
 	}
-	return true;
+	RZ_LOG_INFO("basefind: located %u pointers\n", unique);
+
+	return array;
 }
 
 static int basefind_score_compare(const RzBaseFindScore *a, const RzBaseFindScore *b) {
@@ -214,48 +222,91 @@ static int basefind_score_compare(const RzBaseFindScore *a, const RzBaseFindScor
 	return 1;
 }
 
+static bool basefind_add_score(BaseFindThreadData *bftd, ut64 base, ut32 score) {
+	RzBaseFindScore *pair = RZ_NEW0(RzBaseFindScore);
+	if (!pair) {
+		RZ_LOG_ERROR("basefind: cannot allocate RzBaseFindScore.\n");
+		return false;
+	}
+	pair->score = score;
+	pair->candidate = base;
+
+	rz_th_lock_enter(bftd->lock);
+	if (!rz_list_append(bftd->scores, pair)) {
+		rz_th_lock_leave(bftd->lock);
+		free(pair);
+		RZ_LOG_ERROR("basefind: cannot append new score to the scores list.\n");
+		return false;
+	}
+	RZ_LOG_DEBUG("basefind: possible candidate at 0x%016" PFMT64x " with score of %u\n", base, score);
+	rz_th_lock_leave(bftd->lock);
+	return true;
+}
+
+/**
+ * Scores the bases of the thread a window at a time: a pointer P matches
+ * the string at offset S for the base P - S, so for each string offset the
+ * matching pointers of the window are a contiguous run of the sorted
+ * pointers and each one adds a hit to the histogram of its base.
+ */
 static void *basefind_thread_runner(BaseFindThreadData *bftd) {
 	RzAtomicBool *loop = bftd->loop;
-	RzBaseFindScore *pair = NULL;
-	BaseFindData bfd;
-	ut64 base;
-
-	bfd.array = bftd->array;
-	for (base = bftd->base_start; base < bftd->base_end; base += bftd->alignment) {
-		if (!rz_atomic_bool_get(loop)) {
-			break;
-		}
-		bftd->current = base;
-		bfd.score = 0;
-		bfd.start = base;
-		bfd.end = base + bftd->io_size;
-		ht_uu_foreach(bftd->pointers, (HtUUForeachCallback)basefind_pointer_map_iter, &bfd);
+	const ut64 *pointers = bftd->pointers->ptr;
+	const ut32 n_pointers = bftd->pointers->size;
+	const ut64 *strings = bftd->array->ptr;
+	const ut32 n_strings = bftd->array->size;
+	const ut64 alignment = bftd->alignment;
+	const ut64 n_bases = ((bftd->base_end - bftd->base_start - 1) / alignment) + 1;
+
+	ut32 *histogram = RZ_NEWS(ut32, RZ_MIN(n_bases, BASEFIND_WINDOW_BASES));
+	if (!histogram) {
+		RZ_LOG_ERROR("basefind: cannot allocate scores histogram.\n");
+		return NULL;
+	}
 
-		if (bfd.score < bftd->score_min) {
-			// ignore any score below than score_min
-			continue;
-		}
+	for (ut64 first = 0; first < n_bases; first += BASEFIND_WINDOW_BASES) {
+		ut64 count = RZ_MIN(n_bases - first, BASEFIND_WINDOW_BASES);
+		ut64 window_start = bftd->base_start + first * alignment;
+		ut64 window_last = window_start + (count - 1) * alignment;
+		memset(histogram, 0, count * sizeof(ut32));
 
-		pair = RZ_NEW0(RzBaseFindScore);
-		if (!pair) {
-			RZ_LOG_ERROR("basefind: cannot allocate RzBaseFindScore.\n");
-			break;
+		for (ut32 s = 0; s < n_strings; s++) {
+			if (!rz_atomic_bool_get(loop) || rz_cons_is_breaked()) {
+				goto end;
+			}
+			bftd->current = window_start + ((count * s) / n_strings) * alignment;
+			ut64 low = window_start + strings[s];
+			if (low < window_start) {
+				// the following offsets overflow too
+				break;
+			}
+			ut64 high = window_last + strings[s];
+			if (high < window_last) {
+				high = UT64_MAX;
+			}
+			size_t i;
+#define CMP(x, y) ((x) < (y) ? -1 : ((x) > (y) ? 1 : 0))
+			rz_array_lower_bound(pointers, n_pointers, low, i, CMP);
+#undef CMP
+			for (; i < n_pointers && pointers[i] <= high; i++) {
+				ut64 delta = pointers[i] - low;
+				if (!(delta % alignment)) {
+					histogram[delta / alignment]++;
+				}
+			}
 		}
-		pair->score = bfd.score;
-		pair->candidate = base;
-
-		rz_th_lock_enter(bftd->lock);
-		if (!rz_list_append(bftd->scores, pair)) {
-			rz_th_lock_leave(bftd->lock);
-			free(pair);
-			RZ_LOG_ERROR("basefind: cannot append new score to the scores list.\n");
-			break;
+
+		for (ut64 i = 0; i < count; i++) {
+			// ignore any score below than score_min
+			if (histogram[i] >= bftd->score_min && !basefind_add_score(bftd, window_start + i * alignment, histogram[i])) {
+				goto end;
+			}
 		}
-		RZ_LOG_DEBUG("basefind: possible candidate at 0x%016" PFMT64x " with score of %u\n", base, bfd.score);
-		rz_th_lock_leave(bftd->lock);
 	}
-	bftd->current = base;
+	bftd->current = bftd->base_end;
 
+end:
+	free(histogram);
 	return NULL;
 }
 
@@ -337,7 +388,7 @@ RZ_API RZ_OWN RzList *rz_basefind(RZ_NONNULL RzCore *core, RZ_NONNULL RzBaseFind
 	rz_return_val_if_fail(core && options, NULL);
 	RzList *scores = NULL;
 	BaseFindArray *array = NULL;
-	HtUU *pointers = NULL;
+	BaseFindArray *pointers = NULL;
 	size_t pool_size = 1;
 	RzThreadPool *pool = NULL;
 	RzThreadLock *lock = NULL;
@@ -379,7 +430,13 @@ RZ_API RZ_OWN RzList *rz_basefind(RZ_NONNULL RzCore *core, RZ_NONNULL RzBaseFind
 		goto rz_basefind_end;
 	}
 
-	pointers = basefind_create_pointer_map(core, options->pointer_size / 8);
+	ut64 io_size = rz_io_size(core->io);
+	// a string at an offset beyond the end of the file can't match any base
+	while (array->size > 0 && array->ptr[array->size - 1] >= io_size) {
+		array->size--;
+	}
+
+	pointers = basefind_create_array_of_pointers(core, options->pointer_size / 8);
 	if (!pointers) {
 		goto rz_basefind_end;
 	}
@@ -405,9 +462,10 @@ RZ_API RZ_OWN RzList *rz_basefind(RZ_NONNULL RzCore *core, RZ_NONNULL RzBaseFind
 
 	RZ_LOG_VERBOSE("basefind: using %u threads\n", (ut32)pool_size);
 
-	ut64 io_size = rz_io_size(core->io);
-	ut64 sector_size = (((base_end - base_start) + pool_size - 1) / pool_size);
-	for (size_t i = 0; i < pool_size; ++i) {
+	// every thread gets the same number of bases, all aligned from base_start
+	ut64 n_bases = ((base_end - base_start - 1) / alignment) + 1;
+	ut64 sector_bases = (n_bases + pool_size - 1) / pool_size;
+	for (size_t i = 0; i < pool_size && i * sector_bases < n_bases; ++i) {
 		BaseFindThreadData *bftd = RZ_NEW(BaseFindThreadData);
 		if (!bftd) {
 			RZ_LOG_ERROR("basefind: cannot allocate BaseFindThreadData.\n");
@@ -415,11 +473,14 @@ RZ_API RZ_OWN RzList *rz_basefind(RZ_NONNULL RzCore *core, RZ_NONNULL RzBaseFind
 			goto rz_basefind_end;
 		}
 		bftd->alignment = alignment;
-		bftd->base_start = base_start + (sector_size * i);
+		bftd->base_start = base_start + (sector_bases * i) * alignment;
 		bftd->current = bftd->base_start;
-		bftd->base_end = bftd->base_start + sector_size;
+		bftd->base_end = RZ_MIN(bftd->base_start + sector_bases * alignment, base_end);
+		if (bftd->base_end <= bftd->base_start) {
+			// the sector size overflows
+			bftd->base_end = base_end;
+		}
 		bftd->score_min = options->min_score;
-		bftd->io_size = io_size;
 		bftd->lock = lock;
 		bftd->scores = scores;
 		bftd->pointers = pointers;
@@ -483,6 +544,6 @@ rz_basefind_end:
 	}
 	rz_th_lock_free(lock);
 	basefind_array_free(array);
-	ht_uu_free(pointers);
+	basefind_array_free(pointers);
 	return scores;
 }
@@ -65,6 +65,7 @@ RZ_IPI void rz_core_agraph_del_edge(RzCore *core, const char *un, const char *vn
 RZ_IPI void rz_core_agraph_print_ascii(RzCore *core) {
 	core->graph->can->linemode = rz_config_get_i(core->config, "graph.linemode");
 	core->graph->can->color = rz_config_get_i(core->config, "scr.color");
+	core->graph->layout_budget = rz_config_get_i(core->config, "graph.layout.budget");
 	rz_agraph_set_title(core->graph, rz_config_get(core->config, "graph.title"));
 	rz_agraph_print(core->graph);
 }
@@ -3,8 +3,12 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <string.h>
+#include <time.h>
 
 #include <rz_types.h>
+#if __UNIX__
+#include <sys/resource.h>
+#endif
 #include <rz_list.h>
 #include <rz_flag.h>
 #include <rz_core.h>
@@ -44,7 +48,7 @@ RZ_IPI int fcn_cmpaddr(const void *_a, const void *_b) {
 
 static char *getFunctionName(RzCore *core, ut64 addr) {
 	RzBinFile *bf = rz_bin_cur(core->bin);
-	if (bf && bf->o) {
+	if (bf && bf->o && rz_bin_object_get_classes(bf->o)) {
 		RzBinSymbol *sym = ht_up_find(bf->o->addrzklassmethod, addr, NULL);
 		if (sym && sym->classname && sym->name) {
 			return rz_str_newf("method.%s.%s", sym->classname, sym->name);
@@ -500,27 +504,78 @@ RZ_IPI void rz_core_analysis_bb_info_print(RzCore *core, RzAnalysisBlock *bb, ut
 	bb_info_print(core, fcn, bb, addr, state->mode, state->d.pj, state->d.t);
 }
 
-/*this only autoname those function that start with fcn.* or sym.func.* */
+static bool autoname_candidate(RzAnalysisFunction *fcn) {
+	return !strncmp(fcn->name, "fcn.", 4) || !strncmp(fcn->name, "sym.func.", 9);
+}
+
+typedef struct {
+	RzAnalysisFunction **fcns;
+	RzVector /*<RzAnalysisXRef>*/ **xrefs;
+} AutonameCtx;
+
+static void autoname_xrefs_range(size_t from, size_t to, void *user) {
+	AutonameCtx *ctx = user;
+	for (size_t i = from; i < to; i++) {
+		if (!ctx->xrefs[i]) {
+			ctx->xrefs[i] = rz_analysis_function_get_xrefs_from_vec(ctx->fcns[i]);
+		}
+	}
+}
+
+static char *function_autoname_xrefs(RzCore *core, RzAnalysisFunction *fcn, RzVector /*<RzAnalysisXRef>*/ *xrefs);
+
+/**
+ * \brief Autoname the functions whose name starts with fcn.* or sym.func.*
+ *
+ * Collecting the xrefs of the functions, which walks every instruction, is
+ * done in the task pool. The names are then computed and applied one
+ * function after the other since they look up the flags being renamed.
+ */
 RZ_API void rz_core_analysis_autoname_all_fcns(RzCore *core) {
 	RzListIter *it;
 	RzAnalysisFunction *fcn;
 
+	RzPVector fcns;
+	rz_pvector_init(&fcns, NULL);
 	rz_list_foreach (core->analysis->fcns, it, fcn) {
-		if (!strncmp(fcn->name, "fcn.", 4) || !strncmp(fcn->name, "sym.func.", 9)) {
-			RzFlagItem *item = rz_flag_get(core->flags, fcn->name);
-			if (item) {
-				char *name = rz_core_analysis_function_autoname(core, fcn);
-				if (name) {
-					rz_flag_rename(core->flags, item, name);
-					free(fcn->name);
-					fcn->name = name;
-				}
-			} else {
-				// there should always be a flag for a function
-				rz_warn_if_reached();
+		if (autoname_candidate(fcn)) {
+			rz_pvector_push(&fcns, fcn);
+		}
+	}
+	size_t count = rz_pvector_len(&fcns);
+	AutonameCtx ctx = {
+		.fcns = (RzAnalysisFunction **)rz_pvector_data(&fcns),
+		.xrefs = count ? RZ_NEWS0(RzVector *, count) : NULL,
+	};
+	if (ctx.xrefs) {
+		RzThreadTaskPool *pool = count >= 0x100 ? rz_core_get_task_pool(core) : NULL;
+		if (!pool || (!rz_th_task_pool_parallel_for(pool, 0, count, 0x40, autoname_xrefs_range, &ctx) && !rz_cons_is_breaked())) {
+			// only the functions the pool did not get to are left
+			autoname_xrefs_range(0, count, &ctx);
+		}
+	}
+	for (size_t i = 0; i < count; i++) {
+		fcn = ctx.fcns[i];
+		RzFlagItem *item = rz_flag_get(core->flags, fcn->name);
+		if (item) {
+			char *name = ctx.xrefs
+				? function_autoname_xrefs(core, fcn, ctx.xrefs[i])
+				: rz_core_analysis_function_autoname(core, fcn);
+			if (name) {
+				rz_flag_rename(core->flags, item, name);
+				free(fcn->name);
+				fcn->name = name;
 			}
+		} else {
+			// there should always be a flag for a function
+			rz_warn_if_reached();
+		}
+		if (ctx.xrefs) {
+			rz_vector_free(ctx.xrefs[i]);
 		}
 	}
+	free(ctx.xrefs);
+	rz_pvector_fini(&fcns);
 }
 
 static bool blacklisted_word(const char *name) {
@@ -545,13 +600,24 @@ static bool blacklisted_word(const char *name) {
 RZ_API RZ_OWN char *rz_core_analysis_function_autoname(RZ_NONNULL RzCore *core, RZ_NONNULL RzAnalysisFunction *fcn) {
 	rz_return_val_if_fail(core && fcn, NULL);
 
+	RzVector *xrefs = rz_analysis_function_get_xrefs_from_vec(fcn);
+	char *name = function_autoname_xrefs(core, fcn, xrefs);
+	rz_vector_free(xrefs);
+	return name;
+}
+
+/**
+ * Suggest a name for \p fcn from its outgoing \p xrefs, which are borrowed
+ */
+static char *function_autoname_xrefs(RzCore *core, RzAnalysisFunction *fcn, RzVector /*<RzAnalysisXRef>*/ *xrefs) {
 	RzAnalysisXRef *xref;
-	RzListIter *iter;
 	bool use_getopt = false;
 	bool use_isatty = false;
 	char *do_call = NULL;
-	RzList *xrefs = rz_analysis_function_get_xrefs_from(fcn);
-	rz_list_foreach (xrefs, iter, xref) {
+	if (!xrefs) {
+		return NULL;
+	}
+	rz_vector_foreach(xrefs, xref) {
 		RzFlagItem *f = rz_flag_get_i(core->flags, xref->to);
 		if (f && !blacklisted_word(f->name)) {
 			if (strstr(f->name, ".isatty")) {
@@ -582,7 +648,6 @@ RZ_API RZ_OWN char *rz_core_analysis_function_autoname(RZ_NONNULL RzCore *core,
 			}
 		}
 	}
-	rz_list_free(xrefs);
 	// TODO: append counter if name already exists
 	if (use_getopt) {
 		RzFlagItem *item = rz_flag_get(core->flags, "main");
@@ -613,9 +678,11 @@ RZ_API void rz_core_analysis_function_strings_print(RZ_NONNULL RzCore *core, RZ_
 	rz_return_if_fail(core && fcn);
 
 	RzAnalysisXRef *xref;
-	RzListIter *iter;
-	RzList *xrefs = rz_analysis_function_get_xrefs_from(fcn);
-	rz_list_foreach (xrefs, iter, xref) {
+	RzVector *xrefs = rz_analysis_function_get_xrefs_from_vec(fcn);
+	if (!xrefs) {
+		return;
+	}
+	rz_vector_foreach(xrefs, xref) {
 		RzFlagItem *f = rz_flag_get_by_spaces(core->flags, xref->to, RZ_FLAGS_FS_STRINGS, NULL);
 		if (!f || !f->space || strcmp(f->space->name, RZ_FLAGS_FS_STRINGS)) {
 			continue;
@@ -630,7 +697,7 @@ RZ_API void rz_core_analysis_function_strings_print(RZ_NONNULL RzCore *core, RZ_
 			rz_cons_printf("0x%08" PFMT64x " 0x%08" PFMT64x " %s\n", xref->from, xref->to, f->name);
 		}
 	}
-	rz_list_free(xrefs);
+	rz_vector_free(xrefs);
 }
 
 static ut64 *next_append(ut64 *next, int *nexti, ut64 v) {
@@ -650,16 +717,18 @@ static void rz_analysis_set_stringrefs(RzCore *core, RzAnalysisFunction *fcn) {
 	if (!bobj) {
 		return;
 	}
-	RzListIter *iter;
 	RzAnalysisXRef *xref;
-	RzList *xrefs = rz_analysis_function_get_xrefs_from(fcn);
-	rz_list_foreach (xrefs, iter, xref) {
+	RzVector *xrefs = rz_analysis_function_get_xrefs_from_vec(fcn);
+	if (!xrefs) {
+		return;
+	}
+	rz_vector_foreach(xrefs, xref) {
 		if (xref->type == RZ_ANALYSIS_XREF_TYPE_DATA &&
 			rz_bin_object_get_string_at(bobj, xref->to, is_va)) {
 			rz_analysis_xrefs_set(core->analysis, xref->from, xref->to, RZ_ANALYSIS_XREF_TYPE_STRING);
 		}
 	}
-	rz_list_free(xrefs);
+	rz_vector_free(xrefs);
 }
 
 static bool rz_analysis_try_get_fcn(RzCore *core, RzAnalysisXRef *xref, int fcndepth, int refdepth) {
@@ -724,11 +793,13 @@ static bool rz_analysis_try_get_fcn(RzCore *core, RzAnalysisXRef *xref, int fcnd
 }
 
 static int rz_analysis_analyze_fcn_refs(RzCore *core, RzAnalysisFunction *fcn, int depth) {
-	RzListIter *iter;
 	RzAnalysisXRef *xref;
-	RzList *xrefs = rz_analysis_function_get_xrefs_from(fcn);
+	RzVector *xrefs = rz_analysis_function_get_xrefs_from_vec(fcn);
+	if (!xrefs) {
+		return 0;
+	}
 
-	rz_list_foreach (xrefs, iter, xref) {
+	rz_vector_foreach(xrefs, xref) {
 		if (xref->to == UT64_MAX) {
 			continue;
 		}
@@ -748,7 +819,7 @@ static int rz_analysis_analyze_fcn_refs(RzCore *core, RzAnalysisFunction *fcn, i
 		// TODO: fix memleak here, fcn not freed even though it is
 		// added in core->analysis->fcns which is freed in rz_analysis_free()
 	}
-	rz_list_free(xrefs);
+	rz_vector_free(xrefs);
 	return 1;
 }
 
@@ -761,7 +832,7 @@ static void function_rename(RzFlag *flags, RzAnalysisFunction *fcn) {
 		const char *fcnpfx, *restofname;
 		RzFlagItem *f;
 
-		fcn->type = RZ_ANALYSIS_FCN_TYPE_FCN;
+		rz_analysis_function_set_fcntype(fcn, RZ_ANALYSIS_FCN_TYPE_FCN);
 		fcnpfx = rz_analysis_fcntype_tostring(fcn->type);
 		restofname = fcn->name + locsize;
 		fcn->name = rz_str_newf("%s.%s", fcnpfx, restofname);
@@ -775,9 +846,9 @@ static void function_rename(RzFlag *flags, RzAnalysisFunction *fcn) {
 
 static void autoname_imp_trampoline(RzCore *core, RzAnalysisFunction *fcn) {
 	if (rz_list_length(fcn->bbs) == 1 && ((RzAnalysisBlock *)rz_list_first(fcn->bbs))->ninstr == 1) {
-		RzList *xrefs = rz_analysis_function_get_xrefs_from(fcn);
-		if (xrefs && rz_list_length(xrefs) == 1) {
-			RzAnalysisXRef *xref = rz_list_first(xrefs);
+		RzVector *xrefs = rz_analysis_function_get_xrefs_from_vec(fcn);
+		if (xrefs && rz_vector_len(xrefs) == 1) {
+			RzAnalysisXRef *xref = rz_vector_head(xrefs);
 			if (xref->type != RZ_ANALYSIS_XREF_TYPE_CALL) { /* Some fcns don't return */
 				RzFlagItem *flg = rz_flag_get_i(core->flags, xref->to);
 				if (flg && rz_str_startswith(flg->name, "sym.imp.")) {
@@ -786,7 +857,7 @@ static void autoname_imp_trampoline(RzCore *core, RzAnalysisFunction *fcn) {
 				}
 			}
 		}
-		rz_list_free(xrefs);
+		rz_vector_free(xrefs);
 	}
 }
 
@@ -845,7 +916,7 @@ static int __core_analysis_fcn(RzCore *core, ut64 at, ut64 from, int reftype, in
 	if (!fcn->name) {
 		fcn->name = rz_str_newf("%s.%08" PFMT64x, fcnpfx, at);
 	}
-	rz_analysis_fcn_invalidate_read_ahead_cache();
+	rz_analysis_fcn_invalidate_read_ahead_cache(core->analysis);
 	do {
 		RzFlagItem *f;
 		ut64 delta = rz_analysis_function_linear_size(fcn);
@@ -2397,7 +2468,8 @@ RZ_API RzGraph *rz_core_analysis_importxrefs(RzCore *core) {
 	if (!graph) {
 		return NULL;
 	}
-	rz_list_foreach (obj->imports, iter, imp) {
+	const RzList *imports = rz_bin_object_get_imports(obj);
+	rz_list_foreach (imports, iter, imp) {
 		RzBinSymbol *sym = rz_bin_object_get_symbol_of_import(obj, imp);
 		ut64 addr = sym ? (va ? rz_bin_object_get_vaddr(obj, sym->paddr, sym->vaddr) : sym->paddr) : UT64_MAX;
 		if (addr && addr != UT64_MAX) {
@@ -2778,6 +2850,7 @@ static bool analysis_block_cb(RzAnalysisBlock *bb, BlockRecurseCtx *ctx) {
 // TODO: move this logic into the main analysis loop
 RZ_API void rz_core_recover_vars(RzCore *core, RzAnalysisFunction *fcn, bool argonly) {
 	rz_return_if_fail(core && core->analysis && fcn);
+	fcn->vars_pending = false;
 	if (core->analysis->opt.bb_max_size < 1) {
 		return;
 	}
@@ -2794,6 +2867,29 @@ RZ_API void rz_core_recover_vars(RzCore *core, RzAnalysisFunction *fcn, bool arg
 	fcn->stack = saved_stack;
 }
 
+/**
+ * \brief Recover the variables of \p fcn if aa/aaa left it to be done later
+ *
+ * With analysis.vars.lazy, functions found by aa/aaa only get marked, and
+ * this runs the recovery the first time the variables of one are needed.
+ */
+RZ_API void rz_core_analysis_function_vars_ensure(RzCore *core, RzAnalysisFunction *fcn) {
+	rz_return_if_fail(core && fcn);
+	if (!fcn->vars_pending) {
+		return;
+	}
+	rz_core_recover_vars(core, fcn, true);
+}
+
+// recover the vars of fcn now, or mark them for rz_core_analysis_function_vars_ensure()
+static void recover_vars_or_defer(RzCore *core, RzAnalysisFunction *fcn) {
+	if (core->analysis->opt.vars_lazy) {
+		fcn->vars_pending = true;
+		return;
+	}
+	rz_core_recover_vars(core, fcn, true);
+}
+
 static bool analysis_path_exists(RzCore *core, ut64 from, ut64 to, RzList *bbs, int depth, HtUP *state, HtUP *avoid) {
 	rz_return_val_if_fail(bbs, false);
 	RzAnalysisBlock *bb = rz_analysis_find_most_relevant_block_in(core->analysis, from);
@@ -3311,56 +3407,115 @@ RZ_API bool rz_core_analysis_refs(RZ_NONNULL RzCore *core, size_t nbytes) {
 	return true;
 }
 
+typedef struct {
+	RzCore *core;
+	bool cfg_debug;
+	bool decode_str;
+	HtUP *strings; ///< filtered is_string_at() results by address, NULL for the addresses holding no string
+	RzInterval readable; ///< last interval found on top of the io maps with a readable map
+	int count;
+} XRefSearch;
+
+typedef struct {
+	char *name;
+	int len;
+} XRefString;
+
+static void xref_string_free(HtUPKv *kv) {
+	XRefString *str = kv->value;
+	if (str) {
+		free(str->name);
+		free(str);
+	}
+}
+
 /**
  * \brief Validates a xref. Mainly checks if it points out of the memory map.
  *
- * \param core The rizin core.
+ * The io maps don't change during the search, so the interval of the last
+ * readable map found is remembered.
+ *
+ * \param s The search state.
  * \param xref_to The target address of the xref.
  * \param type The xref type.
- * \param cfg_debug Flag if debugging configured.
  * \return true xref is valid.
  * \return false xref is not valid.
  */
-static bool is_valid_xref(RzCore *core, ut64 xref_to, RzAnalysisXRefType type, int cfg_debug) {
+static bool is_valid_xref(XRefSearch *s, ut64 xref_to, RzAnalysisXRefType type) {
 	if (type == RZ_ANALYSIS_XREF_TYPE_NULL) {
 		return false;
 	}
-	if (cfg_debug) {
-		if (!rz_debug_map_get(core->dbg, xref_to)) {
+	if (s->cfg_debug) {
+		if (!rz_debug_map_get(s->core->dbg, xref_to)) {
 			return false;
 		}
-	} else if (core->io->va) {
-		if (!rz_io_is_valid_offset(core->io, xref_to, 0)) {
+	} else if (s->core->io->va) {
+		if (rz_itv_contain(s->readable, xref_to)) {
+			return true;
+		}
+		const RzSkylineItem *item = rz_skyline_get_item(&s->core->io->map_skyline, xref_to);
+		RzIOMap *map = item ? item->user : NULL;
+		if (!map || !(map->perm & RZ_PERM_R)) {
 			return false;
 		}
+		s->readable = item->itv;
 	}
 	return true;
 }
 
 /**
- * \brief Sets a new xref according to the given to and from addresses.
+ * \brief Decodes the string at \p addr once per search
+ */
+static XRefString *xref_string_at(XRefSearch *s, ut64 addr) {
+	bool found = false;
+	XRefString *str = ht_up_find(s->strings, addr, &found);
+	if (found) {
+		return str;
+	}
+	int len = 0;
+	char *name = is_string_at(s->core, addr, &len);
+	if (name) {
+		str = RZ_NEW(XRefString);
+		if (!str) {
+			free(name);
+			return NULL;
+		}
+		rz_name_filter(name, -1, true);
+		str->name = name;
+		str->len = len;
+	}
+	ht_up_insert(s->strings, addr, str);
+	return str;
+}
+
+/**
+ * \brief Sets a new xref according to the given to and from addresses, if valid.
  *
- * \param core       The rizin core.
+ * When analysis.strings is set, checks if the RZ_ANALYSIS_XREF_TYPE_DATA
+ * address is a string and adds a flag.
+ *
+ * \param s          The search state.
  * \param xref_from  The address where the xref is located.
  * \param xref_to    The target address of the xref.
  * \param type       The xref type.
- * \param decode_str When set to true, checks if the RZ_ANALYSIS_XREF_TYPE_DATA address is a string and adds a flag.
  */
-static void set_new_xref(RzCore *core, ut64 xref_from, ut64 xref_to, RzAnalysisXRefType type, bool decode_str) {
-	if (decode_str && type == RZ_ANALYSIS_XREF_TYPE_DATA) {
-		int len = 0;
-		char *str_string = is_string_at(core, xref_to, &len);
-		if (str_string) {
-			rz_name_filter(str_string, -1, true);
-			char *str_flagname = rz_str_newf("str.%s", str_string);
+static void set_new_xref(XRefSearch *s, ut64 xref_from, ut64 xref_to, RzAnalysisXRefType type) {
+	RzCore *core = s->core;
+	if (!is_valid_xref(s, xref_to, type)) {
+		return;
+	}
+	s->count++;
+	if (s->decode_str && type == RZ_ANALYSIS_XREF_TYPE_DATA) {
+		XRefString *str = xref_string_at(s, xref_to);
+		if (str) {
+			char *str_flagname = rz_str_newf("str.%s", str->name);
 			rz_flag_space_push(core->flags, RZ_FLAGS_FS_STRINGS);
 			(void)rz_flag_set(core->flags, str_flagname, xref_to, 1);
 			rz_flag_space_pop(core->flags);
 			free(str_flagname);
-			if (len > 0) {
-				rz_meta_set(core->analysis, RZ_META_TYPE_STRING, xref_to, len, (const char *)str_string);
+			if (str->len > 0) {
+				rz_meta_set(core->analysis, RZ_META_TYPE_STRING, xref_to, str->len, str->name);
 			}
-			free(str_string);
 		}
 	}
 	// Add to SDB
@@ -3369,6 +3524,15 @@ static void set_new_xref(RzCore *core, ut64 xref_from, ut64 xref_to, RzAnalysisX
 	}
 }
 
+static bool is_uniform_block(const ut8 *buf, int len) {
+	for (int i = 1; i < len; i++) {
+		if (buf[i] != buf[0]) {
+			return false;
+		}
+	}
+	return true;
+}
+
 /**
  * \brief Searches for xrefs in the range of the paramters \p 'from' and \p 'to'.
  *
@@ -3380,10 +3544,13 @@ static void set_new_xref(RzCore *core, ut64 xref_from, ut64 xref_to, RzAnalysisX
 RZ_API int rz_core_analysis_search_xrefs(RZ_NONNULL RzCore *core, ut64 from, ut64 to) {
 	rz_return_val_if_fail(core, -1);
 
-	bool cfg_debug = rz_config_get_b(core->config, "cfg.debug");
-	bool decode_str = rz_config_get_i(core->config, "analysis.strings");
+	XRefSearch s = {
+		.core = core,
+		.cfg_debug = rz_config_get_b(core->config, "cfg.debug"),
+		.decode_str = rz_config_get_i(core->config, "analysis.strings"),
+	};
+	bool jmp_cref = rz_config_get_b(core->config, "analysis.jmp.cref");
 	ut64 at;
-	int count = 0;
 	const int bsz = 8096;
 	RzAnalysisOp op = { 0 };
 
@@ -3403,9 +3570,8 @@ RZ_API int rz_core_analysis_search_xrefs(RZ_NONNULL RzCore *core, ut64 from, ut6
 		return -1;
 	}
 
-	ut8 *block = malloc(bsz);
-	if (!block) {
-		RZ_LOG_ERROR("cannot allocate a temp block\n");
+	s.strings = ht_up_new(NULL, xref_string_free, NULL);
+	if (!s.strings) {
 		free(buf);
 		return -1;
 	}
@@ -3420,13 +3586,7 @@ RZ_API int rz_core_analysis_search_xrefs(RZ_NONNULL RzCore *core, ut64 from, ut6
 			break;
 		}
 		(void)rz_io_read_at(core->io, at, buf, bsz);
-		memset(block, -1, bsz);
-		if (!memcmp(buf, block, bsz)) {
-			at += ret;
-			continue;
-		}
-		memset(block, 0, bsz);
-		if (!memcmp(buf, block, bsz)) {
+		if ((buf[0] == 0xff || !buf[0]) && is_uniform_block(buf, bsz)) {
 			at += ret;
 			continue;
 		}
@@ -3439,54 +3599,34 @@ RZ_API int rz_core_analysis_search_xrefs(RZ_NONNULL RzCore *core, ut64 from, ut6
 			}
 			// find references
 			if ((st64)op.val > asm_sub_varmin && op.val != UT64_MAX && op.val != UT32_MAX) {
-				if (is_valid_xref(core, op.val, RZ_ANALYSIS_XREF_TYPE_DATA, cfg_debug)) {
-					set_new_xref(core, op.addr, op.val, RZ_ANALYSIS_XREF_TYPE_DATA, decode_str);
-					count++;
-				}
+				set_new_xref(&s, op.addr, op.val, RZ_ANALYSIS_XREF_TYPE_DATA);
 			}
 			for (ut8 i = 0; i < 6; ++i) {
 				st64 aval = op.analysis_vals[i].imm;
 				if (aval > asm_sub_varmin && aval != UT64_MAX && aval != UT32_MAX) {
-					if (is_valid_xref(core, aval, RZ_ANALYSIS_XREF_TYPE_DATA, cfg_debug)) {
-						set_new_xref(core, op.addr, aval, RZ_ANALYSIS_XREF_TYPE_DATA, decode_str);
-						count++;
-					}
+					set_new_xref(&s, op.addr, aval, RZ_ANALYSIS_XREF_TYPE_DATA);
 				}
 			}
 			// find references
 			if (op.ptr && op.ptr != UT64_MAX && op.ptr != UT32_MAX) {
-				if (is_valid_xref(core, op.ptr, RZ_ANALYSIS_XREF_TYPE_DATA, cfg_debug)) {
-					set_new_xref(core, op.addr, op.ptr, RZ_ANALYSIS_XREF_TYPE_DATA, decode_str);
-					count++;
-				}
+				set_new_xref(&s, op.addr, op.ptr, RZ_ANALYSIS_XREF_TYPE_DATA);
 			}
 			// find references
 			if (op.addr > 512 && op.disp > 512 && op.disp && op.disp != UT64_MAX) {
-				if (is_valid_xref(core, op.disp, RZ_ANALYSIS_XREF_TYPE_DATA, cfg_debug)) {
-					set_new_xref(core, op.addr, op.disp, RZ_ANALYSIS_XREF_TYPE_DATA, decode_str);
-					count++;
-				}
+				set_new_xref(&s, op.addr, op.disp, RZ_ANALYSIS_XREF_TYPE_DATA);
 			}
 			switch (op.type) {
 			case RZ_ANALYSIS_OP_TYPE_JMP:
-				if (is_valid_xref(core, op.jump, RZ_ANALYSIS_XREF_TYPE_CODE, cfg_debug)) {
-					set_new_xref(core, op.addr, op.jump, RZ_ANALYSIS_XREF_TYPE_CODE, decode_str);
-					count++;
-				}
+				set_new_xref(&s, op.addr, op.jump, RZ_ANALYSIS_XREF_TYPE_CODE);
 				break;
 			case RZ_ANALYSIS_OP_TYPE_CJMP:
-				if (rz_config_get_b(core->config, "analysis.jmp.cref") &&
-					is_valid_xref(core, op.jump, RZ_ANALYSIS_XREF_TYPE_CODE, cfg_debug)) {
-					set_new_xref(core, op.addr, op.jump, RZ_ANALYSIS_XREF_TYPE_CODE, decode_str);
-					count++;
+				if (jmp_cref) {
+					set_new_xref(&s, op.addr, op.jump, RZ_ANALYSIS_XREF_TYPE_CODE);
 				}
 				break;
 			case RZ_ANALYSIS_OP_TYPE_CALL:
 			case RZ_ANALYSIS_OP_TYPE_CCALL:
-				if (is_valid_xref(core, op.jump, RZ_ANALYSIS_XREF_TYPE_CALL, cfg_debug)) {
-					set_new_xref(core, op.addr, op.jump, RZ_ANALYSIS_XREF_TYPE_CALL, decode_str);
-					count++;
-				}
+				set_new_xref(&s, op.addr, op.jump, RZ_ANALYSIS_XREF_TYPE_CALL);
 				break;
 			case RZ_ANALYSIS_OP_TYPE_UJMP:
 			case RZ_ANALYSIS_OP_TYPE_IJMP:
@@ -3494,21 +3634,15 @@ RZ_API int rz_core_analysis_search_xrefs(RZ_NONNULL RzCore *core, ut64 from, ut6
 			case RZ_ANALYSIS_OP_TYPE_IRJMP:
 			case RZ_ANALYSIS_OP_TYPE_MJMP:
 			case RZ_ANALYSIS_OP_TYPE_UCJMP:
-				count++;
-				if (is_valid_xref(core, op.ptr, RZ_ANALYSIS_XREF_TYPE_CODE, cfg_debug)) {
-					set_new_xref(core, op.addr, op.ptr, RZ_ANALYSIS_XREF_TYPE_CODE, decode_str);
-					count++;
-				}
+				s.count++;
+				set_new_xref(&s, op.addr, op.ptr, RZ_ANALYSIS_XREF_TYPE_CODE);
 				break;
 			case RZ_ANALYSIS_OP_TYPE_UCALL:
 			case RZ_ANALYSIS_OP_TYPE_ICALL:
 			case RZ_ANALYSIS_OP_TYPE_RCALL:
 			case RZ_ANALYSIS_OP_TYPE_IRCALL:
 			case RZ_ANALYSIS_OP_TYPE_UCCALL:
-				if (is_valid_xref(core, op.ptr, RZ_ANALYSIS_XREF_TYPE_CALL, cfg_debug)) {
-					set_new_xref(core, op.addr, op.ptr, RZ_ANALYSIS_XREF_TYPE_CALL, decode_str);
-					count++;
-				}
+				set_new_xref(&s, op.addr, op.ptr, RZ_ANALYSIS_XREF_TYPE_CALL);
 				break;
 			default:
 				break;
@@ -3519,9 +3653,9 @@ RZ_API int rz_core_analysis_search_xrefs(RZ_NONNULL RzCore *core, ut64 from, ut6
 		rz_analysis_op_fini(&op);
 	}
 	rz_cons_break_pop();
+	ht_up_free(s.strings);
 	free(buf);
-	free(block);
-	return count;
+	return s.count;
 }
 
 static bool isValidSymbol(RzBinSymbol *symbol) {
@@ -3549,67 +3683,95 @@ static bool isSkippable(RzBinSymbol *s) {
 	return false;
 }
 
-RZ_API int rz_core_analysis_all(RzCore *core) {
-	RzList *list;
-	RzListIter *iter;
-	RzFlagItem *item;
-	RzAnalysisFunction *fcni;
-	const RzBinAddr *binmain;
-	RzBinAddr *entry;
-	RzBinSymbol *symbol;
-	int depth = core->analysis->opt.depth;
-	bool analysis_vars = rz_config_get_i(core->config, "analysis.vars");
-
-	/* Analyze Functions */
-	/* Entries */
-	item = rz_flag_get(core->flags, "entry0");
-	if (item) {
-		rz_core_analysis_fcn(core, item->offset, -1, RZ_ANALYSIS_XREF_TYPE_NULL, depth - 1);
-		rz_core_analysis_function_rename(core, item->offset, "entry0");
-	} else {
-		rz_core_analysis_function_add(core, NULL, core->offset, false);
+static void entrypoint_push(RzVector *entrypoints, SetU *seen, ut64 addr) {
+	if (set_u_contains(seen, addr)) {
+		return;
 	}
+	set_u_add(seen, addr);
+	rz_vector_push(entrypoints, &addr);
+}
 
-	rz_core_task_yield(&core->tasks);
-
-	rz_cons_break_push(NULL, NULL);
-
+/**
+ * \brief Collect the addresses of all the independent function entrypoints
+ * known from the binary (symbols, main and entries), in analysis order
+ *
+ * Aliased symbols are very common (e.g. .symtab and .dynsym describing the
+ * same function), every address is reported only once.
+ */
+static void collect_entrypoints(RzCore *core, RzVector *entrypoints, SetU *seen) {
 	RzBinFile *bf = core->bin->cur;
 	RzBinObject *o = bf ? bf->o : NULL;
+	RzListIter *iter;
+	RzBinSymbol *symbol;
+	RzBinAddr *entry;
+	const RzBinAddr *binmain;
+	RzList *list;
 	/* Symbols (Imports are already analyzed by rz_bin on init) */
-	if (o && (list = o->symbols) != NULL) {
+	if (o && (list = (RzList *)rz_bin_object_get_symbols(o)) != NULL) {
 		rz_list_foreach (list, iter, symbol) {
-			if (rz_cons_is_breaked()) {
-				break;
-			}
 			// Stop analyzing PE imports further
 			if (isSkippable(symbol)) {
 				continue;
 			}
 			if (isValidSymbol(symbol)) {
-				ut64 addr = rz_bin_object_get_vaddr(o, symbol->paddr, symbol->vaddr);
-				rz_core_analysis_fcn(core, addr, -1, RZ_ANALYSIS_XREF_TYPE_NULL, depth - 1);
+				entrypoint_push(entrypoints, seen, rz_bin_object_get_vaddr(o, symbol->paddr, symbol->vaddr));
 			}
 		}
 	}
-	rz_core_task_yield(&core->tasks);
 	/* Main */
 	if (o && (binmain = rz_bin_object_get_special_symbol(o, RZ_BIN_SPECIAL_SYMBOL_MAIN))) {
 		if (binmain->paddr != UT64_MAX) {
-			ut64 addr = rz_bin_object_get_vaddr(o, binmain->paddr, binmain->vaddr);
-			rz_core_analysis_fcn(core, addr, -1, RZ_ANALYSIS_XREF_TYPE_NULL, depth - 1);
+			entrypoint_push(entrypoints, seen, rz_bin_object_get_vaddr(o, binmain->paddr, binmain->vaddr));
 		}
 	}
-	rz_core_task_yield(&core->tasks);
 	if ((list = rz_bin_get_entries(core->bin))) {
 		rz_list_foreach (list, iter, entry) {
 			if (entry->paddr == UT64_MAX) {
 				continue;
 			}
-			ut64 addr = rz_bin_object_get_vaddr(o, entry->paddr, entry->vaddr);
-			rz_core_analysis_fcn(core, addr, -1, RZ_ANALYSIS_XREF_TYPE_NULL, depth - 1);
+			entrypoint_push(entrypoints, seen, rz_bin_object_get_vaddr(o, entry->paddr, entry->vaddr));
+		}
+	}
+}
+
+RZ_API int rz_core_analysis_all(RzCore *core) {
+	RzListIter *iter;
+	RzFlagItem *item;
+	RzAnalysisFunction *fcni;
+	int depth = core->analysis->opt.depth;
+	bool analysis_vars = rz_config_get_i(core->config, "analysis.vars");
+	RzVector entrypoints;
+	SetU *seen = set_u_new();
+	if (!seen) {
+		return false;
+	}
+	rz_vector_init(&entrypoints, sizeof(ut64), NULL, NULL);
+
+	/* Analyze Functions */
+	/* Entries */
+	item = rz_flag_get(core->flags, "entry0");
+	if (item) {
+		rz_core_analysis_fcn(core, item->offset, -1, RZ_ANALYSIS_XREF_TYPE_NULL, depth - 1);
+		rz_core_analysis_function_rename(core, item->offset, "entry0");
+		set_u_add(seen, item->offset);
+	} else {
+		rz_core_analysis_function_add(core, NULL, core->offset, false);
+	}
+
+	rz_core_task_yield(&core->tasks);
+
+	rz_cons_break_push(NULL, NULL);
+
+	collect_entrypoints(core, &entrypoints, seen);
+	set_u_free(seen);
+	ut64 *addr;
+	rz_vector_foreach(&entrypoints, addr) {
+		if (rz_cons_is_breaked()) {
+			break;
 		}
+		rz_core_analysis_fcn(core, *addr, -1, RZ_ANALYSIS_XREF_TYPE_NULL, depth - 1);
 	}
+	rz_vector_fini(&entrypoints);
 	rz_core_task_yield(&core->tasks);
 	if (analysis_vars) {
 		/* Set fcn type to RZ_ANALYSIS_FCN_TYPE_SYM for symbols */
@@ -3617,7 +3779,7 @@ RZ_API int rz_core_analysis_all(RzCore *core) {
 			if (rz_cons_is_breaked()) {
 				break;
 			}
-			rz_core_recover_vars(core, fcni, true);
+			recover_vars_or_defer(core, fcni);
 			if (!strncmp(fcni->name, "sym.", 4) || !strncmp(fcni->name, "main", 4)) {
 				fcni->type = RZ_ANALYSIS_FCN_TYPE_SYM;
 			}
@@ -3694,123 +3856,310 @@ RZ_API int rz_core_analysis_data(RzCore *core, ut64 addr, int count, int depth,
 	return true;
 }
 
-struct block_flags_stat_t {
+#define STATS_GRAIN 16 ///< blocks of the overview counted by each task
+
+/**
+ * \brief Last overview computed by rz_core_analysis_get_stats()
+ *
+ * Visual mode asks for the same range on every redraw. Each kind of count
+ * is kept along with the generation of the data it comes from and only
+ * recomputed when that changed, for the blocks touched by the analysis
+ * since then when that is known.
+ */
+struct rz_core_analysis_stats_cache_t {
+	ut64 from;
+	ut64 to;
 	ut64 step;
+	RzVector /*<RzCoreAnalysisStatsItem>*/ blocks; ///< empty if nothing is cached
+	ut64 flags_generation; ///< RzFlag.generation of the flags counts
+	ut64 analysis_generation; ///< rz_analysis_generation() of the functions, blocks and meta counts
+	ut64 fcns_generation; ///< RzAnalysisGeneration.fcns of the functions and blocks counts
+	ut64 bbs_generation; ///< RzAnalysisGeneration.blocks of the functions and blocks counts
+	ut64 meta_generation; ///< RzAnalysisGeneration.meta of the strings and comments counts
+	const RzSpace *meta_space; ///< meta space the strings and comments were counted in
+	ut32 symbols_file; ///< RzBinFile.id of the symbols counts
+	const RzList *symbols;
+	ut32 symbols_count;
+};
+
+RZ_IPI void rz_core_analysis_stats_cache_free(RZ_NULLABLE RzCoreAnalysisStatsCache *cache) {
+	if (!cache) {
+		return;
+	}
+	rz_vector_fini(&cache->blocks);
+	free(cache);
+}
+
+typedef struct {
+	RzCore *core;
 	ut64 from;
+	ut64 to;
+	ut64 step;
+	size_t count;
 	RzCoreAnalysisStatsItem *blocks;
-};
+	bool bbs; ///< count the basic blocks
+	bool meta; ///< count the strings and comments
+} StatsCtx;
+
+typedef struct {
+	StatsCtx *ctx;
+	ut64 from;
+	ut64 to;
+} StatsRangeCtx;
 
 static bool block_flags_stat(RzFlagItem *fi, void *user) {
-	struct block_flags_stat_t *u = (struct block_flags_stat_t *)user;
-	size_t piece = (fi->offset - u->from) / u->step;
-	u->blocks[piece].flags++;
+	StatsCtx *ctx = user;
+	size_t piece = (fi->offset - ctx->from) / ctx->step;
+	ctx->blocks[piece].flags++;
 	return true;
 }
 
-/**
- * Generate statistics for a range of memory, e.g. for a colorful overview bar.
- *
- * Let `fullsz = to + 1 - from`.
- * If `fullsz % step = 0`, then the result will be `fullsz / step` blocks of size `step`.
- * Otherwise, it will be `fullsz / step` blocks of size `step` and one additional block
- * covering the rest.
- *
- * \param lowest address to consider
- * \param highest address to consider, inclusive. Must be greater than or equal to from.
- * \param size of a single block in the output
- */
-RZ_API RZ_OWN RzCoreAnalysisStats *rz_core_analysis_get_stats(RZ_NONNULL RzCore *core, ut64 from, ut64 to, ut64 step) {
-	rz_return_val_if_fail(core && to >= from && step, NULL);
-	RzAnalysisFunction *F;
-	RzAnalysisBlock *B;
-	RzBinSymbol *S;
-	RzListIter *iter, *iter2;
-	ut64 at;
-	RzCoreAnalysisStats *as = RZ_NEW0(RzCoreAnalysisStats);
-	if (!as) {
-		return NULL;
-	}
-	as->from = from;
-	as->to = to;
-	as->step = step;
-	rz_vector_init(&as->blocks, sizeof(RzCoreAnalysisStatsItem), NULL, NULL);
-	size_t count = (to == UT64_MAX && from == 0) ? rz_num_2_pow_64_div(step) : (to + 1 - from) / step;
-	if (from + count * step != to + 1) {
-		count++;
-	}
-	if (!count || SZT_MUL_OVFCHK(count, sizeof(RzCoreAnalysisStatsItem))) {
-		rz_core_analysis_stats_free(as);
-		return NULL;
-	}
-	RzCoreAnalysisStatsItem *blocks = rz_vector_insert_range(&as->blocks, 0, NULL, count);
-	if (!blocks) {
-		rz_core_analysis_stats_free(as);
-		return NULL;
+static bool block_bbs_stat(RzAnalysisBlock *block, void *user) {
+	StatsRangeCtx *range = user;
+	StatsCtx *ctx = range->ctx;
+	if (block->addr < range->from || block->addr > range->to) {
+		return true;
 	}
-	memset(blocks, 0, count * sizeof(RzCoreAnalysisStatsItem));
-	for (at = from; at < to;) {
-		RzIOMap *map = rz_io_map_get(core->io, at);
-		size_t piece = (at - from) / step;
-		blocks[piece].perm = map ? map->perm : (core->io->desc ? core->io->desc->perm : 0);
-		ut64 prev = at;
-		at += step;
-		if (at < prev) {
-			break;
+	RzListIter *iter;
+	RzAnalysisFunction *fcn;
+	ut32 n = 0;
+	rz_list_foreach (block->fcns, iter, fcn) {
+		// only the blocks of the functions starting in the overview
+		if (fcn->addr >= ctx->from && fcn->addr <= ctx->to) {
+			n++;
 		}
 	}
-	// iter all flags
-	struct block_flags_stat_t u = { .step = step, .from = from, .blocks = blocks };
-	rz_flag_foreach_range(core->flags, from, to, block_flags_stat, &u);
-	// iter all functions
-	rz_list_foreach (core->analysis->fcns, iter, F) {
-		if (F->addr < from || F->addr > to) {
-			continue;
-		}
-		size_t piece = (F->addr - from) / step;
-		blocks[piece].functions++;
-		ut64 last_piece = RZ_MIN((F->addr + rz_analysis_function_linear_size(F) - 1) / step, count - 1);
-		for (; piece <= last_piece; piece++) {
-			blocks[piece].in_functions++;
+	ctx->blocks[(block->addr - ctx->from) / ctx->step].blocks += n;
+	return true;
+}
+
+/* Counts the basic blocks, strings and comments of the blocks [lo, hi) of the overview */
+static void stats_range(size_t lo, size_t hi, void *user) {
+	StatsCtx *ctx = user;
+	RzAnalysis *analysis = ctx->core->analysis;
+	ut64 from = ctx->from + lo * ctx->step;
+	ut64 to = hi == ctx->count ? ctx->to : ctx->from + hi * ctx->step - 1;
+	for (size_t i = lo; i < hi; i++) {
+		if (ctx->bbs) {
+			ctx->blocks[i].blocks = 0;
 		}
-		// iter all basic blocks
-		rz_list_foreach (F->bbs, iter2, B) {
-			if (B->addr < from || B->addr > to) {
-				continue;
-			}
-			piece = (B->addr - from) / step;
-			blocks[piece].blocks++;
+		if (ctx->meta) {
+			ctx->blocks[i].strings = 0;
+			ctx->blocks[i].comments = 0;
 		}
 	}
-	// iter all symbols
-	rz_list_foreach (rz_bin_get_symbols(core->bin), iter, S) {
-		if (S->vaddr < from || S->vaddr > to) {
+	if (ctx->bbs) {
+		StatsRangeCtx range = { ctx, from, to };
+		rz_analysis_blocks_foreach_intersect(analysis, from, to - from == UT64_MAX ? UT64_MAX : to - from + 1, block_bbs_stat, &range);
+	}
+	// metas starting at ctx->to are not counted
+	if (!ctx->meta || from >= ctx->to) {
+		return;
+	}
+	to = RZ_MIN(to, ctx->to - 1);
+	RzPVector *metas = rz_meta_get_all_intersect(analysis, from, to - from + 1, RZ_META_TYPE_ANY);
+	if (!metas) {
+		return;
+	}
+	void **it;
+	rz_pvector_foreach (metas, it) {
+		RzIntervalNode *node = *it;
+		RzAnalysisMetaItem *mi = node->data;
+		if (node->start < from || node->start > to || node->end > ctx->to) {
 			continue;
 		}
-		size_t piece = (S->vaddr - from) / step;
-		blocks[piece].symbols++;
-	}
-	RzPVector *metas = to > from ? rz_meta_get_all_intersect(core->analysis, from, to - from, RZ_META_TYPE_ANY) : NULL;
-	if (metas) {
-		void **it;
-		rz_pvector_foreach (metas, it) {
-			RzIntervalNode *node = *it;
-			RzAnalysisMetaItem *mi = node->data;
-			if (node->start < from || node->end > to) {
-				continue;
-			}
-			size_t piece = (node->start - from) / step;
-			switch (mi->type) {
-			case RZ_META_TYPE_STRING:
-				blocks[piece].strings++;
-				break;
-			case RZ_META_TYPE_COMMENT:
-				blocks[piece].comments++;
-				break;
-			default:
-				break;
+		size_t piece = (node->start - ctx->from) / ctx->step;
+		switch (mi->type) {
+		case RZ_META_TYPE_STRING:
+			ctx->blocks[piece].strings++;
+			break;
+		case RZ_META_TYPE_COMMENT:
+			ctx->blocks[piece].comments++;
+			break;
+		default:
+			break;
+		}
+	}
+	rz_pvector_free(metas);
+}
+
+static void stats_perms(RzCore *core, StatsCtx *ctx) {
+	int desc_perm = core->io->desc ? core->io->desc->perm : 0;
+	size_t i = 0;
+	for (ut64 at = ctx->from; at < ctx->to && i < ctx->count;) {
+		RzInterval itv;
+		RzIOMap *map = rz_io_map_get_range(core->io, at, &itv);
+		ut64 end = map ? rz_itv_end(itv) : at + 1;
+		// all the blocks starting in the same part of the map
+		do {
+			ctx->blocks[i++].perm = map ? map->perm : desc_perm;
+			ut64 prev = at;
+			at += ctx->step;
+			if (at < prev) {
+				return;
 			}
+		} while (at < ctx->to && i < ctx->count && (at < end || (map && !end)));
+	}
+	for (; i < ctx->count; i++) {
+		ctx->blocks[i].perm = 0;
+	}
+}
+
+static void stats_functions(RzCore *core, StatsCtx *ctx) {
+	RzListIter *iter;
+	RzAnalysisFunction *fcn;
+	for (size_t i = 0; i < ctx->count; i++) {
+		ctx->blocks[i].functions = 0;
+		ctx->blocks[i].in_functions = 0;
+	}
+	rz_list_foreach (core->analysis->fcns, iter, fcn) {
+		if (fcn->addr < ctx->from || fcn->addr > ctx->to) {
+			continue;
+		}
+		size_t piece = (fcn->addr - ctx->from) / ctx->step;
+		ctx->blocks[piece].functions++;
+		ut64 last_piece = RZ_MIN((fcn->addr + rz_analysis_function_linear_size(fcn) - 1) / ctx->step, ctx->count - 1);
+		for (; piece <= last_piece; piece++) {
+			ctx->blocks[piece].in_functions++;
+		}
+	}
+}
+
+static void stats_symbols(RzCore *core, StatsCtx *ctx, const RzList *symbols) {
+	RzListIter *iter;
+	RzBinSymbol *sym;
+	for (size_t i = 0; i < ctx->count; i++) {
+		ctx->blocks[i].symbols = 0;
+	}
+	rz_list_foreach (symbols, iter, sym) {
+		if (sym->vaddr < ctx->from || sym->vaddr > ctx->to) {
+			continue;
+		}
+		ctx->blocks[(sym->vaddr - ctx->from) / ctx->step].symbols++;
+	}
+}
+
+static RzCoreAnalysisStatsCache *stats_cache_get(RzCore *core) {
+	if (!core->stats_cache) {
+		core->stats_cache = RZ_NEW0(RzCoreAnalysisStatsCache);
+		if (core->stats_cache) {
+			rz_vector_init(&core->stats_cache->blocks, sizeof(RzCoreAnalysisStatsItem), NULL, NULL);
+		}
+	}
+	return core->stats_cache;
+}
+
+/**
+ * Generate statistics for a range of memory, e.g. for a colorful overview bar.
+ *
+ * Let `fullsz = to + 1 - from`.
+ * If `fullsz % step = 0`, then the result will be `fullsz / step` blocks of size `step`.
+ * Otherwise, it will be `fullsz / step` blocks of size `step` and one additional block
+ * covering the rest.
+ *
+ * The counts of the last range asked for are cached and only the ones whose
+ * flags, functions, metas or symbols changed are computed again, so that
+ * redrawing the same overview is cheap. The basic blocks, strings and
+ * comments are counted in parallel over the blocks.
+ *
+ * \param lowest address to consider
+ * \param highest address to consider, inclusive. Must be greater than or equal to from.
+ * \param size of a single block in the output
+ */
+RZ_API RZ_OWN RzCoreAnalysisStats *rz_core_analysis_get_stats(RZ_NONNULL RzCore *core, ut64 from, ut64 to, ut64 step) {
+	rz_return_val_if_fail(core && to >= from && step, NULL);
+	RzCoreAnalysisStats *as = RZ_NEW0(RzCoreAnalysisStats);
+	if (!as) {
+		return NULL;
+	}
+	as->from = from;
+	as->to = to;
+	as->step = step;
+	rz_vector_init(&as->blocks, sizeof(RzCoreAnalysisStatsItem), NULL, NULL);
+	size_t count = (to == UT64_MAX && from == 0) ? rz_num_2_pow_64_div(step) : (to + 1 - from) / step;
+	if (from + count * step != to + 1) {
+		count++;
+	}
+	if (!count || SZT_MUL_OVFCHK(count, sizeof(RzCoreAnalysisStatsItem))) {
+		rz_core_analysis_stats_free(as);
+		return NULL;
+	}
+	RzCoreAnalysisStatsCache *cache = stats_cache_get(core);
+	RzVector *blocks_vec = cache ? &cache->blocks : &as->blocks;
+	bool cached = cache && !rz_vector_empty(&cache->blocks) && cache->from == from && cache->to == to && cache->step == step;
+	if (!cached) {
+		rz_vector_clear(blocks_vec);
+		if (!rz_vector_insert_range(blocks_vec, 0, NULL, count)) {
+			rz_core_analysis_stats_free(as);
+			return NULL;
+		}
+		memset(rz_vector_head(blocks_vec), 0, count * sizeof(RzCoreAnalysisStatsItem));
+	}
+	RzAnalysis *analysis = core->analysis;
+	StatsCtx ctx = {
+		.core = core,
+		.from = from,
+		.to = to,
+		.step = step,
+		.count = count,
+		.blocks = rz_vector_head(blocks_vec),
+	};
+
+	// the maps are looked up for every redraw, their permissions can change without notice
+	stats_perms(core, &ctx);
+	if (!cached || cache->flags_generation != core->flags->generation) {
+		for (size_t i = 0; i < count; i++) {
+			ctx.blocks[i].flags = 0;
+		}
+		rz_flag_foreach_range(core->flags, from, to, block_flags_stat, &ctx);
+	}
+	bool fcns_changed = !cached || cache->fcns_generation != analysis->gen.fcns || cache->bbs_generation != analysis->gen.blocks;
+	if (fcns_changed) {
+		stats_functions(core, &ctx);
+	}
+	RzBinFile *bf = rz_bin_cur(core->bin);
+	const RzList *symbols = rz_bin_get_symbols(core->bin);
+	ut32 symbols_file = bf ? bf->id : UT32_MAX;
+	ut32 symbols_count = symbols ? rz_list_length(symbols) : 0;
+	if (!cached || cache->symbols_file != symbols_file || cache->symbols != symbols || cache->symbols_count != symbols_count) {
+		stats_symbols(core, &ctx, symbols);
+	}
+
+	// basic blocks, strings and comments, only over the addresses touched since the last time if known
+	const RzSpace *meta_space = rz_spaces_current(&analysis->meta_spaces);
+	ctx.bbs = fcns_changed;
+	ctx.meta = !cached || cache->meta_generation != analysis->gen.meta || cache->meta_space != meta_space;
+	size_t lo = 0, hi = count;
+	ut64 dirty_from, dirty_to;
+	if (cached && !(ctx.meta && cache->meta_space != meta_space) &&
+		rz_analysis_dirty_since(analysis, cache->analysis_generation, &dirty_from, &dirty_to)) {
+		lo = dirty_from <= from ? 0 : dirty_from > to ? count : (dirty_from - from) / step;
+		hi = dirty_to > to ? count : dirty_to < from ? 0 : (dirty_to - from) / step + 1;
+	}
+	if ((ctx.bbs || ctx.meta) && lo < hi) {
+		RzThreadTaskPool *pool = hi - lo > STATS_GRAIN ? rz_core_get_task_pool(core) : NULL;
+		if (!pool || !rz_th_task_pool_parallel_for(pool, lo, hi, STATS_GRAIN, stats_range, &ctx)) {
+			stats_range(lo, hi, &ctx);
+		}
+	}
+
+	if (cache) {
+		cache->from = from;
+		cache->to = to;
+		cache->step = step;
+		cache->flags_generation = core->flags->generation;
+		cache->analysis_generation = rz_analysis_generation(analysis);
+		cache->fcns_generation = analysis->gen.fcns;
+		cache->bbs_generation = analysis->gen.blocks;
+		cache->meta_generation = analysis->gen.meta;
+		cache->meta_space = meta_space;
+		cache->symbols_file = symbols_file;
+		cache->symbols = symbols;
+		cache->symbols_count = symbols_count;
+		if (!rz_vector_insert_range(&as->blocks, 0, rz_vector_head(blocks_vec), count)) {
+			rz_core_analysis_stats_free(as);
+			return NULL;
 		}
-		rz_pvector_free(metas);
 	}
 	return as;
 }
@@ -4496,6 +4845,19 @@ static inline bool get_next_i(IterCtx *ctx, size_t *next_i) {
  * \p size number of bytes to analyze
  * \p fcn optional, when analyzing for a specific function
  */
+// stops at the first item marking data
+static bool esil_not_data_meta_cb(RzIntervalNode *node, void *user) {
+	RzAnalysisMetaItem *meta = node->data;
+	switch (meta->type) {
+	case RZ_META_TYPE_DATA:
+	case RZ_META_TYPE_STRING:
+	case RZ_META_TYPE_FORMAT:
+		return false;
+	default:
+		return true;
+	}
+}
+
 RZ_API void rz_core_analysis_esil(RzCore *core, ut64 addr, ut64 size, RZ_NULLABLE RzAnalysisFunction *fcn) {
 	bool cfg_analysis_strings = rz_config_get_i(core->config, "analysis.strings");
 	bool emu_lazy = rz_config_get_i(core->config, "emu.lazy");
@@ -4595,24 +4957,9 @@ RZ_API void rz_core_analysis_esil(RzCore *core, ut64 addr, ut64 size, RZ_NULLABL
 		if (!rz_io_is_valid_offset(core->io, cur, 0)) {
 			break;
 		}
-		{
-			RzPVector *list = rz_meta_get_all_in(core->analysis, cur, RZ_META_TYPE_ANY);
-			void **it;
-			rz_pvector_foreach (list, it) {
-				RzIntervalNode *node = *it;
-				RzAnalysisMetaItem *meta = node->data;
-				switch (meta->type) {
-				case RZ_META_TYPE_DATA:
-				case RZ_META_TYPE_STRING:
-				case RZ_META_TYPE_FORMAT:
-					i += 4;
-					rz_pvector_free(list);
-					goto repeat;
-				default:
-					break;
-				}
-			}
-			rz_pvector_free(list);
+		if (!rz_meta_foreach_in(core->analysis, cur, RZ_META_TYPE_ANY, esil_not_data_meta_cb, NULL)) {
+			i += 4;
+			goto repeat;
 		}
 
 		/* realign address if needed */
@@ -4892,46 +5239,91 @@ static bool stringAt(RzCore *core, ut64 addr) {
 	return is_string(buf + 1, 31, NULL);
 }
 
-RZ_API int rz_core_search_value_in_range(RzCore *core, RzInterval search_itv, ut64 vmin,
-	ut64 vmax, int vsize, inRangeCb cb, void *cb_user) {
-	int i, align = core->search->align, hitctr = 0;
+/*
+ * Values searched by search_values(), the ranges are checked in order so a
+ * value inside several ranges is reported once per range, by increasing
+ * index.
+ */
+typedef struct {
+	ut64 vmin; ///< lowest value of the range
+	ut64 vmax; ///< highest value of the range, included
+} ValueRange;
+
+typedef struct {
+	ut64 addr;
+	ut64 value;
+	size_t range; ///< index of the range holding the value
+	size_t region; ///< index of the region holding addr, set by the caller
+} ValueHit;
+
+typedef void (*ValueHitCb)(RzCore *core, const ValueHit *hit, void *user);
+
+static inline ut64 value_at(const ut8 *p, int vsize) {
+	ut16 v16;
+	ut32 v32;
+	ut64 v64;
+	switch (vsize) {
+	case 1:
+		return *p;
+	case 2:
+		memcpy(&v16, p, sizeof(v16));
+		return v16;
+	case 4:
+		memcpy(&v32, p, sizeof(v32));
+		return v32;
+	default:
+		memcpy(&v64, p, sizeof(v64));
+		return v64;
+	}
+}
+
+/**
+ * \brief Reports the values of \p vsize bytes in \p search_itv falling in any of \p ranges
+ *
+ * The region is read once whatever the number of ranges: most of the words
+ * are rejected by the bounds of all the ranges before looking at each one.
+ *
+ * \return the number of hits, -1 on error
+ */
+static int search_values(RzCore *core, RzInterval search_itv, const ValueRange *ranges, size_t n_ranges, int vsize, ValueHitCb cb, void *user) {
+	int align = core->search->align, hitctr = 0;
 	bool vinfun = rz_config_get_b(core->config, "analysis.vinfun");
 	bool vinfunr = rz_config_get_b(core->config, "analysis.vinfunrange");
-	bool analyze_strings = rz_config_get_b(core->config, "analysis.strings");
 	ut8 buf[4096];
-	ut64 v64, value = 0, size;
+	ut64 size;
 	ut64 from = search_itv.addr, to = rz_itv_end(search_itv);
-	ut32 v32;
-	ut16 v16;
 	if (from >= to) {
 		eprintf("Error: from must be lower than to\n");
 		return -1;
 	}
+	if (vsize != 1 && vsize != 2 && vsize != 4 && vsize != 8) {
+		eprintf("Unknown vsize %d\n", vsize);
+		return -1;
+	}
 	bool maybeThumb = false;
 	if (align && core->analysis->cur && core->analysis->cur->arch) {
 		if (!strcmp(core->analysis->cur->arch, "arm") && core->analysis->bits != 64) {
 			maybeThumb = true;
 		}
 	}
-
-	if (vmin >= vmax) {
-		eprintf("Error: vmin must be lower than vmax\n");
-		return -1;
-	}
 	if (to == UT64_MAX) {
 		eprintf("Error: Invalid destination boundary\n");
 		return -1;
 	}
-	rz_cons_break_push(NULL, NULL);
-
 	if (!rz_io_is_valid_offset(core->io, from, 0)) {
 		return -1;
 	}
+	ut64 lo = UT64_MAX, hi = 0;
+	for (size_t r = 0; r < n_ranges; r++) {
+		lo = RZ_MIN(lo, ranges[r].vmin);
+		hi = RZ_MAX(hi, ranges[r].vmax);
+	}
+	rz_cons_break_push(NULL, NULL);
 	while (from < to) {
 		size = RZ_MIN(to - from, sizeof(buf));
 		memset(buf, 0xff, sizeof(buf)); // probably unnecessary
 		if (rz_cons_is_breaked()) {
-			goto beach;
+			break;
 		}
 		bool res = rz_io_read_at_mapped(core->io, from, buf, size);
 		if (!res || !memcmp(buf, "\xff\xff\xff\xff", 4) || !memcmp(buf, "\x00\x00\x00\x00", 4)) {
@@ -4945,69 +5337,36 @@ RZ_API int rz_core_search_value_in_range(RzCore *core, RzInterval search_itv, ut
 				continue;
 			}
 		}
-		for (i = 0; i <= (size - vsize); i++) {
-			void *v = (buf + i);
+		for (ut64 i = 0; i + vsize <= size; i++) {
 			ut64 addr = from + i;
-			if (rz_cons_is_breaked()) {
-				goto beach;
-			}
 			if (align && (addr) % align) {
 				continue;
 			}
-			int match = false;
-			int left = size - i;
-			if (vsize > left) {
-				break;
-			}
-			switch (vsize) {
-			case 1:
-				value = *(ut8 *)v;
-				match = (buf[i] >= vmin && buf[i] <= vmax);
-				break;
-			case 2:
-				v16 = *(uut16 *)v;
-				match = (v16 >= vmin && v16 <= vmax);
-				value = v16;
-				break;
-			case 4:
-				v32 = *(uut32 *)v;
-				match = (v32 >= vmin && v32 <= vmax);
-				value = v32;
-				break;
-			case 8:
-				v64 = *(uut64 *)v;
-				match = (v64 >= vmin && v64 <= vmax);
-				value = v64;
-				break;
-			default: eprintf("Unknown vsize %d\n", vsize); return -1;
+			ut64 value = value_at(buf + i, vsize);
+			if (value < lo || value > hi || !value) {
+				continue;
 			}
-			if (match && !vinfun) {
-				if (vinfunr) {
-					if (rz_analysis_get_fcn_in_bounds(core->analysis, addr, RZ_ANALYSIS_FCN_TYPE_NULL)) {
-						match = false;
-					}
-				} else {
-					if (rz_analysis_get_fcn_in(core->analysis, addr, RZ_ANALYSIS_FCN_TYPE_NULL)) {
-						match = false;
-					}
-				}
+			if (align && (value % align) && !(maybeThumb && (value & 1))) {
+				// ignored .. unless we are analyzing arm/thumb and lower bit is 1
+				continue;
 			}
-			if (match && value) {
-				bool isValidMatch = true;
-				if (align && (value % align)) {
-					// ignored .. unless we are analyzing arm/thumb and lower bit is 1
-					isValidMatch = false;
-					if (maybeThumb && (value & 1)) {
-						isValidMatch = true;
-					}
+			bool checked_fcn = false;
+			for (size_t r = 0; r < n_ranges; r++) {
+				if (value < ranges[r].vmin || value > ranges[r].vmax) {
+					continue;
 				}
-				if (isValidMatch) {
-					cb(core, addr, value, vsize, cb_user);
-					if (analyze_strings && stringAt(core, addr)) {
-						add_string_ref(core, addr, value);
+				if (!vinfun && !checked_fcn) {
+					checked_fcn = true;
+					RzAnalysisFunction *fcn = vinfunr
+						? rz_analysis_get_fcn_in_bounds(core->analysis, addr, RZ_ANALYSIS_FCN_TYPE_NULL)
+						: rz_analysis_get_fcn_in(core->analysis, addr, RZ_ANALYSIS_FCN_TYPE_NULL);
+					if (fcn) {
+						break;
 					}
-					hitctr++;
 				}
+				ValueHit hit = { .addr = addr, .value = value, .range = r };
+				cb(core, &hit, user);
+				hitctr++;
 			}
 		}
 		if (size == to - from) {
@@ -5015,11 +5374,56 @@ RZ_API int rz_core_search_value_in_range(RzCore *core, RzInterval search_itv, ut
 		}
 		from += size - vsize + 1;
 	}
-beach:
 	rz_cons_break_pop();
 	return hitctr;
 }
 
+typedef struct {
+	inRangeCb cb;
+	void *cb_user;
+	int vsize;
+	bool analyze_strings;
+} ValueHitApply;
+
+static void value_hit_collect(RzCore *core, const ValueHit *hit, void *user) {
+	rz_vector_push(user, (void *)hit);
+}
+
+static int value_hit_cmp(const void *a, const void *b) {
+	const ValueHit *x = a, *y = b;
+	if (x->range != y->range) {
+		return RZ_NUM_CMP(x->range, y->range);
+	}
+	if (x->region != y->region) {
+		return RZ_NUM_CMP(x->region, y->region);
+	}
+	return RZ_NUM_CMP(x->addr, y->addr);
+}
+
+static void value_hit_apply(RzCore *core, const ValueHit *hit, void *user) {
+	ValueHitApply *apply = user;
+	apply->cb(core, hit->addr, hit->value, apply->vsize, apply->cb_user);
+	if (apply->analyze_strings && stringAt(core, hit->addr)) {
+		add_string_ref(core, hit->addr, hit->value);
+	}
+}
+
+RZ_API int rz_core_search_value_in_range(RzCore *core, RzInterval search_itv, ut64 vmin,
+	ut64 vmax, int vsize, inRangeCb cb, void *cb_user) {
+	if (vmin >= vmax) {
+		eprintf("Error: vmin must be lower than vmax\n");
+		return -1;
+	}
+	ValueRange range = { vmin, vmax };
+	ValueHitApply apply = {
+		.cb = cb,
+		.cb_user = cb_user,
+		.vsize = vsize,
+		.analyze_strings = rz_config_get_b(core->config, "analysis.strings"),
+	};
+	return search_values(core, search_itv, &range, 1, vsize, value_hit_apply, &apply);
+}
+
 typedef struct {
 	HtUU *visited;
 	RzList *path;
@@ -5300,6 +5704,8 @@ RZ_API bool rz_core_analysis_function_add(RzCore *core, const char *name, ut64 a
 	RzAnalysisFunction *fcn = NULL;
 
 	// rz_core_analysis_undefine (core, core->offset);
+	// the image holding addr may not have been loaded yet (e.g. in a dyld shared cache)
+	rz_core_bin_load_vaddr(core, addr);
 	rz_core_analysis_fcn(core, addr, UT64_MAX, RZ_ANALYSIS_XREF_TYPE_NULL, depth);
 	fcn = rz_analysis_get_fcn_in(core->analysis, addr, 0);
 	if (fcn) {
@@ -5445,6 +5851,7 @@ RZ_IPI char *rz_core_analysis_function_signature(RzCore *core, RzOutputMode mode
 			pj_k(j, "args");
 			pj_a(j);
 
+			rz_core_analysis_function_vars_ensure(core, fcn);
 			RzAnalysisFcnVarsCache cache;
 			rz_analysis_fcn_vars_cache_init(core->analysis, &cache, fcn);
 			int nargs = 0;
@@ -5559,15 +5966,14 @@ struct core_noretl {
 	SetU *todo;
 };
 
-static bool process_reference_noreturn_cb(void *u, const ut64 k, const void *v) {
-	RzCore *core = ((struct core_noretl *)u)->core;
-	RzList *noretl = ((struct core_noretl *)u)->noretl;
-	SetU *todo = ((struct core_noretl *)u)->todo;
-	RzAnalysisXRef *xref = (RzAnalysisXRef *)v;
+static bool process_reference_noreturn(struct core_noretl *u, const RzAnalysisXRef *xref) {
+	RzCore *core = u->core;
+	RzList *noretl = u->noretl;
+	SetU *todo = u->todo;
 	if (xref->type == RZ_ANALYSIS_XREF_TYPE_CALL || xref->type == RZ_ANALYSIS_XREF_TYPE_CODE) {
 		// At first we check if there are any relocations that override the call address
 		// Note, that the relocation overrides only the part of the instruction
-		ut64 addr = k;
+		ut64 addr = xref->from;
 		ut8 buf[CALL_BUF_SIZE] = { 0 };
 		RzAnalysisOp op = { 0 };
 		if (core->analysis->iob.read_at(core->analysis->iob.io, addr, buf, CALL_BUF_SIZE)) {
@@ -5591,12 +5997,6 @@ static bool process_reference_noreturn_cb(void *u, const ut64 k, const void *v)
 	return true;
 }
 
-static bool process_refs_cb(void *u, const ut64 k, const void *v) {
-	HtUP *ht = (HtUP *)v;
-	ht_up_foreach(ht, process_reference_noreturn_cb, u);
-	return true;
-}
-
 static bool reanalyze_fcns_cb(void *u, const ut64 k, const void *v) {
 	RzCore *core = u;
 	RzAnalysisFunction *fcn = (RzAnalysisFunction *)(size_t)k;
@@ -5618,7 +6018,14 @@ RZ_API void rz_core_analysis_propagate_noreturn_relocs(RzCore *core, ut64 addr)
 	// List of the potentially noreturn functions
 	SetU *todo = set_u_new();
 	struct core_noretl u = { core, noretl, todo };
-	ht_up_foreach(core->analysis->ht_xrefs_to, process_refs_cb, &u);
+	// work on a copy, processing the references may add new ones
+	RzList *xrefs = rz_analysis_xrefs_list(core->analysis);
+	RzListIter *it;
+	RzAnalysisXRef *xref;
+	rz_list_foreach (xrefs, it, xref) {
+		process_reference_noreturn(&u, xref);
+	}
+	rz_list_free(xrefs);
 	rz_list_free(noretl);
 	core->analysis->bits = bits1;
 	core->rasm->bits = bits2;
@@ -5627,24 +6034,104 @@ RZ_API void rz_core_analysis_propagate_noreturn_relocs(RzCore *core, ut64 addr)
 	set_u_free(todo);
 }
 
-RZ_API void rz_core_analysis_propagate_noreturn(RzCore *core, ut64 addr) {
-	RzList *todo = rz_list_newf(free);
-	if (!todo) {
-		return;
+/*
+ * Size of the instruction of \p block at \p addr, taken from the ops of the
+ * block when it has them and decoded otherwise.
+ */
+static ut64 noreturn_call_size(RzCore *core, RzAnalysisBlock *block, ut64 addr) {
+	for (size_t i = 0; i < block->ninstr; i++) {
+		if (rz_analysis_block_get_op_addr(block, i) == addr) {
+			ut64 size = rz_analysis_block_get_op_size(block, i);
+			if (size && size != UT64_MAX) {
+				return size;
+			}
+			break;
+		}
 	}
+	RzAnalysisOp *op = rz_core_op_analysis(core, addr, RZ_ANALYSIS_OP_MASK_BASIC);
+	if (!op) {
+		eprintf("Cannot analyze opcode at 0x%08" PFMT64x "\n", addr);
+		return 0;
+	}
+	ut64 size = op->size;
+	rz_analysis_op_free(op);
+	return size;
+}
 
-	HtUU *done = ht_uu_new0();
-	if (!done) {
-		rz_list_free(todo);
+static void noreturn_mark_dirty(RzPVector *dirty, SetP *seen, RzAnalysisBlock *block) {
+	RzListIter *it;
+	RzAnalysisFunction *f;
+	rz_list_foreach (block->fcns, it, f) {
+		if (!set_p_contains(seen, f)) {
+			set_p_add(seen, f);
+			rz_pvector_push(dirty, f);
+		}
+	}
+}
+
+/*
+ * Chop the blocks of all the calls to the noreturn function at \p noret_addr
+ * and collect the functions containing them into \p dirty, the only ones
+ * which may have become noreturn too.
+ */
+static void noreturn_chop_callers(RzCore *core, RzAnalysisFunction *request_fcn, ut64 noret_addr, RzPVector *dirty) {
+	SetP *seen = set_p_new();
+	RzVector *xrefs = rz_analysis_xrefs_get_to_vec(core->analysis, noret_addr);
+	if (!seen || !xrefs) {
+		set_p_free(seen);
+		rz_vector_free(xrefs);
 		return;
 	}
+	RzAnalysisXRef *xref;
+	rz_vector_foreach(xrefs, xref) {
+		if (xref->type != RZ_ANALYSIS_XREF_TYPE_CALL) {
+			continue;
+		}
+		// Find the block that has an instruction at exactly the xref addr
+		RzAnalysisBlock *block = find_block_at_xref_addr(core, xref->from);
+		if (!block) {
+			continue;
+		}
+		if (request_fcn) {
+			// specific function requested, check if it contains the bb
+			if (rz_list_contains(block->fcns, request_fcn)) {
+				noreturn_mark_dirty(dirty, seen, block);
+			}
+			rz_analysis_block_unref(block);
+			continue;
+		}
+		ut64 size = noreturn_call_size(core, block, xref->from);
+		if (!size) {
+			rz_analysis_block_unref(block);
+			continue;
+		}
+		// rz_analysis_block_chop_noreturn() might free the block!
+		noreturn_mark_dirty(dirty, seen, block);
+		block = rz_analysis_block_chop_noreturn(block, xref->from + size);
+		if (block) {
+			rz_analysis_block_unref(block);
+		}
+	}
+	rz_vector_free(xrefs);
+	set_p_free(seen);
+}
 
+/**
+ * \brief Mark as noreturn the functions which cannot return because of the calls to noreturn functions they make
+ *
+ * Works through a worklist of noreturn functions: for each one the blocks of
+ * its call sites are chopped first, then every function containing them is
+ * checked once, and queued in turn if it became noreturn. Functions not
+ * calling a newly noreturn one are never looked at again. The propagation
+ * stops after analysis.noreturn.budget milliseconds if not 0.
+ *
+ * \param addr address of the only function to update, UT64_MAX for all
+ */
+RZ_API void rz_core_analysis_propagate_noreturn(RzCore *core, ut64 addr) {
 	RzAnalysisFunction *request_fcn = NULL;
 	if (addr != UT64_MAX) {
 		request_fcn = rz_analysis_get_function_at(core->analysis, addr);
 		if (!request_fcn) {
-			rz_list_free(todo);
-			ht_uu_free(done);
 			return;
 		}
 	}
@@ -5653,79 +6140,69 @@ RZ_API void rz_core_analysis_propagate_noreturn(RzCore *core, ut64 addr) {
 	// via the relocations
 	rz_core_analysis_propagate_noreturn_relocs(core, addr);
 
+	RzVector todo;
+	rz_vector_init(&todo, sizeof(ut64), NULL, NULL);
+	RzPVector dirty;
+	rz_pvector_init(&dirty, NULL);
+	SetU *done = set_u_new();
+	if (!done) {
+		return;
+	}
+
 	// find known noreturn functions to propagate
 	RzListIter *iter;
 	RzAnalysisFunction *f;
 	rz_list_foreach (core->analysis->fcns, iter, f) {
 		if (f->is_noreturn) {
-			ut64 *n = ut64_new(f->addr);
-			rz_list_append(todo, n);
+			rz_vector_push(&todo, &f->addr);
+			set_u_add(done, f->addr);
 		}
 	}
-	while (!rz_list_empty(todo)) {
-		ut64 *paddr = (ut64 *)rz_list_pop(todo);
-		ut64 noret_addr = *paddr;
-		free(paddr);
+	ut64 budget = rz_config_get_i(core->config, "analysis.noreturn.budget");
+	ut64 deadline = budget ? rz_time_now_mono() + budget * RZ_USEC_PER_MSEC : UT64_MAX;
+	size_t callees = 0;
+	size_t analyzed = 0;
+	while (!rz_vector_empty(&todo)) {
 		if (rz_cons_is_breaked()) {
 			break;
 		}
-		RzList *xrefs = rz_analysis_xrefs_get_to(core->analysis, noret_addr);
-		RzAnalysisXRef *xref;
-		rz_list_foreach (xrefs, iter, xref) {
-			RzAnalysisOp *xrefop = rz_core_op_analysis(core, xref->from, RZ_ANALYSIS_OP_MASK_ALL);
-			if (!xrefop) {
-				eprintf("Cannot analyze opcode at 0x%08" PFMT64x "\n", xref->from);
-				continue;
-			}
-			ut64 call_addr = xref->from;
-			ut64 chop_addr = call_addr + xrefop->size;
-			rz_analysis_op_free(xrefop);
-			if (xref->type != RZ_ANALYSIS_XREF_TYPE_CALL) {
-				continue;
-			}
-
-			// Find the block that has an instruction at exactly the xref addr
-			RzAnalysisBlock *block = find_block_at_xref_addr(core, call_addr);
-			if (!block) {
+		if (deadline != UT64_MAX && rz_time_now_mono() > deadline) {
+			RZ_LOG_WARN("analysis: noreturn propagation stopped after %" PFMT64u " ms, %" PFMTSZu " functions left\n",
+				budget, rz_vector_len(&todo));
+			break;
+		}
+		ut64 noret_addr;
+		rz_vector_pop(&todo, &noret_addr);
+		callees++;
+		rz_pvector_clear(&dirty);
+		noreturn_chop_callers(core, request_fcn, noret_addr, &dirty);
+		void **it;
+		rz_pvector_foreach (&dirty, it) {
+			f = *it;
+			if (!f->addr || set_u_contains(done, f->addr)) {
 				continue;
 			}
-
-			RzList *block_fcns = rz_list_clone(block->fcns);
-			if (request_fcn) {
-				// specific function requested, check if it contains the bb
-				if (!rz_list_contains(block->fcns, request_fcn)) {
-					goto kontinue;
-				}
-			} else {
-				// rz_analysis_block_chop_noreturn() might free the block!
-				block = rz_analysis_block_chop_noreturn(block, chop_addr);
-			}
-
-			RzListIter *fit;
-			rz_list_foreach (block_fcns, fit, f) {
-				bool found = ht_uu_find(done, f->addr, NULL) != 0;
-				if (f->addr && !found && analyze_noreturn_function(core, f)) {
-					f->is_noreturn = true;
-					rz_analysis_noreturn_add(core->analysis, NULL, f->addr);
-					ut64 *n = malloc(sizeof(ut64));
-					*n = f->addr;
-					rz_list_append(todo, n);
-					ht_uu_insert(done, *n, 1);
-				}
+			analyzed++;
+			if (analyze_noreturn_function(core, f)) {
+				f->is_noreturn = true;
+				rz_analysis_noreturn_add(core->analysis, NULL, f->addr);
+				rz_vector_push(&todo, &f->addr);
+				set_u_add(done, f->addr);
 			}
-		kontinue:
-			if (block) {
-				rz_analysis_block_unref(block);
-			}
-			rz_list_free(block_fcns);
 		}
-		rz_list_free(xrefs);
 	}
-	rz_list_free(todo);
-	ht_uu_free(done);
+	RZ_LOG_DEBUG("analysis: noreturn propagation went through %" PFMTSZu " callees and checked %" PFMTSZu " callers\n",
+		callees, analyzed);
+	rz_pvector_fini(&dirty);
+	rz_vector_fini(&todo);
+	set_u_free(done);
 }
 
 RZ_IPI bool rz_core_analysis_var_rename(RzCore *core, const char *name, const char *newname) {
+	RzAnalysisFunction *fcn = rz_analysis_get_fcn_in(core->analysis, core->offset, -1);
+	if (fcn) {
+		rz_core_analysis_function_vars_ensure(core, fcn);
+	}
 	RzAnalysisOp *op = rz_core_analysis_op(core, core->offset, RZ_ANALYSIS_OP_MASK_BASIC);
 	if (!name) {
 		RzAnalysisVar *var = op ? rz_analysis_get_used_function_var(core->analysis, op->addr) : NULL;
@@ -5737,7 +6214,6 @@ RZ_IPI bool rz_core_analysis_var_rename(RzCore *core, const char *name, const ch
 			return false;
 		}
 	}
-	RzAnalysisFunction *fcn = rz_analysis_get_fcn_in(core->analysis, core->offset, -1);
 	if (fcn) {
 		RzAnalysisVar *v1 = rz_analysis_function_get_var_byname(fcn, name);
 		if (v1) {
@@ -5772,26 +6248,142 @@ static bool is_apple_target(RzCore *core) {
 	return bo ? strstr(bo->plugin->name, "mach") : false;
 }
 
+static void process_usage(ut64 *cpu_time, ut64 *peak_rss) {
+#if __UNIX__
+	struct rusage ru;
+	if (!getrusage(RUSAGE_SELF, &ru)) {
+		*cpu_time = (ut64)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * RZ_USEC_PER_SEC +
+			ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+#if __APPLE__
+		*peak_rss = ru.ru_maxrss;
+#else
+		*peak_rss = (ut64)ru.ru_maxrss * 1024;
+#endif
+		return;
+	}
+#endif
+	*cpu_time = (ut64)clock() * RZ_USEC_PER_SEC / CLOCKS_PER_SEC;
+	*peak_rss = 0;
+}
+
+static st64 analysis_blocks_count(RzAnalysis *analysis) {
+	st64 count = 0;
+	RBIter iter;
+	RzAnalysisBlock *block;
+	rz_rbtree_foreach (analysis->bb_tree, iter, block, RzAnalysisBlock, _rb) {
+		count++;
+	}
+	return count;
+}
+
+// snapshot of the counters, turned into the deltas by analysis_pass_done()
+static void analysis_pass_sample(RzCore *core, RzCoreAnalysisPass *pass) {
+	pass->wall_time = rz_time_now_mono();
+	process_usage(&pass->cpu_time, &pass->peak_rss);
+	pass->functions = rz_list_length(core->analysis->fcns);
+	pass->blocks = analysis_blocks_count(core->analysis);
+	pass->xrefs = rz_analysis_xrefs_count(core->analysis);
+	pass->io_read = core->io->read_bytes;
+}
+
+static void analysis_pass_begin(RzCore *core, RzCoreAnalysisPass *pass, const char *name) {
+	rz_core_notify_begin(core, "%s", name);
+	RZ_TRACE_BEGIN("analysis", name);
+	pass->name = name;
+	analysis_pass_sample(core, pass);
+}
+
+static void analysis_pass_end(RzCore *core, RzCoreAnalysisPass *pass) {
+	RzCoreAnalysisPass now;
+	analysis_pass_sample(core, &now);
+	RZ_TRACE_END("analysis");
+	pass->wall_time = now.wall_time - pass->wall_time;
+	pass->cpu_time = now.cpu_time - pass->cpu_time;
+	pass->peak_rss = now.peak_rss - pass->peak_rss;
+	pass->functions = now.functions - pass->functions;
+	pass->blocks = now.blocks - pass->blocks;
+	pass->xrefs = now.xrefs - pass->xrefs;
+	pass->io_read = now.io_read - pass->io_read;
+	if (core->analysis_passes) {
+		rz_vector_push(core->analysis_passes, pass);
+	}
+}
+
+static void analysis_pass_done(RzCore *core, RzCoreAnalysisPass *pass) {
+	analysis_pass_end(core, pass);
+	rz_core_notify_done(core, "%s", pass->name);
+}
+
 /**
- * Runs all the steps of the deep analysis.
- *
- * Returns true if all steps were finished and false if it was interrupted.
+ * \brief Passes run by the last rz_core_analysis_everything(), see RzCoreAnalysisPass
  *
- * \param core RzCore reference
- * \param experimental Enable more experimental analysis stages ("aaaa" command)
- * \param dh_orig Name of the debug handler, e.g. "esil"
+ * \return vector of RzCoreAnalysisPass owned by \p core, NULL if no aaa ran yet
  */
-RZ_API bool rz_core_analysis_everything(RzCore *core, bool experimental, char *dh_orig) {
+RZ_API RZ_BORROW RzVector /*<RzCoreAnalysisPass>*/ *rz_core_analysis_passes(RZ_NONNULL RzCore *core) {
+	rz_return_val_if_fail(core, NULL);
+	return core->analysis_passes;
+}
+
+/**
+ * \brief Append the passes run by the last rz_core_analysis_everything() to \p pj as an array
+ */
+RZ_API void rz_core_analysis_passes_json(RZ_NONNULL RzCore *core, RZ_NONNULL PJ *pj) {
+	rz_return_if_fail(core && pj);
+	pj_a(pj);
+	if (core->analysis_passes) {
+		RzCoreAnalysisPass *pass;
+		rz_vector_foreach(core->analysis_passes, pass) {
+			pj_o(pj);
+			pj_ks(pj, "name", pass->name);
+			pj_kn(pj, "wall_time", pass->wall_time);
+			pj_kn(pj, "cpu_time", pass->cpu_time);
+			pj_kn(pj, "peak_rss", pass->peak_rss);
+			pj_kN(pj, "functions", pass->functions);
+			pj_kN(pj, "blocks", pass->blocks);
+			pj_kN(pj, "xrefs", pass->xrefs);
+			pj_kn(pj, "io_read", pass->io_read);
+			pj_end(pj);
+		}
+	}
+	pj_end(pj);
+}
+
+static void analysis_passes_log(RzCore *core) {
+	const char *path = rz_config_get(core->config, "analysis.passes.log");
+	if (RZ_STR_ISEMPTY(path)) {
+		return;
+	}
+	PJ *pj = pj_new();
+	if (!pj) {
+		return;
+	}
+	pj_o(pj);
+	pj_kn(pj, "time", rz_time_now() / RZ_USEC_PER_SEC);
+	RzBinFile *bf = rz_bin_cur(core->bin);
+	pj_ks(pj, "file", bf && bf->file ? bf->file : "");
+	pj_k(pj, "passes");
+	rz_core_analysis_passes_json(core, pj);
+	pj_end(pj);
+	char *line = rz_str_newf("%s\n", pj_string(pj));
+	if (!line || !rz_file_dump(path, (const ut8 *)line, strlen(line), true)) {
+		RZ_LOG_ERROR("core: cannot append the analysis passes to %s\n", path);
+	}
+	free(line);
+	pj_free(pj);
+}
+
+static bool analysis_everything(RzCore *core, bool experimental, char *dh_orig) {
 	bool didAap = false;
-	const char *notify = NULL;
+	RzCoreAnalysisPass pass;
 	ut64 curseek = core->offset;
 	bool cfg_debug = rz_config_get_b(core->config, "cfg.debug");
 	bool plugin_supports_esil = core->analysis->cur->esil;
 	if (rz_str_startswith(rz_config_get(core->config, "bin.lang"), "go")) {
-		rz_core_notify_done(core, "Find function and symbol names from golang binaries");
+		analysis_pass_begin(core, &pass, "Find function and symbol names from golang binaries");
 		if (rz_core_analysis_recover_golang_functions(core)) {
 			rz_core_analysis_resolve_golang_strings(core);
 		}
+		analysis_pass_done(core, &pass);
 	}
 	rz_core_task_yield(&core->tasks);
 	if (!cfg_debug) {
@@ -5808,49 +6400,44 @@ RZ_API bool rz_core_analysis_everything(RzCore *core, bool experimental, char *d
 		return false;
 	}
 
-	notify = "Analyze function calls";
-	rz_core_notify_begin(core, "%s", notify);
+	analysis_pass_begin(core, &pass, "Analyze function calls");
 	(void)rz_core_analysis_calls(core, false); // "aac"
 	rz_core_seek(core, curseek, true);
-	rz_core_notify_done(core, "%s", notify);
+	analysis_pass_done(core, &pass);
 	rz_core_task_yield(&core->tasks);
 	if (rz_cons_is_breaked()) {
 		return false;
 	}
 
 	if (is_unknown_file(core)) {
-		notify = "find and analyze function preludes";
-		rz_core_notify_begin(core, "%s", notify);
+		analysis_pass_begin(core, &pass, "find and analyze function preludes");
 		(void)rz_core_search_preludes(core, false); // "aap"
 		didAap = true;
-		rz_core_notify_done(core, "%s", notify);
+		analysis_pass_done(core, &pass);
 		rz_core_task_yield(&core->tasks);
 		if (rz_cons_is_breaked()) {
 			return false;
 		}
 	}
 
-	notify = "Analyze len bytes of instructions for references";
-	rz_core_notify_begin(core, "%s", notify);
+	analysis_pass_begin(core, &pass, "Analyze len bytes of instructions for references");
 	(void)rz_core_analysis_refs(core, 0); // "aar"
-	rz_core_notify_done(core, "%s", notify);
+	analysis_pass_done(core, &pass);
 	rz_core_task_yield(&core->tasks);
 	if (rz_cons_is_breaked()) {
 		return false;
 	}
 
 	if (is_apple_target(core)) {
-		notify = "Check for objc references";
-		rz_core_notify_begin(core, "%s", notify);
+		analysis_pass_begin(core, &pass, "Check for objc references");
 		cmd_analysis_objc(core, true);
-		rz_core_notify_done(core, "%s", notify);
+		analysis_pass_done(core, &pass);
 	}
 	rz_core_task_yield(&core->tasks);
 
-	notify = "Check for classes";
-	rz_core_notify_begin(core, "%s", notify);
+	analysis_pass_begin(core, &pass, "Check for classes");
 	rz_analysis_class_recover_all(core->analysis);
-	rz_core_notify_done(core, "%s", notify);
+	analysis_pass_done(core, &pass);
 	rz_core_task_yield(&core->tasks);
 
 	rz_config_set_i(core->config, "analysis.calls", c);
@@ -5864,12 +6451,11 @@ RZ_API bool rz_core_analysis_everything(RzCore *core, bool experimental, char *d
 		rz_core_task_yield(&core->tasks);
 		bool pcache = rz_config_get_b(core->config, "io.pcache");
 		rz_config_set_b(core->config, "io.pcache", false);
-		notify = "Emulate functions to find computed references";
-		rz_core_notify_begin(core, "%s", notify);
+		analysis_pass_begin(core, &pass, "Emulate functions to find computed references");
 		if (plugin_supports_esil) {
 			rz_core_analysis_esil_references_all_functions(core);
 		}
-		rz_core_notify_done(core, "%s", notify);
+		analysis_pass_done(core, &pass);
 		rz_core_task_yield(&core->tasks);
 		rz_config_set_b(core->config, "io.pcache", pcache);
 		if (rz_cons_is_breaked()) {
@@ -5878,17 +6464,15 @@ RZ_API bool rz_core_analysis_everything(RzCore *core, bool experimental, char *d
 	}
 
 	if (rz_config_get_i(core->config, "analysis.autoname")) {
-		notify = "Speculatively constructing a function name "
-			 "for fcn.* and sym.func.* functions (aan)";
-		rz_core_notify_begin(core, "%s", notify);
+		analysis_pass_begin(core, &pass, "Speculatively constructing a function name "
+			 "for fcn.* and sym.func.* functions (aan)");
 		rz_core_analysis_autoname_all_fcns(core);
-		rz_core_notify_done(core, "%s", notify);
+		analysis_pass_done(core, &pass);
 		rz_core_task_yield(&core->tasks);
 	}
 
 	if (core->analysis->opt.vars) {
-		notify = "Analyze local variables and arguments";
-		rz_core_notify_begin(core, "%s", notify);
+		analysis_pass_begin(core, &pass, "Analyze local variables and arguments");
 		RzAnalysisFunction *fcni;
 		RzListIter *iter;
 		rz_list_foreach (core->analysis->fcns, iter, fcni) {
@@ -5901,56 +6485,52 @@ RZ_API bool rz_core_analysis_everything(RzCore *core, bool experimental, char *d
 				continue;
 			}
 			// extract only reg based var here
-			rz_core_recover_vars(core, fcni, true);
+			recover_vars_or_defer(core, fcni);
 			rz_list_free(list);
 		}
-		rz_core_notify_done(core, "%s", notify);
+		analysis_pass_done(core, &pass);
 		rz_core_task_yield(&core->tasks);
 	}
 
 	if (plugin_supports_esil) {
-		notify = "Type matching analysis for all functions";
-		rz_core_notify_begin(core, "%s", notify);
+		analysis_pass_begin(core, &pass, "Type matching analysis for all functions");
 		rz_core_analysis_types_propagation(core);
-		rz_core_notify_done(core, "%s", notify);
+		analysis_pass_done(core, &pass);
 		rz_core_task_yield(&core->tasks);
 	}
 
 	if (rz_config_get_b(core->config, "analysis.apply.signature")) {
 		int n_applied = 0;
-		rz_core_notify_begin(core, "Applying signatures from sigdb");
+		analysis_pass_begin(core, &pass, "Applying signatures from sigdb");
 		rz_core_analysis_sigdb_apply(core, &n_applied, NULL);
+		analysis_pass_end(core, &pass);
 		rz_core_notify_done(core, "Applied %d FLIRT signatures via sigdb", n_applied);
 		rz_core_task_yield(&core->tasks);
 	}
 
-	notify = "Propagate noreturn information";
-	rz_core_notify_begin(core, "%s", notify);
+	analysis_pass_begin(core, &pass, "Propagate noreturn information");
 	rz_core_analysis_propagate_noreturn(core, UT64_MAX);
-	rz_core_notify_done(core, "%s", notify);
+	analysis_pass_done(core, &pass);
 	rz_core_task_yield(&core->tasks);
 
 	// Apply DWARF function information
 	Sdb *dwarf_sdb = sdb_ns(core->analysis->sdb, "dwarf", 0);
 	if (dwarf_sdb) {
-		notify = "Integrate dwarf function information.";
-		rz_core_notify_begin(core, "%s", notify);
+		analysis_pass_begin(core, &pass, "Integrate dwarf function information.");
 		rz_analysis_dwarf_integrate_functions(core->analysis, core->flags, dwarf_sdb);
-		rz_core_notify_done(core, "%s", notify);
+		analysis_pass_done(core, &pass);
 	}
 
 	if (experimental) {
 		if (!didAap) {
-			notify = "Finding function preludes";
-			rz_core_notify_begin(core, "%s", notify);
+			analysis_pass_begin(core, &pass, "Finding function preludes");
 			(void)rz_core_search_preludes(core, false); // "aap"
-			rz_core_notify_done(core, "%s", notify);
+			analysis_pass_done(core, &pass);
 			rz_core_task_yield(&core->tasks);
 		}
-		notify = "Enable constraint types analysis for variables";
-		rz_core_notify_begin(core, "%s", notify);
+		analysis_pass_begin(core, &pass, "Enable constraint types analysis for variables");
 		rz_config_set(core->config, "analysis.types.constraint", "true");
-		rz_core_notify_done(core, "%s", notify);
+		analysis_pass_done(core, &pass);
 	} else {
 		rz_core_notify_done(core, "Use -AA or aaaa to perform additional experimental analysis.");
 	}
@@ -5968,6 +6548,246 @@ RZ_API bool rz_core_analysis_everything(RzCore *core, bool experimental, char *d
 	return true;
 }
 
+/**
+ * Path of the analysis.opcache file of the current binary in analysis.opcache.dir,
+ * named after the sha256 of its contents
+ */
+static char *analysis_opcache_path(RzCore *core) {
+	const char *dir = rz_config_get(core->config, "analysis.opcache.dir");
+	if (!core->analysis->op_cache.enabled || RZ_STR_ISEMPTY(dir)) {
+		return NULL;
+	}
+	RzBinFile *bf = rz_bin_cur(core->bin);
+	if (!bf || !bf->o) {
+		return NULL;
+	}
+	RzList *hashes = rz_bin_file_compute_hashes(core->bin, bf, rz_config_get_i(core->config, "bin.hashlimit"));
+	RzListIter *it;
+	RzBinFileHash *h;
+	char *path = NULL;
+	rz_list_foreach (hashes, it, h) {
+		if (!strcmp(h->type, "sha256")) {
+			char *name = rz_str_newf("%s.opcache", h->hex);
+			path = name ? rz_file_path_join(dir, name) : NULL;
+			free(name);
+			break;
+		}
+	}
+	rz_list_free(hashes);
+	return path;
+}
+
+/**
+ * Runs all the steps of the deep analysis.
+ *
+ * Returns true if all steps were finished and false if it was interrupted.
+ *
+ * \param core RzCore reference
+ * \param experimental Enable more experimental analysis stages ("aaaa" command)
+ * \param dh_orig Name of the debug handler, e.g. "esil"
+ */
+RZ_API bool rz_core_analysis_everything(RzCore *core, bool experimental, char *dh_orig) {
+	rz_return_val_if_fail(core, false);
+	if (core->analysis_passes) {
+		rz_vector_clear(core->analysis_passes);
+	} else {
+		core->analysis_passes = rz_vector_new(sizeof(RzCoreAnalysisPass), NULL, NULL);
+	}
+	char *opcache_path = analysis_opcache_path(core);
+	if (opcache_path) {
+		rz_analysis_op_cache_load(core->analysis, opcache_path);
+	}
+	bool done = analysis_everything(core, experimental, dh_orig);
+	if (opcache_path) {
+		const char *dir = rz_config_get(core->config, "analysis.opcache.dir");
+		if (!rz_sys_mkdirp(dir) || !rz_analysis_op_cache_save(core->analysis, opcache_path)) {
+			RZ_LOG_WARN("Cannot save the analysis.opcache to %s\n", opcache_path);
+		}
+		free(opcache_path);
+	}
+	analysis_passes_log(core);
+	return done;
+}
+
+static const char *triage_import_name(RzFlagItem *f) {
+	if (rz_str_startswith(f->name, "sym.imp.")) {
+		return f->name + strlen("sym.imp.");
+	}
+	if (rz_str_startswith(f->name, "reloc.")) {
+		return f->name + strlen("reloc.");
+	}
+	return f->name;
+}
+
+static int triage_name_cmp(const void *a, const void *b) {
+	return strcmp(a, b);
+}
+
+/**
+ * \brief Print the triage record of \p fcn to \p pj
+ *
+ * The record holds the boundaries of the function, its calls, the imports
+ * it calls or references and the strings it references.
+ */
+RZ_API void rz_core_analysis_function_triage_json(RZ_NONNULL RzCore *core, RZ_NONNULL RzAnalysisFunction *fcn, RZ_NONNULL PJ *pj) {
+	rz_return_if_fail(core && fcn && pj);
+	pj_o(pj);
+	pj_ks(pj, "name", fcn->name);
+	pj_kn(pj, "addr", fcn->addr);
+	pj_kn(pj, "minaddr", rz_analysis_function_min_addr(fcn));
+	pj_kn(pj, "maxaddr", rz_analysis_function_max_addr(fcn));
+	pj_kn(pj, "size", rz_analysis_function_linear_size(fcn));
+	pj_kn(pj, "nbbs", rz_list_length(fcn->bbs));
+	pj_kb(pj, "noreturn", fcn->is_noreturn);
+
+	RzVector *xrefs = rz_analysis_function_get_xrefs_from_vec(fcn);
+	RzPVector imports;
+	rz_pvector_init(&imports, NULL);
+	RzAnalysisXRef *xref;
+	pj_ka(pj, "calls");
+	if (xrefs) {
+		rz_vector_foreach(xrefs, xref) {
+			RzFlagItem *imp = rz_flag_get_by_spaces(core->flags, xref->to, RZ_FLAGS_FS_IMPORTS, RZ_FLAGS_FS_RELOCS, NULL);
+			if (imp) {
+				rz_pvector_push(&imports, (void *)triage_import_name(imp));
+			}
+			if (xref->type != RZ_ANALYSIS_XREF_TYPE_CALL) {
+				continue;
+			}
+			RzAnalysisFunction *callee = rz_analysis_get_function_at(core->analysis, xref->to);
+			RzFlagItem *f = callee ? NULL : rz_flag_get_i(core->flags, xref->to);
+			pj_o(pj);
+			pj_kn(pj, "from", xref->from);
+			pj_kn(pj, "to", xref->to);
+			if (callee || f) {
+				pj_ks(pj, "name", callee ? callee->name : f->name);
+			}
+			pj_end(pj);
+		}
+	}
+	pj_end(pj);
+
+	pj_ka(pj, "imports");
+	rz_pvector_sort(&imports, triage_name_cmp);
+	const char *last = NULL;
+	void **it;
+	rz_pvector_foreach (&imports, it) {
+		const char *name = *it;
+		if (!last || strcmp(last, name)) {
+			pj_s(pj, name);
+		}
+		last = name;
+	}
+	pj_end(pj);
+	rz_pvector_fini(&imports);
+
+	pj_ka(pj, "strings");
+	if (xrefs) {
+		rz_vector_foreach(xrefs, xref) {
+			if (xref->type != RZ_ANALYSIS_XREF_TYPE_DATA && xref->type != RZ_ANALYSIS_XREF_TYPE_STRING) {
+				continue;
+			}
+			const char *str = rz_meta_get_string(core->analysis, RZ_META_TYPE_STRING, xref->to);
+			if (!str) {
+				continue;
+			}
+			pj_o(pj);
+			pj_kn(pj, "from", xref->from);
+			pj_kn(pj, "to", xref->to);
+			pj_ks(pj, "string", str);
+			pj_end(pj);
+		}
+	}
+	pj_end(pj);
+	rz_vector_free(xrefs);
+	pj_end(pj);
+}
+
+/**
+ * Drop what a function holds beyond its name and entrypoint once its
+ * triage record was printed
+ */
+static void triage_discard(RzAnalysisFunction *fcn) {
+	rz_analysis_function_delete_all_vars(fcn);
+	while (!rz_list_empty(fcn->bbs)) {
+		rz_analysis_function_remove_block(fcn, rz_list_first(fcn->bbs));
+	}
+}
+
+/**
+ * \brief Quick analysis for triage, printing a line of JSON per function
+ *
+ * Only the functions reachable from the symbols, the entrypoints and the
+ * calls are analyzed (like aa and aac), without variables, types, emulation
+ * or signatures. Once they are all found, the record of each function (see
+ * rz_core_analysis_function_triage_json()) is printed on its own line and
+ * written out as the output grows (see scr.stream).
+ *
+ * \param discard drop the basic blocks and variables of each function after printing it, so that memory does not grow with the records
+ * \return false if the analysis was interrupted
+ */
+RZ_API bool rz_core_analysis_triage(RZ_NONNULL RzCore *core, bool discard) {
+	rz_return_val_if_fail(core, false);
+	if (core->analysis_passes) {
+		rz_vector_clear(core->analysis_passes);
+	} else {
+		core->analysis_passes = rz_vector_new(sizeof(RzCoreAnalysisPass), NULL, NULL);
+	}
+	bool vars = rz_config_get_b(core->config, "analysis.vars");
+	int calls = rz_config_get_i(core->config, "analysis.calls");
+	rz_config_set_b(core->config, "analysis.vars", false);
+	rz_config_set_i(core->config, "analysis.calls", 1);
+	ut64 offset = core->offset;
+	bool done = false;
+	RzCoreAnalysisPass pass;
+
+	analysis_pass_begin(core, &pass, "Analyze all flags starting with sym. and entry0 (aa)");
+	rz_core_analysis_all(core);
+	analysis_pass_done(core, &pass);
+	rz_core_task_yield(&core->tasks);
+	if (rz_cons_is_breaked()) {
+		goto beach;
+	}
+
+	analysis_pass_begin(core, &pass, "Analyze function calls");
+	rz_core_analysis_calls(core, false);
+	analysis_pass_done(core, &pass);
+	rz_core_task_yield(&core->tasks);
+	if (rz_cons_is_breaked()) {
+		goto beach;
+	}
+
+	// a call found later may split any function, so they are only final now
+	analysis_pass_begin(core, &pass, "Print the function records");
+	RzListIter *iter;
+	RzAnalysisFunction *fcn;
+	rz_list_foreach (core->analysis->fcns, iter, fcn) {
+		if (rz_cons_is_breaked()) {
+			break;
+		}
+		PJ *pj = pj_new();
+		if (!pj) {
+			break;
+		}
+		rz_core_analysis_function_triage_json(core, fcn, pj);
+		rz_cons_println(pj_string(pj));
+		pj_free(pj);
+		rz_cons_flush_stream();
+		if (discard) {
+			triage_discard(fcn);
+		}
+	}
+	analysis_pass_end(core, &pass);
+	done = !rz_cons_is_breaked();
+
+beach:
+	rz_core_seek(core, offset, true);
+	rz_config_set_b(core->config, "analysis.vars", vars);
+	rz_config_set_i(core->config, "analysis.calls", calls);
+	analysis_passes_log(core);
+	return done;
+}
+
 static void analysis_sigdb_add(RzSigDb *sigs, const char *path, bool with_details) {
 	if (RZ_STR_ISEMPTY(path) || !rz_file_is_directory(path)) {
 		return;
@@ -6046,6 +6866,21 @@ RZ_API void rz_core_analysis_sigdb_print(RZ_NONNULL RzCore *core, RZ_NONNULL RzT
 	rz_list_free(sigdb);
 }
 
+typedef struct {
+	RzSigDBEntry **sigs;
+	RzFlirtNode **nodes;
+	ut8 arch_id;
+} SigdbParseCtx;
+
+static void sigdb_parse_range(size_t from, size_t to, void *user) {
+	SigdbParseCtx *ctx = user;
+	for (size_t i = from; i < to; i++) {
+		if (!ctx->nodes[i]) {
+			ctx->nodes[i] = rz_sign_flirt_parse_file(ctx->sigs[i]->file_path, ctx->arch_id);
+		}
+	}
+}
+
 /**
  * \brief tries to apply the signatures in the flirt.sigdb.path
  *
@@ -6063,6 +6898,7 @@ RZ_API bool rz_core_analysis_sigdb_apply(RZ_NONNULL RzCore *core, RZ_NULLABLE in
 	RzList *sigdb = NULL;
 	RzListIter *iter = NULL;
 	RzBinObject *obj = NULL;
+	RzBinLanguage lang = RZ_BIN_LANGUAGE_UNKNOWN;
 
 	int n_flags_new, n_flags_old;
 	ut8 arch_id = RZ_FLIRT_SIG_ARCH_ANY;
@@ -6079,6 +6915,7 @@ RZ_API bool rz_core_analysis_sigdb_apply(RZ_NONNULL RzCore *core, RZ_NULLABLE in
 		} else {
 			bin = obj->plugin->name;
 		}
+		lang = rz_bin_object_get_language(obj);
 	}
 
 	arch = rz_config_get(core->config, "asm.arch");
@@ -6094,33 +6931,62 @@ RZ_API bool rz_core_analysis_sigdb_apply(RZ_NONNULL RzCore *core, RZ_NULLABLE in
 		return false;
 	}
 
-	n_flags_old = rz_flag_count(core->flags, "flirt");
+	RzPVector selected;
+	rz_pvector_init(&selected, NULL);
 	rz_list_foreach (sigdb, iter, sig) {
-		if (rz_cons_is_breaked()) {
-			break;
-		}
 		if (RZ_STR_ISEMPTY(filter)) {
 			// apply signatures automatically based on bin, arch and bits
 			if (strcmp(bin, sig->bin_name) || strcmp(arch, sig->arch_name) || bits != sig->arch_bits) {
 				continue;
 			} else if (strstr(sig->base_name, "c++") &&
-				obj->lang != RZ_BIN_LANGUAGE_CXX &&
-				obj->lang != RZ_BIN_LANGUAGE_RUST) {
+				lang != RZ_BIN_LANGUAGE_CXX &&
+				lang != RZ_BIN_LANGUAGE_RUST) {
 				// C++ libs can create many false positives, especially on C binaries.
 				// So their usage is limited to C++ and RUST lang
 				continue;
 			}
-			RZ_LOG_INFO("Applying %s signature file\n", sig->short_path);
-		} else {
+		} else if (!strstr(sig->short_path, filter)) {
 			// apply signatures based on filter value
-			if (!strstr(sig->short_path, filter)) {
-				continue;
+			continue;
+		}
+		rz_pvector_push(&selected, sig);
+	}
+
+	// the files of a group are parsed in parallel, then applied in order
+	RzThreadTaskPool *pool = rz_core_get_task_pool(core);
+	SigdbParseCtx ctx = { .arch_id = arch_id };
+	size_t group = pool ? rz_th_task_pool_size(pool) : 1;
+	ctx.nodes = RZ_NEWS0(RzFlirtNode *, group);
+	n_flags_old = rz_flag_count(core->flags, "flirt");
+	for (size_t from = 0; ctx.nodes && from < rz_pvector_len(&selected) && !rz_cons_is_breaked(); from += group) {
+		ctx.sigs = (RzSigDBEntry **)rz_pvector_data(&selected) + from;
+		size_t count = RZ_MIN(group, rz_pvector_len(&selected) - from);
+		if (!pool || (!rz_th_task_pool_parallel_for(pool, 0, count, 1, sigdb_parse_range, &ctx) && !rz_cons_is_breaked())) {
+			// only the files the pool did not get to are left
+			sigdb_parse_range(0, count, &ctx);
+		}
+		for (size_t i = 0; i < count; i++) {
+			sig = ctx.sigs[i];
+			if (rz_cons_is_breaked()) {
+				break;
+			}
+			if (RZ_STR_ISEMPTY(filter)) {
+				RZ_LOG_INFO("Applying %s signature file\n", sig->short_path);
+			} else {
+				rz_cons_printf("Applying %s/%s/%u/%s signature file\n",
+					sig->bin_name, sig->arch_name, sig->arch_bits, sig->base_name);
+			}
+			if (ctx.nodes[i] && !rz_sign_flirt_apply_node(core->analysis, ctx.nodes[i], pool)) {
+				RZ_LOG_ERROR("FLIRT: Error while scanning the file %s\n", sig->file_path);
 			}
-			rz_cons_printf("Applying %s/%s/%u/%s signature file\n",
-				sig->bin_name, sig->arch_name, sig->arch_bits, sig->base_name);
 		}
-		rz_sign_flirt_apply(core->analysis, sig->file_path, arch_id);
+		for (size_t i = 0; i < count; i++) {
+			rz_sign_flirt_node_free(ctx.nodes[i]);
+			ctx.nodes[i] = NULL;
+		}
 	}
+	free(ctx.nodes);
+	rz_pvector_fini(&selected);
 	rz_list_free(sigdb);
 	n_flags_new = rz_flag_count(core->flags, "flirt");
 
@@ -6322,7 +7188,7 @@ RZ_API bool rz_analysis_add_device_peripheral_map(RzBinObject *o, RzAnalysis *an
 	return true;
 }
 
-RZ_IPI bool rz_core_analysis_types_propagation(RzCore *core) {
+static bool types_propagation(RzCore *core, RzList /*<RzAnalysisFunction *>*/ *fcns) {
 	RzListIter *it;
 	RzAnalysisFunction *fcn;
 	ut64 seek;
@@ -6349,21 +7215,30 @@ RZ_IPI bool rz_core_analysis_types_propagation(RzCore *core) {
 	// TODO : figure out the reason to hold a `LOOP COUNT` in type_match
 	// HtUU <addr->loop_count>
 	HtUU *loop_table = ht_uu_new0();
+	// set up once for all functions, the registers are the same for all of them
+	RzCoreTypeMatchEmul *emul = core->analysis->esil ? rz_core_analysis_type_match_emul_begin(core) : NULL;
+	if (!core->analysis->esil) {
+		eprintf("Please run aeim\n");
+	}
 
 	// Iterating Reverse so that we get function in top-bottom call order
-	rz_list_foreach_prev(core->analysis->fcns, it, fcn) {
-		int ret = rz_core_seek(core, fcn->addr, true);
+	rz_list_foreach_prev(fcns, it, fcn) {
+		// only the seek for the emulation, the history gets the original seek back at the end
+		int ret = rz_core_seek(core, fcn->addr, false);
 		if (!ret) {
 			continue;
 		}
-		rz_reg_arena_poke(core->analysis->reg, saved_arena);
-		rz_analysis_esil_set_pc(core->analysis->esil, fcn->addr);
-		rz_core_analysis_type_match(core, fcn, loop_table);
+		if (emul) {
+			rz_reg_arena_poke(core->analysis->reg, saved_arena);
+			rz_analysis_esil_set_pc(core->analysis->esil, fcn->addr);
+			rz_core_analysis_type_match_emul(core, emul, fcn, loop_table);
+		}
 		if (rz_cons_is_breaked()) {
 			break;
 		}
 		rz_analysis_fcn_vars_add_types(core->analysis, fcn);
 	}
+	rz_core_analysis_type_match_emul_end(core, emul);
 	if (delete_regs) {
 		rz_core_debug_clear_register_flags(core);
 	}
@@ -6377,6 +7252,86 @@ RZ_IPI bool rz_core_analysis_types_propagation(RzCore *core) {
 	return true;
 }
 
+RZ_IPI bool rz_core_analysis_types_propagation(RzCore *core) {
+	return types_propagation(core, core->analysis->fcns);
+}
+
+/**
+ * \brief Runs the type propagation again only in the functions touched by writes, see rz_core_analysis_update_written()
+ */
+RZ_IPI bool rz_core_analysis_types_propagation_dirty(RzCore *core) {
+	if (!core->analysis_dirty_fcns || !core->analysis_dirty_fcns->count) {
+		return true;
+	}
+	RzList *fcns = rz_list_new();
+	if (!fcns) {
+		return false;
+	}
+	RzListIter *it;
+	RzAnalysisFunction *fcn;
+	// keep the order of analysis->fcns, functions deleted since the write are gone from it
+	rz_list_foreach (core->analysis->fcns, it, fcn) {
+		if (set_u_contains(core->analysis_dirty_fcns, fcn->addr)) {
+			rz_list_append(fcns, fcn);
+		}
+	}
+	RZ_FREE_CUSTOM(core->analysis_dirty_fcns, set_u_free);
+	bool ret = types_propagation(core, fcns);
+	rz_list_free(fcns);
+	return ret;
+}
+
+static void mark_dirty_blocks(RzCore *core, RzList /*<RzAnalysisBlock *>*/ *blocks, bool modified_only, ut64 *from, ut64 *to) {
+	RzListIter *it, *it2;
+	RzAnalysisBlock *bb;
+	RzAnalysisFunction *fcn;
+	rz_list_foreach (blocks, it, bb) {
+		if (modified_only && !rz_analysis_block_was_modified(bb)) {
+			continue;
+		}
+		*from = RZ_MIN(*from, bb->addr);
+		*to = RZ_MAX(*to, bb->addr + bb->size);
+		rz_list_foreach (bb->fcns, it2, fcn) {
+			set_u_add(core->analysis_dirty_fcns, fcn->addr);
+		}
+	}
+}
+
+/**
+ * \brief Updates the analysis after \p len bytes have been written at \p addr
+ *
+ * The modified blocks are analyzed again by rz_analysis_update_analysis_range().
+ * With analysis.detectwrites.deps, the xrefs going out of these blocks are also
+ * searched again and their functions are recorded so that `aafu` only runs the
+ * type propagation on them, instead of a whole `aaa`.
+ */
+RZ_IPI void rz_core_analysis_update_written(RzCore *core, ut64 addr, int len) {
+	RzAnalysis *analysis = core->analysis;
+	if (len < 1 || !rz_config_get_b(core->config, "analysis.detectwrites.deps")) {
+		rz_analysis_update_analysis_range(analysis, addr, len);
+		return;
+	}
+	if (!core->analysis_dirty_fcns && !(core->analysis_dirty_fcns = set_u_new())) {
+		rz_analysis_update_analysis_range(analysis, addr, len);
+		return;
+	}
+	ut64 from = UT64_MAX, to = 0;
+	RzList *blocks = rz_analysis_get_blocks_intersect(analysis, addr, len);
+	mark_dirty_blocks(core, blocks, true, &from, &to);
+	rz_list_free(blocks);
+	rz_analysis_update_analysis_range(analysis, addr, len);
+	if (from >= to) {
+		// no code was modified
+		return;
+	}
+	// the blocks analyzed again may extend past the old ones
+	blocks = rz_analysis_get_blocks_intersect(analysis, from, to - from);
+	mark_dirty_blocks(core, blocks, false, &from, &to);
+	rz_list_free(blocks);
+	rz_analysis_xrefs_del_from_range(analysis, from, to);
+	rz_core_analysis_search_xrefs(core, from, to);
+}
+
 RZ_IPI bool rz_core_analysis_function_set_signature(RzCore *core, RzAnalysisFunction *fcn, const char *newsig) {
 	bool res = false;
 	char *fcnname = NULL;
@@ -6412,6 +7367,7 @@ RZ_IPI void rz_core_analysis_function_signature_editor(RzCore *core, ut64 addr)
 		eprintf("Cannot find function in 0x%08" PFMT64x "\n", core->offset);
 		return;
 	}
+	rz_core_analysis_function_vars_ensure(core, f);
 
 	char *sig = rz_analysis_function_get_signature(f);
 	char *data = rz_core_editor(core, NULL, sig);
@@ -6542,12 +7498,46 @@ RZ_IPI void rz_core_analysis_value_pointers(RzCore *core, RzOutputMode mode) {
 		RzIOMap *map, *map2;
 		ut64 from = UT64_MAX;
 		ut64 to = UT64_MAX;
-		// find values pointing to non-executable regions
+		// every region is read once for the values pointing in any map
+		RzVector ranges, hits;
+		rz_vector_init(&ranges, sizeof(ValueRange), NULL, NULL);
+		rz_vector_init(&hits, sizeof(ValueHit), NULL, NULL);
+		rz_list_foreach (list, iter2, map2) {
+			from = rz_itv_begin(map2->itv);
+			to = rz_itv_end(map2->itv);
+			if ((to - from) <= MAX_SCAN_SIZE && from < to) {
+				ValueRange range = { from, to };
+				rz_vector_push(&ranges, &range);
+			}
+		}
+		size_t region = 0;
+		rz_list_foreach (list, iter, map) {
+			if (rz_cons_is_breaked()) {
+				break;
+			}
+			size_t first = rz_vector_len(&hits);
+			if (rz_itv_size(map->itv) <= UT32_MAX && !rz_vector_empty(&ranges)) {
+				(void)search_values(core, map->itv, rz_vector_index_ptr(&ranges, 0), rz_vector_len(&ranges), vsize, value_hit_collect, &hits);
+			}
+			for (size_t i = first; i < rz_vector_len(&hits); i++) {
+				ValueHit *hit = rz_vector_index_ptr(&hits, i);
+				hit->region = region;
+			}
+			region++;
+		}
+		// apply them in the order of a search per map and region
+		rz_vector_sort(&hits, value_hit_cmp, false);
+		ValueHitApply apply = {
+			.cb = _CbInRangeAav,
+			.cb_user = (void *)&mode,
+			.vsize = vsize,
+			.analyze_strings = rz_config_get_b(core->config, "analysis.strings"),
+		};
+		size_t range = 0, next = 0;
 		rz_list_foreach (list, iter2, map2) {
 			if (rz_cons_is_breaked()) {
 				break;
 			}
-			// TODO: Reduce multiple hits for same addr
 			from = rz_itv_begin(map2->itv);
 			to = rz_itv_end(map2->itv);
 			if ((to - from) > MAX_SCAN_SIZE) {
@@ -6555,6 +7545,7 @@ RZ_IPI void rz_core_analysis_value_pointers(RzCore *core, RzOutputMode mode) {
 				continue;
 			}
 			rz_core_notify_done(core, "Value from 0x%08" PFMT64x " to 0x%08" PFMT64x " (aav)", from, to);
+			region = 0;
 			rz_list_foreach (list, iter, map) {
 				ut64 begin = map->itv.addr;
 				ut64 end = rz_itv_end(map->itv);
@@ -6563,12 +7554,25 @@ RZ_IPI void rz_core_analysis_value_pointers(RzCore *core, RzOutputMode mode) {
 				}
 				if (end - begin > UT32_MAX) {
 					rz_core_notify_done(core, "Skipping huge range");
+					region++;
 					continue;
 				}
 				rz_core_notify_done(core, "0x%08" PFMT64x "-0x%08" PFMT64x " in 0x%" PFMT64x "-0x%" PFMT64x " (aav)", from, to, begin, end);
-				(void)rz_core_search_value_in_range(core, map->itv, from, to, vsize, _CbInRangeAav, (void *)&mode);
+				for (; from < to && next < rz_vector_len(&hits); next++) {
+					ValueHit *hit = rz_vector_index_ptr(&hits, next);
+					if (hit->range != range || hit->region != region) {
+						break;
+					}
+					value_hit_apply(core, hit, &apply);
+				}
+				region++;
+			}
+			if (from < to) {
+				range++;
 			}
 		}
+		rz_vector_fini(&ranges);
+		rz_vector_fini(&hits);
 		rz_list_free(list);
 	}
 beach:
@@ -6757,6 +7761,7 @@ RZ_API bool rz_core_analysis_esil_trace_start(RzCore *core) {
 	if (!esil->trace) {
 		return false;
 	}
+	esil->trace->max_changes = rz_config_get_i(core->config, "esil.trace.max");
 	rz_config_set_i(core->config, "dbg.trace", true);
 	return true;
 }
@@ -328,25 +328,16 @@ static void autocmplt_cmd_arg_macro(RzCore *core, RzLineNSCompletionResult *res,
 	}
 }
 
-static void autocmplt_cmd_arg_flag(RzCore *core, RzLineNSCompletionResult *res, const char *s, size_t len) {
-	RzFlagItem *item;
-	RzListIter *iter;
-	RzList *list = rz_flag_all_list(core->flags, false);
-	rz_list_foreach (list, iter, item) {
-		char *flag = item->name;
-		if (!strncmp(flag, s, len)) {
-			rz_line_ns_completion_result_add(res, flag);
-		}
-	}
-	rz_list_free(list);
-}
-
 static bool offset_prompt_add_flag(RzFlagItem *fi, void *user) {
 	RzLineNSCompletionResult *res = (RzLineNSCompletionResult *)user;
 	rz_line_ns_completion_result_add(res, fi->name);
 	return true;
 }
 
+static void autocmplt_cmd_arg_flag(RzCore *core, RzLineNSCompletionResult *res, const char *s, size_t len) {
+	rz_flag_foreach_name_prefix(core->flags, s, len, offset_prompt_add_flag, res);
+}
+
 static void autocmplt_cmd_arg_fcn(RzCore *core, RzLineNSCompletionResult *res, const char *s, size_t len) {
 	RzListIter *iter;
 	RzAnalysisFunction *fcn;
@@ -513,7 +504,7 @@ static void autocmplt_cmd_arg_rznum(RzCore *core, RzLineNSCompletionResult *res,
 		}
 	}
 	autocmplt_cmd_arg_fcn(core, res, s, len);
-	rz_flag_foreach_prefix(core->flags, s, len, offset_prompt_add_flag, res);
+	rz_flag_foreach_name_prefix(core->flags, s, len, offset_prompt_add_flag, res);
 	autocmplt_cmd_arg_help_var(core, res, s, len);
 }
 
@@ -539,6 +539,9 @@ RZ_API bool rz_core_bin_apply_strings(RzCore *r, RzBinFile *binfile) {
 		return false;
 	}
 	int va = (binfile->o && binfile->o->info && binfile->o->info->has_va) ? VA_TRUE : VA_FALSE;
+	RzVector metas;
+	rz_vector_init(&metas, sizeof(RzAnalysisMetaBulkItem), NULL, NULL);
+	rz_vector_reserve(&metas, rz_list_length(l));
 	rz_flag_space_push(r->flags, RZ_FLAGS_FS_STRINGS);
 	rz_cons_break_push(NULL, NULL);
 	RzListIter *iter;
@@ -554,7 +557,13 @@ RZ_API bool rz_core_bin_apply_strings(RzCore *r, RzBinFile *binfile) {
 		if (rz_cons_is_breaked()) {
 			break;
 		}
-		rz_meta_set_with_subtype(r->analysis, RZ_META_TYPE_STRING, string->type, vaddr, string->size, string->string);
+		RzAnalysisMetaBulkItem *meta = rz_vector_push(&metas, NULL);
+		if (meta) {
+			meta->addr = vaddr;
+			meta->size = string->size;
+			meta->subtype = string->type;
+			meta->str = string->string;
+		}
 		char *f_name = strdup(string->string);
 		rz_name_filter(f_name, -1, true);
 		char *str;
@@ -569,6 +578,9 @@ RZ_API bool rz_core_bin_apply_strings(RzCore *r, RzBinFile *binfile) {
 	}
 	rz_flag_space_pop(r->flags);
 	rz_cons_break_pop();
+	// the strings are all known now, the meta tree can be built at once
+	rz_meta_set_bulk(r->analysis, RZ_META_TYPE_STRING, rz_vector_head(&metas), rz_vector_len(&metas));
+	rz_vector_fini(&metas);
 	return true;
 }
 
@@ -651,15 +663,23 @@ RZ_API bool rz_core_bin_apply_main(RzCore *r, RzBinFile *binfile, bool va) {
 	return true;
 }
 
+static bool line_index_push_cb(void *user, const RzBinSourceLineSample *sample) {
+	return rz_bin_source_line_index_builder_push_sample(user, sample);
+}
+
 RZ_API bool rz_core_bin_apply_dwarf(RzCore *core, RzBinFile *binfile) {
 	rz_return_val_if_fail(core && binfile, false);
 	if (!rz_config_get_i(core->config, "bin.dbginfo") || !binfile->o) {
 		return false;
 	}
 	RzBinObject *o = binfile->o;
-	const RzBinSourceLineInfo *li = NULL;
 	RzBinDwarfDebugAbbrev *da = rz_bin_dwarf_parse_abbrev(binfile);
-	RzBinDwarfDebugInfo *info = da ? rz_bin_dwarf_parse_info(binfile, da) : NULL;
+	RzBinDwarfDebugInfo *info = NULL;
+	if (da) {
+		info = rz_config_get_b(core->config, "bin.dbginfo.lazy")
+			? rz_bin_dwarf_parse_info_lazy(binfile, da)
+			: rz_bin_dwarf_parse_info_parallel(binfile, da, rz_core_get_task_pool(core));
+	}
 	HtUP /*<offset, List *<LocListEntry>*/ *loc_table = rz_bin_dwarf_parse_loc(binfile, core->analysis->bits / 8);
 	if (info) {
 		RzAnalysisDwarfContext ctx = {
@@ -671,17 +691,39 @@ RZ_API bool rz_core_bin_apply_dwarf(RzCore *core, RzBinFile *binfile) {
 	if (loc_table) {
 		rz_bin_dwarf_loc_free(loc_table);
 	}
-	RzBinDwarfLineInfo *lines = rz_bin_dwarf_parse_line(binfile, info, RZ_BIN_DWARF_LINE_INFO_MASK_LINES);
-	rz_bin_dwarf_debug_info_free(info);
-	if (lines) {
-		// move all produced rows line info out (TODO: bin loading should do that)
-		li = o->lines = lines->lines;
-		lines->lines = NULL;
+	// stream the line programs right into the compact index, without keeping them as a whole
+	RzBinSourceLineIndexBuilder *builder = rz_bin_source_line_index_builder_new();
+	if (builder && rz_bin_dwarf_line_foreach_sample(binfile, info, line_index_push_cb, builder)) {
+		rz_bin_source_line_index_free(o->lines);
+		o->lines = rz_bin_source_line_index_builder_build_and_free(builder);
+	} else {
+		rz_bin_source_line_index_builder_free(builder);
 	}
+	rz_bin_dwarf_debug_info_free(info);
 	rz_bin_dwarf_debug_abbrev_free(da);
-	if (!li) {
+	return o->lines != NULL;
+}
+
+/**
+ * \brief Load the part of the current file holding \p vaddr if it was left out by bin.lazy and apply it
+ *
+ * This is how the images of a dyld shared cache are loaded on demand.
+ *
+ * \return true if something new was loaded
+ */
+RZ_API bool rz_core_bin_load_vaddr(RzCore *core, ut64 vaddr) {
+	rz_return_val_if_fail(core, false);
+	RzBinFile *binfile = rz_bin_cur(core->bin);
+	if (!binfile || !binfile->o || !binfile->o->plugin || !binfile->o->plugin->load_vaddr) {
+		return false;
+	}
+	if (!rz_bin_object_load_vaddr(binfile, binfile->o, vaddr)) {
 		return false;
 	}
+	bool va = core->io->va || core->bin->is_debugger;
+	rz_core_bin_apply_sections(core, binfile, va);
+	rz_core_bin_apply_symbols(core, binfile, va);
+	rz_core_bin_apply_classes(core, binfile);
 	return true;
 }
 
@@ -1213,7 +1255,7 @@ RZ_API bool rz_core_bin_apply_relocs(RzCore *core, RzBinFile *binfile, bool va_b
 	int va = VA_TRUE; // XXX relocs always vaddr?
 	RzBinRelocStorage *relocs = rz_bin_object_patch_relocs(binfile, o);
 	if (!relocs) {
-		relocs = o->relocs;
+		relocs = rz_bin_object_get_relocs(o);
 		if (!relocs) {
 			return false;
 		}
@@ -1224,7 +1266,7 @@ RZ_API bool rz_core_bin_apply_relocs(RzCore *core, RzBinFile *binfile, bool va_b
 	Sdb *db = NULL;
 	char *sdb_module = NULL;
 	for (size_t i = 0; i < relocs->relocs_count; i++) {
-		RzBinReloc *reloc = relocs->relocs[i];
+		RzBinReloc *reloc = &relocs->relocs[i];
 		if (is_invalid_address_va(va, reloc->vaddr, reloc->paddr)) {
 			continue;
 		}
@@ -1265,7 +1307,7 @@ RZ_API bool rz_core_bin_apply_imports(RzCore *core, RzBinFile *binfile, bool va)
 	}
 	RzListIter *iter;
 	RzBinImport *import;
-	RzList *imports = o->imports;
+	const RzList *imports = rz_bin_object_get_imports(o);
 	rz_list_foreach (imports, iter, import) {
 		if (!import->libname || !strstr(import->libname, ".dll")) {
 			continue;
@@ -1444,6 +1486,37 @@ static void select_flag_space(RzCore *core, RzBinSymbol *symbol) {
 	}
 }
 
+/**
+ * Demangle the names of all the symbols in the task pool before they are
+ * applied one by one, which then only finds them in the demangler cache.
+ */
+static void demangle_symbols_batch(RzCore *core, RzBinFile *binfile, RzList /*<RzBinSymbol *>*/ *symbols, const char *lang, bool va) {
+	RzThreadTaskPool *pool = rz_core_get_task_pool(core);
+	if (!pool || rz_th_task_pool_size(pool) < 2 || rz_list_length(symbols) < 0x100) {
+		return;
+	}
+	RzPVector names;
+	rz_pvector_init(&names, free);
+	if (!rz_pvector_reserve(&names, rz_list_length(symbols))) {
+		return;
+	}
+	RzListIter *iter;
+	RzBinSymbol *symbol;
+	rz_list_foreach (symbols, iter, symbol) {
+		if (!symbol->name || !symbol->paddr || is_invalid_address_va(va, symbol->vaddr, symbol->paddr)) {
+			continue;
+		}
+		// same name as the one demangled by rz_core_sym_name_init()
+		const char *name = symbol->dname ? symbol->dname : symbol->name;
+		char *full = rz_str_newf("%s%s", symbol->is_imported ? "imp." : "", name);
+		if (full) {
+			rz_pvector_push(&names, full);
+		}
+	}
+	rz_bin_demangle_batch(binfile, lang, (const char **)rz_pvector_data(&names), rz_pvector_len(&names), pool);
+	rz_pvector_fini(&names);
+}
+
 RZ_API bool rz_core_bin_apply_symbols(RzCore *core, RzBinFile *binfile, bool va) {
 	rz_return_val_if_fail(core && binfile, false);
 	RzBinObject *o = binfile->o;
@@ -1460,6 +1533,9 @@ RZ_API bool rz_core_bin_apply_symbols(RzCore *core, RzBinFile *binfile, bool va)
 	rz_flag_space_push(core->flags, RZ_FLAGS_FS_SYMBOLS);
 
 	RzList *symbols = rz_bin_get_symbols(core->bin);
+	if (lang && symbols) {
+		demangle_symbols_batch(core, binfile, symbols, lang, va);
+	}
 	size_t count = 0;
 	RzListIter *iter;
 	RzBinSymbol *symbol;
@@ -1552,7 +1628,7 @@ RZ_API bool rz_core_bin_apply_symbols(RzCore *core, RzBinFile *binfile, bool va)
 RZ_API bool rz_core_bin_apply_classes(RzCore *core, RzBinFile *binfile) {
 	rz_return_val_if_fail(core && binfile, false);
 	RzBinObject *o = binfile->o;
-	RzList *cs = o ? o->classes : NULL;
+	const RzList *cs = o ? rz_bin_object_get_classes(o) : NULL;
 	if (!cs) {
 		return false;
 	}
@@ -1631,37 +1707,182 @@ static void digests_ht_free(HtPPKv *kv) {
 	free(kv->value);
 }
 
+#define DIGESTS_CHUNK_SIZE 0x10000
+
+static RzHashCfg *digests_cfg_new(RzHash *hash, RzList /*<char *>*/ *digests) {
+	RzHashCfg *md = rz_hash_cfg_new(hash);
+	if (!md) {
+		return NULL;
+	}
+	RzListIter *it;
+	char *digest;
+	rz_list_foreach (digests, it, digest) {
+		// unknown algorithms are just left out of the result
+		if (rz_hash_plugin_by_name(hash, digest)) {
+			rz_hash_cfg_configure(md, digest);
+		}
+	}
+	if (!rz_hash_cfg_init(md)) {
+		rz_hash_cfg_free(md);
+		return NULL;
+	}
+	return md;
+}
+
+static HtPP *digests_cfg_results(RzHashCfg *md, RzList /*<char *>*/ *digests) {
+	HtPP *r = ht_pp_new(NULL, digests_ht_free, NULL);
+	if (!r || !rz_hash_cfg_final(md)) {
+		ht_pp_free(r);
+		return NULL;
+	}
+	RzListIter *it;
+	char *digest;
+	rz_list_foreach (digests, it, digest) {
+		if (!rz_hash_plugin_by_name(md->hash, digest)) {
+			continue;
+		}
+		char *chkstr = rz_hash_cfg_get_result_string(md, digest, NULL, false);
+		if (chkstr && !ht_pp_insert(r, digest, chkstr)) {
+			free(chkstr);
+		}
+	}
+	return r;
+}
+
+/**
+ * Compute all the \p digests of \p data at once. The data is fed by chunks to all
+ * the algorithms, so each chunk is still in cache for the next algorithm.
+ */
+static HtPP *digests_from_bytes(RzHash *hash, RzList /*<char *>*/ *digests, const ut8 *data, ut64 size) {
+	RzHashCfg *md = digests_cfg_new(hash, digests);
+	if (!md) {
+		return NULL;
+	}
+	for (ut64 off = 0; off < size; off += DIGESTS_CHUNK_SIZE) {
+		rz_hash_cfg_update(md, data + off, RZ_MIN(DIGESTS_CHUNK_SIZE, size - off));
+	}
+	HtPP *r = digests_cfg_results(md, digests);
+	rz_hash_cfg_free(md);
+	return r;
+}
+
+static const ut8 *digests_borrow(RzCore *core, ut64 paddr, ut64 size) {
+	if (!core->io->desc) {
+		return NULL;
+	}
+	ut64 len = size;
+	const ut8 *data = rz_io_desc_borrow_at(core->io->desc, paddr, &len);
+	// short files are padded by rz_io_pread_at(), only borrow complete ranges
+	return data && len == size ? data : NULL;
+}
+
 /**
  * \brief Create a hashtable of digests
  *
  * Digest names are supplied as a list of `char *` strings.
  * Returns the hashtable with keys of digest names and values of
  * strings containing requested digests.
+ *
+ * The bytes are read only once for all the digests, directly from the
+ * memory of the file when it is mapped.
  * */
 RZ_API RZ_OWN HtPP *rz_core_bin_create_digests(RzCore *core, ut64 paddr, ut64 size, RzList *digests) {
 	rz_return_val_if_fail(size && digests, NULL);
-	HtPP *r = ht_pp_new(NULL, digests_ht_free, NULL);
-	if (!r) {
+	const ut8 *borrowed = digests_borrow(core, paddr, size);
+	if (borrowed) {
+		return digests_from_bytes(core->hash, digests, borrowed, size);
+	}
+	RzHashCfg *md = digests_cfg_new(core->hash, digests);
+	ut8 *data = malloc(RZ_MIN(size, DIGESTS_CHUNK_SIZE));
+	if (!md || !data) {
+		rz_hash_cfg_free(md);
+		free(data);
 		return NULL;
 	}
-	RzListIter *it;
-	char *digest;
-	rz_list_foreach (digests, it, digest) {
-		ut8 *data = malloc(size);
-		if (!data) {
-			ht_pp_free(r);
-			return NULL;
-		}
-		rz_io_pread_at(core->io, paddr, data, size);
-		char *chkstr = rz_hash_cfg_calculate_small_block_string(core->hash, digest, data, size, NULL, false);
-		if (!chkstr) {
-			continue;
+	for (ut64 off = 0; off < size; off += DIGESTS_CHUNK_SIZE) {
+		int len = (int)RZ_MIN(DIGESTS_CHUNK_SIZE, size - off);
+		rz_io_pread_at(core->io, paddr + off, data, len);
+		rz_hash_cfg_update(md, data, len);
+	}
+	free(data);
+	HtPP *r = digests_cfg_results(md, digests);
+	rz_hash_cfg_free(md);
+	return r;
+}
+
+typedef struct {
+	RzHash *hash;
+	RzList /*<char *>*/ *digests;
+	RzBinSection **sections;
+	const ut8 **data;
+	HtPP **results;
+} SectionsDigestsCtx;
+
+static void sections_digests_range(size_t from, size_t to, void *user) {
+	SectionsDigestsCtx *ctx = user;
+	for (size_t i = from; i < to; i++) {
+		if (ctx->data[i] && !ctx->results[i]) {
+			ctx->results[i] = digests_from_bytes(ctx->hash, ctx->digests, ctx->data[i], ctx->sections[i]->size);
 		}
-		ht_pp_insert(r, digest, chkstr);
+	}
+}
+
+/**
+ * \brief Compute the \p digests of all the \p sections, spread over the task pool
+ *
+ * Sections whose bytes can be borrowed from the io are hashed by the workers,
+ * the others are read and hashed by the calling thread, as the io can not be
+ * shared among threads.
+ *
+ * \return Array of rz_pvector_len(sections) hashtables like the ones of
+ * rz_core_bin_create_digests(), NULL for empty sections or on failure
+ */
+static HtPP **sections_create_digests(RzCore *core, RzPVector /*<RzBinSection *>*/ *sections, RzList /*<char *>*/ *digests) {
+	size_t count = rz_pvector_len(sections);
+	HtPP **results = RZ_NEWS0(HtPP *, count);
+	const ut8 **data = RZ_NEWS0(const ut8 *, count);
+	if (!results || !data) {
+		free(results);
 		free(data);
+		return NULL;
+	}
+	size_t borrowed = 0;
+	for (size_t i = 0; i < count; i++) {
+		RzBinSection *section = rz_pvector_at(sections, i);
+		if (section->size && (data[i] = digests_borrow(core, section->paddr, section->size))) {
+			borrowed++;
+		}
 	}
+	SectionsDigestsCtx ctx = {
+		.hash = core->hash,
+		.digests = digests,
+		.sections = (RzBinSection **)rz_pvector_data(sections),
+		.data = data,
+		.results = results,
+	};
+	RzThreadTaskPool *pool = borrowed > 1 ? rz_core_get_task_pool(core) : NULL;
+	if (!pool || (!rz_th_task_pool_parallel_for(pool, 0, count, 1, sections_digests_range, &ctx) && !rz_cons_is_breaked())) {
+		// only the ranges the pool did not get to are left
+		sections_digests_range(0, count, &ctx);
+	}
+	for (size_t i = 0; i < count; i++) {
+		RzBinSection *section = rz_pvector_at(sections, i);
+		if (!data[i] && section->size) {
+			results[i] = rz_core_bin_create_digests(core, section->paddr, section->size, digests);
+		}
+	}
+	free(data);
+	return results;
+}
 
-	return r;
+static void sections_digests_free(HtPP **results, size_t count) {
+	if (!results) {
+		return;
+	}
+	for (size_t i = 0; i < count; i++) {
+		ht_pp_free(results[i]);
+	}
+	free(results);
 }
 
 /**
@@ -1734,7 +1955,7 @@ static bool bin_dwarf(RzCore *core, RzBinFile *binfile, RzCmdStateOutput *state)
 		return false;
 	}
 	RzBinDwarfDebugAbbrev *da = rz_bin_dwarf_parse_abbrev(binfile);
-	RzBinDwarfDebugInfo *info = da ? rz_bin_dwarf_parse_info(binfile, da) : NULL;
+	RzBinDwarfDebugInfo *info = da ? rz_bin_dwarf_parse_info_parallel(binfile, da, rz_core_get_task_pool(core)) : NULL;
 	if (state->mode == RZ_OUTPUT_MODE_STANDARD) {
 		if (da) {
 			rz_core_bin_dwarf_print_abbrev_section(da);
@@ -1822,6 +2043,38 @@ RZ_API void rz_core_bin_print_source_line_info(RzCore *core, const RzBinSourceLi
 	rz_cmd_state_output_array_end(state);
 }
 
+typedef struct {
+	RzCore *core;
+	RzCmdStateOutput *state;
+} PrintSampleCtx;
+
+static bool print_sample_cb(void *user, const RzBinSourceLineSample *sample) {
+	PrintSampleCtx *ctx = user;
+	if (rz_cons_is_breaked()) {
+		return false;
+	}
+	rz_core_bin_print_source_line_sample(ctx->core, sample, ctx->state);
+	return true;
+}
+
+RZ_API void rz_core_bin_print_source_line_index(RzCore *core, const RzBinSourceLineIndex *index, RzCmdStateOutput *state) {
+	rz_return_if_fail(core && index && state);
+	PrintSampleCtx ctx = { core, state };
+	rz_cmd_state_output_array_start(state);
+	rz_cons_break_push(NULL, NULL);
+	rz_bin_source_line_index_foreach(index, print_sample_cb, &ctx);
+	rz_cons_break_pop();
+	rz_cmd_state_output_array_end(state);
+}
+
+RZ_API void rz_core_bin_print_source_line_index_at(RzCore *core, const RzBinSourceLineIndex *index, ut64 addr, RzCmdStateOutput *state) {
+	rz_return_if_fail(core && index && state);
+	PrintSampleCtx ctx = { core, state };
+	rz_cmd_state_output_array_start(state);
+	rz_bin_source_line_index_foreach_at(index, addr, print_sample_cb, &ctx);
+	rz_cmd_state_output_array_end(state);
+}
+
 static const char *bin_reloc_type_name(RzBinReloc *reloc) {
 #define CASE(T) \
 	case RZ_BIN_RELOC_##T: return reloc->additive ? "ADD_" #T : "SET_" #T
@@ -2246,7 +2499,7 @@ RZ_API bool rz_core_bin_relocs_print(RzCore *core, RzBinFile *bf, RzCmdStateOutp
 
 	rz_cmd_state_output_array_start(state);
 	for (size_t i = 0; i < relocs->relocs_count; i++) {
-		RzBinReloc *reloc = relocs->relocs[i];
+		RzBinReloc *reloc = &relocs->relocs[i];
 		ut64 addr = rva(o, reloc->paddr, reloc->vaddr, va);
 
 		switch (state->mode) {
@@ -2354,7 +2607,7 @@ static bool digests_pj_cb(void *user, const void *k, const void *v) {
 	return true;
 }
 
-static void sections_print_json(RzCore *core, PJ *pj, RzBinObject *o, RzBinSection *section, RzList *hashes) {
+static void sections_print_json(RzCore *core, PJ *pj, RzBinObject *o, RzBinSection *section, RzList *hashes, HtPP *digests) {
 	ut64 addr = get_section_addr(core, o, section);
 	char perms[5];
 	section_perms_str(perms, section->perm);
@@ -2390,18 +2643,16 @@ static void sections_print_json(RzCore *core, PJ *pj, RzBinObject *o, RzBinSecti
 		pj_kN(pj, "align", section->align);
 	}
 	if (hashes && section->size > 0) {
-		HtPP *digests = rz_core_bin_create_digests(core, section->paddr, section->size, hashes);
 		if (!digests) {
 			pj_end(pj);
 			return;
 		}
 		ht_pp_foreach(digests, digests_pj_cb, pj);
-		ht_pp_free(digests);
 	}
 	pj_end(pj);
 }
 
-static bool sections_print_table(RzCore *core, RzTable *t, RzBinObject *o, RzBinSection *section, RzList *hashes) {
+static bool sections_print_table(RzCore *core, RzTable *t, RzBinObject *o, RzBinSection *section, RzList *hashes, HtPP *digests) {
 	ut64 addr = get_section_addr(core, o, section);
 	char perms[5];
 	section_perms_str(perms, section->perm);
@@ -2430,7 +2681,6 @@ static bool sections_print_table(RzCore *core, RzTable *t, RzBinObject *o, RzBin
 	}
 	bool result = false;
 	if (hashes && section->size > 0) {
-		HtPP *digests = rz_core_bin_create_digests(core, section->paddr, section->size, hashes);
 		if (!digests) {
 			goto cleanup;
 		}
@@ -2443,7 +2693,6 @@ static bool sections_print_table(RzCore *core, RzTable *t, RzBinObject *o, RzBin
 				rz_table_add_row_columnsf(t, "s", digest);
 			}
 		}
-		ht_pp_free(digests);
 	}
 	result = true;
 cleanup:
@@ -2495,6 +2744,8 @@ RZ_API bool rz_core_bin_sections_print(RzCore *core, RzBinFile *bf, RzCmdStateOu
 	rz_cmd_state_output_array_start(state);
 	sections_headers_setup(core, state, hashes);
 
+	RzPVector shown;
+	rz_pvector_init(&shown, NULL);
 	rz_list_foreach (sections, iter, section) {
 		if (filter && filter->offset != UT64_MAX) {
 			if (!is_in_symbol_range(section->vaddr, section->vsize, filter->offset) &&
@@ -2505,18 +2756,27 @@ RZ_API bool rz_core_bin_sections_print(RzCore *core, RzBinFile *bf, RzCmdStateOu
 		if (filter && filter->name && section->name && strcmp(section->name, filter->name)) {
 			continue;
 		}
+		rz_pvector_push(&shown, section);
+	}
+	HtPP **digests = hashes ? sections_create_digests(core, &shown, hashes) : NULL;
+	void **it;
+	rz_pvector_foreach (&shown, it) {
+		section = *it;
+		HtPP *section_digests = digests ? digests[it - rz_pvector_data(&shown)] : NULL;
 		switch (state->mode) {
 		case RZ_OUTPUT_MODE_JSON:
-			sections_print_json(core, state->d.pj, o, section, hashes);
+			sections_print_json(core, state->d.pj, o, section, hashes, section_digests);
 			break;
 		case RZ_OUTPUT_MODE_TABLE:
-			res &= sections_print_table(core, state->d.t, o, section, hashes);
+			res &= sections_print_table(core, state->d.t, o, section, hashes, section_digests);
 			break;
 		default:
 			rz_warn_if_reached();
 			break;
 		}
 	}
+	sections_digests_free(digests, rz_pvector_len(&shown));
+	rz_pvector_fini(&shown);
 
 	rz_cmd_state_output_array_end(state);
 
@@ -2653,6 +2913,8 @@ RZ_API bool rz_core_bin_segments_print(RzCore *core, RzBinFile *bf, RzCmdStateOu
 		}
 	}
 
+	RzPVector shown;
+	rz_pvector_init(&shown, NULL);
 	rz_list_foreach (segments, iter, segment) {
 		if (filter && filter->offset != UT64_MAX) {
 			if (!is_in_symbol_range(segment->vaddr, segment->vsize, filter->offset) &&
@@ -2663,18 +2925,27 @@ RZ_API bool rz_core_bin_segments_print(RzCore *core, RzBinFile *bf, RzCmdStateOu
 		if (filter && filter->name && segment->name && strcmp(segment->name, filter->name)) {
 			continue;
 		}
+		rz_pvector_push(&shown, segment);
+	}
+	HtPP **digests = hashes ? sections_create_digests(core, &shown, hashes) : NULL;
+	void **it;
+	rz_pvector_foreach (&shown, it) {
+		segment = *it;
+		HtPP *segment_digests = digests ? digests[it - rz_pvector_data(&shown)] : NULL;
 		switch (state->mode) {
 		case RZ_OUTPUT_MODE_JSON:
-			sections_print_json(core, state->d.pj, o, segment, hashes);
+			sections_print_json(core, state->d.pj, o, segment, hashes, segment_digests);
 			break;
 		case RZ_OUTPUT_MODE_TABLE:
-			sections_print_table(core, state->d.t, o, segment, hashes);
+			sections_print_table(core, state->d.t, o, segment, hashes, segment_digests);
 			break;
 		default:
 			rz_warn_if_reached();
 			break;
 		}
 	}
+	sections_digests_free(digests, rz_pvector_len(&shown));
+	rz_pvector_fini(&shown);
 
 	rz_cmd_state_output_array_end(state);
 	rz_list_free(segments);
@@ -3757,7 +4028,8 @@ static void bin_class_print_rizin(RzCore *r, RzBinClass *c, ut64 at_min) {
 	}
 
 	// C struct
-	if (bf->o->lang == RZ_BIN_LANGUAGE_C || bf->o->lang == RZ_BIN_LANGUAGE_CXX || bf->o->lang == RZ_BIN_LANGUAGE_OBJC) {
+	RzBinLanguage lang = rz_bin_object_get_language(bf->o);
+	if (lang == RZ_BIN_LANGUAGE_C || lang == RZ_BIN_LANGUAGE_CXX || lang == RZ_BIN_LANGUAGE_OBJC) {
 		rz_cons_printf("td \"struct %s {", c->name);
 		rz_list_foreach (c->fields, iter2, f) {
 			char *n = objc_name_toc(f->name);
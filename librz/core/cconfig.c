@@ -186,6 +186,13 @@ static bool cb_analysis_vars(void *user, void *data) {
 	return true;
 }
 
+static bool cb_analysis_vars_lazy(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	core->analysis->opt.vars_lazy = node->i_value;
+	return true;
+}
+
 static bool cb_analysis_vars_stackname(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -948,6 +955,22 @@ static bool cb_binfilter(void *user, void *data) {
 	return true;
 }
 
+static bool cb_demangle_cache(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	if (core->bin && core->bin->demangler) {
+		rz_demangler_cache_set_size(core->bin->demangler, node->i_value);
+	}
+	return true;
+}
+
+static bool cb_binlazy(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	core->bin->lazy = node->i_value;
+	return true;
+}
+
 static bool cb_useldr(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -1096,6 +1119,30 @@ static bool cb_timezone(void *user, void *data) {
 	return true;
 }
 
+static bool cb_cfg_tracing(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	if (node->i_value) {
+		rz_tracing_enable(true);
+		return true;
+	}
+	if (!rz_tracing_is_enabled()) {
+		return true;
+	}
+	rz_tracing_enable(false);
+	const char *path = rz_config_get(core->config, "cfg.tracing.file");
+	if (RZ_STR_ISEMPTY(path)) {
+		return true;
+	}
+	char *json = rz_tracing_to_json();
+	if (!json || !rz_file_dump(path, (const ut8 *)json, strlen(json), false)) {
+		RZ_LOG_ERROR("core: cannot write the trace events to %s\n", path);
+	}
+	free(json);
+	rz_tracing_reset();
+	return true;
+}
+
 static bool cb_cfgdebug(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -1461,6 +1508,15 @@ static bool cb_esilstackdepth(void *user, void *data) {
 	return true;
 }
 
+static bool cb_esiltracemax(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	if (core->analysis && core->analysis->esil && core->analysis->esil->trace) {
+		core->analysis->esil->trace->max_changes = node->i_value;
+	}
+	return true;
+}
+
 static bool cb_fixrows(void *user, void *data) {
 	RzConfigNode *node = (RzConfigNode *)data;
 	rz_cons_singleton()->fix_rows = (int)node->i_value;
@@ -1936,6 +1992,49 @@ static bool cb_io_cache_read(void *user, void *data) {
 	return true;
 }
 
+static bool cb_io_pagecache(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	rz_io_page_cache_enable(core->io, node->i_value);
+	return true;
+}
+
+static bool cb_io_pagecache_pages(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	rz_io_page_cache_set_max_pages(core->io, node->i_value);
+	return true;
+}
+
+static bool cb_io_pagecache_stats(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	if (node->i_value) {
+		// only resetting the counters is allowed
+		return false;
+	}
+	rz_io_page_cache_reset_stats(core->io);
+	return true;
+}
+
+static void counter_node_set(RzConfigNode *node, ut64 value) {
+	node->i_value = value;
+	free(node->value);
+	node->value = rz_str_newf("%" PFMT64u, value);
+}
+
+static bool cb_io_pagecache_hits_getter(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	counter_node_set((RzConfigNode *)data, core->io->page_cache.hits);
+	return true;
+}
+
+static bool cb_io_pagecache_misses_getter(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	counter_node_set((RzConfigNode *)data, core->io->page_cache.misses);
+	return true;
+}
+
 static bool cb_io_cache_write(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -2177,6 +2276,19 @@ static bool cb_scrflush(void *user, void *data) {
 	return true;
 }
 
+static bool cb_scrdamage(void *user, void *data) {
+	RzConfigNode *node = (RzConfigNode *)data;
+	rz_cons_singleton()->damage = node->i_value;
+	rz_cons_screen_invalidate();
+	return true;
+}
+
+static bool cb_scrstream(void *user, void *data) {
+	RzConfigNode *node = (RzConfigNode *)data;
+	rz_cons_singleton()->stream_chunk = node->i_value;
+	return true;
+}
+
 static bool cb_scrstrconv(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -2228,6 +2340,24 @@ static bool cb_iotrap(void *user, void *data) {
 	return true;
 }
 
+static bool cb_emucow(void *user, void *data) {
+	RzConfigNode *node = (RzConfigNode *)data;
+	RzCore *core = (RzCore *)user;
+	if (!core->analysis) {
+		return true;
+	}
+	return rz_analysis_set_emu_cow(core->analysis, node->i_value) || !node->i_value;
+}
+
+static bool cb_emuprofile(void *user, void *data) {
+	RzConfigNode *node = (RzConfigNode *)data;
+	RzCore *core = (RzCore *)user;
+	if (!core->analysis) {
+		return true;
+	}
+	return rz_analysis_emu_prof_enable(core->analysis, node->i_value);
+}
+
 static bool cb_scr_bgfill(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -2333,6 +2463,20 @@ static bool cb_swstep(void *user, void *data) {
 	return true;
 }
 
+static bool cb_dbg_trace_branches(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	return rz_debug_trace_branches(core->dbg, node->i_value);
+}
+
+static bool cb_dbg_reglazy(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	core->dbg->reg_lazy = node->i_value;
+	rz_debug_reg_invalidate(core->dbg);
+	return true;
+}
+
 static bool cb_consbreak(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -2449,6 +2593,14 @@ static bool cb_bindbginfo(void *user, void *data) {
 	return true;
 }
 
+static bool cb_bincachedir(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	free(core->bin->cache_dir);
+	core->bin->cache_dir = RZ_STR_ISNOTEMPTY(node->value) ? strdup(node->value) : NULL;
+	return true;
+}
+
 static bool cb_binprefix(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -2574,6 +2726,66 @@ static int __dbg_swstep_getter(void *user, RzConfigNode *node) {
 	return true;
 }
 
+static bool cb_analysis_readahead(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	if (node->i_value > ST32_MAX) {
+		return false;
+	}
+	return rz_analysis_fcn_set_read_ahead_size(core->analysis, node->i_value);
+}
+
+static bool cb_analysis_opcache(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	rz_analysis_op_cache_enable(core->analysis, node->i_value);
+	return true;
+}
+
+static bool cb_analysis_opcache_size(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	rz_analysis_op_cache_set_max_entries(core->analysis, node->i_value);
+	return true;
+}
+
+static bool cb_analysis_opcache_stats(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	if (node->i_value) {
+		// only resetting the counters is allowed
+		return false;
+	}
+	rz_analysis_op_cache_reset_stats(core->analysis);
+	return true;
+}
+
+static bool cb_analysis_opcache_hits_getter(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	counter_node_set((RzConfigNode *)data, core->analysis->op_cache.hits);
+	return true;
+}
+
+static bool cb_analysis_opcache_misses_getter(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	counter_node_set((RzConfigNode *)data, core->analysis->op_cache.misses);
+	return true;
+}
+
+static bool cb_analysis_arena(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	core->analysis->use_arena = node->i_value;
+	return true;
+}
+
+static bool cb_analysis_snapshot(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	core->analysis->publish_snapshots = node->i_value;
+	return true;
+}
+
 static bool cb_analysis_roregs(RzCore *core, RzConfigNode *node) {
 	if (core && core->analysis && core->analysis->reg) {
 		rz_list_free(core->analysis->reg->roregs);
@@ -2881,6 +3093,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 
 	/* analysis */
 	SETBPREF("analysis.detectwrites", "false", "Automatically reanalyze function after a write");
+	SETBPREF("analysis.detectwrites.deps", "false", "Also update the xrefs of the blocks touched by analysis.detectwrites and record their functions for aafu");
 	SETPREF("analysis.fcnprefix", "fcn", "Prefix new function names with this");
 	const char *analysiscc = rz_analysis_cc_default(core->analysis);
 	SETCB("analysis.cc", analysiscc ? analysiscc : "", (RzConfigCallback)&cb_analysiscc, "Specify default calling convention");
@@ -2904,6 +3117,9 @@ RZ_API int rz_core_config_init(RzCore *core) {
 		"analysis.fcn", "analysis.bb",
 		NULL);
 	SETI("analysis.timeout", 0, "Stop analyzing after a couple of seconds");
+	SETBPREF("analysis.triage.discard", "false", "Drop the basic blocks and variables of each function once aaq printed it");
+	SETPREF("analysis.passes.log", "", "Append the statistics of the passes of each aaa as a line of JSON to this file (see aaP)");
+	SETI("analysis.noreturn.budget", 0, "Stop propagating noreturn functions after N milliseconds (0 for no limit)");
 	SETCB("analysis.jmp.retpoline", "true", &cb_analysis_jmpretpoline, "Analyze retpolines, may be slower if not needed");
 	SETICB("analysis.jmp.tailcall", 0, &cb_analysis_jmptailcall, "Consume a branch as a call if delta is big");
 
@@ -2911,6 +3127,16 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETCB("analysis.jmp.after", "true", &cb_analysis_afterjmp, "Continue analysis after jmp/ujmp");
 	SETCB("analysis.trap.after", "false", &cb_analysis_aftertrap, "Continue analysis after trap instructions.");
 	SETCB("analysis.delay", "true", &cb_analysis_delay, "Enable delay slot analysis if supported by the architecture");
+	SETICB("analysis.readahead", RZ_ANALYSIS_READ_AHEAD_DEFAULT_SIZE, &cb_analysis_readahead, "Size of the window of bytes prefetched during basic block analysis (0 to disable)");
+	SETCB("analysis.opcache", "false", &cb_analysis_opcache, "Memoize decoded instructions (not used for disassembly and IL lifting)");
+	SETICB("analysis.opcache.size", RZ_ANALYSIS_OP_CACHE_DEFAULT_SIZE, &cb_analysis_opcache_size, "Maximum number of instructions kept by analysis.opcache");
+	SETPREF("analysis.opcache.dir", "", "Directory where aaa loads and saves analysis.opcache for the next session on the same file (empty to disable)");
+	SETICB("analysis.opcache.hits", 0, &cb_analysis_opcache_stats, "Number of analysis.opcache hits (set to 0 to reset)");
+	rz_config_set_getter(cfg, "analysis.opcache.hits", cb_analysis_opcache_hits_getter);
+	SETICB("analysis.opcache.misses", 0, &cb_analysis_opcache_stats, "Number of analysis.opcache misses (set to 0 to reset)");
+	rz_config_set_getter(cfg, "analysis.opcache.misses", cb_analysis_opcache_misses_getter);
+	SETCB("analysis.arena", "false", &cb_analysis_arena, "Allocate basic blocks and functions from per-analysis slabs (see aai)");
+	SETCB("analysis.snapshot", "false", &cb_analysis_snapshot, "Publish a read-only snapshot of functions, blocks and xrefs for concurrent readers whenever waiting for input");
 	SETICB("analysis.depth", 64, &cb_analysis_depth, "Max depth at code analysis"); // XXX: warn if depth is > 50 .. can be problematic
 	SETICB("analysis.graph_depth", 256, &cb_analysis_graphdepth, "Max depth for path search");
 	SETICB("analysis.sleep", 0, &cb_analysis_sleep, "Sleep N usecs every so often during analysis. Avoid 100% CPU usage");
@@ -2925,6 +3151,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETBPREF("analysis.types.verbose", "false", "Verbose output from type analysis");
 	SETBPREF("analysis.types.constraint", "false", "Enable constraint types analysis for variables");
 	SETCB("analysis.vars", "true", &cb_analysis_vars, "Analyze local variables and arguments");
+	SETCB("analysis.vars.lazy", "false", &cb_analysis_vars_lazy, "Defer the variables analysis of aa/aaa until a function is shown or its variables are used");
 	SETCB("analysis.vars.stackname", "false", &cb_analysis_vars_stackname, "Name variables based on their offset on the stack");
 	SETBPREF("analysis.vinfun", "true", "Search values in functions (aav) (false by default to only find on non-code)");
 	SETBPREF("analysis.vinfunrange", "false", "Search values outside function ranges (requires analysis.vinfun=false)\n");
@@ -2994,6 +3221,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETI("esil.addr.size", 64, "Maximum address size in accessed by the ESIL VM");
 	SETBPREF("esil.breakoninvalid", "false", "Break esil execution when instruction is invalid");
 	SETI("esil.timeout", 0, "A timeout (in seconds) for when we should give up emulating");
+	SETICB("esil.trace.max", 0, &cb_esiltracemax, "Number of register and memory changes an ESIL trace keeps before dropping the oldest ones (0 for unlimited)");
 	/* asm */
 	// asm.os needs to be first, since other asm.* depend on it
 	n = NODECB("asm.os", "none", &cb_asmos);
@@ -3051,6 +3279,8 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETBPREF("emu.str.inv", "true", "Color-invert emu.str strings");
 	SETBPREF("emu.str.flag", "true", "Also show flag (if any) for asm.emu string");
 	SETBPREF("emu.write", "false", "Allow asm.emu to modify memory (WARNING)");
+	SETCB("emu.cow", "false", &cb_emucow, "Keep memory written by esil and il emulation in copy-on-write pages instead of io (see aem)");
+	SETCB("emu.profile", "false", &cb_emuprofile, "Count executions and time of esil and il emulation per instruction (see aeP)");
 	SETBPREF("emu.ssa", "false", "Perform SSA checks and show the ssa reg names as comments");
 	n = NODECB("emu.skip", "ds", &cb_emuskip);
 	SETDESC(n, "Skip metadata of given types in asm.emu");
@@ -3182,13 +3412,17 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETDESC(n, "Filter strings");
 	SETOPTIONS(n, "a", "8", "p", "e", "u", "i", "U", "f", NULL);
 	SETCB("bin.filter", "true", &cb_binfilter, "Filter symbol names to fix dupped names");
+	SETCB("bin.lazy", "false", &cb_binlazy, "Load imports, symbols, relocs and classes from the plugin only when first used");
+	SETCB("bin.cache.dir", "", &cb_bincachedir, "Directory where parsed bin objects are cached by content hash (empty to disable, overrides bin.lazy)");
 	SETCB("bin.force", "", &cb_binforce, "Force that rbin plugin");
 	SETPREF("bin.lang", "", "Language for bin.demangle");
 	SETBPREF("bin.demangle", "true", "Import demangled symbols from RzBin");
 	SETBPREF("bin.demangle.libs", "false", "Show library name on demangled symbols names");
+	SETICB("bin.demangle.cache", RZ_DEMANGLER_CACHE_SIZE_DEFAULT, &cb_demangle_cache, "Number of recently demangled symbols to remember (0 to disable)");
 	SETI("bin.baddr", -1, "Base address of the binary");
 	SETI("bin.laddr", 0, "Base address for loading library ('*.so')");
 	SETCB("bin.dbginfo", "true", &cb_bindbginfo, "Load debug information at startup if available");
+	SETBPREF("bin.dbginfo.lazy", "false", "Decode the DWARF compilation units one at a time when applying the debug information");
 	SETBPREF("bin.relocs", "true", "Load relocs information at startup if available");
 	SETICB("bin.minstr", 0, &cb_binminstr, "Minimum string length for rz_bin");
 	SETICB("bin.maxstr", 0, &cb_binmaxstr, "Maximum string length for rz_bin");
@@ -3205,6 +3439,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	/* prj */
 	SETPREF("prj.file", "", "Path of the currently opened project");
 	SETBPREF("prj.compress", "false", "Compress the project file while saving");
+	SETBPREF("prj.binary", "false", "Save the project in the binary sdb format instead of plaintext");
 
 	/* cfg */
 	SETBPREF("cfg.plugins", "true", "Load plugins at startup");
@@ -3212,6 +3447,8 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETICB("time.zone", 0, &cb_timezone, "Time zone, in hours relative to GMT: +2, -1,..");
 	SETBPREF("cfg.newtab", "false", "Show descriptions in command completion");
 	SETCB("cfg.debug", "false", &cb_cfgdebug, "Debugger mode");
+	SETPREF("cfg.tracing.file", "", "Write the Chrome trace events to this file when cfg.tracing is disabled");
+	SETCB("cfg.tracing", "false", &cb_cfg_tracing, "Record trace events of commands, tasks, analysis passes, bin loading and io reads");
 	p = rz_sys_getenv("EDITOR");
 #if __WINDOWS__
 	rz_config_set(cfg, "cfg.editor", p ? p : "notepad");
@@ -3339,8 +3576,10 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	rz_config_desc(cfg, "dbg.follow", "Follow program counter when pc > core->offset + dbg.follow");
 	SETBPREF("dbg.rebase", "true", "Rebase analysis/meta/comments/flags when reopening file in debugger");
 	SETCB("dbg.swstep", "false", &cb_swstep, "Force use of software steps (code analysis+breakpoint)");
+	SETCB("dbg.reglazy", "false", &cb_dbg_reglazy, "Only fetch the register types in use and only write back the modified ones");
 	SETBPREF("dbg.trace.inrange", "false", "While tracing, avoid following calls outside specified range");
 	SETBPREF("dbg.trace.libs", "true", "Trace library code too");
+	SETCB("dbg.trace.branches", "false", &cb_dbg_trace_branches, "Trace the executed blocks from the branches recorded by the cpu (Intel BTS on Linux)");
 	SETBPREF("dbg.exitkills", "true", "Kill process on exit");
 	SETPREF("dbg.exe.path", "", "Path to binary being debugged");
 	SETCB("dbg.execs", "false", &cb_dbg_execs, "Stop execution if new thread is created");
@@ -3403,6 +3642,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	/* http */
 	SETBPREF("http.log", "true", "Show HTTP requests processed");
 	SETBPREF("http.colon", "false", "Only accept the : command");
+	SETBPREF("http.async", "false", "Serve many clients at once from an event loop, running commands as tasks (needs libuv)");
 	SETPREF("http.logfile", "", "Specify a log file instead of stderr for http requests");
 	SETBPREF("http.cors", "false", "Enable CORS");
 	SETPREF("http.referer", "", "CSFR protection if set");
@@ -3469,6 +3709,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETBPREF("graph.json.usenames", "true", "Use names instead of addresses in Global Call Graph (agCj)");
 	SETI("graph.edges", 2, "0=no edges, 1=simple edges, 2=avoid collisions");
 	SETI("graph.layout", 0, "Graph layout (0=vertical, 1=horizontal)");
+	SETI("graph.layout.budget", 1000, "Max time in ms spent reducing edge crossings in the graph layout (0=no limit)");
 	SETI("graph.linemode", 1, "Graph edges (0=diagonal, 1=square)");
 	SETPREF("graph.font", "Courier", "Font for dot graphs");
 	SETBPREF("graph.offset", "false", "Show offsets in graphs");
@@ -3511,6 +3752,8 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETICB("scr.maxtab", 4096, &cb_completion_maxtab, "Change max number of auto completion suggestions");
 	SETICB("scr.pagesize", 1, &cb_scrpagesize, "Flush in pages when scr.linesleep is != 0");
 	SETCB("scr.flush", "false", &cb_scrflush, "Force flush to console in realtime (breaks scripting)");
+	SETCB("scr.damage", "false", &cb_scrdamage, "Only write the rows that changed when redrawing visual mode and panels (saves bandwidth on remote terminals)");
+	SETICB("scr.stream", 0, &cb_scrstream, "Write out unfiltered output in chunks of this many bytes while it is printed (0 to keep it until the command ends)");
 	SETBPREF("scr.slow", "true", "Do slow stuff on visual mode like RzFlag.get_at(true)");
 	SETCB("scr.prompt.popup", "false", &cb_scr_prompt_popup, "Show widget dropdown for autocomplete");
 #if __WINDOWS__
@@ -3590,6 +3833,10 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETBPREF("search.flags", "true", "All search results are flagged, otherwise only printed");
 	SETBPREF("search.overlap", "false", "Look for overlapped search hits");
 	SETI("search.maxhits", 0, "Maximum number of hits (0: no limit)");
+	SETI("search.max.threads", RZ_THREAD_POOL_ALL_CORES, "Max threads number of the keyword search (when 0 uses all available cores)");
+	SETBPREF("search.index", "true", "Skip the data the gram indexes built by /Ib rule out in keyword searches");
+	SETI("search.index.maxmem", 64 * 1024 * 1024, "Max memory of each gram index built by /Ib, its pages get larger to fit");
+	SETI("search.readahead", 4, "Number of blocks keyword searches read ahead in a background thread when the data can't be scanned in place (0 to disable)");
 	SETI("search.from", -1, "Search start address");
 	n = NODECB("search.in", "io.maps", &cb_searchin);
 	SETDESC(n, "Specify search boundaries");
@@ -3621,6 +3868,12 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETCB("io.pcache", "false", &cb_iopcache, "io.cache for p-level");
 	SETCB("io.pcache.write", "false", &cb_iopcachewrite, "Enable write-cache");
 	SETCB("io.pcache.read", "false", &cb_iopcacheread, "Enable read-cache");
+	SETCB("io.pagecache", "false", &cb_io_pagecache, "Keep recently read plugin pages in memory (for debuggers only until the target runs, if supported)");
+	SETICB("io.pagecache.pages", RZ_IO_PAGE_CACHE_DEFAULT_PAGES, &cb_io_pagecache_pages, "Maximum number of 4 KiB pages kept by io.pagecache");
+	SETICB("io.pagecache.hits", 0, &cb_io_pagecache_stats, "Number of io.pagecache hits (set to 0 to reset)");
+	rz_config_set_getter(cfg, "io.pagecache.hits", cb_io_pagecache_hits_getter);
+	SETICB("io.pagecache.misses", 0, &cb_io_pagecache_stats, "Number of io.pagecache misses (set to 0 to reset)");
+	rz_config_set_getter(cfg, "io.pagecache.misses", cb_io_pagecache_misses_getter);
 	SETCB("io.ff", "true", &cb_ioff, "Fill invalid buffers with 0xff instead of returning error");
 	SETBPREF("io.exec", "true", "See !!rizin -h~-x");
 	SETICB("io.0xff", 0xff, &cb_io_oxff, "Use this value instead of 0xff to fill unallocated areas");
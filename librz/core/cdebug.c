@@ -95,6 +95,32 @@ RZ_IPI void rz_core_debug_continue(RzCore *core) {
 	}
 }
 
+/**
+ * Continue the target in the background, its stop is handled by
+ * rz_core_debug_async_collect() before the next command runs.
+ */
+RZ_IPI bool rz_core_debug_continue_async(RzCore *core) {
+	rz_reg_arena_swap(core->dbg->reg, true);
+#if __linux__
+	core->dbg->continue_all_threads = true;
+#endif
+	return rz_debug_continue_async(core->dbg);
+}
+
+/**
+ * Handle the stop of a target continued by rz_core_debug_continue_async()
+ * \param block wait for the target to stop
+ * \return true if the target was running and stopped now
+ */
+RZ_IPI bool rz_core_debug_async_collect(RzCore *core, bool block) {
+	if (!rz_debug_is_running(core->dbg) || !rz_debug_async_collect(core->dbg, block)) {
+		return false;
+	}
+	rz_core_reg_update_flags(core);
+	rz_core_dbg_follow_seek_register(core);
+	return true;
+}
+
 RZ_API bool rz_core_debug_continue_until(RzCore *core, ut64 addr, ut64 to) {
 	ut64 pc;
 	if (!strcmp(core->dbg->btalgo, "trace") && core->dbg->arch && !strcmp(core->dbg->arch, "x86") && core->dbg->bits == 4) {
@@ -609,9 +635,9 @@ RZ_API void rz_debug_map_list_visual(RzDebug *dbg, ut64 addr, const char *input,
 RZ_API void rz_debug_trace_print(RzDebug *dbg, RzCmdStateOutput *state, ut64 offset) {
 	rz_return_if_fail(dbg);
 	int tag = dbg->trace->tag;
-	RzListIter *iter;
-	RzDebugTracepoint *trace;
-	rz_list_foreach (dbg->trace->traces, iter, trace) {
+	void **it;
+	rz_pvector_foreach (dbg->trace->traces, it) {
+		RzDebugTracepoint *trace = *it;
 		if (trace->tag && !(tag & trace->tag)) {
 			continue;
 		}
@@ -105,21 +105,6 @@ static bool __rebase_flags(RzFlagItem *flag, void *user) {
 	return true;
 }
 
-static bool __rebase_xrefs_i(void *user, const ut64 k, const void *v) {
-	struct __rebase_struct *reb = (void *)user;
-	RzAnalysisXRef *xref = (RzAnalysisXRef *)v;
-	xref->from += reb->diff;
-	xref->to += reb->diff;
-	rz_analysis_xrefs_set(reb->core->analysis, xref->from, xref->to, xref->type);
-	return true;
-}
-
-static bool __rebase_xrefs(void *user, const ut64 k, const void *v) {
-	HtUP *ht = (HtUP *)v;
-	ht_up_foreach(ht, __rebase_xrefs_i, user);
-	return true;
-}
-
 static void __rebase_everything(RzCore *core, RzList *old_sections, ut64 old_base) {
 	RzListIter *it, *itit, *ititit;
 	RzAnalysisFunction *fcn;
@@ -169,14 +154,13 @@ static void __rebase_everything(RzCore *core, RzList *old_sections, ut64 old_bas
 	rz_meta_rebase(core->analysis, diff);
 
 	// XREFS
-	HtUP *xrefs_from = core->analysis->ht_xrefs_from;
-	HtUP *xrefs_to = core->analysis->ht_xrefs_to;
-	core->analysis->ht_xrefs_from = NULL;
-	core->analysis->ht_xrefs_to = NULL;
+	RzList *xrefs = rz_analysis_xrefs_list(core->analysis);
 	rz_analysis_xrefs_init(core->analysis);
-	ht_up_foreach(xrefs_from, __rebase_xrefs, &reb);
-	ht_up_free(xrefs_from);
-	ht_up_free(xrefs_to);
+	RzAnalysisXRef *xref;
+	rz_list_foreach (xrefs, it, xref) {
+		rz_analysis_xrefs_set(core->analysis, xref->from + diff, xref->to + diff, xref->type);
+	}
+	rz_list_free(xrefs);
 
 	// BREAKPOINTS
 	rz_debug_bp_rebase(core->dbg, old_base, new_base);
@@ -34,3 +34,142 @@ RZ_API RZ_OWN RzList *rz_heap_windows_heap_list(RzCore *core) {
 }
 
 #endif
+
+#define HEAP_CACHE_BLOCK      0x10000
+#define HEAP_CACHE_MAX_BLOCKS 0x400
+
+struct rz_core_heap_cache_t {
+	ut32 target_generation; ///< dbg->target_generation when the blocks were read
+	HtUP *blocks; ///< aligned address -> HEAP_CACHE_BLOCK bytes, or NULL if not readable entirely
+};
+
+static void heap_cache_block_free(HtUPKv *kv) {
+	free(kv->value);
+}
+
+RZ_IPI void rz_core_heap_cache_invalidate(RZ_NULLABLE RzCoreHeapCache *cache) {
+	if (!cache || (cache->blocks && !cache->blocks->count)) {
+		return;
+	}
+	ht_up_free(cache->blocks);
+	cache->blocks = ht_up_new(NULL, heap_cache_block_free, NULL);
+}
+
+RZ_IPI void rz_core_heap_cache_free(RZ_NULLABLE RzCoreHeapCache *cache) {
+	if (!cache) {
+		return;
+	}
+	ht_up_free(cache->blocks);
+	free(cache);
+}
+
+static RzCoreHeapCache *heap_cache_get(RzCore *core) {
+	RzCoreHeapCache *cache = core->heap_cache;
+	if (!cache) {
+		cache = RZ_NEW0(RzCoreHeapCache);
+		if (!cache) {
+			return NULL;
+		}
+		cache->blocks = ht_up_new(NULL, heap_cache_block_free, NULL);
+		cache->target_generation = core->dbg->target_generation;
+		core->heap_cache = cache;
+	}
+	if (cache->target_generation != core->dbg->target_generation ||
+		(cache->blocks && cache->blocks->count > HEAP_CACHE_MAX_BLOCKS)) {
+		rz_core_heap_cache_invalidate(cache);
+		cache->target_generation = core->dbg->target_generation;
+	}
+	return cache->blocks ? cache : NULL;
+}
+
+static const ut8 *heap_cache_block(RzCore *core, RzCoreHeapCache *cache, ut64 addr) {
+	bool found;
+	ut8 *block = ht_up_find(cache->blocks, addr, &found);
+	if (found) {
+		return block;
+	}
+	block = malloc(HEAP_CACHE_BLOCK);
+	if (block && !rz_io_read_at(core->io, addr, block, HEAP_CACHE_BLOCK)) {
+		// e.g. the end of a mapping, it is read piece by piece
+		RZ_FREE(block);
+	}
+	ht_up_insert(cache->blocks, addr, block);
+	return block;
+}
+
+/**
+ * \brief Reads target memory for the glibc and Windows heap commands
+ *
+ * Walking the chunks and bins reads a header at a time, which is very slow
+ * when every read goes to a remote debugger. The memory is read instead by
+ * blocks of 64 KiB, which are kept until the target runs or is written to.
+ *
+ * \return false if not all of it could be read, like rz_io_read_at()
+ */
+RZ_IPI bool rz_core_heap_read(RZ_NONNULL RzCore *core, ut64 addr, RZ_NONNULL RZ_OUT ut8 *buf, ut64 len) {
+	rz_return_val_if_fail(core && buf, false);
+	RzCoreHeapCache *cache = heap_cache_get(core);
+	if (!cache || len > INT_MAX) {
+		return len <= INT_MAX && rz_io_read_at(core->io, addr, buf, (int)len);
+	}
+	bool ret = len > 0;
+	while (len) {
+		ut64 base = addr - addr % HEAP_CACHE_BLOCK;
+		ut64 n = RZ_MIN(len, HEAP_CACHE_BLOCK - (addr - base));
+		const ut8 *block = base <= UT64_MAX - HEAP_CACHE_BLOCK ? heap_cache_block(core, cache, base) : NULL;
+		if (block) {
+			memcpy(buf, block + (addr - base), n);
+		} else if (!rz_io_read_at(core->io, addr, buf, (int)n)) {
+			ret = false;
+		}
+		addr += n;
+		buf += n;
+		len -= n;
+	}
+	return ret;
+}
+
+/**
+ * \brief Reads in advance the memory that the heap commands are about to walk
+ *
+ * The blocks of [addr, addr + len) not read yet are fetched with a single
+ * rz_io_readv(), so a whole heap segment costs one round trip instead of one
+ * per block. If the vectored read fails, e.g. on a range not entirely
+ * committed, nothing is kept and rz_core_heap_read() reads block by block.
+ */
+RZ_IPI void rz_core_heap_prefetch(RZ_NONNULL RzCore *core, ut64 addr, ut64 len) {
+	rz_return_if_fail(core);
+	RzCoreHeapCache *cache = heap_cache_get(core);
+	if (!cache || !len || addr > UT64_MAX - len) {
+		return;
+	}
+	ut64 base = addr - addr % HEAP_CACHE_BLOCK;
+	ut64 end = addr + len;
+	RzVector vecs;
+	rz_vector_init(&vecs, sizeof(RzIOVec), NULL, NULL);
+	for (; base < end && base <= UT64_MAX - HEAP_CACHE_BLOCK; base += HEAP_CACHE_BLOCK) {
+		if (cache->blocks->count + rz_vector_len(&vecs) >= HEAP_CACHE_MAX_BLOCKS) {
+			break;
+		}
+		if (ht_up_find_kv(cache->blocks, base, NULL)) {
+			continue;
+		}
+		RzIOVec *vec = rz_vector_push(&vecs, NULL);
+		if (!vec || !(vec->buf = malloc(HEAP_CACHE_BLOCK))) {
+			if (vec) {
+				rz_vector_pop(&vecs, NULL);
+			}
+			break;
+		}
+		vec->addr = base;
+		vec->len = HEAP_CACHE_BLOCK;
+	}
+	bool ok = !rz_vector_empty(&vecs) && rz_io_readv(core->io, rz_vector_head(&vecs), rz_vector_len(&vecs));
+	RzIOVec *vec;
+	rz_vector_foreach (&vecs, vec) {
+		if (!ok || !ht_up_insert(cache->blocks, vec->addr, vec->buf)) {
+			free(vec->buf);
+		}
+	}
+	rz_vector_fini(&vecs);
+}
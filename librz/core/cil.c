@@ -698,3 +698,113 @@ RZ_IPI bool rz_core_analysis_il_step_with_events(RzCore *core, PJ *pj) {
 	}
 	return true;
 }
+
+static const char *il_step_result_str(RzAnalysisILStepResult r) {
+	switch (r) {
+	case RZ_ANALYSIS_IL_STEP_RESULT_SUCCESS:
+		return "ok";
+	case RZ_ANALYSIS_IL_STEP_RESULT_NOT_SET_UP:
+		return "not set up";
+	case RZ_ANALYSIS_IL_STEP_IL_RUNTIME_ERROR:
+		return "runtime error";
+	case RZ_ANALYSIS_IL_STEP_INVALID_OP:
+		return "invalid op";
+	}
+	return "unknown";
+}
+
+static void il_batch_print_job_json(PJ *pj, const char *reg_name, RzAnalysisILBatchJob *job) {
+	RzAnalysisILBatchReg *r = rz_vector_index_ptr(&job->regs, 0);
+	pj_o(pj);
+	pj_kn(pj, reg_name, r->value);
+	pj_kn(pj, "steps", job->steps);
+	pj_kn(pj, "pc", job->pc);
+	pj_ks(pj, "result", il_step_result_str(job->result));
+	pj_ko(pj, "regs");
+	rz_vector_foreach(&job->final_regs, r) {
+		pj_kn(pj, r->name, r->value);
+	}
+	pj_end(pj);
+	pj_ka(pj, "pages");
+	RzVector *pages = job->mem ? rz_buf_cow_get_pages(job->mem) : NULL;
+	if (pages) {
+		ut64 *addr;
+		rz_vector_foreach(pages, addr) {
+			pj_n(pj, *addr);
+		}
+		rz_vector_free(pages);
+	}
+	pj_end(pj);
+	pj_end(pj);
+}
+
+/**
+ * \brief Emulate from the current registers once for every value of \p reg_name in the comma-separated \p values
+ *
+ * The runs are independent of each other and of the user-faced vm, they are
+ * executed in parallel and stop at \p until or after \p max_steps instructions.
+ */
+RZ_IPI bool rz_core_analysis_il_batch(RzCore *core, const char *reg_name, const char *values, ut64 until, ut64 max_steps, RzOutputMode mode) {
+	rz_return_val_if_fail(core && reg_name && values, false);
+	RzList *vals = rz_str_split_duplist(values, ",", true);
+	RzPVector *jobs = rz_pvector_new((RzPVectorFree)rz_analysis_il_batch_job_free);
+	if (!vals || !jobs) {
+		rz_list_free(vals);
+		rz_pvector_free(jobs);
+		return false;
+	}
+	RzListIter *it;
+	const char *val;
+	rz_list_foreach (vals, it, val) {
+		RzAnalysisILBatchJob *job = rz_analysis_il_batch_job_new(until, max_steps);
+		if (!job || !rz_analysis_il_batch_job_set_reg(job, reg_name, rz_num_math(core->num, val)) || !rz_pvector_push(jobs, job)) {
+			rz_analysis_il_batch_job_free(job);
+			goto beach;
+		}
+	}
+	rz_list_free(vals);
+	vals = NULL;
+
+	rz_cons_break_push(NULL, NULL);
+	bool succ = rz_analysis_il_vm_batch_run(core->analysis, jobs, rz_core_get_task_pool(core));
+	rz_cons_break_pop();
+	if (!succ) {
+		RZ_LOG_ERROR("RzIL: batch emulation is not available for the current arch\n");
+		goto beach;
+	}
+
+	PJ *pj = NULL;
+	if (mode == RZ_OUTPUT_MODE_JSON) {
+		pj = pj_new();
+		if (!pj) {
+			goto beach;
+		}
+		pj_a(pj);
+	}
+	void **vit;
+	rz_pvector_foreach (jobs, vit) {
+		RzAnalysisILBatchJob *job = *vit;
+		if (pj) {
+			il_batch_print_job_json(pj, reg_name, job);
+			continue;
+		}
+		RzAnalysisILBatchReg *r = rz_vector_index_ptr(&job->regs, 0);
+		rz_cons_printf("%s=0x%" PFMT64x " steps=%" PFMT64u " pc=0x%" PFMT64x,
+			reg_name, r->value, job->steps, job->pc);
+		if (job->result != RZ_ANALYSIS_IL_STEP_RESULT_SUCCESS) {
+			rz_cons_printf(" (%s)", il_step_result_str(job->result));
+		}
+		rz_cons_newline();
+	}
+	if (pj) {
+		pj_end(pj);
+		rz_cons_println(pj_string(pj));
+		pj_free(pj);
+	}
+	rz_pvector_free(jobs);
+	return true;
+beach:
+	rz_list_free(vals);
+	rz_pvector_free(jobs);
+	return false;
+}
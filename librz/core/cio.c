@@ -798,11 +798,10 @@ RZ_API RzCmdStatus rz_core_io_cache_print(RzCore *core, RzCmdStateOutput *state)
 	rz_return_val_if_fail(core && core->io, RZ_CMD_STATUS_ERROR);
 
 	size_t i, j = 0;
-	void **iter;
+	RBIter iter;
 	RzIOCache *c;
 
-	rz_pvector_foreach (&core->io->cache, iter) {
-		c = *iter;
+	rz_rbtree_foreach (core->io->cache, iter, c, RzIOCache, rb) {
 		const ut64 dataSize = rz_itv_size(c->itv);
 		switch (state->mode) {
 		case RZ_OUTPUT_MODE_STANDARD:
@@ -3522,6 +3522,19 @@ static RzCmdParsedArgs *parse_args(struct tsr2cmd_state *state, TSNode args, boo
 	}
 }
 
+// the parser is only needed when the command was not parsed before or has to be re-parsed after substitutions
+static TSParser *state_parser(struct tsr2cmd_state *state) {
+	if (state->parser) {
+		return state->parser;
+	}
+	state->parser = ts_parser_new();
+	if (state->parser && !ts_parser_set_language(state->parser, (TSLanguage *)state->core->rcmd->language)) {
+		ts_parser_delete(state->parser);
+		state->parser = NULL;
+	}
+	return state->parser;
+}
+
 static TSTree *apply_edits(struct tsr2cmd_state *state, RzList *edits) {
 	struct tsr2cmd_edit *edit;
 	RzListIter *it;
@@ -3532,7 +3545,8 @@ static TSTree *apply_edits(struct tsr2cmd_state *state, RzList *edits) {
 		state->input = rz_str_replace(state->input, edit->old_text, edit->new_text, 0);
 	}
 	RZ_LOG_DEBUG("new input = '%s'\n", state->input);
-	return ts_parser_parse_string(state->parser, NULL, state->input, strlen(state->input));
+	TSParser *parser = state_parser(state);
+	return parser ? ts_parser_parse_string(parser, NULL, state->input, strlen(state->input)) : NULL;
 }
 
 static void substitute_args_fini(struct tsr2cmd_state *state) {
@@ -5214,6 +5228,75 @@ struct ts_data_symbol_map map_ts_symbols[] = {
 	{ NULL, NULL },
 };
 
+#define PARSED_CMDS_MAX      64
+#define PARSED_CMD_MAX_INPUT 4096
+
+typedef struct {
+	char *input;
+	TSTree *tree;
+} ParsedCmd;
+
+static void parsed_cmd_free(ParsedCmd *p) {
+	if (!p) {
+		return;
+	}
+	ts_tree_delete(p->tree);
+	free(p->input);
+	free(p);
+}
+
+/**
+ * Look for \p input in the trees parsed before. Trees are immutable and
+ * ts_tree_copy() only takes a reference, so the caller gets its own copy
+ * that it has to delete.
+ */
+static TSTree *parsed_cmd_get(RzCmd *cmd, const char *input) {
+	if (!cmd->ts_parsed) {
+		return NULL;
+	}
+	TSTree *tree = NULL;
+	RzListIter *it;
+	ParsedCmd *p;
+	rz_th_lock_enter(cmd->ts_parsed_lock);
+	rz_list_foreach (cmd->ts_parsed, it, p) {
+		if (strcmp(p->input, input)) {
+			continue;
+		}
+		tree = ts_tree_copy(p->tree);
+		if (it != rz_list_head(cmd->ts_parsed)) {
+			rz_list_split_iter(cmd->ts_parsed, it);
+			free(it);
+			rz_list_prepend(cmd->ts_parsed, p);
+		}
+		break;
+	}
+	rz_th_lock_leave(cmd->ts_parsed_lock);
+	return tree;
+}
+
+static void parsed_cmd_add(RzCmd *cmd, const char *input, TSTree *tree) {
+	size_t len = strlen(input);
+	if (!len || len > PARSED_CMD_MAX_INPUT) {
+		// scripts are not worth keeping around
+		return;
+	}
+	if (!cmd->ts_parsed) {
+		return;
+	}
+	ParsedCmd *p = RZ_NEW0(ParsedCmd);
+	if (!p) {
+		return;
+	}
+	p->input = rz_str_ndup(input, len);
+	p->tree = ts_tree_copy(tree);
+	rz_th_lock_enter(cmd->ts_parsed_lock);
+	if (rz_list_length(cmd->ts_parsed) >= PARSED_CMDS_MAX) {
+		parsed_cmd_free(rz_list_pop(cmd->ts_parsed));
+	}
+	rz_list_prepend(cmd->ts_parsed, p);
+	rz_th_lock_leave(cmd->ts_parsed_lock);
+}
+
 /**
  * \brief Create an instance of RzCmd for the Rizin language
  */
@@ -5226,6 +5309,11 @@ RZ_API RzCmd *rz_core_cmd_new(bool has_cons) {
 	TSLanguage *lang = tree_sitter_rzcmd();
 	res->language = lang;
 	res->ts_symbols_ht = ht_up_new0();
+	res->ts_parsed = rz_list_newf((RzListFree)parsed_cmd_free);
+	res->ts_parsed_lock = rz_th_lock_new(false);
+	if (!res->ts_parsed_lock) {
+		RZ_FREE_CUSTOM(res->ts_parsed, rz_list_free);
+	}
 	struct ts_data_symbol_map *entry = map_ts_stmt_handlers;
 	while (entry->name) {
 		TSSymbol symbol = ts_language_symbol_for_name(lang, entry->name, strlen(entry->name), true);
@@ -5243,25 +5331,28 @@ RZ_API RzCmd *rz_core_cmd_new(bool has_cons) {
 }
 
 static RzCmdStatus core_cmd_tsrzcmd(RzCore *core, const char *cstr, bool split_lines, bool log) {
-	TSParser *parser = ts_parser_new();
-	bool language_ok = ts_parser_set_language(parser, (TSLanguage *)core->rcmd->language);
-	rz_return_val_if_fail(language_ok, RZ_CMD_STATUS_INVALID);
+	RzCmdStatus res = RZ_CMD_STATUS_INVALID;
+	struct tsr2cmd_state state = { 0 };
+	state.core = core;
 
 	char *input = strdup(rz_str_trim_head_ro(cstr));
 
-	TSTree *tree = ts_parser_parse_string(parser, NULL, input, strlen(input));
+	TSTree *tree = parsed_cmd_get(core->rcmd, input);
 	if (!tree) {
-		rz_warn_if_reached();
-		free(input);
-		return RZ_CMD_STATUS_INVALID;
+		TSParser *parser = state_parser(&state);
+		rz_return_val_if_fail(parser, RZ_CMD_STATUS_INVALID);
+		tree = ts_parser_parse_string(parser, NULL, input, strlen(input));
+		if (!tree) {
+			rz_warn_if_reached();
+			ts_parser_delete(parser);
+			free(input);
+			return RZ_CMD_STATUS_INVALID;
+		}
+		parsed_cmd_add(core->rcmd, input, tree);
 	}
 
 	TSNode root = ts_tree_root_node(tree);
 
-	RzCmdStatus res = RZ_CMD_STATUS_INVALID;
-	struct tsr2cmd_state state;
-	state.parser = parser;
-	state.core = core;
 	state.input = input;
 	state.tree = tree;
 	state.log = log;
@@ -5278,7 +5369,9 @@ static RzCmdStatus core_cmd_tsrzcmd(RzCore *core, const char *cstr, bool split_l
 	free(ts_str);
 
 	if (is_ts_statements(root) && !ts_node_has_error(root)) {
+		RZ_TRACE_BEGIN("cmd", input);
 		res = handle_ts_statements(&state, root);
+		RZ_TRACE_END("cmd");
 	} else {
 		// TODO: print a more meaningful error message and use the ERROR
 		// tokens to indicate where, probably, the error is.
@@ -5286,7 +5379,9 @@ static RzCmdStatus core_cmd_tsrzcmd(RzCore *core, const char *cstr, bool split_l
 	}
 
 	ts_tree_delete(tree);
-	ts_parser_delete(parser);
+	if (state.parser) {
+		ts_parser_delete(state.parser);
+	}
 	free(input);
 	rz_pvector_fini(&state.saved_input);
 	rz_pvector_fini(&state.saved_tree);
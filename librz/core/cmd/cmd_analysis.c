@@ -8,6 +8,7 @@
 #include "../core_private.h"
 
 #define MAX_SCAN_SIZE 0x7ffffff
+#define IL_BATCH_MAX_STEPS 0x10000
 
 HEAPTYPE(ut64);
 
@@ -74,6 +75,8 @@ static const char *help_msg_ae[] = {
 	"aeli", "", "list loaded ESIL interrupts",
 	"aeli", " [file]", "load ESIL interrupts from shared object",
 	"aelir", " [interrupt number]", "remove ESIL interrupt and free it if needed",
+	"aem", "[?]", "Copy-on-write emulation memory (emu.cow)",
+	"aeP", "[?]", "Emulation profile (emu.profile)",
 	"aepc", " [addr]", "change esil PC to this address",
 	"aes", "", "perform emulated debugger step",
 	"aesp", " [X] [N]", "evaluate N instr from offset X",
@@ -262,6 +265,15 @@ exit:
 	return fcn;
 }
 
+// the function in offset, with its variables recovered if that was deferred
+static RzAnalysisFunction *analysis_get_function_vars_in(RzCore *core, ut64 offset) {
+	RzAnalysisFunction *fcn = analysis_get_function_in(core->analysis, offset);
+	if (fcn) {
+		rz_core_analysis_function_vars_ensure(core, fcn);
+	}
+	return fcn;
+}
+
 static int cmpaddr(const void *_a, const void *_b) {
 	const RzAnalysisFunction *a = _a, *b = _b;
 	return (a->addr > b->addr) ? 1 : (a->addr < b->addr) ? -1
@@ -1091,25 +1103,13 @@ RZ_API bool rz_core_esil_continue_back(RzCore *core) {
 		return true;
 	}
 
-	RzRegItem *ripc = rz_reg_get(esil->analysis->reg, "PC", -1);
-	RzVector *vreg = ht_up_find(esil->trace->registers, ripc->offset | (ripc->arena << 16), NULL);
-	if (!vreg) {
-		RZ_LOG_ERROR("failed to find PC change vector\n");
-		return false;
-	}
-
 	// Search for the nearest breakpoint in the tracepoints before the current position
-	bool bp_found = false;
-	int idx = 0;
-	RzAnalysisEsilRegChange *reg;
-	rz_vector_foreach_prev(vreg, reg) {
-		if (reg->idx >= esil->trace->idx) {
-			continue;
-		}
-		bp_found = rz_bp_get_in(core->dbg->bp, reg->data, RZ_PERM_X) != NULL;
-		if (bp_found) {
-			idx = reg->idx;
-			eprintf("hit breakpoint at: 0x%" PFMT64x " idx: %d\n", reg->data, reg->idx);
+	int idx = esil->trace->start_idx;
+	for (int i = esil->trace->idx - 1; i >= esil->trace->start_idx; i--) {
+		RzILTraceInstruction *ins = rz_analysis_esil_get_instruction_trace(esil->trace, i);
+		if (ins && rz_bp_get_in(core->dbg->bp, ins->addr, RZ_PERM_X)) {
+			idx = i;
+			eprintf("hit breakpoint at: 0x%" PFMT64x " idx: %d\n", ins->addr, i);
 			break;
 		}
 	}
@@ -1750,6 +1750,162 @@ RZ_IPI RzCmdStatus rz_il_trace_stop_handler(RzCore *core, int argc, const char *
 	return rz_core_analysis_esil_trace_stop(core) ? RZ_CMD_STATUS_OK : RZ_CMD_STATUS_ERROR;
 }
 
+static bool emu_mem_enabled(RzCore *core) {
+	if (!core->analysis->emu_mem) {
+		RZ_LOG_ERROR("Emulation memory is only kept apart with emu.cow=true\n");
+		return false;
+	}
+	return true;
+}
+
+// aem
+RZ_IPI RzCmdStatus rz_emu_mem_list_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state) {
+	if (!emu_mem_enabled(core)) {
+		return RZ_CMD_STATUS_ERROR;
+	}
+	RzVector *pages = rz_buf_cow_get_pages(core->analysis->emu_mem);
+	if (!pages) {
+		return RZ_CMD_STATUS_ERROR;
+	}
+	rz_cmd_state_output_array_start(state);
+	ut64 *addr;
+	rz_vector_foreach (pages, addr) {
+		switch (state->mode) {
+		case RZ_OUTPUT_MODE_STANDARD:
+			rz_cons_printf("0x%08" PFMT64x " - 0x%08" PFMT64x "\n", *addr, *addr + RZ_BUF_COW_PAGE_SIZE);
+			break;
+		case RZ_OUTPUT_MODE_QUIET:
+			rz_cons_printf("0x%08" PFMT64x "\n", *addr);
+			break;
+		case RZ_OUTPUT_MODE_JSON:
+			pj_o(state->d.pj);
+			pj_kn(state->d.pj, "addr", *addr);
+			pj_kn(state->d.pj, "size", RZ_BUF_COW_PAGE_SIZE);
+			pj_end(state->d.pj);
+			break;
+		default:
+			rz_warn_if_reached();
+			break;
+		}
+	}
+	rz_cmd_state_output_array_end(state);
+	rz_vector_free(pages);
+	return RZ_CMD_STATUS_OK;
+}
+
+// aemc
+RZ_IPI RzCmdStatus rz_emu_mem_commit_handler(RzCore *core, int argc, const char **argv) {
+	if (!emu_mem_enabled(core)) {
+		return RZ_CMD_STATUS_ERROR;
+	}
+	if (!rz_buf_cow_commit(core->analysis->emu_mem)) {
+		RZ_LOG_ERROR("Not all emulated memory could be written into io\n");
+		return RZ_CMD_STATUS_ERROR;
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
+// aem-
+RZ_IPI RzCmdStatus rz_emu_mem_reset_handler(RzCore *core, int argc, const char **argv) {
+	if (!emu_mem_enabled(core)) {
+		return RZ_CMD_STATUS_ERROR;
+	}
+	rz_buf_cow_reset(core->analysis->emu_mem);
+	return RZ_CMD_STATUS_OK;
+}
+
+static bool emu_prof_enabled(RzCore *core) {
+	if (!core->analysis->emu_prof) {
+		RZ_LOG_ERROR("Emulation is only profiled with emu.profile=true\n");
+		return false;
+	}
+	return true;
+}
+
+static void emu_prof_print_summary(RzAnalysisEmuProf *prof, RzCmdStateOutput *state) {
+	switch (state->mode) {
+	case RZ_OUTPUT_MODE_STANDARD:
+		rz_cons_printf("insns: %" PFMT64u "  time: %" PFMT64u "us  lift: %" PFMT64u "us  mem: %" PFMT64u "us\n",
+			prof->hits, prof->time_exec, prof->time_lift, prof->time_mem);
+		rz_cons_printf("reads: %" PFMT64u " (%" PFMT64u " bytes)  writes: %" PFMT64u " (%" PFMT64u " bytes)\n",
+			prof->mem_reads, prof->mem_read_bytes, prof->mem_writes, prof->mem_write_bytes);
+		break;
+	case RZ_OUTPUT_MODE_JSON:
+		pj_kn(state->d.pj, "insns", prof->hits);
+		pj_kn(state->d.pj, "time", prof->time_exec);
+		pj_kn(state->d.pj, "lift_time", prof->time_lift);
+		pj_kn(state->d.pj, "mem_time", prof->time_mem);
+		pj_kn(state->d.pj, "mem_reads", prof->mem_reads);
+		pj_kn(state->d.pj, "mem_read_bytes", prof->mem_read_bytes);
+		pj_kn(state->d.pj, "mem_writes", prof->mem_writes);
+		pj_kn(state->d.pj, "mem_write_bytes", prof->mem_write_bytes);
+		break;
+	default:
+		break;
+	}
+}
+
+// aeP
+RZ_IPI RzCmdStatus rz_emu_prof_list_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state) {
+	if (!emu_prof_enabled(core)) {
+		return RZ_CMD_STATUS_ERROR;
+	}
+	RzAnalysisEmuProf *prof = core->analysis->emu_prof;
+	RzPVector *insns = rz_analysis_emu_prof_insns(prof);
+	if (!insns) {
+		return RZ_CMD_STATUS_ERROR;
+	}
+	size_t n = argc > 1 ? rz_num_math(core->num, argv[1]) : rz_pvector_len(insns);
+	if (state->mode == RZ_OUTPUT_MODE_JSON) {
+		pj_o(state->d.pj);
+		emu_prof_print_summary(prof, state);
+		pj_ka(state->d.pj, "profile");
+	} else {
+		emu_prof_print_summary(prof, state);
+	}
+	rz_cmd_state_output_set_columnsf(state, "xnnn", "addr", "hits", "time", "avg");
+	for (size_t i = 0; i < n && i < rz_pvector_len(insns); i++) {
+		RzAnalysisEmuProfInsn *insn = rz_pvector_at(insns, i);
+		switch (state->mode) {
+		case RZ_OUTPUT_MODE_STANDARD:
+			rz_cons_printf("0x%08" PFMT64x " %8" PFMT64u " %8" PFMT64u "us %5.1f%%\n", insn->addr, insn->hits, insn->time,
+				prof->time_exec ? insn->time * 100.0 / prof->time_exec : 0.0);
+			break;
+		case RZ_OUTPUT_MODE_QUIET:
+			rz_cons_printf("0x%08" PFMT64x " %" PFMT64u "\n", insn->addr, insn->hits);
+			break;
+		case RZ_OUTPUT_MODE_TABLE:
+			rz_table_add_rowf(state->d.t, "xnnn", insn->addr, insn->hits, insn->time, insn->time / insn->hits);
+			break;
+		case RZ_OUTPUT_MODE_JSON:
+			pj_o(state->d.pj);
+			pj_kn(state->d.pj, "addr", insn->addr);
+			pj_kn(state->d.pj, "hits", insn->hits);
+			pj_kn(state->d.pj, "time", insn->time);
+			pj_end(state->d.pj);
+			break;
+		default:
+			rz_warn_if_reached();
+			break;
+		}
+	}
+	if (state->mode == RZ_OUTPUT_MODE_JSON) {
+		pj_end(state->d.pj);
+		pj_end(state->d.pj);
+	}
+	rz_pvector_free(insns);
+	return RZ_CMD_STATUS_OK;
+}
+
+// aeP-
+RZ_IPI RzCmdStatus rz_emu_prof_reset_handler(RzCore *core, int argc, const char **argv) {
+	if (!emu_prof_enabled(core)) {
+		return RZ_CMD_STATUS_ERROR;
+	}
+	rz_analysis_emu_prof_reset(core->analysis->emu_prof);
+	return RZ_CMD_STATUS_OK;
+}
+
 static const char _handler_no_name[] = "<no name>";
 static bool _aeli_iter(void *user, const ut64 key, const void *value) {
 	const RzAnalysisEsilInterrupt *interrupt = value;
@@ -3740,12 +3896,12 @@ RZ_IPI RzCmdStatus rz_analysis_function_setbits_handler(RzCore *core, int argc,
 		rz_analysis_hint_set_bits(core->analysis, bb->addr, bits);
 		rz_analysis_hint_set_bits(core->analysis, bb->addr + bb->size, core->analysis->bits);
 	}
-	fcn->bits = bits;
+	rz_analysis_function_set_bits(fcn, bits);
 	return RZ_CMD_STATUS_OK;
 }
 
 RZ_IPI RzCmdStatus rz_analysis_function_signature_handler(RzCore *core, int argc, const char **argv, RzOutputMode mode) {
-	RzAnalysisFunction *f = analysis_get_function_in(core->analysis, core->offset);
+	RzAnalysisFunction *f = analysis_get_function_vars_in(core, core->offset);
 	if (!f) {
 		return RZ_CMD_STATUS_ERROR;
 	}
@@ -4072,7 +4228,7 @@ fail:
 }
 
 RZ_IPI RzCmdStatus rz_analysis_function_vars_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state) {
-	RzAnalysisFunction *fcn = analysis_get_function_in(core->analysis, core->offset);
+	RzAnalysisFunction *fcn = analysis_get_function_vars_in(core, core->offset);
 	if (!fcn) {
 		return RZ_CMD_STATUS_ERROR;
 	}
@@ -4113,7 +4269,7 @@ RZ_IPI RzCmdStatus rz_analysis_function_vars_handler(RzCore *core, int argc, con
 }
 
 RZ_IPI RzCmdStatus rz_analysis_function_vars_dis_refs_handler(RzCore *core, int argc, const char **argv) {
-	RzAnalysisFunction *fcn = analysis_get_function_in(core->analysis, core->offset);
+	RzAnalysisFunction *fcn = analysis_get_function_vars_in(core, core->offset);
 	if (!fcn) {
 		return RZ_CMD_STATUS_ERROR;
 	}
@@ -4148,7 +4304,7 @@ RZ_IPI RzCmdStatus rz_analysis_function_vars_dis_refs_handler(RzCore *core, int
 }
 
 RZ_IPI RzCmdStatus rz_analysis_function_vars_del_handler(RzCore *core, int argc, const char **argv) {
-	RzAnalysisFunction *fcn = analysis_get_function_in(core->analysis, core->offset);
+	RzAnalysisFunction *fcn = analysis_get_function_vars_in(core, core->offset);
 	if (!fcn) {
 		return RZ_CMD_STATUS_ERROR;
 	}
@@ -4171,7 +4327,7 @@ RZ_IPI RzCmdStatus rz_analysis_function_vars_detect_handler(RzCore *core, int ar
 }
 
 RZ_IPI RzCmdStatus rz_analysis_function_vars_display_handler(RzCore *core, int argc, const char **argv) {
-	RzAnalysisFunction *fcn = analysis_get_function_in(core->analysis, core->offset);
+	RzAnalysisFunction *fcn = analysis_get_function_vars_in(core, core->offset);
 	if (!fcn) {
 		return RZ_CMD_STATUS_ERROR;
 	}
@@ -4212,7 +4368,7 @@ static int delta_cmp2(const void *a, const void *b) {
 }
 
 RZ_IPI RzCmdStatus rz_analysis_function_vars_stackframe_handler(RzCore *core, int argc, const char **argv) {
-	RzAnalysisFunction *fcn = analysis_get_function_in(core->analysis, core->offset);
+	RzAnalysisFunction *fcn = analysis_get_function_vars_in(core, core->offset);
 	if (!fcn) {
 		return RZ_CMD_STATUS_ERROR;
 	}
@@ -4253,7 +4409,7 @@ RZ_IPI RzCmdStatus rz_analysis_function_vars_rename_handler(RzCore *core, int ar
 }
 
 static RzCmdStatus analysis_function_vars_accesses(RzCore *core, int access_type, const char *varname) {
-	RzAnalysisFunction *fcn = analysis_get_function_in(core->analysis, core->offset);
+	RzAnalysisFunction *fcn = analysis_get_function_vars_in(core, core->offset);
 	if (!fcn) {
 		return RZ_CMD_STATUS_ERROR;
 	}
@@ -4286,7 +4442,7 @@ RZ_IPI RzCmdStatus rz_analysis_function_vars_writes_handler(RzCore *core, int ar
 }
 
 RZ_IPI RzCmdStatus rz_analysis_function_vars_type_handler(RzCore *core, int argc, const char **argv) {
-	RzAnalysisFunction *fcn = analysis_get_function_in(core->analysis, core->offset);
+	RzAnalysisFunction *fcn = analysis_get_function_vars_in(core, core->offset);
 	if (!fcn) {
 		return RZ_CMD_STATUS_ERROR;
 	}
@@ -4308,7 +4464,7 @@ RZ_IPI RzCmdStatus rz_analysis_function_vars_type_handler(RzCore *core, int argc
 }
 
 RZ_IPI RzCmdStatus rz_analysis_function_args_and_vars_xrefs_handler(RzCore *core, int argc, const char **argv, RzOutputMode mode, bool use_args, bool use_vars) {
-	RzAnalysisFunction *fcn = analysis_get_function_in(core->analysis, core->offset);
+	RzAnalysisFunction *fcn = analysis_get_function_vars_in(core, core->offset);
 	if (!fcn) {
 		return RZ_CMD_STATUS_ERROR;
 	}
@@ -4364,7 +4520,7 @@ static RzCmdStatus analysis_function_vars_kind_list(RzCore *core, RzAnalysisFunc
 }
 
 static RzCmdStatus analysis_function_vars_del(RzCore *core, RzAnalysisVarKind kind, const char *varname) {
-	RzAnalysisFunction *fcn = analysis_get_function_in(core->analysis, core->offset);
+	RzAnalysisFunction *fcn = analysis_get_function_vars_in(core, core->offset);
 	if (!fcn) {
 		return RZ_CMD_STATUS_ERROR;
 	}
@@ -4373,7 +4529,7 @@ static RzCmdStatus analysis_function_vars_del(RzCore *core, RzAnalysisVarKind ki
 }
 
 static RzCmdStatus analysis_function_vars_del_all(RzCore *core, RzAnalysisVarKind kind) {
-	RzAnalysisFunction *fcn = analysis_get_function_in(core->analysis, core->offset);
+	RzAnalysisFunction *fcn = analysis_get_function_vars_in(core, core->offset);
 	if (!fcn) {
 		return RZ_CMD_STATUS_ERROR;
 	}
@@ -4382,7 +4538,7 @@ static RzCmdStatus analysis_function_vars_del_all(RzCore *core, RzAnalysisVarKin
 }
 
 static RzCmdStatus analysis_function_vars_getsetref(RzCore *core, int delta, ut64 addr, RzAnalysisVarKind kind, RzAnalysisVarAccessType access_type) {
-	RzAnalysisFunction *fcn = analysis_get_function_in(core->analysis, core->offset);
+	RzAnalysisFunction *fcn = analysis_get_function_vars_in(core, core->offset);
 	if (!fcn) {
 		return RZ_CMD_STATUS_ERROR;
 	}
@@ -4406,7 +4562,7 @@ static RzCmdStatus analysis_function_vars_getsetref(RzCore *core, int delta, ut6
 /// --------- Base pointer based variable handlers -------------
 
 RZ_IPI RzCmdStatus rz_analysis_function_vars_bp_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state) {
-	RzAnalysisFunction *fcn = analysis_get_function_in(core->analysis, core->offset);
+	RzAnalysisFunction *fcn = analysis_get_function_vars_in(core, core->offset);
 	if (!fcn) {
 		return RZ_CMD_STATUS_ERROR;
 	}
@@ -4454,7 +4610,7 @@ RZ_IPI RzCmdStatus rz_analysis_function_vars_bp_setref_handler(RzCore *core, int
 /// --------- Register-based variable handlers -------------
 
 RZ_IPI RzCmdStatus rz_analysis_function_vars_regs_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state) {
-	RzAnalysisFunction *fcn = analysis_get_function_in(core->analysis, core->offset);
+	RzAnalysisFunction *fcn = analysis_get_function_vars_in(core, core->offset);
 	if (!fcn) {
 		return RZ_CMD_STATUS_ERROR;
 	}
@@ -4517,7 +4673,7 @@ RZ_IPI RzCmdStatus rz_analysis_function_vars_regs_setref_handler(RzCore *core, i
 /// --------- Stack-based variable handlers -------------
 
 RZ_IPI RzCmdStatus rz_analysis_function_vars_sp_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state) {
-	RzAnalysisFunction *fcn = analysis_get_function_in(core->analysis, core->offset);
+	RzAnalysisFunction *fcn = analysis_get_function_vars_in(core, core->offset);
 	if (!fcn) {
 		return RZ_CMD_STATUS_ERROR;
 	}
@@ -5251,6 +5407,8 @@ static void function_print_to_json(RzCore *core, RzAnalysisFunction *fcn, RzCmdS
 static void function_list_print_to_json(RzCore *core, RzList *list, RzCmdStateOutput *state) {
 	RzListIter *it;
 	RzAnalysisFunction *fcn;
+	// an entry takes about half a kilobyte
+	pj_reserve(state->d.pj, rz_list_length(list) * 512);
 	pj_a(state->d.pj);
 	rz_list_foreach (list, it, fcn) {
 		function_print_to_json(core, fcn, state);
@@ -5437,10 +5595,10 @@ RZ_IPI RzCmdStatus rz_analysis_function_list_ascii_handler(RzCore *core, int arg
 
 static void fcn_print_trace_info(RzDebugTrace *traced, RzAnalysisFunction *fcn) {
 	int tag = traced->tag;
-	RzListIter *iter;
-	RzDebugTracepoint *trace;
+	void **it;
 
-	rz_list_foreach (traced->traces, iter, trace) {
+	rz_pvector_foreach (traced->traces, it) {
+		RzDebugTracepoint *trace = *it;
 		if (!trace->tag || (tag & trace->tag)) {
 			if (rz_analysis_function_contains(fcn, trace->addr)) {
 				rz_cons_printf("\ntraced: %d\n", trace->times);
@@ -6140,6 +6298,12 @@ RZ_IPI RzCmdStatus rz_il_vm_step_until_addr_handler(RzCore *core, int argc, cons
 	return RZ_CMD_STATUS_OK;
 }
 
+RZ_IPI RzCmdStatus rz_il_vm_batch_handler(RzCore *core, int argc, const char **argv, RzOutputMode mode) {
+	ut64 until = rz_num_math(core->num, argv[3]);
+	ut64 max_steps = argc > 4 ? rz_num_math(core->num, argv[4]) : IL_BATCH_MAX_STEPS;
+	return rz_core_analysis_il_batch(core, argv[1], argv[2], until, max_steps, mode) ? RZ_CMD_STATUS_OK : RZ_CMD_STATUS_ERROR;
+}
+
 RZ_IPI RzCmdStatus rz_il_vm_status_handler(RzCore *core, int argc, const char **argv, RzOutputMode mode) {
 	if (argc == 3) {
 		ut64 value = rz_num_math(core->num, argv[2]);
@@ -7431,6 +7595,14 @@ RZ_IPI RzCmdStatus rz_analyze_everything_experimental_handler(RzCore *core, int
 	return RZ_CMD_STATUS_OK;
 }
 
+RZ_IPI RzCmdStatus rz_analyze_triage_handler(RzCore *core, int argc, const char **argv) {
+	rz_cons_break_push(NULL, NULL);
+	rz_cons_break_timeout(rz_config_get_i(core->config, "analysis.timeout"));
+	rz_core_analysis_triage(core, rz_config_get_b(core->config, "analysis.triage.discard"));
+	rz_cons_break_pop();
+	return RZ_CMD_STATUS_OK;
+}
+
 RZ_IPI RzCmdStatus rz_analyze_all_function_calls_handler(RzCore *core, int argc, const char **argv) {
 	rz_core_analysis_calls(core, false);
 	return RZ_CMD_STATUS_OK;
@@ -7494,6 +7666,10 @@ RZ_IPI RzCmdStatus rz_analyze_recursively_all_function_types_handler(RzCore *cor
 	return bool2status(rz_core_analysis_types_propagation(core));
 }
 
+RZ_IPI RzCmdStatus rz_analyze_dirty_functions_types_handler(RzCore *core, int argc, const char **argv) {
+	return bool2status(rz_core_analysis_types_propagation_dirty(core));
+}
+
 RZ_IPI RzCmdStatus rz_apply_signatures_from_sigdb_handler(RzCore *core, int argc, const char **argv) {
 	const char *filter = argc == 2 ? argv[1] : NULL;
 	return bool2status(rz_core_analysis_sigdb_apply(core, NULL, filter));
@@ -7515,6 +7691,9 @@ RZ_IPI RzCmdStatus rz_print_analysis_details_handler(RzCore *core, int argc, con
 	st64 call = rz_core_analysis_calls_count(core);
 	st64 xrfs = rz_analysis_xrefs_count(core->analysis);
 	double precentage = (code > 0) ? (covr * 100.0 / code) : 0;
+	RzSlabStats blocks, fcn_mem;
+	rz_analysis_arena_stats(core->analysis, &blocks, &fcn_mem);
+	bool arena = core->analysis->use_arena || blocks.chunks || fcn_mem.chunks;
 
 	switch (state->mode) {
 	case RZ_OUTPUT_MODE_STANDARD:
@@ -7528,6 +7707,12 @@ RZ_IPI RzCmdStatus rz_print_analysis_details_handler(RzCore *core, int argc, con
 		rz_cons_printf("coverage:    %" PFMT64d "\n", covr);
 		rz_cons_printf("code size:   %" PFMT64d "\n", code);
 		rz_cons_printf("percentuage: %.2f%% (coverage on code size)\n", precentage);
+		if (arena) {
+			rz_cons_printf("arena bbs:   %" PFMT64u " (%" PFMT64u " of %" PFMT64u " bytes)\n",
+				(ut64)blocks.used, (ut64)blocks.used_bytes, (ut64)blocks.reserved_bytes);
+			rz_cons_printf("arena fcns:  %" PFMT64u " (%" PFMT64u " of %" PFMT64u " bytes)\n",
+				(ut64)fcn_mem.used, (ut64)fcn_mem.used_bytes, (ut64)fcn_mem.reserved_bytes);
+		}
 		break;
 	case RZ_OUTPUT_MODE_JSON:
 		pj_o(state->d.pj);
@@ -7541,6 +7726,20 @@ RZ_IPI RzCmdStatus rz_print_analysis_details_handler(RzCore *core, int argc, con
 		pj_ki(state->d.pj, "covrage", covr);
 		pj_ki(state->d.pj, "codesz", code);
 		pj_ki(state->d.pj, "percent", precentage);
+		if (arena) {
+			pj_ko(state->d.pj, "arena");
+			pj_ko(state->d.pj, "bbs");
+			pj_kn(state->d.pj, "count", blocks.used);
+			pj_kn(state->d.pj, "used", blocks.used_bytes);
+			pj_kn(state->d.pj, "reserved", blocks.reserved_bytes);
+			pj_end(state->d.pj);
+			pj_ko(state->d.pj, "fcns");
+			pj_kn(state->d.pj, "count", fcn_mem.used);
+			pj_kn(state->d.pj, "used", fcn_mem.used_bytes);
+			pj_kn(state->d.pj, "reserved", fcn_mem.reserved_bytes);
+			pj_end(state->d.pj);
+			pj_end(state->d.pj);
+		}
 		pj_end(state->d.pj);
 		break;
 	default:
@@ -7550,6 +7749,40 @@ RZ_IPI RzCmdStatus rz_print_analysis_details_handler(RzCore *core, int argc, con
 	return RZ_CMD_STATUS_OK;
 }
 
+// aaP
+RZ_IPI RzCmdStatus rz_print_analysis_passes_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state) {
+	RzVector *passes = rz_core_analysis_passes(core);
+	if (!passes) {
+		RZ_LOG_ERROR("core: no aaa or aaaa ran yet\n");
+		return RZ_CMD_STATUS_ERROR;
+	}
+	if (state->mode == RZ_OUTPUT_MODE_JSON) {
+		rz_core_analysis_passes_json(core, state->d.pj);
+		return RZ_CMD_STATUS_OK;
+	}
+	rz_cmd_state_output_set_columnsf(state, "nnnnnnns", "wall", "cpu", "rss", "fcns", "bbs", "xrefs", "io", "name");
+	if (state->mode == RZ_OUTPUT_MODE_STANDARD) {
+		rz_cons_printf("%10s %10s %10s %7s %7s %7s %10s  %s\n", "wall", "cpu", "rss", "fcns", "bbs", "xrefs", "io", "name");
+	}
+	RzCoreAnalysisPass *pass;
+	rz_vector_foreach(passes, pass) {
+		switch (state->mode) {
+		case RZ_OUTPUT_MODE_STANDARD:
+			rz_cons_printf("%10" PFMT64u " %10" PFMT64u " %10" PFMT64u " %7" PFMT64d " %7" PFMT64d " %7" PFMT64d " %10" PFMT64u "  %s\n",
+				pass->wall_time, pass->cpu_time, pass->peak_rss, pass->functions, pass->blocks, pass->xrefs, pass->io_read, pass->name);
+			break;
+		case RZ_OUTPUT_MODE_TABLE:
+			rz_table_add_rowf(state->d.t, "nnnnnnns", pass->wall_time, pass->cpu_time, pass->peak_rss,
+				pass->functions, pass->blocks, pass->xrefs, pass->io_read, pass->name);
+			break;
+		default:
+			rz_warn_if_reached();
+			return RZ_CMD_STATUS_ERROR;
+		}
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
 RZ_IPI RzCmdStatus rz_analyze_all_unresolved_jumps_handler(RzCore *core, int argc, const char **argv) {
 	rz_core_analysis_resolve_jumps(core);
 	return RZ_CMD_STATUS_OK;
@@ -32,6 +32,9 @@
 #define MIN_SUMMARY_WIDTH    6
 #define MAX_RIGHT_ALIGHNMENT 20
 
+// json output of commands bigger than this goes to RzCons while it is produced
+#define STATE_JSON_STREAM_THRESHOLD (256 * 1024)
+
 // NOTE: this should be in sync with SPECIAL_CHARACTERS in
 //       rizin-shell-parser grammar, except for ", ' and
 //       whitespaces, because we let cmd_substitution_arg create
@@ -171,7 +174,7 @@ static RzCmdDesc *create_cmd_desc(RzCmd *cmd, RzCmdDesc *parent, RzCmdDescType t
 	res->n_children = 0;
 	res->help = help ? help : &not_defined_help;
 	rz_pvector_init(&res->children, (RzPVectorFree)cmd_desc_free);
-	if (ht_insert && !ht_pp_insert(cmd->ht_cmds, name, res)) {
+	if (ht_insert && !ht_pp_insert(cmd->ht_cmds, res->name, res)) {
 		goto err;
 	}
 	cmd_desc_set_parent(cmd, res, parent);
@@ -187,6 +190,17 @@ RZ_API void rz_cmd_alias_init(RzCmd *cmd) {
 	cmd->aliases.values = NULL;
 }
 
+static HtPP *ht_cmds_new(void) {
+	// the keys are the names owned by the descriptors, no need to copy them
+	HtPPOptions opt = {
+		.cmp = (HtPPListComparator)strcmp,
+		.hashfn = (HtPPHashFunction)sdb_hash,
+		.calcsizeK = (HtPPCalcSizeK)strlen,
+		.elem_size = sizeof(HtPPKv),
+	};
+	return ht_pp_new_opt(&opt);
+}
+
 RZ_API RzCmd *rz_cmd_new(bool has_cons) {
 	int i;
 	RzCmd *cmd = RZ_NEW0(RzCmd);
@@ -199,7 +213,7 @@ RZ_API RzCmd *rz_cmd_new(bool has_cons) {
 		cmd->cmds[i] = NULL;
 	}
 	cmd->nullcallback = cmd->data = NULL;
-	cmd->ht_cmds = ht_pp_new0();
+	cmd->ht_cmds = ht_cmds_new();
 	cmd->root_cmd_desc = create_cmd_desc(cmd, NULL, RZ_CMD_DESC_TYPE_GROUP, "", &root_help, true);
 	rz_cmd_macro_init(&cmd->macro);
 	rz_cmd_alias_init(cmd);
@@ -212,6 +226,8 @@ RZ_API RzCmd *rz_cmd_free(RzCmd *cmd) {
 		return NULL;
 	}
 	ht_up_free(cmd->ts_symbols_ht);
+	rz_list_free(cmd->ts_parsed);
+	rz_th_lock_free(cmd->ts_parsed_lock);
 	rz_cmd_alias_free(cmd);
 	rz_cmd_macro_fini(&cmd->macro);
 	ht_pp_free(cmd->ht_cmds);
@@ -703,6 +719,10 @@ static void args_preprocessing(RzCmdDesc *cd, RzCmdParsedArgs *args) {
 	}
 }
 
+static void state_json_sink(void *user, const char *s, size_t len) {
+	rz_cons_memcat(s, (int)len);
+}
+
 static RzCmdStatus argv_call_cb(RzCmd *cmd, RzCmdDesc *cd, RzCmdParsedArgs *args) {
 	if (!rz_cmd_desc_has_handler(cd)) {
 		return RZ_CMD_STATUS_NONEXISTINGCMD;
@@ -744,6 +764,9 @@ static RzCmdStatus argv_call_cb(RzCmd *cmd, RzCmdDesc *cd, RzCmdParsedArgs *args
 		if (!rz_cmd_state_output_init(&state, mode)) {
 			return RZ_CMD_STATUS_INVALID;
 		}
+		if (mode == RZ_OUTPUT_MODE_JSON || mode == RZ_OUTPUT_MODE_LONG_JSON) {
+			pj_set_sink(state.d.pj, state_json_sink, NULL, STATE_JSON_STREAM_THRESHOLD);
+		}
 		RzCmdStatus res = cd->d.argv_state_data.cb(cmd->data, args->argc, (const char **)args->argv, &state);
 		if (args->extra && state.mode == RZ_OUTPUT_MODE_TABLE) {
 			bool res = rz_table_query(state.d.t, args->extra);
@@ -2246,6 +2246,96 @@ RZ_IPI RzCmdStatus rz_cmd_debug_list_trace_session_mmap_handler(RzCore *core, in
 	return RZ_CMD_STATUS_OK;
 }
 
+// dtd
+RZ_IPI RzCmdStatus rz_cmd_debug_trace_drcov_handler(RzCore *core, int argc, const char **argv) {
+	RzBuffer *buf = rz_debug_trace_drcov(core->dbg);
+	if (!buf) {
+		RZ_LOG_ERROR("Cannot export the trace as drcov\n");
+		return RZ_CMD_STATUS_ERROR;
+	}
+	bool ok = rz_buf_dump(buf, argv[1]);
+	rz_buf_free(buf);
+	if (!ok) {
+		RZ_LOG_ERROR("Cannot write to %s\n", argv[1]);
+		return RZ_CMD_STATUS_ERROR;
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
+// dtm
+RZ_IPI RzCmdStatus rz_cmd_debug_trace_maps_coverage_handler(RzCore *core, int argc, const char **argv) {
+	rz_debug_map_sync(core->dbg);
+	RzListIter *iter;
+	RzDebugMap *map;
+	rz_list_foreach (core->dbg->maps, iter, map) {
+		if (!(map->perm & RZ_PERM_X) || map->addr >= map->addr_end) {
+			continue;
+		}
+		ut64 covered = 0;
+		RzBitmap *bm = rz_debug_trace_coverage(core->dbg, map->addr, map->addr_end, &covered);
+		if (!bm) {
+			return RZ_CMD_STATUS_ERROR;
+		}
+		rz_bitmap_free(bm);
+		ut64 size = map->addr_end - map->addr;
+		rz_cons_printf("0x%08" PFMT64x " - 0x%08" PFMT64x " %" PFMT64u "/%" PFMT64u " %.2f%% %s\n",
+			map->addr, map->addr_end, covered, size, covered * 100.0 / size, map->name ? map->name : "");
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
+// dtsc
+RZ_IPI RzCmdStatus rz_cmd_debug_trace_session_changed_pages_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state) {
+	RzDebugSession *session = core->dbg->session;
+	if (!session || rz_vector_empty(session->checkpoints)) {
+		RZ_LOG_ERROR("No session checkpoint to compare with\n");
+		return RZ_CMD_STATUS_ERROR;
+	}
+	RzDebugCheckpoint *chkpt = rz_vector_tail(session->checkpoints);
+	RzThreadTaskPool *pool = rz_core_get_task_pool(core);
+	PJ *pj = state->d.pj;
+	if (state->mode == RZ_OUTPUT_MODE_JSON) {
+		pj_a(pj);
+	}
+	RzListIter *iter;
+	RzDebugSnap *snap;
+	rz_list_foreach (chkpt->snaps, iter, snap) {
+		RzBitmap *changed = rz_debug_snap_diff_live(core->dbg, snap, pool);
+		if (!changed) {
+			continue;
+		}
+		if (state->mode == RZ_OUTPUT_MODE_JSON) {
+			pj_o(pj);
+			pj_ks(pj, "name", snap->name);
+			pj_kn(pj, "addr", snap->addr);
+			pj_ka(pj, "pages");
+		}
+		for (size_t i = rz_bitmap_next_set(changed, 0); i < snap->pages_count; i = rz_bitmap_next_set(changed, i + 1)) {
+			ut64 addr = snap->addr + (ut64)i * RZ_DEBUG_SNAP_PAGE_SIZE;
+			switch (state->mode) {
+			case RZ_OUTPUT_MODE_JSON:
+				pj_n(pj, addr);
+				break;
+			case RZ_OUTPUT_MODE_QUIET:
+				rz_cons_printf("0x%08" PFMT64x "\n", addr);
+				break;
+			default:
+				rz_cons_printf("0x%08" PFMT64x " %s\n", addr, snap->name);
+				break;
+			}
+		}
+		if (state->mode == RZ_OUTPUT_MODE_JSON) {
+			pj_end(pj);
+			pj_end(pj);
+		}
+		rz_bitmap_free(changed);
+	}
+	if (state->mode == RZ_OUTPUT_MODE_JSON) {
+		pj_end(pj);
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
 // dtt
 RZ_IPI RzCmdStatus rz_cmd_debug_trace_tag_handler(RzCore *core, int argc, const char **argv) {
 	int tag = rz_num_math(core->num, argv[1]);
@@ -3171,6 +3261,69 @@ RZ_IPI RzCmdStatus rz_cmd_debug_bt_disable_bp_trace_handler(RzCore *core, int ar
 	return RZ_CMD_STATUS_OK;
 }
 
+// dbB
+RZ_IPI RzCmdStatus rz_cmd_debug_coverage_start_handler(RzCore *core, int argc, const char **argv) {
+	if (!rz_debug_coverage_start(core->dbg)) {
+		RZ_LOG_ERROR("Cannot start the block coverage\n");
+		return RZ_CMD_STATUS_ERROR;
+	}
+	rz_cons_printf("%d blocks armed\n", (int)rz_vector_len(&core->dbg->coverage->blocks));
+	return RZ_CMD_STATUS_OK;
+}
+
+// dbB-
+RZ_IPI RzCmdStatus rz_cmd_debug_coverage_stop_handler(RzCore *core, int argc, const char **argv) {
+	if (!core->dbg->coverage) {
+		RZ_LOG_ERROR("Block coverage is not running\n");
+		return RZ_CMD_STATUS_ERROR;
+	}
+	return rz_debug_coverage_stop(core->dbg) ? RZ_CMD_STATUS_OK : RZ_CMD_STATUS_ERROR;
+}
+
+// dbBl
+RZ_IPI RzCmdStatus rz_cmd_debug_coverage_list_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state) {
+	RzDebugCoverage *cov = core->dbg->coverage;
+	if (!cov) {
+		RZ_LOG_ERROR("Block coverage is not running\n");
+		return RZ_CMD_STATUS_ERROR;
+	}
+	PJ *pj = state->d.pj;
+	if (state->mode == RZ_OUTPUT_MODE_JSON) {
+		pj_o(pj);
+		pj_kn(pj, "blocks", rz_vector_len(&cov->blocks));
+		pj_kn(pj, "hits", cov->hits);
+		pj_ka(pj, "list");
+	}
+	RzDebugCoverageBlock *b;
+	rz_vector_foreach(&cov->blocks, b) {
+		switch (state->mode) {
+		case RZ_OUTPUT_MODE_JSON:
+			pj_o(pj);
+			pj_kn(pj, "addr", b->addr);
+			pj_kn(pj, "size", b->size);
+			pj_kb(pj, "hit", b->hit);
+			pj_end(pj);
+			break;
+		case RZ_OUTPUT_MODE_QUIET:
+			if (b->hit) {
+				rz_cons_printf("0x%08" PFMT64x "\n", b->addr);
+			}
+			break;
+		default:
+			rz_cons_printf("0x%08" PFMT64x " %5u %s\n", b->addr, b->size,
+				b->hit ? "hit" : (b->trap_size ? "-" : "unarmed"));
+			break;
+		}
+	}
+	if (state->mode == RZ_OUTPUT_MODE_JSON) {
+		pj_end(pj);
+		pj_end(pj);
+	} else if (state->mode == RZ_OUTPUT_MODE_STANDARD) {
+		rz_cons_printf("%" PFMT64u "/%d blocks hit\n", cov->hits, (int)rz_vector_len(&cov->blocks));
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
 // dbts
 RZ_IPI RzCmdStatus rz_cmd_debug_bt_toggle_bp_trace_handler(RzCore *core, int argc, const char **argv) {
 	RzBreakpointItem *bpi = rz_bp_get_in(core->dbg->bp, core->offset, 0);
@@ -3253,6 +3406,30 @@ RZ_IPI RzCmdStatus rz_cmd_debug_continue_execution_handler(RzCore *core, int arg
 	return RZ_CMD_STATUS_OK;
 }
 
+// dca
+RZ_IPI RzCmdStatus rz_cmd_debug_continue_async_handler(RzCore *core, int argc, const char **argv) {
+	CMD_CHECK_DEBUG_DEAD(core);
+	if (rz_debug_is_running(core->dbg)) {
+		RZ_LOG_ERROR("The target is already running\n");
+		return RZ_CMD_STATUS_ERROR;
+	}
+	if (!rz_core_debug_continue_async(core)) {
+		RZ_LOG_WARN("Cannot continue in the background, continuing\n");
+		rz_core_debug_continue(core);
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
+// dcw
+RZ_IPI RzCmdStatus rz_cmd_debug_continue_wait_handler(RzCore *core, int argc, const char **argv) {
+	if (!rz_debug_is_running(core->dbg)) {
+		RZ_LOG_ERROR("The target is not running\n");
+		return RZ_CMD_STATUS_ERROR;
+	}
+	rz_core_debug_async_collect(core, true);
+	return RZ_CMD_STATUS_OK;
+}
+
 // dcb
 RZ_IPI RzCmdStatus rz_cmd_debug_continue_back_handler(RzCore *core, int argc, const char **argv) {
 	CMD_CHECK_DEBUG_DEAD(core);
@@ -107,6 +107,7 @@ static const char *help_msg_question[] = {
 	"?iy", " prompt", "yesno input prompt",
 	"?j", " arg", "same as '? num' but in JSON",
 	"?l", "[q] str", "returns the length of string ('q' for quiet, just set $?)",
+	"?M", "[j]", "show the memory held by each subsystem (needs -Dmem_accounting=true)",
 	"?o", " num", "get octal value",
 	"?P", " paddr", "get virtual address for given physical one",
 	"?p", " vaddr", "get physical address for given virtual address",
@@ -416,6 +417,41 @@ RZ_API void rz_core_clippy(RzCore *core, const char *msg) {
 	free(s);
 }
 
+static void cmd_help_mem_account(bool json) {
+	if (!rz_mem_account_enabled()) {
+		RZ_LOG_ERROR("core: memory accounting is disabled, rebuild with -Dmem_accounting=true\n");
+		return;
+	}
+	PJ *pj = json ? pj_new() : NULL;
+	if (pj) {
+		pj_a(pj);
+	} else {
+		rz_cons_printf("%-10s %14s %10s %14s %10s\n", "category", "live_bytes", "objects", "peak_bytes", "total");
+	}
+	for (int i = 0; i < RZ_MEM_ACCOUNT_COUNT; i++) {
+		RzMemAccountStats stats;
+		rz_mem_account_stats(i, &stats);
+		const char *name = rz_mem_account_category_name(i);
+		if (pj) {
+			pj_o(pj);
+			pj_ks(pj, "category", name);
+			pj_kn(pj, "live_bytes", stats.live_bytes);
+			pj_kn(pj, "live_objects", stats.live_objects);
+			pj_kn(pj, "peak_bytes", stats.peak_bytes);
+			pj_kn(pj, "total_objects", stats.total_objects);
+			pj_end(pj);
+		} else {
+			rz_cons_printf("%-10s %14" PFMT64u " %10" PFMT64u " %14" PFMT64u " %10" PFMT64u "\n",
+				name, stats.live_bytes, stats.live_objects, stats.peak_bytes, stats.total_objects);
+		}
+	}
+	if (pj) {
+		pj_end(pj);
+		rz_cons_println(pj_string(pj));
+		pj_free(pj);
+	}
+}
+
 RZ_IPI int rz_cmd_help(void *data, const char *input) {
 	RzCore *core = (RzCore *)data;
 	RzIOMap *map;
@@ -543,6 +579,9 @@ RZ_IPI int rz_cmd_help(void *data, const char *input) {
 			core->times->loadlibs_time,
 			core->times->file_open_time);
 		break;
+	case 'M': // "?M"
+		cmd_help_mem_account(input[1] == 'j');
+		break;
 	case 'u': // "?u"
 	{
 		char unit[8];
@@ -48,6 +48,13 @@ static bool is_equal_file_hashes(RzList *lfile_hashes, RzList *rfile_hashes, boo
 	return true;
 }
 
+static bool source_file_insert_cb(void *user, const RzBinSourceLineSample *s) {
+	if (s->line && s->file) {
+		ht_pp_insert(user, s->file, NULL);
+	}
+	return true;
+}
+
 static bool source_file_collect_cb(void *user, const void *k, const void *v) {
 	RzPVector *r = user;
 	char *f = strdup(k);
@@ -69,7 +76,7 @@ static bool print_source_info(RzCore *core, PrintSourceInfoType type, RzCmdState
 		rz_cons_printf("No file loaded.\n");
 		return false;
 	}
-	RzBinSourceLineInfo *li = binfile->o->lines;
+	RzBinSourceLineIndex *li = binfile->o->lines;
 	if (!li) {
 		rz_cons_printf("No source info available.\n");
 		return true;
@@ -81,13 +88,7 @@ static bool print_source_info(RzCore *core, PrintSourceInfoType type, RzCmdState
 		if (!files) {
 			return false;
 		}
-		for (size_t i = 0; i < li->samples_count; i++) {
-			RzBinSourceLineSample *s = &li->samples[i];
-			if (!s->line || !s->file) {
-				continue;
-			}
-			ht_pp_insert(files, s->file, NULL);
-		}
+		rz_bin_source_line_index_foreach(li, source_file_insert_cb, files);
 		// sort them alphabetically
 		RzPVector sorter;
 		rz_pvector_init(&sorter, free);
@@ -114,15 +115,10 @@ static bool print_source_info(RzCore *core, PrintSourceInfoType type, RzCmdState
 		break;
 	}
 	case PRINT_SOURCE_INFO_LINES_ALL:
-		rz_core_bin_print_source_line_info(core, li, state);
+		rz_core_bin_print_source_line_index(core, li, state);
 		break;
 	case PRINT_SOURCE_INFO_LINES_HERE:
-		rz_cmd_state_output_array_start(state);
-		for (const RzBinSourceLineSample *s = rz_bin_source_line_info_get_first_at(li, core->offset);
-			s; s = rz_bin_source_line_info_get_next(li, s)) {
-			rz_core_bin_print_source_line_sample(core, s, state);
-		}
-		rz_cmd_state_output_array_end(state);
+		rz_core_bin_print_source_line_index_at(core, li, core->offset, state);
 		break;
 	}
 	return true;
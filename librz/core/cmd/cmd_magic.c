@@ -13,6 +13,15 @@ static void rz_core_magic_reset(RzCore *core) {
 	kw_count = 0;
 }
 
+// whether rz_magic_buffer() found nothing worth reporting
+static bool magic_str_is_data(const char *str) {
+#if USE_LIB_MAGIC
+	return !strcmp(str, "data") || strstr(str, "ASCII") || strstr(str, "ISO") || strstr(str, "no line terminator");
+#else
+	return !strcmp(str, "data");
+#endif
+}
+
 static int rz_core_magic_at(RzCore *core, const char *file, ut64 addr, int depth, int v, PJ *pj, int *hits) {
 	const char *fmt;
 	char *q, *p;
@@ -96,11 +105,7 @@ static int rz_core_magic_at(RzCore *core, const char *file, ut64 addr, int depth
 	str = rz_magic_buffer(ck, core->block + delta, core->blocksize - delta);
 	if (str) {
 		const char *cmdhit;
-#if USE_LIB_MAGIC
-		if (!v && (!strcmp(str, "data") || strstr(str, "ASCII") || strstr(str, "ISO") || strstr(str, "no line terminator"))) {
-#else
-		if (!v && (!strcmp(str, "data"))) {
-#endif
+		if (!v && magic_str_is_data(str)) {
 			int mod = core->search->align;
 			if (mod < 1) {
 				mod = 1;
@@ -189,6 +194,133 @@ seek_exit:
 	return ret;
 }
 
+/*
+ * For /m: what rz_magic_buffer() returns at each offset of a range, computed
+ * ahead on the task pool with one RzMagic per worker. rz_core_magic_at() then
+ * only runs at the offsets that matched, the others are skipped by
+ * rz_core_magic_skip() exactly as rz_core_magic_at() would have.
+ */
+typedef enum {
+	MAGIC_PROBE_UNKNOWN = 0, ///< not probed, rz_core_magic_at() has to look
+	MAGIC_PROBE_NONE, ///< rz_magic_buffer() failed
+	MAGIC_PROBE_DATA, ///< nothing but "data"
+	MAGIC_PROBE_HIT,
+} MagicProbe;
+
+#define MAGIC_PROBE_CHUNK (1024 * 1024)
+#define MAGIC_PROBE_SLICE (64 * 1024)
+
+typedef struct {
+	RzThreadTaskPool *pool;
+	RzThreadLock *lock;
+	RzMagic **magics; ///< one per worker
+	const ut8 *buf; ///< bytes at from, plus a block of tail
+	ut64 from;
+	ut64 len; ///< number of offsets to probe
+	ut64 blk_from; ///< core->offset, rz_core_magic_at() serves its block from there
+	ut32 bsize;
+	ut32 align;
+	ut8 *probes;
+	ut64 next_slice;
+} MagicProbeBatch;
+
+static void magic_probe_run(size_t from, size_t to, void *user) {
+	MagicProbeBatch *batch = user;
+	for (size_t w = from; w < to; w++) {
+		RzMagic *ck = batch->magics[w];
+		while (!rz_th_task_pool_is_breaked(batch->pool)) {
+			rz_th_lock_enter(batch->lock);
+			ut64 start = batch->next_slice;
+			batch->next_slice += MAGIC_PROBE_SLICE;
+			rz_th_lock_leave(batch->lock);
+			if (start >= batch->len) {
+				break;
+			}
+			ut64 end = RZ_MIN(start + MAGIC_PROBE_SLICE, batch->len);
+			for (ut64 i = start; i < end; i++) {
+				ut64 addr = batch->from + i;
+				if (batch->align && addr % batch->align) {
+					// rz_core_magic_skip() checks the alignment first
+					batch->probes[i] = MAGIC_PROBE_NONE;
+					continue;
+				}
+				// same window as rz_core_magic_at(): the rest of the block, or a new block
+				bool in_block = addr >= batch->blk_from && addr + NAH < batch->blk_from + batch->bsize;
+				size_t len = in_block ? batch->blk_from + batch->bsize - addr : batch->bsize;
+				const char *str = rz_magic_buffer(ck, batch->buf + i, len);
+				batch->probes[i] = !str ? MAGIC_PROBE_NONE : magic_str_is_data(str) ? MAGIC_PROBE_DATA
+												   : MAGIC_PROBE_HIT;
+			}
+		}
+	}
+}
+
+/**
+ * Probe the \p len offsets from \p from with the magic file \p file, or dir.magic.
+ * \return the MagicProbe of each offset, or NULL if they could not be probed
+ */
+static ut8 *rz_core_magic_probe(RzCore *core, const char *file, ut64 from, ut64 len) {
+	if (file && *file == ' ') {
+		file++;
+	}
+	const char *path = file && *file ? file : rz_config_get(core->config, "dir.magic");
+	RzThreadTaskPool *pool = rz_core_get_task_pool(core);
+	size_t n_workers = pool ? RZ_MAX(rz_th_task_pool_size(pool), 1) : 1;
+	n_workers = RZ_MIN(n_workers, (len + MAGIC_PROBE_SLICE - 1) / MAGIC_PROBE_SLICE);
+	MagicProbeBatch batch = {
+		.pool = pool,
+		.lock = rz_th_lock_new(false),
+		.magics = RZ_NEWS0(RzMagic *, n_workers),
+		.buf = malloc(len + core->blocksize),
+		.from = from,
+		.len = len,
+		.blk_from = core->offset,
+		.bsize = core->blocksize,
+		.align = core->search->align,
+		.probes = calloc(len, 1),
+	};
+	bool succ = batch.lock && batch.magics && batch.buf && batch.probes;
+	// loaded here because parsing the magic files is not thread-safe
+	for (size_t i = 0; succ && i < n_workers; i++) {
+		batch.magics[i] = rz_magic_new(0);
+		succ = batch.magics[i] && rz_magic_load(batch.magics[i], path);
+	}
+	if (succ) {
+		rz_io_read_at(core->io, from, (ut8 *)batch.buf, len + core->blocksize);
+		if (!pool || n_workers < 2 || !rz_th_task_pool_parallel_for(pool, 0, n_workers, 1, magic_probe_run, &batch)) {
+			// probes the slices the pool did not pick up, if any
+			magic_probe_run(0, 1, &batch);
+		}
+	}
+	for (size_t i = 0; batch.magics && i < n_workers; i++) {
+		rz_magic_free(batch.magics[i]);
+	}
+	free(batch.magics);
+	free((ut8 *)batch.buf);
+	rz_th_lock_free(batch.lock);
+	if (!succ) {
+		RZ_FREE(batch.probes);
+	}
+	return batch.probes;
+}
+
+/**
+ * What rz_core_magic_at() returns at \p addr for \p probe, which is not a hit.
+ */
+static int rz_core_magic_skip(RzCore *core, ut64 addr, MagicProbe probe, PJ *pj, int hits) {
+	int align = core->search->align;
+	if (align && addr % align) {
+		return addr % align;
+	}
+	if (!pj && ((addr & 7) == 0) && ((addr & (7 << 8)) == 0)) {
+		eprintf("0x%08" PFMT64x " [%d matches found]\r", addr, hits);
+	}
+	if (probe == MAGIC_PROBE_DATA) {
+		return RZ_MAX(align, 1) + 1;
+	}
+	return align ? align : 1;
+}
+
 static void rz_core_magic(RzCore *core, const char *file, int v, PJ *pj) {
 	ut64 addr = core->offset;
 	int hits = 0;
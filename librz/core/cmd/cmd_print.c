@@ -1736,7 +1736,12 @@ static void cmd_print_format(RzCore *core, const char *_input, const ut8 *block,
 			eprintf("cannot allocate %d byte(s)\n", size);
 			goto stage_left;
 		}
-		memcpy(buf, core->block, core->blocksize);
+		if (size > core->blocksize) {
+			/* read the whole structure at once instead of past the block */
+			rz_io_read_at(core->io, core->offset, buf, size);
+		} else {
+			memcpy(buf, core->block, core->blocksize);
+		}
 		/* check if fmt is '\d+ \d+<...>', common mistake due to usage string*/
 		bool syntax_ok = true;
 		char *args = strdup(fmt);
@@ -3589,6 +3594,38 @@ static void core_print_columns(RzCore *core, const ut8 *buf, ut32 len, ut32 heig
 	}
 }
 
+/* most bytes read at once when computing the entropy of blocks */
+#define ENTROPY_BARS_BATCH 0x1000000
+
+/*
+ * Fill ptr with the entropy fraction of each of the nblocks blocks, scaled to 0-255.
+ * Many blocks are read at once and computed in parallel on the core task pool.
+ */
+static bool entropy_bars(RzCore *core, ut8 *ptr, size_t nblocks, ut64 blocksize, size_t skipblocks, ut64 from) {
+	size_t batch = RZ_MAX(ENTROPY_BARS_BATCH / RZ_MAX(blocksize, 1), 1);
+	batch = RZ_MIN(batch, nblocks);
+	ut8 *buf = batch ? malloc(batch * blocksize) : NULL;
+	double *entropies = RZ_NEWS(double, batch);
+	if (!buf || !entropies) {
+		free(buf);
+		free(entropies);
+		return false;
+	}
+	RzThreadTaskPool *pool = nblocks > 1 ? rz_core_get_task_pool(core) : NULL;
+	for (size_t i = 0; i < nblocks; i += batch) {
+		size_t n = RZ_MIN(batch, nblocks - i);
+		ut64 off = from + (blocksize * (i + skipblocks));
+		rz_io_read_at(core->io, off, buf, n * blocksize);
+		rz_hash_entropy_blocks(core->hash, pool, buf, blocksize, n, true, entropies);
+		for (size_t j = 0; j < n; j++) {
+			ptr[i + j] = (ut8)(255 * entropies[j]);
+		}
+	}
+	free(buf);
+	free(entropies);
+	return true;
+}
+
 static void cmd_print_bars(RzCore *core, const char *input) {
 	bool print_bars = false;
 	ut8 *ptr = NULL;
@@ -3784,25 +3821,16 @@ static void cmd_print_bars(RzCore *core, const char *input) {
 		} break;
 		case 'e': // "p=e"
 		{
-			ut8 *p;
-			int i = 0;
 			ptr = calloc(1, nblocks);
 			if (!ptr) {
 				eprintf("Error: failed to malloc memory");
 				goto beach;
 			}
-			p = malloc(blocksize);
-			if (!p) {
+			if (!entropy_bars(core, ptr, nblocks, blocksize, skipblocks, from)) {
 				RZ_FREE(ptr);
 				eprintf("Error: failed to malloc memory");
 				goto beach;
 			}
-			for (i = 0; i < nblocks; i++) {
-				ut64 off = from + (blocksize * (i + skipblocks));
-				rz_io_read_at(core->io, off, p, blocksize);
-				ptr[i] = (ut8)(255 * rz_hash_entropy_fraction(core->hash, p, blocksize));
-			}
-			free(p);
 			core_print_columns(core, ptr, nblocks, 14);
 		} break;
 		default:
@@ -3883,25 +3911,16 @@ static void cmd_print_bars(RzCore *core, const char *input) {
 	} break;
 	case 'e': // "p=e" entropy
 	{
-		ut8 *p;
-		int i = 0;
 		ptr = calloc(1, nblocks);
 		if (!ptr) {
 			eprintf("Error: failed to malloc memory");
 			goto beach;
 		}
-		p = malloc(blocksize);
-		if (!p) {
+		if (!entropy_bars(core, ptr, nblocks, blocksize, skipblocks, from)) {
 			RZ_FREE(ptr);
 			eprintf("Error: failed to malloc memory");
 			goto beach;
 		}
-		for (i = 0; i < nblocks; i++) {
-			ut64 off = from + (blocksize * (i + skipblocks));
-			rz_io_read_at(core->io, off, p, blocksize);
-			ptr[i] = (ut8)(255 * rz_hash_entropy_fraction(core->hash, p, blocksize));
-		}
-		free(p);
 		print_bars = true;
 	} break;
 	case '0': // 0x00 bytes
@@ -7027,15 +7046,26 @@ RZ_IPI RzCmdStatus rz_cmd_sizes_of_n_instructions_handler(RzCore *core, int argc
 
 	rz_cmd_state_output_array_start(state);
 	rz_cons_break_push(NULL, NULL);
+	// only the sizes are needed, so the instructions are decoded in batches without text
+	RzAsmInsn insns[64];
+	int count = 0, pos = 0;
 	for (ut32 i = 0, j = 0; i < core->blocksize && j < RZ_ABS(n_instrs); i += ret, j++) {
-		RzAsmOp asm_op = { 0 };
-		ret = rz_asm_disassemble(core->rasm, &asm_op, core->block + i, core->blocksize - i);
+		if (pos >= count) {
+			rz_asm_set_pc(core->rasm, core->offset + i);
+			count = rz_asm_disassemble_batch(core->rasm, core->block + i, core->blocksize - i,
+				insns, RZ_MIN(RZ_ARRAY_SIZE(insns), RZ_ABS(n_instrs) - j), NULL);
+			pos = 0;
+			if (count < 1) {
+				break;
+			}
+		}
+		RzAsmInsn *insn = &insns[pos++];
 		if (rz_cons_is_breaked()) {
 			break;
 		}
 		// be sure to return 0 when it fails to disassemble the
 		// instruction to uniform the output across all disassemblers.
-		int op_size = ret < 1 ? 0 : ret;
+		int op_size = insn->invalid ? 0 : insn->size;
 		switch (state->mode) {
 		case RZ_OUTPUT_MODE_STANDARD:
 			rz_cons_printf("%d\n", op_size);
@@ -7047,9 +7077,7 @@ RZ_IPI RzCmdStatus rz_cmd_sizes_of_n_instructions_handler(RzCore *core, int argc
 			rz_warn_if_reached();
 			return RZ_CMD_STATUS_ERROR;
 		}
-		if (ret < 1) {
-			ret = 1;
-		}
+		ret = insn->size;
 	}
 	rz_cons_break_pop();
 	rz_cmd_state_output_array_end(state);
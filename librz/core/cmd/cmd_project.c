@@ -33,7 +33,8 @@ RZ_IPI RzCmdStatus rz_project_save_handler(RzCore *core, int argc, const char **
 		file = argv[1];
 	}
 	bool compress = rz_config_get_b(core->config, "prj.compress");
-	RzProjectErr err = rz_project_save_file(core, file, compress);
+	RzProjectFormat format = rz_config_get_b(core->config, "prj.binary") ? RZ_PROJECT_FORMAT_BINARY : RZ_PROJECT_FORMAT_TEXT;
+	RzProjectErr err = rz_project_save_file_as(core, file, format, compress);
 	if (err != RZ_PROJECT_ERR_SUCCESS) {
 		eprintf("Failed to save project to file %s: %s\n", file, rz_project_err_message(err));
 	}
@@ -15,6 +15,9 @@
 #define AES_SEARCH_LENGTH         40
 #define PRIVATE_KEY_SEARCH_LENGTH 11
 
+// Amount of data read at once by the parallel keyword search
+#define SEARCH_PARALLEL_SIZE (16 * 1024 * 1024)
+
 static const char *help_msg_search_esil[] = {
 	"/E", " [esil-expr]", "search offsets matching a specific esil expression",
 	"/Ej", " [esil-expr]", "same as above but using the given magic file",
@@ -24,6 +27,16 @@ static const char *help_msg_search_esil[] = {
 	NULL
 };
 
+static const char *help_msg_slash_I[] = {
+	"Usage: /I", "", "Index the 4-byte grams of the search boundaries, for the next keyword searches",
+	"/I", "", "List the indexes",
+	"/Ib", "", "Build an index of each map in the search boundaries",
+	"/I-", "", "Drop all the indexes",
+	"/Il", " [file]", "Load the indexes from file",
+	"/Is", " [file]", "Save the indexes to file",
+	NULL
+};
+
 static const char *help_msg_slash_m[] = {
 	"/m", "", "search for known magic patterns",
 	"/m", " [file]", "same as above but using the given magic file",
@@ -52,6 +65,7 @@ static const char *help_msg_slash[] = {
 	"/g", "[g] [from]", "find all graph paths A to B (/gg follow jumps, see search.count and analysis.depth)",
 	"/h", "[t] [hash] [len]", "find block matching this hash. See ph",
 	"/i", " foo", "search for string 'foo' ignoring case",
+	"/I", "[?]", "index the search boundaries to speed up the next keyword searches",
 	"/m", "[?][ebm] magicfile", "search for magic, filesystems or binary headers",
 	"/o", " [n]", "show offset of n instructions backward",
 	"/O", " [n]", "same as /o, but with a different fallback if analysis cannot be used",
@@ -130,11 +144,24 @@ static const char *help_msg_slash_R[] = {
 	"/R/j", " [filter-by-regexp]", "JSON output [regular expression]",
 	"/R/q", " [filter-by-regexp]", "Show gadgets in a quiet manner [regular expression]",
 	"/Rj", " [filter-by-string]", "JSON output",
+	"/Ri", "[?]", "Build and query an index of all the gadgets",
 	"/Rk", " [select-by-class]", "Query stored ROP gadgets",
 	"/Rq", " [filter-by-string]", "Show gadgets in a quiet manner",
 	NULL
 };
 
+static const char *help_msg_slash_Ri[] = {
+	"Usage: /Ri", "", "Query the ROP gadget index",
+	"/Rib", "", "Build the index with every gadget in the search boundaries",
+	"/Ri", " [filter-by-string]", "Show indexed gadgets",
+	"/Ri/", " [filter-by-regexp]", "Show indexed gadgets [regular expression]",
+	"/Rij", " [filter-by-string]", "JSON output",
+	"/Riq", " [filter-by-string]", "Show indexed gadgets in a quiet manner",
+	"/Ril", " [file]", "Load the index from file",
+	"/Ris", " [file]", "Save the index to file",
+	NULL
+};
+
 static const char *help_msg_slash_Rk[] = {
 	"Usage: /Rk", "", "Query stored ROP gadgets",
 	"/Rk", " [nop|mov|const|arithm|arithm_ct]", "Show gadgets",
@@ -979,29 +1006,104 @@ static bool is_end_gadget(const RzAnalysisOp *aop, const ut8 crop) {
 	return false;
 }
 
-static bool insert_into(void *user, const ut64 k, const ut64 v) {
-	HtUU *ht = (HtUU *)user;
-	ht_uu_insert(ht, k, v);
-	return true;
+/*
+ * The gadgets ending at the same end gadget start at different offsets, but
+ * most of them soon decode in sync and share their tail. The decoded
+ * instructions are cached by their index in the search buffer, so that these
+ * tails are decoded only once.
+ */
+typedef struct {
+	int size; ///< < 0 if the bytes could not be decoded
+	bool end; ///< end gadget or nop, which can't start a gadget
+	char *opstr; ///< NULL if the instruction is invalid
+} RopOp;
+
+typedef struct {
+	RzAnalysis *analysis;
+	RzAsm *rasm; ///< fallback for plugins without disassembly, only set on the main thread
+	HtUP *ops; ///< buffer index => RopOp *
+} RopDecoder;
+
+static void rop_op_kv_free(HtUPKv *kv) {
+	RopOp *op = kv->value;
+	if (op) {
+		free(op->opstr);
+		free(op);
+	}
 }
 
-// TODO: follow unconditional jumps
-static RzList *construct_rop_gadget(RzCore *core, ut64 addr, ut8 *buf, int buflen, int idx, const char *grep, int regex, RzList *rx_list, struct endlist_pair *end_gadget, HtUU *badstart) {
-	int endaddr = end_gadget->instr_offset;
-	int branch_delay = end_gadget->delay_size;
+static bool rop_decoder_init(RopDecoder *d, RzAnalysis *analysis, RzAsm *rasm) {
+	d->analysis = analysis;
+	d->rasm = rasm;
+	d->ops = ht_up_new(NULL, rop_op_kv_free, NULL);
+	return d->ops;
+}
+
+static void rop_decoder_fini(RopDecoder *d) {
+	ht_up_free(d->ops);
+	d->ops = NULL;
+}
+
+/**
+ * Forget the cached instructions, before moving on to the next end gadget
+ */
+static void rop_decoder_reset(RopDecoder *d) {
+	if (d->ops && d->ops->count) {
+		ht_up_free(d->ops);
+		d->ops = ht_up_new(NULL, rop_op_kv_free, NULL);
+	}
+}
+
+static RopOp *rop_decoder_op(RopDecoder *d, ut64 addr, const ut8 *buf, int buflen, int idx) {
+	RopOp *op = ht_up_find(d->ops, idx, NULL);
+	if (op) {
+		return op;
+	}
+	op = RZ_NEW0(RopOp);
+	if (!op) {
+		return NULL;
+	}
 	RzAnalysisOp aop = { 0 };
+	int error = rz_analysis_op(d->analysis, &aop, addr, buf + idx, buflen - idx, RZ_ANALYSIS_OP_MASK_DISASM);
+	op->size = error < 0 ? -1 : aop.size;
+	op->end = is_end_gadget(&aop, 0) || aop.type == RZ_ANALYSIS_OP_TYPE_NOP;
+	if (op->size >= 0) {
+		if (aop.mnemonic) {
+			op->opstr = strdup(aop.mnemonic);
+		} else if (d->rasm) {
+			RZ_LOG_WARN("Analysis plugin %s did not return disassembly\n", d->analysis->cur->name);
+			RzAsmOp asmop;
+			rz_asm_set_pc(d->rasm, addr);
+			if (rz_asm_disassemble(d->rasm, &asmop, buf + idx, buflen - idx) >= 0) {
+				op->opstr = strdup(rz_asm_op_get_asm(&asmop));
+			}
+			rz_asm_op_fini(&asmop);
+		}
+		if (op->opstr && (!rz_str_ncasecmp(op->opstr, "invalid", strlen("invalid")) ||
+					 !rz_str_ncasecmp(op->opstr, ".byte", strlen(".byte")))) {
+			RZ_FREE(op->opstr);
+		}
+	}
+	rz_analysis_op_fini(&aop);
+	if (!ht_up_insert(d->ops, idx, op)) {
+		free(op->opstr);
+		free(op);
+		return NULL;
+	}
+	return op;
+}
+
+// TODO: follow unconditional jumps
+static RzList *construct_rop_gadget(RopDecoder *d, ut8 max_instr, ut64 addr, ut8 *buf, int buflen, int idx, const char *grep, int regex, RzList *rx_list, int endaddr) {
 	const char *start = NULL, *end = NULL;
 	char *grep_str = NULL;
 	RzCoreAsmHit *hit = NULL;
 	RzList *hitlist = rz_core_asm_hit_list_new();
 	ut8 nb_instr = 0;
-	const ut8 max_instr = rz_config_get_i(core->config, "rop.len");
 	bool valid = false;
 	int grep_find;
 	int search_hit;
 	char *rx = NULL;
-	HtUUOptions opt = { 0 };
-	HtUU *localbadstart = ht_uu_new_opt(&opt);
 	int count = 0;
 
 	if (grep) {
@@ -1020,40 +1122,15 @@ static RzList *construct_rop_gadget(RzCore *core, ut64 addr, ut8 *buf, int bufle
 		}
 	}
 
-	bool found;
-	ht_uu_find(badstart, idx, &found);
-	if (found) {
-		valid = false;
-		goto ret;
-	}
 	while (nb_instr < max_instr) {
-		ht_uu_insert(localbadstart, idx, 1);
-
-		int error = rz_analysis_op(core->analysis, &aop, addr, buf + idx, buflen - idx, RZ_ANALYSIS_OP_MASK_DISASM);
-		if (error < 0 || (nb_instr == 0 && (is_end_gadget(&aop, 0) || aop.type == RZ_ANALYSIS_OP_TYPE_NOP))) {
+		RopOp *op = rop_decoder_op(d, addr, buf, buflen, idx);
+		if (!op || op->size < 0 || (nb_instr == 0 && op->end) || !op->opstr) {
 			valid = false;
 			goto ret;
 		}
 
-		const int opsz = aop.size;
-		// opsz = rz_strbuf_length (asmop.buf);
-		char *opst = aop.mnemonic;
-		if (!opst) {
-			RZ_LOG_WARN("Analysis plugin %s did not return disassembly\n", core->analysis->cur->name);
-			RzAsmOp asmop;
-			rz_asm_set_pc(core->rasm, addr);
-			if (rz_asm_disassemble(core->rasm, &asmop, buf + idx, buflen - idx) < 0) {
-				valid = false;
-				goto ret;
-			}
-			opst = strdup(rz_asm_op_get_asm(&asmop));
-			rz_asm_op_fini(&asmop);
-		}
-		if (!rz_str_ncasecmp(opst, "invalid", strlen("invalid")) ||
-			!rz_str_ncasecmp(opst, ".byte", strlen(".byte"))) {
-			valid = false;
-			goto ret;
-		}
+		const int opsz = op->size;
+		const char *opst = op->opstr;
 
 		hit = rz_core_asm_hit_new();
 		if (hit) {
@@ -1094,26 +1171,11 @@ static RzList *construct_rop_gadget(RzCore *core, ut64 addr, ut8 *buf, int bufle
 			valid = (endaddr == idx - opsz);
 			goto ret;
 		}
-		rz_analysis_op_fini(&aop);
 		nb_instr++;
 	}
 ret:
-	rz_analysis_op_fini(&aop);
 	free(grep_str);
-	if (regex && rx) {
-		rz_list_free(hitlist);
-		ht_uu_free(localbadstart);
-		return NULL;
-	}
-	if (!valid || (grep && end)) {
-		rz_list_free(hitlist);
-		ht_uu_free(localbadstart);
-		return NULL;
-	}
-	ht_uu_foreach(localbadstart, insert_into, badstart);
-	ht_uu_free(localbadstart);
-	// If our arch has bds then we better be including them
-	if (branch_delay && rz_list_length(hitlist) < (1 + branch_delay)) {
+	if ((regex && rx) || !valid || (grep && end)) {
 		rz_list_free(hitlist);
 		return NULL;
 	}
@@ -1282,14 +1344,468 @@ static void print_rop(RzCore *core, RzList *hitlist, PJ *pj, int mode) {
 	rz_list_free(ropList);
 }
 
-static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, const char *grep, int regexp, struct search_parameters *param) {
+/*
+ * The gadget index is a flat sdb in the "rop_index" namespace of core->sdb.
+ * Gadgets are deduplicated by their bytes, which are the key in hex. Values
+ * are "<addr>,<addr>,...\t<class>\t<op>; <op>; ...", where the class is only
+ * computed when rop.db is set, like for /R.
+ */
+#define ROP_INDEX_NS       "rop_index"
+#define ROP_INDEX_MAX_SIZE 4096
+
+static void rop_index_add(RzCore *core, Sdb *index, RzList /*<RzCoreAsmHit *>*/ *hitlist) {
+	RzCoreAsmHit *first = rz_list_first(hitlist);
+	RzCoreAsmHit *last = rz_list_last(hitlist);
+	if (!first || !last || last->addr < first->addr) {
+		return;
+	}
+	ut64 addr = first->addr;
+	ut64 size = last->addr + last->len - addr;
+	if (!size || size > ROP_INDEX_MAX_SIZE) {
+		return;
+	}
+	ut8 *buf = malloc(size);
+	char *hex = malloc(size * 2 + 1);
+	if (!buf || !hex) {
+		goto beach;
+	}
+	rz_io_read_at(core->io, addr, buf, size);
+	rz_hex_bin2str(buf, size, hex);
+	const char *old = sdb_const_get(index, hex, NULL);
+	const char *tab = old ? strchr(old, '\t') : NULL;
+	if (tab) {
+		// same bytes somewhere else, only the addresses change
+		char *value = rz_str_newf("%.*s,0x%08" PFMT64x "%s", (int)(tab - old), old, addr, tab);
+		if (value) {
+			sdb_set_owned(index, hex, value, 0);
+		}
+		goto beach;
+	}
+	RzList *esil_list = rz_config_get_b(core->config, "rop.db") ? rz_list_newf(free) : NULL;
+	RzStrBuf text;
+	rz_strbuf_init(&text);
+	RzListIter *iter;
+	RzCoreAsmHit *hit;
+	rz_list_foreach (hitlist, iter, hit) {
+		const ut8 *op_buf = buf + (hit->addr - addr);
+		RzAsmOp asmop;
+		rz_asm_set_pc(core->rasm, hit->addr);
+		rz_asm_disassemble(core->rasm, &asmop, op_buf, hit->len);
+		rz_strbuf_appendf(&text, "%s%s", rz_strbuf_is_empty(&text) ? "" : "; ", rz_asm_op_get_asm(&asmop));
+		rz_asm_op_fini(&asmop);
+		if (esil_list) {
+			RzAnalysisOp analop = { 0 };
+			rz_analysis_op(core->analysis, &analop, hit->addr, op_buf, hit->len, RZ_ANALYSIS_OP_MASK_ESIL);
+			if (analop.type != RZ_ANALYSIS_OP_TYPE_RET) {
+				rz_list_append(esil_list, rz_str_newf(" %s", RZ_STRBUF_SAFEGET(&analop.esil)));
+			}
+			rz_analysis_op_fini(&analop);
+		}
+	}
+	char *cls = esil_list ? rop_classify_string(core, esil_list) : NULL;
+	char *value = rz_str_newf("0x%08" PFMT64x "\t%s\t%s", addr, cls ? cls : "", rz_strbuf_get(&text));
+	if (value) {
+		// the separator of the fields must not show up in them
+		rz_str_replace_ch(strchr(strchr(value, '\t') + 1, '\t') + 1, '\t', ' ', true);
+		sdb_set_owned(index, hex, value, 0);
+	}
+	free(cls);
+	rz_strbuf_fini(&text);
+	rz_list_free(esil_list);
+beach:
+	free(buf);
+	free(hex);
+}
+
+typedef enum {
+	ROP_STEP_NEXT, ///< try the next start
+	ROP_STEP_SKIP_WINDOW, ///< move on to the next end gadget
+	ROP_STEP_STOP,
+} RopStep;
+
+typedef RopStep (*RopStartCb)(int idx, size_t window, struct endlist_pair *end_gadget, void *user);
+
+/**
+ * Enumerate the offsets in a buffer of \p delta bytes where gadgets ending at
+ * the end gadgets of \p end_list, sorted by offset, may start. A window is
+ * the range of starts for one end gadget.
+ */
+static void rop_starts_foreach(RzVector /*<struct endlist_pair>*/ *end_list, int delta, int ropdepth, int increment, RopStartCb cb, void *user) {
+	const int max_inst_size_x86 = 15;
+	size_t window = 0;
+	struct endlist_pair *end_gadget = rz_vector_index_ptr(end_list, 0);
+	int next = end_gadget->instr_offset;
+	int prev = 0;
+	// Start at just before the first end gadget.
+	for (int i = next - ropdepth; i < (delta - max_inst_size_x86); i += increment) {
+		if (increment == 1) {
+			// give in-boundary instructions a shot
+			if (i < prev - max_inst_size_x86) {
+				i = prev - max_inst_size_x86;
+			}
+		} else {
+			if (i < prev) {
+				i = prev;
+			}
+		}
+		if (i < 0) {
+			i = 0;
+		}
+		if (rz_cons_is_breaked()) {
+			break;
+		}
+		if (i >= next) {
+			// We've exhausted the first end-gadget section,
+			// move to the next one.
+			if (++window >= rz_vector_len(end_list)) {
+				break;
+			}
+			prev = i;
+			end_gadget = rz_vector_index_ptr(end_list, window);
+			next = end_gadget->instr_offset;
+			i = next - ropdepth;
+			if (i < 0) {
+				i = 0;
+			}
+		}
+		RopStep step = cb(i, window, end_gadget, user);
+		if (step == ROP_STEP_STOP) {
+			break;
+		}
+		if (step == ROP_STEP_SKIP_WINDOW) {
+			i = next;
+		}
+	}
+}
+
+typedef struct {
+	int idx;
+	size_t window;
+	RzList /*<RzCoreAsmHit *>*/ *hitlist; ///< gadget starting at idx, if any
+} RopStart;
+
+static void rop_start_fini(void *e, void *user) {
+	RopStart *start = e;
+	rz_list_free(start->hitlist);
+}
+
+typedef struct {
+	RzCore *core;
+	struct search_parameters *param;
+	Sdb *index;
+	Sdb *gadget_sdb;
+	const char *grep;
+	int regexp;
+	RzList /*<char *>*/ *rx_list;
+	int mode;
+	bool subchain;
+	ut8 max_instr;
+	int increment;
+	int align;
+	int max_count;
+	bool result;
+	RopDecoder decoder;
+	// the map being searched
+	ut64 from;
+	ut8 *buf;
+	int delta;
+	RzVector /*<struct endlist_pair>*/ end_list;
+	HtUU *badstart;
+	size_t window; ///< window of the instructions cached by the decoder
+	RzVector /*<RopStart>*/ starts; ///< gadgets decoded in parallel, in the order of the search
+	size_t cursor; ///< first start not yet reported
+} RopSearch;
+
+/**
+ * Print or index a gadget and free it
+ */
+static bool rop_report(RopSearch *rs, RzList /*<RzCoreAsmHit *>*/ *hitlist) {
+	RzCore *core = rs->core;
+	if (rs->index) {
+		rop_index_add(core, rs->index, hitlist);
+		rz_list_free(hitlist);
+		return true;
+	}
+	if (rs->gadget_sdb) {
+		RzListIter *iter;
+
+		RzCoreAsmHit *hit = (RzCoreAsmHit *)hitlist->head->data;
+		char *headAddr = rz_str_newf("%" PFMT64x, hit->addr);
+		if (!headAddr) {
+			rz_list_free(hitlist);
+			return false;
+		}
+
+		rz_list_foreach (hitlist, iter, hit) {
+			char *addr = rz_str_newf("%" PFMT64x "(%" PFMT32d ")", hit->addr, hit->len);
+			if (!addr) {
+				free(headAddr);
+				rz_list_free(hitlist);
+				return false;
+			}
+			sdb_concat(rs->gadget_sdb, headAddr, addr, 0);
+			free(addr);
+		}
+		free(headAddr);
+	}
+
+	int mode = rs->param->outmode == RZ_MODE_JSON ? 'j' : rs->mode;
+	if ((mode == 'q') && rs->subchain) {
+		do {
+			print_rop(core, hitlist, NULL, mode);
+			hitlist->head = hitlist->head->n;
+		} while (hitlist->head->n);
+	} else {
+		print_rop(core, hitlist, rs->param->pj, mode);
+	}
+	rz_list_free(hitlist);
+	return true;
+}
+
+/**
+ * Take the gadget decoded in parallel for the start \p idx of \p window, if
+ * it was decoded. The gadgets of the starts passed over are freed.
+ */
+static bool rop_start_take(RopSearch *rs, int idx, size_t window, RzList **hitlist) {
+	while (rs->cursor < rz_vector_len(&rs->starts)) {
+		RopStart *start = rz_vector_index_ptr(&rs->starts, rs->cursor);
+		if (start->window > window || (start->window == window && start->idx > idx)) {
+			return false;
+		}
+		rs->cursor++;
+		if (start->window == window && start->idx == idx) {
+			*hitlist = start->hitlist;
+			start->hitlist = NULL;
+			return true;
+		}
+		RZ_FREE_CUSTOM(start->hitlist, rz_list_free);
+	}
+	return false;
+}
+
+static RopStep rop_start_search(int idx, size_t window, struct endlist_pair *end_gadget, void *user) {
+	RopSearch *rs = user;
+	RzCore *core = rs->core;
+	// fixed width archs have no gadget overlapping the one that was found
+	const RopStep found = rs->increment != 1 && !rs->index ? ROP_STEP_SKIP_WINDOW : ROP_STEP_NEXT;
+	RzList *hitlist = NULL;
+	bool decoded = rop_start_take(rs, idx, window, &hitlist);
+	if (decoded && !hitlist && rs->increment == 1) {
+		rz_asm_set_pc(core->rasm, rs->from + idx);
+		return ROP_STEP_NEXT;
+	}
+	RzAsmOp asmop;
+	int ret = rz_asm_disassemble(core->rasm, &asmop, rs->buf + idx, rs->delta - idx);
+	rz_asm_op_fini(&asmop);
+	if (!ret) {
+		rz_list_free(hitlist);
+		return rs->increment != 1 ? ROP_STEP_SKIP_WINDOW : ROP_STEP_NEXT;
+	}
+	rz_asm_set_pc(core->rasm, rs->from + idx);
+	bool bad;
+	ht_uu_find(rs->badstart, idx, &bad);
+	if (bad) {
+		rz_list_free(hitlist);
+		return ROP_STEP_NEXT;
+	}
+	if (!decoded) {
+		if (rs->window != window) {
+			rop_decoder_reset(&rs->decoder);
+			rs->window = window;
+		}
+		hitlist = construct_rop_gadget(&rs->decoder, rs->max_instr, rs->from + idx, rs->buf, rs->delta, idx,
+			rs->grep, rs->regexp, rs->rx_list, end_gadget->instr_offset);
+	}
+	if (!hitlist) {
+		return ROP_STEP_NEXT;
+	}
+	RzListIter *iter;
+	RzCoreAsmHit *hit;
+	rz_list_foreach (hitlist, iter, hit) {
+		ht_uu_insert(rs->badstart, hit->addr - rs->from, 1);
+	}
+	// If our arch has bds then we better be including them
+	if (end_gadget->delay_size && rz_list_length(hitlist) < (1 + end_gadget->delay_size)) {
+		rz_list_free(hitlist);
+		return ROP_STEP_NEXT;
+	}
+	if (rs->align && (0 != ((rs->from + idx) % rs->align))) {
+		rz_list_free(hitlist);
+		return ROP_STEP_NEXT;
+	}
+	if (!rop_report(rs, hitlist)) {
+		rs->result = false;
+		return ROP_STEP_STOP;
+	}
+	if (rs->max_count > 0) {
+		rs->max_count--;
+		if (rs->max_count < 1) {
+			return ROP_STEP_STOP;
+		}
+	}
+	return found;
+}
+
+static RopStep rop_start_add(int idx, size_t window, struct endlist_pair *end_gadget, void *user) {
+	RopStart start = { .idx = idx, .window = window };
+	return rz_vector_push(user, &start) ? ROP_STEP_NEXT : ROP_STEP_STOP;
+}
+
+/*
+ * The gadgets of a map are decoded in parallel, window by window, assuming
+ * that every start is tried. They are then reported in the order of the
+ * search, which takes the starts found in previous gadgets and the windows
+ * cut short into account, so the result is the same as searching serially.
+ */
+#define ROP_PARALLEL_MIN_WINDOWS 256
+
+typedef struct {
+	RopSearch *rs;
+	RzThreadTaskPool *pool;
+	RzThreadLock *lock;
+	RopDecoder *decoders;
+	RzVector /*<size_t>*/ windows; ///< index of the first start of each window
+	size_t next_window;
+} RopBatch;
+
+static void rop_batch_run(size_t from, size_t to, void *user) {
+	RopBatch *batch = user;
+	RopSearch *rs = batch->rs;
+	for (size_t w = from; w < to; w++) {
+		RopDecoder *d = &batch->decoders[w];
+		while (!rz_th_task_pool_is_breaked(batch->pool)) {
+			rz_th_lock_enter(batch->lock);
+			size_t k = batch->next_window++;
+			rz_th_lock_leave(batch->lock);
+			if (k >= rz_vector_len(&batch->windows)) {
+				break;
+			}
+			size_t first = *(size_t *)rz_vector_index_ptr(&batch->windows, k);
+			size_t last = k + 1 < rz_vector_len(&batch->windows)
+				? *(size_t *)rz_vector_index_ptr(&batch->windows, k + 1)
+				: rz_vector_len(&rs->starts);
+			rop_decoder_reset(d);
+			for (size_t j = first; j < last; j++) {
+				RopStart *start = rz_vector_index_ptr(&rs->starts, j);
+				struct endlist_pair *end_gadget = rz_vector_index_ptr(&rs->end_list, start->window);
+				start->hitlist = construct_rop_gadget(d, rs->max_instr, rs->from + start->idx, rs->buf, rs->delta, start->idx,
+					rs->grep, rs->regexp, rs->rx_list, end_gadget->instr_offset);
+			}
+		}
+	}
+}
+
+static bool rop_hint_found(ut64 addr, RZ_NULLABLE const char *arch, void *user) {
+	*(bool *)user = true;
+	return false;
+}
+
+static bool rop_bits_hint_found(ut64 addr, int bits, void *user) {
+	*(bool *)user = true;
+	return false;
+}
+
+/**
+ * Whether the arch and bits to decode with are the same in all of [from, to),
+ * since the decoders of the workers can't switch them per address.
+ */
+static bool rop_arch_bits_fixed(RzCore *core, ut64 from, ut64 to) {
+	bool found = false;
+	if (!core->fixedarch) {
+		rz_analysis_arch_hints_foreach(core->analysis, rop_hint_found, &found);
+	}
+	if (!core->fixedbits) {
+		rz_analysis_bits_hints_foreach(core->analysis, rop_bits_hint_found, &found);
+	}
+	if (found) {
+		return false;
+	}
+	RzBinObject *o = rz_bin_cur_object(core->bin);
+	const RzList *sections = o ? rz_bin_object_get_sections_all(o) : NULL;
+	RzListIter *iter;
+	RzBinSection *s;
+	rz_list_foreach (sections, iter, s) {
+		ut64 addr = core->io->va ? s->vaddr : s->paddr;
+		ut64 size = core->io->va ? s->vsize : s->size;
+		if (addr >= to || addr + size <= from) {
+			continue;
+		}
+		if ((!core->fixedarch && s->arch) || (!core->fixedbits && s->bits)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static RzAnalysis *rop_analysis_new(RzAnalysis *analysis) {
+	RzAnalysis *a = rz_analysis_new();
+	if (!a) {
+		return NULL;
+	}
+	if (!rz_analysis_use(a, analysis->cur->name)) {
+		rz_analysis_free(a);
+		return NULL;
+	}
+	rz_analysis_set_bits(a, analysis->bits);
+	rz_analysis_set_cpu(a, analysis->cpu);
+	rz_analysis_set_big_endian(a, analysis->big_endian);
+	return a;
+}
+
+/**
+ * Decode the gadgets of all the starts of the current map of \p rs in \p pool
+ * \return false if they have to be decoded while searching instead
+ */
+static bool rop_decode_parallel(RopSearch *rs, int ropdepth, RzThreadTaskPool *pool) {
+	RzCore *core = rs->core;
+	rop_starts_foreach(&rs->end_list, rs->delta, ropdepth, rs->increment, rop_start_add, &rs->starts);
+	RopBatch batch = {
+		.rs = rs,
+		.pool = pool,
+		.lock = rz_th_lock_new(false),
+	};
+	rz_vector_init(&batch.windows, sizeof(size_t), NULL, NULL);
+	for (size_t i = 0; i < rz_vector_len(&rs->starts); i++) {
+		RopStart *start = rz_vector_index_ptr(&rs->starts, i);
+		if (i && start->window == ((RopStart *)rz_vector_index_ptr(&rs->starts, i - 1))->window) {
+			continue;
+		}
+		rz_vector_push(&batch.windows, &i);
+	}
+	size_t n_workers = RZ_MIN(rz_th_task_pool_size(pool), rz_vector_len(&batch.windows));
+	bool succ = batch.lock && rz_vector_len(&batch.windows) >= ROP_PARALLEL_MIN_WINDOWS && n_workers > 1 &&
+		(batch.decoders = RZ_NEWS0(RopDecoder, n_workers));
+	// decoders are set up here because plugins are initialized on the main thread
+	for (size_t i = 0; succ && i < n_workers; i++) {
+		RzAnalysis *a = rop_analysis_new(core->analysis);
+		succ = a && rop_decoder_init(&batch.decoders[i], a, NULL);
+	}
+	if (succ && !rz_th_task_pool_parallel_for(pool, 0, n_workers, 1, rop_batch_run, &batch) &&
+		!rz_th_task_pool_is_breaked(pool)) {
+		// decodes the windows the pool did not pick up, if any
+		rop_batch_run(0, 1, &batch);
+	}
+	for (size_t i = 0; batch.decoders && i < n_workers; i++) {
+		rz_analysis_free(batch.decoders[i].analysis);
+		rop_decoder_fini(&batch.decoders[i]);
+	}
+	free(batch.decoders);
+	rz_vector_fini(&batch.windows);
+	rz_th_lock_free(batch.lock);
+	if (!succ) {
+		rz_vector_clear(&rs->starts);
+	}
+	return succ;
+}
+
+static int rz_core_search_rop(RzCore *core, RzInterval search_itv, Sdb *index, const char *grep, int regexp, struct search_parameters *param) {
 	const ut8 crop = rz_config_get_i(core->config, "rop.conditional"); // decide if cjmp, cret, and ccall should be used too for the gadget-search
 	const ut8 subchain = rz_config_get_i(core->config, "rop.subchains");
 	const ut8 max_instr = rz_config_get_i(core->config, "rop.len");
 	const char *arch = rz_config_get(core->config, "asm.arch");
-	int max_count = rz_config_get_i(core->config, "search.maxhits");
-	int i = 0, end = 0, mode = 0, increment = 1, ret, result = true;
-	RzList /*<endlist_pair>*/ *end_list = rz_list_newf(free);
+	// the index has to be complete, search.maxhits only applies to plain searches
+	int max_count = index ? 0 : rz_config_get_i(core->config, "search.maxhits");
+	int i = 0, mode = 0, increment = 1, result = true;
 	RzList /*<RzRegex>*/ *rx_list = NULL;
 	int align = core->search->align;
 	RzListIter *itermap = NULL;
@@ -1299,7 +1815,6 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 	int delta = 0;
 	ut8 *buf;
 	RzIOMap *map;
-	RzAsmOp asmop;
 
 	Sdb *gadgetSdb = NULL;
 	if (rz_config_get_i(core->config, "rop.sdb")) {
@@ -1311,7 +1826,6 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 		max_count = -1;
 	}
 	if (max_instr <= 1) {
-		rz_list_free(end_list);
 		eprintf("ROP length (rop.len) must be greater than 1.\n");
 		if (max_instr == 1) {
 			eprintf("For rop.len = 1, use /c to search for single "
@@ -1365,31 +1879,62 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 			tok = strtok(NULL, ";");
 		}
 	}
-	if (param->outmode == RZ_MODE_JSON) {
+
+	RopSearch rs = {
+		.core = core,
+		.param = param,
+		.index = index,
+		.gadget_sdb = gadgetSdb,
+		.grep = grep,
+		.regexp = regexp,
+		.rx_list = rx_list,
+		.mode = mode,
+		.subchain = subchain,
+		.max_instr = max_instr,
+		.increment = increment,
+		.align = align,
+		.max_count = max_count,
+		.result = true,
+	};
+	if (!rop_decoder_init(&rs.decoder, core->analysis, core->rasm)) {
+		result = false;
+		goto bad;
+	}
+	rz_vector_init(&rs.end_list, sizeof(struct endlist_pair), NULL, NULL);
+	rz_vector_init(&rs.starts, sizeof(RopStart), rop_start_fini, NULL);
+	// Get the depth of rop search, should just be max_instr
+	// instructions, x86 and friends are weird length instructions, so
+	// we'll just assume 15 byte instructions.
+	const int ropdepth = increment == 1 ? max_instr * 15 /* wow, x86 is long */ : max_instr * increment;
+	// with a limit the search stops early, decoding every start ahead would be wasted
+	RzThreadTaskPool *pool = max_count < 0 && core->analysis->cur && core->analysis->cur->concurrent_op
+		? rz_core_get_task_pool(core)
+		: NULL;
+
+	if (param->outmode == RZ_MODE_JSON && !index) {
 		pj_a(param->pj);
 	}
 	rz_cons_break_push(NULL, NULL);
 
 	rz_list_foreach (param->boundaries, itermap, map) {
-		HtUUOptions opt = { 0 };
-		HtUU *badstart = ht_uu_new_opt(&opt);
 		if (!rz_itv_overlap(search_itv, map->itv)) {
 			continue;
 		}
 		RzInterval itv = rz_itv_intersect(search_itv, map->itv);
 		ut64 from = itv.addr, to = rz_itv_end(itv);
-		if (rz_cons_is_breaked()) {
+		if (rz_cons_is_breaked() || !rs.max_count || !rs.result) {
 			break;
 		}
 		delta = to - from;
 		buf = calloc(1, delta);
 		if (!buf) {
 			result = false;
-			goto bad;
+			break;
 		}
 		(void)rz_io_read_at(core->io, from, buf, delta);
 
 		// Find the end gadgets.
+		rz_vector_clear(&rs.end_list);
 		for (i = 0; i + 32 < delta; i += increment) {
 			RzAnalysisOp end_gadget = RZ_EMPTY;
 			// Disassemble one.
@@ -1399,25 +1944,16 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 				continue;
 			}
 			if (is_end_gadget(&end_gadget, crop)) {
-#if 0
-				if (search->maxhits && rz_list_length (end_list) >= search->maxhits) {
-					// limit number of high level rop gadget results
-					rz_analysis_op_fini (&end_gadget);
-					break;
-				}
-#endif
-				struct endlist_pair *epair = RZ_NEW0(struct endlist_pair);
-				if (epair) {
-					// If this arch has branch delay slots, add the next instr as well
-					if (end_gadget.delay) {
-						epair->instr_offset = i + increment;
-						epair->delay_size = end_gadget.delay;
-					} else {
-						epair->instr_offset = (intptr_t)i;
-						epair->delay_size = end_gadget.delay;
-					}
-					rz_list_append(end_list, (void *)(intptr_t)epair);
+				struct endlist_pair epair;
+				// If this arch has branch delay slots, add the next instr as well
+				if (end_gadget.delay) {
+					epair.instr_offset = i + increment;
+					epair.delay_size = end_gadget.delay;
+				} else {
+					epair.instr_offset = (intptr_t)i;
+					epair.delay_size = end_gadget.delay;
 				}
+				rz_vector_push(&rs.end_list, &epair);
 			}
 			rz_analysis_op_fini(&end_gadget);
 			if (rz_cons_is_breaked()) {
@@ -1426,118 +1962,22 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 			// Right now we have a list of all of the end/stop gadgets.
 			// We can just construct gadgets from a little bit before them.
 		}
-		rz_list_reverse(end_list);
 		// If we have no end gadgets, just skip all of this search nonsense.
-		if (!rz_list_empty(end_list)) {
-			int prev, next, ropdepth;
-			const int max_inst_size_x86 = 15;
-			// Get the depth of rop search, should just be max_instr
-			// instructions, x86 and friends are weird length instructions, so
-			// we'll just assume 15 byte instructions.
-			ropdepth = increment == 1 ? max_instr * max_inst_size_x86 /* wow, x86 is long */ : max_instr * increment;
-			if (rz_cons_is_breaked()) {
-				break;
-			}
-			struct endlist_pair *end_gadget = (struct endlist_pair *)rz_list_pop(end_list);
-			next = end_gadget->instr_offset;
-			prev = 0;
-			// Start at just before the first end gadget.
-			for (i = next - ropdepth; i < (delta - max_inst_size_x86) && max_count; i += increment) {
-				if (increment == 1) {
-					// give in-boundary instructions a shot
-					if (i < prev - max_inst_size_x86) {
-						i = prev - max_inst_size_x86;
-					}
-				} else {
-					if (i < prev) {
-						i = prev;
-					}
-				}
-				if (i < 0) {
-					i = 0;
-				}
-				if (rz_cons_is_breaked()) {
-					break;
-				}
-				if (i >= next) {
-					// We've exhausted the first end-gadget section,
-					// move to the next one.
-					free(end_gadget);
-					if (rz_list_get_n(end_list, 0)) {
-						prev = i;
-						end_gadget = (struct endlist_pair *)rz_list_pop(end_list);
-						next = end_gadget->instr_offset;
-						i = next - ropdepth;
-						if (i < 0) {
-							i = 0;
-						}
-					} else {
-						break;
-					}
-				}
-				if (i >= end) { // read by chunk of 4k
-					rz_io_read_at(core->io, from + i, buf + i,
-						RZ_MIN((delta - i), 4096));
-					end = i + 2048;
-				}
-				ret = rz_asm_disassemble(core->rasm, &asmop, buf + i, delta - i);
-				if (ret) {
-					rz_asm_set_pc(core->rasm, from + i);
-					RzList *hitlist = construct_rop_gadget(core,
-						from + i, buf, delta, i, grep, regexp,
-						rx_list, end_gadget, badstart);
-					if (!hitlist) {
-						continue;
-					}
-					if (align && (0 != ((from + i) % align))) {
-						continue;
-					}
-					if (gadgetSdb) {
-						RzListIter *iter;
-
-						RzCoreAsmHit *hit = (RzCoreAsmHit *)hitlist->head->data;
-						char *headAddr = rz_str_newf("%" PFMT64x, hit->addr);
-						if (!headAddr) {
-							result = false;
-							goto bad;
-						}
-
-						rz_list_foreach (hitlist, iter, hit) {
-							char *addr = rz_str_newf("%" PFMT64x "(%" PFMT32d ")", hit->addr, hit->len);
-							if (!addr) {
-								free(headAddr);
-								result = false;
-								goto bad;
-							}
-							sdb_concat(gadgetSdb, headAddr, addr, 0);
-							free(addr);
-						}
-						free(headAddr);
-					}
-
-					if (param->outmode == RZ_MODE_JSON) {
-						mode = 'j';
-					}
-					if ((mode == 'q') && subchain) {
-						do {
-							print_rop(core, hitlist, NULL, mode);
-							hitlist->head = hitlist->head->n;
-						} while (hitlist->head->n);
-					} else {
-						print_rop(core, hitlist, param->pj, mode);
-					}
-					rz_list_free(hitlist);
-					if (max_count > 0) {
-						max_count--;
-						if (max_count < 1) {
-							break;
-						}
-					}
-				}
-				if (increment != 1) {
-					i = next;
-				}
+		if (!rz_vector_empty(&rs.end_list) && !rz_cons_is_breaked()) {
+			HtUUOptions opt = { 0 };
+			rs.from = from;
+			rs.buf = buf;
+			rs.delta = delta;
+			rs.badstart = ht_uu_new_opt(&opt);
+			rs.window = SIZE_MAX;
+			rs.cursor = 0;
+			if (pool && rop_arch_bits_fixed(core, from, to)) {
+				rop_decode_parallel(&rs, ropdepth, pool);
 			}
+			rop_starts_foreach(&rs.end_list, delta, ropdepth, increment, rop_start_search, &rs);
+			rz_vector_clear(&rs.starts);
+			rop_decoder_reset(&rs.decoder);
+			ht_uu_free(rs.badstart);
 		}
 		free(buf);
 	}
@@ -1546,12 +1986,15 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 	}
 	rz_cons_break_pop();
 
-	if (param->outmode == RZ_MODE_JSON) {
+	if (param->outmode == RZ_MODE_JSON && !index) {
 		pj_end(param->pj);
 	}
+	result = result && rs.result;
+	rop_decoder_fini(&rs.decoder);
+	rz_vector_fini(&rs.starts);
+	rz_vector_fini(&rs.end_list);
 bad:
 	rz_list_free(rx_list);
-	rz_list_free(end_list);
 	free(grep_arg);
 	free(gregexp);
 	return result;
@@ -2303,6 +2746,170 @@ static void do_asm_search(RzCore *core, struct search_parameters *param, const c
 	rz_cons_break_pop();
 }
 
+/**
+ * Drop the gram indexes of the data in [addr, addr + len), which are no
+ * longer valid after the data is written or remapped.
+ */
+RZ_IPI void rz_core_search_index_invalidate(RzCore *core, ut64 addr, ut64 len) {
+	if (!core->search_indexes || !len) {
+		return;
+	}
+	RzInterval itv = { addr, len };
+	RzListIter *iter, *tmp;
+	RzSearchGramIndex *idx;
+	rz_list_foreach_safe (core->search_indexes, iter, tmp, idx) {
+		if (rz_itv_overlap(itv, rz_search_gram_index_itv(idx))) {
+			rz_list_delete(core->search_indexes, iter);
+		}
+	}
+}
+
+static bool search_index_add(RzCore *core, RzSearchGramIndex *idx) {
+	if (!core->search_indexes) {
+		core->search_indexes = rz_list_newf((RzListFree)rz_search_gram_index_free);
+		if (!core->search_indexes) {
+			return false;
+		}
+	}
+	RzInterval itv = rz_search_gram_index_itv(idx);
+	rz_core_search_index_invalidate(core, itv.addr, itv.size);
+	return !!rz_list_append(core->search_indexes, idx);
+}
+
+static RzSearchGramIndex *search_index_build(RzCore *core, RzInterval itv, ut8 *buf, ut64 buf_size) {
+	RzSearchGramIndex *idx = rz_search_gram_index_new(itv.addr, itv.size, rz_config_get_i(core->config, "search.index.maxmem"));
+	if (!idx) {
+		return NULL;
+	}
+	for (ut64 at = itv.addr; at < rz_itv_end(itv); at += buf_size) {
+		if (rz_cons_is_breaked()) {
+			rz_search_gram_index_free(idx);
+			return NULL;
+		}
+		ut64 len = RZ_MIN(buf_size, rz_itv_end(itv) - at);
+		ut64 borrowed = len;
+		const ut8 *data = rz_io_borrow_at(core->io, at, &borrowed);
+		if (!data || borrowed != len) {
+			(void)rz_io_read_at(core->io, at, buf, len);
+			data = buf;
+		}
+		if (!rz_search_gram_index_feed(idx, data, len)) {
+			rz_search_gram_index_free(idx);
+			return NULL;
+		}
+	}
+	return idx;
+}
+
+static void search_index_build_all(RzCore *core, RzList /*<RzIOMap *>*/ *boundaries, RzInterval search_itv) {
+	ut8 *buf = malloc(SEARCH_PARALLEL_SIZE);
+	if (!buf) {
+		return;
+	}
+	rz_cons_break_push(NULL, NULL);
+	RzListIter *iter;
+	RzIOMap *map;
+	rz_list_foreach (boundaries, iter, map) {
+		if (!rz_itv_overlap(search_itv, map->itv)) {
+			continue;
+		}
+		RzInterval itv = rz_itv_intersect(search_itv, map->itv);
+		eprintf("Indexing [0x%" PFMT64x "-0x%" PFMT64x "]\n", itv.addr, rz_itv_end(itv));
+		RzSearchGramIndex *idx = search_index_build(core, itv, buf, SEARCH_PARALLEL_SIZE);
+		if (!idx) {
+			eprintf("Error: cannot index [0x%" PFMT64x "-0x%" PFMT64x "]\n", itv.addr, rz_itv_end(itv));
+			break;
+		}
+		if (!search_index_add(core, idx)) {
+			rz_search_gram_index_free(idx);
+			break;
+		}
+	}
+	rz_cons_break_pop();
+	free(buf);
+}
+
+static void search_index_list(RzCore *core) {
+	RzListIter *iter;
+	RzSearchGramIndex *idx;
+	rz_list_foreach (core->search_indexes, iter, idx) {
+		RzInterval itv = rz_search_gram_index_itv(idx);
+		rz_cons_printf("0x%08" PFMT64x " 0x%08" PFMT64x " page=%" PFMT64u " mem=%" PFMT64u "\n",
+			itv.addr, rz_itv_end(itv), rz_search_gram_index_page_size(idx), rz_search_gram_index_mem(idx));
+	}
+}
+
+static bool search_index_save(RzCore *core, const char *file) {
+	if (rz_list_empty(core->search_indexes)) {
+		eprintf("Error: no index to save\n");
+		return false;
+	}
+	bool append = false;
+	RzListIter *iter;
+	RzSearchGramIndex *idx;
+	rz_list_foreach (core->search_indexes, iter, idx) {
+		ut64 size;
+		ut8 *buf = rz_search_gram_index_serialize(idx, &size);
+		bool ok = buf && size <= INT_MAX && rz_file_dump(file, buf, (int)size, append);
+		free(buf);
+		if (!ok) {
+			eprintf("Error: cannot write the index to '%s'\n", file);
+			return false;
+		}
+		append = true;
+	}
+	return true;
+}
+
+static bool search_index_load(RzCore *core, const char *file) {
+	size_t size;
+	ut8 *buf = (ut8 *)rz_file_slurp(file, &size);
+	if (!buf) {
+		eprintf("Error: cannot read '%s'\n", file);
+		return false;
+	}
+	ut64 max_mem = rz_config_get_i(core->config, "search.index.maxmem");
+	ut64 off = 0;
+	while (off < size) {
+		ut64 used;
+		RzSearchGramIndex *idx = rz_search_gram_index_deserialize(buf + off, size - off, max_mem, &used);
+		if (!idx) {
+			eprintf("Error: invalid index in '%s'\n", file);
+			break;
+		}
+		if (!search_index_add(core, idx)) {
+			rz_search_gram_index_free(idx);
+			break;
+		}
+		off += used;
+	}
+	free(buf);
+	return off == size;
+}
+
+/**
+ * Get the parts of [from, to) the keyword search has to scan, in \p ranges.
+ * Without an index of the whole range usable for the search, that is the
+ * whole range.
+ */
+static void search_index_ranges(RzCore *core, ut64 from, ut64 to, RzVector /*<RzInterval>*/ *ranges) {
+	if (core->search_indexes && rz_config_get_b(core->config, "search.index")) {
+		RzListIter *iter;
+		RzSearchGramIndex *idx;
+		rz_list_foreach (core->search_indexes, iter, idx) {
+			if (rz_search_gram_index_ranges(idx, core->search, from, to, core->blocksize, ranges)) {
+				return;
+			}
+		}
+	}
+	RzInterval all = { from, to - from };
+	rz_vector_push(ranges, &all);
+}
+
+static bool search_is_breaked(void *user) {
+	return rz_cons_is_breaked();
+}
+
 static void do_string_search(RzCore *core, RzInterval search_itv, struct search_parameters *param) {
 	ut64 at;
 	ut8 *buf;
@@ -2328,7 +2935,12 @@ static void do_string_search(RzCore *core, RzInterval search_itv, struct search_
 		/* TODO: launch search in background support */
 		// REMOVE OLD FLAGS rz_core_cmdf (core, "f-%s*", rz_config_get (core->config, "search.prefix"));
 		rz_search_set_callback(core->search, &_cb_hit, param);
-		if (!(buf = malloc(core->blocksize))) {
+		// forward keyword searches scan many blocks at once, split among threads
+		const size_t max_threads = rz_config_get_i(core->config, "search.max.threads");
+		const bool parallel = max_threads != 1 && search->mode == RZ_SEARCH_KEYWORD && !search->bckwrds && !search->inverse;
+		const ut64 chunk = parallel ? core->blocksize * RZ_MAX(1, SEARCH_PARALLEL_SIZE / core->blocksize) : core->blocksize;
+		const size_t readahead_blocks = rz_config_get_i(core->config, "search.readahead");
+		if (!(buf = malloc(chunk))) {
 			return;
 		}
 		if (search->bckwrds) {
@@ -2360,46 +2972,82 @@ static void do_string_search(RzCore *core, RzInterval search_itv, struct search_
 				}
 			}
 
-			const ut64 from = itv.addr, to = rz_itv_end(itv),
-				   from1 = search->bckwrds ? to : from,
-				   to1 = search->bckwrds ? from : to;
+			const ut64 to1 = search->bckwrds ? itv.addr : rz_itv_end(itv);
+			// with an index, only the blocks which may hold a match are read
+			RzVector ranges;
+			rz_vector_init(&ranges, sizeof(RzInterval), NULL, NULL);
+			search_index_ranges(core, itv.addr, rz_itv_end(itv), &ranges);
+			RzInterval *range;
 			ut64 len;
-			for (at = from1; at != to1; at = search->bckwrds ? at - len : at + len) {
-				print_search_progress(at, to1, search->nhits, param);
-				if (rz_cons_is_breaked()) {
-					eprintf("\n\n");
-					break;
-				}
-				if (search->bckwrds) {
-					len = RZ_MIN(core->blocksize, at - from);
-					// TODO prefix_read_at
-					if (!rz_io_is_valid_offset(core->io, at - len, 0)) {
+			at = to1;
+			rz_vector_foreach(&ranges, range) {
+				const ut64 from = range->addr, to = rz_itv_end(*range),
+					   from1 = search->bckwrds ? to : from,
+					   range_to1 = search->bckwrds ? from : to;
+				// prefetch the range in the background when it can't be scanned in place
+				ut64 probe = 1;
+				const bool readahead = readahead_blocks > 0 && !search->bckwrds && !rz_io_borrow_at(core->io, from, &probe) &&
+					rz_io_readahead_start(core->io, from, to, chunk, readahead_blocks, search_is_breaked, NULL);
+				for (at = from1; at != range_to1; at = search->bckwrds ? at - len : at + len) {
+					print_search_progress(at, to1, search->nhits, param);
+					if (rz_cons_is_breaked()) {
+						eprintf("\n\n");
 						break;
 					}
-					(void)rz_io_read_at(core->io, at - len, buf, len);
-				} else {
-					len = RZ_MIN(core->blocksize, to - at);
-					if (!rz_io_is_valid_offset(core->io, at, 0)) {
+					ut64 block_at;
+					if (search->bckwrds) {
+						len = RZ_MIN(core->blocksize, at - from);
+						// TODO prefix_read_at
+						block_at = at - len;
+					} else {
+						len = RZ_MIN(chunk, to - at);
+						block_at = at;
+					}
+					if (!rz_io_is_valid_offset(core->io, block_at, 0)) {
 						break;
 					}
-					(void)rz_io_read_at(core->io, at, buf, len);
-				}
-				rz_search_update(core->search, at, buf, len);
-				if (param->aes_search) {
-					// Adjust length to search between blocks.
-					if (len == core->blocksize) {
-						len -= AES_SEARCH_LENGTH - 1;
+					// stop the chunk at the first block the serial search would have stopped at
+					for (ut64 off = core->blocksize; off < len; off += core->blocksize) {
+						if (!rz_io_is_valid_offset(core->io, block_at + off, 0)) {
+							len = off;
+							break;
+						}
 					}
-				} else if (param->privkey_search) {
-					// Adjust length to search between blocks.
-					if (len == core->blocksize) {
-						len -= PRIVATE_KEY_SEARCH_LENGTH - 1;
+					// scan mmap'd data in place when possible, the backward search reverses the data it is given
+					ut64 borrowed = len;
+					const ut8 *data = search->bckwrds || readahead ? NULL : rz_io_borrow_at(core->io, block_at, &borrowed);
+					if (!data || borrowed != len) {
+						(void)rz_io_read_at(core->io, block_at, buf, len);
+						data = buf;
+					}
+					if (parallel) {
+						rz_search_update_parallel(core->search, at, data, len, core->blocksize, max_threads);
+					} else {
+						rz_search_update(core->search, at, data, len);
+					}
+					if (param->aes_search) {
+						// Adjust length to search between blocks.
+						if (len == core->blocksize) {
+							len -= AES_SEARCH_LENGTH - 1;
+						}
+					} else if (param->privkey_search) {
+						// Adjust length to search between blocks.
+						if (len == core->blocksize) {
+							len -= PRIVATE_KEY_SEARCH_LENGTH - 1;
+						}
+					}
+					if (core->search->maxhits > 0 && core->search->nhits >= core->search->maxhits) {
+						rz_io_readahead_stop(core->io);
+						rz_vector_fini(&ranges);
+						goto done;
 					}
 				}
-				if (core->search->maxhits > 0 && core->search->nhits >= core->search->maxhits) {
-					goto done;
+				rz_io_readahead_stop(core->io);
+				if (at != range_to1) {
+					break;
 				}
 			}
+			rz_vector_fini(&ranges);
 			print_search_progress(at, to1, search->nhits, param);
 			rz_cons_clear_line(1);
 			core->num->value = search->nhits;
@@ -2516,6 +3164,184 @@ static void rop_kuery(void *data, const char *input, PJ *pj) {
 	}
 }
 
+/*
+ * Like the grep of /R: the semicolon-separated fields of filter must match
+ * instructions of the gadget, in order.
+ */
+static bool rop_index_match(const char *text, RzList /*<char *>*/ *fields, bool regexp) {
+	RzListIter *it = rz_list_iterator(fields);
+	if (!it) {
+		return true;
+	}
+	char *dup = strdup(text);
+	if (!dup) {
+		return false;
+	}
+	char *op = dup;
+	while (op && it) {
+		char *next = strstr(op, "; ");
+		if (next) {
+			*next = '\0';
+			next += 2;
+		}
+		const char *field = rz_list_iter_get_data(it);
+		if (regexp ? rz_regex_match(field, "e", op) > 0 : !!strstr(op, field)) {
+			it = rz_list_iter_get_next(it);
+		}
+		op = next;
+	}
+	free(dup);
+	return !it;
+}
+
+static int rop_index_cmp(const void *a, const void *b) {
+	ut64 aa = strtoull(sdbkv_value((SdbKv *)a), NULL, 16);
+	ut64 bb = strtoull(sdbkv_value((SdbKv *)b), NULL, 16);
+	return aa < bb ? -1 : aa > bb;
+}
+
+static void rop_index_print_entry(const char *bytes, const char *value, PJ *pj, int mode) {
+	char *dup = strdup(value);
+	if (!dup) {
+		return;
+	}
+	char *cls = strchr(dup, '\t');
+	char *text = cls ? strchr(cls + 1, '\t') : NULL;
+	if (!text) {
+		free(dup);
+		return;
+	}
+	*cls++ = '\0';
+	*text++ = '\0';
+	char *addrs = dup;
+	char *comma = strchr(addrs, ',');
+	switch (mode) {
+	case 'j': {
+		pj_o(pj);
+		pj_ka(pj, "offsets");
+		char *addr = addrs;
+		while (addr) {
+			char *next = strchr(addr, ',');
+			if (next) {
+				*next++ = '\0';
+			}
+			pj_n(pj, strtoull(addr, NULL, 16));
+			addr = next;
+		}
+		pj_end(pj);
+		pj_ks(pj, "bytes", bytes);
+		pj_ks(pj, "opcodes", text);
+		if (*cls) {
+			pj_ks(pj, "class", cls);
+		}
+		pj_end(pj);
+		break;
+	}
+	case 'q':
+		if (comma) {
+			*comma = '\0';
+		}
+		rz_cons_printf("%s: %s;\n", addrs, text);
+		break;
+	default:
+		rz_cons_printf("%s  %s  %s%s%s\n", addrs, bytes, text, *cls ? "  ; " : "", cls);
+		break;
+	}
+	free(dup);
+}
+
+static void rop_index_query(RzCore *core, const char *input, PJ *pj) {
+	Sdb *index = sdb_ns(core->sdb, ROP_INDEX_NS, false);
+	if (!index) {
+		eprintf("Error: no ROP gadget index, build it with /Rib or load it with /Ril\n");
+		return;
+	}
+	bool regexp = false;
+	int mode = 0;
+	if (*input == '/') {
+		regexp = true;
+		input++;
+	}
+	if (*input == 'j' || *input == 'q') {
+		mode = *input++;
+	}
+	RzList *fields = rz_list_newf(free);
+	if (!fields) {
+		return;
+	}
+	if (*input == ' ') {
+		char *filter = rz_str_replace(strdup(input + 1), ",,", ";", true);
+		RzList *parts = filter ? rz_str_split_duplist(filter, ";", true) : NULL;
+		RzListIter *it;
+		char *part;
+		rz_list_foreach (parts, it, part) {
+			if (*part) {
+				rz_list_append(fields, strdup(part));
+			}
+		}
+		rz_list_free(parts);
+		free(filter);
+	}
+	if (mode == 'j') {
+		pj_a(pj);
+	}
+	SdbList *list = sdb_foreach_list(index, false);
+	ls_sort(list, rop_index_cmp);
+	SdbListIter *iter;
+	SdbKv *kv;
+	ls_foreach (list, iter, kv) {
+		const char *value = sdbkv_value(kv);
+		const char *text = strchr(value, '\t');
+		text = text ? strchr(text + 1, '\t') : NULL;
+		if (!text || !rop_index_match(text + 1, fields, regexp)) {
+			continue;
+		}
+		rop_index_print_entry(sdbkv_key(kv), value, pj, mode);
+	}
+	ls_free(list);
+	if (mode == 'j') {
+		pj_end(pj);
+	}
+	rz_list_free(fields);
+}
+
+static bool rop_index_save(RzCore *core, const char *file) {
+	Sdb *index = sdb_ns(core->sdb, ROP_INDEX_NS, false);
+	if (!index) {
+		eprintf("Error: no ROP gadget index to save\n");
+		return false;
+	}
+	Sdb *out = sdb_new0();
+	if (!out) {
+		return false;
+	}
+	sdb_file(out, file);
+	sdb_copy(index, out);
+	bool ret = sdb_sync(out);
+	sdb_free(out);
+	if (!ret) {
+		eprintf("Error: cannot write the ROP gadget index to '%s'\n", file);
+	}
+	return ret;
+}
+
+static bool rop_index_load(RzCore *core, const char *file) {
+	if (!rz_file_exists(file)) {
+		eprintf("Error: cannot find '%s'\n", file);
+		return false;
+	}
+	Sdb *in = sdb_new(NULL, file, 0);
+	Sdb *index = sdb_ns(core->sdb, ROP_INDEX_NS, true);
+	if (!in || !index) {
+		sdb_free(in);
+		return false;
+	}
+	sdb_reset(index);
+	sdb_copy(in, index);
+	sdb_free(in);
+	return true;
+}
+
 static int memcmpdiff(const ut8 *a, const ut8 *b, int len) {
 	int i, diff = 0;
 	for (i = 0; i < len; i++) {
@@ -3024,7 +3850,28 @@ reread:
 		if (input[1] == '?') {
 			rz_core_cmd_help(core, help_msg_slash_R);
 		} else if (input[1] == '/') {
-			rz_core_search_rop(core, search_itv, 0, input + 1, 1, &param);
+			rz_core_search_rop(core, search_itv, NULL, input + 1, 1, &param);
+		} else if (input[1] == 'i') {
+			if (input[2] == '?') {
+				rz_core_cmd_help(core, help_msg_slash_Ri);
+			} else if (input[2] == 'b') {
+				Sdb *index = sdb_ns(core->sdb, ROP_INDEX_NS, true);
+				if (index) {
+					sdb_reset(index);
+					rz_core_search_rop(core, search_itv, index, "", 0, &param);
+				}
+			} else if (input[2] == 's' || input[2] == 'l') {
+				const char *file = rz_str_trim_head_ro(input + 3);
+				if (!*file) {
+					rz_core_cmd_help(core, help_msg_slash_Ri);
+				} else if (input[2] == 's') {
+					rop_index_save(core, file);
+				} else {
+					rop_index_load(core, file);
+				}
+			} else {
+				rop_index_query(core, input + 2, param.pj);
+			}
 		} else if (input[1] == 'k') {
 			if (input[2] == '?') {
 				rz_core_cmd_help(core, help_msg_slash_Rk);
@@ -3035,7 +3882,7 @@ reread:
 			Sdb *gadgetSdb = sdb_ns(core->sdb, "gadget_sdb", false);
 
 			if (!gadgetSdb) {
-				rz_core_search_rop(core, search_itv, 0, input + 1, 0, &param);
+				rz_core_search_rop(core, search_itv, NULL, input + 1, 0, &param);
 			} else {
 				SdbKv *kv;
 				SdbListIter *sdb_iter;
@@ -3293,6 +4140,29 @@ reread:
 		}
 		}
 	} break;
+	case 'I': // "/I"
+		dosearch = false;
+		if (input[1] == '?') {
+			rz_core_cmd_help(core, help_msg_slash_I);
+		} else if (input[1] == 'b') { // "/Ib"
+			search_index_build_all(core, param.boundaries, search_itv);
+		} else if (input[1] == '-') { // "/I-"
+			RZ_FREE_CUSTOM(core->search_indexes, rz_list_free);
+		} else if (input[1] == 's' || input[1] == 'l') { // "/Is" "/Il"
+			const char *file = rz_str_trim_head_ro(input + 2);
+			if (!*file) {
+				rz_core_cmd_help(core, help_msg_slash_I);
+			} else if (input[1] == 's') {
+				search_index_save(core, file);
+			} else {
+				search_index_load(core, file);
+			}
+		} else if (!input[1]) {
+			search_index_list(core);
+		} else {
+			rz_core_cmd_help(core, help_msg_slash_I);
+		}
+		break;
 	case 'm': // "/m"
 		dosearch = false;
 		if (input[1] == '?') { // "/m?"
@@ -3320,11 +4190,27 @@ reread:
 					eprintf("-- %llx %llx\n", map->itv.addr, rz_itv_end(map->itv));
 				}
 				rz_cons_break_push(NULL, NULL);
-				for (addr = map->itv.addr; addr < rz_itv_end(map->itv); addr++) {
+				PJ *pj = param.outmode == RZ_MODE_JSON ? param.pj : NULL;
+				ut64 end = rz_itv_end(map->itv);
+				ut64 chunk_from = 0, chunk_end = 0;
+				ut8 *probes = NULL;
+				for (addr = map->itv.addr; addr < end; addr++) {
 					if (rz_cons_is_breaked()) {
 						break;
 					}
-					ret = rz_core_magic_at(core, file, addr, 99, false, param.outmode == RZ_MODE_JSON ? param.pj : NULL, &hits);
+					if (addr >= chunk_end) {
+						// offsets where nothing matches are found ahead, in parallel
+						chunk_end = addr + RZ_MIN(end - addr, MAGIC_PROBE_CHUNK);
+						free(probes);
+						probes = rz_core_magic_probe(core, file, addr, chunk_end - addr);
+						chunk_from = addr;
+					}
+					ut8 probe = probes ? probes[addr - chunk_from] : MAGIC_PROBE_UNKNOWN;
+					if (probe == MAGIC_PROBE_NONE || probe == MAGIC_PROBE_DATA) {
+						ret = rz_core_magic_skip(core, addr, probe, pj, hits);
+					} else {
+						ret = rz_core_magic_at(core, file, addr, 99, false, pj, &hits);
+					}
 					if (ret == -1) {
 						// something went terribly wrong.
 						break;
@@ -3334,6 +4220,7 @@ reread:
 					}
 					addr += ret - 1;
 				}
+				free(probes);
 				rz_cons_clear_line(1);
 				rz_cons_break_pop();
 			}
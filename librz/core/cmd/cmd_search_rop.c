@@ -727,3 +727,37 @@ static void rop_classify(RzCore *core, Sdb *db, RzList *ropList, const char *key
 
 	free(str);
 }
+
+/* the classes of rop_classify() as a single string, for the gadget index */
+static char *rop_classify_string(RzCore *core, RzList *ropList) {
+	if (rop_classify_nops(core, ropList) == 1) {
+		return strdup("NOP");
+	}
+	char *mov = rop_classify_mov(core, ropList);
+	char *ct = rop_classify_constant(core, ropList);
+	char *arithm = rop_classify_arithmetic(core, ropList);
+	char *arithm_ct = rop_classify_arithmetic_const(core, ropList);
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	if (mov) {
+		rz_strbuf_appendf(&sb, "MOV { %s } ", mov);
+	}
+	if (ct) {
+		rz_strbuf_appendf(&sb, "LOAD_CONST { %s } ", ct);
+	}
+	if (arithm) {
+		rz_strbuf_appendf(&sb, "ARITHMETIC { %s } ", arithm);
+	}
+	if (arithm_ct) {
+		rz_strbuf_appendf(&sb, "ARITHMETIC_CONST { %s } ", arithm_ct);
+	}
+	free(mov);
+	free(ct);
+	free(arithm);
+	free(arithm_ct);
+	char *res = rz_strbuf_drain_nofree(&sb);
+	if (res) {
+		rz_str_trim_tail(res);
+	}
+	return res;
+}
@@ -13,9 +13,12 @@ static const RzCmdDescDetail hash_bang_details[2];
 static const RzCmdDescDetail pointer_details[2];
 static const RzCmdDescDetail interpret_macro_multiple_details[2];
 static const RzCmdDescDetail analysis_all_esil_details[2];
+static const RzCmdDescDetail print_analysis_passes_details[2];
 static const RzCmdDescDetail analyze_all_preludes_details[2];
+static const RzCmdDescDetail analyze_triage_details[2];
 static const RzCmdDescDetail analysis_functions_merge_details[2];
 static const RzCmdDescDetail analysis_appcall_details[2];
+static const RzCmdDescDetail il_vm_batch_details[2];
 static const RzCmdDescDetail analysis_reg_cond_details[4];
 static const RzCmdDescDetail ar_details[2];
 static const RzCmdDescDetail analysis_hint_set_arch_details[2];
@@ -140,6 +143,7 @@ static const RzCmdDescArg analysis_continue_until_addr_args[2];
 static const RzCmdDescArg analysis_continue_until_esil_args[2];
 static const RzCmdDescArg analysis_esil_init_mem_args[4];
 static const RzCmdDescArg analysis_esil_init_mem_remove_args[4];
+static const RzCmdDescArg emu_prof_list_args[2];
 static const RzCmdDescArg il_step_args[2];
 static const RzCmdDescArg il_step_evaluate_args[2];
 static const RzCmdDescArg il_step_over_until_addr_args[2];
@@ -149,6 +153,7 @@ static const RzCmdDescArg il_step_until_opt_args[2];
 static const RzCmdDescArg il_vm_step_args[2];
 static const RzCmdDescArg il_vm_step_with_events_args[2];
 static const RzCmdDescArg il_vm_step_until_addr_args[2];
+static const RzCmdDescArg il_vm_batch_args[5];
 static const RzCmdDescArg il_vm_status_args[3];
 static const RzCmdDescArg analysis_regs_args[2];
 static const RzCmdDescArg analysis_regs_columns_args[2];
@@ -307,6 +312,7 @@ static const RzCmdDescArg cmd_debug_trace_add_args[2];
 static const RzCmdDescArg cmd_debug_trace_add_addrs_args[2];
 static const RzCmdDescArg cmd_debug_trace_calls_args[4];
 static const RzCmdDescArg cmd_debug_trace_esil_args[2];
+static const RzCmdDescArg cmd_debug_trace_drcov_args[2];
 static const RzCmdDescArg cmd_debug_save_trace_session_args[2];
 static const RzCmdDescArg cmd_debug_load_trace_session_args[2];
 static const RzCmdDescArg cmd_debug_trace_tag_args[2];
@@ -1340,6 +1346,14 @@ static const RzCmdDescHelp analyze_recursively_all_function_types_help = {
 	.args = analyze_recursively_all_function_types_args,
 };
 
+static const RzCmdDescArg analyze_dirty_functions_types_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp analyze_dirty_functions_types_help = {
+	.summary = "Performs type matching again in the functions touched by writes (see analysis.detectwrites.deps)",
+	.args = analyze_dirty_functions_types_args,
+};
+
 static const RzCmdDescArg print_analysis_details_args[] = {
 	{ 0 },
 };
@@ -1348,6 +1362,26 @@ static const RzCmdDescHelp print_analysis_details_help = {
 	.args = print_analysis_details_args,
 };
 
+static const RzCmdDescDetailEntry print_analysis_passes_Columns_detail_entries[] = {
+	{ .text = "wall, cpu", .arg_str = "", .comment = "elapsed and process CPU time in microseconds" },
+	{ .text = "rss", .arg_str = "", .comment = "growth of the peak resident set size in bytes" },
+	{ .text = "fcns, bbs, xrefs", .arg_str = "", .comment = "functions, basic blocks and referencing addresses created" },
+	{ .text = "io", .arg_str = "", .comment = "bytes read through io" },
+	{ 0 },
+};
+static const RzCmdDescDetail print_analysis_passes_details[] = {
+	{ .name = "Columns", .entries = print_analysis_passes_Columns_detail_entries },
+	{ 0 },
+};
+static const RzCmdDescArg print_analysis_passes_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp print_analysis_passes_help = {
+	.summary = "Print the time and resources spent by each pass of the last aaa/aaaa",
+	.details = print_analysis_passes_details,
+	.args = print_analysis_passes_args,
+};
+
 static const RzCmdDescArg analyze_all_unresolved_jumps_args[] = {
 	{ 0 },
 };
@@ -1412,6 +1446,25 @@ static const RzCmdDescHelp analyze_all_preludes_help = {
 	.args = analyze_all_preludes_args,
 };
 
+static const RzCmdDescDetailEntry analyze_triage_Records_detail_entries[] = {
+	{ .text = "name, addr, minaddr, maxaddr, size, nbbs, noreturn", .arg_str = "", .comment = "boundaries of the function" },
+	{ .text = "calls, imports, strings", .arg_str = "", .comment = "what the function calls and references" },
+	{ .text = "e analysis.triage.discard=true", .arg_str = "", .comment = "drop the blocks of each function once printed" },
+	{ 0 },
+};
+static const RzCmdDescDetail analyze_triage_details[] = {
+	{ .name = "Records", .entries = analyze_triage_Records_detail_entries },
+	{ 0 },
+};
+static const RzCmdDescArg analyze_triage_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp analyze_triage_help = {
+	.summary = "Quick triage analysis, printing a line of JSON per function",
+	.details = analyze_triage_details,
+	.args = analyze_triage_args,
+};
+
 static const RzCmdDescArg analyze_xrefs_section_bytes_args[] = {
 	{
 		.name = "n_bytes",
@@ -2708,6 +2761,58 @@ static const RzCmdDescHelp analysis_esil_init_mem_p_help = {
 	.args = analysis_esil_init_mem_p_args,
 };
 
+static const RzCmdDescHelp aem_help = {
+	.summary = "Copy-on-write emulation memory (emu.cow)",
+};
+static const RzCmdDescArg emu_mem_list_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp emu_mem_list_help = {
+	.summary = "List the pages written by emulation",
+	.args = emu_mem_list_args,
+};
+
+static const RzCmdDescArg emu_mem_commit_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp emu_mem_commit_help = {
+	.summary = "Commit the pages written by emulation into io",
+	.args = emu_mem_commit_args,
+};
+
+static const RzCmdDescArg emu_mem_reset_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp emu_mem_reset_help = {
+	.summary = "Discard the pages written by emulation",
+	.args = emu_mem_reset_args,
+};
+
+static const RzCmdDescHelp aeP_help = {
+	.summary = "Emulation profile (emu.profile)",
+};
+static const RzCmdDescArg emu_prof_list_args[] = {
+	{
+		.name = "n",
+		.type = RZ_CMD_ARG_TYPE_NUM,
+		.optional = true,
+
+	},
+	{ 0 },
+};
+static const RzCmdDescHelp emu_prof_list_help = {
+	.summary = "Show executions and time per emulated instruction, the most expensive first",
+	.args = emu_prof_list_args,
+};
+
+static const RzCmdDescArg emu_prof_reset_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp emu_prof_reset_help = {
+	.summary = "Reset the emulation profile",
+	.args = emu_prof_reset_args,
+};
+
 static const RzCmdDescHelp aes_help = {
 	.summary = "ESIL emulated debugger step",
 };
@@ -2914,6 +3019,45 @@ static const RzCmdDescHelp il_vm_step_until_addr_help = {
 	.args = il_vm_step_until_addr_args,
 };
 
+static const RzCmdDescDetailEntry il_vm_batch_Examples_detail_entries[] = {
+	{ .text = "aezb eax 0,1,0x100 0x8048100", .arg_str = NULL, .comment = "Run three emulations with eax set to 0, 1 and 0x100 until pc is 0x8048100" },
+	{ .text = "aezbj rdi 1,2,3 0x1000 64", .arg_str = NULL, .comment = "Same with rdi, stopping after 64 instructions at most, printing final registers and written pages" },
+	{ 0 },
+};
+static const RzCmdDescDetail il_vm_batch_details[] = {
+	{ .name = "Examples", .entries = il_vm_batch_Examples_detail_entries },
+	{ 0 },
+};
+static const RzCmdDescArg il_vm_batch_args[] = {
+	{
+		.name = "reg",
+		.type = RZ_CMD_ARG_TYPE_STRING,
+
+	},
+	{
+		.name = "values",
+		.type = RZ_CMD_ARG_TYPE_STRING,
+
+	},
+	{
+		.name = "until",
+		.type = RZ_CMD_ARG_TYPE_RZNUM,
+
+	},
+	{
+		.name = "max_steps",
+		.type = RZ_CMD_ARG_TYPE_NUM,
+		.optional = true,
+
+	},
+	{ 0 },
+};
+static const RzCmdDescHelp il_vm_batch_help = {
+	.summary = "Emulate from the current registers once for every value of <reg>, in parallel",
+	.details = il_vm_batch_details,
+	.args = il_vm_batch_args,
+};
+
 static const RzCmdDescArg il_vm_status_args[] = {
 	{
 		.name = "var_name",
@@ -6305,6 +6449,33 @@ static const RzCmdDescHelp cmd_debug_bt_toggle_bp_trace_help = {
 	.args = cmd_debug_bt_toggle_bp_trace_args,
 };
 
+static const RzCmdDescHelp dbB_help = {
+	.summary = "Block coverage commands",
+};
+static const RzCmdDescArg cmd_debug_coverage_start_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_debug_coverage_start_help = {
+	.summary = "Start block coverage with a one-shot trap on every analysed basic block",
+	.args = cmd_debug_coverage_start_args,
+};
+
+static const RzCmdDescArg cmd_debug_coverage_stop_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_debug_coverage_stop_help = {
+	.summary = "Stop block coverage and remove the traps not hit yet",
+	.args = cmd_debug_coverage_stop_args,
+};
+
+static const RzCmdDescArg cmd_debug_coverage_list_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_debug_coverage_list_help = {
+	.summary = "List the blocks of the block coverage and whether they were hit",
+	.args = cmd_debug_coverage_list_args,
+};
+
 static const RzCmdDescArg cmd_debug_bp_set_expr_cur_offset_args[] = {
 	{
 		.name = "expr",
@@ -6384,6 +6555,23 @@ static const RzCmdDescHelp cmd_debug_continue_execution_help = {
 	.args = cmd_debug_continue_execution_args,
 };
 
+static const RzCmdDescArg cmd_debug_continue_async_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_debug_continue_async_help = {
+	.summary = "Continue execution in the background",
+	.description = "The prompt stays usable while the target runs, its stop is handled before the next command. Registers cannot be accessed meanwhile.",
+	.args = cmd_debug_continue_async_args,
+};
+
+static const RzCmdDescArg cmd_debug_continue_wait_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_debug_continue_wait_help = {
+	.summary = "Wait for the target continued in the background to stop",
+	.args = cmd_debug_continue_wait_args,
+};
+
 static const RzCmdDescArg cmd_debug_continue_back_args[] = {
 	{ 0 },
 };
@@ -6866,6 +7054,27 @@ static const RzCmdDescHelp cmd_debug_trace_interactive_help = {
 	.args = cmd_debug_trace_interactive_args,
 };
 
+static const RzCmdDescArg cmd_debug_trace_drcov_args[] = {
+	{
+		.name = "file",
+		.type = RZ_CMD_ARG_TYPE_FILE,
+
+	},
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_debug_trace_drcov_help = {
+	.summary = "Export the traced addresses as drcov coverage to <file>",
+	.args = cmd_debug_trace_drcov_args,
+};
+
+static const RzCmdDescArg cmd_debug_trace_maps_coverage_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_debug_trace_maps_coverage_help = {
+	.summary = "Show the traced coverage of each executable map",
+	.args = cmd_debug_trace_maps_coverage_args,
+};
+
 static const RzCmdDescHelp dts_help = {
 	.summary = "Debug trace session commands",
 };
@@ -6919,6 +7128,14 @@ static const RzCmdDescHelp cmd_debug_list_trace_session_mmap_help = {
 	.args = cmd_debug_list_trace_session_mmap_args,
 };
 
+static const RzCmdDescArg cmd_debug_trace_session_changed_pages_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_debug_trace_session_changed_pages_help = {
+	.summary = "List the memory pages changed since the last checkpoint",
+	.args = cmd_debug_trace_session_changed_pages_args,
+};
+
 static const RzCmdDescArg cmd_debug_trace_tag_args[] = {
 	{
 		.name = "tag",
@@ -14157,9 +14374,15 @@ RZ_IPI void rzshell_cmddescs_init(RzCore *core) {
 	RzCmdDesc *analyze_recursively_all_function_types_cd = rz_cmd_desc_argv_new(core->rcmd, aaf_cd, "aaft", rz_analyze_recursively_all_function_types_handler, &analyze_recursively_all_function_types_help);
 	rz_warn_if_fail(analyze_recursively_all_function_types_cd);
 
+	RzCmdDesc *analyze_dirty_functions_types_cd = rz_cmd_desc_argv_new(core->rcmd, aaf_cd, "aafu", rz_analyze_dirty_functions_types_handler, &analyze_dirty_functions_types_help);
+	rz_warn_if_fail(analyze_dirty_functions_types_cd);
+
 	RzCmdDesc *print_analysis_details_cd = rz_cmd_desc_argv_state_new(core->rcmd, aa_cd, "aai", RZ_OUTPUT_MODE_STANDARD | RZ_OUTPUT_MODE_JSON, rz_print_analysis_details_handler, &print_analysis_details_help);
 	rz_warn_if_fail(print_analysis_details_cd);
 
+	RzCmdDesc *print_analysis_passes_cd = rz_cmd_desc_argv_state_new(core->rcmd, aa_cd, "aaP", RZ_OUTPUT_MODE_STANDARD | RZ_OUTPUT_MODE_JSON | RZ_OUTPUT_MODE_TABLE, rz_print_analysis_passes_handler, &print_analysis_passes_help);
+	rz_warn_if_fail(print_analysis_passes_cd);
+
 	RzCmdDesc *analyze_all_unresolved_jumps_cd = rz_cmd_desc_argv_new(core->rcmd, aa_cd, "aaj", rz_analyze_all_unresolved_jumps_handler, &analyze_all_unresolved_jumps_help);
 	rz_warn_if_fail(analyze_all_unresolved_jumps_cd);
 
@@ -14179,6 +14402,9 @@ RZ_IPI void rzshell_cmddescs_init(RzCore *core) {
 	RzCmdDesc *analyze_all_preludes_cd = rz_cmd_desc_argv_new(core->rcmd, aa_cd, "aap", rz_analyze_all_preludes_handler, &analyze_all_preludes_help);
 	rz_warn_if_fail(analyze_all_preludes_cd);
 
+	RzCmdDesc *analyze_triage_cd = rz_cmd_desc_argv_new(core->rcmd, aa_cd, "aaq", rz_analyze_triage_handler, &analyze_triage_help);
+	rz_warn_if_fail(analyze_triage_cd);
+
 	RzCmdDesc *analyze_xrefs_section_bytes_cd = rz_cmd_desc_argv_new(core->rcmd, aa_cd, "aar", rz_analyze_xrefs_section_bytes_handler, &analyze_xrefs_section_bytes_help);
 	rz_warn_if_fail(analyze_xrefs_section_bytes_cd);
 
@@ -14447,6 +14673,19 @@ RZ_IPI void rzshell_cmddescs_init(RzCore *core) {
 	RzCmdDesc *analysis_esil_init_mem_p_cd = rz_cmd_desc_argv_new(core->rcmd, aeim_cd, "aeimp", rz_analysis_esil_init_mem_p_handler, &analysis_esil_init_mem_p_help);
 	rz_warn_if_fail(analysis_esil_init_mem_p_cd);
 
+	RzCmdDesc *aem_cd = rz_cmd_desc_group_state_new(core->rcmd, cmd_analysis_cd, "aem", RZ_OUTPUT_MODE_STANDARD | RZ_OUTPUT_MODE_JSON | RZ_OUTPUT_MODE_QUIET, rz_emu_mem_list_handler, &emu_mem_list_help, &aem_help);
+	rz_warn_if_fail(aem_cd);
+	RzCmdDesc *emu_mem_commit_cd = rz_cmd_desc_argv_new(core->rcmd, aem_cd, "aemc", rz_emu_mem_commit_handler, &emu_mem_commit_help);
+	rz_warn_if_fail(emu_mem_commit_cd);
+
+	RzCmdDesc *emu_mem_reset_cd = rz_cmd_desc_argv_new(core->rcmd, aem_cd, "aem-", rz_emu_mem_reset_handler, &emu_mem_reset_help);
+	rz_warn_if_fail(emu_mem_reset_cd);
+
+	RzCmdDesc *aeP_cd = rz_cmd_desc_group_state_new(core->rcmd, cmd_analysis_cd, "aeP", RZ_OUTPUT_MODE_STANDARD | RZ_OUTPUT_MODE_TABLE | RZ_OUTPUT_MODE_JSON | RZ_OUTPUT_MODE_QUIET, rz_emu_prof_list_handler, &emu_prof_list_help, &aeP_help);
+	rz_warn_if_fail(aeP_cd);
+	RzCmdDesc *emu_prof_reset_cd = rz_cmd_desc_argv_new(core->rcmd, aeP_cd, "aeP-", rz_emu_prof_reset_handler, &emu_prof_reset_help);
+	rz_warn_if_fail(emu_prof_reset_cd);
+
 	RzCmdDesc *aes_cd = rz_cmd_desc_group_new(core->rcmd, cmd_analysis_cd, "aes", rz_il_step_handler, &il_step_help, &aes_help);
 	rz_warn_if_fail(aes_cd);
 	RzCmdDesc *il_step_evaluate_cd = rz_cmd_desc_argv_new(core->rcmd, aes_cd, "aesp", rz_il_step_evaluate_handler, &il_step_evaluate_help);
@@ -14499,6 +14738,9 @@ RZ_IPI void rzshell_cmddescs_init(RzCore *core) {
 	RzCmdDesc *il_vm_step_until_addr_cd = rz_cmd_desc_argv_new(core->rcmd, aez_cd, "aezsu", rz_il_vm_step_until_addr_handler, &il_vm_step_until_addr_help);
 	rz_warn_if_fail(il_vm_step_until_addr_cd);
 
+	RzCmdDesc *il_vm_batch_cd = rz_cmd_desc_argv_modes_new(core->rcmd, aez_cd, "aezb", RZ_OUTPUT_MODE_STANDARD | RZ_OUTPUT_MODE_JSON, rz_il_vm_batch_handler, &il_vm_batch_help);
+	rz_warn_if_fail(il_vm_batch_cd);
+
 	RzCmdDesc *il_vm_status_cd = rz_cmd_desc_argv_modes_new(core->rcmd, aez_cd, "aezv", RZ_OUTPUT_MODE_STANDARD | RZ_OUTPUT_MODE_TABLE | RZ_OUTPUT_MODE_JSON | RZ_OUTPUT_MODE_QUIET, rz_il_vm_status_handler, &il_vm_status_help);
 	rz_warn_if_fail(il_vm_status_cd);
 
@@ -15230,6 +15472,14 @@ RZ_IPI void rzshell_cmddescs_init(RzCore *core) {
 	RzCmdDesc *cmd_debug_bt_toggle_bp_trace_cd = rz_cmd_desc_argv_new(core->rcmd, dbt_cd, "dbts", rz_cmd_debug_bt_toggle_bp_trace_handler, &cmd_debug_bt_toggle_bp_trace_help);
 	rz_warn_if_fail(cmd_debug_bt_toggle_bp_trace_cd);
 
+	RzCmdDesc *dbB_cd = rz_cmd_desc_group_new(core->rcmd, db_cd, "dbB", rz_cmd_debug_coverage_start_handler, &cmd_debug_coverage_start_help, &dbB_help);
+	rz_warn_if_fail(dbB_cd);
+	RzCmdDesc *cmd_debug_coverage_stop_cd = rz_cmd_desc_argv_new(core->rcmd, dbB_cd, "dbB-", rz_cmd_debug_coverage_stop_handler, &cmd_debug_coverage_stop_help);
+	rz_warn_if_fail(cmd_debug_coverage_stop_cd);
+
+	RzCmdDesc *cmd_debug_coverage_list_cd = rz_cmd_desc_argv_state_new(core->rcmd, dbB_cd, "dbBl", RZ_OUTPUT_MODE_STANDARD | RZ_OUTPUT_MODE_JSON | RZ_OUTPUT_MODE_QUIET, rz_cmd_debug_coverage_list_handler, &cmd_debug_coverage_list_help);
+	rz_warn_if_fail(cmd_debug_coverage_list_cd);
+
 	RzCmdDesc *cmd_debug_bp_set_expr_cur_offset_cd = rz_cmd_desc_argv_new(core->rcmd, db_cd, "dbx", rz_cmd_debug_bp_set_expr_cur_offset_handler, &cmd_debug_bp_set_expr_cur_offset_help);
 	rz_warn_if_fail(cmd_debug_bp_set_expr_cur_offset_cd);
 
@@ -15241,6 +15491,12 @@ RZ_IPI void rzshell_cmddescs_init(RzCore *core) {
 
 	RzCmdDesc *dc_cd = rz_cmd_desc_group_new(core->rcmd, cmd_debug_cd, "dc", rz_cmd_debug_continue_execution_handler, &cmd_debug_continue_execution_help, &dc_help);
 	rz_warn_if_fail(dc_cd);
+	RzCmdDesc *cmd_debug_continue_async_cd = rz_cmd_desc_argv_new(core->rcmd, dc_cd, "dca", rz_cmd_debug_continue_async_handler, &cmd_debug_continue_async_help);
+	rz_warn_if_fail(cmd_debug_continue_async_cd);
+
+	RzCmdDesc *cmd_debug_continue_wait_cd = rz_cmd_desc_argv_new(core->rcmd, dc_cd, "dcw", rz_cmd_debug_continue_wait_handler, &cmd_debug_continue_wait_help);
+	rz_warn_if_fail(cmd_debug_continue_wait_cd);
+
 	RzCmdDesc *cmd_debug_continue_back_cd = rz_cmd_desc_argv_new(core->rcmd, dc_cd, "dcb", rz_cmd_debug_continue_back_handler, &cmd_debug_continue_back_help);
 	rz_warn_if_fail(cmd_debug_continue_back_cd);
 
@@ -15364,6 +15620,12 @@ RZ_IPI void rzshell_cmddescs_init(RzCore *core) {
 	RzCmdDesc *cmd_debug_trace_interactive_cd = rz_cmd_desc_argv_new(core->rcmd, dtg_cd, "dtgi", rz_cmd_debug_trace_interactive_handler, &cmd_debug_trace_interactive_help);
 	rz_warn_if_fail(cmd_debug_trace_interactive_cd);
 
+	RzCmdDesc *cmd_debug_trace_drcov_cd = rz_cmd_desc_argv_new(core->rcmd, dt_cd, "dtd", rz_cmd_debug_trace_drcov_handler, &cmd_debug_trace_drcov_help);
+	rz_warn_if_fail(cmd_debug_trace_drcov_cd);
+
+	RzCmdDesc *cmd_debug_trace_maps_coverage_cd = rz_cmd_desc_argv_new(core->rcmd, dt_cd, "dtm", rz_cmd_debug_trace_maps_coverage_handler, &cmd_debug_trace_maps_coverage_help);
+	rz_warn_if_fail(cmd_debug_trace_maps_coverage_cd);
+
 	RzCmdDesc *dts_cd = rz_cmd_desc_group_new(core->rcmd, dt_cd, "dts", NULL, NULL, &dts_help);
 	rz_warn_if_fail(dts_cd);
 	RzCmdDesc *cmd_debug_start_trace_session_cd = rz_cmd_desc_argv_new(core->rcmd, dts_cd, "dts+", rz_cmd_debug_start_trace_session_handler, &cmd_debug_start_trace_session_help);
@@ -15381,6 +15643,9 @@ RZ_IPI void rzshell_cmddescs_init(RzCore *core) {
 	RzCmdDesc *cmd_debug_list_trace_session_mmap_cd = rz_cmd_desc_argv_new(core->rcmd, dts_cd, "dtsm", rz_cmd_debug_list_trace_session_mmap_handler, &cmd_debug_list_trace_session_mmap_help);
 	rz_warn_if_fail(cmd_debug_list_trace_session_mmap_cd);
 
+	RzCmdDesc *cmd_debug_trace_session_changed_pages_cd = rz_cmd_desc_argv_state_new(core->rcmd, dts_cd, "dtsc", RZ_OUTPUT_MODE_STANDARD | RZ_OUTPUT_MODE_JSON | RZ_OUTPUT_MODE_QUIET, rz_cmd_debug_trace_session_changed_pages_handler, &cmd_debug_trace_session_changed_pages_help);
+	rz_warn_if_fail(cmd_debug_trace_session_changed_pages_cd);
+
 	RzCmdDesc *cmd_debug_trace_tag_cd = rz_cmd_desc_argv_new(core->rcmd, dt_cd, "dtt", rz_cmd_debug_trace_tag_handler, &cmd_debug_trace_tag_help);
 	rz_warn_if_fail(cmd_debug_trace_tag_cd);
 
@@ -180,19 +180,21 @@ RZ_API RzBinReloc *rz_core_getreloc(RzCore *core, ut64 addr, int size) {
 		return NULL;
 	}
 	RzBinFile *bf = rz_bin_cur(core->bin);
-	if (!bf || !bf->o || !bf->o->relocs) {
+	RzBinRelocStorage *relocs = bf && bf->o ? rz_bin_object_get_relocs(bf->o) : NULL;
+	if (!relocs) {
 		return NULL;
 	}
-	return rz_bin_reloc_storage_get_reloc_in(bf->o->relocs, addr, size);
+	return rz_bin_reloc_storage_get_reloc_in(relocs, addr, size);
 }
 
 RZ_API RzBinReloc *rz_core_get_reloc_to(RzCore *core, ut64 addr) {
 	rz_return_val_if_fail(core, NULL);
 	RzBinFile *bf = rz_bin_cur(core->bin);
-	if (!bf || !bf->o || !bf->o->relocs) {
+	RzBinRelocStorage *relocs = bf && bf->o ? rz_bin_object_get_relocs(bf->o) : NULL;
+	if (!relocs) {
 		return NULL;
 	}
-	return rz_bin_reloc_storage_get_reloc_to(bf->o->relocs, addr);
+	return rz_bin_reloc_storage_get_reloc_to(relocs, addr);
 }
 
 /* returns the address of a jmp/call given a shortcut by the user or UT64_MAX
@@ -1253,7 +1255,7 @@ static bool add_argv(RzFlagItem *fi, void *user) {
 static void autocomplete_flags(RzCore *core, RzLineCompletion *completion, const char *str) {
 	rz_return_if_fail(str);
 	int n = strlen(str);
-	rz_flag_foreach_prefix(core->flags, str, n, add_argv, completion);
+	rz_flag_foreach_name_prefix(core->flags, str, n, add_argv, completion);
 }
 
 // TODO: Should be refactored
@@ -1562,7 +1564,7 @@ RZ_API void rz_core_autocomplete(RZ_NULLABLE RzCore *core, RzLineCompletion *com
 		ptr = (char *)rz_str_trim_head_ro(ptr + 1);
 		n = strlen(ptr); //(buf->data+sdelta);
 		sdelta = (int)(size_t)(ptr - buf->data);
-		rz_flag_foreach_prefix(core->flags, buf->data + sdelta, n, add_argv, completion);
+		rz_flag_foreach_name_prefix(core->flags, buf->data + sdelta, n, add_argv, completion);
 	} else if (!strncmp(buf->data, "#!pipe ", 7)) {
 		if (strchr(buf->data + 7, ' ')) {
 			autocompleteFilename(completion, buf, NULL, 2);
@@ -2153,6 +2155,10 @@ static void rz_core_break(RzCore *core) {
 }
 
 static void *rz_core_sleep_begin(RzCore *core) {
+	if (core->analysis->publish_snapshots) {
+		// only the task holding the turn gets here, the tables are consistent
+		rz_analysis_snapshot_publish(core->analysis);
+	}
 	RzCoreTask *task = rz_core_task_self(&core->tasks);
 	if (task) {
 		rz_core_task_sleep_begin(task);
@@ -2342,8 +2348,12 @@ static int bp_bits_at(ut64 addr, void *user) {
 static void ev_iowrite_cb(RzEvent *ev, int type, void *user, void *data) {
 	RzCore *core = user;
 	RzEventIOWrite *iow = data;
+	rz_analysis_fcn_invalidate_read_ahead_cache(core->analysis);
+	rz_core_disasm_cache_invalidate(core->disasm_cache);
+	rz_core_heap_cache_invalidate(core->heap_cache);
+	rz_core_search_index_invalidate(core, iow->addr, iow->len);
 	if (rz_config_get_i(core->config, "analysis.detectwrites")) {
-		rz_analysis_update_analysis_range(core->analysis, iow->addr, iow->len);
+		rz_core_analysis_update_written(core, iow->addr, iow->len);
 		if (core->cons->event_resize && core->cons->event_data) {
 			// Force a reload of the graph
 			core->cons->event_resize(core->cons->event_data);
@@ -2359,11 +2369,14 @@ RZ_IPI void rz_core_vfile_bin_file_deleted(RzCore *core, RzBinFile *bf);
 static void ev_iodescclose_cb(RzEvent *ev, int type, void *user, void *data) {
 	RzEventIODescClose *ioc = data;
 	rz_core_file_io_desc_closed(user, ioc->desc);
+	rz_core_heap_cache_invalidate(((RzCore *)user)->heap_cache);
 }
 
 static void ev_iomapdel_cb(RzEvent *ev, int type, void *user, void *data) {
 	RzEventIOMapDel *iod = data;
 	rz_core_file_io_map_deleted(user, iod->map);
+	rz_core_search_index_invalidate(user, iod->map->itv.addr, iod->map->itv.size);
+	rz_core_heap_cache_invalidate(((RzCore *)user)->heap_cache);
 }
 
 static void ev_binfiledel_cb(RzEvent *ev, int type, void *user, void *data) {
@@ -2378,6 +2391,10 @@ RZ_IPI void rz_core_file_free(RzCoreFile *cf);
 
 RZ_IPI extern RzIOPlugin rz_core_io_plugin_vfile;
 
+static bool lang_read_at(RzCore *core, ut64 addr, ut8 *buf, int len) {
+	return rz_io_read_at(core->io, addr, buf, len);
+}
+
 RZ_API bool rz_core_init(RzCore *core) {
 	core->blocksize = RZ_CORE_BLOCKSIZE;
 	core->block = (ut8 *)calloc(RZ_CORE_BLOCKSIZE + 1, 1);
@@ -2472,6 +2489,7 @@ RZ_API bool rz_core_init(RzCore *core) {
 	core->lang = rz_lang_new();
 	core->lang->cmd_str = (char *(*)(void *, const char *))rz_core_cmd_str;
 	core->lang->cmdf = (int (*)(void *, const char *, ...))rz_core_cmdf;
+	core->lang->read_at = (RzCoreReadAtCallback)lang_read_at;
 	rz_core_bind_cons(core);
 	core->lang->cb_printf = rz_cons_printf;
 	rz_lang_define(core->lang, "RzCore", "core", core);
@@ -2628,6 +2646,17 @@ RZ_API void rz_core_fini(RzCore *c) {
 	rz_core_task_break_all(&c->tasks);
 	rz_core_task_join(&c->tasks, NULL, -1);
 	rz_core_wait(c);
+	if (rz_config_get_b(c->config, "cfg.tracing")) {
+		// writes cfg.tracing.file
+		rz_config_set_b(c->config, "cfg.tracing", false);
+	}
+	RZ_FREE_CUSTOM(c->task_pool, rz_th_task_pool_free);
+	RZ_FREE_CUSTOM(c->analysis_dirty_fcns, set_u_free);
+	RZ_FREE_CUSTOM(c->disasm_cache, rz_core_disasm_cache_free);
+	RZ_FREE_CUSTOM(c->heap_cache, rz_core_heap_cache_free);
+	RZ_FREE_CUSTOM(c->stats_cache, rz_core_analysis_stats_cache_free);
+	RZ_FREE_CUSTOM(c->search_indexes, rz_list_free);
+	RZ_FREE_CUSTOM(c->analysis_passes, rz_vector_free);
 	//  avoid double free
 	RZ_FREE_CUSTOM(c->hash, rz_hash_free);
 	RZ_FREE_CUSTOM(c->ropchain, rz_list_free);
@@ -2828,6 +2857,10 @@ RZ_API int rz_core_prompt(RzCore *r, int sync) {
 }
 
 RZ_API int rz_core_prompt_exec(RzCore *r) {
+	// stops of a target continued in the background are handled between commands
+	if (r->dbg && rz_core_debug_async_collect(r, false)) {
+		RZ_LOG_INFO("The target stopped at 0x%" PFMT64x "\n", rz_debug_reg_get(r->dbg, "PC"));
+	}
 	int ret = rz_core_cmd(r, r->cmdqueue, true);
 	r->rc = r->num->value;
 	// int ret = rz_core_cmd (r, r->cmdqueue, true);
@@ -2889,6 +2922,8 @@ typedef struct {
 	RzSocket *fd;
 	RzSocket *client;
 	bool listener;
+	ut32 caps;
+	ut64 offset;
 } RzIORap;
 
 static void rap_break(void *u) {
@@ -2899,6 +2934,77 @@ static void rap_break(void *u) {
 	}
 }
 
+static ut32 rap_server_caps(void) {
+#if HAVE_ZLIB
+	return RAP_CAP_READV | RAP_CAP_ZLIB;
+#else
+	return RAP_CAP_READV;
+#endif
+}
+
+/**
+ * Answer a RAP_PACKET_READV, whose opcode was already read from \p c, with
+ * the concatenated data of all the ranges, deflated if the client asked for
+ * it and it makes the reply smaller.
+ */
+static bool rap_serve_readv(RzCore *core, RzSocket *c) {
+	ut8 hdr[10];
+	if (rz_socket_read_block(c, hdr, 5) != 5) {
+		return false;
+	}
+	ut32 n = rz_read_be32(hdr);
+	ut8 flags = hdr[4];
+	if (n > RAP_READV_MAX_IOV) {
+		return false;
+	}
+	ut8 ranges[RAP_READV_MAX_IOV * 12];
+	if (rz_socket_read_block(c, ranges, n * 12) != n * 12) {
+		return false;
+	}
+	ut64 total = 0;
+	for (ut32 i = 0; i < n; i++) {
+		total += rz_read_be32(ranges + i * 12 + 8);
+	}
+	if (total > RAP_READV_MAX) {
+		return false;
+	}
+	ut8 *data = malloc(RZ_MAX(total, 1));
+	if (!data) {
+		return false;
+	}
+	ut8 *p = data;
+	for (ut32 i = 0; i < n; i++) {
+		ut32 len = rz_read_be32(ranges + i * 12 + 8);
+		rz_io_read_at(core->io, rz_read_be64(ranges + i * 12), p, len);
+		p += len;
+	}
+	ut8 *out = data;
+	int out_len = (int)total;
+	hdr[5] = 0;
+	if ((flags & RAP_READV_ZLIB) && total) {
+		int zlen = 0;
+		ut8 *z = rz_deflate(data, (int)total, NULL, &zlen);
+		if (z && zlen > 0 && zlen < total) {
+			out = z;
+			out_len = zlen;
+			hdr[5] = RAP_READV_ZLIB;
+		} else {
+			free(z);
+		}
+	}
+	hdr[0] = RAP_PACKET_READV | RAP_PACKET_REPLY;
+	rz_write_be32(hdr + 1, out_len);
+	rz_write_be32(hdr + 6, (ut32)total);
+	rz_socket_write(c, hdr, 10);
+	rz_socket_write(c, out, out_len);
+	rz_socket_flush(c);
+	if (out != data) {
+		free(out);
+	}
+	free(data);
+	return true;
+}
+
 // TODO: PLEASE move into core/io/rap? */
 // TODO: use static buffer instead of mallocs all the time. it's network!
 RZ_API bool rz_core_serve(RzCore *core, RzIODesc *file) {
@@ -2985,10 +3091,26 @@ reaccept:
 				}
 				buf[0] = RAP_PACKET_OPEN | RAP_PACKET_REPLY;
 				rz_write_be32(buf + 1, pipefd);
-				rz_socket_write(c, buf, 5);
+				if (flg & RAP_OPEN_CAPS) {
+					buf[0] |= RAP_PACKET_EXTENDED;
+					rz_write_be32(buf + 5, rap_server_caps());
+				}
+				rz_socket_write(c, buf, (flg & RAP_OPEN_CAPS) ? 9 : 5);
 				rz_socket_flush(c);
 				RZ_FREE(ptr);
 				break;
+			case RAP_PACKET_READV:
+				if (!rap_serve_readv(core, c)) {
+					eprintf("rap: invalid readv request\n");
+					rz_socket_close(c);
+					if (rz_config_get_i(core->config, "rap.loop")) {
+						eprintf("rap: waiting for new connection\n");
+						rz_socket_free(c);
+						goto reaccept;
+					}
+					goto out_of_function;
+				}
+				break;
 			case RAP_PACKET_READ:
 				rz_socket_read_block(c, (ut8 *)&buf, 4);
 				i = rz_read_be32(buf);
@@ -3285,6 +3407,26 @@ RZ_API RzConfig *rz_core_get_config(RzCore *core) {
 	return core->config;
 }
 
+static bool core_task_pool_is_breaked(void *user) {
+	return rz_cons_is_breaked();
+}
+
+/**
+ * \brief Returns the pool of workers shared by every command, allocating it on first use
+ *
+ * The tasks submitted to it are cancelled when the user breaks (^C).
+ */
+RZ_API RZ_BORROW RzThreadTaskPool *rz_core_get_task_pool(RZ_NONNULL RzCore *core) {
+	rz_return_val_if_fail(core, NULL);
+	if (!core->task_pool) {
+		core->task_pool = rz_th_task_pool_new(RZ_THREAD_POOL_ALL_CORES);
+		if (core->task_pool) {
+			rz_th_task_pool_set_break_callback(core->task_pool, core_task_pool_is_breaked, core);
+		}
+	}
+	return core->task_pool;
+}
+
 RZ_API RzBin *rz_core_get_bin(RzCore *core) {
 	return core->bin;
 }
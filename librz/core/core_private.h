@@ -29,6 +29,7 @@ RZ_IPI bool rz_core_analysis_il_vm_set(RzCore *core, const char *var_name, ut64
 RZ_IPI void rz_core_analysis_il_vm_status(RzCore *core, const char *varname, RzOutputMode mode);
 RZ_IPI bool rz_core_il_step(RzCore *core);
 RZ_IPI bool rz_core_analysis_il_step_with_events(RzCore *core, PJ *pj);
+RZ_IPI bool rz_core_analysis_il_batch(RzCore *core, const char *reg_name, const char *values, ut64 until, ut64 max_steps, RzOutputMode mode);
 
 RZ_IPI bool rz_core_analysis_var_rename(RzCore *core, const char *name, const char *newname);
 RZ_IPI char *rz_core_analysis_function_signature(RzCore *core, RzOutputMode mode, char *fcn_name);
@@ -37,6 +38,15 @@ RZ_IPI char *rz_core_analysis_var_display(RzCore *core, RzAnalysisVar *var, bool
 RZ_IPI char *rz_core_analysis_all_vars_display(RzCore *core, RzAnalysisFunction *fcn, bool add_name);
 RZ_IPI bool rz_analysis_var_global_list_show(RzAnalysis *analysis, RzCmdStateOutput *state, RZ_NULLABLE const char *name);
 RZ_IPI bool rz_core_analysis_types_propagation(RzCore *core);
+RZ_IPI bool rz_core_analysis_types_propagation_dirty(RzCore *core);
+RZ_IPI void rz_core_analysis_stats_cache_free(RZ_NULLABLE RzCoreAnalysisStatsCache *cache);
+
+/* analysis_tp.c */
+typedef struct rz_core_type_match_emul_t RzCoreTypeMatchEmul;
+RZ_IPI RZ_OWN RzCoreTypeMatchEmul *rz_core_analysis_type_match_emul_begin(RzCore *core);
+RZ_IPI void rz_core_analysis_type_match_emul_end(RzCore *core, RZ_NULLABLE RzCoreTypeMatchEmul *emul);
+RZ_IPI void rz_core_analysis_type_match_emul(RzCore *core, RZ_NONNULL RzCoreTypeMatchEmul *emul, RzAnalysisFunction *fcn, HtUU *loop_table);
+RZ_IPI void rz_core_analysis_update_written(RzCore *core, ut64 addr, int len);
 RZ_IPI bool rz_core_analysis_function_set_signature(RzCore *core, RzAnalysisFunction *fcn, const char *newsig);
 RZ_IPI void rz_core_analysis_function_signature_editor(RzCore *core, ut64 addr);
 RZ_IPI void rz_core_analysis_bbs_asciiart(RzCore *core, RzAnalysisFunction *fcn);
@@ -124,6 +134,8 @@ RZ_IPI void rz_core_debug_sync_bits(RzCore *core);
 RZ_IPI void rz_core_debug_single_step_in(RzCore *core);
 RZ_IPI void rz_core_debug_single_step_over(RzCore *core);
 RZ_IPI void rz_core_debug_continue(RzCore *core);
+RZ_IPI bool rz_core_debug_continue_async(RzCore *core);
+RZ_IPI bool rz_core_debug_async_collect(RzCore *core, bool block);
 RZ_IPI void rz_core_debug_attach(RzCore *core, int pid);
 RZ_IPI void rz_core_debug_print_status(RzCore *core);
 RZ_IPI void rz_core_debug_bp_add(RzCore *core, ut64 addr, const char *arg_perm, bool hwbp, bool watch);
@@ -142,6 +154,17 @@ RZ_IPI bool rz_disasm_check_end(int nb_opcodes, int i_opcodes, int nb_bytes, int
 RZ_IPI void rz_core_asm_bb_middle(RZ_NONNULL RzCore *core, ut64 at, RZ_INOUT RZ_NONNULL int *oplen, RZ_NONNULL int *ret);
 RZ_IPI bool rz_core_handle_backwards_disasm(RZ_NONNULL RzCore *core,
 	RZ_NONNULL RZ_INOUT int *pn_opcodes, RZ_NONNULL RZ_INOUT int *pn_bytes);
+RZ_IPI void rz_core_disasm_cache_free(RZ_NULLABLE RzCoreDisasmCache *cache);
+RZ_IPI void rz_core_disasm_cache_invalidate(RZ_NULLABLE RzCoreDisasmCache *cache);
+
+/* cheap.c */
+RZ_IPI bool rz_core_heap_read(RZ_NONNULL RzCore *core, ut64 addr, RZ_NONNULL RZ_OUT ut8 *buf, ut64 len);
+RZ_IPI void rz_core_heap_prefetch(RZ_NONNULL RzCore *core, ut64 addr, ut64 len);
+RZ_IPI void rz_core_heap_cache_invalidate(RZ_NULLABLE RzCoreHeapCache *cache);
+RZ_IPI void rz_core_heap_cache_free(RZ_NULLABLE RzCoreHeapCache *cache);
+
+/* cmd_search.c */
+RZ_IPI void rz_core_search_index_invalidate(RzCore *core, ut64 addr, ut64 len);
 
 /* cmd_seek.c */
 RZ_IPI bool rz_core_seek_to_register(RzCore *core, const char *input, bool is_silent);
@@ -443,7 +443,7 @@ RZ_API bool rz_core_flirt_create_file(RZ_NONNULL RzCore *core, RZ_NONNULL const
 		return false;
 	}
 
-	RzFlirtNode *node = rz_sign_flirt_node_new(core->analysis, optimize);
+	RzFlirtNode *node = rz_sign_flirt_node_new(core->analysis, optimize, rz_core_get_task_pool(core));
 	if (!node) {
 		return false;
 	}
@@ -77,6 +77,19 @@ static const char *rz_vline_uc[] = {
 #define DS_PRE_FCN_MIDDLE 3
 #define DS_PRE_FCN_TAIL   4
 
+#define DS_ASM_BATCH 64
+
+/* instructions decoded ahead of the one being disassembled, see ds_asm_disassemble() */
+typedef struct {
+	RzAsmInsn insns[DS_ASM_BATCH];
+	RzStrBuf text;
+	int count;
+	int pos;
+	RzAsmPlugin *cur; ///< plugin, bits and syntax the batch was decoded with
+	int bits;
+	int syntax;
+} DisasmAsmBatch;
+
 // TODO: what about using bit shifting and enum for keys? see librz/util/bitmap.c
 // the problem of this is that the fields will be more opaque to bindings, but we will earn some bits
 typedef struct {
@@ -303,8 +316,31 @@ typedef struct {
 	int asm_types;
 
 	RzPVector *vec;
+	DisasmAsmBatch asm_batch;
 } RzDisasmState;
 
+#define DS_CACHE_MAX_BYTES 32
+#define DS_CACHE_MAX_LINES 0x4000
+
+/* formatted output of one instruction, valid as long as the bytes and the reflines around it match */
+typedef struct {
+	ut8 bytes[DS_CACHE_MAX_BYTES];
+	int inc;
+	bool is_dest;
+	char *line;
+	char *refline2;
+	char *text;
+	int text_len;
+} RzDisasmCacheLine;
+
+struct rz_core_disasm_cache_t {
+	HtUP *lines; ///< address -> RzDisasmCacheLine
+	ut64 analysis_generation;
+	ut64 flags_generation;
+	ut64 config_generation;
+	int cols;
+};
+
 static void ds_setup_print_pre(RzDisasmState *ds, bool tail, bool middle);
 static void ds_setup_pre(RzDisasmState *ds, bool tail, bool middle);
 static void ds_print_pre(RzDisasmState *ds, bool fcnline);
@@ -917,6 +953,7 @@ static void ds_free(RzDisasmState *ds) {
 		}
 	}
 	rz_asm_op_fini(&ds->asmop);
+	rz_strbuf_fini(&ds->asm_batch.text);
 	rz_analysis_op_fini(&ds->analysis_op);
 	rz_analysis_hint_free(ds->hint);
 	ds_print_esil_analysis_fini(ds);
@@ -1098,17 +1135,16 @@ static void ds_build_op_str(RzDisasmState *ds, bool print_color) {
 			free(ds->opstr);
 			ds->opstr = strdup(ds->strsub);
 		}
-		if (core->parser->subrel) {
-			RzList *list = rz_analysis_xrefs_get_from(core->analysis, at);
-			RzListIter *iter;
+		RzVector *xrefs = core->parser->subrel ? rz_analysis_xrefs_get_from_vec(core->analysis, at) : NULL;
+		if (xrefs) {
 			RzAnalysisXRef *xref;
-			rz_list_foreach (list, iter, xref) {
+			rz_vector_foreach(xrefs, xref) {
 				if ((xref->type == RZ_ANALYSIS_XREF_TYPE_DATA || xref->type == RZ_ANALYSIS_XREF_TYPE_STRING) && ds->analysis_op.type == RZ_ANALYSIS_OP_TYPE_LEA) {
 					core->parser->subrel_addr = xref->to;
 					break;
 				}
 			}
-			rz_list_free(list);
+			rz_vector_free(xrefs);
 		}
 	}
 
@@ -1283,6 +1319,8 @@ static void ds_begin_line(RzDisasmState *ds) {
 		}
 		pj_k(ds->pj, "text");
 	}
+	// the previous lines are done, so they can already be written out
+	rz_cons_flush_stream();
 	ds->buf_line_begin = rz_cons_get_buffer_len();
 	if (!ds->pj && ds->asm_hint_pos == -1) {
 		if (!ds_print_core_vmode(ds, ds->asm_hint_pos)) {
@@ -1341,14 +1379,16 @@ static void ds_begin_comment(RzDisasmState *ds) {
 
 static void ds_show_refs(RzDisasmState *ds) {
 	RzAnalysisXRef *xref;
-	RzListIter *iter;
 
 	if (!ds->show_cmtrefs) {
 		return;
 	}
-	RzList *list = rz_analysis_xrefs_get_from(ds->core->analysis, ds->at);
+	RzVector *xrefs = rz_analysis_xrefs_get_from_vec(ds->core->analysis, ds->at);
+	if (!xrefs) {
+		return;
+	}
 
-	rz_list_foreach (list, iter, xref) {
+	rz_vector_foreach(xrefs, xref) {
 		const char *cmt = rz_meta_get_string(ds->core->analysis, RZ_META_TYPE_COMMENT, xref->to);
 		const RzList *fls = rz_flag_get_list(ds->core->flags, xref->to);
 		RzListIter *iter2;
@@ -1383,12 +1423,11 @@ static void ds_show_refs(RzDisasmState *ds) {
 		}
 		ds_print_color_reset(ds);
 	}
-	rz_list_free(list);
+	rz_vector_free(xrefs);
 }
 
 static void ds_show_xrefs(RzDisasmState *ds) {
 	RzAnalysisXRef *xrefi;
-	RzListIter *iter, *it;
 	RzCore *core = ds->core;
 	char *name, *realname;
 	int count = 0;
@@ -1396,26 +1435,31 @@ static void ds_show_xrefs(RzDisasmState *ds) {
 		return;
 	}
 	/* show xrefs */
-	RzList *xrefs = rz_analysis_xrefs_get_to(core->analysis, ds->at);
+	RzVector *xrefs = rz_analysis_xrefs_get_to_vec(core->analysis, ds->at);
 	if (!xrefs) {
 		return;
 	}
+	size_t len = rz_vector_len(xrefs);
+	if (!len) {
+		rz_vector_free(xrefs);
+		return;
+	}
 	// only show fcnline in xrefs when addr is not the beginning of a function
 	bool fcnlines = (ds->fcn && ds->fcn->addr == ds->at);
-	if (rz_list_length(xrefs) > ds->maxrefs) {
+	if (len > ds->maxrefs) {
 		ds_begin_line(ds);
 		ds_pre_xrefs(ds, fcnlines);
 		ds_comment(ds, false, "%s; XREFS(%d)",
 			ds->show_color ? ds->pal_comment : "",
-			rz_list_length(xrefs));
+			(int)len);
 		if (ds->show_color) {
 			ds_print_color_reset(ds);
 		}
 		ds_newline(ds);
-		rz_list_free(xrefs);
+		rz_vector_free(xrefs);
 		return;
 	}
-	if (rz_list_length(xrefs) > ds->foldxrefs) {
+	if (len > ds->foldxrefs) {
 		int cols = rz_cons_get_size(NULL);
 		cols -= 15;
 		cols /= 23;
@@ -1423,11 +1467,12 @@ static void ds_show_xrefs(RzDisasmState *ds) {
 		ds_begin_line(ds);
 		ds_pre_xrefs(ds, fcnlines);
 		ds_comment(ds, false, "%s; XREFS: ", ds->show_color ? ds->pal_comment : "");
-		rz_list_foreach (xrefs, iter, xrefi) {
+		size_t i = 0;
+		rz_vector_foreach(xrefs, xrefi) {
 			ds_comment(ds, false, "%s 0x%08" PFMT64x "  ",
 				rz_analysis_xrefs_type_tostring(xrefi->type), xrefi->from);
 			if (count == cols) {
-				if (iter->n) {
+				if (++i < len) {
 					ds_print_color_reset(ds);
 					ds_newline(ds);
 					ds_begin_line(ds);
@@ -1436,19 +1481,23 @@ static void ds_show_xrefs(RzDisasmState *ds) {
 				}
 				count = 0;
 			} else {
+				i++;
 				count++;
 			}
 		}
 		ds_print_color_reset(ds);
 		ds_newline(ds);
-		rz_list_free(xrefs);
+		rz_vector_free(xrefs);
 		return;
 	}
 
-	RzList *addrs = rz_list_newf(free);
+	RzVector addrs;
+	rz_vector_init(&addrs, sizeof(ut64), NULL, NULL);
 	RzAnalysisFunction *fun, *next_fun;
 	RzFlagItem *f, *next_f;
-	rz_list_foreach (xrefs, iter, xrefi) {
+	for (size_t i = 0; i < len; i++) {
+		xrefi = rz_vector_index_ptr(xrefs, i);
+		RzAnalysisXRef *next = i + 1 < len ? rz_vector_index_ptr(xrefs, i + 1) : NULL;
 		if (!ds->asm_xrefs_code && xrefi->type == RZ_ANALYSIS_XREF_TYPE_CODE) {
 			continue;
 		}
@@ -1456,11 +1505,10 @@ static void ds_show_xrefs(RzDisasmState *ds) {
 			realname = NULL;
 			fun = fcnIn(ds, xrefi->from, -1);
 			if (fun) {
-				if (iter != xrefs->tail) {
-					ut64 next_addr = ((RzAnalysisXRef *)(iter->n->data))->from;
-					next_fun = rz_analysis_get_fcn_in(core->analysis, next_addr, -1);
+				if (next) {
+					next_fun = rz_analysis_get_fcn_in(core->analysis, next->from, -1);
 					if (next_fun && next_fun->addr == fun->addr) {
-						rz_list_append(addrs, rz_num_dup(xrefi->from));
+						rz_vector_push(&addrs, &xrefi->from);
 						continue;
 					}
 				}
@@ -1471,15 +1519,15 @@ static void ds_show_xrefs(RzDisasmState *ds) {
 					}
 				}
 				name = strdup(fun->name);
-				rz_list_append(addrs, rz_num_dup(xrefi->from));
+				rz_vector_push(&addrs, &xrefi->from);
 			} else {
 				f = rz_flag_get_at(core->flags, xrefi->from, true);
 				if (f) {
-					if (iter != xrefs->tail) {
-						ut64 next_addr = ((RzAnalysisXRef *)(iter->n->data))->from;
-						next_f = rz_flag_get_at(core->flags, next_addr, true);
+					ut64 delta = xrefi->from - f->offset;
+					if (next) {
+						next_f = rz_flag_get_at(core->flags, next->from, true);
 						if (next_f && f->offset == next_f->offset) {
-							rz_list_append(addrs, rz_num_dup(xrefi->from - f->offset));
+							rz_vector_push(&addrs, &delta);
 							continue;
 						}
 					}
@@ -1495,22 +1543,22 @@ static void ds_show_xrefs(RzDisasmState *ds) {
 						}
 					}
 					name = strdup(f->name);
-					rz_list_append(addrs, rz_num_dup(xrefi->from - f->offset));
+					rz_vector_push(&addrs, &delta);
 				} else {
 					name = strdup("unk");
 				}
 			}
 			ds_begin_line(ds);
 			ds_pre_xrefs(ds, fcnlines);
-			const char *plural = rz_list_length(addrs) > 1 ? "S" : "";
+			const char *plural = rz_vector_len(&addrs) > 1 ? "S" : "";
 			const char *plus = fun ? "" : "+";
 			ds_comment(ds, false, "%s; %s XREF%s from %s @ ",
 				COLOR(ds, pal_comment), rz_analysis_xrefs_type_tostring(xrefi->type), plural,
 				realname ? realname : name);
 			ut64 *addrptr;
-			rz_list_foreach (addrs, it, addrptr) {
-				if (addrptr && *addrptr) {
-					ds_comment(ds, false, "%s%s0x%" PFMT64x, it == addrs->head ? "" : ", ", plus, *addrptr);
+			rz_vector_foreach(&addrs, addrptr) {
+				if (*addrptr) {
+					ds_comment(ds, false, "%s%s0x%" PFMT64x, addrptr == rz_vector_head(&addrs) ? "" : ", ", plus, *addrptr);
 				}
 			}
 			if (realname && (!fun || rz_analysis_get_function_at(core->analysis, ds->at))) {
@@ -1524,15 +1572,15 @@ static void ds_show_xrefs(RzDisasmState *ds) {
 			}
 			ds_comment(ds, false, "%s", COLOR_RESET(ds));
 			ds_newline(ds);
-			rz_list_purge(addrs);
+			rz_vector_clear(&addrs);
 			RZ_FREE(name);
 			free(realname);
 		} else {
 			eprintf("Corrupted database?\n");
 		}
 	}
-	rz_list_free(addrs);
-	rz_list_free(xrefs);
+	rz_vector_fini(&addrs);
+	rz_vector_free(xrefs);
 }
 
 static bool calc_tab_buf_size(size_t len, size_t tabs, size_t *c) {
@@ -1927,6 +1975,7 @@ static void ds_show_functions(RzDisasmState *ds) {
 	if (!f) {
 		return;
 	}
+	rz_core_analysis_function_vars_ensure(core, f);
 	if (demangle) {
 		fcn_name = rz_bin_demangle(core->bin->cur, lang, f->name, f->addr, keep_lib);
 		if (fcn_name) {
@@ -2584,6 +2633,44 @@ static void ds_update_ref_lines(RzDisasmState *ds) {
 	}
 }
 
+/**
+ * Same as rz_asm_disassemble() at the pc of core->rasm, but served from a
+ * batch of up to \p max instructions decoded at once with
+ * rz_asm_disassemble_batch(), for plugins that support it.
+ */
+static int ds_asm_disassemble(RzDisasmState *ds, RzAsmOp *op, const ut8 *buf, int len, int max) {
+	RzAsm *a = ds->core->rasm;
+	DisasmAsmBatch *b = &ds->asm_batch;
+	if (!a->cur || !a->cur->disassemble_batch || ds->core->io->addrbytes != 1) {
+		return rz_asm_disassemble(a, op, buf, len);
+	}
+	if (b->cur != a->cur || b->bits != a->bits || b->syntax != a->syntax) {
+		b->count = 0;
+	}
+	while (b->pos < b->count && b->insns[b->pos].addr < a->pc) {
+		b->pos++;
+	}
+	if (b->pos >= b->count || b->insns[b->pos].addr != a->pc) {
+		rz_strbuf_fini(&b->text);
+		b->count = rz_asm_disassemble_batch(a, buf, len, b->insns, RZ_MAX(1, RZ_MIN(max, DS_ASM_BATCH)), &b->text);
+		b->pos = 0;
+		b->cur = a->cur;
+		b->bits = a->bits;
+		b->syntax = a->syntax;
+	}
+	RzAsmInsn *insn = b->pos < b->count ? &b->insns[b->pos] : NULL;
+	if (!insn || insn->invalid || insn->size > len) {
+		// invalid instructions are printed in many ways, let the plugin do it
+		return rz_asm_disassemble(a, op, buf, len);
+	}
+	b->pos++;
+	rz_asm_op_init(op);
+	op->size = insn->size;
+	rz_asm_op_set_asm(op, rz_strbuf_get(&b->text) + insn->asm_off);
+	rz_asm_op_set_buf(op, buf, insn->size);
+	return insn->size;
+}
+
 static int ds_disassemble(RzDisasmState *ds, ut8 *buf, int len) {
 	RzCore *core = ds->core;
 	int ret;
@@ -2625,7 +2712,7 @@ static int ds_disassemble(RzDisasmState *ds, ut8 *buf, int len) {
 		ds->opstr = strdup(ds->hint->opcode);
 	}
 	rz_asm_op_fini(&ds->asmop);
-	ret = rz_asm_disassemble(core->rasm, &ds->asmop, buf, len);
+	ret = ds_asm_disassemble(ds, &ds->asmop, buf, len, ds->l > 0 ? ds->l : DS_ASM_BATCH);
 	if (ds->asmop.size < 1) {
 		ds->asmop.size = 1;
 	}
@@ -4076,18 +4163,19 @@ static void ds_print_ptr(RzDisasmState *ds, int len, int idx) {
 			}
 		}
 	}
-	RzListIter *iter;
 	RzAnalysisXRef *xref;
-	RzList *list = rz_analysis_xrefs_get_from(core->analysis, ds->at);
-	rz_list_foreach (list, iter, xref) {
-		if (xref->type == RZ_ANALYSIS_XREF_TYPE_STRING || xref->type == RZ_ANALYSIS_XREF_TYPE_DATA) {
-			if ((f = rz_flag_get_i(core->flags, xref->to))) {
-				refaddr = xref->to;
-				break;
+	RzVector *xrefs = rz_analysis_xrefs_get_from_vec(core->analysis, ds->at);
+	if (xrefs) {
+		rz_vector_foreach(xrefs, xref) {
+			if (xref->type == RZ_ANALYSIS_XREF_TYPE_STRING || xref->type == RZ_ANALYSIS_XREF_TYPE_DATA) {
+				if ((f = rz_flag_get_i(core->flags, xref->to))) {
+					refaddr = xref->to;
+					break;
+				}
 			}
 		}
+		rz_vector_free(xrefs);
 	}
-	rz_list_free(list);
 	if (ds->analysis_op.type == (RZ_ANALYSIS_OP_TYPE_MOV | RZ_ANALYSIS_OP_TYPE_REG) && ds->analysis_op.stackop == RZ_ANALYSIS_STACK_SET && ds->analysis_op.val != UT64_MAX && ds->analysis_op.val > 10) {
 		const char *arch = rz_config_get(core->config, "asm.arch");
 		if (arch && !strcmp(arch, "x86")) {
@@ -5341,6 +5429,174 @@ RZ_API void rz_analysis_disasm_text_free(RzAnalysisDisasmText *t) {
  * \param options Disassemble Options
  * \return Disassemble bytes number
  */
+static void ds_cache_line_free(RzDisasmCacheLine *cl) {
+	if (!cl) {
+		return;
+	}
+	free(cl->line);
+	free(cl->refline2);
+	free(cl->text);
+	free(cl);
+}
+
+static void ds_cache_line_kv_free(HtUPKv *kv) {
+	ds_cache_line_free(kv->value);
+}
+
+RZ_IPI void rz_core_disasm_cache_invalidate(RZ_NULLABLE RzCoreDisasmCache *cache) {
+	if (!cache || !cache->lines->count) {
+		return;
+	}
+	ht_up_free(cache->lines);
+	cache->lines = ht_up_new(NULL, ds_cache_line_kv_free, NULL);
+}
+
+RZ_IPI void rz_core_disasm_cache_free(RZ_NULLABLE RzCoreDisasmCache *cache) {
+	if (!cache) {
+		return;
+	}
+	ht_up_free(cache->lines);
+	free(cache);
+}
+
+typedef struct {
+	ut64 from;
+	ut64 to;
+	RzVector /*<ut64>*/ victims;
+} DsCacheDropCtx;
+
+static bool ds_cache_collect_range(void *user, const ut64 addr, const void *value) {
+	DsCacheDropCtx *ctx = user;
+	const RzDisasmCacheLine *cl = value;
+	// a line also depends on the bytes it covers
+	if (addr <= ctx->to && addr + cl->inc - 1 >= ctx->from) {
+		rz_vector_push(&ctx->victims, (void *)&addr);
+	}
+	return true;
+}
+
+/* forget the lines touching [from, to] only, see rz_analysis_dirty_since() */
+static void ds_cache_drop_range(RzCoreDisasmCache *cache, ut64 from, ut64 to) {
+	if (from > to) {
+		return;
+	}
+	if (!from && to == UT64_MAX) {
+		rz_core_disasm_cache_invalidate(cache);
+		return;
+	}
+	DsCacheDropCtx ctx = { .from = from, .to = to };
+	rz_vector_init(&ctx.victims, sizeof(ut64), NULL, NULL);
+	ht_up_foreach(cache->lines, ds_cache_collect_range, &ctx);
+	ut64 *addr;
+	rz_vector_foreach(&ctx.victims, addr) {
+		ht_up_delete(cache->lines, *addr);
+	}
+	rz_vector_fini(&ctx.victims);
+}
+
+/**
+ * Lines are only reused in visual and panels mode, where the same range is printed
+ * over and over while scrolling, and only when nothing carries state from one line
+ * to the next (emulation, stack pointer tracking, relative symbols, ...).
+ * Any change to the analysis, the flags or the config drops the cached lines.
+ */
+static RzCoreDisasmCache *ds_cache_get(RzDisasmState *ds) {
+	RzCore *core = ds->core;
+	if (!core->vmode || ds->pj || ds->vec || ds->pdf || core->print->cur_enabled ||
+		core->cons->stream_chunk || core->cons->null || core->bin->is_debugger ||
+		ds->show_emu || ds->pre_emu || ds->asm_hint_emu || ds->show_stackptr || ds->show_nodup ||
+		ds->show_dwarf || ds->show_indent || ds->show_symbols || ds->show_reloff || ds->show_trace) {
+		return NULL;
+	}
+	RzCoreDisasmCache *cache = core->disasm_cache;
+	if (!cache) {
+		cache = RZ_NEW0(RzCoreDisasmCache);
+		if (!cache) {
+			return NULL;
+		}
+		cache->lines = ht_up_new(NULL, ds_cache_line_kv_free, NULL);
+		if (!cache->lines) {
+			free(cache);
+			return NULL;
+		}
+		core->disasm_cache = cache;
+	}
+	int cols = rz_cons_get_size(NULL);
+	ut64 analysis_generation = rz_analysis_generation(core->analysis);
+	if (cache->flags_generation != core->flags->generation ||
+		cache->config_generation != core->config->generation ||
+		cache->cols != cols || cache->lines->count > DS_CACHE_MAX_LINES) {
+		rz_core_disasm_cache_invalidate(cache);
+	} else if (cache->analysis_generation != analysis_generation) {
+		ut64 from, to;
+		if (rz_analysis_dirty_since(core->analysis, cache->analysis_generation, &from, &to)) {
+			ds_cache_drop_range(cache, from, to);
+		} else {
+			rz_core_disasm_cache_invalidate(cache);
+		}
+	}
+	cache->analysis_generation = analysis_generation;
+	cache->flags_generation = core->flags->generation;
+	cache->config_generation = core->config->generation;
+	cache->cols = cols;
+	return cache;
+}
+
+static bool ds_cache_key_eq(const char *a, const char *b) {
+	return a == b || (a && b && !strcmp(a, b));
+}
+
+/* print the cached line at ds->at if it still matches, returns the bytes it covers or 0 */
+static int ds_cache_replay(RzDisasmState *ds, RzCoreDisasmCache *cache, const ut8 *buf, int len) {
+	bool found = false;
+	RzDisasmCacheLine *cl = ht_up_find(cache->lines, ds->at, &found);
+	if (!found || cl->inc > len || memcmp(cl->bytes, buf, cl->inc) ||
+		cl->is_dest != (ds->at == ds->dest) ||
+		!ds_cache_key_eq(cl->line, ds->line) || !ds_cache_key_eq(cl->refline2, ds->refline2) ||
+		rz_bp_get_at(ds->core->dbg->bp, ds->at)) {
+		return 0;
+	}
+	rz_cons_memcat(cl->text, cl->text_len);
+	return cl->inc;
+}
+
+/* start recording the output of the line at ds->at */
+static RzDisasmCacheLine *ds_cache_record(RzDisasmState *ds) {
+	if (rz_bp_get_at(ds->core->dbg->bp, ds->at)) {
+		return NULL;
+	}
+	RzDisasmCacheLine *cl = RZ_NEW0(RzDisasmCacheLine);
+	if (!cl) {
+		return NULL;
+	}
+	cl->is_dest = ds->at == ds->dest;
+	cl->line = ds->line ? strdup(ds->line) : NULL;
+	cl->refline2 = ds->refline2 ? strdup(ds->refline2) : NULL;
+	cl->text_len = rz_cons_get_buffer_len();
+	return cl;
+}
+
+/* keep the recorded line unless it had side effects that a replay would miss */
+static void ds_cache_commit(RzDisasmState *ds, RzCoreDisasmCache *cache, RzDisasmCacheLine *cl, int qjmps, const ut8 *buf, int len, int inc) {
+	int begin = cl->text_len;
+	int end = rz_cons_get_buffer_len();
+	if (inc > DS_CACHE_MAX_BYTES || inc > len || end <= begin || ds->core->asmqjmps_count != qjmps) {
+		ds_cache_line_free(cl);
+		return;
+	}
+	cl->text_len = end - begin;
+	cl->text = rz_mem_dup(rz_cons_get_buffer() + begin, cl->text_len);
+	if (!cl->text) {
+		ds_cache_line_free(cl);
+		return;
+	}
+	memcpy(cl->bytes, buf, inc);
+	cl->inc = inc;
+	if (!ht_up_update(cache->lines, ds->at, cl)) {
+		ds_cache_line_free(cl);
+	}
+}
+
 RZ_API int rz_core_print_disasm(RZ_NONNULL RzCore *core, ut64 addr, RZ_NONNULL ut8 *buf, int len, int nlines, RZ_NULLABLE RzCmdStateOutput *state,
 	RZ_NULLABLE RzCoreDisasmOptions *options) {
 	rz_return_val_if_fail(core && buf, 0);
@@ -5388,6 +5644,10 @@ RZ_API int rz_core_print_disasm(RZ_NONNULL RzCore *core, ut64 addr, RZ_NONNULL u
 		rz_cons_push();
 	}
 
+	RzCoreDisasmCache *cache = ds_cache_get(ds);
+	RzDisasmCacheLine *pending = NULL;
+	int qjmps = 0;
+
 	// disable row_offsets to prevent other commands to overwrite computed info
 	p->calc_row_offsets = false;
 
@@ -5450,6 +5710,7 @@ toro:
 		ds->vat = rz_core_pava(core, ds->at);
 		if (rz_cons_is_breaked()) {
 			RZ_FREE(nbuf);
+			ds_cache_line_free(pending);
 			if (!ds->vec && ds->pj) {
 				rz_cons_pop();
 			}
@@ -5473,6 +5734,25 @@ toro:
 				continue;
 			}
 		}
+		if (cache) {
+			ds_cache_line_free(pending);
+			pending = NULL;
+			ds_update_ref_lines(ds);
+			inc = ds_cache_replay(ds, cache, buf + addrbytes * idx, len - addrbytes * idx);
+			if (inc) {
+				if (ds->at >= addr) {
+					rz_print_set_rowoff(core->print, ds->lines, ds->at - addr, calc_row_offsets);
+				}
+				RZ_FREE(ds->line);
+				RZ_FREE(ds->line_col);
+				RZ_FREE(ds->refline);
+				RZ_FREE(ds->refline2);
+				RZ_FREE(ds->prev_line_col);
+				continue;
+			}
+			pending = ds_cache_record(ds);
+			qjmps = core->asmqjmps_count;
+		}
 		rz_core_seek_arch_bits(core, ds->at); // slow but safe
 		ds->has_description = false;
 		ds->hint = rz_core_hint_begin(core, ds->hint, ds->at);
@@ -5481,7 +5761,9 @@ toro:
 		// XXX. this must be done in ds_update_pc()
 		// ds_update_pc (ds, ds->at);
 		rz_asm_set_pc(core->rasm, ds->at);
-		ds_update_ref_lines(ds);
+		if (!cache) {
+			ds_update_ref_lines(ds);
+		}
 		rz_analysis_op_fini(&ds->analysis_op);
 		rz_analysis_op(core->analysis, &ds->analysis_op, ds->at, buf + addrbytes * idx, (int)(len - addrbytes * idx), DS_ANALYSIS_OP_MASK);
 		if (ds_must_strip(ds)) {
@@ -5492,6 +5774,9 @@ toro:
 		}
 		// f = rz_analysis_get_fcn_in (core->analysis, ds->at, RZ_ANALYSIS_FCN_TYPE_NULL);
 		f = ds->fcn = fcnIn(ds, ds->at, RZ_ANALYSIS_FCN_TYPE_NULL);
+		if (f) {
+			rz_core_analysis_function_vars_ensure(core, f);
+		}
 		ds_show_comments_right(ds);
 		// TRY adding here
 		RzType *link_type = rz_analysis_type_link_at(core->analysis, ds->addr + idx);
@@ -5750,7 +6035,13 @@ toro:
 			inc = 1;
 		}
 		inc += ds->asmop.payload + (ds->asmop.payload % ds->core->rasm->dataalign);
+		if (pending) {
+			ds_cache_commit(ds, cache, pending, qjmps, buf + addrbytes * idx, len - addrbytes * idx, inc);
+			pending = NULL;
+		}
 	}
+	ds_cache_line_free(pending);
+	pending = NULL;
 	rz_analysis_op_fini(&ds->analysis_op);
 
 	RZ_FREE(nbuf);
@@ -5798,6 +6089,10 @@ toro:
 	ds_reflines_fini(ds);
 	rz_config_hold_restore(rch);
 	rz_config_hold_free(rch);
+	if (cache) {
+		// asm.bits and friends changed along the way have just been restored
+		cache->config_generation = core->config->generation;
+	}
 	ds_free(ds);
 	RZ_FREE(nbuf);
 	p->calc_row_offsets = calc_row_offsets;
@@ -5863,8 +6158,8 @@ toro:
 		rz_asm_set_pc(core->rasm, ds->at);
 		// XXX copypasta from main disassembler function
 		// rz_analysis_get_fcn_in (core->analysis, ds->at, RZ_ANALYSIS_FCN_TYPE_NULL);
-		ret = rz_asm_disassemble(core->rasm, &ds->asmop,
-			buf + addrbytes * i, len);
+		rz_asm_op_fini(&ds->asmop);
+		ret = ds_asm_disassemble(ds, &ds->asmop, buf + addrbytes * i, len, nb_opcodes > 0 ? nb_opcodes - j : DS_ASM_BATCH);
 		ds->oplen = ret;
 		skip_bytes_flag = handleMidFlags(core, ds, true);
 		if (ds->midbb) {
@@ -6167,12 +6462,11 @@ RZ_API int rz_core_print_disasm_json(RzCore *core, ut64 addr, ut8 *buf, int nb_b
 		/* add xrefs from */
 		{
 			RzAnalysisXRef *xref;
-			RzListIter *iter2;
-			RzList *xrefs = rz_analysis_xrefs_get_from(core->analysis, op->addr);
-			if (xrefs && !rz_list_empty(xrefs)) {
+			RzVector *xrefs = rz_analysis_xrefs_get_from_vec(core->analysis, op->addr);
+			if (xrefs && !rz_vector_empty(xrefs)) {
 				pj_k(pj, "xrefs_from");
 				pj_a(pj);
-				rz_list_foreach (xrefs, iter2, xref) {
+				rz_vector_foreach(xrefs, xref) {
 					pj_o(pj);
 					pj_kn(pj, "addr", xref->to);
 					pj_ks(pj, "type", rz_analysis_xrefs_type_tostring(xref->type));
@@ -6180,17 +6474,16 @@ RZ_API int rz_core_print_disasm_json(RzCore *core, ut64 addr, ut8 *buf, int nb_b
 				}
 				pj_end(pj);
 			}
-			rz_list_free(xrefs);
+			rz_vector_free(xrefs);
 		}
 		/* add xrefs to */
 		{
 			RzAnalysisXRef *xref;
-			RzListIter *iter2;
-			RzList *xrefs = rz_analysis_xrefs_get_to(core->analysis, op->addr);
-			if (xrefs && !rz_list_empty(xrefs)) {
+			RzVector *xrefs = rz_analysis_xrefs_get_to_vec(core->analysis, op->addr);
+			if (xrefs && !rz_vector_empty(xrefs)) {
 				pj_k(pj, "xrefs_to");
 				pj_a(pj);
-				rz_list_foreach (xrefs, iter2, xref) {
+				rz_vector_foreach(xrefs, xref) {
 					pj_o(pj);
 					pj_kn(pj, "addr", xref->from);
 					pj_ks(pj, "type", rz_analysis_xrefs_type_tostring(xref->type));
@@ -6198,7 +6491,7 @@ RZ_API int rz_core_print_disasm_json(RzCore *core, ut64 addr, ut8 *buf, int nb_b
 				}
 				pj_end(pj);
 			}
-			rz_list_free(xrefs);
+			rz_vector_free(xrefs);
 		}
 
 		pj_end(pj);
@@ -6606,16 +6899,8 @@ RZ_API int rz_core_disasm_pde(RzCore *core, int nb_opcodes, RzCmdStateOutput *st
 		}
 	}
 	RzAnalysisEsil *esil = core->analysis->esil;
-	RzPVector ocache = core->io->cache;
 	const int ocached = core->io->cached;
-	if (ocache.v.a) {
-		RzPVector *vec = (RzPVector *)rz_vector_clone((RzVector *)&ocache);
-		vec->v.free = NULL;
-		core->io->cache = *vec;
-		free(vec);
-	} else {
-		rz_io_cache_init(core->io);
-	}
+	rz_io_cache_push(core->io);
 	rz_reg_arena_push(reg);
 	RzConfigHold *chold = rz_config_hold_new(core->config);
 	rz_config_hold_i(chold, "io.cache", "asm.lines", NULL);
@@ -6711,23 +6996,7 @@ RZ_API int rz_core_disasm_pde(RzCore *core, int nb_opcodes, RzCmdStateOutput *st
 	rz_cmd_state_output_array_end(state);
 	free(buf);
 	rz_reg_arena_pop(reg);
-	int len = rz_pvector_len(&ocache);
-	if (rz_pvector_len(&core->io->cache) > len) {
-		// TODO: Implement push/pop for IO.cache
-		while (len > 0) {
-			(void)rz_pvector_pop_front(&core->io->cache);
-			len--;
-		}
-		core->io->cache.v.free = ocache.v.free;
-	}
-	rz_io_cache_fini(core->io);
-	core->io->cache = ocache;
-	rz_skyline_clear(&core->io->cache_skyline);
-	void **it;
-	rz_pvector_foreach (&ocache, it) {
-		RzIOCache *c = (RzIOCache *)*it;
-		rz_skyline_add(&core->io->cache_skyline, c->itv, c);
-	}
+	rz_io_cache_pop(core->io);
 	core->io->cached = ocached;
 	rz_config_hold_restore(chold);
 	rz_config_hold_free(chold);
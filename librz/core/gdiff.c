@@ -116,7 +116,7 @@ RZ_API bool rz_core_gdiff_2_files(RzCore *c, RzCore *c2) {
 		}
 	}
 	/* Diff functions */
-	rz_analysis_diff_fcn(cores[0]->analysis, cores[0]->analysis->fcns, cores[1]->analysis->fcns);
+	rz_analysis_diff_fcn_parallel(cores[0]->analysis, cores[0]->analysis->fcns, cores[1]->analysis->fcns, rz_core_get_task_pool(c));
 
 	return true;
 }
@@ -135,7 +135,7 @@ static bool is_pclntab_valid(GoPcLnTab *pclntab) {
 
 static void add_new_func_symbol(RzCore *core, const char *name, ut64 vaddr) {
 	RzBinFile *bf = rz_bin_cur(core->bin);
-	if (!bf || !bf->o || !bf->o->symbols) {
+	if (!bf || !bf->o || !rz_bin_object_get_symbols(bf->o)) {
 		return;
 	}
 	ut64 paddr = rz_io_v2p(core->io, vaddr);
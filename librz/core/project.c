@@ -40,6 +40,16 @@ RZ_API RzProjectErr rz_project_save(RzCore *core, RzProject *prj, const char *fi
 }
 
 RZ_API RzProjectErr rz_project_save_file(RzCore *core, const char *file, bool compress) {
+	return rz_project_save_file_as(core, file, RZ_PROJECT_FORMAT_TEXT, compress);
+}
+
+/**
+ * \brief Save the project of \p core to \p file in the given \p format
+ *
+ * Both formats hold the same data and are read back by rz_project_load_file(),
+ * the binary one is just faster to write and to load for big projects.
+ */
+RZ_API RzProjectErr rz_project_save_file_as(RzCore *core, const char *file, RzProjectFormat format, bool compress) {
 	char *tmp_file = NULL;
 
 	if (compress) {
@@ -62,7 +72,8 @@ RZ_API RzProjectErr rz_project_save_file(RzCore *core, const char *file, bool co
 		sdb_free(prj);
 		return err;
 	}
-	if (!sdb_text_save(prj, save_file, true)) {
+	bool saved = format == RZ_PROJECT_FORMAT_BINARY ? sdb_bin_save(prj, save_file, true) : sdb_text_save(prj, save_file, true);
+	if (!saved) {
 		err = RZ_PROJECT_ERR_FILE;
 	}
 	sdb_free(prj);
@@ -115,7 +126,8 @@ RZ_API RzProject *rz_project_load_file_raw(const char *file) {
 		load_file = file;
 	}
 
-	if (!sdb_text_load(prj, load_file)) {
+	bool loaded = sdb_bin_check(load_file) ? sdb_bin_load(prj, load_file) : sdb_text_load(prj, load_file);
+	if (!loaded) {
 		sdb_free(prj);
 		prj = NULL;
 	}
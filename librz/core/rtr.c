@@ -58,23 +58,26 @@ RZ_API void rz_core_wait(RzCore *core) {
 	}
 }
 
+static void http_vlogf(bool http_log_enabled, const char *http_log_file, const char *fmt, va_list ap) {
+	if (!http_log_enabled) {
+		return;
+	}
+	if (http_log_file && *http_log_file) {
+		char *msg = calloc(4096, 1);
+		if (msg) {
+			vsnprintf(msg, 4095, fmt, ap);
+			rz_file_dump(http_log_file, (const ut8 *)msg, -1, true);
+			free(msg);
+		}
+	} else {
+		vfprintf(stderr, fmt, ap);
+	}
+}
+
 static void http_logf(RzCore *core, const char *fmt, ...) {
-	bool http_log_enabled = rz_config_get_i(core->config, "http.log");
 	va_list ap;
 	va_start(ap, fmt);
-	if (http_log_enabled) {
-		const char *http_log_file = rz_config_get(core->config, "http.logfile");
-		if (http_log_file && *http_log_file) {
-			char *msg = calloc(4096, 1);
-			if (msg) {
-				vsnprintf(msg, 4095, fmt, ap);
-				rz_file_dump(http_log_file, (const ut8 *)msg, -1, true);
-				free(msg);
-			}
-		} else {
-			vfprintf(stderr, fmt, ap);
-		}
-	}
+	http_vlogf(rz_config_get_i(core->config, "http.log"), rz_config_get(core->config, "http.logfile"), fmt, ap);
 	va_end(ap);
 }
 
@@ -488,6 +488,874 @@ the_end : {
 	return ret;
 }
 
+#if HAVE_LIBUV
+
+/*
+ * Event loop flavour of the http server, used when http.async is set.
+ *
+ * The loop thread only parses requests and writes responses, it never
+ * touches the core: the settings are read once at startup and every
+ * /cmd/ request runs in a core task, so other clients keep being served
+ * while a command runs and the task scheduler keeps commands from
+ * stepping on each other. Connections are kept alive, pipelined requests
+ * are answered in order and command output is sent chunked.
+ */
+
+#define HTTP_ASYNC_BACKLOG    128
+#define HTTP_ASYNC_READ       0x1000
+#define HTTP_ASYNC_HEADER_MAX 0x10000
+#define HTTP_ASYNC_BODY_MAX   (64 << 20)
+#define HTTP_ASYNC_CHUNK      0x4000
+
+typedef struct http_async_t {
+	RzCore *core;
+	RzConfig *cfg; ///< clone with the http overrides, used by the command tasks
+	uv_loop_t loop;
+	uv_tcp_t server;
+	uv_async_t stop;
+	uv_async_t done; ///< woken by the tasks when a command finished
+	RzThreadLock *lock;
+	RzList /*<HttpAsyncJob *>*/ *finished; ///< guarded by lock
+	RzList /*<HttpAsyncJob *>*/ *running;
+	RzList /*<HttpAsyncClient *>*/ *clients;
+	bool stopping;
+	bool quit; ///< Rh-- or Rh* was requested, stop once it is answered
+	int ret;
+	// settings snapshot
+	char *allow_str;
+	RzList *allow;
+	char *auth_str;
+	RzList *authtokens;
+	char *index;
+	char *root;
+	char *homeroot;
+	char *uproot;
+	char *referer;
+	const char *cors;
+	bool auth;
+	bool colon;
+	bool dirlist;
+	bool upget;
+	bool upload;
+	bool verbose;
+	bool log; ///< http.log, read once as the commands run with core->config swapped
+	char *logfile; ///< http.logfile
+	ut64 maxsize;
+} HttpAsync;
+
+typedef struct http_async_client_t {
+	HttpAsync *srv;
+	uv_tcp_t handle;
+	ut8 *in;
+	size_t in_len;
+	size_t in_size;
+	char peer[64];
+	bool busy; ///< a response is being produced or written
+	bool keep_alive;
+	bool chunked;
+	bool closing;
+	int refs; ///< the handle plus a running command
+} HttpAsyncClient;
+
+typedef struct http_async_job_t {
+	HttpAsync *srv;
+	HttpAsyncClient *client;
+	int task_id;
+	char *cmd;
+	char *out;
+	bool silent;
+} HttpAsyncJob;
+
+typedef struct http_async_request_t {
+	char *method;
+	char *path;
+	char *referer;
+	ut8 *data;
+	size_t data_len;
+	bool keep_alive;
+	bool http11;
+	bool auth;
+} HttpAsyncRequest;
+
+typedef struct http_async_write_t {
+	uv_write_t req;
+	HttpAsyncClient *client;
+	char *data;
+} HttpAsyncWrite;
+
+static void http_async_process(HttpAsyncClient *c);
+static void http_async_shutdown(HttpAsync *srv);
+
+/* http_logf() with the config of the server, safe while a command is running */
+static void http_async_logf(HttpAsync *srv, const char *fmt, ...) {
+	va_list ap;
+	va_start(ap, fmt);
+	http_vlogf(srv->log, srv->logfile, fmt, ap);
+	va_end(ap);
+}
+
+static const char *http_async_status(int code) {
+	switch (code) {
+	case 200: return "OK";
+	case 302: return "Found";
+	case 400: return "Bad Request";
+	case 401: return "Unauthorized";
+	case 403: return "Forbidden";
+	case 404: return "Not Found";
+	case 413: return "Payload Too Large";
+	case 500: return "Internal Server Error";
+	case 503: return "Service Unavailable";
+	default: return "Unknown";
+	}
+}
+
+static void http_async_client_unref(HttpAsyncClient *c) {
+	if (--c->refs > 0) {
+		return;
+	}
+	free(c->in);
+	free(c);
+}
+
+static void http_async_client_closed(uv_handle_t *handle) {
+	http_async_client_unref(handle->data);
+}
+
+static void http_async_client_close(HttpAsyncClient *c) {
+	if (c->closing) {
+		return;
+	}
+	c->closing = true;
+	rz_list_delete_data(c->srv->clients, c);
+	uv_close((uv_handle_t *)&c->handle, http_async_client_closed);
+}
+
+static void http_async_written(uv_write_t *req, int status) {
+	HttpAsyncWrite *w = (HttpAsyncWrite *)req;
+	HttpAsyncClient *c = w->client;
+	HttpAsync *srv = c->srv;
+	free(w->data);
+	free(w);
+	if (c->closing) {
+		return;
+	}
+	c->busy = false;
+	if (status < 0 || !c->keep_alive || srv->stopping || srv->quit) {
+		http_async_client_close(c);
+		if (srv->quit) {
+			http_async_shutdown(srv);
+		}
+		return;
+	}
+	http_async_process(c);
+}
+
+static void http_async_write(HttpAsyncClient *c, RzStrBuf *sb) {
+	size_t len = rz_strbuf_length(sb);
+	char *data = rz_strbuf_drain_nofree(sb);
+	HttpAsyncWrite *w = RZ_NEW0(HttpAsyncWrite);
+	if (!data || !w) {
+		goto fail;
+	}
+	w->client = c;
+	w->data = data;
+	uv_buf_t buf = uv_buf_init(data, (unsigned int)len);
+	if (uv_write(&w->req, (uv_stream_t *)&c->handle, &buf, 1, http_async_written) < 0) {
+		goto fail;
+	}
+	return;
+fail:
+	free(data);
+	free(w);
+	http_async_client_close(c);
+}
+
+/**
+ * Queue the whole response to \p c, \p headers are extra "\r\n" terminated lines.
+ * Bodies of HTTP/1.1 clients are sent with the chunked transfer coding.
+ */
+static void http_async_respond(HttpAsyncClient *c, int code, const char *headers, const char *body, size_t len) {
+	HttpAsync *srv = c->srv;
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	rz_strbuf_appendf(&sb, "HTTP/1.1 %d %s\r\n%s%s", code, http_async_status(code),
+		srv->cors ? srv->cors : "", headers ? headers : "");
+	if (code == 401) {
+		rz_strbuf_append(&sb, "WWW-Authenticate: Basic realm=\"R2 Web UI Access\"\r\n");
+	}
+	rz_strbuf_appendf(&sb, "Connection: %s\r\n", c->keep_alive ? "keep-alive" : "close");
+	if (!body) {
+		body = "";
+		len = 0;
+	}
+	if (c->chunked) {
+		rz_strbuf_append(&sb, "Transfer-Encoding: chunked\r\n\r\n");
+		size_t off;
+		for (off = 0; off < len; off += HTTP_ASYNC_CHUNK) {
+			size_t n = RZ_MIN(len - off, HTTP_ASYNC_CHUNK);
+			rz_strbuf_appendf(&sb, "%zx\r\n", n);
+			rz_strbuf_append_n(&sb, body + off, n);
+			rz_strbuf_append(&sb, "\r\n");
+		}
+		rz_strbuf_append(&sb, "0\r\n\r\n");
+	} else {
+		rz_strbuf_appendf(&sb, "Content-Length: %zu\r\n\r\n", len);
+		rz_strbuf_append_n(&sb, body, len);
+	}
+	http_async_write(c, &sb);
+}
+
+static void http_async_respond_str(HttpAsyncClient *c, int code, const char *body) {
+	http_async_respond(c, code, NULL, body, body ? strlen(body) : 0);
+}
+
+/* runs in a core task, everything but the job is off limits */
+static void *http_async_task(RzCore *core, void *user) {
+	HttpAsyncJob *job = user;
+	HttpAsync *srv = job->srv;
+	RzConfig *cfg = core->config;
+	core->config = srv->cfg;
+	rz_config_set_i(core->config, "scr.color", COLOR_MODE_DISABLED);
+	if (job->silent) {
+		rz_core_cmd0(core, job->cmd);
+	} else {
+		job->out = rz_core_cmd_str_pipe(core, job->cmd);
+	}
+	core->config = cfg;
+	rz_th_lock_enter(srv->lock);
+	rz_list_append(srv->finished, job);
+	rz_th_lock_leave(srv->lock);
+	uv_async_send(&srv->done);
+	return NULL;
+}
+
+static void http_async_job_free(HttpAsyncJob *job) {
+	if (!job) {
+		return;
+	}
+	free(job->cmd);
+	free(job->out);
+	free(job);
+}
+
+static void http_async_done(uv_async_t *handle) {
+	HttpAsync *srv = handle->data;
+	rz_th_lock_enter(srv->lock);
+	RzList *finished = srv->finished;
+	srv->finished = rz_list_newf((RzListFree)http_async_job_free);
+	rz_th_lock_leave(srv->lock);
+	RzListIter *iter;
+	HttpAsyncJob *job;
+	rz_list_foreach (finished, iter, job) {
+		HttpAsyncClient *c = job->client;
+		rz_list_delete_data(srv->running, job);
+		if (!c->closing) {
+			c->keep_alive &= !srv->stopping;
+			const char *out = job->out ? job->out : "";
+			http_async_respond(c, 200, job->out ? "Content-Type: text/plain\r\n" : NULL, out, strlen(out));
+		}
+		http_async_client_unref(c);
+	}
+	rz_list_free(finished);
+	if (srv->stopping && rz_list_empty(srv->running)) {
+		uv_close((uv_handle_t *)&srv->done, NULL);
+	}
+}
+
+static void http_async_cmd(HttpAsyncClient *c, HttpAsyncRequest *rq) {
+	HttpAsync *srv = c->srv;
+	if (srv->colon && rq->path[5] != ':') {
+		http_async_respond_str(c, 403, "Permission denied");
+		return;
+	}
+	if (srv->referer && (!rq->referer || !strstr(rq->referer, srv->referer))) {
+		http_async_respond_str(c, 503, NULL);
+		return;
+	}
+	char *cmd = strdup(rq->path + 5);
+	if (!cmd) {
+		http_async_respond_str(c, 500, NULL);
+		return;
+	}
+	rz_str_uri_decode(cmd);
+	if (!strcmp(cmd, "Rh*") || !strcmp(cmd, "Rh--")) {
+		srv->ret = !strcmp(cmd, "Rh*") ? -2 : 0;
+		srv->quit = true;
+		c->keep_alive = false;
+		http_async_respond_str(c, 200, NULL);
+		free(cmd);
+		return;
+	}
+	HttpAsyncJob *job = RZ_NEW0(HttpAsyncJob);
+	if (!job) {
+		free(cmd);
+		http_async_respond_str(c, 500, NULL);
+		return;
+	}
+	job->srv = srv;
+	job->client = c;
+	/* commands in /cmd/: starting with : do not show any output */
+	job->silent = *cmd == ':';
+	job->cmd = job->silent ? strdup(cmd + 1) : cmd;
+	if (job->silent) {
+		free(cmd);
+	}
+	RzCoreTask *task = job->cmd ? rz_core_function_task_new(srv->core, http_async_task, job) : NULL;
+	if (!task) {
+		http_async_job_free(job);
+		http_async_respond_str(c, 500, NULL);
+		return;
+	}
+	task->transient = true;
+	job->task_id = task->id;
+	c->refs++;
+	rz_list_append(srv->running, job);
+	rz_core_task_enqueue(&srv->core->tasks, task);
+}
+
+static void http_async_file(HttpAsyncClient *c, const char *path, const char *dir) {
+	if (!rz_file_exists(path)) {
+		if (dir) {
+			http_async_logf(c->srv, "Dirlisting %s\n", dir);
+			char *resp = rtr_dir_files(dir);
+			http_async_respond_str(c, 404, resp);
+			free(resp);
+		} else {
+			http_async_logf(c->srv, "File '%s' not found\n", path);
+			http_async_respond_str(c, 404, "File not found\n");
+		}
+		return;
+	}
+	size_t sz = 0;
+	char *f = rz_file_slurp(path, &sz);
+	if (!f) {
+		http_async_logf(c->srv, "http: Cannot open '%s'\n", path);
+		http_async_respond_str(c, 403, "Permission denied");
+		return;
+	}
+	const char *ct = NULL;
+	if (strstr(path, ".js")) {
+		ct = "Content-Type: application/javascript\r\n";
+	}
+	if (strstr(path, ".css")) {
+		ct = "Content-Type: text/css\r\n";
+	}
+	if (strstr(path, ".html")) {
+		ct = "Content-Type: text/html\r\n";
+	}
+	http_async_respond(c, 200, ct, f, sz);
+	free(f);
+}
+
+static void http_async_get(HttpAsyncClient *c, HttpAsyncRequest *rq) {
+	HttpAsync *srv = c->srv;
+	const char *dir = srv->dirlist && rz_file_is_directory(rq->path) ? rq->path : NULL;
+	if (rz_str_startswith(rq->path, "/cmd/")) {
+		http_async_cmd(c, rq);
+		return;
+	}
+	if (rz_str_startswith(rq->path, "/up/")) {
+		if (!srv->upget) {
+			http_async_respond_str(c, 403, NULL);
+		} else if (!rq->path[4]) {
+			char *ptr = rtr_dir_files(srv->uproot);
+			http_async_respond_str(c, 200, ptr);
+			free(ptr);
+		} else {
+			char *path = rz_file_root(srv->uproot, rq->path + 4);
+			http_async_file(c, path, dir);
+			free(path);
+		}
+		return;
+	}
+	char *path = NULL;
+	if (!strcmp(rq->path, "/")) {
+		if (*srv->index == '/') {
+			path = strdup(srv->index);
+		} else {
+			char *upath = rz_str_newf("/%s", srv->index);
+			path = rz_file_root(srv->root, upath);
+			free(upath);
+		}
+	} else if (*srv->homeroot) {
+		char *homepath = rz_file_abspath(srv->homeroot);
+		path = rz_file_root(homepath, rq->path);
+		free(homepath);
+		if (!rz_file_exists(path) && !rz_file_is_directory(path)) {
+			free(path);
+			path = rz_file_root(srv->root, rq->path);
+		}
+	} else {
+		path = rz_file_root(srv->root, rq->path);
+	}
+	if (rq->path[strlen(rq->path) - 1] == '/') {
+		if (*srv->index == '/') {
+			free(path);
+			path = strdup(srv->index);
+		} else if (strcmp(rq->path, "/")) {
+			path = rz_str_append(path, srv->index);
+		}
+	} else if (rz_file_is_directory(path)) {
+		char *loc = rz_str_newf("Location: %s/\r\n", rq->path);
+		http_async_respond(c, 302, loc, NULL, 0);
+		free(loc);
+		free(path);
+		return;
+	}
+	if (!path) {
+		http_async_respond_str(c, 500, NULL);
+		return;
+	}
+	http_async_file(c, path, dir);
+	free(path);
+}
+
+static void http_async_post(HttpAsyncClient *c, HttpAsyncRequest *rq) {
+	HttpAsync *srv = c->srv;
+	if (!srv->upload || !rz_str_startswith(rq->path, "/up/")) {
+		http_async_respond_str(c, 403, "403 Forbidden\n");
+		return;
+	}
+	int retlen = 0;
+	ut8 *ret = rz_socket_http_handle_upload(rq->data, (int)rq->data_len, &retlen);
+	if (!ret) {
+		http_async_respond_str(c, 400, NULL);
+		return;
+	}
+	if (srv->maxsize && retlen > srv->maxsize) {
+		http_async_respond_str(c, 403, "403 File too big\n");
+	} else {
+		char *filename = rz_file_root(srv->uproot, rq->path + 4);
+		http_async_logf(srv, "UPLOADED '%s'\n", filename);
+		rz_file_dump(filename, ret, retlen, 0);
+		free(filename);
+		char *msg = rz_str_newf("<html><body><h2>uploaded %d byte(s). Thanks</h2>\n", retlen);
+		http_async_respond_str(c, 200, msg);
+		free(msg);
+	}
+	free(ret);
+}
+
+static void http_async_handle(HttpAsyncClient *c, HttpAsyncRequest *rq) {
+	if (c->srv->verbose) {
+		http_async_logf(c->srv, "[HTTP] %s %s %s\n", c->peer, rq->method, rq->path);
+	}
+	if (!rq->auth) {
+		http_async_respond_str(c, 401, NULL);
+	} else if (!strcmp(rq->method, "OPTIONS")) {
+		http_async_respond_str(c, 200, NULL);
+	} else if (!strcmp(rq->method, "GET")) {
+		http_async_get(c, rq);
+	} else if (!strcmp(rq->method, "POST")) {
+		http_async_post(c, rq);
+	} else {
+		http_async_respond_str(c, 404, "Invalid protocol");
+	}
+}
+
+static void http_async_request_fini(HttpAsyncRequest *rq) {
+	free(rq->method);
+	free(rq->path);
+	free(rq->referer);
+	free(rq->data);
+}
+
+static bool http_async_authorized(HttpAsync *srv, const char *token) {
+	size_t len = strlen(token);
+	char *dec = calloc(4, len + 1);
+	if (!dec) {
+		return false;
+	}
+	bool ok = false;
+	if (rz_base64_decode((ut8 *)dec, token, (int)len) != -1) {
+		RzListIter *iter;
+		const char *t;
+		rz_list_foreach (srv->authtokens, iter, t) {
+			if (!strcmp(dec, t)) {
+				ok = true;
+				break;
+			}
+		}
+	}
+	free(dec);
+	return ok;
+}
+
+/**
+ * Take the next complete request out of the input buffer of \p c.
+ * \return 1 when \p rq was filled, 0 if more input is needed, -1 on a malformed request
+ */
+static int http_async_parse(HttpAsyncClient *c, HttpAsyncRequest *rq) {
+	HttpAsync *srv = c->srv;
+	const ut8 *end = rz_mem_mem(c->in, (int)RZ_MIN(c->in_len, HTTP_ASYNC_HEADER_MAX), (const ut8 *)"\r\n\r\n", 4);
+	if (!end) {
+		return c->in_len > HTTP_ASYNC_HEADER_MAX ? -1 : 0;
+	}
+	size_t hdr_len = end - c->in + 4;
+	char *hdr = rz_str_ndup((const char *)c->in, (int)hdr_len - 4);
+	if (!hdr) {
+		return -1;
+	}
+	memset(rq, 0, sizeof(*rq));
+	rq->auth = !srv->auth;
+	size_t content_length = 0;
+	bool connection_close = false, connection_keep = false;
+	char *line = hdr, *next;
+	for (; line; line = next) {
+		next = strstr(line, "\r\n");
+		if (next) {
+			*next = 0;
+			next += 2;
+		}
+		if (!rq->method) {
+			char *sp = strchr(line, ' ');
+			char *sp2 = sp ? strchr(sp + 1, ' ') : NULL;
+			if (!sp || !sp2 || sp[1] != '/') {
+				goto fail;
+			}
+			rq->method = rz_str_ndup(line, (int)(sp - line));
+			rq->path = rz_str_ndup(sp + 1, (int)(sp2 - sp - 1));
+			rq->http11 = !strcmp(sp2 + 1, "HTTP/1.1");
+			continue;
+		}
+		char *colon = strchr(line, ':');
+		if (!colon) {
+			continue;
+		}
+		*colon = 0;
+		const char *value = rz_str_trim_head_ro(colon + 1);
+		if (!rz_str_casecmp(line, "Content-Length")) {
+			content_length = strtoull(value, NULL, 10);
+			if (content_length > HTTP_ASYNC_BODY_MAX) {
+				goto fail;
+			}
+		} else if (!rz_str_casecmp(line, "Connection")) {
+			connection_close = !rz_str_casecmp(value, "close");
+			connection_keep = !rz_str_casecmp(value, "keep-alive");
+		} else if (!rz_str_casecmp(line, "Referer")) {
+			free(rq->referer);
+			rq->referer = strdup(value);
+		} else if (srv->auth && !rz_str_casecmp(line, "Authorization") && rz_str_startswith(value, "Basic ")) {
+			rq->auth = http_async_authorized(srv, value + 6);
+		}
+	}
+	if (!rq->method || !rq->path) {
+		goto fail;
+	}
+	if (c->in_len - hdr_len < content_length) {
+		http_async_request_fini(rq);
+		free(hdr);
+		return 0;
+	}
+	rq->data = malloc(content_length + 1);
+	if (!rq->data) {
+		goto fail;
+	}
+	memcpy(rq->data, c->in + hdr_len, content_length);
+	rq->data[content_length] = 0;
+	rq->data_len = content_length;
+	rq->keep_alive = rq->http11 ? !connection_close : connection_keep;
+	free(hdr);
+	size_t used = hdr_len + content_length;
+	memmove(c->in, c->in + used, c->in_len - used);
+	c->in_len -= used;
+	return 1;
+fail:
+	http_async_request_fini(rq);
+	free(hdr);
+	return -1;
+}
+
+static void http_async_process(HttpAsyncClient *c) {
+	if (c->busy || c->closing) {
+		return;
+	}
+	HttpAsyncRequest rq;
+	int r = http_async_parse(c, &rq);
+	if (!r) {
+		return;
+	}
+	c->busy = true;
+	if (r < 0) {
+		http_async_logf(c->srv, "Invalid http headers received from client\n");
+		c->keep_alive = false;
+		c->chunked = false;
+		http_async_respond_str(c, 400, "Bad request\n");
+		return;
+	}
+	c->keep_alive = rq.keep_alive && !c->srv->stopping;
+	c->chunked = rq.http11;
+	http_async_handle(c, &rq);
+	http_async_request_fini(&rq);
+}
+
+static void http_async_alloc(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf) {
+	HttpAsyncClient *c = handle->data;
+	if (c->in_size - c->in_len < HTTP_ASYNC_READ) {
+		size_t size = RZ_MAX(c->in_size * 2, HTTP_ASYNC_READ * 4);
+		ut8 *in = realloc(c->in, size);
+		if (!in) {
+			*buf = uv_buf_init(NULL, 0);
+			return;
+		}
+		c->in = in;
+		c->in_size = size;
+	}
+	*buf = uv_buf_init((char *)c->in + c->in_len, (unsigned int)(c->in_size - c->in_len));
+}
+
+static void http_async_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
+	HttpAsyncClient *c = stream->data;
+	if (nread < 0) {
+		http_async_client_close(c);
+		return;
+	}
+	c->in_len += nread;
+	if (c->in_len > HTTP_ASYNC_HEADER_MAX + HTTP_ASYNC_BODY_MAX) {
+		// pipelining that far ahead is abuse
+		http_async_client_close(c);
+		return;
+	}
+	http_async_process(c);
+}
+
+static bool http_async_allowed(HttpAsyncClient *c) {
+	struct sockaddr_storage sa;
+	int len = sizeof(sa);
+	if (uv_tcp_getpeername(&c->handle, (struct sockaddr *)&sa, &len)) {
+		return false;
+	}
+	if (sa.ss_family == AF_INET6) {
+		uv_ip6_name((struct sockaddr_in6 *)&sa, c->peer, sizeof(c->peer));
+	} else {
+		uv_ip4_name((struct sockaddr_in *)&sa, c->peer, sizeof(c->peer));
+	}
+	if (!c->srv->allow) {
+		return true;
+	}
+	RzListIter *iter;
+	const char *host;
+	rz_list_foreach (c->srv->allow, iter, host) {
+		if (!strcmp(host, c->peer)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void http_async_accept(uv_stream_t *server, int status) {
+	HttpAsync *srv = server->data;
+	if (status < 0) {
+		http_async_logf(srv, "New connection error: %s\n", uv_strerror(status));
+		return;
+	}
+	HttpAsyncClient *c = RZ_NEW0(HttpAsyncClient);
+	if (!c) {
+		return;
+	}
+	c->srv = srv;
+	c->refs = 1;
+	c->handle.data = c;
+	uv_tcp_init(server->loop, &c->handle);
+	if (uv_accept(server, (uv_stream_t *)&c->handle) || !http_async_allowed(c)) {
+		c->closing = true;
+		uv_close((uv_handle_t *)&c->handle, http_async_client_closed);
+		return;
+	}
+	rz_list_append(srv->clients, c);
+	uv_read_start((uv_stream_t *)&c->handle, http_async_alloc, http_async_read);
+}
+
+static void http_async_shutdown(HttpAsync *srv) {
+	if (srv->stopping) {
+		return;
+	}
+	srv->stopping = true;
+	uv_close((uv_handle_t *)&srv->server, NULL);
+	uv_close((uv_handle_t *)&srv->stop, NULL);
+	RzListIter *iter, *tmp;
+	HttpAsyncClient *c;
+	rz_list_foreach_safe (srv->clients, iter, tmp, c) {
+		// busy ones are closed once their response is out
+		if (!c->busy) {
+			http_async_client_close(c);
+		}
+	}
+	HttpAsyncJob *job;
+	rz_list_foreach (srv->running, iter, job) {
+		rz_core_task_break(&srv->core->tasks, job->task_id);
+	}
+	if (rz_list_empty(srv->running)) {
+		uv_close((uv_handle_t *)&srv->done, NULL);
+	}
+}
+
+static void http_async_stop(uv_async_t *handle) {
+	http_async_shutdown(handle->data);
+}
+
+static void http_async_break(uv_async_t *async) {
+	uv_async_send(async);
+}
+
+static void http_async_fini(HttpAsync *srv) {
+	rz_list_free(srv->clients);
+	rz_list_free(srv->running);
+	rz_list_free(srv->finished);
+	rz_th_lock_free(srv->lock);
+	rz_config_free(srv->cfg);
+	rz_list_free(srv->allow);
+	free(srv->allow_str);
+	rz_list_free(srv->authtokens);
+	free(srv->auth_str);
+	free(srv->index);
+	free(srv->root);
+	free(srv->homeroot);
+	free(srv->uproot);
+	free(srv->referer);
+	free(srv->logfile);
+}
+
+static bool http_async_init(HttpAsync *srv, RzCore *core, int port) {
+	RzConfig *cfg = core->config;
+	memset(srv, 0, sizeof(*srv));
+	srv->core = core;
+	srv->lock = rz_th_lock_new(false);
+	srv->finished = rz_list_newf((RzListFree)http_async_job_free);
+	srv->running = rz_list_new();
+	srv->clients = rz_list_new();
+	srv->cfg = rz_config_clone(cfg);
+	if (!srv->lock || !srv->finished || !srv->running || !srv->clients || !srv->cfg) {
+		return false;
+	}
+	rz_config_set(srv->cfg, "asm.cmt.right", "false");
+	rz_config_set(srv->cfg, "asm.bytes", "false");
+	rz_config_set(srv->cfg, "scr.interactive", "false");
+	rz_config_set_i(srv->cfg, "scr.color", COLOR_MODE_DISABLED);
+	const char *allow = rz_config_get(cfg, "http.allow");
+	if (RZ_STR_ISNOTEMPTY(allow)) {
+		srv->allow_str = strdup(allow);
+		srv->allow = srv->allow_str ? rz_str_split_list(srv->allow_str, ",", 0) : NULL;
+	}
+	srv->auth = rz_config_get_b(cfg, "http.auth");
+	if (srv->auth) {
+		const char *authfile = rz_config_get(cfg, "http.authfile");
+		srv->auth_str = RZ_STR_ISNOTEMPTY(authfile) ? rz_file_slurp(authfile, NULL) : NULL;
+		if (!srv->auth_str) {
+			eprintf("Empty list of HTTP users\n");
+			return false;
+		}
+		srv->authtokens = rz_str_split_list(srv->auth_str, "\n", 0);
+	}
+	const char *referer = rz_config_get(cfg, "http.referer");
+	if (RZ_STR_ISNOTEMPTY(referer)) {
+		srv->referer = strstr(referer, "http") ? strdup(referer) : rz_str_newf("http://localhost:%d/", port);
+	}
+	srv->index = strdup(rz_config_get(cfg, "http.index"));
+	srv->root = strdup(rz_config_get(cfg, "http.root"));
+	srv->homeroot = strdup(rz_config_get(cfg, "http.homeroot"));
+	srv->uproot = strdup(rz_config_get(cfg, "http.uproot"));
+	if (rz_config_get_b(cfg, "http.cors")) {
+		srv->cors = "Access-Control-Allow-Origin: *\r\n"
+			    "Access-Control-Allow-Headers: Origin, X-Requested-With, Content-Type, Accept\r\n";
+	}
+	srv->colon = rz_config_get_b(cfg, "http.colon");
+	srv->dirlist = rz_config_get_b(cfg, "http.dirlist");
+	srv->upget = rz_config_get_b(cfg, "http.upget");
+	srv->upload = rz_config_get_b(cfg, "http.upload");
+	srv->verbose = rz_config_get_b(cfg, "http.verbose");
+	srv->log = rz_config_get_b(cfg, "http.log");
+	srv->logfile = strdup(rz_config_get(cfg, "http.logfile"));
+	srv->maxsize = rz_config_get_i(cfg, "http.maxsize");
+	return srv->index && srv->root && srv->homeroot && srv->uproot && srv->logfile;
+}
+
+// return 1 on error, -2 to restart
+static int rz_core_rtr_http_async_run(RzCore *core, int browse, const char *path) {
+	const char *host = rz_config_get(core->config, "http.bind");
+	const char *port = rz_config_get(core->config, "http.port");
+	char buf[32];
+	if (!path) {
+		return false;
+	}
+	if (rz_config_get(core->config, "http.uri")[0]) {
+		eprintf("http.uri proxying is not supported by http.async\n");
+		return 1;
+	}
+	char *arg = strchr(path, ' ');
+	if (arg) {
+		path = arg + 1;
+	}
+	if (atoi(path)) {
+		port = path;
+		rz_config_set(core->config, "http.port", port);
+		path = NULL;
+	}
+	if (!strcmp(port, "0")) {
+		rz_num_irand();
+		snprintf(buf, sizeof(buf), "%d", 1024 + rz_num_rand(45256));
+		port = buf;
+	}
+	const char *bind = "127.0.0.1";
+	if (host && (host[0] == '0' || !strcmp(host, "public"))) {
+		host = "127.0.0.1";
+		bind = "0.0.0.0";
+		rz_config_set(core->config, "http.bind", "0.0.0.0");
+	} else if (!host || !*host || !strcmp(host, "local")) {
+		host = "localhost";
+	}
+	int iport = atoi(port);
+
+	HttpAsync srv;
+	if (!http_async_init(&srv, core, iport)) {
+		http_async_fini(&srv);
+		return 1;
+	}
+	int ret = 1;
+	uv_loop_init(&srv.loop);
+	srv.server.data = &srv;
+	srv.stop.data = &srv;
+	srv.done.data = &srv;
+	uv_tcp_init(&srv.loop, &srv.server);
+	struct sockaddr_in addr;
+	uv_ip4_addr(bind, iport, &addr);
+	int r = uv_tcp_bind(&srv.server, (const struct sockaddr *)&addr, 0);
+	if (!r) {
+		r = uv_listen((uv_stream_t *)&srv.server, HTTP_ASYNC_BACKLOG, http_async_accept);
+	}
+	if (r) {
+		eprintf("Cannot listen on http.port: %s\n", uv_strerror(r));
+		uv_close((uv_handle_t *)&srv.server, NULL);
+		uv_run(&srv.loop, UV_RUN_DEFAULT);
+		goto beach;
+	}
+	uv_async_init(&srv.loop, &srv.stop, http_async_stop);
+	uv_async_init(&srv.loop, &srv.done, http_async_done);
+
+	if (browse == 'H') {
+		const char *browser = rz_config_get(core->config, "http.browser");
+		rz_sys_cmdf("%s http://%s:%d/%s &", browser, host, iport, path ? path : "");
+	}
+	eprintf("Starting async http server...\n");
+	eprintf("open http://%s:%d/\n", host, iport);
+	eprintf("rizin -C http://%s:%d/cmd/\n", host, iport);
+	core->http_up = true;
+
+	rz_cons_break_push((RzConsBreak)http_async_break, &srv.stop);
+	void *bed = rz_cons_sleep_begin();
+	uv_run(&srv.loop, UV_RUN_DEFAULT);
+	rz_cons_sleep_end(bed);
+	rz_cons_break_pop();
+	core->http_up = false;
+	ret = srv.quit ? srv.ret : 0;
+beach:
+	uv_loop_close(&srv.loop);
+	http_async_fini(&srv);
+	return ret;
+}
+
+#endif
+
 RZ_API int rz_core_rtr_http(RzCore *core, int launch, int browse, const char *path) {
 	int ret = 0;
 	if (launch == '-') {
@@ -504,6 +1372,14 @@ RZ_API int rz_core_rtr_http(RzCore *core, int launch, int browse, const char *pa
 		return rz_core_cmdf(core, "& Rh%s", path);
 	}
 	do {
+		if (rz_config_get_b(core->config, "http.async")) {
+#if HAVE_LIBUV
+			ret = rz_core_rtr_http_async_run(core, browse, path);
+			continue;
+#else
+			eprintf("http.async needs libuv, serving one client at a time\n");
+#endif
+		}
 		ret = rz_core_rtr_http_run(core, launch, browse, path);
 	} while (ret == -2);
 	return ret;
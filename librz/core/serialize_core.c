@@ -76,8 +76,10 @@ RZ_API bool rz_serialize_core_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzCore *core,
 		SUB("file", file_load(subdb, core, prj_file, res));
 	}
 	SUB("config", rz_serialize_config_load(subdb, core->config, config_exclude, res));
-	SUB("flags", rz_serialize_flag_load(subdb, core->flags, res));
-	SUB("analysis", rz_serialize_analysis_load(subdb, core->analysis, res));
+	// the json values of the biggest namespaces are parsed on the shared workers
+	RzThreadTaskPool *pool = rz_core_get_task_pool(core);
+	SUB("flags", rz_serialize_flag_load_parallel(subdb, core->flags, pool, res));
+	SUB("analysis", rz_serialize_analysis_load_parallel(subdb, core->analysis, pool, res));
 	SUB("debug", rz_serialize_debug_load(subdb, core->dbg, res));
 
 	const char *str = sdb_get(db, "offset", 0);
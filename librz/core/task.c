@@ -17,7 +17,9 @@ RZ_API void rz_core_task_scheduler_init(RzCoreTaskScheduler *sched,
 	sched->oneshot_queue = rz_list_newf(free);
 	sched->oneshots_enqueued = 0;
 	sched->lock = rz_th_lock_new(true);
+	sched->state_lock = rz_th_rwlock_new();
 	sched->tasks_running = 0;
+	sched->concurrent_running = 0;
 	sched->oneshot_running = false;
 	sched->main_task = rz_core_task_new(sched, NULL, NULL, NULL);
 	rz_list_append(sched->tasks, sched->main_task);
@@ -29,6 +31,7 @@ RZ_API void rz_core_task_scheduler_fini(RzCoreTaskScheduler *tasks) {
 	rz_list_free(tasks->tasks_queue);
 	rz_list_free(tasks->oneshot_queue);
 	rz_th_lock_free(tasks->lock);
+	rz_th_rwlock_free(tasks->state_lock);
 }
 
 #if HAVE_PTHREAD
@@ -180,6 +183,8 @@ RZ_API RzCoreTask *rz_core_task_new(RzCoreTaskScheduler *sched, RzCoreTaskRunner
 	task->state = RZ_CORE_TASK_STATE_BEFORE_START;
 	task->refcount = 1;
 	task->transient = false;
+	task->concurrent = false;
+	task->state_locked = false;
 	return task;
 
 fail:
@@ -228,11 +233,33 @@ static void cleanup_transient(RzCoreTaskScheduler *sched, RzCoreTask *exclude) {
 	}
 }
 
+/**
+ * Run the queued oneshots, must be called with the scheduler lock held.
+ */
+static void run_oneshots(RzCoreTaskScheduler *sched) {
+	OneShot *oneshot;
+	while ((oneshot = rz_list_pop_head(sched->oneshot_queue))) {
+		sched->oneshots_enqueued--;
+		sched->oneshot_running = true;
+		oneshot->func(oneshot->user);
+		sched->oneshot_running = false;
+		free(oneshot);
+	}
+}
+
 RZ_API void rz_core_task_schedule(RzCoreTask *current, RzTaskState next_state) {
 	RzCoreTaskScheduler *sched = current->sched;
 	bool stop = next_state != RZ_CORE_TASK_STATE_RUNNING;
 
-	if (sched->oneshot_running || (!stop && sched->tasks_running == 1 && sched->oneshots_enqueued == 0)) {
+	if (sched->oneshot_running) {
+		return;
+	}
+	if (!stop && sched->tasks_running == 1 && sched->oneshots_enqueued == 0) {
+		// no other scheduled task, but let the concurrent ones waiting in
+		if (current->state_locked && rz_th_rwlock_has_waiting_readers(sched->state_lock)) {
+			rz_th_rwlock_write_leave(sched->state_lock);
+			rz_th_rwlock_write_enter(sched->state_lock);
+		}
 		return;
 	}
 
@@ -251,14 +278,7 @@ RZ_API void rz_core_task_schedule(RzCoreTask *current, RzTaskState next_state) {
 
 	// oneshots always have priority.
 	// if there are any queued, run them immediately.
-	OneShot *oneshot;
-	while ((oneshot = rz_list_pop_head(sched->oneshot_queue))) {
-		sched->oneshots_enqueued--;
-		sched->oneshot_running = true;
-		oneshot->func(oneshot->user);
-		sched->oneshot_running = false;
-		free(oneshot);
-	}
+	run_oneshots(sched);
 
 	RzCoreTask *next = rz_list_pop_head(sched->tasks_queue);
 
@@ -269,6 +289,13 @@ RZ_API void rz_core_task_schedule(RzCoreTask *current, RzTaskState next_state) {
 
 	tasks_lock_leave(sched, &old_sigset);
 
+	// the concurrent tasks may run until the next scheduled task starts
+	bool state_locked = current->state_locked;
+	if (state_locked) {
+		current->state_locked = false;
+		rz_th_rwlock_write_leave(sched->state_lock);
+	}
+
 	if (next) {
 		rz_th_lock_enter(next->dispatch_lock);
 		next->dispatched = true;
@@ -288,6 +315,10 @@ RZ_API void rz_core_task_schedule(RzCoreTask *current, RzTaskState next_state) {
 	}
 
 	if (!stop) {
+		if (state_locked) {
+			rz_th_rwlock_write_enter(sched->state_lock);
+			current->state_locked = true;
+		}
 		sched->current_task = current;
 		if (sched->ctx_switch) {
 			sched->ctx_switch(current, sched->ctx_switch_user);
@@ -326,6 +357,8 @@ static void task_wakeup(RzCoreTask *current) {
 
 	rz_th_lock_leave(current->dispatch_lock);
 
+	rz_th_rwlock_write_enter(sched->state_lock);
+	current->state_locked = true;
 	sched->current_task = current;
 
 	if (sched->ctx_switch) {
@@ -355,7 +388,13 @@ static void *task_run_thread(RzCoreTask *task) {
 		goto nonstart;
 	}
 
+	if (rz_tracing_is_enabled()) {
+		char name[32];
+		snprintf(name, sizeof(name), "task %d", task->id);
+		rz_tracing_begin("task", name);
+	}
 	task->runner(sched, task->runner_user);
+	RZ_TRACE_END("task");
 
 	TASK_SIGSET_T old_sigset;
 nonstart:
@@ -371,6 +410,66 @@ nonstart:
 	return NULL;
 }
 
+/**
+ * Run a concurrent task: it doesn't wait for its turn in the scheduler queue,
+ * but only holds the state lock as reader, so it runs at the same time as the
+ * other concurrent tasks and whenever no scheduled task holds the state lock.
+ */
+static void *task_run_concurrent(RzCoreTask *task) {
+	RzCoreTaskScheduler *sched = task->sched;
+
+	TASK_SIGSET_T old_sigset;
+	tasks_lock_enter(sched, &old_sigset);
+	sched->concurrent_running++;
+	task->state = RZ_CORE_TASK_STATE_RUNNING;
+	tasks_lock_leave(sched, &old_sigset);
+
+	if (!task->breaked) {
+		rz_th_rwlock_read_enter(sched->state_lock);
+		if (rz_tracing_is_enabled()) {
+			char name[32];
+			snprintf(name, sizeof(name), "task %d", task->id);
+			rz_tracing_begin("task", name);
+		}
+		task->runner(sched, task->runner_user);
+		RZ_TRACE_END("task");
+		rz_th_rwlock_read_leave(sched->state_lock);
+	}
+
+	tasks_lock_enter(sched, &old_sigset);
+	task->state = RZ_CORE_TASK_STATE_DONE;
+	sched->concurrent_running--;
+	if (!sched->concurrent_running && !sched->tasks_running) {
+		// the oneshots enqueued while only concurrent tasks were running
+		run_oneshots(sched);
+	}
+	cleanup_transient(sched, task);
+	if (task->running_sem) {
+		rz_th_sem_post(task->running_sem);
+	}
+	tasks_lock_leave(sched, &old_sigset);
+	return NULL;
+}
+
+/**
+ * \brief Make \p task run concurrently with the other tasks once enqueued
+ *
+ * A concurrent task runs on its own thread without waiting for its turn, as
+ * long as the scheduled task running is sleeping, yielding or done, and at the
+ * same time as the other concurrent tasks. It must therefore only read the
+ * state shared with the other tasks, and must not use anything bound to the
+ * scheduled task running, such as RzCons, rz_core_task_self() or
+ * rz_core_task_yield(), nor anything keeping internal state while reading,
+ * such as RzIO.
+ *
+ * Must be called before rz_core_task_enqueue(), and the task must not be run
+ * with rz_core_task_run_sync().
+ */
+RZ_API void rz_core_task_set_concurrent(RzCoreTask *task, bool concurrent) {
+	rz_return_if_fail(task && task->state == RZ_CORE_TASK_STATE_BEFORE_START && !task->thread);
+	task->concurrent = concurrent;
+}
+
 RZ_API void rz_core_task_enqueue(RzCoreTaskScheduler *scheduler, RzCoreTask *task) {
 	if (!scheduler || !task) {
 		return;
@@ -384,7 +483,7 @@ RZ_API void rz_core_task_enqueue(RzCoreTaskScheduler *scheduler, RzCoreTask *tas
 		rz_th_sem_wait(task->running_sem);
 	}
 	rz_list_append(scheduler->tasks, task);
-	task->thread = rz_th_new((RzThreadFunction)task_run_thread, task);
+	task->thread = rz_th_new((RzThreadFunction)(task->concurrent ? task_run_concurrent : task_run_thread), task);
 	tasks_lock_leave(scheduler, &old_sigset);
 }
 
@@ -394,7 +493,7 @@ RZ_API void rz_core_task_enqueue_oneshot(RzCoreTaskScheduler *scheduler, RzCoreT
 	}
 	TASK_SIGSET_T old_sigset;
 	tasks_lock_enter(scheduler, &old_sigset);
-	if (scheduler->tasks_running == 0) {
+	if (scheduler->tasks_running == 0 && scheduler->concurrent_running == 0) {
 		// nothing is running right now and no other task can be scheduled
 		// while core->tasks_lock is locked => just run it
 		scheduler->oneshot_running = true;
@@ -660,6 +759,7 @@ typedef struct function_task_ctx_t {
 	RzCoreTaskFunction fcn;
 	void *fcn_user;
 	void *res;
+	bool concurrent; ///< the task doesn't own RzCons, see rz_core_task_set_concurrent()
 } FunctionTaskCtx;
 
 static FunctionTaskCtx *function_task_ctx_new(RzCore *core, RzCoreTaskFunction fcn, void *fcn_user) {
@@ -674,12 +774,17 @@ static FunctionTaskCtx *function_task_ctx_new(RzCore *core, RzCoreTaskFunction f
 	ctx->fcn = fcn;
 	ctx->fcn_user = fcn_user;
 	ctx->res = NULL;
+	ctx->concurrent = false;
 	return ctx;
 }
 
 static void function_task_runner(RzCoreTaskScheduler *sched, void *user) {
 	FunctionTaskCtx *ctx = user;
 	RzCore *core = ctx->core_ctx.core;
+	if (ctx->concurrent) {
+		ctx->res = ctx->fcn(core, ctx->fcn_user);
+		return;
+	}
 	rz_cons_push();
 	ctx->res = ctx->fcn(core, ctx->fcn_user);
 	rz_cons_pop();
@@ -711,6 +816,22 @@ RZ_API RzCoreTask *rz_core_function_task_new(RzCore *core, RzCoreTaskFunction fc
 	return task;
 }
 
+/**
+ * Create a new task that runs a custom function concurrently with the other tasks and saves its result.
+ * The function must only read the core state, see rz_core_task_set_concurrent() for what it can't use.
+ * These tasks are not user-visible.
+ */
+RZ_API RzCoreTask *rz_core_function_task_new_concurrent(RzCore *core, RzCoreTaskFunction fcn, void *fcn_user) {
+	RzCoreTask *task = rz_core_function_task_new(core, fcn, fcn_user);
+	if (!task) {
+		return NULL;
+	}
+	FunctionTaskCtx *ctx = task->runner_user;
+	ctx->concurrent = true;
+	rz_core_task_set_concurrent(task, true);
+	return task;
+}
+
 /**
  * Get the return value of the function that was run in a task created with rz_core_function_task_new.
  * If the task is not a function task, returns NULL.
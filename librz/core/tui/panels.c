@@ -4743,10 +4743,13 @@ void __panels_refresh(RzCore *core) {
 		return;
 	}
 	rz_cons_canvas_print(can);
+	// a full screen frame, so that only what changed is written with scr.damage
+	rz_cons_newline();
+	rz_cons_visual_flush();
 	if (core->scr_gadgets) {
 		rz_core_gadget_print(core);
+		rz_cons_flush();
 	}
-	rz_cons_flush();
 }
 
 void __do_panels_resize(RzCore *core) {
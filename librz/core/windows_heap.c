@@ -5,6 +5,7 @@
 #include <rz_core.h>
 #include <TlHelp32.h>
 #include <windows_heap.h>
+#include "core_private.h"
 #include "..\..\debug\p\native\maps\windows_maps.h"
 #include "..\..\bin\pdb\pdb_downloader.h"
 #include "..\..\bin\pdb\pdb.h"
@@ -154,9 +155,38 @@ static bool initialize_windows_ntdll_query_api_functions(void) {
 	return true;
 }
 
-static bool is_segment_heap(HANDLE h_proc, PVOID heapBase) {
+/*
+ * Reads the debuggee memory through the core heap cache, which keeps it by
+ * blocks of 64 KiB until the target runs (see rz_core_heap_read()).
+ * Walking the heaps reads a header at a time, so most reads are served from
+ * the local copy instead of a ReadProcessMemory() each.
+ * Same interface as ReadProcessMemory().
+ */
+static BOOL ReadHeapMemory(RzDebug *dbg, HANDLE h_proc, LPCVOID address, LPVOID buffer, SIZE_T size, SIZE_T *read) {
+	RzCore *core = dbg->corebind.core;
+	if (!core) {
+		return ReadProcessMemory(h_proc, address, buffer, size, read);
+	}
+	bool ret = !size || rz_core_heap_read(core, (ut64)(WPARAM)address, buffer, size);
+	if (read) {
+		*read = ret ? size : 0;
+	}
+	if (!ret) {
+		SetLastError(ERROR_PARTIAL_COPY);
+	}
+	return ret;
+}
+
+static void PrefetchHeapMemory(RzDebug *dbg, WPARAM from, WPARAM to) {
+	RzCore *core = dbg->corebind.core;
+	if (core && from < to) {
+		rz_core_heap_prefetch(core, from, to - from);
+	}
+}
+
+static bool is_segment_heap(RzDebug *dbg, HANDLE h_proc, PVOID heapBase) {
 	HEAP heap;
-	if (ReadProcessMemory(h_proc, heapBase, &heap, sizeof(HEAP), NULL)) {
+	if (ReadHeapMemory(dbg, h_proc, heapBase, &heap, sizeof(HEAP), NULL)) {
 		if (heap.SegmentSignature == 0xddeeddee) {
 			return true;
 		}
@@ -404,7 +434,7 @@ static bool GetLFHKey(RzDebug *dbg, HANDLE h_proc, bool segment, WPARAM *lfhKey)
 	} else {
 		lfhKeyLocation = RtlpLFHKeyOffset; // ntdll!RtlpLFHKey
 	}
-	if (!ReadProcessMemory(h_proc, (PVOID)lfhKeyLocation, lfhKey, sizeof(WPARAM), NULL)) {
+	if (!ReadHeapMemory(dbg, h_proc, (PVOID)lfhKeyLocation, lfhKey, sizeof(WPARAM), NULL)) {
 		rz_sys_perror("ReadProcessMemory");
 		eprintf("LFH key not found.\n");
 		*lfhKey = 0;
@@ -466,7 +496,7 @@ static RzList *GetListOfHeaps(RzDebug *dbg, HANDLE ph) {
 		return NULL;
 	}
 	PEB peb;
-	ReadProcessMemory(ph, pib.PebBaseAddress, &peb, sizeof(PEB), NULL);
+	ReadHeapMemory(dbg, ph, pib.PebBaseAddress, &peb, sizeof(PEB), NULL);
 	RzList *heaps = rz_list_new();
 	PVOID heapAddress;
 	PVOID *processHeaps;
@@ -479,7 +509,7 @@ static RzList *GetListOfHeaps(RzDebug *dbg, HANDLE ph) {
 		numberOfHeaps = *((ULONG *)(((ut8 *)&peb) + 0x88));
 	}
 	do {
-		ReadProcessMemory(ph, processHeaps, &heapAddress, sizeof(PVOID), NULL);
+		ReadHeapMemory(dbg, ph, processHeaps, &heapAddress, sizeof(PVOID), NULL);
 		rz_list_push(heaps, heapAddress);
 		processHeaps += 1;
 	} while (--numberOfHeaps);
@@ -602,10 +632,10 @@ static PDEBUG_BUFFER InitHeapInfo(RzDebug *dbg, DWORD mask) {
 		memset((BYTE *)(*blocks) + old_alloc, 0, old_alloc); \
 	}
 
-static bool __lfh_segment_loop(HANDLE h_proc, PHeapBlockBasicInfo *blocks, SIZE_T *allocated, WPARAM lfhKey, WPARAM *count, WPARAM first, WPARAM next) {
+static bool __lfh_segment_loop(RzDebug *dbg, HANDLE h_proc, PHeapBlockBasicInfo *blocks, SIZE_T *allocated, WPARAM lfhKey, WPARAM *count, WPARAM first, WPARAM next) {
 	while ((first != next) && next) {
 		HEAP_LFH_SUBSEGMENT subsegment;
-		ReadProcessMemory(h_proc, (void *)next, &subsegment, sizeof(HEAP_LFH_SUBSEGMENT), NULL);
+		ReadHeapMemory(dbg, h_proc, (void *)next, &subsegment, sizeof(HEAP_LFH_SUBSEGMENT), NULL);
 		subsegment.BlockOffsets.EncodedData ^= (DWORD)lfhKey ^ ((DWORD)next >> 0xC);
 		WPARAM mask = 1, offset = 0;
 		int l;
@@ -613,7 +643,7 @@ static bool __lfh_segment_loop(HANDLE h_proc, PHeapBlockBasicInfo *blocks, SIZE_
 			if (!mask) {
 				mask = 1;
 				offset++;
-				ReadProcessMemory(h_proc, (WPARAM *)(next + offsetof(HEAP_LFH_SUBSEGMENT, BlockBitmap)) + offset,
+				ReadHeapMemory(dbg, h_proc, (WPARAM *)(next + offsetof(HEAP_LFH_SUBSEGMENT, BlockBitmap)) + offset,
 					&subsegment.BlockBitmap, sizeof(WPARAM), NULL);
 			}
 			if (subsegment.BlockBitmap[0] & mask) {
@@ -642,14 +672,14 @@ static bool GetSegmentHeapBlocks(RzDebug *dbg, HANDLE h_proc, PVOID heapBase, PH
 	rz_return_val_if_fail(h_proc && blocks && count && allocated, false);
 	WPARAM bytesRead;
 	SEGMENT_HEAP segheapHeader;
-	ReadProcessMemory(h_proc, heapBase, &segheapHeader, sizeof(SEGMENT_HEAP), &bytesRead);
+	ReadHeapMemory(dbg, h_proc, heapBase, &segheapHeader, sizeof(SEGMENT_HEAP), &bytesRead);
 
 	if (segheapHeader.Signature != 0xddeeddee) {
 		return false;
 	}
 	WPARAM lfhKey;
 	WPARAM lfhKeyLocation = RtlpHpHeapGlobalsOffset + sizeof(WPARAM);
-	if (!ReadProcessMemory(h_proc, (PVOID)lfhKeyLocation, &lfhKey, sizeof(WPARAM), &bytesRead)) {
+	if (!ReadHeapMemory(dbg, h_proc, (PVOID)lfhKeyLocation, &lfhKey, sizeof(WPARAM), &bytesRead)) {
 		rz_sys_perror("ReadProcessMemory");
 		eprintf("LFH key not found.\n");
 		return false;
@@ -663,19 +693,19 @@ static bool GetSegmentHeapBlocks(RzDebug *dbg, HANDLE h_proc, PVOID heapBase, PH
 			continue;
 		}
 		HEAP_LFH_BUCKET bucket;
-		ReadProcessMemory(h_proc, segheapHeader.LfhContext.Buckets[j], &bucket, sizeof(HEAP_LFH_BUCKET), &bytesRead);
+		ReadHeapMemory(dbg, h_proc, segheapHeader.LfhContext.Buckets[j], &bucket, sizeof(HEAP_LFH_BUCKET), &bytesRead);
 		HEAP_LFH_AFFINITY_SLOT affinitySlot, *paffinitySlot;
-		ReadProcessMemory(h_proc, bucket.AffinitySlots, &paffinitySlot, sizeof(PHEAP_LFH_AFFINITY_SLOT), &bytesRead);
+		ReadHeapMemory(dbg, h_proc, bucket.AffinitySlots, &paffinitySlot, sizeof(PHEAP_LFH_AFFINITY_SLOT), &bytesRead);
 		bucket.AffinitySlots++;
-		ReadProcessMemory(h_proc, paffinitySlot, &affinitySlot, sizeof(HEAP_LFH_AFFINITY_SLOT), &bytesRead);
+		ReadHeapMemory(dbg, h_proc, paffinitySlot, &affinitySlot, sizeof(HEAP_LFH_AFFINITY_SLOT), &bytesRead);
 		WPARAM first = (WPARAM)paffinitySlot + offsetof(HEAP_LFH_SUBSEGMENT_OWNER, AvailableSubsegmentList);
 		WPARAM next = (WPARAM)affinitySlot.State.AvailableSubsegmentList.Flink;
-		if (!__lfh_segment_loop(h_proc, blocks, allocated, lfhKey, count, first, next)) {
+		if (!__lfh_segment_loop(dbg, h_proc, blocks, allocated, lfhKey, count, first, next)) {
 			return false;
 		}
 		first = (WPARAM)paffinitySlot + offsetof(HEAP_LFH_SUBSEGMENT_OWNER, FullSubsegmentList);
 		next = (WPARAM)affinitySlot.State.FullSubsegmentList.Flink;
-		if (!__lfh_segment_loop(h_proc, blocks, allocated, lfhKey, count, first, next)) {
+		if (!__lfh_segment_loop(dbg, h_proc, blocks, allocated, lfhKey, count, first, next)) {
 			return false;
 		}
 	}
@@ -689,12 +719,12 @@ static bool GetSegmentHeapBlocks(RzDebug *dbg, HANDLE h_proc, PVOID heapBase, PH
 			GROW_PBLOCKS();
 			while (curr) {
 				rz_stack_push(s, curr);
-				ReadProcessMemory(h_proc, curr, node, sizeof(RTL_BALANCED_NODE), &bytesRead);
+				ReadHeapMemory(dbg, h_proc, curr, node, sizeof(RTL_BALANCED_NODE), &bytesRead);
 				curr = node->Left;
 			};
 			curr = (PRTL_BALANCED_NODE)rz_stack_pop(s);
 			HEAP_LARGE_ALLOC_DATA entry;
-			ReadProcessMemory(h_proc, curr, &entry, sizeof(HEAP_LARGE_ALLOC_DATA), &bytesRead);
+			ReadHeapMemory(dbg, h_proc, curr, &entry, sizeof(HEAP_LARGE_ALLOC_DATA), &bytesRead);
 			(*blocks)[*count].address = entry.VirtualAddess - entry.UnusedBytes; // This is a union
 			(*blocks)[*count].flags = 1 | SEGMENT_HEAP_BLOCK | LARGE_BLOCK;
 			(*blocks)[*count].size = ((entry.AllocatedPages >> 12) << 12);
@@ -703,7 +733,7 @@ static bool GetSegmentHeapBlocks(RzDebug *dbg, HANDLE h_proc, PVOID heapBase, PH
 				return false;
 			}
 			extra->unusedBytes = entry.UnusedBytes;
-			ReadProcessMemory(h_proc, (void *)(*blocks)[*count].address, &extra->granularity, sizeof(USHORT), &bytesRead);
+			ReadHeapMemory(dbg, h_proc, (void *)(*blocks)[*count].address, &extra->granularity, sizeof(USHORT), &bytesRead);
 			(*blocks)[*count].extra = EXTRA_FLAG | (WPARAM)extra;
 			curr = entry.TreeNode.Right;
 			*count += 1;
@@ -713,7 +743,7 @@ static bool GetSegmentHeapBlocks(RzDebug *dbg, HANDLE h_proc, PVOID heapBase, PH
 	}
 
 	WPARAM RtlpHpHeapGlobal;
-	ReadProcessMemory(h_proc, (PVOID)RtlpHpHeapGlobalsOffset, &RtlpHpHeapGlobal, sizeof(WPARAM), &bytesRead);
+	ReadHeapMemory(dbg, h_proc, (PVOID)RtlpHpHeapGlobalsOffset, &RtlpHpHeapGlobal, sizeof(WPARAM), &bytesRead);
 	// Backend Blocks (And VS)
 	int i;
 	for (i = 0; i < 2; i++) {
@@ -722,7 +752,7 @@ static bool GetSegmentHeapBlocks(RzDebug *dbg, HANDLE h_proc, PVOID heapBase, PH
 		HEAP_PAGE_SEGMENT pageSegment;
 		WPARAM currPageSegment = (WPARAM)ctx.SegmentListHead.Flink;
 		do {
-			if (!ReadProcessMemory(h_proc, (PVOID)currPageSegment, &pageSegment, sizeof(HEAP_PAGE_SEGMENT), &bytesRead)) {
+			if (!ReadHeapMemory(dbg, h_proc, (PVOID)currPageSegment, &pageSegment, sizeof(HEAP_PAGE_SEGMENT), &bytesRead)) {
 				break;
 			}
 			for (WPARAM j = 2; j < 256; j++) {
@@ -746,12 +776,13 @@ static bool GetSegmentHeapBlocks(RzDebug *dbg, HANDLE h_proc, PVOID heapBase, PH
 				if (pageSegment.DescArray[j].RangeFlags & 0xF && pageSegment.DescArray[j].UnusedBytes == 0x1000) {
 					HEAP_VS_SUBSEGMENT vsSubsegment;
 					WPARAM start, from = currPageSegment + j * 0x1000;
-					ReadProcessMemory(h_proc, (PVOID)from, &vsSubsegment, sizeof(HEAP_VS_SUBSEGMENT), &bytesRead);
+					ReadHeapMemory(dbg, h_proc, (PVOID)from, &vsSubsegment, sizeof(HEAP_VS_SUBSEGMENT), &bytesRead);
 					// Walk through subsegment
 					start = from += sizeof(HEAP_VS_SUBSEGMENT);
+					PrefetchHeapMemory(dbg, start, start + vsSubsegment.Size * sizeof(HEAP_VS_CHUNK_HEADER));
 					while (from < (WPARAM)start + vsSubsegment.Size * sizeof(HEAP_VS_CHUNK_HEADER)) {
 						HEAP_VS_CHUNK_HEADER vsChunk;
-						ReadProcessMemory(h_proc, (PVOID)from, &vsChunk, sizeof(HEAP_VS_CHUNK_HEADER), &bytesRead);
+						ReadHeapMemory(dbg, h_proc, (PVOID)from, &vsChunk, sizeof(HEAP_VS_CHUNK_HEADER), &bytesRead);
 						vsChunk.Sizes.HeaderBits ^= from ^ RtlpHpHeapGlobal;
 						WPARAM sz = vsChunk.Sizes.UnsafeSize * sizeof(HEAP_VS_CHUNK_HEADER);
 						if (vsChunk.Sizes.Allocated) {
@@ -816,7 +847,7 @@ static PDEBUG_BUFFER GetHeapBlocks(DWORD pid, RzDebug *dbg) {
 		HEAP_ENTRY heapEntry;
 		HEAP heapHeader;
 		const SIZE_T sz_entry = sizeof(HEAP_ENTRY);
-		ReadProcessMemory(h_proc, heap->Base, &heapHeader, sizeof(HEAP), &bytesRead);
+		ReadHeapMemory(dbg, h_proc, heap->Base, &heapHeader, sizeof(HEAP), &bytesRead);
 
 		SIZE_T allocated = 128 * sizeof(HeapBlockBasicInfo);
 		PHeapBlockBasicInfo blocks = calloc(allocated, 1);
@@ -841,7 +872,7 @@ static PDEBUG_BUFFER GetHeapBlocks(DWORD pid, RzDebug *dbg) {
 		PLIST_ENTRY entry = heapHeader.VirtualAllocdBlocks.Flink;
 		while (entry && (entry != fentry)) {
 			HEAP_VIRTUAL_ALLOC_ENTRY vAlloc;
-			ReadProcessMemory(h_proc, entry, &vAlloc, sizeof(HEAP_VIRTUAL_ALLOC_ENTRY), &bytesRead);
+			ReadHeapMemory(dbg, h_proc, entry, &vAlloc, sizeof(HEAP_VIRTUAL_ALLOC_ENTRY), &bytesRead);
 			DecodeHeapEntry(dbg, &heapHeader, &vAlloc.BusyBlock);
 			GROW_BLOCKS();
 			blocks[count].address = (WPARAM)entry;
@@ -861,7 +892,7 @@ static PDEBUG_BUFFER GetHeapBlocks(DWORD pid, RzDebug *dbg) {
 		// LFH Activated
 		if (heapHeader.FrontEndHeap && heapHeader.FrontEndHeapType == 0x2) {
 			LFH_HEAP lfhHeader;
-			if (!ReadProcessMemory(h_proc, heapHeader.FrontEndHeap, &lfhHeader, sizeof(LFH_HEAP), &bytesRead)) {
+			if (!ReadHeapMemory(dbg, h_proc, heapHeader.FrontEndHeap, &lfhHeader, sizeof(LFH_HEAP), &bytesRead)) {
 				rz_sys_perror("ReadProcessMemory");
 				goto err;
 			}
@@ -880,7 +911,7 @@ static PDEBUG_BUFFER GetHeapBlocks(DWORD pid, RzDebug *dbg) {
 				WPARAM curSubsegment = (WPARAM)(curEntry + 2);
 				int next = 0;
 				do { // (next < blockZone.NextIndex)
-					if (!ReadProcessMemory(h_proc, (PVOID)curSubsegment, &subsegment, sizeof(HEAP_SUBSEGMENT), &bytesRead) || !subsegment.BlockSize || !ReadProcessMemory(h_proc, subsegment.LocalInfo, &info, sizeof(HEAP_LOCAL_SEGMENT_INFO), &bytesRead) || !ReadProcessMemory(h_proc, info.LocalData, &localData, sizeof(HEAP_LOCAL_DATA), &bytesRead) || !ReadProcessMemory(h_proc, localData.CrtZone, &blockZone, sizeof(LFH_BLOCK_ZONE), &bytesRead)) {
+					if (!ReadHeapMemory(dbg, h_proc, (PVOID)curSubsegment, &subsegment, sizeof(HEAP_SUBSEGMENT), &bytesRead) || !subsegment.BlockSize || !ReadHeapMemory(dbg, h_proc, subsegment.LocalInfo, &info, sizeof(HEAP_LOCAL_SEGMENT_INFO), &bytesRead) || !ReadHeapMemory(dbg, h_proc, info.LocalData, &localData, sizeof(HEAP_LOCAL_DATA), &bytesRead) || !ReadHeapMemory(dbg, h_proc, localData.CrtZone, &blockZone, sizeof(LFH_BLOCK_ZONE), &bytesRead)) {
 						break;
 					}
 
@@ -889,14 +920,16 @@ static PDEBUG_BUFFER GetHeapBlocks(DWORD pid, RzDebug *dbg) {
 					}
 
 					size_t sz = subsegment.BlockSize * sizeof(HEAP_ENTRY);
-					ReadProcessMemory(h_proc, subsegment.UserBlocks, &userdata, sizeof(HEAP_USERDATA_HEADER), &bytesRead);
+					ReadHeapMemory(dbg, h_proc, subsegment.UserBlocks, &userdata, sizeof(HEAP_USERDATA_HEADER), &bytesRead);
 					userdata.EncodedOffsets.StrideAndOffset ^= PtrToInt(subsegment.UserBlocks) ^ PtrToInt(heapHeader.FrontEndHeap) ^ (WPARAM)lfhKey;
 					size_t bitmapsz = (userdata.BusyBitmap.SizeOfBitMap + 8 - userdata.BusyBitmap.SizeOfBitMap % 8) / 8;
 					WPARAM *bitmap = calloc(bitmapsz > sizeof(WPARAM) ? bitmapsz : sizeof(WPARAM), 1);
 					if (!bitmap) {
 						goto err;
 					}
-					ReadProcessMemory(h_proc, userdata.BusyBitmap.Buffer, bitmap, bitmapsz, &bytesRead);
+					ReadHeapMemory(dbg, h_proc, userdata.BusyBitmap.Buffer, bitmap, bitmapsz, &bytesRead);
+					PrefetchHeapMemory(dbg, (WPARAM)subsegment.UserBlocks + userdata.EncodedOffsets.FirstAllocationOffset,
+						(WPARAM)subsegment.UserBlocks + userdata.EncodedOffsets.FirstAllocationOffset + sz * userdata.BusyBitmap.SizeOfBitMap);
 					WPARAM mask = 1;
 					// Walk through the busy bitmap
 					int j;
@@ -911,7 +944,7 @@ static PDEBUG_BUFFER GetHeapBlocks(DWORD pid, RzDebug *dbg) {
 							GROW_BLOCKS();
 							WPARAM off = userdata.EncodedOffsets.FirstAllocationOffset + sz * j;
 							from = (WPARAM)subsegment.UserBlocks + off;
-							ReadProcessMemory(h_proc, (PVOID)from, &heapEntry, sz_entry, &bytesRead);
+							ReadHeapMemory(dbg, h_proc, (PVOID)from, &heapEntry, sz_entry, &bytesRead);
 							DecodeLFHEntry(dbg, &heapHeader, &heapEntry, subsegment.UserBlocks, lfhKey, from);
 							blocks[count].address = from;
 							blocks[count].flags = 1 | NT_BLOCK | LFH_BLOCK;
@@ -934,22 +967,24 @@ static PDEBUG_BUFFER GetHeapBlocks(DWORD pid, RzDebug *dbg) {
 				} while (next < blockZone.NextIndex || subsegment.BlockSize);
 
 				LIST_ENTRY entry;
-				ReadProcessMemory(h_proc, curEntry, &entry, sizeof(entry), &bytesRead);
+				ReadHeapMemory(dbg, h_proc, curEntry, &entry, sizeof(entry), &bytesRead);
 				curEntry = entry.Flink;
 			} while (curEntry != firstEntry);
 		}
 
 		HEAP_SEGMENT oldSegment, segment;
 		WPARAM firstSegment = (WPARAM)heapHeader.SegmentList.Flink;
-		ReadProcessMemory(h_proc, (PVOID)(firstSegment - offsetof(HEAP_SEGMENT, SegmentListEntry)), &segment, sizeof(HEAP_SEGMENT), &bytesRead);
+		ReadHeapMemory(dbg, h_proc, (PVOID)(firstSegment - offsetof(HEAP_SEGMENT, SegmentListEntry)), &segment, sizeof(HEAP_SEGMENT), &bytesRead);
 		// NT Blocks (Loops through all _HEAP_SEGMENTs)
 		do {
 			from = (WPARAM)segment.FirstEntry;
 			if (!from) {
 				goto next;
 			}
+			// The committed part of the segment, walked entry by entry below
+			PrefetchHeapMemory(dbg, from, RZ_MIN((WPARAM)segment.LastValidEntry, (WPARAM)segment.BaseAddress + (WPARAM)(segment.NumberOfPages - segment.NumberOfUnCommittedPages) * 0x1000));
 			do {
-				if (!ReadProcessMemory(h_proc, (PVOID)from, &heapEntry, sz_entry, &bytesRead)) {
+				if (!ReadHeapMemory(dbg, h_proc, (PVOID)from, &heapEntry, sz_entry, &bytesRead)) {
 					break;
 				}
 				DecodeHeapEntry(dbg, &heapHeader, &heapEntry);
@@ -978,7 +1013,7 @@ static PDEBUG_BUFFER GetHeapBlocks(DWORD pid, RzDebug *dbg) {
 		next:
 			oldSegment = segment;
 			from = (WPARAM)segment.SegmentListEntry.Flink - offsetof(HEAP_SEGMENT, SegmentListEntry);
-			ReadProcessMemory(h_proc, (PVOID)from, &segment, sizeof(HEAP_SEGMENT), &bytesRead);
+			ReadHeapMemory(dbg, h_proc, (PVOID)from, &segment, sizeof(HEAP_SEGMENT), &bytesRead);
 		} while ((WPARAM)oldSegment.SegmentListEntry.Flink != firstSegment);
 		heap->Blocks = blocks;
 		heap->BlockCount = count;
@@ -1024,17 +1059,17 @@ static PHeapBlock GetSingleSegmentBlock(RzDebug *dbg, HANDLE h_proc, PSEGMENT_HE
 	WPARAM granularity = (WPARAM)dbg->bits * 2;
 	WPARAM headerOff = offset - granularity;
 	SEGMENT_HEAP heap;
-	ReadProcessMemory(h_proc, heapBase, &heap, sizeof(SEGMENT_HEAP), NULL);
+	ReadHeapMemory(dbg, h_proc, heapBase, &heap, sizeof(SEGMENT_HEAP), NULL);
 	WPARAM RtlpHpHeapGlobal;
-	ReadProcessMemory(h_proc, (PVOID)RtlpHpHeapGlobalsOffset, &RtlpHpHeapGlobal, sizeof(WPARAM), NULL);
+	ReadHeapMemory(dbg, h_proc, (PVOID)RtlpHpHeapGlobalsOffset, &RtlpHpHeapGlobal, sizeof(WPARAM), NULL);
 
 	WPARAM pgSegOff = headerOff & heap.SegContexts[0].SegmentMask;
 	WPARAM segSignature;
-	ReadProcessMemory(h_proc, (PVOID)(pgSegOff + sizeof(LIST_ENTRY)), &segSignature, sizeof(WPARAM), NULL); // HEAP_PAGE_SEGMENT.Signature
+	ReadHeapMemory(dbg, h_proc, (PVOID)(pgSegOff + sizeof(LIST_ENTRY)), &segSignature, sizeof(WPARAM), NULL); // HEAP_PAGE_SEGMENT.Signature
 	WPARAM test = RtlpHpHeapGlobal ^ pgSegOff ^ segSignature ^ ((WPARAM)heapBase + offsetof(SEGMENT_HEAP, SegContexts));
 	if (test == 0xa2e64eada2e64ead) { // Hardcoded in ntdll
 		HEAP_PAGE_SEGMENT segment;
-		ReadProcessMemory(h_proc, (PVOID)pgSegOff, &segment, sizeof(HEAP_PAGE_SEGMENT), NULL);
+		ReadHeapMemory(dbg, h_proc, (PVOID)pgSegOff, &segment, sizeof(HEAP_PAGE_SEGMENT), NULL);
 		WPARAM pgRangeDescOff = ((headerOff - pgSegOff) >> heap.SegContexts[0].UnitShift) << 5;
 		WPARAM pageIndex = pgRangeDescOff / sizeof(HEAP_PAGE_RANGE_DESCRIPTOR);
 		if (!(segment.DescArray[pageIndex].RangeFlags & PAGE_RANGE_FLAGS_FIRST)) {
@@ -1044,10 +1079,10 @@ static PHeapBlock GetSingleSegmentBlock(RzDebug *dbg, HANDLE h_proc, PSEGMENT_HE
 		WPARAM subsegmentOffset = pgSegOff + pageIndex * 0x1000;
 		if (segment.DescArray[pageIndex].RangeFlags & 0xF && segment.DescArray[pageIndex].UnusedBytes == 0x1000) {
 			HEAP_VS_SUBSEGMENT subsegment;
-			ReadProcessMemory(h_proc, (PVOID)subsegmentOffset, &subsegment, sizeof(HEAP_VS_SUBSEGMENT), NULL);
+			ReadHeapMemory(dbg, h_proc, (PVOID)subsegmentOffset, &subsegment, sizeof(HEAP_VS_SUBSEGMENT), NULL);
 			if ((subsegment.Size ^ 0x2BED) == subsegment.Signature) {
 				HEAP_VS_CHUNK_HEADER header;
-				ReadProcessMemory(h_proc, (PVOID)(headerOff - sizeof(HEAP_VS_CHUNK_HEADER)), &header, sizeof(HEAP_VS_CHUNK_HEADER), NULL);
+				ReadHeapMemory(dbg, h_proc, (PVOID)(headerOff - sizeof(HEAP_VS_CHUNK_HEADER)), &header, sizeof(HEAP_VS_CHUNK_HEADER), NULL);
 				header.Sizes.HeaderBits ^= RtlpHpHeapGlobal ^ headerOff;
 				hb->dwAddress = offset;
 				hb->dwSize = header.Sizes.UnsafeSize * sizeof(HEAP_VS_CHUNK_HEADER);
@@ -1060,7 +1095,7 @@ static PHeapBlock GetSingleSegmentBlock(RzDebug *dbg, HANDLE h_proc, PSEGMENT_HE
 		// LFH
 		if (segment.DescArray[pageIndex].RangeFlags & PAGE_RANGE_FLAGS_LFH_SUBSEGMENT) {
 			HEAP_LFH_SUBSEGMENT subsegment;
-			ReadProcessMemory(h_proc, (PVOID)subsegmentOffset, &subsegment, sizeof(HEAP_LFH_SUBSEGMENT), NULL);
+			ReadHeapMemory(dbg, h_proc, (PVOID)subsegmentOffset, &subsegment, sizeof(HEAP_LFH_SUBSEGMENT), NULL);
 			WPARAM lfhKey;
 			GetLFHKey(dbg, h_proc, true, &lfhKey);
 			subsegment.BlockOffsets.EncodedData ^= (DWORD)lfhKey ^ ((DWORD)subsegmentOffset >> 0xC);
@@ -1080,11 +1115,11 @@ static PHeapBlock GetSingleSegmentBlock(RzDebug *dbg, HANDLE h_proc, PSEGMENT_HE
 		}
 		RTL_BALANCED_NODE node;
 		WPARAM curr = (WPARAM)heap.LargeAllocMetadata.Root;
-		ReadProcessMemory(h_proc, (PVOID)curr, &node, sizeof(RTL_BALANCED_NODE), NULL);
+		ReadHeapMemory(dbg, h_proc, (PVOID)curr, &node, sizeof(RTL_BALANCED_NODE), NULL);
 
 		while (curr) {
 			HEAP_LARGE_ALLOC_DATA entry;
-			ReadProcessMemory(h_proc, (PVOID)curr, &entry, sizeof(HEAP_LARGE_ALLOC_DATA), NULL);
+			ReadHeapMemory(dbg, h_proc, (PVOID)curr, &entry, sizeof(HEAP_LARGE_ALLOC_DATA), NULL);
 			WPARAM VirtualAddess = entry.VirtualAddess - entry.UnusedBytes;
 			if ((offset & ~0xFFFFULL) > VirtualAddess) {
 				curr = (WPARAM)node.Right;
@@ -1095,11 +1130,11 @@ static PHeapBlock GetSingleSegmentBlock(RzDebug *dbg, HANDLE h_proc, PSEGMENT_HE
 				hb->dwSize = ((entry.AllocatedPages >> 12) << 12) - entry.UnusedBytes;
 				hb->dwFlags = SEGMENT_HEAP_BLOCK | LARGE_BLOCK | 1;
 				extra->unusedBytes = entry.UnusedBytes;
-				ReadProcessMemory(h_proc, (PVOID)hb->dwAddress, &extra->granularity, sizeof(USHORT), NULL);
+				ReadHeapMemory(dbg, h_proc, (PVOID)hb->dwAddress, &extra->granularity, sizeof(USHORT), NULL);
 				return hb;
 			}
 			if (curr) {
-				ReadProcessMemory(h_proc, (PVOID)curr, &node, sizeof(RTL_BALANCED_NODE), NULL);
+				ReadHeapMemory(dbg, h_proc, (PVOID)curr, &node, sizeof(RTL_BALANCED_NODE), NULL);
 			}
 		}
 	}
@@ -1138,7 +1173,7 @@ static PHeapBlock GetSingleBlock(RzDebug *dbg, ut64 offset) {
 	int i;
 	for (i = 0; i < heapInfo->count; i++) {
 		DEBUG_HEAP_INFORMATION heap = heapInfo->heaps[i];
-		if (is_segment_heap(h_proc, heap.Base)) {
+		if (is_segment_heap(dbg, h_proc, heap.Base)) {
 			free(hb);
 			RZ_FREE(extra);
 			hb = GetSingleSegmentBlock(dbg, h_proc, heap.Base, offset);
@@ -1150,8 +1185,8 @@ static PHeapBlock GetSingleBlock(RzDebug *dbg, ut64 offset) {
 			HEAP h;
 			HEAP_ENTRY entry;
 			WPARAM entryOffset = offset - heap.Granularity;
-			if (!ReadProcessMemory(h_proc, heap.Base, &h, sizeof(HEAP), NULL) ||
-				!ReadProcessMemory(h_proc, (PVOID)entryOffset, &entry, sizeof(HEAP_ENTRY), NULL)) {
+			if (!ReadHeapMemory(dbg, h_proc, heap.Base, &h, sizeof(HEAP), NULL) ||
+				!ReadHeapMemory(dbg, h_proc, (PVOID)entryOffset, &entry, sizeof(HEAP_ENTRY), NULL)) {
 				goto err;
 			}
 			extra->granularity = heap.Granularity;
@@ -1163,7 +1198,7 @@ static PHeapBlock GetSingleBlock(RzDebug *dbg, ut64 offset) {
 				UPDATE_FLAGS(hb, (DWORD)entry.Flags | NT_BLOCK);
 				if (entry.UnusedBytes == 0x4) {
 					HEAP_VIRTUAL_ALLOC_ENTRY largeEntry;
-					if (ReadProcessMemory(h_proc, (PVOID)(offset - sizeof(HEAP_VIRTUAL_ALLOC_ENTRY)), &largeEntry, sizeof(HEAP_VIRTUAL_ALLOC_ENTRY), NULL)) {
+					if (ReadHeapMemory(dbg, h_proc, (PVOID)(offset - sizeof(HEAP_VIRTUAL_ALLOC_ENTRY)), &largeEntry, sizeof(HEAP_VIRTUAL_ALLOC_ENTRY), NULL)) {
 						hb->dwSize = largeEntry.CommitSize;
 						hb->dwFlags |= LARGE_BLOCK;
 						extra->unusedBytes = largeEntry.ReserveSize - largeEntry.CommitSize;
@@ -1190,11 +1225,11 @@ static PHeapBlock GetSingleBlock(RzDebug *dbg, ut64 offset) {
 				if (DecodeLFHEntry(dbg, &h, &entry, (PVOID)userBlocksOffset, NtLFHKey, entryOffset)) {
 					HEAP_USERDATA_HEADER UserBlocks;
 					HEAP_SUBSEGMENT subsegment;
-					if (!ReadProcessMemory(h_proc, (PVOID)userBlocksOffset, &UserBlocks, sizeof(HEAP_USERDATA_HEADER), NULL)) {
+					if (!ReadHeapMemory(dbg, h_proc, (PVOID)userBlocksOffset, &UserBlocks, sizeof(HEAP_USERDATA_HEADER), NULL)) {
 						rz_sys_perror("GetSingleBlock/ReadProcessMemory");
 						continue;
 					}
-					if (!ReadProcessMemory(h_proc, (PVOID)UserBlocks.SubSegment, &subsegment, sizeof(HEAP_SUBSEGMENT), NULL)) {
+					if (!ReadHeapMemory(dbg, h_proc, (PVOID)UserBlocks.SubSegment, &subsegment, sizeof(HEAP_SUBSEGMENT), NULL)) {
 						continue;
 					}
 					hb->dwAddress = offset;
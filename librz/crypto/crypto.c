@@ -204,3 +204,15 @@ RZ_API const ut8 *rz_crypto_get_output(RzCrypto *cry, int *size) {
 	}
 	return cry->output;
 }
+
+/**
+ * \brief Drops the output produced so far, keeping its buffer for the next updates
+ *
+ * Lets a caller consume the output of rz_crypto_get_output() after each
+ * rz_crypto_update(), so that data of any size can be processed in
+ * constant memory.
+ */
+RZ_API void rz_crypto_clear_output(RZ_NONNULL RzCrypto *cry) {
+	rz_return_if_fail(cry);
+	cry->output_len = 0;
+}
@@ -6,16 +6,17 @@
 #include <rz_util.h>
 #include <aes.h>
 
-static void encryptaes(struct aes_ctx *ctx, ut8 *in, ut8 *out) {
+// \p len must be a multiple of AES_BLOCK_SIZE
+static void encryptaes(struct aes_ctx *ctx, size_t len, const ut8 *in, ut8 *out) {
 	switch (ctx->key_size) {
 	case AES128_KEY_SIZE:
-		aes128_encrypt(&ctx->u.ctx128, AES_BLOCK_SIZE, out, in);
+		aes128_encrypt(&ctx->u.ctx128, len, out, in);
 		break;
 	case AES192_KEY_SIZE:
-		aes192_encrypt(&ctx->u.ctx192, AES_BLOCK_SIZE, out, in);
+		aes192_encrypt(&ctx->u.ctx192, len, out, in);
 		break;
 	case AES256_KEY_SIZE:
-		aes256_encrypt(&ctx->u.ctx256, AES_BLOCK_SIZE, out, in);
+		aes256_encrypt(&ctx->u.ctx256, len, out, in);
 		break;
 	default:
 		rz_warn_if_reached();
@@ -23,16 +24,17 @@ static void encryptaes(struct aes_ctx *ctx, ut8 *in, ut8 *out) {
 	}
 }
 
-static void decryptaes(struct aes_ctx *ctx, ut8 *in, ut8 *out) {
+// \p len must be a multiple of AES_BLOCK_SIZE
+static void decryptaes(struct aes_ctx *ctx, size_t len, const ut8 *in, ut8 *out) {
 	switch (ctx->key_size) {
 	case AES128_KEY_SIZE:
-		aes128_decrypt(&ctx->u.ctx128, AES_BLOCK_SIZE, out, in);
+		aes128_decrypt(&ctx->u.ctx128, len, out, in);
 		break;
 	case AES192_KEY_SIZE:
-		aes192_decrypt(&ctx->u.ctx192, AES_BLOCK_SIZE, out, in);
+		aes192_decrypt(&ctx->u.ctx192, len, out, in);
 		break;
 	case AES256_KEY_SIZE:
-		aes256_decrypt(&ctx->u.ctx256, AES_BLOCK_SIZE, out, in);
+		aes256_decrypt(&ctx->u.ctx256, len, out, in);
 		break;
 	default:
 		rz_warn_if_reached();
@@ -100,43 +102,34 @@ static bool update(RzCrypto *cry, const ut8 *buf, int len) {
 	// Pad to the block size, do not append dummy block
 	const int diff = (AES_BLOCK_SIZE - (len % AES_BLOCK_SIZE)) % AES_BLOCK_SIZE;
 	const int size = len + diff;
-	const int blocks = size / AES_BLOCK_SIZE;
-	int i;
+	const int full = len - (len % AES_BLOCK_SIZE);
 
-	ut8 *const obuf = calloc(1, size);
+	ut8 *const obuf = malloc(size);
 	if (!obuf) {
 		return false;
 	}
-	ut8 *const ibuf = calloc(1, size);
-	if (!ibuf) {
-		free(obuf);
-		return false;
-	}
-
-	memset(ibuf, 0, size);
-	memcpy(ibuf, buf, len);
 	// Padding should start like 100000...
+	ut8 last[AES_BLOCK_SIZE] = { 0 };
 	if (diff) {
-		ibuf[len] = 8; // 0b1000;
+		memcpy(last, buf + full, len - full);
+		last[len - full] = 8; // 0b1000;
 	}
 
+	// all the whole blocks go through in a single call
 	if (cry->dir == RZ_CRYPTO_DIR_ENCRYPT) {
-		for (i = 0; i < blocks; i++) {
-			const int delta = AES_BLOCK_SIZE * i;
-			encryptaes(st, ibuf + delta, obuf + delta);
+		encryptaes(st, full, buf, obuf);
+		if (diff) {
+			encryptaes(st, AES_BLOCK_SIZE, last, obuf + full);
 		}
 	} else {
-		for (i = 0; i < blocks; i++) {
-			const int delta = AES_BLOCK_SIZE * i;
-			decryptaes(st, ibuf + delta, obuf + delta);
+		decryptaes(st, full, buf, obuf);
+		if (diff) {
+			decryptaes(st, AES_BLOCK_SIZE, last, obuf + full);
 		}
 	}
 
-	// printf("%128s\n", obuf);
-
 	rz_crypto_append(cry, obuf, size);
 	free(obuf);
-	free(ibuf);
 	return true;
 }
 
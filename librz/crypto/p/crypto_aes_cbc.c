@@ -12,16 +12,17 @@ typedef struct aes_cbc_context_t {
 	ut8 iv[32];
 } AesCbcCtx;
 
-static void encryptaes(struct aes_ctx *ctx, ut8 *in, ut8 *out) {
+// \p len must be a multiple of AES_BLOCK_SIZE
+static void encryptaes(struct aes_ctx *ctx, size_t len, const ut8 *in, ut8 *out) {
 	switch (ctx->key_size) {
 	case AES128_KEY_SIZE:
-		aes128_encrypt(&ctx->u.ctx128, AES_BLOCK_SIZE, out, in);
+		aes128_encrypt(&ctx->u.ctx128, len, out, in);
 		break;
 	case AES192_KEY_SIZE:
-		aes192_encrypt(&ctx->u.ctx192, AES_BLOCK_SIZE, out, in);
+		aes192_encrypt(&ctx->u.ctx192, len, out, in);
 		break;
 	case AES256_KEY_SIZE:
-		aes256_encrypt(&ctx->u.ctx256, AES_BLOCK_SIZE, out, in);
+		aes256_encrypt(&ctx->u.ctx256, len, out, in);
 		break;
 	default:
 		rz_warn_if_reached();
@@ -29,16 +30,17 @@ static void encryptaes(struct aes_ctx *ctx, ut8 *in, ut8 *out) {
 	}
 }
 
-static void decryptaes(struct aes_ctx *ctx, ut8 *in, ut8 *out) {
+// \p len must be a multiple of AES_BLOCK_SIZE
+static void decryptaes(struct aes_ctx *ctx, size_t len, const ut8 *in, ut8 *out) {
 	switch (ctx->key_size) {
 	case AES128_KEY_SIZE:
-		aes128_decrypt(&ctx->u.ctx128, AES_BLOCK_SIZE, out, in);
+		aes128_decrypt(&ctx->u.ctx128, len, out, in);
 		break;
 	case AES192_KEY_SIZE:
-		aes192_decrypt(&ctx->u.ctx192, AES_BLOCK_SIZE, out, in);
+		aes192_decrypt(&ctx->u.ctx192, len, out, in);
 		break;
 	case AES256_KEY_SIZE:
-		aes256_decrypt(&ctx->u.ctx256, AES_BLOCK_SIZE, out, in);
+		aes256_decrypt(&ctx->u.ctx256, len, out, in);
 		break;
 	default:
 		rz_warn_if_reached();
@@ -124,40 +126,40 @@ static bool update(RzCrypto *cry, const ut8 *buf, int len) {
 	const int size = len + diff;
 	const int blocks = size / AES_BLOCK_SIZE;
 
-	ut8 *const obuf = calloc(1, size);
+	ut8 *const obuf = malloc(size);
 	if (!obuf) {
 		return false;
 	}
-
-	ut8 *const ibuf = calloc(1, size);
+	ut8 *const ibuf = malloc(size);
 	if (!ibuf) {
 		free(obuf);
 		return false;
 	}
 
-	memset(ibuf, 0, size);
 	memcpy(ibuf, buf, len);
-
 	if (diff) {
+		memset(ibuf + len, 0, diff);
 		ibuf[len] = 8; // 0b1000;
 	}
 
 	int i, j;
 	if (cry->dir == RZ_CRYPTO_DIR_ENCRYPT) {
+		// each block depends on the previous ciphertext
 		for (i = 0; i < blocks; i++) {
 			for (j = 0; j < AES_BLOCK_SIZE; j++) {
 				ibuf[i * AES_BLOCK_SIZE + j] ^= ctx->iv[j];
 			}
-			encryptaes(&ctx->st, ibuf + AES_BLOCK_SIZE * i, obuf + AES_BLOCK_SIZE * i);
+			encryptaes(&ctx->st, AES_BLOCK_SIZE, ibuf + AES_BLOCK_SIZE * i, obuf + AES_BLOCK_SIZE * i);
 			memcpy(ctx->iv, obuf + AES_BLOCK_SIZE * i, AES_BLOCK_SIZE);
 		}
 	} else {
+		// the ciphertext is all known, so the blocks are decrypted at once
+		decryptaes(&ctx->st, size, ibuf, obuf);
 		for (i = 0; i < blocks; i++) {
-			decryptaes(&ctx->st, ibuf + AES_BLOCK_SIZE * i, obuf + AES_BLOCK_SIZE * i);
 			for (j = 0; j < AES_BLOCK_SIZE; j++) {
 				obuf[i * AES_BLOCK_SIZE + j] ^= ctx->iv[j];
 			}
-			memcpy(ctx->iv, buf + AES_BLOCK_SIZE * i, AES_BLOCK_SIZE);
+			memcpy(ctx->iv, ibuf + AES_BLOCK_SIZE * i, AES_BLOCK_SIZE);
 		}
 	}
 
@@ -0,0 +1,245 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_debug.h>
+
+/*
+ * Block coverage mode: every analysed basic block gets a trap written over
+ * its first instruction. A block hitting its trap gets its original bytes
+ * back and the target continues right away, so each block stops the target
+ * at most once and the rest of the run goes at native speed.
+ *
+ * Unlike breakpoints the traps are not removed while the target is stopped.
+ */
+
+RZ_IPI bool rz_debug_coverage_hit(RzDebug *dbg, RzRegItem *pc_ri, ut64 pc);
+
+#define COVERAGE_PAGE_SIZE 0x1000
+
+static int block_cmp(ut64 addr, void *a) {
+	RzDebugCoverageBlock *b = a;
+	return RZ_NUM_CMP(addr, b->addr);
+}
+
+static void coverage_free(RzDebugCoverage *cov) {
+	if (!cov) {
+		return;
+	}
+	rz_vector_fini(&cov->blocks);
+	free(cov);
+}
+
+static bool collect_blocks(RzDebug *dbg, RzDebugCoverage *cov) {
+	RBIter iter;
+	RzAnalysisBlock *block;
+	ut64 next_free = 0;
+	// bb_tree is sorted by address, so the blocks vector is too
+	rz_rbtree_foreach (dbg->analysis->bb_tree, iter, block, RzAnalysisBlock, _rb) {
+		if (!block->size || block->addr < next_free) {
+			// would overlap the trap of the previous block
+			continue;
+		}
+		int trap_size = rz_bp_size_at(dbg->bp, block->addr);
+		if (trap_size < 1 || trap_size > RZ_DEBUG_COVERAGE_TRAP_MAX || trap_size > block->size) {
+			continue;
+		}
+		if (rz_bp_get_in(dbg->bp, block->addr, 0) || rz_bp_get_in(dbg->bp, block->addr + trap_size - 1, 0)) {
+			// leave it to the breakpoint
+			continue;
+		}
+		RzDebugCoverageBlock *b = rz_vector_push(&cov->blocks, NULL);
+		if (!b) {
+			return false;
+		}
+		memset(b, 0, sizeof(*b));
+		b->addr = block->addr;
+		b->size = (ut32)block->size;
+		b->trap_size = trap_size;
+		next_free = block->addr + trap_size;
+	}
+	return true;
+}
+
+/*
+ * Arm the blocks [first, last] which all lie in the same page with a single
+ * read and a single write of the range they span.
+ */
+static bool arm_page(RzDebug *dbg, RzDebugCoverage *cov, size_t first, size_t last) {
+	RzDebugCoverageBlock *lo = rz_vector_index_ptr(&cov->blocks, first);
+	RzDebugCoverageBlock *hi = rz_vector_index_ptr(&cov->blocks, last);
+	ut64 from = lo->addr;
+	ut64 len = hi->addr + hi->trap_size - from;
+	ut8 *buf = malloc(len);
+	if (!buf) {
+		return false;
+	}
+	if (!dbg->iob.read_at(dbg->iob.io, from, buf, len)) {
+		free(buf);
+		return false;
+	}
+	for (size_t i = first; i <= last; i++) {
+		RzDebugCoverageBlock *b = rz_vector_index_ptr(&cov->blocks, i);
+		ut8 *at = buf + (b->addr - from);
+		memcpy(b->orig, at, b->trap_size);
+		if (rz_bp_get_bytes(dbg->bp, b->addr, at, b->trap_size) != b->trap_size) {
+			free(buf);
+			return false;
+		}
+	}
+	bool ret = dbg->iob.write_at(dbg->iob.io, from, buf, len);
+	free(buf);
+	return ret;
+}
+
+/**
+ * \brief Start collecting the block coverage of the target
+ *
+ * Writes a one-shot trap at the start of every basic block known to the
+ * analysis, except the ones already holding a breakpoint. The traps are
+ * handled inside of rz_debug_wait() and never reported as breakpoints.
+ */
+RZ_API bool rz_debug_coverage_start(RZ_NONNULL RzDebug *dbg) {
+	rz_return_val_if_fail(dbg, false);
+	if (!dbg->analysis || !dbg->iob.read_at || !dbg->iob.write_at || rz_debug_is_dead(dbg)) {
+		return false;
+	}
+	if (dbg->coverage) {
+		rz_debug_coverage_stop(dbg);
+	}
+	RzDebugCoverage *cov = RZ_NEW0(RzDebugCoverage);
+	if (!cov) {
+		return false;
+	}
+	rz_vector_init(&cov->blocks, sizeof(RzDebugCoverageBlock), NULL, NULL);
+	if (!collect_blocks(dbg, cov)) {
+		coverage_free(cov);
+		return false;
+	}
+	size_t count = rz_vector_len(&cov->blocks);
+	size_t first = 0;
+	for (size_t i = 0; i < count; i++) {
+		RzDebugCoverageBlock *b = rz_vector_index_ptr(&cov->blocks, i);
+		RzDebugCoverageBlock *next = i + 1 < count ? rz_vector_index_ptr(&cov->blocks, i + 1) : NULL;
+		ut64 page = b->addr / COVERAGE_PAGE_SIZE;
+		if (next && (next->addr + next->trap_size - 1) / COVERAGE_PAGE_SIZE == page) {
+			continue;
+		}
+		if (!arm_page(dbg, cov, first, i)) {
+			// blocks of unreadable or unwritable pages stay uncovered
+			for (size_t j = first; j <= i; j++) {
+				RzDebugCoverageBlock *u = rz_vector_index_ptr(&cov->blocks, j);
+				u->trap_size = 0;
+			}
+		}
+		first = i + 1;
+	}
+	dbg->coverage = cov;
+	return true;
+}
+
+/**
+ * \brief Stop collecting the block coverage, removing the traps of the blocks not hit yet
+ */
+RZ_API bool rz_debug_coverage_stop(RZ_NONNULL RzDebug *dbg) {
+	rz_return_val_if_fail(dbg, false);
+	RzDebugCoverage *cov = dbg->coverage;
+	if (!cov) {
+		return false;
+	}
+	bool ret = true;
+	if (!rz_debug_is_dead(dbg)) {
+		RzDebugCoverageBlock *b;
+		rz_vector_foreach(&cov->blocks, b) {
+			if (!b->hit && b->trap_size) {
+				ret &= dbg->iob.write_at(dbg->iob.io, b->addr, b->orig, b->trap_size);
+			}
+		}
+	}
+	coverage_free(cov);
+	dbg->coverage = NULL;
+	return ret;
+}
+
+/**
+ * \brief Get which blocks were hit, bit i is set if the i-th block of RzDebugCoverage.blocks was executed
+ */
+RZ_API RZ_OWN RzBitmap *rz_debug_coverage_bitmap(RZ_NONNULL RzDebug *dbg) {
+	rz_return_val_if_fail(dbg, NULL);
+	RzDebugCoverage *cov = dbg->coverage;
+	if (!cov) {
+		return NULL;
+	}
+	RzBitmap *bm = rz_bitmap_new(RZ_MAX(rz_vector_len(&cov->blocks), 1));
+	if (!bm) {
+		return NULL;
+	}
+	size_t i = 0;
+	RzDebugCoverageBlock *b;
+	rz_vector_foreach(&cov->blocks, b) {
+		if (b->hit) {
+			rz_bitmap_set(bm, i);
+		}
+		i++;
+	}
+	return bm;
+}
+
+// the armed block whose trap ends at pc, or starts at it for targets leaving the pc on the trap
+static RzDebugCoverageBlock *coverage_trap_at(RzDebugCoverage *cov, ut64 pc) {
+	ut64 from = pc > RZ_DEBUG_COVERAGE_TRAP_MAX ? pc - RZ_DEBUG_COVERAGE_TRAP_MAX : 0;
+	size_t i;
+	rz_vector_lower_bound(&cov->blocks, from, i, block_cmp);
+	for (; i < rz_vector_len(&cov->blocks); i++) {
+		RzDebugCoverageBlock *b = rz_vector_index_ptr(&cov->blocks, i);
+		if (b->addr > pc) {
+			break;
+		}
+		if (b->trap_size && (b->addr + b->trap_size == pc || b->addr == pc)) {
+			return b;
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Called on breakpoint stops while the coverage mode is on. Returns true if
+ * the stop was caused by a coverage trap, which is then removed with the pc
+ * moved back to the start of its block.
+ */
+RZ_IPI bool rz_debug_coverage_hit(RzDebug *dbg, RzRegItem *pc_ri, ut64 pc) {
+	RzDebugCoverage *cov = dbg->coverage;
+	RzDebugCoverageBlock *b = coverage_trap_at(cov, pc);
+	if (!b) {
+		return false;
+	}
+	RzBreakpointItem *bpi = rz_bp_get_at(dbg->bp, b->addr);
+	if (b->hit) {
+		// a trap already removed can still be reported by another thread that hit it at the same time
+		if (bpi || pc == b->addr) {
+			return false;
+		}
+	} else if (bpi) {
+		// a breakpoint placed over the trap later saved the trap as the original bytes
+		if (bpi->obytes && bpi->size >= b->trap_size) {
+			memcpy(bpi->obytes, b->orig, b->trap_size);
+		}
+		b->hit = true;
+		cov->hits++;
+		return false;
+	} else {
+		if (!dbg->iob.write_at(dbg->iob.io, b->addr, b->orig, b->trap_size)) {
+			return false;
+		}
+		b->hit = true;
+		cov->hits++;
+		if (dbg->trace->enabled) {
+			rz_debug_trace_add(dbg, b->addr, b->size);
+		}
+	}
+	if (pc != b->addr) {
+		if (!rz_reg_set_value(dbg->reg, pc_ri, b->addr) || !rz_debug_reg_sync(dbg, RZ_REG_TYPE_GPR, true)) {
+			return false;
+		}
+	}
+	return true;
+}
@@ -12,6 +12,22 @@
 
 RZ_LIB_VERSION(rz_debug);
 
+RZ_IPI bool rz_debug_coverage_hit(RzDebug *dbg, RzRegItem *pc_ri, ut64 pc);
+
+static void async_end(RzDebug *dbg) {
+	rz_th_wait(dbg->async_waiter);
+	rz_th_free(dbg->async_waiter);
+	dbg->async_waiter = NULL;
+}
+
+static bool async_check_stopped(RzDebug *dbg) {
+	if (dbg->async_waiter) {
+		RZ_LOG_ERROR("The target is running, wait for it to stop first\n");
+		return false;
+	}
+	return true;
+}
+
 // Size of the lookahead buffers used in rz_debug functions
 #define DBG_BUF_SIZE 512
 
@@ -42,7 +58,7 @@ RZ_API void rz_debug_bp_update(RzDebug *dbg) {
 	RzListIter *iter;
 	rz_list_foreach (dbg->bp->bps, iter, bp) {
 		if (bp->expr) {
-			bp->addr = dbg->corebind.numGet(dbg->corebind.core, bp->expr);
+			rz_bp_item_set_addr(dbg->bp, bp, dbg->corebind.numGet(dbg->corebind.core, bp->expr));
 		}
 	}
 }
@@ -415,6 +431,14 @@ RZ_API void rz_debug_tracenodes_reset(RzDebug *dbg) {
 
 RZ_API RzDebug *rz_debug_free(RzDebug *dbg) {
 	if (dbg) {
+		if (dbg->async_waiter) {
+			rz_debug_stop(dbg);
+			async_end(dbg);
+		}
+		rz_atomic_bool_free(dbg->async_stopped);
+		if (dbg->trace && dbg->trace->branches && dbg->cur && dbg->cur->branch_trace) {
+			dbg->cur->branch_trace(dbg, false);
+		}
 		rz_hash_free(dbg->hash);
 		rz_bp_free(dbg->bp);
 		free(dbg->snap_path);
@@ -429,11 +453,18 @@ RZ_API RzDebug *rz_debug_free(RzDebug *dbg) {
 		rz_list_free(dbg->call_frames);
 		free(dbg->btalgo);
 		rz_debug_trace_free(dbg->trace);
+		if (dbg->coverage) {
+			rz_vector_fini(&dbg->coverage->blocks);
+			free(dbg->coverage);
+		}
 		rz_debug_session_free(dbg->session);
 		rz_analysis_op_free(dbg->cur_op);
 		dbg->trace = NULL;
 		rz_egg_free(dbg->egg);
 		rz_reg_free(dbg->reg);
+		for (int i = 0; i < RZ_REG_TYPE_LAST; i++) {
+			free(dbg->reg_synced[i]);
+		}
 		free(dbg->arch);
 		free(dbg->glob_libs);
 		free(dbg->glob_unlibs);
@@ -445,6 +476,7 @@ RZ_API RzDebug *rz_debug_free(RzDebug *dbg) {
 RZ_API int rz_debug_attach(RzDebug *dbg, int pid) {
 	int ret = false;
 	if (dbg && dbg->cur && dbg->cur->attach) {
+		rz_debug_reg_invalidate(dbg);
 		ret = dbg->cur->attach(dbg, pid);
 		if (ret != -1) {
 			dbg->reason.type = RZ_DEBUG_REASON_NONE; // after a successful attach, the process is not dead
@@ -582,7 +614,14 @@ RZ_API int rz_debug_start(RzDebug *dbg, const char *cmd) {
 
 RZ_API int rz_debug_detach(RzDebug *dbg, int pid) {
 	int ret = 0;
+	if (dbg->async_waiter) {
+		// a running thread cannot be detached
+		rz_debug_stop(dbg);
+		async_end(dbg);
+		rz_debug_wait(dbg, NULL);
+	}
 	if (dbg->cur && dbg->cur->detach) {
+		rz_debug_reg_invalidate(dbg);
 		ret = dbg->cur->detach(dbg, pid);
 		if (dbg->pid == pid) {
 			dbg->pid = -1;
@@ -608,6 +647,7 @@ RZ_API bool rz_debug_select(RzDebug *dbg, int pid, int tid) {
 		eprintf("= attach %d %d\n", pid, tid);
 	}
 
+	rz_debug_reg_invalidate(dbg);
 	if (dbg->cur && dbg->cur->select && !dbg->cur->select(dbg, pid, tid)) {
 		return false;
 	}
@@ -621,6 +661,10 @@ RZ_API bool rz_debug_select(RzDebug *dbg, int pid, int tid) {
 	}
 
 	rz_io_system(dbg->iob.io, sdb_fmt("pid %d", dbg->tid));
+	if (dbg->trace->branches && (dbg->tid != prev_tid || dbg->pid != prev_pid)) {
+		// branches are recorded per thread
+		rz_debug_trace_branches(dbg, true);
+	}
 
 	// Synchronize with the current thread's data
 	if (dbg->corebind.core) {
@@ -663,6 +707,7 @@ RZ_API const char *rz_debug_reason_to_string(int type) {
 	case RZ_DEBUG_REASON_FPU: return "fpu";
 	case RZ_DEBUG_REASON_STEP: return "step";
 	case RZ_DEBUG_REASON_USERSUSP: return "suspended-by-user";
+	case RZ_DEBUG_REASON_COVERAGE: return "coverage";
 	}
 	return "unhandled";
 }
@@ -699,8 +744,12 @@ RZ_API RzDebugReasonType rz_debug_wait(RzDebug *dbg, RzBreakpointItem **bp) {
 
 	/* if our debugger plugin has wait */
 	if (dbg->cur && dbg->cur->wait) {
+		rz_debug_reg_invalidate(dbg);
 		reason = dbg->cur->wait(dbg, dbg->pid);
 		if (reason == RZ_DEBUG_REASON_DEAD) {
+			if (dbg->trace->branches) {
+				rz_debug_trace_branches_collect(dbg);
+			}
 			eprintf("\n==> Process finished\n\n");
 			RzEventDebugProcessFinished event = {
 				.pid = dbg->pid
@@ -729,6 +778,9 @@ RZ_API RzDebugReasonType rz_debug_wait(RzDebug *dbg, RzBreakpointItem **bp) {
 		if (!rz_debug_reg_sync(dbg, RZ_REG_TYPE_GPR, false)) {
 			return RZ_DEBUG_REASON_ERROR;
 		}
+		if (dbg->trace->branches) {
+			rz_debug_trace_branches_collect(dbg);
+		}
 
 		bool libs_bp = (dbg->glob_libs || dbg->glob_unlibs) ? true : false;
 		/* if the underlying stop reason is a breakpoint, call the handlers */
@@ -749,6 +801,11 @@ RZ_API RzDebugReasonType rz_debug_wait(RzDebug *dbg, RzBreakpointItem **bp) {
 			/* get the value */
 			pc = rz_reg_get_value(dbg->reg, pc_ri);
 
+			if (dbg->coverage && reason == RZ_DEBUG_REASON_BREAKPOINT && rz_debug_coverage_hit(dbg, pc_ri, pc)) {
+				dbg->reason.type = RZ_DEBUG_REASON_COVERAGE;
+				return RZ_DEBUG_REASON_COVERAGE;
+			}
+
 			if (!rz_debug_bp_hit(dbg, pc_ri, pc, &b)) {
 				return RZ_DEBUG_REASON_ERROR;
 			}
@@ -928,6 +985,7 @@ RZ_API int rz_debug_step_hard(RzDebug *dbg, RzBreakpointItem **pb) {
 		}
 	}
 
+	rz_debug_reg_invalidate(dbg);
 	if (!dbg->cur->step(dbg)) {
 		return false;
 	}
@@ -968,7 +1026,7 @@ RZ_API int rz_debug_step(RzDebug *dbg, int steps) {
 		steps = 1;
 	}
 
-	if (!dbg || !dbg->cur) {
+	if (!dbg || !dbg->cur || !async_check_stopped(dbg)) {
 		return steps_taken;
 	}
 
@@ -1051,6 +1109,7 @@ RZ_API int rz_debug_step_over(RzDebug *dbg, int steps) {
 				dbg->session->maxcnum++;
 				rz_debug_trace_ins_before(dbg);
 			}
+			rz_debug_reg_invalidate(dbg);
 			if (!dbg->cur->step_over(dbg)) {
 				return steps_taken;
 			}
@@ -1138,13 +1197,37 @@ RZ_API int rz_debug_step_cnum(RzDebug *dbg, int steps) {
 	return steps;
 }
 
-RZ_API int rz_debug_continue_kill(RzDebug *dbg, int sig) {
+static void *async_wait_thread(void *user) {
+	RzDebug *dbg = user;
+	dbg->cur->wait_async(dbg, dbg->pid);
+	rz_atomic_bool_set(dbg->async_stopped, true);
+	return NULL;
+}
+
+static bool async_begin(RzDebug *dbg) {
+	if (!dbg->async_stopped && !(dbg->async_stopped = rz_atomic_bool_new(false))) {
+		return false;
+	}
+	rz_atomic_bool_set(dbg->async_stopped, false);
+	dbg->async_waiter = rz_th_new(async_wait_thread, dbg);
+	return dbg->async_waiter;
+}
+
+/*
+ * Resume the target and handle its stop like continuing wants to.
+ *
+ * async: return as soon as the target runs, the stop is handled later by
+ * calling this again with collect set.
+ */
+static int debug_continue(RzDebug *dbg, int sig, bool async, bool collect) {
 	RzDebugReasonType reason = RZ_DEBUG_REASON_NONE;
 	int ret = 0;
 	RzBreakpointItem *bp = NULL;
 
-	if (!dbg) {
-		return 0;
+	if (collect) {
+		ret = dbg->tid;
+		reason = rz_debug_wait(dbg, &bp);
+		goto stopped;
 	}
 
 	// If the debugger is not at the end of the changes
@@ -1191,13 +1274,19 @@ repeat:
 			return 0;
 		}
 		/* tell the inferior to go! */
+		rz_debug_reg_invalidate(dbg);
 		ret = dbg->cur->cont(dbg, dbg->pid, dbg->tid, sig);
+		if (async && async_begin(dbg)) {
+			return dbg->tid;
+		}
 		// XXX(jjd): why? //dbg->reason.signum = 0;
 		reason = rz_debug_wait(dbg, &bp);
 	} else {
 		return 0;
 	}
 
+stopped:
+
 	if (dbg->corebind.core) {
 		RzCore *core = (RzCore *)dbg->corebind.core;
 		RzNum *num = core->num;
@@ -1210,6 +1299,9 @@ repeat:
 			}
 		}
 	}
+	if (reason == RZ_DEBUG_REASON_COVERAGE && !rz_cons_is_breaked()) {
+		goto repeat;
+	}
 	if (reason == RZ_DEBUG_REASON_BREAKPOINT &&
 		((bp && !bp->enabled) || (!bp && !rz_cons_is_breaked() && dbg->corebind.core && dbg->corebind.cfggeti(dbg->corebind.core, "dbg.bpsysign")))) {
 		goto repeat;
@@ -1329,10 +1421,87 @@ repeat:
 	return ret;
 }
 
+RZ_API int rz_debug_continue_kill(RzDebug *dbg, int sig) {
+	if (!dbg || !async_check_stopped(dbg)) {
+		return 0;
+	}
+	return debug_continue(dbg, sig, false, false);
+}
+
 RZ_API int rz_debug_continue(RzDebug *dbg) {
 	return rz_debug_continue_kill(dbg, 0); // dbg->reason.signum);
 }
 
+/**
+ * \brief Resume the target without waiting for it to stop
+ *
+ * A thread waits for the stop in the background, which is then handled on
+ * the calling thread by rz_debug_async_collect(). Until then, everything
+ * talking to the stopped target, like the registers, fails.
+ *
+ * \return false if the backend cannot wait in the background, the caller should continue synchronously then
+ */
+RZ_API bool rz_debug_continue_async(RZ_NONNULL RzDebug *dbg) {
+	rz_return_val_if_fail(dbg, false);
+	if (!async_check_stopped(dbg) || rz_debug_is_dead(dbg)) {
+		return false;
+	}
+	if (!dbg->cur || !dbg->cur->wait_async || !dbg->cur->cont ||
+		(dbg->session && (dbg->trace_continue || dbg->session->cnum != dbg->session->maxcnum))) {
+		return false;
+	}
+	debug_continue(dbg, 0, true, false);
+	return true;
+}
+
+/**
+ * \brief Check whether the target was resumed by rz_debug_continue_async() and its stop was not collected yet
+ */
+RZ_API bool rz_debug_is_running(RZ_NONNULL RzDebug *dbg) {
+	rz_return_val_if_fail(dbg, false);
+	return dbg->async_waiter;
+}
+
+/**
+ * \brief Check whether the target resumed by rz_debug_continue_async() stopped
+ */
+RZ_API bool rz_debug_async_stopped(RZ_NONNULL RzDebug *dbg) {
+	rz_return_val_if_fail(dbg, false);
+	return dbg->async_waiter && rz_atomic_bool_get(dbg->async_stopped);
+}
+
+static void async_break(void *user) {
+	rz_debug_stop(user);
+}
+
+/**
+ * \brief Handle the stop of the target resumed by rz_debug_continue_async()
+ *
+ * Must be called from the thread that resumed the target. Stops that
+ * continuing skips, like disabled breakpoints, resume the target again in
+ * the background.
+ *
+ * \param block wait for the stop, the target is interrupted on break
+ * \return true if the target is stopped now
+ */
+RZ_API bool rz_debug_async_collect(RZ_NONNULL RzDebug *dbg, bool block) {
+	rz_return_val_if_fail(dbg, false);
+	if (!dbg->async_waiter) {
+		return true;
+	}
+	if (!block && !rz_atomic_bool_get(dbg->async_stopped)) {
+		return false;
+	}
+	rz_cons_break_push(async_break, dbg);
+	// let the other core tasks run meanwhile
+	void *bed = rz_cons_sleep_begin();
+	async_end(dbg);
+	rz_cons_sleep_end(bed);
+	rz_cons_break_pop();
+	debug_continue(dbg, 0, true, true);
+	return !dbg->async_waiter;
+}
+
 RZ_API int rz_debug_continue_pass_exception(RzDebug *dbg) {
 	return rz_debug_continue_kill(dbg, dbg->reason.signum);
 }
@@ -1537,6 +1706,7 @@ RZ_API int rz_debug_continue_syscalls(RzDebug *dbg, int *sc, int n_sc) {
 		 * return value after... */
 		rz_debug_step(dbg, 1);
 #endif
+		rz_debug_reg_invalidate(dbg);
 		dbg->cur->contsc(dbg, dbg->pid, 0); // TODO handle return value
 		// wait until continuation
 		reason = rz_debug_wait(dbg, NULL);
@@ -1583,6 +1753,7 @@ RZ_API int rz_debug_continue_syscall(RzDebug *dbg, int sc) {
 RZ_API int rz_debug_syscall(RzDebug *dbg, int num) {
 	bool ret = true;
 	if (dbg->cur->contsc) {
+		rz_debug_reg_invalidate(dbg);
 		ret = dbg->cur->contsc(dbg, dbg->pid, num);
 	}
 	eprintf("TODO: show syscall information\n");
@@ -1601,7 +1772,13 @@ RZ_API int rz_debug_kill(RzDebug *dbg, int pid, int tid, int sig) {
 	}
 	if (dbg->cur && dbg->cur->kill) {
 		if (pid > 0) {
-			return dbg->cur->kill(dbg, pid, tid, sig);
+			rz_debug_reg_invalidate(dbg);
+			int ret = dbg->cur->kill(dbg, pid, tid, sig);
+			if (dbg->async_waiter) {
+				// the signal stops a traced target
+				rz_debug_async_collect(dbg, true);
+			}
+			return ret;
 		}
 		return -1;
 	}
@@ -1743,7 +1920,7 @@ RZ_API void rz_debug_bp_rebase(RzDebug *dbg, ut64 old_base, ut64 new_base) {
 
 	// update bp's address
 	rz_list_foreach (dbg->bp->bps, iter, bp) {
-		bp->addr += diff;
+		rz_bp_item_set_addr(dbg->bp, bp, bp->addr + diff);
 		bp->delta = bp->addr - dbg->bp->baddr;
 	}
 }
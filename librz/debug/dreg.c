@@ -6,6 +6,46 @@
 #include <rz_cons.h>
 #include <rz_reg.h>
 
+static inline bool reg_type_fresh(RzDebug *dbg, int type) {
+	return dbg->reg_valid & (1u << type);
+}
+
+// takes ownership of buf, which holds the bytes of the arena now matching the target
+static void reg_type_synced(RzDebug *dbg, int type, ut8 *buf, int size) {
+	free(dbg->reg_synced[type]);
+	dbg->reg_synced[type] = buf;
+	dbg->reg_synced_size[type] = size;
+	dbg->reg_valid |= 1u << type;
+}
+
+static bool reg_type_modified(RzDebug *dbg, int type, const ut8 *buf, int size) {
+	return !reg_type_fresh(dbg, type) || dbg->reg_synced_size[type] != size ||
+		memcmp(dbg->reg_synced[type], buf, size);
+}
+
+/**
+ * \brief Forget which register types match the target
+ *
+ * Must be called whenever the target may have changed its registers behind
+ * our back (it ran, another thread got selected, ...), so that the next
+ * rz_debug_reg_sync() in lazy mode (dbg.reglazy) fetches them again.
+ * Its memory may have changed too, so dbg->target_generation is bumped for
+ * the users caching it.
+ */
+RZ_API void rz_debug_reg_invalidate(RzDebug *dbg) {
+	rz_return_if_fail(dbg);
+	dbg->reg_valid = 0;
+	dbg->target_generation++;
+}
+
+/**
+ * \brief Transfer registers of \p type between the target and dbg->reg
+ *
+ * With dbg->reg_lazy set, reads skip the types that were already read since
+ * the target last ran and writes skip the types whose arena is unchanged since
+ * it was last exchanged with the target. A write of RZ_REG_TYPE_ANY also skips
+ * the types never read since the target ran, those can only hold stale values.
+ */
 RZ_API int rz_debug_reg_sync(RzDebug *dbg, int type, int write) {
 	int i, n, size;
 	if (!dbg || !dbg->reg || !dbg->cur) {
@@ -15,6 +55,10 @@ RZ_API int rz_debug_reg_sync(RzDebug *dbg, int type, int write) {
 	if (rz_debug_is_dead(dbg)) {
 		return false;
 	}
+	// ptrace only talks to stopped threads
+	if (dbg->async_waiter) {
+		return false;
+	}
 	// Check if the functions needed are available
 	if (write && !dbg->cur->reg_write) {
 		return false;
@@ -43,9 +87,19 @@ RZ_API int rz_debug_reg_sync(RzDebug *dbg, int type, int write) {
 			}
 		}
 	}
-	do {
+	// DO NOT BREAK RZ_REG_TYPE_ANY PLEASE
+	// Continue the synchronization or just stop if it was asked only for a single type of regs
+	int last = (type == RZ_REG_TYPE_ANY) ? RZ_REG_TYPE_LAST - 1 : i;
+	for (; i <= last; i++) {
 		if (write) {
 			ut8 *buf = rz_reg_get_bytes(dbg->reg, i, &size);
+			if (buf && dbg->reg_lazy) {
+				bool stale = type == RZ_REG_TYPE_ANY && !reg_type_fresh(dbg, i);
+				if (stale || !reg_type_modified(dbg, i, buf, size)) {
+					free(buf);
+					continue;
+				}
+			}
 			if (!buf || !dbg->cur->reg_write(dbg, i, buf, size)) {
 				if (i == RZ_REG_TYPE_GPR) {
 					eprintf("rz_debug_reg: error writing "
@@ -56,9 +110,18 @@ RZ_API int rz_debug_reg_sync(RzDebug *dbg, int type, int write) {
 					free(buf);
 					return false;
 				}
+				free(buf);
+				continue;
+			}
+			if (dbg->reg_lazy) {
+				reg_type_synced(dbg, i, buf, size);
+			} else {
+				free(buf);
 			}
-			free(buf);
 		} else {
+			if (dbg->reg_lazy && reg_type_fresh(dbg, i)) {
+				continue;
+			}
 			// int bufsize = RZ_MAX (1024, dbg->reg->size*2); // i know. its hacky
 			int bufsize = dbg->reg->size;
 			// int bufsize = dbg->reg->regset[i].arena->size;
@@ -72,39 +135,46 @@ RZ_API int rz_debug_reg_sync(RzDebug *dbg, int type, int write) {
 				// we need to check against zero because reg_read can return false
 				if (size > 0) {
 					rz_reg_set_bytes(dbg->reg, i, buf, size); // RZ_MIN (size, bufsize));
-					//		free (buf);
-					//		return true;
+					if (dbg->reg_lazy) {
+						int synced_size;
+						ut8 *synced = rz_reg_get_bytes(dbg->reg, i, &synced_size);
+						if (synced) {
+							reg_type_synced(dbg, i, synced, synced_size);
+						}
+					}
 				}
 				free(buf);
 			}
 		}
-		// DO NOT BREAK RZ_REG_TYPE_ANY PLEASE
-		//   break;
-		// Continue the synchronization or just stop if it was asked only for a single type of regs
-		i++;
-	} while ((type == RZ_REG_TYPE_ANY) && (i < RZ_REG_TYPE_LAST));
+	}
 	return true;
 }
 
+// the type to sync for ri, everything unless registers are fetched lazily
+static int reg_item_sync_type(RzDebug *dbg, RzRegItem *ri) {
+	return dbg->reg_lazy && ri ? ri->arena : RZ_REG_TYPE_ANY;
+}
+
 RZ_API int rz_debug_reg_set(struct rz_debug_t *dbg, const char *name, ut64 num) {
 	RzRegItem *ri = rz_reg_get_by_role_or_name(dbg->reg, name);
 	if (!ri) {
 		return false;
 	}
 	rz_reg_set_value(dbg->reg, ri, num);
-	rz_debug_reg_sync(dbg, RZ_REG_TYPE_ANY, true);
+	rz_debug_reg_sync(dbg, reg_item_sync_type(dbg, ri), true);
 	return true;
 }
 
 RZ_API ut64 rz_debug_reg_get(RzDebug *dbg, const char *name) {
-	rz_debug_reg_sync(dbg, RZ_REG_TYPE_ANY, false);
-	return rz_reg_getv_by_role_or_name(dbg->reg, name);
+	RzRegItem *ri = rz_reg_get_by_role_or_name(dbg->reg, name);
+	rz_debug_reg_sync(dbg, reg_item_sync_type(dbg, ri), false);
+	return ri ? rz_reg_get_value(dbg->reg, ri) : UT64_MAX;
 }
 
 RZ_API ut64 rz_debug_num_callback(RzNum *userptr, const char *str, int *ok) {
 	RzDebug *dbg = (RzDebug *)userptr;
-	rz_debug_reg_sync(dbg, RZ_REG_TYPE_ANY, false);
 	RzRegItem *ri = rz_reg_get_by_role_or_name(dbg->reg, str);
+	rz_debug_reg_sync(dbg, reg_item_sync_type(dbg, ri), false);
 	if (!ri) {
 		*ok = 0;
 		return UT64_MAX;
@@ -118,6 +188,7 @@ RZ_API bool rz_debug_reg_profile_sync(RzDebug *dbg) {
 		char *p = dbg->cur->reg_profile(dbg);
 		if (p) {
 			rz_reg_set_profile_string(dbg->reg, p);
+			rz_debug_reg_invalidate(dbg);
 			rz_debug_reg_sync(dbg, RZ_REG_TYPE_ANY, false);
 			free(p);
 		} else {
@@ -55,6 +55,26 @@ RZ_API RzDebugSession *rz_debug_session_new(void) {
 	return session;
 }
 
+static RzDebugSnap *checkpoint_find_snap(RzDebugCheckpoint *checkpoint, ut64 addr, ut32 size) {
+	RzListIter *iter;
+	RzDebugSnap *snap;
+	rz_list_foreach (checkpoint->snaps, iter, snap) {
+		if (snap->addr == addr && snap->size == size) {
+			return snap;
+		}
+	}
+	return NULL;
+}
+
+// the most recent snapshot of the range, whose unchanged pages a new one can share
+static RzDebugSnap *last_snap(RzVector *checkpoints, ut64 addr, ut32 size) {
+	if (rz_vector_empty(checkpoints)) {
+		return NULL;
+	}
+	RzDebugCheckpoint *last = rz_vector_tail(checkpoints);
+	return last->snaps ? checkpoint_find_snap(last, addr, size) : NULL;
+}
+
 RZ_API bool rz_debug_add_checkpoint(RzDebug *dbg) {
 	rz_return_val_if_fail(dbg->session, false);
 	size_t i;
@@ -79,7 +99,8 @@ RZ_API bool rz_debug_add_checkpoint(RzDebug *dbg) {
 	rz_debug_map_sync(dbg);
 	rz_list_foreach (dbg->maps, iter, map) {
 		if ((map->perm & RZ_PERM_RW) == RZ_PERM_RW) {
-			RzDebugSnap *snap = rz_debug_snap_map(dbg, map);
+			RzDebugSnap *prev = last_snap(dbg->session->checkpoints, map->addr, map->size);
+			RzDebugSnap *snap = rz_debug_snap_map_shared(dbg, map, prev);
 			if (snap) {
 				rz_list_append(checkpoint.snaps, snap);
 			}
@@ -136,7 +157,7 @@ static void _set_initial_memory(RzDebug *dbg) {
 	RzListIter *iter;
 	RzDebugSnap *snap;
 	rz_list_foreach (dbg->session->cur_chkpt->snaps, iter, snap) {
-		dbg->iob.write_at(dbg->iob.io, snap->addr, snap->data, snap->size);
+		rz_debug_snap_restore(dbg, snap);
 	}
 }
 
@@ -175,6 +196,10 @@ RZ_API void rz_debug_session_restore_reg_mem(RzDebug *dbg, ut32 cnum) {
 	dbg->session->cur_chkpt = _get_checkpoint_before(dbg->session, cnum);
 
 	// Restore registers
+	if (dbg->reg_lazy) {
+		// lazy writes skip the types not fetched since the last stop
+		rz_debug_reg_sync(dbg, RZ_REG_TYPE_ANY, false);
+	}
 	_restore_registers(dbg, cnum);
 	rz_debug_reg_sync(dbg, RZ_REG_TYPE_ANY, true);
 
@@ -301,6 +326,24 @@ static void serialize_memory(Sdb *db, HtUP *memory) {
 	ht_up_foreach(memory, serialize_memory_cb, db);
 }
 
+// "zdata" holds the deflated contents, "data" the raw ones when compression is unavailable
+static bool serialize_snap_data(PJ *j, RzDebugSnap *snap) {
+	ut8 *data = rz_debug_snap_data(snap);
+	if (!data) {
+		return false;
+	}
+	int zsize = 0;
+	ut8 *zdata = snap->size ? rz_deflate(data, snap->size, NULL, &zsize) : NULL;
+	char *edata = zdata ? sdb_encode(zdata, zsize) : sdb_encode(data, snap->size);
+	if (edata) {
+		pj_ks(j, zdata ? "zdata" : "data", edata);
+	}
+	free(edata);
+	free(zdata);
+	free(data);
+	return edata != NULL;
+}
+
 static void serialize_checkpoints(Sdb *db, RzVector *checkpoints) {
 	size_t i;
 	RzDebugCheckpoint *chkpt;
@@ -337,7 +380,7 @@ static void serialize_checkpoints(Sdb *db, RzVector *checkpoints) {
 
 		// Serialize RzDebugSnap to "snaps"
 		// {"name":<str>, "addr":<ut64>, "addr_end":<ut64>, "size":<ut64>,
-		//  "data":"<base64>", "perm":<int>, "user":<int>, "shared":<bool>}
+		//  "zdata":"<base64>", "perm":<int>, "user":<int>, "shared":<bool>}
 		pj_ka(j, "snaps");
 		rz_list_foreach (chkpt->snaps, iter, snap) {
 			pj_o(j);
@@ -345,13 +388,10 @@ static void serialize_checkpoints(Sdb *db, RzVector *checkpoints) {
 			pj_kn(j, "addr", snap->addr);
 			pj_kn(j, "addr_end", snap->addr_end);
 			pj_kn(j, "size", snap->size);
-			char *edata = sdb_encode((const void *)snap->data, snap->size);
-			if (!edata) {
+			if (!serialize_snap_data(j, snap)) {
 				pj_free(j);
 				return;
 			}
-			pj_ks(j, "data", edata);
-			free(edata);
 			pj_kn(j, "perm", snap->perm);
 			pj_kn(j, "user", snap->user);
 			pj_kb(j, "shared", snap->shared);
@@ -394,10 +434,12 @@ static void serialize_checkpoints(Sdb *db, RzVector *checkpoints) {
  *
  * RzDebugSnap JSON:
  * {"name":<str>, "addr":<ut64>, "addr_end":<ut64>, "size":<ut64>,
- *  "data":"<base64>", "perm":<int>, "user":<int>, "shared":<bool>}
+ *  "zdata":"<base64 of deflated data>", "perm":<int>, "user":<int>, "shared":<bool>}
  *
  * Notes:
  * - This mostly follows rz-db-style serialization
+ * - Snaps holding "data":"<base64>" instead of "zdata" are loaded too, they
+ *   are written by older versions and when zlib is not available
  */
 RZ_API void rz_debug_session_serialize(RzDebugSession *session, Sdb *db) {
 	sdb_num_set(db, "maxcnum", session->maxcnum, 0);
@@ -562,6 +604,22 @@ static void deserialize_registers(Sdb *db, HtUP *registers) {
 #define SNAPATTR(ATTR) sdb_fmt("snaps.a[%u]." ATTR, i)
 #define REGATTR(ATTR)  sdb_fmt("registers.%d." ATTR, i)
 
+static ut8 *deserialize_snap_data(const char *encoded, bool compressed, ut32 size) {
+	int len = 0;
+	ut8 *data = sdb_decode(encoded, &len);
+	if (data && compressed) {
+		int dlen = 0;
+		ut8 *inflated = len > 0 ? rz_inflate(data, len, NULL, &dlen) : NULL;
+		free(data);
+		data = inflated;
+		len = dlen;
+	}
+	if (data && len != size) {
+		RZ_FREE(data);
+	}
+	return data;
+}
+
 static bool deserialize_checkpoints_cb(void *user, const char *cnum, const char *v) {
 	const RzJson *child;
 	char *json_str = strdup(v);
@@ -622,7 +680,8 @@ static bool deserialize_checkpoints_cb(void *user, const char *cnum, const char
 	for (child = snaps_json->children.first; child; child = child->next) {
 		const RzJson *namej = rz_json_get(child, "name");
 		CHECK_TYPE(namej, RZ_JSON_STRING);
-		const RzJson *dataj = rz_json_get(child, "data");
+		const RzJson *zdataj = rz_json_get(child, "zdata");
+		const RzJson *dataj = zdataj ? zdataj : rz_json_get(child, "data");
 		CHECK_TYPE(dataj, RZ_JSON_STRING);
 		const RzJson *sizej = rz_json_get(child, "size");
 		CHECK_TYPE(sizej, RZ_JSON_INTEGER);
@@ -646,11 +705,18 @@ static bool deserialize_checkpoints_cb(void *user, const char *cnum, const char
 		snap->addr = addrj->num.u_value;
 		snap->addr_end = addr_endj->num.u_value;
 		snap->size = sizej->num.u_value;
-		snap->data = sdb_decode(dataj->str_value, NULL);
 		snap->perm = permj->num.s_value;
 		snap->user = userj->num.s_value;
 		snap->shared = sharedj->num.u_value;
 
+		ut8 *data = deserialize_snap_data(dataj->str_value, zdataj != NULL, snap->size);
+		if (!data || !rz_debug_snap_set_data(snap, data, last_snap(checkpoints, snap->addr, snap->size))) {
+			eprintf("Error: invalid data of snap at 0x%" PFMT64x "\n", snap->addr);
+			free(data);
+			rz_debug_snap_free(snap);
+			continue;
+		}
+		free(data);
 		rz_list_append(checkpoint.snaps, snap);
 	}
 end:
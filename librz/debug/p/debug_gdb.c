@@ -336,6 +336,7 @@ static int rz_debug_gdb_reg_write(RzDebug *dbg, int type, const ut8 *buf, int si
 		}
 		ctx->reg_buf = new_buf;
 		memset(new_buf + ctx->buf_size, 0, buflen - ctx->buf_size);
+		ctx->buf_size = buflen;
 	}
 
 	RzRegItem *current = NULL;
@@ -347,7 +348,12 @@ static int rz_debug_gdb_reg_write(RzDebug *dbg, int type, const ut8 *buf, int si
 		if (!current) {
 			break;
 		}
-		gdbr_write_reg(ctx->desc, current->name, (char *)arena->bytes + (current->offset / 8), current->size / 8);
+		int offset = current->offset / 8;
+		if (gdbr_write_reg(ctx->desc, current->name, (char *)arena->bytes + offset, current->size / 8) == 0 &&
+			offset + current->size / 8 <= buflen) {
+			// remember what the target holds now so the next write only sends newer changes
+			memcpy(ctx->reg_buf + offset, arena->bytes + offset, current->size / 8);
+		}
 	}
 	return true;
 }
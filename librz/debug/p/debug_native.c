@@ -1229,6 +1229,13 @@ static bool rz_debug_native_init(RzDebug *dbg, void **user) {
 #endif
 }
 
+#if __linux__
+static void rz_debug_native_fini(RzDebug *dbg, void *user) {
+	// plugin_data only holds the branch tracer
+	linux_branch_trace(dbg, false);
+}
+#endif
+
 #if __i386__ || __x86_64__
 static void sync_drx_regs(RzDebug *dbg, drxt *regs, size_t num_regs) {
 	/* sanity check, we rely on this assumption */
@@ -1673,6 +1680,12 @@ RzDebugPlugin rz_debug_plugin_native = {
 	.breakpoint = rz_debug_native_bp,
 	.drx = rz_debug_native_drx,
 	.gcore = rz_debug_gcore,
+#if __linux__
+	.fini = rz_debug_native_fini,
+	.branch_trace = linux_branch_trace,
+	.branch_trace_read = linux_branch_trace_read,
+	.wait_async = linux_dbg_wait_async,
+#endif
 };
 
 #ifndef RZ_PLUGIN_INCORE
@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_debug.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "linux_debug.h"
+
+/*
+ * Branch tracing through perf: sampling every taken branch instruction of a
+ * thread makes the kernel use the Branch Trace Store of Intel cpus, which
+ * records each branch as a sample with ip = source and addr = destination
+ * without stopping the target.
+ */
+
+#define BTS_PMU_PATH "/sys/bus/event_source/devices/intel_bts"
+
+// data pages of the ring buffer, halved until the mlock limit of the user allows it
+#define BRANCH_TRACE_PAGES_MAX 512
+#define BRANCH_TRACE_PAGES_MIN 8
+
+typedef struct {
+	int fd;
+	int tid;
+	struct perf_event_mmap_page *meta;
+	ut8 *data;
+	size_t data_size;
+	size_t map_size;
+} LinuxBranchTrace;
+
+static void branch_trace_free(LinuxBranchTrace *bt) {
+	if (!bt) {
+		return;
+	}
+	if (bt->meta) {
+		munmap(bt->meta, bt->map_size);
+	}
+	if (bt->fd != -1) {
+		close(bt->fd);
+	}
+	free(bt);
+}
+
+static int branch_trace_open(int tid) {
+	struct perf_event_attr attr = { 0 };
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = PERF_COUNT_HW_BRANCH_INSTRUCTIONS;
+	attr.sample_period = 1;
+	attr.sample_type = PERF_SAMPLE_IP | PERF_SAMPLE_ADDR;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.wakeup_events = 1;
+	return (int)syscall(SYS_perf_event_open, &attr, tid, -1, -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+static bool branch_trace_map(LinuxBranchTrace *bt) {
+	size_t page_size = sysconf(_SC_PAGESIZE);
+	for (size_t pages = BRANCH_TRACE_PAGES_MAX; pages >= BRANCH_TRACE_PAGES_MIN; pages /= 2) {
+		size_t map_size = (pages + 1) * page_size;
+		void *map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, bt->fd, 0);
+		if (map != MAP_FAILED) {
+			bt->meta = map;
+			bt->map_size = map_size;
+			bt->data = (ut8 *)map + page_size;
+			bt->data_size = pages * page_size;
+			return true;
+		}
+		if (errno != EPERM && errno != ENOMEM) {
+			break;
+		}
+	}
+	return false;
+}
+
+bool linux_branch_trace(RzDebug *dbg, bool enable) {
+	branch_trace_free(dbg->plugin_data);
+	dbg->plugin_data = NULL;
+	if (!enable) {
+		return true;
+	}
+	if (!rz_file_exists(BTS_PMU_PATH)) {
+		RZ_LOG_ERROR("Branch tracing needs the Branch Trace Store of Intel cpus\n");
+		return false;
+	}
+	LinuxBranchTrace *bt = RZ_NEW0(LinuxBranchTrace);
+	if (!bt) {
+		return false;
+	}
+	bt->tid = dbg->tid;
+	bt->fd = branch_trace_open(bt->tid);
+	if (bt->fd == -1) {
+		RZ_LOG_ERROR("Cannot record the branches of %d: %s (see /proc/sys/kernel/perf_event_paranoid)\n", bt->tid, strerror(errno));
+		branch_trace_free(bt);
+		return false;
+	}
+	if (!branch_trace_map(bt)) {
+		RZ_LOG_ERROR("Cannot map the branch trace buffer: %s\n", strerror(errno));
+		branch_trace_free(bt);
+		return false;
+	}
+	dbg->plugin_data = bt;
+	return true;
+}
+
+// copy len bytes at offset off of the ring buffer, which may wrap around
+static void ring_read(LinuxBranchTrace *bt, ut64 off, void *dst, size_t len) {
+	size_t start = off % bt->data_size;
+	size_t first = RZ_MIN(len, bt->data_size - start);
+	memcpy(dst, bt->data + start, first);
+	memcpy((ut8 *)dst + first, bt->data, len - first);
+}
+
+bool linux_branch_trace_read(RzDebug *dbg, RzDebugBranchCallback cb, void *user) {
+	LinuxBranchTrace *bt = dbg->plugin_data;
+	if (!bt) {
+		return false;
+	}
+	ut64 head = __atomic_load_n(&bt->meta->data_head, __ATOMIC_ACQUIRE);
+	ut64 tail = bt->meta->data_tail;
+	ut64 lost = 0;
+	bool stop = false;
+	while (tail < head) {
+		struct perf_event_header hdr;
+		ring_read(bt, tail, &hdr, sizeof(hdr));
+		if (hdr.size < sizeof(hdr)) {
+			// corrupted, drop everything
+			tail = head;
+			break;
+		}
+		ut64 payload[2];
+		if (!stop && hdr.type == PERF_RECORD_SAMPLE && hdr.size >= sizeof(hdr) + sizeof(payload)) {
+			// ip, addr as asked in sample_type
+			ring_read(bt, tail + sizeof(hdr), payload, sizeof(payload));
+			stop = !cb(user, payload[0], payload[1]);
+		} else if (hdr.type == PERF_RECORD_LOST && hdr.size >= sizeof(hdr) + sizeof(payload)) {
+			// id, lost
+			ring_read(bt, tail + sizeof(hdr), payload, sizeof(payload));
+			lost += payload[1];
+		}
+		tail += hdr.size;
+	}
+	__atomic_store_n(&bt->meta->data_tail, tail, __ATOMIC_RELEASE);
+	if (lost) {
+		RZ_LOG_WARN("%" PFMT64u " branches were lost, the trace buffer filled up between two stops\n", lost);
+	}
+	return true;
+}
@@ -499,6 +499,27 @@ static void linux_dbg_wait_break(RzDebug *dbg) {
 	}
 }
 
+/*
+ * Block until a traced thread stops or exits, leaving the event to be
+ * consumed by linux_dbg_wait(). Waiting on the children of another thread of
+ * the same process is allowed, so this can run outside of the tracer thread.
+ */
+bool linux_dbg_wait_async(RzDebug *dbg, int pid) {
+	siginfo_t info;
+	int flags = WEXITED | WSTOPPED | WNOWAIT | __WALL;
+	for (;;) {
+		int ret = dbg->continue_all_threads
+			? waitid(P_ALL, 0, &info, flags)
+			: waitid(P_PID, pid, &info, flags);
+		if (ret == 0) {
+			return true;
+		}
+		if (errno != EINTR) {
+			return false;
+		}
+	}
+}
+
 RzDebugReasonType linux_dbg_wait(RzDebug *dbg, int pid) {
 	RzDebugReasonType reason = RZ_DEBUG_REASON_UNKNOWN;
 	int tid = 0;
@@ -174,7 +174,10 @@ RzList *linux_desc_list(int pid);
 bool linux_stop_threads(RzDebug *dbg, int except);
 int linux_handle_signals(RzDebug *dbg, int tid);
 int linux_dbg_wait(RzDebug *dbg, int pid);
+bool linux_dbg_wait_async(RzDebug *dbg, int pid);
 char *linux_reg_profile(RzDebug *dbg);
+bool linux_branch_trace(RzDebug *dbg, bool enable);
+bool linux_branch_trace_read(RzDebug *dbg, RzDebugBranchCallback cb, void *user);
 int match_pid(const void *pid_o, const void *th_o);
 
 #endif
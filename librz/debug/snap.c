@@ -4,15 +4,140 @@
 
 #include <rz_debug.h>
 
+// pages read from the target at once while taking a snapshot
+#define SNAP_READ_PAGES 64
+// pages compared by each task of rz_debug_snap_diff()
+#define SNAP_DIFF_GRAIN 64
+
+static void snap_page_unref(RzDebugSnapPage *page) {
+	if (page && !--page->refs) {
+		free(page->data);
+		free(page);
+	}
+}
+
 RZ_API void rz_debug_snap_free(RzDebugSnap *snap) {
 	if (snap) {
 		free(snap->name);
-		free(snap->data);
+		for (ut32 i = 0; i < snap->pages_count; i++) {
+			snap_page_unref(snap->pages[i]);
+		}
+		free(snap->pages);
 		RZ_FREE(snap);
 	}
 }
 
+static inline ut32 snap_page_size(RzDebugSnap *snap, ut32 idx) {
+	return RZ_MIN(RZ_DEBUG_SNAP_PAGE_SIZE, snap->size - idx * RZ_DEBUG_SNAP_PAGE_SIZE);
+}
+
+static bool snap_alloc_pages(RzDebugSnap *snap) {
+	snap->pages_count = (snap->size + RZ_DEBUG_SNAP_PAGE_SIZE - 1) / RZ_DEBUG_SNAP_PAGE_SIZE;
+	snap->pages = RZ_NEWS0(RzDebugSnapPage *, snap->pages_count);
+	if (!snap->pages) {
+		snap->pages_count = 0;
+		return false;
+	}
+	return true;
+}
+
+/*
+ * Store buf as page idx of snap, reusing the page of prev if it holds the
+ * same bytes. prev must be NULL or cover the same range as snap.
+ */
+static bool snap_set_page(RzDebugSnap *snap, ut32 idx, const ut8 *buf, RzDebugSnap *prev) {
+	ut32 size = snap_page_size(snap, idx);
+	RzDebugSnapPage *page = prev ? prev->pages[idx] : NULL;
+	if (page && !memcmp(page->data, buf, size)) {
+		page->refs++;
+	} else {
+		page = RZ_NEW0(RzDebugSnapPage);
+		if (!page) {
+			return false;
+		}
+		page->data = rz_mem_dup(buf, size);
+		if (!page->data) {
+			free(page);
+			return false;
+		}
+		page->refs = 1;
+	}
+	snap_page_unref(snap->pages[idx]);
+	snap->pages[idx] = page;
+	return true;
+}
+
+static inline bool snap_can_share(RzDebugSnap *snap, RzDebugSnap *prev) {
+	return prev && prev->addr == snap->addr && prev->size == snap->size && prev->pages_count == snap->pages_count;
+}
+
+/**
+ * \brief Set the contents of \p snap to the \p snap->size bytes at \p data
+ *
+ * \param prev an older snapshot of the same range, its unchanged pages are shared instead of copied
+ */
+RZ_API bool rz_debug_snap_set_data(RZ_NONNULL RzDebugSnap *snap, RZ_NONNULL const ut8 *data, RZ_NULLABLE RzDebugSnap *prev) {
+	rz_return_val_if_fail(snap && data, false);
+	if (!snap->pages && !snap_alloc_pages(snap)) {
+		return false;
+	}
+	if (!snap_can_share(snap, prev)) {
+		prev = NULL;
+	}
+	for (ut32 i = 0; i < snap->pages_count; i++) {
+		if (!snap_set_page(snap, i, data + (ut64)i * RZ_DEBUG_SNAP_PAGE_SIZE, prev)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * \brief Get a copy of the whole contents of \p snap
+ */
+RZ_API RZ_OWN ut8 *rz_debug_snap_data(RZ_NONNULL RzDebugSnap *snap) {
+	rz_return_val_if_fail(snap, NULL);
+	ut8 *data = malloc(RZ_MAX(snap->size, 1));
+	if (!data) {
+		return NULL;
+	}
+	for (ut32 i = 0; i < snap->pages_count; i++) {
+		if (!snap->pages[i]) {
+			free(data);
+			return NULL;
+		}
+		memcpy(data + (ut64)i * RZ_DEBUG_SNAP_PAGE_SIZE, snap->pages[i]->data, snap_page_size(snap, i));
+	}
+	return data;
+}
+
+/**
+ * \brief Write the contents of \p snap back to the memory of the target
+ */
+RZ_API bool rz_debug_snap_restore(RZ_NONNULL RzDebug *dbg, RZ_NONNULL RzDebugSnap *snap) {
+	rz_return_val_if_fail(dbg && snap, false);
+	bool ret = true;
+	for (ut32 i = 0; i < snap->pages_count; i++) {
+		if (!snap->pages[i]) {
+			ret = false;
+			continue;
+		}
+		ut64 addr = snap->addr + (ut64)i * RZ_DEBUG_SNAP_PAGE_SIZE;
+		ret &= dbg->iob.write_at(dbg->iob.io, addr, snap->pages[i]->data, snap_page_size(snap, i));
+	}
+	return ret;
+}
+
 RZ_API RzDebugSnap *rz_debug_snap_map(RzDebug *dbg, RzDebugMap *map) {
+	return rz_debug_snap_map_shared(dbg, map, NULL);
+}
+
+/**
+ * \brief Take a snapshot of \p map, sharing the pages that did not change since \p prev
+ *
+ * \param prev an older snapshot, only used if it covers the same range as \p map
+ */
+RZ_API RzDebugSnap *rz_debug_snap_map_shared(RzDebug *dbg, RzDebugMap *map, RZ_NULLABLE RzDebugSnap *prev) {
 	rz_return_val_if_fail(dbg && map, NULL);
 	if (map->size < 1) {
 		eprintf("Invalid map size\n");
@@ -32,14 +157,29 @@ RZ_API RzDebugSnap *rz_debug_snap_map(RzDebug *dbg, RzDebugMap *map) {
 	snap->user = map->user;
 	snap->shared = map->shared;
 
-	snap->data = malloc(map->size);
-	if (!snap->data) {
+	ut8 *buf = malloc(RZ_MIN(snap->size, SNAP_READ_PAGES * RZ_DEBUG_SNAP_PAGE_SIZE));
+	if (!buf || !snap_alloc_pages(snap)) {
+		free(buf);
 		rz_debug_snap_free(snap);
 		return NULL;
 	}
+	if (!snap_can_share(snap, prev)) {
+		prev = NULL;
+	}
 	eprintf("Reading %d byte(s) from 0x%08" PFMT64x "...\n", snap->size, snap->addr);
-	dbg->iob.read_at(dbg->iob.io, snap->addr, snap->data, snap->size);
-
+	for (ut32 i = 0; i < snap->pages_count; i += SNAP_READ_PAGES) {
+		ut32 off = i * RZ_DEBUG_SNAP_PAGE_SIZE;
+		ut32 len = RZ_MIN(SNAP_READ_PAGES * RZ_DEBUG_SNAP_PAGE_SIZE, snap->size - off);
+		dbg->iob.read_at(dbg->iob.io, snap->addr + off, buf, len);
+		for (ut32 j = i; j < snap->pages_count && j < i + SNAP_READ_PAGES; j++) {
+			if (!snap_set_page(snap, j, buf + (j - i) * RZ_DEBUG_SNAP_PAGE_SIZE, prev)) {
+				free(buf);
+				rz_debug_snap_free(snap);
+				return NULL;
+			}
+		}
+	}
+	free(buf);
 	return snap;
 }
 
@@ -48,20 +188,136 @@ RZ_API bool rz_debug_snap_contains(RzDebugSnap *snap, ut64 addr) {
 }
 
 RZ_API ut8 *rz_debug_snap_get_hash(RzDebug *dbg, RzDebugSnap *snap, RzHashSize *size) {
-	ut8 *digest = rz_hash_cfg_calculate_small_block(dbg->hash, "sha256", snap->data, snap->size, size);
-	if (!digest) {
+	RzHashCfg *md = rz_hash_cfg_new_with_algo(dbg->hash, "sha256", NULL, 0);
+	if (!md) {
 		return NULL;
 	}
+	for (ut32 i = 0; i < snap->pages_count; i++) {
+		if (!snap->pages[i]) {
+			rz_hash_cfg_free(md);
+			return NULL;
+		}
+		rz_hash_cfg_update(md, snap->pages[i]->data, snap_page_size(snap, i));
+	}
+	rz_hash_cfg_final(md);
+	RzHashSize digest_size = 0;
+	const ut8 *result = rz_hash_cfg_get_result(md, "sha256", &digest_size);
+	ut8 *digest = result ? rz_mem_dup(result, digest_size) : NULL;
+	rz_hash_cfg_free(md);
+	if (digest && size) {
+		*size = digest_size;
+	}
 	return digest;
 }
 
+/**
+ * \brief Check whether \p a and \p b hold the same bytes
+ */
 RZ_API bool rz_debug_snap_is_equal(RzDebug *dbg, RzDebugSnap *a, RzDebugSnap *b) {
-	RzHashSize digest_size = 0;
-	ut8 *a_dgst = rz_debug_snap_get_hash(dbg, a, &digest_size);
-	ut8 *b_dgst = rz_debug_snap_get_hash(dbg, b, NULL);
-
-	bool ret = a_dgst && b_dgst && !memcmp(a_dgst, b_dgst, digest_size);
-	free(a_dgst);
-	free(b_dgst);
+	RzBitmap *changed = rz_debug_snap_diff(dbg, a, b, NULL);
+	if (!changed) {
+		return false;
+	}
+	bool ret = rz_bitmap_next_set(changed, 0) >= a->pages_count;
+	rz_bitmap_free(changed);
 	return ret;
 }
+
+// pages are never modified once created, so their hash is computed once
+static ut32 snap_page_hash(RzDebug *dbg, RzDebugSnapPage *page, ut32 size) {
+	if (!page->hashed) {
+		page->hash = rz_hash_xxhash(dbg->hash, page->data, size);
+		page->hashed = true;
+	}
+	return page->hash;
+}
+
+typedef struct {
+	RzDebug *dbg;
+	RzDebugSnap *a;
+	RzDebugSnap *b;
+	ut8 *changed;
+} SnapDiffCtx;
+
+static void snap_diff_range(size_t from, size_t to, void *user) {
+	SnapDiffCtx *ctx = user;
+	for (size_t i = from; i < to; i++) {
+		RzDebugSnapPage *pa = ctx->a->pages[i];
+		RzDebugSnapPage *pb = ctx->b->pages[i];
+		if (pa == pb) {
+			// shared, so unchanged
+			continue;
+		}
+		if (!pa || !pb) {
+			ctx->changed[i] = 1;
+			continue;
+		}
+		ut32 size = snap_page_size(ctx->a, i);
+		ctx->changed[i] = snap_page_hash(ctx->dbg, pa, size) != snap_page_hash(ctx->dbg, pb, size) ||
+			memcmp(pa->data, pb->data, size);
+	}
+}
+
+/**
+ * \brief Find the pages that differ between two snapshots of the same size
+ *
+ * Pages shared by both snapshots are known to be unchanged, the others are
+ * told apart by their cached hash first.
+ *
+ * \param pool workers to compare the pages with, NULL to do it in the calling thread
+ * \return a bitmap with a bit set for every changed page, or NULL if the sizes differ
+ */
+RZ_API RZ_OWN RzBitmap *rz_debug_snap_diff(RZ_NONNULL RzDebug *dbg, RZ_NONNULL RzDebugSnap *a, RZ_NONNULL RzDebugSnap *b, RZ_NULLABLE RzThreadTaskPool *pool) {
+	rz_return_val_if_fail(dbg && a && b, NULL);
+	if (a->size != b->size || a->pages_count != b->pages_count) {
+		return NULL;
+	}
+	SnapDiffCtx ctx = { .dbg = dbg, .a = a, .b = b };
+	ctx.changed = RZ_NEWS0(ut8, RZ_MAX(a->pages_count, 1));
+	RzBitmap *bm = rz_bitmap_new(RZ_MAX(a->pages_count, 1));
+	if (!ctx.changed || !bm) {
+		free(ctx.changed);
+		rz_bitmap_free(bm);
+		return NULL;
+	}
+	if (!pool || a->pages_count <= SNAP_DIFF_GRAIN ||
+		!rz_th_task_pool_parallel_for(pool, 0, a->pages_count, SNAP_DIFF_GRAIN, snap_diff_range, &ctx)) {
+		snap_diff_range(0, a->pages_count, &ctx);
+	}
+	// the workers fill a byte per page, bits of a word cannot be set concurrently
+	for (ut32 i = 0; i < a->pages_count; i++) {
+		if (ctx.changed[i]) {
+			rz_bitmap_set(bm, i);
+		}
+	}
+	free(ctx.changed);
+	return bm;
+}
+
+/**
+ * \brief Find the pages of the target memory that changed since \p snap was taken
+ *
+ * The memory is read through the same path as rz_debug_snap_map_shared(),
+ * keeping no copy of the unchanged pages.
+ *
+ * \return a bitmap with a bit set for every changed page of \p snap
+ */
+RZ_API RZ_OWN RzBitmap *rz_debug_snap_diff_live(RZ_NONNULL RzDebug *dbg, RZ_NONNULL RzDebugSnap *snap, RZ_NULLABLE RzThreadTaskPool *pool) {
+	rz_return_val_if_fail(dbg && snap, NULL);
+	RzDebugMap map = {
+		.name = snap->name,
+		.addr = snap->addr,
+		.addr_end = snap->addr_end,
+		.size = snap->size,
+		.perm = snap->perm,
+		.user = snap->user,
+		.shared = snap->shared,
+	};
+	RzDebugSnap *now = rz_debug_snap_map_shared(dbg, &map, snap);
+	if (!now) {
+		return NULL;
+	}
+	RzBitmap *changed = rz_debug_snap_diff(dbg, snap, now, pool);
+	rz_debug_snap_free(now);
+	return changed;
+}
@@ -3,6 +3,10 @@
 
 #include <rz_debug.h>
 
+static void tag_ht_free(HtUPKv *kv) {
+	ht_up_free(kv->value);
+}
+
 /* Old debug trace implementation */
 RZ_API RzDebugTrace *rz_debug_trace_new(void) {
 	RzDebugTrace *t = RZ_NEW0(RzDebugTrace);
@@ -12,13 +16,12 @@ RZ_API RzDebugTrace *rz_debug_trace_new(void) {
 	t->tag = 1; // UT32_MAX;
 	t->addresses = NULL;
 	t->enabled = false;
-	t->traces = rz_list_new();
+	t->traces = rz_pvector_new(free);
 	if (!t->traces) {
 		rz_debug_trace_free(t);
 		return NULL;
 	}
-	t->traces->free = free;
-	t->ht = ht_pp_new0();
+	t->ht = ht_up_new(NULL, tag_ht_free, NULL);
 	if (!t->ht) {
 		rz_debug_trace_free(t);
 		return NULL;
@@ -30,12 +33,38 @@ RZ_API void rz_debug_trace_free(RzDebugTrace *trace) {
 	if (!trace) {
 		return;
 	}
-	rz_list_purge(trace->traces);
-	free(trace->traces);
-	ht_pp_free(trace->ht);
+	rz_pvector_free(trace->traces);
+	ht_up_free(trace->ht);
 	RZ_FREE(trace);
 }
 
+// the tracepoints of tag, keyed by address
+static HtUP *tag_ht(RzDebugTrace *trace, int tag, bool create) {
+	HtUP *ht = ht_up_find(trace->ht, (ut64)(ut32)tag, NULL);
+	if (!ht && create) {
+		ht = ht_up_new0();
+		if (ht && !ht_up_insert(trace->ht, (ut64)(ut32)tag, ht)) {
+			ht_up_free(ht);
+			ht = NULL;
+		}
+	}
+	return ht;
+}
+
+/**
+ * \brief Make room for \p count tracepoints of the current tag, to avoid growing while tracing
+ */
+RZ_API void rz_debug_trace_reserve(RzDebugTrace *trace, size_t count) {
+	rz_return_if_fail(trace);
+	rz_pvector_reserve(trace->traces, rz_pvector_len(trace->traces) + count);
+	if (!tag_ht(trace, trace->tag, false)) {
+		HtUP *ht = ht_up_new_size(count, NULL, NULL, NULL);
+		if (ht && !ht_up_insert(trace->ht, (ut64)(ut32)trace->tag, ht)) {
+			ht_up_free(ht);
+		}
+	}
+}
+
 // TODO: added overlap/mask support here...
 // TODO: think about tagged traces
 RZ_API int rz_debug_trace_tag(RzDebug *dbg, int tag) {
@@ -198,9 +227,8 @@ RZ_API void rz_debug_trace_at(RzDebug *dbg, const char *str) {
 }
 
 RZ_API RzDebugTracepoint *rz_debug_trace_get(RzDebug *dbg, ut64 addr) {
-	int tag = dbg->trace->tag;
-	return ht_pp_find(dbg->trace->ht,
-		sdb_fmt("trace.%d.%" PFMT64x, tag, addr), NULL);
+	HtUP *ht = tag_ht(dbg->trace, dbg->trace->tag, false);
+	return ht ? ht_up_find(ht, addr, NULL) : NULL;
 }
 
 static int cmpaddr(const void *_a, const void *_b) {
@@ -218,14 +246,14 @@ static int cmpaddr(const void *_a, const void *_b) {
 RZ_API RZ_OWN RzList *rz_debug_traces_info(RzDebug *dbg, ut64 offset) {
 	rz_return_val_if_fail(dbg, NULL);
 	int tag = dbg->trace->tag;
-	RzListIter *iter;
 	RzList *info_list = rz_list_new();
 	if (!info_list) {
 		return NULL;
 	}
 
-	RzDebugTracepoint *trace;
-	rz_list_foreach (dbg->trace->traces, iter, trace) {
+	void **it;
+	rz_pvector_foreach (dbg->trace->traces, it) {
+		RzDebugTracepoint *trace = *it;
 		if (trace->tag && !(tag & trace->tag)) {
 			continue;
 		}
@@ -258,12 +286,29 @@ static int rz_debug_trace_is_traceable(RzDebug *dbg, ut64 addr) {
 	return true;
 }
 
+/**
+ * \brief Record that \p size bytes at \p addr were executed
+ *
+ * Every address has a single tracepoint per tag, executing it again bumps
+ * its times and count.
+ */
 RZ_API RzDebugTracepoint *rz_debug_trace_add(RzDebug *dbg, ut64 addr, int size) {
 	RzDebugTracepoint *tp;
 	int tag = dbg->trace->tag;
 	if (!rz_debug_trace_is_traceable(dbg, addr)) {
 		return NULL;
 	}
+	HtUP *ht = tag_ht(dbg->trace, tag, true);
+	if (!ht) {
+		return NULL;
+	}
+	tp = ht_up_find(ht, addr, NULL);
+	if (tp) {
+		tp->size = RZ_MAX(tp->size, size);
+		tp->count = ++dbg->trace->count;
+		tp->times++;
+		return tp;
+	}
 	rz_analysis_trace_bb(dbg->analysis, addr);
 	tp = RZ_NEW0(RzDebugTracepoint);
 	if (!tp) {
@@ -275,17 +320,274 @@ RZ_API RzDebugTracepoint *rz_debug_trace_add(RzDebug *dbg, ut64 addr, int size)
 	tp->size = size;
 	tp->count = ++dbg->trace->count;
 	tp->times = 1;
-	rz_list_append(dbg->trace->traces, tp);
-	ht_pp_update(dbg->trace->ht,
-		sdb_fmt("trace.%d.%" PFMT64x, tag, addr), tp);
+	if (!rz_pvector_push(dbg->trace->traces, tp)) {
+		free(tp);
+		return NULL;
+	}
+	ht_up_insert(ht, addr, tp);
 	return tp;
 }
 
 RZ_API void rz_debug_trace_reset(RzDebug *dbg) {
 	RzDebugTrace *t = dbg->trace;
-	rz_list_purge(t->traces);
-	ht_pp_free(t->ht);
-	t->ht = ht_pp_new0();
-	t->traces = rz_list_new();
-	t->traces->free = free;
+	rz_pvector_clear(t->traces);
+	ht_up_free(t->ht);
+	t->ht = ht_up_new(NULL, tag_ht_free, NULL);
+}
+
+// longest block accepted between a branch target and the next taken branch
+#define BRANCH_BLOCK_MAX 0x10000
+
+typedef struct {
+	RzDebug *dbg;
+	ut64 block;
+} BranchTraceCtx;
+
+static int branch_op_size(RzDebug *dbg, ut64 addr) {
+	ut8 buf[32];
+	RzAnalysisOp op = { 0 };
+	int size = 1;
+	if (dbg->iob.read_at(dbg->iob.io, addr, buf, sizeof(buf)) &&
+		rz_analysis_op(dbg->analysis, &op, addr, buf, sizeof(buf), RZ_ANALYSIS_OP_MASK_BASIC) > 0) {
+		size = op.size;
+	}
+	rz_analysis_op_fini(&op);
+	return size;
+}
+
+// trace the block at from, size is computed by the callback only for blocks not seen yet
+static void trace_block(RzDebug *dbg, ut64 from, ut64 end, int (*size_cb)(RzDebug *dbg, ut64 from, ut64 end)) {
+	if (end <= from || end - from > BRANCH_BLOCK_MAX) {
+		return;
+	}
+	RzDebugTracepoint *tp = rz_debug_trace_get(dbg, from);
+	if (!tp) {
+		rz_debug_trace_add(dbg, from, size_cb(dbg, from, end));
+		return;
+	}
+	if (end > tp->addr + tp->size) {
+		// a longer path through the same block, not taken branches are not recorded
+		tp->size = size_cb(dbg, from, end);
+	}
+	tp->times++;
+	tp->count = ++dbg->trace->count;
+}
+
+// end is one past the address of the branch closing the block
+static int branch_block_size(RzDebug *dbg, ut64 from, ut64 end) {
+	return (int)(end - 1 - from) + branch_op_size(dbg, end - 1);
+}
+
+// end is where the target stopped
+static int stop_block_size(RzDebug *dbg, ut64 from, ut64 end) {
+	return (int)(end - from);
+}
+
+static bool trace_branch_cb(void *user, ut64 from, ut64 to) {
+	BranchTraceCtx *ctx = user;
+	if (ctx->block != UT64_MAX) {
+		// the block entered by the previous branch ends with this one
+		trace_block(ctx->dbg, ctx->block, from + 1, branch_block_size);
+	}
+	ctx->block = to;
+	return true;
+}
+
+/**
+ * \brief Record the executed blocks from the taken branches recorded by the backend
+ *
+ * Much faster than tracing by stepping: the target runs natively and the
+ * backend (e.g. Intel BTS through perf on Linux) records every taken branch.
+ * The branches are read with rz_debug_trace_branches_collect() whenever the
+ * target stops and fed as tracepoints, one per executed block.
+ *
+ * \return false if the backend cannot record branches
+ */
+RZ_API bool rz_debug_trace_branches(RzDebug *dbg, bool enable) {
+	rz_return_val_if_fail(dbg && dbg->trace, false);
+	if (!enable) {
+		if (dbg->trace->branches && dbg->cur && dbg->cur->branch_trace) {
+			rz_debug_trace_branches_collect(dbg);
+			dbg->cur->branch_trace(dbg, false);
+		}
+		dbg->trace->branches = false;
+		return true;
+	}
+	if (!dbg->cur || !dbg->cur->branch_trace || !dbg->cur->branch_trace_read) {
+		RZ_LOG_ERROR("The %s debug backend cannot trace branches\n", dbg->cur ? dbg->cur->name : "current");
+		return false;
+	}
+	if (rz_debug_is_dead(dbg) || !dbg->cur->branch_trace(dbg, true)) {
+		return false;
+	}
+	dbg->trace->branches = true;
+	dbg->trace->branch_block = rz_debug_reg_get(dbg, "PC");
+	return true;
+}
+
+/**
+ * \brief Turn the branches recorded since the last call into tracepoints
+ */
+RZ_API bool rz_debug_trace_branches_collect(RzDebug *dbg) {
+	rz_return_val_if_fail(dbg && dbg->trace, false);
+	if (!dbg->trace->branches || !dbg->cur || !dbg->cur->branch_trace_read) {
+		return false;
+	}
+	BranchTraceCtx ctx = { dbg, dbg->trace->branch_block };
+	bool ret = dbg->cur->branch_trace_read(dbg, trace_branch_cb, &ctx);
+	if (rz_debug_is_dead(dbg)) {
+		dbg->trace->branch_block = UT64_MAX;
+		return ret;
+	}
+	// the target stopped inside the last block, trace what ran of it
+	ut64 pc = rz_debug_reg_get(dbg, "PC");
+	if (ctx.block != UT64_MAX) {
+		trace_block(dbg, ctx.block, pc, stop_block_size);
+	}
+	dbg->trace->branch_block = pc;
+	return ret;
+}
+
+/**
+ * \brief Get which bytes of [\p from, \p to) were executed according to the trace
+ *
+ * \param covered set to the number of executed bytes in the range
+ * \return a bitmap with one bit per byte of the range
+ */
+RZ_API RZ_OWN RzBitmap *rz_debug_trace_coverage(RZ_NONNULL RzDebug *dbg, ut64 from, ut64 to, RZ_NULLABLE RZ_OUT ut64 *covered) {
+	rz_return_val_if_fail(dbg && dbg->trace && from < to, NULL);
+	RzBitmap *bm = rz_bitmap_new(to - from);
+	if (!bm) {
+		return NULL;
+	}
+	void **it;
+	rz_pvector_foreach (dbg->trace->traces, it) {
+		RzDebugTracepoint *tp = *it;
+		ut64 start = RZ_MAX(tp->addr, from);
+		ut64 end = RZ_MIN(tp->addr + RZ_MAX(tp->size, 1), to);
+		if (start < end) {
+			rz_bitmap_set_range(bm, start - from, end - from);
+		}
+	}
+	if (covered) {
+		*covered = rz_bitmap_count(bm, 0, to - from);
+	}
+	return bm;
+}
+
+typedef struct {
+	const char *path;
+	ut64 base;
+	ut64 end;
+} DrcovModule;
+
+static DrcovModule *drcov_module_at(RzVector *modules, ut64 addr, ut16 *id) {
+	DrcovModule *mod;
+	ut16 i = 0;
+	rz_vector_foreach(modules, mod) {
+		if (addr >= mod->base && addr < mod->end) {
+			*id = i;
+			return mod;
+		}
+		i++;
+	}
+	return NULL;
+}
+
+// one module per mapped file, spanning all of its maps
+static bool drcov_modules(RzDebug *dbg, RzVector *modules) {
+	RzListIter *iter;
+	RzDebugMap *map;
+	rz_list_foreach (dbg->maps, iter, map) {
+		if (!map->file) {
+			continue;
+		}
+		DrcovModule *mod;
+		bool found = false;
+		rz_vector_foreach(modules, mod) {
+			if (!strcmp(mod->path, map->file)) {
+				mod->base = RZ_MIN(mod->base, map->addr);
+				mod->end = RZ_MAX(mod->end, map->addr_end);
+				found = true;
+				break;
+			}
+		}
+		if (found) {
+			continue;
+		}
+		if (rz_vector_len(modules) >= UT16_MAX) {
+			break;
+		}
+		mod = rz_vector_push(modules, NULL);
+		if (!mod) {
+			return false;
+		}
+		mod->path = map->file;
+		mod->base = map->addr;
+		mod->end = map->addr_end;
+	}
+	return true;
+}
+
+/**
+ * \brief Export the traced addresses as a drcov (DynamoRIO coverage) file
+ *
+ * Tracepoints outside of any mapped file are left out. The result can be
+ * loaded by coverage viewers like Lighthouse or Cartographer.
+ */
+RZ_API RZ_OWN RzBuffer *rz_debug_trace_drcov(RZ_NONNULL RzDebug *dbg) {
+	rz_return_val_if_fail(dbg && dbg->trace, NULL);
+	rz_debug_map_sync(dbg);
+	RzVector modules;
+	rz_vector_init(&modules, sizeof(DrcovModule), NULL, NULL);
+	RzBuffer *buf = NULL;
+	RzVector bbs;
+	rz_vector_init(&bbs, 8, NULL, NULL);
+	if (!drcov_modules(dbg, &modules)) {
+		goto beach;
+	}
+	void **it;
+	rz_pvector_foreach (dbg->trace->traces, it) {
+		RzDebugTracepoint *tp = *it;
+		ut16 id;
+		DrcovModule *mod = drcov_module_at(&modules, tp->addr, &id);
+		if (!mod || tp->addr - mod->base > UT32_MAX) {
+			continue;
+		}
+		// struct { ut32 start; ut16 size; ut16 mod_id; }, little endian
+		ut8 *bb = rz_vector_push(&bbs, NULL);
+		if (!bb) {
+			goto beach;
+		}
+		rz_write_le32(bb, (ut32)(tp->addr - mod->base));
+		rz_write_le16(bb + 4, (ut16)RZ_MIN(tp->size, UT16_MAX));
+		rz_write_le16(bb + 6, id);
+	}
+	buf = rz_buf_new_with_bytes(NULL, 0);
+	if (!buf) {
+		goto beach;
+	}
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	rz_strbuf_appendf(&sb, "DRCOV VERSION: 2\nDRCOV FLAVOR: drcov\n");
+	rz_strbuf_appendf(&sb, "Module Table: version 2, count %u\n", (ut32)rz_vector_len(&modules));
+	rz_strbuf_append(&sb, "Columns: id, base, end, entry, checksum, timestamp, path\n");
+	DrcovModule *mod;
+	ut32 i = 0;
+	rz_vector_foreach(&modules, mod) {
+		rz_strbuf_appendf(&sb, "%u, 0x%016" PFMT64x ", 0x%016" PFMT64x ", 0x0000000000000000, 0x00000000, 0x00000000, %s\n",
+			i++, mod->base, mod->end, mod->path);
+	}
+	rz_strbuf_appendf(&sb, "BB Table: %u bbs\n", (ut32)rz_vector_len(&bbs));
+	bool ok = rz_buf_append_string(buf, rz_strbuf_get(&sb)) &&
+		(rz_vector_empty(&bbs) || rz_buf_append_bytes(buf, bbs.a, rz_vector_len(&bbs) * bbs.elem_size));
+	rz_strbuf_fini(&sb);
+	if (!ok) {
+		rz_buf_free(buf);
+		buf = NULL;
+	}
+beach:
+	rz_vector_fini(&bbs);
+	rz_vector_fini(&modules);
+	return buf;
 }
@@ -103,6 +103,12 @@ RZ_API RZ_OWN RzDemangler *rz_demangler_new(void) {
 	}
 
 	dem->plugins = plugins;
+	dem->cache_lock = rz_th_lock_new(false);
+	if (!dem->cache_lock) {
+		rz_demangler_free(dem);
+		return NULL;
+	}
+	dem->cache_size = RZ_DEMANGLER_CACHE_SIZE_DEFAULT;
 	return dem;
 }
 
@@ -114,6 +120,9 @@ RZ_API void rz_demangler_free(RZ_NULLABLE RzDemangler *dem) {
 		return;
 	}
 	rz_list_free(dem->plugins);
+	ht_pp_free(dem->cache);
+	ht_pp_free(dem->cache_old);
+	rz_th_lock_free(dem->cache_lock);
 	free(dem);
 }
 
@@ -157,6 +166,7 @@ RZ_API bool rz_demangler_plugin_add(RZ_NONNULL RzDemangler *dem, RZ_NONNULL RzDe
 		}
 	}
 
+	rz_demangler_cache_clear(dem);
 	return rz_list_append(dem->plugins, plugin);
 }
 
@@ -197,10 +207,133 @@ RZ_API bool rz_demangler_resolve(RZ_NONNULL RzDemangler *dem, RZ_NULLABLE const
 
 	rz_list_foreach (dem->plugins, it, plugin) {
 		if (!strcmp(plugin->language, language)) {
-			*output = plugin->demangle(symbol);
+			*output = rz_demangler_resolve_cached(dem, symbol, plugin->language, plugin->demangle);
 			return true;
 		}
 	}
 
 	return false;
 }
+
+// value of the cache entries of the symbols that can't be demangled
+static char cache_not_demangled;
+
+static void cache_kv_free(HtPPKv *kv) {
+	free(kv->key);
+	if (kv->value != &cache_not_demangled) {
+		free(kv->value);
+	}
+}
+
+static char *cache_dup(const char *value) {
+	return value == &cache_not_demangled ? NULL : strdup(value);
+}
+
+/// add key to the most recent generation, the caller must hold the lock
+static void cache_insert(RzDemangler *dem, const char *key, const char *demangled) {
+	if (dem->cache && dem->cache->count >= dem->cache_size) {
+		// the old generation holds only the entries not used since the last switch
+		ht_pp_free(dem->cache_old);
+		dem->cache_old = dem->cache;
+		dem->cache = NULL;
+	}
+	if (!dem->cache) {
+		dem->cache = ht_pp_new(NULL, cache_kv_free, NULL);
+		if (!dem->cache) {
+			return;
+		}
+	}
+	char *value = demangled ? strdup(demangled) : &cache_not_demangled;
+	if (!value || !ht_pp_insert(dem->cache, key, value)) {
+		// another thread may have inserted it meanwhile
+		if (value != &cache_not_demangled) {
+			free(value);
+		}
+	}
+}
+
+/// look for key in both generations, the caller must hold the lock
+static bool cache_find(RzDemangler *dem, const char *key, char **output) {
+	bool found = false;
+	const char *value = dem->cache ? ht_pp_find(dem->cache, key, &found) : NULL;
+	if (found) {
+		*output = cache_dup(value);
+		return true;
+	}
+	value = dem->cache_old ? ht_pp_find(dem->cache_old, key, &found) : NULL;
+	if (!found) {
+		return false;
+	}
+	*output = cache_dup(value);
+	if (value == &cache_not_demangled || *output) {
+		// still in use, keep it for the next generation
+		cache_insert(dem, key, *output);
+	}
+	return true;
+}
+
+/**
+ * \brief Demangles \p symbol with \p handler, remembering the results of the most recent symbols
+ *
+ * The same symbols are demangled again and again while loading a binary, printing the
+ * disassembly or naming functions, so the results are kept in a bounded cache, keyed by
+ * \p language and \p symbol. This function can be called from multiple threads at once.
+ *
+ * \param symbol The mangled symbol
+ * \param language The language of the symbol, which must always be demangled by \p handler
+ * \param handler The function doing the demangling on cache misses
+ * \return The demangled symbol, to be freed, or NULL if it can't be demangled
+ */
+RZ_API RZ_OWN char *rz_demangler_resolve_cached(RZ_NONNULL RzDemangler *dem, RZ_NONNULL const char *symbol, RZ_NONNULL const char *language, RZ_NONNULL RzDemanglerHandler handler) {
+	rz_return_val_if_fail(dem && symbol && language && handler, NULL);
+	if (!dem->cache_size) {
+		return handler(symbol);
+	}
+	char *key = rz_str_newf("%s:%s", language, symbol);
+	if (!key) {
+		return handler(symbol);
+	}
+	char *output = NULL;
+	rz_th_lock_enter(dem->cache_lock);
+	bool found = cache_find(dem, key, &output);
+	rz_th_lock_leave(dem->cache_lock);
+	if (found) {
+		free(key);
+		return output;
+	}
+	// demangle without holding the lock, so other threads can go on meanwhile
+	output = handler(symbol);
+	rz_th_lock_enter(dem->cache_lock);
+	cache_insert(dem, key, output);
+	rz_th_lock_leave(dem->cache_lock);
+	free(key);
+	return output;
+}
+
+/**
+ * \brief Sets the maximum number of demangled symbols kept in the cache, 0 disables it
+ *
+ * The cache keeps up to twice this number of entries: the recent ones and the
+ * ones not used since the last time the recent entries filled up.
+ */
+RZ_API void rz_demangler_cache_set_size(RZ_NONNULL RzDemangler *dem, size_t size) {
+	rz_return_if_fail(dem);
+	rz_th_lock_enter(dem->cache_lock);
+	dem->cache_size = size;
+	if (!size) {
+		RZ_FREE_CUSTOM(dem->cache, ht_pp_free);
+		RZ_FREE_CUSTOM(dem->cache_old, ht_pp_free);
+	}
+	rz_th_lock_leave(dem->cache_lock);
+}
+
+/**
+ * \brief Forgets all the demangled symbols, e.g. after adding a plugin that demangles differently
+ */
+RZ_API void rz_demangler_cache_clear(RZ_NONNULL RzDemangler *dem) {
+	rz_return_if_fail(dem);
+	rz_th_lock_enter(dem->cache_lock);
+	RZ_FREE_CUSTOM(dem->cache, ht_pp_free);
+	RZ_FREE_CUSTOM(dem->cache_old, ht_pp_free);
+	rz_th_lock_leave(dem->cache_lock);
+}
@@ -0,0 +1,533 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/* Matcher used for large buffers of bytes
+ *
+ * The hit map of the Ratcliff/Obershelp matcher costs one list node per
+ * byte of B and every search for the longest match walks the hits of each
+ * byte of A, which is way too slow and memory hungry for big binaries.
+ *
+ * From DIFF_ANCHORED_MIN bytes in total the buffers are matched in two steps:
+ * - anchors: B is indexed by the hash of its DIFF_ANCHOR_SIZE bytes windows
+ *   starting at the multiples of DIFF_ANCHOR_SIZE, then A is scanned with a
+ *   rolling hash of the same size; each verified hit on a window that is
+ *   unique in B is extended in both directions and becomes an anchor. Any
+ *   common run of at least 2 * DIFF_ANCHOR_SIZE - 1 bytes contains an indexed
+ *   window, so it cannot be missed. Repeated content, like padding, is
+ *   anchored by looking at the same distance from the previous anchor.
+ *   Like in the patience diff, the chain of anchors increasing in both
+ *   buffers which covers the most bytes is kept and the rest is dropped,
+ *   then the areas left between them are anchored again on their own.
+ * - gaps: the areas between two anchors are matched with the linear space
+ *   variant of the Myers' O(ND) algorithm, which finds the middle snake of
+ *   the edit path and recurses on both halves. When the edit cost grows past
+ *   DIFF_MYERS_MAX_COST the furthest reaching path is taken as split point,
+ *   and gaps larger than DIFF_MYERS_MAX_GAP are left as replaced.
+ *
+ * Common runs are compared 16 bytes at a time with SSE2 when available, and a
+ * machine word at a time otherwise.
+ */
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DIFF_USE_SSE2 1
+#endif
+
+#define DIFF_ANCHORED_MIN     0x10000
+#define DIFF_ANCHOR_SIZE      32
+#define DIFF_ANCHOR_PRIME     0x100000001b3ULL
+#define DIFF_ANCHOR_MAX_DEPTH 8
+#define DIFF_MYERS_MAX_GAP    0x10000
+#define DIFF_MYERS_MAX_COST   256
+
+typedef struct anchored_ctx_t {
+	const ut8 *a;
+	const ut8 *b;
+	RzList /*<RzDiffMatch>*/ *matches;
+	RzVector /*<Block>*/ stack;
+	st64 *kv; ///< forward and backward furthest reaching paths, 2 * (DIFF_MYERS_MAX_GAP + 3) entries
+	ut32 gap_a; ///< start in A of the gap being matched
+	ut32 gap_b; ///< start in B of the gap being matched
+	ut32 gap_b_size;
+} AnchoredCtx;
+
+static inline ut64 load_word(const ut8 *p) {
+	ut64 w;
+	memcpy(&w, p, sizeof(w));
+	return w;
+}
+
+#ifdef DIFF_USE_SSE2
+// Returns a bitmask of the bytes which differ between the 16 bytes at a and at b.
+static inline ut32 block_mismatch(const ut8 *a, const ut8 *b) {
+	__m128i va = _mm_loadu_si128((const __m128i *)a);
+	__m128i vb = _mm_loadu_si128((const __m128i *)b);
+	return ~(ut32)_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) & 0xffff;
+}
+
+static inline ut32 lowest_bit(ut32 mask) {
+#if defined(__GNUC__)
+	return (ut32)__builtin_ctz(mask);
+#else
+	ut32 i = 0;
+	while (!(mask & 1)) {
+		mask >>= 1;
+		i++;
+	}
+	return i;
+#endif
+}
+
+static inline ut32 highest_bit(ut32 mask) {
+#if defined(__GNUC__)
+	return 31 - (ut32)__builtin_clz(mask);
+#else
+	ut32 i = 0;
+	while (mask >>= 1) {
+		i++;
+	}
+	return i;
+#endif
+}
+#endif
+
+/* Length of the common run of a and b, up to max bytes */
+static ut32 common_forward(const ut8 *a, const ut8 *b, ut32 max) {
+	ut32 n = 0;
+#ifdef DIFF_USE_SSE2
+	while (n + 16 <= max) {
+		ut32 mismatch = block_mismatch(a + n, b + n);
+		if (mismatch) {
+			return n + lowest_bit(mismatch);
+		}
+		n += 16;
+	}
+#endif
+	while (n + sizeof(ut64) <= max && load_word(a + n) == load_word(b + n)) {
+		n += sizeof(ut64);
+	}
+	while (n < max && a[n] == b[n]) {
+		n++;
+	}
+	return n;
+}
+
+/* Length of the common run ending right before a and b, up to max bytes */
+static ut32 common_backward(const ut8 *a, const ut8 *b, ut32 max) {
+	ut32 n = 0;
+#ifdef DIFF_USE_SSE2
+	while (n + 16 <= max) {
+		ut32 mismatch = block_mismatch(a - n - 16, b - n - 16);
+		if (mismatch) {
+			return n + 15 - highest_bit(mismatch);
+		}
+		n += 16;
+	}
+#endif
+	while (n + sizeof(ut64) <= max && load_word(a - n - sizeof(ut64)) == load_word(b - n - sizeof(ut64))) {
+		n += sizeof(ut64);
+	}
+	while (n < max && a[-(st64)n - 1] == b[-(st64)n - 1]) {
+		n++;
+	}
+	return n;
+}
+
+static bool anchored_add_match(AnchoredCtx *ctx, ut32 a, ut32 b, ut32 size) {
+	if (!size) {
+		return true;
+	}
+	RzDiffMatch *match = match_new(a, b, size);
+	if (!match || !rz_list_append(ctx->matches, match)) {
+		RZ_LOG_ERROR("rz_diff_matches_new: cannot append match into matches\n");
+		free(match);
+		return false;
+	}
+	return true;
+}
+
+/*
+ * Finds where to split the edit path of a[a_low, a_hi) into b[b_low, b_hi),
+ * which must be both not empty and must not start or end with the same byte.
+ * Returns false if the block cannot be split.
+ */
+static bool myers_split(AnchoredCtx *ctx, const Block *block, ut32 *split_a, ut32 *split_b) {
+	// coordinates are relative to the gap, so the diagonals k = x - y fit the arrays
+	const ut8 *a = ctx->a + ctx->gap_a;
+	const ut8 *b = ctx->b + ctx->gap_b;
+	st64 a_low = block->a_low - ctx->gap_a, a_hi = block->a_hi - ctx->gap_a;
+	st64 b_low = block->b_low - ctx->gap_b, b_hi = block->b_hi - ctx->gap_b;
+	st64 k_min = a_low - b_hi, k_max = a_hi - b_low;
+	st64 f_mid = a_low - b_low, r_mid = a_hi - b_hi;
+	st64 f_min = f_mid, f_max = f_mid, r_min = r_mid, r_max = r_mid;
+	bool odd = (f_mid - r_mid) & 1;
+	st64 *kf = ctx->kv + ctx->gap_b_size + 1;
+	st64 *kr = kf + DIFF_MYERS_MAX_GAP + 3;
+	st64 x = 0, y = 0, k;
+
+	kf[f_mid] = a_low;
+	kr[r_mid] = a_hi;
+	for (ut32 cost = 1;; cost++) {
+		if (f_min > k_min) {
+			kf[--f_min - 1] = -1;
+		} else {
+			f_min++;
+		}
+		if (f_max < k_max) {
+			kf[++f_max + 1] = -1;
+		} else {
+			f_max--;
+		}
+		for (k = f_max; k >= f_min; k -= 2) {
+			x = kf[k - 1] >= kf[k + 1] ? kf[k - 1] + 1 : kf[k + 1];
+			y = x - k;
+			if (x < a_hi && y < b_hi) {
+				x += common_forward(a + x, b + y, RZ_MIN(a_hi - x, b_hi - y));
+			}
+			kf[k] = x;
+			y = x - k;
+			if (odd && r_min <= k && k <= r_max && kr[k] <= x) {
+				goto split;
+			}
+		}
+
+		if (r_min > k_min) {
+			kr[--r_min - 1] = ST64_MAX;
+		} else {
+			r_min++;
+		}
+		if (r_max < k_max) {
+			kr[++r_max + 1] = ST64_MAX;
+		} else {
+			r_max--;
+		}
+		for (k = r_max; k >= r_min; k -= 2) {
+			x = kr[k - 1] < kr[k + 1] ? kr[k - 1] : kr[k + 1] - 1;
+			y = x - k;
+			if (x > a_low && y > b_low) {
+				x -= common_backward(a + x, b + y, RZ_MIN(x - a_low, y - b_low));
+			}
+			kr[k] = x;
+			y = x - k;
+			if (!odd && f_min <= k && k <= f_max && x <= kf[k]) {
+				goto split;
+			}
+		}
+
+		if (cost < DIFF_MYERS_MAX_COST) {
+			continue;
+		}
+		// too expensive: split where one of the two directions went the furthest
+		st64 f_best = -1, f_best_x = a_low;
+		for (k = f_max; k >= f_min; k -= 2) {
+			x = RZ_MIN(kf[k], a_hi);
+			y = x - k;
+			if (y > b_hi) {
+				x = b_hi + k;
+				y = b_hi;
+			}
+			if (f_best < x + y) {
+				f_best = x + y;
+				f_best_x = x;
+			}
+		}
+		st64 r_best = ST64_MAX, r_best_x = a_hi;
+		for (k = r_max; k >= r_min; k -= 2) {
+			x = RZ_MAX(a_low, kr[k]);
+			y = x - k;
+			if (y < b_low) {
+				x = b_low + k;
+				y = b_low;
+			}
+			if (x + y < r_best) {
+				r_best = x + y;
+				r_best_x = x;
+			}
+		}
+		if ((a_hi + b_hi) - r_best < f_best - (a_low + b_low)) {
+			x = f_best_x;
+			y = f_best - f_best_x;
+		} else {
+			x = r_best_x;
+			y = r_best - r_best_x;
+		}
+		break;
+	}
+
+split:
+	if ((x == a_low && y == b_low) || (x == a_hi && y == b_hi)) {
+		return false;
+	}
+	*split_a = x + ctx->gap_a;
+	*split_b = y + ctx->gap_b;
+	return true;
+}
+
+/* Matches a[a_low, a_hi) with b[b_low, b_hi), the area between two anchors */
+static bool myers_matches(AnchoredCtx *ctx, ut32 a_low, ut32 a_hi, ut32 b_low, ut32 b_hi) {
+	if (a_low == a_hi || b_low == b_hi) {
+		return true;
+	} else if ((ut64)(a_hi - a_low) + (b_hi - b_low) > DIFF_MYERS_MAX_GAP) {
+		return true;
+	}
+	ctx->gap_a = a_low;
+	ctx->gap_b = b_low;
+	ctx->gap_b_size = b_hi - b_low;
+	Block *top = rz_vector_push(&ctx->stack, NULL);
+	if (!top) {
+		return false;
+	}
+	top->a_low = a_low;
+	top->a_hi = a_hi;
+	top->b_low = b_low;
+	top->b_hi = b_hi;
+	while (!rz_vector_empty(&ctx->stack)) {
+		Block block;
+		rz_vector_pop(&ctx->stack, &block);
+		ut32 n = common_forward(ctx->a + block.a_low, ctx->b + block.b_low, RZ_MIN(block.a_hi - block.a_low, block.b_hi - block.b_low));
+		if (!anchored_add_match(ctx, block.a_low, block.b_low, n)) {
+			return false;
+		}
+		block.a_low += n;
+		block.b_low += n;
+		n = common_backward(ctx->a + block.a_hi, ctx->b + block.b_hi, RZ_MIN(block.a_hi - block.a_low, block.b_hi - block.b_low));
+		if (!anchored_add_match(ctx, block.a_hi - n, block.b_hi - n, n)) {
+			return false;
+		}
+		block.a_hi -= n;
+		block.b_hi -= n;
+		if (block.a_low == block.a_hi || block.b_low == block.b_hi) {
+			continue;
+		}
+
+		ut32 split_a, split_b;
+		if (!myers_split(ctx, &block, &split_a, &split_b)) {
+			continue;
+		}
+		Block *low = rz_vector_push(&ctx->stack, NULL);
+		Block *hi = low ? rz_vector_push(&ctx->stack, NULL) : NULL;
+		if (!hi) {
+			return false;
+		}
+		low = rz_vector_index_ptr(&ctx->stack, rz_vector_len(&ctx->stack) - 2);
+		low->a_low = block.a_low;
+		low->a_hi = split_a;
+		low->b_low = block.b_low;
+		low->b_hi = split_b;
+		hi->a_low = split_a;
+		hi->a_hi = block.a_hi;
+		hi->b_low = split_b;
+		hi->b_hi = block.b_hi;
+	}
+	return true;
+}
+
+static ut64 anchor_hash(const ut8 *p) {
+	ut64 h = 0;
+	for (ut32 i = 0; i < DIFF_ANCHOR_SIZE; i++) {
+		h = h * DIFF_ANCHOR_PRIME + p[i];
+	}
+	return h;
+}
+
+typedef struct anchor_t {
+	ut32 a;
+	ut32 b;
+	ut32 size;
+	ut64 weight; ///< bytes covered by the heaviest chain ending with this anchor
+	st64 prev; ///< previous anchor of that chain, -1 if none
+} Anchor;
+
+/*
+ * Finds the anchors of a[a_low, a_hi) in b[b_low, b_hi); they are sorted by
+ * and do not overlap in A, but may come in any order in B.
+ */
+static bool collect_anchors(const ut8 *a, ut32 a_low, ut32 a_hi, const ut8 *b, ut32 b_low, ut32 b_hi, RzVector /*<Anchor>*/ *anchors) {
+	HtUUO *index = ht_uuo_new0();
+	if (!index) {
+		return false;
+	}
+	for (ut32 pos = b_low; pos + DIFF_ANCHOR_SIZE <= b_hi; pos += DIFF_ANCHOR_SIZE) {
+		// windows seen more than once would make bad anchors, like runs of padding
+		if (!ht_uuo_insert(index, anchor_hash(b + pos), pos)) {
+			ht_uuo_update(index, anchor_hash(b + pos), UT64_MAX);
+		}
+	}
+
+	ut64 pow = 1;
+	for (ut32 i = 1; i < DIFF_ANCHOR_SIZE; i++) {
+		pow *= DIFF_ANCHOR_PRIME;
+	}
+	ut32 a_last = a_low, b_last = b_low;
+	ut64 hash = 0;
+	bool rolling = false;
+	for (ut32 i = a_low; i + DIFF_ANCHOR_SIZE <= a_hi;) {
+		hash = rolling ? (hash - a[i - 1] * pow) * DIFF_ANCHOR_PRIME + a[i + DIFF_ANCHOR_SIZE - 1] : anchor_hash(a + i);
+		rolling = true;
+
+		bool found = false;
+		ut64 pos = ht_uuo_find(index, hash, &found);
+		if (!found || pos == UT64_MAX || memcmp(a + i, b + pos, DIFF_ANCHOR_SIZE)) {
+			// not a unique window, try at the same distance from the last anchor
+			pos = b_last + (ut64)(i - a_last);
+			if (pos + DIFF_ANCHOR_SIZE > b_hi || memcmp(a + i, b + pos, DIFF_ANCHOR_SIZE)) {
+				i++;
+				continue;
+			}
+		}
+
+		ut32 b_floor = pos >= b_last ? b_last : b_low;
+		ut32 back = common_backward(a + i, b + pos, RZ_MIN(i - a_last, pos - b_floor));
+		Anchor *anchor = rz_vector_push(anchors, NULL);
+		if (!anchor) {
+			ht_uuo_free(index);
+			return false;
+		}
+		anchor->a = i - back;
+		anchor->b = pos - back;
+		anchor->size = back + common_forward(a + i, b + pos, RZ_MIN(a_hi - i, b_hi - pos));
+		a_last = anchor->a + anchor->size;
+		b_last = anchor->b + anchor->size;
+		i = a_last;
+		rolling = false;
+	}
+	ht_uuo_free(index);
+	return true;
+}
+
+static int ut32_cmp(const void *a, const void *b) {
+	return RZ_NUM_CMP(*(const ut32 *)a, *(const ut32 *)b);
+}
+
+#define UT32_CMP(x, y) RZ_NUM_CMP(x, y)
+
+/*
+ * Weighs the heaviest chain of anchors increasing in both A and B that ends
+ * with each anchor, and returns the index of the heaviest of all, -1 if none.
+ * The best chain ending before an anchor starts in B is queried from a
+ * Fenwick tree of the maximums, indexed by the rank of the anchor ends in B.
+ */
+static st64 chain_anchors(RzVector /*<Anchor>*/ *anchors) {
+	size_t count = rz_vector_len(anchors);
+	if (!count) {
+		return -1;
+	}
+	ut32 *ends = RZ_NEWS(ut32, count);
+	st64 *tree = RZ_NEWS(st64, count + 1);
+	if (!ends || !tree) {
+		free(ends);
+		free(tree);
+		return -1;
+	}
+	for (size_t i = 0; i < count; i++) {
+		Anchor *anchor = rz_vector_index_ptr(anchors, i);
+		ends[i] = anchor->b + anchor->size;
+		tree[i + 1] = -1;
+	}
+	qsort(ends, count, sizeof(ut32), ut32_cmp);
+
+	st64 best = -1;
+	for (size_t i = 0; i < count; i++) {
+		Anchor *anchor = rz_vector_index_ptr(anchors, i);
+		size_t rank;
+		rz_array_upper_bound(ends, count, anchor->b, rank, UT32_CMP);
+		anchor->prev = -1;
+		for (size_t r = rank; r > 0; r -= r & -r) {
+			st64 j = tree[r];
+			if (j >= 0 && (anchor->prev < 0 || ((Anchor *)rz_vector_index_ptr(anchors, j))->weight > ((Anchor *)rz_vector_index_ptr(anchors, anchor->prev))->weight)) {
+				anchor->prev = j;
+			}
+		}
+		anchor->weight = anchor->size;
+		if (anchor->prev >= 0) {
+			anchor->weight += ((Anchor *)rz_vector_index_ptr(anchors, anchor->prev))->weight;
+		}
+		rz_array_upper_bound(ends, count, anchor->b + anchor->size, rank, UT32_CMP);
+		for (size_t r = rank; r <= count; r += r & -r) {
+			if (tree[r] < 0 || ((Anchor *)rz_vector_index_ptr(anchors, tree[r]))->weight < anchor->weight) {
+				tree[r] = i;
+			}
+		}
+		if (best < 0 || ((Anchor *)rz_vector_index_ptr(anchors, best))->weight < anchor->weight) {
+			best = i;
+		}
+	}
+	free(ends);
+	free(tree);
+	return best;
+}
+
+/*
+ * Matches a[a_low, a_hi) with b[b_low, b_hi) by the heaviest chain of their
+ * anchors. The areas around the anchors of the chain are anchored again, as
+ * dropped anchors may have hidden better ones, and once nothing is left to
+ * anchor they are matched by myers_matches().
+ */
+static bool anchored_gap(AnchoredCtx *ctx, ut32 a_low, ut32 a_hi, ut32 b_low, ut32 b_hi, ut32 depth) {
+	if (depth >= DIFF_ANCHOR_MAX_DEPTH || a_hi - a_low < DIFF_ANCHOR_SIZE || b_hi - b_low < DIFF_ANCHOR_SIZE) {
+		return myers_matches(ctx, a_low, a_hi, b_low, b_hi);
+	}
+	RzVector anchors;
+	rz_vector_init(&anchors, sizeof(Anchor), NULL, NULL);
+	if (!collect_anchors(ctx->a, a_low, a_hi, ctx->b, b_low, b_hi, &anchors)) {
+		RZ_LOG_ERROR("rz_diff_matches_new: cannot allocate anchors\n");
+		rz_vector_fini(&anchors);
+		return false;
+	}
+	st64 i = chain_anchors(&anchors);
+	if (i < 0) {
+		rz_vector_fini(&anchors);
+		return myers_matches(ctx, a_low, a_hi, b_low, b_hi);
+	}
+	// walk back the chain, matching the area that follows each anchor
+	bool ret = false;
+	for (; i >= 0;) {
+		Anchor *anchor = rz_vector_index_ptr(&anchors, i);
+		ut32 a_next = anchor->a + anchor->size;
+		ut32 b_next = anchor->b + anchor->size;
+		if (!anchored_gap(ctx, a_next, a_hi, b_next, b_hi, depth + 1) ||
+			!anchored_add_match(ctx, anchor->a, anchor->b, anchor->size)) {
+			goto end;
+		}
+		a_hi = anchor->a;
+		b_hi = anchor->b;
+		i = anchor->prev;
+	}
+	ret = anchored_gap(ctx, a_low, a_hi, b_low, b_hi, depth + 1);
+
+end:
+	rz_vector_fini(&anchors);
+	return ret;
+}
+
+/*
+ * Fills the matches of a large bytes diff.
+ * The matches are not sorted and adjacent ones are not merged.
+ */
+static bool anchored_matches(RzDiff *diff, RzList /*<RzDiffMatch>*/ *matches) {
+	const ut8 *a = diff->a;
+	const ut8 *b = diff->b;
+	ut32 a_size = diff->a_size;
+	ut32 b_size = diff->b_size;
+	bool ret = false;
+	AnchoredCtx ctx = { .a = a, .b = b, .matches = matches };
+	rz_vector_init(&ctx.stack, sizeof(Block), NULL, NULL);
+
+	ctx.kv = RZ_NEWS(st64, 2 * (DIFF_MYERS_MAX_GAP + 3));
+	if (!ctx.kv) {
+		RZ_LOG_ERROR("rz_diff_matches_new: cannot allocate myers paths\n");
+		goto end;
+	}
+
+	// the common prefix and suffix need no anchor
+	ut32 prefix = common_forward(a, b, RZ_MIN(a_size, b_size));
+	ut32 suffix = common_backward(a + a_size, b + b_size, RZ_MIN(a_size, b_size) - prefix);
+	ret = anchored_add_match(&ctx, 0, 0, prefix) &&
+		anchored_add_match(&ctx, a_size - suffix, b_size - suffix, suffix) &&
+		anchored_gap(&ctx, prefix, a_size - suffix, prefix, b_size - suffix, 0);
+
+end:
+	rz_vector_fini(&ctx.stack);
+	free(ctx.kv);
+	return ret;
+}
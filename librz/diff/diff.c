@@ -62,6 +62,7 @@
 /**/
 #include <ht_pp.h>
 #include <ht_uu.h>
+#include <ht_uuo.h>
 
 #define NUM2PTR(x) ((void *)(intptr_t)(x))
 #define PTR2NUM(x) ((intptr_t)(void *)(x))
@@ -93,6 +94,8 @@ struct rz_diff_t {
 	ut32 b_size;
 	HtPP *b_hits;
 	MethodsInternal methods;
+	bool anchored; ///< large bytes diff, matched by anchored_matches() without b_hits
+	bool histogram; ///< large lines diff, matched by histogram_matches() without b_hits
 };
 
 /**
@@ -119,7 +122,10 @@ static bool fake_ignore(const void *value) {
 	return false;
 }
 
+static RzDiffMatch *match_new(ut32 a, ut32 b, ut32 size);
+
 #include "bytes_diff.c"
+#include "anchored_diff.c"
 #include "lines_diff.c"
 #include "unified_diff.c"
 
@@ -140,6 +146,9 @@ static bool set_b(RzDiff *diff, const void *b, ut32 b_size) {
 
 	diff->b = b;
 	diff->b_size = b_size;
+	if (diff->anchored || diff->histogram) {
+		return true;
+	}
 
 	RzList *list = NULL;
 	RzDiffMethodElemAt elem_at = diff->methods.elem_at;
@@ -184,6 +193,8 @@ static bool set_b(RzDiff *diff, const void *b, ut32 b_size) {
  * Allocates the internal structure needed to diff buffers by
  * using the methods defined in methods_bytes.
  * Allows to define an callback function to ignore bytes.
+ * Without it, buffers of DIFF_ANCHORED_MIN bytes or more are matched
+ * with anchors and the Myers' algorithm (see anchored_diff.c).
  * */
 RZ_API RZ_OWN RzDiff *rz_diff_bytes_new(RZ_BORROW const ut8 *a, ut32 a_size, RZ_BORROW const ut8 *b, ut32 b_size, RZ_NULLABLE RzDiffIgnoreByte ignore) {
 	rz_return_val_if_fail(a && b, NULL);
@@ -197,6 +208,7 @@ RZ_API RZ_OWN RzDiff *rz_diff_bytes_new(RZ_BORROW const ut8 *a, ut32 a_size, RZ_
 	if (ignore) {
 		diff->methods.ignore = (RzDiffMethodIgnore)ignore;
 	}
+	diff->anchored = !ignore && (ut64)a_size + b_size >= DIFF_ANCHORED_MIN;
 
 	if (!set_a(diff, a, a_size)) {
 		rz_diff_free(diff);
@@ -215,6 +227,8 @@ RZ_API RZ_OWN RzDiff *rz_diff_bytes_new(RZ_BORROW const ut8 *a, ut32 a_size, RZ_
  * Allocates the internal structure needed to diff strings with new lines
  * using the methods defined in methods_lines.
  * Allows to define an callback function to ignore lines.
+ * Without it, strings of DIFF_HISTOGRAM_MIN lines or more are matched
+ * with the histogram diff (see lines_diff.c).
  * */
 RZ_API RZ_OWN RzDiff *rz_diff_lines_new(RZ_BORROW const char *a, RZ_BORROW const char *b, RZ_NULLABLE RzDiffIgnoreLine ignore) {
 	rz_return_val_if_fail(a && b, NULL);
@@ -224,11 +238,15 @@ RZ_API RZ_OWN RzDiff *rz_diff_lines_new(RZ_BORROW const char *a, RZ_BORROW const
 		return NULL;
 	}
 
-	RzList *a_lines = tokenize_lines(a);
-	RzList *b_lines = tokenize_lines(b);
+	DiffLinesPool *pool = lines_pool_new();
+	DiffLines *a_lines = pool ? tokenize_lines(a, pool, true) : NULL;
+	DiffLines *b_lines = a_lines ? tokenize_lines(b, pool, false) : NULL;
 	if (!a_lines || !b_lines) {
-		rz_list_free(a_lines);
-		rz_list_free(b_lines);
+		if (a_lines) {
+			line_free(a_lines);
+		} else {
+			lines_pool_free(pool);
+		}
 		free(diff);
 		return NULL;
 	}
@@ -239,11 +257,13 @@ RZ_API RZ_OWN RzDiff *rz_diff_lines_new(RZ_BORROW const char *a, RZ_BORROW const
 		diff->methods.ignore = (RzDiffMethodIgnore)ignore;
 	}
 
-	if (!set_a(diff, a_lines, rz_list_length(a_lines))) {
+	diff->histogram = !ignore && (ut64)a_lines->size + b_lines->size >= DIFF_HISTOGRAM_MIN;
+
+	if (!set_a(diff, a_lines, a_lines->size)) {
 		rz_diff_free(diff);
 		return NULL;
 	}
-	if (!set_b(diff, b_lines, rz_list_length(b_lines))) {
+	if (!set_b(diff, b_lines, b_lines->size)) {
 		rz_diff_free(diff);
 		return NULL;
 	}
@@ -510,7 +530,7 @@ RZ_API RZ_OWN RzList /*<RzDiffMatch>*/ *rz_diff_matches_new(RZ_NONNULL RzDiff *d
 		goto rz_diff_matches_new_fail;
 	}
 	non_adjacent = rz_list_newf((RzListFree)free);
-	if (!matches) {
+	if (!non_adjacent) {
 		RZ_LOG_ERROR("rz_diff_matches_new: cannot allocate non_adjacent\n");
 		goto rz_diff_matches_new_fail;
 	}
@@ -521,7 +541,15 @@ RZ_API RZ_OWN RzList /*<RzDiffMatch>*/ *rz_diff_matches_new(RZ_NONNULL RzDiff *d
 		goto rz_diff_matches_new_fail;
 	}
 
-	if (!stack_append_block(stack, 0, diff->a_size, 0, diff->b_size)) {
+	if (diff->anchored) {
+		if (!anchored_matches(diff, matches)) {
+			goto rz_diff_matches_new_fail;
+		}
+	} else if (diff->histogram) {
+		if (!histogram_matches(diff, matches)) {
+			goto rz_diff_matches_new_fail;
+		}
+	} else if (!stack_append_block(stack, 0, diff->a_size, 0, diff->b_size)) {
 		RZ_LOG_ERROR("rz_diff_matches_new: cannot append initial block "
 			     "into stack\n");
 		goto rz_diff_matches_new_fail;
@@ -58,6 +58,85 @@ out:
 	return true;
 }
 
+#define LEV_WORD_BITS 64
+
+/*
+ * Advances one 64 rows block of the bit-vector Levenshtein algorithm by one
+ * column: pv/mv are the vertical +1/-1 deltas of the block, eq the rows
+ * matching the text byte, hin the horizontal delta entering from above.
+ * Returns the horizontal delta leaving the row selected by last.
+ */
+static inline int lev_advance_block(ut64 *pv, ut64 *mv, ut64 eq, int hin, ut64 last) {
+	ut64 Pv = *pv, Mv = *mv;
+	ut64 Xv = eq | Mv;
+	if (hin < 0) {
+		eq |= 1;
+	}
+	ut64 Xh = (((eq & Pv) + Pv) ^ Pv) | eq;
+	ut64 Ph = Mv | ~(Xh | Pv);
+	ut64 Mh = Pv & Xh;
+	int hout = (Ph & last) ? 1 : (Mh & last) ? -1 : 0;
+	Ph <<= 1;
+	Mh <<= 1;
+	if (hin < 0) {
+		Mh |= 1;
+	} else if (hin > 0) {
+		Ph |= 1;
+	}
+	*pv = Mh | ~(Xv | Ph);
+	*mv = Ph & Xv;
+	return hout;
+}
+
+/*
+ * Levenshtein distance of the text a and the pattern b, with lb > 0, by the
+ * bit-parallel algorithm of G. Myers as extended to multiple words by
+ * H. Hyyrö: a column of the DP matrix is kept as the bits of its vertical
+ * deltas, so it is updated 64 cells at a time.
+ * Returns UT32_MAX if the distance is greater than max, as soon as it is known.
+ */
+static ut32 lev_bit_vector(const ut8 *a, ut32 la, const ut8 *b, ut32 lb, ut32 max, bool *oom) {
+	size_t words = (lb + LEV_WORD_BITS - 1) / LEV_WORD_BITS;
+	ut64 *peq = NULL, *pv = NULL, *mv = NULL;
+	ut32 score = lb, ret = UT32_MAX;
+
+	if (words > SIZE_MAX / sizeof(ut64) / (256 + 2) ||
+		!(peq = calloc(256 * words, sizeof(ut64))) ||
+		!(pv = malloc(words * sizeof(ut64))) ||
+		!(mv = calloc(words, sizeof(ut64)))) {
+		*oom = true;
+		goto end;
+	}
+	for (ut32 i = 0; i < lb; i++) {
+		peq[b[i] * words + i / LEV_WORD_BITS] |= 1ULL << (i % LEV_WORD_BITS);
+	}
+	memset(pv, 0xff, words * sizeof(ut64));
+
+	const ut64 high = 1ULL << (LEV_WORD_BITS - 1);
+	const ut64 last = 1ULL << ((lb - 1) % LEV_WORD_BITS);
+	for (ut32 j = 0; j < la; j++) {
+		const ut64 *eq = peq + a[j] * words;
+		// the first row of the matrix grows by one at each column
+		int h = 1;
+		size_t w = 0;
+		for (; w + 1 < words; w++) {
+			h = lev_advance_block(&pv[w], &mv[w], eq[w], h, high);
+		}
+		score += lev_advance_block(&pv[w], &mv[w], eq[w], h, last);
+		// each of the columns left can lower the score by one at most
+		if (score > max && score - max > la - j - 1) {
+			goto end;
+		}
+	}
+	ret = score;
+
+end:
+	free(peq);
+	free(pv);
+	free(mv);
+	return ret;
+}
+
 /**
  * \brief Calculates the distance between two buffers using the Levenshtein algorithm
  *
@@ -67,10 +146,23 @@ out:
  * */
 RZ_API bool rz_diff_levenstein_distance(RZ_NONNULL const ut8 *a, ut32 la, RZ_NONNULL const ut8 *b, ut32 lb, RZ_NULLABLE ut32 *distance, RZ_NULLABLE double *similarity) {
 	rz_return_val_if_fail(a && b, false);
+	return rz_diff_levenstein_distance_max(a, la, b, lb, UT32_MAX, distance, similarity);
+}
+
+/**
+ * \brief Calculates the distance between two buffers using the Levenshtein algorithm, up to a maximum
+ *
+ * Works like rz_diff_levenstein_distance(), but stops as soon as the distance is
+ * known to be greater than \p max, which makes discarding dissimilar buffers cheap.
+ * In that case distance is set to UT32_MAX and similarity to 0.
+ * */
+RZ_API bool rz_diff_levenstein_distance_max(RZ_NONNULL const ut8 *a, ut32 la, RZ_NONNULL const ut8 *b, ut32 lb, ut32 max, RZ_NULLABLE ut32 *distance, RZ_NULLABLE double *similarity) {
+	rz_return_val_if_fail(a && b, false);
 
 	const ut32 length = RZ_MAX(la, lb);
 	const ut8 *ea = a + la, *eb = b + lb, *t;
-	ut32 *d, i, j;
+	ut32 d, i;
+	bool oom = false;
 
 	for (; a < ea && b < eb && *a == *b; a++, b++) {
 	}
@@ -87,28 +179,27 @@ RZ_API bool rz_diff_levenstein_distance(RZ_NONNULL const ut8 *a, ut32 la, RZ_NON
 		b = t;
 	}
 
-	if (sizeof(ut32) > SIZE_MAX / (lb + 1) || !(d = malloc((lb + 1) * sizeof(ut32)))) {
-		return false;
-	}
-	for (i = 0; i <= lb; i++) {
-		d[i] = i;
-	}
-	for (i = 0; i < la; i++) {
-		ut32 ul = d[0];
-		d[0] = i + 1;
-		for (j = 0; j < lb; j++) {
-			ut32 u = d[j + 1];
-			d[j + 1] = a[i] == b[j] ? ul : RZ_MIN(ul, RZ_MIN(d[j], u)) + 1;
-			ul = u;
+	if (la - lb > max) {
+		d = UT32_MAX;
+	} else if (!lb) {
+		d = la;
+	} else {
+		// the shorter buffer is the pattern, so it fills the fewest words
+		d = lev_bit_vector(a, la, b, lb, max, &oom);
+		if (oom) {
+			return false;
 		}
 	}
 
 	if (distance) {
-		*distance = d[lb];
+		*distance = d;
 	}
 	if (similarity) {
-		*similarity = length ? 1.0 - (double)d[lb] / length : 1.0;
+		if (d == UT32_MAX) {
+			*similarity = 0.0;
+		} else {
+			*similarity = length ? 1.0 - (double)d / length : 1.0;
+		}
 	}
-	free(d);
 	return true;
 }
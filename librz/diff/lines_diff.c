@@ -2,69 +2,156 @@
 // SPDX-FileCopyrightText: 2021 deroad <wargio@libero.it>
 // SPDX-License-Identifier: LGPL-3.0-only
 
-/* Helpers for handling lines */
+/* Helpers for handling lines
+ *
+ * The lines of A and B are interned in a pool shared by both inputs, so equal
+ * lines have the same pointer and the same id: lines are compared and hashed
+ * by pointer and the large inputs are matched on arrays of ids.
+ *
+ * From DIFF_HISTOGRAM_MIN lines in total the inputs are matched with the
+ * histogram diff instead of the Ratcliff/Obershelp matcher, whose hit lists
+ * explode on dumps repeating the same lines. After removing the common head
+ * and tail of a block, the lines of A are counted and chained by id, then B is
+ * scanned for the common run with the rarest line, taking the longest one on
+ * ties; the blocks on both sides of the run are matched the same way. A block
+ * whose lines all appear more than DIFF_HISTOGRAM_MAX_CHAIN times in A is left
+ * as replaced.
+ */
 #define DIFF_IS_LINES_METHOD(x) (x.elem_at == methods_lines.elem_at)
 
-static RzList *tokenize_lines(const char *string) {
-	RzList *lines = NULL;
-	size_t last = 0;
-	size_t size = 0;
-	char *line = NULL;
+#define DIFF_HISTOGRAM_MIN       0x4000
+#define DIFF_HISTOGRAM_MAX_CHAIN 64
+#define DIFF_HISTOGRAM_NONE      UT32_MAX
 
-	lines = rz_list_newf((RzListFree)free);
-	if (!lines) {
+typedef struct diff_lines_pool_t {
+	HtPP *ht; ///< line -> id + 1, owns the lines
+} DiffLinesPool;
+
+typedef struct diff_lines_t {
+	const char **lines; ///< interned lines
+	ut32 *ids;
+	ut32 size;
+	DiffLinesPool *pool; ///< shared by A and B, owned by A
+	bool owns_pool;
+} DiffLines;
+
+static void line_free(DiffLines *lines);
+
+static DiffLinesPool *lines_pool_new(void) {
+	DiffLinesPool *pool = RZ_NEW0(DiffLinesPool);
+	if (!pool || !(pool->ht = ht_pp_new0())) {
+		free(pool);
+		return NULL;
+	}
+	pool->ht->opt.dupkey = NULL; // the lines are allocated once by lines_intern()
+	return pool;
+}
+
+static void lines_pool_free(DiffLinesPool *pool) {
+	if (!pool) {
+		return;
+	}
+	ht_pp_free(pool->ht);
+	free(pool);
+}
+
+static bool lines_intern(DiffLines *lines, const char *line, size_t len, RzStrBuf *tmp) {
+	if (!rz_strbuf_setbin(tmp, (const ut8 *)line, len)) {
+		return false;
+	}
+	HtPPKv *kv = ht_pp_find_kv(lines->pool->ht, rz_strbuf_get(tmp), NULL);
+	if (kv) {
+		lines->lines[lines->size] = kv->key;
+		lines->ids[lines->size++] = PTR2NUM(kv->value) - 1;
+		return true;
+	}
+	ut32 id = lines->pool->ht->count;
+	char *copy = rz_str_ndup(line, len);
+	if (!copy || !ht_pp_insert(lines->pool->ht, copy, NUM2PTR(id + 1))) {
+		free(copy);
+		return false;
+	}
+	lines->lines[lines->size] = copy;
+	lines->ids[lines->size++] = id;
+	return true;
+}
+
+static DiffLines *tokenize_lines(const char *string, DiffLinesPool *pool, bool owns_pool) {
+	RzStrBuf tmp;
+	rz_strbuf_init(&tmp);
+	size_t size = strlen(string);
+	size_t count = 0;
+	for (const char *p = string; (p = memchr(p, '\n', size - (p - string))); p++) {
+		count++;
+	}
+	count++;
+
+	DiffLines *lines = RZ_NEW0(DiffLines);
+	if (!lines || count > UT32_MAX) {
+		RZ_LOG_ERROR("rz_diff_line_new: cannot allocate list of lines\n");
+		free(lines);
+		return NULL;
+	}
+	lines->pool = pool;
+	lines->owns_pool = owns_pool;
+	lines->lines = RZ_NEWS(const char *, count);
+	lines->ids = RZ_NEWS(ut32, count);
+	if (!lines->lines || !lines->ids) {
 		RZ_LOG_ERROR("rz_diff_line_new: cannot allocate list of lines\n");
 		goto tokenize_newlines_fail;
 	}
 
-	size = strlen(string);
-	for (size_t i = 0; i < size; ++i) {
-		if (string[i] == '\n') {
-			line = rz_str_ndup(string + last, (i + 1) - last);
-			if (!line || !rz_list_append(lines, line)) {
-				RZ_LOG_ERROR("rz_diff_line_new: cannot allocate line or add it to the list\n");
-				free(line);
-				goto tokenize_newlines_fail;
-			}
-			last = i + 1;
+	const char *line = string;
+	const char *end = string + size;
+	for (const char *nl; line < end && (nl = memchr(line, '\n', end - line)); line = nl + 1) {
+		if (!lines_intern(lines, line, (nl + 1) - line, &tmp)) {
+			RZ_LOG_ERROR("rz_diff_line_new: cannot allocate line or add it to the list\n");
+			goto tokenize_newlines_fail;
 		}
 	}
 
-	if (last < size) {
-		line = rz_str_ndup(string + last, size - last);
-		if (!line || !rz_list_append(lines, line)) {
-			RZ_LOG_ERROR("rz_diff_line_new: cannot allocate last line or add it to the list\n");
-			free(line);
-			goto tokenize_newlines_fail;
-		}
+	if (line < end && !lines_intern(lines, line, end - line, &tmp)) {
+		RZ_LOG_ERROR("rz_diff_line_new: cannot allocate last line or add it to the list\n");
+		goto tokenize_newlines_fail;
 	}
 
+	rz_strbuf_fini(&tmp);
 	return lines;
 
 tokenize_newlines_fail:
-	rz_list_free(lines);
+	rz_strbuf_fini(&tmp);
+	line_free(lines);
 	return NULL;
 }
 
-static const void *line_elem_at(const RzList *array, ut32 index) {
-	return rz_list_get_n(array, index);
+static const void *line_elem_at(const DiffLines *array, ut32 index) {
+	return array->lines[index];
 }
 
 static int line_compare(const char *a_elem, const char *b_elem) {
-	return strcmp(a_elem, b_elem);
+	// interned
+	return a_elem != b_elem;
 }
 
 static ut32 line_hash(const char *elem) {
-	ut32 size = strlen(elem);
-	return rz_diff_hash_data((const ut8 *)elem, size);
+	ut64 p = PTR2NUM(elem);
+	return (ut32)((p >> 4) ^ (p >> 32)) * 0x9e3779b1u;
 }
 
 static void line_stringify(const char *a_elem, RzStrBuf *sb) {
 	rz_strbuf_set(sb, a_elem);
 }
 
-static void line_free(RzList *array) {
-	rz_list_free(array);
+static void line_free(DiffLines *lines) {
+	if (!lines) {
+		return;
+	}
+	if (lines->owns_pool) {
+		lines_pool_free(lines->pool);
+	}
+	free(lines->lines);
+	free(lines->ids);
+	free(lines);
 }
 
 static const MethodsInternal methods_lines = {
@@ -75,3 +162,149 @@ static const MethodsInternal methods_lines = {
 	.ignore /*   */ = fake_ignore,
 	.free /*     */ = (RzDiffMethodFree)line_free,
 };
+
+typedef struct histogram_ctx_t {
+	const ut32 *a;
+	const ut32 *b;
+	ut32 *count; ///< occurrences of each id in the block of A
+	ut32 *last; ///< last position of each id in the block of A
+	ut32 *prev; ///< previous position of the same id in the block of A
+	RzList /*<RzDiffMatch>*/ *matches;
+	RzVector /*<Block>*/ stack;
+} HistogramCtx;
+
+static bool histogram_add_match(HistogramCtx *ctx, ut32 a, ut32 b, ut32 size) {
+	if (!size) {
+		return true;
+	}
+	RzDiffMatch *match = match_new(a, b, size);
+	if (!match || !rz_list_append(ctx->matches, match)) {
+		RZ_LOG_ERROR("rz_diff_matches_new: cannot append match into matches\n");
+		free(match);
+		return false;
+	}
+	return true;
+}
+
+/* Finds the common run of the block containing the rarest line of A, returns its size */
+static ut32 histogram_best_run(HistogramCtx *ctx, const Block *block, ut32 *best_a, ut32 *best_b) {
+	const ut32 *a = ctx->a, *b = ctx->b;
+	ut32 best_size = 0, best_count = DIFF_HISTOGRAM_MAX_CHAIN + 1;
+	for (ut32 b_pos = block->b_low; b_pos < block->b_hi;) {
+		ut32 count = ctx->count[b[b_pos]];
+		ut32 b_next = b_pos + 1;
+		if (!count || count > best_count) {
+			b_pos = b_next;
+			continue;
+		}
+		for (ut32 a_pos = ctx->last[b[b_pos]]; a_pos != DIFF_HISTOGRAM_NONE; a_pos = ctx->prev[a_pos]) {
+			ut32 as = a_pos, bs = b_pos, ae = a_pos + 1, be = b_pos + 1;
+			ut32 run_count = count;
+			while (as > block->a_low && bs > block->b_low && a[as - 1] == b[bs - 1]) {
+				as--;
+				bs--;
+				run_count = RZ_MIN(run_count, ctx->count[a[as]]);
+			}
+			while (ae < block->a_hi && be < block->b_hi && a[ae] == b[be]) {
+				run_count = RZ_MIN(run_count, ctx->count[a[ae]]);
+				ae++;
+				be++;
+			}
+			b_next = RZ_MAX(b_next, be);
+			if (run_count < best_count || (run_count == best_count && ae - as > best_size)) {
+				*best_a = as;
+				*best_b = bs;
+				best_size = ae - as;
+				best_count = run_count;
+			}
+		}
+		b_pos = b_next;
+	}
+	return best_size;
+}
+
+static bool histogram_match_block(HistogramCtx *ctx, Block block) {
+	const ut32 *a = ctx->a, *b = ctx->b;
+	ut32 n = 0;
+	while (block.a_low + n < block.a_hi && block.b_low + n < block.b_hi && a[block.a_low + n] == b[block.b_low + n]) {
+		n++;
+	}
+	if (!histogram_add_match(ctx, block.a_low, block.b_low, n)) {
+		return false;
+	}
+	block.a_low += n;
+	block.b_low += n;
+	n = 0;
+	while (block.a_hi - n > block.a_low && block.b_hi - n > block.b_low && a[block.a_hi - n - 1] == b[block.b_hi - n - 1]) {
+		n++;
+	}
+	if (!histogram_add_match(ctx, block.a_hi - n, block.b_hi - n, n)) {
+		return false;
+	}
+	block.a_hi -= n;
+	block.b_hi -= n;
+	if (block.a_low == block.a_hi || block.b_low == block.b_hi) {
+		return true;
+	}
+
+	for (ut32 i = block.a_low; i < block.a_hi; i++) {
+		ctx->prev[i] = ctx->last[a[i]];
+		ctx->last[a[i]] = i;
+		ctx->count[a[i]]++;
+	}
+	ut32 best_a = 0, best_b = 0;
+	ut32 size = histogram_best_run(ctx, &block, &best_a, &best_b);
+	for (ut32 i = block.a_low; i < block.a_hi; i++) {
+		ctx->last[a[i]] = DIFF_HISTOGRAM_NONE;
+		ctx->count[a[i]] = 0;
+	}
+	if (!size) {
+		return true;
+	}
+
+	Block low = { block.a_low, best_a, block.b_low, best_b };
+	Block high = { best_a + size, block.a_hi, best_b + size, block.b_hi };
+	return histogram_add_match(ctx, best_a, best_b, size) &&
+		rz_vector_push(&ctx->stack, &low) && rz_vector_push(&ctx->stack, &high);
+}
+
+/* Fills matches with the runs of lines common to A and B, in any order */
+static bool histogram_matches(RzDiff *diff, RzList /*<RzDiffMatch>*/ *matches) {
+	const DiffLines *a = diff->a;
+	const DiffLines *b = diff->b;
+	ut32 ids = a->pool->ht->count;
+	bool ret = false;
+	HistogramCtx ctx = {
+		.a = a->ids,
+		.b = b->ids,
+		.count = RZ_NEWS0(ut32, RZ_MAX(ids, 1)),
+		.last = RZ_NEWS(ut32, RZ_MAX(ids, 1)),
+		.prev = RZ_NEWS(ut32, RZ_MAX(a->size, 1)),
+		.matches = matches,
+	};
+	rz_vector_init(&ctx.stack, sizeof(Block), NULL, NULL);
+	if (!ctx.count || !ctx.last || !ctx.prev) {
+		RZ_LOG_ERROR("rz_diff_matches_new: cannot allocate histogram\n");
+		goto end;
+	}
+	memset(ctx.last, 0xff, RZ_MAX(ids, 1) * sizeof(ut32));
+
+	Block block = { 0, a->size, 0, b->size };
+	if (!rz_vector_push(&ctx.stack, &block)) {
+		goto end;
+	}
+	while (!rz_vector_empty(&ctx.stack)) {
+		rz_vector_pop(&ctx.stack, &block);
+		if (!histogram_match_block(&ctx, block)) {
+			goto end;
+		}
+	}
+	ret = true;
+
+end:
+	rz_vector_fini(&ctx.stack);
+	free(ctx.count);
+	free(ctx.last);
+	free(ctx.prev);
+	return ret;
+}
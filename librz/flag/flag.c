@@ -31,18 +31,157 @@ static const char *str_callback(RzNum *user, ut64 off, int *ok) {
 	return NULL;
 }
 
-static void flag_skiplist_free(void *data) {
+static void flags_at_free(void *data) {
 	RzFlagsAtOffset *item = (RzFlagsAtOffset *)data;
 	rz_list_free(item->flags);
 	free(data);
 }
 
-static int flag_skiplist_cmp(const void *va, const void *vb) {
-	const RzFlagsAtOffset *a = (RzFlagsAtOffset *)va, *b = (RzFlagsAtOffset *)vb;
-	if (a->off == b->off) {
-		return 0;
+#define FLAGS_AT_CMP(x, elem) RZ_NUM_CMP(x, ((RzFlagsAtOffset *)(elem))->off)
+#define FLAGS_AT_DEAD(x)      rz_list_empty(((RzFlagsAtOffset *)(x))->flags)
+
+#define FLAGS_PENDING_MIN 0x400
+#define FLAGS_PENDING_MAX 0x40000
+
+/*
+ * by_off is kept sorted: offsets added past its end are appended, the ones
+ * added out of order wait in the by_off_pending tree and offsets left
+ * without flags stay in by_off as tombstones. Both are folded into by_off
+ * once they grow past a fraction of it, so interleaving flag changes with
+ * ordered lookups, like the analysis does, never costs more than a merge
+ * every few thousand changes.
+ */
+typedef struct {
+	RBNode rb;
+	RzFlagsAtOffset *flags;
+} FlagsAtPending;
+
+typedef struct {
+	size_t i; ///< next candidate in by_off
+	RBIter pending; ///< next candidate in by_off_pending
+} FlagsAtIter;
+
+static int pending_cmp(const void *incoming, const RBNode *in_tree, void *user) {
+	ut64 off = *(const ut64 *)incoming;
+	const FlagsAtPending *pend = container_of(in_tree, const FlagsAtPending, rb);
+	return RZ_NUM_CMP(off, pend->flags->off);
+}
+
+static void pending_free(RBNode *node, void *user) {
+	free(container_of(node, FlagsAtPending, rb));
+}
+
+static void pending_free_flags(RBNode *node, void *user) {
+	FlagsAtPending *pend = container_of(node, FlagsAtPending, rb);
+	flags_at_free(pend->flags);
+	free(pend);
+}
+
+static size_t by_off_limit(RzFlag *f) {
+	return RZ_MAX(FLAGS_PENDING_MIN, RZ_MIN(FLAGS_PENDING_MAX, rz_pvector_len(f->by_off) / 8));
+}
+
+/*
+ * Drop the tombstones of by_off and merge the pending offsets into it
+ */
+static bool by_off_merge(RzFlag *f) {
+	void **a = rz_pvector_data(f->by_off);
+	size_t i, n = 0, len = rz_pvector_len(f->by_off);
+	for (i = 0; i < len; i++) {
+		if (FLAGS_AT_DEAD(a[i])) {
+			flags_at_free(a[i]);
+		} else {
+			a[n++] = a[i];
+		}
+	}
+	if (n < len) {
+		rz_vector_remove_range(&f->by_off->v, n, len - n, NULL);
 	}
-	return a->off < b->off ? -1 : 1;
+	f->by_off_dead = 0;
+	size_t k = n + f->by_off_pending_count;
+	if (!rz_pvector_reserve(f->by_off, k)) {
+		return false;
+	}
+	while (rz_pvector_len(f->by_off) < k) {
+		rz_pvector_push(f->by_off, NULL);
+	}
+	// merge from the back, the sorted ones only move towards the end
+	a = rz_pvector_data(f->by_off);
+	RBIter it = rz_rbtree_last(f->by_off_pending);
+	while (rz_rbtree_iter_has(&it)) {
+		RzFlagsAtOffset *flags = rz_rbtree_iter_get(&it, FlagsAtPending, rb)->flags;
+		while (n && ((RzFlagsAtOffset *)a[n - 1])->off > flags->off) {
+			a[--k] = a[--n];
+		}
+		a[--k] = flags;
+		rz_rbtree_iter_prev(&it);
+	}
+	rz_rbtree_free(f->by_off_pending, pending_free, NULL);
+	f->by_off_pending = NULL;
+	f->by_off_pending_count = 0;
+	return true;
+}
+
+static bool by_off_add(RzFlag *f, RzFlagsAtOffset *flags) {
+	size_t len = rz_pvector_len(f->by_off);
+	if (!len || ((RzFlagsAtOffset *)rz_pvector_tail(f->by_off))->off < flags->off) {
+		return rz_pvector_push(f->by_off, flags) != NULL;
+	}
+	FlagsAtPending *pend = RZ_NEW(FlagsAtPending);
+	if (!pend) {
+		return false;
+	}
+	pend->flags = flags;
+	rz_rbtree_insert(&f->by_off_pending, &flags->off, &pend->rb, pending_cmp, NULL);
+	if (++f->by_off_pending_count >= by_off_limit(f)) {
+		by_off_merge(f);
+	}
+	return true;
+}
+
+/* position \p it on the first offset >= \p off */
+static void flags_at_iter_seek(RzFlag *f, FlagsAtIter *it, ut64 off) {
+	rz_pvector_lower_bound(f->by_off, off, it->i, FLAGS_AT_CMP);
+	it->pending = rz_rbtree_lower_bound_forward(f->by_off_pending, &off, pending_cmp, NULL);
+}
+
+/* position \p it on the last offset <= \p off, to be walked with flags_at_iter_prev() */
+static void flags_at_iter_seek_back(RzFlag *f, FlagsAtIter *it, ut64 off) {
+	rz_pvector_upper_bound(f->by_off, off, it->i, FLAGS_AT_CMP);
+	it->pending = rz_rbtree_upper_bound_backward(f->by_off_pending, &off, pending_cmp, NULL);
+}
+
+static RzFlagsAtOffset *flags_at_iter_next(RzFlag *f, FlagsAtIter *it) {
+	size_t len = rz_pvector_len(f->by_off);
+	while (it->i < len && FLAGS_AT_DEAD(rz_pvector_at(f->by_off, it->i))) {
+		it->i++;
+	}
+	RzFlagsAtOffset *a = it->i < len ? rz_pvector_at(f->by_off, it->i) : NULL;
+	RzFlagsAtOffset *b = rz_rbtree_iter_has(&it->pending) ? rz_rbtree_iter_get(&it->pending, FlagsAtPending, rb)->flags : NULL;
+	if (b && (!a || b->off < a->off)) {
+		rz_rbtree_iter_next(&it->pending);
+		return b;
+	}
+	if (a) {
+		it->i++;
+	}
+	return a;
+}
+
+static RzFlagsAtOffset *flags_at_iter_prev(RzFlag *f, FlagsAtIter *it) {
+	while (it->i && FLAGS_AT_DEAD(rz_pvector_at(f->by_off, it->i - 1))) {
+		it->i--;
+	}
+	RzFlagsAtOffset *a = it->i ? rz_pvector_at(f->by_off, it->i - 1) : NULL;
+	RzFlagsAtOffset *b = rz_rbtree_iter_has(&it->pending) ? rz_rbtree_iter_get(&it->pending, FlagsAtPending, rb)->flags : NULL;
+	if (b && (!a || b->off > a->off)) {
+		rz_rbtree_iter_prev(&it->pending);
+		return b;
+	}
+	if (a) {
+		it->i--;
+	}
+	return a;
 }
 
 static ut64 num_callback(RzNum *user, const char *name, int *ok) {
@@ -64,16 +203,15 @@ static ut64 num_callback(RzNum *user, const char *name, int *ok) {
 	return 0LL;
 }
 
-static void free_item_realname(RzFlagItem *item) {
-	if (item->name != item->realname) {
-		free(item->realname);
-	}
-}
+/*
+ * Names and realnames are interned in the global pool, so the names of
+ * symbols, imports and relocs shared by several flags are stored once and
+ * the keys of ht_name are the names of the items themselves.
+ */
+#define NAMES rz_str_intern_global()
 
-static void free_item_name(RzFlagItem *item) {
-	if (item->name != item->realname) {
-		free(item->name);
-	}
+static char *intern_name(const char *name) {
+	return (char *)rz_str_intern_get(NAMES, name);
 }
 
 /* return the list of flag at the nearest position.
@@ -81,21 +219,38 @@ static void free_item_name(RzFlagItem *item) {
    dir == 0 ->  result == off
    dir == 1 ->  result >= off*/
 static RzFlagsAtOffset *rz_flag_get_nearest_list(RzFlag *f, ut64 off, int dir) {
-	RzFlagsAtOffset key = { .off = off };
-	RzFlagsAtOffset *flags = (dir >= 0)
-		? rz_skiplist_get_geq(f->by_off, &key)
-		: rz_skiplist_get_leq(f->by_off, &key);
-	return (dir == 0 && flags && flags->off != off) ? NULL : flags;
+	if (!dir) {
+		return ht_up_find(f->ht_off, off, NULL);
+	}
+	FlagsAtIter it;
+	if (dir > 0) {
+		flags_at_iter_seek(f, &it, off);
+		return flags_at_iter_next(f, &it);
+	}
+	flags_at_iter_seek_back(f, &it, off);
+	return flags_at_iter_prev(f, &it);
 }
 
 static void remove_offsetmap(RzFlag *f, RzFlagItem *item) {
 	rz_return_if_fail(f && item);
 	RzFlagsAtOffset *flags = rz_flag_get_nearest_list(f, item->offset, 0);
-	if (flags) {
-		rz_list_delete_data(flags->flags, item);
-		if (rz_list_empty(flags->flags)) {
-			rz_skiplist_delete(f->by_off, flags);
-		}
+	if (!flags) {
+		return;
+	}
+	rz_list_delete_data(flags->flags, item);
+	if (!rz_list_empty(flags->flags)) {
+		return;
+	}
+	ut64 off = flags->off;
+	ht_up_delete(f->ht_off, off);
+	if (rz_rbtree_delete(&f->by_off_pending, &off, pending_cmp, NULL, pending_free, NULL)) {
+		f->by_off_pending_count--;
+		flags_at_free(flags);
+		return;
+	}
+	// left in by_off as a tombstone
+	if (++f->by_off_dead >= by_off_limit(f)) {
+		by_off_merge(f);
 	}
 }
 
@@ -105,6 +260,18 @@ static RzFlagsAtOffset *flags_at_offset(RzFlag *f, ut64 off) {
 		return res;
 	}
 
+	// bring back the tombstone of the offset if there is one
+	size_t i;
+	rz_pvector_lower_bound(f->by_off, off, i, FLAGS_AT_CMP);
+	if (i < rz_pvector_len(f->by_off) && ((RzFlagsAtOffset *)rz_pvector_at(f->by_off, i))->off == off) {
+		res = rz_pvector_at(f->by_off, i);
+		if (!ht_up_insert(f->ht_off, off, res)) {
+			return NULL;
+		}
+		f->by_off_dead--;
+		return res;
+	}
+
 	// there is no existing flagsAtOffset, we create one now
 	res = RZ_NEW(RzFlagsAtOffset);
 	if (!res) {
@@ -118,7 +285,15 @@ static RzFlagsAtOffset *flags_at_offset(RzFlag *f, ut64 off) {
 	}
 
 	res->off = off;
-	rz_skiplist_insert(f->by_off, res);
+	if (!ht_up_insert(f->ht_off, off, res)) {
+		flags_at_free(res);
+		return NULL;
+	}
+	if (!by_off_add(f, res)) {
+		ht_up_delete(f->ht_off, off);
+		flags_at_free(res);
+		return NULL;
+	}
 	return res;
 }
 
@@ -133,11 +308,12 @@ static char *filter_item_name(const char *name) {
 	return res;
 }
 
+// takes the reference to the interned name
 static void set_name(RzFlagItem *item, char *name) {
-	free_item_name(item);
+	rz_str_intern_put(NAMES, item->name);
 	item->name = name;
-	free_item_realname(item);
-	item->realname = item->name;
+	rz_str_intern_put(NAMES, item->realname);
+	item->realname = (char *)rz_str_intern_ref(NAMES, name);
 }
 
 static bool update_flag_item_offset(RzFlag *f, RzFlagItem *item, ut64 newoff, bool is_new, bool force) {
@@ -146,6 +322,7 @@ static bool update_flag_item_offset(RzFlag *f, RzFlagItem *item, ut64 newoff, bo
 			remove_offsetmap(f, item);
 		}
 		item->offset = newoff;
+		f->generation++;
 
 		RzFlagsAtOffset *flagsAtOffset = flags_at_offset(f, newoff);
 		if (!flagsAtOffset) {
@@ -166,7 +343,12 @@ static bool update_flag_item_name(RzFlag *f, RzFlagItem *item, const char *newna
 	if (!force && (item->name == newname || (item->name && !strcmp(item->name, newname)))) {
 		return false;
 	}
-	char *fname = filter_item_name(newname);
+	char *filtered = filter_item_name(newname);
+	if (!filtered) {
+		return false;
+	}
+	char *fname = intern_name(filtered);
+	free(filtered);
 	if (!fname) {
 		return false;
 	}
@@ -175,17 +357,29 @@ static bool update_flag_item_name(RzFlag *f, RzFlagItem *item, const char *newna
 		: ht_pp_insert(f->ht_name, fname, item);
 	if (res) {
 		set_name(item, fname);
+		f->generation++;
 		return true;
 	}
-	free(fname);
+	rz_str_intern_put(NAMES, fname);
 	return false;
 }
 
 static void ht_free_flag(HtPPKv *kv) {
-	free(kv->key);
+	// the key is the name of the item
 	rz_flag_item_free(kv->value);
 }
 
+static HtPP *ht_name_new(void) {
+	HtPPOptions opt = {
+		.cmp = (HtPPListComparator)strcmp,
+		.hashfn = (HtPPHashFunction)sdb_hash,
+		.calcsizeK = (HtPPCalcSizeK)strlen,
+		.freefn = ht_free_flag,
+		.elem_size = sizeof(HtPPKv),
+	};
+	return ht_pp_new_opt(&opt);
+}
+
 static bool count_flags(RzFlagItem *fi, void *user) {
 	int *count = (int *)user;
 	(*count)++;
@@ -230,8 +424,13 @@ RZ_API RzFlag *rz_flag_new(void) {
 	f->base = 0;
 	f->zones = NULL;
 	f->tags = sdb_new0();
-	f->ht_name = ht_pp_new(NULL, ht_free_flag, NULL);
-	f->by_off = rz_skiplist_new(flag_skiplist_free, flag_skiplist_cmp);
+	f->ht_name = ht_name_new();
+	f->by_off = rz_pvector_new(flags_at_free);
+	f->ht_off = ht_up_new0();
+	if (!f->by_off || !f->ht_off) {
+		rz_flag_free(f);
+		return NULL;
+	}
 	rz_list_free(f->zones);
 	new_spaces(f);
 	return f;
@@ -247,8 +446,8 @@ RZ_API RzFlagItem *rz_flag_item_clone(RzFlagItem *item) {
 	n->color = STRDUP_OR_NULL(item->color);
 	n->comment = STRDUP_OR_NULL(item->comment);
 	n->alias = STRDUP_OR_NULL(item->alias);
-	n->name = STRDUP_OR_NULL(item->name);
-	n->realname = STRDUP_OR_NULL(item->realname);
+	n->name = (char *)rz_str_intern_ref(NAMES, item->name);
+	n->realname = (char *)rz_str_intern_ref(NAMES, item->realname);
 	n->offset = item->offset;
 	n->size = item->size;
 	n->space = item->space;
@@ -262,16 +461,19 @@ RZ_API void rz_flag_item_free(RzFlagItem *item) {
 	free(item->color);
 	free(item->comment);
 	free(item->alias);
-	/* release only one of the two pointers if they are the same */
-	free_item_name(item);
-	free(item->realname);
+	rz_str_intern_put(NAMES, item->name);
+	rz_str_intern_put(NAMES, item->realname);
+	RZ_MEM_UNTRACK(item);
 	free(item);
 }
 
 RZ_API RzFlag *rz_flag_free(RzFlag *f) {
 	rz_return_val_if_fail(f, NULL);
-	rz_skiplist_free(f->by_off);
+	ht_up_free(f->ht_off);
+	rz_pvector_free(f->by_off);
+	rz_rbtree_free(f->by_off_pending, pending_free_flags, NULL);
 	ht_pp_free(f->ht_name);
+	rz_pvector_free(f->by_name);
 	sdb_free(f->tags);
 	rz_spaces_fini(&f->spaces);
 	rz_num_free(f->num);
@@ -406,11 +608,8 @@ RZ_API RzFlagItem *rz_flag_get_at(RzFlag *f, ut64 off, bool closest) {
 
 	RzFlagItem *nice = NULL;
 	RzListIter *iter;
-	const RzFlagsAtOffset *flags_at = rz_flag_get_nearest_list(f, off, -1);
-	if (!flags_at) {
-		return NULL;
-	}
-	if (flags_at->off == off) {
+	const RzFlagsAtOffset *flags_at = ht_up_find(f->ht_off, off, NULL);
+	if (flags_at) {
 		RzFlagItem *item;
 		rz_list_foreach (flags_at->flags, iter, item) {
 			if (IS_FI_NOTIN_SPACE(f, item)) {
@@ -432,24 +631,21 @@ RZ_API RzFlagItem *rz_flag_get_at(RzFlag *f, ut64 off, bool closest) {
 	if (!closest) {
 		return NULL;
 	}
-	while (!nice && flags_at) {
+	// walk back through the offsets before
+	FlagsAtIter it;
+	flags_at_iter_seek_back(f, &it, off);
+	while (!nice && (flags_at = flags_at_iter_prev(f, &it))) {
+		if (flags_at->off == off) {
+			continue;
+		}
 		RzFlagItem *item;
 		rz_list_foreach (flags_at->flags, iter, item) {
 			if (IS_FI_NOTIN_SPACE(f, item)) {
 				continue;
 			}
-			if (item->offset == off) {
-				eprintf("XXX Should never happend\n");
-				return evalFlag(f, item);
-			}
 			nice = item;
 			break;
 		}
-		if (!nice && flags_at->off) {
-			flags_at = rz_flag_get_nearest_list(f, flags_at->off - 1, -1);
-		} else {
-			flags_at = NULL;
-		}
 	}
 	return nice ? evalFlag(f, nice) : NULL;
 }
@@ -530,7 +726,10 @@ RZ_API RzFlagItem *rz_flag_set(RzFlag *f, const char *name, ut64 off, ut32 size)
 	RzFlagItem *item = rz_flag_get(f, itemname);
 	free(itemname);
 	if (item && item->offset == off) {
-		item->size = size;
+		if (item->size != size) {
+			item->size = size;
+			f->generation++;
+		}
 		return item;
 	}
 
@@ -539,6 +738,7 @@ RZ_API RzFlagItem *rz_flag_set(RzFlag *f, const char *name, ut64 off, ut32 size)
 		if (!item) {
 			goto err;
 		}
+		RZ_MEM_TRACK(RZ_MEM_ACCOUNT_FLAG, item, sizeof(RzFlagItem));
 		is_new = true;
 	}
 
@@ -570,8 +770,8 @@ RZ_API void rz_flag_item_set_comment(RzFlagItem *item, const char *comment) {
 /* add/replace/remove the realname of a flag item */
 RZ_API void rz_flag_item_set_realname(RzFlagItem *item, const char *realname) {
 	rz_return_if_fail(item);
-	free_item_realname(item);
-	item->realname = RZ_STR_ISEMPTY(realname) ? NULL : strdup(realname);
+	rz_str_intern_put(NAMES, item->realname);
+	item->realname = RZ_STR_ISEMPTY(realname) ? NULL : intern_name(realname);
 }
 
 /* add/replace/remove the color of a flag item */
@@ -598,6 +798,7 @@ RZ_API bool rz_flag_unset(RzFlag *f, RzFlagItem *item) {
 	rz_return_val_if_fail(f && item, false);
 	remove_offsetmap(f, item);
 	ht_pp_delete(f->ht_name, item->name);
+	f->generation++;
 	return true;
 }
 
@@ -677,10 +878,17 @@ RZ_API bool rz_flag_unset_name(RzFlag *f, const char *name) {
 RZ_API void rz_flag_unset_all(RzFlag *f) {
 	rz_return_if_fail(f);
 	ht_pp_free(f->ht_name);
-	f->ht_name = ht_pp_new(NULL, ht_free_flag, NULL);
-	rz_skiplist_purge(f->by_off);
+	f->ht_name = ht_name_new();
+	ht_up_free(f->ht_off);
+	f->ht_off = ht_up_new0();
+	rz_pvector_clear(f->by_off);
+	rz_rbtree_free(f->by_off_pending, pending_free_flags, NULL);
+	f->by_off_pending = NULL;
+	f->by_off_pending_count = 0;
+	f->by_off_dead = 0;
 	rz_spaces_fini(&f->spaces);
 	new_spaces(f);
+	f->generation++;
 }
 
 /**
@@ -780,23 +988,33 @@ RZ_API int rz_flag_count(RzFlag *f, const char *glob) {
 	return count;
 }
 
-#define FOREACH_BODY(condition) \
-	RzSkipListNode *it, *tmp; \
-	RzFlagsAtOffset *flags_at; \
+/* iterates the offsets in [from, to], callbacks may change the flags */
+#define FOREACH_BODY_RANGE(from, to, condition) \
 	RzListIter *it2, *tmp2; \
 	RzFlagItem *fi; \
-	rz_skiplist_foreach_safe(f->by_off, it, tmp, flags_at) { \
-		if (flags_at) { \
-			rz_list_foreach_safe (flags_at->flags, it2, tmp2, fi) { \
-				if (condition) { \
-					if (!cb(fi, user)) { \
-						return; \
-					} \
+	RzFlagsAtOffset *flags_at; \
+	FlagsAtIter fit; \
+	flags_at_iter_seek(f, &fit, from); \
+	while ((flags_at = flags_at_iter_next(f, &fit)) && flags_at->off <= (to)) { \
+		ut64 off = flags_at->off, gen = f->generation; \
+		rz_list_foreach_safe (flags_at->flags, it2, tmp2, fi) { \
+			if (condition) { \
+				if (!cb(fi, user)) { \
+					return; \
 				} \
 			} \
 		} \
+		if (off == UT64_MAX) { \
+			break; \
+		} \
+		if (f->generation != gen) { \
+			/* the iterator may point to freed or moved offsets now */ \
+			flags_at_iter_seek(f, &fit, off + 1); \
+		} \
 	}
 
+#define FOREACH_BODY(condition) FOREACH_BODY_RANGE(0, UT64_MAX, condition)
+
 RZ_API void rz_flag_foreach(RzFlag *f, RzFlagItemCb cb, void *user) {
 	FOREACH_BODY(true);
 }
@@ -806,13 +1024,76 @@ RZ_API void rz_flag_foreach_prefix(RzFlag *f, const char *pfx, int pfx_len, RzFl
 	FOREACH_BODY(!strncmp(fi->name, pfx, pfx_len));
 }
 
+static int flag_name_cmp(const void *a, const void *b) {
+	return strcmp(((RzFlagItem *)a)->name, ((RzFlagItem *)b)->name);
+}
+
+static bool push_by_name(void *user, const void *k, const void *v) {
+	rz_pvector_push(user, (void *)v);
+	return true;
+}
+
+/*
+ * by_name is only rebuilt when a prefix lookup follows some change of the
+ * flags, so setting many flags in a row does not keep it sorted for nothing.
+ */
+static bool by_name_update(RzFlag *f) {
+	if (f->by_name && f->by_name_generation == f->generation) {
+		return true;
+	}
+	if (!f->by_name) {
+		f->by_name = rz_pvector_new(NULL);
+		if (!f->by_name) {
+			return false;
+		}
+	}
+	rz_pvector_clear(f->by_name);
+	if (f->ht_name->count && !rz_pvector_reserve(f->by_name, f->ht_name->count)) {
+		return false;
+	}
+	ht_pp_foreach(f->ht_name, push_by_name, f->by_name);
+	rz_pvector_sort(f->by_name, flag_name_cmp);
+	f->by_name_generation = f->generation;
+	return true;
+}
+
+#define FLAG_NAME_PREFIX_CMP(x, elem) strncmp(x, ((RzFlagItem *)(elem))->name, pfx_len)
+
+/**
+ * \brief Calls \p cb on every flag whose name starts with the \p pfx_len first chars of \p pfx, by name order
+ *
+ * A negative \p pfx_len uses all of \p pfx.
+ * Unlike rz_flag_foreach_prefix(), the flags are looked up by binary search
+ * in the names, which is what completing a name wants. \p cb must not add,
+ * rename or remove flags.
+ */
+RZ_API void rz_flag_foreach_name_prefix(RZ_NONNULL RzFlag *f, RZ_NONNULL const char *pfx, int pfx_len, RzFlagItemCb cb, void *user) {
+	rz_return_if_fail(f && pfx && cb);
+	pfx_len = pfx_len < 0 ? strlen(pfx) : pfx_len;
+	if (!by_name_update(f)) {
+		rz_flag_foreach_prefix(f, pfx, pfx_len, cb, user);
+		return;
+	}
+	size_t i;
+	rz_pvector_lower_bound(f->by_name, pfx, i, FLAG_NAME_PREFIX_CMP);
+	for (; i < rz_pvector_len(f->by_name); i++) {
+		RzFlagItem *fi = rz_pvector_at(f->by_name, i);
+		if (strncmp(fi->name, pfx, pfx_len)) {
+			break;
+		}
+		if (!cb(fi, user)) {
+			break;
+		}
+	}
+}
+
 /**
  * \param from inclusive
  * \param to inclusive
  */
 RZ_API void rz_flag_foreach_range(RZ_NONNULL RzFlag *f, ut64 from, ut64 to, RzFlagItemCb cb, void *user) {
 	rz_return_if_fail(f);
-	FOREACH_BODY(fi->offset >= from && fi->offset <= to);
+	FOREACH_BODY_RANGE(from, to, fi->offset >= from && fi->offset <= to);
 }
 
 RZ_API void rz_flag_foreach_glob(RzFlag *f, const char *glob, RzFlagItemCb cb, void *user) {
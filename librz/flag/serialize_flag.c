@@ -149,16 +149,8 @@ typedef struct {
 	RzKeyParser *parser;
 } FlagLoadCtx;
 
-static bool flag_load_cb(void *user, const char *k, const char *v) {
-	FlagLoadCtx *ctx = user;
-
-	char *json_str = strdup(v);
-	if (!json_str) {
-		return true;
-	}
-	RzJson *json = rz_json_parse(json_str);
+static bool flag_load_json(FlagLoadCtx *ctx, const char *k, RzJson *json) {
 	if (!json || json->type != RZ_JSON_OBJECT) {
-		free(json_str);
 		return false;
 	}
 
@@ -221,10 +213,8 @@ static bool flag_load_cb(void *user, const char *k, const char *v) {
 			break;
 	});
 
-	bool res = true;
 	if (!offset_set || !size_set) {
-		res = false;
-		goto beach;
+		return false;
 	}
 
 	RzFlagItem *item = rz_flag_set(ctx->flag, k, proto.offset - ctx->flag->base, proto.size);
@@ -243,15 +233,20 @@ static bool flag_load_cb(void *user, const char *k, const char *v) {
 		rz_flag_item_set_alias(item, proto.alias);
 	}
 
-beach:
-	rz_json_free(json);
-	free(json_str);
-	return res;
+	return true;
 }
 
-static bool load_flags(RZ_NONNULL Sdb *flags_db, RZ_NONNULL RzFlag *flag) {
+static bool load_flags(RZ_NONNULL Sdb *flags_db, RZ_NONNULL RzFlag *flag, RZ_NULLABLE RzThreadTaskPool *pool) {
+	RzVector entries;
+	if (!rz_serialize_json_entries_init(&entries, flags_db)) {
+		rz_serialize_json_entries_fini(&entries);
+		return false;
+	}
+	RzVector *entries_ptr = &entries;
+	rz_serialize_json_entries_parse(&entries_ptr, 1, pool);
 	FlagLoadCtx ctx = { flag, rz_key_parser_new() };
 	if (!ctx.parser) {
+		rz_serialize_json_entries_fini(&entries);
 		return false;
 	}
 	rz_key_parser_add(ctx.parser, "realname", FLAG_FIELD_REALNAME);
@@ -262,12 +257,26 @@ static bool load_flags(RZ_NONNULL Sdb *flags_db, RZ_NONNULL RzFlag *flag) {
 	rz_key_parser_add(ctx.parser, "color", FLAG_FIELD_COLOR);
 	rz_key_parser_add(ctx.parser, "comment", FLAG_FIELD_COMMENT);
 	rz_key_parser_add(ctx.parser, "alias", FLAG_FIELD_ALIAS);
-	bool r = sdb_foreach(flags_db, flag_load_cb, &ctx);
+	bool r = true;
+	RzSerializeJsonEntry *entry;
+	rz_vector_foreach(&entries, entry) {
+		if (!flag_load_json(&ctx, entry->key, entry->json)) {
+			r = false;
+			break;
+		}
+	}
 	rz_key_parser_free(ctx.parser);
+	rz_serialize_json_entries_fini(&entries);
 	return r;
 }
 
-RZ_API bool rz_serialize_flag_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzFlag *flag, RZ_NULLABLE RzSerializeResultInfo *res) {
+/**
+ * \brief Load the flags from \p db, parsing them on \p pool
+ *
+ * \param pool Workers to parse the flags on, everything is done by the caller if NULL
+ */
+RZ_API bool rz_serialize_flag_load_parallel(RZ_NONNULL Sdb *db, RZ_NONNULL RzFlag *flag, RZ_NULLABLE RzThreadTaskPool *pool, RZ_NULLABLE RzSerializeResultInfo *res) {
+	rz_return_val_if_fail(db && flag, false);
 	rz_flag_unset_all(flag);
 
 	const char *str = sdb_const_get(db, "base", NULL);
@@ -315,10 +324,14 @@ RZ_API bool rz_serialize_flag_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzFlag *flag,
 		RZ_SERIALIZE_ERR(res, "missing flags sub-namespace");
 		return false;
 	}
-	if (!load_flags(flags_db, flag)) {
+	if (!load_flags(flags_db, flag, pool)) {
 		RZ_SERIALIZE_ERR(res, "failed to parse a flag json");
 		return false;
 	}
 
 	return true;
 }
+
+RZ_API bool rz_serialize_flag_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzFlag *flag, RZ_NULLABLE RzSerializeResultInfo *res) {
+	return rz_serialize_flag_load_parallel(db, flag, NULL, res);
+}
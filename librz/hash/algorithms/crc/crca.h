@@ -71,11 +71,13 @@ typedef struct {
 	int reflect;
 	utcrc poly;
 	utcrc xout;
+	bool has_table; ///< true once table has been computed for size and poly
+	utcrc table[256]; ///< register update for each value of its top byte, used on large inputs
 } RzCrc;
 
 void crc_init_preset(RzCrc *ctx, RzCrcPresets preset);
 void crc_init_custom(RzCrc *ctx, utcrc crc, ut32 size, int reflect, utcrc poly, utcrc xout);
-void crc_update(RzCrc *ctx, const ut8 *data, ut32 sz);
+void crc_update(RzCrc *ctx, const ut8 *data, ut64 sz);
 void crc_final(RzCrc *ctx, utcrc *r);
 
 #endif /* RZ_CRCA_H */
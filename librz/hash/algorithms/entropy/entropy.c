@@ -12,12 +12,42 @@ bool rz_entropy_init(RzEntropy *ctx) {
 	return true;
 }
 
+/* inputs shorter than this are counted straight into the context */
+#define ENTROPY_SPLIT_MIN 1024
+/* most bytes counted before the sub-histograms are merged, so they fit in ut32 */
+#define ENTROPY_SPLIT_MAX ((size_t)1 << 30)
+
 bool rz_entropy_update(RzEntropy *ctx, const ut8 *data, size_t len) {
 	rz_return_val_if_fail(ctx && data, false);
-	for (size_t i = 0; i < len; i++) {
-		ctx->count[data[i]]++;
-	}
 	ctx->size += len;
+	if (len < ENTROPY_SPLIT_MIN) {
+		for (size_t i = 0; i < len; i++) {
+			ctx->count[data[i]]++;
+		}
+		return true;
+	}
+	// runs of equal bytes make each increment wait for the previous one,
+	// counting consecutive bytes in different histograms avoids that
+	ut32 sub[4][256];
+	while (len) {
+		size_t chunk = RZ_MIN(len, ENTROPY_SPLIT_MAX);
+		memset(sub, 0, sizeof(sub));
+		size_t i = 0;
+		for (; i + 4 <= chunk; i += 4) {
+			sub[0][data[i]]++;
+			sub[1][data[i + 1]]++;
+			sub[2][data[i + 2]]++;
+			sub[3][data[i + 3]]++;
+		}
+		for (; i < chunk; i++) {
+			sub[0][data[i]]++;
+		}
+		for (i = 0; i < 256; i++) {
+			ctx->count[i] += (ut64)sub[0][i] + sub[1][i] + sub[2][i] + sub[3][i];
+		}
+		data += chunk;
+		len -= chunk;
+	}
 	return true;
 }
 
@@ -6,6 +6,8 @@
 #include <rz_util.h>
 #include <xxhash.h>
 
+#include "algorithms/entropy/entropy.h"
+
 RZ_LIB_VERSION(rz_hash);
 
 #define hash_cfg_can_hmac(c)    ((c)->status == RZ_MSG_DIGEST_STATUS_ALLOC)
@@ -55,6 +57,46 @@ RZ_API double rz_hash_entropy_fraction(RZ_NONNULL RzHash *rh, const ut8 *data, u
 	return e;
 }
 
+typedef struct {
+	const ut8 *data;
+	ut64 block_size;
+	bool fraction;
+	double *entropies;
+} EntropyBlocksCtx;
+
+static void entropy_blocks_range(size_t from, size_t to, void *user) {
+	EntropyBlocksCtx *ctx = user;
+	RzEntropy entropy;
+	ut8 digest[RZ_HASH_ENTROPY_DIGEST_SIZE];
+	for (size_t i = from; i < to; i++) {
+		rz_entropy_init(&entropy);
+		rz_entropy_update(&entropy, ctx->data + i * ctx->block_size, ctx->block_size);
+		rz_entropy_final(digest, &entropy, ctx->fraction);
+		ctx->entropies[i] = rz_read_be_double(digest);
+	}
+}
+
+/**
+ * \brief Calculates the entropy of each of the \p count consecutive blocks of \p block_size bytes in \p data
+ *
+ * The blocks are spread over the tasks of \p pool when one is given.
+ *
+ * \param fraction true to get the values of rz_hash_entropy_fraction() instead of rz_hash_entropy()
+ * \param entropies receives the \p count values, in order
+ */
+RZ_API void rz_hash_entropy_blocks(RZ_NONNULL RzHash *rh, RZ_NULLABLE RzThreadTaskPool *pool, RZ_NONNULL const ut8 *data, ut64 block_size, size_t count, bool fraction, RZ_NONNULL RZ_OUT double *entropies) {
+	rz_return_if_fail(data && entropies);
+	EntropyBlocksCtx ctx = {
+		.data = data,
+		.block_size = block_size,
+		.fraction = fraction,
+		.entropies = entropies,
+	};
+	if (!pool || count < 2 || !rz_th_task_pool_parallel_for(pool, 0, count, 0, entropy_blocks_range, &ctx)) {
+		entropy_blocks_range(0, count, &ctx);
+	}
+}
+
 static int hash_cfg_config_compare(const void *value, const void *data) {
 	const HashCfgConfig *mdc = (const HashCfgConfig *)data;
 	const char *name = (const char *)value;
@@ -350,6 +392,70 @@ RZ_API bool rz_hash_cfg_update(RzHashCfg *md, const ut8 *data, ut64 size) {
 	return true;
 }
 
+typedef struct {
+	HashCfgConfig **configs;
+	const ut8 *data;
+	ut64 size;
+	bool *ok;
+} HashCfgUpdateCtx;
+
+static void hash_cfg_update_range(size_t from, size_t to, void *user) {
+	HashCfgUpdateCtx *ctx = user;
+	for (size_t i = from; i < to; i++) {
+		HashCfgConfig *mdc = ctx->configs[i];
+		ctx->ok[i] = mdc->plugin->update(mdc->context, ctx->data, ctx->size);
+	}
+}
+
+/**
+ * \brief Inserts data into each the message digest contextes, updating them in parallel
+ *
+ * Same as rz_hash_cfg_update(), except that every configured algorithm
+ * consumes \p data on its own task of \p pool.
+ * */
+RZ_API bool rz_hash_cfg_update_parallel(RZ_NONNULL RzHashCfg *md, RZ_NULLABLE RzThreadTaskPool *pool, RZ_NONNULL const ut8 *data, ut64 size) {
+	rz_return_val_if_fail(md && hash_cfg_can_update(md), false);
+	size_t count = rz_list_length(md->configurations);
+	if (!pool || count < 2) {
+		return rz_hash_cfg_update(md, data, size);
+	}
+	HashCfgConfig **configs = RZ_NEWS(HashCfgConfig *, count);
+	bool *ok = RZ_NEWS0(bool, count);
+	if (!configs || !ok) {
+		free(configs);
+		free(ok);
+		return false;
+	}
+	size_t i = 0;
+	RzListIter *iter = NULL;
+	HashCfgConfig *mdc = NULL;
+	rz_list_foreach (md->configurations, iter, mdc) {
+		configs[i++] = mdc;
+	}
+	HashCfgUpdateCtx ctx = {
+		.configs = configs,
+		.data = data,
+		.size = size,
+		.ok = ok,
+	};
+	// ranges cancelled by a break of the pool are left marked as failed
+	rz_th_task_pool_parallel_for(pool, 0, count, 1, hash_cfg_update_range, &ctx);
+	bool ret = true;
+	for (i = 0; i < count; i++) {
+		if (!ok[i]) {
+			RZ_LOG_ERROR("msg digest: failed to call update for %s.\n", configs[i]->plugin->name);
+			ret = false;
+			break;
+		}
+	}
+	free(configs);
+	free(ok);
+	if (ret) {
+		md->status = RZ_MSG_DIGEST_STATUS_UPDATE;
+	}
+	return ret;
+}
+
 /**
  * \brief Generates the final value of the message digest contextes
  *
@@ -542,6 +648,52 @@ RZ_API ut8 *rz_hash_cfg_calculate_small_block(RZ_NONNULL RzHash *rh, const char
 	return result;
 }
 
+/**
+ * \brief Calculates the digests of many independent small buffers at once
+ *
+ * The plugin is looked up and its context is allocated only once for all
+ * the \p count buffers, instead of once per buffer like with
+ * rz_hash_cfg_calculate_small_block().
+ *
+ * \param buffers the \p count buffers to hash
+ * \param sizes the size of each buffer
+ * \param osize set to the size of one digest
+ * \return the \p count digests, one after the other, or NULL on failure
+ */
+RZ_API RZ_OWN ut8 *rz_hash_cfg_calculate_small_blocks(RZ_NONNULL RzHash *rh, RZ_NONNULL const char *name, RZ_NONNULL const ut8 *const *buffers, RZ_NONNULL const ut64 *sizes, size_t count, RZ_NULLABLE RzHashSize *osize) {
+	rz_return_val_if_fail(rh && name && buffers && sizes, NULL);
+
+	const RzHashPlugin *plugin = rz_hash_plugin_by_name(rh, name);
+	if (!plugin) {
+		return NULL;
+	}
+	void *context = plugin->context_new();
+	if (!context) {
+		return NULL;
+	}
+	RzHashSize digest_size = plugin->digest_size(context);
+	ut8 *result = count && digest_size ? RZ_NEWS(ut8, count * digest_size) : NULL;
+	if (!result) {
+		plugin->context_free(context);
+		return NULL;
+	}
+	for (size_t i = 0; i < count; i++) {
+		if (!plugin->init(context) ||
+			!plugin->update(context, buffers[i], sizes[i]) ||
+			!plugin->final(context, result + i * digest_size)) {
+			RZ_LOG_ERROR("msg digest: cannot calculate small blocks with %s.\n", plugin->name);
+			plugin->context_free(context);
+			free(result);
+			return NULL;
+		}
+	}
+	plugin->context_free(context);
+	if (osize) {
+		*osize = digest_size;
+	}
+	return result;
+}
+
 RZ_API char *rz_hash_cfg_calculate_small_block_string(RZ_NONNULL RzHash *rh, const char *name, const ut8 *buffer, ut64 bsize, ut32 *size, bool invert) {
 	rz_return_val_if_fail(rh && name && buffer, NULL);
 
@@ -0,0 +1,944 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/**
+ * \file
+ * Compilation of RzIL effects into flat code for the RzILVM
+ *
+ * rz_il_evaluate_effect() walks the op tree recursively and every pure op
+ * allocates its result. For code that is executed many times, the tree can
+ * instead be compiled once into a linear sequence of three-address
+ * instructions operating on an array of ut64 slots, which is what the
+ * interpreter at the bottom of this file runs.
+ *
+ * Only well-typed trees whose values all fit into 64 bits are compiled, the
+ * rest is left to the tree evaluator. Emitted events, their order and the
+ * resulting vm state are the same as with the tree evaluator.
+ *
+ * Bools are stored as 0 or 1. Let-bound and local variables live in slots,
+ * which is fine because they never survive a single rz_il_vm_step().
+ */
+
+#include <rz_il/rz_il_vm.h>
+#include <rz_il/rz_il_validate.h>
+
+extern RZ_IPI RzILOpPureHandler rz_il_op_handler_pure_table_default[RZ_IL_OP_PURE_MAX];
+extern RZ_IPI RzILOpEffectHandler rz_il_op_handler_effect_table_default[RZ_IL_OP_EFFECT_MAX];
+
+#define SLOTS_ON_STACK 64
+
+typedef enum {
+	ILC_CONST, ///< dst = imm
+	ILC_MOV, ///< dst = a
+	ILC_VAR, ///< dst = global var ptr, len is 0 for a bool
+	ILC_INV, ///< dst = !a
+	ILC_AND, ///< dst = a && b
+	ILC_OR, ///< dst = a || b
+	ILC_XOR, ///< dst = a ^ b, for bools
+	ILC_MSB,
+	ILC_LSB,
+	ILC_IS_ZERO,
+	ILC_NEG,
+	ILC_LOGNOT,
+	ILC_ADD,
+	ILC_SUB,
+	ILC_MUL,
+	ILC_DIV,
+	ILC_SDIV,
+	ILC_MOD,
+	ILC_SMOD,
+	ILC_LOGAND,
+	ILC_LOGOR,
+	ILC_LOGXOR,
+	ILC_SHIFTL, ///< dst = a << b, filled with c
+	ILC_SHIFTR, ///< dst = a >> b, filled with c
+	ILC_EQ,
+	ILC_ULE,
+	ILC_SLE,
+	ILC_CAST, ///< dst = a of aux bits cast to len bits, filled with c
+	ILC_APPEND, ///< dst = a . b where b has aux bits
+	ILC_LOAD, ///< dst = mem imm [a], key of aux bits
+	ILC_LOADW, ///< dst = len bits from mem imm [a], key of aux bits
+	ILC_STORE, ///< mem imm [a] = b, key of aux bits
+	ILC_STOREW, ///< mem imm [a] = b of len bits, key of aux bits
+	ILC_SET, ///< global var ptr = a, len is 0 for a bool
+	ILC_JMP, ///< pc = a
+	ILC_GOTO, ///< continue at instruction dst
+	ILC_GOTO_IF_NOT, ///< continue at instruction dst if !a
+	ILC_EFFECT, ///< evaluate effect ptr with the tree evaluator
+} IlcCode;
+
+typedef struct {
+	IlcCode code;
+	ut32 len; ///< bits of the operands or result, see the codes
+	ut32 aux;
+	ut32 dst, a, b, c;
+	ut64 imm;
+	const void *ptr; ///< borrowed from the op tree
+} IlcInsn;
+
+struct rz_il_compiled_effect_t {
+	IlcInsn *insns;
+	ut32 insns_count;
+	ut32 slots_count;
+};
+
+/////////////////////////////////////////////////////////
+// Compiler
+
+typedef struct {
+	RzILVM *vm;
+	RzVector /*<IlcInsn>*/ insns;
+	RzVector /*<ut32>*/ slot_lens; ///< bits of each slot, 0 for a bool
+	HtPP *locals; ///< local var name => slot + 1
+	HtPP *lets; ///< let-bound name => slot + 1, of the innermost binding
+	bool fallback_ok; ///< effects may be evaluated by the tree evaluator
+} IlcCompiler;
+
+static ut32 slot_new(IlcCompiler *c, ut32 len) {
+	rz_vector_push(&c->slot_lens, &len);
+	return (ut32)rz_vector_len(&c->slot_lens) - 1;
+}
+
+static ut32 slot_len(IlcCompiler *c, ut32 slot) {
+	return *(ut32 *)rz_vector_index_ptr(&c->slot_lens, slot);
+}
+
+static IlcInsn *emit(IlcCompiler *c, IlcCode code) {
+	IlcInsn *insn = rz_vector_push(&c->insns, NULL);
+	if (insn) {
+		memset(insn, 0, sizeof(*insn));
+		insn->code = code;
+	}
+	return insn;
+}
+
+static ut32 pos(IlcCompiler *c) {
+	return (ut32)rz_vector_len(&c->insns);
+}
+
+/**
+ * Compile \p op so that its value ends up in *slot.
+ * \param len bits of the value, 0 for a bool
+ */
+static bool compile_pure(IlcCompiler *c, RzILOpPure *op, ut32 *slot, ut32 *len);
+
+static bool compile_unop(IlcCompiler *c, IlcCode code, RzILOpPure *x, ut32 *slot, ut32 *len, bool to_bool) {
+	ut32 a, alen;
+	if (!compile_pure(c, x, &a, &alen)) {
+		return false;
+	}
+	IlcInsn *insn = emit(c, code);
+	if (!insn) {
+		return false;
+	}
+	insn->a = a;
+	insn->len = alen;
+	*len = to_bool ? 0 : alen;
+	insn->dst = *slot = slot_new(c, *len);
+	return true;
+}
+
+static bool compile_binop(IlcCompiler *c, IlcCode code, RzILOpPure *x, RzILOpPure *y, ut32 *slot, ut32 *len, bool to_bool) {
+	ut32 a, b, alen, blen;
+	// same order as the handlers, which matters for the events
+	if (!compile_pure(c, x, &a, &alen) || !compile_pure(c, y, &b, &blen)) {
+		return false;
+	}
+	IlcInsn *insn = emit(c, code);
+	if (!insn) {
+		return false;
+	}
+	insn->a = a;
+	insn->b = b;
+	insn->len = alen;
+	*len = to_bool ? 0 : alen;
+	insn->dst = *slot = slot_new(c, *len);
+	return true;
+}
+
+static bool compile_shift(IlcCompiler *c, IlcCode code, RzILOpArgsShiftLeft *args, ut32 *slot, ut32 *len) {
+	ut32 a, b, f, alen, blen, flen;
+	if (!compile_pure(c, args->x, &a, &alen) || !compile_pure(c, args->y, &b, &blen) || !compile_pure(c, args->fill_bit, &f, &flen)) {
+		return false;
+	}
+	IlcInsn *insn = emit(c, code);
+	if (!insn) {
+		return false;
+	}
+	insn->a = a;
+	insn->b = b;
+	insn->c = f;
+	insn->len = alen;
+	*len = alen;
+	insn->dst = *slot = slot_new(c, *len);
+	return true;
+}
+
+static bool compile_var(IlcCompiler *c, RzILOpArgsVar *args, ut32 *slot, ut32 *len) {
+	switch (args->kind) {
+	case RZ_IL_VAR_KIND_GLOBAL: {
+		RzILVar *var = rz_il_vm_get_var(c->vm, RZ_IL_VAR_KIND_GLOBAL, args->v);
+		if (!var) {
+			return false;
+		}
+		ut32 vlen = var->sort.type == RZ_IL_TYPE_PURE_BOOL ? 0 : var->sort.props.bv.length;
+		if (vlen > 64) {
+			return false;
+		}
+		IlcInsn *insn = emit(c, ILC_VAR);
+		if (!insn) {
+			return false;
+		}
+		insn->ptr = args->v;
+		insn->len = vlen;
+		*len = vlen;
+		insn->dst = *slot = slot_new(c, *len);
+		return true;
+	}
+	case RZ_IL_VAR_KIND_LOCAL:
+	case RZ_IL_VAR_KIND_LOCAL_PURE: {
+		HtPP *scope = args->kind == RZ_IL_VAR_KIND_LOCAL ? c->locals : c->lets;
+		ut32 s = (ut32)(size_t)ht_pp_find(scope, args->v, NULL);
+		if (!s) {
+			return false;
+		}
+		*slot = s - 1;
+		*len = slot_len(c, *slot);
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+static bool compile_let(IlcCompiler *c, RzILOpArgsLet *args, ut32 *slot, ut32 *len) {
+	ut32 e, elen;
+	if (!compile_pure(c, args->exp, &e, &elen)) {
+		return false;
+	}
+	bool shadowed = false;
+	void *prev = ht_pp_find(c->lets, args->name, &shadowed);
+	ht_pp_update(c->lets, args->name, (void *)(size_t)(e + 1));
+	bool succ = compile_pure(c, args->body, slot, len);
+	if (shadowed) {
+		ht_pp_update(c->lets, args->name, prev);
+	} else {
+		ht_pp_delete(c->lets, args->name);
+	}
+	return succ;
+}
+
+static bool compile_ite(IlcCompiler *c, RzILOpArgsIte *args, ut32 *slot, ut32 *len) {
+	ut32 cond, clen, x, y, ylen;
+	if (!args->x || !args->y || !compile_pure(c, args->condition, &cond, &clen)) {
+		return false;
+	}
+	ut32 jf = pos(c);
+	IlcInsn *insn = emit(c, ILC_GOTO_IF_NOT);
+	if (!insn) {
+		return false;
+	}
+	insn->a = cond;
+	if (!compile_pure(c, args->x, &x, len) || !(insn = emit(c, ILC_MOV))) {
+		return false;
+	}
+	ut32 dst = slot_new(c, *len);
+	insn->a = x;
+	insn->dst = dst;
+	ut32 jend = pos(c);
+	if (!emit(c, ILC_GOTO)) {
+		return false;
+	}
+	((IlcInsn *)rz_vector_index_ptr(&c->insns, jf))->dst = pos(c);
+	if (!compile_pure(c, args->y, &y, &ylen) || !(insn = emit(c, ILC_MOV))) {
+		return false;
+	}
+	insn->a = y;
+	insn->dst = dst;
+	((IlcInsn *)rz_vector_index_ptr(&c->insns, jend))->dst = pos(c);
+	*slot = dst;
+	return true;
+}
+
+static bool compile_pure(IlcCompiler *c, RzILOpPure *op, ut32 *slot, ut32 *len) {
+	if (!op) {
+		return false;
+	}
+	IlcInsn *insn;
+	switch (op->code) {
+	case RZ_IL_OP_VAR:
+		return compile_var(c, &op->op.var, slot, len);
+	case RZ_IL_OP_ITE:
+		return compile_ite(c, &op->op.ite, slot, len);
+	case RZ_IL_OP_LET:
+		return compile_let(c, &op->op.let, slot, len);
+	case RZ_IL_OP_B0:
+	case RZ_IL_OP_B1:
+		if (!(insn = emit(c, ILC_CONST))) {
+			return false;
+		}
+		insn->imm = op->code == RZ_IL_OP_B1;
+		*len = 0;
+		insn->dst = *slot = slot_new(c, *len);
+		return true;
+	case RZ_IL_OP_INV:
+		return compile_unop(c, ILC_INV, op->op.boolinv.x, slot, len, true);
+	case RZ_IL_OP_AND:
+		return compile_binop(c, ILC_AND, op->op.booland.x, op->op.booland.y, slot, len, true);
+	case RZ_IL_OP_OR:
+		return compile_binop(c, ILC_OR, op->op.boolor.x, op->op.boolor.y, slot, len, true);
+	case RZ_IL_OP_XOR:
+		return compile_binop(c, ILC_XOR, op->op.boolxor.x, op->op.boolxor.y, slot, len, true);
+	case RZ_IL_OP_BITV: {
+		RzBitVector *bv = op->op.bitv.value;
+		if (rz_bv_len(bv) > 64 || !(insn = emit(c, ILC_CONST))) {
+			return false;
+		}
+		insn->imm = rz_bv_to_ut64(bv);
+		*len = rz_bv_len(bv);
+		insn->dst = *slot = slot_new(c, *len);
+		return true;
+	}
+	case RZ_IL_OP_MSB:
+		return compile_unop(c, ILC_MSB, op->op.msb.bv, slot, len, true);
+	case RZ_IL_OP_LSB:
+		return compile_unop(c, ILC_LSB, op->op.lsb.bv, slot, len, true);
+	case RZ_IL_OP_IS_ZERO:
+		return compile_unop(c, ILC_IS_ZERO, op->op.is_zero.bv, slot, len, true);
+	case RZ_IL_OP_NEG:
+		return compile_unop(c, ILC_NEG, op->op.neg.bv, slot, len, false);
+	case RZ_IL_OP_LOGNOT:
+		return compile_unop(c, ILC_LOGNOT, op->op.lognot.bv, slot, len, false);
+	case RZ_IL_OP_ADD:
+		return compile_binop(c, ILC_ADD, op->op.add.x, op->op.add.y, slot, len, false);
+	case RZ_IL_OP_SUB:
+		return compile_binop(c, ILC_SUB, op->op.sub.x, op->op.sub.y, slot, len, false);
+	case RZ_IL_OP_MUL:
+		return compile_binop(c, ILC_MUL, op->op.mul.x, op->op.mul.y, slot, len, false);
+	case RZ_IL_OP_DIV:
+		return compile_binop(c, ILC_DIV, op->op.div.x, op->op.div.y, slot, len, false);
+	case RZ_IL_OP_SDIV:
+		return compile_binop(c, ILC_SDIV, op->op.sdiv.x, op->op.sdiv.y, slot, len, false);
+	case RZ_IL_OP_MOD:
+		return compile_binop(c, ILC_MOD, op->op.mod.x, op->op.mod.y, slot, len, false);
+	case RZ_IL_OP_SMOD:
+		return compile_binop(c, ILC_SMOD, op->op.smod.x, op->op.smod.y, slot, len, false);
+	case RZ_IL_OP_LOGAND:
+		return compile_binop(c, ILC_LOGAND, op->op.logand.x, op->op.logand.y, slot, len, false);
+	case RZ_IL_OP_LOGOR:
+		return compile_binop(c, ILC_LOGOR, op->op.logor.x, op->op.logor.y, slot, len, false);
+	case RZ_IL_OP_LOGXOR:
+		return compile_binop(c, ILC_LOGXOR, op->op.logxor.x, op->op.logxor.y, slot, len, false);
+	case RZ_IL_OP_SHIFTR:
+		return compile_shift(c, ILC_SHIFTR, &op->op.shiftr, slot, len);
+	case RZ_IL_OP_SHIFTL:
+		return compile_shift(c, ILC_SHIFTL, &op->op.shiftl, slot, len);
+	case RZ_IL_OP_EQ:
+		return compile_binop(c, ILC_EQ, op->op.eq.x, op->op.eq.y, slot, len, true);
+	case RZ_IL_OP_SLE:
+		return compile_binop(c, ILC_SLE, op->op.sle.x, op->op.sle.y, slot, len, true);
+	case RZ_IL_OP_ULE:
+		return compile_binop(c, ILC_ULE, op->op.ule.x, op->op.ule.y, slot, len, true);
+	case RZ_IL_OP_CAST: {
+		RzILOpArgsCast *args = &op->op.cast;
+		ut32 f, flen, a, alen;
+		// the handler evaluates the fill bit first
+		if (args->length > 64 || !compile_pure(c, args->fill, &f, &flen) || !compile_pure(c, args->val, &a, &alen) ||
+			!(insn = emit(c, ILC_CAST))) {
+			return false;
+		}
+		insn->a = a;
+		insn->c = f;
+		insn->aux = alen;
+		insn->len = args->length;
+		*len = args->length;
+		insn->dst = *slot = slot_new(c, *len);
+		return true;
+	}
+	case RZ_IL_OP_APPEND: {
+		ut32 h, hlen, l, llen;
+		if (!compile_pure(c, op->op.append.high, &h, &hlen) || !compile_pure(c, op->op.append.low, &l, &llen) ||
+			hlen + llen > 64 || !(insn = emit(c, ILC_APPEND))) {
+			return false;
+		}
+		insn->a = h;
+		insn->b = l;
+		insn->aux = llen;
+		insn->len = hlen + llen;
+		*len = hlen + llen;
+		insn->dst = *slot = slot_new(c, *len);
+		return true;
+	}
+	case RZ_IL_OP_LOAD:
+	case RZ_IL_OP_LOADW: {
+		bool w = op->code == RZ_IL_OP_LOADW;
+		RzILMemIndex mi = w ? op->op.loadw.mem : op->op.load.mem;
+		RzILMem *mem = rz_il_vm_get_mem(c->vm, mi);
+		ut32 k, klen;
+		ut32 vlen = w ? op->op.loadw.n_bits : (mem ? rz_il_mem_value_len(mem) : 0);
+		if (!mem || vlen > 64 || !compile_pure(c, w ? op->op.loadw.key : op->op.load.key, &k, &klen) ||
+			!(insn = emit(c, w ? ILC_LOADW : ILC_LOAD))) {
+			return false;
+		}
+		insn->a = k;
+		insn->aux = klen;
+		insn->imm = mi;
+		insn->len = vlen;
+		*len = vlen;
+		insn->dst = *slot = slot_new(c, *len);
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+static bool compile_effect(IlcCompiler *c, RzILOpEffect *op);
+
+static bool compile_fallback(IlcCompiler *c, RzILOpEffect *op) {
+	if (!c->fallback_ok) {
+		return false;
+	}
+	IlcInsn *insn = emit(c, ILC_EFFECT);
+	if (!insn) {
+		return false;
+	}
+	insn->ptr = op;
+	return true;
+}
+
+static bool compile_set(IlcCompiler *c, RzILOpArgsSet *args) {
+	ut32 a, alen;
+	if (!compile_pure(c, args->x, &a, &alen)) {
+		return false;
+	}
+	IlcInsn *insn;
+	if (args->is_local) {
+		ut32 s = (ut32)(size_t)ht_pp_find(c->locals, args->v, NULL);
+		if (!s) {
+			s = slot_new(c, alen) + 1;
+			ht_pp_insert(c->locals, args->v, (void *)(size_t)s);
+		}
+		if (!(insn = emit(c, ILC_MOV))) {
+			return false;
+		}
+		insn->a = a;
+		insn->dst = s - 1;
+		return true;
+	}
+	if (!(insn = emit(c, ILC_SET))) {
+		return false;
+	}
+	insn->a = a;
+	insn->len = alen;
+	insn->ptr = args->v;
+	return true;
+}
+
+static bool compile_branch(IlcCompiler *c, RzILOpArgsBranch *args) {
+	ut32 cond, clen;
+	if (!compile_pure(c, args->condition, &cond, &clen)) {
+		return false;
+	}
+	ut32 jf = pos(c);
+	IlcInsn *insn = emit(c, ILC_GOTO_IF_NOT);
+	if (!insn) {
+		return false;
+	}
+	insn->a = cond;
+	if (!compile_effect(c, args->true_eff)) {
+		return false;
+	}
+	ut32 jend = pos(c);
+	if (!emit(c, ILC_GOTO)) {
+		return false;
+	}
+	((IlcInsn *)rz_vector_index_ptr(&c->insns, jf))->dst = pos(c);
+	if (!compile_effect(c, args->false_eff)) {
+		return false;
+	}
+	((IlcInsn *)rz_vector_index_ptr(&c->insns, jend))->dst = pos(c);
+	return true;
+}
+
+static bool compile_repeat(IlcCompiler *c, RzILOpArgsRepeat *args) {
+	ut32 loop = pos(c);
+	ut32 cond, clen;
+	if (!compile_pure(c, args->condition, &cond, &clen)) {
+		return false;
+	}
+	ut32 jf = pos(c);
+	IlcInsn *insn = emit(c, ILC_GOTO_IF_NOT);
+	if (!insn) {
+		return false;
+	}
+	insn->a = cond;
+	if (!compile_effect(c, args->data_eff) || !(insn = emit(c, ILC_GOTO))) {
+		return false;
+	}
+	insn->dst = loop;
+	((IlcInsn *)rz_vector_index_ptr(&c->insns, jf))->dst = pos(c);
+	return true;
+}
+
+static bool compile_effect(IlcCompiler *c, RzILOpEffect *op) {
+	if (!op) {
+		// a missing branch does nothing
+		return true;
+	}
+	IlcInsn *insn;
+	switch (op->code) {
+	case RZ_IL_OP_NOP:
+		return true;
+	case RZ_IL_OP_SET:
+		return compile_set(c, &op->op.set);
+	case RZ_IL_OP_SEQ:
+		return compile_effect(c, op->op.seq.x) && compile_effect(c, op->op.seq.y);
+	case RZ_IL_OP_BRANCH:
+		return compile_branch(c, &op->op.branch);
+	case RZ_IL_OP_REPEAT:
+		return compile_repeat(c, &op->op.repeat);
+	case RZ_IL_OP_BLK:
+		if (op->op.blk.label) {
+			// labels are created at runtime
+			return compile_fallback(c, op);
+		}
+		return compile_effect(c, op->op.blk.data_eff) && compile_effect(c, op->op.blk.ctrl_eff);
+	case RZ_IL_OP_JMP: {
+		ut32 a, alen;
+		if (!compile_pure(c, op->op.jmp.dst, &a, &alen) || !(insn = emit(c, ILC_JMP))) {
+			return false;
+		}
+		insn->a = a;
+		insn->len = alen;
+		return true;
+	}
+	case RZ_IL_OP_STORE:
+	case RZ_IL_OP_STOREW: {
+		bool w = op->code == RZ_IL_OP_STOREW;
+		RzILOpArgsStore *args = &op->op.store;
+		ut32 k, klen, v, vlen;
+		if (w) {
+			if (!compile_pure(c, op->op.storew.key, &k, &klen) || !compile_pure(c, op->op.storew.value, &v, &vlen)) {
+				return false;
+			}
+		} else if (!compile_pure(c, args->key, &k, &klen) || !compile_pure(c, args->value, &v, &vlen)) {
+			return false;
+		}
+		if (!(insn = emit(c, w ? ILC_STOREW : ILC_STORE))) {
+			return false;
+		}
+		insn->a = k;
+		insn->b = v;
+		insn->aux = klen;
+		insn->len = vlen;
+		insn->imm = w ? op->op.storew.mem : args->mem;
+		return true;
+	}
+	case RZ_IL_OP_EMPTY:
+	case RZ_IL_OP_GOTO:
+		// rare, and goto may call hooks which expect the op
+		return compile_fallback(c, op);
+	default:
+		return false;
+	}
+}
+
+static bool local_sort_fits_cb(void *user, const void *k, const void *v) {
+	const RzILSortPure *sort = v;
+	bool *fits = user;
+	if (sort->type == RZ_IL_TYPE_PURE_BITVECTOR && sort->props.bv.length > 64) {
+		*fits = false;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * \brief Compile \p op into flat code for rz_il_vm_step_compiled()
+ *
+ * The op is type-checked against the variables and memories of \p vm
+ * first, so the result is only valid for \p vm. Strings are borrowed from
+ * \p op, which must outlive the result.
+ *
+ * \return the compiled code, or NULL if \p op is invalid or can't be compiled
+ *         (e.g. bitvectors of more than 64 bits), in which case it should simply
+ *         be evaluated with rz_il_vm_step().
+ */
+RZ_API RZ_OWN RzILCompiledEffect *rz_il_compile_effect(RZ_NONNULL RzILVM *vm, RZ_NONNULL RzILOpEffect *op) {
+	rz_return_val_if_fail(vm && op, NULL);
+	// custom handlers must keep being called
+	if (memcmp(vm->op_handler_pure_table, rz_il_op_handler_pure_table_default, sizeof(rz_il_op_handler_pure_table_default)) ||
+		memcmp(vm->op_handler_effect_table, rz_il_op_handler_effect_table_default, sizeof(rz_il_op_handler_effect_table_default)) ||
+		rz_il_vm_get_pc_len(vm) > 64) {
+		return NULL;
+	}
+	RzILValidateGlobalContext *ctx = rz_il_validate_global_context_new_from_vm(vm);
+	if (!ctx) {
+		return NULL;
+	}
+	HtPP *local_sorts = NULL;
+	bool valid = rz_il_validate_effect(op, ctx, &local_sorts, NULL, NULL);
+	rz_il_validate_global_context_free(ctx);
+	if (!valid || !local_sorts) {
+		ht_pp_free(local_sorts);
+		return NULL;
+	}
+	bool fits = true;
+	ht_pp_foreach(local_sorts, local_sort_fits_cb, &fits);
+
+	RzILCompiledEffect *r = NULL;
+	IlcCompiler c = { 0 };
+	c.vm = vm;
+	// the tree evaluator would not see local vars kept in slots
+	c.fallback_ok = !local_sorts->count;
+	rz_vector_init(&c.insns, sizeof(IlcInsn), NULL, NULL);
+	rz_vector_init(&c.slot_lens, sizeof(ut32), NULL, NULL);
+	c.locals = ht_pp_new0();
+	c.lets = ht_pp_new0();
+	if (!fits || !c.locals || !c.lets || !compile_effect(&c, op)) {
+		goto beach;
+	}
+	r = RZ_NEW0(RzILCompiledEffect);
+	if (!r) {
+		goto beach;
+	}
+	r->insns_count = (ut32)rz_vector_len(&c.insns);
+	r->insns = rz_vector_flush(&c.insns);
+	r->slots_count = (ut32)rz_vector_len(&c.slot_lens);
+	if (!r->insns && r->insns_count) {
+		free(r);
+		r = NULL;
+	}
+beach:
+	rz_vector_fini(&c.insns);
+	rz_vector_fini(&c.slot_lens);
+	ht_pp_free(c.locals);
+	ht_pp_free(c.lets);
+	ht_pp_free(local_sorts);
+	return r;
+}
+
+RZ_API void rz_il_compiled_effect_free(RZ_NULLABLE RzILCompiledEffect *c) {
+	if (!c) {
+		return;
+	}
+	free(c->insns);
+	free(c);
+}
+
+/////////////////////////////////////////////////////////
+// Interpreter
+
+static inline ut64 mask_of(ut32 len) {
+	return len ? UT64_MAX >> (64 - len) : 1;
+}
+
+static inline bool msb_of(ut64 v, ut32 len) {
+	return (v >> (len - 1)) & 1;
+}
+
+// same results as rz_bv_div() and rz_bv_mod()
+static inline ut64 udiv(ut64 x, ut64 y, ut32 len) {
+	return y ? x / y : mask_of(len);
+}
+
+static inline ut64 umod(ut64 x, ut64 y) {
+	return y ? x % y : x;
+}
+
+static inline ut64 neg(ut64 x, ut32 len) {
+	return -x & mask_of(len);
+}
+
+// same case distinction as rz_bv_sdiv() and rz_bv_smod()
+static ut64 sdiv(ut64 x, ut64 y, ut32 len) {
+	bool mx = msb_of(x, len);
+	bool my = msb_of(y, len);
+	if (!mx && !my) {
+		return udiv(x, y, len);
+	}
+	if (mx && !my) {
+		return neg(udiv(neg(x, len), y, len), len);
+	}
+	if (!mx && my) {
+		return neg(udiv(x, neg(y, len), len), len);
+	}
+	return udiv(neg(x, len), neg(y, len), len);
+}
+
+static ut64 smod(ut64 x, ut64 y, ut32 len) {
+	bool mx = msb_of(x, len);
+	bool my = msb_of(y, len);
+	if (!mx && !my) {
+		return umod(x, y);
+	}
+	if (mx && !my) {
+		return neg(umod(neg(x, len), y), len);
+	}
+	if (!mx && my) {
+		return neg(umod(x, neg(y, len)), len);
+	}
+	return neg(umod(neg(x, len), neg(y, len)), len);
+}
+
+static ut64 shift(ut64 x, ut64 amount, bool fill, ut32 len, bool left) {
+	// like rz_bv_lshift_fill()/rz_bv_rshift_fill() after rz_bv_to_ut32()
+	ut32 sh = (ut32)amount;
+	ut64 mask = mask_of(len);
+	if (!sh) {
+		return x;
+	}
+	if (sh >= len) {
+		return fill ? mask : 0;
+	}
+	if (left) {
+		return ((x << sh) | (fill ? mask_of(sh) : 0)) & mask;
+	}
+	return (x >> sh) | (fill ? mask & ~(mask >> sh) : 0);
+}
+
+static void small_bv(RzBitVector *bv, ut32 len, ut64 val) {
+	// bitvectors of up to 64 bits don't allocate
+	rz_bv_init(bv, len);
+	rz_bv_set_from_ut64(bv, val);
+}
+
+static bool exec_var(RzILVM *vm, const IlcInsn *insn, ut64 *dst) {
+	const char *name = insn->ptr;
+	RzILVal *val = rz_il_vm_get_var_value(vm, RZ_IL_VAR_KIND_GLOBAL, name);
+	if (!val) {
+		RZ_LOG_ERROR("RzIL: reading value of variable \"%s\" of kind %s failed.\n",
+			name, rz_il_var_kind_name(RZ_IL_VAR_KIND_GLOBAL));
+		return false;
+	}
+	rz_il_vm_event_add(vm, rz_il_event_var_read_new(name, val));
+	*dst = val->type == RZ_IL_TYPE_PURE_BOOL ? val->data.b->b : rz_bv_to_ut64(val->data.bv);
+	return true;
+}
+
+static bool exec_set(RzILVM *vm, const IlcInsn *insn, ut64 v) {
+	const char *name = insn->ptr;
+	RzILVal *old = rz_il_vm_get_var_value(vm, RZ_IL_VAR_KIND_GLOBAL, name);
+	if (!old) {
+		return false;
+	}
+	// the event copies both values, so the variable can be updated in place
+	RzBitVector bv;
+	RzILBool b = { .b = !!v };
+	RzILVal val = { .type = old->type };
+	if (old->type == RZ_IL_TYPE_PURE_BOOL) {
+		val.data.b = &b;
+	} else {
+		small_bv(&bv, insn->len, v);
+		val.data.bv = &bv;
+	}
+	rz_il_vm_event_add(vm, rz_il_event_var_write_new(name, old, &val));
+	if (old->type == RZ_IL_TYPE_PURE_BOOL) {
+		old->data.b->b = b.b;
+	} else {
+		rz_bv_set_from_ut64(old->data.bv, v);
+		rz_bv_fini(&bv);
+	}
+	return true;
+}
+
+static bool exec_load(RzILVM *vm, const IlcInsn *insn, ut64 key, ut64 *dst) {
+	RzBitVector k;
+	small_bv(&k, insn->aux, key);
+	RzBitVector *r = insn->code == ILC_LOADW
+		? rz_il_vm_mem_loadw(vm, (RzILMemIndex)insn->imm, &k, insn->len)
+		: rz_il_vm_mem_load(vm, (RzILMemIndex)insn->imm, &k);
+	rz_bv_fini(&k);
+	if (!r) {
+		return false;
+	}
+	*dst = rz_bv_to_ut64(r);
+	rz_bv_free(r);
+	return true;
+}
+
+static void exec_store(RzILVM *vm, const IlcInsn *insn, ut64 key, ut64 val) {
+	RzBitVector k, v;
+	small_bv(&k, insn->aux, key);
+	small_bv(&v, insn->len, val);
+	if (insn->code == ILC_STOREW) {
+		rz_il_vm_mem_storew(vm, (RzILMemIndex)insn->imm, &k, &v);
+	} else {
+		rz_il_vm_mem_store(vm, (RzILMemIndex)insn->imm, &k, &v);
+	}
+	rz_bv_fini(&k);
+	rz_bv_fini(&v);
+}
+
+static void exec_jmp(RzILVM *vm, const IlcInsn *insn, ut64 dst) {
+	RzBitVector bv;
+	small_bv(&bv, insn->len, dst);
+	rz_il_vm_event_add(vm, rz_il_event_pc_write_new(vm->pc, &bv));
+	rz_bv_fini(&bv);
+	rz_bv_set_from_ut64(vm->pc, dst);
+}
+
+static bool run(RzILVM *vm, const RzILCompiledEffect *code, ut64 *s) {
+	const IlcInsn *insns = code->insns;
+	for (ut32 ip = 0; ip < code->insns_count;) {
+		const IlcInsn *i = &insns[ip++];
+		ut64 m = mask_of(i->len);
+		switch (i->code) {
+		case ILC_CONST:
+			s[i->dst] = i->imm;
+			break;
+		case ILC_MOV:
+			s[i->dst] = s[i->a];
+			break;
+		case ILC_VAR:
+			if (!exec_var(vm, i, &s[i->dst])) {
+				return false;
+			}
+			break;
+		case ILC_INV:
+			s[i->dst] = !s[i->a];
+			break;
+		case ILC_AND:
+			s[i->dst] = s[i->a] && s[i->b];
+			break;
+		case ILC_OR:
+			s[i->dst] = s[i->a] || s[i->b];
+			break;
+		case ILC_XOR:
+			s[i->dst] = s[i->a] ^ s[i->b];
+			break;
+		case ILC_MSB:
+			s[i->dst] = msb_of(s[i->a], i->len);
+			break;
+		case ILC_LSB:
+			s[i->dst] = s[i->a] & 1;
+			break;
+		case ILC_IS_ZERO:
+			s[i->dst] = !s[i->a];
+			break;
+		case ILC_NEG:
+			s[i->dst] = neg(s[i->a], i->len);
+			break;
+		case ILC_LOGNOT:
+			s[i->dst] = ~s[i->a] & m;
+			break;
+		case ILC_ADD:
+			s[i->dst] = (s[i->a] + s[i->b]) & m;
+			break;
+		case ILC_SUB:
+			s[i->dst] = (s[i->a] - s[i->b]) & m;
+			break;
+		case ILC_MUL:
+			s[i->dst] = (s[i->a] * s[i->b]) & m;
+			break;
+		case ILC_DIV:
+			if (!s[i->b]) {
+				rz_il_vm_event_add(vm, rz_il_event_exception_new("division by zero"));
+			}
+			s[i->dst] = udiv(s[i->a], s[i->b], i->len);
+			break;
+		case ILC_SDIV:
+			s[i->dst] = sdiv(s[i->a], s[i->b], i->len);
+			break;
+		case ILC_MOD:
+			s[i->dst] = umod(s[i->a], s[i->b]);
+			break;
+		case ILC_SMOD:
+			s[i->dst] = smod(s[i->a], s[i->b], i->len);
+			break;
+		case ILC_LOGAND:
+			s[i->dst] = s[i->a] & s[i->b];
+			break;
+		case ILC_LOGOR:
+			s[i->dst] = s[i->a] | s[i->b];
+			break;
+		case ILC_LOGXOR:
+			s[i->dst] = s[i->a] ^ s[i->b];
+			break;
+		case ILC_SHIFTL:
+		case ILC_SHIFTR:
+			s[i->dst] = shift(s[i->a], s[i->b], s[i->c], i->len, i->code == ILC_SHIFTL);
+			break;
+		case ILC_EQ:
+			s[i->dst] = s[i->a] == s[i->b];
+			break;
+		case ILC_ULE:
+			s[i->dst] = s[i->a] <= s[i->b];
+			break;
+		case ILC_SLE: {
+			bool mx = msb_of(s[i->a], i->len);
+			bool my = msb_of(s[i->b], i->len);
+			s[i->dst] = mx == my ? s[i->a] <= s[i->b] : mx;
+			break;
+		}
+		case ILC_CAST:
+			if (i->len <= i->aux) {
+				s[i->dst] = s[i->a] & m;
+			} else {
+				s[i->dst] = s[i->a] | (s[i->c] ? m & ~mask_of(i->aux) : 0);
+			}
+			break;
+		case ILC_APPEND:
+			s[i->dst] = i->aux < 64 ? (s[i->a] << i->aux) | s[i->b] : s[i->b];
+			break;
+		case ILC_LOAD:
+		case ILC_LOADW:
+			if (!exec_load(vm, i, s[i->a], &s[i->dst])) {
+				return false;
+			}
+			break;
+		case ILC_STORE:
+		case ILC_STOREW:
+			exec_store(vm, i, s[i->a], s[i->b]);
+			break;
+		case ILC_SET:
+			if (!exec_set(vm, i, s[i->a])) {
+				return false;
+			}
+			break;
+		case ILC_JMP:
+			exec_jmp(vm, i, s[i->a]);
+			break;
+		case ILC_GOTO:
+			ip = i->dst;
+			break;
+		case ILC_GOTO_IF_NOT:
+			if (!s[i->a]) {
+				ip = i->dst;
+			}
+			break;
+		case ILC_EFFECT:
+			if (!rz_il_evaluate_effect(vm, (RzILOpEffect *)i->ptr)) {
+				return false;
+			}
+			break;
+		default:
+			rz_warn_if_reached();
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Evaluate (execute) code compiled with rz_il_compile_effect()
+ * \return false if an error occured and the execution should be aborted
+ */
+RZ_API bool rz_il_evaluate_compiled_effect(RZ_NONNULL RzILVM *vm, RZ_NONNULL const RzILCompiledEffect *code) {
+	rz_return_val_if_fail(vm && code, false);
+	ut64 stack_slots[SLOTS_ON_STACK];
+	ut64 *slots = stack_slots;
+	if (code->slots_count > SLOTS_ON_STACK) {
+		slots = RZ_NEWS(ut64, code->slots_count);
+		if (!slots) {
+			return false;
+		}
+	}
+	bool succ = run(vm, code, slots);
+	if (slots != stack_slots) {
+		free(slots);
+	}
+	return succ;
+}
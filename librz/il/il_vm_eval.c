@@ -219,17 +219,24 @@ RZ_API void rz_il_vm_clear_events(RzILVM *vm) {
  * \param op_list, a list of op roots.
  * \param fallthrough_addr initial address to set PC to. Thus also the address to "step to" if no explicit jump occurs.
  */
-RZ_API bool rz_il_vm_step(RzILVM *vm, RzILOpEffect *op, ut64 fallthrough_addr) {
-	rz_return_val_if_fail(vm && op, false);
-
+static void step_begin(RzILVM *vm, ut64 fallthrough_addr) {
 	rz_il_vm_clear_events(vm);
 
 	// Set the successor pc **before** evaluating. Any jmp/goto may then overwrite it again.
-	RzBitVector *next_pc = rz_bv_new_from_ut64(vm->pc->len, fallthrough_addr);
-	rz_il_vm_event_add(vm, rz_il_event_pc_write_new(vm->pc, next_pc));
-	rz_bv_free(vm->pc);
-	vm->pc = next_pc;
+	// The event keeps its own copies, so the pc is updated in place.
+	RzBitVector next_pc;
+	if (rz_bv_init(&next_pc, vm->pc->len)) {
+		rz_bv_set_from_ut64(&next_pc, fallthrough_addr);
+		rz_il_vm_event_add(vm, rz_il_event_pc_write_new(vm->pc, &next_pc));
+		rz_bv_fini(&next_pc);
+	}
+	rz_bv_set_from_ut64(vm->pc, fallthrough_addr);
+}
+
+RZ_API bool rz_il_vm_step(RzILVM *vm, RzILOpEffect *op, ut64 fallthrough_addr) {
+	rz_return_val_if_fail(vm && op, false);
 
+	step_begin(vm, fallthrough_addr);
 	bool succ = rz_il_evaluate_effect(vm, op);
 
 	// remove any local defined variable (local pure vars are unbound automatically)
@@ -237,6 +244,20 @@ RZ_API bool rz_il_vm_step(RzILVM *vm, RzILOpEffect *op, ut64 fallthrough_addr) {
 	return succ;
 }
 
+/**
+ * Same as rz_il_vm_step(), but executes code from rz_il_compile_effect()
+ */
+RZ_API bool rz_il_vm_step_compiled(RZ_NONNULL RzILVM *vm, RZ_NONNULL const RzILCompiledEffect *code, ut64 fallthrough_addr) {
+	rz_return_val_if_fail(vm && code, false);
+
+	step_begin(vm, fallthrough_addr);
+	bool succ = rz_il_evaluate_compiled_effect(vm, code);
+
+	// compiled local vars live in slots, but fallbacks to the tree evaluator may have set some
+	rz_il_var_set_reset(&vm->local_vars);
+	return succ;
+}
+
 static void *eval_pure(RZ_NONNULL RzILVM *vm, RZ_NONNULL RzILOpPure *op, RZ_NONNULL RzILTypePure *type) {
 	rz_return_val_if_fail(vm && op && type, NULL);
 	RzILOpPureHandler handler = vm->op_handler_pure_table[op->code];
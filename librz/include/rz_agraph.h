@@ -87,6 +87,8 @@ typedef struct rz_ascii_graph_t {
 	unsigned int n_layers;
 	RzList *dists; /* RzList<struct dist_t> */
 	RzList *edges; /* RzList<AEdge> */
+	HtUP *layout_orders; /* layer orders already computed, by shape of the graph */
+	int layout_budget; /* ms to spend at most minimizing crossings, 0 for no limit */
 	RzAGraphHits ghits;
 } RzAGraph;
 
@@ -36,7 +36,7 @@ RZ_LIB_VERSION_HEADER(rz_analysis);
 
 /* dwarf processing context */
 typedef struct rz_analysis_dwarf_context {
-	const RzBinDwarfDebugInfo *info;
+	RzBinDwarfDebugInfo *info;
 	HtUP /*<offset, RzBinDwarfLocList*>*/ *loc;
 	// const RzBinDwarfCfa *cfa; TODO
 } RzAnalysisDwarfContext;
@@ -236,6 +236,28 @@ typedef struct rz_analysis_fcn_meta_t {
 	int numcallrefs; // number of calls
 } RzAnalysisFcnMeta;
 
+/**
+ * \brief Control flow facts of a function, computed at once on dense block indices
+ *
+ * Built and cached by rz_analysis_function_get_cfg(). Indices are the ones of
+ * the nodes of graph, which are the blocks of the function sorted by address.
+ */
+typedef struct rz_analysis_function_cfg_t {
+	ut64 bbs_generation; ///< RzAnalysisFunction.bbs_generation this was built at
+	ut64 signature; ///< hash of the blocks and their successors this was built from
+	RzGraphCSR *graph; ///< the data of each node is its RzAnalysisBlock, edges only lead to blocks of the function
+	ut32 entry; ///< index of the block at the function address, UT32_MAX if there is none
+	ut32 *idom; ///< immediate dominator of each block, UT32_MAX for the entry and the unreachable blocks
+	ut32 *dom_pre; ///< preorder number in the dominator tree, UT32_MAX for the unreachable blocks
+	ut32 *dom_post; ///< postorder number in the dominator tree
+	ut32 *loop_header; ///< header of the innermost natural loop containing each block, UT32_MAX if none
+	ut32 *loop_parent; ///< for loop headers, the header of the enclosing loop, UT32_MAX if none
+	ut32 *loop_depth; ///< number of natural loops containing each block
+	ut32 n_loops;
+	ut32 *scc; ///< strongly connected component of each block, numbered in reverse topological order
+	ut32 n_sccs;
+} RzAnalysisFunctionCFG;
+
 typedef struct rz_analysis_function_t {
 	char *name;
 	int bits; // ((> bits 0) (set-bits bits))
@@ -257,11 +279,14 @@ typedef struct rz_analysis_function_t {
 	bool has_changed; // true if function may have changed since last anaysis TODO: set this attribute where necessary
 	bool bp_frame;
 	bool is_noreturn; // true if function does not return
+	bool vars_pending; // variables not recovered yet, see analysis.vars.lazy
 	ut8 *fingerprint; // TODO: make is fuzzy and smarter
 	int argnum; // number of arguments;
 	size_t fingerprint_size;
 	RzAnalysisDiff *diff;
 	RzList *bbs; // TODO: should be RzPVector
+	ut64 bbs_generation; ///< bumped when blocks are added, removed or changed, see rz_analysis_function_get_cfg()
+	RzAnalysisFunctionCFG *cfg; ///< cached, use rz_analysis_function_get_cfg()
 	RzAnalysisFcnMeta meta;
 	RzList *imports; // maybe bound to class?
 	struct rz_analysis_t *analysis; // this function is associated with this instance
@@ -306,6 +331,13 @@ typedef struct rz_analysis_meta_item_t {
 	const RzSpace *space;
 } RzAnalysisMetaItem;
 
+typedef struct rz_analysis_meta_bulk_item_t {
+	ut64 addr;
+	ut64 size;
+	int subtype;
+	const char *str;
+} RzAnalysisMetaBulkItem;
+
 // anal
 typedef enum {
 	RZ_ANALYSIS_OP_FAMILY_UNKNOWN = -1,
@@ -507,6 +539,7 @@ typedef struct rz_analysis_options_t {
 	int depth;
 	int graph_depth;
 	bool vars; // analysisyze local var and arguments
+	bool vars_lazy; // recover the vars of aa/aaa functions only once they are looked at
 	bool varname_stack; // name vars based on their offset in the stack
 	int cjmpref;
 	int jmpref;
@@ -548,8 +581,97 @@ typedef struct rz_analysis_hint_cb_t {
 	void (*on_bits)(struct rz_analysis_t *a, ut64 addr, int bits, bool set);
 } RHintCb;
 
+/**
+ * \brief Last lookup in a tree of ranged hints: the record found holds for every address in [from, to]
+ */
+typedef struct rz_analysis_ranged_hint_cache_t {
+	bool valid;
+	ut64 from;
+	ut64 to;
+	void *record; ///< RzAnalysisRangedHintRecordBase in effect, NULL if none
+} RzAnalysisRangedHintCache;
+
 typedef struct rz_analysis_il_vm_t RzAnalysisILVM;
 
+/**
+ * \brief Window of prefetched bytes used by basic-block analysis to limit the io round trips
+ */
+typedef struct rz_analysis_read_ahead_t {
+	ut8 *buf;
+	size_t size; ///< allocated size of buf (analysis.readahead)
+	size_t len; ///< number of valid bytes in buf
+	ut64 addr; ///< address of buf[0], UT64_MAX when the window is invalid
+} RzAnalysisReadAhead;
+
+#define RZ_ANALYSIS_READ_AHEAD_DEFAULT_SIZE 0x10000
+
+#define RZ_ANALYSIS_ARENA_BLOCKS_PER_CHUNK 0x400
+#define RZ_ANALYSIS_ARENA_FCNS_PER_CHUNK   0x100
+
+#define RZ_ANALYSIS_OP_CACHE_BYTES        32
+#define RZ_ANALYSIS_OP_CACHE_DEFAULT_SIZE 0x10000
+#define RZ_ANALYSIS_IL_OP_CACHE_SIZE      0x4000
+
+/**
+ * \brief Address-keyed cache of decoded ops, see op_cache.c
+ */
+typedef struct rz_analysis_op_cache_t {
+	bool enabled; ///< analysis.opcache
+	size_t max_entries; ///< analysis.opcache.size
+	HtUP /*<ut64, RzAnalysisOpCacheEntry *>*/ *entries;
+	ut64 hits;
+	ut64 misses;
+} RzAnalysisOpCache;
+
+/**
+ * \brief Profile of one emulated instruction, see emu_prof.c
+ */
+typedef struct rz_analysis_emu_prof_insn_t {
+	ut64 addr;
+	ut64 hits; ///< number of times it was executed
+	ut64 time; ///< total microseconds spent executing it, including its memory accesses
+} RzAnalysisEmuProfInsn;
+
+/**
+ * \brief Counting profiler of esil and il emulation, see emu_prof.c
+ */
+typedef struct rz_analysis_emu_prof_t {
+	HtUP /*<ut64, RzAnalysisEmuProfInsn *>*/ *insns;
+	ut64 hits; ///< number of executed instructions
+	ut64 time_exec; ///< microseconds spent executing instructions, including memory accesses and lifting
+	ut64 time_mem; ///< microseconds spent accessing emulated memory
+	ut64 time_lift; ///< microseconds spent lifting il ops that were not cached
+	ut64 mem_reads;
+	ut64 mem_read_bytes;
+	ut64 mem_writes;
+	ut64 mem_write_bytes;
+	int depth; ///< nesting of accounted executions, only the outermost one is accounted
+} RzAnalysisEmuProf;
+
+/**
+ * \brief Mutation counters of the analysis tables, for invalidating derived caches
+ */
+typedef struct rz_analysis_generation_t {
+	ut64 fcns; ///< functions and their variables
+	ut64 blocks; ///< bb_tree
+	ut64 xrefs;
+	ut64 hints; ///< addr_hints, arch_hints and bits_hints
+	ut64 meta;
+	ut64 total; ///< sum of all the above
+} RzAnalysisGeneration;
+
+typedef struct rz_analysis_dirty_range_t {
+	ut64 generation; ///< RzAnalysisGeneration.total right after the mutation
+	ut64 from; ///< first touched address
+	ut64 to; ///< last touched address (inclusive)
+} RzAnalysisDirtyRange;
+
+/* Compact xref storage, see xrefs.c */
+typedef struct rz_analysis_xref_index_t RzAnalysisXRefIndex;
+
+/* Read-only snapshots for concurrent readers, see snapshot.c */
+typedef struct rz_analysis_snapshot_t RzAnalysisSnapshot;
+
 typedef struct rz_analysis_t {
 	char *cpu; // analysis.cpu
 	char *os; // asm.os
@@ -562,6 +684,8 @@ typedef struct rz_analysis_t {
 	void *core;
 	ut64 gp; // analysis.gp, global pointer. used for mips. but can be used by other arches too in the future
 	RBTree bb_tree; // all basic blocks by address. They can overlap each other, but must never start at the same address.
+	ut32 block_visit_mark; // private, mark of the running rz_analysis_block_recurse*() traversal
+	bool block_visit_busy; // private, a traversal is using the marks of the blocks
 	RzList *fcns;
 	HtUP *ht_addr_fun; // address => function
 	HtPP *ht_name_fun; // name => function
@@ -588,14 +712,16 @@ typedef struct rz_analysis_t {
 	RzList *plugins;
 	Sdb *sdb_noret;
 	Sdb *sdb_fmts;
-	HtUP *ht_xrefs_from;
-	HtUP *ht_xrefs_to;
+	RzAnalysisXRefIndex *xrefs_from;
+	RzAnalysisXRefIndex *xrefs_to;
 	bool recursive_noreturn; // analysis.rnr
 	// moved from RzAnalysisFcn
 	Sdb *sdb; // root
 	HtUP /*<RzVector<RzAnalysisAddrHintRecord>>*/ *addr_hints; // all hints that correspond to a single address
 	RBTree /*<RzAnalysisArchHintRecord>*/ arch_hints;
 	RBTree /*<RzAnalysisArchBitsRecord>*/ bits_hints;
+	RzAnalysisRangedHintCache arch_hints_cache;
+	RzAnalysisRangedHintCache bits_hints_cache;
 	RHintCb hint_cbs;
 	RzIntervalTree meta;
 	RzSpaces meta_spaces;
@@ -604,6 +730,7 @@ typedef struct rz_analysis_t {
 	Sdb *sdb_cc; // calling conventions
 	Sdb *sdb_classes;
 	Sdb *sdb_classes_attrs;
+	HtPP /*<char *, ClassMethods *>*/ *class_methods; ///< parsed methods of sdb_classes_attrs by class name, see class.c
 	RzAnalysisCallbacks cb;
 	RzAnalysisOptions opt;
 	RzList *reflines;
@@ -624,6 +751,20 @@ typedef struct rz_analysis_t {
 	HtPP *ht_global_var; // global variables
 	RBTree global_var_tree; // global variables by address. must not overlap
 	RzHash *hash;
+	RzAnalysisReadAhead read_ahead;
+	RzAnalysisOpCache op_cache;
+	bool use_arena; ///< analysis.arena, allocate blocks and functions from the slabs below
+	RzSlab *block_slab;
+	RzSlab *fcn_slab;
+	RzBuffer *emu_mem; ///< emu.cow, copy-on-write pages over io taking memory writes of esil and il emulation, NULL to write into io directly
+	RzAnalysisEmuProf *emu_prof; ///< emu.profile, NULL when not profiling
+	RzAnalysisGeneration gen; ///< mutation counters of the tables above, see generation.c
+	RzVector /*<RzAnalysisDirtyRange>*/ dirty; ///< address ranges of the latest mutations, see rz_analysis_dirty_since()
+	ut64 dirty_floor; ///< gen.total of the newest mutation whose range was dropped from dirty
+	Sdb *serialize_cache; ///< namespaces written by the last rz_serialize_analysis_save(), reused while their counter in gen is unchanged
+	bool publish_snapshots; ///< analysis.snapshot, publish a snapshot whenever the core waits for input
+	RzAnalysisSnapshot *snapshot; ///< last published by rz_analysis_snapshot_publish()
+	RzThreadLock *snapshot_lock; ///< protects snapshot
 } RzAnalysis;
 
 typedef enum rz_analysis_addr_hint_type_t {
@@ -724,11 +865,11 @@ typedef struct rz_analysis_var_access_t {
 // generic for args and locals
 typedef struct rz_analysis_var_t {
 	RzAnalysisFunction *fcn;
-	char *name; // name of the variable
+	const char *name; // name of the variable, interned in the analysis constpool
 	RzAnalysisVarKind kind;
 	bool isarg;
 	int delta; /* delta offset inside stack frame */
-	char *regname; // name of the register
+	const char *regname; // name of the register, interned in the analysis constpool
 	RzVector /*<RzAnalysisVarAccess>*/ accesses; // ordered by offset, touch this only through API or expect uaf
 	char *comment;
 	RzVector /*<RzTypeConstraint>*/ constraints;
@@ -886,6 +1027,10 @@ typedef struct rz_analysis_bb_t {
 	RzList *fcns;
 	RzAnalysis *analysis;
 	int ref;
+	struct rz_analysis_bb_t *_jump_bb; // private, block at jump, valid while _succ_gen matches
+	struct rz_analysis_bb_t *_fail_bb; // private, block at fail, valid while _succ_gen matches
+	ut64 _succ_gen; // private, RzAnalysis.gen.blocks when _jump_bb and _fail_bb were looked up
+	ut32 _visit_mark; // private, RzAnalysis.block_visit_mark of the last traversal that visited this block
 } RzAnalysisBlock;
 
 typedef struct rz_analysis_task_item {
@@ -999,26 +1144,34 @@ typedef struct rz_analysis_esil_interrupt_handler_t {
 	void (*fini)(void *user);
 } RzAnalysisEsilInterruptHandler;
 
-typedef struct rz_analysis_esil_change_reg_t {
-	int idx;
-	ut64 data;
-} RzAnalysisEsilRegChange;
-
-typedef struct rz_analysis_esil_change_mem_t {
-	int idx;
-	ut8 data;
-} RzAnalysisEsilMemChange;
+/**
+ * \brief A single register or memory change recorded by the esil trace
+ *
+ * Both the previous and the new value are kept, so the trace can be walked in both directions.
+ */
+typedef struct rz_analysis_esil_trace_change_t {
+	int idx; ///< trace index from which on the change is part of the state
+	ut8 size; ///< number of bytes of a memory change, 0 for register changes
+	const char *reg; ///< name of the register (from the analysis constpool), NULL for memory changes
+	ut64 addr; ///< address of the memory change
+	ut64 old; ///< value before the change, memory bytes are packed in little endian
+	ut64 data; ///< value after the change
+} RzAnalysisEsilTraceChange;
+
+#define RZ_ANALYSIS_ESIL_TRACE_CHUNK_SIZE 1024 ///< number of changes in each chunk of the trace log
+#define RZ_ANALYSIS_ESIL_TRACE_CHECKPOINT 256 ///< distance of the trace indices whose log position is indexed
 
 typedef struct rz_analysis_esil_trace_t {
 	int idx;
 	int end_idx;
-	HtUP *registers;
-	HtUP *memory;
-	RzRegArena *arena[RZ_REG_TYPE_LAST];
-	ut64 stack_addr;
-	ut64 stack_size;
-	ut8 *stack_data;
-	// RzVector<RzILTraceInstruction>
+	int start_idx; ///< lowest index that can be restored, > 0 only after old changes were dropped
+	RzPVector /*<RzAnalysisEsilTraceChange[RZ_ANALYSIS_ESIL_TRACE_CHUNK_SIZE]>*/ changes; ///< append-only log of all changes
+	ut64 changes_base; ///< number of changes dropped from the front of the log, a multiple of the chunk size
+	ut64 changes_count; ///< number of changes ever appended to the log
+	ut64 changes_applied; ///< number of changes that make up the state at idx
+	ut64 max_changes; ///< if not 0, the oldest chunks are dropped to keep about this many changes
+	RzVector /*<ut64>*/ checkpoints; ///< number of changes that make up the state at each multiple of RZ_ANALYSIS_ESIL_TRACE_CHECKPOINT
+	// RzVector<RzILTraceInstruction>, NULL for indices below start_idx
 	RzPVector *instructions;
 } RzAnalysisEsilTrace;
 
@@ -1070,6 +1223,9 @@ typedef struct rz_analysis_esil_t {
 	/* native ops and custom ops */
 	HtPP *ops;
 	RzStrBuf current_opstr;
+	HtUP *compiled; ///< address => compiled esil expression of the instruction there
+	int compiled_busy; ///< depth of the compiled expressions being run, they must not be freed meanwhile
+	bool compiled_stale; ///< the compiled expressions must be dropped once none is running anymore
 	RzIDStorage *sources;
 	HtUP *interrupts;
 	/* deep esil parsing fills this */
@@ -1091,10 +1247,6 @@ typedef struct rz_analysis_esil_t {
 	int stack_fd; // ahem, let's not do this
 } RzAnalysisEsil;
 
-/* Alias RegChange and MemChange */
-typedef RzAnalysisEsilRegChange RzAnalysisRzilRegChange;
-typedef RzAnalysisEsilMemChange RzAnalysisRzilMemChange;
-
 /* Alias esil strace */
 typedef RzAnalysisEsilTrace RzAnalysisRzilTrace;
 
@@ -1156,6 +1308,7 @@ struct rz_analysis_il_vm_t {
 	RZ_NONNULL RzILVM *vm; ///< low-level vm to execute IL code
 	RZ_NONNULL RzBuffer *io_buf; ///< buffer to use for memory 0 (io)
 	RZ_NONNULL RzILRegBinding *reg_binding; ///< specifies which (global) variables are bound to registers
+	RZ_NULLABLE HtUP /*<ut64, RzAnalysisILOpCacheEntry *>*/ *op_cache; ///< address => lifted instruction, see rz_analysis_il_vm_step()
 } /* RzAnalysisILVM */;
 
 typedef enum {
@@ -1165,6 +1318,26 @@ typedef enum {
 	RZ_ANALYSIS_IL_STEP_INVALID_OP
 } RzAnalysisILStepResult;
 
+typedef struct rz_analysis_il_batch_reg_t {
+	char *name; ///< name of the register, or of the pc register for the program counter
+	ut64 value;
+} RzAnalysisILBatchReg;
+
+/**
+ * \brief One independent emulation run of rz_analysis_il_vm_batch_run()
+ */
+typedef struct rz_analysis_il_batch_job_t {
+	RzVector /*<RzAnalysisILBatchReg>*/ regs; ///< registers to set on top of analysis->reg before starting
+	ut64 until; ///< stop when the pc reaches this address, UT64_MAX for none
+	ut64 max_steps; ///< stop after this many instructions at most
+	// results
+	RzAnalysisILStepResult result; ///< result of the last step
+	ut64 steps; ///< number of instructions executed successfully
+	ut64 pc; ///< final program counter
+	RzVector /*<RzAnalysisILBatchReg>*/ final_regs; ///< final contents of all registers bound in the vm
+	RZ_NULLABLE RzBuffer *mem; ///< cow view of memory after the run, rz_buf_cow_get_pages() gives all pages it wrote
+} RzAnalysisILBatchJob;
+
 #undef ESIL
 
 typedef struct rz_analysis_esil_interrupt_t {
@@ -1240,6 +1413,7 @@ typedef struct rz_analysis_plugin_t {
 	int bits;
 	int esil; // can do esil or not
 	int fileformat_type;
+	bool concurrent_op; ///< op() without RZ_ANALYSIS_OP_MASK_ESIL only uses the state of its RzAnalysis, so different instances can run it in parallel
 	bool (*init)(void **user);
 	bool (*fini)(void *user);
 	// int (*reset_counter) (RzAnalysis *analysis, ut64 start_addr);
@@ -1285,6 +1459,66 @@ RZ_API const char *rz_analysis_op_family_to_string(int n);
 RZ_API int rz_analysis_op_family_from_string(const char *f);
 RZ_API int rz_analysis_op_hint(RzAnalysisOp *op, RzAnalysisHint *hint);
 
+/* op_cache.c */
+RZ_API void rz_analysis_op_cache_init(RzAnalysis *analysis);
+RZ_API void rz_analysis_op_cache_fini(RzAnalysis *analysis);
+RZ_API void rz_analysis_op_cache_enable(RzAnalysis *analysis, bool enable);
+RZ_API void rz_analysis_op_cache_set_max_entries(RzAnalysis *analysis, size_t max_entries);
+RZ_API void rz_analysis_op_cache_invalidate(RzAnalysis *analysis);
+RZ_API void rz_analysis_op_cache_reset_stats(RzAnalysis *analysis);
+RZ_API bool rz_analysis_op_cache_save(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL const char *path);
+RZ_API bool rz_analysis_op_cache_load(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL const char *path);
+RZ_IPI bool rz_analysis_op_cache_get(RzAnalysis *analysis, RzAnalysisOp *op, int *ret, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask);
+RZ_IPI void rz_analysis_op_cache_put(RzAnalysis *analysis, const RzAnalysisOp *op, int ret, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask);
+
+/* generation.c */
+RZ_API ut64 rz_analysis_generation(RZ_NONNULL RzAnalysis *analysis);
+RZ_API bool rz_analysis_dirty_since(RZ_NONNULL RzAnalysis *analysis, ut64 generation, RZ_NONNULL RZ_OUT ut64 *from, RZ_NONNULL RZ_OUT ut64 *to);
+
+/* snapshot.c */
+typedef struct rz_analysis_snapshot_function_t {
+	ut64 addr;
+	const char *name;
+	int type;
+	int bits;
+	ut64 min_addr; ///< lowest address of the blocks
+	ut64 max_addr; ///< end of the highest block
+	const ut64 *blocks; ///< addresses of the blocks, sorted
+	size_t blocks_count;
+} RzAnalysisSnapshotFunction;
+
+typedef struct rz_analysis_snapshot_block_t {
+	ut64 addr;
+	ut64 size;
+	ut64 jump;
+	ut64 fail;
+	int ninstr;
+	const ut64 *fcns; ///< entrypoints of the functions the block belongs to, sorted
+	size_t fcns_count;
+} RzAnalysisSnapshotBlock;
+
+RZ_API bool rz_analysis_snapshot_publish(RZ_NONNULL RzAnalysis *analysis);
+RZ_API RZ_OWN RzAnalysisSnapshot *rz_analysis_snapshot_acquire(RZ_NONNULL RzAnalysis *analysis);
+RZ_API void rz_analysis_snapshot_release(RZ_NULLABLE RzAnalysisSnapshot *snap);
+RZ_API ut64 rz_analysis_snapshot_generation(RZ_NONNULL const RzAnalysisSnapshot *snap);
+RZ_API RZ_BORROW const RzAnalysisSnapshotFunction *rz_analysis_snapshot_functions(RZ_NONNULL const RzAnalysisSnapshot *snap, RZ_NONNULL RZ_OUT size_t *count);
+RZ_API RZ_BORROW const RzAnalysisSnapshotFunction *rz_analysis_snapshot_function_at(RZ_NONNULL const RzAnalysisSnapshot *snap, ut64 addr);
+RZ_API RZ_OWN RzPVector /*<const RzAnalysisSnapshotBlock *>*/ *rz_analysis_snapshot_blocks_in(RZ_NONNULL const RzAnalysisSnapshot *snap, ut64 addr);
+RZ_API RZ_OWN RzPVector /*<const RzAnalysisSnapshotFunction *>*/ *rz_analysis_snapshot_functions_in(RZ_NONNULL const RzAnalysisSnapshot *snap, ut64 addr);
+RZ_API RZ_BORROW const RzAnalysisXRef *rz_analysis_snapshot_xrefs_from(RZ_NONNULL const RzAnalysisSnapshot *snap, ut64 addr, RZ_NONNULL RZ_OUT size_t *count);
+RZ_API RZ_BORROW const RzAnalysisXRef *rz_analysis_snapshot_xrefs_to(RZ_NONNULL const RzAnalysisSnapshot *snap, ut64 addr, RZ_NONNULL RZ_OUT size_t *count);
+RZ_IPI void rz_analysis_dirty_init(RzAnalysis *analysis);
+RZ_IPI void rz_analysis_dirty_fini(RzAnalysis *analysis);
+RZ_IPI void rz_analysis_mark_dirty(RzAnalysis *analysis, ut64 *counter, ut64 from, ut64 to);
+
+/* emu_prof.c */
+RZ_API bool rz_analysis_emu_prof_enable(RZ_NONNULL RzAnalysis *analysis, bool enable);
+RZ_API void rz_analysis_emu_prof_free(RZ_NULLABLE RzAnalysisEmuProf *prof);
+RZ_API void rz_analysis_emu_prof_reset(RZ_NONNULL RzAnalysisEmuProf *prof);
+RZ_API RZ_OWN RzPVector /*<RzAnalysisEmuProfInsn *>*/ *rz_analysis_emu_prof_insns(RZ_NONNULL RzAnalysisEmuProf *prof);
+RZ_IPI void rz_analysis_emu_prof_insn(RzAnalysisEmuProf *prof, ut64 addr, ut64 time);
+RZ_IPI void rz_analysis_emu_prof_mem(RzAnalysisEmuProf *prof, bool write, ut64 len, ut64 time);
+
 /* block.c */
 typedef bool (*RzAnalysisBlockCb)(RzAnalysisBlock *block, void *user);
 typedef bool (*RzAnalysisAddrCb)(ut64 addr, void *user);
@@ -1297,6 +1531,11 @@ RZ_API void rz_analysis_block_unref(RzAnalysisBlock *bb);
 // This will fail if the range overlaps any existing blocks.
 RZ_API RzAnalysisBlock *rz_analysis_create_block(RzAnalysis *analysis, ut64 addr, ut64 size);
 
+// Create blocks out of the tree and insert all of them at once, e.g. when loading a project.
+RZ_IPI RzAnalysisBlock *rz_analysis_block_new_unlinked(RzAnalysis *analysis, ut64 addr, ut64 size);
+RZ_IPI void rz_analysis_block_free_unlinked(RzAnalysisBlock *block);
+RZ_IPI bool rz_analysis_blocks_link_all(RzAnalysis *analysis, RzPVector /*<RzAnalysisBlock *>*/ *blocks);
+
 static inline bool rz_analysis_block_contains(RzAnalysisBlock *bb, ut64 addr) {
 	return addr >= bb->addr && addr < bb->addr + bb->size;
 }
@@ -1381,6 +1620,9 @@ RZ_API void rz_analysis_block_update_hash(RzAnalysisBlock *block);
 // returns true if a byte in the given basic block was modified
 RZ_API bool rz_analysis_block_was_modified(RzAnalysisBlock *block);
 
+RZ_API void rz_analysis_blocks_update_hash(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzAnalysisBlock **blocks, size_t count);
+RZ_API bool rz_analysis_blocks_were_modified(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzAnalysisBlock **blocks, size_t count);
+
 RZ_API RzAnalysisBlock *rz_analysis_find_most_relevant_block_in(RzAnalysis *analysis, ut64 off);
 
 RZ_API ut16 rz_analysis_block_get_op_offset(RzAnalysisBlock *block, size_t i);
@@ -1422,6 +1664,12 @@ RZ_API bool rz_analysis_function_relocate(RzAnalysisFunction *fcn, ut64 addr);
 // This can fail (and return false) if there is another function with the name given
 RZ_API bool rz_analysis_function_rename(RzAnalysisFunction *fcn, const char *name);
 
+// change the bits of the given function, use this instead of writing fcn->bits
+RZ_API void rz_analysis_function_set_bits(RzAnalysisFunction *fcn, int bits);
+
+// change the RZ_ANALYSIS_FCN_TYPE_* of the given function, use this instead of writing fcn->type
+RZ_API void rz_analysis_function_set_fcntype(RzAnalysisFunction *fcn, int type);
+
 RZ_API void rz_analysis_function_add_block(RzAnalysisFunction *fcn, RzAnalysisBlock *bb);
 RZ_API void rz_analysis_function_remove_block(RzAnalysisFunction *fcn, RzAnalysisBlock *bb);
 
@@ -1455,11 +1703,13 @@ RZ_API RZ_OWN char *rz_analysis_function_name_guess(RzTypeDB *typedb, RZ_NONNULL
 /* analysis.c */
 RZ_API RzAnalysis *rz_analysis_new(void);
 RZ_API void rz_analysis_purge(RzAnalysis *analysis);
+RZ_API void rz_analysis_arena_stats(RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSlabStats *blocks, RZ_NULLABLE RzSlabStats *fcns);
 RZ_API RzAnalysis *rz_analysis_free(RzAnalysis *r);
 RZ_API int rz_analysis_add(RzAnalysis *analysis, RzAnalysisPlugin *foo);
 RZ_API int rz_analysis_archinfo(RzAnalysis *analysis, int query);
 RZ_API bool rz_analysis_use(RzAnalysis *analysis, const char *name);
 RZ_API bool rz_analysis_set_reg_profile(RzAnalysis *analysis);
+RZ_API bool rz_analysis_set_emu_cow(RzAnalysis *analysis, bool enable);
 RZ_API char *rz_analysis_get_reg_profile(RzAnalysis *analysis);
 RZ_API bool rz_analysis_set_bits(RzAnalysis *analysis, int bits);
 RZ_API bool rz_analysis_set_os(RzAnalysis *analysis, const char *os);
@@ -1591,8 +1841,13 @@ RZ_API void rz_analysis_il_vm_free(RZ_NULLABLE RzAnalysisILVM *vm);
 RZ_API void rz_analysis_il_vm_sync_from_reg(RzAnalysisILVM *vm, RZ_NONNULL RzReg *reg);
 RZ_API bool rz_analysis_il_vm_sync_to_reg(RzAnalysisILVM *vm, RZ_NONNULL RzReg *reg);
 RZ_API RzAnalysisILStepResult rz_analysis_il_vm_step(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzAnalysisILVM *vm, RZ_NULLABLE RzReg *reg);
+RZ_API void rz_analysis_il_vm_cache_invalidate(RZ_NONNULL RzAnalysisILVM *vm);
 RZ_API bool rz_analysis_il_vm_setup(RzAnalysis *analysis);
 RZ_API void rz_analysis_il_vm_cleanup(RzAnalysis *analysis);
+RZ_API RZ_OWN RzAnalysisILBatchJob *rz_analysis_il_batch_job_new(ut64 until, ut64 max_steps);
+RZ_API void rz_analysis_il_batch_job_free(RZ_NULLABLE RzAnalysisILBatchJob *job);
+RZ_API bool rz_analysis_il_batch_job_set_reg(RZ_NONNULL RzAnalysisILBatchJob *job, RZ_NONNULL const char *name, ut64 value);
+RZ_API bool rz_analysis_il_vm_batch_run(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzPVector /*<RzAnalysisILBatchJob *>*/ *jobs, RZ_NULLABLE RzThreadTaskPool *pool);
 
 /* trace */
 RZ_API RzAnalysisRzilTrace *rz_analysis_rzil_trace_new(RzAnalysis *analysis, RzAnalysisILVM *rzil);
@@ -1618,13 +1873,15 @@ RZ_API bool rz_analysis_fcn_add_bb(RzAnalysis *analysis, RzAnalysisFunction *fcn
 	ut64 addr, ut64 size,
 	ut64 jump, ut64 fail, RZ_BORROW RzAnalysisDiff *diff);
 RZ_API bool rz_analysis_check_fcn(RzAnalysis *analysis, ut8 *buf, ut16 bufsz, ut64 addr, ut64 low, ut64 high);
-RZ_API void rz_analysis_fcn_invalidate_read_ahead_cache(void);
+RZ_API void rz_analysis_fcn_invalidate_read_ahead_cache(RzAnalysis *analysis);
+RZ_API bool rz_analysis_fcn_set_read_ahead_size(RzAnalysis *analysis, size_t size);
 
 RZ_API void rz_analysis_function_check_bp_use(RzAnalysisFunction *fcn);
 RZ_API void rz_analysis_update_analysis_range(RzAnalysis *analysis, ut64 addr, int size);
 RZ_API void rz_analysis_function_update_analysis(RzAnalysisFunction *fcn);
 
 RZ_API bool rz_analysis_task_item_new(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzVector *tasks, RZ_NONNULL RzAnalysisFunction *fcn, RZ_NULLABLE RzAnalysisBlock *block, ut64 address);
+RZ_API bool rz_analysis_task_items_new(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzVector *tasks, RZ_NONNULL RzAnalysisFunction *fcn, RZ_NULLABLE RzAnalysisBlock *block, RZ_NONNULL const ut64 *addrs, size_t count);
 RZ_API int rz_analysis_run_tasks(RZ_NONNULL RzVector *tasks);
 
 #define RZ_ANALYSIS_FCN_VARKIND_LOCAL 'v'
@@ -1636,6 +1893,17 @@ RZ_API int rz_analysis_var_count(RzAnalysis *a, RzAnalysisFunction *fcn, int kin
 
 RZ_API int rz_analysis_function_complexity(RzAnalysisFunction *fcn);
 RZ_API int rz_analysis_function_loops(RzAnalysisFunction *fcn);
+
+/* function_cfg.c */
+RZ_API RZ_BORROW const RzAnalysisFunctionCFG *rz_analysis_function_get_cfg(RZ_NONNULL RzAnalysisFunction *fcn);
+RZ_API ut32 rz_analysis_function_cfg_index(RZ_NONNULL const RzAnalysisFunctionCFG *cfg, ut64 addr);
+RZ_API bool rz_analysis_function_cfg_dominates(RZ_NONNULL const RzAnalysisFunctionCFG *cfg, ut32 a, ut32 b);
+RZ_API RZ_BORROW RzAnalysisBlock *rz_analysis_function_idom(RZ_NONNULL RzAnalysisFunction *fcn, ut64 addr);
+RZ_API bool rz_analysis_function_dominates(RZ_NONNULL RzAnalysisFunction *fcn, ut64 a, ut64 b);
+RZ_API RZ_BORROW RzAnalysisBlock *rz_analysis_function_loop_header(RZ_NONNULL RzAnalysisFunction *fcn, ut64 addr);
+RZ_API ut32 rz_analysis_function_loop_depth(RZ_NONNULL RzAnalysisFunction *fcn, ut64 addr);
+RZ_API ut32 rz_analysis_function_scc(RZ_NONNULL RzAnalysisFunction *fcn, ut64 addr);
+RZ_IPI void rz_analysis_function_cfg_invalidate(RzAnalysisFunction *fcn);
 RZ_API void rz_analysis_trim_jmprefs(RzAnalysis *analysis, RzAnalysisFunction *fcn);
 RZ_API void rz_analysis_del_jmprefs(RzAnalysis *analysis, RzAnalysisFunction *fcn);
 RZ_API char *rz_analysis_function_get_json(RzAnalysisFunction *function);
@@ -1650,6 +1918,7 @@ RZ_API int rz_analysis_function_resize(RzAnalysisFunction *fcn, int newsize);
 RZ_API bool rz_analysis_function_purity(RzAnalysisFunction *fcn);
 
 typedef bool (*RzAnalysisRefCmp)(RzAnalysisXRef *ref, void *data);
+typedef bool (*RzAnalysisXRefCb)(void *user, const RzAnalysisXRef *xref);
 RZ_API RzList *rz_analysis_xref_list_new(void);
 RZ_API ut64 rz_analysis_xrefs_count(RzAnalysis *analysis);
 RZ_API const char *rz_analysis_xrefs_type_tostring(RzAnalysisXRefType type);
@@ -1659,9 +1928,17 @@ RZ_API RzList *rz_analysis_xrefs_get_from(RzAnalysis *analysis, ut64 addr);
 RZ_API RzList *rz_analysis_xrefs_list(RzAnalysis *analysis);
 RZ_API RzList *rz_analysis_function_get_xrefs_from(RzAnalysisFunction *fcn);
 RZ_API RzList *rz_analysis_function_get_xrefs_to(RzAnalysisFunction *fcn);
+RZ_API RZ_OWN RzVector /*<RzAnalysisXRef>*/ *rz_analysis_xrefs_get_to_vec(RZ_NONNULL RzAnalysis *analysis, ut64 addr);
+RZ_API RZ_OWN RzVector /*<RzAnalysisXRef>*/ *rz_analysis_xrefs_get_from_vec(RZ_NONNULL RzAnalysis *analysis, ut64 addr);
+RZ_API RZ_OWN RzVector /*<RzAnalysisXRef>*/ *rz_analysis_function_get_xrefs_from_vec(RZ_NONNULL RzAnalysisFunction *fcn);
+RZ_API RZ_OWN RzVector /*<RzAnalysisXRef>*/ *rz_analysis_function_get_xrefs_to_vec(RZ_NONNULL RzAnalysisFunction *fcn);
 RZ_API bool rz_analysis_xrefs_set(RzAnalysis *analysis, ut64 from, ut64 to, RzAnalysisXRefType type);
 RZ_API bool rz_analysis_xrefs_deln(RzAnalysis *analysis, ut64 from, ut64 to, RzAnalysisXRefType type);
 RZ_API bool rz_analysis_xref_del(RzAnalysis *analysis, ut64 from, ut64 to);
+RZ_API ut64 rz_analysis_xrefs_del_from_range(RZ_NONNULL RzAnalysis *analysis, ut64 from, ut64 to);
+RZ_API bool rz_analysis_xrefs_foreach_from(RZ_NONNULL RzAnalysis *analysis, ut64 addr, RZ_NONNULL RzAnalysisXRefCb cb, void *user);
+RZ_API bool rz_analysis_xrefs_foreach_to(RZ_NONNULL RzAnalysis *analysis, ut64 addr, RZ_NONNULL RzAnalysisXRefCb cb, void *user);
+RZ_API bool rz_analysis_xrefs_foreach(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzAnalysisXRefCb cb, void *user);
 
 RZ_API RzList *rz_analysis_get_fcns(RzAnalysis *analysis);
 
@@ -1749,6 +2026,7 @@ RZ_API RZ_OWN RzList /* RzTypePath */ *rz_analysis_type_paths_by_address(RzAnaly
 
 /* project */
 RZ_API bool rz_analysis_xrefs_init(RzAnalysis *analysis);
+RZ_API void rz_analysis_xrefs_fini(RzAnalysis *analysis);
 
 #define RZ_ANALYSIS_THRESHOLDFCN 0.7F
 #define RZ_ANALYSIS_THRESHOLDBB  0.7F
@@ -1762,6 +2040,7 @@ RZ_API int rz_analysis_diff_fingerprint_bb(RzAnalysis *analysis, RzAnalysisBlock
 RZ_API size_t rz_analysis_diff_fingerprint_fcn(RzAnalysis *analysis, RzAnalysisFunction *fcn);
 RZ_API bool rz_analysis_diff_bb(RzAnalysis *analysis, RzAnalysisFunction *fcn, RzAnalysisFunction *fcn2);
 RZ_API int rz_analysis_diff_fcn(RzAnalysis *analysis, RzList *fcns, RzList *fcns2);
+RZ_API int rz_analysis_diff_fcn_parallel(RzAnalysis *analysis, RzList *fcns1, RzList *fcns2, RZ_NULLABLE RzThreadTaskPool *pool);
 RZ_API int rz_analysis_diff_eval(RzAnalysis *analysis);
 
 /* value.c */
@@ -1874,6 +2153,9 @@ RZ_API bool rz_meta_set(RzAnalysis *a, RzAnalysisMetaType type, ut64 addr, ut64
 // Same as rz_meta_set() but also sets the subtype.
 RZ_API bool rz_meta_set_with_subtype(RzAnalysis *m, RzAnalysisMetaType type, int subtype, ut64 addr, ut64 size, const char *str);
 
+// Same as rz_meta_set_with_subtype() on each of the given items in order, much faster on an empty meta tree.
+RZ_API bool rz_meta_set_bulk(RZ_NONNULL RzAnalysis *a, RzAnalysisMetaType type, RZ_NULLABLE const RzAnalysisMetaBulkItem *items, size_t count);
+
 // Delete all meta items in the current space that intersect with the given interval.
 // If size == UT64_MAX, everything in the current space will be deleted.
 RZ_API void rz_meta_del(RzAnalysis *a, RzAnalysisMetaType type, ut64 addr, ut64 size);
@@ -1903,6 +2185,11 @@ RZ_API RzPVector /*<RzIntervalNode<RMetaItem> *>*/ *rz_meta_get_all_in(RzAnalysi
 // Returns all nodes for items with the given type intersecting the given interval in the current space.
 RZ_API RzPVector /*<RzIntervalNode<RMetaItem> *>*/ *rz_meta_get_all_intersect(RzAnalysis *a, ut64 start, ut64 size, RzAnalysisMetaType type);
 
+// Same as the rz_meta_get_all_*() functions, but call cb on each node instead of collecting them, until it returns false.
+RZ_API bool rz_meta_foreach_at(RZ_NONNULL RzAnalysis *a, ut64 at, RzAnalysisMetaType type, RZ_NONNULL RzIntervalIterCb cb, void *user);
+RZ_API bool rz_meta_foreach_in(RZ_NONNULL RzAnalysis *a, ut64 at, RzAnalysisMetaType type, RZ_NONNULL RzIntervalIterCb cb, void *user);
+RZ_API bool rz_meta_foreach_intersect(RZ_NONNULL RzAnalysis *a, ut64 start, ut64 size, RzAnalysisMetaType type, RZ_NONNULL RzIntervalIterCb cb, void *user);
+
 // Delete all meta items in the given space
 RZ_API void rz_meta_space_unset_for(RzAnalysis *a, const RzSpace *space);
 
@@ -2108,6 +2395,9 @@ RZ_API RzAnalysisClassErr rz_analysis_class_method_delete(RzAnalysis *analysis,
 RZ_API bool rz_analysis_class_method_exists(RzAnalysis *analysis, const char *class_name, const char *meth_name);
 RZ_API bool rz_analysis_class_method_exists_by_addr(RzAnalysis *analysis, const char *class_name, ut64 addr);
 RZ_API void rz_analysis_class_method_recover(RzAnalysis *analysis, RzBinClass *cls, RzList *methods);
+RZ_IPI void rz_analysis_class_methods_init(RzAnalysis *analysis);
+RZ_IPI void rz_analysis_class_methods_fini(RzAnalysis *analysis);
+RZ_IPI void rz_analysis_class_methods_reset(RzAnalysis *analysis);
 
 RZ_API void rz_analysis_class_base_fini(RzAnalysisBaseClass *base);
 RZ_API RzAnalysisClassErr rz_analysis_class_base_get(RzAnalysis *analysis, const char *class_name, const char *base_id, RzAnalysisBaseClass *base);
@@ -2206,6 +2496,7 @@ RZ_API bool rz_serialize_analysis_cc_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnaly
 
 RZ_API void rz_serialize_analysis_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis);
 RZ_API bool rz_serialize_analysis_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res);
+RZ_API bool rz_serialize_analysis_load_parallel(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzThreadTaskPool *pool, RZ_NULLABLE RzSerializeResultInfo *res);
 
 /* plugin pointers */
 extern RzAnalysisPlugin rz_analysis_plugin_null;
@@ -72,6 +72,16 @@ typedef struct rz_asm_op_t {
 	RzBuffer *buf_inc; // must die
 } RzAsmOp;
 
+/**
+ * \brief One instruction decoded by rz_asm_disassemble_batch()
+ */
+typedef struct rz_asm_insn_t {
+	ut64 addr;
+	int size; ///< bytes taken by the instruction, 1 if it is invalid
+	bool invalid;
+	int asm_off; ///< offset of the nul-terminated text in the text buffer of the batch, -1 without text
+} RzAsmInsn;
+
 typedef struct rz_asm_code_t {
 #if 1
 	int len;
@@ -80,16 +90,18 @@ typedef struct rz_asm_code_t {
 #else
 	RzAsmOp op; // we have those fields already inside RzAsmOp
 #endif
-	RzList *equs; // TODO: must be a hash
+	RzList *equs; ///< RzAsmEqu, in definition order
+	HtPP *equs_by_key; ///< key -> RzAsmEqu of equs
+	RzVector /*<size_t>*/ *equs_lens; ///< distinct lengths of the keys
 	ut64 code_offset;
 	ut64 data_offset;
 	int code_align;
 } RzAsmCode;
 
-// TODO: Must use Hashtable instead of this hack
 typedef struct {
 	char *key;
 	char *value;
+	size_t index; ///< position in RzAsmCode.equs
 } RzAsmEqu;
 
 #define _RzAsmPlugin struct rz_asm_plugin_t
@@ -136,6 +148,13 @@ typedef struct rz_asm_plugin_t {
 	bool (*init)(void **user);
 	bool (*fini)(void *user);
 	int (*disassemble)(RzAsm *a, RzAsmOp *op, const ut8 *buf, int len);
+	/**
+	 * Optional, decode up to n instructions of buf at a->pc with a single setup,
+	 * stopping before the first one that does not decode. The text, if asked
+	 * for, must be the one disassemble() gives.
+	 * \return the number of instructions written to insns
+	 */
+	int (*disassemble_batch)(RzAsm *a, RzAsmInsn *insns, int n, const ut8 *buf, int len, RZ_NULLABLE RzStrBuf *text);
 	int (*assemble)(RzAsm *a, RzAsmOp *op, const char *buf);
 	char *(*mnemonics)(RzAsm *a, int id, bool json);
 	RzConfig *(*get_config)(void);
@@ -162,6 +181,7 @@ RZ_API bool rz_asm_set_syntax(RzAsm *a, int syntax);
 RZ_API int rz_asm_syntax_from_string(const char *name);
 RZ_API int rz_asm_set_pc(RzAsm *a, ut64 pc);
 RZ_API int rz_asm_disassemble(RzAsm *a, RzAsmOp *op, const ut8 *buf, int len);
+RZ_API int rz_asm_disassemble_batch(RZ_NONNULL RzAsm *a, RZ_NONNULL const ut8 *buf, int len, RZ_NONNULL RZ_OUT RzAsmInsn *insns, int n, RZ_NULLABLE RzStrBuf *text);
 RZ_API int rz_asm_assemble(RzAsm *a, RzAsmOp *op, const char *buf);
 RZ_API RzAsmCode *rz_asm_mdisassemble(RzAsm *a, const ut8 *buf, int len);
 RZ_API RzAsmCode *rz_asm_mdisassemble_hexstr(RzAsm *a, RzParse *p, const char *hexstr);
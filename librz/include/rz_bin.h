@@ -13,8 +13,16 @@
 typedef struct rz_bin_t RzBin;
 typedef struct rz_bin_file_t RzBinFile;
 typedef struct rz_bin_source_line_info_t RzBinSourceLineInfo;
+typedef struct rz_bin_source_line_index_t RzBinSourceLineIndex;
+typedef struct rz_bin_source_line_sample_t RzBinSourceLineSample;
 typedef struct rz_bin_reloc_storage_t RzBinRelocStorage;
 
+/**
+ * \brief Called for each sample, the file of \p sample is only valid during the call
+ * \return false to stop the iteration
+ */
+typedef bool (*RzBinSourceLineSampleCb)(void *user, const RzBinSourceLineSample *sample);
+
 #include <rz_bin_dwarf.h>
 #include <rz_pdb.h>
 
@@ -281,7 +289,7 @@ typedef struct rz_bin_object_t {
 	RzList /*<RzBinClass>*/ *classes;
 	HtPP *classes_ht;
 	HtPP *methods_ht;
-	RzBinSourceLineInfo *lines;
+	RzBinSourceLineIndex *lines;
 	RzList /*<RzBinMem>*/ *mem;
 	char *regstate;
 	RzBinInfo *info;
@@ -291,6 +299,15 @@ typedef struct rz_bin_object_t {
 	RZ_DEPRECATE RZ_BORROW Sdb *kv; ///< deprecated, put info in C structures instead of this (holds a copy of another pointer.)
 	HtUP *addrzklassmethod;
 	void *bin_obj; // internal pointer used by formats
+	/**
+	 * \name Lazy loading, see bin.lazy
+	 * Imports, symbols, relocs, classes and the language are only asked to
+	 * the plugin by the first accessor that needs them.
+	 */
+	ut32 lazy_pending; ///< items not loaded yet
+	ut32 lazy_loading; ///< items being loaded right now
+	RzThreadLock *lazy_lock;
+	struct rz_bin_file_t *lazy_bf; ///< the file to load the pending items from
 } RzBinObject;
 
 // XXX: RbinFile may hold more than one RzBinObject
@@ -351,11 +368,13 @@ struct rz_bin_t {
 	int is_debugger;
 	bool want_dbginfo;
 	int filter; // symbol filtering
+	bool lazy; // load imports, symbols, relocs and classes on first use
 	char strfilter; // string filtering
 	char *strpurge; // purge false positive strings
 	char *srcdir; // dir.source
 	char *prefix; // bin.prefix
 	char *strenc;
+	char *cache_dir; // bin.cache.dir, where parsed objects are cached, NULL to disable
 	ut64 filter_rules;
 	bool verbose;
 	bool use_xtr; // use extract plugins when loading a file?
@@ -449,7 +468,7 @@ RZ_API void rz_bin_trycatch_free(RzBinTrycatch *tc);
  * Such a case corresponds for example to what DW_LNE_end_sequence emits in Dwarf.
  * Use rz_bin_source_line_sample_is_closing() for checking if a sample is closing.
  */
-typedef struct rz_bin_source_line_sample_t {
+struct rz_bin_source_line_sample_t {
 	/**
 	 * The first address that is covered by the given line and column,
 	 * or, if all other members are 0/NULL, this is the first.
@@ -477,7 +496,7 @@ typedef struct rz_bin_source_line_sample_t {
 	 * RzBinSourceLineInfo or RzBinSourceLineInfoBuilder.
 	 */
 	const char *file;
-} RzBinSourceLineSample;
+};
 
 /*
  * see documentation of RzBinSourceLineSample about what closing exactly means.
@@ -516,6 +535,38 @@ RZ_API void rz_bin_source_line_info_free(RzBinSourceLineInfo *sli);
 RZ_API const RzBinSourceLineSample *rz_bin_source_line_info_get_first_at(const RzBinSourceLineInfo *sli, ut64 addr);
 RZ_API const RzBinSourceLineSample *rz_bin_source_line_info_get_next(const RzBinSourceLineInfo *sli, RZ_NONNULL const RzBinSourceLineSample *cur);
 
+/**
+ * \brief Builds an RzBinSourceLineIndex out of samples pushed in any order
+ *
+ * The samples are delta-encoded as they come, so building the index costs
+ * a few bytes per sample instead of a whole RzBinSourceLineSample.
+ */
+typedef struct rz_bin_source_line_index_builder_t RzBinSourceLineIndexBuilder;
+
+RZ_API RZ_OWN RzBinSourceLineIndexBuilder *rz_bin_source_line_index_builder_new(void);
+RZ_API void rz_bin_source_line_index_builder_free(RZ_NULLABLE RzBinSourceLineIndexBuilder *builder);
+RZ_API bool rz_bin_source_line_index_builder_push_sample(RZ_NONNULL RzBinSourceLineIndexBuilder *builder, RZ_NONNULL const RzBinSourceLineSample *sample);
+RZ_API RZ_OWN RzBinSourceLineIndex *rz_bin_source_line_index_builder_build_and_free(RZ_NONNULL RZ_OWN RzBinSourceLineIndexBuilder *builder);
+
+RZ_API RZ_OWN RzBinSourceLineIndex *rz_bin_source_line_index_new_from_info(RZ_NONNULL const RzBinSourceLineInfo *sli);
+RZ_API void rz_bin_source_line_index_free(RZ_NULLABLE RzBinSourceLineIndex *index);
+RZ_API size_t rz_bin_source_line_index_count(RZ_NONNULL const RzBinSourceLineIndex *index);
+RZ_API bool rz_bin_source_line_index_foreach(RZ_NONNULL const RzBinSourceLineIndex *index, RZ_NONNULL RzBinSourceLineSampleCb cb, void *user);
+RZ_API bool rz_bin_source_line_index_foreach_at(RZ_NONNULL const RzBinSourceLineIndex *index, ut64 addr, RZ_NONNULL RzBinSourceLineSampleCb cb, void *user);
+
+#define RZ_BIN_MAGIC_MAX 16
+
+/**
+ * \brief Bytes that a buffer in the format of a plugin starts with
+ */
+typedef struct rz_bin_magic_t {
+	const ut8 *bytes;
+	size_t size; ///< at most RZ_BIN_MAGIC_MAX, 0 terminates a list of magics
+} RzBinMagic;
+
+#define RZ_BIN_MAGIC(str) \
+	{ (const ut8 *)(str), sizeof(str) - 1 }
+
 typedef struct rz_bin_plugin_t {
 	char *name;
 	char *desc;
@@ -528,6 +579,7 @@ typedef struct rz_bin_plugin_t {
 	void (*destroy)(RzBinFile *bf);
 	bool (*check_bytes)(const ut8 *buf, ut64 length);
 	bool (*check_buffer)(RzBuffer *buf);
+	const RzBinMagic *magics; ///< optional, check_buffer is then only called on buffers starting with one of them
 	bool (*check_filename)(const char *filename);
 	ut64 (*baddr)(RzBinFile *bf);
 	ut64 (*boffset)(RzBinFile *bf);
@@ -550,6 +602,7 @@ typedef struct rz_bin_plugin_t {
 	RzList /*<RzBinReloc>*/ *(*patch_relocs)(RzBinFile *bf);
 	RzList /*<RzBinFileHash>*/ *(*hashes)(RzBinFile *bf);
 	RzList /*<RzBinResource>*/ *(*resources)(RzBinFile *bf);
+	bool (*load_vaddr)(RzBinFile *bf, ut64 vaddr); ///< load the part of the file holding vaddr if it was left out by bin.lazy, true if the items changed
 	void (*header)(RzBinFile *bf);
 	char *(*signature)(RzBinFile *bf, bool json);
 	int (*demangle_type)(const char *str);
@@ -739,12 +792,28 @@ typedef struct rz_bin_reloc_t {
 
 RZ_API ut64 rz_bin_reloc_size(RzBinReloc *reloc);
 
+/**
+ * \brief Index from fixed-size pages of the address space to a sorted array of addresses
+ *
+ * A lookup only has to binary search the addresses of one page instead of the whole array.
+ */
+typedef struct rz_bin_reloc_page_index_t {
+	ut64 base; ///< lowest address of the array
+	ut32 shift; ///< log2 of the page size
+	size_t count; ///< number of pages
+	size_t *first; ///< count + 1 entries, first[p] is the index of the first address >= base + (p << shift)
+} RzBinRelocPageIndex;
+
 /// Efficient storage of relocations to query by address
 struct rz_bin_reloc_storage_t {
-	RzBinReloc **relocs; ///< all relocs, ordered by their vaddr
+	RzBinReloc *relocs; ///< all relocs, ordered by their vaddr and stored contiguously
 	size_t relocs_count;
+	ut64 *vaddrs; ///< vaddr of each reloc in relocs, so searches don't touch the relocs themselves
+	RzBinRelocPageIndex vaddr_pages;
 	RzBinReloc **target_relocs; ///< all relocs that have a valid target_vaddr, ordered by their target_vaddr. size is target_relocs_count!
 	size_t target_relocs_count;
+	ut64 *target_vaddrs; ///< target_vaddr of each reloc in target_relocs
+	RzBinRelocPageIndex target_pages;
 }; // RzBinRelocStorage
 
 RZ_API RzBinRelocStorage *rz_bin_reloc_storage_new(RZ_OWN RzList *relocs);
@@ -935,8 +1004,11 @@ RZ_API const RzList *rz_bin_object_get_strings(RZ_NONNULL RzBinObject *obj);
 RZ_API const RzList *rz_bin_object_get_mem(RZ_NONNULL RzBinObject *obj);
 RZ_API const RzList *rz_bin_object_get_resources(RZ_NONNULL RzBinObject *obj);
 RZ_API const RzList *rz_bin_object_get_symbols(RZ_NONNULL RzBinObject *obj);
+RZ_API RzBinRelocStorage *rz_bin_object_get_relocs(RZ_NONNULL RzBinObject *obj);
+RZ_API RzBinLanguage rz_bin_object_get_language(RZ_NONNULL RzBinObject *obj);
 RZ_API bool rz_bin_object_reset_strings(RZ_NONNULL RzBin *bin, RZ_NONNULL RzBinFile *bf, RZ_NONNULL RzBinObject *obj);
 RZ_API RzBinString *rz_bin_object_get_string_at(RZ_NONNULL RzBinObject *obj, ut64 address, bool is_va);
+RZ_API RZ_BORROW RzBinString *rz_bin_object_get_string_in(RZ_NONNULL RzBinObject *obj, ut64 address, bool is_va);
 RZ_API bool rz_bin_object_is_big_endian(RZ_NONNULL RzBinObject *obj);
 RZ_API bool rz_bin_object_is_static(RZ_NONNULL RzBinObject *obj);
 RZ_API RZ_OWN RzVector *rz_bin_object_sections_mapping_list(RZ_NONNULL RzBinObject *obj);
@@ -992,12 +1064,14 @@ RZ_API ut64 rz_bin_object_addr_with_base(RzBinObject *o, ut64 addr);
 RZ_API ut64 rz_bin_object_get_vaddr(RzBinObject *o, ut64 paddr, ut64 vaddr);
 RZ_API const RzBinAddr *rz_bin_object_get_special_symbol(RzBinObject *o, RzBinSpecialSymbol sym);
 RZ_API RzBinRelocStorage *rz_bin_object_patch_relocs(RzBinFile *bf, RzBinObject *o);
+RZ_API bool rz_bin_object_load_vaddr(RZ_NONNULL RzBinFile *bf, RZ_NONNULL RzBinObject *o, ut64 vaddr);
 RZ_API RzBinSymbol *rz_bin_object_get_symbol_of_import(RzBinObject *o, RzBinImport *imp);
 RZ_API RzBinVirtualFile *rz_bin_object_get_virtual_file(RzBinObject *o, const char *name);
 RZ_API void rz_bin_mem_free(void *data);
 
 // demangle functions
 RZ_API RZ_OWN char *rz_bin_demangle(RZ_NULLABLE RzBinFile *bf, RZ_NULLABLE const char *language, RZ_NULLABLE const char *symbol, ut64 vaddr, bool libs);
+RZ_API void rz_bin_demangle_batch(RZ_NONNULL RzBinFile *bf, RZ_NULLABLE const char *language, RZ_NONNULL const char **symbols, size_t count, RZ_NULLABLE RzThreadTaskPool *pool);
 RZ_API const char *rz_bin_get_meth_flag_string(ut64 flag, bool compact);
 
 RZ_API RZ_BORROW RzBinSection *rz_bin_get_section_at(RzBinObject *o, ut64 off, int va);
@@ -3,6 +3,7 @@
 
 #include <rz_types.h>
 #include <rz_bin.h>
+#include <rz_th.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -779,6 +780,12 @@ typedef struct {
 	 * that references this particular line information.
 	 */
 	HtUP /*<ut64, char *>*/ *line_info_offset_comp_dir;
+
+	/**
+	 * Set by rz_bin_dwarf_parse_info_lazy(), holds what is needed
+	 * to decode the DIEs of the units on demand
+	 */
+	struct rz_bin_dwarf_info_source_t *source;
 } RzBinDwarfDebugInfo;
 
 #define ABBREV_DECL_CAP 8
@@ -950,6 +957,11 @@ RZ_API const char *rz_bin_dwarf_get_lang_name(ut64 lang);
 RZ_API RzList /*<RzBinDwarfARangeSet>*/ *rz_bin_dwarf_parse_aranges(RzBinFile *binfile);
 RZ_API RzBinDwarfDebugAbbrev *rz_bin_dwarf_parse_abbrev(RzBinFile *binfile);
 RZ_API RzBinDwarfDebugInfo *rz_bin_dwarf_parse_info(RzBinFile *binfile, RzBinDwarfDebugAbbrev *da);
+RZ_API RZ_OWN RzBinDwarfDebugInfo *rz_bin_dwarf_parse_info_parallel(RZ_NONNULL RzBinFile *binfile, RZ_NONNULL RzBinDwarfDebugAbbrev *da, RZ_NULLABLE RzThreadTaskPool *pool);
+RZ_API RZ_OWN RzBinDwarfDebugInfo *rz_bin_dwarf_parse_info_lazy(RZ_NONNULL RzBinFile *binfile, RZ_NONNULL RzBinDwarfDebugAbbrev *da);
+RZ_API RZ_BORROW RzBinDwarfCompUnit *rz_bin_dwarf_debug_info_get_unit(RZ_NONNULL RzBinDwarfDebugInfo *info, size_t index);
+RZ_API void rz_bin_dwarf_debug_info_unload_unit(RZ_NONNULL RzBinDwarfDebugInfo *info, size_t index);
+RZ_API RZ_BORROW RzBinDwarfDie *rz_bin_dwarf_debug_info_get_die(RZ_NONNULL RzBinDwarfDebugInfo *info, ut64 offset);
 RZ_API HtUP /*<offset, RzBinDwarfLocList*/ *rz_bin_dwarf_parse_loc(RzBinFile *binfile, int addr_size);
 RZ_API void rz_bin_dwarf_arange_set_free(RzBinDwarfARangeSet *set);
 RZ_API void rz_bin_dwarf_loc_free(HtUP /*<offset, RzBinDwarfLocList*>*/ *loc_table);
@@ -965,6 +977,7 @@ RZ_API void rz_bin_dwarf_debug_abbrev_free(RzBinDwarfDebugAbbrev *da);
 typedef char **RzBinDwarfLineFileCache;
 
 RZ_API RzBinDwarfLineInfo *rz_bin_dwarf_parse_line(RzBinFile *binfile, RZ_NULLABLE RzBinDwarfDebugInfo *info, RzBinDwarfLineInfoMask mask);
+RZ_API bool rz_bin_dwarf_line_foreach_sample(RZ_NONNULL RzBinFile *binfile, RZ_NULLABLE RzBinDwarfDebugInfo *info, RZ_NONNULL RzBinSourceLineSampleCb cb, void *user);
 RZ_API char *rz_bin_dwarf_line_header_get_full_file_path(RZ_NULLABLE const RzBinDwarfDebugInfo *info, const RzBinDwarfLineHeader *header, ut64 file_index);
 RZ_API ut64 rz_bin_dwarf_line_header_get_adj_opcode(const RzBinDwarfLineHeader *header, ut8 opcode);
 RZ_API ut64 rz_bin_dwarf_line_header_get_spec_op_advance_pc(const RzBinDwarfLineHeader *header, ut8 opcode);
@@ -91,6 +91,7 @@ typedef struct rz_bp_t {
 	int nbps;
 	int nhwbps;
 	RzList *bps; // list of breakpoints
+	RzIntervalTree bps_tree; ///< the items of bps by their [addr, addr + size) range, for lookups by address
 	RzBreakpointItem **bps_idx;
 	int bps_idx_count;
 	ut64 baddr;
@@ -138,6 +139,7 @@ RZ_API RZ_BORROW RzBreakpointItem *rz_bp_get_ending_at(RZ_NONNULL RzBreakpoint *
 RZ_API RzBreakpointItem *rz_bp_get_in(RzBreakpoint *bp, ut64 addr, int perm);
 
 RZ_API bool rz_bp_is_valid(RzBreakpoint *bp, RzBreakpointItem *b);
+RZ_API bool rz_bp_item_set_addr(RZ_NONNULL RzBreakpoint *bp, RZ_NONNULL RzBreakpointItem *item, ut64 addr);
 RZ_API bool rz_bp_item_set_cond(RZ_NONNULL RzBreakpointItem *item, RZ_NULLABLE const char *cond);
 RZ_API bool rz_bp_item_set_data(RZ_NONNULL RzBreakpointItem *item, RZ_NULLABLE const char *data);
 RZ_API bool rz_bp_item_set_expr(RZ_NONNULL RzBreakpointItem *item, RZ_NULLABLE const char *expr);
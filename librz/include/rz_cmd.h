@@ -484,6 +484,12 @@ typedef struct rz_cmd_t {
 	RzCmdAlias aliases;
 	void *language; // used to store TSLanguage *
 	HtUP *ts_symbols_ht;
+	/**
+	 * Trees of the most recently parsed command strings, most recent first,
+	 * so that commands run in loops are only parsed once.
+	 */
+	RzList /*<void *>*/ *ts_parsed;
+	RzThreadLock *ts_parsed_lock;
 	RzCmdDesc *root_cmd_desc;
 	HtPP *ht_cmds;
 	/**
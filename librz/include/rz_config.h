@@ -19,10 +19,12 @@ RZ_LIB_VERSION_HEADER(rz_config);
 #define CN_STR 0x000008
 #define CN_RO  0x000010
 #define CN_RW  0x000020
+// desc is not owned by the node, see rz_config_node_desc_static()
+#define CN_STATIC_DESC 0x000040
 
 #define NODECB(w, x, y)    rz_config_set_cb(cfg, w, x, y)
 #define NODEICB(w, x, y)   rz_config_set_i_cb(cfg, w, x, y)
-#define SETDESC(x, y)      rz_config_node_desc(x, y)
+#define SETDESC(x, y)      rz_config_node_desc_static(x, y)
 #define SETOPTIONS(x, ...) set_options(x, __VA_ARGS__)
 #define SETI(x, y, z)      SETDESC(rz_config_set_i(cfg, x, y), z)
 #define SETB(x, y, z)      SETDESC(rz_config_set_b(cfg, x, y), z)
@@ -55,6 +57,7 @@ typedef struct rz_config_t {
 	RzNum *num;
 	RzList *nodes;
 	HtPP *ht;
+	ut64 generation; ///< bumped whenever rz_config_set*() changes a value
 } RzConfig;
 
 typedef struct rz_config_hold_num_t {
@@ -99,6 +102,7 @@ RZ_API bool rz_config_get_b(RzConfig *cfg, RZ_NONNULL const char *name);
 RZ_API RZ_BORROW const char *rz_config_get(RzConfig *cfg, RZ_NONNULL const char *name);
 RZ_API const char *rz_config_desc(RzConfig *cfg, RZ_NONNULL const char *name, RZ_NULLABLE const char *desc);
 RZ_API const char *rz_config_node_desc(RzConfigNode *node, RZ_NULLABLE const char *desc);
+RZ_API const char *rz_config_node_desc_static(RzConfigNode *node, RZ_NULLABLE const char *desc);
 RZ_API RZ_BORROW RzConfigNode *rz_config_node_get(RzConfig *cfg, RZ_NONNULL const char *name);
 RZ_API RZ_OWN RzConfigNode *rz_config_node_new(RZ_NONNULL const char *name, RZ_NONNULL const char *value);
 RZ_API RZ_OWN RzConfigNode *rz_config_node_clone(RzConfigNode *n);
@@ -19,6 +19,7 @@ extern "C" {
 #include <rz_util/rz_sys.h>
 #include <rz_util/rz_utf8.h>
 #include <rz_util/rz_file.h>
+#include <rz_th.h>
 #include <rz_vector.h>
 #include <sdb.h>
 #include <ht_up.h>
@@ -496,6 +497,8 @@ typedef struct rz_cons_context_t {
 
 #define HUD_BUF_SIZE 512
 
+typedef struct rz_cons_screen_t RzConsScreen;
+
 typedef struct rz_cons_t {
 	RzConsContext *context;
 	RzConsInputContext *input;
@@ -554,6 +557,9 @@ typedef struct rz_cons_t {
 	RZ_DEPRECATE bool newline;
 	RzVirtTermMode vtmode;
 	bool flush;
+	size_t stream_chunk; ///< scr.stream, see rz_cons_flush_stream()
+	bool damage; ///< scr.damage, only write what changed since the last visual frame
+	RzConsScreen *screen; ///< last visual frame on the terminal, see screen.c
 	bool use_utf8; // use utf8 features
 	bool use_utf8_curvy; // use utf8 curved corners
 	bool dotted_lines;
@@ -564,6 +570,7 @@ typedef struct rz_cons_t {
 	ut64 timeout; // must come from rz_time_now_mono()
 	bool grep_color;
 	bool grep_highlight;
+	RzThreadTaskPool *grep_pool; ///< workers grepping big outputs, see grep.c
 	bool filter;
 	char *(*rgbstr)(char *str, size_t sz, ut64 addr);
 	bool click_set;
@@ -591,6 +598,7 @@ typedef struct rz_cons_t {
 #define RZ_CONS_CLEAR_LINE               "\x1b[2K\r"
 #define RZ_CONS_CLEAR_SCREEN             "\x1b[2J\r"
 #define RZ_CONS_CLEAR_FROM_CURSOR_TO_END "\x1b[0J\r"
+#define RZ_CONS_CLEAR_TO_EOL             "\x1b[0K"
 
 #define RZ_CONS_CURSOR_SAVE         "\x1b[s"
 #define RZ_CONS_CURSOR_RESTORE      "\x1b[u"
@@ -903,6 +911,7 @@ RZ_API int rz_cons_memcat(const char *str, int len);
 RZ_API void rz_cons_newline(void);
 RZ_API void rz_cons_filter(void);
 RZ_API void rz_cons_flush(void);
+RZ_API void rz_cons_flush_stream(void);
 RZ_API void rz_cons_set_flush(bool flush);
 RZ_API void rz_cons_last(void);
 RZ_API int rz_cons_less_str(const char *str, const char *exitkeys);
@@ -910,6 +919,7 @@ RZ_API void rz_cons_less(void);
 RZ_API void rz_cons_memset(char ch, int len);
 RZ_API void rz_cons_visual_flush(void);
 RZ_API void rz_cons_visual_write(char *buffer);
+RZ_API void rz_cons_screen_invalidate(void);
 RZ_API bool rz_cons_is_utf8(void);
 RZ_API void rz_cons_cmd_help(const char *help[], bool use_color);
 
@@ -275,7 +275,9 @@ typedef struct rz_core_tasks_t {
 	struct rz_core_task_t *current_task;
 	struct rz_core_task_t *main_task;
 	RzThreadLock *lock;
+	RzThreadRWLock *state_lock; ///< held as writer by the scheduled task running, as reader by the concurrent tasks
 	int tasks_running;
+	int concurrent_running; ///< concurrent tasks started and not done, see rz_core_task_set_concurrent()
 	bool oneshot_running;
 } RzCoreTaskScheduler;
 
@@ -293,6 +295,10 @@ typedef struct rz_core_seek_history_t {
 	RzCoreSeekItem saved_item; ///< Position to save in history
 } RzCoreSeekHistory;
 
+typedef struct rz_core_disasm_cache_t RzCoreDisasmCache;
+typedef struct rz_core_heap_cache_t RzCoreHeapCache;
+typedef struct rz_core_analysis_stats_cache_t RzCoreAnalysisStatsCache;
+
 struct rz_core_t {
 	RzBin *bin;
 	RzList *plugins; ///< List of registered core plugins
@@ -359,6 +365,13 @@ struct rz_core_t {
 	RzList *watchers;
 	RzList *scriptstack;
 	RzCoreTaskScheduler tasks;
+	RzThreadTaskPool *task_pool; ///< workers shared by the commands, see rz_core_get_task_pool()
+	SetU *analysis_dirty_fcns; ///< entrypoints of the functions touched by writes, see analysis.detectwrites.deps
+	RzCoreDisasmCache *disasm_cache; ///< formatted disasm lines reused across visual redraws, NULL until first used
+	RzCoreHeapCache *heap_cache; ///< target memory read by the heap commands, see rz_core_heap_read()
+	RzCoreAnalysisStatsCache *stats_cache; ///< last overview of rz_core_analysis_get_stats(), NULL until first used
+	RzList /*<RzSearchGramIndex *>*/ *search_indexes; ///< gram indexes built by /Ib, NULL until first built
+	RzVector /*<RzCoreAnalysisPass>*/ *analysis_passes; ///< passes of the last aaa/aaaa, NULL until first run
 	int max_cmd_depth;
 	ut8 switch_file_view;
 	Sdb *sdb;
@@ -471,6 +484,7 @@ RZ_API const char *rz_core_get_section_name(RzCore *core, ut64 addr);
 RZ_API RzCons *rz_core_get_cons(RzCore *core);
 RZ_API RzBin *rz_core_get_bin(RzCore *core);
 RZ_API RzConfig *rz_core_get_config(RzCore *core);
+RZ_API RZ_BORROW RzThreadTaskPool *rz_core_get_task_pool(RZ_NONNULL RzCore *core);
 RZ_API bool rz_core_init(RzCore *core);
 RZ_API void rz_core_bind_cons(RzCore *core); // to restore pointers in cons
 RZ_API RzCore *rz_core_new(void);
@@ -805,6 +819,10 @@ RZ_API bool rz_core_analysis_graph(RzCore *core, ut64 addr, int opts);
 RZ_API RzList *rz_core_analysis_graph_to(RzCore *core, ut64 addr, int n);
 RZ_API int rz_core_analysis_all(RzCore *core);
 RZ_API bool rz_core_analysis_everything(RzCore *core, bool experimental, char *dh_orig);
+RZ_API RZ_BORROW RzVector /*<RzCoreAnalysisPass>*/ *rz_core_analysis_passes(RZ_NONNULL RzCore *core);
+RZ_API bool rz_core_analysis_triage(RZ_NONNULL RzCore *core, bool discard);
+RZ_API void rz_core_analysis_function_triage_json(RZ_NONNULL RzCore *core, RZ_NONNULL RzAnalysisFunction *fcn, RZ_NONNULL PJ *pj);
+RZ_API void rz_core_analysis_passes_json(RZ_NONNULL RzCore *core, RZ_NONNULL PJ *pj);
 RZ_API RZ_OWN RzList *rz_core_analysis_sigdb_list(RZ_NONNULL RzCore *core, bool with_details);
 RZ_API bool rz_core_analysis_sigdb_apply(RZ_NONNULL RzCore *core, RZ_NULLABLE int *n_applied, RZ_NULLABLE const char *filter);
 RZ_API void rz_core_analysis_sigdb_print(RZ_NONNULL RzCore *core, RZ_NONNULL RzTable *table);
@@ -899,6 +917,7 @@ RZ_API bool rz_core_bin_apply_classes(RzCore *core, RzBinFile *binfile);
 RZ_API bool rz_core_bin_apply_resources(RzCore *core, RzBinFile *binfile);
 RZ_API bool rz_core_bin_apply_info(RzCore *r, RzBinFile *binfile, ut32 mask);
 RZ_API bool rz_core_bin_apply_all_info(RzCore *r, RzBinFile *binfile);
+RZ_API bool rz_core_bin_load_vaddr(RzCore *core, ut64 vaddr);
 RZ_API int rz_core_bin_set_by_fd(RzCore *core, ut64 bin_fd);
 RZ_API int rz_core_bin_set_by_name(RzCore *core, const char *name);
 RZ_API bool rz_core_bin_load(RZ_NONNULL RzCore *core, RZ_NULLABLE const char *file_uri, ut64 base_addr);
@@ -910,6 +929,8 @@ RZ_API RZ_OWN HtPP *rz_core_bin_create_digests(RzCore *core, ut64 paddr, ut64 si
 
 RZ_API void rz_core_bin_print_source_line_sample(RzCore *core, const RzBinSourceLineSample *s, RzCmdStateOutput *state);
 RZ_API void rz_core_bin_print_source_line_info(RzCore *core, const RzBinSourceLineInfo *li, RzCmdStateOutput *state);
+RZ_API void rz_core_bin_print_source_line_index(RzCore *core, const RzBinSourceLineIndex *index, RzCmdStateOutput *state);
+RZ_API void rz_core_bin_print_source_line_index_at(RzCore *core, const RzBinSourceLineIndex *index, ut64 addr, RzCmdStateOutput *state);
 
 RZ_API bool rz_core_sym_is_export(RZ_NONNULL RzBinSymbol *s);
 RZ_API void rz_core_sym_name_init(RZ_NONNULL RzCore *r, RZ_OUT RzBinSymNames *sn, RZ_NONNULL RzBinSymbol *sym, RZ_NULLABLE const char *lang);
@@ -932,6 +953,7 @@ RZ_API void rz_core_sysenv_begin(RzCore *core);
 RZ_API void rz_core_sysenv_end(RzCore *core);
 
 RZ_API void rz_core_recover_vars(RzCore *core, RzAnalysisFunction *fcn, bool argonly);
+RZ_API void rz_core_analysis_function_vars_ensure(RzCore *core, RzAnalysisFunction *fcn);
 
 /* cmd_linux_heap_glibc.c */
 RZ_API RzList *rz_heap_chunks_list(RzCore *core, ut64 m_arena);
@@ -1127,6 +1149,20 @@ typedef struct {
 	RzVector blocks;
 } RzCoreAnalysisStats;
 
+/**
+ * Resources spent and objects created by one pass of rz_core_analysis_everything().
+ */
+typedef struct rz_core_analysis_pass_t {
+	const char *name; ///< static description of the pass
+	ut64 wall_time; ///< microseconds
+	ut64 cpu_time; ///< microseconds of user and system time of the whole process
+	ut64 peak_rss; ///< growth of the peak resident set size in bytes, 0 where unsupported
+	st64 functions; ///< functions created, negative when removed
+	st64 blocks; ///< basic blocks created, negative when removed
+	st64 xrefs; ///< addresses referencing others, negative when removed
+	ut64 io_read; ///< bytes read through RzIO
+} RzCoreAnalysisPass;
+
 RZ_API char *rz_core_analysis_hasrefs(RzCore *core, ut64 value, int mode);
 RZ_API char *rz_core_analysis_get_comments(RzCore *core, ut64 addr);
 RZ_API RZ_OWN RzCoreAnalysisStats *rz_core_analysis_get_stats(RZ_NONNULL RzCore *a, ut64 from, ut64 to, ut64 step);
@@ -1170,6 +1206,8 @@ struct rz_core_task_t {
 	RzThreadLock *dispatch_lock;
 	RzThread *thread;
 	bool breaked;
+	bool concurrent; ///< runs next to the scheduled tasks instead of waiting for its turn
+	bool state_locked; ///< holds the state lock of the scheduler as writer
 
 	RzCoreTaskRunner runner; // will be NULL for main task
 	RzCoreTaskRunnerFree runner_free;
@@ -1190,6 +1228,7 @@ RZ_API RzCoreTask *rz_core_task_new(RzCoreTaskScheduler *sched, RzCoreTaskRunner
 RZ_API void rz_core_task_incref(RzCoreTask *task);
 RZ_API void rz_core_task_decref(RzCoreTask *task);
 RZ_API void rz_core_task_enqueue(RzCoreTaskScheduler *scheduler, RzCoreTask *task);
+RZ_API void rz_core_task_set_concurrent(RzCoreTask *task, bool concurrent);
 RZ_API void rz_core_task_enqueue_oneshot(RzCoreTaskScheduler *scheduler, RzCoreTaskOneShot func, void *user);
 RZ_API int rz_core_task_run_sync(RzCoreTaskScheduler *scheduler, RzCoreTask *task);
 RZ_API void rz_core_task_sync_begin(RzCoreTaskScheduler *scheduler);
@@ -1212,6 +1251,7 @@ RZ_API RzCoreTask *rz_core_cmd_task_new(RzCore *core, const char *cmd, RzCoreCmd
 RZ_API const char *rz_core_cmd_task_get_result(RzCoreTask *task);
 typedef void *(*RzCoreTaskFunction)(RzCore *core, void *user);
 RZ_API RzCoreTask *rz_core_function_task_new(RzCore *core, RzCoreTaskFunction fcn, void *fcn_user);
+RZ_API RzCoreTask *rz_core_function_task_new_concurrent(RzCore *core, RzCoreTaskFunction fcn, void *fcn_user);
 RZ_API void *rz_core_function_task_get_result(RzCoreTask *task);
 RZ_API const char *rz_core_task_status(RzCoreTask *task);
 RZ_API void rz_core_task_print(RzCore *core, RzCoreTask *task, int mode, PJ *j);
@@ -64,6 +64,7 @@ RZ_API int rz_crypto_update(RzCrypto *cry, const ut8 *buf, int len);
 RZ_API int rz_crypto_final(RzCrypto *cry, const ut8 *buf, int len);
 RZ_API int rz_crypto_append(RzCrypto *cry, const ut8 *buf, int len);
 RZ_API const ut8 *rz_crypto_get_output(RzCrypto *cry, int *size);
+RZ_API void rz_crypto_clear_output(RZ_NONNULL RzCrypto *cry);
 RZ_API const char *rz_crypto_name(const RzCryptoSelector bit);
 RZ_API const char *rz_crypto_codec_name(const RzCryptoSelector bit);
 RZ_API const RzCryptoPlugin *rz_crypto_plugin_by_index(size_t index);
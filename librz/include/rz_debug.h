@@ -113,6 +113,7 @@ typedef enum {
 	RZ_DEBUG_REASON_INT,
 	RZ_DEBUG_REASON_FPU,
 	RZ_DEBUG_REASON_USERSUSP,
+	RZ_DEBUG_REASON_COVERAGE, ///< a block coverage trap was hit and removed, see rz_debug_coverage_start()
 } RzDebugReasonType;
 
 /* TODO: move to rz_analysis */
@@ -159,12 +160,25 @@ typedef struct rz_debug_desc_t {
 	ut64 off;
 } RzDebugDesc;
 
+#define RZ_DEBUG_SNAP_PAGE_SIZE 0x1000
+
+/**
+ * \brief A page of snapshotted memory, shared by all the snapshots in which it is unchanged
+ */
+typedef struct rz_debug_snap_page_t {
+	ut8 *data;
+	ut32 refs;
+	ut32 hash; ///< xxhash32 of data, valid if hashed is set
+	bool hashed;
+} RzDebugSnapPage;
+
 typedef struct rz_debug_snap_t {
 	char *name;
 	ut64 addr;
 	ut64 addr_end;
 	ut32 size;
-	ut8 *data;
+	RzDebugSnapPage **pages; ///< size / RZ_DEBUG_SNAP_PAGE_SIZE pages, the last one possibly shorter
+	ut32 pages_count;
 	int perm;
 	int user;
 	bool shared;
@@ -216,8 +230,23 @@ typedef struct rz_snap_entry {
 	int perm;
 } RSnapEntry;
 
+#define RZ_DEBUG_COVERAGE_TRAP_MAX 8
+
+typedef struct rz_debug_coverage_block_t {
+	ut64 addr;
+	ut32 size; ///< size of the basic block
+	ut8 trap_size; ///< 0 if the trap could not be written
+	ut8 orig[RZ_DEBUG_COVERAGE_TRAP_MAX]; ///< bytes overwritten by the trap
+	bool hit;
+} RzDebugCoverageBlock;
+
+typedef struct rz_debug_coverage_t {
+	RzVector /*<RzDebugCoverageBlock>*/ blocks; ///< sorted by address
+	ut64 hits; ///< number of blocks executed so far
+} RzDebugCoverage;
+
 typedef struct rz_debug_trace_t {
-	RzList *traces;
+	RzPVector *traces; ///< RzDebugTracepoint, one per traced address and tag, in the order they were first hit
 	int count;
 	int enabled;
 	// int changed;
@@ -225,9 +254,16 @@ typedef struct rz_debug_trace_t {
 	int dup;
 	char *addresses;
 	// TODO: add range here
-	HtPP *ht;
+	HtUP *ht; ///< tag -> (HtUP address -> RzDebugTracepoint)
+	bool branches; ///< the backend records the taken branches, see rz_debug_trace_branches()
+	ut64 branch_block; ///< start of the block executing when the branches were last read
 } RzDebugTrace;
 
+/**
+ * \brief Called for every taken branch recorded by the backend, return false to stop
+ */
+typedef bool (*RzDebugBranchCallback)(void *user, ut64 from, ut64 to);
+
 typedef struct rz_debug_tracepoint_t {
 	ut64 addr;
 	ut64 tags; // XXX
@@ -279,12 +315,20 @@ typedef struct rz_debug_t {
 
 	/* tracing vars */
 	RzDebugTrace *trace;
+	RzDebugCoverage *coverage; /* block coverage mode, see rz_debug_coverage_start() */
+	RzThread *async_waiter; /* waits for the target resumed by rz_debug_continue_async() to stop */
+	RzAtomicBool *async_stopped; /* set by async_waiter once the target stopped */
 	HtUP *tracenodes;
 	RTree *tree;
 	RzList *call_frames;
 
 	RzReg *reg;
 	RzList *q_regs;
+	bool reg_lazy; /* only transfer the register types that are stale or modified */
+	ut32 reg_valid; /* bitmask of the register types read since the target last ran */
+	ut8 *reg_synced[RZ_REG_TYPE_LAST]; /* arena bytes last exchanged with the target */
+	ut32 target_generation; /* bumped whenever the target may have changed, see rz_debug_reg_invalidate() */
+	int reg_synced_size[RZ_REG_TYPE_LAST];
 	RzBreakpoint *bp;
 	char *snap_path;
 
@@ -382,6 +426,7 @@ typedef struct rz_debug_plugin_t {
 	int (*step_over)(RzDebug *dbg);
 	int (*cont)(RzDebug *dbg, int pid, int tid, int sig);
 	RzDebugReasonType (*wait)(RzDebug *dbg, int pid);
+	bool (*wait_async)(RzDebug *dbg, int pid); ///< Block until the target stops without consuming the stop for wait, called from another thread
 	bool (*gcore)(RzDebug *dbg, char *path, RzBuffer *dest);
 	bool (*kill)(RzDebug *dbg, int pid, int tid, int sig);
 	RzList *(*kill_list)(RzDebug *dbg);
@@ -400,6 +445,9 @@ typedef struct rz_debug_plugin_t {
 	int (*map_dealloc)(RzDebug *dbg, ut64 addr, int size);
 	int (*map_protect)(RzDebug *dbg, ut64 addr, int size, int perms);
 	int (*drx)(RzDebug *dbg, int n, ut64 addr, int size, int rwx, int g, int api_type);
+	/* branch tracing */
+	bool (*branch_trace)(RzDebug *dbg, bool enable); ///< Start or stop recording the taken branches of dbg->tid
+	bool (*branch_trace_read)(RzDebug *dbg, RzDebugBranchCallback cb, void *user); ///< Pass the branches recorded since the last read to cb, oldest first
 	RzDebugDescPlugin desc;
 	// TODO: use RzList here
 } RzDebugPlugin;
@@ -453,6 +501,10 @@ RZ_API int rz_debug_continue_until_nontraced(RzDebug *dbg);
 RZ_API int rz_debug_continue_syscall(RzDebug *dbg, int sc);
 RZ_API int rz_debug_continue_syscalls(RzDebug *dbg, int *sc, int n_sc);
 RZ_API int rz_debug_continue(RzDebug *dbg);
+RZ_API bool rz_debug_continue_async(RZ_NONNULL RzDebug *dbg);
+RZ_API bool rz_debug_is_running(RZ_NONNULL RzDebug *dbg);
+RZ_API bool rz_debug_async_stopped(RZ_NONNULL RzDebug *dbg);
+RZ_API bool rz_debug_async_collect(RZ_NONNULL RzDebug *dbg, bool block);
 RZ_API int rz_debug_continue_kill(RzDebug *dbg, int signal);
 RZ_API int rz_debug_continue_pass_exception(RzDebug *dbg);
 
@@ -520,6 +572,7 @@ RZ_API int rz_debug_desc_list(RzDebug *dbg, int rad);
 RZ_API bool rz_debug_reg_profile_sync(RzDebug *dbg);
 RZ_API int rz_debug_reg_sync(RzDebug *dbg, int type, int write);
 RZ_API int rz_debug_reg_set(RzDebug *dbg, const char *name, ut64 num);
+RZ_API void rz_debug_reg_invalidate(RzDebug *dbg);
 RZ_API ut64 rz_debug_reg_get(RzDebug *dbg, const char *name);
 
 RZ_API ut64 rz_debug_execute(RzDebug *dbg, const ut8 *buf, int len, int restore);
@@ -552,7 +605,17 @@ RZ_API void rz_debug_trace_print(RzDebug *dbg, RzCmdStateOutput *state, ut64 off
 RZ_API RZ_OWN RzList *rz_debug_traces_info(RzDebug *dbg, ut64 offset);
 RZ_API void rz_debug_traces_ascii(RzDebug *dbg, ut64 offset);
 RZ_API RzDebugTracepoint *rz_debug_trace_add(RzDebug *dbg, ut64 addr, int size);
+RZ_API bool rz_debug_trace_branches(RzDebug *dbg, bool enable);
+RZ_API bool rz_debug_trace_branches_collect(RzDebug *dbg);
 RZ_API RzDebugTrace *rz_debug_trace_new(void);
+
+/* block coverage */
+RZ_API bool rz_debug_coverage_start(RZ_NONNULL RzDebug *dbg);
+RZ_API bool rz_debug_coverage_stop(RZ_NONNULL RzDebug *dbg);
+RZ_API RZ_OWN RzBitmap *rz_debug_coverage_bitmap(RZ_NONNULL RzDebug *dbg);
+RZ_API void rz_debug_trace_reserve(RzDebugTrace *trace, size_t count);
+RZ_API RZ_OWN RzBitmap *rz_debug_trace_coverage(RZ_NONNULL RzDebug *dbg, ut64 from, ut64 to, RZ_NULLABLE RZ_OUT ut64 *covered);
+RZ_API RZ_OWN RzBuffer *rz_debug_trace_drcov(RZ_NONNULL RzDebug *dbg);
 RZ_API void rz_debug_trace_free(RzDebugTrace *dbg);
 RZ_API int rz_debug_trace_tag(RzDebug *dbg, int tag);
 RZ_API int rz_debug_child_fork(RzDebug *dbg);
@@ -591,9 +654,15 @@ RZ_API RzDebugSession *rz_debug_session_new(void);
 RZ_API void rz_debug_session_free(RzDebugSession *session);
 
 RZ_API RzDebugSnap *rz_debug_snap_map(RzDebug *dbg, RzDebugMap *map);
+RZ_API RzDebugSnap *rz_debug_snap_map_shared(RzDebug *dbg, RzDebugMap *map, RZ_NULLABLE RzDebugSnap *prev);
+RZ_API bool rz_debug_snap_set_data(RZ_NONNULL RzDebugSnap *snap, RZ_NONNULL const ut8 *data, RZ_NULLABLE RzDebugSnap *prev);
+RZ_API RZ_OWN ut8 *rz_debug_snap_data(RZ_NONNULL RzDebugSnap *snap);
+RZ_API bool rz_debug_snap_restore(RZ_NONNULL RzDebug *dbg, RZ_NONNULL RzDebugSnap *snap);
 RZ_API bool rz_debug_snap_contains(RzDebugSnap *snap, ut64 addr);
 RZ_API ut8 *rz_debug_snap_get_hash(RzDebug *dbg, RzDebugSnap *snap, RzHashSize *size);
 RZ_API bool rz_debug_snap_is_equal(RzDebug *dbg, RzDebugSnap *a, RzDebugSnap *b);
+RZ_API RZ_OWN RzBitmap *rz_debug_snap_diff(RZ_NONNULL RzDebug *dbg, RZ_NONNULL RzDebugSnap *a, RZ_NONNULL RzDebugSnap *b, RZ_NULLABLE RzThreadTaskPool *pool);
+RZ_API RZ_OWN RzBitmap *rz_debug_snap_diff_live(RZ_NONNULL RzDebug *dbg, RZ_NONNULL RzDebugSnap *snap, RZ_NULLABLE RzThreadTaskPool *pool);
 RZ_API void rz_debug_snap_free(RzDebugSnap *snap);
 
 RZ_API int rz_debug_step_back(RzDebug *dbg, int steps);
@@ -6,6 +6,7 @@
 #define RZ_DEMANGLER_H
 #include <rz_types.h>
 #include <rz_list.h>
+#include <rz_th.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,11 +21,18 @@ typedef struct rz_demangler_plugin_t {
 	RZ_OWN char *(*demangle)(RZ_NONNULL const char *symbol); ///< demangler method to resolve the mangled symbol
 } RzDemanglerPlugin;
 
+#define RZ_DEMANGLER_CACHE_SIZE_DEFAULT 0x10000
+
 typedef struct rz_demangler_t {
 	RzList *plugins;
+	RzThreadLock *cache_lock; ///< the cache is shared by all the threads demangling with this RzDemangler
+	HtPP *cache; ///< "language:mangled" -> demangled, most recent generation
+	HtPP *cache_old; ///< previous generation, entries found here move back to cache
+	size_t cache_size; ///< max number of entries of each generation, 0 disables the cache
 } RzDemangler;
 
 typedef bool (*RzDemanglerIter)(const RzDemanglerPlugin *plugin, void *data);
+typedef RZ_OWN char *(*RzDemanglerHandler)(RZ_NONNULL const char *symbol);
 
 #define rz_demangler_plugin_demangle(x, y) ((x) && RZ_STR_ISNOTEMPTY(y) ? (x)->demangle(y) : NULL)
 
@@ -40,6 +48,9 @@ RZ_API void rz_demangler_plugin_iterate(RZ_NONNULL RzDemangler *demangler, RZ_NO
 RZ_API bool rz_demangler_plugin_add(RZ_NONNULL RzDemangler *demangler, RZ_NONNULL RzDemanglerPlugin *plugin);
 RZ_API RZ_BORROW const RzDemanglerPlugin *rz_demangler_plugin_get(RZ_NONNULL RzDemangler *demangler, RZ_NONNULL const char *language);
 RZ_API bool rz_demangler_resolve(RZ_NONNULL RzDemangler *demangler, RZ_NULLABLE const char *symbol, RZ_NONNULL const char *language, RZ_NONNULL RZ_OWN char **output);
+RZ_API RZ_OWN char *rz_demangler_resolve_cached(RZ_NONNULL RzDemangler *demangler, RZ_NONNULL const char *symbol, RZ_NONNULL const char *language, RZ_NONNULL RzDemanglerHandler handler);
+RZ_API void rz_demangler_cache_set_size(RZ_NONNULL RzDemangler *demangler, size_t size);
+RZ_API void rz_demangler_cache_clear(RZ_NONNULL RzDemangler *demangler);
 
 #ifdef __cplusplus
 }
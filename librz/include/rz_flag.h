@@ -32,8 +32,8 @@ typedef struct rz_flags_at_offset_t {
 } RzFlagsAtOffset;
 
 typedef struct rz_flag_item_t {
-	char *name; /* unique name, escaped to avoid issues with rizin shell */
-	char *realname; /* real name, without any escaping */
+	char *name; /* unique name, escaped to avoid issues with rizin shell, interned in rz_str_intern_global() */
+	char *realname; /* real name, without any escaping, interned in rz_str_intern_global() */
 	bool demangled; /* real name from demangling? */
 	ut64 offset; /* offset flagged by this item */
 	ut64 size; /* size of the flag item */
@@ -49,9 +49,16 @@ typedef struct rz_flag_t {
 	bool realnames;
 	Sdb *tags;
 	RzNum *num;
-	RzSkipList *by_off; /* flags sorted by offset, value=RzFlagsAtOffset */
+	RzPVector *by_off; /* RzFlagsAtOffset sorted by offset, the ones left without flags stay until the next merge */
+	RBNode *by_off_pending; /* RzFlagsAtOffset added out of order since the last merge into by_off */
+	size_t by_off_pending_count; /* number of nodes in by_off_pending */
+	size_t by_off_dead; /* number of RzFlagsAtOffset without flags in by_off */
+	HtUP *ht_off; /* hashmap key=offset, value=RzFlagsAtOffset * */
 	HtPP *ht_name; /* hashmap key=item name, value=RzFlagItem * */
 	RzList *zones;
+	ut64 generation; /* bumped whenever a flag is added, moved, renamed or removed */
+	RzPVector *by_name; /* RzFlagItem * sorted by name, built lazily for the prefix lookups */
+	ut64 by_name_generation; /* value of generation when by_name was built */
 } RzFlag;
 
 /* compile time dependency */
@@ -126,6 +133,7 @@ RZ_API bool rz_flag_move(RzFlag *f, ut64 at, ut64 to);
 RZ_API int rz_flag_count(RzFlag *f, const char *glob);
 RZ_API void rz_flag_foreach(RzFlag *f, RzFlagItemCb cb, void *user);
 RZ_API void rz_flag_foreach_prefix(RzFlag *f, const char *pfx, int pfx_len, RzFlagItemCb cb, void *user);
+RZ_API void rz_flag_foreach_name_prefix(RZ_NONNULL RzFlag *f, RZ_NONNULL const char *pfx, int pfx_len, RzFlagItemCb cb, void *user);
 RZ_API void rz_flag_foreach_range(RZ_NONNULL RzFlag *f, ut64 from, ut64 to, RzFlagItemCb cb, void *user);
 RZ_API void rz_flag_foreach_glob(RzFlag *f, const char *glob, RzFlagItemCb cb, void *user);
 RZ_API void rz_flag_foreach_space(RzFlag *f, const RzSpace *space, RzFlagItemCb cb, void *user);
@@ -195,6 +203,7 @@ RZ_API void rz_serialize_flag_zones_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzList /
 RZ_API bool rz_serialize_flag_zones_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzList /*<RzFlagZoneItem *>*/ *zones, RZ_NULLABLE RzSerializeResultInfo *res);
 RZ_API void rz_serialize_flag_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzFlag *flag);
 RZ_API bool rz_serialize_flag_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzFlag *flag, RZ_NULLABLE RzSerializeResultInfo *res);
+RZ_API bool rz_serialize_flag_load_parallel(RZ_NONNULL Sdb *db, RZ_NONNULL RzFlag *flag, RZ_NULLABLE RzThreadTaskPool *pool, RZ_NULLABLE RzSerializeResultInfo *res);
 
 #endif
 
@@ -214,10 +214,12 @@ typedef struct rz_flirt_info_t {
 } RzFlirtInfo;
 
 RZ_API ut32 rz_sign_flirt_node_count_nodes(RZ_NONNULL const RzFlirtNode *node);
-RZ_API RZ_OWN RzFlirtNode *rz_sign_flirt_node_new(RZ_NONNULL RzAnalysis *analysis, ut32 optimization);
+RZ_API RZ_OWN RzFlirtNode *rz_sign_flirt_node_new(RZ_NONNULL RzAnalysis *analysis, ut32 optimization, RZ_NULLABLE RzThreadTaskPool *pool);
 RZ_API void rz_sign_flirt_node_free(RZ_NULLABLE RzFlirtNode *node);
 RZ_API void rz_sign_flirt_info_fini(RZ_NULLABLE RzFlirtInfo *info);
 
+RZ_API RZ_OWN RzFlirtNode *rz_sign_flirt_parse_file(RZ_NONNULL const char *flirt_file, ut8 expected_arch);
+RZ_API bool rz_sign_flirt_apply_node(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL const RzFlirtNode *node, RZ_NULLABLE RzThreadTaskPool *pool);
 RZ_API bool rz_sign_flirt_apply(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL const char *flirt_file, ut8 expected_arch);
 
 typedef struct rz_flirt_compressed_options_t {
@@ -7,6 +7,7 @@
 #include <rz_types.h>
 #include <rz_list.h>
 #include <rz_util/rz_mem.h>
+#include <rz_th.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -65,18 +66,21 @@ RZ_API bool rz_hash_cfg_configure(RZ_NONNULL RzHashCfg *md, RZ_NONNULL const cha
 RZ_API bool rz_hash_cfg_hmac(RZ_NONNULL RzHashCfg *md, RZ_NONNULL const ut8 *key, ut64 key_size);
 RZ_API bool rz_hash_cfg_init(RZ_NONNULL RzHashCfg *md);
 RZ_API bool rz_hash_cfg_update(RZ_NONNULL RzHashCfg *md, RZ_NONNULL const ut8 *data, ut64 size);
+RZ_API bool rz_hash_cfg_update_parallel(RZ_NONNULL RzHashCfg *md, RZ_NULLABLE RzThreadTaskPool *pool, RZ_NONNULL const ut8 *data, ut64 size);
 RZ_API bool rz_hash_cfg_final(RZ_NONNULL RzHashCfg *md);
 RZ_API bool rz_hash_cfg_iterate(RZ_NONNULL RzHashCfg *md, size_t iterate);
 RZ_API RZ_BORROW const ut8 *rz_hash_cfg_get_result(RZ_NONNULL RzHashCfg *md, RZ_NONNULL const char *name, RZ_NONNULL RzHashSize *size);
 RZ_API RZ_OWN char *rz_hash_cfg_get_result_string(RZ_NONNULL RzHashCfg *md, RZ_NONNULL const char *name, RZ_NULLABLE ut32 *size, bool invert);
 RZ_API RzHashSize rz_hash_cfg_size(RZ_NONNULL RzHashCfg *md, RZ_NONNULL const char *name);
 RZ_API RZ_OWN ut8 *rz_hash_cfg_calculate_small_block(RZ_NONNULL RzHash *rh, RZ_NONNULL const char *name, RZ_NONNULL const ut8 *buffer, ut64 bsize, RZ_NONNULL RzHashSize *osize);
+RZ_API RZ_OWN ut8 *rz_hash_cfg_calculate_small_blocks(RZ_NONNULL RzHash *rh, RZ_NONNULL const char *name, RZ_NONNULL const ut8 *const *buffers, RZ_NONNULL const ut64 *sizes, size_t count, RZ_NULLABLE RzHashSize *osize);
 RZ_API RZ_OWN char *rz_hash_cfg_calculate_small_block_string(RZ_NONNULL RzHash *rh, RZ_NONNULL const char *name, RZ_NONNULL const ut8 *buffer, ut64 bsize, RZ_NULLABLE ut32 *size, bool invert);
 RZ_API RZ_OWN char *rz_hash_cfg_randomart(RZ_NONNULL const ut8 *buffer, ut32 length, ut64 address);
 
 RZ_API ut32 rz_hash_xxhash(RZ_NONNULL RzHash *rh, RZ_NONNULL const ut8 *input, size_t size);
 RZ_API double rz_hash_entropy(RZ_NONNULL RzHash *rh, RZ_NONNULL const ut8 *data, ut64 len);
 RZ_API double rz_hash_entropy_fraction(RZ_NONNULL RzHash *rh, RZ_NONNULL const ut8 *data, ut64 len);
+RZ_API void rz_hash_entropy_blocks(RZ_NONNULL RzHash *rh, RZ_NULLABLE RzThreadTaskPool *pool, RZ_NONNULL const ut8 *data, ut64 block_size, size_t count, bool fraction, RZ_NONNULL RZ_OUT double *entropies);
 
 #endif
 
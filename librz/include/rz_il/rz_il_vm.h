@@ -99,6 +99,13 @@ RZ_API bool rz_il_evaluate_effect(RZ_NONNULL RzILVM *vm, RZ_NONNULL RzILOpEffect
 
 RZ_API bool rz_il_vm_step(RzILVM *vm, RzILOpEffect *op, ut64 fallthrough_addr);
 
+// Compiled evaluation
+typedef struct rz_il_compiled_effect_t RzILCompiledEffect;
+RZ_API RZ_OWN RzILCompiledEffect *rz_il_compile_effect(RZ_NONNULL RzILVM *vm, RZ_NONNULL RzILOpEffect *op);
+RZ_API void rz_il_compiled_effect_free(RZ_NULLABLE RzILCompiledEffect *c);
+RZ_API bool rz_il_evaluate_compiled_effect(RZ_NONNULL RzILVM *vm, RZ_NONNULL const RzILCompiledEffect *code);
+RZ_API bool rz_il_vm_step_compiled(RZ_NONNULL RzILVM *vm, RZ_NONNULL const RzILCompiledEffect *code, ut64 fallthrough_addr);
+
 #ifdef __cplusplus
 }
 #endif
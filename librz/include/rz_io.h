@@ -11,6 +11,7 @@
 #include <rz_bind.h>
 #include "rz_vector.h"
 #include "rz_skyline.h"
+#include <ht_uu.h>
 
 #define RZ_IO_SEEK_SET 0
 #define RZ_IO_SEEK_CUR 1
@@ -56,6 +57,38 @@ extern "C" {
 
 RZ_LIB_VERSION_HEADER(rz_io);
 
+#define RZ_IO_PAGE_CACHE_PAGE_SIZE     0x1000
+#define RZ_IO_PAGE_CACHE_DEFAULT_PAGES 1024
+#define RZ_IO_PAGE_CACHE_MAX_READ      0x10000
+
+/**
+ * \brief LRU cache of pages read from io plugins, see io_page_cache.c
+ */
+typedef struct rz_io_page_cache_t {
+	bool enabled;
+	size_t max_pages; ///< maximum number of pages kept in memory
+	size_t count; ///< number of pages currently cached
+	HtUP /*<int fd, HtUP<ut64 paddr, RzIOPage *>>*/ *fds;
+	HtUU /*<int fd, ut64>*/ *generations; ///< plugin generation the cached pages of each debug fd were read at
+	struct rz_io_page_t *head; ///< most recently used page
+	struct rz_io_page_t *tail; ///< least recently used page
+	ut64 hits;
+	ut64 misses;
+} RzIOPageCache;
+
+#define RZ_IO_MAP_CACHE_SIZE 4
+
+/**
+ * \brief Most recently used parts of the map skyline, see io_map_lookup()
+ */
+typedef struct rz_io_map_cache_t {
+	ut32 generation; ///< generation of map_skyline the items were taken from
+	size_t count;
+	RzSkylineItem items[RZ_IO_MAP_CACHE_SIZE]; ///< most recently used first
+} RzIOMapCache;
+
+typedef struct rz_io_readahead_t RzIOReadAhead;
+
 typedef struct rz_io_t {
 	struct rz_io_desc_t *desc; // XXX deprecate... we should use only the fd integer, not hold a weak pointer
 	ut64 off;
@@ -72,9 +105,13 @@ typedef struct rz_io_t {
 	RzIDPool *map_ids;
 	RzPVector maps; // from tail backwards maps with higher priority are found
 	RzSkyline map_skyline; // map parts that are not covered by others
+	RzIOMapCache map_cache;
 	RzIDStorage *files;
-	RzPVector cache;
-	RzSkyline cache_skyline;
+	RBTree cache; ///< io.cache extents (RzIOCache), sorted by address, never overlapping nor adjacent
+	RzPVector /*<RBTree>*/ cache_stack; ///< saved cache contents, see rz_io_cache_push()
+	RzIOPageCache page_cache;
+	RzIOReadAhead *readahead; ///< background prefetching of a sequential scan, see rz_io_readahead_start()
+	ut64 read_bytes; ///< bytes requested by rz_io_read_at(), rz_io_read_at_mapped(), rz_io_nread_at() and rz_io_readv()
 	ut8 *write_mask;
 	int write_mask_len;
 	RzList *plugins;
@@ -104,6 +141,15 @@ typedef struct rz_io_desc_t {
 	RzIO *io;
 } RzIODesc;
 
+/**
+ * \brief One range of a vectored read, see rz_io_readv()
+ */
+typedef struct rz_io_vec_t {
+	ut64 addr; ///< virtual or physical address, depending on io.va
+	ut8 *buf; ///< receives len bytes
+	int len;
+} RzIOVec;
+
 typedef struct {
 	ut64 magic;
 	int pid;
@@ -140,6 +186,18 @@ typedef struct rz_io_plugin_t {
 	int (*create)(RzIO *io, const char *file, int mode, int type);
 	bool (*check)(RzIO *io, const char *, bool many);
 	ut8 *(*get_buf)(RzIODesc *desc, ut64 *size);
+	const ut8 *(*borrow)(RzIO *io, RzIODesc *desc, ut64 paddr, ut64 *len); ///< see rz_io_desc_borrow_at()
+	/**
+	 * Debug plugins can return a counter that changes whenever the target may
+	 * have run. This lets io.pagecache keep their pages until the next change.
+	 */
+	ut64 (*generation)(RzIODesc *desc);
+	/**
+	 * Optional, read the physical ranges of \p vecs (sorted by address) in one go instead of a seek and a read for each. Remote
+	 * plugins can answer them in a single round trip. Returns true iff all
+	 * of them were read completely.
+	 */
+	bool (*readv)(RzIO *io, RzIODesc *desc, const RzIOVec *vecs, size_t n);
 } RzIOPlugin;
 
 typedef struct rz_io_map_t {
@@ -164,6 +222,7 @@ typedef struct rz_io_cache_t {
 	ut8 *data;
 	ut8 *odata;
 	int written;
+	RBNode rb; ///< node in RzIO.cache
 } RzIOCache;
 
 #define RZ_IO_DESC_CACHE_SIZE (sizeof(ut64) * 8)
@@ -214,6 +273,8 @@ typedef const char *(*RzIOFdGetName)(RzIO *io, int fd);
 typedef RzList *(*RzIOFdGetMap)(RzIO *io, int fd);
 typedef bool (*RzIOFdRemap)(RzIO *io, int fd, ut64 addr);
 typedef ut8 *(*RzIOFdGetBuf)(RzIO *io, int fd, ut64 *size);
+typedef const ut8 *(*RzIOFdBorrowAt)(RzIO *io, int fd, ut64 addr, ut64 *len);
+typedef const ut8 *(*RzIOBorrowAt)(RzIO *io, ut64 addr, ut64 *len);
 typedef bool (*RzIOIsValidOff)(RzIO *io, ut64 addr, int hasperm);
 typedef RzIOMap *(*RzIOMapGet)(RzIO *io, ut64 addr);
 typedef RzIOMap *(*RzIOMapGetPaddr)(RzIO *io, ut64 paddr);
@@ -254,6 +315,8 @@ typedef struct rz_io_bind_t {
 	RzIOFdGetMap fd_get_map;
 	RzIOFdRemap fd_remap;
 	RzIOFdGetBuf fd_getbuf;
+	RzIOFdBorrowAt fd_borrow_at;
+	RzIOBorrowAt borrow_at;
 	RzIOIsValidOff is_valid_offset;
 	RzIOAddrIsMapped addr_is_mapped;
 	RzIOMapGet map_get;
@@ -283,6 +346,7 @@ RZ_API RzIOMap *rz_io_map_add(RzIO *io, int fd, int flags, ut64 delta, ut64 addr
 // same as rz_io_map_add but used when many maps need to be added. Call rz_io_update when all maps have been added.
 RZ_API RzIOMap *rz_io_map_add_batch(RzIO *io, int fd, int flags, ut64 delta, ut64 addr, ut64 size);
 RZ_API RzIOMap *rz_io_map_get(RzIO *io, ut64 addr); // returns the map at vaddr with the highest priority
+RZ_API RzIOMap *rz_io_map_get_range(RzIO *io, ut64 addr, RZ_NULLABLE RZ_OUT RzInterval *range);
 // update the internal state of RzIO after a series of _batch operations
 RZ_API void rz_io_update(RzIO *io);
 RZ_API bool rz_io_map_is_mapped(RzIO *io, ut64 addr);
@@ -325,8 +389,10 @@ RZ_API int rz_io_pread_at(RzIO *io, ut64 paddr, ut8 *buf, int len);
 RZ_API int rz_io_pwrite_at(RzIO *io, ut64 paddr, const ut8 *buf, int len);
 RZ_API bool rz_io_vread_at_mapped(RzIO *io, ut64 vaddr, ut8 *buf, int len);
 RZ_API bool rz_io_read_at(RzIO *io, ut64 addr, ut8 *buf, int len);
+RZ_API RZ_BORROW const ut8 *rz_io_borrow_at(RZ_NONNULL RzIO *io, ut64 addr, RZ_NONNULL RZ_INOUT ut64 *len);
 RZ_API bool rz_io_read_at_mapped(RzIO *io, ut64 addr, ut8 *buf, int len);
 RZ_API int rz_io_nread_at(RzIO *io, ut64 addr, ut8 *buf, int len);
+RZ_API bool rz_io_readv(RZ_NONNULL RzIO *io, RZ_NONNULL const RzIOVec *vecs, size_t n);
 RZ_API bool rz_io_write_at(RzIO *io, ut64 addr, const ut8 *buf, int len);
 RZ_API bool rz_io_read(RzIO *io, ut8 *buf, int len);
 RZ_API bool rz_io_write(RzIO *io, const ut8 *buf, int len);
@@ -367,6 +433,7 @@ RZ_API ut64 rz_io_desc_seek(RzIODesc *desc, ut64 offset, int whence);
 RZ_API bool rz_io_desc_resize(RzIODesc *desc, ut64 newsize);
 RZ_API ut64 rz_io_desc_size(RzIODesc *desc);
 RZ_API ut8 *rz_io_desc_get_buf(RzIODesc *desc, RZ_OUT RZ_NONNULL ut64 *size);
+RZ_API RZ_BORROW const ut8 *rz_io_desc_borrow_at(RZ_NONNULL RzIODesc *desc, ut64 paddr, RZ_NONNULL RZ_INOUT ut64 *len);
 RZ_API bool rz_io_desc_is_blockdevice(RzIODesc *desc);
 RZ_API bool rz_io_desc_is_chardevice(RzIODesc *desc);
 RZ_API bool rz_io_desc_exchange(RzIO *io, int fd, int fdx); // this should get 2 descs
@@ -390,6 +457,8 @@ RZ_API void rz_io_cache_fini(RzIO *io);
 RZ_API void rz_io_cache_reset(RzIO *io, int set);
 RZ_API bool rz_io_cache_write(RzIO *io, ut64 addr, const ut8 *buf, int len);
 RZ_API bool rz_io_cache_read(RzIO *io, ut64 addr, ut8 *buf, int len);
+RZ_API bool rz_io_cache_push(RzIO *io);
+RZ_API bool rz_io_cache_pop(RzIO *io);
 
 /* io/p_cache.c */
 RZ_API bool rz_io_desc_cache_init(RzIODesc *desc);
@@ -401,6 +470,22 @@ RZ_API void rz_io_desc_cache_fini(RzIODesc *desc);
 RZ_API void rz_io_desc_cache_fini_all(RzIO *io);
 RZ_API RzList *rz_io_desc_cache_list(RzIODesc *desc);
 
+/* io/io_readahead.c */
+RZ_API bool rz_io_readahead_start(RZ_NONNULL RzIO *io, ut64 from, ut64 to, size_t block_size, size_t nblocks, RZ_NULLABLE RzThreadBreakCallback is_breaked, RZ_NULLABLE void *user);
+RZ_API void rz_io_readahead_stop(RZ_NONNULL RzIO *io);
+
+/* io/io_page_cache.c */
+RZ_API void rz_io_page_cache_init(RzIO *io);
+RZ_API void rz_io_page_cache_fini(RzIO *io);
+RZ_API void rz_io_page_cache_clear(RzIO *io);
+RZ_API void rz_io_page_cache_enable(RzIO *io, bool enable);
+RZ_API void rz_io_page_cache_set_max_pages(RzIO *io, size_t max_pages);
+RZ_API void rz_io_page_cache_reset_stats(RzIO *io);
+RZ_API void rz_io_page_cache_invalidate(RzIO *io, int fd, ut64 addr, ut64 len);
+RZ_API void rz_io_page_cache_invalidate_fd(RzIO *io, int fd);
+RZ_API bool rz_io_page_cache_usable(RzIO *io, RzIODesc *desc);
+RZ_API int rz_io_page_cache_read(RzIO *io, RzIODesc *desc, ut64 addr, ut8 *buf, int len);
+
 /* io/fd.c */
 RZ_API int rz_io_fd_open(RzIO *io, const char *uri, int flags, int mode);
 RZ_API bool rz_io_fd_close(RzIO *io, int fd);
@@ -409,6 +494,7 @@ RZ_API int rz_io_fd_write(RzIO *io, int fd, const ut8 *buf, int len);
 RZ_API ut64 rz_io_fd_seek(RzIO *io, int fd, ut64 addr, int whence);
 RZ_API ut64 rz_io_fd_size(RzIO *io, int fd);
 RZ_API ut8 *rz_io_fd_get_buf(RzIO *io, int fd, RZ_OUT RZ_NONNULL ut64 *size);
+RZ_API RZ_BORROW const ut8 *rz_io_fd_borrow_at(RZ_NONNULL RzIO *io, int fd, ut64 paddr, RZ_NONNULL RZ_INOUT ut64 *len);
 RZ_API bool rz_io_fd_resize(RzIO *io, int fd, ut64 newsize);
 RZ_API bool rz_io_fd_is_blockdevice(RzIO *io, int fd);
 RZ_API bool rz_io_fd_is_chardevice(RzIO *io, int fd);
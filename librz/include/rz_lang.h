@@ -13,6 +13,7 @@ RZ_LIB_VERSION_HEADER(rz_lang);
 
 typedef char *(*RzCoreCmdStrCallback)(void *core, const char *s);
 typedef int (*RzCoreCmdfCallback)(void *core, const char *s, ...);
+typedef bool (*RzCoreReadAtCallback)(void *core, ut64 addr, ut8 *buf, int len);
 
 typedef struct rz_lang_t {
 	struct rz_lang_plugin_t *cur;
@@ -22,6 +23,7 @@ typedef struct rz_lang_t {
 	PrintfCallback cb_printf;
 	RzCoreCmdStrCallback cmd_str;
 	RzCoreCmdfCallback cmdf;
+	RzCoreReadAtCallback read_at;
 } RzLang;
 
 typedef struct rz_lang_plugin_t {
@@ -150,11 +150,19 @@ typedef struct tpi_types {
 	bool parsed;
 } RzPdbTpiType;
 
+typedef struct tpi_record_t {
+	ut32 offset; ///< offset of the record in the stream
+	ut16 leaf_type;
+	bool invalid; ///< decoding the record failed already
+} RzPdbTpiRecord;
+
 typedef struct tpi_stream_t {
 	RzPdbTpiStreamHeader header;
-	RBTree types;
+	RBTree types; ///< the types decoded so far, see rz_bin_pdb_get_type_by_index()
 	ut64 type_index_base;
 	RzList /* RzBaseType */ *print_type;
+	RzBuffer *buf; ///< the stream data, records are decoded from it on demand
+	RzVector /*<RzPdbTpiRecord>*/ records; ///< the records from header.TypeIndexBegin on
 } RzPdbTpiStream;
 
 // PDB
@@ -258,6 +266,7 @@ RZ_API void rz_bin_pdb_free(RzPdb *pdb);
 
 // TPI
 RZ_API RZ_BORROW RzPdbTpiType *rz_bin_pdb_get_type_by_index(RZ_NONNULL RzPdbTpiStream *stream, ut32 index);
+RZ_API ut16 rz_bin_pdb_get_type_leaf(RZ_NONNULL RzPdbTpiStream *stream, ut32 index);
 RZ_API RZ_OWN char *rz_bin_pdb_calling_convention_as_string(RZ_NONNULL RzPdbTpiCallingConvention idx);
 RZ_API bool rz_bin_pdb_type_is_fwdref(RZ_NONNULL RzPdbTpiType *t);
 RZ_API RZ_BORROW RzList *rz_bin_pdb_get_type_members(RZ_NONNULL RzPdbTpiStream *stream, RzPdbTpiType *t);
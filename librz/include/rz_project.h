@@ -28,9 +28,15 @@ typedef enum rz_project_err {
 	RZ_PROJECT_ERR_UNKNOWN
 } RzProjectErr;
 
+typedef enum rz_project_format {
+	RZ_PROJECT_FORMAT_TEXT, ///< plaintext sdb, see sdb_text_save()
+	RZ_PROJECT_FORMAT_BINARY ///< binary sdb, see sdb_bin_save()
+} RzProjectFormat;
+
 RZ_API RZ_NONNULL const char *rz_project_err_message(RzProjectErr err);
 RZ_API RzProjectErr rz_project_save(RzCore *core, RzProject *prj, const char *file);
 RZ_API RzProjectErr rz_project_save_file(RzCore *core, const char *file, bool compress);
+RZ_API RzProjectErr rz_project_save_file_as(RzCore *core, const char *file, RzProjectFormat format, bool compress);
 RZ_API RzProject *rz_project_load_file_raw(const char *file);
 RZ_API void rz_project_free(RzProject *prj);
 
@@ -3,6 +3,7 @@
 
 #include <rz_types.h>
 #include <rz_list.h>
+#include <rz_vector.h>
 #include <rz_util/rz_hex.h>
 #include <rz_util/rz_bitvector.h>
 #include <rz_util/rz_assert.h>
@@ -135,6 +136,7 @@ typedef struct rz_reg_arena_t {
 typedef struct rz_reg_set_t {
 	RzRegArena *arena;
 	RzList *pool; ///< RzRegArena
+	RzPVector /*<RzRegArena *>*/ *spare; ///< arenas popped from the pool, reused by the next push
 	RzList *regs; ///< RzRegItem
 	HtPP *ht_regs; ///< name:RzRegItem
 	RzListIter *cur;
@@ -148,6 +150,7 @@ typedef struct rz_reg_t {
 	RzRegProfile reg_profile;
 	char *name[RZ_REG_NAME_LAST]; // aliases
 	RzRegSet regset[RZ_REG_TYPE_LAST];
+	HtPP *ht_names; ///< name:RzRegItem of any type, the first one in regset order, for rz_reg_get() with type -1
 	RzList *allregs;
 	RzList *roregs;
 	int iters;
@@ -156,6 +159,7 @@ typedef struct rz_reg_t {
 	int size;
 	bool is_thumb;
 	bool big_endian;
+	ut32 generation; ///< bumped every time the register items are freed, so holders of RzRegItem pointers can detect staleness
 } RzReg;
 
 typedef struct rz_reg_flags_t {
@@ -246,6 +250,8 @@ RZ_API ut64 rz_reg_set_bvalue(RzReg *reg, RzRegItem *item, const char *str);
 /* packed registers */
 RZ_API int rz_reg_set_pack(RzReg *reg, RzRegItem *item, int packidx, int packbits, ut64 val);
 RZ_API ut64 rz_reg_get_pack(RzReg *reg, RzRegItem *item, int packidx, int packbits);
+RZ_API bool rz_reg_get_pack_bytes(RZ_NONNULL RzReg *reg, RZ_NONNULL RzRegItem *item, int packidx, int packbytes, RZ_OUT RZ_NONNULL ut8 *buf);
+RZ_API bool rz_reg_set_pack_bytes(RZ_NONNULL RzReg *reg, RZ_NONNULL RzRegItem *item, int packidx, int packbytes, RZ_NONNULL const ut8 *buf);
 
 /* byte arena */
 RZ_API ut8 *rz_reg_get_bytes(RzReg *reg, int type, int *size);
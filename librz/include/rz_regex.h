@@ -26,6 +26,7 @@ typedef struct rz_regmatch_t {
 #define RZ_REGEX_NEWLINE  0010
 #define RZ_REGEX_NOSPEC   0020
 #define RZ_REGEX_PEND     0040
+#define RZ_REGEX_NODFA    0100 /* always step the state sets, never use the DFA cache */
 #define RZ_REGEX_DUMP     0200
 
 /* regerror() flags */
@@ -27,6 +27,8 @@ enum {
 };
 
 #define RZ_SEARCH_DISTANCE_MAX 10
+// number of keywords from which the keyword search switches to a multi-pattern automaton
+#define RZ_SEARCH_AC_MIN_KEYWORDS 16
 
 #define RZ_SEARCH_KEYWORD_TYPE_BINARY 'i'
 #define RZ_SEARCH_KEYWORD_TYPE_STRING 's'
@@ -42,6 +44,8 @@ typedef struct rz_search_keyword_t {
 	int icase; // ignore case
 	int type;
 	ut64 last; // last hit hint
+	RzRegex *regex; // compiled bin_keyword, kept between the chunks of a regexp search
+	ut64 regexp_next; // address the next regexp scan starts at, the matches before it are reported
 } RzSearchKeyword;
 
 typedef struct rz_search_hit_t {
@@ -51,6 +55,9 @@ typedef struct rz_search_hit_t {
 
 typedef int (*RzSearchCallback)(RzSearchKeyword *kw, void *user, ut64 where);
 
+typedef struct rz_search_ac_t RzSearchAC;
+typedef struct rz_search_gram_index_t RzSearchGramIndex;
+
 typedef struct rz_search_t {
 	int n_kws; // hit${n_kws}_${count}
 	int mode;
@@ -70,8 +77,13 @@ typedef struct rz_search_t {
 	int align;
 	int (*update)(struct rz_search_t *s, ut64 from, const ut8 *buf, int len);
 	RzList *kws; // TODO: Use rz_search_kw_new ()
+	RzSearchAC *ac; ///< automaton compiled from kws on demand, see aho_corasick.c
+	int ac_min_kws; ///< use the automaton from this number of keywords on, 0 to never use it
 	RzIOBind iob;
 	char bckwrds;
+	ut8 *regexp_tail; ///< end of the last chunk of a regexp search, for the matches crossing two chunks
+	int regexp_tail_len;
+	ut64 regexp_tail_to; ///< address right after regexp_tail
 } RzSearch;
 
 #ifdef RZ_API
@@ -81,11 +93,13 @@ typedef struct rz_search_t {
 RZ_API RzSearch *rz_search_new(int mode);
 RZ_API int rz_search_set_mode(RzSearch *s, int mode);
 RZ_API RzSearch *rz_search_free(RzSearch *s);
+RZ_API RZ_OWN RzSearch *rz_search_fork(RZ_NONNULL RzSearch *s);
 
 /* keyword management */
 RZ_API RzList *rz_search_find(RzSearch *s, ut64 addr, const ut8 *buf, int len);
 RZ_API int rz_search_update(RzSearch *s, ut64 from, const ut8 *buf, long len);
 RZ_API int rz_search_update_i(RzSearch *s, ut64 from, const ut8 *buf, long len);
+RZ_API int rz_search_update_parallel(RzSearch *s, ut64 from, const ut8 *buf, ut64 len, ut64 block_size, size_t max_threads);
 
 RZ_API void rz_search_keyword_free(RzSearchKeyword *kw);
 RZ_API RzSearchKeyword *rz_search_keyword_new(const ut8 *kw, int kwlen, const ut8 *bm, int bmlen, const char *data);
@@ -116,6 +130,18 @@ RZ_API int rz_search_set_string_limits(RzSearch *s, ut32 min, ut32 max); // dup
 RZ_API void rz_search_set_callback(RzSearch *s, RzSearchCallback(callback), void *user);
 RZ_API int rz_search_begin(RzSearch *s);
 
+/* gram index */
+RZ_API RZ_OWN RzSearchGramIndex *rz_search_gram_index_new(ut64 addr, ut64 size, ut64 max_mem);
+RZ_API void rz_search_gram_index_free(RZ_NULLABLE RzSearchGramIndex *idx);
+RZ_API bool rz_search_gram_index_feed(RZ_NONNULL RzSearchGramIndex *idx, RZ_NONNULL const ut8 *buf, ut64 len);
+RZ_API RzInterval rz_search_gram_index_itv(RZ_NONNULL RzSearchGramIndex *idx);
+RZ_API bool rz_search_gram_index_complete(RZ_NONNULL RzSearchGramIndex *idx);
+RZ_API ut64 rz_search_gram_index_page_size(RZ_NONNULL RzSearchGramIndex *idx);
+RZ_API ut64 rz_search_gram_index_mem(RZ_NONNULL RzSearchGramIndex *idx);
+RZ_API bool rz_search_gram_index_ranges(RZ_NONNULL RzSearchGramIndex *idx, RZ_NONNULL RzSearch *s, ut64 from, ut64 to, ut64 block_size, RZ_NONNULL RzVector /*<RzInterval>*/ *out);
+RZ_API RZ_OWN ut8 *rz_search_gram_index_serialize(RZ_NONNULL RzSearchGramIndex *idx, RZ_NONNULL ut64 *size);
+RZ_API RZ_OWN RzSearchGramIndex *rz_search_gram_index_deserialize(RZ_NONNULL const ut8 *buf, ut64 size, ut64 max_mem, RZ_NULLABLE ut64 *used);
+
 /* pattern search */
 RZ_API void rz_search_pattern_size(RzSearch *s, int size);
 RZ_API int rz_search_pattern(RzSearch *s, ut64 from, ut64 to);
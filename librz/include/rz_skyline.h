@@ -11,6 +11,7 @@ typedef struct rz_skyline_item_t {
 
 typedef struct rz_skyline_t {
 	RzVector v;
+	ut32 generation; ///< changed on every modification, so lookups can be cached
 } RzSkyline;
 
 RZ_API bool rz_skyline_add(RzSkyline *skyline, RzInterval itv, void *user);
@@ -19,16 +20,19 @@ RZ_API const RzSkylineItem *rz_skyline_get_item_intersect(RzSkyline *skyline, ut
 static inline void rz_skyline_init(RzSkyline *skyline) {
 	rz_return_if_fail(skyline);
 	rz_vector_init(&skyline->v, sizeof(RzSkylineItem), NULL, NULL);
+	skyline->generation = 0;
 }
 
 static inline void rz_skyline_fini(RzSkyline *skyline) {
 	rz_return_if_fail(skyline);
 	rz_vector_fini(&skyline->v);
+	skyline->generation++;
 }
 
 static inline void rz_skyline_clear(RzSkyline *skyline) {
 	rz_return_if_fail(skyline);
 	rz_vector_clear(&skyline->v);
+	skyline->generation++;
 }
 
 static inline const RzSkylineItem *rz_skyline_get_item(RzSkyline *skyline, ut64 addr) {
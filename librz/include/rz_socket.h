@@ -4,6 +4,7 @@
 #include "rz_types.h"
 #include "rz_bind.h"
 #include "rz_list.h"
+#include "rz_vector.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -48,6 +49,33 @@ RZ_LIB_VERSION_HEADER(rz_socket);
 #define RZ_INVALID_SOCKET -1
 #endif
 
+/*
+ * Framed rzpipe protocol. The host offers it with RZPIPE_FRAMED_ENV in the
+ * environment of the script and the script turns it on by sending
+ * RZPIPE_FRAMED_HELLO instead of a command, hosts without it ignore
+ * messages starting with a NUL byte.
+ *
+ * Afterwards every message has a header of RZPIPE_FRAME_HDR_SIZE bytes, the
+ * payload size as le32 and a type (requests) or status (responses), followed
+ * by the payload. Requests can be pipelined, the responses come back in the
+ * same order. The hello is answered with a RZPIPE_FRAME_OK response.
+ *
+ * With RZPIPE_FRAME_SHM the script can also get a POSIX shared memory segment
+ * created by the host, RZPIPE_FRAME_SHM_READ then makes the host read straight
+ * into it and only the small request and response go through the pipe.
+ */
+#define RZPIPE_FRAMED_ENV       "RZ_PIPE_FRAMED"
+#define RZPIPE_FRAMED_HELLO     "\x00rzpipe-framed-1\n"
+#define RZPIPE_FRAMED_HELLO_LEN 17
+#define RZPIPE_FRAME_HDR_SIZE   5
+#define RZPIPE_FRAME_MAX        (256 * 1024 * 1024)
+#define RZPIPE_FRAME_CMD        'c' ///< payload: the command, response: its output
+#define RZPIPE_FRAME_READ       'r' ///< payload: le64 address and le32 size, response: the raw bytes
+#define RZPIPE_FRAME_SHM        's' ///< payload: le32 size (0 to drop it), response: the name of the segment for shm_open()
+#define RZPIPE_FRAME_SHM_READ   'R' ///< payload: le64 address, le32 size and le32 offset in the segment, response: empty
+#define RZPIPE_FRAME_OK         0
+#define RZPIPE_FRAME_ERROR      1
+
 typedef struct {
 	int child;
 #if __WINDOWS__
@@ -57,6 +85,9 @@ typedef struct {
 	int output[2];
 #endif
 	RzCoreBind coreb;
+	bool framed; ///< the framed protocol was negotiated
+	ut8 *shm; ///< segment shared with the host, see rzpipe_shm_open()
+	size_t shm_size;
 } RzPipe;
 
 typedef struct rz_socket_t {
@@ -175,10 +206,29 @@ enum {
 	RAP_PACKET_CLOSE = 5,
 	// system was deprecated in slot 6,
 	RAP_PACKET_CMD = 7,
+	RAP_PACKET_READV = 8,
+	RAP_PACKET_EXTENDED = 0x40, ///< set in the RAP_PACKET_OPEN reply when the capabilities follow the fd
 	RAP_PACKET_REPLY = 0x80,
 	RAP_PACKET_MAX = 4096
 };
 
+/* capabilities of the server, only told to clients asking with RAP_OPEN_CAPS */
+enum {
+	RAP_CAP_READV = 1 << 0, ///< RAP_PACKET_READV is understood
+	RAP_CAP_ZLIB = 1 << 1, ///< RAP_PACKET_READV replies can be deflated
+};
+
+#define RAP_OPEN_CAPS     0x80 ///< flag of RAP_PACKET_OPEN, ask for the capabilities in the reply
+#define RAP_READV_ZLIB    1 ///< flag of RAP_PACKET_READV, the data of the reply is (or may be) deflated
+#define RAP_READV_MAX     (1 << 20) ///< max bytes read by a single RAP_PACKET_READV
+#define RAP_READV_MAX_IOV 256 ///< max ranges read by a single RAP_PACKET_READV
+
+typedef struct rz_socket_rap_iov_t {
+	ut64 addr;
+	ut8 *buf;
+	ut32 len;
+} RzSocketRapIov;
+
 typedef struct rz_socket_rap_server_t {
 	RzSocket *fd;
 	char *port;
@@ -206,6 +256,10 @@ RZ_API char *rz_socket_rap_client_command(RzSocket *s, const char *cmd, RzCoreBi
 RZ_API int rz_socket_rap_client_write(RzSocket *s, const ut8 *buf, int count);
 RZ_API int rz_socket_rap_client_read(RzSocket *s, ut8 *buf, int count);
 RZ_API int rz_socket_rap_client_seek(RzSocket *s, ut64 offset, int whence);
+RZ_API int rz_socket_rap_client_open_caps(RzSocket *s, const char *file, int rw, RZ_NULLABLE RZ_OUT ut32 *caps);
+RZ_API bool rz_socket_rap_client_readv(RzSocket *s, ut32 caps, RZ_NONNULL const RzSocketRapIov *iov, size_t count);
+RZ_API int rz_socket_rap_client_read_at(RzSocket *s, ut32 caps, ut64 addr, RZ_NONNULL ut8 *buf, int count);
+RZ_API int rz_socket_rap_client_write_at(RzSocket *s, ut64 addr, RZ_NONNULL const ut8 *buf, int count);
 
 /* run.c */
 #define RZ_RUN_PROFILE_NARGS 512
@@ -270,6 +324,11 @@ RZ_API RzPipe *rzpipe_open(const char *cmd);
 RZ_API RzPipe *rzpipe_open_dl(const char *file);
 RZ_API char *rzpipe_cmd(RzPipe *rzpipe, const char *str);
 RZ_API char *rzpipe_cmdf(RzPipe *rzpipe, const char *fmt, ...) RZ_PRINTF_CHECK(2, 3);
+RZ_API RZ_OWN RzPVector /*<char *>*/ *rzpipe_cmd_batch(RZ_NONNULL RzPipe *rzpipe, RZ_NONNULL const char **cmds, size_t n);
+RZ_API st64 rzpipe_read_at(RZ_NONNULL RzPipe *rzpipe, ut64 addr, RZ_NONNULL RZ_OUT ut8 *buf, size_t len);
+RZ_API bool rzpipe_shm_open(RZ_NONNULL RzPipe *rzpipe, size_t size);
+RZ_API void rzpipe_shm_close(RZ_NONNULL RzPipe *rzpipe);
+RZ_API RZ_BORROW const ut8 *rzpipe_shm_read_at(RZ_NONNULL RzPipe *rzpipe, ut64 addr, size_t len);
 #endif
 
 #ifdef __cplusplus
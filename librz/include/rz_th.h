@@ -22,10 +22,16 @@ extern "C" {
 typedef struct rz_th_sem_t RzThreadSemaphore;
 typedef struct rz_th_lock_t RzThreadLock;
 typedef struct rz_th_cond_t RzThreadCond;
+typedef struct rz_th_rwlock_t RzThreadRWLock;
 typedef struct rz_th_t RzThread;
 typedef struct rz_th_pool_t RzThreadPool;
 typedef struct rz_th_queue_t RzThreadQueue;
+typedef struct rz_th_ring_t RzThreadRing;
+typedef struct rz_th_task_pool_t RzThreadTaskPool;
+typedef struct rz_th_future_t RzThreadFuture;
 typedef void *(*RzThreadFunction)(void *user);
+typedef void (*RzThreadRangeFunction)(size_t from, size_t to, void *user);
+typedef bool (*RzThreadBreakCallback)(void *user);
 
 typedef struct rz_atomic_bool_t RzAtomicBool;
 
@@ -57,6 +63,14 @@ RZ_API void rz_th_cond_signal_all(RZ_NONNULL RzThreadCond *cond);
 RZ_API void rz_th_cond_wait(RZ_NONNULL RzThreadCond *cond, RZ_NONNULL RzThreadLock *lock);
 RZ_API void rz_th_cond_free(RZ_NULLABLE RzThreadCond *cond);
 
+RZ_API RZ_OWN RzThreadRWLock *rz_th_rwlock_new(void);
+RZ_API void rz_th_rwlock_free(RZ_NULLABLE RzThreadRWLock *rwl);
+RZ_API void rz_th_rwlock_read_enter(RZ_NONNULL RzThreadRWLock *rwl);
+RZ_API void rz_th_rwlock_read_leave(RZ_NONNULL RzThreadRWLock *rwl);
+RZ_API void rz_th_rwlock_write_enter(RZ_NONNULL RzThreadRWLock *rwl);
+RZ_API void rz_th_rwlock_write_leave(RZ_NONNULL RzThreadRWLock *rwl);
+RZ_API bool rz_th_rwlock_has_waiting_readers(RZ_NONNULL RzThreadRWLock *rwl);
+
 RZ_API size_t rz_th_physical_core_number();
 RZ_API size_t rz_th_request_physical_cores(size_t max_cores);
 
@@ -75,6 +89,27 @@ RZ_API RZ_OWN void *rz_th_queue_wait_pop(RZ_NONNULL RzThreadQueue *queue, bool t
 RZ_API bool rz_th_queue_is_empty(RZ_NULLABLE RzThreadQueue *queue);
 RZ_API bool rz_th_queue_is_full(RZ_NULLABLE RzThreadQueue *queue);
 
+RZ_API RZ_OWN RzThreadRing *rz_th_ring_new(size_t capacity, RZ_NULLABLE RzListFree qfree);
+RZ_API void rz_th_ring_free(RZ_NULLABLE RzThreadRing *ring);
+RZ_API size_t rz_th_ring_capacity(RZ_NONNULL RzThreadRing *ring);
+RZ_API bool rz_th_ring_push(RZ_NONNULL RzThreadRing *ring, RZ_NONNULL void *user);
+RZ_API RZ_OWN void *rz_th_ring_pop(RZ_NONNULL RzThreadRing *ring);
+RZ_API RZ_OWN void *rz_th_ring_wait_pop(RZ_NONNULL RzThreadRing *ring);
+RZ_API bool rz_th_ring_is_empty(RZ_NONNULL RzThreadRing *ring);
+RZ_API bool rz_th_ring_is_full(RZ_NONNULL RzThreadRing *ring);
+
+RZ_API RZ_OWN RzThreadTaskPool *rz_th_task_pool_new(size_t max_threads);
+RZ_API void rz_th_task_pool_free(RZ_NULLABLE RzThreadTaskPool *pool);
+RZ_API size_t rz_th_task_pool_size(RZ_NONNULL RzThreadTaskPool *pool);
+RZ_API void rz_th_task_pool_set_break_callback(RZ_NONNULL RzThreadTaskPool *pool, RZ_NULLABLE RzThreadBreakCallback is_breaked, RZ_NULLABLE void *user);
+RZ_API bool rz_th_task_pool_is_breaked(RZ_NONNULL RzThreadTaskPool *pool);
+RZ_API RZ_OWN RzThreadFuture *rz_th_task_pool_submit(RZ_NONNULL RzThreadTaskPool *pool, RZ_NONNULL RzThreadFunction function, RZ_NULLABLE void *user);
+RZ_API bool rz_th_task_pool_parallel_for(RZ_NONNULL RzThreadTaskPool *pool, size_t from, size_t to, size_t grain, RZ_NONNULL RzThreadRangeFunction function, RZ_NULLABLE void *user);
+RZ_API bool rz_th_future_is_done(RZ_NONNULL RzThreadFuture *future);
+RZ_API bool rz_th_future_is_cancelled(RZ_NONNULL RzThreadFuture *future);
+RZ_API void *rz_th_future_wait(RZ_NONNULL RzThreadTaskPool *pool, RZ_NONNULL RzThreadFuture *future);
+RZ_API void rz_th_future_free(RZ_NULLABLE RzThreadFuture *future);
+
 RZ_API RZ_OWN RzAtomicBool *rz_atomic_bool_new(bool value);
 RZ_API void rz_atomic_bool_free(RZ_NULLABLE RzAtomicBool *tbool);
 RZ_API bool rz_atomic_bool_get(RZ_NONNULL RzAtomicBool *tbool);
@@ -27,16 +27,19 @@ typedef struct rz_type_target_t {
 } RzTypeTarget;
 
 typedef struct rz_type_parser_t RzTypeParser;
+typedef struct rz_type_layout_cache_t RzTypeLayoutCache;
 
 typedef struct rz_type_db_t {
 	void *user;
 	HtPP /* <char *, RzBaseType *> */ *types; //< name -> base type
 	HtPP /* <char *, char *> */ *formats; //< name -> `pf` format
 	HtPP /* <char *, RzCallable *> */ *callables; //< name -> RzCallable (function type)
+	RzPVector /* <Sdb *> */ *callables_lazy; //< compiled sdbs whose callables are built on first access, most recent last
 	RzTypeTarget *target;
 	RzTypeParser *parser;
 	RzNum *num;
 	RzIOBind iob; // for RzIO in formats
+	RzTypeLayoutCache *layouts; //< computed sizes of the compound types
 } RzTypeDB;
 
 // All types in RzTypeDB module are either concrete,
@@ -346,6 +349,7 @@ RZ_API ut64 rz_type_db_union_bitsize(const RzTypeDB *typedb, RZ_NONNULL RzBaseTy
 RZ_API ut64 rz_type_db_typedef_bitsize(const RzTypeDB *typedb, RZ_NONNULL RzBaseType *btype);
 RZ_API ut64 rz_type_db_base_get_bitsize(const RzTypeDB *typedb, RZ_NONNULL RzBaseType *btype);
 RZ_API ut64 rz_type_db_get_bitsize(const RzTypeDB *typedb, RZ_NONNULL RzType *type);
+RZ_API void rz_type_db_invalidate_layouts(RZ_NONNULL const RzTypeDB *typedb);
 
 // Various type helpers
 RZ_API bool rz_type_atomic_eq(const RzTypeDB *typedb, RZ_NONNULL const RzType *typ1, RZ_NONNULL const RzType *typ2);
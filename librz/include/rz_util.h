@@ -41,6 +41,7 @@
 #include "rz_util/rz_hex.h"
 #include "rz_util/rz_log.h"
 #include "rz_util/rz_mem.h"
+#include "rz_util/rz_mem_account.h"
 #include "rz_util/rz_name.h"
 #include "rz_util/rz_num.h"
 #include "rz_util/rz_table.h"
@@ -58,13 +59,16 @@
 #include "rz_util/rz_str_search.h"
 #include "rz_util/rz_strpool.h"
 #include "rz_util/rz_str_constpool.h"
+#include "rz_util/rz_str_intern.h"
 #include "rz_util/rz_sys.h"
+#include "rz_util/rz_tracing.h"
 #include "rz_util/rz_tree.h"
 #include "rz_util/rz_uleb128.h"
 #include "rz_util/rz_utf8.h"
 #include "rz_util/rz_utf16.h"
 #include "rz_util/rz_utf32.h"
 #include "rz_util/rz_idpool.h"
+#include "rz_util/rz_slab.h"
 #include "rz_util/rz_asn1.h"
 #include "rz_util/rz_pj.h"
 #include "rz_util/rz_x509.h"
@@ -16,7 +16,7 @@ extern "C" {
 #endif
 
 typedef struct rz_bitmap_t {
-	int length;
+	size_t length; ///< number of bits
 	RBitword *bitmap;
 } RzBitmap;
 
@@ -26,6 +26,13 @@ RZ_API void rz_bitmap_free(RzBitmap *b);
 RZ_API void rz_bitmap_set(RzBitmap *b, size_t bit);
 RZ_API void rz_bitmap_unset(RzBitmap *b, size_t bit);
 RZ_API int rz_bitmap_test(RzBitmap *b, size_t bit);
+RZ_API void rz_bitmap_set_range(RZ_NONNULL RzBitmap *b, size_t from, size_t to);
+RZ_API void rz_bitmap_unset_range(RZ_NONNULL RzBitmap *b, size_t from, size_t to);
+RZ_API size_t rz_bitmap_count(RZ_NONNULL const RzBitmap *b, size_t from, size_t to);
+RZ_API size_t rz_bitmap_next_set(RZ_NONNULL const RzBitmap *b, size_t from);
+RZ_API size_t rz_bitmap_next_unset(RZ_NONNULL const RzBitmap *b, size_t from);
+RZ_API bool rz_bitmap_or(RZ_NONNULL RzBitmap *dst, RZ_NONNULL const RzBitmap *src);
+RZ_API bool rz_bitmap_and(RZ_NONNULL RzBitmap *dst, RZ_NONNULL const RzBitmap *src);
 
 #ifdef __cplusplus
 }
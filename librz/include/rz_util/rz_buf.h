@@ -3,6 +3,7 @@
 #include <rz_util/rz_mem.h>
 #include <rz_types.h>
 #include <rz_list.h>
+#include <rz_vector.h>
 #include <rz_util/rz_assert.h>
 
 #ifdef __cplusplus
@@ -26,6 +27,7 @@ typedef bool (*RzBufferResize)(RzBuffer *b, ut64 newsize);
 typedef st64 (*RzBufferSeek)(RzBuffer *b, st64 addr, int whence);
 typedef ut8 *(*RzBufferGetWholeBuf)(RzBuffer *b, ut64 *sz);
 typedef void (*RzBufferFreeWholeBuf)(RzBuffer *b);
+typedef const ut8 *(*RzBufferBorrow)(RzBuffer *b, ut64 addr, ut64 *len);
 typedef RzList *(*RzBufferNonEmptyList)(RzBuffer *b);
 
 typedef struct rz_buffer_methods_t {
@@ -38,6 +40,7 @@ typedef struct rz_buffer_methods_t {
 	RzBufferSeek seek;
 	RzBufferGetWholeBuf get_whole_buf;
 	RzBufferFreeWholeBuf free_whole_buf;
+	RzBufferBorrow borrow;
 } RzBufferMethods;
 
 struct rz_buf_t {
@@ -61,6 +64,10 @@ typedef enum {
 	RZ_BUF_SPARSE_WRITE_MODE_THROUGH ///< all writes are performed in the underlying base buffer
 } RzBufferSparseWriteMode;
 
+#define RZ_BUF_COW_PAGE_SIZE 0x1000
+
+typedef struct rz_buf_cow_snapshot_t RzBufferCowSnapshot;
+
 /* utils */
 
 /// change cur according to addr and whence (RZ_BUF_SET/RZ_BUF_CUR/RZ_BUF_END)
@@ -86,6 +93,9 @@ RZ_API RZ_OWN RzBuffer *rz_buf_new_slice(RzBuffer *b, ut64 offset, ut64 size);
 RZ_API RZ_OWN RzBuffer *rz_buf_new_slurp(const char *file);
 RZ_API RZ_OWN RzBuffer *rz_buf_new_sparse(ut8 Oxff);
 RZ_API RZ_OWN RzBuffer *rz_buf_new_sparse_overlay(RzBuffer *b, RzBufferSparseWriteMode write_mode);
+RZ_API RZ_OWN RzBuffer *rz_buf_new_cow(RZ_NONNULL RzBuffer *b);
+RZ_API RZ_OWN RzBuffer *rz_buf_new_inflate(RZ_NONNULL RzBuffer *b);
+RZ_API RZ_OWN RzBuffer *rz_buf_new_inflatew(RZ_NONNULL RzBuffer *b, int wbits);
 RZ_API RZ_OWN RzBuffer *rz_buf_new_with_buf(RzBuffer *b);
 RZ_API RZ_OWN RzBuffer *rz_buf_new_with_bytes(RZ_NULLABLE RZ_BORROW const ut8 *bytes, ut64 len);
 RZ_API RZ_OWN RzBuffer *rz_buf_new_with_io_fd(RZ_NONNULL void /* RzIOBind */ *iob, int fd);
@@ -132,6 +142,7 @@ RZ_API ut64 rz_buf_tell(RZ_NONNULL RzBuffer *b);
 RZ_API void rz_buf_free(RzBuffer *b);
 RZ_API void rz_buf_set_overflow_byte(RZ_NONNULL RzBuffer *b, ut8 Oxff);
 RZ_DEPRECATE RZ_API RZ_BORROW ut8 *rz_buf_data(RZ_NONNULL RzBuffer *b, RZ_NONNULL RZ_OUT ut64 *size);
+RZ_API RZ_BORROW const ut8 *rz_buf_borrow_at(RZ_NONNULL RzBuffer *b, ut64 addr, RZ_NONNULL RZ_INOUT ut64 *len);
 
 typedef ut64 (*RzBufferFwdScan)(RZ_BORROW RZ_NONNULL const ut8 *buf, ut64 len, RZ_NULLABLE void *user);
 RZ_API ut64 rz_buf_fwd_scan(RZ_NONNULL RzBuffer *b, ut64 start, ut64 amount, RZ_NONNULL RzBufferFwdScan fwd_scan, RZ_NULLABLE void *user);
@@ -326,6 +337,15 @@ RZ_API const RzBufferSparseChunk *rz_buf_sparse_get_chunks(RzBuffer *b, RZ_NONNU
 RZ_API void rz_buf_sparse_set_write_mode(RzBuffer *b, RzBufferSparseWriteMode mode);
 RZ_API bool rz_buf_sparse_populated_in(RzBuffer *b, ut64 from, ut64 to);
 
+// cow-specific
+
+RZ_API RZ_OWN RzVector /*<ut64>*/ *rz_buf_cow_get_pages(RZ_NONNULL RzBuffer *b);
+RZ_API bool rz_buf_cow_commit(RZ_NONNULL RzBuffer *b);
+RZ_API void rz_buf_cow_reset(RZ_NONNULL RzBuffer *b);
+RZ_API RZ_OWN RzBufferCowSnapshot *rz_buf_cow_snapshot(RZ_NONNULL RzBuffer *b);
+RZ_API bool rz_buf_cow_restore(RZ_NONNULL RzBuffer *b, RZ_NONNULL const RzBufferCowSnapshot *snap);
+RZ_API void rz_buf_cow_snapshot_free(RZ_NULLABLE RzBufferCowSnapshot *snap);
+
 RZ_API bool rz_deflatew_buf(RZ_NONNULL RzBuffer *src, RZ_NONNULL RzBuffer *dst, ut64 block_size, ut8 *src_consumed, int wbits);
 RZ_API bool rz_deflate_buf(RZ_NONNULL RzBuffer *src, RZ_NONNULL RzBuffer *dst, ut64 block_size, ut8 *src_consumed);
 RZ_API bool rz_inflatew_buf(RZ_NONNULL RzBuffer *src, RZ_NONNULL RzBuffer *dst, ut64 block_size, ut8 *src_consumed, int wbits);
@@ -18,6 +18,7 @@ typedef struct rz_event_t {
 	RzVector all_callbacks;
 	RzVector /*<RzEventCallbackHandle>*/ pending_unhook; ///< while inside of a call and a handle is unhooked, the unhook is deferred and saved here
 	int next_handle;
+	size_t hooked; ///< number of hooks, events are not dispatched at all without any
 } RzEvent;
 
 typedef struct rz_event_callback_handle_t {
@@ -40,6 +40,37 @@ typedef struct rz_graph_visitor_t {
 typedef void (*RzGraphNodeCallback)(RzGraphNode *n, RzGraphVisitor *vis);
 typedef void (*RzGraphEdgeCallback)(const RzGraphEdge *e, RzGraphVisitor *vis);
 
+/**
+ * \brief Immutable graph in compressed sparse row form
+ *
+ * Nodes are the indices 0 to n_nodes - 1 and the edges of each node are
+ * contiguous, so accessing a node or its neighbours is O(1) and traversals
+ * don't chase pointers.
+ */
+typedef struct rz_graph_csr_t {
+	ut32 n_nodes;
+	ut32 n_edges;
+	void **data; ///< data of each node
+	RzGraphNode **nodes; ///< node of the RzGraph each index was built from, NULL if not built from one
+	ut32 *out_off; ///< the successors of i are out[out_off[i]] to out[out_off[i + 1] - 1]
+	ut32 *out;
+	ut32 *in_off; ///< the predecessors of i are in[in_off[i]] to in[in_off[i + 1] - 1]
+	ut32 *in;
+	ut32 *index_of; ///< index of each RzGraphNode.idx, UT32_MAX for the deleted ones
+	ut32 n_index_of;
+} RzGraphCSR;
+
+typedef struct rz_graph_csr_builder_t RzGraphCSRBuilder;
+
+typedef struct rz_graph_csr_visitor_t {
+	void (*discover_node)(ut32 n, struct rz_graph_csr_visitor_t *vis);
+	void (*finish_node)(ut32 n, struct rz_graph_csr_visitor_t *vis);
+	void (*tree_edge)(ut32 from, ut32 to, ut32 nth, struct rz_graph_csr_visitor_t *vis);
+	void (*back_edge)(ut32 from, ut32 to, ut32 nth, struct rz_graph_csr_visitor_t *vis);
+	void (*fcross_edge)(ut32 from, ut32 to, ut32 nth, struct rz_graph_csr_visitor_t *vis);
+	void *data;
+} RzGraphCSRVisitor;
+
 // Contrructs a new RzGraph, returns heap-allocated graph.
 RZ_API RzGraph *rz_graph_new(void);
 // Destroys the graph and all nodes.
@@ -66,6 +97,34 @@ RZ_API void rz_graph_dfs_node(RzGraph *g, RzGraphNode *n, RzGraphVisitor *vis);
 RZ_API void rz_graph_dfs_node_reverse(RzGraph *g, RzGraphNode *n, RzGraphVisitor *vis);
 RZ_API void rz_graph_dfs(RzGraph *g, RzGraphVisitor *vis);
 
+RZ_API RZ_OWN RzGraphCSRBuilder *rz_graph_csr_builder_new(void);
+RZ_API void rz_graph_csr_builder_free(RZ_NULLABLE RzGraphCSRBuilder *b);
+RZ_API ut32 rz_graph_csr_builder_add_node(RZ_NONNULL RzGraphCSRBuilder *b, RZ_NULLABLE void *data);
+RZ_API bool rz_graph_csr_builder_add_edge(RZ_NONNULL RzGraphCSRBuilder *b, ut32 from, ut32 to);
+RZ_API RZ_OWN RzGraphCSR *rz_graph_csr_builder_build(RZ_NONNULL RzGraphCSRBuilder *b);
+RZ_API RZ_OWN RzGraphCSR *rz_graph_csr_new_from_graph(RZ_NONNULL const RzGraph *g);
+RZ_API void rz_graph_csr_free(RZ_NULLABLE RzGraphCSR *g);
+RZ_API ut32 rz_graph_csr_index(RZ_NONNULL const RzGraphCSR *g, RZ_NONNULL const RzGraphNode *n);
+RZ_API bool rz_graph_csr_adjacent(RZ_NONNULL const RzGraphCSR *g, ut32 from, ut32 to);
+RZ_API void rz_graph_csr_dfs_node(RZ_NONNULL const RzGraphCSR *g, ut32 n, RZ_NONNULL RzGraphCSRVisitor *vis);
+RZ_API void rz_graph_csr_dfs(RZ_NONNULL const RzGraphCSR *g, RZ_NONNULL RzGraphCSRVisitor *vis);
+
+static inline ut32 rz_graph_csr_out_degree(const RzGraphCSR *g, ut32 n) {
+	return g->out_off[n + 1] - g->out_off[n];
+}
+
+static inline const ut32 *rz_graph_csr_out_nodes(const RzGraphCSR *g, ut32 n) {
+	return g->out + g->out_off[n];
+}
+
+static inline ut32 rz_graph_csr_in_degree(const RzGraphCSR *g, ut32 n) {
+	return g->in_off[n + 1] - g->in_off[n];
+}
+
+static inline const ut32 *rz_graph_csr_in_nodes(const RzGraphCSR *g, ut32 n) {
+	return g->in + g->in_off[n];
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -41,6 +41,16 @@ RZ_API void rz_interval_tree_fini(RzIntervalTree *tree);
 // return false if the insertion failed.
 RZ_API bool rz_interval_tree_insert(RzIntervalTree *tree, ut64 start, ut64 end, void *data);
 
+typedef struct rz_interval_tree_entry_t {
+	ut64 start;
+	ut64 end;
+	void *data;
+} RzIntervalTreeEntry;
+
+// Insert many entries at once, in O(n) if the tree is empty and the entries are sorted by start.
+// return false if some insertion failed.
+RZ_API bool rz_interval_tree_bulk_load(RzIntervalTree *tree, const RzIntervalTreeEntry *entries, size_t count);
+
 // Removes a given node from the tree. The node will be freed.
 // If free is true, the data in the node is freed as well.
 // false if the removal failed
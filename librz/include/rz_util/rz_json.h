@@ -51,6 +51,7 @@ typedef struct rz_json_t {
 			size_t count;
 			struct rz_json_t *first;
 			struct rz_json_t *last;
+			void *index; // key lookup of big objects, built by the first rz_json_get() on them
 		} children;
 	};
 	struct rz_json_t *next; // points to next child
@@ -33,32 +33,37 @@ typedef enum rz_log_level {
 typedef void (*RzLogCallback)(const char *output, const char *funcname, const char *filename,
 	ut32 lineno, RzLogLevel level, const char *tag, const char *fmtstr, ...) RZ_PRINTF_CHECK(7, 8);
 
-#define RZ_VLOG(lvl, tag, fmtstr, args) rz_vlog(MACRO_LOG_FUNC, __FILE__, \
-	__LINE__, lvl, tag, fmtstr, args);
-
-#define RZ_LOG(lvl, tag, fmtstr, ...) rz_log(MACRO_LOG_FUNC, __FILE__, \
-	__LINE__, lvl, tag, fmtstr, ##__VA_ARGS__);
+/*
+ * The macros check the level before calling into rz_log(), so that disabled
+ * messages cost a single call and never evaluate their arguments.
+ */
+#define RZ_VLOG(lvl, tag, fmtstr, args) \
+	do { \
+		if (rz_log_level_enabled(lvl)) { \
+			rz_vlog(MACRO_LOG_FUNC, __FILE__, __LINE__, lvl, tag, fmtstr, args); \
+		} \
+	} while (0);
+
+#define RZ_LOG(lvl, tag, fmtstr, ...) \
+	do { \
+		if (rz_log_level_enabled(lvl)) { \
+			rz_log(MACRO_LOG_FUNC, __FILE__, __LINE__, lvl, tag, fmtstr, ##__VA_ARGS__); \
+		} \
+	} while (0);
 
 #if RZ_BUILD_DEBUG
-#define RZ_LOG_SILLY(fmtstr, ...) rz_log(MACRO_LOG_FUNC, __FILE__, \
-	__LINE__, RZ_LOGLVL_SILLY, NULL, fmtstr, ##__VA_ARGS__);
-#define RZ_LOG_DEBUG(fmtstr, ...) rz_log(MACRO_LOG_FUNC, __FILE__, \
-	__LINE__, RZ_LOGLVL_DEBUG, NULL, fmtstr, ##__VA_ARGS__);
+#define RZ_LOG_SILLY(fmtstr, ...) RZ_LOG(RZ_LOGLVL_SILLY, NULL, fmtstr, ##__VA_ARGS__)
+#define RZ_LOG_DEBUG(fmtstr, ...) RZ_LOG(RZ_LOGLVL_DEBUG, NULL, fmtstr, ##__VA_ARGS__)
 #else
 #define RZ_LOG_SILLY(fmtstr, ...)
 #define RZ_LOG_DEBUG(fmtstr, ...)
 #endif
 
-#define RZ_LOG_VERBOSE(fmtstr, ...) rz_log(MACRO_LOG_FUNC, __FILE__, \
-	__LINE__, RZ_LOGLVL_VERBOSE, NULL, fmtstr, ##__VA_ARGS__);
-#define RZ_LOG_INFO(fmtstr, ...) rz_log(MACRO_LOG_FUNC, __FILE__, \
-	__LINE__, RZ_LOGLVL_INFO, NULL, fmtstr, ##__VA_ARGS__);
-#define RZ_LOG_WARN(fmtstr, ...) rz_log(MACRO_LOG_FUNC, __FILE__, \
-	__LINE__, RZ_LOGLVL_WARN, NULL, fmtstr, ##__VA_ARGS__);
-#define RZ_LOG_ERROR(fmtstr, ...) rz_log(MACRO_LOG_FUNC, __FILE__, \
-	__LINE__, RZ_LOGLVL_ERROR, NULL, fmtstr, ##__VA_ARGS__);
-#define RZ_LOG_FATAL(fmtstr, ...) rz_log(MACRO_LOG_FUNC, __FILE__, \
-	__LINE__, RZ_LOGLVL_FATAL, NULL, fmtstr, ##__VA_ARGS__);
+#define RZ_LOG_VERBOSE(fmtstr, ...) RZ_LOG(RZ_LOGLVL_VERBOSE, NULL, fmtstr, ##__VA_ARGS__)
+#define RZ_LOG_INFO(fmtstr, ...)    RZ_LOG(RZ_LOGLVL_INFO, NULL, fmtstr, ##__VA_ARGS__)
+#define RZ_LOG_WARN(fmtstr, ...)    RZ_LOG(RZ_LOGLVL_WARN, NULL, fmtstr, ##__VA_ARGS__)
+#define RZ_LOG_ERROR(fmtstr, ...)   RZ_LOG(RZ_LOGLVL_ERROR, NULL, fmtstr, ##__VA_ARGS__)
+#define RZ_LOG_FATAL(fmtstr, ...)   RZ_LOG(RZ_LOGLVL_FATAL, NULL, fmtstr, ##__VA_ARGS__)
 
 #ifdef __cplusplus
 extern "C" {
@@ -70,6 +75,7 @@ RZ_API void rz_log_set_file(const char *filename);
 RZ_API void rz_log_set_srcinfo(bool show_info);
 RZ_API void rz_log_set_colors(bool show_colors);
 RZ_API void rz_log_set_traplevel(RzLogLevel level);
+RZ_API bool rz_log_level_enabled(RzLogLevel level);
 
 // Functions for adding log callbacks
 RZ_API void rz_log_add_callback(RzLogCallback cbfunc);
@@ -0,0 +1,59 @@
+#ifndef RZ_MEM_ACCOUNT_H
+#define RZ_MEM_ACCOUNT_H
+
+#include <rz_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Optional accounting of the memory held by the big subsystems, enabled at
+ * build time with -Dmem_accounting=true.
+ *
+ * Subsystems register the objects they allocate with RZ_MEM_TRACK() and
+ * unregister them with RZ_MEM_UNTRACK() right before freeing them. Sizes are
+ * the ones given when tracking, so the numbers are an estimate of what each
+ * subsystem keeps alive, not an exact heap profile. Untracking a pointer that
+ * was never tracked is a no-op, so objects allocated on paths that do not
+ * track them are simply not counted.
+ *
+ * All functions are thread-safe.
+ */
+
+typedef enum {
+	RZ_MEM_ACCOUNT_ANALYSIS = 0, ///< functions and basic blocks
+	RZ_MEM_ACCOUNT_BIN, ///< symbols, imports, sections and strings of loaded binaries
+	RZ_MEM_ACCOUNT_FLAG, ///< flag items
+	RZ_MEM_ACCOUNT_IO_CACHE, ///< io cache writes
+	RZ_MEM_ACCOUNT_CONS, ///< console output buffers
+	RZ_MEM_ACCOUNT_SDB, ///< sdb key/value pairs
+	RZ_MEM_ACCOUNT_COUNT
+} RzMemAccountCategory;
+
+typedef struct rz_mem_account_stats_t {
+	ut64 live_bytes;
+	ut64 live_objects;
+	ut64 peak_bytes;
+	ut64 total_objects; ///< objects tracked since the start, including the freed ones
+} RzMemAccountStats;
+
+RZ_API bool rz_mem_account_enabled(void);
+RZ_API const char *rz_mem_account_category_name(RzMemAccountCategory cat);
+RZ_API void rz_mem_account_track(RzMemAccountCategory cat, RZ_NULLABLE const void *ptr, size_t size);
+RZ_API void rz_mem_account_untrack(RZ_NULLABLE const void *ptr);
+RZ_API void rz_mem_account_stats(RzMemAccountCategory cat, RZ_NONNULL RZ_OUT RzMemAccountStats *stats);
+
+#if WITH_MEM_ACCOUNTING
+#define RZ_MEM_TRACK(cat, ptr, size) rz_mem_account_track(cat, ptr, size)
+#define RZ_MEM_UNTRACK(ptr)          rz_mem_account_untrack(ptr)
+#else
+#define RZ_MEM_TRACK(cat, ptr, size) ((void)0)
+#define RZ_MEM_UNTRACK(ptr)          ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RZ_MEM_ACCOUNT_H
@@ -9,18 +9,27 @@
 extern "C" {
 #endif
 
+/* receives the json text produced so far, see pj_set_sink() */
+typedef void (*PJSink)(void *user, const char *s, size_t len);
+
 typedef struct pj_t {
 	RzStrBuf sb;
 	bool is_first;
 	bool is_key;
 	char braces[RZ_PRINT_JSON_DEPTH_LIMIT];
 	int level;
+	PJSink sink;
+	void *sink_user;
+	size_t sink_threshold;
 } PJ;
 
 /* lifecycle */
 RZ_API PJ *pj_new(void);
 RZ_API void pj_free(PJ *j);
 RZ_API void pj_reset(PJ *j); // clear the pj contents, but keep the buffer allocated to re-use it
+RZ_API void pj_set_sink(RZ_NONNULL PJ *j, RZ_NULLABLE PJSink sink, void *user, size_t threshold);
+RZ_API void pj_flush(RZ_NONNULL PJ *j);
+RZ_API void pj_reserve(RZ_NONNULL PJ *j, size_t size);
 RZ_API char *pj_drain(PJ *j);
 /* encode the pj data as a string */
 RZ_API const char *pj_string(PJ *pj);
@@ -60,6 +60,7 @@ typedef struct rz_containing_rb_tree_t {
 RZ_API bool rz_rbtree_aug_delete(RBNode **root, void *data, RBComparator cmp, void *cmp_user, RBNodeFree freefn, void *free_user, RBNodeSum sum);
 RZ_API bool rz_rbtree_aug_insert(RBNode **root, void *data, RBNode *node, RBComparator cmp, void *cmp_user, RBNodeSum sum);
 RZ_API bool rz_rbtree_aug_update_sum(RBNode *root, void *data, RBNode *node, RBComparator cmp, void *cmp_user, RBNodeSum sum);
+RZ_API bool rz_rbtree_aug_bulk_load(RBNode **root, RBNode **nodes, size_t count, RBNodeSum sum);
 
 RZ_API bool rz_rbtree_delete(RBNode **root, void *data, RBComparator cmp, void *cmp_user, RBNodeFree freefn, void *free_user);
 RZ_API RBNode *rz_rbtree_find(RBNode *root, void *data, RBComparator cmp, void *user);
@@ -6,6 +6,9 @@
 
 #include <rz_util/rz_json.h>
 #include <rz_list.h>
+#include <rz_vector.h>
+#include <rz_th.h>
+#include <sdb.h>
 
 /**
  * \brief Detailed info about a (de)serialization result
@@ -132,4 +135,21 @@ static inline void rz_key_parser_add(RzKeyParser *parser, const char *key, int v
 		rip \
 	}
 
+/**
+ * \brief Entry of an sdb namespace with its value parsed as json
+ *
+ * Loading big namespaces is split in parsing all the values, which can be done
+ * in parallel, then installing them one after another in the iteration order of sdb.
+ */
+typedef struct rz_serialize_json_entry_t {
+	char *key;
+	char *json_str; ///< copy of the value, parsed in place
+	RzJson *json; ///< NULL if the value is not valid json
+	bool parsed;
+} RzSerializeJsonEntry;
+
+RZ_API bool rz_serialize_json_entries_init(RZ_NONNULL RZ_OUT RzVector /*<RzSerializeJsonEntry>*/ *entries, RZ_NONNULL Sdb *db);
+RZ_API void rz_serialize_json_entries_fini(RZ_NULLABLE RzVector /*<RzSerializeJsonEntry>*/ *entries);
+RZ_API void rz_serialize_json_entries_parse(RZ_NONNULL RzVector /*<RzSerializeJsonEntry>*/ **entries, size_t count, RZ_NULLABLE RzThreadTaskPool *pool);
+
 #endif // RZ_SERIALIZE_H
@@ -0,0 +1,45 @@
+#ifndef RZ_SLAB_H
+#define RZ_SLAB_H
+
+#include <rz_types.h>
+#include <rz_vector.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Allocator of fixed-size objects carved out of big chunks
+ *
+ * Freed objects are kept in a free list and handed out again by the next
+ * allocation, chunks are only released when the slab is freed.
+ */
+typedef struct rz_slab_t {
+	size_t elem_size; ///< size of each object, aligned to hold a pointer
+	size_t chunk_elems; ///< number of objects in each chunk
+	RzPVector /*<ut8 *>*/ chunks; ///< sorted by address
+	ut8 *last_chunk; ///< the most recently allocated chunk
+	void *free_list; ///< freed objects, each one holds the pointer to the next one
+	size_t fresh; ///< objects never handed out at the end of last_chunk
+	size_t used; ///< objects currently allocated
+} RzSlab;
+
+typedef struct rz_slab_stats_t {
+	size_t used; ///< objects currently allocated
+	size_t used_bytes; ///< bytes of the objects currently allocated
+	size_t reserved_bytes; ///< bytes of all the chunks
+	size_t chunks; ///< number of chunks
+} RzSlabStats;
+
+RZ_API RZ_OWN RzSlab *rz_slab_new(size_t elem_size, size_t chunk_elems);
+RZ_API void rz_slab_free(RZ_NULLABLE RzSlab *slab);
+RZ_API RZ_OWN void *rz_slab_alloc(RZ_NONNULL RzSlab *slab);
+RZ_API void rz_slab_release(RZ_NONNULL RzSlab *slab, RZ_NULLABLE void *ptr);
+RZ_API bool rz_slab_owns(RZ_NONNULL RzSlab *slab, RZ_NULLABLE const void *ptr);
+RZ_API void rz_slab_stats(RZ_NONNULL RzSlab *slab, RZ_NONNULL RzSlabStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RZ_SLAB_H
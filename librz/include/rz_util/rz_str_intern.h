@@ -0,0 +1,33 @@
+#ifndef RZ_STR_INTERN_H
+#define RZ_STR_INTERN_H
+
+#include <rz_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * RzStrIntern stores each distinct string once. Every rz_str_intern_get()
+ * returns the same pointer for equal strings and takes a reference, which is
+ * given back with rz_str_intern_put(). Interned strings can thus be compared
+ * by pointer and must never be modified nor freed directly.
+ *
+ * All functions are thread-safe.
+ */
+
+typedef struct rz_str_intern_t RzStrIntern;
+
+RZ_API RZ_OWN RzStrIntern *rz_str_intern_new(void);
+RZ_API void rz_str_intern_free(RZ_NULLABLE RzStrIntern *pool);
+RZ_API RZ_BORROW RzStrIntern *rz_str_intern_global(void);
+RZ_API RZ_NULLABLE const char *rz_str_intern_get(RZ_NONNULL RzStrIntern *pool, RZ_NULLABLE const char *str);
+RZ_API RZ_NULLABLE const char *rz_str_intern_ref(RZ_NONNULL RzStrIntern *pool, RZ_NULLABLE const char *str);
+RZ_API void rz_str_intern_put(RZ_NONNULL RzStrIntern *pool, RZ_NULLABLE const char *str);
+RZ_API size_t rz_str_intern_count(RZ_NONNULL RzStrIntern *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RZ_STR_INTERN_H
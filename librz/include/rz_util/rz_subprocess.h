@@ -49,6 +49,8 @@ typedef struct rz_process_output_t {
 	int ret;
 	///< True if the process has exited because of a timeout
 	bool timeout;
+	///< Peak resident set size of the sub-process in KiB, 0 if unknown
+	ut64 peak_rss;
 } RzSubprocessOutput;
 
 /**
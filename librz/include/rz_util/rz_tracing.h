@@ -0,0 +1,47 @@
+#ifndef RZ_TRACING_H
+#define RZ_TRACING_H
+
+#include <rz_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Scoped trace events of the whole process, exported in the Chrome trace
+ * event format understood by Perfetto and chrome://tracing.
+ *
+ * Nothing is recorded until rz_tracing_enable(), the RZ_TRACE_* macros only
+ * check a flag meanwhile. Each RZ_TRACE_BEGIN() must be followed by an
+ * RZ_TRACE_END() on the same thread. All functions are thread-safe.
+ */
+
+#define RZ_TRACING_MAX_EVENTS 0x100000 ///< events beyond this are dropped until rz_tracing_reset()
+
+RZ_API void rz_tracing_enable(bool enable);
+RZ_API bool rz_tracing_is_enabled(void);
+RZ_API void rz_tracing_begin(RZ_NONNULL const char *cat, RZ_NONNULL const char *name);
+RZ_API void rz_tracing_end(RZ_NONNULL const char *cat);
+RZ_API void rz_tracing_reset(void);
+RZ_API size_t rz_tracing_count(void);
+RZ_API RZ_OWN char *rz_tracing_to_json(void);
+
+#define RZ_TRACE_BEGIN(cat, name) \
+	do { \
+		if (rz_tracing_is_enabled()) { \
+			rz_tracing_begin(cat, name); \
+		} \
+	} while (0)
+
+#define RZ_TRACE_END(cat) \
+	do { \
+		if (rz_tracing_is_enabled()) { \
+			rz_tracing_end(cat); \
+		} \
+	} while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RZ_TRACING_H
@@ -32,6 +32,15 @@ static st64 on_map_skyline(RzIO *io, ut64 vaddr, ut8 *buf, int len, int match_fl
 	ut64 addr = vaddr;
 	size_t i;
 	bool ret = true, wrap = !prefix_mode && vaddr + len < vaddr;
+	RzSkylineItem hit;
+	// fast path, all in a single recently used part
+	if (len > 0 && io_map_lookup(io, vaddr, &hit) && (ut64)len - 1 <= hit.itv.size - 1 - (vaddr - hit.itv.addr)) {
+		RzIOMap *map = hit.user;
+		if ((map->perm & match_flg) == match_flg || io->p_cache) {
+			st64 result = op(io, map->fd, map->delta + vaddr - map->itv.addr, buf, len, map, NULL);
+			return prefix_mode ? result : result == len;
+		}
+	}
 #define CMP(addr, part) ((addr) < rz_itv_end(((RzSkylineItem *)(part))->itv) - 1 ? -1 : (addr) > rz_itv_end(((RzSkylineItem *)(part))->itv) - 1 ? 1 \
 																		: 0)
 	// Let i be the first skyline part whose right endpoint > addr
@@ -116,8 +125,10 @@ RZ_API RzIO *rz_io_init(RzIO *io) {
 	io->addrbytes = 1;
 	rz_io_desc_init(io);
 	rz_skyline_init(&io->map_skyline);
+	memset(&io->map_cache, 0, sizeof(io->map_cache));
 	rz_io_map_init(io);
 	rz_io_cache_init(io);
+	rz_io_page_cache_init(io);
 	rz_io_plugin_init(io);
 	io->event = rz_event_new(io);
 	return io;
@@ -259,10 +270,12 @@ RZ_API int rz_io_close_all(RzIO *io) { // what about undo?
 	if (!io) {
 		return false;
 	}
+	rz_io_readahead_stop(io);
 	rz_io_desc_fini(io);
 	rz_io_map_reset(io);
 	rz_io_desc_init(io);
 	rz_io_cache_fini(io);
+	rz_io_page_cache_clear(io);
 	return true;
 }
 
@@ -279,6 +292,65 @@ RZ_API int rz_io_pwrite_at(RzIO *io, ut64 paddr, const ut8 *buf, int len) {
 	return rz_io_desc_write_at(io->desc, paddr, buf, len);
 }
 
+/**
+ * \brief Get a pointer to the data at \p addr without copying it
+ *
+ * This is the zero-copy counterpart of rz_io_read_at(): it only succeeds
+ * when the data is held contiguously in memory by the io plugin (e.g. a
+ * mmap'd file) and is not shadowed by io.cache. In virtual mode the
+ * returned range never spans more than one map. The pointer is valid
+ * until the next write, map change or close of the underlying desc.
+ *
+ * \param len In: number of bytes wanted. Out: number of bytes available at the returned pointer, never more than requested
+ * \return The pointer, or NULL if the data can't be borrowed and must be read with rz_io_read_at()
+ */
+RZ_API RZ_BORROW const ut8 *rz_io_borrow_at(RZ_NONNULL RzIO *io, ut64 addr, RZ_NONNULL RZ_INOUT ut64 *len) {
+	rz_return_val_if_fail(io && len, NULL);
+	if (!*len) {
+		return NULL;
+	}
+	ut64 want = *len;
+	if (addr + want < addr && addr + want) {
+		// don't wrap around the address space
+		want = UT64_MAX - addr + 1;
+	}
+	if (io->cached & RZ_PERM_R) {
+		const RzIOCache *cache = io_cache_first_after(io, addr);
+		if (cache) {
+			if (rz_itv_begin(cache->itv) <= addr) {
+				return NULL;
+			}
+			want = RZ_MIN(want, rz_itv_begin(cache->itv) - addr);
+		}
+	}
+	RzIODesc *desc = io->desc;
+	ut64 paddr = addr;
+	if (io->va) {
+		RzSkylineItem part;
+		if (!io_map_lookup(io, addr, &part)) {
+			return NULL;
+		}
+		RzIOMap *map = part.user;
+		if (!(map->perm & RZ_PERM_R)) {
+			return NULL;
+		}
+		ut64 end = rz_itv_end(part.itv);
+		if (end && end - addr < want) {
+			want = end - addr;
+		}
+		paddr = map->delta + addr - map->itv.addr;
+		desc = rz_io_desc_get(io, map->fd);
+	}
+	if (!desc) {
+		return NULL;
+	}
+	const ut8 *ret = rz_io_desc_borrow_at(desc, paddr, &want);
+	if (ret) {
+		*len = want;
+	}
+	return ret;
+}
+
 // Returns true iff all reads on mapped regions are successful and complete.
 RZ_API bool rz_io_vread_at_mapped(RzIO *io, ut64 vaddr, ut8 *buf, int len) {
 	rz_return_val_if_fail(io && buf && len > 0, false);
@@ -302,9 +374,13 @@ RZ_API bool rz_io_read_at(RzIO *io, ut64 addr, ut8 *buf, int len) {
 	if (len == 0) {
 		return false;
 	}
-	bool ret = (io->va)
-		? rz_io_vread_at_mapped(io, addr, buf, len)
-		: rz_io_pread_at(io, addr, buf, len) > 0;
+	io->read_bytes += len;
+	bool ret;
+	if (!io->readahead || !io_readahead_read(io->readahead, addr, buf, len, &ret)) {
+		ret = (io->va)
+			? rz_io_vread_at_mapped(io, addr, buf, len)
+			: rz_io_pread_at(io, addr, buf, len) > 0;
+	}
 	if (io->cached & RZ_PERM_R) {
 		(void)rz_io_cache_read(io, addr, buf, len);
 	}
@@ -318,13 +394,16 @@ RZ_API bool rz_io_read_at(RzIO *io, ut64 addr, ut8 *buf, int len) {
 RZ_API bool rz_io_read_at_mapped(RzIO *io, ut64 addr, ut8 *buf, int len) {
 	bool ret;
 	rz_return_val_if_fail(io && buf, false);
-	if (io->ff) {
-		memset(buf, io->Oxff, len);
-	}
-	if (io->va) {
-		ret = on_map_skyline(io, addr, buf, len, RZ_PERM_R, fd_read_at_wrap, false);
-	} else {
-		ret = rz_io_pread_at(io, addr, buf, len) > 0;
+	io->read_bytes += len;
+	if (!io->readahead || !io_readahead_read(io->readahead, addr, buf, len, &ret)) {
+		if (io->ff) {
+			memset(buf, io->Oxff, len);
+		}
+		if (io->va) {
+			ret = on_map_skyline(io, addr, buf, len, RZ_PERM_R, fd_read_at_wrap, false);
+		} else {
+			ret = rz_io_pread_at(io, addr, buf, len) > 0;
+		}
 	}
 	if (io->cached & RZ_PERM_R) {
 		(void)rz_io_cache_read(io, addr, buf, len);
@@ -341,6 +420,7 @@ RZ_API int rz_io_nread_at(RzIO *io, ut64 addr, ut8 *buf, int len) {
 	if (len == 0) {
 		return 0;
 	}
+	io->read_bytes += len;
 	if (io->va) {
 		if (io->ff) {
 			memset(buf, io->Oxff, len);
@@ -355,6 +435,230 @@ RZ_API int rz_io_nread_at(RzIO *io, ut64 addr, ut8 *buf, int len) {
 	return ret;
 }
 
+#define IO_READV_GAP  64 ///< ranges closer than this are read with a single call
+#define IO_READV_SPAN 0x10000 ///< unless the merged read would get bigger than this
+
+typedef struct {
+	ut64 addr;
+	int len;
+	ut8 *buf; ///< the buffer of the range if the span has only one, owned otherwise
+	size_t first; ///< index of the first range of the span in the sorted array
+	size_t count;
+	bool in_part; ///< io.va and the span lies entirely inside part
+	RzSkylineItem part;
+	bool ok;
+} IOReadvSpan;
+
+typedef struct {
+	RzIODesc *desc;
+	RzIOVec vec; ///< physical range
+	size_t span;
+} IOReadvBatch;
+
+static int readv_vec_cmp(const void *a, const void *b) {
+	const RzIOVec *va = *(const RzIOVec **)a;
+	const RzIOVec *vb = *(const RzIOVec **)b;
+	return va->addr < vb->addr ? -1 : va->addr > vb->addr;
+}
+
+static int readv_batch_cmp(const void *a, const void *b) {
+	const IOReadvBatch *ba = a, *bb = b;
+	if (ba->desc->fd != bb->desc->fd) {
+		return ba->desc->fd < bb->desc->fd ? -1 : 1;
+	}
+	return ba->vec.addr < bb->vec.addr ? -1 : ba->vec.addr > bb->vec.addr;
+}
+
+static bool readv_in_part(const IOReadvSpan *span, ut64 end) {
+	return span->in_part && end - 1 <= rz_itv_end(span->part.itv) - 1;
+}
+
+// Whether the range [addr, end) can be read together with the span
+static bool readv_extends(RzIO *io, const IOReadvSpan *span, ut64 addr, ut64 end) {
+	ut64 span_end = span->addr + span->len;
+	if (span_end <= span->addr) {
+		// reaches the top of the address space
+		return false;
+	}
+	if (RZ_MAX(end, span_end) - span->addr > IO_READV_SPAN) {
+		return false;
+	}
+	if (addr <= span_end) {
+		return true;
+	}
+	if (addr - span_end > IO_READV_GAP) {
+		return false;
+	}
+	// don't let the gap pull in other maps, which may not be readable
+	return !io->va || readv_in_part(span, end);
+}
+
+static size_t readv_coalesce(RzIO *io, const RzIOVec **sorted, size_t count, IOReadvSpan *spans) {
+	IOReadvSpan *span = NULL;
+	size_t nspans = 0;
+	for (size_t i = 0; i < count; i++) {
+		const RzIOVec *vec = sorted[i];
+		ut64 end = vec->addr + vec->len;
+		if (span && end > vec->addr && readv_extends(io, span, vec->addr, end)) {
+			end = RZ_MAX(end, span->addr + span->len);
+			span->in_part = readv_in_part(span, end);
+			span->len = end - span->addr;
+			span->count++;
+			continue;
+		}
+		span = &spans[nspans++];
+		span->addr = vec->addr;
+		span->len = vec->len;
+		span->first = i;
+		span->count = 1;
+		span->in_part = io->va && end > vec->addr && io_map_lookup(io, vec->addr, &span->part);
+		span->in_part = readv_in_part(span, end);
+	}
+	return nspans;
+}
+
+// Returns the desc whose readv callback can read the span, at *paddr
+static RzIODesc *readv_desc(RzIO *io, const IOReadvSpan *span, ut64 *paddr) {
+	RzIODesc *desc = io->desc;
+	*paddr = span->addr;
+	if (io->va) {
+		RzIOMap *map = span->part.user;
+		if (!span->in_part || !(map->perm & RZ_PERM_R)) {
+			return NULL;
+		}
+		desc = rz_io_desc_get(io, map->fd);
+		*paddr = map->delta + span->addr - map->itv.addr;
+	}
+	if (!desc || !desc->plugin || !desc->plugin->readv || !(desc->perm & RZ_PERM_R)) {
+		return NULL;
+	}
+	if (io->cachemode || io->p_cache || rz_io_page_cache_usable(io, desc) || *paddr + span->len <= *paddr) {
+		return NULL;
+	}
+	return desc;
+}
+
+static bool readv_span(RzIO *io, IOReadvSpan *span) {
+	if (io->ff) {
+		memset(span->buf, io->Oxff, span->len);
+	}
+	if (io->va) {
+		return on_map_skyline(io, span->addr, span->buf, span->len, RZ_PERM_R, fd_read_at_wrap, false);
+	}
+	return rz_io_pread_at(io, span->addr, span->buf, span->len) == span->len;
+}
+
+// Hands all the spans of each desc to its readv callback at once
+static void readv_dispatch(RzIO *io, RzVector *batch, IOReadvSpan *spans) {
+	size_t n = rz_vector_len(batch);
+	if (!n) {
+		return;
+	}
+	rz_vector_sort(batch, readv_batch_cmp, false);
+	RzIOVec *vecs = RZ_NEWS(RzIOVec, n);
+	size_t i = 0;
+	while (i < n) {
+		IOReadvBatch *first = rz_vector_index_ptr(batch, i);
+		size_t j;
+		for (j = i; j < n; j++) {
+			IOReadvBatch *b = rz_vector_index_ptr(batch, j);
+			if (b->desc != first->desc) {
+				break;
+			}
+			if (vecs) {
+				vecs[j - i] = b->vec;
+			}
+		}
+		bool ok = vecs && first->desc->plugin->readv(io, first->desc, vecs, j - i);
+		for (; i < j; i++) {
+			IOReadvSpan *span = &spans[((IOReadvBatch *)rz_vector_index_ptr(batch, i))->span];
+			// on failure, fall back to reading the spans one by one
+			span->ok = ok || readv_span(io, span);
+		}
+	}
+	free(vecs);
+}
+
+/**
+ * \brief Read many ranges at once
+ *
+ * The ranges are sorted and coalesced when they overlap or lie close to
+ * each other in the same map, so each contiguous span goes through the
+ * map/plugin stack with a single call. The spans of plugins implementing
+ * RzIOPlugin.readv are all handed to it together, which lets remote plugins
+ * answer them in a single round trip.
+ *
+ * As with rz_io_read_at_mapped(), unmapped bytes are filled with io.Oxff if
+ * io.ff is set, and io.cache is applied on top.
+ *
+ * \param vecs Ranges to read, in any order, possibly overlapping
+ * \return true iff all reads on mapped regions were successful and complete
+ */
+RZ_API bool rz_io_readv(RZ_NONNULL RzIO *io, RZ_NONNULL const RzIOVec *vecs, size_t n) {
+	rz_return_val_if_fail(io && vecs, false);
+	for (size_t i = 0; i < n; i++) {
+		rz_return_val_if_fail(vecs[i].len >= 0 && (vecs[i].buf || !vecs[i].len), false);
+	}
+	const RzIOVec **sorted = RZ_NEWS(const RzIOVec *, RZ_MAX(n, 1));
+	IOReadvSpan *spans = RZ_NEWS0(IOReadvSpan, RZ_MAX(n, 1));
+	if (!sorted || !spans) {
+		free(sorted);
+		free(spans);
+		return false;
+	}
+	size_t count = 0;
+	for (size_t i = 0; i < n; i++) {
+		if (vecs[i].len) {
+			sorted[count++] = &vecs[i];
+			io->read_bytes += vecs[i].len;
+		}
+	}
+	qsort(sorted, count, sizeof(*sorted), readv_vec_cmp);
+	size_t nspans = readv_coalesce(io, sorted, count, spans);
+
+	bool ret = true;
+	RzVector batch;
+	rz_vector_init(&batch, sizeof(IOReadvBatch), NULL, NULL);
+	for (size_t i = 0; i < nspans; i++) {
+		IOReadvSpan *span = &spans[i];
+		span->buf = span->count == 1 ? sorted[span->first]->buf : malloc(span->len);
+		if (!span->buf) {
+			ret = false;
+			goto beach;
+		}
+		IOReadvBatch b = { .vec = { .buf = span->buf, .len = span->len }, .span = i };
+		b.desc = readv_desc(io, span, &b.vec.addr);
+		if (!b.desc) {
+			span->ok = readv_span(io, span);
+		} else if (!rz_vector_push(&batch, &b)) {
+			ret = false;
+			goto beach;
+		}
+	}
+	readv_dispatch(io, &batch, spans);
+	for (size_t i = 0; i < nspans; i++) {
+		IOReadvSpan *span = &spans[i];
+		if (io->cached & RZ_PERM_R) {
+			(void)rz_io_cache_read(io, span->addr, span->buf, span->len);
+		}
+		ret &= span->ok;
+		for (size_t j = 0; span->count > 1 && j < span->count; j++) {
+			const RzIOVec *vec = sorted[span->first + j];
+			memcpy(vec->buf, span->buf + (vec->addr - span->addr), vec->len);
+		}
+	}
+beach:
+	for (size_t i = 0; i < nspans; i++) {
+		if (spans[i].count > 1) {
+			free(spans[i].buf);
+		}
+	}
+	rz_vector_fini(&batch);
+	free(sorted);
+	free(spans);
+	return ret;
+}
+
 RZ_API bool rz_io_write_at(RzIO *io, ut64 addr, const ut8 *buf, int len) {
 	int i;
 	bool ret = false;
@@ -369,10 +673,12 @@ RZ_API bool rz_io_write_at(RzIO *io, ut64 addr, const ut8 *buf, int len) {
 	}
 	if (io->cached & RZ_PERM_W) {
 		ret = rz_io_cache_write(io, addr, mybuf, len);
-	} else if (io->va) {
-		ret = rz_io_vwrite_at(io, addr, mybuf, len);
 	} else {
-		ret = rz_io_pwrite_at(io, addr, mybuf, len) > 0;
+		if (io->va) {
+			ret = rz_io_vwrite_at(io, addr, mybuf, len);
+		} else {
+			ret = rz_io_pwrite_at(io, addr, mybuf, len) > 0;
+		}
 	}
 	if (buf != mybuf) {
 		free(mybuf);
@@ -410,6 +716,8 @@ RZ_API bool rz_io_is_listener(RzIO *io) {
 
 RZ_API char *rz_io_system(RzIO *io, const char *cmd) {
 	if (io && io->desc && io->desc->plugin && io->desc->plugin->system && RZ_STR_ISNOTEMPTY(cmd)) {
+		// plugin commands may change the underlying data behind our back
+		rz_io_page_cache_invalidate_fd(io, io->desc->fd);
 		return io->desc->plugin->system(io, io->desc, cmd);
 	}
 	return NULL;
@@ -578,6 +886,8 @@ RZ_API void rz_io_bind(RzIO *io, RzIOBind *bnd) {
 	bnd->fd_get_map = rz_io_map_get_for_fd;
 	bnd->fd_remap = rz_io_map_remap_fd;
 	bnd->fd_getbuf = rz_io_fd_get_buf;
+	bnd->fd_borrow_at = rz_io_fd_borrow_at;
+	bnd->borrow_at = rz_io_borrow_at;
 	bnd->is_valid_offset = rz_io_is_valid_offset;
 	bnd->map_get = rz_io_map_get;
 	bnd->map_get_paddr = rz_io_map_get_paddr;
@@ -725,11 +1035,13 @@ RZ_API int rz_io_fini(RzIO *io) {
 	if (!io) {
 		return false;
 	}
+	rz_io_readahead_stop(io);
 	rz_io_desc_cache_fini_all(io);
 	rz_io_desc_fini(io);
 	rz_io_map_fini(io);
 	rz_list_free(io->plugins);
 	rz_io_cache_fini(io);
+	rz_io_page_cache_fini(io);
 	if (io->runprofile) {
 		RZ_FREE(io->runprofile);
 	}
@@ -2,127 +2,298 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <rz_io.h>
-#include <rz_skyline.h>
+#include "io_private.h"
+
+/**
+ * \file io_cache.c
+ * io.cache write cache.
+ *
+ * Writes are coalesced into extents kept in an RB-tree sorted by address.
+ * Extents never overlap nor touch each other: a write overlapping or
+ * adjacent to existing extents is merged with them into a single one, so
+ * each byte has exactly one cached value and one original value (odata),
+ * whatever the number of writes done to it.
+ */
 
 static void cache_item_free(RzIOCache *cache) {
 	if (!cache) {
 		return;
 	}
+	RZ_MEM_UNTRACK(cache);
 	free(cache->data);
 	free(cache->odata);
 	free(cache);
 }
 
+static void cache_node_free(RBNode *node, void *user) {
+	cache_item_free(container_of(node, RzIOCache, rb));
+}
+
+static void cache_tree_free(void *tree) {
+	rz_rbtree_free(tree, cache_node_free, NULL);
+}
+
+static int cache_cmp(const void *incoming, const RBNode *in_tree, void *user) {
+	const RzIOCache *a = incoming;
+	const RzIOCache *b = container_of(in_tree, const RzIOCache, rb);
+	if (rz_itv_begin(a->itv) < rz_itv_begin(b->itv)) {
+		return -1;
+	}
+	return rz_itv_begin(a->itv) > rz_itv_begin(b->itv) ? 1 : 0;
+}
+
+static int cache_addr_cmp(const void *incoming, const RBNode *in_tree, void *user) {
+	const ut64 addr = *(const ut64 *)incoming;
+	const RzIOCache *c = container_of(in_tree, const RzIOCache, rb);
+	if (addr < rz_itv_begin(c->itv)) {
+		return -1;
+	}
+	return addr >= rz_itv_end(c->itv) ? 1 : 0;
+}
+
+/**
+ * \brief Get the first cache extent ending after \p addr, i.e. either the one containing \p addr or the next one
+ */
+RzIOCache *io_cache_first_after(RzIO *io, ut64 addr) {
+	RBNode *node = rz_rbtree_lower_bound(io->cache, &addr, cache_addr_cmp, NULL);
+	return node ? container_of(node, RzIOCache, rb) : NULL;
+}
+
+static void cache_delete(RzIO *io, RzIOCache *c) {
+	ut64 addr = rz_itv_begin(c->itv);
+	rz_rbtree_delete(&io->cache, &addr, cache_addr_cmp, NULL, cache_node_free, NULL);
+}
+
+static RzIOCache *cache_item_dup(const RzIOCache *c) {
+	RzIOCache *dup = RZ_NEW0(RzIOCache);
+	if (!dup) {
+		return NULL;
+	}
+	dup->itv = c->itv;
+	dup->written = c->written;
+	dup->data = rz_mem_dup(c->data, rz_itv_size(c->itv));
+	dup->odata = rz_mem_dup(c->odata, rz_itv_size(c->itv));
+	if (!dup->data || !dup->odata) {
+		cache_item_free(dup);
+		return NULL;
+	}
+	RZ_MEM_TRACK(RZ_MEM_ACCOUNT_IO_CACHE, dup, sizeof(RzIOCache) + 2 * rz_itv_size(dup->itv));
+	return dup;
+}
+
 RZ_API bool rz_io_cache_at(RzIO *io, ut64 addr) {
 	rz_return_val_if_fail(io, false);
-	return rz_skyline_contains(&io->cache_skyline, addr);
+	RzIOCache *c = io_cache_first_after(io, addr);
+	return c && rz_itv_begin(c->itv) <= addr;
 }
 
 RZ_API void rz_io_cache_init(RzIO *io) {
 	rz_return_if_fail(io);
-	rz_pvector_init(&io->cache, (RzPVectorFree)cache_item_free);
-	rz_skyline_init(&io->cache_skyline);
+	io->cache = NULL;
+	rz_pvector_init(&io->cache_stack, cache_tree_free);
 	io->cached = 0;
 }
 
 RZ_API void rz_io_cache_fini(RzIO *io) {
 	rz_return_if_fail(io);
-	rz_pvector_fini(&io->cache);
-	rz_skyline_fini(&io->cache_skyline);
+	cache_tree_free(io->cache);
+	io->cache = NULL;
+	rz_pvector_fini(&io->cache_stack);
 	io->cached = 0;
 }
 
+/**
+ * \brief Write the cached data overlapping [from, to) to the underlying io
+ *
+ * Every extent is written with a single call, in address order.
+ */
 RZ_API void rz_io_cache_commit(RzIO *io, ut64 from, ut64 to) {
-	void **iter;
-	RzIOCache *c;
-	RzInterval range = (RzInterval){ from, to - from };
 	rz_return_if_fail(io);
-	rz_pvector_foreach (&io->cache, iter) {
-		// if (from <= c->to - 1 && c->from <= to - 1) {
-		c = *iter;
-		if (rz_itv_overlap(c->itv, range)) {
-			int cached = io->cached;
-			io->cached = 0;
-			if (rz_io_write_at(io, rz_itv_begin(c->itv), c->data, rz_itv_size(c->itv))) {
-				c->written = true;
-			} else {
-				eprintf("Error writing change at 0x%08" PFMT64x "\n", rz_itv_begin(c->itv));
-			}
-			io->cached = cached;
-			// break; // XXX old behavior, revisit this
+	RzInterval range = (RzInterval){ from, to - from };
+	const int cached = io->cached;
+	io->cached = 0;
+	RBIter it = rz_rbtree_lower_bound_forward(io->cache, &from, cache_addr_cmp, NULL);
+	RzIOCache *c;
+	rz_rbtree_iter_while (it, c, RzIOCache, rb) {
+		if (!rz_itv_overlap(c->itv, range)) {
+			break;
+		}
+		if (rz_io_write_at(io, rz_itv_begin(c->itv), c->data, rz_itv_size(c->itv))) {
+			c->written = true;
+		} else {
+			eprintf("Error writing change at 0x%08" PFMT64x "\n", rz_itv_begin(c->itv));
 		}
 	}
+	io->cached = cached;
 }
 
 RZ_API void rz_io_cache_reset(RzIO *io, int set) {
 	rz_return_if_fail(io);
 	io->cached = set;
-	rz_pvector_clear(&io->cache);
-	rz_skyline_clear(&io->cache_skyline);
+	cache_tree_free(io->cache);
+	io->cache = NULL;
 }
 
+/**
+ * \brief Drop the cache extents overlapping [from, to), restoring their original data
+ *
+ * \return the number of extents dropped
+ */
 RZ_API int rz_io_cache_invalidate(RzIO *io, ut64 from, ut64 to) {
 	rz_return_val_if_fail(io, 0);
 	int invalidated = 0;
-	void **iter;
-	RzIOCache *c;
 	RzInterval range = (RzInterval){ from, to - from };
-	rz_pvector_foreach_prev(&io->cache, iter) {
-		c = *iter;
-		if (rz_itv_overlap(c->itv, range)) {
-			int cached = io->cached;
-			io->cached = 0;
-			rz_io_write_at(io, rz_itv_begin(c->itv), c->odata, rz_itv_size(c->itv));
-			io->cached = cached;
-			c->written = false;
-			rz_pvector_remove_data(&io->cache, c);
-			free(c->data);
-			free(c->odata);
-			free(c);
-			invalidated++;
+	RzIOCache *c;
+	ut64 cur = from;
+	while ((c = io_cache_first_after(io, cur)) && rz_itv_overlap(c->itv, range)) {
+		const int cached = io->cached;
+		io->cached = 0;
+		rz_io_write_at(io, rz_itv_begin(c->itv), c->odata, rz_itv_size(c->itv));
+		io->cached = cached;
+		cur = rz_itv_end(c->itv);
+		cache_delete(io, c);
+		invalidated++;
+	}
+	return invalidated;
+}
+
+/**
+ * \brief Save the current cache contents, to be restored by rz_io_cache_pop()
+ *
+ * Writes done in between are dropped by the pop, so code can be emulated
+ * with io.cache enabled without leaving anything behind.
+ */
+RZ_API bool rz_io_cache_push(RzIO *io) {
+	rz_return_val_if_fail(io, false);
+	RBTree copy = NULL;
+	RBIter it;
+	RzIOCache *c;
+	rz_rbtree_foreach (io->cache, it, c, RzIOCache, rb) {
+		RzIOCache *dup = cache_item_dup(c);
+		if (!dup) {
+			cache_tree_free(copy);
+			return false;
 		}
+		rz_rbtree_insert(&copy, dup, &dup->rb, cache_cmp, NULL);
 	}
-	rz_skyline_clear(&io->cache_skyline);
-	rz_pvector_foreach (&io->cache, iter) {
-		c = *iter;
-		rz_skyline_add(&io->cache_skyline, c->itv, c);
+	if (!rz_pvector_push(&io->cache_stack, copy)) {
+		cache_tree_free(copy);
+		return false;
 	}
-	return invalidated;
+	return true;
+}
+
+/**
+ * \brief Restore the cache contents saved by the last rz_io_cache_push()
+ */
+RZ_API bool rz_io_cache_pop(RzIO *io) {
+	rz_return_val_if_fail(io, false);
+	if (rz_pvector_empty(&io->cache_stack)) {
+		return false;
+	}
+	cache_tree_free(io->cache);
+	io->cache = rz_pvector_pop(&io->cache_stack);
+	return true;
+}
+
+static void cache_read_original(RzIO *io, ut64 addr, ut8 *buf, ut64 len) {
+	const bool cm = io->cachemode;
+	io->cachemode = false;
+	memset(buf, 0, len);
+	rz_io_read_at(io, addr, buf, (int)len);
+	io->cachemode = cm;
 }
 
 RZ_API bool rz_io_cache_write(RzIO *io, ut64 addr, const ut8 *buf, int len) {
 	rz_return_val_if_fail(io && buf, false);
-	RzIOCache *ch = RZ_NEW0(RzIOCache);
-	if (!ch) {
-		return false;
+	if (len < 1) {
+		return !len;
 	}
 	if (UT64_ADD_OVFCHK(addr, len)) {
 		const ut64 first_len = UT64_MAX - addr;
 		rz_io_cache_write(io, 0, buf + first_len, len - first_len);
 		len = first_len;
 	}
-	ch->itv = (RzInterval){ addr, len };
-	ch->odata = (ut8 *)calloc(1, len + 1);
-	if (!ch->odata) {
-		free(ch);
-		return false;
+	const ut64 end = addr + len;
+	// first extent overlapping or touching [addr, end)
+	RzIOCache *first = io_cache_first_after(io, addr ? addr - 1 : 0);
+	if (first && rz_itv_begin(first->itv) > end) {
+		first = NULL;
 	}
-	ch->data = (ut8 *)calloc(1, len + 1);
-	if (!ch->data) {
-		free(ch->odata);
-		free(ch);
+	RzIOCache *ext;
+	if (first && rz_itv_begin(first->itv) <= addr && rz_itv_end(first->itv) >= end) {
+		// rewriting already cached bytes, e.g. patching the same code again
+		ext = first;
+		goto write;
+	}
+	ut64 begin = addr;
+	ut64 merged_end = end;
+	if (first) {
+		begin = RZ_MIN(begin, rz_itv_begin(first->itv));
+		RBIter it = rz_rbtree_lower_bound_forward(io->cache, &begin, cache_addr_cmp, NULL);
+		RzIOCache *c;
+		rz_rbtree_iter_while (it, c, RzIOCache, rb) {
+			if (rz_itv_begin(c->itv) > end) {
+				break;
+			}
+			merged_end = RZ_MAX(merged_end, rz_itv_end(c->itv));
+		}
+	}
+	const ut64 size = merged_end - begin;
+	if (size > SIZE_MAX) {
 		return false;
 	}
-	ch->written = false;
-	{
-		const bool cm = io->cachemode;
-		io->cachemode = false;
-		rz_io_read_at(io, addr, ch->odata, len);
-		io->cachemode = cm;
+	ut64 cur;
+	if (first && rz_itv_begin(first->itv) == begin) {
+		// grow the first extent in place, which keeps sequential writes cheap
+		ext = first;
+		ut8 *data = realloc(ext->data, size);
+		if (!data) {
+			return false;
+		}
+		ext->data = data;
+		ut8 *odata = realloc(ext->odata, size);
+		if (!odata) {
+			return false;
+		}
+		ext->odata = odata;
+		cur = rz_itv_end(ext->itv);
+	} else {
+		ext = RZ_NEW0(RzIOCache);
+		if (!ext) {
+			return false;
+		}
+		ext->data = malloc(size);
+		ext->odata = malloc(size);
+		if (!ext->data || !ext->odata) {
+			cache_item_free(ext);
+			return false;
+		}
+		cur = begin;
+	}
+	// move the merged extents into ext, reading the original data of the gaps in between
+	while (cur < merged_end) {
+		RzIOCache *next = io_cache_first_after(io, cur);
+		const ut64 gap_end = next && rz_itv_begin(next->itv) < merged_end ? rz_itv_begin(next->itv) : merged_end;
+		if (gap_end > cur) {
+			cache_read_original(io, cur, ext->odata + (cur - begin), gap_end - cur);
+			cur = gap_end;
+			continue;
+		}
+		const ut64 next_size = rz_itv_size(next->itv);
+		memcpy(ext->data + (cur - begin), next->data, next_size);
+		memcpy(ext->odata + (cur - begin), next->odata, next_size);
+		cur += next_size;
+		cache_delete(io, next);
+	}
+	ext->itv = (RzInterval){ begin, size };
+	RZ_MEM_TRACK(RZ_MEM_ACCOUNT_IO_CACHE, ext, sizeof(RzIOCache) + 2 * size);
+	if (ext != first) {
+		rz_rbtree_insert(&io->cache, ext, &ext->rb, cache_cmp, NULL);
 	}
-	memcpy(ch->data, buf, len);
-	rz_pvector_push(&io->cache, ch);
-	rz_skyline_add(&io->cache_skyline, ch->itv, ch);
+write:
+	memcpy(ext->data + (addr - rz_itv_begin(ext->itv)), buf, len);
+	ext->written = false;
 	RzEventIOWrite iow = { addr, buf, len };
 	rz_event_send(io->event, RZ_EVENT_IO_WRITE, &iow);
 	return true;
@@ -130,7 +301,6 @@ RZ_API bool rz_io_cache_write(RzIO *io, ut64 addr, const ut8 *buf, int len) {
 
 RZ_API bool rz_io_cache_read(RzIO *io, ut64 addr, ut8 *buf, int len) {
 	rz_return_val_if_fail(io && buf, false);
-	RzSkyline *skyline = &io->cache_skyline;
 	if (!len) {
 		return true;
 	}
@@ -139,31 +309,19 @@ RZ_API bool rz_io_cache_read(RzIO *io, ut64 addr, ut8 *buf, int len) {
 		rz_io_cache_read(io, 0, buf + first_len, len - first_len);
 		len = first_len;
 	}
-	const RzSkylineItem *iter = rz_skyline_get_item_intersect(skyline, addr, len);
-	if (!iter) {
-		return false;
-	}
-	const RzSkylineItem *last = (RzSkylineItem *)skyline->v.a + skyline->v.len;
+	const ut64 end = addr + len;
 	bool covered = false;
-	while (iter != last) {
-		const ut64 begin = rz_itv_begin(iter->itv);
-		const st64 addr_offset = begin - addr;
-		const ut64 buf_offset = addr_offset > 0 ? addr_offset : 0;
-		const ut64 cur_addr = addr + buf_offset;
-		const ut64 left = len - buf_offset;
-		if (begin > cur_addr + left) {
+	RBIter it = rz_rbtree_lower_bound_forward(io->cache, &addr, cache_addr_cmp, NULL);
+	RzIOCache *c;
+	rz_rbtree_iter_while (it, c, RzIOCache, rb) {
+		const ut64 begin = rz_itv_begin(c->itv);
+		if (begin >= end) {
 			break;
 		}
-		RzIOCache *cache = iter->user;
-		const ut64 cache_shift = addr_offset < 0 ? -addr_offset : 0;
-		const ut64 cache_offset = begin - rz_itv_begin(cache->itv) + cache_shift;
-		const ut64 read = RZ_MIN(left, rz_itv_size(iter->itv) - cache_shift);
-		memcpy(buf + buf_offset, cache->data + cache_offset, read);
+		const ut64 from = RZ_MAX(begin, addr);
+		const ut64 to = RZ_MIN(rz_itv_end(c->itv), end);
+		memcpy(buf + (from - addr), c->data + (from - begin), to - from);
 		covered = true;
-		if (left - read <= 0) {
-			break;
-		}
-		iter++;
 	}
 	return covered;
 }
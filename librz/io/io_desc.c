@@ -6,6 +6,7 @@
 #include <rz_io.h>
 #include <sdb.h>
 #include <string.h>
+#include "io_private.h"
 
 // shall be used by plugins for creating descs
 RZ_API RzIODesc *rz_io_desc_new(RzIO *io, RzIOPlugin *plugin, const char *uri, int perm, int mode, void *data) {
@@ -61,6 +62,7 @@ RZ_API bool rz_io_desc_add(RzIO *io, RzIODesc *desc) {
 RZ_API bool rz_io_desc_del(RzIO *io, int fd) { // can we pass this a riodesc and check if it belongs to the desc->io ?
 	rz_return_val_if_fail(io && io->files, false);
 	RzIODesc *desc = rz_id_storage_get(io->files, fd);
+	rz_io_page_cache_invalidate_fd(io, fd);
 	rz_io_desc_free(desc);
 	if (desc == io->desc) {
 		io->desc = NULL;
@@ -193,19 +195,15 @@ RZ_API int rz_io_desc_write(RzIODesc *desc, const ut8 *buf, int len) {
 	return rz_io_plugin_write(desc, buf, len);
 }
 
-// returns length of read bytes
-RZ_API int rz_io_desc_read(RzIODesc *desc, ut8 *buf, int len) {
-	// check pointers and permissions
-	if (!buf || !desc || !desc->plugin || !(desc->perm & RZ_PERM_R)) {
-		return -1;
-	}
-	ut64 seek = rz_io_desc_seek(desc, 0LL, RZ_IO_SEEK_CUR);
+static int desc_read_from(RzIODesc *desc, ut64 seek, ut8 *buf, int len) {
 	if (desc->io->cachemode) {
 		if (seek != UT64_MAX && rz_io_cache_at(desc->io, seek)) {
 			return rz_io_cache_read(desc->io, seek, buf, len);
 		}
 	}
-	int ret = rz_io_plugin_read(desc, buf, len);
+	int ret = rz_io_page_cache_usable(desc->io, desc)
+		? rz_io_page_cache_read(desc->io, desc, seek, buf, len)
+		: rz_io_plugin_read(desc, buf, len);
 	if (ret > 0 && desc->io->cachemode) {
 		rz_io_cache_write(desc->io, seek, buf, len);
 	} else if ((ret > 0) && desc->io && (desc->io->p_cache & 1)) {
@@ -214,6 +212,16 @@ RZ_API int rz_io_desc_read(RzIODesc *desc, ut8 *buf, int len) {
 	return ret;
 }
 
+// returns length of read bytes
+RZ_API int rz_io_desc_read(RzIODesc *desc, ut8 *buf, int len) {
+	// check pointers and permissions
+	if (!buf || !desc || !desc->plugin || !(desc->perm & RZ_PERM_R)) {
+		return -1;
+	}
+	ut64 seek = rz_io_desc_seek(desc, 0LL, RZ_IO_SEEK_CUR);
+	return desc_read_from(desc, seek, buf, len);
+}
+
 RZ_API ut64 rz_io_desc_seek(RzIODesc *desc, ut64 offset, int whence) {
 	if (!desc || !desc->plugin || !desc->plugin->lseek) {
 		return (ut64)-1;
@@ -247,9 +255,35 @@ RZ_API ut8 *rz_io_desc_get_buf(RzIODesc *desc, RZ_OUT RZ_NONNULL ut64 *size) {
 	return desc->plugin->get_buf(desc, size);
 }
 
+/**
+ * \brief Get a pointer to the data at \p paddr of \p desc without copying it
+ *
+ * Only plugins keeping the whole file contiguous in memory (like mmap'd
+ * files) support this. Nothing is returned when the data may be shadowed
+ * by io.cache or by the desc write cache, as the plugin memory would be
+ * stale then. The pointer is valid until the next write to or resize of
+ * \p desc, or until it is closed.
+ *
+ * \param len In: number of bytes wanted. Out: number of bytes available at the returned pointer
+ * \return The pointer, or NULL if the data can't be borrowed and must be read with rz_io_desc_read_at()
+ */
+RZ_API RZ_BORROW const ut8 *rz_io_desc_borrow_at(RZ_NONNULL RzIODesc *desc, ut64 paddr, RZ_NONNULL RZ_INOUT ut64 *len) {
+	rz_return_val_if_fail(desc && len, NULL);
+	if (!*len || !desc->plugin || !desc->plugin->borrow || !(desc->perm & RZ_PERM_R)) {
+		return NULL;
+	}
+	if (desc->io && (desc->io->cachemode || desc->io->p_cache)) {
+		return NULL;
+	}
+	return desc->plugin->borrow(desc->io, desc, paddr, len);
+}
+
 RZ_API bool rz_io_desc_resize(RzIODesc *desc, ut64 newsize) {
 	if (desc && desc->plugin && desc->plugin->resize) {
 		bool ret = desc->plugin->resize(desc->io, desc, newsize);
+		if (desc->io) {
+			rz_io_page_cache_invalidate_fd(desc->io, desc->fd);
+		}
 		if (desc->io && desc->io->p_cache) {
 			rz_io_desc_cache_cleanup(desc);
 		}
@@ -277,6 +311,8 @@ RZ_API bool rz_io_desc_exchange(RzIO *io, int fd, int fdx) {
 	if (!(desc = rz_io_desc_get(io, fd)) || !(descx = rz_io_desc_get(io, fdx))) {
 		return false;
 	}
+	rz_io_page_cache_invalidate_fd(io, fd);
+	rz_io_page_cache_invalidate_fd(io, fdx);
 	desc->fd = fdx;
 	descx->fd = fd;
 	rz_id_storage_set(io->files, desc, fdx);
@@ -348,18 +384,53 @@ RZ_API bool rz_io_desc_get_base(RzIODesc *desc, ut64 *base) {
 	return desc->plugin->getbase(desc, base);
 }
 
-RZ_API int rz_io_desc_read_at(RzIODesc *desc, ut64 addr, ut8 *buf, int len) {
-	if (desc && buf && (rz_io_desc_seek(desc, addr, RZ_IO_SEEK_SET) == addr)) {
+static int desc_read_at(RzIODesc *desc, ut64 addr, ut8 *buf, int len) {
+	if (desc->io && rz_io_page_cache_usable(desc->io, desc)) {
+		// the page cache seeks by itself, only when it misses
+		if (!(desc->perm & RZ_PERM_R)) {
+			return -1;
+		}
+		return desc_read_from(desc, addr, buf, len);
+	}
+	if (rz_io_desc_seek(desc, addr, RZ_IO_SEEK_SET) == addr) {
 		return rz_io_desc_read(desc, buf, len);
 	}
 	return 0;
 }
 
+RZ_API int rz_io_desc_read_at(RzIODesc *desc, ut64 addr, ut8 *buf, int len) {
+	if (!desc || !buf) {
+		return 0;
+	}
+	if (!desc->io) {
+		return desc_read_at(desc, addr, buf, len);
+	}
+	// the seek and the read must not be interleaved with the ones of the read-ahead worker
+	io_readahead_lock(desc->io);
+	int ret = desc_read_at(desc, addr, buf, len);
+	io_readahead_unlock(desc->io);
+	return ret;
+}
+
 RZ_API int rz_io_desc_write_at(RzIODesc *desc, ut64 addr, const ut8 *buf, int len) {
-	if (desc && buf && (rz_io_desc_seek(desc, addr, RZ_IO_SEEK_SET) == addr)) {
-		return rz_io_desc_write(desc, buf, len);
+	if (!desc || !buf) {
+		return 0;
 	}
-	return 0;
+	RzIO *io = desc->io;
+	if (io) {
+		io_readahead_lock(io);
+	}
+	int ret = 0;
+	if (rz_io_desc_seek(desc, addr, RZ_IO_SEEK_SET) == addr) {
+		ret = rz_io_desc_write(desc, buf, len);
+	}
+	if (io) {
+		io_readahead_unlock(io);
+		if (io->readahead && ret > 0) {
+			io_readahead_invalidate_desc(io->readahead, desc, addr, ret);
+		}
+	}
+	return ret;
 }
 
 /* lifecycle */
@@ -390,6 +461,7 @@ static bool desc_fini_cb(void *user, void *data, ut32 id) {
 RZ_IPI bool rz_io_desc_fini(RzIO *io) {
 	rz_return_val_if_fail(io, false);
 	if (io->files) {
+		rz_io_page_cache_clear(io);
 		rz_id_storage_foreach(io->files, desc_fini_cb, io);
 		rz_id_storage_free(io->files);
 		io->files = NULL;
@@ -55,6 +55,15 @@ RZ_API ut8 *rz_io_fd_get_buf(RzIO *io, int fd, RZ_OUT RZ_NONNULL ut64 *size) {
 	return rz_io_desc_get_buf(rz_io_desc_get(io, fd), size);
 }
 
+/**
+ * \brief Same as rz_io_desc_borrow_at(), for the desc \p fd
+ */
+RZ_API RZ_BORROW const ut8 *rz_io_fd_borrow_at(RZ_NONNULL RzIO *io, int fd, ut64 paddr, RZ_NONNULL RZ_INOUT ut64 *len) {
+	rz_return_val_if_fail(io && len, NULL);
+	RzIODesc *desc = rz_io_desc_get(io, fd);
+	return desc ? rz_io_desc_borrow_at(desc, paddr, len) : NULL;
+}
+
 RZ_API bool rz_io_fd_resize(RzIO *io, int fd, ut64 newsize) {
 	return rz_io_desc_resize(rz_io_desc_get(io, fd), newsize);
 }
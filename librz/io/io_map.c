@@ -172,10 +172,62 @@ RZ_API RzIOMap *rz_io_map_get_paddr(RzIO *io, ut64 paddr) {
 	return NULL;
 }
 
+/**
+ * Find the part of the skyline containing \p addr, trying the most recently
+ * used ones first. Consecutive reads mostly hit the same map, and this saves
+ * them the binary search.
+ */
+bool io_map_lookup(RzIO *io, ut64 addr, RzSkylineItem *part) {
+	RzIOMapCache *cache = &io->map_cache;
+	if (cache->generation != io->map_skyline.generation) {
+		cache->generation = io->map_skyline.generation;
+		cache->count = 0;
+	}
+	size_t i;
+	for (i = 0; i < cache->count; i++) {
+		const RzSkylineItem *item = &cache->items[i];
+		// also right for the parts ending at the top of the address space
+		if (addr - item->itv.addr < item->itv.size) {
+			*part = *item;
+			memmove(cache->items + 1, cache->items, i * sizeof(RzSkylineItem));
+			cache->items[0] = *part;
+			return true;
+		}
+	}
+	const RzSkylineItem *item = rz_skyline_get_item(&io->map_skyline, addr);
+	if (!item) {
+		return false;
+	}
+	*part = *item;
+	size_t keep = RZ_MIN(cache->count, RZ_IO_MAP_CACHE_SIZE - 1);
+	memmove(cache->items + 1, cache->items, keep * sizeof(RzSkylineItem));
+	cache->items[0] = *part;
+	cache->count = keep + 1;
+	return true;
+}
+
 // gets first map where addr fits in
 RZ_API RzIOMap *rz_io_map_get(RzIO *io, ut64 addr) {
 	rz_return_val_if_fail(io, NULL);
-	return rz_skyline_get(&io->map_skyline, addr);
+	RzSkylineItem part;
+	return io_map_lookup(io, addr, &part) ? part.user : NULL;
+}
+
+/**
+ * \brief Get the map at \p addr with the highest priority, like rz_io_map_get()
+ * \param range If not NULL, set to the addresses around \p addr where the
+ * map is not shadowed by any other, which can all be read from it at once
+ */
+RZ_API RzIOMap *rz_io_map_get_range(RzIO *io, ut64 addr, RZ_NULLABLE RZ_OUT RzInterval *range) {
+	rz_return_val_if_fail(io, NULL);
+	RzSkylineItem part;
+	if (!io_map_lookup(io, addr, &part)) {
+		return NULL;
+	}
+	if (range) {
+		*range = part.itv;
+	}
+	return part.user;
 }
 
 RZ_API bool rz_io_map_is_mapped(RzIO *io, ut64 addr) {
@@ -142,3 +142,13 @@ ut64 io_memory_lseek(RzIO *io, RzIODesc *fd, ut64 offset, int whence) {
 	_io_malloc_set_off(fd, rz_offset);
 	return rz_offset;
 }
+
+const ut8 *io_memory_borrow(RzIO *io, RzIODesc *fd, ut64 paddr, ut64 *len) {
+	ut32 size = _io_malloc_sz(fd);
+	ut8 *buf = _io_malloc_buf(fd);
+	if (!buf || paddr >= size) {
+		return NULL;
+	}
+	*len = RZ_MIN(*len, size - paddr);
+	return buf + paddr;
+}
@@ -0,0 +1,323 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_io.h>
+
+/**
+ * \file io_page_cache.c
+ * Size-bounded LRU cache of plugin-level pages, keyed by (fd, paddr page).
+ *
+ * The cache sits right above the io plugin read callback, so everything
+ * stacked on top of it (io.cache, io.pcache, maps) keeps working unchanged.
+ * Any write going through rz_io_plugin_write() invalidates the touched pages.
+ * Debug plugins only take part if they implement RzIOPlugin.generation, all
+ * their pages are dropped as soon as it changes.
+ */
+
+typedef struct rz_io_page_t {
+	int fd;
+	ut64 addr; ///< page aligned physical address
+	int size; ///< number of valid bytes in data, may be smaller than a page near EOF
+	struct rz_io_page_t *prev; ///< more recently used
+	struct rz_io_page_t *next; ///< less recently used
+	ut8 data[RZ_IO_PAGE_CACHE_PAGE_SIZE];
+} RzIOPage;
+
+#define PAGE_MASK (~((ut64)RZ_IO_PAGE_CACHE_PAGE_SIZE - 1))
+
+static void fd_pages_free(HtUPKv *kv) {
+	ht_up_free(kv->value);
+}
+
+static void lru_unlink(RzIOPageCache *pc, RzIOPage *page) {
+	if (page->prev) {
+		page->prev->next = page->next;
+	} else {
+		pc->head = page->next;
+	}
+	if (page->next) {
+		page->next->prev = page->prev;
+	} else {
+		pc->tail = page->prev;
+	}
+	page->prev = page->next = NULL;
+}
+
+static void lru_push_front(RzIOPageCache *pc, RzIOPage *page) {
+	page->prev = NULL;
+	page->next = pc->head;
+	if (pc->head) {
+		pc->head->prev = page;
+	}
+	pc->head = page;
+	if (!pc->tail) {
+		pc->tail = page;
+	}
+}
+
+static void page_remove(RzIOPageCache *pc, RzIOPage *page) {
+	HtUP *pages = ht_up_find(pc->fds, (ut64)(ut32)page->fd, NULL);
+	if (pages) {
+		ht_up_delete(pages, page->addr);
+	}
+	lru_unlink(pc, page);
+	pc->count--;
+	free(page);
+}
+
+static RzIOPage *page_find(RzIOPageCache *pc, int fd, ut64 addr) {
+	HtUP *pages = ht_up_find(pc->fds, (ut64)(ut32)fd, NULL);
+	return pages ? ht_up_find(pages, addr, NULL) : NULL;
+}
+
+static bool page_insert(RzIOPageCache *pc, RzIOPage *page) {
+	HtUP *pages = ht_up_find(pc->fds, (ut64)(ut32)page->fd, NULL);
+	if (!pages) {
+		pages = ht_up_new0();
+		if (!pages || !ht_up_insert(pc->fds, (ut64)(ut32)page->fd, pages)) {
+			ht_up_free(pages);
+			return false;
+		}
+	}
+	if (!ht_up_insert(pages, page->addr, page)) {
+		return false;
+	}
+	lru_push_front(pc, page);
+	pc->count++;
+	while (pc->count > pc->max_pages && pc->tail && pc->tail != page) {
+		page_remove(pc, pc->tail);
+	}
+	return true;
+}
+
+RZ_API void rz_io_page_cache_init(RzIO *io) {
+	rz_return_if_fail(io);
+	RzIOPageCache *pc = &io->page_cache;
+	memset(pc, 0, sizeof(*pc));
+	pc->max_pages = RZ_IO_PAGE_CACHE_DEFAULT_PAGES;
+}
+
+RZ_API void rz_io_page_cache_fini(RzIO *io) {
+	rz_return_if_fail(io);
+	rz_io_page_cache_clear(io);
+	ht_up_free(io->page_cache.fds);
+	io->page_cache.fds = NULL;
+	ht_uu_free(io->page_cache.generations);
+	io->page_cache.generations = NULL;
+}
+
+/**
+ * \brief Drop all the cached pages, keeping the configuration and the counters
+ */
+RZ_API void rz_io_page_cache_clear(RzIO *io) {
+	rz_return_if_fail(io);
+	RzIOPageCache *pc = &io->page_cache;
+	RzIOPage *page = pc->head;
+	while (page) {
+		RzIOPage *next = page->next;
+		free(page);
+		page = next;
+	}
+	pc->head = pc->tail = NULL;
+	pc->count = 0;
+	ht_up_free(pc->fds);
+	pc->fds = NULL;
+}
+
+/**
+ * \brief Enable or disable the page cache. Disabling it drops all cached pages.
+ */
+RZ_API void rz_io_page_cache_enable(RzIO *io, bool enable) {
+	rz_return_if_fail(io);
+	if (!enable) {
+		rz_io_page_cache_clear(io);
+	}
+	io->page_cache.enabled = enable;
+}
+
+/**
+ * \brief Set the maximum number of pages kept in the cache, evicting the least recently used ones if needed
+ */
+RZ_API void rz_io_page_cache_set_max_pages(RzIO *io, size_t max_pages) {
+	rz_return_if_fail(io);
+	RzIOPageCache *pc = &io->page_cache;
+	pc->max_pages = max_pages;
+	while (pc->count > pc->max_pages && pc->tail) {
+		page_remove(pc, pc->tail);
+	}
+}
+
+RZ_API void rz_io_page_cache_reset_stats(RzIO *io) {
+	rz_return_if_fail(io);
+	io->page_cache.hits = 0;
+	io->page_cache.misses = 0;
+}
+
+/**
+ * \brief Drop all the cached pages of \p fd overlapping [addr, addr + len)
+ */
+RZ_API void rz_io_page_cache_invalidate(RzIO *io, int fd, ut64 addr, ut64 len) {
+	rz_return_if_fail(io);
+	RzIOPageCache *pc = &io->page_cache;
+	if (!pc->fds || !len) {
+		return;
+	}
+	ut64 end = addr + len < addr ? UT64_MAX : addr + len - 1;
+	ut64 page_addr;
+	for (page_addr = addr & PAGE_MASK; page_addr <= end; page_addr += RZ_IO_PAGE_CACHE_PAGE_SIZE) {
+		RzIOPage *page = page_find(pc, fd, page_addr);
+		if (page) {
+			page_remove(pc, page);
+		}
+		if (page_addr + RZ_IO_PAGE_CACHE_PAGE_SIZE < page_addr) {
+			break;
+		}
+	}
+}
+
+/**
+ * \brief Drop all the cached pages of \p fd
+ */
+RZ_API void rz_io_page_cache_invalidate_fd(RzIO *io, int fd) {
+	rz_return_if_fail(io);
+	RzIOPageCache *pc = &io->page_cache;
+	if (!pc->fds) {
+		return;
+	}
+	RzIOPage *page = pc->head;
+	while (page) {
+		RzIOPage *next = page->next;
+		if (page->fd == fd) {
+			lru_unlink(pc, page);
+			pc->count--;
+			free(page);
+		}
+		page = next;
+	}
+	ht_up_delete(pc->fds, (ut64)(ut32)fd);
+	if (pc->generations) {
+		ht_uu_delete(pc->generations, (ut64)(ut32)fd);
+	}
+}
+
+/**
+ * \brief Whether reads from \p desc can be served by the page cache
+ *
+ * Character device backends and debuggers that can't tell when their target
+ * ran are never cached, their contents may change without any write going
+ * through RzIO.
+ */
+RZ_API bool rz_io_page_cache_usable(RzIO *io, RzIODesc *desc) {
+	rz_return_val_if_fail(io, false);
+	if (!io->page_cache.enabled || !io->page_cache.max_pages || !desc || !desc->plugin) {
+		return false;
+	}
+	return (!desc->plugin->isdbg || desc->plugin->generation) && !rz_io_desc_is_chardevice(desc);
+}
+
+// drop the pages of a debug target that ran since they were read
+static void sync_generation(RzIO *io, RzIODesc *desc) {
+	RzIOPageCache *pc = &io->page_cache;
+	ut64 fd = (ut64)(ut32)desc->fd;
+	ut64 gen = desc->plugin->generation(desc);
+	bool found = false;
+	ut64 cached = pc->generations ? ht_uu_find(pc->generations, fd, &found) : 0;
+	if (found && cached == gen) {
+		return;
+	}
+	rz_io_page_cache_invalidate_fd(io, desc->fd);
+	if (!pc->generations) {
+		pc->generations = ht_uu_new0();
+	}
+	if (pc->generations) {
+		ht_uu_update(pc->generations, fd, gen);
+	}
+}
+
+static RzIOPage *page_load(RzIO *io, RzIODesc *desc, ut64 page_addr) {
+	RzIOPageCache *pc = &io->page_cache;
+	RzIOPage *page = page_find(pc, desc->fd, page_addr);
+	if (page) {
+		pc->hits++;
+		if (pc->head != page) {
+			lru_unlink(pc, page);
+			lru_push_front(pc, page);
+		}
+		return page;
+	}
+	pc->misses++;
+	if (rz_io_desc_seek(desc, page_addr, RZ_IO_SEEK_SET) != page_addr) {
+		return NULL;
+	}
+	page = RZ_NEW(RzIOPage);
+	if (!page) {
+		return NULL;
+	}
+	page->fd = desc->fd;
+	page->addr = page_addr;
+	page->prev = page->next = NULL;
+	page->size = rz_io_plugin_read(desc, page->data, RZ_IO_PAGE_CACHE_PAGE_SIZE);
+	if (page->size <= 0) {
+		free(page);
+		return NULL;
+	}
+	if (!pc->fds) {
+		pc->fds = ht_up_new(NULL, fd_pages_free, NULL);
+	}
+	if (!pc->fds || !page_insert(pc, page)) {
+		free(page);
+		return NULL;
+	}
+	return page;
+}
+
+/**
+ * \brief Read \p len bytes at physical address \p addr of \p desc through the page cache
+ *
+ * Pages missing from the cache are read with one plugin call each and kept
+ * for subsequent reads. The desc position is left at the end of the read
+ * data, as a plain plugin read would do.
+ *
+ * \return the number of bytes read, or -1 if nothing could be read at all
+ */
+RZ_API int rz_io_page_cache_read(RzIO *io, RzIODesc *desc, ut64 addr, ut8 *buf, int len) {
+	rz_return_val_if_fail(io && desc && buf, -1);
+	if (len < 1) {
+		return 0;
+	}
+	if (desc->plugin && desc->plugin->generation) {
+		sync_generation(io, desc);
+	}
+	if (len > RZ_IO_PAGE_CACHE_MAX_READ) {
+		// large sequential reads would just thrash the cache
+		if (rz_io_desc_seek(desc, addr, RZ_IO_SEEK_SET) != addr) {
+			return -1;
+		}
+		return rz_io_plugin_read(desc, buf, len);
+	}
+	int done = 0;
+	while (done < len) {
+		ut64 cur = addr + done;
+		ut64 page_addr = cur & PAGE_MASK;
+		int delta = (int)(cur - page_addr);
+		RzIOPage *page = page_load(io, desc, page_addr);
+		if (!page || page->size <= delta) {
+			break;
+		}
+		int n = RZ_MIN(len - done, page->size - delta);
+		memcpy(buf + done, page->data + delta, n);
+		done += n;
+		if (page->size < RZ_IO_PAGE_CACHE_PAGE_SIZE) {
+			// short page, this is the end of the readable data
+			break;
+		}
+		if (page_addr + RZ_IO_PAGE_CACHE_PAGE_SIZE < page_addr) {
+			break;
+		}
+	}
+	if (!done) {
+		return -1;
+	}
+	rz_io_desc_seek(desc, addr + done, RZ_IO_SEEK_SET);
+	return done;
+}
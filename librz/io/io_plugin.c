@@ -85,7 +85,13 @@ RZ_API int rz_io_plugin_read(RzIODesc *desc, ut8 *buf, int len) {
 	if (!desc->plugin->read) {
 		return -1;
 	}
-	return desc->plugin->read(desc->io, desc, buf, len);
+	if (!rz_tracing_is_enabled()) {
+		return desc->plugin->read(desc->io, desc, buf, len);
+	}
+	rz_tracing_begin("io", desc->plugin->name);
+	int ret = desc->plugin->read(desc->io, desc, buf, len);
+	rz_tracing_end("io");
+	return ret;
 }
 
 RZ_API int rz_io_plugin_write(RzIODesc *desc, const ut8 *buf, int len) {
@@ -97,6 +103,7 @@ RZ_API int rz_io_plugin_write(RzIODesc *desc, const ut8 *buf, int len) {
 	}
 	const ut64 cur_addr = rz_io_desc_seek(desc, 0LL, RZ_IO_SEEK_CUR);
 	int ret = desc->plugin->write(desc->io, desc, buf, len);
+	rz_io_page_cache_invalidate(desc->io, desc->fd, cur_addr, len);
 	RzEventIOWrite iow = { cur_addr, buf, len };
 	rz_event_send(desc->io->event, RZ_EVENT_IO_WRITE, &iow);
 	return ret;
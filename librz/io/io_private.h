@@ -7,5 +7,12 @@
 RzIOMap *io_map_new(RzIO *io, int fd, int perm, ut64 delta, ut64 addr, ut64 size);
 RzIOMap *io_map_add(RzIO *io, int fd, int flags, ut64 delta, ut64 addr, ut64 size, bool do_skyline);
 void io_map_calculate_skyline(RzIO *io);
+bool io_map_lookup(RzIO *io, ut64 addr, RzSkylineItem *part);
+RzIOCache *io_cache_first_after(RzIO *io, ut64 addr);
+bool io_readahead_read(RzIOReadAhead *ra, ut64 addr, ut8 *buf, int len, bool *ret);
+void io_readahead_invalidate(RzIOReadAhead *ra, ut64 addr, ut64 len);
+void io_readahead_invalidate_desc(RzIOReadAhead *ra, RzIODesc *desc, ut64 paddr, ut64 len);
+void io_readahead_lock(RzIO *io);
+void io_readahead_unlock(RzIO *io);
 
 #endif
@@ -0,0 +1,343 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_io.h>
+#include "io_private.h"
+
+/**
+ * \file io_readahead.c
+ * Background prefetching of a range that is about to be read sequentially.
+ *
+ * A consumer declares the range with rz_io_readahead_start(), then a worker
+ * thread keeps the blocks following the last one read in a ring, which
+ * rz_io_read_at() copies from. Only the plugin reads happen on the worker:
+ * the maps covering the range are resolved once when starting, and io.cache
+ * is still applied by the reading thread, so the rest of RzIO stays single
+ * threaded. The plugin accesses of both threads are serialized by io_lock,
+ * which rz_io_desc_read_at() and rz_io_desc_write_at() take.
+ */
+
+typedef struct {
+	ut64 addr; ///< first address of the segment inside the range
+	ut64 size;
+	RzIODesc *desc; ///< NULL if the segment can't be read
+	ut64 paddr; ///< offset of addr in desc
+} ReadAheadSegment;
+
+struct rz_io_readahead_t {
+	RzIO *io;
+	ut64 from;
+	ut64 to;
+	ut64 block_size;
+	ut64 nblocks;
+	ut8 *data; ///< nblocks * block_size bytes, see slot_of()
+	bool *ok; ///< result of the read of the block held by each slot
+	RzVector /*<ReadAheadSegment>*/ segments; ///< readable parts of the range with io.va, sorted
+	RzIODesc *desc; ///< desc read from without io.va
+	int va; ///< config of the io the segments were resolved with
+	int ff;
+	int Oxff;
+	int p_cache;
+	ut32 map_generation;
+	RzThreadBreakCallback is_breaked;
+	void *user;
+	RzThreadLock *lock; ///< protects all the fields below
+	ut64 head; ///< start of the first block held, the ones before may be overwritten
+	ut64 tail; ///< end of the blocks held, the worker reads the one starting here next
+	ut32 generation; ///< changed when the window is moved, blocks read before are dropped
+	bool stop;
+	RzThreadCond *cond; ///< signaled when a block was read, the window moved or the worker stopped
+	RzThreadLock *io_lock; ///< held around every plugin read and write, see io_readahead_lock()
+	RzThread *thread;
+};
+
+static inline ut64 block_floor(RzIOReadAhead *ra, ut64 addr) {
+	return addr - (addr - ra->from) % ra->block_size;
+}
+
+static inline ut64 slot_of(RzIOReadAhead *ra, ut64 addr) {
+	return ((addr - ra->from) / ra->block_size) % ra->nblocks;
+}
+
+static bool read_block(RzIOReadAhead *ra, ut64 addr, ut8 *buf, ut64 len) {
+	memset(buf, ra->ff ? ra->Oxff : 0, len);
+	if (!ra->va) {
+		return rz_io_desc_read_at(ra->desc, addr, buf, (int)len) > 0;
+	}
+	// gaps are fine, like in rz_io_vread_at_mapped()
+	bool ok = true;
+	ut64 last = addr + len - 1;
+	ReadAheadSegment *seg;
+	rz_vector_foreach(&ra->segments, seg) {
+		ut64 seg_last = seg->addr + seg->size - 1;
+		if (seg_last < addr) {
+			continue;
+		}
+		if (seg->addr > last) {
+			break;
+		}
+		ut64 a = RZ_MAX(seg->addr, addr);
+		int n = (int)(RZ_MIN(seg_last, last) - a + 1);
+		if (!seg->desc || rz_io_desc_read_at(seg->desc, seg->paddr + (a - seg->addr), buf + (a - addr), n) != n) {
+			ok = false;
+		}
+	}
+	return ok;
+}
+
+static void *readahead_th(void *user) {
+	RzIOReadAhead *ra = user;
+	rz_th_lock_enter(ra->lock);
+	while (!ra->stop) {
+		if (ra->tail >= ra->to || ra->tail - ra->head >= ra->block_size * ra->nblocks) {
+			rz_th_cond_wait(ra->cond, ra->lock);
+			continue;
+		}
+		// the slot of the block at tail is out of the window, nobody reads it meanwhile
+		ut64 addr = ra->tail;
+		ut64 len = RZ_MIN(ra->block_size, ra->to - addr);
+		ut64 slot = slot_of(ra, addr);
+		ut32 generation = ra->generation;
+		rz_th_lock_leave(ra->lock);
+
+		bool breaked = ra->is_breaked && ra->is_breaked(ra->user);
+		bool ok = false;
+		if (!breaked) {
+			ok = read_block(ra, addr, ra->data + slot * ra->block_size, len);
+		}
+
+		rz_th_lock_enter(ra->lock);
+		if (breaked) {
+			ra->stop = true;
+		} else if (generation == ra->generation) {
+			ra->ok[slot] = ok;
+			ra->tail = addr + len;
+		}
+		rz_th_cond_signal_all(ra->cond);
+	}
+	rz_th_lock_leave(ra->lock);
+	return NULL;
+}
+
+static bool resolve_segments(RzIOReadAhead *ra) {
+	RzIO *io = ra->io;
+	ra->va = io->va;
+	ra->ff = io->ff;
+	ra->Oxff = io->Oxff;
+	ra->p_cache = io->p_cache;
+	ra->map_generation = io->map_skyline.generation;
+	ra->desc = io->desc;
+	if (!io->va) {
+		return true;
+	}
+	RzSkylineItem *part;
+	rz_vector_foreach(&io->map_skyline.v, part) {
+		ut64 first = RZ_MAX(part->itv.addr, ra->from);
+		ut64 last = RZ_MIN(rz_itv_end(part->itv) - 1, ra->to - 1);
+		if (first > last) {
+			continue;
+		}
+		RzIOMap *map = part->user;
+		ReadAheadSegment *seg = rz_vector_push(&ra->segments, NULL);
+		if (!seg) {
+			return false;
+		}
+		seg->addr = first;
+		seg->size = last - first + 1;
+		seg->desc = (map->perm & RZ_PERM_R) || io->p_cache ? rz_io_desc_get(io, map->fd) : NULL;
+		seg->paddr = map->delta + first - map->itv.addr;
+	}
+	return true;
+}
+
+static bool config_changed(RzIOReadAhead *ra) {
+	RzIO *io = ra->io;
+	return io->va != ra->va || io->ff != ra->ff || io->Oxff != ra->Oxff || io->p_cache != ra->p_cache ||
+		(io->va ? io->map_skyline.generation != ra->map_generation : io->desc != ra->desc);
+}
+
+static void readahead_free(RzIOReadAhead *ra) {
+	if (!ra) {
+		return;
+	}
+	if (ra->thread) {
+		rz_th_lock_enter(ra->lock);
+		ra->stop = true;
+		rz_th_cond_signal_all(ra->cond);
+		rz_th_lock_leave(ra->lock);
+		rz_th_wait(ra->thread);
+		rz_th_free(ra->thread);
+	}
+	rz_th_cond_free(ra->cond);
+	rz_th_lock_free(ra->io_lock);
+	rz_th_lock_free(ra->lock);
+	rz_vector_fini(&ra->segments);
+	free(ra->ok);
+	free(ra->data);
+	free(ra);
+}
+
+/**
+ * \brief Start reading ahead [\p from, \p to) in the background
+ *
+ * A worker thread reads the range in blocks of \p block_size bytes, keeping at
+ * most \p nblocks of them ahead of the last address read. rz_io_read_at(),
+ * rz_io_read_at_mapped() and rz_io_nread_at() are then served from these
+ * blocks when possible, waiting for the worker if it is about to read them.
+ * Reading before the last block read or far after it moves the window.
+ *
+ * The maps are resolved when starting, so until rz_io_readahead_stop() the io
+ * must not be changed apart from writes, which drop the blocks they overlap.
+ * Reads and writes of the other functions, down to rz_io_desc_read_at() and
+ * rz_io_desc_write_at(), are serialized with the ones of the worker.
+ *
+ * \param is_breaked Checked before every block, the worker stops when it returns true
+ * \return false if the read-ahead couldn't be started, reads are then done as usual
+ */
+RZ_API bool rz_io_readahead_start(RZ_NONNULL RzIO *io, ut64 from, ut64 to, size_t block_size, size_t nblocks, RZ_NULLABLE RzThreadBreakCallback is_breaked, RZ_NULLABLE void *user) {
+	rz_return_val_if_fail(io, false);
+	rz_io_readahead_stop(io);
+	if (from >= to || !block_size || !nblocks || block_size > INT_MAX || SZT_MUL_OVFCHK(block_size, nblocks)) {
+		return false;
+	}
+	RzIOReadAhead *ra = RZ_NEW0(RzIOReadAhead);
+	if (!ra) {
+		return false;
+	}
+	ra->io = io;
+	ra->from = ra->head = ra->tail = from;
+	ra->to = to;
+	ra->block_size = block_size;
+	ra->nblocks = nblocks;
+	ra->is_breaked = is_breaked;
+	ra->user = user;
+	rz_vector_init(&ra->segments, sizeof(ReadAheadSegment), NULL, NULL);
+	ra->data = malloc(block_size * nblocks);
+	ra->ok = RZ_NEWS0(bool, nblocks);
+	ra->lock = rz_th_lock_new(false);
+	// recursive in case a plugin reads through the io while reading itself
+	ra->io_lock = rz_th_lock_new(true);
+	ra->cond = rz_th_cond_new();
+	if (!ra->data || !ra->ok || !ra->lock || !ra->io_lock || !ra->cond || !resolve_segments(ra)) {
+		readahead_free(ra);
+		return false;
+	}
+	// set first, the reads of the worker take io_lock through it
+	io->readahead = ra;
+	ra->thread = rz_th_new(readahead_th, ra);
+	if (!ra->thread) {
+		io->readahead = NULL;
+		readahead_free(ra);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * \brief Stop the read-ahead started by rz_io_readahead_start(), if any
+ */
+RZ_API void rz_io_readahead_stop(RZ_NONNULL RzIO *io) {
+	rz_return_if_fail(io);
+	readahead_free(io->readahead);
+	io->readahead = NULL;
+}
+
+/**
+ * Serve a read from the blocks of the read-ahead.
+ *
+ * The result of a block is the one of its whole read, so \p ret may be false
+ * even if the part of it requested was fine.
+ *
+ * \return false if the range can't be served, it must then be read directly
+ */
+bool io_readahead_read(RzIOReadAhead *ra, ut64 addr, ut8 *buf, int len, bool *ret) {
+	if (len < 1 || addr < ra->from || addr >= ra->to || (ut64)len > ra->to - addr) {
+		return false;
+	}
+	ut64 end = addr + len;
+	ut64 block = block_floor(ra, addr);
+	rz_th_lock_enter(ra->lock);
+	if (config_changed(ra)) {
+		ra->stop = true;
+		rz_th_cond_signal_all(ra->cond);
+	}
+	if (ra->stop || end - block > ra->block_size * ra->nblocks) {
+		rz_th_lock_leave(ra->lock);
+		return false;
+	}
+	if (block < ra->head || block > ra->tail) {
+		ra->tail = block;
+		ra->generation++;
+	}
+	// the blocks before are done with
+	ra->head = block;
+	rz_th_cond_signal_all(ra->cond);
+	while (end > ra->tail && !ra->stop) {
+		rz_th_cond_wait(ra->cond, ra->lock);
+	}
+	if (end > ra->tail) {
+		rz_th_lock_leave(ra->lock);
+		return false;
+	}
+	bool ok = true;
+	for (ut64 at = addr; at < end;) {
+		ut64 slot = slot_of(ra, at);
+		ut64 off = (at - ra->from) % ra->block_size;
+		ut64 n = RZ_MIN(ra->block_size - off, end - at);
+		memcpy(buf + (at - addr), ra->data + slot * ra->block_size + off, n);
+		ok &= ra->ok[slot];
+		at += n;
+	}
+	rz_th_lock_leave(ra->lock);
+	*ret = ok;
+	return true;
+}
+
+/**
+ * Drop the blocks held after a write of [\p addr, \p addr + \p len).
+ */
+void io_readahead_invalidate(RzIOReadAhead *ra, ut64 addr, ut64 len) {
+	rz_th_lock_enter(ra->lock);
+	// the block at tail may be being read
+	if (addr < ra->tail + ra->block_size && (addr + len > ra->head || addr + len < addr)) {
+		ra->tail = ra->head;
+		ra->generation++;
+		rz_th_cond_signal_all(ra->cond);
+	}
+	rz_th_lock_leave(ra->lock);
+}
+
+/**
+ * Drop the blocks held after a write of [\p paddr, \p paddr + \p len) in \p desc.
+ */
+void io_readahead_invalidate_desc(RzIOReadAhead *ra, RzIODesc *desc, ut64 paddr, ut64 len) {
+	// the segments and the config they were resolved with are never changed
+	if (!ra->va) {
+		if (desc == ra->desc) {
+			io_readahead_invalidate(ra, paddr, len);
+		}
+		return;
+	}
+	ut64 end = paddr + len;
+	ReadAheadSegment *seg;
+	rz_vector_foreach(&ra->segments, seg) {
+		if (seg->desc != desc || paddr >= seg->paddr + seg->size || end <= seg->paddr) {
+			continue;
+		}
+		ut64 start = RZ_MAX(paddr, seg->paddr);
+		ut64 n = RZ_MIN(end, seg->paddr + seg->size) - start;
+		io_readahead_invalidate(ra, seg->addr + (start - seg->paddr), n);
+	}
+}
+
+void io_readahead_lock(RzIO *io) {
+	if (io->readahead) {
+		rz_th_lock_enter(io->readahead->io_lock);
+	}
+}
+
+void io_readahead_unlock(RzIO *io) {
+	if (io->readahead) {
+		rz_th_lock_leave(io->readahead->io_lock);
+	}
+}
@@ -197,6 +197,13 @@ static ut8 *io_default_get_buf(RzIODesc *desc, ut64 *size) {
 	return rz_buf_data(mmo->buf, size);
 }
 
+static const ut8 *io_default_borrow(RzIO *io, RzIODesc *desc, ut64 paddr, ut64 *len) {
+	rz_return_val_if_fail(desc && desc->data && len, NULL);
+	RzIOMMapFileObj *mmo = desc->data;
+	// only mmap'd files can lend their contents, the others would need a copy
+	return rz_buf_borrow_at(mmo->buf, paddr, len);
+}
+
 RzIOPlugin rz_io_plugin_default = {
 	.name = "default",
 	.desc = "Open local files",
@@ -212,7 +219,8 @@ RzIOPlugin rz_io_plugin_default = {
 #if __UNIX__
 	.is_blockdevice = __is_blockdevice,
 #endif
-	.get_buf = io_default_get_buf
+	.get_buf = io_default_get_buf,
+	.borrow = io_default_borrow
 };
 
 #ifndef RZ_PLUGIN_INCORE
@@ -164,6 +164,11 @@ static int __read(RzIO *io, RzIODesc *fd, ut8 *buf, int count) {
 	return debug_gdb_read_at(buf, count, addr);
 }
 
+static ut64 __generation(RzIODesc *fd) {
+	// the memory is stale once the target ran, see gdbr_read_memory()
+	return desc ? desc->mem_gen : 0;
+}
+
 static int __close(RzIODesc *fd) {
 	if (fd) {
 		RZ_FREE(fd->name);
@@ -422,6 +427,7 @@ RzIOPlugin rz_io_plugin_gdb = {
 	.system = __system,
 	.getpid = __getpid,
 	.gettid = __gettid,
+	.generation = __generation,
 	.isdbg = true
 };
 
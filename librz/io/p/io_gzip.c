@@ -8,100 +8,34 @@
 #include <sys/types.h>
 
 typedef struct {
-	ut8 *buf;
-	ut32 size;
+	RzBuffer *buf; ///< decompressed contents, with the writes kept in a sparse overlay
 	ut64 offset;
 } RzIOGzip;
 
-static inline ut32 _io_malloc_sz(RzIODesc *desc) {
-	if (!desc) {
-		return 0;
-	}
-	RzIOGzip *mal = (RzIOGzip *)desc->data;
-	return mal ? mal->size : 0;
-}
-
-static inline void _io_malloc_set_sz(RzIODesc *desc, ut32 sz) {
-	if (!desc) {
-		return;
-	}
-	RzIOGzip *mal = (RzIOGzip *)desc->data;
-	if (mal) {
-		mal->size = sz;
-	}
-}
-
-static inline ut8 *_io_malloc_buf(RzIODesc *desc) {
-	if (!desc) {
-		return NULL;
-	}
-	RzIOGzip *mal = (RzIOGzip *)desc->data;
-	return mal->buf;
-}
-
-static inline ut8 *_io_malloc_set_buf(RzIODesc *desc, ut8 *buf) {
-	if (!desc) {
-		return NULL;
-	}
-	RzIOGzip *mal = (RzIOGzip *)desc->data;
-	return mal->buf = buf;
-}
-
-static inline ut64 _io_malloc_off(RzIODesc *desc) {
-	if (!desc) {
-		return 0;
-	}
-	RzIOGzip *mal = (RzIOGzip *)desc->data;
-	return mal->offset;
-}
-
-static inline void _io_malloc_set_off(RzIODesc *desc, ut64 off) {
-	if (!desc) {
-		return;
-	}
-	RzIOGzip *mal = (RzIOGzip *)desc->data;
-	mal->offset = off;
-}
-
 static int __write(RzIO *io, RzIODesc *fd, const ut8 *buf, int count) {
 	if (!fd || !buf || count < 0 || !fd->data) {
 		return -1;
 	}
-	if (_io_malloc_off(fd) > _io_malloc_sz(fd)) {
+	RzIOGzip *gz = fd->data;
+	ut64 size = rz_buf_size(gz->buf);
+	if (gz->offset >= size) {
 		return -1;
 	}
-	if (_io_malloc_off(fd) + count > _io_malloc_sz(fd)) {
-		count -= (_io_malloc_off(fd) + count - _io_malloc_sz(fd));
-	}
-	if (count > 0) {
-		memcpy(_io_malloc_buf(fd) + _io_malloc_off(fd), buf, count);
-		_io_malloc_set_off(fd, _io_malloc_off(fd) + count);
-		return count;
+	count = (int)RZ_MIN((ut64)count, size - gz->offset);
+	st64 r = rz_buf_write_at(gz->buf, gz->offset, buf, count);
+	if (r <= 0) {
+		return -1;
 	}
-	return -1;
+	gz->offset += r;
+	return (int)r;
 }
 
 static bool __resize(RzIO *io, RzIODesc *fd, ut64 count) {
-	ut8 *new_buf = NULL;
 	if (!fd || !fd->data || count == 0) {
 		return false;
 	}
-	ut32 mallocsz = _io_malloc_sz(fd);
-	if (_io_malloc_off(fd) > mallocsz) {
-		return false;
-	}
-	new_buf = malloc(count);
-	if (!new_buf) {
-		return false;
-	}
-	memcpy(new_buf, _io_malloc_buf(fd), RZ_MIN(count, mallocsz));
-	if (count > mallocsz) {
-		memset(new_buf + mallocsz, 0, count - mallocsz);
-	}
-	free(_io_malloc_buf(fd));
-	_io_malloc_set_buf(fd, new_buf);
-	_io_malloc_set_sz(fd, count);
-	return true;
+	RzIOGzip *gz = fd->data;
+	return rz_buf_resize(gz->buf, count);
 }
 
 static int __read(RzIO *io, RzIODesc *fd, ut8 *buf, int count) {
@@ -109,48 +43,44 @@ static int __read(RzIO *io, RzIODesc *fd, ut8 *buf, int count) {
 	if (!fd || !fd->data) {
 		return -1;
 	}
-	ut32 mallocsz = _io_malloc_sz(fd);
-	if (_io_malloc_off(fd) > mallocsz) {
+	RzIOGzip *gz = fd->data;
+	ut64 size = rz_buf_size(gz->buf);
+	if (gz->offset > size) {
 		return -1;
 	}
-	if (_io_malloc_off(fd) + count >= mallocsz) {
-		count = mallocsz - _io_malloc_off(fd);
-	}
-	memcpy(buf, _io_malloc_buf(fd) + _io_malloc_off(fd), count);
-	return count;
+	count = (int)RZ_MIN((ut64)count, size - gz->offset);
+	return (int)rz_buf_read_at(gz->buf, gz->offset, buf, count);
 }
 
 static int __close(RzIODesc *fd) {
-	RzIOGzip *riom;
 	if (!fd || !fd->data) {
 		return -1;
 	}
-	riom = fd->data;
-	RZ_FREE(riom->buf);
+	RzIOGzip *gz = fd->data;
+	rz_buf_free(gz->buf);
 	RZ_FREE(fd->data);
 	eprintf("TODO: Writing changes into gzipped files is not yet supported\n");
 	return 0;
 }
 
 static ut64 __lseek(RzIO *io, RzIODesc *fd, ut64 offset, int whence) {
-	ut64 rz_offset = offset;
 	if (!fd || !fd->data) {
 		return offset;
 	}
-	ut32 mallocsz = _io_malloc_sz(fd);
+	RzIOGzip *gz = fd->data;
+	ut64 size = rz_buf_size(gz->buf);
 	switch (whence) {
 	case SEEK_SET:
-		rz_offset = (offset <= mallocsz) ? offset : mallocsz;
+		gz->offset = RZ_MIN(offset, size);
 		break;
 	case SEEK_CUR:
-		rz_offset = (_io_malloc_off(fd) + offset <= mallocsz) ? _io_malloc_off(fd) + offset : mallocsz;
+		gz->offset = gz->offset + offset <= size ? gz->offset + offset : size;
 		break;
 	case SEEK_END:
-		rz_offset = _io_malloc_sz(fd);
+		gz->offset = size;
 		break;
 	}
-	_io_malloc_set_off(fd, rz_offset);
-	return rz_offset;
+	return gz->offset;
 }
 
 static bool __plugin_open(RzIO *io, const char *pathname, bool many) {
@@ -158,24 +88,25 @@ static bool __plugin_open(RzIO *io, const char *pathname, bool many) {
 }
 
 static RzIODesc *__open(RzIO *io, const char *pathname, int rw, int mode) {
-	if (__plugin_open(io, pathname, 0)) {
-		RzIOGzip *mal = RZ_NEW0(RzIOGzip);
-		if (!mal) {
-			return NULL;
-		}
-		size_t len;
-		ut8 *data = (ut8 *)rz_file_slurp(pathname + 7, &len);
-		int *size = (int *)&mal->size;
-		mal->buf = rz_inflate(data, (int)len, NULL, size);
-		if (mal->buf) {
-			free(data);
-			return rz_io_desc_new(io, &rz_io_plugin_gzip, pathname, rw, mode, mal);
-		}
-		free(data);
-		eprintf("Cannot allocate (%s) %d byte(s)\n", pathname + 9, mal->size);
-		free(mal);
+	if (!__plugin_open(io, pathname, 0)) {
+		return NULL;
+	}
+	RzIOGzip *gz = RZ_NEW0(RzIOGzip);
+	if (!gz) {
+		return NULL;
+	}
+	// decompressed on demand, so huge images do not need to fit in memory
+	RzBuffer *file = rz_buf_new_file(pathname + 7, O_RDONLY, 0);
+	RzBuffer *inflated = file ? rz_buf_new_inflate(file) : NULL;
+	gz->buf = inflated ? rz_buf_new_sparse_overlay(inflated, RZ_BUF_SPARSE_WRITE_MODE_SPARSE) : NULL;
+	rz_buf_free(inflated);
+	rz_buf_free(file);
+	if (!gz->buf) {
+		eprintf("Cannot decompress %s\n", pathname + 7);
+		free(gz);
+		return NULL;
 	}
-	return NULL;
+	return rz_io_desc_new(io, &rz_io_plugin_gzip, pathname, rw, mode, gz);
 }
 
 RzIOPlugin rz_io_plugin_gzip = {
@@ -8,12 +8,451 @@
 #include <stdlib.h>
 #include "../io_memory.h"
 
+/*
+ * When the server advertises byte ranges, nothing is downloaded at open
+ * besides the headers of a HEAD request: reads fetch the HTTP_BLOCK sized
+ * blocks they touch with `Range:` GETs over a kept-alive connection and keep
+ * the last HTTP_CACHE_BLOCKS of them around. Reads going on from where the
+ * previous fetch stopped double the number of blocks asked for at once, up
+ * to HTTP_AHEAD_MAX. Other servers get the whole resource downloaded into
+ * memory, as before.
+ */
+
+#define HTTP_BLOCK         0x10000
+#define HTTP_CACHE_BLOCKS  64
+#define HTTP_AHEAD_MAX     16
+#define HTTP_MAX_HEADER    0x2000
+#define HTTP_MAX_REDIRECTS 5
+#define HTTP_TIMEOUT       10
+
+typedef struct {
+	ut64 index; ///< block number, UT64_MAX if the slot is empty
+	ut64 used; ///< tick of the last use, the smallest is evicted first
+	ut64 size; ///< bytes in data, only the last block of the resource is short
+	ut8 *data;
+} HttpBlock;
+
+typedef struct {
+	char *host;
+	char *port;
+	char *path; ///< without the leading slash
+	RzSocket *s; ///< connection kept alive between requests, NULL if closed
+	ut64 size;
+	ut64 offset;
+	HttpBlock cache[HTTP_CACHE_BLOCKS];
+	ut64 tick;
+	ut64 next; ///< block following the last fetch, for spotting sequential reads
+	ut32 ahead; ///< blocks asked for by the next sequential fetch
+} HttpRange;
+
+typedef struct {
+	int code;
+	ut64 length; ///< Content-Length, UT64_MAX if missing
+	ut64 range_from; ///< first byte of Content-Range, UT64_MAX if missing
+	ut64 total; ///< resource size from Content-Range, UT64_MAX if missing
+	bool ranges; ///< Accept-Ranges: bytes
+	bool close; ///< Connection: close
+	char *location;
+} HttpAnswer;
+
 static bool __check(RzIO *io, const char *pathname, bool many) {
 	return (!strncmp(pathname, "http://", 7));
 }
 
+static void http_disconnect(HttpRange *h) {
+	rz_socket_free(h->s);
+	h->s = NULL;
+}
+
+static bool http_set_url(HttpRange *h, const char *url) {
+	if (!__check(NULL, url, false)) {
+		return false;
+	}
+	char *host = strdup(url + 7);
+	if (!host) {
+		return false;
+	}
+	char *path = strchr(host, '/');
+	if (path) {
+		*path++ = 0;
+	}
+	char *port = strchr(host, ':');
+	if (port) {
+		*port++ = 0;
+	}
+	free(h->host);
+	free(h->port);
+	free(h->path);
+	h->host = host;
+	h->port = strdup(port ? port : "80");
+	h->path = strdup(path ? path : "");
+	http_disconnect(h);
+	return h->port && h->path;
+}
+
+/**
+ * Value of the header \p name, which has to start a line of \p headers.
+ */
+static const char *header_value(const char *headers, const char *name) {
+	size_t len = strlen(name);
+	const char *p = headers;
+	while ((p = strchr(p, '\n'))) {
+		p++;
+		if (!rz_str_ncasecmp(p, name, len) && p[len] == ':') {
+			p += len + 1;
+			while (*p == ' ' || *p == '\t') {
+				p++;
+			}
+			return p;
+		}
+	}
+	return NULL;
+}
+
+static bool parse_answer(const char *headers, HttpAnswer *a) {
+	if (rz_str_ncasecmp(headers, "HTTP/1.", 7) || !headers[7] || headers[8] != ' ') {
+		return false;
+	}
+	a->code = atoi(headers + 9);
+	a->length = UT64_MAX;
+	a->range_from = UT64_MAX;
+	a->total = UT64_MAX;
+	const char *p = header_value(headers, "Content-Length");
+	if (p && IS_DIGIT(*p)) {
+		a->length = strtoull(p, NULL, 10);
+	}
+	p = header_value(headers, "Content-Range");
+	if (p && !rz_str_ncasecmp(p, "bytes ", 6)) {
+		p += 6;
+		if (IS_DIGIT(*p)) {
+			a->range_from = strtoull(p, NULL, 10);
+		}
+		p = strchr(p, '/');
+		if (p && IS_DIGIT(p[1])) {
+			a->total = strtoull(p + 1, NULL, 10);
+		}
+	}
+	p = header_value(headers, "Accept-Ranges");
+	a->ranges = p && !rz_str_ncasecmp(p, "bytes", 5);
+	p = header_value(headers, "Connection");
+	a->close = p ? !rz_str_ncasecmp(p, "close", 5) : headers[7] == '0';
+	p = header_value(headers, "Location");
+	if (p) {
+		a->location = rz_str_ndup(p, strcspn(p, "\r\n"));
+	}
+	return true;
+}
+
+static char *read_headers(RzSocket *s) {
+	char *buf = malloc(HTTP_MAX_HEADER + 1);
+	if (!buf) {
+		return NULL;
+	}
+	size_t i;
+	for (i = 0; i < HTTP_MAX_HEADER; i++) {
+		if (rz_socket_read_block(s, (ut8 *)buf + i, 1) != 1) {
+			break;
+		}
+		if (i >= 3 && !memcmp(buf + i - 3, "\r\n\r\n", 4)) {
+			buf[i + 1] = 0;
+			return buf;
+		}
+	}
+	free(buf);
+	return NULL;
+}
+
+/**
+ * Send a request for \p path, with a Range header if \p to is not 0, and
+ * read the headers of the answer. The body is left for the caller to read.
+ */
+static bool http_request(HttpRange *h, const char *method, ut64 from, ut64 to, HttpAnswer *a) {
+	memset(a, 0, sizeof(*a));
+	char range[64] = { 0 };
+	if (to) {
+		snprintf(range, sizeof(range), "Range: bytes=%" PFMT64u "-%" PFMT64u "\r\n", from, to - 1);
+	}
+	// an idle connection may have been dropped by the server, retry once on a new one
+	bool reused = h->s;
+	for (int attempt = 0; attempt < 2; attempt++) {
+		if (!h->s) {
+			h->s = rz_socket_new(false);
+			if (!h->s || !rz_socket_connect_tcp(h->s, h->host, h->port, HTTP_TIMEOUT)) {
+				http_disconnect(h);
+				return false;
+			}
+			rz_socket_block_time(h->s, true, HTTP_TIMEOUT, 0);
+		}
+		rz_socket_printf(h->s,
+			"%s /%s HTTP/1.1\r\n"
+			"User-Agent: rizin " RZ_VERSION "\r\n"
+			"Accept: */*\r\n"
+			"Host: %s:%s\r\n"
+			"Connection: keep-alive\r\n"
+			"%s"
+			"\r\n",
+			method, h->path, h->host, h->port, range);
+		char *headers = read_headers(h->s);
+		if (headers) {
+			bool ret = parse_answer(headers, a);
+			free(headers);
+			if (!ret) {
+				http_disconnect(h);
+			}
+			return ret;
+		}
+		http_disconnect(h);
+		if (!reused) {
+			break;
+		}
+		reused = false;
+	}
+	return false;
+}
+
+static HttpBlock *cache_slot(HttpRange *h, ut64 index, bool evict) {
+	HttpBlock *victim = NULL;
+	for (size_t i = 0; i < HTTP_CACHE_BLOCKS; i++) {
+		HttpBlock *blk = &h->cache[i];
+		if (blk->index == index) {
+			return blk;
+		}
+		// empty slots have used 0, so they go first
+		if (!victim || blk->used < victim->used) {
+			victim = blk;
+		}
+	}
+	return evict ? victim : NULL;
+}
+
+/**
+ * Fetch the blocks from \p index on, as many as the read-ahead asks for but
+ * stopping before any already cached, with a single request.
+ */
+static bool fetch_blocks(HttpRange *h, ut64 index) {
+	ut64 last = (h->size - 1) / HTTP_BLOCK;
+	h->ahead = index == h->next ? RZ_MIN(h->ahead * 2, HTTP_AHEAD_MAX) : 1;
+	ut64 count = 1;
+	while (count < h->ahead && index + count <= last && !cache_slot(h, index + count, false)) {
+		count++;
+	}
+	ut64 from = index * HTTP_BLOCK;
+	ut64 to = RZ_MIN((index + count) * HTTP_BLOCK, h->size);
+	HttpAnswer a;
+	if (!http_request(h, "GET", from, to, &a)) {
+		return false;
+	}
+	// a changed size means the resource was replaced under us
+	bool ret = a.code == 206 && a.range_from == from && a.length == to - from && (a.total == UT64_MAX || a.total == h->size);
+	free(a.location);
+	if (!ret) {
+		// whatever body came cannot be skipped reliably
+		http_disconnect(h);
+		return false;
+	}
+	h->next = index + count;
+	for (ut64 i = 0; i < count; i++) {
+		HttpBlock *blk = cache_slot(h, index + i, true);
+		if (!blk->data && !(blk->data = malloc(HTTP_BLOCK))) {
+			http_disconnect(h);
+			return i > 0;
+		}
+		blk->index = UT64_MAX;
+		blk->used = 0;
+		blk->size = RZ_MIN(to - from, HTTP_BLOCK);
+		if (rz_socket_read_block(h->s, blk->data, (int)blk->size) != (int)blk->size) {
+			http_disconnect(h);
+			return i > 0;
+		}
+		blk->index = index + i;
+		blk->used = ++h->tick;
+		from += blk->size;
+	}
+	if (a.close) {
+		http_disconnect(h);
+	}
+	return true;
+}
+
+static bool buf_http_init(RzBuffer *b, const void *user) {
+	b->priv = (void *)user;
+	return true;
+}
+
+static bool buf_http_fini(RzBuffer *b) {
+	HttpRange *h = b->priv;
+	http_disconnect(h);
+	for (size_t i = 0; i < HTTP_CACHE_BLOCKS; i++) {
+		free(h->cache[i].data);
+	}
+	free(h->host);
+	free(h->port);
+	free(h->path);
+	RZ_FREE(b->priv);
+	return true;
+}
+
+static ut64 buf_http_size(RzBuffer *b) {
+	HttpRange *h = b->priv;
+	return h->size;
+}
+
+static st64 buf_http_seek(RzBuffer *b, st64 addr, int whence) {
+	HttpRange *h = b->priv;
+	h->offset = rz_seek_offset(h->offset, h->size, addr, whence);
+	return RZ_MIN(h->offset, ST64_MAX);
+}
+
+static st64 buf_http_read(RzBuffer *b, ut8 *buf, ut64 len) {
+	HttpRange *h = b->priv;
+	if (h->offset >= h->size) {
+		return 0;
+	}
+	len = RZ_MIN(len, h->size - h->offset);
+	ut64 done = 0;
+	while (done < len) {
+		ut64 addr = h->offset + done;
+		ut64 index = addr / HTTP_BLOCK;
+		HttpBlock *blk = cache_slot(h, index, false);
+		if (!blk && (!fetch_blocks(h, index) || !(blk = cache_slot(h, index, false)))) {
+			break;
+		}
+		blk->used = ++h->tick;
+		ut64 delta = addr - index * HTTP_BLOCK;
+		ut64 n = RZ_MIN(len - done, blk->size - delta);
+		memcpy(buf + done, blk->data + delta, n);
+		done += n;
+	}
+	if (!done && len) {
+		return -1;
+	}
+	h->offset += done;
+	return done;
+}
+
+static const RzBufferMethods buffer_http_methods = {
+	.init = buf_http_init,
+	.fini = buf_http_fini,
+	.read = buf_http_read,
+	.get_size = buf_http_size,
+	.seek = buf_http_seek,
+};
+
+/**
+ * Ask the server for the size of \p url and whether it serves byte ranges,
+ * following redirects to other plain http urls.
+ */
+static HttpRange *http_range_new(const char *url) {
+	HttpRange *h = RZ_NEW0(HttpRange);
+	if (!h) {
+		return NULL;
+	}
+	for (size_t i = 0; i < HTTP_CACHE_BLOCKS; i++) {
+		h->cache[i].index = UT64_MAX;
+	}
+	h->next = UT64_MAX;
+	char *next = NULL;
+	bool ok = false;
+	for (int redirections = 0; redirections <= HTTP_MAX_REDIRECTS && http_set_url(h, next ? next : url); redirections++) {
+		HttpAnswer a;
+		RZ_FREE(next);
+		if (!http_request(h, "HEAD", 0, 0, &a)) {
+			break;
+		}
+		if (a.code >= 300 && a.code < 400 && a.location) {
+			next = a.location;
+			continue;
+		}
+		free(a.location);
+		ok = a.code == 200 && a.ranges && a.length && a.length != UT64_MAX;
+		h->size = a.length;
+		if (a.close) {
+			http_disconnect(h);
+		}
+		break;
+	}
+	free(next);
+	if (!ok) {
+		http_disconnect(h);
+		free(h->host);
+		free(h->port);
+		free(h->path);
+		free(h);
+		return NULL;
+	}
+	return h;
+}
+
+static RzBuffer *http_range_open(const char *url) {
+	HttpRange *h = http_range_new(url);
+	if (!h) {
+		return NULL;
+	}
+	RzBuffer *ranged = rz_buf_new_with_methods(&buffer_http_methods, h);
+	if (!ranged) {
+		free(h->host);
+		free(h->port);
+		free(h->path);
+		free(h);
+		return NULL;
+	}
+	// writes stay local, in a sparse overlay
+	RzBuffer *buf = rz_buf_new_sparse_overlay(ranged, RZ_BUF_SPARSE_WRITE_MODE_SPARSE);
+	rz_buf_free(ranged);
+	return buf;
+}
+
+static int http_range_read(RzIO *io, RzIODesc *fd, ut8 *buf, int count) {
+	memset(buf, 0xff, count);
+	if (!fd || !fd->data) {
+		return -1;
+	}
+	ut64 size = rz_buf_size(fd->data);
+	ut64 off = rz_buf_tell(fd->data);
+	if (off > size) {
+		return -1;
+	}
+	count = (int)RZ_MIN((ut64)count, size - off);
+	st64 r = rz_buf_read(fd->data, buf, count);
+	return r < 0 ? -1 : (int)r;
+}
+
+static int http_range_write(RzIO *io, RzIODesc *fd, const ut8 *buf, int count) {
+	if (!fd || !buf || count < 0 || !fd->data) {
+		return -1;
+	}
+	ut64 size = rz_buf_size(fd->data);
+	ut64 off = rz_buf_tell(fd->data);
+	if (off >= size) {
+		return -1;
+	}
+	count = (int)RZ_MIN((ut64)count, size - off);
+	st64 r = rz_buf_write(fd->data, buf, count);
+	return r <= 0 ? -1 : (int)r;
+}
+
+static ut64 http_range_lseek(RzIO *io, RzIODesc *fd, ut64 offset, int whence) {
+	if (!fd || !fd->data) {
+		return offset;
+	}
+	return rz_buf_seek(fd->data, offset, whence);
+}
+
+static int http_range_close(RzIODesc *fd) {
+	if (!fd || !fd->data) {
+		return -1;
+	}
+	rz_buf_free(fd->data);
+	fd->data = NULL;
+	return 0;
+}
+
 static RzIODesc *__open(RzIO *io, const char *pathname, int rw, int mode) {
 	if (__check(io, pathname, 0)) {
+		RzBuffer *ranged = http_range_open(pathname);
+		if (ranged) {
+			return rz_io_desc_new(io, &rz_io_plugin_http, pathname, RZ_PERM_RW | rw, mode, ranged);
+		}
 		int rlen, code;
 		RzIOMalloc *mal = RZ_NEW0(RzIOMalloc);
 		if (!mal) {
@@ -37,11 +476,11 @@ RzIOPlugin rz_io_plugin_http = {
 	.uris = "http://",
 	.license = "LGPL3",
 	.open = __open,
-	.close = io_memory_close,
-	.read = io_memory_read,
+	.close = http_range_close,
+	.read = http_range_read,
 	.check = __check,
-	.lseek = io_memory_lseek,
-	.write = io_memory_write,
+	.lseek = http_range_lseek,
+	.write = http_range_write,
 };
 
 #ifndef RZ_PLUGIN_INCORE
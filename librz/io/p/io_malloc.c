@@ -59,6 +59,7 @@ RzIOPlugin rz_io_plugin_malloc = {
 	.lseek = io_memory_lseek,
 	.write = io_memory_write,
 	.resize = io_memory_resize,
+	.borrow = io_memory_borrow,
 };
 
 #ifndef RZ_PLUGIN_INCORE
@@ -13,10 +13,33 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <errno.h>
+#if HAVE_PROCESS_VM_READV
+#include <sys/uio.h>
+#endif
+
+/*
+ * Reads use pread, or process_vm_readv for batches, so they don't depend on
+ * a shared file offset and may come from several threads at once. The
+ * mappings of the process are cached to split reads at the holes, which
+ * /proc/pid/mem would fail on, and read the mapped parts with one call
+ * each. The cache is refreshed when a read inside it fails, or when an
+ * address outside of it is asked for and it's older than PROCPID_MAPS_TTL.
+ */
+#define PROCPID_MAPS_TTL (250 * 1000) ///< microseconds
+#define PROCPID_IOV_MAX  1024
+
+typedef struct {
+	ut64 from;
+	ut64 to;
+} ProcpidSpan;
 
 typedef struct {
 	int fd;
 	int pid;
+	bool vm_rw; ///< process_vm_readv can be used
+	RzThreadLock *lock; ///< protects the fields below
+	RzVector /*<ProcpidSpan>*/ spans; ///< contiguous mappings of pid, sorted
+	ut64 spans_time; ///< when the spans were read, 0 if they must be
 } RzIOProcpid;
 
 #define RzIOPROCPID_PID(x) (((RzIOProcpid *)(x)->data)->pid)
@@ -27,23 +50,187 @@ static int __waitpid(int pid) {
 	return (waitpid(pid, &st, 0) != -1);
 }
 
-static int debug_os_read_at(int fdn, void *buf, int sz, ut64 addr) {
-	if (lseek(fdn, addr, 0) < 0) {
+static bool spans_load(RzIOProcpid *iop) {
+	char path[64];
+	snprintf(path, sizeof(path), "/proc/%d/maps", iop->pid);
+	FILE *f = rz_sys_fopen(path, "r");
+	if (!f) {
+		return false;
+	}
+	rz_vector_clear(&iop->spans);
+	char line[1024];
+	while (fgets(line, sizeof(line), f)) {
+		ut64 from, to;
+		if (sscanf(line, "%" PFMT64x "-%" PFMT64x, &from, &to) != 2 || from >= to) {
+			continue;
+		}
+		ProcpidSpan *last = rz_vector_empty(&iop->spans) ? NULL : rz_vector_tail(&iop->spans);
+		if (last && last->to == from) {
+			last->to = to;
+			continue;
+		}
+		ProcpidSpan *span = rz_vector_push(&iop->spans, NULL);
+		if (!span) {
+			break;
+		}
+		span->from = from;
+		span->to = to;
+	}
+	fclose(f);
+	iop->spans_time = rz_time_now_mono();
+	return true;
+}
+
+static bool spans_cover(RzIOProcpid *iop, ut64 from, ut64 to) {
+	ProcpidSpan *span;
+	rz_vector_foreach(&iop->spans, span) {
+		if (span->to <= from) {
+			continue;
+		}
+		if (span->from > from) {
+			return false;
+		}
+		from = span->to;
+		if (from >= to) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Put the mapped parts of [from, to) in \p parts, reloading the mappings
+ * when \p reload or when the cached ones look out of date.
+ */
+static void spans_collect(RzIOProcpid *iop, ut64 from, ut64 to, bool reload, RzVector *parts) {
+	rz_th_lock_enter(iop->lock);
+	if (reload || !iop->spans_time ||
+		(!spans_cover(iop, from, to) && rz_time_now_mono() - iop->spans_time > PROCPID_MAPS_TTL)) {
+		if (!spans_load(iop)) {
+			// no maps to look at, let the reads find out
+			rz_vector_clear(&iop->spans);
+			ProcpidSpan *all = rz_vector_push(&iop->spans, NULL);
+			if (all) {
+				all->from = 0;
+				all->to = UT64_MAX;
+			}
+		}
+	}
+	ProcpidSpan *span;
+	rz_vector_foreach(&iop->spans, span) {
+		if (span->to <= from) {
+			continue;
+		}
+		if (span->from >= to) {
+			break;
+		}
+		ProcpidSpan *part = rz_vector_push(parts, NULL);
+		if (!part) {
+			break;
+		}
+		part->from = RZ_MAX(span->from, from);
+		part->to = RZ_MIN(span->to, to);
+	}
+	rz_th_lock_leave(iop->lock);
+}
+
+static ut64 pread_all(int fd, ut8 *buf, ut64 len, ut64 addr) {
+	ut64 done = 0;
+	while (done < len && addr + done <= ST64_MAX) {
+		ssize_t r = pread(fd, buf + done, len - done, (off_t)(addr + done));
+		if (r < 1) {
+			break;
+		}
+		done += r;
+	}
+	return done;
+}
+
+/**
+ * Read [addr, addr + len), the unmapped bytes are left as 0xff. Returns the
+ * size of the prefix that could be read, like a read of /proc/pid/mem would.
+ */
+static int procpid_read_at(RzIOProcpid *iop, ut8 *buf, int len, ut64 addr) {
+	if (len < 1) {
 		return -1;
 	}
-	return read(fdn, buf, sz);
+	memset(buf, 0xff, len);
+	ut64 end = addr + len;
+	if (end < addr) {
+		end = UT64_MAX;
+	}
+	RzVector parts;
+	rz_vector_init(&parts, sizeof(ProcpidSpan), NULL, NULL);
+	int ret = -1;
+	for (int attempt = 0; attempt < 2; attempt++) {
+		rz_vector_clear(&parts);
+		spans_collect(iop, addr, end, attempt > 0, &parts);
+		ut64 prefix = addr;
+		bool changed = false;
+		ProcpidSpan *part;
+		rz_vector_foreach(&parts, part) {
+			ut64 n = pread_all(iop->fd, buf + (part->from - addr), part->to - part->from, part->from);
+			if (n != part->to - part->from) {
+				changed = true;
+			}
+			if (part->from == prefix) {
+				prefix += n;
+			}
+		}
+		ret = prefix > addr ? (int)(prefix - addr) : -1;
+		if (!changed) {
+			break;
+		}
+		// the mappings moved since they were read
+	}
+	rz_vector_fini(&parts);
+	return ret;
 }
 
 static int __read(RzIO *io, RzIODesc *fd, ut8 *buf, int len) {
-	memset(buf, 0xff, len); // TODO: only memset the non-readed bytes
-	return debug_os_read_at(RzIOPROCPID_FD(fd), buf, len, io->off);
+	return procpid_read_at(fd->data, buf, len, io->off);
+}
+
+static bool __readv(RzIO *io, RzIODesc *fd, const RzIOVec *vecs, size_t n) {
+	RzIOProcpid *iop = fd->data;
+	size_t i = 0;
+#if HAVE_PROCESS_VM_READV
+	// all the ranges with as few calls as possible, they fail at the first hole
+	struct iovec local[PROCPID_IOV_MAX], remote[PROCPID_IOV_MAX];
+	while (iop->vm_rw && i < n) {
+		size_t count = RZ_MIN(n - i, PROCPID_IOV_MAX);
+		ssize_t want = 0;
+		for (size_t j = 0; j < count; j++) {
+			local[j].iov_base = vecs[i + j].buf;
+			local[j].iov_len = vecs[i + j].len;
+			remote[j].iov_base = (void *)(size_t)vecs[i + j].addr;
+			remote[j].iov_len = vecs[i + j].len;
+			want += vecs[i + j].len;
+		}
+		ssize_t r = process_vm_readv(iop->pid, local, count, remote, count, 0);
+		if (r < 0 && (errno == ENOSYS || errno == EPERM)) {
+			iop->vm_rw = false;
+			break;
+		}
+		if (r != want) {
+			return false;
+		}
+		i += count;
+	}
+#endif
+	for (; i < n; i++) {
+		if (procpid_read_at(iop, vecs[i].buf, vecs[i].len, vecs[i].addr) != vecs[i].len) {
+			return false;
+		}
+	}
+	return true;
 }
 
 static int procpid_write_at(int fd, const ut8 *buf, int sz, ut64 addr) {
-	if (lseek(fd, addr, 0) < 0) {
+	if (addr > ST64_MAX) {
 		return -1;
 	}
-	return write(fd, buf, sz);
+	return pwrite(fd, buf, sz, (off_t)addr);
 }
 
 static int __write(RzIO *io, RzIODesc *fd, const ut8 *buf, int len) {
@@ -79,12 +266,15 @@ static RzIODesc *__open(RzIO *io, const char *file, int rw, int mode) {
 		fd = rz_sys_open(procpidpath, O_RDWR, 0);
 		if (fd != -1) {
 			RzIOProcpid *riop = RZ_NEW0(RzIOProcpid);
-			if (!riop) {
+			if (!riop || !(riop->lock = rz_th_lock_new(false))) {
+				free(riop);
 				close(fd);
 				return NULL;
 			}
 			riop->pid = pid;
 			riop->fd = fd;
+			riop->vm_rw = true;
+			rz_vector_init(&riop->spans, sizeof(ProcpidSpan), NULL, NULL);
 			RzIODesc *d = rz_io_desc_new(io, &rz_io_plugin_procpid, file, true, 0, riop);
 			d->name = rz_sys_pid_to_path(riop->pid);
 			return d;
@@ -101,7 +291,11 @@ static ut64 __lseek(RzIO *io, RzIODesc *fd, ut64 offset, int whence) {
 }
 
 static int __close(RzIODesc *fd) {
-	int ret = ptrace(PTRACE_DETACH, RzIOPROCPID_PID(fd), 0, 0);
+	RzIOProcpid *iop = fd->data;
+	int ret = ptrace(PTRACE_DETACH, iop->pid, 0, 0);
+	close(iop->fd);
+	rz_th_lock_free(iop->lock);
+	rz_vector_fini(&iop->spans);
 	RZ_FREE(fd->data);
 	return ret;
 }
@@ -111,7 +305,10 @@ static char *__system(RzIO *io, RzIODesc *fd, const char *cmd) {
 	if (!strncmp(cmd, "pid", 3)) {
 		int pid = atoi(cmd + 3);
 		if (pid > 0) {
+			rz_th_lock_enter(iop->lock);
 			iop->pid = pid;
+			iop->spans_time = 0;
+			rz_th_lock_leave(iop->lock);
 		}
 		io->cb_printf("%d\n", iop->pid);
 	} else {
@@ -128,6 +325,7 @@ RzIOPlugin rz_io_plugin_procpid = {
 	.open = __open,
 	.close = __close,
 	.read = __read,
+	.readv = __readv,
 	.check = __plugin_open,
 	.lseek = __lseek,
 	.system = __system,
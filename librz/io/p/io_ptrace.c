@@ -14,17 +14,22 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <errno.h>
+#if HAVE_PROCESS_VM_READV
+#include <sys/uio.h>
+#endif
 
 typedef struct {
 	int pid;
 	int tid;
-	int fd;
+	int fd; ///< /proc/pid/mem of opid, or -1
 	int opid;
+	bool vm_rw; ///< process_vm_readv/writev can be used
 } RzIOPtrace;
 #define RzIOPTRACE_OPID(x) (((RzIOPtrace *)(x)->data)->opid)
 #define RzIOPTRACE_PID(x)  (((RzIOPtrace *)(x)->data)->pid)
 #define RzIOPTRACE_FD(x)   (((RzIOPtrace *)(x)->data)->fd)
 static void open_pidmem(RzIOPtrace *iop);
+static void close_pidmem(RzIOPtrace *iop);
 
 #undef RZ_IO_NFDS
 #define RZ_IO_NFDS 2
@@ -41,12 +46,14 @@ extern int errno;
 #endif
 #endif
 
-#if 0
-procpidmem is buggy.. running this sometimes results in ffff
-
-	while : ; do rizin -qc 'oo;x' -d ls ; done
-#endif
-#define USE_PROC_PID_MEM 0
+/*
+ * Memory is moved with process_vm_readv/writev first, then with
+ * pread/pwrite on /proc/pid/mem, which can also write to read-only pages,
+ * and only what both refused goes through PEEKTEXT/POKEDATA one word at a
+ * time. The fast paths stop at the first page they cannot access, so the
+ * slow path is given one page at a time before they are retried.
+ */
+#define PTRACE_IO_PAGE 0x1000
 
 static int __waitpid(int pid) {
 	int st = 0;
@@ -81,49 +88,114 @@ static int debug_os_read_at(RzIO *io, int pid, ut32 *buf, int sz, ut64 addr) {
 	return sz;
 }
 
-static int __read(RzIO *io, RzIODesc *desc, ut8 *buf, int len) {
-#if USE_PROC_PID_MEM
-	int ret, fd;
+static int ptrace_page_left(ut64 addr, int len) {
+	ut64 left = PTRACE_IO_PAGE - (addr & (PTRACE_IO_PAGE - 1));
+	return left < len ? (int)left : len;
+}
+
+static bool pidmem_sync(RzIOPtrace *iop) {
+	if (iop->pid != iop->opid && iop->fd != -1) {
+		// the debugger switched to another process
+		close(iop->fd);
+		open_pidmem(iop);
+	}
+	return iop->fd != -1;
+}
+
+static void vm_rw_check(RzIOPtrace *iop) {
+	if (errno == ENOSYS || errno == EPERM) {
+		// not in this kernel or not allowed, no point in asking again
+		iop->vm_rw = false;
+	}
+}
+
+/**
+ * Read as much as possible from the start of [addr, addr + len) without
+ * ptrace, returns the number of bytes read.
+ */
+static int fast_read_at(RzIOPtrace *iop, ut8 *buf, int len, ut64 addr) {
+#if HAVE_PROCESS_VM_READV
+	if (iop->vm_rw) {
+		struct iovec local = { buf, len };
+		struct iovec remote = { (void *)(size_t)addr, len };
+		ssize_t r = process_vm_readv(iop->pid, &local, 1, &remote, 1, 0);
+		if (r > 0) {
+			return (int)r;
+		}
+		vm_rw_check(iop);
+	}
 #endif
+	if (addr <= ST64_MAX && pidmem_sync(iop)) {
+		ssize_t r = pread(iop->fd, buf, len, (off_t)addr);
+		if (!r) {
+			// the process called exec and the file still points to the old address space
+			close_pidmem(iop);
+			open_pidmem(iop);
+			r = iop->fd != -1 ? pread(iop->fd, buf, len, (off_t)addr) : -1;
+		}
+		if (r > 0) {
+			return (int)r;
+		}
+	}
+	return 0;
+}
+
+static int fast_write_at(RzIOPtrace *iop, const ut8 *buf, int len, ut64 addr) {
+#if HAVE_PROCESS_VM_READV
+	if (iop->vm_rw) {
+		struct iovec local = { (void *)buf, len };
+		struct iovec remote = { (void *)(size_t)addr, len };
+		ssize_t r = process_vm_writev(iop->pid, &local, 1, &remote, 1, 0);
+		if (r > 0) {
+			return (int)r;
+		}
+		vm_rw_check(iop);
+	}
+#endif
+	if (addr <= ST64_MAX && pidmem_sync(iop)) {
+		ssize_t r = pwrite(iop->fd, buf, len, (off_t)addr);
+		if (r > 0) {
+			return (int)r;
+		}
+	}
+	return 0;
+}
+
+static int __read(RzIO *io, RzIODesc *desc, ut8 *buf, int len) {
 	ut64 addr = io->off;
 	if (!desc || !desc->data) {
 		return -1;
 	}
-	memset(buf, '\xff', len); // TODO: only memset the non-readed bytes
-	/* reopen procpidmem if necessary */
-#if USE_PROC_PID_MEM
-	fd = RzIOPTRACE_FD(desc);
-	if (RzIOPTRACE_PID(desc) != RzIOPTRACE_OPID(desc)) {
-		if (fd != -1) {
-			close(fd);
-		}
-		open_pidmem((RzIOPtrace *)desc->data);
-		fd = RzIOPTRACE_FD(desc);
-		RzIOPTRACE_OPID(desc) = RzIOPTRACE_PID(desc);
+	if (len < 1 || addr == UT64_MAX) {
+		return -1;
 	}
-	// /proc/pid/mem fails on latest linux
-	if (fd != -1) {
-		ret = lseek(fd, addr, SEEK_SET);
-		if (ret >= 0) {
-			// Workaround for the buggy Debian Wheeze's /proc/pid/mem
-			if (read(fd, buf, len) != -1) {
-				return ret;
+	RzIOPtrace *iop = desc->data;
+	ut32 *aligned_buf = NULL;
+	int done = 0;
+	while (done < len) {
+		int n = fast_read_at(iop, buf + done, len - done, addr + done);
+		if (n > 0) {
+			done += n;
+			continue;
+		}
+		n = ptrace_page_left(addr + done, len - done);
+		if (!aligned_buf) {
+			aligned_buf = (ut32 *)rz_malloc_aligned(PTRACE_IO_PAGE, sizeof(ut32));
+			if (!aligned_buf) {
+				return -1;
 			}
 		}
+		debug_os_read_at(io, iop->pid, aligned_buf, n, addr + done);
+		memcpy(buf + done, aligned_buf, n);
+		done += n;
 	}
-#endif
-	ut32 *aligned_buf = (ut32 *)rz_malloc_aligned(len, sizeof(ut32));
 	if (aligned_buf) {
-		int res = debug_os_read_at(io, RzIOPTRACE_PID(desc), (ut32 *)aligned_buf, len, addr);
-		memcpy(buf, aligned_buf, len);
 		rz_free_aligned(aligned_buf);
-		return res;
 	}
-	return -1;
+	return len;
 }
 
-static int ptrace_write_at(RzIO *io, int pid, const ut8 *pbuf, int sz, ut64 addr) {
-	ptrace_word *buf = (ptrace_word *)pbuf;
+static int ptrace_write_at(RzIO *io, int pid, const ut8 *buf, int sz, ut64 addr) {
 	ut32 words = sz / sizeof(ptrace_word);
 	ut32 last = sz % sizeof(ptrace_word);
 	ptrace_word x, *at = (ptrace_word *)(size_t)addr;
@@ -132,14 +204,16 @@ static int ptrace_write_at(RzIO *io, int pid, const ut8 *pbuf, int sz, ut64 addr
 		return -1;
 	}
 	for (x = 0; x < words; x++) {
-		int rc = debug_write_raw(io, pid, at++, buf[x]); //((ut32*)(at)), buf[x]);
+		// buf may point anywhere in the caller's buffer
+		memcpy(&lr, buf + x * sizeof(ptrace_word), sizeof(ptrace_word));
+		int rc = debug_write_raw(io, pid, at++, lr);
 		if (rc) {
 			return -1;
 		}
 	}
 	if (last) {
 		lr = debug_read_raw(io, pid, (void *)at);
-		memcpy(&lr, buf + x, last);
+		memcpy(&lr, buf + x * sizeof(ptrace_word), last);
 		if (debug_write_raw(io, pid, (void *)at, lr)) {
 			return sz - last;
 		}
@@ -151,25 +225,41 @@ static int __write(RzIO *io, RzIODesc *fd, const ut8 *buf, int len) {
 	if (!fd || !fd->data) {
 		return -1;
 	}
-	return ptrace_write_at(io, RzIOPTRACE_PID(fd), buf, len, io->off);
+	ut64 addr = io->off;
+	if (len < 1 || addr == UT64_MAX) {
+		return -1;
+	}
+	RzIOPtrace *iop = fd->data;
+	int done = 0;
+	while (done < len) {
+		int n = fast_write_at(iop, buf + done, len - done, addr + done);
+		if (n > 0) {
+			done += n;
+			continue;
+		}
+		n = ptrace_page_left(addr + done, len - done);
+		int r = ptrace_write_at(io, iop->pid, buf + done, n, addr + done);
+		if (r < n) {
+			r = done + RZ_MAX(r, 0);
+			return r ? r : -1;
+		}
+		done += n;
+	}
+	return len;
 }
 
 static void open_pidmem(RzIOPtrace *iop) {
-#if USE_PROC_PID_MEM
+#if __linux__
 	char pidmem[32];
 	snprintf(pidmem, sizeof(pidmem), "/proc/%d/mem", iop->pid);
-	iop->fd = open(pidmem, O_RDWR);
+	iop->fd = open(pidmem, O_RDWR | O_CLOEXEC);
 	if (iop->fd == -1) {
-		iop->fd = open(pidmem, O_RDONLY);
+		iop->fd = open(pidmem, O_RDONLY | O_CLOEXEC);
 	}
-#if 0
-	if (iop->fd == -1)
-		eprintf ("Warning: Cannot open /proc/%d/mem. "
-			"Fallback to ptrace io.\n", iop->pid);
-#endif
 #else
 	iop->fd = -1;
 #endif
+	iop->opid = iop->pid;
 }
 
 static void close_pidmem(RzIOPtrace *iop) {
@@ -248,6 +338,7 @@ static RzIODesc *__open(RzIO *io, const char *file, int rw, int mode) {
 	}
 
 	riop->pid = riop->tid = pid;
+	riop->vm_rw = HAVE_PROCESS_VM_READV;
 	open_pidmem(riop);
 	desc = rz_io_desc_new(io, &rz_io_plugin_ptrace, file, rw | RZ_PERM_X, mode, riop);
 	desc->name = rz_sys_pid_to_path(pid);
@@ -299,14 +390,17 @@ static char *__system(RzIO *io, RzIODesc *fd, const char *cmd) {
 	}
 	if (!strcmp(cmd, "help")) {
 		eprintf("Usage: R!cmd args\n"
-			" R!ptrace   - use ptrace io\n"
-			" R!mem      - use /proc/pid/mem io if possible\n"
+			" R!ptrace   - use ptrace io only\n"
+			" R!mem      - use process_vm_readv and /proc/pid/mem io if possible\n"
 			" R!pid      - show targeted pid\n"
 			" R!pid <#>  - select new pid\n");
 	} else if (!strcmp(cmd, "ptrace")) {
 		close_pidmem(iop);
+		iop->vm_rw = false;
 	} else if (!strcmp(cmd, "mem")) {
+		close_pidmem(iop);
 		open_pidmem(iop);
+		iop->vm_rw = HAVE_PROCESS_VM_READV;
 	} else if (!strncmp(cmd, "pid", 3)) {
 		if (iop) {
 			if (cmd[3] == ' ') {
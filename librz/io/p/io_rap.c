@@ -11,6 +11,8 @@ typedef struct {
 	RzSocket *fd;
 	RzSocket *client;
 	bool listener;
+	ut32 caps; ///< RAP_CAP_* of the server
+	ut64 offset; ///< kept here, every read and write tells the server where
 } RzIORap;
 
 #define RzIORAP_FD(x)        (((x)->data) ? (((RzIORap *)((x)->data))->client) : NULL)
@@ -19,7 +21,15 @@ typedef struct {
 
 static int __rap_write(RzIO *io, RzIODesc *fd, const ut8 *buf, int count) {
 	RzSocket *s = RzIORAP_FD(fd);
-	return rz_socket_rap_client_write(s, buf, count);
+	if (!s) {
+		return -1;
+	}
+	RzIORap *rap = fd->data;
+	int ret = rz_socket_rap_client_write_at(s, rap->offset, buf, count);
+	if (ret > 0) {
+		rap->offset += ret;
+	}
+	return ret;
 }
 
 static bool __rap_accept(RzIO *io, RzIODesc *desc, int fd) {
@@ -33,7 +43,35 @@ static bool __rap_accept(RzIO *io, RzIODesc *desc, int fd) {
 
 static int __rap_read(RzIO *io, RzIODesc *fd, ut8 *buf, int count) {
 	RzSocket *s = RzIORAP_FD(fd);
-	return rz_socket_rap_client_read(s, buf, count);
+	if (!s) {
+		return -1;
+	}
+	RzIORap *rap = fd->data;
+	int ret = rz_socket_rap_client_read_at(s, rap->caps, rap->offset, buf, count);
+	if (ret > 0) {
+		rap->offset += ret;
+	}
+	return ret;
+}
+
+static bool __rap_readv(RzIO *io, RzIODesc *fd, const RzIOVec *vecs, size_t n) {
+	RzSocket *s = RzIORAP_FD(fd);
+	if (!s) {
+		return false;
+	}
+	RzIORap *rap = fd->data;
+	RzSocketRapIov *iov = RZ_NEWS(RzSocketRapIov, RZ_MAX(n, 1));
+	if (!iov) {
+		return false;
+	}
+	for (size_t i = 0; i < n; i++) {
+		iov[i].addr = vecs[i].addr;
+		iov[i].buf = vecs[i].buf;
+		iov[i].len = vecs[i].len;
+	}
+	bool ret = rz_socket_rap_client_readv(s, rap->caps, iov, n);
+	free(iov);
+	return ret;
 }
 
 static int __rap_close(RzIODesc *fd) {
@@ -59,7 +97,23 @@ static int __rap_close(RzIODesc *fd) {
 
 static ut64 __rap_lseek(RzIO *io, RzIODesc *fd, ut64 offset, int whence) {
 	RzSocket *s = RzIORAP_FD(fd);
-	return rz_socket_rap_client_seek(s, offset, whence);
+	if (!s) {
+		return UT64_MAX;
+	}
+	RzIORap *rap = fd->data;
+	switch (whence) {
+	case SEEK_SET:
+		rap->offset = offset;
+		break;
+	case SEEK_CUR:
+		rap->offset += offset;
+		break;
+	default:
+		// only the server knows the size
+		rap->offset = rz_socket_rap_client_seek(s, offset, whence);
+		break;
+	}
+	return rap->offset;
 }
 
 static bool __rap_plugin_open(RzIO *io, const char *pathname, bool many) {
@@ -144,7 +198,7 @@ static RzIODesc *__rap_open(RzIO *io, const char *pathname, int rw, int mode) {
 	rior->listener = false;
 	rior->client = rior->fd = s;
 	if (file && *file) {
-		i = rz_socket_rap_client_open(s, file, rw);
+		i = rz_socket_rap_client_open_caps(s, file, rw, &rior->caps);
 		if (i == -1) {
 			free(rior);
 			rz_socket_free(s);
@@ -285,6 +339,7 @@ RzIOPlugin rz_io_plugin_rap = {
 	.open = __rap_open,
 	.close = __rap_close,
 	.read = __rap_read,
+	.readv = __rap_readv,
 	.check = __rap_plugin_open,
 	.lseek = __rap_lseek,
 	.system = __rap_system,
@@ -140,6 +140,12 @@ static int __read(RzIO *io, RzIODesc *fd, ut8 *buf, int count) {
 	return winkd_read_at(fd->data, io->off, buf, count);
 }
 
+static ut64 __generation(RzIODesc *fd) {
+	// bumped by winkd_continue() and process switches
+	KdCtx *ctx = fd ? fd->data : NULL;
+	return ctx ? ctx->windctx.mem_gen : 0;
+}
+
 static int __close(RzIODesc *fd) {
 	winkd_kdctx_free((KdCtx **)&fd->data);
 	return true;
@@ -156,6 +162,7 @@ RzIOPlugin rz_io_plugin_winkd = {
 	.check = __plugin_open,
 	.lseek = __lseek,
 	.write = __write,
+	.generation = __generation,
 	.isdbg = true
 };
 
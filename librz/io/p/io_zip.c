@@ -119,6 +119,46 @@ struct zip *rz_io_zip_open_archive(const char *archivename, ut32 perm, int mode,
 	return NULL;
 }
 
+/**
+ * Whether the entry can be served by inflating its raw data on demand,
+ * which needs a plain deflate entry and no writes to flush back.
+ */
+static bool zip_entry_inflatable(RzIOZipFileObj *zfo, struct zip_stat *sb) {
+	const zip_uint64_t need = ZIP_STAT_SIZE | ZIP_STAT_COMP_SIZE | ZIP_STAT_COMP_METHOD | ZIP_STAT_ENCRYPTION_METHOD;
+	return !(zfo->perm & RZ_PERM_W) && (sb->valid & need) == need &&
+		sb->comp_method == ZIP_CM_DEFLATE && sb->encryption_method == ZIP_EM_NONE;
+}
+
+/**
+ * Keep only the compressed data of the entry in memory and decompress
+ * it as it is read.
+ */
+static bool zip_entry_open_inflate(RzIOZipFileObj *zfo, struct zip *zipArch, struct zip_stat *sb) {
+	struct zip_file *zFile = zip_fopen_index(zipArch, zfo->entry, ZIP_FL_COMPRESSED);
+	if (!zFile) {
+		return false;
+	}
+	ut8 *data = malloc(sb->comp_size ? sb->comp_size : 1);
+	bool res = false;
+	if (data && zip_fread(zFile, data, sb->comp_size) == (zip_int64_t)sb->comp_size) {
+		RzBuffer *raw = rz_buf_new_with_pointers(data, sb->comp_size, true);
+		data = NULL;
+		RzBuffer *inflated = raw ? rz_buf_new_inflatew(raw, -15) : NULL;
+		rz_buf_free(raw);
+		if (inflated && rz_buf_size(inflated) == sb->size) {
+			rz_buf_free(zfo->b);
+			zfo->b = inflated;
+			zfo->opened = true;
+			res = true;
+		} else {
+			rz_buf_free(inflated);
+		}
+	}
+	free(data);
+	zip_fclose(zFile);
+	return res;
+}
+
 static int rz_io_zip_slurp_file(RzIOZipFileObj *zfo) {
 	struct zip_file *zFile = NULL;
 	struct zip *zipArch;
@@ -131,7 +171,15 @@ static int rz_io_zip_slurp_file(RzIOZipFileObj *zfo) {
 		zfo->archivename, zfo->perm,
 		zfo->mode, zfo->rw);
 
-	if (zipArch && zfo && zfo->entry != -1) {
+	if (zipArch && zfo->entry != -1) {
+		zip_stat_init(&sb);
+		if (!zip_stat_index(zipArch, zfo->entry, 0, &sb) && zip_entry_inflatable(zfo, &sb) &&
+			zip_entry_open_inflate(zfo, zipArch, &sb)) {
+			zip_close(zipArch);
+			return true;
+		}
+	}
+	if (zipArch && zfo->entry != -1) {
 		zFile = zip_fopen_index(zipArch, zfo->entry, 0);
 		if (!zFile) {
 			zip_close(zipArch);
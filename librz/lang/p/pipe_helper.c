@@ -4,12 +4,16 @@
 #include <rz_lib.h>
 #include <rz_core.h>
 #include <rz_lang.h>
+#include <rz_socket.h>
 #if __WINDOWS__
 #include <windows.h>
 #endif
 #ifdef _MSC_VER
 #include <process.h>
 #endif
+#if HAVE_SHM_OPEN
+#include <sys/mman.h>
+#endif
 
 #if __WINDOWS__
 static HANDLE myCreateChildProcess(const char *szCmdline) {
@@ -127,6 +131,203 @@ static void env(const char *s, int f) {
 	//	eprintf ("%s %s\n", s, a);
 	free(a);
 }
+
+static bool write_all(int fd, const ut8 *buf, size_t len) {
+	while (len > 0) {
+		ssize_t w = write(fd, buf, len);
+		if (w < 1) {
+			return false;
+		}
+		buf += w;
+		len -= w;
+	}
+	return true;
+}
+
+static void frame_reply(RzStrBuf *out, ut8 status, const void *payload, ut32 len) {
+	ut8 hdr[RZPIPE_FRAME_HDR_SIZE];
+	rz_write_le32(hdr, len);
+	hdr[4] = status;
+	rz_strbuf_append_n(out, (const char *)hdr, sizeof(hdr));
+	if (len) {
+		rz_strbuf_append_n(out, payload, len);
+	}
+}
+
+static bool frame_flush(int fd, RzStrBuf *out) {
+	bool ret = write_all(fd, (const ut8 *)rz_strbuf_get(out), rz_strbuf_length(out));
+	rz_strbuf_set(out, "");
+	return ret;
+}
+
+/* segment shared with the script, see RZPIPE_FRAME_SHM */
+typedef struct {
+	char *name;
+	ut8 *buf;
+	size_t size;
+} PipeShm;
+
+static void shm_drop(PipeShm *shm) {
+#if HAVE_SHM_OPEN
+	if (shm->buf) {
+		munmap(shm->buf, shm->size);
+	}
+	if (shm->name) {
+		shm_unlink(shm->name);
+	}
+#endif
+	free(shm->name);
+	memset(shm, 0, sizeof(*shm));
+}
+
+static bool shm_create(PipeShm *shm, size_t size) {
+	shm_drop(shm);
+#if HAVE_SHM_OPEN
+	static ut32 count = 0;
+	char *name = rz_str_newf("/rzpipe-%d-%u", rz_sys_getpid(), count++);
+	if (!name) {
+		return false;
+	}
+	int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd == -1) {
+		free(name);
+		return false;
+	}
+	void *buf = ftruncate(fd, size) ? MAP_FAILED : mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (buf == MAP_FAILED) {
+		shm_unlink(name);
+		free(name);
+		return false;
+	}
+	shm->name = name;
+	shm->buf = buf;
+	shm->size = size;
+	return true;
+#else
+	return false;
+#endif
+}
+
+static bool frame_handle(RzLang *lang, int fd, ut8 type, const ut8 *payload, ut32 len, RzStrBuf *out, PipeShm *shm) {
+	switch (type) {
+	case RZPIPE_FRAME_CMD: {
+		char *cmd = rz_str_ndup((const char *)payload, len);
+		char *res = cmd ? lang->cmd_str((RzCore *)lang->user, cmd) : NULL;
+		if (res) {
+			frame_reply(out, RZPIPE_FRAME_OK, res, strlen(res));
+		} else {
+			frame_reply(out, RZPIPE_FRAME_ERROR, NULL, 0);
+		}
+		free(res);
+		free(cmd);
+		return true;
+	}
+	case RZPIPE_FRAME_READ: {
+		ut32 size = len == 12 ? rz_read_le32(payload + 8) : 0;
+		ut8 *buf = lang->read_at && size && size <= RZPIPE_FRAME_MAX ? malloc(size) : NULL;
+		if (!buf) {
+			frame_reply(out, RZPIPE_FRAME_ERROR, NULL, 0);
+			return true;
+		}
+		ut8 status = lang->read_at(lang->user, rz_read_le64(payload), buf, size) ? RZPIPE_FRAME_OK : RZPIPE_FRAME_ERROR;
+		// the bytes go out as they are, without copying them into the replies
+		ut8 hdr[RZPIPE_FRAME_HDR_SIZE];
+		rz_write_le32(hdr, size);
+		hdr[4] = status;
+		bool ret = frame_flush(fd, out) && write_all(fd, hdr, sizeof(hdr)) && write_all(fd, buf, size);
+		free(buf);
+		return ret;
+	}
+	case RZPIPE_FRAME_SHM: {
+		ut32 size = len == 4 ? rz_read_le32(payload) : 0;
+		if (!size) {
+			shm_drop(shm);
+			frame_reply(out, RZPIPE_FRAME_OK, NULL, 0);
+		} else if (size <= RZPIPE_FRAME_MAX && shm_create(shm, size)) {
+			frame_reply(out, RZPIPE_FRAME_OK, shm->name, strlen(shm->name));
+		} else {
+			frame_reply(out, RZPIPE_FRAME_ERROR, NULL, 0);
+		}
+		return true;
+	}
+	case RZPIPE_FRAME_SHM_READ: {
+		ut32 size = len == 16 ? rz_read_le32(payload + 8) : 0;
+		ut32 off = len == 16 ? rz_read_le32(payload + 12) : 0;
+		bool ok = lang->read_at && shm->buf && size && off <= shm->size && size <= shm->size - off &&
+			lang->read_at(lang->user, rz_read_le64(payload), shm->buf + off, size);
+		frame_reply(out, ok ? RZPIPE_FRAME_OK : RZPIPE_FRAME_ERROR, NULL, 0);
+		return true;
+	}
+	default:
+		frame_reply(out, RZPIPE_FRAME_ERROR, NULL, 0);
+		return true;
+	}
+}
+
+/* serve the framed protocol (see RZPIPE_FRAMED_HELLO) until the script goes away,
+ * \p pending are the bytes received after the hello */
+static void lang_pipe_serve_framed(RzLang *lang, int in, int out, const ut8 *pending, size_t pending_len) {
+	RzStrBuf replies;
+	PipeShm shm = { 0 };
+	size_t len = 0, cap = RZ_MAX(pending_len, 0x10000);
+	ut8 *buf = malloc(cap);
+	if (!buf) {
+		return;
+	}
+	memcpy(buf, pending, pending_len);
+	len = pending_len;
+	rz_strbuf_init(&replies);
+	frame_reply(&replies, RZPIPE_FRAME_OK, "1", 1);
+	for (;;) {
+		// answer all the complete requests at once, pipelined ones need a single write
+		size_t off = 0;
+		while (len - off >= RZPIPE_FRAME_HDR_SIZE) {
+			ut32 plen = rz_read_le32(buf + off);
+			if (plen > RZPIPE_FRAME_MAX) {
+				eprintf("rz_lang_pipe: invalid frame size\n");
+				goto beach;
+			}
+			if (len - off - RZPIPE_FRAME_HDR_SIZE < plen) {
+				break;
+			}
+			if (!frame_handle(lang, out, buf[off + 4], buf + off + RZPIPE_FRAME_HDR_SIZE, plen, &replies, &shm)) {
+				goto beach;
+			}
+			off += RZPIPE_FRAME_HDR_SIZE + plen;
+		}
+		memmove(buf, buf + off, len - off);
+		len -= off;
+		if (rz_strbuf_length(&replies) && !frame_flush(out, &replies)) {
+			break;
+		}
+		if (rz_cons_is_breaked()) {
+			break;
+		}
+		if (len >= RZPIPE_FRAME_HDR_SIZE) {
+			size_t need = RZPIPE_FRAME_HDR_SIZE + rz_read_le32(buf);
+			if (need > cap) {
+				ut8 *tmp = realloc(buf, need);
+				if (!tmp) {
+					break;
+				}
+				buf = tmp;
+				cap = need;
+			}
+		}
+		void *bed = rz_cons_sleep_begin();
+		ssize_t r = read(in, buf + len, cap - len);
+		rz_cons_sleep_end(bed);
+		if (r < 1) {
+			break;
+		}
+		len += r;
+	}
+beach:
+	shm_drop(&shm);
+	rz_strbuf_fini(&replies);
+	free(buf);
+}
 #endif
 
 RZ_IPI int lang_pipe_run(RzLang *lang, const char *code, int len) {
@@ -160,6 +361,8 @@ RZ_IPI int lang_pipe_run(RzLang *lang, const char *code, int len) {
 		perror("pipe run");
 	} else if (!child) {
 		/* children */
+		// only offered to the script, rizin itself may be a client of another host
+		rz_sys_setenv(RZPIPE_FRAMED_ENV, "1");
 		rz_sys_xsystem(code);
 		rz_xwrite(input[1], "", 1);
 		rz_sys_pipe_close(input[0]);
@@ -189,6 +392,11 @@ RZ_IPI int lang_pipe_run(RzLang *lang, const char *code, int len) {
 				break;
 			}
 			if (!buf[0]) {
+				if (ret >= RZPIPE_FRAMED_HELLO_LEN && !memcmp(buf, RZPIPE_FRAMED_HELLO, RZPIPE_FRAMED_HELLO_LEN)) {
+					lang_pipe_serve_framed(lang, output[0], input[1],
+						(const ut8 *)buf + RZPIPE_FRAMED_HELLO_LEN, ret - RZPIPE_FRAMED_HELLO_LEN);
+					break;
+				}
 				continue;
 			}
 			buf[sizeof(buf) - 1] = 0;
@@ -34,6 +34,7 @@
 #if !USE_LIB_MAGIC
 
 #include <rz_util.h>
+#include <rz_th.h>
 #include <ctype.h>
 #include "file.h"
 #include "patchlevel.h"
@@ -187,6 +188,103 @@ static void init_file_tables(void) {
 	}
 }
 
+/*
+ * Parsed magic sets, keyed by the path they were loaded from, so that every
+ * RzMagic loading the same file or directory only parses it once per process.
+ * An entry is dropped when the modification time of the path changes.
+ */
+typedef struct {
+	struct rz_magic *magic;
+	ut32 nmagic;
+	time_t mtime;
+} MagicCacheItem;
+
+static HtPP *magic_cache = NULL;
+static RzThreadLock *magic_cache_lock = NULL;
+
+static void magic_cache_kv_free(HtPPKv *kv) {
+	free(kv->key);
+	MagicCacheItem *item = kv->value;
+	if (item) {
+		free(item->magic);
+		free(item);
+	}
+}
+
+#ifdef RZ_DEFINE_CONSTRUCTOR_NEEDS_PRAGMA
+#pragma RZ_DEFINE_CONSTRUCTOR_PRAGMA_ARGS(init_magic_cache)
+#endif
+RZ_DEFINE_CONSTRUCTOR(init_magic_cache)
+static void init_magic_cache(void) {
+	magic_cache_lock = rz_th_lock_new(false);
+	magic_cache = ht_pp_new(NULL, magic_cache_kv_free, NULL);
+}
+
+#ifdef RZ_DEFINE_DESTRUCTOR_NEEDS_PRAGMA
+#pragma RZ_DEFINE_DESTRUCTOR_PRAGMA_ARGS(fini_magic_cache)
+#endif
+RZ_DEFINE_DESTRUCTOR(fini_magic_cache)
+static void fini_magic_cache(void) {
+	ht_pp_free(magic_cache);
+	magic_cache = NULL;
+	rz_th_lock_free(magic_cache_lock);
+	magic_cache_lock = NULL;
+}
+
+static struct rz_magic *magic_dup(const struct rz_magic *magic, ut32 nmagic) {
+	// same layout as apprentice_load(), so file_delmagic() can free it
+	struct rz_magic *r = malloc(1 + (sizeof(*magic) * nmagic));
+	if (r) {
+		memcpy(r, magic, sizeof(*magic) * nmagic);
+	}
+	return r;
+}
+
+/*
+ * apprentice_load() through the cache of parsed sets.
+ */
+static int apprentice_load_cached(RzMagic *ms, struct rz_magic **magicp, ut32 *nmagicp, const char *fn, int action) {
+	struct stat st;
+	// inline magic buffers start with '#' and are not worth keeping around
+	if (action != FILE_LOAD || *fn == '#' || !magic_cache || stat(fn, &st) != 0) {
+		return apprentice_load(ms, magicp, nmagicp, fn, action);
+	}
+	rz_th_lock_enter(magic_cache_lock);
+	MagicCacheItem *item = ht_pp_find(magic_cache, fn, NULL);
+	if (item && item->mtime == st.st_mtime) {
+		*magicp = magic_dup(item->magic, item->nmagic);
+		*nmagicp = item->nmagic;
+		rz_th_lock_leave(magic_cache_lock);
+		if (!*magicp) {
+			file_oomem(ms, sizeof(**magicp) * item->nmagic);
+			return -1;
+		}
+		ms->flags |= RZ_MAGIC_CHECK;
+		return 0;
+	}
+	rz_th_lock_leave(magic_cache_lock);
+
+	int rv = apprentice_load(ms, magicp, nmagicp, fn, action);
+	if (rv != 0) {
+		return rv;
+	}
+	item = RZ_NEW0(MagicCacheItem);
+	if (!item) {
+		return rv;
+	}
+	item->magic = magic_dup(*magicp, *nmagicp);
+	item->nmagic = *nmagicp;
+	item->mtime = st.st_mtime;
+	if (!item->magic) {
+		free(item);
+		return rv;
+	}
+	rz_th_lock_enter(magic_cache_lock);
+	ht_pp_update(magic_cache, fn, item);
+	rz_th_lock_leave(magic_cache_lock);
+	return rv;
+}
+
 /*
  * Handle one file or directory.
  */
@@ -222,7 +320,7 @@ static int apprentice_1(RzMagic *ms, const char *fn, int action, struct mlist *m
 	if ((rv = apprentice_map(ms, &magic, &nmagic, fn)) == -1) {
 		// if (ms->flags & RZ_MAGIC_CHECK)
 		//	file_magwarn(ms, "using regular magic file `%s'", fn);
-		rv = apprentice_load(ms, &magic, &nmagic, fn, action);
+		rv = apprentice_load_cached(ms, &magic, &nmagic, fn, action);
 		if (rv != 0) {
 			return -1;
 		}
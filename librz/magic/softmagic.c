@@ -78,6 +78,18 @@ int file_softmagic(RzMagic *ms, const ut8 *buf, size_t nbytes, int mode) {
 	return 0;
 }
 
+/*
+ * Cheap pre-check for the most common top-level test, a plain string
+ * compared at a fixed offset: when its first byte is not there the entry
+ * cannot match, so mget() and magiccheck() are not worth running.
+ */
+static inline bool quick_mismatch(const struct rz_magic *m, const ut8 *s, size_t nbytes) {
+	if (m->type != FILE_STRING || m->reln != '=' || (m->flag & (INDIR | OFFADD)) || m->str_flags || !m->vallen) {
+		return false;
+	}
+	return m->offset >= nbytes || s[m->offset] != (ut8)m->value.s[0];
+}
+
 /*
  * Go through the whole list, stopping if you find a match.  Process all
  * the continuations of that match before returning.
@@ -128,6 +140,13 @@ static int match(RzMagic *ms, struct rz_magic *magic, ut32 nmagic, const ut8 *s,
 			continue; /* Skip to next top-level test*/
 		}
 
+		if (quick_mismatch(m, s, nbytes)) {
+			while (magindex < nmagic - 1 && magic[magindex + 1].cont_level) {
+				magindex++;
+			}
+			continue;
+		}
+
 		ms->offset = m->offset;
 		ms->line = m->lineno;
 
@@ -92,7 +92,7 @@ static int rz_main_version_verify(int show) {
 static int main_help(int line) {
 	if (line < 2) {
 		printf("Usage: rizin [-ACdfLMnNqStuvwzX] [-P patch] [-p prj] [-a arch] [-b bits] [-i file]\n"
-		       "             [-s addr] [-B baddr] [-m maddr] [-c cmd] [-e k=v] file|pid|-|--|=\n");
+		       "             [-s addr] [-B baddr] [-m maddr] [-c cmd] [-e k=v] [-j list] file|pid|-|--|=\n");
 	}
 	if (line != 1) {
 		printf(
@@ -116,6 +116,7 @@ static int main_help(int line) {
 			" -h, -hh      show help message, -hh for long\n"
 			" -H ([var])   display variable\n"
 			" -i [file]    run script file\n"
+			" -j [list]    batch mode: fork a warm core for every file in list (- for stdin)\n"
 			" -I [file]    run script file before the file is opened\n"
 			" -k [OS/kern] set asm.os (linux, macos, w32, netbsd, ...)\n"
 			" -l [lib]     load plugin file\n"
@@ -317,6 +318,136 @@ beach:
 	return false;
 }
 
+static void run_analysis(RzCore *r, int do_analysis) {
+	switch (do_analysis) {
+	case 0: return;
+	case 1: rz_core_cmd0(r, "aa"); break;
+	case 2: rz_core_cmd0(r, "aaa"); break;
+	case 3: rz_core_cmd0(r, "aaaa"); break;
+	default: rz_core_cmd0(r, "aaaaa"); break;
+	}
+	rz_cons_flush();
+}
+
+typedef struct {
+	RzList /*<char *>*/ *cmds;
+	RzList /*<char *>*/ *files;
+	RzList /*<char *>*/ *evals;
+	const char *asmarch;
+	const char *asmbits;
+	const char *asmos;
+	int do_analysis;
+	int perms;
+	ut64 mapaddr;
+	ut64 baddr;
+	bool load_bin;
+} BatchOptions;
+
+/* runs in the forked child, on a copy of the warm core */
+static int batch_sample(RzCore *r, const char *sample, BatchOptions *bo) {
+	RzCoreFile *fh = rz_core_file_open(r, sample, bo->perms, bo->mapaddr);
+	if (!fh) {
+		RZ_LOG_ERROR("[r] Cannot open '%s'\n", sample);
+		return 1;
+	}
+	if (bo->load_bin && !rz_core_bin_load(r, NULL, bo->baddr)) {
+		RZ_LOG_ERROR("Cannot load bin info of '%s'\n", sample);
+	}
+	RzListIter *iter;
+	const char *cmdn;
+	rz_list_foreach (bo->evals, iter, cmdn) {
+		rz_config_eval(r->config, cmdn);
+	}
+	if (bo->asmarch) {
+		rz_config_set(r->config, "asm.arch", bo->asmarch);
+	}
+	if (bo->asmbits) {
+		rz_config_set(r->config, "asm.bits", bo->asmbits);
+	}
+	if (bo->asmos) {
+		rz_config_set(r->config, "asm.os", bo->asmos);
+	}
+	// at the same point as for a single file, after the -e options
+	char *global_rc = rz_path_system_rc();
+	if (rz_file_exists(global_rc)) {
+		(void)rz_core_run_script(r, global_rc);
+	}
+	free(global_rc);
+	RzFlagItem *entry = rz_flag_get(r->flags, "entry0");
+	rz_core_seek(r, entry ? entry->offset : r->offset, true);
+	run_analysis(r, bo->do_analysis);
+	run_commands(r, bo->cmds, bo->files, true, bo->do_analysis);
+	rz_cons_flush();
+	return 0;
+}
+
+/**
+ * Batch mode (-j): everything that does not depend on the sample (plugins,
+ * user rc scripts and -I scripts) is done once in this process, which then
+ * forks for every sample listed in \p list. The children share the warm
+ * state copy-on-write, so a sample only pays for its own loading and analysis.
+ * The -e options and the system rc run in the children after the sample is
+ * opened, in the same order as for a single file.
+ * Samples are processed one at a time to keep their outputs in order.
+ */
+static int batch_run(RzCore *r, const char *list, BatchOptions *bo) {
+#if HAVE_FORK
+	char *content = !strcmp(list, "-") ? rz_stdin_slurp(NULL) : rz_file_slurp(list, NULL);
+	if (!content) {
+		RZ_LOG_ERROR("Cannot read the sample list '%s'\n", list);
+		return 1;
+	}
+	RzList *samples = rz_str_split_duplist(content, "\n", true);
+	free(content);
+	if (!samples) {
+		return 1;
+	}
+	if (bo->asmarch) {
+		rz_config_set(r->config, "asm.arch", bo->asmarch);
+	}
+	if (bo->asmbits) {
+		rz_config_set(r->config, "asm.bits", bo->asmbits);
+	}
+	if (bo->asmos) {
+		rz_config_set(r->config, "asm.os", bo->asmos);
+	}
+	int failed = 0;
+	RzListIter *iter;
+	const char *sample;
+	rz_list_foreach (samples, iter, sample) {
+		if (!*sample || *sample == '#') {
+			continue;
+		}
+		// nothing buffered may be inherited, or it would be printed twice
+		rz_cons_flush();
+		fflush(stdout);
+		fflush(stderr);
+		int pid = rz_sys_fork();
+		if (pid < 0) {
+			RZ_LOG_ERROR("Cannot fork for '%s'\n", sample);
+			failed++;
+			break;
+		}
+		if (!pid) {
+			int rc = batch_sample(r, sample, bo);
+			fflush(stdout);
+			// like -Q, the copy of the core is dropped with the process
+			_exit(rc);
+		}
+		int status = 0;
+		if (waitpid(pid, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status)) {
+			RZ_LOG_ERROR("Failed to process '%s'\n", sample);
+			failed++;
+		}
+	}
+	rz_list_free(samples);
+	return failed ? 1 : 0;
+#else
+	RZ_LOG_ERROR("Batch mode is not supported on this platform\n");
+	return 1;
+#endif
+}
+
 static bool mustSaveHistory(RzConfig *c) {
 	if (!rz_config_get_i(c, "scr.histsave")) {
 		return false;
@@ -397,6 +528,7 @@ RZ_API int rz_main_rizin(int argc, const char **argv) {
 	const char *asmos = NULL;
 	const char *forcebin = NULL;
 	const char *asmbits = NULL;
+	const char *batch_list = NULL;
 	char *customRarunProfile = NULL;
 	ut64 mapaddr = 0LL;
 	bool quiet = false;
@@ -483,7 +615,7 @@ RZ_API int rz_main_rizin(int argc, const char **argv) {
 	char *debugbackend = strdup("native");
 
 	RzGetopt opt;
-	rz_getopt_init(&opt, argc, argv, "=02AMCwxfF:H:hm:e:nk:NdqQs:p:b:B:a:Lui:I:l:R:r:c:D:vVSTzuXt");
+	rz_getopt_init(&opt, argc, argv, "=02AMCwxfF:H:hj:m:e:nk:NdqQs:p:b:B:a:Lui:I:l:R:r:c:D:vVSTzuXt");
 	while (argc >= 2 && (c = rz_getopt_next(&opt)) != -1) {
 		switch (c) {
 		case '-':
@@ -577,6 +709,9 @@ RZ_API int rz_main_rizin(int argc, const char **argv) {
 			main_print_var(opt.arg);
 			LISTS_FREE();
 			return 0;
+		case 'j':
+			batch_list = opt.arg;
+			break;
 		case 'i':
 			if (RZ_STR_ISEMPTY(opt.arg)) {
 				RZ_LOG_ERROR("Cannot open empty script path\n");
@@ -754,6 +889,13 @@ RZ_API int rz_main_rizin(int argc, const char **argv) {
 		}
 	}
 
+	if (batch_list && (opt.ind < argc || debug || (perms & RZ_PERM_W))) {
+		// the samples only come from the list, and they are opened read-only
+		RZ_LOG_ERROR("-j can't be used with a file, -d or -w\n");
+		ret = 1;
+		goto beach;
+	}
+
 	if (pfile && !*pfile) {
 		RZ_LOG_ERROR("Cannot open empty path\n");
 		ret = 1;
@@ -878,6 +1020,26 @@ RZ_API int rz_main_rizin(int argc, const char **argv) {
 		rz_config_set(r->config, "scr.utf8", "false");
 	}
 
+	if (batch_list) {
+		BatchOptions bo = {
+			.cmds = cmds,
+			.files = files,
+			.evals = evals,
+			.asmarch = asmarch,
+			.asmbits = asmbits,
+			.asmos = asmos,
+			.do_analysis = do_analysis,
+			.perms = perms,
+			.mapaddr = mapaddr,
+			.baddr = baddr,
+			.load_bin = load_bin == LOAD_BIN_ALL,
+		};
+		rz_config_set(r->config, "scr.interactive", "false");
+		rz_config_set(r->config, "scr.prompt", "false");
+		ret = batch_run(r, batch_list, &bo);
+		goto beach;
+	}
+
 	if (pfile && rz_file_is_directory(pfile)) {
 		if (debug) {
 			RZ_LOG_ERROR("Error: Cannot debug directories, yet.\n");
@@ -1346,15 +1508,7 @@ RZ_API int rz_main_rizin(int argc, const char **argv) {
 		free(global_rc);
 	}
 
-	if (do_analysis > 0) {
-		switch (do_analysis) {
-		case 1: rz_core_cmd0(r, "aa"); break;
-		case 2: rz_core_cmd0(r, "aaa"); break;
-		case 3: rz_core_cmd0(r, "aaaa"); break;
-		default: rz_core_cmd0(r, "aaaaa"); break;
-		}
-		rz_cons_flush();
-	}
+	run_analysis(r, do_analysis);
 #if UNCOLORIZE_NONTTY
 #if __UNIX__
 	if (!rz_cons_isatty()) {
@@ -1449,15 +1603,16 @@ RZ_API int rz_main_rizin(int argc, const char **argv) {
 
 			prj = rz_config_get(r->config, "prj.file");
 			bool compress = rz_config_get_b(r->config, "prj.compress");
+			RzProjectFormat prj_format = rz_config_get_b(r->config, "prj.binary") ? RZ_PROJECT_FORMAT_BINARY : RZ_PROJECT_FORMAT_TEXT;
 			RzProjectErr prj_err = RZ_PROJECT_ERR_SUCCESS;
 			if (no_question_save) {
 				if (prj && *prj && y_save_project) {
-					prj_err = rz_project_save_file(r, prj, compress);
+					prj_err = rz_project_save_file_as(r, prj, prj_format, compress);
 				}
 			} else {
 				question = rz_str_newf("Do you want to save the '%s' project? (Y/n)", prj);
 				if (prj && *prj && rz_cons_yesno('y', "%s", question)) {
-					prj_err = rz_project_save_file(r, prj, compress);
+					prj_err = rz_project_save_file_as(r, prj, prj_format, compress);
 				}
 				free(question);
 			}
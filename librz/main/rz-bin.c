@@ -153,7 +153,7 @@ static ut32 actions2mask(ut64 action) {
 static int rabin_show_help(int v) {
 	printf("Usage: rz-bin [-AcdeEghHiIjlLMqrRsSUvVxzZ] [-@ at] [-a arch] [-b bits] [-B addr]\n"
 	       "              [-C F:C:D] [-f str] [-m addr] [-n str] [-N m:M] [-P[-P] pdb]\n"
-	       "              [-o str] [-O str] [-k query] [-D lang symname] file\n");
+	       "              [-o str] [-O str] [-k query] [-D lang symname] [-t list] file\n");
 	if (v) {
 		printf(
 			" -@ [addr]       show section, symbol or import at addr\n"
@@ -200,6 +200,7 @@ static int rabin_show_help(int v) {
 			" -S              sections\n"
 			" -SS             segments\n"
 			" -SSS            sections mapping to segments\n"
+			" -t [list]       batch mode: process the files in list (- for stdin) in parallel, one json line each\n"
 			" -T              display file signature\n"
 			" -u              unfiltered (no rename duplicated symbols/sections)\n"
 			" -U              resoUrces\n"
@@ -227,6 +228,7 @@ static int rabin_show_help(int v) {
 		       " RZ_BIN_PDBSERVER: e pdb.server       # use alternative PDB server\n"
 		       " RZ_BIN_SYMSTORE:  e pdb.symstore     # path to downstream symbol store\n"
 		       " RZ_BIN_PREFIX:    e bin.prefix       # prefix symbols/sections/relocs with a specific string\n"
+		       " RZ_BIN_THREADS:   # number of threads used by -t (0 for one per core)\n"
 		       " RZ_CONFIG:        # sdb config file\n");
 	}
 	return 1;
@@ -619,6 +621,35 @@ static int __lib_bin_ldr_dt(RzLibPlugin *pl, void *p, void *u) {
 	return true;
 }
 
+static void rabin_load_plugins(RzBin *bin) {
+	char *homeplugindir = rz_path_home_prefix(RZ_PLUGINS);
+	// TODO: remove after 0.4.0 is released
+	char *oldhomeplugindir = rz_path_home_prefix(RZ_HOME_OLD_PLUGINS);
+	char *plugindir = rz_path_system(RZ_PLUGINS);
+	RzLib *l = rz_lib_new(NULL, NULL);
+	rz_lib_add_handler(l, RZ_LIB_TYPE_DEMANGLER, "demangler plugins",
+		&__lib_demangler_cb, &__lib_demangler_dt, bin->demangler);
+	rz_lib_add_handler(l, RZ_LIB_TYPE_BIN, "bin plugins",
+		&__lib_bin_cb, &__lib_bin_dt, bin);
+	rz_lib_add_handler(l, RZ_LIB_TYPE_BIN_XTR, "bin xtr plugins",
+		&__lib_bin_xtr_cb, &__lib_bin_xtr_dt, bin);
+	rz_lib_add_handler(l, RZ_LIB_TYPE_BIN_LDR, "bin ldr plugins",
+		&__lib_bin_ldr_cb, &__lib_bin_ldr_dt, bin);
+	/* load plugins everywhere */
+	char *path = rz_sys_getenv(RZ_LIB_ENV);
+	if (!RZ_STR_ISEMPTY(path)) {
+		rz_lib_opendir(l, path, false);
+	}
+	rz_lib_opendir(l, homeplugindir, false);
+	rz_lib_opendir(l, oldhomeplugindir, false);
+	rz_lib_opendir(l, plugindir, false);
+	free(homeplugindir);
+	free(oldhomeplugindir);
+	free(plugindir);
+	free(path);
+	rz_lib_free(l);
+}
+
 static void __listPlugins(RzBin *bin, const char *plugin_name, PJ *pj, int rad) {
 	int format = 0;
 	RzCmdStateOutput state = { 0 };
@@ -691,6 +722,211 @@ static void print_string(RzBinFile *bf, RzBinString *string, PJ *pj, int mode) {
 	}
 }
 
+/*
+ * Batch mode (-t): every worker thread owns a RzCore that is set up once,
+ * with the plugins and configuration of the main one, and then reused for
+ * all the files it takes from the shared queue. Each file produces exactly
+ * one line of json on stdout, written under a lock so lines never mix.
+ *
+ * Only loading the files runs in parallel. The workers share the global
+ * RzCons, which some printers use (e.g. -d pushes a break handler), so
+ * rz_core_bin_print() is called under the same lock.
+ */
+typedef struct {
+	RzThreadQueue *files;
+	RzThreadLock *out_lock;
+	ut32 mask;
+	ut64 baddr;
+	ut64 laddr;
+	const char *forcebin;
+	ut64 action;
+	RzCoreBinFilter *filter;
+	RzList /*<char *>*/ *chksum_list;
+	RzAtomicBool *failed;
+} RabinBatch;
+
+typedef struct {
+	RabinBatch *batch;
+	RzCore *core;
+} RabinBatchWorker;
+
+static void rabin_batch_print_error(RabinBatch *batch, const char *file, const char *error) {
+	PJ *pj = pj_new();
+	if (!pj) {
+		return;
+	}
+	pj_o(pj);
+	pj_ks(pj, "file", file);
+	pj_ks(pj, "error", error);
+	pj_end(pj);
+	rz_th_lock_enter(batch->out_lock);
+	printf("%s\n", pj_string(pj));
+	fflush(stdout);
+	rz_th_lock_leave(batch->out_lock);
+	pj_free(pj);
+}
+
+static bool rabin_batch_file(RabinBatch *batch, RzCore *core, const char *file) {
+	RzCoreFile *fh = rz_core_file_open(core, file, RZ_PERM_R, 0);
+	int fd = fh ? rz_io_fd_get_current(core->io) : -1;
+	if (fd == -1) {
+		if (fh) {
+			rz_core_file_close(fh);
+		}
+		rabin_batch_print_error(batch, file, "cannot open file");
+		return false;
+	}
+	RzBin *bin = core->bin;
+	bin->minstrlen = rz_config_get_i(core->config, "bin.minstr");
+	bin->maxstrbuf = rz_config_get_i(core->config, "bin.maxstrbuf");
+	rz_bin_force_plugin(bin, batch->forcebin);
+	rz_bin_load_filter(bin, batch->action);
+
+	RzBinOptions bo;
+	rz_bin_options_init(&bo, fd, batch->baddr, batch->laddr, false);
+	bo.obj_opts.elf_load_sections = rz_config_get_b(core->config, "elf.load.sections");
+	bo.obj_opts.elf_checks_sections = rz_config_get_b(core->config, "elf.checks.sections");
+	bo.obj_opts.elf_checks_segments = rz_config_get_b(core->config, "elf.checks.segments");
+	bo.obj_opts.big_endian = rz_config_get_b(core->config, "cfg.bigendian");
+
+	bool ret = false;
+	RzBinFile *bf = rz_bin_open(bin, file, &bo);
+	if (!bf) {
+		rabin_batch_print_error(batch, file, "cannot load bin");
+		goto beach;
+	}
+	(void)rz_core_bin_update_arch_bits(core);
+	if (batch->baddr != UT64_MAX) {
+		rz_bin_set_baddr(bin, batch->baddr);
+	}
+	RzCmdStateOutput state;
+	if (!rz_cmd_state_output_init(&state, RZ_OUTPUT_MODE_JSON)) {
+		goto beach;
+	}
+	start_state(&state);
+	pj_ks(state.d.pj, "file", file);
+	rz_th_lock_enter(batch->out_lock);
+	rz_core_bin_print(core, bf, batch->mask, batch->filter, &state, batch->chksum_list);
+	pj_end(state.d.pj);
+	const char *s = pj_string(state.d.pj);
+	if (s) {
+		printf("%s\n", s);
+		fflush(stdout);
+		ret = true;
+	}
+	rz_th_lock_leave(batch->out_lock);
+	rz_cmd_state_output_fini(&state);
+beach:
+	rz_core_file_close(fh);
+	// bins not attached to the core file (e.g. when the load failed half way)
+	rz_bin_file_delete_all(bin);
+	return ret;
+}
+
+static void *rabin_batch_worker(RabinBatchWorker *worker) {
+	char *file;
+	while ((file = rz_th_queue_pop(worker->batch->files, false))) {
+		if (!rabin_batch_file(worker->batch, worker->core, file)) {
+			rz_atomic_bool_set(worker->batch->failed, true);
+		}
+		free(file);
+	}
+	return NULL;
+}
+
+static RzThreadQueue *rabin_batch_read_list(const char *list) {
+	char *content = !strcmp(list, "-") ? rz_stdin_slurp(NULL) : rz_file_slurp(list, NULL);
+	if (!content) {
+		return NULL;
+	}
+	RzThreadQueue *files = rz_th_queue_new(RZ_THREAD_QUEUE_UNLIMITED, free);
+	char *line = content;
+	while (files && line && *line) {
+		char *next = strchr(line, '\n');
+		if (next) {
+			*next++ = '\0';
+		}
+		rz_str_trim(line);
+		if (*line && *line != '#') {
+			char *file = strdup(line);
+			if (!file || !rz_th_queue_push(files, file, true)) {
+				free(file);
+				rz_th_queue_free(files);
+				files = NULL;
+			}
+		}
+		line = next;
+	}
+	free(content);
+	return files;
+}
+
+/**
+ * Runs the actions selected on the command line on every file listed in
+ * \p list, using up to \p max_threads threads (0 means one per core).
+ */
+static int rabin_batch(RzCore *main_core, const char *list, size_t max_threads, bool load_plugins, RabinBatch *batch) {
+	batch->files = rabin_batch_read_list(list);
+	if (!batch->files) {
+		eprintf("rz-bin: Cannot read the file list '%s'\n", list);
+		return 1;
+	}
+	int result = 1;
+	RzThreadPool *pool = rz_th_pool_new(max_threads);
+	size_t n_workers = rz_th_pool_size(pool);
+	RabinBatchWorker *workers = n_workers ? RZ_NEWS0(RabinBatchWorker, n_workers) : NULL;
+	Sdb *config = sdb_new0();
+	batch->out_lock = rz_th_lock_new(false);
+	batch->failed = rz_atomic_bool_new(false);
+	if (!workers || !config || !batch->out_lock || !batch->failed) {
+		goto beach;
+	}
+	rz_config_serialize(main_core->config, config);
+	size_t i;
+	// cores are created here, not in the threads, since rz_core_new() is not thread-safe
+	for (i = 0; i < n_workers; i++) {
+		RzCore *core = rz_core_new();
+		if (!core) {
+			goto beach;
+		}
+		workers[i].batch = batch;
+		workers[i].core = core;
+		if (load_plugins) {
+			rabin_load_plugins(core->bin);
+		}
+		rz_config_unserialize(core->config, config, NULL);
+		core->bin->filter = main_core->bin->filter;
+		core->bin->cb_printf = rz_cons_printf;
+	}
+	for (i = 0; i < n_workers; i++) {
+		RzThread *th = rz_th_new((RzThreadFunction)rabin_batch_worker, &workers[i]);
+		if (!th) {
+			break;
+		}
+		if (!rz_th_pool_add_thread(pool, th)) {
+			rz_th_free(th);
+			break;
+		}
+	}
+	if (!i) {
+		goto beach;
+	}
+	// the workers started so far drain the whole queue anyway
+	rz_th_pool_wait(pool);
+	result = rz_atomic_bool_get(batch->failed) ? 1 : 0;
+beach:
+	rz_th_pool_free(pool);
+	for (i = 0; workers && i < n_workers; i++) {
+		rz_core_free(workers[i].core);
+	}
+	free(workers);
+	sdb_free(config);
+	rz_atomic_bool_free(batch->failed);
+	rz_th_lock_free(batch->out_lock);
+	rz_th_queue_free(batch->files);
+	return result;
+}
+
 RZ_API int rz_main_rz_bin(int argc, const char **argv) {
 	RzBin *bin = NULL;
 	const char *name = NULL;
@@ -709,6 +945,7 @@ RZ_API int rz_main_rz_bin(int argc, const char **argv) {
 	const char *forcebin = NULL;
 	const char *chksum = NULL;
 	const char *op = NULL;
+	const char *batch_list = NULL;
 	RzCoreFile *fh = NULL;
 	RzCoreBinFilter filter;
 	int xtr_idx = 0; // load all files if extraction is necessary.
@@ -720,35 +957,11 @@ RZ_API int rz_main_rz_bin(int argc, const char **argv) {
 
 	rz_core_init(&core);
 	bin = core.bin;
-	if (!(tmp = rz_sys_getenv("RZ_BIN_NOPLUGINS"))) {
-		char *homeplugindir = rz_path_home_prefix(RZ_PLUGINS);
-		// TODO: remove after 0.4.0 is released
-		char *oldhomeplugindir = rz_path_home_prefix(RZ_HOME_OLD_PLUGINS);
-		char *plugindir = rz_path_system(RZ_PLUGINS);
-		RzLib *l = rz_lib_new(NULL, NULL);
-		rz_lib_add_handler(l, RZ_LIB_TYPE_DEMANGLER, "demangler plugins",
-			&__lib_demangler_cb, &__lib_demangler_dt, bin->demangler);
-		rz_lib_add_handler(l, RZ_LIB_TYPE_BIN, "bin plugins",
-			&__lib_bin_cb, &__lib_bin_dt, bin);
-		rz_lib_add_handler(l, RZ_LIB_TYPE_BIN_XTR, "bin xtr plugins",
-			&__lib_bin_xtr_cb, &__lib_bin_xtr_dt, bin);
-		rz_lib_add_handler(l, RZ_LIB_TYPE_BIN_LDR, "bin ldr plugins",
-			&__lib_bin_ldr_cb, &__lib_bin_ldr_dt, bin);
-		/* load plugins everywhere */
-		char *path = rz_sys_getenv(RZ_LIB_ENV);
-		if (!RZ_STR_ISEMPTY(path)) {
-			rz_lib_opendir(l, path, false);
-		}
-		rz_lib_opendir(l, homeplugindir, false);
-		rz_lib_opendir(l, oldhomeplugindir, false);
-		rz_lib_opendir(l, plugindir, false);
-		free(homeplugindir);
-		free(oldhomeplugindir);
-		free(plugindir);
-		free(path);
-		rz_lib_free(l);
-	}
+	bool load_plugins = !(tmp = rz_sys_getenv("RZ_BIN_NOPLUGINS"));
 	free(tmp);
+	if (load_plugins) {
+		rabin_load_plugins(bin);
+	}
 
 	if ((tmp = rz_sys_getenv("RZ_CONFIG"))) {
 		Sdb *config_sdb = sdb_new(NULL, tmp, 0);
@@ -797,7 +1010,7 @@ RZ_API int rz_main_rz_bin(int argc, const char **argv) {
 	}
 #define unset_action(x) action &= ~x
 	RzGetopt opt;
-	rz_getopt_init(&opt, argc, argv, "DjgAf:F:a:B:G:b:cC:k:K:dD:Mm:n:N:@:isSVIHeEUlRwO:o:pPqQrTvLhuxYXzZ");
+	rz_getopt_init(&opt, argc, argv, "DjgAf:F:a:B:G:b:cC:k:K:dD:Mm:n:N:@:isSVIHeEUlRwO:o:pPqQrt:TvLhuxYXzZ");
 	while ((c = rz_getopt_next(&opt)) != -1) {
 		switch (c) {
 		case 'g':
@@ -821,6 +1034,7 @@ RZ_API int rz_main_rz_bin(int argc, const char **argv) {
 			break;
 		case 'V': set_action(RZ_BIN_REQ_VERSIONINFO); break;
 		case 'T': set_action(RZ_BIN_REQ_SIGNATURE); break;
+		case 't': batch_list = opt.arg; break;
 		case 'w': set_action(RZ_BIN_REQ_TRYCATCH); break;
 		case 'q':
 			out_mode = (out_mode & RZ_MODE_SIMPLE ? RZ_MODE_SIMPLEST : RZ_MODE_SIMPLE);
@@ -1043,6 +1257,45 @@ RZ_API int rz_main_rz_bin(int argc, const char **argv) {
 		rz_core_fini(&core);
 		return ret_num;
 	}
+	if (batch_list) {
+		if (action & RZ_BIN_REQ_HELP || action == RZ_BIN_REQ_UNK) {
+			rz_core_fini(&core);
+			return rabin_show_help(0);
+		}
+		if ((tmp = rz_sys_getenv("RZ_BIN_PREFIX"))) {
+			rz_config_set(core.config, "bin.prefix", tmp);
+			free(tmp);
+		}
+		size_t max_threads = 0;
+		if ((tmp = rz_sys_getenv("RZ_BIN_THREADS"))) {
+			max_threads = rz_num_math(NULL, tmp);
+			free(tmp);
+		}
+		RzList *chksum_list = NULL;
+		if (RZ_STR_ISNOTEMPTY(chksum)) {
+			chksum_list = rz_str_split_duplist_n(chksum, ",", 0, true);
+			if (!chksum_list) {
+				rz_core_fini(&core);
+				return 1;
+			}
+		}
+		filter.offset = at;
+		filter.name = name;
+		RabinBatch batch = {
+			.mask = actions2mask(action),
+			.baddr = baddr,
+			.laddr = laddr,
+			.forcebin = forcebin,
+			.action = action,
+			.filter = &filter,
+			.chksum_list = chksum_list,
+		};
+		rz_cons_new()->context->is_interactive = false;
+		result = rabin_batch(&core, batch_list, max_threads, load_plugins, &batch);
+		rz_list_free(chksum_list);
+		rz_core_fini(&core);
+		return result;
+	}
 	file = argv[opt.ind];
 
 	if (file && !*file) {
@@ -26,6 +26,9 @@ typedef struct {
 	bool widestr;
 	bool nonstop;
 	bool json;
+	bool jsonl; ///< print every hit as a line of JSON, as soon as its file is scanned
+	bool parallel; ///< scan several mapped files at once
+	size_t jobs; ///< number of files scanned at once, RZ_THREAD_POOL_ALL_CORES for one per core
 	int mode;
 	int align;
 	ut8 *buf;
@@ -35,9 +38,11 @@ typedef struct {
 	ut64 cur;
 	RzPrint *pr;
 	RzList *keywords;
+	RzList *kwfiles; ///< contents of the files given with -K, keywords point into them
 	const char *mask;
 	const char *curfile;
 	const char *comma;
+	RzStrBuf *out; ///< output of the hits of the file scanned by a worker, printed in order later
 } RzfindOptions;
 
 static void rzfind_options_fini(RzfindOptions *ro) {
@@ -51,10 +56,22 @@ static void rzfind_options_init(RzfindOptions *ro) {
 	ro->bsize = 4096;
 	ro->to = UT64_MAX;
 	ro->keywords = rz_list_newf(NULL);
+	ro->kwfiles = rz_list_newf(free);
 }
 
 static int rzfind_open(RzfindOptions *ro, const char *file);
 
+static void rzfind_printf(RzfindOptions *ro, const char *fmt, ...) {
+	va_list ap;
+	va_start(ap, fmt);
+	if (ro->out) {
+		rz_strbuf_vappendf(ro->out, fmt, ap);
+	} else {
+		vprintf(fmt, ap);
+	}
+	va_end(ap);
+}
+
 static int hit(RzSearchKeyword *kw, void *user, ut64 addr) {
 	RzfindOptions *ro = (RzfindOptions *)user;
 	int delta = addr - ro->cur;
@@ -73,7 +90,7 @@ static int hit(RzSearchKeyword *kw, void *user, ut64 addr) {
 		if (ro->widestr) {
 			str = _str;
 			int i, j = 0;
-			for (i = delta; ro->buf[i] && i < sizeof(_str); i++) {
+			for (i = delta; i < ro->bsize && ro->buf[i] && i < sizeof(_str); i++) {
 				char ch = ro->buf[i];
 				if (ch == '"' || ch == '\\') {
 					ch = '\'';
@@ -88,14 +105,14 @@ static int hit(RzSearchKeyword *kw, void *user, ut64 addr) {
 					j += 3;
 					break;
 				}
-				if (ro->buf[i]) {
+				if (i >= ro->bsize || ro->buf[i]) {
 					break;
 				}
 			}
 			str[j] = 0;
 		} else {
 			size_t i;
-			for (i = 0; i < sizeof(_str) - 1; i++) {
+			for (i = 0; i < sizeof(_str) - 1 && delta + i < ro->bsize; i++) {
 				char ch = ro->buf[delta + i];
 				if (ch == '"' || ch == '\\') {
 					ch = '\'';
@@ -109,7 +126,7 @@ static int hit(RzSearchKeyword *kw, void *user, ut64 addr) {
 		}
 	} else {
 		size_t i;
-		for (i = 0; i < sizeof(_str) - 1; i++) {
+		for (i = 0; i < sizeof(_str) - 1 && delta + i < ro->bsize; i++) {
 			char ch = ro->buf[delta + i];
 			if (ch == '"' || ch == '\\') {
 				ch = '\'';
@@ -121,18 +138,31 @@ static int hit(RzSearchKeyword *kw, void *user, ut64 addr) {
 		}
 		str[i] = 0;
 	}
-	if (ro->json) {
+	if (ro->jsonl) {
+		PJ *pj = pj_new();
+		if (!pj) {
+			return 0;
+		}
+		pj_o(pj);
+		pj_ks(pj, "file", ro->curfile);
+		pj_kn(pj, "offset", addr);
+		pj_ks(pj, "type", "string");
+		pj_ks(pj, "data", str);
+		pj_end(pj);
+		rzfind_printf(ro, "%s\n", pj_string(pj));
+		pj_free(pj);
+	} else if (ro->json) {
 		const char *type = "string";
-		printf("%s{\"offset\":%" PFMT64d ",\"type\":\"%s\",\"data\":\"%s\"}",
+		rzfind_printf(ro, "%s{\"offset\":%" PFMT64d ",\"type\":\"%s\",\"data\":\"%s\"}",
 			ro->comma, addr, type, str);
 		ro->comma = ",";
 	} else if (ro->rad) {
-		printf("f hit%d_%d @ 0x%08" PFMT64x " ; %s\n", 0, kw->count, addr, ro->curfile);
+		rzfind_printf(ro, "f hit%d_%d @ 0x%08" PFMT64x " ; %s\n", 0, kw->count, addr, ro->curfile);
 	} else {
 		if (ro->showstr) {
-			printf("0x%" PFMT64x " %s\n", addr, str);
+			rzfind_printf(ro, "0x%" PFMT64x " %s\n", addr, str);
 		} else {
-			printf("0x%" PFMT64x "\n", addr);
+			rzfind_printf(ro, "0x%" PFMT64x "\n", addr);
 			if (ro->pr) {
 				rz_print_hexdump(ro->pr, addr, (ut8 *)ro->buf + delta, 78, 16, 1, 1);
 				rz_cons_flush();
@@ -170,7 +200,7 @@ static void print_bin_string(RzBinFile *bf, RzBinString *string, PJ *pj) {
 }
 
 static int show_help(const char *argv0, int line) {
-	printf("Usage: %s [-mXnzZhqv] [-a align] [-b sz] [-f/t from/to] [-[e|s|w|S|I] str] [-x hex] -|file|dir ..\n", argv0);
+	printf("Usage: %s [-mXnzZhlqv] [-a align] [-b sz] [-f/t from/to] [-[e|s|w|S|I] str] [-x hex] [-K file] [-P jobs] -|file|dir ..\n", argv0);
 	if (line) {
 		return 0;
 	}
@@ -183,9 +213,12 @@ static int show_help(const char *argv0, int line) {
 		" -h         show this help\n"
 		" -i         identify filetype (rizin -nqcpm file)\n"
 		" -j         output in JSON\n"
+		" -l         output a line of JSON per hit, as soon as the file is scanned (implies -P)\n"
+		" -K [file]  search for every keyword listed in file, one per line (hexpairs if -x is also given)\n"
 		" -m         magic search, file-type carver\n"
 		" -M [str]   set a binary mask to be applied on keywords\n"
 		" -n         do not stop on read errors\n"
+		" -P [jobs]  map the files and scan [jobs] of them at once (0 for one per core), keywords only\n"
 		" -r         print using rizin commands\n"
 		" -s [str]   search for a specific string (can be used multiple times)\n"
 		" -w [str]   search for a specific wide string (can be used multiple times). Assumes str is UTF-8.\n"
@@ -201,6 +234,28 @@ static int show_help(const char *argv0, int line) {
 	return 0;
 }
 
+static void rzfind_add_keywords(RzfindOptions *ro, RzSearch *rs) {
+	RzListIter *iter;
+	const char *kw;
+	if (ro->mode == RZ_SEARCH_KEYWORD) {
+		rz_list_foreach (ro->keywords, iter, kw) {
+			if (ro->hexstr) {
+				if (ro->mask) {
+					rz_search_kw_add(rs, rz_search_keyword_new_hex(kw, ro->mask, NULL));
+				} else {
+					rz_search_kw_add(rs, rz_search_keyword_new_hexmask(kw, NULL));
+				}
+			} else if (ro->widestr) {
+				rz_search_kw_add(rs, rz_search_keyword_new_wide(kw, ro->mask, NULL, 0));
+			} else {
+				rz_search_kw_add(rs, rz_search_keyword_new_str(kw, ro->mask, NULL, 0));
+			}
+		}
+	} else if (ro->mode == RZ_SEARCH_STRING) {
+		rz_search_kw_add(rs, rz_search_keyword_new_hexmask("00", NULL)); // XXX
+	}
+}
+
 static int rzfind_open_file(RzfindOptions *ro, const char *file, const ut8 *data, int datalen) {
 	RzListIter *iter;
 	RzSearch *rs = NULL;
@@ -374,23 +429,7 @@ static int rzfind_open_file(RzfindOptions *ro, const char *file, const ut8 *data
 		}
 		goto done;
 	}
-	if (ro->mode == RZ_SEARCH_KEYWORD) {
-		rz_list_foreach (ro->keywords, iter, kw) {
-			if (ro->hexstr) {
-				if (ro->mask) {
-					rz_search_kw_add(rs, rz_search_keyword_new_hex(kw, ro->mask, NULL));
-				} else {
-					rz_search_kw_add(rs, rz_search_keyword_new_hexmask(kw, NULL));
-				}
-			} else if (ro->widestr) {
-				rz_search_kw_add(rs, rz_search_keyword_new_wide(kw, ro->mask, NULL, 0));
-			} else {
-				rz_search_kw_add(rs, rz_search_keyword_new_str(kw, ro->mask, NULL, 0));
-			}
-		}
-	} else if (ro->mode == RZ_SEARCH_STRING) {
-		rz_search_kw_add(rs, rz_search_keyword_new_hexmask("00", NULL)); // XXX
-	}
+	rzfind_add_keywords(ro, rs);
 
 	ro->curfile = file;
 	rz_search_begin(rs);
@@ -470,6 +509,165 @@ static int rzfind_open(RzfindOptions *ro, const char *file) {
 		: rzfind_open_file(ro, file, NULL, -1);
 }
 
+// Size of the updates of the search in a mapped file, the hits don't depend on it
+#define RZFIND_MAP_CHUNK (1024 * 1024)
+
+typedef struct {
+	RzStrBuf *out; ///< output of the file, NULL once printed
+	bool json_hits; ///< whether out has some JSON hits, to separate them from the previous ones
+	bool done;
+} RzfindResult;
+
+typedef struct {
+	RzfindOptions *ro;
+	RzSearch *rs; ///< search the workers fork, so they share its compiled keywords
+	RzPVector /*<char *>*/ *files;
+	RzfindResult *results;
+	size_t next; ///< first file whose output is not printed yet
+	RzThreadLock *lock; ///< protects results, next and stdout
+} RzfindParallel;
+
+static void rzfind_collect_files(RzPVector /*<char *>*/ *files, const char *file) {
+	if (!rz_file_is_directory(file)) {
+		rz_pvector_push(files, strdup(file));
+		return;
+	}
+	RzList *entries = rz_sys_dir(file);
+	RzListIter *iter;
+	const char *fname;
+	rz_list_foreach (entries, iter, fname) {
+		/* Filter-out unwanted entries */
+		if (*fname == '.') {
+			continue;
+		}
+		char *fullpath = rz_file_path_join(file, fname);
+		if (fullpath) {
+			rzfind_collect_files(files, fullpath);
+			free(fullpath);
+		}
+	}
+	rz_list_free(entries);
+}
+
+/**
+ * Scan \p file mapped read-only, without copying it, with a fork of \p rs.
+ * The output goes to \p res, ro is only read.
+ */
+static void rzfind_scan_mapped(const RzfindOptions *ro, RzSearch *rs, const char *file, RzfindResult *res) {
+	RzfindOptions wro = *ro;
+	wro.out = res->out;
+	wro.curfile = file;
+	wro.comma = "";
+	if (!ro->quiet && !ro->jsonl) {
+		rzfind_printf(&wro, "File: %s\n", file);
+	}
+	RzMmap *map = rz_file_mmap(file, O_RDONLY, 0, 0);
+	if (!map) {
+		eprintf("Cannot open file '%s'\n", file);
+		return;
+	}
+	RzSearch *ws = rz_search_fork(rs);
+	if (!ws) {
+		rz_file_mmap_free(map);
+		return;
+	}
+	rz_search_set_callback(ws, &hit, &wro);
+	// hit() finds the data of every address in the whole mapping
+	wro.buf = map->buf;
+	wro.bsize = map->len;
+	wro.cur = 0;
+	ut64 to = RZ_MIN(ro->to, map->len);
+	const ut64 chunk = RZ_MAX(ro->bsize, RZFIND_MAP_CHUNK);
+	for (ut64 at = ro->from; at < to; at += chunk) {
+		ut64 len = RZ_MIN(chunk, to - at);
+		if (rz_search_update(ws, at, map->buf + at, len) == -1) {
+			eprintf("search: update error at 0x%08" PFMT64x " in %s\n", at, file);
+			break;
+		}
+	}
+	res->json_hits = *wro.comma;
+	rz_search_free(ws);
+	rz_file_mmap_free(map);
+}
+
+static void rzfind_result_print(RzfindParallel *p, RzfindResult *res) {
+	if (!res->out) {
+		return;
+	}
+	if (res->json_hits) {
+		printf("%s", p->ro->comma);
+		p->ro->comma = ",";
+	}
+	fputs(rz_strbuf_get(res->out), stdout);
+	fflush(stdout);
+	rz_strbuf_free(res->out);
+	res->out = NULL;
+}
+
+static void rzfind_parallel_range(const size_t from, const size_t to, void *user) {
+	RzfindParallel *p = user;
+	for (size_t i = from; i < to; i++) {
+		RzfindResult *res = &p->results[i];
+		res->out = rz_strbuf_new(NULL);
+		if (res->out) {
+			rzfind_scan_mapped(p->ro, p->rs, rz_pvector_at(p->files, i), res);
+		}
+		rz_th_lock_enter(p->lock);
+		res->done = true;
+		if (p->ro->jsonl) {
+			rzfind_result_print(p, res);
+		} else {
+			// print all the files scanned so far, in the order they were given
+			for (; p->next < rz_pvector_len(p->files) && p->results[p->next].done; p->next++) {
+				rzfind_result_print(p, &p->results[p->next]);
+			}
+		}
+		rz_th_lock_leave(p->lock);
+	}
+}
+
+/**
+ * Scan the keywords in every file given, and in the files of the
+ * directories given, up to ro->jobs files at once.
+ */
+static int rzfind_open_parallel(RzfindOptions *ro, const char **paths, int count) {
+	RzfindParallel p = { 0 };
+	p.ro = ro;
+	p.files = rz_pvector_new(free);
+	p.rs = rz_search_new(ro->mode);
+	p.lock = rz_th_lock_new(false);
+	int result = 1;
+	if (!p.files || !p.rs || !p.lock) {
+		goto beach;
+	}
+	for (int i = 0; i < count; i++) {
+		rzfind_collect_files(p.files, paths[i]);
+	}
+	p.results = RZ_NEWS0(RzfindResult, rz_pvector_len(p.files));
+	if (!p.results && !rz_pvector_empty(p.files)) {
+		goto beach;
+	}
+	p.rs->align = ro->align;
+	rzfind_add_keywords(ro, p.rs);
+	rz_search_begin(p.rs);
+	// the caller scans files too while waiting for the pool
+	size_t workers = ro->jobs == 1 ? 0 : ro->jobs ? ro->jobs - 1 : RZ_THREAD_POOL_ALL_CORES;
+	RzThreadTaskPool *pool = workers || !ro->jobs ? rz_th_task_pool_new(workers) : NULL;
+	if (pool) {
+		rz_th_task_pool_parallel_for(pool, 0, rz_pvector_len(p.files), 1, rzfind_parallel_range, &p);
+		rz_th_task_pool_free(pool);
+	} else {
+		rzfind_parallel_range(0, rz_pvector_len(p.files), &p);
+	}
+	result = 0;
+beach:
+	free(p.results);
+	rz_th_lock_free(p.lock);
+	rz_search_free(p.rs);
+	rz_pvector_free(p.files);
+	return result;
+}
+
 RZ_API int rz_main_rz_find(int argc, const char **argv) {
 	RzfindOptions ro;
 	rzfind_options_init(&ro);
@@ -478,7 +676,7 @@ RZ_API int rz_main_rz_find(int argc, const char **argv) {
 	const char *file = NULL;
 
 	RzGetopt opt;
-	rz_getopt_init(&opt, argc, argv, "a:ie:b:jmM:s:w:S:I:x:Xzf:F:t:E:rqnhvZ");
+	rz_getopt_init(&opt, argc, argv, "a:ie:b:jK:lmM:s:w:S:I:x:Xzf:F:t:E:P:rqnhvZ");
 	while ((c = rz_getopt_next(&opt)) != -1) {
 		switch (c) {
 		case 'a':
@@ -493,9 +691,41 @@ RZ_API int rz_main_rz_find(int argc, const char **argv) {
 		case 'j':
 			ro.json = true;
 			break;
+		case 'l':
+			ro.jsonl = true;
+			ro.parallel = true;
+			break;
+		case 'P':
+			ro.parallel = true;
+			ro.jobs = rz_num_math(NULL, opt.arg);
+			break;
 		case 'n':
 			ro.nonstop = 1;
 			break;
+		case 'K': {
+			char *data = rz_file_slurp(opt.arg, NULL);
+			if (!data) {
+				eprintf("Cannot slurp '%s'\n", opt.arg);
+				return 1;
+			}
+			rz_list_append(ro.kwfiles, data);
+			ro.mode = RZ_SEARCH_KEYWORD;
+			char *line = data;
+			while (line) {
+				char *next = strchr(line, '\n');
+				if (next) {
+					*next++ = 0;
+				}
+				size_t len = strlen(line);
+				if (len && line[len - 1] == '\r') {
+					line[--len] = 0;
+				}
+				if (len) {
+					rz_list_append(ro.keywords, line);
+				}
+				line = next;
+			}
+		} break;
 		case 'm':
 			ro.mode = RZ_SEARCH_MAGIC;
 			break;
@@ -590,20 +820,46 @@ RZ_API int rz_main_rz_find(int argc, const char **argv) {
 	if (opt.ind + 1 == argc && RZ_STR_ISNOTEMPTY(argv[opt.ind]) && !rz_file_is_directory(argv[opt.ind])) {
 		ro.quiet = true;
 	}
+	if (ro.parallel) {
+		// the mapped scan only supports the keyword search without hexdumps
+		ro.parallel = ro.mode == RZ_SEARCH_KEYWORD && !ro.pr && !ro.identify && !ro.import && !ro.symbol;
+		for (int i = opt.ind; ro.parallel && i < argc; i++) {
+			ro.parallel = RZ_STR_ISNOTEMPTY(argv[i]) && strcmp(argv[i], "-");
+		}
+		if (!ro.parallel) {
+			eprintf("Warning: cannot scan these files in parallel, scanning them one by one\n");
+		}
+	}
+	if (ro.jsonl && ro.parallel) {
+		ro.json = false;
+	} else {
+		ro.jsonl = false;
+	}
 	if (ro.json) {
 		printf("[");
 	}
+	if (ro.parallel) {
+		int ret = rzfind_open_parallel(&ro, argv + opt.ind, argc - opt.ind);
+		rz_list_free(ro.keywords);
+		rz_list_free(ro.kwfiles);
+		if (ro.json) {
+			printf("]\n");
+		}
+		return ret;
+	}
 	for (; opt.ind < argc; opt.ind++) {
 		file = argv[opt.ind];
 
 		if (RZ_STR_ISEMPTY(file)) {
 			eprintf("Cannot open empty path\n");
 			rz_list_free(ro.keywords);
+			rz_list_free(ro.kwfiles);
 			return 1;
 		}
 		rzfind_open(&ro, file);
 	}
 	rz_list_free(ro.keywords);
+	rz_list_free(ro.kwfiles);
 	if (ro.json) {
 		printf("]\n");
 	}
@@ -12,6 +12,8 @@
 #include <rz_lib.h>
 
 #define RZ_HASH_DEFAULT_BLOCK_SIZE 0x1000
+#define RZ_HASH_CHUNK_SIZE         0x100000
+#define RZ_HASH_BATCH_SIZE         0x4000000
 
 typedef struct {
 	ut8 *buf;
@@ -664,7 +666,41 @@ rz_hash_context_run_end:
 	return result;
 }
 
-static void hash_print_crypto(RzHashContext *ctx, const char *hname, const ut8 *buffer, int len, ut64 from, ut64 to) {
+static void hash_print_crypto_begin(RzHashContext *ctx, const char *hname, ut64 from, ut64 to) {
+	switch (ctx->mode) {
+	case RZ_HASH_MODE_RANDOMART:
+	case RZ_HASH_MODE_STANDARD:
+		printf("0x%08" PFMT64x "-0x%08" PFMT64x " %s: ", from, to, hname);
+		fflush(stdout);
+		break;
+	case RZ_HASH_MODE_QUIET:
+		printf("%s: ", hname);
+		fflush(stdout);
+		break;
+	default:
+		break;
+	}
+}
+
+static void hash_print_crypto_write(const ut8 *buffer, int len) {
+	if (len > 0 && write(1, buffer, len) != len) {
+		RZ_LOG_ERROR("rz-hash: error, cannot write on stdout\n");
+	}
+}
+
+static void hash_print_crypto_end(RzHashContext *ctx) {
+	switch (ctx->mode) {
+	case RZ_HASH_MODE_RANDOMART:
+	case RZ_HASH_MODE_STANDARD:
+	case RZ_HASH_MODE_QUIET:
+		printf("\n");
+		break;
+	default:
+		break;
+	}
+}
+
+static void hash_print_crypto_json(RzHashContext *ctx, const char *hname, const ut8 *buffer, int len, ut64 from, ut64 to) {
 	char *value = ctx->operation == RZ_HASH_OP_ENCRYPT ? malloc(len * 2 + 1) : malloc(len + 1);
 	if (!value) {
 		RZ_LOG_ERROR("rz-hash: error, cannot allocate value memory\n");
@@ -681,36 +717,10 @@ static void hash_print_crypto(RzHashContext *ctx, const char *hname, const ut8 *
 		value[len] = 0;
 	}
 
-	switch (ctx->mode) {
-	case RZ_HASH_MODE_JSON:
-		pj_kn(ctx->pj, "from", from);
-		pj_kn(ctx->pj, "to", to);
-		pj_ks(ctx->pj, "name", hname);
-		pj_ks(ctx->pj, "value", value);
-		break;
-	case RZ_HASH_MODE_RANDOMART:
-	case RZ_HASH_MODE_STANDARD:
-		printf("0x%08" PFMT64x "-0x%08" PFMT64x " %s: ", from, to, hname);
-		fflush(stdout);
-		if (write(1, buffer, len) != len) {
-			RZ_LOG_ERROR("rz-hash: error, cannot write on stdout\n");
-		}
-		printf("\n");
-		break;
-	case RZ_HASH_MODE_QUIET:
-		printf("%s: ", hname);
-		fflush(stdout);
-		if (write(1, buffer, len) != len) {
-			RZ_LOG_ERROR("rz-hash: error, cannot write on stdout\n");
-		}
-		printf("\n");
-		break;
-	case RZ_HASH_MODE_VERY_QUIET:
-		if (write(1, buffer, len) != len) {
-			RZ_LOG_ERROR("rz-hash: error, cannot write on stdout\n");
-		}
-		break;
-	}
+	pj_kn(ctx->pj, "from", from);
+	pj_kn(ctx->pj, "to", to);
+	pj_ks(ctx->pj, "name", hname);
+	pj_ks(ctx->pj, "value", value);
 	free(value);
 }
 
@@ -797,15 +807,226 @@ static RzList *parse_hash_algorithms(RzHashContext *ctx) {
 	return rz_str_split_list(ctx->algorithm, ",", 0);
 }
 
+static RzHashCfg *hash_cfg_new_configured(RzHashContext *ctx, RzList *algorithms) {
+	const char *algorithm;
+	RzListIter *it;
+	RzHashCfg *md = rz_hash_cfg_new(ctx->rh);
+	if (!md) {
+		RZ_LOG_ERROR("rz-hash: error, cannot allocate hash context memory\n");
+		return NULL;
+	}
+	rz_list_foreach (algorithms, it, algorithm) {
+		if (!rz_hash_cfg_configure(md, algorithm)) {
+			rz_hash_cfg_free(md);
+			return NULL;
+		}
+	}
+	if (ctx->key.len > 0 && !rz_hash_cfg_hmac(md, ctx->key.buf, ctx->key.len)) {
+		rz_hash_cfg_free(md);
+		return NULL;
+	}
+	return md;
+}
+
+typedef struct {
+	RzHashCfg *md;
+	RzThreadTaskPool *pool;
+	const ut8 *data;
+	ut64 size;
+	bool ok;
+} HashUpdateTask;
+
+static void *hash_update_task(HashUpdateTask *task) {
+	task->ok = rz_hash_cfg_update_parallel(task->md, task->pool, task->data, task->size);
+	return NULL;
+}
+
+/**
+ * Hashes [from, to) together with the seed. With a pool, each chunk is
+ * hashed by all the algorithms in parallel while the next one is read.
+ */
+static bool hash_io_range(RzHashContext *ctx, RzHashCfg *md, RzThreadTaskPool *pool, RzIO *io, ut64 from, ut64 to) {
+	if (!rz_hash_cfg_init(md)) {
+		return false;
+	}
+	if (ctx->as_prefix && ctx->seed.buf &&
+		!rz_hash_cfg_update(md, ctx->seed.buf, ctx->seed.len)) {
+		return false;
+	}
+
+	// the chunk size only changes how the input is read, never the digests
+	ut64 chunk = RZ_MAX(ctx->block_size, RZ_HASH_CHUNK_SIZE);
+	ut8 *bufs[2] = { malloc(chunk), pool ? malloc(chunk) : NULL };
+	if (!bufs[0] || (pool && !bufs[1])) {
+		RZ_LOG_ERROR("rz-hash: error, cannot allocate block memory\n");
+		free(bufs[0]);
+		free(bufs[1]);
+		return false;
+	}
+
+	bool result = false;
+	HashUpdateTask task = { .md = md, .pool = pool, .ok = true };
+	RzThreadFuture *future = NULL;
+	int cur = 0;
+	for (ut64 j = from; j < to; j += chunk) {
+		int read = rz_io_pread_at(io, j, bufs[cur], RZ_MIN(chunk, to - j));
+		if (read < 0) {
+			RZ_LOG_ERROR("rz-hash: error, cannot read at 0x%08" PFMT64x "\n", j);
+			goto hash_io_range_end;
+		}
+		if (future) {
+			rz_th_future_wait(pool, future);
+			rz_th_future_free(future);
+			future = NULL;
+			if (!task.ok) {
+				goto hash_io_range_end;
+			}
+		}
+		task.data = bufs[cur];
+		task.size = read;
+		if (pool) {
+			future = rz_th_task_pool_submit(pool, (RzThreadFunction)hash_update_task, &task);
+			cur ^= 1;
+		}
+		if (!future) {
+			hash_update_task(&task);
+			if (!task.ok) {
+				goto hash_io_range_end;
+			}
+		}
+	}
+	if (future) {
+		rz_th_future_wait(pool, future);
+		rz_th_future_free(future);
+		future = NULL;
+		if (!task.ok) {
+			goto hash_io_range_end;
+		}
+	}
+
+	if (!ctx->as_prefix && ctx->seed.buf &&
+		!rz_hash_cfg_update(md, ctx->seed.buf, ctx->seed.len)) {
+		goto hash_io_range_end;
+	}
+	result = rz_hash_cfg_final(md) && rz_hash_cfg_iterate(md, ctx->iterate);
+
+hash_io_range_end:
+	if (future) {
+		rz_th_future_wait(pool, future);
+		rz_th_future_free(future);
+	}
+	free(bufs[0]);
+	free(bufs[1]);
+	return result;
+}
+
+typedef struct {
+	RzHashCfg **mds;
+	const ut8 *data;
+	const int *sizes;
+	bool *ok;
+	ut64 bsize;
+	ut64 iterate;
+} HashBlocksCtx;
+
+static void hash_blocks_range(size_t from, size_t to, void *user) {
+	HashBlocksCtx *ctx = user;
+	for (size_t i = from; i < to; i++) {
+		RzHashCfg *md = ctx->mds[i];
+		ctx->ok[i] = rz_hash_cfg_init(md) &&
+			rz_hash_cfg_update(md, ctx->data + i * ctx->bsize, ctx->sizes[i]) &&
+			rz_hash_cfg_final(md) &&
+			rz_hash_cfg_iterate(md, ctx->iterate);
+	}
+}
+
+/**
+ * Hashes and prints every block of [from, to) on its own. The blocks are
+ * read in batches, whose blocks are hashed in parallel and printed in order.
+ */
+static bool hash_io_blocks(RzHashContext *ctx, RzList *algorithms, RzThreadTaskPool *pool, RzIO *io, ut64 from, ut64 to, const char *filename) {
+	ut64 bsize = ctx->block_size;
+	size_t slots = 1;
+	if (pool) {
+		slots = RZ_MIN(rz_th_task_pool_size(pool) * 4, RZ_MAX(RZ_HASH_BATCH_SIZE / bsize, 1));
+	}
+	bool result = false;
+	const char *algorithm;
+	RzListIter *it;
+	RzHashCfg **mds = RZ_NEWS0(RzHashCfg *, slots);
+	int *sizes = RZ_NEWS0(int, slots);
+	bool *ok = RZ_NEWS0(bool, slots);
+	ut8 *data = malloc(slots * bsize);
+	if (!mds || !sizes || !ok || !data) {
+		RZ_LOG_ERROR("rz-hash: error, cannot allocate block memory\n");
+		goto hash_io_blocks_end;
+	}
+	for (size_t i = 0; i < slots; i++) {
+		if (!(mds[i] = hash_cfg_new_configured(ctx, algorithms))) {
+			goto hash_io_blocks_end;
+		}
+	}
+
+	HashBlocksCtx bctx = {
+		.mds = mds,
+		.data = data,
+		.sizes = sizes,
+		.ok = ok,
+		.bsize = bsize,
+		.iterate = ctx->iterate,
+	};
+	for (ut64 j = from; j < to; j += slots * bsize) {
+		size_t count = RZ_MIN(slots, (to - j + bsize - 1) / bsize);
+		for (size_t i = 0; i < count; i++) {
+			ut64 at = j + i * bsize;
+			sizes[i] = rz_io_pread_at(io, at, data + i * bsize, to - at > bsize ? bsize : (to - at));
+			if (sizes[i] < 0) {
+				RZ_LOG_ERROR("rz-hash: error, cannot read at 0x%08" PFMT64x "\n", at);
+				goto hash_io_blocks_end;
+			}
+		}
+		if (!pool || count < 2 || !rz_th_task_pool_parallel_for(pool, 0, count, 1, hash_blocks_range, &bctx)) {
+			hash_blocks_range(0, count, &bctx);
+		}
+		for (size_t i = 0; i < count; i++) {
+			if (!ok[i]) {
+				goto hash_io_blocks_end;
+			}
+			ut64 at = j + i * bsize;
+			rz_list_foreach (algorithms, it, algorithm) {
+				if (ctx->mode == RZ_HASH_MODE_JSON) {
+					pj_o(ctx->pj);
+				}
+				hash_print_digest(ctx, mds[i], algorithm, at, at + bsize, filename);
+				if (ctx->mode == RZ_HASH_MODE_JSON) {
+					pj_end(ctx->pj);
+				}
+			}
+		}
+	}
+	result = true;
+
+hash_io_blocks_end:
+	if (mds) {
+		for (size_t i = 0; i < slots; i++) {
+			rz_hash_cfg_free(mds[i]);
+		}
+	}
+	free(mds);
+	free(sizes);
+	free(ok);
+	free(data);
+	return result;
+}
+
 static bool calculate_hash(RzHashContext *ctx, RzIO *io, const char *filename) {
 	bool result = false;
 	const char *algorithm;
 	RzList *algorithms = NULL;
 	RzListIter *it;
 	RzHashCfg *md = NULL;
-	ut64 bsize = 0;
+	RzThreadTaskPool *pool = NULL;
 	ut64 filesize;
-	ut8 *block = NULL;
 	ut8 *cmphash = NULL;
 	const ut8 *digest = NULL;
 	RzHashSize digest_size = 0;
@@ -818,12 +1039,6 @@ static bool calculate_hash(RzHashContext *ctx, RzIO *io, const char *filename) {
 
 	filesize = rz_io_desc_size(io->desc);
 
-	md = rz_hash_cfg_new(ctx->rh);
-	if (!md) {
-		RZ_LOG_ERROR("rz-hash: error, cannot allocate hash context memory\n");
-		goto calculate_hash_end;
-	}
-
 	if (ctx->offset.to > filesize) {
 		RZ_LOG_ERROR("rz-hash: error, -t value is greater than file size\n");
 		goto calculate_hash_end;
@@ -834,25 +1049,18 @@ static bool calculate_hash(RzHashContext *ctx, RzIO *io, const char *filename) {
 		goto calculate_hash_end;
 	}
 
-	bsize = ctx->block_size;
-	block = malloc(bsize);
-	if (!block) {
-		RZ_LOG_ERROR("rz-hash: error, cannot allocate block memory\n");
+	md = hash_cfg_new_configured(ctx, algorithms);
+	if (!md) {
 		goto calculate_hash_end;
 	}
 
-	rz_list_foreach (algorithms, it, algorithm) {
-		if (!rz_hash_cfg_configure(md, algorithm)) {
-			goto calculate_hash_end;
-		}
-	}
-
-	if (ctx->key.len > 0 && !rz_hash_cfg_hmac(md, ctx->key.buf, ctx->key.len)) {
-		goto calculate_hash_end;
+	ut64 to = ctx->offset.to ? ctx->offset.to : filesize;
+	if (to > ctx->offset.from && to - ctx->offset.from > RZ_MAX(ctx->block_size, RZ_HASH_CHUNK_SIZE)) {
+		// small inputs are not worth starting the workers
+		pool = rz_th_task_pool_new(RZ_THREAD_POOL_ALL_CORES);
 	}
 
 	if (ctx->compare) {
-		ut64 to = ctx->offset.to ? ctx->offset.to : filesize;
 		size_t cmphashlen = 0;
 		bool result = false;
 
@@ -861,28 +1069,7 @@ static bool calculate_hash(RzHashContext *ctx, RzIO *io, const char *filename) {
 			goto calculate_hash_end;
 		}
 
-		if (!rz_hash_cfg_init(md)) {
-			goto calculate_hash_end;
-		}
-
-		if (ctx->as_prefix && ctx->seed.buf &&
-			!rz_hash_cfg_update(md, ctx->seed.buf, ctx->seed.len)) {
-			goto calculate_hash_end;
-		}
-
-		for (ut64 j = ctx->offset.from; j < to; j += bsize) {
-			int read = rz_io_pread_at(io, j, block, to - j > bsize ? bsize : (to - j));
-			if (!rz_hash_cfg_update(md, block, read)) {
-				goto calculate_hash_end;
-			}
-		}
-
-		if (!ctx->as_prefix && ctx->seed.buf &&
-			!rz_hash_cfg_update(md, ctx->seed.buf, ctx->seed.len)) {
-			goto calculate_hash_end;
-		}
-		if (!rz_hash_cfg_final(md) ||
-			!rz_hash_cfg_iterate(md, ctx->iterate)) {
+		if (!hash_io_range(ctx, md, pool, io, ctx->offset.from, to)) {
 			goto calculate_hash_end;
 		}
 
@@ -903,58 +1090,15 @@ static bool calculate_hash(RzHashContext *ctx, RzIO *io, const char *filename) {
 			}
 		}
 	} else if (ctx->show_blocks) {
-		ut64 to = ctx->offset.to ? ctx->offset.to : filesize;
-		for (ut64 j = ctx->offset.from; j < to; j += bsize) {
-			int read = rz_io_pread_at(io, j, block, to - j > bsize ? bsize : (to - j));
-			if (!rz_hash_cfg_init(md) ||
-				!rz_hash_cfg_update(md, block, read) ||
-				!rz_hash_cfg_final(md) ||
-				!rz_hash_cfg_iterate(md, ctx->iterate)) {
-				goto calculate_hash_end;
-			}
-
-			rz_list_foreach (algorithms, it, algorithm) {
-				digest = rz_hash_cfg_get_result(md, algorithm, &digest_size);
-				if (ctx->mode == RZ_HASH_MODE_JSON) {
-					pj_o(ctx->pj);
-				}
-				hash_print_digest(ctx, md, algorithm, j, j + bsize, filename);
-				if (ctx->mode == RZ_HASH_MODE_JSON) {
-					pj_end(ctx->pj);
-				}
-			}
-		}
-	} else {
-		ut64 to = ctx->offset.to ? ctx->offset.to : filesize;
-		if (!rz_hash_cfg_init(md)) {
+		if (!hash_io_blocks(ctx, algorithms, pool, io, ctx->offset.from, to, filename)) {
 			goto calculate_hash_end;
 		}
-
-		if (ctx->as_prefix && ctx->seed.buf &&
-			!rz_hash_cfg_update(md, ctx->seed.buf, ctx->seed.len)) {
-			goto calculate_hash_end;
-		}
-
-		for (ut64 j = ctx->offset.from; j < to; j += bsize) {
-			int read = rz_io_pread_at(io, j, block, to - j > bsize ? bsize : (to - j));
-			if (!rz_hash_cfg_update(md, block, read)) {
-				goto calculate_hash_end;
-			}
-		}
-
-		if (!ctx->as_prefix && ctx->seed.buf &&
-			!rz_hash_cfg_update(md, ctx->seed.buf, ctx->seed.len)) {
-			goto calculate_hash_end;
-		}
-
-		if (!rz_hash_cfg_final(md) ||
-			!rz_hash_cfg_iterate(md, ctx->iterate)) {
+	} else {
+		if (!hash_io_range(ctx, md, pool, io, ctx->offset.from, to)) {
 			goto calculate_hash_end;
 		}
 
 		rz_list_foreach (algorithms, it, algorithm) {
-			digest = rz_hash_cfg_get_result(md, algorithm, &digest_size);
-
 			if (ctx->mode == RZ_HASH_MODE_JSON) {
 				pj_o(ctx->pj);
 			}
@@ -967,13 +1111,50 @@ static bool calculate_hash(RzHashContext *ctx, RzIO *io, const char *filename) {
 	result = true;
 
 calculate_hash_end:
+	rz_th_task_pool_free(pool);
 	rz_list_free(algorithms);
-	free(block);
 	free(cmphash);
 	rz_hash_cfg_free(md);
 	return result;
 }
 
+static void hash_crypto_flush(RzCrypto *cry) {
+	int size = 0;
+	const ut8 *output = rz_crypto_get_output(cry, &size);
+	hash_print_crypto_write(output, size);
+	rz_crypto_clear_output(cry);
+}
+
+/*
+ * Runs cry over the range of the context, one block at a time. Unless the
+ * json output needs it whole, the output of each block is printed and
+ * dropped right away, so any size can be processed in constant memory.
+ */
+static void hash_crypto_range(RzHashContext *ctx, RzCrypto *cry, RzIO *io, ut8 *block, ut64 bsize, ut64 to) {
+	bool stream = ctx->mode != RZ_HASH_MODE_JSON;
+	if (stream) {
+		hash_print_crypto_begin(ctx, ctx->algorithm, ctx->offset.from, to);
+	}
+	for (ut64 j = ctx->offset.from; j < to; j += bsize) {
+		int read = rz_io_pread_at(io, j, block, to - j > bsize ? bsize : (to - j));
+		rz_crypto_update(cry, block, read);
+		if (stream) {
+			hash_crypto_flush(cry);
+		}
+	}
+
+	rz_crypto_final(cry, NULL, 0);
+
+	if (stream) {
+		hash_crypto_flush(cry);
+		hash_print_crypto_end(ctx);
+		return;
+	}
+	int size = 0;
+	const ut8 *output = rz_crypto_get_output(cry, &size);
+	hash_print_crypto_json(ctx, ctx->algorithm, output, size, ctx->offset.from, to);
+}
+
 static bool calculate_decrypt(RzHashContext *ctx, RzIO *io, const char *filename) {
 	RzCrypto *cry = NULL;
 	bool result = false;
@@ -1030,17 +1211,7 @@ static bool calculate_decrypt(RzHashContext *ctx, RzIO *io, const char *filename
 	}
 
 	ut64 to = ctx->offset.to ? ctx->offset.to : filesize;
-	for (ut64 j = ctx->offset.from; j < to; j += bsize) {
-		int read = rz_io_pread_at(io, j, block, to - j > bsize ? bsize : (to - j));
-		rz_crypto_update(cry, block, read);
-	}
-
-	rz_crypto_final(cry, NULL, 0);
-
-	int plaintext_size = 0;
-	const ut8 *plaintext = rz_crypto_get_output(cry, &plaintext_size);
-
-	hash_print_crypto(ctx, ctx->algorithm, plaintext, plaintext_size, ctx->offset.from, to);
+	hash_crypto_range(ctx, cry, io, block, bsize, to);
 	result = true;
 
 calculate_decrypt_end:
@@ -1112,17 +1283,7 @@ static bool calculate_encrypt(RzHashContext *ctx, RzIO *io, const char *filename
 	}
 
 	ut64 to = ctx->offset.to ? ctx->offset.to : filesize;
-	for (ut64 j = ctx->offset.from; j < to; j += bsize) {
-		int read = rz_io_pread_at(io, j, block, to - j > bsize ? bsize : (to - j));
-		rz_crypto_update(cry, block, read);
-	}
-
-	rz_crypto_final(cry, NULL, 0);
-
-	int ciphertext_size = 0;
-	const ut8 *ciphertext = rz_crypto_get_output(cry, &ciphertext_size);
-
-	hash_print_crypto(ctx, ctx->algorithm, ciphertext, ciphertext_size, ctx->offset.from, to);
+	hash_crypto_range(ctx, cry, io, block, bsize, to);
 	result = true;
 
 calculate_encrypt_end:
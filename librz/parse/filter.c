@@ -14,6 +14,8 @@
 	(x) == ',' || (x) == ';' || (x) == '[' || (x) == ']' || \
 	(x) == '(' || (x) == ')' || (x) == '{' || (x) == '}' || (x) == '\x1b')
 
+#define isregchar(x) (IS_LOWER(x) || IS_UPPER(x) || IS_DIGIT(x) || (x) == '_')
+
 static bool isvalidflag(RzFlagItem *flag) {
 	if (flag) {
 		if (strstr(flag->name, "main") || strstr(flag->name, "entry")) {
@@ -65,6 +67,7 @@ static int parse_number(const char *str) {
 	return p - str;
 }
 
+#if FILTER_DWORD
 // TODO: move into rz_util/rz_str
 static void replaceWords(char *s, const char *k, const char *v) {
 	for (;;) {
@@ -78,6 +81,7 @@ static void replaceWords(char *s, const char *k, const char *v) {
 		memmove(p, v, strlen(v));
 	}
 }
+#endif
 
 static char *findNextNumber(char *op) {
 	if (!op) {
@@ -142,7 +146,7 @@ static char *findNextNumber(char *op) {
 	return NULL;
 }
 
-static void __replaceRegisters(RzReg *reg, char *s, bool x86) {
+static const char *reg_role_of(RzReg *reg, const char *tok, size_t toklen, bool x86) {
 	int i;
 	for (i = 0; i < 64; i++) {
 		const char *k = rz_reg_get_name(reg, i);
@@ -153,14 +157,64 @@ static void __replaceRegisters(RzReg *reg, char *s, bool x86) {
 		if (!v) {
 			break;
 		}
-		if (x86 && *k == 'r') {
-			replaceWords(s, k, v);
-			char *reg32 = strdup(k);
-			*reg32 = 'e';
-			replaceWords(s, reg32, v);
-		} else {
-			replaceWords(s, k, v);
+		if (strlen(k) == toklen && !strncmp(k, tok, toklen)) {
+			return v;
+		}
+	}
+	if (!x86 || *tok != 'e') {
+		return NULL;
+	}
+	// 32bit views of the 64bit x86 registers: eax for rax, etc
+	for (i = 0; i < 64; i++) {
+		const char *k = rz_reg_get_name(reg, i);
+		if (!k || i == RZ_REG_NAME_PC) {
+			continue;
+		}
+		const char *v = rz_reg_get_role(i);
+		if (!v) {
+			break;
+		}
+		if (*k == 'r' && strlen(k) == toklen && !strncmp(k + 1, tok + 1, toklen - 1)) {
+			return v;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Replace every register name in \p s by its role (SP, A0, ...) in a single pass,
+ * looking up each identifier token once instead of scanning the whole line per role.
+ */
+static void __replaceRegisters(RzReg *reg, char *s, bool x86) {
+	char *p = s;
+	while (*p) {
+		if (*p == 0x1b) {
+			// skip ansi escape codes, their payload is not a register
+			for (p++; *p && !IS_LOWER(*p) && !IS_UPPER(*p); p++) {
+				;
+			}
+			if (*p) {
+				p++;
+			}
+			continue;
+		}
+		if (!isregchar(*p)) {
+			p++;
+			continue;
+		}
+		char *tok = p;
+		for (; isregchar(*p); p++) {
+			;
 		}
+		size_t toklen = p - tok;
+		const char *v = reg_role_of(reg, tok, toklen, x86);
+		if (!v) {
+			continue;
+		}
+		size_t vlen = strlen(v);
+		memmove(tok + vlen, p, strlen(p) + 1);
+		memcpy(tok, v, vlen);
+		p = tok + vlen;
 	}
 }
 
@@ -190,15 +244,13 @@ static bool filter(RzParse *p, ut64 addr, RzFlag *f, RzAnalysisHint *hint, char
 	replaceWords(ptr, "qword ", src);
 #endif
 	if (p->subreg) {
-		__replaceRegisters(p->analb.analysis->reg, ptr, false);
-		if (x86) {
-			__replaceRegisters(p->analb.analysis->reg, ptr, true);
-		}
+		__replaceRegisters(p->analb.analysis->reg, ptr, x86);
 	}
 	ptr2 = NULL;
 	// remove "dword" 2
 	char *nptr;
 	int count = 0;
+	const bool lea = x86 && rz_str_startswith_icase(data, "lea") && (data[3] == ' ' || data[3] == 0x1b);
 	for (count = 0; (nptr = findNextNumber(ptr)); count++) {
 		ptr = nptr;
 
@@ -247,7 +299,6 @@ static bool filter(RzParse *p, ut64 addr, RzFlag *f, RzAnalysisHint *hint, char
 			}
 			if (f) {
 				RzFlagItem *flag2;
-				bool lea = x86 && rz_str_startswith_icase(data, "lea") && (data[3] == ' ' || data[3] == 0x1b);
 				bool remove_brackets = false;
 				flag = p->flag_get(f, off);
 				if ((!flag || arm) && p->subrel_addr) {
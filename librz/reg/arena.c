@@ -4,6 +4,9 @@
 #include <rz_reg.h>
 #include <rz_util/rz_str.h>
 
+// popped arenas kept per register type for the next pushes
+#define RZ_REG_ARENA_SPARE_MAX 8
+
 /* non-endian safe - used for raw mapping with system registers */
 RZ_API ut8 *rz_reg_get_bytes(RzReg *reg, int type, int *size) {
 	RzRegArena *arena;
@@ -213,6 +216,41 @@ RZ_API void rz_reg_arena_swap(RzReg *reg, int copy) {
 	}
 }
 
+/**
+ * \brief Keeps a popped arena around for the next push, or frees it when enough are kept
+ */
+static void arena_release(RzRegSet *regset, RzRegArena *a) {
+	if (!regset->spare || rz_pvector_len(regset->spare) >= RZ_REG_ARENA_SPARE_MAX || !rz_pvector_push(regset->spare, a)) {
+		rz_reg_arena_free(a);
+	}
+}
+
+/**
+ * \brief Returns an arena of \p size bytes, reusing a popped one when possible
+ *
+ * The content of the bytes is undefined, the caller overwrites them.
+ */
+static RzRegArena *arena_acquire(RzRegSet *regset, int size) {
+	RzRegArena *a = regset->spare && !rz_pvector_empty(regset->spare) ? rz_pvector_pop(regset->spare) : NULL;
+	if (!a) {
+		return rz_reg_arena_new(size);
+	}
+	if (a->size != size) {
+		// keep the same slack as rz_reg_arena_new()
+		ut8 *bytes = size > 0 ? realloc(a->bytes, size + 8) : NULL;
+		if (size > 0 && !bytes) {
+			rz_reg_arena_free(a);
+			return rz_reg_arena_new(size);
+		}
+		if (size < 1) {
+			free(a->bytes);
+		}
+		a->bytes = bytes;
+		a->size = size;
+	}
+	return a;
+}
+
 RZ_API void rz_reg_arena_pop(RzReg *reg) {
 	RzRegArena *a;
 	int i;
@@ -224,7 +262,7 @@ RZ_API void rz_reg_arena_pop(RzReg *reg) {
 			continue;
 		}
 		a = rz_list_pop(reg->regset[i].pool);
-		rz_reg_arena_free(a);
+		arena_release(&reg->regset[i], a);
 		a = reg->regset[i].pool->tail->data;
 		if (a) {
 			reg->regset[i].arena = a;
@@ -240,13 +278,15 @@ RZ_API int rz_reg_arena_push(RzReg *reg) {
 		if (!a) {
 			continue;
 		}
-		RzRegArena *b = rz_reg_arena_new(a->size); // new arena
+		RzRegArena *b = arena_acquire(&reg->regset[i], a->size); // new arena
 		if (!b) {
 			continue;
 		}
-		// b->size == a->size always because of how rz_reg_arena_new behave
-		if (a->bytes) {
+		// b->size == a->size always because of how arena_acquire behave
+		if (a->bytes && b->bytes) {
 			memcpy(b->bytes, a->bytes, b->size);
+		} else if (b->bytes) {
+			memset(b->bytes, 0, b->size);
 		}
 		rz_list_push(reg->regset[i].pool, b);
 		reg->regset[i].arena = b;
@@ -355,6 +355,27 @@ static void add_item_to_regset(RZ_BORROW RzReg *reg, RZ_BORROW RzRegItem *item)
 	reg->regset[t].maskregstype |= ((int)1 << item->type);
 }
 
+/**
+ * Index the names of the registers of all the regsets at once, so looking
+ * up a name without knowing its type is a single hashtable lookup instead of
+ * one per regset.
+ */
+static void index_names(RZ_BORROW RzReg *reg) {
+	ht_pp_free(reg->ht_names);
+	reg->ht_names = ht_pp_new0();
+	if (!reg->ht_names) {
+		return;
+	}
+	for (int i = 0; i < RZ_REG_TYPE_LAST; i++) {
+		RzListIter *it;
+		RzRegItem *item;
+		rz_list_foreach (reg->regset[i].regs, it, item) {
+			// keep the first one, like the lookup in regset order does
+			ht_pp_insert(reg->ht_names, item->name, item);
+		}
+	}
+}
+
 /**
  * \brief Fills \p reg->regset with the definitions and alias of the register profile.
  *
@@ -405,7 +426,7 @@ RZ_API bool rz_reg_set_reg_profile(RZ_BORROW RzReg *reg) {
 
 		add_item_to_regset(reg, item);
 	}
-
+	index_names(reg);
 	return true;
 }
 
@@ -193,6 +193,7 @@ RZ_API void rz_reg_free_internal(RzReg *reg, bool init) {
 	rz_return_if_fail(reg);
 	ut32 i;
 
+	reg->generation++;
 	rz_list_free(reg->roregs);
 	reg->roregs = NULL;
 	RZ_FREE(reg->reg_profile_str);
@@ -207,6 +208,8 @@ RZ_API void rz_reg_free_internal(RzReg *reg, bool init) {
 			RZ_FREE(reg->name[i]);
 		}
 	}
+	ht_pp_free(reg->ht_names);
+	reg->ht_names = NULL;
 	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
 		ht_pp_free(reg->regset[i].ht_regs);
 		reg->regset[i].ht_regs = NULL;
@@ -226,6 +229,8 @@ RZ_API void rz_reg_free_internal(RzReg *reg, bool init) {
 			reg->regset[i].arena = NULL;
 			rz_list_free(reg->regset[i].pool);
 			reg->regset[i].pool = NULL;
+			rz_pvector_free(reg->regset[i].spare);
+			reg->regset[i].spare = NULL;
 		}
 	}
 	if (!init) {
@@ -298,6 +303,7 @@ RZ_API RzReg *rz_reg_new(void) {
 			return NULL;
 		}
 		reg->regset[i].pool = rz_list_newf((RzListFree)rz_reg_arena_free);
+		reg->regset[i].spare = rz_pvector_new((RzPVectorFree)rz_reg_arena_free);
 		reg->regset[i].regs = rz_list_newf((RzListFree)rz_reg_item_free);
 		rz_list_push(reg->regset[i].pool, arena);
 		reg->regset[i].arena = arena;
@@ -359,6 +365,9 @@ RZ_API RzRegItem *rz_reg_get(RzReg *reg, const char *name, int type) {
 				name = nname;
 			}
 		}
+		if (reg->ht_names) {
+			return ht_pp_find(reg->ht_names, name, NULL);
+		}
 	} else {
 		i = type;
 		e = type + 1;
@@ -372,3 +372,56 @@ RZ_API int rz_reg_set_pack(RzReg *reg, RzRegItem *item, int packidx, int packbit
 	eprintf("rz_reg_set_value: Cannot set %s to 0x%" PFMT64x "\n", item->name, val);
 	return false;
 }
+
+static ut8 *reg_pack_bytes(RzReg *reg, RzRegItem *item, int packidx, int *packbytes) {
+	if (*packbytes < 1) {
+		if (item->size % 8) {
+			return NULL;
+		}
+		*packbytes = item->size / 8;
+	}
+	if (*packbytes < 1 || item->offset < 0 || item->offset % 8 || packidx < 0 || ((st64)packidx + 1) * *packbytes * 8 > item->size) {
+		return NULL;
+	}
+	RzRegArena *arena = reg->regset[item->arena].arena;
+	int off = item->offset / 8 + packidx * *packbytes;
+	if (!arena || !arena->bytes || off + *packbytes > arena->size) {
+		return NULL;
+	}
+	return arena->bytes + off;
+}
+
+/**
+ * \brief Copies a lane of a byte-aligned register, of any size, into \p buf
+ *
+ * The bytes are copied as they are stored in the arena, without any endian
+ * conversion, which makes it suitable for vector registers wider than 64 bits.
+ *
+ * \param packidx index of the lane, lane 0 starting at the first byte of the register
+ * \param packbytes size of a lane in bytes, or 0 for the whole register
+ * \param buf buffer of at least \p packbytes bytes
+ */
+RZ_API bool rz_reg_get_pack_bytes(RZ_NONNULL RzReg *reg, RZ_NONNULL RzRegItem *item, int packidx, int packbytes, RZ_OUT RZ_NONNULL ut8 *buf) {
+	rz_return_val_if_fail(reg && item && buf, false);
+	const ut8 *src = reg_pack_bytes(reg, item, packidx, &packbytes);
+	if (!src) {
+		return false;
+	}
+	memcpy(buf, src, packbytes);
+	return true;
+}
+
+/**
+ * \brief Sets a lane of a byte-aligned register, of any size, from \p buf
+ *
+ * \see rz_reg_get_pack_bytes()
+ */
+RZ_API bool rz_reg_set_pack_bytes(RZ_NONNULL RzReg *reg, RZ_NONNULL RzRegItem *item, int packidx, int packbytes, RZ_NONNULL const ut8 *buf) {
+	rz_return_val_if_fail(reg && item && buf, false);
+	ut8 *dst = reg_pack_bytes(reg, item, packidx, &packbytes);
+	if (!dst) {
+		return false;
+	}
+	memcpy(dst, buf, packbytes);
+	return true;
+}
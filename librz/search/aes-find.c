@@ -22,6 +22,20 @@
 #define AES192_KEY_LENGTH    24
 #define AES256_KEY_LENGTH    32
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AES_USE_SSE2 1
+#endif
+
+/*
+ * Positions are pre-filtered by groups of AES_GROUP_SIZE: a key schedule can
+ * only start at i if the first byte of its second expanded word is the xor
+ * of the bytes 4 and (key length) at i, for one of the key lengths.
+ * AES_GROUP_READ is how many bytes past the group start are looked at.
+ */
+#define AES_GROUP_SIZE 16
+#define AES_GROUP_READ (AES_GROUP_SIZE + AES256_SEARCH_LENGTH - 4)
+
 static bool aes256_key_test(const unsigned char *buf) {
 	bool word1 = buf[32] == (buf[0] ^ Sbox[buf[29]] ^ 1) && buf[33] == (buf[1] ^ Sbox[buf[30]]) && buf[34] == (buf[2] ^ Sbox[buf[31]]) && buf[35] == (buf[3] ^ Sbox[buf[28]]);
 	bool word2 = (buf[36] == (buf[4] ^ buf[32]) && buf[37] == (buf[5] ^ buf[33]) && buf[38] == (buf[6] ^ buf[34]) && buf[39] == (buf[7] ^ buf[35]));
@@ -40,6 +54,29 @@ static bool aes128_key_test(const unsigned char *buf) {
 	return word1 && word2;
 }
 
+// Returns a bitmask of the positions of the group where a key schedule may start.
+static inline ut32 aes_group_candidates(const ut8 *buf) {
+#ifdef AES_USE_SSE2
+	__m128i w4 = _mm_loadu_si128((const __m128i *)(buf + 4));
+	__m128i m128 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(buf + 20)),
+		_mm_xor_si128(w4, _mm_loadu_si128((const __m128i *)(buf + 16))));
+	__m128i m192 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(buf + 28)),
+		_mm_xor_si128(w4, _mm_loadu_si128((const __m128i *)(buf + 24))));
+	__m128i m256 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(buf + 36)),
+		_mm_xor_si128(w4, _mm_loadu_si128((const __m128i *)(buf + 32))));
+	return (ut32)_mm_movemask_epi8(_mm_or_si128(m128, _mm_or_si128(m192, m256)));
+#else
+	ut32 mask = 0;
+	for (ut32 i = 0; i < AES_GROUP_SIZE; i++) {
+		const ut8 *b = buf + i;
+		if (b[20] == (b[4] ^ b[16]) || b[28] == (b[4] ^ b[24]) || b[36] == (b[4] ^ b[32])) {
+			mask |= 1 << i;
+		}
+	}
+	return mask;
+#endif
+}
+
 RZ_API int rz_search_aes_update(RzSearch *s, ut64 from, const ut8 *buf, int len) {
 	int i, t, last = len - AES128_SEARCH_LENGTH;
 	RzListIter *iter;
@@ -48,7 +85,17 @@ RZ_API int rz_search_aes_update(RzSearch *s, ut64 from, const ut8 *buf, int len)
 
 	rz_list_foreach (s->kws, iter, kw) {
 		if (last >= 0) {
+			int group = -AES_GROUP_SIZE;
+			ut32 candidates = 0;
 			for (i = 0; i < last; i++) {
+				if (i >= group + AES_GROUP_SIZE && i + AES_GROUP_READ <= len) {
+					group = i;
+					candidates = aes_group_candidates(buf + i);
+				}
+				// near the end of the buffer every position is tested
+				if (i < group + AES_GROUP_SIZE && !(candidates & (1 << (i - group)))) {
+					continue;
+				}
 				if (aes128_key_test(buf + i)) {
 					kw->keyword_length = AES128_KEY_LENGTH;
 					t = rz_search_hit_new(s, kw, from + i);
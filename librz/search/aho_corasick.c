@@ -0,0 +1,307 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/**
+ * \file aho_corasick.c
+ * Multi-pattern matcher used by the keyword search when there are many keywords.
+ *
+ * Each keyword contributes an "anchor" to the automaton: its longest run of
+ * bytes not affected by the binmask. The automaton only reports candidate
+ * positions, every candidate is then checked against the whole keyword, so
+ * binmasks and icase keep their exact semantics. When some keyword ignores
+ * case, all the anchors and the scanned data are lowercased, which gives a
+ * superset of the actual matches of the case sensitive keywords too.
+ *
+ * The automaton is a complete DFA over the byte classes appearing in the
+ * anchors, which makes the scan a single table lookup per byte.
+ *
+ * The tables are never modified after the compilation, so several automata
+ * scanning in different threads can share them, see rz_search_ac_share().
+ */
+
+#include "search_private.h"
+#include <ctype.h>
+
+// Don't build automata bigger than this (in transitions), the brute force search is used instead
+#define AC_MAX_TRANSITIONS (16 * 1024 * 1024)
+
+typedef struct {
+	int off; ///< offset of the anchor inside the keyword
+	int len; ///< length of the anchor, 0 if the keyword has no anchor
+	int next; ///< next keyword whose anchor ends in the same state, -1 if none
+} RzSearchACKeyword;
+
+struct rz_search_ac_t {
+	int n_kws;
+	RzSearchACKeyword *kws;
+	RzVector /*<int>*/ *cands[2]; ///< candidate start offsets, one vector per keyword for each scanned window
+	bool fold;
+	ut8 cls[UT8_MAX + 1]; ///< byte -> class, 0 for the bytes not appearing in any anchor
+	int n_cls;
+	int n_states;
+	int *delta; ///< n_states * n_cls transitions
+	int *out; ///< first keyword whose anchor ends in the state, -1 if none
+	int *dict; ///< nearest state in the fail chain with some output, 0 if none
+	bool shared; ///< kws, delta, out and dict are borrowed from the automaton this one was shared from
+};
+
+static ut8 fold_byte(const RzSearchAC *ac, ut8 b) {
+	return ac->fold ? tolower(b) : b;
+}
+
+static void keyword_anchor(const RzSearchKeyword *kw, RzSearchACKeyword *akw) {
+	akw->off = 0;
+	akw->len = 0;
+	if (!kw->binmask_length) {
+		akw->len = kw->keyword_length;
+		return;
+	}
+	int run = 0;
+	for (int j = 0; j < kw->keyword_length; j++) {
+		if (kw->bin_binmask[j % kw->binmask_length] != 0xff) {
+			run = 0;
+			continue;
+		}
+		run++;
+		if (run > akw->len) {
+			akw->len = run;
+			akw->off = j - run + 1;
+		}
+	}
+}
+
+static bool states_grow(RzSearchAC *ac, int *capacity) {
+	if (ac->n_states < *capacity) {
+		return true;
+	}
+	int cap = *capacity * 2;
+	if ((st64)cap * ac->n_cls > AC_MAX_TRANSITIONS) {
+		return false;
+	}
+	int *delta = realloc(ac->delta, sizeof(int) * cap * ac->n_cls);
+	if (!delta) {
+		return false;
+	}
+	ac->delta = delta;
+	memset(ac->delta + (size_t)*capacity * ac->n_cls, 0, sizeof(int) * (cap - *capacity) * ac->n_cls);
+	int *out = realloc(ac->out, sizeof(int) * cap);
+	if (!out) {
+		return false;
+	}
+	ac->out = out;
+	*capacity = cap;
+	return true;
+}
+
+static bool trie_add(RzSearchAC *ac, const RzSearchKeyword *kw, int idx, int *capacity) {
+	RzSearchACKeyword *akw = &ac->kws[idx];
+	int state = 0;
+	for (int j = akw->off; j < akw->off + akw->len; j++) {
+		int *next = &ac->delta[(size_t)state * ac->n_cls + ac->cls[fold_byte(ac, kw->bin_keyword[j])]];
+		if (!*next) {
+			if (!states_grow(ac, capacity)) {
+				return false;
+			}
+			// delta may have moved
+			next = &ac->delta[(size_t)state * ac->n_cls + ac->cls[fold_byte(ac, kw->bin_keyword[j])]];
+			ac->out[ac->n_states] = -1;
+			*next = ac->n_states++;
+		}
+		state = *next;
+	}
+	akw->next = ac->out[state];
+	ac->out[state] = idx;
+	return true;
+}
+
+static bool fail_links_build(RzSearchAC *ac) {
+	int *fail = calloc(ac->n_states, sizeof(int));
+	int *queue = malloc(sizeof(int) * ac->n_states);
+	ac->dict = calloc(ac->n_states, sizeof(int));
+	if (!fail || !queue || !ac->dict) {
+		free(fail);
+		free(queue);
+		return false;
+	}
+	int head = 0, tail = 0;
+	queue[tail++] = 0;
+	while (head < tail) {
+		int state = queue[head++];
+		int *row = &ac->delta[(size_t)state * ac->n_cls];
+		const int *fail_row = &ac->delta[(size_t)fail[state] * ac->n_cls];
+		// class 0 never appears in an anchor, so it always leads back to the root
+		for (int c = 1; c < ac->n_cls; c++) {
+			if (!row[c]) {
+				row[c] = state ? fail_row[c] : 0;
+				continue;
+			}
+			int child = row[c];
+			fail[child] = state ? fail_row[c] : 0;
+			ac->dict[child] = ac->out[fail[child]] >= 0 ? fail[child] : ac->dict[fail[child]];
+			queue[tail++] = child;
+		}
+	}
+	free(fail);
+	free(queue);
+	return true;
+}
+
+static bool candidates_init(RzSearchAC *ac) {
+	ac->cands[0] = RZ_NEWS0(RzVector, ac->n_kws);
+	ac->cands[1] = RZ_NEWS0(RzVector, ac->n_kws);
+	if (!ac->cands[0] || !ac->cands[1]) {
+		return false;
+	}
+	for (int i = 0; i < ac->n_kws; i++) {
+		rz_vector_init(&ac->cands[0][i], sizeof(int), NULL, NULL);
+		rz_vector_init(&ac->cands[1][i], sizeof(int), NULL, NULL);
+	}
+	return true;
+}
+
+/**
+ * \brief Compile the automaton matching the keywords in \p kws
+ *
+ * \return the automaton, or NULL if it would be too big and the keywords must be searched one by one
+ */
+RZ_IPI RzSearchAC *rz_search_ac_new(RzList /*<RzSearchKeyword *>*/ *kws) {
+	rz_return_val_if_fail(kws, NULL);
+	RzSearchAC *ac = RZ_NEW0(RzSearchAC);
+	if (!ac) {
+		return NULL;
+	}
+	ac->n_kws = rz_list_length(kws);
+	ac->kws = RZ_NEWS0(RzSearchACKeyword, ac->n_kws);
+	if (!ac->kws || !candidates_init(ac)) {
+		goto fail;
+	}
+	RzListIter *iter;
+	RzSearchKeyword *kw;
+	rz_list_foreach (kws, iter, kw) {
+		if (kw->icase) {
+			ac->fold = true;
+		}
+	}
+	bool used[UT8_MAX + 1] = { 0 };
+	int idx = 0;
+	rz_list_foreach (kws, iter, kw) {
+		keyword_anchor(kw, &ac->kws[idx]);
+		for (int j = ac->kws[idx].off; j < ac->kws[idx].off + ac->kws[idx].len; j++) {
+			used[fold_byte(ac, kw->bin_keyword[j])] = true;
+		}
+		idx++;
+	}
+	ac->n_cls = 1;
+	for (int b = 0; b <= UT8_MAX; b++) {
+		ac->cls[b] = used[b] ? ac->n_cls++ : 0;
+	}
+	if (ac->fold) {
+		for (int b = 0; b <= UT8_MAX; b++) {
+			ac->cls[b] = ac->cls[tolower(b)];
+		}
+	}
+	int capacity = 64;
+	ac->delta = calloc((size_t)capacity * ac->n_cls, sizeof(int));
+	ac->out = malloc(sizeof(int) * capacity);
+	if (!ac->delta || !ac->out) {
+		goto fail;
+	}
+	ac->out[0] = -1;
+	ac->n_states = 1;
+	idx = 0;
+	rz_list_foreach (kws, iter, kw) {
+		if (ac->kws[idx].len && !trie_add(ac, kw, idx, &capacity)) {
+			goto fail;
+		}
+		idx++;
+	}
+	if (!fail_links_build(ac)) {
+		goto fail;
+	}
+	return ac;
+fail:
+	rz_search_ac_free(ac);
+	return NULL;
+}
+
+/**
+ * \brief Create an automaton using the tables of \p ac, with its own candidates
+ *
+ * The new automaton can scan in another thread than \p ac, which must
+ * outlive it.
+ */
+RZ_IPI RzSearchAC *rz_search_ac_share(RzSearchAC *ac) {
+	rz_return_val_if_fail(ac, NULL);
+	RzSearchAC *sac = RZ_NEW0(RzSearchAC);
+	if (!sac) {
+		return NULL;
+	}
+	*sac = *ac;
+	sac->shared = true;
+	sac->cands[0] = sac->cands[1] = NULL;
+	if (!candidates_init(sac)) {
+		rz_search_ac_free(sac);
+		return NULL;
+	}
+	return sac;
+}
+
+RZ_IPI void rz_search_ac_free(RzSearchAC *ac) {
+	if (!ac) {
+		return;
+	}
+	for (int w = 0; w < 2; w++) {
+		for (int i = 0; ac->cands[w] && i < ac->n_kws; i++) {
+			rz_vector_fini(&ac->cands[w][i]);
+		}
+		free(ac->cands[w]);
+	}
+	if (!ac->shared) {
+		free(ac->kws);
+		free(ac->delta);
+		free(ac->out);
+		free(ac->dict);
+	}
+	free(ac);
+}
+
+/**
+ * \brief Whether the keyword at index \p idx has an anchor, i.e. can be found through rz_search_ac_scan()
+ */
+RZ_IPI bool rz_search_ac_has_anchor(RzSearchAC *ac, int idx) {
+	rz_return_val_if_fail(ac && idx >= 0 && idx < ac->n_kws, false);
+	return ac->kws[idx].len > 0;
+}
+
+/**
+ * \brief Collect the candidate offsets in \p buf of every keyword into the \p window set
+ *
+ * Only the candidates starting before \p max_start are collected, in
+ * increasing order. The caller must still check that the whole keyword
+ * fits in the data and matches.
+ */
+RZ_IPI void rz_search_ac_scan(RzSearchAC *ac, int window, const ut8 *buf, int len, int max_start) {
+	rz_return_if_fail(ac && window >= 0 && window < 2 && buf);
+	RzVector *cands = ac->cands[window];
+	for (int i = 0; i < ac->n_kws; i++) {
+		rz_vector_clear(&cands[i]);
+	}
+	int state = 0;
+	for (int p = 0; p < len; p++) {
+		state = ac->delta[(size_t)state * ac->n_cls + ac->cls[buf[p]]];
+		int t = ac->out[state] >= 0 ? state : ac->dict[state];
+		for (; t; t = ac->dict[t]) {
+			for (int k = ac->out[t]; k >= 0; k = ac->kws[k].next) {
+				int start = p + 1 - ac->kws[k].len - ac->kws[k].off;
+				if (start >= 0 && start < max_start) {
+					rz_vector_push(&cands[k], &start);
+				}
+			}
+		}
+	}
+}
+
+RZ_IPI RzVector /*<int>*/ *rz_search_ac_candidates(RzSearchAC *ac, int window, int idx) {
+	rz_return_val_if_fail(ac && window >= 0 && window < 2 && idx >= 0 && idx < ac->n_kws, NULL);
+	return &ac->cands[window][idx];
+}
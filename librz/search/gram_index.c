@@ -0,0 +1,402 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/**
+ * \file gram_index.c
+ * Inverted index of the 4-byte grams of a memory range, used to restrict
+ * repeated keyword searches to the parts of the range which may match.
+ *
+ * Every gram is hashed into one of GRAM_BUCKETS buckets, which holds the
+ * sorted list of the pages the gram appears in. Pages start at 256 bytes
+ * and are doubled, merging their lists, whenever the index would take more
+ * memory than allowed. Grams are lowercased, so that icase keywords can be
+ * looked up too: like hash collisions, this only adds candidates.
+ *
+ * A keyword is looked up through its least frequent window of 4 bytes not
+ * affected by the binmask, keywords without such a window make the index
+ * unusable for the search.
+ */
+
+#include "search_private.h"
+#include <ctype.h>
+
+#define GRAM_SIZE          4
+#define GRAM_BUCKETS_BITS  16
+#define GRAM_BUCKETS       (1 << GRAM_BUCKETS_BITS)
+#define GRAM_MIN_SHIFT     8
+#define GRAM_INDEX_MAGIC   "RZGI"
+#define GRAM_INDEX_VERSION 1
+
+typedef struct {
+	ut32 *pages;
+	ut32 len;
+	ut32 cap;
+} GramBucket;
+
+struct rz_search_gram_index_t {
+	ut64 addr;
+	ut64 size;
+	ut64 fed; ///< bytes given to rz_search_gram_index_feed() so far
+	ut64 max_mem;
+	ut64 mem; ///< bytes allocated for the page lists
+	ut32 shift; ///< log2 of the page size
+	ut32 gram; ///< last GRAM_SIZE - 1 folded bytes fed, in the low bits
+	GramBucket *buckets;
+};
+
+static ut32 gram_hash(ut32 gram) {
+	return (gram * 2654435761U) >> (32 - GRAM_BUCKETS_BITS);
+}
+
+static ut32 gram_of(const ut8 *b) {
+	return ((ut32)tolower(b[0]) << 24) | ((ut32)tolower(b[1]) << 16) | ((ut32)tolower(b[2]) << 8) | tolower(b[3]);
+}
+
+/**
+ * \brief Create an empty index of the \p size bytes at \p addr
+ *
+ * The data is then given in order with rz_search_gram_index_feed().
+ *
+ * \param max_mem maximum size of the page lists, the pages get larger when it is reached
+ */
+RZ_API RZ_OWN RzSearchGramIndex *rz_search_gram_index_new(ut64 addr, ut64 size, ut64 max_mem) {
+	rz_return_val_if_fail(size && addr + size - 1 >= addr, NULL);
+	RzSearchGramIndex *idx = RZ_NEW0(RzSearchGramIndex);
+	if (!idx) {
+		return NULL;
+	}
+	idx->buckets = RZ_NEWS0(GramBucket, GRAM_BUCKETS);
+	if (!idx->buckets) {
+		free(idx);
+		return NULL;
+	}
+	idx->addr = addr;
+	idx->size = size;
+	idx->max_mem = max_mem;
+	idx->shift = GRAM_MIN_SHIFT;
+	// page numbers must fit in 32 bits
+	while (((size - 1) >> idx->shift) > UT32_MAX) {
+		idx->shift++;
+	}
+	return idx;
+}
+
+RZ_API void rz_search_gram_index_free(RZ_NULLABLE RzSearchGramIndex *idx) {
+	if (!idx) {
+		return;
+	}
+	for (ut32 i = 0; i < GRAM_BUCKETS; i++) {
+		free(idx->buckets[i].pages);
+	}
+	free(idx->buckets);
+	free(idx);
+}
+
+/**
+ * Double the page size until the lists fit in max_mem, or until a
+ * single page covers the whole range.
+ */
+static void gram_index_shrink(RzSearchGramIndex *idx) {
+	while (idx->mem > idx->max_mem && ((idx->size - 1) >> idx->shift)) {
+		idx->shift++;
+		idx->mem = 0;
+		for (ut32 i = 0; i < GRAM_BUCKETS; i++) {
+			GramBucket *b = &idx->buckets[i];
+			ut32 n = 0;
+			for (ut32 j = 0; j < b->len; j++) {
+				ut32 page = b->pages[j] >> 1;
+				if (!n || b->pages[n - 1] != page) {
+					b->pages[n++] = page;
+				}
+			}
+			b->len = n;
+			if (n < b->cap / 2) {
+				ut32 *pages = realloc(b->pages, RZ_MAX(n, 1) * sizeof(ut32));
+				if (pages) {
+					b->pages = pages;
+					b->cap = RZ_MAX(n, 1);
+				}
+			}
+			idx->mem += (ut64)b->cap * sizeof(ut32);
+		}
+	}
+}
+
+static bool gram_index_add(RzSearchGramIndex *idx, ut32 gram, ut64 off) {
+	GramBucket *b = &idx->buckets[gram_hash(gram)];
+	ut32 page = off >> idx->shift;
+	if (b->len && b->pages[b->len - 1] == page) {
+		return true;
+	}
+	if (b->len == b->cap) {
+		ut32 cap = b->cap ? b->cap * 2 : 4;
+		ut32 *pages = realloc(b->pages, cap * sizeof(ut32));
+		if (!pages) {
+			return false;
+		}
+		b->pages = pages;
+		idx->mem += (ut64)(cap - b->cap) * sizeof(ut32);
+		b->cap = cap;
+	}
+	b->pages[b->len++] = page;
+	return true;
+}
+
+/**
+ * \brief Add the next \p len bytes of the indexed range to \p idx
+ *
+ * \return false on allocation failure or if more data than the size of the index is given
+ */
+RZ_API bool rz_search_gram_index_feed(RZ_NONNULL RzSearchGramIndex *idx, RZ_NONNULL const ut8 *buf, ut64 len) {
+	rz_return_val_if_fail(idx && buf, false);
+	if (len > idx->size - idx->fed) {
+		return false;
+	}
+	ut32 gram = idx->gram;
+	for (ut64 i = 0; i < len; i++) {
+		gram = (gram << 8) | (ut8)tolower(buf[i]);
+		ut64 off = idx->fed + i;
+		if (off + 1 < GRAM_SIZE) {
+			continue;
+		}
+		if (!gram_index_add(idx, gram, off + 1 - GRAM_SIZE)) {
+			return false;
+		}
+		if (idx->mem > idx->max_mem) {
+			gram_index_shrink(idx);
+		}
+	}
+	idx->gram = gram;
+	idx->fed += len;
+	return true;
+}
+
+RZ_API RzInterval rz_search_gram_index_itv(RZ_NONNULL RzSearchGramIndex *idx) {
+	rz_return_val_if_fail(idx, (RzInterval){ 0 });
+	return (RzInterval){ idx->addr, idx->size };
+}
+
+/**
+ * \brief Whether all the data of the indexed range has been fed
+ */
+RZ_API bool rz_search_gram_index_complete(RZ_NONNULL RzSearchGramIndex *idx) {
+	rz_return_val_if_fail(idx, false);
+	return idx->fed == idx->size;
+}
+
+/**
+ * \brief Size of the pages the offsets are recorded with
+ */
+RZ_API ut64 rz_search_gram_index_page_size(RZ_NONNULL RzSearchGramIndex *idx) {
+	rz_return_val_if_fail(idx, 0);
+	return 1ULL << idx->shift;
+}
+
+/**
+ * \brief Memory taken by the index, in bytes
+ */
+RZ_API ut64 rz_search_gram_index_mem(RZ_NONNULL RzSearchGramIndex *idx) {
+	rz_return_val_if_fail(idx, 0);
+	return idx->mem + GRAM_BUCKETS * sizeof(GramBucket) + sizeof(RzSearchGramIndex);
+}
+
+/**
+ * Find the offset of the least frequent window of \p kw which can be
+ * looked up, or -1 if there is none.
+ */
+static int keyword_window(RzSearchGramIndex *idx, RzSearchKeyword *kw) {
+	int best = -1;
+	ut32 best_len = UT32_MAX;
+	int run = 0;
+	for (int j = 0; j < kw->keyword_length; j++) {
+		if (kw->binmask_length && kw->bin_binmask[j % kw->binmask_length] != 0xff) {
+			run = 0;
+			continue;
+		}
+		if (++run < GRAM_SIZE) {
+			continue;
+		}
+		int k = j + 1 - GRAM_SIZE;
+		ut32 len = idx->buckets[gram_hash(gram_of(kw->bin_keyword + k))].len;
+		if (len < best_len) {
+			best = k;
+			best_len = len;
+		}
+	}
+	return best;
+}
+
+typedef struct {
+	ut64 first;
+	ut64 last;
+} GramBlocks;
+
+static int gram_blocks_cmp(const void *a, const void *b) {
+	const GramBlocks *x = a, *y = b;
+	return x->first < y->first ? -1 : x->first > y->first;
+}
+
+/**
+ * \brief Get the parts of [\p from, \p to) a keyword search has to scan
+ *
+ * The parts are made of whole blocks of \p block_size bytes counted from
+ * \p from, and contain every match and the data before it which
+ * rz_search_mybinparse_update() looks at. Updating the search with these
+ * blocks only, in order, gives the same hits in the same order as updating
+ * it with all the blocks of [\p from, \p to).
+ *
+ * \param out vector of RzInterval, filled with the sorted and disjoint parts to scan
+ * \return false if the index cannot be used for this search, which must then scan the whole range
+ */
+RZ_API bool rz_search_gram_index_ranges(RZ_NONNULL RzSearchGramIndex *idx, RZ_NONNULL RzSearch *s, ut64 from, ut64 to, ut64 block_size, RZ_NONNULL RzVector /*<RzInterval>*/ *out) {
+	rz_return_val_if_fail(idx && s && out && block_size, false);
+	if (s->update != rz_search_mybinparse_update || s->bckwrds || s->inverse || s->distance ||
+		!rz_list_length(s->kws) || !rz_search_gram_index_complete(idx) ||
+		from >= to || from < idx->addr || to - 1 > idx->addr + idx->size - 1) {
+		return false;
+	}
+	ut64 longest = 0;
+	RzListIter *iter;
+	RzSearchKeyword *kw;
+	rz_list_foreach (s->kws, iter, kw) {
+		longest = RZ_MAX(longest, kw->keyword_length);
+	}
+	const ut64 last_block = (to - from - 1) / block_size;
+	const ut64 page_size = 1ULL << idx->shift;
+	RzVector blocks;
+	rz_vector_init(&blocks, sizeof(GramBlocks), NULL, NULL);
+	rz_list_foreach (s->kws, iter, kw) {
+		int k = keyword_window(idx, kw);
+		if (k < 0) {
+			rz_vector_fini(&blocks);
+			return false;
+		}
+		GramBucket *b = &idx->buckets[gram_hash(gram_of(kw->bin_keyword + k))];
+		for (ut32 j = 0; j < b->len; j++) {
+			// the window starts in the page, so the keyword starts k bytes before
+			ut64 page = idx->addr + ((ut64)b->pages[j] << idx->shift);
+			ut64 start = page < from + k ? from : page - k;
+			ut64 end = page + page_size < from + k ? from : RZ_MIN(page + page_size - k, to);
+			if (start >= end) {
+				continue;
+			}
+			GramBlocks *gb = rz_vector_push(&blocks, NULL);
+			if (!gb) {
+				rz_vector_fini(&blocks);
+				return false;
+			}
+			gb->first = (start - from) / block_size;
+			// the matches are reported by the update of the block they end in
+			gb->last = RZ_MIN((end - 1 + longest - 1 - from) / block_size, last_block);
+		}
+	}
+	rz_vector_sort(&blocks, gram_blocks_cmp, false);
+	rz_vector_clear(out);
+	GramBlocks *gb, cur = { 0 };
+	bool open = false;
+	rz_vector_foreach(&blocks, gb) {
+		if (open && gb->first <= cur.last + 1) {
+			cur.last = RZ_MAX(cur.last, gb->last);
+			continue;
+		}
+		if (open) {
+			RzInterval itv = { from + cur.first * block_size, RZ_MIN((cur.last + 1) * block_size, to - from) - cur.first * block_size };
+			rz_vector_push(out, &itv);
+		}
+		cur = *gb;
+		open = true;
+	}
+	if (open) {
+		RzInterval itv = { from + cur.first * block_size, RZ_MIN((cur.last + 1) * block_size, to - from) - cur.first * block_size };
+		rz_vector_push(out, &itv);
+	}
+	rz_vector_fini(&blocks);
+	return true;
+}
+
+/**
+ * \brief Serialize \p idx, to save it to a file
+ *
+ * \param size set to the size of the returned buffer
+ */
+RZ_API RZ_OWN ut8 *rz_search_gram_index_serialize(RZ_NONNULL RzSearchGramIndex *idx, RZ_NONNULL ut64 *size) {
+	rz_return_val_if_fail(idx && size && rz_search_gram_index_complete(idx), NULL);
+	ut64 total = 4 + 4 + 8 + 8 + 4 + (ut64)GRAM_BUCKETS * 4;
+	for (ut32 i = 0; i < GRAM_BUCKETS; i++) {
+		total += (ut64)idx->buckets[i].len * 4;
+	}
+	ut8 *buf = malloc(total);
+	if (!buf) {
+		return NULL;
+	}
+	ut8 *p = buf;
+	memcpy(p, GRAM_INDEX_MAGIC, 4);
+	rz_write_le32(p + 4, GRAM_INDEX_VERSION);
+	rz_write_le64(p + 8, idx->addr);
+	rz_write_le64(p + 16, idx->size);
+	rz_write_le32(p + 24, idx->shift);
+	p += 28;
+	for (ut32 i = 0; i < GRAM_BUCKETS; i++) {
+		GramBucket *b = &idx->buckets[i];
+		rz_write_le32(p, b->len);
+		p += 4;
+		for (ut32 j = 0; j < b->len; j++, p += 4) {
+			rz_write_le32(p, b->pages[j]);
+		}
+	}
+	*size = total;
+	return buf;
+}
+
+/**
+ * \brief Load an index serialized by rz_search_gram_index_serialize()
+ *
+ * \param used if not NULL, set to the number of bytes of \p buf taken by the index
+ */
+RZ_API RZ_OWN RzSearchGramIndex *rz_search_gram_index_deserialize(RZ_NONNULL const ut8 *buf, ut64 size, ut64 max_mem, RZ_NULLABLE ut64 *used) {
+	rz_return_val_if_fail(buf, NULL);
+	if (size < 28 || memcmp(buf, GRAM_INDEX_MAGIC, 4) || rz_read_le32(buf + 4) != GRAM_INDEX_VERSION) {
+		return NULL;
+	}
+	ut64 isize = rz_read_le64(buf + 16);
+	ut32 shift = rz_read_le32(buf + 24);
+	if (!isize || shift >= 64 || ((isize - 1) >> shift) > UT32_MAX) {
+		return NULL;
+	}
+	RzSearchGramIndex *idx = rz_search_gram_index_new(rz_read_le64(buf + 8), isize, max_mem);
+	if (!idx) {
+		return NULL;
+	}
+	idx->shift = shift;
+	idx->fed = isize;
+	const ut8 *p = buf + 28, *end = buf + size;
+	for (ut32 i = 0; i < GRAM_BUCKETS; i++) {
+		if (end - p < 4) {
+			goto err;
+		}
+		GramBucket *b = &idx->buckets[i];
+		ut32 len = rz_read_le32(p);
+		p += 4;
+		if ((ut64)(end - p) / 4 < len) {
+			goto err;
+		}
+		if (len) {
+			b->pages = malloc(len * sizeof(ut32));
+			if (!b->pages) {
+				goto err;
+			}
+			b->len = b->cap = len;
+			for (ut32 j = 0; j < len; j++, p += 4) {
+				b->pages[j] = rz_read_le32(p);
+			}
+			idx->mem += (ut64)len * sizeof(ut32);
+		}
+	}
+	if (used) {
+		*used = p - buf;
+	}
+	return idx;
+err:
+	rz_search_gram_index_free(idx);
+	return NULL;
+}
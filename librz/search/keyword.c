@@ -50,6 +50,7 @@ RZ_API void rz_search_keyword_free(RzSearchKeyword *kw) {
 	if (!kw) {
 		return;
 	}
+	rz_regex_free(kw->regex);
 	free(kw->bin_binmask);
 	free(kw->bin_keyword);
 	free(kw);
@@ -14,6 +14,16 @@ the sequence tag, the minimal length of the sequence,
 the version marker and the minimal key length. */
 #define PRIVKEY_SEARCH_MIN_LENGTH (1 + 1 + 4 + 1)
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PRIVKEY_USE_SSE2 1
+#endif
+
+/* All the version markers start with an INTEGER of length 1 (02 01), so
+the positions are pre-filtered by groups of PRIVKEY_GROUP_SIZE on these two
+bytes before comparing the whole markers. */
+#define PRIVKEY_GROUP_SIZE 16
+
 /*Baby BER parser, just good enough for private keys.
 
 This is not robust to errors in the memory image, but if we added
@@ -65,6 +75,36 @@ static int check_fields(const ut8 *start) {
 	return true;
 }
 
+// Returns a bitmask of the positions of the group starting with 02 01.
+static inline ut32 version_marker_candidates(const ut8 *buf) {
+#ifdef PRIVKEY_USE_SSE2
+	__m128i tag = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)buf), _mm_set1_epi8(0x02));
+	__m128i len = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(buf + 1)), _mm_set1_epi8(0x01));
+	return (ut32)_mm_movemask_epi8(_mm_and_si128(tag, len));
+#else
+	ut32 mask = 0;
+	for (ut32 i = 0; i < PRIVKEY_GROUP_SIZE; i++) {
+		if (buf[i] == 0x02 && buf[i + 1] == 0x01) {
+			mask |= 1 << i;
+		}
+	}
+	return mask;
+#endif
+}
+
+static inline ut32 lowest_bit(ut32 mask) {
+#if defined(__GNUC__)
+	return (ut32)__builtin_ctz(mask);
+#else
+	ut32 i = 0;
+	while (!(mask & 1)) {
+		mask >>= 1;
+		i++;
+	}
+	return i;
+#endif
+}
+
 // Finds and return index of a private key:
 // As defined in RFC 3447 for RSA, as defined in RFC 5915 for
 // elliptic curves and as defined in 7 of RFC 8410 for SafeCurves
@@ -84,6 +124,17 @@ RZ_API int rz_search_privkey_update(RzSearch *s, ut64 from, const ut8 *buf, int
 	rz_list_foreach (s->kws, iter, kw) {
 		// Iteration until the remaining length is too small to contain a key.
 		for (i = 2; i < len - PRIVKEY_SEARCH_MIN_LENGTH; i++) {
+			if (i + PRIVKEY_GROUP_SIZE + 1 <= len) {
+				ut32 candidates = version_marker_candidates(buf + i);
+				if (!candidates) {
+					i += PRIVKEY_GROUP_SIZE - 1;
+					continue;
+				}
+				i += lowest_bit(candidates);
+				if (i >= len - PRIVKEY_SEARCH_MIN_LENGTH) {
+					break;
+				}
+			}
 			if (memcmp(buf + i, rsa_versionmarker, sizeof(rsa_versionmarker)) &&
 				memcmp(buf + i, ecc_versionmarker, sizeof(ecc_versionmarker)) &&
 				memcmp(buf + i, safecurves_versionmarker, sizeof(safecurves_versionmarker))) {
@@ -5,48 +5,110 @@
 #include "rz_search.h"
 #include <rz_regex.h>
 
+static RzRegex *keyword_regex(RzSearchKeyword *kw) {
+	if (kw->regex) {
+		return kw->regex;
+	}
+	int reflags = RZ_REGEX_EXTENDED;
+	if (kw->icase) {
+		reflags |= RZ_REGEX_ICASE;
+	}
+	RzRegex *re = RZ_NEW0(RzRegex);
+	if (!re) {
+		return NULL;
+	}
+	if (rz_regex_comp(re, (char *)kw->bin_keyword, reflags)) {
+		free(re);
+		return NULL;
+	}
+	// compiled once, so the DFA cache of the regex is reused by every chunk
+	kw->regex = re;
+	return re;
+}
+
+/* the longest part of a match that may lie in the previous chunk */
+#define REGEXP_TAIL_MAX 4096
+
+static void keep_tail(RzSearch *s, ut64 base, const ut8 *data, int size) {
+	RzListIter *iter;
+	RzSearchKeyword *kw;
+	ut64 keep = base + size;
+	rz_list_foreach (s->kws, iter, kw) {
+		keep = RZ_MIN(keep, kw->regexp_next);
+	}
+	keep = RZ_MAX(keep, base + size - RZ_MIN(size, REGEXP_TAIL_MAX));
+	int tail_len = base + size - keep;
+	ut8 *tail = tail_len ? malloc(tail_len) : NULL;
+	if (tail) {
+		memcpy(tail, data + (keep - base), tail_len);
+	}
+	free(s->regexp_tail);
+	s->regexp_tail = tail;
+	s->regexp_tail_len = tail ? tail_len : 0;
+	s->regexp_tail_to = base + size;
+}
+
 RZ_API int rz_search_regexp_update(RzSearch *s, ut64 from, const ut8 *buf, int len) {
 	RzSearchKeyword *kw;
 	RzListIter *iter;
 	RzRegexMatch match;
-	RzRegex compiled = { 0 };
 	const int old_nhits = s->nhits;
-	int ret = 0;
-
-	rz_list_foreach (s->kws, iter, kw) {
-		int reflags = RZ_REGEX_EXTENDED;
+	int ret = -1;
 
-		if (kw->icase) {
-			reflags |= RZ_REGEX_ICASE;
+	// scan the unmatched end of the previous chunk again, with this chunk behind it
+	const ut8 *data = buf;
+	ut8 *joined = NULL;
+	ut64 base = from;
+	int size = len;
+	if (s->regexp_tail_len && s->regexp_tail_to == from) {
+		joined = malloc((size_t)s->regexp_tail_len + len);
+		if (joined) {
+			memcpy(joined, s->regexp_tail, s->regexp_tail_len);
+			memcpy(joined + s->regexp_tail_len, buf, len);
+			data = joined;
+			base -= s->regexp_tail_len;
+			size += s->regexp_tail_len;
 		}
+	}
 
-		if (rz_regex_comp(&compiled, (char *)kw->bin_keyword, reflags)) {
+	rz_list_foreach (s->kws, iter, kw) {
+		RzRegex *compiled = keyword_regex(kw);
+		if (!compiled) {
 			eprintf("Cannot compile '%s' regexp\n", kw->bin_keyword);
-			return -1;
+			goto beach;
+		}
+		if (!joined || kw->regexp_next < base || kw->regexp_next > from) {
+			kw->regexp_next = base;
 		}
 
-		match.rm_so = 0;
-		match.rm_eo = len;
+		int next = kw->regexp_next - base;
+		match.rm_so = next;
+		match.rm_eo = size;
 
-		while (!rz_regex_exec(&compiled, (char *)buf, 1, &match, RZ_REGEX_STARTEND)) {
-			int t = rz_search_hit_new(s, kw, from + match.rm_so);
+		while (next < size && !rz_regex_exec(compiled, (char *)data, 1, &match, RZ_REGEX_STARTEND)) {
+			if (match.rm_so >= size) {
+				// an empty match past the data belongs to the next chunk
+				break;
+			}
+			int t = rz_search_hit_new(s, kw, base + match.rm_so);
 			if (!t) {
-				ret = -1;
 				goto beach;
 			}
+			/* Setup the boundaries for RZ_REGEX_STARTEND, past empty matches too */
+			next = RZ_MAX(match.rm_eo, match.rm_so + 1);
+			kw->regexp_next = base + next;
 			if (t > 1) {
+				ret = s->nhits - old_nhits;
 				goto beach;
 			}
-			/* Setup the boundaries for RZ_REGEX_STARTEND */
-			match.rm_so = match.rm_eo;
-			match.rm_eo = len;
+			match.rm_so = next;
+			match.rm_eo = size;
 		}
 	}
+	keep_tail(s, base, data, size);
+	ret = s->nhits - old_nhits;
 
 beach:
-	rz_regex_fini(&compiled);
-	if (!ret) {
-		ret = s->nhits - old_nhits;
-	}
+	free(joined);
 	return ret;
 }
@@ -3,7 +3,9 @@
 
 #include <rz_search.h>
 #include <rz_list.h>
+#include <rz_th.h>
 #include <ctype.h>
+#include "search_private.h"
 
 // Experimental search engine (fails, because stops at first hit of every block read
 #define USE_BMH 0
@@ -39,6 +41,7 @@ RZ_API RzSearch *rz_search_new(int mode) {
 	s->string_min = 3;
 	s->hits = rz_list_newf(free);
 	s->maxhits = 0;
+	s->ac_min_kws = RZ_SEARCH_AC_MIN_KEYWORDS;
 	// TODO: review those mempool sizes. ensure never gets NULL
 	s->kws = rz_list_newf(free);
 	if (!s->kws) {
@@ -55,6 +58,8 @@ RZ_API RzSearch *rz_search_free(RzSearch *s) {
 	}
 	rz_list_free(s->hits);
 	rz_list_free(s->kws);
+	rz_search_ac_free(s->ac);
+	free(s->regexp_tail);
 	// rz_io_free(s->iob.io); this is supposed to be a weak reference
 	free(s->data);
 	free(s);
@@ -93,12 +98,21 @@ RZ_API int rz_search_set_mode(RzSearch *s, int mode) {
 	return false;
 }
 
+static void search_ac_invalidate(RzSearch *s) {
+	rz_search_ac_free(s->ac);
+	s->ac = NULL;
+}
+
 RZ_API int rz_search_begin(RzSearch *s) {
 	RzListIter *iter;
 	RzSearchKeyword *kw;
+	search_ac_invalidate(s);
+	RZ_FREE(s->regexp_tail);
+	s->regexp_tail_len = 0;
 	rz_list_foreach (s->kws, iter, kw) {
 		kw->count = 0;
 		kw->last = 0;
+		kw->regexp_next = 0;
 	}
 	return true;
 }
@@ -355,6 +369,176 @@ static bool brute_force_match(RzSearch *s, RzSearchKeyword *kw, const ut8 *buf,
 	return j == kw->keyword_length;
 }
 
+/**
+ * Whether the offsets worth a brute_force_match() of \p kw can be found
+ * with first_last_filter(), i.e. whether its first and last bytes must
+ * match exactly.
+ */
+static bool first_last_filter_usable(RzSearch *s, RzSearchKeyword *kw) {
+	return !s->distance && !s->inverse && !kw->icase && !kw->binmask_length && kw->keyword_length > 1;
+}
+
+/**
+ * Get the first offset in [i, last] where \p data holds the first and the
+ * last byte of \p kw, or last + 1 if there is none.
+ *
+ * Eight offsets are tested at once on 64-bit words: a zero byte in
+ * (word(i) ^ first) | (word(i + len - 1) ^ last) means both bytes match.
+ * The bit trick used to find zero bytes may report false positives, but
+ * only above an actual zero byte, so a reported word always has a match.
+ */
+static ut64 first_last_filter(RzSearchKeyword *kw, const ut8 *data, ut64 i, ut64 last) {
+	const ut32 tail = kw->keyword_length - 1;
+	const ut8 first_byte = kw->bin_keyword[0];
+	const ut8 last_byte = kw->bin_keyword[tail];
+	const ut64 first_word = 0x0101010101010101ULL * first_byte;
+	const ut64 last_word = 0x0101010101010101ULL * last_byte;
+	for (; i + 7 <= last; i += 8) {
+		const ut64 v = (rz_read_le64(data + i) ^ first_word) | (rz_read_le64(data + i + tail) ^ last_word);
+		if ((v - 0x0101010101010101ULL) & ~v & 0x8080808080808080ULL) {
+			break;
+		}
+	}
+	for (; i <= last; i++) {
+		if (data[i] == first_byte && data[i + tail] == last_byte) {
+			return i;
+		}
+	}
+	return last + 1;
+}
+
+/**
+ * Report the hits of \p kw in data[i, len) starting before \p end, \p shift
+ * being the number of bytes of data preceding \p from.
+ * When \p cands is given, only these offsets are checked.
+ *
+ * \return the result of the last rz_search_hit_new(), 1 if there was no hit
+ */
+static int keyword_scan(RzSearch *s, RzSearchKeyword *kw, const RzVector *cands, ut64 from, const ut8 *data, ut64 len, int i, int end, int shift) {
+	if (cands) {
+		const int *pos;
+		rz_vector_foreach(cands, pos) {
+			if (*pos < i) {
+				continue;
+			}
+			if (*pos + kw->keyword_length > len || *pos >= end) {
+				break;
+			}
+			if (!brute_force_match(s, kw, data, *pos)) {
+				continue;
+			}
+			int t = rz_search_hit_new(s, kw, s->bckwrds ? from - kw->keyword_length - *pos + shift : from + *pos - shift);
+			if (t != 1) {
+				return t;
+			}
+			i = s->overlap ? *pos + 1 : *pos + kw->keyword_length;
+		}
+		return 1;
+	}
+	const bool filter = i >= 0 && first_last_filter_usable(s, kw);
+	for (; i + kw->keyword_length <= len && i < end; i++) {
+		if (filter) {
+			const ut64 last = RZ_MIN(len - kw->keyword_length, end - 1);
+			i = first_last_filter(kw, data, i, last);
+			if (i > last) {
+				break;
+			}
+		}
+		if (brute_force_match(s, kw, data, i) != s->inverse) {
+			int t = rz_search_hit_new(s, kw, s->bckwrds ? from - kw->keyword_length - i + shift : from + i - shift);
+			if (t != 1) {
+				return t;
+			}
+			if (!s->overlap) {
+				i += kw->keyword_length - 1;
+			}
+		}
+	}
+	return 1;
+}
+
+/**
+ * Get the automaton matching all the keywords at once, if it should be used
+ * for this search. Inverse and distance searches can only be done one
+ * keyword at a time.
+ */
+static RzSearchAC *search_ac_get(RzSearch *s) {
+	if (!s->ac_min_kws || s->inverse || s->distance || rz_list_length(s->kws) < s->ac_min_kws) {
+		return NULL;
+	}
+	if (!s->ac) {
+		s->ac = rz_search_ac_new(s->kws);
+	}
+	return s->ac;
+}
+
+static RzSearchKeyword *keyword_copy(const RzSearchKeyword *kw, bool regexp) {
+	RzSearchKeyword *k = RZ_NEW0(RzSearchKeyword);
+	if (!k) {
+		return NULL;
+	}
+	*k = *kw;
+	k->count = 0;
+	k->last = 0;
+	k->regex = NULL;
+	k->bin_binmask = NULL;
+	// the pattern of a regexp keyword is a string, longer than keyword_length if it has escapes
+	k->bin_keyword = regexp ? (ut8 *)strdup((const char *)kw->bin_keyword) : rz_mem_dup(kw->bin_keyword, kw->keyword_length);
+	if (kw->binmask_length) {
+		k->bin_binmask = rz_mem_dup(kw->bin_binmask, kw->binmask_length);
+	}
+	if (!k->bin_keyword || (kw->binmask_length && !k->bin_binmask)) {
+		rz_search_keyword_free(k);
+		return NULL;
+	}
+	return k;
+}
+
+/**
+ * \brief Create a search with the mode, the settings and copies of the keywords of \p s
+ *
+ * The keyword automaton of \p s is compiled if it should be used and shared
+ * with the new search instead of being compiled again. \p s must thus
+ * outlive the new search and keep its keywords unchanged meanwhile.
+ * The callback and the state of the search are not copied, so every fork
+ * can scan different data in its own thread. A fork is ready to scan,
+ * calling rz_search_begin() on it would drop the shared automaton.
+ */
+RZ_API RZ_OWN RzSearch *rz_search_fork(RZ_NONNULL RzSearch *s) {
+	rz_return_val_if_fail(s, NULL);
+	RzSearch *fs = rz_search_new(s->mode);
+	if (!fs) {
+		return NULL;
+	}
+	fs->pattern_size = s->pattern_size;
+	fs->string_min = s->string_min;
+	fs->string_max = s->string_max;
+	fs->maxhits = s->maxhits;
+	fs->distance = s->distance;
+	fs->inverse = s->inverse;
+	fs->overlap = s->overlap;
+	fs->contiguous = s->contiguous;
+	fs->align = s->align;
+	fs->ac_min_kws = s->ac_min_kws;
+	fs->bckwrds = s->bckwrds;
+	fs->n_kws = s->n_kws;
+	RzListIter *iter;
+	RzSearchKeyword *kw;
+	rz_list_foreach (s->kws, iter, kw) {
+		RzSearchKeyword *k = keyword_copy(kw, s->mode == RZ_SEARCH_REGEXP);
+		if (!k) {
+			rz_search_free(fs);
+			return NULL;
+		}
+		rz_list_append(fs->kws, k);
+	}
+	if (s->mode == RZ_SEARCH_KEYWORD) {
+		RzSearchAC *ac = search_ac_get(s);
+		fs->ac = ac ? rz_search_ac_share(ac) : NULL;
+	}
+	return fs;
+}
+
 // Supported search variants: backward, binmask, icase, inverse, overlap
 RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, int len) {
 	RzSearchKeyword *kw;
@@ -394,41 +578,37 @@ RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, i
 
 	ut64 len1 = left->len + RZ_MIN(longest - 1, len);
 	memcpy(left->data + left->len, buf, len1 - left->len);
+	RzSearchAC *ac = search_ac_get(s);
+	if (ac) {
+		rz_search_ac_scan(ac, 0, left->data, len1, left->len);
+		rz_search_ac_scan(ac, 1, buf, len, len);
+	}
+	int idx = 0;
 	rz_list_foreach (s->kws, iter, kw) {
 		i = s->overlap || !kw->count ? 0 : s->bckwrds ? kw->last - from < left->len ? from + left->len - kw->last : 0
 			: from - kw->last < left->len         ? kw->last + left->len - from
 							      : 0;
-		for (; i + kw->keyword_length <= len1 && i < left->len; i++) {
-			if (brute_force_match(s, kw, left->data, i) != s->inverse) {
-				int t = rz_search_hit_new(s, kw, s->bckwrds ? from - kw->keyword_length - i + left->len : from + i - left->len);
-				if (!t) {
-					return -1;
-				}
-				if (t > 1) {
-					return s->nhits - old_nhits;
-				}
-				if (!s->overlap) {
-					i += kw->keyword_length - 1;
-				}
-			}
+		// the matches ending in the previous block were reported by the previous update
+		i = RZ_MAX(i, left->len - (int)kw->keyword_length + 1);
+		const bool anchored = ac && rz_search_ac_has_anchor(ac, idx);
+		int t = keyword_scan(s, kw, anchored ? rz_search_ac_candidates(ac, 0, idx) : NULL, from, left->data, len1, i, left->len, left->len);
+		if (!t) {
+			return -1;
+		}
+		if (t > 1) {
+			return s->nhits - old_nhits;
 		}
 		i = s->overlap || !kw->count ? 0 : s->bckwrds ? from > kw->last ? from - kw->last : 0
 			: from < kw->last                     ? kw->last - from
 							      : 0;
-		for (; i + kw->keyword_length <= len; i++) {
-			if (brute_force_match(s, kw, buf, i) != s->inverse) {
-				int t = rz_search_hit_new(s, kw, s->bckwrds ? from - kw->keyword_length - i : from + i);
-				if (!t) {
-					return -1;
-				}
-				if (t > 1) {
-					return s->nhits - old_nhits;
-				}
-				if (!s->overlap) {
-					i += kw->keyword_length - 1;
-				}
-			}
+		t = keyword_scan(s, kw, anchored ? rz_search_ac_candidates(ac, 1, idx) : NULL, from, buf, len, i, len, 0);
+		if (!t) {
+			return -1;
+		}
+		if (t > 1) {
+			return s->nhits - old_nhits;
 		}
+		idx++;
 	}
 	if (len < longest - 1) {
 		if (len1 < longest) {
@@ -484,6 +664,235 @@ RZ_API int rz_search_update_i(RzSearch *s, ut64 from, const ut8 *buf, long len)
 	return rz_search_update(s, from, buf, len);
 }
 
+typedef struct {
+	ut64 addr;
+	ut64 block; ///< index of the block whose update reports the hit
+	int kw; ///< position of the keyword in RzSearch.kws
+} RzSearchRawHit;
+
+typedef struct {
+	RzSearch *s; ///< private copy of the search, with private copies of the keywords
+	const ut8 *buf;
+	ut64 buf_from; ///< address of buf[0]
+	ut64 start; ///< the worker reports the hits ending in [start, end)
+	ut64 end;
+	ut64 context; ///< bytes before start to scan too, for the matches crossing start
+	ut64 block_size;
+	RzVector /*<RzSearchRawHit>*/ hits;
+	bool failed;
+} RzSearchWorker;
+
+// Size of the updates done by each worker, independent of the block size of the caller
+#define SEARCH_WORKER_CHUNK (1024 * 1024)
+// Don't bother splitting less than this per thread
+#define SEARCH_WORKER_MIN_SPAN (256 * 1024)
+
+static int worker_hit_cb(RzSearchKeyword *kw, void *user, ut64 addr) {
+	RzSearchWorker *w = user;
+	if (addr + kw->keyword_length <= w->start) {
+		// entirely in the data shared with the previous worker, which reports it
+		return 1;
+	}
+	RzSearchRawHit *hit = rz_vector_push(&w->hits, NULL);
+	if (!hit) {
+		w->failed = true;
+		return 0;
+	}
+	hit->addr = addr;
+	hit->block = (addr + kw->keyword_length - 1 - w->buf_from) / w->block_size;
+	hit->kw = kw->kwidx;
+	return 1;
+}
+
+static void *worker_run(RzSearchWorker *w) {
+	ut64 at = w->start - w->context;
+	while (at < w->end && !w->failed) {
+		ut64 len = RZ_MIN(w->end - at, SEARCH_WORKER_CHUNK);
+		if (rz_search_update(w->s, at, w->buf + (at - w->buf_from), len) < 0) {
+			w->failed = true;
+		}
+		at += len;
+	}
+	return NULL;
+}
+
+static RzSearch *worker_search_new(RzSearch *s, RzSearchWorker *w) {
+	RzSearch *ws = rz_search_fork(s);
+	if (!ws) {
+		return NULL;
+	}
+	// every match is collected, rz_search_hit_new() filters them later in the same order as a serial update
+	ws->overlap = true;
+	ws->contiguous = true;
+	ws->align = 0;
+	ws->maxhits = 0;
+	RzListIter *iter;
+	RzSearchKeyword *kw;
+	int idx = 0;
+	rz_list_foreach (ws->kws, iter, kw) {
+		kw->kwidx = idx++;
+	}
+	rz_search_set_callback(ws, worker_hit_cb, w);
+	return ws;
+}
+
+static int raw_hit_cmp(const void *a, const void *b) {
+	const RzSearchRawHit *ha = a, *hb = b;
+	if (ha->block != hb->block) {
+		return ha->block < hb->block ? -1 : 1;
+	}
+	if (ha->kw != hb->kw) {
+		return ha->kw < hb->kw ? -1 : 1;
+	}
+	return ha->addr < hb->addr ? -1 : ha->addr > hb->addr;
+}
+
+/**
+ * Report the sorted raw hits through rz_search_hit_new(), skipping the
+ * ones rz_search_mybinparse_update() would have skipped.
+ * Each (block, keyword, window) group corresponds to one keyword_scan() call.
+ */
+static int raw_hits_replay(RzSearch *s, RzVector *hits, RzSearchKeyword **kws, ut64 from, ut64 block_size) {
+	ut64 block = UT64_MAX, thr = 0;
+	int kwi = -1;
+	bool left = false;
+	RzSearchRawHit *hit;
+	rz_vector_foreach(hits, hit) {
+		RzSearchKeyword *kw = kws[hit->kw];
+		bool hit_left = hit->addr < from + hit->block * block_size;
+		if (hit->block != block || hit->kw != kwi || hit_left != left) {
+			block = hit->block;
+			kwi = hit->kw;
+			left = hit_left;
+			thr = !s->overlap && kw->count ? kw->last : 0;
+		}
+		if (hit->addr < thr) {
+			continue;
+		}
+		int t = rz_search_hit_new(s, kw, hit->addr);
+		if (t != 1) {
+			return t;
+		}
+		thr = s->overlap ? hit->addr + 1 : hit->addr + kw->keyword_length;
+	}
+	return 1;
+}
+
+static int search_update_serial(RzSearch *s, ut64 from, const ut8 *buf, ut64 len, ut64 block_size) {
+	const ut64 old_nhits = s->nhits;
+	for (ut64 off = 0; off < len; off += block_size) {
+		if (rz_search_update(s, from + off, buf + off, RZ_MIN(block_size, len - off)) < 0) {
+			return -1;
+		}
+	}
+	return s->nhits - old_nhits;
+}
+
+/**
+ * \brief Update the search with \p len bytes of data, using up to \p max_threads threads
+ *
+ * The hits, their order and the search state afterwards are the same as
+ * calling rz_search_update() on each consecutive \p block_size bytes of
+ * \p buf, and the callback is only ever called from the calling thread.
+ * Only the forward keyword search is parallelized, anything else is just
+ * updated block by block.
+ *
+ * \param max_threads maximum number of threads, RZ_THREAD_POOL_ALL_CORES to use all the cores
+ * \return the number of new hits, or -1 on error
+ */
+RZ_API int rz_search_update_parallel(RzSearch *s, ut64 from, const ut8 *buf, ut64 len, ut64 block_size, size_t max_threads) {
+	rz_return_val_if_fail(s && buf && block_size, -1);
+	int longest = 0;
+	RzSearchKeyword *kw;
+	RzListIter *iter;
+	rz_list_foreach (s->kws, iter, kw) {
+		longest = RZ_MAX(longest, kw->keyword_length);
+	}
+	if (max_threads == 1 || s->update != rz_search_mybinparse_update || s->bckwrds || s->inverse ||
+		!longest || block_size < longest || len < block_size + 2 * SEARCH_WORKER_MIN_SPAN || from + len < from) {
+		return search_update_serial(s, from, buf, len, block_size);
+	}
+	const ut64 old_nhits = s->nhits;
+	// the first block goes through the normal path, so the data left over by the previous update is used
+	if (rz_search_update(s, from, buf, block_size) < 0) {
+		return -1;
+	}
+	if (s->maxhits && s->nhits >= s->maxhits) {
+		return s->nhits - old_nhits;
+	}
+	RzThreadPool *pool = rz_th_pool_new(max_threads);
+	const size_t n_kws = rz_list_length(s->kws);
+	RzSearchKeyword **kws = RZ_NEWS(RzSearchKeyword *, n_kws);
+	ut64 rest = len - block_size;
+	size_t n_workers = pool ? RZ_MIN(rz_th_pool_size(pool), rest / SEARCH_WORKER_MIN_SPAN) : 0;
+	RzSearchWorker *workers = n_workers ? RZ_NEWS0(RzSearchWorker, n_workers) : NULL;
+	RzVector hits;
+	rz_vector_init(&hits, sizeof(RzSearchRawHit), NULL, NULL);
+	int ret = -1;
+	if (!kws || !workers) {
+		goto beach;
+	}
+	size_t i = 0;
+	rz_list_foreach (s->kws, iter, kw) {
+		kws[i++] = kw;
+	}
+	const ut64 span = (rest + n_workers - 1) / n_workers;
+	for (i = 0; i < n_workers; i++) {
+		RzSearchWorker *w = &workers[i];
+		rz_vector_init(&w->hits, sizeof(RzSearchRawHit), NULL, NULL);
+		w->buf = buf;
+		w->buf_from = from;
+		w->start = from + block_size + span * i;
+		w->end = RZ_MIN(w->start + span, from + len);
+		w->context = longest - 1;
+		w->block_size = block_size;
+		w->s = worker_search_new(s, w);
+		if (!w->s) {
+			goto beach;
+		}
+	}
+	for (i = 0; i < n_workers; i++) {
+		RzThread *th = rz_th_new((RzThreadFunction)worker_run, &workers[i]);
+		if (!th) {
+			break;
+		}
+		if (!rz_th_pool_add_thread(pool, th)) {
+			rz_th_free(th);
+			break;
+		}
+	}
+	rz_th_pool_wait(pool);
+	if (i < n_workers) {
+		goto beach;
+	}
+	for (i = 0; i < n_workers; i++) {
+		RzSearchWorker *w = &workers[i];
+		if (w->failed || (rz_vector_len(&w->hits) && !rz_vector_insert_range(&hits, rz_vector_len(&hits), w->hits.a, rz_vector_len(&w->hits)))) {
+			goto beach;
+		}
+	}
+	rz_vector_sort(&hits, raw_hit_cmp, false);
+	if (!raw_hits_replay(s, &hits, kws, from, block_size)) {
+		goto beach;
+	}
+	// what rz_search_mybinparse_update() would have left over after the last block
+	RzSearchLeftover *left = s->data;
+	left->len = longest - 1;
+	memcpy(left->data, buf + len - left->len, left->len);
+	left->end = from + len;
+	ret = s->nhits - old_nhits;
+beach:
+	for (i = 0; workers && i < n_workers; i++) {
+		rz_search_free(workers[i].s);
+		rz_vector_fini(&workers[i].hits);
+	}
+	rz_th_pool_free(pool);
+	rz_vector_fini(&hits);
+	free(workers);
+	free(kws);
+	return ret;
+}
+
 static int listcb(RzSearchKeyword *k, void *user, ut64 addr) {
 	RzSearchHit *hit = RZ_NEW0(RzSearchHit);
 	if (!hit) {
@@ -509,6 +918,7 @@ RZ_API int rz_search_kw_add(RzSearch *s, RzSearchKeyword *kw) {
 	}
 	kw->kwidx = s->n_kws++;
 	rz_list_append(s->kws, kw);
+	search_ac_invalidate(s);
 	return true;
 }
 
@@ -516,6 +926,7 @@ RZ_API int rz_search_kw_add(RzSearch *s, RzSearchKeyword *kw) {
 RZ_API void rz_search_string_prepare_backward(RzSearch *s) {
 	RzListIter *iter;
 	RzSearchKeyword *kw;
+	search_ac_invalidate(s);
 	// Precondition: !kw->binmask_length || kw->keyword_length % kw->binmask_length == 0
 	rz_list_foreach (s->kws, iter, kw) {
 		ut8 *i = kw->bin_keyword, *j = kw->bin_keyword + kw->keyword_length;
@@ -545,4 +956,5 @@ RZ_API void rz_search_kw_reset(RzSearch *s) {
 	rz_list_purge(s->kws);
 	rz_list_purge(s->hits);
 	RZ_FREE(s->data);
+	search_ac_invalidate(s);
 }
@@ -0,0 +1,17 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#ifndef RZ_SEARCH_PRIVATE_H
+#define RZ_SEARCH_PRIVATE_H
+
+#include <rz_search.h>
+
+/* aho_corasick.c */
+RZ_IPI RzSearchAC *rz_search_ac_new(RzList /*<RzSearchKeyword *>*/ *kws);
+RZ_IPI RzSearchAC *rz_search_ac_share(RzSearchAC *ac);
+RZ_IPI void rz_search_ac_free(RzSearchAC *ac);
+RZ_IPI bool rz_search_ac_has_anchor(RzSearchAC *ac, int idx);
+RZ_IPI void rz_search_ac_scan(RzSearchAC *ac, int window, const ut8 *buf, int len, int max_start);
+RZ_IPI RzVector /*<int>*/ *rz_search_ac_candidates(RzSearchAC *ac, int window, int idx);
+
+#endif
@@ -262,7 +262,6 @@ static bool flirt_node_shorten_and_insert(const RzFlirtNode *root, RzFlirtNode *
 			// same pattern just merge.
 			rz_list_join(child->module_list, node->module_list);
 			rz_sign_flirt_node_free(node);
-			rz_list_sort(child->module_list, (RzListComparator)flirt_compare_module);
 			return true;
 		} else if (child->length == i) {
 			// partial pattern match but matches the child
@@ -270,7 +269,6 @@ static bool flirt_node_shorten_and_insert(const RzFlirtNode *root, RzFlirtNode *
 			if (!flirt_node_shorten_and_insert(child, node)) {
 				return false;
 			}
-			rz_list_sort(child->child_list, (RzListComparator)flirt_compare_node);
 		} else if (node->length == i) {
 			// partial pattern match but matches the node
 			it->data = node;
@@ -300,7 +298,6 @@ static bool flirt_node_shorten_and_insert(const RzFlirtNode *root, RzFlirtNode *
 			}
 			flirt_node_shorten_pattern(node, i);
 			flirt_node_shorten_pattern(child, i);
-			rz_list_sort(middle_node->child_list, (RzListComparator)flirt_compare_node);
 		}
 		return true;
 	}
@@ -313,6 +310,21 @@ static bool flirt_node_shorten_and_insert(const RzFlirtNode *root, RzFlirtNode *
 	return true;
 }
 
+/*
+ * The children of a node never start with the same byte, so at most one of
+ * them can share a prefix with an inserted node whatever their order: the
+ * lists are sorted only once everything is inserted.
+ */
+static void flirt_node_sort(RzFlirtNode *node) {
+	rz_list_sort(node->module_list, (RzListComparator)flirt_compare_module);
+	rz_list_sort(node->child_list, (RzListComparator)flirt_compare_node);
+	RzListIter *it;
+	RzFlirtNode *child;
+	rz_list_foreach (node->child_list, it, child) {
+		flirt_node_sort(child);
+	}
+}
+
 bool flirt_node_optimize(RzFlirtNode *root) {
 	if (rz_list_length(root->child_list) < 1) {
 		return true;
@@ -337,6 +349,7 @@ bool flirt_node_optimize(RzFlirtNode *root) {
 		}
 	}
 	rz_list_free(childs);
+	flirt_node_sort(root);
 
 	return true;
 
@@ -345,14 +358,131 @@ fail:
 	return false;
 }
 
+#define FLIRT_READ_GAP  0x1000 ///< functions closer than this are read together
+#define FLIRT_READ_SPAN 0x100000 ///< unless the read would get bigger than this
+
+typedef struct {
+	RzAnalysisFunction *func;
+	ut64 size; ///< linear size, then without the trailing variant bytes
+	const ut8 *bytes; ///< NULL if the function couldn't be read
+	ut8 *mask;
+	RzFlirtNode *child;
+	bool built;
+} FlirtCandidate;
+
+typedef struct {
+	RzAnalysis *analysis;
+	FlirtCandidate *candidates;
+	bool tail_bytes;
+} FlirtCreateCtx;
+
+static int flirt_candidate_cmp_addr(const void *a, const void *b) {
+	const FlirtCandidate *ca = *(const FlirtCandidate **)a;
+	const FlirtCandidate *cb = *(const FlirtCandidate **)b;
+	return ca->func->addr < cb->func->addr ? -1 : ca->func->addr > cb->func->addr;
+}
+
+static bool flirt_candidate_read(RzAnalysis *analysis, FlirtCandidate *c, RzPVector /*<ut8 *>*/ *buffers) {
+	ut8 *pattern = malloc(c->size);
+	if (!pattern || !rz_pvector_push(buffers, pattern)) {
+		RZ_LOG_ERROR("FLIRT: cannot allocate function buffer.\n");
+		free(pattern);
+		return false;
+	}
+	if (!analysis->iob.read_at(analysis->iob.io, c->func->addr, pattern, (int)c->size)) {
+		RZ_LOG_WARN("FLIRT: couldn't read function %s at 0x%" PFMT64x ".\n", c->func->name, c->func->addr);
+		return true;
+	}
+	c->bytes = pattern;
+	return true;
+}
+
+/* reads [from, to) covering the \p n functions of \p run at once, borrowing the bytes if the io allows it */
+static bool flirt_run_read(RzAnalysis *analysis, FlirtCandidate **run, size_t n, ut64 from, ut64 to, RzPVector /*<ut8 *>*/ *buffers) {
+	ut64 len = to - from;
+	const ut8 *data = NULL;
+	if (analysis->iob.borrow_at) {
+		ut64 borrowed = len;
+		data = analysis->iob.borrow_at(analysis->iob.io, from, &borrowed);
+		if (borrowed < len) {
+			data = NULL;
+		}
+	}
+	if (!data && n > 1) {
+		ut8 *buf = malloc(len);
+		if (buf && analysis->iob.read_at(analysis->iob.io, from, buf, (int)len) && rz_pvector_push(buffers, buf)) {
+			data = buf;
+		} else {
+			// e.g. a hole between the functions, they are read one by one
+			free(buf);
+		}
+	}
+	for (size_t i = 0; i < n; i++) {
+		if (data) {
+			run[i]->bytes = data + (run[i]->func->addr - from);
+		} else if (!flirt_candidate_read(analysis, run[i], buffers)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* reads the bytes of all the functions, the ones next to each other with a single read */
+static bool flirt_candidates_read(RzAnalysis *analysis, FlirtCandidate *candidates, size_t count, RzPVector /*<ut8 *>*/ *buffers) {
+	FlirtCandidate **sorted = RZ_NEWS(FlirtCandidate *, count);
+	if (!sorted) {
+		for (size_t i = 0; i < count; i++) {
+			if (!flirt_candidate_read(analysis, &candidates[i], buffers)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	for (size_t i = 0; i < count; i++) {
+		sorted[i] = &candidates[i];
+	}
+	qsort(sorted, count, sizeof(FlirtCandidate *), flirt_candidate_cmp_addr);
+	bool ret = true;
+	for (size_t i = 0, j; ret && i < count; i = j) {
+		ut64 from = sorted[i]->func->addr;
+		ut64 to = from + sorted[i]->size;
+		for (j = i + 1; j < count; j++) {
+			ut64 addr = sorted[j]->func->addr;
+			ut64 end = RZ_MAX(to, addr + sorted[j]->size);
+			if (to > UT64_MAX - FLIRT_READ_GAP || addr > to + FLIRT_READ_GAP || end - from > FLIRT_READ_SPAN) {
+				break;
+			}
+			to = end;
+		}
+		ret = flirt_run_read(analysis, sorted + i, j - i, from, to, buffers);
+	}
+	free(sorted);
+	return ret;
+}
+
+static void flirt_children_range(size_t from, size_t to, void *user) {
+	FlirtCreateCtx *ctx = user;
+	for (size_t i = from; i < to; i++) {
+		FlirtCandidate *c = &ctx->candidates[i];
+		if (c->mask) {
+			c->child = flirt_create_child_from_analysis(ctx->analysis, c->func, c->bytes, c->mask, c->size, ctx->tail_bytes);
+		}
+		c->built = true;
+	}
+}
+
 /**
  * \brief Generates the FLIRT signatures and returns an RzFlirtNode
  *
+ * The bytes of the functions are read a range of neighbouring functions at a
+ * time and, when \p pool is given, the nodes of the functions are built on it.
+ *
  * \param  analysis     The RzAnalysis structure to derive the signatures.
  * \param  optimization Optimization to apply after creation of the flatten nodes.
+ * \param  pool         Task pool to build the nodes on, NULL to build them on the calling thread.
  * \return              Generated FLIRT root node.
  */
-RZ_API RZ_OWN RzFlirtNode *rz_sign_flirt_node_new(RZ_NONNULL RzAnalysis *analysis, ut32 optimization) {
+RZ_API RZ_OWN RzFlirtNode *rz_sign_flirt_node_new(RZ_NONNULL RzAnalysis *analysis, ut32 optimization, RZ_NULLABLE RzThreadTaskPool *pool) {
 	rz_return_val_if_fail(analysis && analysis->coreb.core, NULL);
 	if (optimization > RZ_FLIRT_NODE_OPTIMIZE_MAX) {
 		RZ_LOG_ERROR("FLIRT: optimization value is invalid (%u > RZ_FLIRT_NODE_OPTIMIZE_MAX).\n", optimization);
@@ -365,9 +495,13 @@ RZ_API RZ_OWN RzFlirtNode *rz_sign_flirt_node_new(RZ_NONNULL RzAnalysis *analysi
 	}
 	bool tail_bytes = optimization != RZ_FLIRT_NODE_OPTIMIZE_MAX;
 	RzFlirtNode *root = RZ_NEW0(RzFlirtNode);
-	if (!root) {
+	FlirtCandidate *candidates = RZ_NEWS0(FlirtCandidate, rz_list_length(analysis->fcns));
+	RzPVector buffers;
+	rz_pvector_init(&buffers, free);
+	size_t count = 0;
+	if (!root || !candidates) {
 		RZ_LOG_ERROR("FLIRT: cannot allocate root node.\n");
-		return NULL;
+		goto fail;
 	}
 	root->child_list = rz_list_newf((RzListFree)rz_sign_flirt_node_free);
 
@@ -392,46 +526,57 @@ RZ_API RZ_OWN RzFlirtNode *rz_sign_flirt_node_new(RZ_NONNULL RzAnalysis *analysi
 			RZ_LOG_ERROR("FLIRT: this should never happen. please open a bug report.\n");
 			goto fail;
 		}
+		candidates[count].func = func;
+		candidates[count].size = func_size;
+		count++;
+	}
 
-		ut8 *pattern = malloc(func_size);
-		if (!pattern) {
-			RZ_LOG_ERROR("FLIRT: cannot allocate function buffer.\n");
-			goto fail;
-		}
+	if (!flirt_candidates_read(analysis, candidates, count, &buffers)) {
+		goto fail;
+	}
 
-		if (!analysis->iob.read_at(analysis->iob.io, func->addr, pattern, (int)func_size)) {
-			RZ_LOG_WARN("FLIRT: couldn't read function %s at 0x%" PFMT64x ".\n", func->name, func->addr);
-			free(pattern);
+	// the masks come from the arch plugins, which are not thread safe
+	for (size_t i = 0; i < count; i++) {
+		FlirtCandidate *c = &candidates[i];
+		if (!c->bytes) {
 			continue;
 		}
-
-		ut8 *mask = rz_analysis_mask(analysis, func_size, pattern, func->addr);
-		if (!mask) {
+		c->mask = rz_analysis_mask(analysis, c->size, c->bytes, c->func->addr);
+		if (!c->mask) {
 			RZ_LOG_ERROR("FLIRT: cannot calculate pattern mask.\n");
-			free(pattern);
 			goto fail;
-		} else if (!is_valid_mask_prelude(mask, func_size)) {
-			free(pattern);
-			free(mask);
+		} else if (!is_valid_mask_prelude(c->mask, c->size)) {
+			RZ_FREE(c->mask);
 			continue;
 		}
 
-		for (ut32 i = func_size - 1; i > 1; --i) {
-			if (mask[i] != 0xFF) {
-				func_size--;
+		for (ut32 j = c->size - 1; j > 1; --j) {
+			if (c->mask[j] != 0xFF) {
+				c->size--;
 				continue;
 			}
 			break;
 		}
+	}
 
-		RzFlirtNode *child = flirt_create_child_from_analysis(analysis, func, pattern, mask, func_size, tail_bytes);
-		RZ_FREE(pattern);
-		free(mask);
-		if (!child || !rz_list_append(root->child_list, child)) {
+	FlirtCreateCtx ctx = { analysis, candidates, tail_bytes };
+	if (!pool || !rz_th_task_pool_parallel_for(pool, 0, count, 64, flirt_children_range, &ctx)) {
+		for (size_t i = 0; i < count; i++) {
+			if (!candidates[i].built) {
+				flirt_children_range(i, i + 1, &ctx);
+			}
+		}
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		FlirtCandidate *c = &candidates[i];
+		if (!c->mask) {
+			continue;
+		} else if (!c->child || !rz_list_append(root->child_list, c->child)) {
 			RZ_LOG_ERROR("FLIRT: cannot append child to root list.\n");
-			rz_sign_flirt_node_free(child);
 			goto fail;
 		}
+		c->child = NULL;
 	}
 
 	if (rz_list_length(root->child_list) < 1) {
@@ -445,9 +590,20 @@ RZ_API RZ_OWN RzFlirtNode *rz_sign_flirt_node_new(RZ_NONNULL RzAnalysis *analysi
 		goto fail;
 	}
 
+	for (size_t i = 0; i < count; i++) {
+		free(candidates[i].mask);
+	}
+	free(candidates);
+	rz_pvector_fini(&buffers);
 	return root;
 
 fail:
+	for (size_t i = 0; candidates && i < count; i++) {
+		free(candidates[i].mask);
+		rz_sign_flirt_node_free(candidates[i].child);
+	}
+	free(candidates);
+	rz_pvector_fini(&buffers);
 	rz_sign_flirt_node_free(root);
 	return NULL;
 }
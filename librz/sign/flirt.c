@@ -102,6 +102,12 @@
 
 #include <rz_lib.h>
 #include <rz_flirt.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLIRT_USE_SSE2 1
+#endif
+
 #define MAX_WBITS 15
 
 #if 0
@@ -323,45 +329,17 @@ RZ_API void rz_sign_flirt_info_fini(RZ_NULLABLE RzFlirtInfo *info) {
 }
 
 /**
- * \brief Checks if a pattern does match the buffer data
- *
- * \param p_size   The pattern size
- * \param pattern  The pattern to check agains
- * \param mask     The pattern mask
- * \param b        Buffer to check
- * \param b_size   Size of the buffer to check
- *
- * \return True if pattern does match, false otherwise.
- */
-static bool is_pattern_matching(ut32 p_size, const ut8 *pattern, const ut8 *mask, const ut8 *b, ut32 b_size) {
-	if (b_size < p_size) {
-		return false;
-	}
-	for (ut32 i = 0; i < p_size; i++) {
-		if (mask[i] == 0xFF && pattern[i] != b[i]) {
-			return false;
-		}
-	}
-	return true;
-}
-
-/**
- * \brief Checks if the module matches the buffer and renames the matched functions
+ * \brief Checks if the module matches the buffer
  *
- * \param analysis  The RzAnalysis struct from where to fetch and modify the functions
  * \param module    The FLIRT module to match against the buffer
  * \param b         Buffer to check
- * \param address   Function address
  * \param buf_size  Size of the buffer to check
  *
  * \return True if pattern does match, false otherwise.
  */
-static int module_match_buffer(RzAnalysis *analysis, const RzFlirtModule *module, ut8 *b, ut64 address, ut32 buf_size) {
-	RzFlirtFunction *flirt_func;
-	RzAnalysisFunction *next_module_function;
-	RzListIter *tail_byte_it, *flirt_func_it;
+static bool module_match_buffer(const RzFlirtModule *module, const ut8 *b, ut32 buf_size) {
+	RzListIter *tail_byte_it;
 	RzFlirtTailByte *tail_byte;
-	ut32 name_index = 0;
 
 	if (32 + module->crc_length < buf_size &&
 		module->crc16 != flirt_crc16(b + 32, module->crc_length)) {
@@ -375,6 +353,24 @@ static int module_match_buffer(RzAnalysis *analysis, const RzFlirtModule *module
 			}
 		}
 	}
+	return true;
+}
+
+/**
+ * \brief Renames the functions of a matched module
+ *
+ * \param analysis  The RzAnalysis struct from where to fetch and modify the functions
+ * \param module    The FLIRT module matching the function at \p address
+ * \param address   Function address
+ * \param deleted   Set where the functions merged into the module ones, and so deleted, are added
+ *
+ * \return False on allocation failure, otherwise true
+ */
+static bool module_apply(RzAnalysis *analysis, const RzFlirtModule *module, ut64 address, SetP *deleted) {
+	RzFlirtFunction *flirt_func;
+	RzAnalysisFunction *next_module_function;
+	RzListIter *flirt_func_it;
+	ut32 name_index = 0;
 
 	rz_list_foreach (module->public_functions, flirt_func_it, flirt_func) {
 		// Once the first module function is found, we need to go through the module->public_functions
@@ -412,6 +408,7 @@ static int module_match_buffer(RzAnalysis *analysis, const RzFlirtModule *module
 							rz_analysis_function_add_block(next_module_function, block);
 						}
 						next_module_function->ninstr += fcn->ninstr;
+						set_p_add(deleted, fcn);
 						rz_analysis_function_delete(fcn);
 					}
 				}
@@ -455,28 +452,224 @@ static int module_match_buffer(RzAnalysis *analysis, const RzFlirtModule *module
 	return true;
 }
 
-static int node_match_buffer(RzAnalysis *analysis, const RzFlirtNode *node, ut8 *b, ut64 address, ut32 buf_size, ut32 buf_idx) {
-	RzListIter *node_child_it, *module_it;
+/*
+ * Compiled form of a signature tree, built once per signature file and used
+ * for all the functions. The pattern of each node is kept with a mask of
+ * 0xff or 0 per byte so that it can be compared 16 bytes at a time with SSE2
+ * (8 bytes at a time without), and the
+ * children of the nodes having many of them are indexed by the first byte of
+ * their pattern: only the ones which can match the next byte of the function
+ * are tried, still in the order of the tree.
+ */
+
+#define FLIRT_INDEX_MIN  8
+#define FLIRT_INDEX_SIZE 258
+
+typedef struct flirt_match_node_t {
+	const RzFlirtNode *node;
+	ut8 *bytes; ///< pattern bytes, 0 where variant, followed by the mask
+	ut8 *mask; ///< 0xff where the byte must match, 0 where it is variant
+	struct flirt_match_node_t *children;
+	ut32 n_children;
+	/**
+	 * NULL if not indexed, else the FLIRT_INDEX_SIZE group bounds followed by the
+	 * children positions: the children starting with byte c are at [index[c], index[c + 1])
+	 * and the ones starting with a variant byte at [index[256], index[257]).
+	 */
+	ut32 *index;
+} FlirtMatchNode;
+
+static void match_node_fini(FlirtMatchNode *m) {
+	for (ut32 i = 0; i < m->n_children; i++) {
+		match_node_fini(&m->children[i]);
+	}
+	free(m->children);
+	free(m->bytes);
+	free(m->index);
+}
+
+static bool match_node_index(FlirtMatchNode *m) {
+	m->index = RZ_NEWS0(ut32, FLIRT_INDEX_SIZE + m->n_children);
+	if (!m->index) {
+		return false;
+	}
+	ut32 *pos = m->index + FLIRT_INDEX_SIZE;
+	ut32 i, c, count[257] = { 0 };
+	for (i = 0; i < m->n_children; i++) {
+		const FlirtMatchNode *child = &m->children[i];
+		count[child->mask && child->mask[0] ? child->bytes[0] : 256]++;
+	}
+	for (c = 0; c < 257; c++) {
+		m->index[c + 1] = m->index[c] + count[c];
+		count[c] = m->index[c];
+	}
+	for (i = 0; i < m->n_children; i++) {
+		const FlirtMatchNode *child = &m->children[i];
+		pos[count[child->mask && child->mask[0] ? child->bytes[0] : 256]++] = i;
+	}
+	return true;
+}
+
+static bool match_node_init(FlirtMatchNode *m, const RzFlirtNode *node) {
+	m->node = node;
+	if (node->length) {
+		m->bytes = malloc(node->length * 2);
+		if (!m->bytes) {
+			return false;
+		}
+		m->mask = m->bytes + node->length;
+		for (ut32 i = 0; i < node->length; i++) {
+			m->mask[i] = node->pattern_mask[i] == 0xFF ? 0xFF : 0;
+			m->bytes[i] = node->pattern_bytes[i] & m->mask[i];
+		}
+	}
+	ut32 n = rz_list_length(node->child_list);
+	if (!n) {
+		return true;
+	}
+	m->children = RZ_NEWS0(FlirtMatchNode, n);
+	if (!m->children) {
+		return false;
+	}
+	RzListIter *it;
 	RzFlirtNode *child;
-	RzFlirtModule *module;
+	rz_list_foreach (node->child_list, it, child) {
+		if (!match_node_init(&m->children[m->n_children++], child)) {
+			return false;
+		}
+	}
+	return n < FLIRT_INDEX_MIN || match_node_index(m);
+}
 
-	if (is_pattern_matching(node->length, node->pattern_bytes, node->pattern_mask, b + buf_idx, buf_size - buf_idx)) {
-		if (node->child_list) {
-			rz_list_foreach (node->child_list, node_child_it, child) {
-				if (node_match_buffer(analysis, child, b, address, buf_size, buf_idx + node->length)) {
-					return true;
-				}
+static bool match_node_pattern(const FlirtMatchNode *m, const ut8 *b, ut32 b_size) {
+	ut32 length = m->node->length;
+	if (b_size < length) {
+		return false;
+	}
+	ut32 i = 0;
+#ifdef FLIRT_USE_SSE2
+	for (; i + 16 <= length; i += 16) {
+		__m128i x = _mm_loadu_si128((const __m128i *)(b + i));
+		__m128i p = _mm_loadu_si128((const __m128i *)(m->bytes + i));
+		__m128i k = _mm_loadu_si128((const __m128i *)(m->mask + i));
+		__m128i diff = _mm_and_si128(_mm_xor_si128(x, p), k);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != 0xffff) {
+			return false;
+		}
+	}
+#endif
+	for (; i + 8 <= length; i += 8) {
+		ut64 x, p, k;
+		memcpy(&x, b + i, sizeof(x));
+		memcpy(&p, m->bytes + i, sizeof(p));
+		memcpy(&k, m->mask + i, sizeof(k));
+		if ((x ^ p) & k) {
+			return false;
+		}
+	}
+	for (; i < length; i++) {
+		if ((b[i] ^ m->bytes[i]) & m->mask[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static const RzFlirtModule *match_node_buffer(const FlirtMatchNode *m, const ut8 *b, ut32 buf_size, ut32 buf_idx);
+
+/**
+ * \brief Tries the children of \p m against the buffer at \p buf_idx, in order, until one matches
+ *
+ * \return The first module matching the buffer, NULL if none
+ */
+static const RzFlirtModule *match_children_buffer(const FlirtMatchNode *m, const ut8 *b, ut32 buf_size, ut32 buf_idx) {
+	const RzFlirtModule *module;
+	if (!m->index || buf_idx >= buf_size) {
+		for (ut32 i = 0; i < m->n_children; i++) {
+			if ((module = match_node_buffer(&m->children[i], b, buf_size, buf_idx))) {
+				return module;
 			}
-		} else if (node->module_list) {
-			rz_list_foreach (node->module_list, module_it, module) {
-				if (module_match_buffer(analysis, module, b, address, buf_size)) {
-					return true;
-				}
+		}
+		return NULL;
+	}
+	// merge the children starting with the byte and the ones starting with a variant byte
+	const ut32 *pos = m->index + FLIRT_INDEX_SIZE;
+	const ut8 c = b[buf_idx];
+	ut32 i = m->index[c], i_end = m->index[c + 1];
+	ut32 v = m->index[256], v_end = m->index[257];
+	while (i < i_end || v < v_end) {
+		ut32 k = v == v_end || (i < i_end && pos[i] < pos[v]) ? pos[i++] : pos[v++];
+		if ((module = match_node_buffer(&m->children[k], b, buf_size, buf_idx))) {
+			return module;
+		}
+	}
+	return NULL;
+}
+
+static const RzFlirtModule *match_node_buffer(const FlirtMatchNode *m, const ut8 *b, ut32 buf_size, ut32 buf_idx) {
+	const RzFlirtNode *node = m->node;
+	if (!match_node_pattern(m, b + buf_idx, buf_size - buf_idx)) {
+		return NULL;
+	}
+	if (node->child_list) {
+		return match_children_buffer(m, b, buf_size, buf_idx + node->length);
+	} else if (node->module_list) {
+		RzListIter *module_it;
+		RzFlirtModule *module;
+		rz_list_foreach (node->module_list, module_it, module) {
+			if (module_match_buffer(module, b, buf_size)) {
+				return module;
 			}
 		}
 	}
+	return NULL;
+}
 
-	return false;
+/*
+ * The functions are matched in batches: their bytes are read, then matched
+ * against the signatures in parallel, since that only reads the signatures
+ * and the bytes, and finally the matched modules are applied in the order
+ * of the functions, like a single pass would. Applying a module can resize
+ * or delete the functions following it, so a function deleted since is
+ * skipped and one resized since is read and matched again.
+ */
+
+#define FLIRT_MATCH_BATCH 512
+
+typedef struct {
+	RzAnalysisFunction *fcn;
+	ut8 *buf;
+	ut64 size; ///< size of buf, the linear size of fcn when read
+	const RzFlirtModule *module; ///< first module matching buf, NULL if none
+} FlirtMatch;
+
+typedef struct {
+	FlirtMatchNode root;
+	FlirtMatch *matches;
+} FlirtMatchCtx;
+
+static bool match_read(RzAnalysis *analysis, FlirtMatch *match) {
+	RzAnalysisFunction *func = match->fcn;
+	RZ_FREE(match->buf);
+	match->module = NULL;
+	match->size = rz_analysis_function_linear_size(func);
+	match->buf = malloc(match->size);
+	if (!match->buf) {
+		return false;
+	}
+	if (!analysis->iob.read_at(analysis->iob.io, func->addr, match->buf, (int)match->size)) {
+		RZ_FREE(match->buf);
+		return false;
+	}
+	return true;
+}
+
+static void match_range(size_t from, size_t to, void *user) {
+	FlirtMatchCtx *ctx = user;
+	for (size_t i = from; i < to; i++) {
+		FlirtMatch *match = &ctx->matches[i];
+		match->module = match_children_buffer(&ctx->root, match->buf, match->size, 0);
+	}
 }
 
 /**
@@ -484,10 +677,11 @@ static int node_match_buffer(RzAnalysis *analysis, const RzFlirtNode *node, ut8
  *
  * \param analysis   The analysis
  * \param root_node  The root node
+ * \param pool       Thread pool where the functions are matched, NULL to match them on the calling thread
  *
  * \return False on error, otherwise true
  */
-static bool node_match_functions(RzAnalysis *analysis, const RzFlirtNode *root_node) {
+static bool node_match_functions(RzAnalysis *analysis, const RzFlirtNode *root_node, RzThreadTaskPool *pool) {
 	bool ret = true;
 
 	if (rz_list_length(analysis->fcns) == 0) {
@@ -495,37 +689,79 @@ static bool node_match_functions(RzAnalysis *analysis, const RzFlirtNode *root_n
 		return ret;
 	}
 
-	analysis->flb.push_fs(analysis->flb.f, "flirt");
+	FlirtMatchCtx ctx = { 0 };
+	RzPVector funcs;
+	rz_pvector_init(&funcs, NULL);
+	SetP *deleted = set_p_new();
+	ctx.matches = RZ_NEWS0(FlirtMatch, FLIRT_MATCH_BATCH);
+	if (!deleted || !ctx.matches || !match_node_init(&ctx.root, root_node)) {
+		RZ_LOG_ERROR("FLIRT: cannot allocate the signature matcher\n");
+		ret = false;
+		goto beach;
+	}
 	RzListIter *it_func;
 	RzAnalysisFunction *func;
 	rz_list_foreach (analysis->fcns, it_func, func) {
 		if (func->type != RZ_ANALYSIS_FCN_TYPE_FCN && func->type != RZ_ANALYSIS_FCN_TYPE_LOC) { // scan only for unknown functions
 			continue;
 		}
-
-		ut64 func_size = rz_analysis_function_linear_size(func);
-		ut8 *func_buf = malloc(func_size);
-		if (!func_buf) {
-			ret = false;
-			break;
-		}
-		if (!analysis->iob.read_at(analysis->iob.io, func->addr, func_buf, (int)func_size)) {
-			RZ_LOG_ERROR("FLIRT: Couldn't read function %s at 0x%" PFMT64x "\n", func->name, func->addr);
-			RZ_FREE(func_buf);
+		if (!rz_pvector_push(&funcs, func)) {
 			ret = false;
-			break;
+			goto beach;
 		}
-		RzListIter *node_child_it;
-		RzFlirtNode *child;
-		rz_list_foreach (root_node->child_list, node_child_it, child) {
-			if (node_match_buffer(analysis, child, func_buf, func->addr, func_size, 0)) {
+	}
+
+	analysis->flb.push_fs(analysis->flb.f, "flirt");
+	size_t next = 0;
+	while (ret && next < rz_pvector_len(&funcs)) {
+		// read the functions not deleted yet, up to the first one failing
+		size_t n = 0;
+		bool failed = false;
+		for (; next < rz_pvector_len(&funcs) && n < FLIRT_MATCH_BATCH; next++) {
+			func = rz_pvector_at(&funcs, next);
+			if (set_p_contains(deleted, func)) {
+				continue;
+			}
+			ctx.matches[n].fcn = func;
+			if (!match_read(analysis, &ctx.matches[n++])) {
+				failed = true;
 				break;
 			}
 		}
-		RZ_FREE(func_buf);
+		size_t n_read = failed ? n - 1 : n;
+		if (!pool || !rz_th_task_pool_parallel_for(pool, 0, n_read, 0, match_range, &ctx)) {
+			match_range(0, n_read, &ctx);
+		}
+		for (size_t i = 0; ret && i < n; i++) {
+			FlirtMatch *match = &ctx.matches[i];
+			if (set_p_contains(deleted, match->fcn)) {
+				continue;
+			}
+			if (i == n_read || rz_analysis_function_linear_size(match->fcn) != match->size) {
+				// failed to read, or changed by the modules applied before
+				if (!match_read(analysis, match)) {
+					RZ_LOG_ERROR("FLIRT: Couldn't read function %s at 0x%" PFMT64x "\n", match->fcn->name, match->fcn->addr);
+					ret = false;
+					break;
+				}
+				match_range(i, i + 1, &ctx);
+			}
+			if (match->module && !module_apply(analysis, match->module, match->fcn->addr, deleted)) {
+				ret = false;
+			}
+		}
+		for (size_t i = 0; i < n; i++) {
+			RZ_FREE(ctx.matches[i].buf);
+		}
+		next += failed;
 	}
 	analysis->flb.pop_fs(analysis->flb.f);
 
+beach:
+	match_node_fini(&ctx.root);
+	free(ctx.matches);
+	set_p_free(deleted);
+	rz_pvector_fini(&funcs);
 	return ret;
 }
 
@@ -1280,31 +1516,31 @@ exit:
 }
 
 /**
- * \brief Parses the FLIRT file and applies the signatures
+ * \brief Parses a FLIRT file, either a .sig or a .pat file
  *
- * \param  analysis    The RzAnalysis structure
- * \param  flirt_file  The FLIRT file to parse
- * \return true if the signatures were sucessfully applied to the file
+ * \param  flirt_file     The FLIRT file to parse
+ * \param  expected_arch  The architecture expected in a .sig file (RZ_FLIRT_SIG_ARCH_*)
+ * \return The root node of the signatures, NULL on error
  */
-RZ_API bool rz_sign_flirt_apply(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL const char *flirt_file, ut8 expected_arch) {
-	rz_return_val_if_fail(analysis && RZ_STR_ISNOTEMPTY(flirt_file), false);
+RZ_API RZ_OWN RzFlirtNode *rz_sign_flirt_parse_file(RZ_NONNULL const char *flirt_file, ut8 expected_arch) {
+	rz_return_val_if_fail(RZ_STR_ISNOTEMPTY(flirt_file), NULL);
 	RzBuffer *flirt_buf = NULL;
 	RzFlirtNode *node = NULL;
 
 	if (expected_arch > RZ_FLIRT_SIG_ARCH_ANY) {
 		RZ_LOG_ERROR("FLIRT: unknown architecture %u\n", expected_arch);
-		return false;
+		return NULL;
 	}
 
 	const char *extension = rz_str_lchr(flirt_file, '.');
 	if (RZ_STR_ISEMPTY(extension) || (strcmp(extension, ".sig") != 0 && strcmp(extension, ".pat") != 0)) {
 		RZ_LOG_ERROR("FLIRT: unknown extension '%s'\n", extension);
-		return false;
+		return NULL;
 	}
 
 	if (!(flirt_buf = rz_buf_new_slurp(flirt_file))) {
 		RZ_LOG_ERROR("FLIRT: Can't open %s\n", flirt_file);
-		return false;
+		return NULL;
 	}
 
 	if (!strcmp(extension, ".pat")) {
@@ -1314,15 +1550,46 @@ RZ_API bool rz_sign_flirt_apply(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL cons
 	}
 
 	rz_buf_free(flirt_buf);
-	if (node) {
-		if (!node_match_functions(analysis, node)) {
-			RZ_LOG_ERROR("FLIRT: Error while scanning the file %s\n", flirt_file);
-		}
-		rz_sign_flirt_node_free(node);
-		return true;
+	if (!node) {
+		RZ_LOG_ERROR("FLIRT: We encountered an error while parsing the file %s. Sorry.\n", flirt_file);
 	}
-	RZ_LOG_ERROR("FLIRT: We encountered an error while parsing the file %s. Sorry.\n", flirt_file);
-	return false;
+	return node;
+}
+
+/**
+ * \brief Applies the parsed signatures to the analyzed functions
+ *
+ * The functions are matched in parallel on \p pool when given, the result is
+ * the same as the one of a single thread.
+ *
+ * \param  analysis  The RzAnalysis structure
+ * \param  node      The root node of the signatures
+ * \param  pool      The thread pool to use, can be NULL
+ * \return false if an error occurred while scanning the functions
+ */
+RZ_API bool rz_sign_flirt_apply_node(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL const RzFlirtNode *node, RZ_NULLABLE RzThreadTaskPool *pool) {
+	rz_return_val_if_fail(analysis && node, false);
+	return node_match_functions(analysis, node, pool);
+}
+
+/**
+ * \brief Parses the FLIRT file and applies the signatures
+ *
+ * \param  analysis    The RzAnalysis structure
+ * \param  flirt_file  The FLIRT file to parse
+ * \return true if the signatures were sucessfully applied to the file
+ */
+RZ_API bool rz_sign_flirt_apply(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL const char *flirt_file, ut8 expected_arch) {
+	rz_return_val_if_fail(analysis && RZ_STR_ISNOTEMPTY(flirt_file), false);
+	RzFlirtNode *node = rz_sign_flirt_parse_file(flirt_file, expected_arch);
+	if (!node) {
+		return false;
+	}
+	if (!rz_sign_flirt_apply_node(analysis, node, NULL)) {
+		RZ_LOG_ERROR("FLIRT: Error while scanning the file %s\n", flirt_file);
+	}
+	rz_sign_flirt_node_free(node);
+	return true;
 }
 
 /**
@@ -20,6 +20,9 @@ Usage Example:
 #include <rz_util.h>
 #include <rz_lib.h>
 #include <rz_socket.h>
+#if HAVE_SHM_OPEN
+#include <sys/mman.h>
+#endif
 
 #define RZP_PID(x)    (((RzPipe *)(x)->data)->pid)
 #define RZP_INPUT(x)  (((RzPipe *)(x)->data)->input[0])
@@ -33,12 +36,107 @@ static void env(const char *s, int f) {
 }
 #endif
 
+#define RZPIPE_BATCH_WINDOW 8192
+
+static bool rzp_write_all(RzPipe *rzp, const ut8 *buf, size_t len) {
+#if __WINDOWS__
+	DWORD dwWritten = 0;
+	return WriteFile(rzp->pipe, buf, len, &dwWritten, NULL) && dwWritten == len;
+#else
+	while (len > 0) {
+		ssize_t w = write(rzp->input[1], buf, len);
+		if (w < 1) {
+			return false;
+		}
+		buf += w;
+		len -= w;
+	}
+	return true;
+#endif
+}
+
+static bool rzp_read_all(RzPipe *rzp, ut8 *buf, size_t len) {
+#if __WINDOWS__
+	DWORD dwRead = 0;
+	return ReadFile(rzp->pipe, buf, len, &dwRead, NULL) && dwRead == len;
+#else
+	while (len > 0) {
+		ssize_t r = read(rzp->output[0], buf, len);
+		if (r < 1) {
+			return false;
+		}
+		buf += r;
+		len -= r;
+	}
+	return true;
+#endif
+}
+
+static bool rzp_frame_append(RzStrBuf *sb, ut8 type, const void *payload, ut32 len) {
+	ut8 hdr[RZPIPE_FRAME_HDR_SIZE];
+	rz_write_le32(hdr, len);
+	hdr[4] = type;
+	return rz_strbuf_append_n(sb, (const char *)hdr, sizeof(hdr)) &&
+		(!len || rz_strbuf_append_n(sb, payload, len));
+}
+
+static bool rzp_frame_send(RzPipe *rzp, ut8 type, const void *payload, ut32 len) {
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	bool ret = rzp_frame_append(&sb, type, payload, len) &&
+		rzp_write_all(rzp, (const ut8 *)rz_strbuf_get(&sb), rz_strbuf_length(&sb));
+	rz_strbuf_fini(&sb);
+	return ret;
+}
+
+static bool rzp_frame_header(RzPipe *rzp, ut8 *status, ut32 *len) {
+	ut8 hdr[RZPIPE_FRAME_HDR_SIZE];
+	if (!rzp_read_all(rzp, hdr, sizeof(hdr))) {
+		return false;
+	}
+	*len = rz_read_le32(hdr);
+	*status = hdr[4];
+	return *len <= RZPIPE_FRAME_MAX;
+}
+
+/* read a response, the payload is NUL terminated */
+static char *rzp_frame_recv(RzPipe *rzp, ut8 *status) {
+	ut32 len;
+	if (!rzp_frame_header(rzp, status, &len)) {
+		return NULL;
+	}
+	char *payload = malloc((size_t)len + 1);
+	if (!payload) {
+		return NULL;
+	}
+	if (!rzp_read_all(rzp, (ut8 *)payload, len)) {
+		free(payload);
+		return NULL;
+	}
+	payload[len] = 0;
+	return payload;
+}
+
+/* switch to the framed protocol if the host offers it */
+static void rzp_negotiate(RzPipe *rzp) {
+	char *framed = rz_sys_getenv(RZPIPE_FRAMED_ENV);
+	if (RZ_STR_ISNOTEMPTY(framed) && rzp_write_all(rzp, (const ut8 *)RZPIPE_FRAMED_HELLO, RZPIPE_FRAMED_HELLO_LEN)) {
+		ut8 status = RZPIPE_FRAME_ERROR;
+		free(rzp_frame_recv(rzp, &status));
+		rzp->framed = status == RZPIPE_FRAME_OK;
+	}
+	free(framed);
+}
+
 RZ_API int rzpipe_write(RzPipe *rzpipe, const char *str) {
 	char *cmd;
 	int ret, len;
 	if (!rzpipe || !str) {
 		return -1;
 	}
+	if (rzpipe->framed) {
+		return rzp_frame_send(rzpipe, RZPIPE_FRAME_CMD, str, strlen(str));
+	}
 	len = strlen(str) + 2; /* include \n\x00 */
 	cmd = malloc(len + 2);
 	if (!cmd) {
@@ -64,6 +162,11 @@ RZ_API char *rzpipe_read(RzPipe *rzpipe) {
 	if (!rzpipe) {
 		return NULL;
 	}
+	if (rzpipe->framed) {
+		ut8 status;
+		// a command without output is an empty string, as with the text protocol
+		return rzp_frame_recv(rzpipe, &status);
+	}
 	bufsz = 4096;
 	buf = calloc(1, bufsz);
 	if (!buf) {
@@ -107,6 +210,16 @@ RZ_API char *rzpipe_read(RzPipe *rzpipe) {
 	return buf;
 }
 
+static void rzp_shm_unmap(RzPipe *rzp) {
+#if HAVE_SHM_OPEN
+	if (rzp->shm) {
+		munmap(rzp->shm, rzp->shm_size);
+	}
+#endif
+	rzp->shm = NULL;
+	rzp->shm_size = 0;
+}
+
 RZ_API int rzpipe_close(RzPipe *rzpipe) {
 	if (!rzpipe) {
 		return 0;
@@ -119,6 +232,8 @@ RZ_API int rzpipe_close(RzPipe *rzpipe) {
 		}
 	}
 	*/
+	// the host drops its side when the session ends
+	rzp_shm_unmap(rzpipe);
 #if __WINDOWS__
 	if (rzpipe->pipe) {
 		CloseHandle(rzpipe->pipe);
@@ -184,6 +299,8 @@ static RzPipe *rzp_open_spawn(RzPipe *rzp, const char *cmd) {
 	if (!done) {
 		eprintf("Cannot find RZ_PIPE_IN or RZ_PIPE_OUT environment\n");
 		RZ_FREE(rzp);
+	} else {
+		rzp_negotiate(rzp);
 	}
 	free(in);
 	free(out);
@@ -352,3 +469,189 @@ RZ_API char *rzpipe_cmdf(RzPipe *rzp, const char *fmt, ...) {
 	va_end(ap);
 	return (char *)fmt;
 }
+
+/**
+ * \brief Run \p n commands, pipelining them if the framed protocol is in use
+ *
+ * \return the outputs in the same order as \p cmds, NULL for the commands that failed
+ */
+RZ_API RZ_OWN RzPVector /*<char *>*/ *rzpipe_cmd_batch(RZ_NONNULL RzPipe *rzp, RZ_NONNULL const char **cmds, size_t n) {
+	rz_return_val_if_fail(rzp && cmds, NULL);
+	RzPVector *res = rz_pvector_new(free);
+	if (!res || (n && !rz_pvector_reserve(res, n))) {
+		rz_pvector_free(res);
+		return NULL;
+	}
+	size_t i = 0, j;
+	if (!rzp->framed) {
+		for (i = 0; i < n; i++) {
+			rz_pvector_push(res, rzpipe_cmd(rzp, cmds[i]));
+		}
+		return res;
+	}
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	while (i < n) {
+		// keep the requests in flight below the pipe capacity, the host could
+		// otherwise block writing responses while we block writing requests
+		size_t first = i;
+		rz_strbuf_set(&sb, "");
+		do {
+			rzp_frame_append(&sb, RZPIPE_FRAME_CMD, cmds[i], strlen(cmds[i]));
+			i++;
+		} while (i < n && rz_strbuf_length(&sb) + RZPIPE_FRAME_HDR_SIZE + strlen(cmds[i]) <= RZPIPE_BATCH_WINDOW);
+		bool ok = rzp_write_all(rzp, (const ut8 *)rz_strbuf_get(&sb), rz_strbuf_length(&sb));
+		for (j = first; j < i; j++) {
+			ut8 status;
+			rz_pvector_push(res, ok ? rzp_frame_recv(rzp, &status) : NULL);
+		}
+	}
+	rz_strbuf_fini(&sb);
+	return res;
+}
+
+/**
+ * \brief Read \p len bytes at \p addr of the host
+ *
+ * With the framed protocol the bytes are transferred as they are, through
+ * the shared memory segment if there is one big enough, otherwise this falls
+ * back to parsing the output of p8.
+ *
+ * \return the number of bytes read or -1 on error
+ */
+RZ_API st64 rzpipe_read_at(RZ_NONNULL RzPipe *rzp, ut64 addr, RZ_NONNULL RZ_OUT ut8 *buf, size_t len) {
+	rz_return_val_if_fail(rzp && buf, -1);
+	if (len > RZPIPE_FRAME_MAX) {
+		return -1;
+	}
+	if (!rzp->framed) {
+		char *hex = rzpipe_cmdf(rzp, "p8 %" PFMT64u " @ 0x%" PFMT64x, (ut64)len, addr);
+		if (!hex) {
+			return -1;
+		}
+		rz_str_trim(hex);
+		st64 r = rz_hex_str2bin(hex, buf);
+		free(hex);
+		return r;
+	}
+	if (len && len <= rzp->shm_size) {
+		const ut8 *data = rzpipe_shm_read_at(rzp, addr, len);
+		if (!data) {
+			return -1;
+		}
+		memcpy(buf, data, len);
+		return len;
+	}
+	ut8 req[12];
+	rz_write_le64(req, addr);
+	rz_write_le32(req + 8, len);
+	ut8 status;
+	ut32 rlen;
+	if (!rzp_frame_send(rzp, RZPIPE_FRAME_READ, req, sizeof(req)) || !rzp_frame_header(rzp, &status, &rlen)) {
+		return -1;
+	}
+	// straight into the caller buffer
+	if (!rzp_read_all(rzp, buf, RZ_MIN(rlen, len))) {
+		return -1;
+	}
+	for (ut32 skip = rlen > len ? rlen - len : 0; skip > 0; skip--) {
+		ut8 b;
+		if (!rzp_read_all(rzp, &b, 1)) {
+			return -1;
+		}
+	}
+	return status == RZPIPE_FRAME_OK ? RZ_MIN(rlen, len) : -1;
+}
+
+static bool rzp_skip(RzPipe *rzp, ut32 len) {
+	ut8 tmp[64];
+	while (len > 0) {
+		ut32 n = RZ_MIN(len, sizeof(tmp));
+		if (!rzp_read_all(rzp, tmp, n)) {
+			return false;
+		}
+		len -= n;
+	}
+	return true;
+}
+
+/**
+ * \brief Get a shared memory segment of \p size bytes from the host
+ *
+ * Afterwards rzpipe_shm_read_at() and rzpipe_read_at() have the host read
+ * its memory directly into the segment, so the bytes don't go through the
+ * pipe. A segment opened before is dropped.
+ *
+ * \return false if the host or the platform can't do it, e.g. without the framed protocol
+ */
+RZ_API bool rzpipe_shm_open(RZ_NONNULL RzPipe *rzp, size_t size) {
+	rz_return_val_if_fail(rzp, false);
+	rzpipe_shm_close(rzp);
+#if HAVE_SHM_OPEN
+	if (!rzp->framed || !size || size > RZPIPE_FRAME_MAX) {
+		return false;
+	}
+	ut8 req[4];
+	rz_write_le32(req, size);
+	ut8 status = RZPIPE_FRAME_ERROR;
+	char *name = rzp_frame_send(rzp, RZPIPE_FRAME_SHM, req, sizeof(req)) ? rzp_frame_recv(rzp, &status) : NULL;
+	if (!name || status != RZPIPE_FRAME_OK) {
+		free(name);
+		return false;
+	}
+	int fd = shm_open(name, O_RDONLY, 0);
+	free(name);
+	if (fd == -1) {
+		return false;
+	}
+	void *shm = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (shm == MAP_FAILED) {
+		return false;
+	}
+	rzp->shm = shm;
+	rzp->shm_size = size;
+	return true;
+#else
+	return false;
+#endif
+}
+
+/**
+ * \brief Drop the segment got with rzpipe_shm_open(), if any
+ */
+RZ_API void rzpipe_shm_close(RZ_NONNULL RzPipe *rzp) {
+	rz_return_if_fail(rzp);
+	if (!rzp->shm) {
+		return;
+	}
+	rzp_shm_unmap(rzp);
+	ut8 req[4] = { 0 };
+	ut8 status;
+	if (rzp_frame_send(rzp, RZPIPE_FRAME_SHM, req, sizeof(req))) {
+		free(rzp_frame_recv(rzp, &status));
+	}
+}
+
+/**
+ * \brief Read \p len bytes at \p addr of the host into the shared memory segment
+ *
+ * \return the bytes, at the start of the segment and valid until the next read,
+ * or NULL on error or if \p len doesn't fit in the segment
+ */
+RZ_API RZ_BORROW const ut8 *rzpipe_shm_read_at(RZ_NONNULL RzPipe *rzp, ut64 addr, size_t len) {
+	rz_return_val_if_fail(rzp, NULL);
+	if (!rzp->shm || !len || len > rzp->shm_size) {
+		return NULL;
+	}
+	ut8 req[16];
+	rz_write_le64(req, addr);
+	rz_write_le32(req + 8, len);
+	rz_write_le32(req + 12, 0);
+	ut8 status;
+	ut32 rlen;
+	if (!rzp_frame_send(rzp, RZPIPE_FRAME_SHM_READ, req, sizeof(req)) || !rzp_frame_header(rzp, &status, &rlen) || !rzp_skip(rzp, rlen)) {
+		return NULL;
+	}
+	return status == RZPIPE_FRAME_OK ? rzp->shm : NULL;
+}
@@ -21,19 +21,32 @@ static void rz_rap_packet_fill(ut8 *buf, const ut8 *src, int len) {
 }
 
 RZ_API int rz_socket_rap_client_open(RzSocket *s, const char *file, int rw) {
+	return rz_socket_rap_client_open_caps(s, file, rw, NULL);
+}
+
+/**
+ * \brief Open \p file on the server, as rz_socket_rap_client_open() does.
+ * \param caps If not NULL, ask the server for its RAP_CAP_* capabilities
+ * and store them here, 0 if the server does not know about them.
+ */
+RZ_API int rz_socket_rap_client_open_caps(RzSocket *s, const char *file, int rw, RZ_NULLABLE RZ_OUT ut32 *caps) {
+	if (caps) {
+		*caps = 0;
+	}
 	rz_socket_block_time(s, true, 1, 0);
 	size_t file_len0 = strlen(file) + 1;
 	if (file_len0 > 255) {
 		eprintf("Filename too long\n");
 		return -1;
 	}
-	char *buf = malloc(file_len0 + 7);
+	char *buf = malloc(file_len0 + 9);
 	if (!buf) {
 		return -1;
 	}
 	// >>
 	buf[0] = RAP_PACKET_OPEN;
-	buf[1] = rw;
+	// older servers ignore the flag and reply as usual
+	buf[1] = rw | (caps ? RAP_OPEN_CAPS : 0);
 	buf[2] = (ut8)(file_len0 & 0xff);
 	memcpy(buf + 3, file, file_len0);
 	(void)rz_socket_write(s, buf, 3 + file_len0);
@@ -44,7 +57,11 @@ RZ_API int rz_socket_rap_client_open(RzSocket *s, const char *file, int rw) {
 	int r = rz_socket_read_block(s, (ut8 *)buf, 5);
 	if (r == 5) {
 		if (buf[0] == (char)(RAP_PACKET_OPEN | RAP_PACKET_REPLY)) {
-			fd = rz_read_at_be32(buf + 1, 1);
+			fd = rz_read_at_be32(buf, 1);
+		} else if (caps && buf[0] == (char)(RAP_PACKET_OPEN | RAP_PACKET_REPLY | RAP_PACKET_EXTENDED) &&
+			rz_socket_read_block(s, (ut8 *)buf + 5, 4) == 4) {
+			fd = rz_read_at_be32(buf, 1);
+			*caps = rz_read_at_be32(buf, 5);
 		} else {
 			eprintf("RapClientOpen: Bad packet 0x%02x\n", buf[0]);
 		}
@@ -198,3 +215,215 @@ RZ_API int rz_socket_rap_client_seek(RzSocket *s, ut64 offset, int whence) {
 	}
 	return rz_read_at_be64(tmp, 1);
 }
+
+#define RAP_PIPELINE 8 ///< RAP_PACKET_READV requests sent ahead before waiting for the first reply
+
+typedef struct {
+	size_t iov; ///< range where the data of the request starts
+	ut32 delta; ///< offset of the data in that range
+	ut32 len; ///< bytes asked for by the request
+} RapReadReq;
+
+/**
+ * Build the RAP_PACKET_READV request for the ranges from \p at and \p delta on.
+ */
+static bool readv_next(const RzSocketRapIov *iov, size_t count, bool zlib, size_t *at, ut32 *delta, RapReadReq *req, ut8 *pkt, size_t *pkt_len) {
+	while (*at < count && *delta >= iov[*at].len) {
+		(*at)++;
+		*delta = 0;
+	}
+	if (*at >= count) {
+		return false;
+	}
+	req->iov = *at;
+	req->delta = *delta;
+	req->len = 0;
+	ut32 n_iov = 0;
+	ut8 *p = pkt + 6;
+	while (*at < count && n_iov < RAP_READV_MAX_IOV && req->len < RAP_READV_MAX) {
+		ut32 n = RZ_MIN(iov[*at].len - *delta, RAP_READV_MAX - req->len);
+		if (n) {
+			rz_write_be64(p, iov[*at].addr + *delta);
+			rz_write_be32(p + 8, n);
+			p += 12;
+			n_iov++;
+			req->len += n;
+			*delta += n;
+		}
+		if (*delta >= iov[*at].len) {
+			(*at)++;
+			*delta = 0;
+		}
+	}
+	pkt[0] = RAP_PACKET_READV;
+	rz_write_be32(pkt + 1, n_iov);
+	// small transfers are not worth the deflating
+	pkt[5] = zlib && req->len >= RAP_PACKET_MAX * 16 ? RAP_READV_ZLIB : 0;
+	*pkt_len = p - pkt;
+	return true;
+}
+
+static bool readv_reply(RzSocket *s, const RzSocketRapIov *iov, size_t count, const RapReadReq *req) {
+	ut8 hdr[10];
+	if (rz_socket_read_block(s, hdr, 10) != 10 || hdr[0] != (RAP_PACKET_READV | RAP_PACKET_REPLY) ||
+		rz_read_be32(hdr + 6) != req->len) {
+		return false;
+	}
+	ut32 len = rz_read_be32(hdr + 1);
+	if (len > RAP_READV_MAX * 2) {
+		return false;
+	}
+	ut8 *data = malloc(RZ_MAX(len, 1));
+	if (!data) {
+		return false;
+	}
+	bool ret = false;
+	if (rz_socket_read_block(s, data, len) != len) {
+		goto beach;
+	}
+	if (hdr[5] & RAP_READV_ZLIB) {
+		int dst_len = 0;
+		ut8 *raw = len ? rz_inflate(data, len, NULL, &dst_len) : NULL;
+		free(data);
+		data = raw;
+		if (!data || dst_len != req->len) {
+			goto beach;
+		}
+	} else if (len != req->len) {
+		goto beach;
+	}
+	// scatter the data back into the ranges
+	const ut8 *src = data;
+	size_t at = req->iov;
+	ut32 delta = req->delta;
+	ut32 left = req->len;
+	while (left && at < count) {
+		ut32 n = RZ_MIN(iov[at].len - delta, left);
+		memcpy(iov[at].buf + delta, src, n);
+		src += n;
+		left -= n;
+		at++;
+		delta = 0;
+	}
+	ret = true;
+beach:
+	free(data);
+	return ret;
+}
+
+static bool rap_seek_set(RzSocket *s, ut64 addr) {
+	ut8 tmp[10];
+	tmp[0] = RAP_PACKET_SEEK;
+	tmp[1] = 0; // SEEK_SET
+	rz_write_be64(tmp + 2, addr);
+	(void)rz_socket_write(s, tmp, 10);
+	rz_socket_flush(s);
+	return rz_socket_read_block(s, tmp, 9) == 9 && tmp[0] == (RAP_PACKET_SEEK | RAP_PACKET_REPLY);
+}
+
+/**
+ * Read the ranges with the original packets, a seek and a read of at most
+ * RAP_PACKET_MAX bytes at a time.
+ */
+static bool readv_compat(RzSocket *s, const RzSocketRapIov *iov, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		for (ut32 delta = 0; delta < iov[i].len; delta += RAP_PACKET_MAX) {
+			int n = (int)RZ_MIN(iov[i].len - delta, RAP_PACKET_MAX);
+			memset(iov[i].buf + delta, 0xff, n);
+			if (!rap_seek_set(s, iov[i].addr + delta) || rz_socket_rap_client_read(s, iov[i].buf + delta, n) != n) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * \brief Read the \p count ranges of \p iov from the server.
+ *
+ * Servers with RAP_CAP_READV in \p caps get RAP_PACKET_READV requests of up
+ * to RAP_READV_MAX bytes, RAP_PIPELINE of them sent ahead without waiting
+ * for the replies, so large reads are not bound by the round trip time.
+ * Other servers are asked with a seek and a read per RAP_PACKET_MAX bytes.
+ */
+RZ_API bool rz_socket_rap_client_readv(RzSocket *s, ut32 caps, RZ_NONNULL const RzSocketRapIov *iov, size_t count) {
+	rz_return_val_if_fail(s && iov, false);
+	if (!(caps & RAP_CAP_READV)) {
+		return readv_compat(s, iov, count);
+	}
+#if HAVE_ZLIB
+	bool zlib = caps & RAP_CAP_ZLIB;
+#else
+	bool zlib = false;
+#endif
+	ut8 *pkt = malloc(6 + RAP_READV_MAX_IOV * 12);
+	if (!pkt) {
+		return false;
+	}
+	rz_socket_block_time(s, true, 1, 0);
+	RapReadReq reqs[RAP_PIPELINE];
+	size_t sent = 0, done = 0;
+	size_t at = 0;
+	ut32 delta = 0;
+	bool ret = true;
+	for (;;) {
+		size_t pkt_len;
+		while (sent - done < RAP_PIPELINE && readv_next(iov, count, zlib, &at, &delta, &reqs[sent % RAP_PIPELINE], pkt, &pkt_len)) {
+			(void)rz_socket_write(s, pkt, pkt_len);
+			sent++;
+		}
+		rz_socket_flush(s);
+		if (done == sent) {
+			break;
+		}
+		if (!readv_reply(s, iov, count, &reqs[done % RAP_PIPELINE])) {
+			eprintf("rap: unexpected readv reply\n");
+			ret = false;
+			break;
+		}
+		done++;
+	}
+	free(pkt);
+	return ret;
+}
+
+/**
+ * \brief Read \p count bytes at \p addr, see rz_socket_rap_client_readv().
+ * \return \p count, or -1 on failure
+ */
+RZ_API int rz_socket_rap_client_read_at(RzSocket *s, ut32 caps, ut64 addr, RZ_NONNULL ut8 *buf, int count) {
+	rz_return_val_if_fail(s && buf, -1);
+	if (count < 1) {
+		return count;
+	}
+	RzSocketRapIov iov = { addr, buf, (ut32)count };
+	return rz_socket_rap_client_readv(s, caps, &iov, 1) ? count : -1;
+}
+
+/**
+ * \brief Write \p count bytes at \p addr, with a seek and a write per
+ * RAP_PACKET_MAX bytes.
+ * \return the bytes written, or -1 on failure
+ */
+RZ_API int rz_socket_rap_client_write_at(RzSocket *s, ut64 addr, RZ_NONNULL const ut8 *buf, int count) {
+	rz_return_val_if_fail(s && buf, -1);
+	if (count < 1) {
+		return count;
+	}
+	int written = 0;
+	while (written < count) {
+		int n = RZ_MIN(count - written, RAP_PACKET_MAX);
+		if (!rap_seek_set(s, addr + written)) {
+			break;
+		}
+		int r = rz_socket_rap_client_write(s, buf + written, n);
+		if (r < 1) {
+			break;
+		}
+		written += r;
+		if (r < n) {
+			break;
+		}
+	}
+	return written > 0 ? written : -1;
+}
@@ -74,6 +74,7 @@ RZ_API RZ_BORROW RzBaseType *rz_type_db_get_base_type(const RzTypeDB *typedb, RZ
 RZ_API bool rz_type_db_delete_base_type(RzTypeDB *typedb, RZ_NONNULL RzBaseType *type) {
 	rz_return_val_if_fail(typedb && type && type->name, false);
 	ht_pp_delete(typedb->types, type->name);
+	rz_type_db_invalidate_layouts(typedb);
 	return true;
 }
 
@@ -191,6 +192,7 @@ RZ_API RZ_OWN RzBaseType *rz_type_base_type_new(RzBaseTypeKind kind) {
 RZ_API void rz_type_db_save_base_type(const RzTypeDB *typedb, const RzBaseType *type) {
 	rz_return_if_fail(typedb && type && type->name);
 	ht_pp_insert(typedb->types, type->name, (void *)type);
+	rz_type_db_invalidate_layouts(typedb);
 }
 
 /**
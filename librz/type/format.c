@@ -7,6 +7,8 @@
 #include <rz_reg.h>
 #include <rz_type.h>
 
+#include "type_private.h"
+
 #define NOPTR           0
 #define PTRSEEK         1
 #define PTRBACK         2
@@ -1511,17 +1513,71 @@ static void rz_type_format_num(RzStrBuf *outbuf, int endian, int mode, const cha
 	}
 }
 
+#define FORMAT_SIZE_NESTING 5
+#define FORMAT_SIZE_UNKNOWN INT_MIN
+
+/**
+ * Returns the format generated from the type \p name, remembered until the
+ * types of \p typedb change. The string is owned by the cache.
+ */
+static const char *type_format_cached(const RzTypeDB *typedb, const char *name) {
+	HtPP *formats = rz_type_db_type_formats(typedb);
+	if (!formats) {
+		return rz_type_format(typedb, name);
+	}
+	bool found = false;
+	const char *fmt = ht_pp_find(formats, name, &found);
+	if (found) {
+		return fmt;
+	}
+	char *value = rz_type_format(typedb, name);
+	if (!ht_pp_insert(formats, name, value)) {
+		free(value);
+		return NULL;
+	}
+	return value;
+}
+
+static int format_struct_size(const RzTypeDB *typedb, const char *f, int mode, int n);
+
 // XXX: this is somewhat incomplete. must be updated to handle all format chars
 RZ_API int rz_type_format_struct_size(const RzTypeDB *typedb, const char *f, int mode, int n) {
-	char *end, *args, *fmt;
-	int size = 0, tabsize = 0, i, idx = 0, biggest = 0, fmt_len = 0, times = 1;
-	bool tabsize_set = false;
 	if (!f) {
 		return -1;
 	}
-	if (n >= 5) { // This is the nesting level, is this not a bit arbitrary?!
+	if (n >= FORMAT_SIZE_NESTING) { // This is the nesting level, is this not a bit arbitrary?!
 		return 0;
 	}
+	// The size does not depend on the mode, only on the format and the nesting level
+	HtPP *sizes = rz_type_db_format_sizes(typedb);
+	int *known = sizes ? ht_pp_find(sizes, f, NULL) : NULL;
+	if (known && known[n] != FORMAT_SIZE_UNKNOWN) {
+		return known[n];
+	}
+	int size = format_struct_size(typedb, f, mode, n);
+	sizes = rz_type_db_format_sizes(typedb);
+	if (!sizes) {
+		return size;
+	}
+	known = ht_pp_find(sizes, f, NULL);
+	if (!known) {
+		known = RZ_NEWS(int, FORMAT_SIZE_NESTING);
+		if (!known || !ht_pp_insert(sizes, f, known)) {
+			free(known);
+			return size;
+		}
+		for (int i = 0; i < FORMAT_SIZE_NESTING; i++) {
+			known[i] = FORMAT_SIZE_UNKNOWN;
+		}
+	}
+	known[n] = size;
+	return size;
+}
+
+static int format_struct_size(const RzTypeDB *typedb, const char *f, int mode, int n) {
+	char *end, *args, *fmt;
+	int size = 0, tabsize = 0, i, idx = 0, biggest = 0, fmt_len = 0, times = 1;
+	bool tabsize_set = false;
 	const char *fmt2 = rz_type_db_format_get(typedb, f);
 	if (!fmt2) {
 		fmt2 = f;
@@ -1673,7 +1729,7 @@ RZ_API int rz_type_format_struct_size(const RzTypeDB *typedb, const char *f, int
 					return -1;
 				}
 				if (!format) { // Fetch format from types db
-					format = rz_type_format(typedb, structname + 1);
+					format = type_format_cached(typedb, structname + 1);
 				}
 			}
 			if (!format) {
@@ -1787,7 +1843,8 @@ static int rz_type_format_struct(const RzTypeDB *typedb, RzPrint *p, RzStrBuf *o
 	} else {
 		const char *dbfmt = rz_type_db_format_get(typedb, name);
 		if (!dbfmt) { // Fetch struct info from types DB
-			fmt = rz_type_format(typedb, name);
+			const char *typefmt = type_format_cached(typedb, name);
+			fmt = typefmt ? strdup(typefmt) : NULL;
 		} else {
 			fmt = strdup(dbfmt);
 		}
@@ -1912,6 +1969,7 @@ RZ_API const char *rz_type_db_format_get(const RzTypeDB *typedb, const char *nam
 RZ_API void rz_type_db_format_set(RzTypeDB *typedb, const char *name, const char *fmt) {
 	rz_return_if_fail(typedb && name && fmt);
 	ht_pp_insert(typedb->formats, name, strdup(fmt));
+	rz_type_db_invalidate_layouts(typedb);
 }
 
 static bool format_collect_cb(void *user, const void *k, const void *v) {
@@ -1932,6 +1990,7 @@ RZ_API RZ_OWN RzList *rz_type_db_format_all(RzTypeDB *typedb) {
 RZ_API void rz_type_db_format_delete(RzTypeDB *typedb, const char *name) {
 	rz_return_if_fail(typedb && name);
 	ht_pp_delete(typedb->formats, name);
+	rz_type_db_invalidate_layouts(typedb);
 }
 
 static int rz_type_format_data_internal(const RzTypeDB *typedb, RzPrint *p, RzStrBuf *outbuf, ut64 seek, const ut8 *b, const int len,
@@ -7,6 +7,7 @@
 #include <rz_util.h>
 #include <rz_type.h>
 #include <string.h>
+#include "type_private.h"
 
 /**
  * \brief Creates a new RzCallable type
@@ -161,6 +162,7 @@ RZ_API bool rz_type_func_save(RzTypeDB *typedb, RZ_NONNULL RzCallable *callable)
  */
 RZ_API RZ_BORROW RzCallable *rz_type_func_get(RzTypeDB *typedb, RZ_NONNULL const char *name) {
 	rz_return_val_if_fail(typedb && name, NULL);
+	rz_type_db_callables_lazy_load(typedb, name);
 	bool found = false;
 	RzCallable *callable = ht_pp_find(typedb->callables, name, &found);
 	if (!found || !callable) {
@@ -178,6 +180,7 @@ RZ_API RZ_BORROW RzCallable *rz_type_func_get(RzTypeDB *typedb, RZ_NONNULL const
  */
 RZ_API bool rz_type_func_delete(RzTypeDB *typedb, RZ_NONNULL const char *name) {
 	rz_return_val_if_fail(typedb && name, false);
+	rz_type_db_callables_lazy_forget(typedb, name);
 	ht_pp_delete(typedb->callables, name);
 	return true;
 }
@@ -190,6 +193,7 @@ static void callables_ht_free(HtPPKv *kv) {
  * \brief Removes all RzCallable types
  */
 RZ_API void rz_type_func_delete_all(RzTypeDB *typedb) {
+	rz_pvector_clear(typedb->callables_lazy);
 	ht_pp_free(typedb->callables);
 	typedb->callables = ht_pp_new(NULL, callables_ht_free, NULL);
 }
@@ -202,6 +206,7 @@ RZ_API void rz_type_func_delete_all(RzTypeDB *typedb) {
  */
 RZ_API bool rz_type_func_exist(RzTypeDB *typedb, RZ_NONNULL const char *name) {
 	rz_return_val_if_fail(typedb && name, false);
+	rz_type_db_callables_lazy_load(typedb, name);
 	bool found = false;
 	return ht_pp_find(typedb->callables, name, &found) && found;
 }
@@ -568,6 +573,7 @@ RZ_API RZ_OWN RzList *rz_type_function_names(RzTypeDB *typedb) {
 	rz_return_val_if_fail(typedb, NULL);
 	RzList *result = rz_list_newf(free);
 	ht_pp_foreach(typedb->callables, function_names_collect_cb, result);
+	rz_type_db_callables_lazy_names(typedb, result, false);
 	return result;
 }
 
@@ -589,5 +595,6 @@ RZ_API RZ_OWN RzList *rz_type_noreturn_function_names(RzTypeDB *typedb) {
 	rz_return_val_if_fail(typedb, NULL);
 	RzList *noretl = rz_list_newf(free);
 	ht_pp_foreach(typedb->callables, noreturn_function_names_collect_cb, noretl);
+	rz_type_db_callables_lazy_names(typedb, noretl, true);
 	return noretl;
 }
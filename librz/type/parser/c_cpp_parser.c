@@ -9,6 +9,7 @@
 #include <tree_sitter/api.h>
 
 #include <types_parser.h>
+#include "../type_private.h"
 
 #define TS_START_END(node, start, end) \
 	do { \
@@ -279,6 +280,8 @@ RZ_API int rz_type_parse_file(RzTypeDB *typedb, const char *path, const char *di
  */
 RZ_API int rz_type_parse_string(RzTypeDB *typedb, const char *code, char **error_msg) {
 	bool verbose = true;
+	// Declarations are checked against the existing callables by the parser state
+	rz_type_db_callables_lazy_load_all(typedb);
 	// Create new C parser state
 	CParserState *state = c_parser_state_new(typedb->types, typedb->callables);
 	if (!state) {
@@ -6,6 +6,7 @@
 #include <rz_vector.h>
 #include <rz_type.h>
 #include <sdb.h>
+#include "type_private.h"
 
 /**
  * Parse a type or take it from the cache if it has been parsed before already.
@@ -156,16 +157,180 @@ static bool sdb_load_callables(RzTypeDB *typedb, Sdb *sdb) {
 	return true;
 }
 
+/*
+ * Compiled sdbs, like the shipped functions-*.sdb, hold thousands of callables
+ * of which an analysis session only ever looks at a few, and building each of
+ * them means running the C parser on all of its argument types. So these are
+ * not loaded upfront: the sdb is kept open and queried in place through its
+ * cdb index, and a callable is only built the first time its name is looked up.
+ * From then on, or once it is deleted, the name is unset in all the pending
+ * sdbs so that none of them provides it again.
+ */
+
+static bool is_pending_callable(Sdb *db, const char *name) {
+	const char *kind = sdb_const_get(db, name, NULL);
+	return kind && !strcmp(kind, "func");
+}
+
+RZ_IPI void rz_type_db_callables_lazy_forget(RzTypeDB *typedb, RZ_NONNULL const char *name) {
+	rz_return_if_fail(typedb && name);
+	void **it;
+	rz_pvector_foreach (typedb->callables_lazy, it) {
+		Sdb *db = *it;
+		if (is_pending_callable(db, name)) {
+			sdb_unset(db, name, 0);
+		}
+	}
+}
+
+static void callables_lazy_load(RzTypeDB *typedb, const char *name, HtPP *type_str_cache) {
+	bool found = false;
+	ht_pp_find(typedb->callables, name, &found);
+	if (found) {
+		return;
+	}
+	RzCallable *callable = NULL;
+	size_t i = rz_pvector_len(typedb->callables_lazy);
+	while (i-- > 0) {
+		Sdb *db = rz_pvector_at(typedb->callables_lazy, i);
+		if (is_pending_callable(db, name)) {
+			callable = get_callable_type(typedb, db, name, type_str_cache);
+			break;
+		}
+	}
+	rz_type_db_callables_lazy_forget(typedb, name);
+	if (callable) {
+		ht_pp_insert(typedb->callables, callable->name, callable);
+		RZ_LOG_DEBUG("inserting the \"%s\" callable type\n", callable->name);
+	}
+}
+
+/**
+ * \brief Builds the callable \p name from the pending compiled sdbs, if any provides it
+ */
+RZ_IPI void rz_type_db_callables_lazy_load(RzTypeDB *typedb, RZ_NONNULL const char *name) {
+	rz_return_if_fail(typedb && name);
+	if (rz_pvector_empty(typedb->callables_lazy)) {
+		return;
+	}
+	HtPP *type_str_cache = ht_pp_new0();
+	if (!type_str_cache) {
+		return;
+	}
+	callables_lazy_load(typedb, name, type_str_cache);
+	ht_pp_free(type_str_cache);
+}
+
+/**
+ * \brief Builds all the callables of the pending compiled sdbs and closes them
+ */
+RZ_IPI void rz_type_db_callables_lazy_load_all(RzTypeDB *typedb) {
+	rz_return_if_fail(typedb);
+	if (rz_pvector_empty(typedb->callables_lazy)) {
+		return;
+	}
+	HtPP *type_str_cache = ht_pp_new0();
+	if (!type_str_cache) {
+		return;
+	}
+	// the most recent sdb first, the names it provides are then unset in the older ones
+	while (!rz_pvector_empty(typedb->callables_lazy)) {
+		Sdb *db = rz_pvector_tail(typedb->callables_lazy);
+		SdbKv *kv;
+		SdbListIter *iter;
+		SdbList *l = sdb_foreach_list_filter(db, filter_func, false);
+		ls_foreach (l, iter, kv) {
+			callables_lazy_load(typedb, sdbkv_key(kv), type_str_cache);
+		}
+		ls_free(l);
+		rz_pvector_pop(typedb->callables_lazy);
+		sdb_free(db);
+	}
+	ht_pp_free(type_str_cache);
+}
+
+/**
+ * \brief Appends to \p names the callables of the pending compiled sdbs, without building them
+ *
+ * \param noreturn_only Only append the callables that have the "noreturn" attribute
+ */
+RZ_IPI void rz_type_db_callables_lazy_names(RzTypeDB *typedb, RzList /*<char *>*/ *names, bool noreturn_only) {
+	rz_return_if_fail(typedb && names);
+	if (rz_pvector_empty(typedb->callables_lazy)) {
+		return;
+	}
+	// a name may be pending in several sdbs, the most recent one decides
+	HtPP *seen = ht_pp_new0();
+	if (!seen) {
+		return;
+	}
+	RzStrBuf key;
+	rz_strbuf_init(&key);
+	size_t i = rz_pvector_len(typedb->callables_lazy);
+	while (i-- > 0) {
+		Sdb *db = rz_pvector_at(typedb->callables_lazy, i);
+		SdbKv *kv;
+		SdbListIter *iter;
+		SdbList *l = sdb_foreach_list_filter(db, filter_func, false);
+		ls_foreach (l, iter, kv) {
+			const char *name = sdbkv_key(kv);
+			bool found = false;
+			ht_pp_find(seen, name, &found);
+			if (found) {
+				continue;
+			}
+			ht_pp_insert(seen, name, NULL);
+			if (noreturn_only && !sdb_bool_get(db, rz_strbuf_setf(&key, "func.%s.noreturn", name), 0)) {
+				continue;
+			}
+			rz_list_append(names, strdup(name));
+		}
+		ls_free(l);
+	}
+	rz_strbuf_fini(&key);
+	ht_pp_free(seen);
+}
+
+typedef struct {
+	Sdb *db;
+	RzList /*<char *>*/ *replaced;
+} EvictReplacedCtx;
+
+static bool evict_replaced_cb(void *user, const void *k, const void *v) {
+	EvictReplacedCtx *ctx = user;
+	if (is_pending_callable(ctx->db, k)) {
+		rz_list_append(ctx->replaced, strdup(k));
+	}
+	return true;
+}
+
 static bool sdb_load_by_path(RZ_NONNULL RzTypeDB *typedb, RZ_NONNULL const char *path) {
 	rz_return_val_if_fail(typedb && path, false);
 	if (RZ_STR_ISEMPTY(path)) {
 		return false;
 	}
 	Sdb *db = sdb_new(0, path, 0);
-	bool result = sdb_load_callables(typedb, db);
-	sdb_close(db);
-	sdb_free(db);
-	return result;
+	if (!db) {
+		return false;
+	}
+	// the callables of a newer sdb replace the ones with the same name
+	EvictReplacedCtx ctx = { db, rz_list_newf(free) };
+	if (!ctx.replaced) {
+		sdb_free(db);
+		return false;
+	}
+	ht_pp_foreach(typedb->callables, evict_replaced_cb, &ctx);
+	RzListIter *it;
+	const char *name;
+	rz_list_foreach (ctx.replaced, it, name) {
+		ht_pp_delete(typedb->callables, name);
+	}
+	rz_list_free(ctx.replaced);
+	if (!rz_pvector_push(typedb->callables_lazy, db)) {
+		sdb_free(db);
+		return false;
+	}
+	return true;
 }
 
 static bool sdb_load_from_string(RZ_NONNULL RzTypeDB *typedb, RZ_NONNULL const char *string) {
@@ -251,7 +416,8 @@ static bool export_callable_cb(void *user, const void *k, const void *v) {
 	return true;
 }
 
-static bool callable_export_sdb(RZ_NONNULL Sdb *db, RZ_NONNULL const RzTypeDB *typedb) {
+static bool callable_export_sdb(RZ_NONNULL Sdb *db, RZ_NONNULL RzTypeDB *typedb) {
+	rz_type_db_callables_lazy_load_all(typedb);
 	struct typedb_sdb tdb = { typedb, db };
 	ht_pp_foreach(typedb->callables, export_callable_cb, &tdb);
 	return true;
@@ -260,6 +426,9 @@ static bool callable_export_sdb(RZ_NONNULL Sdb *db, RZ_NONNULL const RzTypeDB *t
 /**
  * \brief Loads the callable types from compiled SDB specified by path
  *
+ * The callables are only built when they are first accessed, the
+ * SDB is kept open until then.
+ *
  * \param typedb RzTypeDB instance
  * \param path A path to the compiled SDB containing serialized types
  */
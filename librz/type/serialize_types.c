@@ -336,6 +336,8 @@ bool sdb_load_base_types(RzTypeDB *typedb, Sdb *sdb) {
 		}
 		if (tpair && tpair->type) {
 			ht_pp_update(typedb->types, tpair->type->name, tpair->type);
+			// the type may replace one of the same name
+			rz_type_db_invalidate_layouts(typedb);
 			// If the SDB provided the preferred type format then we store it
 			char *format = tpair->format ? tpair->format : NULL;
 			// Format is not always defined, e.g. for types like "void" or anonymous types
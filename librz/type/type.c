@@ -8,6 +8,8 @@
 #include <rz_type.h>
 #include <string.h>
 #include <sdb.h>
+#include <ht_pu.h>
+#include "type_private.h"
 
 static void types_ht_free(HtPPKv *kv) {
 	free(kv->key);
@@ -24,6 +26,108 @@ static void callables_ht_free(HtPPKv *kv) {
 	rz_type_callable_free(kv->value);
 }
 
+static void callables_lazy_free(void *db) {
+	sdb_free(db);
+}
+
+/*
+ * Sizes of the struct, union and typedef base types, computed once, and the
+ * same for the `pf` formats, see format.c. They depend on the target and on
+ * the other types and formats, so the cache is only used as long as neither
+ * the target bits nor the number of types or formats changed. Edits keeping
+ * these numbers are followed by rz_type_db_invalidate_layouts().
+ */
+struct rz_type_layout_cache_t {
+	HtPU /*<RzBaseType *, ut64>*/ *bitsizes;
+	HtPP /*<char *, int *>*/ *format_sizes;
+	HtPP /*<char *, char *>*/ *type_formats;
+	int bits;
+	ut8 pointer_size;
+	ut32 types_count;
+	ut32 formats_count;
+};
+
+#define LAYOUTS_STALE UT32_MAX
+
+static void layout_kv_free(HtPPKv *kv) {
+	free(kv->key);
+	free(kv->value);
+}
+
+static void layout_cache_clear(RzTypeLayoutCache *cache) {
+	ht_pu_free(cache->bitsizes);
+	ht_pp_free(cache->format_sizes);
+	ht_pp_free(cache->type_formats);
+	cache->bitsizes = ht_pu_new0();
+	cache->format_sizes = ht_pp_new(NULL, layout_kv_free, NULL);
+	cache->type_formats = ht_pp_new(NULL, layout_kv_free, NULL);
+}
+
+static RzTypeLayoutCache *layout_cache_new(void) {
+	RzTypeLayoutCache *cache = RZ_NEW0(RzTypeLayoutCache);
+	if (!cache) {
+		return NULL;
+	}
+	cache->types_count = LAYOUTS_STALE;
+	return cache;
+}
+
+static void layout_cache_free(RzTypeLayoutCache *cache) {
+	if (!cache) {
+		return;
+	}
+	ht_pu_free(cache->bitsizes);
+	ht_pp_free(cache->format_sizes);
+	ht_pp_free(cache->type_formats);
+	free(cache);
+}
+
+// the cache, emptied first if what it depends on changed
+static RzTypeLayoutCache *layout_cache_get(const RzTypeDB *typedb) {
+	RzTypeLayoutCache *cache = typedb->layouts;
+	if (!cache) {
+		return NULL;
+	}
+	ut8 pointer_size = rz_type_db_pointer_size(typedb);
+	if (cache->bits != typedb->target->bits || cache->pointer_size != pointer_size ||
+		cache->types_count != typedb->types->count || cache->formats_count != typedb->formats->count) {
+		layout_cache_clear(cache);
+		cache->bits = typedb->target->bits;
+		cache->pointer_size = pointer_size;
+		cache->types_count = typedb->types->count;
+		cache->formats_count = typedb->formats->count;
+	}
+	return cache;
+}
+
+/**
+ * \brief Sizes of the formats computed so far, by nesting level
+ */
+RZ_IPI RZ_NULLABLE HtPP *rz_type_db_format_sizes(const RzTypeDB *typedb) {
+	RzTypeLayoutCache *cache = layout_cache_get(typedb);
+	return cache ? cache->format_sizes : NULL;
+}
+
+/**
+ * \brief Formats generated so far from the base types, by type name
+ */
+RZ_IPI RZ_NULLABLE HtPP *rz_type_db_type_formats(const RzTypeDB *typedb) {
+	RzTypeLayoutCache *cache = layout_cache_get(typedb);
+	return cache ? cache->type_formats : NULL;
+}
+
+/**
+ * \brief Drop the computed sizes of the types and formats
+ *
+ * Must be called after a base type already in \p typedb is modified in place.
+ */
+RZ_API void rz_type_db_invalidate_layouts(RZ_NONNULL const RzTypeDB *typedb) {
+	rz_return_if_fail(typedb);
+	if (typedb->layouts) {
+		typedb->layouts->types_count = LAYOUTS_STALE;
+	}
+}
+
 /**
  * \brief Creates a new instance of the RzTypeDB
  *
@@ -54,19 +158,29 @@ RZ_API RzTypeDB *rz_type_db_new() {
 	if (!typedb->callables) {
 		goto rz_type_db_new_fail;
 	}
+	typedb->callables_lazy = rz_pvector_new(callables_lazy_free);
+	if (!typedb->callables_lazy) {
+		goto rz_type_db_new_fail;
+	}
 	typedb->parser = rz_type_parser_init(typedb->types, typedb->callables);
 	if (!typedb->parser) {
 		goto rz_type_db_new_fail;
 	}
+	typedb->layouts = layout_cache_new();
+	if (!typedb->layouts) {
+		goto rz_type_db_new_fail;
+	}
 	rz_io_bind_init(typedb->iob);
 	return typedb;
 
 rz_type_db_new_fail:
+	rz_type_parser_free(typedb->parser);
 	free((void *)typedb->target->default_type);
 	free(typedb->target);
 	ht_pp_free(typedb->types);
 	ht_pp_free(typedb->formats);
 	ht_pp_free(typedb->callables);
+	rz_pvector_free(typedb->callables_lazy);
 	free(typedb);
 	return NULL;
 }
@@ -77,7 +191,9 @@ rz_type_db_new_fail:
  * Destroys hashtables for RzBaseType, RzCallable, type formats.
  */
 RZ_API void rz_type_db_free(RzTypeDB *typedb) {
+	layout_cache_free(typedb->layouts);
 	rz_type_parser_free(typedb->parser);
+	rz_pvector_free(typedb->callables_lazy);
 	ht_pp_free(typedb->callables);
 	ht_pp_free(typedb->types);
 	ht_pp_free(typedb->formats);
@@ -94,12 +210,14 @@ RZ_API void rz_type_db_free(RzTypeDB *typedb) {
  * Destroys all loaded base types and callable types.
  */
 RZ_API void rz_type_db_purge(RzTypeDB *typedb) {
+	rz_pvector_clear(typedb->callables_lazy);
 	ht_pp_free(typedb->callables);
 	typedb->callables = ht_pp_new(NULL, callables_ht_free, NULL);
 	ht_pp_free(typedb->types);
 	typedb->types = ht_pp_new(NULL, types_ht_free, NULL);
 	rz_type_parser_free(typedb->parser);
 	typedb->parser = rz_type_parser_init(typedb->types, typedb->callables);
+	rz_type_db_invalidate_layouts(typedb);
 }
 
 /**
@@ -108,6 +226,7 @@ RZ_API void rz_type_db_purge(RzTypeDB *typedb) {
 RZ_API void rz_type_db_format_purge(RzTypeDB *typedb) {
 	ht_pp_free(typedb->formats);
 	typedb->formats = ht_pp_new(NULL, formats_ht_free, NULL);
+	rz_type_db_invalidate_layouts(typedb);
 }
 
 static void set_default_type(RzTypeTarget *target, int bits) {
@@ -746,6 +865,27 @@ RZ_API ut64 rz_type_db_typedef_bitsize(const RzTypeDB *typedb, RZ_NONNULL RzBase
 	return rz_type_db_get_bitsize(typedb, btype->type);
 }
 
+typedef ut64 (*BitsizeFn)(const RzTypeDB *typedb, RzBaseType *btype);
+
+// size of a struct, union or typedef, computed by fn only if not known yet
+static ut64 compound_bitsize(const RzTypeDB *typedb, RzBaseType *btype, BitsizeFn fn) {
+	RzTypeLayoutCache *cache = layout_cache_get(typedb);
+	HtPU *bitsizes = cache ? cache->bitsizes : NULL;
+	bool found = false;
+	ut64 size = bitsizes ? ht_pu_find(bitsizes, btype, &found) : 0;
+	if (found) {
+		return size;
+	}
+	size = fn(typedb, btype);
+	// the members have been sized in between, fetch the table again
+	cache = layout_cache_get(typedb);
+	bitsizes = cache ? cache->bitsizes : NULL;
+	if (bitsizes) {
+		ht_pu_insert(bitsizes, btype, size);
+	}
+	return size;
+}
+
 /**
  * \brief Returns the base type size in bits (target dependent)
  *
@@ -757,13 +897,13 @@ RZ_API ut64 rz_type_db_base_get_bitsize(const RzTypeDB *typedb, RZ_NONNULL RzBas
 	if (btype->kind == RZ_BASE_TYPE_KIND_ENUM) {
 		return rz_type_db_enum_bitsize(typedb, btype);
 	} else if (btype->kind == RZ_BASE_TYPE_KIND_STRUCT) {
-		return rz_type_db_struct_bitsize(typedb, btype);
+		return compound_bitsize(typedb, btype, rz_type_db_struct_bitsize);
 	} else if (btype->kind == RZ_BASE_TYPE_KIND_UNION) {
-		return rz_type_db_union_bitsize(typedb, btype);
+		return compound_bitsize(typedb, btype, rz_type_db_union_bitsize);
 	} else if (btype->kind == RZ_BASE_TYPE_KIND_ATOMIC) {
 		return rz_type_db_atomic_bitsize(typedb, btype);
 	} else if (btype->kind == RZ_BASE_TYPE_KIND_TYPEDEF) {
-		return rz_type_db_typedef_bitsize(typedb, btype);
+		return compound_bitsize(typedb, btype, rz_type_db_typedef_bitsize);
 	}
 	// Should not happen
 	rz_warn_if_reached();
@@ -792,16 +932,18 @@ RZ_API ut64 rz_type_db_get_bitsize(const RzTypeDB *typedb, RZ_NONNULL RzType *ty
 	if (!btype) {
 		return 0;
 	}
+	// atomic types are the most common and have their size at hand
+	if (btype->kind == RZ_BASE_TYPE_KIND_ATOMIC) {
+		return btype->size;
+	}
 	if (btype->kind == RZ_BASE_TYPE_KIND_ENUM && type->identifier.kind == RZ_TYPE_IDENTIFIER_KIND_ENUM) {
 		return rz_type_db_enum_bitsize(typedb, btype);
 	} else if (btype->kind == RZ_BASE_TYPE_KIND_STRUCT && type->identifier.kind == RZ_TYPE_IDENTIFIER_KIND_STRUCT) {
-		return rz_type_db_struct_bitsize(typedb, btype);
+		return compound_bitsize(typedb, btype, rz_type_db_struct_bitsize);
 	} else if (btype->kind == RZ_BASE_TYPE_KIND_UNION && type->identifier.kind == RZ_TYPE_IDENTIFIER_KIND_UNION) {
-		return rz_type_db_union_bitsize(typedb, btype);
-	} else if (btype->kind == RZ_BASE_TYPE_KIND_ATOMIC) {
-		return rz_type_db_atomic_bitsize(typedb, btype);
+		return compound_bitsize(typedb, btype, rz_type_db_union_bitsize);
 	} else if (btype->kind == RZ_BASE_TYPE_KIND_TYPEDEF) {
-		return rz_type_db_typedef_bitsize(typedb, btype);
+		return compound_bitsize(typedb, btype, rz_type_db_typedef_bitsize);
 	}
 	// Should not happen
 	rz_warn_if_reached();
@@ -1328,5 +1470,6 @@ RZ_API bool rz_type_db_edit_base_type(RzTypeDB *typedb, RZ_NONNULL const char *n
 	}
 	// Free now unnecessary old base type
 	rz_type_base_type_free(t);
+	rz_type_db_invalidate_layouts(typedb);
 	return true;
 }
@@ -0,0 +1,19 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#ifndef RZ_TYPE_PRIVATE_H
+#define RZ_TYPE_PRIVATE_H
+
+#include <rz_type.h>
+
+/* type.c */
+RZ_IPI RZ_NULLABLE HtPP *rz_type_db_format_sizes(const RzTypeDB *typedb);
+RZ_IPI RZ_NULLABLE HtPP *rz_type_db_type_formats(const RzTypeDB *typedb);
+
+/* serialize_functions.c */
+RZ_IPI void rz_type_db_callables_lazy_load(RzTypeDB *typedb, RZ_NONNULL const char *name);
+RZ_IPI void rz_type_db_callables_lazy_load_all(RzTypeDB *typedb);
+RZ_IPI void rz_type_db_callables_lazy_forget(RzTypeDB *typedb, RZ_NONNULL const char *name);
+RZ_IPI void rz_type_db_callables_lazy_names(RzTypeDB *typedb, RzList /*<char *>*/ *names, bool noreturn_only);
+
+#endif
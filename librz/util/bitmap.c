@@ -13,24 +13,66 @@
 
 #define BITMAP_WORD_COUNT(bit) (BITWORD_MULT(bit) >> BITWORD_BITS_SHIFT)
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BITMAP_USE_SSE2 1
+#endif
+
+// mask of the bits [from, to) of a word, with from < to <= BITWORD_BITS
+#define BITWORD_RANGE_MASK(from, to) \
+	((((to) == BITWORD_BITS) ? ~(RBitword)0 : (((RBitword)1 << (to)) - 1)) & ~(((RBitword)1 << (from)) - 1))
+
+static inline size_t bitword_popcount(RBitword w) {
+#if defined(__GNUC__)
+	return (size_t)__builtin_popcountll((unsigned long long)w);
+#else
+	size_t n = 0;
+	for (; w; n++) {
+		w &= w - 1;
+	}
+	return n;
+#endif
+}
+
+static inline size_t bitword_lowest(RBitword w) {
+#if defined(__GNUC__)
+	return (size_t)__builtin_ctzll((unsigned long long)w);
+#else
+	size_t i = 0;
+	while (!(w & 1)) {
+		w >>= 1;
+		i++;
+	}
+	return i;
+#endif
+}
+
 RZ_API RzBitmap *rz_bitmap_new(size_t len) {
 	RzBitmap *b = RZ_NEW0(RzBitmap);
 	if (!b) {
 		return NULL;
 	}
 	b->length = len;
-	b->bitmap = calloc(BITMAP_WORD_COUNT(len), sizeof(RBitword));
+	b->bitmap = calloc(RZ_MAX(BITMAP_WORD_COUNT(len), 1), sizeof(RBitword));
+	if (!b->bitmap) {
+		free(b);
+		return NULL;
+	}
 	return b;
 }
 
 RZ_API void rz_bitmap_set_bytes(RzBitmap *b, const ut8 *buf, int len) {
-	if (b->length < len) {
-		len = b->length;
+	size_t size = BITMAP_WORD_COUNT(b->length) * sizeof(RBitword);
+	if (len < 0) {
+		return;
 	}
-	memcpy(b->bitmap, buf, len);
+	memcpy(b->bitmap, buf, RZ_MIN((size_t)len, size));
 }
 
 RZ_API void rz_bitmap_free(RzBitmap *b) {
+	if (!b) {
+		return;
+	}
 	free(b->bitmap);
 	free(b);
 }
@@ -56,3 +98,140 @@ RZ_API int rz_bitmap_test(RzBitmap *b, size_t bit) {
 	}
 	return -1;
 }
+
+static void bitmap_range_apply(RzBitmap *b, size_t from, size_t to, bool set) {
+	to = RZ_MIN(to, b->length);
+	if (from >= to) {
+		return;
+	}
+	size_t first = from >> BITWORD_BITS_SHIFT;
+	size_t last = (to - 1) >> BITWORD_BITS_SHIFT;
+	size_t lo = from & BITWORD_BITS_MASK;
+	size_t hi = ((to - 1) & BITWORD_BITS_MASK) + 1;
+	if (first == last) {
+		RBitword mask = BITWORD_RANGE_MASK(lo, hi);
+		b->bitmap[first] = set ? b->bitmap[first] | mask : b->bitmap[first] & ~mask;
+		return;
+	}
+	RBitword head = BITWORD_RANGE_MASK(lo, BITWORD_BITS);
+	RBitword tail = BITWORD_RANGE_MASK(0, hi);
+	b->bitmap[first] = set ? b->bitmap[first] | head : b->bitmap[first] & ~head;
+	memset(b->bitmap + first + 1, set ? 0xff : 0, (last - first - 1) * sizeof(RBitword));
+	b->bitmap[last] = set ? b->bitmap[last] | tail : b->bitmap[last] & ~tail;
+}
+
+/**
+ * \brief Sets the bits [\p from, \p to), clamped to the length of the bitmap
+ */
+RZ_API void rz_bitmap_set_range(RZ_NONNULL RzBitmap *b, size_t from, size_t to) {
+	rz_return_if_fail(b);
+	bitmap_range_apply(b, from, to, true);
+}
+
+/**
+ * \brief Clears the bits [\p from, \p to), clamped to the length of the bitmap
+ */
+RZ_API void rz_bitmap_unset_range(RZ_NONNULL RzBitmap *b, size_t from, size_t to) {
+	rz_return_if_fail(b);
+	bitmap_range_apply(b, from, to, false);
+}
+
+/**
+ * \brief Counts the bits set in [\p from, \p to), clamped to the length of the bitmap
+ */
+RZ_API size_t rz_bitmap_count(RZ_NONNULL const RzBitmap *b, size_t from, size_t to) {
+	rz_return_val_if_fail(b, 0);
+	to = RZ_MIN(to, b->length);
+	if (from >= to) {
+		return 0;
+	}
+	size_t first = from >> BITWORD_BITS_SHIFT;
+	size_t last = (to - 1) >> BITWORD_BITS_SHIFT;
+	size_t lo = from & BITWORD_BITS_MASK;
+	size_t hi = ((to - 1) & BITWORD_BITS_MASK) + 1;
+	if (first == last) {
+		return bitword_popcount(b->bitmap[first] & BITWORD_RANGE_MASK(lo, hi));
+	}
+	size_t n = bitword_popcount(b->bitmap[first] & BITWORD_RANGE_MASK(lo, BITWORD_BITS));
+	for (size_t i = first + 1; i < last; i++) {
+		n += bitword_popcount(b->bitmap[i]);
+	}
+	return n + bitword_popcount(b->bitmap[last] & BITWORD_RANGE_MASK(0, hi));
+}
+
+static size_t bitmap_next(const RzBitmap *b, size_t from, RBitword flip) {
+	if (from >= b->length) {
+		return b->length;
+	}
+	size_t i = from >> BITWORD_BITS_SHIFT;
+	size_t words = BITMAP_WORD_COUNT(b->length);
+	// the bits before from are masked out of the first word
+	RBitword w = (b->bitmap[i] ^ flip) & BITWORD_RANGE_MASK(from & BITWORD_BITS_MASK, BITWORD_BITS);
+	while (!w) {
+		if (++i >= words) {
+			return b->length;
+		}
+		w = b->bitmap[i] ^ flip;
+	}
+	size_t bit = (i << BITWORD_BITS_SHIFT) + bitword_lowest(w);
+	return RZ_MIN(bit, b->length);
+}
+
+/**
+ * \brief Finds the first bit set at or after \p from
+ *
+ * \return the index of the bit, or the length of the bitmap if there is none
+ */
+RZ_API size_t rz_bitmap_next_set(RZ_NONNULL const RzBitmap *b, size_t from) {
+	rz_return_val_if_fail(b, 0);
+	return bitmap_next(b, from, 0);
+}
+
+/**
+ * \brief Finds the first bit not set at or after \p from
+ *
+ * \return the index of the bit, or the length of the bitmap if there is none
+ */
+RZ_API size_t rz_bitmap_next_unset(RZ_NONNULL const RzBitmap *b, size_t from) {
+	rz_return_val_if_fail(b, 0);
+	return bitmap_next(b, from, ~(RBitword)0);
+}
+
+static bool bitmap_combine(RzBitmap *dst, const RzBitmap *src, bool and) {
+	if (dst->length != src->length) {
+		return false;
+	}
+	size_t words = BITMAP_WORD_COUNT(dst->length);
+	size_t i = 0;
+#if BITMAP_USE_SSE2
+	for (; i + 16 / sizeof(RBitword) <= words; i += 16 / sizeof(RBitword)) {
+		__m128i d = _mm_loadu_si128((const __m128i *)(dst->bitmap + i));
+		__m128i s = _mm_loadu_si128((const __m128i *)(src->bitmap + i));
+		_mm_storeu_si128((__m128i *)(dst->bitmap + i), and ? _mm_and_si128(d, s) : _mm_or_si128(d, s));
+	}
+#endif
+	for (; i < words; i++) {
+		dst->bitmap[i] = and ? dst->bitmap[i] & src->bitmap[i] : dst->bitmap[i] | src->bitmap[i];
+	}
+	return true;
+}
+
+/**
+ * \brief Sets in \p dst the bits set in \p src, both having the same length
+ *
+ * \return false if the lengths differ, \p dst is then left untouched
+ */
+RZ_API bool rz_bitmap_or(RZ_NONNULL RzBitmap *dst, RZ_NONNULL const RzBitmap *src) {
+	rz_return_val_if_fail(dst && src, false);
+	return bitmap_combine(dst, src, false);
+}
+
+/**
+ * \brief Clears in \p dst the bits not set in \p src, both having the same length
+ *
+ * \return false if the lengths differ, \p dst is then left untouched
+ */
+RZ_API bool rz_bitmap_and(RZ_NONNULL RzBitmap *dst, RZ_NONNULL const RzBitmap *src) {
+	rz_return_val_if_fail(dst && src, false);
+	return bitmap_combine(dst, src, true);
+}
@@ -8,6 +8,9 @@
 #define NELEM(N, ELEMPER) ((N + (ELEMPER)-1) / (ELEMPER))
 #define BV_ELEM_SIZE      8U
 
+/// mask of all the valid bits of bitvectors <= 64 bits stored in bits.small_u
+#define bv_small_mask(len) (UT64_MAX >> (64 - (len)))
+
 // optimization for reversing 8 bits which uses 32 bits
 // https://graphics.stanford.edu/~seander/bithacks.html#ReverseByteWith32Bits
 #define reverse_byte(x) ((((x)*0x0802LU & 0x22110LU) | ((x)*0x8020LU & 0x88440LU)) * 0x10101LU >> 16)
@@ -410,7 +413,8 @@ RZ_API bool rz_bv_toggle(RZ_NONNULL RzBitVector *bv, ut32 pos) {
 RZ_API bool rz_bv_toggle_all(RZ_NONNULL RzBitVector *bv) {
 	rz_return_val_if_fail(bv, false);
 	if (bv->len <= 64) {
-		bv->bits.small_u = ~(bv->bits.small_u);
+		bv->bits.small_u = ~(bv->bits.small_u) & bv_small_mask(bv->len);
+		return true;
 	}
 
 	rz_return_val_if_fail(bv->bits.large_a, false);
@@ -479,6 +483,12 @@ RZ_API bool rz_bv_lshift_fill(RZ_NONNULL RzBitVector *bv, ut32 size, bool fill_b
 		return true;
 	}
 
+	if (bv->len <= 64) {
+		ut64 fill = fill_bit ? bv_small_mask(size) : 0;
+		bv->bits.small_u = ((bv->bits.small_u << size) | fill) & bv_small_mask(bv->len);
+		return true;
+	}
+
 	RzBitVector tmp;
 	if (!rz_bv_init(&tmp, bv->len)) {
 		return false;
@@ -518,6 +528,13 @@ RZ_API bool rz_bv_rshift_fill(RZ_NONNULL RzBitVector *bv, ut32 size, bool fill_b
 		return true;
 	}
 
+	if (bv->len <= 64) {
+		ut64 mask = bv_small_mask(bv->len);
+		ut64 fill = fill_bit ? mask & ~(mask >> size) : 0;
+		bv->bits.small_u = (bv->bits.small_u >> size) | fill;
+		return true;
+	}
+
 	RzBitVector tmp;
 	if (!rz_bv_init(&tmp, bv->len)) {
 		return false;
@@ -652,6 +669,10 @@ RZ_API RZ_OWN RzBitVector *rz_bv_complement_1(RZ_NONNULL RzBitVector *bv) {
 RZ_API RZ_OWN RzBitVector *rz_bv_complement_2(RZ_NONNULL RzBitVector *bv) {
 	rz_return_val_if_fail(bv, NULL);
 
+	if (bv->len <= 64) {
+		return rz_bv_new_from_ut64(bv->len, -bv->bits.small_u);
+	}
+
 	// from right side to left, find the 1st 1 bit
 	// flip/toggle every bit before it
 	RzBitVector *ret = rz_bv_dup(bv);
@@ -672,6 +693,17 @@ RZ_API RZ_OWN RzBitVector *rz_bv_complement_2(RZ_NONNULL RzBitVector *bv) {
 	return ret;
 }
 
+/**
+ * (x + y) mod 2^len for bitvectors <= 64 bits, which fit into a native ut64
+ */
+static RzBitVector *bv_small_add(ut32 len, ut64 x, ut64 y, RZ_NULLABLE bool *carry) {
+	ut64 sum = x + y;
+	if (carry) {
+		*carry = len == 64 ? sum < x : (sum >> len) & 1;
+	}
+	return rz_bv_new_from_ut64(len, sum);
+}
+
 /**
  * Result of (x + y) mod 2^length
  * Both operands must have the same length.
@@ -688,6 +720,10 @@ RZ_API RZ_OWN RzBitVector *rz_bv_add(RZ_NONNULL RzBitVector *x, RZ_NONNULL RzBit
 		return NULL;
 	}
 
+	if (x->len <= 64) {
+		return bv_small_add(x->len, x->bits.small_u, y->bits.small_u, carry);
+	}
+
 	bool a = false, b = false, _carry = false;
 	RzBitVector *ret = rz_bv_new(x->len);
 
@@ -715,6 +751,11 @@ RZ_API RZ_OWN RzBitVector *rz_bv_add(RZ_NONNULL RzBitVector *x, RZ_NONNULL RzBit
 RZ_API RZ_OWN RzBitVector *rz_bv_sub(RZ_NONNULL RzBitVector *x, RZ_NONNULL RzBitVector *y, RZ_NULLABLE bool *borrow) {
 	rz_return_val_if_fail(x && y, NULL);
 
+	if (x->len == y->len && x->len <= 64) {
+		// same as adding the 2's complement below, including the carry out
+		return bv_small_add(x->len, x->bits.small_u, -y->bits.small_u & bv_small_mask(y->len), borrow);
+	}
+
 	RzBitVector *ret;
 	RzBitVector *neg_y;
 
@@ -742,6 +783,10 @@ RZ_API RZ_OWN RzBitVector *rz_bv_mul(RZ_NONNULL RzBitVector *x, RZ_NONNULL RzBit
 		return NULL;
 	}
 
+	if (x->len <= 64) {
+		return rz_bv_new_from_ut64(x->len, x->bits.small_u * y->bits.small_u);
+	}
+
 	if (!rz_bv_init(&dump, x->len)) {
 		return NULL;
 	}
@@ -780,6 +825,10 @@ int bv_unsigned_cmp(RZ_NONNULL RzBitVector *x, RZ_NONNULL RzBitVector *y) {
 		return 0;
 	}
 
+	if (x->len <= 64) {
+		return x->bits.small_u < y->bits.small_u ? -1 : (x->bits.small_u > y->bits.small_u);
+	}
+
 	ut32 len = x->len;
 	int pos;
 	bool x_bit, y_bit;
@@ -1091,6 +1140,10 @@ RZ_API bool rz_bv_cmp(RZ_NONNULL RzBitVector *x, RZ_NONNULL RzBitVector *y) {
 		return true;
 	}
 
+	if (x->len <= 64) {
+		return x->bits.small_u != y->bits.small_u;
+	}
+
 	for (ut32 i = 0; i < x->len; ++i) {
 		if (rz_bv_get(x, i) != rz_bv_get(y, i)) {
 			return true;
@@ -1107,6 +1160,13 @@ RZ_API bool rz_bv_cmp(RZ_NONNULL RzBitVector *x, RZ_NONNULL RzBitVector *y) {
 RZ_API ut32 rz_bv_clz(RZ_NONNULL RzBitVector *bv) {
 	rz_return_val_if_fail(bv, 0);
 	ut32 r = 0;
+	if (bv->len <= 64) {
+		ut64 v = bv->bits.small_u;
+		for (ut64 top = 1ull << (bv->len - 1); top && !(v & top); top >>= 1) {
+			r++;
+		}
+		return r;
+	}
 	for (ut32 i = rz_bv_len(bv); i; i--) {
 		if (rz_bv_get(bv, i - 1)) {
 			break;
@@ -1123,6 +1183,16 @@ RZ_API ut32 rz_bv_clz(RZ_NONNULL RzBitVector *bv) {
 RZ_API ut32 rz_bv_ctz(RZ_NONNULL RzBitVector *bv) {
 	rz_return_val_if_fail(bv, 0);
 	ut32 r = 0;
+	if (bv->len <= 64) {
+		ut64 v = bv->bits.small_u;
+		if (!v) {
+			return bv->len;
+		}
+		for (; !(v & 1); v >>= 1) {
+			r++;
+		}
+		return r;
+	}
 	for (ut32 i = 0; i < rz_bv_len(bv); i++) {
 		if (rz_bv_get(bv, i)) {
 			break;
@@ -1265,7 +1335,8 @@ RZ_API bool rz_bv_set_from_st64(RZ_NONNULL RzBitVector *bv, st64 value) {
 RZ_API void rz_bv_set_from_bytes_le(RZ_NONNULL RzBitVector *bv, RZ_IN RZ_NONNULL const ut8 *buf, ut32 bit_offset, ut32 size) {
 	rz_return_if_fail(buf && size);
 	size = RZ_MIN(size, bv->len);
-	if (!bit_offset && size <= 64) {
+	if (!(bit_offset & 7) && size <= 64) {
+		buf += bit_offset >> 3;
 		ut64 val = 0;
 		for (ut32 i = 0; i < (size + 7) / 8; i++) {
 			val |= (ut64)buf[i] << (i * 8);
@@ -1274,6 +1345,17 @@ RZ_API void rz_bv_set_from_bytes_le(RZ_NONNULL RzBitVector *bv, RZ_IN RZ_NONNULL
 		rz_bv_set_from_ut64(bv, val);
 		return;
 	}
+	if (!(bit_offset & 7) && bv->len > 64) {
+		// byte aligned, large_a has the same layout as buf
+		buf += bit_offset >> 3;
+		ut32 bytes = size >> 3;
+		memcpy(bv->bits.large_a, buf, bytes);
+		memset(bv->bits.large_a + bytes, 0, bv->_elem_len - bytes);
+		if (size & 7) {
+			bv->bits.large_a[bytes] = buf[bytes] & ((1 << (size & 7)) - 1);
+		}
+		return;
+	}
 	for (ut32 i = 0; i < bv->len; i++) {
 		bool bit = false;
 		if (i < size) {
@@ -1296,6 +1378,23 @@ RZ_API void rz_bv_set_from_bytes_le(RZ_NONNULL RzBitVector *bv, RZ_IN RZ_NONNULL
 RZ_API void rz_bv_set_from_bytes_be(RZ_NONNULL RzBitVector *bv, RZ_IN RZ_NONNULL const ut8 *buf, ut32 bit_offset, ut32 size) {
 	rz_return_if_fail(buf && size);
 	size = RZ_MIN(size, bv->len);
+	if (!(bit_offset & 7) && !(size & 7) && size == bv->len) {
+		// whole bytes, the first byte of buf becomes the most significant one
+		buf += bit_offset >> 3;
+		ut32 bytes = size >> 3;
+		if (size <= 64) {
+			ut64 val = 0;
+			for (ut32 i = 0; i < bytes; i++) {
+				val = (val << 8) | buf[i];
+			}
+			rz_bv_set_from_ut64(bv, val);
+			return;
+		}
+		for (ut32 i = 0; i < bytes; i++) {
+			bv->bits.large_a[bytes - 1 - i] = buf[i];
+		}
+		return;
+	}
 	// upper bits goes always in the upper bit of the bitv
 	for (ut32 i = 0; i < bv->len; i++) {
 		bool bit = false;
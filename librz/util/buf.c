@@ -14,6 +14,8 @@ typedef enum {
 	RZ_BUFFER_MMAP,
 	RZ_BUFFER_SPARSE,
 	RZ_BUFFER_REF,
+	RZ_BUFFER_COW,
+	RZ_BUFFER_INFLATE,
 } RzBufferType;
 
 #include "buf_file.c"
@@ -23,6 +25,10 @@ typedef enum {
 #include "buf_io_fd.c"
 #include "buf_io.c"
 #include "buf_ref.c"
+#include "buf_cow.c"
+#if HAVE_ZLIB
+#include "buf_inflate.c"
+#endif
 
 #define GET_STRING_BUFFER_SIZE 32
 
@@ -266,6 +272,14 @@ static RzBuffer *new_buffer(RzBufferType type, void *user) {
 	case RZ_BUFFER_REF:
 		methods = &buffer_ref_methods;
 		break;
+	case RZ_BUFFER_COW:
+		methods = &buffer_cow_methods;
+		break;
+#if HAVE_ZLIB
+	case RZ_BUFFER_INFLATE:
+		methods = &buffer_inflate_methods;
+		break;
+#endif
 	default:
 		rz_warn_if_reached();
 		return NULL;
@@ -434,6 +448,58 @@ RZ_API RZ_OWN RzBuffer *rz_buf_new_sparse_overlay(RzBuffer *b, RzBufferSparseWri
 	return new_buffer(RZ_BUFFER_SPARSE, &cfg);
 }
 
+/**
+ * \brief Creates a copy-on-write buffer on top of another buffer.
+ * \param b The base buffer, which is only read from until rz_buf_cow_commit().
+ * \return Return the new allocated buffer.
+ *
+ * The function creates a new allocated buffer using the RZ_BUFFER_COW back end.
+ * Writes are kept in pages of RZ_BUF_COW_PAGE_SIZE bytes which are copied
+ * from \p b on the first write, so the writes themselves never touch \p b.
+ * Snapshots of the contents can be taken cheaply with rz_buf_cow_snapshot().
+ */
+RZ_API RZ_OWN RzBuffer *rz_buf_new_cow(RZ_NONNULL RzBuffer *b) {
+	rz_return_val_if_fail(b, NULL);
+
+	return new_buffer(RZ_BUFFER_COW, b);
+}
+
+/**
+ * \brief Creates a read-only buffer of the decompressed contents of a zlib, gzip or raw deflate stream.
+ * \param b The buffer holding the compressed stream, which must not change while in use.
+ * \param wbits The window size logarithm and header format, as for inflateInit2() and rz_inflatew().
+ * \return Return the new allocated buffer, or NULL if \p b is not a valid stream.
+ *
+ * The function creates a new allocated buffer using the RZ_BUFFER_INFLATE back end.
+ * The stream is decompressed once on creation to learn its size, keeping a
+ * checkpoint every few MiB, and then again on demand from the checkpoint
+ * nearest to each read. Only a bounded part of the decompressed data is
+ * ever held in memory.
+ */
+RZ_API RZ_OWN RzBuffer *rz_buf_new_inflatew(RZ_NONNULL RzBuffer *b, int wbits) {
+	rz_return_val_if_fail(b, NULL);
+#if HAVE_ZLIB
+	struct buf_inflate_user u = { 0 };
+
+	u.src = b;
+	u.wbits = wbits;
+
+	return new_buffer(RZ_BUFFER_INFLATE, &u);
+#else
+	return NULL;
+#endif
+}
+
+/**
+ * \brief Creates a read-only buffer of the decompressed contents of a zlib or gzip stream, detecting which one it is.
+ * \see rz_buf_new_inflatew()
+ */
+RZ_API RZ_OWN RzBuffer *rz_buf_new_inflate(RZ_NONNULL RzBuffer *b) {
+	rz_return_val_if_fail(b, NULL);
+	// MAX_WBITS, plus 32 to accept both headers
+	return rz_buf_new_inflatew(b, 15 + 32);
+}
+
 /**
  * \brief Creates a new buffer from a source buffer.
  * \param b The source buffer used to create the sub buffer.
@@ -1290,6 +1356,26 @@ RZ_DEPRECATE RZ_API RZ_BORROW ut8 *rz_buf_data(RZ_NONNULL RzBuffer *b, RZ_NONNUL
 	return get_whole_buf(b, size);
 }
 
+/**
+ * \brief Get a pointer to the buffer contents at \p addr, without copying them
+ *
+ * Only buffers backed by contiguous memory support this: bytes and mmap
+ * buffers, slices of those and io buffers on top of mmap'd files. The
+ * returned pointer is valid until the buffer is written, resized or freed.
+ *
+ * \param b Buffer to borrow the data from
+ * \param addr Address of the first byte
+ * \param len In: number of bytes wanted. Out: number of bytes available at the returned pointer, never more than requested
+ * \return Pointer to the data or NULL if it can't be borrowed, in which case rz_buf_read_at() must be used
+ */
+RZ_API RZ_BORROW const ut8 *rz_buf_borrow_at(RZ_NONNULL RzBuffer *b, ut64 addr, RZ_NONNULL RZ_INOUT ut64 *len) {
+	rz_return_val_if_fail(b && b->methods && len, NULL);
+	if (!*len || !b->methods->borrow) {
+		return NULL;
+	}
+	return b->methods->borrow(b, addr, len);
+}
+
 /**
  * \brief Scans buffer linearly in chunks calling \p fwd_scan for each chunk.
  *
@@ -1305,6 +1391,11 @@ RZ_API ut64 rz_buf_fwd_scan(RZ_NONNULL RzBuffer *b, ut64 start, ut64 amount, RZ_
 	if (!amount) {
 		return 0;
 	}
+	ut64 borrowed = amount;
+	const ut8 *data = rz_buf_borrow_at(b, start, &borrowed);
+	if (data && (borrowed == amount || borrowed == rz_buf_size(b) - start)) {
+		return fwd_scan(data, borrowed, user);
+	}
 	if (b->methods->get_whole_buf) {
 		ut64 sz;
 		const ut8 *buf = b->methods->get_whole_buf(b, &sz);
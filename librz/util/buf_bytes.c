@@ -115,6 +115,15 @@ static ut8 *buf_bytes_get_whole_buf(RzBuffer *b, ut64 *sz) {
 	return priv->buf;
 }
 
+static const ut8 *buf_bytes_borrow(RzBuffer *b, ut64 addr, ut64 *len) {
+	struct buf_bytes_priv *priv = get_priv_bytes(b);
+	if (addr >= priv->length) {
+		return NULL;
+	}
+	*len = RZ_MIN(*len, priv->length - addr);
+	return priv->buf + addr;
+}
+
 static const RzBufferMethods buffer_bytes_methods = {
 	.init = buf_bytes_init,
 	.fini = buf_bytes_fini,
@@ -123,5 +132,6 @@ static const RzBufferMethods buffer_bytes_methods = {
 	.get_size = buf_bytes_get_size,
 	.resize = buf_bytes_resize,
 	.seek = buf_bytes_seek,
-	.get_whole_buf = buf_bytes_get_whole_buf
+	.get_whole_buf = buf_bytes_get_whole_buf,
+	.borrow = buf_bytes_borrow
 };
@@ -0,0 +1,352 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+
+/**
+ * A page of the cow buffer.
+ * Pages are shared between the buffer and its snapshots until one of them writes into it.
+ */
+typedef struct buf_cow_page_t {
+	int refs; ///< number of page tables (buffer or snapshots) holding this page
+	ut8 data[RZ_BUF_COW_PAGE_SIZE];
+} CowPage;
+
+typedef struct buf_cow_priv {
+	RzBuffer *base; ///< unpopulated pages are taken from here
+	HtUP /*<ut64, CowPage *>*/ *pages; ///< page address => page
+	ut64 written_end; ///< end of the highest write, for the size
+	ut64 offset;
+} CowPriv;
+
+struct rz_buf_cow_snapshot_t {
+	HtUP /*<ut64, CowPage *>*/ *pages;
+	ut64 written_end;
+};
+
+#define PAGE_MASK ((ut64)RZ_BUF_COW_PAGE_SIZE - 1)
+
+static void page_unref(CowPage *page) {
+	if (page && !--page->refs) {
+		free(page);
+	}
+}
+
+static void page_kv_free(HtUPKv *kv) {
+	page_unref(kv->value);
+}
+
+static HtUP *pages_new(void) {
+	return ht_up_new(NULL, page_kv_free, NULL);
+}
+
+static bool page_share_cb(void *user, const ut64 k, const void *v) {
+	CowPage *page = (CowPage *)v;
+	if (!ht_up_insert(user, k, page)) {
+		return false;
+	}
+	page->refs++;
+	return true;
+}
+
+/**
+ * \return a new page table with the same pages as \p pages
+ */
+static HtUP *pages_share(HtUP *pages) {
+	HtUP *r = pages_new();
+	if (!r) {
+		return NULL;
+	}
+	if (pages) {
+		ht_up_foreach(pages, page_share_cb, r);
+		if (r->count != pages->count) {
+			ht_up_free(r);
+			return NULL;
+		}
+	}
+	return r;
+}
+
+/**
+ * Get the page at \p addr for writing, populating it from the base or
+ * unsharing it from snapshots first if necessary.
+ */
+static CowPage *page_writable(CowPriv *priv, ut64 addr) {
+	CowPage *page = ht_up_find(priv->pages, addr, NULL);
+	if (page && page->refs == 1) {
+		return page;
+	}
+	CowPage *copy = RZ_NEW(CowPage);
+	if (!copy) {
+		return NULL;
+	}
+	copy->refs = 1;
+	if (page) {
+		memcpy(copy->data, page->data, sizeof(copy->data));
+	} else {
+		memset(copy->data, 0xff, sizeof(copy->data));
+		rz_buf_read_at(priv->base, addr, copy->data, sizeof(copy->data));
+	}
+	// drops the reference to the shared page, if any
+	if (!ht_up_update(priv->pages, addr, copy)) {
+		free(copy);
+		return NULL;
+	}
+	return copy;
+}
+
+static inline CowPriv *get_priv_cow(RzBuffer *b) {
+	CowPriv *priv = b->priv;
+	rz_warn_if_fail(priv);
+	return priv;
+}
+
+static bool buf_cow_init(RzBuffer *b, const void *user) {
+	rz_return_val_if_fail(user, false);
+	CowPriv *priv = RZ_NEW0(CowPriv);
+	if (!priv) {
+		return false;
+	}
+	priv->pages = pages_new();
+	if (!priv->pages) {
+		free(priv);
+		return false;
+	}
+	priv->base = rz_buf_ref((RzBuffer *)user);
+	b->priv = priv;
+	return true;
+}
+
+static bool buf_cow_fini(RzBuffer *b) {
+	CowPriv *priv = get_priv_cow(b);
+	ht_up_free(priv->pages);
+	rz_buf_free(priv->base);
+	RZ_FREE(b->priv);
+	return true;
+}
+
+static ut64 buf_cow_size(RzBuffer *b) {
+	CowPriv *priv = get_priv_cow(b);
+	return RZ_MAX(rz_buf_size(priv->base), priv->written_end);
+}
+
+static st64 buf_cow_read(RzBuffer *b, ut8 *buf, ut64 len) {
+	CowPriv *priv = get_priv_cow(b);
+	if (priv->offset + len < priv->offset) {
+		len = UT64_MAX - priv->offset;
+	}
+	// consecutive unpopulated pages are read from the base in one go
+	ut64 base_from = priv->offset;
+	ut64 off = priv->offset;
+	ut64 end = priv->offset + len;
+	while (off < end) {
+		ut64 page_addr = off & ~PAGE_MASK;
+		ut64 in_page = RZ_MIN(end - off, RZ_BUF_COW_PAGE_SIZE - (off - page_addr));
+		CowPage *page = ht_up_find(priv->pages, page_addr, NULL);
+		if (page) {
+			if (base_from < off) {
+				rz_buf_read_at(priv->base, base_from, buf + (base_from - priv->offset), off - base_from);
+			}
+			memcpy(buf + (off - priv->offset), page->data + (off - page_addr), in_page);
+			base_from = off + in_page;
+		}
+		off += in_page;
+	}
+	if (base_from < end) {
+		rz_buf_read_at(priv->base, base_from, buf + (base_from - priv->offset), end - base_from);
+	}
+	priv->offset = end;
+	return len;
+}
+
+static st64 buf_cow_write(RzBuffer *b, const ut8 *buf, ut64 len) {
+	CowPriv *priv = get_priv_cow(b);
+	if (priv->offset + len < priv->offset) {
+		len = UT64_MAX - priv->offset;
+	}
+	ut64 off = priv->offset;
+	ut64 end = priv->offset + len;
+	while (off < end) {
+		ut64 page_addr = off & ~PAGE_MASK;
+		ut64 in_page = RZ_MIN(end - off, RZ_BUF_COW_PAGE_SIZE - (off - page_addr));
+		CowPage *page = page_writable(priv, page_addr);
+		if (!page) {
+			break;
+		}
+		memcpy(page->data + (off - page_addr), buf + (off - priv->offset), in_page);
+		off += in_page;
+	}
+	st64 r = off - priv->offset;
+	if (!r && len) {
+		return -1;
+	}
+	priv->offset = off;
+	if (off > priv->written_end) {
+		priv->written_end = off;
+	}
+	return r;
+}
+
+static st64 buf_cow_seek(RzBuffer *b, st64 addr, int whence) {
+	CowPriv *priv = get_priv_cow(b);
+	priv->offset = rz_seek_offset(priv->offset, buf_cow_size(b), addr, whence);
+	return RZ_MIN(priv->offset, ST64_MAX);
+}
+
+static const RzBufferMethods buffer_cow_methods = {
+	.init = buf_cow_init,
+	.fini = buf_cow_fini,
+	.read = buf_cow_read,
+	.write = buf_cow_write,
+	.get_size = buf_cow_size,
+	.seek = buf_cow_seek
+};
+
+static int addr_cmp(const void *a, const void *b) {
+	ut64 x = *(const ut64 *)a;
+	ut64 y = *(const ut64 *)b;
+	return RZ_NUM_CMP(x, y);
+}
+
+static bool page_addr_cb(void *user, const ut64 k, const void *v) {
+	return !!rz_vector_push(user, (void *)&k);
+}
+
+/**
+ * \brief Only for cow RzBuffers, get the addresses of all populated pages
+ * \return vector of ut64 page addresses in ascending order
+ */
+RZ_API RZ_OWN RzVector /*<ut64>*/ *rz_buf_cow_get_pages(RZ_NONNULL RzBuffer *b) {
+	rz_return_val_if_fail(b, NULL);
+	RzVector *r = rz_vector_new(sizeof(ut64), NULL, NULL);
+	if (!r || b->methods != &buffer_cow_methods) {
+		return r;
+	}
+	CowPriv *priv = get_priv_cow(b);
+	rz_vector_reserve(r, priv->pages->count);
+	ht_up_foreach(priv->pages, page_addr_cb, r);
+	rz_vector_sort(r, addr_cmp, false);
+	return r;
+}
+
+/**
+ * \brief Only for cow RzBuffers, write all populated pages into the base buffer
+ *
+ * Only the bytes that differ from the base are written. Pages that were
+ * written successfully are dropped afterwards, the others are kept.
+ *
+ * \return whether all pages could be written
+ */
+RZ_API bool rz_buf_cow_commit(RZ_NONNULL RzBuffer *b) {
+	rz_return_val_if_fail(b, false);
+	if (b->methods != &buffer_cow_methods) {
+		return false;
+	}
+	CowPriv *priv = get_priv_cow(b);
+	RzVector *addrs = rz_buf_cow_get_pages(b);
+	if (!addrs) {
+		return false;
+	}
+	bool succ = true;
+	ut8 cur[RZ_BUF_COW_PAGE_SIZE];
+	ut64 *addr;
+	rz_vector_foreach (addrs, addr) {
+		CowPage *page = ht_up_find(priv->pages, *addr, NULL);
+		memset(cur, 0xff, sizeof(cur));
+		rz_buf_read_at(priv->base, *addr, cur, sizeof(cur));
+		bool page_succ = true;
+		for (size_t i = 0; i < RZ_BUF_COW_PAGE_SIZE;) {
+			if (page->data[i] == cur[i]) {
+				i++;
+				continue;
+			}
+			size_t j = i + 1;
+			while (j < RZ_BUF_COW_PAGE_SIZE && page->data[j] != cur[j]) {
+				j++;
+			}
+			if (rz_buf_write_at(priv->base, *addr + i, page->data + i, j - i) != (st64)(j - i)) {
+				page_succ = false;
+			}
+			i = j;
+		}
+		if (page_succ) {
+			ht_up_delete(priv->pages, *addr);
+		} else {
+			succ = false;
+		}
+	}
+	rz_vector_free(addrs);
+	return succ;
+}
+
+/**
+ * \brief Only for cow RzBuffers, drop all populated pages, so the contents are the base's again
+ */
+RZ_API void rz_buf_cow_reset(RZ_NONNULL RzBuffer *b) {
+	rz_return_if_fail(b);
+	if (b->methods != &buffer_cow_methods) {
+		return;
+	}
+	CowPriv *priv = get_priv_cow(b);
+	HtUP *pages = pages_new();
+	if (!pages) {
+		return;
+	}
+	ht_up_free(priv->pages);
+	priv->pages = pages;
+	priv->written_end = 0;
+}
+
+/**
+ * \brief Only for cow RzBuffers, remember the current contents for rz_buf_cow_restore()
+ *
+ * The snapshot shares all pages with the buffer, so this only costs a copy of the page table.
+ * Contents of the base that were never written in the cow buffer are not part of the snapshot.
+ */
+RZ_API RZ_OWN RzBufferCowSnapshot *rz_buf_cow_snapshot(RZ_NONNULL RzBuffer *b) {
+	rz_return_val_if_fail(b, NULL);
+	if (b->methods != &buffer_cow_methods) {
+		return NULL;
+	}
+	CowPriv *priv = get_priv_cow(b);
+	RzBufferCowSnapshot *snap = RZ_NEW(RzBufferCowSnapshot);
+	if (!snap) {
+		return NULL;
+	}
+	snap->pages = pages_share(priv->pages);
+	if (!snap->pages) {
+		free(snap);
+		return NULL;
+	}
+	snap->written_end = priv->written_end;
+	return snap;
+}
+
+/**
+ * \brief Only for cow RzBuffers, go back to the contents at the time \p snap was taken
+ *
+ * \p snap stays valid and can be restored again later.
+ */
+RZ_API bool rz_buf_cow_restore(RZ_NONNULL RzBuffer *b, RZ_NONNULL const RzBufferCowSnapshot *snap) {
+	rz_return_val_if_fail(b && snap, false);
+	if (b->methods != &buffer_cow_methods) {
+		return false;
+	}
+	CowPriv *priv = get_priv_cow(b);
+	HtUP *pages = pages_share(snap->pages);
+	if (!pages) {
+		return false;
+	}
+	ht_up_free(priv->pages);
+	priv->pages = pages;
+	priv->written_end = snap->written_end;
+	return true;
+}
+
+RZ_API void rz_buf_cow_snapshot_free(RZ_NULLABLE RzBufferCowSnapshot *snap) {
+	if (!snap) {
+		return;
+	}
+	ht_up_free(snap->pages);
+	free(snap);
+}
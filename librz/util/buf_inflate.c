@@ -0,0 +1,304 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include <zlib.h>
+
+/*
+ * Read-only view of the decompressed contents of a deflate stream.
+ *
+ * Opening the buffer runs through the stream once to learn its size and to
+ * leave a checkpoint every INFLATE_SPAN bytes of output. A checkpoint is a
+ * deflate block boundary: its position in the input, down to the bit, and
+ * the window of output preceding it, which is all the inflater needs to
+ * restart there. Reads are served in INFLATE_BLOCK sized blocks, decompressed
+ * from the nearest checkpoint or by continuing the stream of the previous
+ * read, so the memory used only grows with the number of checkpoints and
+ * never with the decompressed size.
+ */
+
+#define INFLATE_SPAN   ((ut64)1 << 20)
+#define INFLATE_WINDOW 32768
+#define INFLATE_BLOCK  0x10000
+#define INFLATE_CHUNK  0x4000
+
+typedef struct {
+	ut64 out; ///< offset in the decompressed data
+	ut64 in; ///< offset in the compressed data of the first byte to feed, after the bits one
+	int bits; ///< bits of the byte before in still to be consumed, 0 if none
+	ut8 window[INFLATE_WINDOW]; ///< decompressed data preceding out
+} InflatePoint;
+
+typedef struct {
+	RzBuffer *src;
+	RzPVector /*<InflatePoint *>*/ points; ///< sorted by out
+	ut64 size;
+	ut64 offset;
+	z_stream strm; ///< raw inflater, restarted from the points
+	ut64 strm_in; ///< compressed offset of the next input of strm
+	ut64 strm_out; ///< decompressed offset of the next output of strm, UT64_MAX if unusable
+	ut8 in[INFLATE_CHUNK];
+	ut8 block[INFLATE_BLOCK]; ///< last decompressed block
+	ut64 block_addr; ///< address of block, UT64_MAX if none
+} InflatePriv;
+
+struct buf_inflate_user {
+	RzBuffer *src;
+	int wbits;
+};
+
+static inline InflatePriv *get_priv_inflate(RzBuffer *b) {
+	InflatePriv *priv = (InflatePriv *)b->priv;
+	rz_warn_if_fail(priv);
+	return priv;
+}
+
+static bool add_point(InflatePriv *priv, z_stream *strm, ut64 in, ut64 out, const ut8 *window) {
+	InflatePoint *point = RZ_NEW(InflatePoint);
+	if (!point) {
+		return false;
+	}
+	point->out = out;
+	point->in = in;
+	point->bits = out ? strm->data_type & 7 : 0;
+	// the window is circular, its oldest byte is where the next output goes
+	size_t left = strm->avail_out % INFLATE_WINDOW;
+	memcpy(point->window, window + INFLATE_WINDOW - left, left);
+	memcpy(point->window + left, window, INFLATE_WINDOW - left);
+	if (!rz_pvector_push(&priv->points, point)) {
+		free(point);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Decompress the whole stream once, discarding the output but keeping the
+ * checkpoints along the way.
+ */
+static bool build_index(InflatePriv *priv, int wbits) {
+	z_stream strm = { 0 };
+	if (inflateInit2(&strm, wbits) != Z_OK) {
+		return false;
+	}
+	ut8 *window = calloc(1, INFLATE_WINDOW);
+	if (!window) {
+		inflateEnd(&strm);
+		return false;
+	}
+	bool ret = false;
+	ut64 totin = 0;
+	ut64 totout = 0;
+	ut64 last = 0;
+	int err = Z_OK;
+	// without a header to stop after, raw streams get their first point here
+	if (wbits < 0 && !add_point(priv, &strm, 0, 0, window)) {
+		goto beach;
+	}
+	do {
+		st64 n = rz_buf_read_at(priv->src, totin, priv->in, INFLATE_CHUNK);
+		if (n <= 0) {
+			// truncated, what was decompressed so far is still readable
+			break;
+		}
+		strm.next_in = priv->in;
+		strm.avail_in = n;
+		do {
+			if (!strm.avail_out) {
+				strm.next_out = window;
+				strm.avail_out = INFLATE_WINDOW;
+			}
+			totin += strm.avail_in;
+			totout += strm.avail_out;
+			err = inflate(&strm, Z_BLOCK);
+			totin -= strm.avail_in;
+			totout -= strm.avail_out;
+			if (err == Z_NEED_DICT || err == Z_DATA_ERROR || err == Z_MEM_ERROR) {
+				goto beach;
+			}
+			if (err == Z_STREAM_END) {
+				break;
+			}
+			// at the end of a block, but not of the last one
+			if ((strm.data_type & 128) && !(strm.data_type & 64) && (rz_pvector_empty(&priv->points) || totout - last >= INFLATE_SPAN)) {
+				if (!add_point(priv, &strm, totin, totout, window)) {
+					goto beach;
+				}
+				last = totout;
+			}
+		} while (strm.avail_in);
+	} while (err != Z_STREAM_END);
+	priv->size = totout;
+	ret = !rz_pvector_empty(&priv->points) || !totout;
+beach:
+	free(window);
+	inflateEnd(&strm);
+	return ret;
+}
+
+static bool buf_inflate_init(RzBuffer *b, const void *user) {
+	const struct buf_inflate_user *u = user;
+	InflatePriv *priv = RZ_NEW0(InflatePriv);
+	if (!priv) {
+		return false;
+	}
+	rz_pvector_init(&priv->points, free);
+	priv->src = rz_buf_ref(u->src);
+	priv->strm_out = UT64_MAX;
+	priv->block_addr = UT64_MAX;
+	if (inflateInit2(&priv->strm, -MAX_WBITS) != Z_OK) {
+		rz_buf_free(priv->src);
+		free(priv);
+		return false;
+	}
+	if (!build_index(priv, u->wbits)) {
+		inflateEnd(&priv->strm);
+		rz_pvector_fini(&priv->points);
+		rz_buf_free(priv->src);
+		free(priv);
+		return false;
+	}
+	b->readonly = true;
+	b->priv = priv;
+	return true;
+}
+
+static bool buf_inflate_fini(RzBuffer *b) {
+	InflatePriv *priv = get_priv_inflate(b);
+	inflateEnd(&priv->strm);
+	rz_pvector_fini(&priv->points);
+	rz_buf_free(priv->src);
+	RZ_FREE(b->priv);
+	return true;
+}
+
+static ut64 buf_inflate_size(RzBuffer *b) {
+	InflatePriv *priv = get_priv_inflate(b);
+	return priv->size;
+}
+
+static st64 buf_inflate_seek(RzBuffer *b, st64 addr, int whence) {
+	InflatePriv *priv = get_priv_inflate(b);
+	priv->offset = rz_seek_offset(priv->offset, priv->size, addr, whence);
+	return RZ_MIN(priv->offset, ST64_MAX);
+}
+
+#define POINT_OUT_CMP(x, elem) RZ_NUM_CMP(x, ((InflatePoint *)(elem))->out)
+
+static bool restart_at(InflatePriv *priv, InflatePoint *point) {
+	if (inflateReset(&priv->strm) != Z_OK) {
+		return false;
+	}
+	priv->strm.avail_in = 0;
+	priv->strm_in = point->in;
+	if (point->bits) {
+		ut8 byte;
+		if (rz_buf_read_at(priv->src, point->in - 1, &byte, 1) != 1 ||
+			inflatePrime(&priv->strm, point->bits, byte >> (8 - point->bits)) != Z_OK) {
+			return false;
+		}
+	}
+	if (inflateSetDictionary(&priv->strm, point->window, INFLATE_WINDOW) != Z_OK) {
+		return false;
+	}
+	priv->strm_out = point->out;
+	return true;
+}
+
+/**
+ * Continue the stream for \p len bytes of output into \p out, NULL to skip them.
+ */
+static bool stream_inflate(InflatePriv *priv, ut8 *out, ut64 len) {
+	ut8 discard[0x1000];
+	while (len) {
+		if (!priv->strm.avail_in) {
+			st64 n = rz_buf_read_at(priv->src, priv->strm_in, priv->in, INFLATE_CHUNK);
+			if (n <= 0) {
+				return false;
+			}
+			priv->strm_in += n;
+			priv->strm.next_in = priv->in;
+			priv->strm.avail_in = n;
+		}
+		ut64 chunk = out ? len : RZ_MIN(len, sizeof(discard));
+		chunk = RZ_MIN(chunk, UT32_MAX);
+		priv->strm.next_out = out ? out : discard;
+		priv->strm.avail_out = chunk;
+		int err = inflate(&priv->strm, Z_NO_FLUSH);
+		ut64 done = chunk - priv->strm.avail_out;
+		priv->strm_out += done;
+		len -= done;
+		if (out) {
+			out += done;
+		}
+		if (err == Z_STREAM_END) {
+			return !len;
+		}
+		if (err != Z_OK && err != Z_BUF_ERROR) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Make block hold the decompressed data at \p block_addr.
+ */
+static bool load_block(InflatePriv *priv, ut64 block_addr) {
+	if (priv->block_addr == block_addr) {
+		return true;
+	}
+	priv->block_addr = UT64_MAX;
+	size_t i;
+	rz_pvector_upper_bound(&priv->points, block_addr, i, POINT_OUT_CMP);
+	if (!i) {
+		return false;
+	}
+	InflatePoint *point = rz_pvector_at(&priv->points, i - 1);
+	// going on with the current stream is cheaper if it has not passed the block yet
+	if (priv->strm_out == UT64_MAX || priv->strm_out > block_addr || priv->strm_out < point->out) {
+		if (!restart_at(priv, point)) {
+			priv->strm_out = UT64_MAX;
+			return false;
+		}
+	}
+	ut64 len = RZ_MIN(INFLATE_BLOCK, priv->size - block_addr);
+	if (!stream_inflate(priv, NULL, block_addr - priv->strm_out) || !stream_inflate(priv, priv->block, len)) {
+		priv->strm_out = UT64_MAX;
+		return false;
+	}
+	priv->block_addr = block_addr;
+	return true;
+}
+
+static st64 buf_inflate_read(RzBuffer *b, ut8 *buf, ut64 len) {
+	InflatePriv *priv = get_priv_inflate(b);
+	if (priv->offset >= priv->size) {
+		return 0;
+	}
+	len = RZ_MIN(len, priv->size - priv->offset);
+	ut64 done = 0;
+	while (done < len) {
+		ut64 addr = priv->offset + done;
+		ut64 block_addr = addr - addr % INFLATE_BLOCK;
+		if (!load_block(priv, block_addr)) {
+			break;
+		}
+		ut64 n = RZ_MIN(len - done, INFLATE_BLOCK - (addr - block_addr));
+		memcpy(buf + done, priv->block + (addr - block_addr), n);
+		done += n;
+	}
+	if (!done && len) {
+		return -1;
+	}
+	priv->offset += done;
+	return done;
+}
+
+static const RzBufferMethods buffer_inflate_methods = {
+	.init = buf_inflate_init,
+	.fini = buf_inflate_fini,
+	.read = buf_inflate_read,
+	.get_size = buf_inflate_size,
+	.seek = buf_inflate_seek,
+};
@@ -51,10 +51,16 @@ static st64 buf_io_write(RzBuffer *b, const ut8 *buf, ut64 len) {
 	return r ? len : -1;
 }
 
+static const ut8 *buf_io_borrow(RzBuffer *b, ut64 addr, ut64 *len) {
+	BufIOPriv *priv = b->priv;
+	return priv->iob->borrow_at ? priv->iob->borrow_at(priv->iob->io, addr, len) : NULL;
+}
+
 static const RzBufferMethods buffer_io_methods = {
 	.init = buf_io_init,
 	.fini = buf_io_fini,
 	.read = buf_io_read,
 	.write = buf_io_write,
 	.seek = buf_io_seek,
+	.borrow = buf_io_borrow,
 };
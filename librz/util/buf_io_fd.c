@@ -85,6 +85,11 @@ static ut8 *buf_io_fd_get_whole_buf(RzBuffer *b, ut64 *size) {
 	return priv->iob->fd_getbuf(priv->iob->io, priv->fd, size);
 }
 
+static const ut8 *buf_io_fd_borrow(RzBuffer *b, ut64 addr, ut64 *len) {
+	struct buf_io_fd_priv *priv = get_priv_io(b);
+	return priv->iob->fd_borrow_at ? priv->iob->fd_borrow_at(priv->iob->io, priv->fd, addr, len) : NULL;
+}
+
 static const RzBufferMethods buffer_io_fd_methods = {
 	.init = buf_io_fd_init,
 	.fini = buf_io_fd_fini,
@@ -93,5 +98,6 @@ static const RzBufferMethods buffer_io_fd_methods = {
 	.get_size = buf_io_fd_get_size,
 	.resize = buf_io_fd_resize,
 	.seek = buf_io_fd_seek,
-	.get_whole_buf = buf_io_fd_get_whole_buf
+	.get_whole_buf = buf_io_fd_get_whole_buf,
+	.borrow = buf_io_fd_borrow
 };
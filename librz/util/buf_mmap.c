@@ -78,5 +78,6 @@ static const RzBufferMethods buffer_mmap_methods = {
 	.get_size = buf_bytes_get_size,
 	.resize = buf_mmap_resize,
 	.seek = buf_bytes_seek,
-	.get_whole_buf = buf_mmap_get_whole_buf
+	.get_whole_buf = buf_mmap_get_whole_buf,
+	.borrow = buf_bytes_borrow
 };
@@ -93,6 +93,15 @@ static st64 buf_ref_seek(RzBuffer *b, st64 addr, int whence) {
 	return priv->cur;
 }
 
+static const ut8 *buf_ref_borrow(RzBuffer *b, ut64 addr, ut64 *len) {
+	struct buf_ref_priv *priv = get_priv_ref(b);
+	if (addr >= priv->size) {
+		return NULL;
+	}
+	*len = RZ_MIN(*len, priv->size - addr);
+	return rz_buf_borrow_at(priv->parent, priv->base + addr, len);
+}
+
 static const RzBufferMethods buffer_ref_methods = {
 	.init = buf_ref_init,
 	.fini = buf_ref_fini,
@@ -100,4 +109,5 @@ static const RzBufferMethods buffer_ref_methods = {
 	.get_size = buf_ref_get_size,
 	.resize = buf_ref_resize,
 	.seek = buf_ref_seek,
+	.borrow = buf_ref_borrow,
 };
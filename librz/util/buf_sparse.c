@@ -9,39 +9,118 @@ typedef struct sparse_init_config_t {
 	RzBufferSparseWriteMode write_mode;
 } SparseInitConfig;
 
+/**
+ * Populated ranges are split into chunks of at most this size, so that
+ * growing, merging or copying a chunk never costs more than this.
+ */
+#define SPARSE_CHUNK_MAX 0x10000
+
+typedef struct sparse_node_t {
+	RBNode rb;
+	RzBufferSparseChunk c;
+	ut64 cap; ///< allocated size of c.data
+} SparseNode;
+
 typedef struct buf_sparse_priv {
 	RzBuffer *base; ///< If not NULL, unpopulated bytes are taken from this, else Oxff
-	RzVector chunks; ///< of RzBufferSparseChunk, non-overlapping, ordered by from addr
+	RBTree chunks; ///< of SparseNode, non-overlapping, ordered by from addr
+	size_t count; ///< number of chunks
+	RzVector view; ///< flat copy of the chunks returned by rz_buf_sparse_get_chunks()
+	bool view_dirty;
 	ut64 offset;
 	RzBufferSparseWriteMode write_mode;
 } SparsePriv;
 
-static void chunk_fini(void *a, void *user) {
-	RzBufferSparseChunk *s = (RzBufferSparseChunk *)a;
-	free(s->data);
+static void node_free(RBNode *node, void *user) {
+	SparseNode *n = container_of(node, SparseNode, rb);
+	free(n->c.data);
+	free(n);
 }
 
-static bool sparse_limits(SparsePriv *priv, ut64 *max) {
-	if (rz_vector_empty(&priv->chunks)) {
+static int node_cmp(const void *incoming, const RBNode *in_tree, void *user) {
+	ut64 addr = *(const ut64 *)incoming;
+	const SparseNode *n = container_of(in_tree, const SparseNode, rb);
+	if (addr < n->c.from) {
+		return -1;
+	}
+	return addr > n->c.to ? 1 : 0;
+}
+
+static int node_insert_cmp(const void *incoming, const RBNode *in_tree, void *user) {
+	const SparseNode *a = incoming;
+	const SparseNode *b = container_of(in_tree, const SparseNode, rb);
+	return RZ_NUM_CMP(a->c.from, b->c.from);
+}
+
+/**
+ * \return the chunk containing \p addr, or else the first one after it, or NULL
+ */
+static SparseNode *node_first_after(SparsePriv *priv, ut64 addr) {
+	RBNode *node = rz_rbtree_lower_bound(priv->chunks, &addr, node_cmp, NULL);
+	return node ? container_of(node, SparseNode, rb) : NULL;
+}
+
+static SparseNode *node_at(SparsePriv *priv, ut64 addr) {
+	RBNode *node = rz_rbtree_find(priv->chunks, &addr, node_cmp, NULL);
+	return node ? container_of(node, SparseNode, rb) : NULL;
+}
+
+static SparseNode *node_last(SparsePriv *priv) {
+	RBIter it = rz_rbtree_last(priv->chunks);
+	return rz_rbtree_iter_has(&it) ? rz_rbtree_iter_get(&it, SparseNode, rb) : NULL;
+}
+
+static void node_delete(SparsePriv *priv, SparseNode *n) {
+	ut64 addr = n->c.from;
+	rz_rbtree_delete(&priv->chunks, &addr, node_cmp, NULL, node_free, NULL);
+	priv->count--;
+}
+
+static bool node_reserve(SparseNode *n, ut64 size) {
+	if (size <= n->cap) {
+		return true;
+	}
+	// grow geometrically, so that byte by byte appends stay cheap
+	ut64 cap = RZ_MAX(size, RZ_MIN(n->cap * 2, SPARSE_CHUNK_MAX));
+	ut8 *data = realloc(n->c.data, cap);
+	if (!data) {
 		return false;
 	}
-	RzBufferSparseChunk *c = rz_vector_index_ptr(&priv->chunks, rz_vector_len(&priv->chunks) - 1);
-	*max = c->to + 1;
+	n->c.data = data;
+	n->cap = cap;
 	return true;
 }
 
-static int chunk_cmp(ut64 addr, void *a) {
-	RzBufferSparseChunk *c = a;
-	return RZ_NUM_CMP(addr, c->from);
+static bool sparse_limits(SparsePriv *priv, ut64 *max) {
+	SparseNode *last = node_last(priv);
+	if (!last) {
+		return false;
+	}
+	*max = last->c.to + 1;
+	return true;
 }
 
 /**
- * \return index of the chunk AFTER the one that might contain the addr (so 0 means there is none)
+ * Merge \p n with the chunk right after it if they touch and the result is not too big.
  */
-static size_t chunk_index_in(SparsePriv *priv, ut64 addr) {
-	size_t i;
-	rz_vector_upper_bound(&priv->chunks, addr, i, chunk_cmp);
-	return i;
+static void node_coalesce_next(SparsePriv *priv, SparseNode *n) {
+	if (n->c.to == UT64_MAX) {
+		return;
+	}
+	SparseNode *next = node_at(priv, n->c.to + 1);
+	if (!next) {
+		return;
+	}
+	ut64 size = n->c.to - n->c.from + 1;
+	ut64 next_size = next->c.to - next->c.from + 1;
+	if (size + next_size > SPARSE_CHUNK_MAX || !node_reserve(n, size + next_size)) {
+		return;
+	}
+	memcpy(n->c.data + size, next->c.data, next_size);
+	// delete it while its addresses are not covered by n yet, to find it again
+	ut64 to = next->c.to;
+	node_delete(priv, next);
+	n->c.to = to;
 }
 
 /**
@@ -55,61 +134,46 @@ static st64 sparse_write(SparsePriv *priv, ut64 addr, const ut8 *data, ut64 len)
 		// clamp to UT64_MAX (inclusive)
 		len = 0 - addr;
 	}
-	size_t in_start_index = chunk_index_in(priv, addr);
-	size_t in_end_index = chunk_index_in(priv, addr + len < addr ? UT64_MAX : addr + len);
-	RzBufferSparseChunk *c = NULL; // the chunk where we will write into
-	if (in_start_index) {
-		// if we start writing inside an existing chunk, use it.
-		c = rz_vector_index_ptr(&priv->chunks, in_start_index - 1);
-		if (addr > c->to) {
-			// already after it
-			c = NULL;
+	priv->view_dirty = true;
+	ut64 end = addr + len - 1; // inclusive
+	ut64 a = addr;
+	for (;;) {
+		SparseNode *n = node_first_after(priv, a);
+		ut64 wsz;
+		if (n && n->c.from <= a) {
+			// inside of an existing chunk, overwrite it
+			wsz = RZ_MIN(n->c.to, end) - a + 1;
+			memcpy(n->c.data + (a - n->c.from), data + (a - addr), wsz);
 		} else {
-			// inside of it, our start index is the index of this chunk
-			in_start_index--;
-		}
-	}
-	if (!c) {
-		c = rz_vector_insert(&priv->chunks, in_start_index, NULL);
-		if (in_end_index) {
-			// adjust after insertion
-			in_end_index++;
-		}
-		c->from = addr;
-		c->to = c->from;
-		c->data = NULL;
-	}
-	// (re)alloc buffer and fill with appropriate data
-	ut64 newto = addr + len - 1;
-	RzBufferSparseChunk *in_end_chunk = NULL;
-	if (in_end_index) {
-		in_end_chunk = rz_vector_index_ptr(&priv->chunks, in_end_index - 1);
-		if (in_end_chunk->to > newto) {
-			newto = in_end_chunk->to;
-		} else {
-			// completely swallowed this chunk, nothing to copy
-			in_end_chunk = NULL;
+			// in a gap, fill it up to the next chunk by appending to the previous one or with new chunks
+			ut64 gap_to = n && n->c.from - 1 < end ? n->c.from - 1 : end;
+			SparseNode *prev = a ? node_at(priv, a - 1) : NULL;
+			if (prev && prev->c.to - prev->c.from + 1 < SPARSE_CHUNK_MAX) {
+				ut64 size = prev->c.to - prev->c.from + 1;
+				wsz = RZ_MIN(gap_to - a + 1, SPARSE_CHUNK_MAX - size);
+				if (!node_reserve(prev, size + wsz)) {
+					return -1;
+				}
+				prev->c.to += wsz;
+			} else {
+				wsz = RZ_MIN(gap_to - a + 1, SPARSE_CHUNK_MAX);
+				prev = RZ_NEW0(SparseNode);
+				if (!prev || !node_reserve(prev, wsz)) {
+					free(prev);
+					return -1;
+				}
+				prev->c.from = a;
+				prev->c.to = a + wsz - 1;
+				rz_rbtree_insert(&priv->chunks, prev, &prev->rb, node_insert_cmp, NULL);
+				priv->count++;
+			}
+			memcpy(prev->c.data + (a - prev->c.from), data + (a - addr), wsz);
+			node_coalesce_next(priv, prev);
 		}
-	}
-	ut8 *newbuf = realloc(c->data, newto - c->from + 1);
-	if (!newbuf) {
-		return -1;
-	}
-	c->data = newbuf;
-	c->to = newto;
-	memcpy(c->data + (addr - c->from), data, len);
-	if (in_end_chunk && in_end_chunk != c) {
-		memcpy(c->data + (addr - c->from) + len,
-			in_end_chunk->data + (addr + len - in_end_chunk->from),
-			in_end_chunk->to - (addr + len) + 1);
-	}
-	// remove all chunks that are now overlapped and overwritten
-	if (in_end_index && in_start_index < in_end_index - 1) {
-		// remove_range does not free by design
-		for (size_t i = in_start_index + 1; i <= in_end_index - 1; i++) {
-			chunk_fini(rz_vector_index_ptr(&priv->chunks, i), NULL);
+		if (a + wsz - 1 == end) {
+			break;
 		}
-		rz_vector_remove_range(&priv->chunks, in_start_index + 1, in_end_index - (in_start_index + 1), NULL);
+		a += wsz;
 	}
 	return len;
 }
@@ -135,7 +199,9 @@ static bool buf_sparse_init(RzBuffer *b, const void *user) {
 	} else {
 		priv->write_mode = RZ_BUF_SPARSE_WRITE_MODE_SPARSE;
 	}
-	rz_vector_init(&priv->chunks, sizeof(RzBufferSparseChunk), chunk_fini, NULL);
+	priv->chunks = NULL;
+	priv->count = 0;
+	rz_vector_init(&priv->view, sizeof(RzBufferSparseChunk), NULL, NULL);
 	priv->offset = 0;
 	b->priv = priv;
 	return true;
@@ -143,7 +209,8 @@ static bool buf_sparse_init(RzBuffer *b, const void *user) {
 
 static bool buf_sparse_fini(RzBuffer *b) {
 	struct buf_sparse_priv *priv = get_priv_sparse(b);
-	rz_vector_fini(&priv->chunks);
+	rz_rbtree_free(priv->chunks, node_free, NULL);
+	rz_vector_fini(&priv->view);
 	rz_buf_free(priv->base);
 	RZ_FREE(b->priv);
 	return true;
@@ -151,30 +218,25 @@ static bool buf_sparse_fini(RzBuffer *b) {
 
 static bool buf_sparse_resize(RzBuffer *b, ut64 newsize) {
 	SparsePriv *priv = get_priv_sparse(b);
-	size_t n;
-	rz_vector_lower_bound(&priv->chunks, newsize, n, chunk_cmp);
-	// now n == index of the first chunk to be thrown away entirely
-	if (n < rz_vector_len(&priv->chunks)) {
-		// remove all excessive chunks if shrinking
-		for (size_t i = n; i < rz_vector_len(&priv->chunks); i++) {
-			chunk_fini(rz_vector_index_ptr(&priv->chunks, i), NULL);
-		}
-		rz_vector_remove_range(&priv->chunks, n, rz_vector_len(&priv->chunks) - n, NULL);
+	priv->view_dirty = true;
+	// remove all excessive chunks if shrinking
+	SparseNode *last;
+	while ((last = node_last(priv)) && last->c.from >= newsize) {
+		node_delete(priv, last);
 	}
-	// now n == rz_vector_len(&priv->chunks)
 	bool must_extend = false; // whether we must add another artificial chunk to reach exactly the size
-	if (n) {
-		RzBufferSparseChunk *c = rz_vector_index_ptr(&priv->chunks, n - 1);
-		if (newsize <= c->to) {
+	if (last) {
+		if (newsize <= last->c.to) {
 			// must chop the now-last block
-			assert(newsize); // newsize > 0 is guaranteed when n > 0, otherwise the lower bound above would have returned 0.
-			c->to = newsize - 1;
-			ut8 *tmp = realloc(c->data, c->to - c->from + 1);
+			assert(newsize); // newsize > 0 is guaranteed when a chunk is left, otherwise it would have been removed above.
+			last->c.to = newsize - 1;
+			ut8 *tmp = realloc(last->c.data, last->c.to - last->c.from + 1);
 			if (tmp) {
-				c->data = tmp;
+				last->c.data = tmp;
+				last->cap = last->c.to - last->c.from + 1;
 			}
 		} else {
-			must_extend = newsize && c->to < newsize - 1;
+			must_extend = newsize && last->c.to < newsize - 1;
 		}
 	} else {
 		must_extend = !!newsize;
@@ -211,16 +273,17 @@ static st64 buf_sparse_read(RzBuffer *b, ut8 *buf, ut64 len) {
 	}
 	// first inside-chunk is special because we might start inside of it
 	size_t r = 0;
-	size_t i = chunk_index_in(priv, priv->offset);
-	if (i) {
-		RzBufferSparseChunk *c = rz_vector_index_ptr(&priv->chunks, i - 1);
-		if (priv->offset <= c->to) {
+	RBIter it = rz_rbtree_lower_bound_forward(priv->chunks, &priv->offset, node_cmp, NULL);
+	if (rz_rbtree_iter_has(&it)) {
+		RzBufferSparseChunk *c = &rz_rbtree_iter_get(&it, SparseNode, rb)->c;
+		if (c->from <= priv->offset) {
 			ut64 to = RZ_MIN(c->to, max);
 			ut64 rsz = to - priv->offset + 1;
 			memcpy(buf, c->data + (priv->offset - c->from), rsz);
 			priv->offset += rsz;
 			buf += rsz;
 			r += rsz;
+			rz_rbtree_iter_next(&it);
 		}
 	}
 	// non-chunk/chunk alternating
@@ -228,15 +291,15 @@ static st64 buf_sparse_read(RzBuffer *b, ut8 *buf, ut64 len) {
 		// in each iteration, write one part like [0xff, 0xff, 0xff][some chunk]
 		ut64 empty_to = max; // inclusive offset to which to fill with 0xff
 		ut64 next_off = empty_to + 1; // offset to start at in the next iteration
-		if (i < rz_vector_len(&priv->chunks)) {
-			RzBufferSparseChunk *c = rz_vector_index_ptr(&priv->chunks, i);
+		if (rz_rbtree_iter_has(&it)) {
+			RzBufferSparseChunk *c = &rz_rbtree_iter_get(&it, SparseNode, rb)->c;
 			if (c->from <= empty_to) {
 				next_off = RZ_MIN(c->to + 1, next_off);
 				empty_to = c->from - 1;
 				memcpy(buf + empty_to - priv->offset + 1, c->data, next_off - empty_to - 1);
 				r += next_off - priv->offset;
 			}
-			i++;
+			rz_rbtree_iter_next(&it);
 		}
 		if (empty_to >= priv->offset) {
 			// fill non-chunk part with 0xff or base file
@@ -309,7 +372,10 @@ static const RzBufferMethods buffer_sparse_methods = {
 	.seek = buf_sparse_seek
 };
 
-/// Only for sparse RzBuffers, get all sparse data chunks currently populated.
+/**
+ * Only for sparse RzBuffers, get all sparse data chunks currently populated.
+ * The returned array is valid until the next write or resize of the buffer.
+ */
 RZ_API const RzBufferSparseChunk *rz_buf_sparse_get_chunks(RzBuffer *b, RZ_NONNULL size_t *count) {
 	rz_return_val_if_fail(b && count, NULL);
 	if (b->methods != &buffer_sparse_methods) {
@@ -317,8 +383,21 @@ RZ_API const RzBufferSparseChunk *rz_buf_sparse_get_chunks(RzBuffer *b, RZ_NONNU
 		return NULL;
 	}
 	SparsePriv *priv = get_priv_sparse(b);
-	*count = rz_vector_len(&priv->chunks);
-	return rz_vector_index_ptr(&priv->chunks, 0);
+	if (priv->view_dirty) {
+		rz_vector_clear(&priv->view);
+		if (priv->count && !rz_vector_reserve(&priv->view, priv->count)) {
+			*count = 0;
+			return NULL;
+		}
+		RBIter it;
+		SparseNode *n;
+		rz_rbtree_foreach (priv->chunks, it, n, SparseNode, rb) {
+			rz_vector_push(&priv->view, &n->c);
+		}
+		priv->view_dirty = false;
+	}
+	*count = rz_vector_len(&priv->view);
+	return rz_vector_index_ptr(&priv->view, 0);
 }
 
 /// Only for sparse RzBuffers
@@ -342,13 +421,6 @@ RZ_API bool rz_buf_sparse_populated_in(RzBuffer *b, ut64 from, ut64 to) {
 		return false;
 	}
 	SparsePriv *priv = get_priv_sparse(b);
-	size_t from_i = chunk_index_in(priv, from);
-	if (from_i) {
-		RzBufferSparseChunk *c = rz_vector_index_ptr(&priv->chunks, from_i - 1);
-		if (from <= c->to) {
-			return true;
-		}
-	}
-	size_t to_i = chunk_index_in(priv, to);
-	return to_i > from_i;
+	SparseNode *n = node_first_after(priv, from);
+	return n && n->c.from <= to;
 }
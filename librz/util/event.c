@@ -64,28 +64,36 @@ RZ_API RzEventCallbackHandle rz_event_hook(RzEvent *ev, int type, RzEventCallbac
 	hook.user = user;
 	hook.handle = ev->next_handle++;
 	if (type == RZ_EVENT_ALL) {
-		rz_vector_push(&ev->all_callbacks, &hook);
+		if (!rz_vector_push(&ev->all_callbacks, &hook)) {
+			return handle;
+		}
 	} else {
 		RzVector *cbs = get_cbs(ev, type);
-		if (!cbs) {
+		if (!cbs || !rz_vector_push(cbs, &hook)) {
 			return handle;
 		}
-		rz_vector_push(cbs, &hook);
 	}
+	ev->hooked++;
 	handle.handle = hook.handle;
 	handle.type = type;
 	return handle;
 }
 
+typedef struct {
+	int handle;
+	size_t removed;
+} DelHookCtx;
+
 static bool del_hook(void *user, const ut64 k, const void *v) {
-	int handle = *(int *)user;
+	DelHookCtx *ctx = user;
 	RzVector *cbs = (RzVector *)v;
 	RzEventCallbackHook *hook;
 	size_t i;
 	rz_return_val_if_fail(cbs, false);
 	rz_vector_enumerate(cbs, hook, i) {
-		if (hook->handle == handle) {
+		if (hook->handle == ctx->handle) {
 			rz_vector_remove_at(cbs, i, NULL);
+			ctx->removed++;
 			break;
 		}
 	}
@@ -100,21 +108,26 @@ RZ_API void rz_event_unhook(RzEvent *ev, RzEventCallbackHandle handle) {
 		rz_vector_push(&ev->pending_unhook, &handle);
 		return;
 	}
+	DelHookCtx ctx = { .handle = handle.handle };
 	if (handle.type == RZ_EVENT_ALL) {
 		// try to delete it both from each list of callbacks and from
 		// the "all_callbacks" vector
-		ht_up_foreach(ev->callbacks, del_hook, &handle.handle);
-		del_hook(&handle.handle, 0, &ev->all_callbacks);
+		ht_up_foreach(ev->callbacks, del_hook, &ctx);
+		del_hook(&ctx, 0, &ev->all_callbacks);
 	} else {
 		RzVector *cbs = ht_up_find(ev->callbacks, (ut64)handle.type, NULL);
 		rz_return_if_fail(cbs);
-		del_hook(&handle.handle, 0, cbs);
+		del_hook(&ctx, 0, cbs);
 	}
+	ev->hooked -= RZ_MIN(ctx.removed, ev->hooked);
 }
 
 RZ_API void rz_event_send(RzEvent *ev, int type, void *data) {
 	RzEventCallbackHook *hook;
 	rz_return_if_fail(ev && !ev->incall);
+	if (!ev->hooked) {
+		return;
+	}
 
 	// send to both the per-type callbacks and to the all_callbacks
 	ev->incall = true;
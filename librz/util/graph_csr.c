@@ -0,0 +1,345 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include <rz_vector.h>
+
+/**
+ * \file graph_csr.c
+ * Compressed sparse row graphs, built once and then only traversed.
+ *
+ * Producers of big graphs (e.g. call graphs) either collect nodes and edges in
+ * a RzGraphCSRBuilder, or convert a finished RzGraph with
+ * rz_graph_csr_new_from_graph(), and then work with plain indices.
+ */
+
+enum {
+	WHITE_COLOR = 0,
+	GRAY_COLOR,
+	BLACK_COLOR
+};
+
+typedef struct {
+	ut32 from;
+	ut32 to;
+} CSREdge;
+
+struct rz_graph_csr_builder_t {
+	RzPVector /*<void *>*/ data;
+	RzVector /*<CSREdge>*/ edges;
+};
+
+RZ_API RZ_OWN RzGraphCSRBuilder *rz_graph_csr_builder_new(void) {
+	RzGraphCSRBuilder *b = RZ_NEW0(RzGraphCSRBuilder);
+	if (!b) {
+		return NULL;
+	}
+	rz_pvector_init(&b->data, NULL);
+	rz_vector_init(&b->edges, sizeof(CSREdge), NULL, NULL);
+	return b;
+}
+
+RZ_API void rz_graph_csr_builder_free(RZ_NULLABLE RzGraphCSRBuilder *b) {
+	if (!b) {
+		return;
+	}
+	rz_pvector_fini(&b->data);
+	rz_vector_fini(&b->edges);
+	free(b);
+}
+
+/**
+ * \brief Add a node holding \p data
+ * \return the index of the node, UT32_MAX on failure
+ */
+RZ_API ut32 rz_graph_csr_builder_add_node(RZ_NONNULL RzGraphCSRBuilder *b, RZ_NULLABLE void *data) {
+	rz_return_val_if_fail(b, UT32_MAX);
+	ut32 idx = (ut32)rz_pvector_len(&b->data);
+	if (idx == UT32_MAX - 1 || !rz_pvector_push(&b->data, data)) {
+		return UT32_MAX;
+	}
+	return idx;
+}
+
+/**
+ * \brief Add an edge between two nodes added before
+ *
+ * The successors and predecessors of each node keep the order their edges
+ * were added in.
+ */
+RZ_API bool rz_graph_csr_builder_add_edge(RZ_NONNULL RzGraphCSRBuilder *b, ut32 from, ut32 to) {
+	rz_return_val_if_fail(b, false);
+	ut32 n = (ut32)rz_pvector_len(&b->data);
+	if (from >= n || to >= n || rz_vector_len(&b->edges) >= UT32_MAX - 1) {
+		return false;
+	}
+	CSREdge e = { from, to };
+	return rz_vector_push(&b->edges, &e) != NULL;
+}
+
+static RzGraphCSR *csr_alloc(ut32 n_nodes, ut32 n_edges) {
+	RzGraphCSR *g = RZ_NEW0(RzGraphCSR);
+	if (!g) {
+		return NULL;
+	}
+	g->n_nodes = n_nodes;
+	g->n_edges = n_edges;
+	g->data = RZ_NEWS0(void *, n_nodes + 1);
+	g->out_off = RZ_NEWS0(ut32, n_nodes + 1);
+	g->in_off = RZ_NEWS0(ut32, n_nodes + 1);
+	g->out = RZ_NEWS0(ut32, n_edges + 1);
+	g->in = RZ_NEWS0(ut32, n_edges + 1);
+	if (!g->data || !g->out_off || !g->in_off || !g->out || !g->in) {
+		rz_graph_csr_free(g);
+		return NULL;
+	}
+	return g;
+}
+
+/**
+ * \brief Build the graph with the nodes and edges added to \p b
+ *
+ * \p b stays valid and can be freed or built again afterwards.
+ */
+RZ_API RZ_OWN RzGraphCSR *rz_graph_csr_builder_build(RZ_NONNULL RzGraphCSRBuilder *b) {
+	rz_return_val_if_fail(b, NULL);
+	ut32 n_nodes = (ut32)rz_pvector_len(&b->data);
+	ut32 n_edges = (ut32)rz_vector_len(&b->edges);
+	RzGraphCSR *g = csr_alloc(n_nodes, n_edges);
+	if (!g) {
+		return NULL;
+	}
+	if (n_nodes) {
+		memcpy(g->data, rz_pvector_data(&b->data), n_nodes * sizeof(void *));
+	}
+	CSREdge *e;
+	// counting sort of the edges by source and by destination, keeping their order
+	rz_vector_foreach(&b->edges, e) {
+		g->out_off[e->from + 1]++;
+		g->in_off[e->to + 1]++;
+	}
+	for (ut32 i = 0; i < n_nodes; i++) {
+		g->out_off[i + 1] += g->out_off[i];
+		g->in_off[i + 1] += g->in_off[i];
+	}
+	ut32 *out_pos = RZ_NEWS(ut32, n_nodes + 1);
+	ut32 *in_pos = RZ_NEWS(ut32, n_nodes + 1);
+	if (!out_pos || !in_pos) {
+		free(out_pos);
+		free(in_pos);
+		rz_graph_csr_free(g);
+		return NULL;
+	}
+	memcpy(out_pos, g->out_off, (n_nodes + 1) * sizeof(ut32));
+	memcpy(in_pos, g->in_off, (n_nodes + 1) * sizeof(ut32));
+	rz_vector_foreach(&b->edges, e) {
+		g->out[out_pos[e->from]++] = e->to;
+		g->in[in_pos[e->to]++] = e->from;
+	}
+	free(out_pos);
+	free(in_pos);
+	return g;
+}
+
+/**
+ * \brief Convert \p g to a RzGraphCSR
+ *
+ * The nodes get the indices of their position in rz_graph_get_nodes() and the
+ * successors and predecessors of each node keep the order of its out_nodes and
+ * in_nodes. The data is shared with \p g, which must outlive the result if the
+ * data or the nodes are used.
+ */
+RZ_API RZ_OWN RzGraphCSR *rz_graph_csr_new_from_graph(RZ_NONNULL const RzGraph *g) {
+	rz_return_val_if_fail(g, NULL);
+	ut32 n_nodes = rz_list_length(g->nodes);
+	ut32 n_edges = 0;
+	RzListIter *it;
+	RzGraphNode *n;
+	rz_list_foreach (g->nodes, it, n) {
+		n_edges += rz_list_length(n->out_nodes);
+	}
+	RzGraphCSR *csr = csr_alloc(n_nodes, n_edges);
+	if (!csr) {
+		return NULL;
+	}
+	csr->n_index_of = g->last_index > 0 ? (ut32)g->last_index : 0;
+	csr->nodes = RZ_NEWS0(RzGraphNode *, n_nodes + 1);
+	csr->index_of = RZ_NEWS(ut32, csr->n_index_of + 1);
+	if (!csr->nodes || !csr->index_of) {
+		rz_graph_csr_free(csr);
+		return NULL;
+	}
+	memset(csr->index_of, 0xff, (csr->n_index_of + 1) * sizeof(ut32));
+	ut32 i = 0;
+	rz_list_foreach (g->nodes, it, n) {
+		if (n->idx < csr->n_index_of) {
+			csr->index_of[n->idx] = i;
+		}
+		csr->nodes[i] = n;
+		csr->data[i] = n->data;
+		i++;
+	}
+	ut32 n_out = 0, n_in = 0;
+	for (i = 0; i < n_nodes; i++) {
+		RzListIter *itn;
+		RzGraphNode *m;
+		csr->out_off[i] = n_out;
+		csr->in_off[i] = n_in;
+		n = csr->nodes[i];
+		rz_list_foreach (n->out_nodes, itn, m) {
+			ut32 idx = rz_graph_csr_index(csr, m);
+			if (idx != UT32_MAX && n_out < n_edges) {
+				csr->out[n_out++] = idx;
+			}
+		}
+		rz_list_foreach (n->in_nodes, itn, m) {
+			ut32 idx = rz_graph_csr_index(csr, m);
+			if (idx != UT32_MAX && n_in < n_edges) {
+				csr->in[n_in++] = idx;
+			}
+		}
+	}
+	csr->out_off[n_nodes] = n_out;
+	csr->in_off[n_nodes] = n_in;
+	csr->n_edges = n_out;
+	return csr;
+}
+
+RZ_API void rz_graph_csr_free(RZ_NULLABLE RzGraphCSR *g) {
+	if (!g) {
+		return;
+	}
+	free(g->data);
+	free(g->nodes);
+	free(g->out_off);
+	free(g->out);
+	free(g->in_off);
+	free(g->in);
+	free(g->index_of);
+	free(g);
+}
+
+/**
+ * \brief Index of \p n in a graph built by rz_graph_csr_new_from_graph()
+ * \return the index or UT32_MAX if \p n is not part of it
+ */
+RZ_API ut32 rz_graph_csr_index(RZ_NONNULL const RzGraphCSR *g, RZ_NONNULL const RzGraphNode *n) {
+	rz_return_val_if_fail(g && n, UT32_MAX);
+	if (!g->index_of || n->idx >= g->n_index_of) {
+		return UT32_MAX;
+	}
+	ut32 i = g->index_of[n->idx];
+	return i != UT32_MAX && g->nodes[i] == n ? i : UT32_MAX;
+}
+
+/**
+ * \brief true if there is an edge from \p from to \p to
+ */
+RZ_API bool rz_graph_csr_adjacent(RZ_NONNULL const RzGraphCSR *g, ut32 from, ut32 to) {
+	rz_return_val_if_fail(g, false);
+	if (from >= g->n_nodes) {
+		return false;
+	}
+	const ut32 *succ = rz_graph_csr_out_nodes(g, from);
+	ut32 n = rz_graph_csr_out_degree(g, from);
+	for (ut32 i = 0; i < n; i++) {
+		if (succ[i] == to) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// stack and pos hold g->n_nodes entries, a node is on the stack only while gray
+static void dfs_node(const RzGraphCSR *g, ut32 start, RzGraphCSRVisitor *vis, ut8 *color, ut32 *stack, ut32 *pos) {
+	ut32 depth = 0;
+	color[start] = GRAY_COLOR;
+	if (vis->discover_node) {
+		vis->discover_node(start, vis);
+	}
+	stack[depth] = start;
+	pos[depth++] = 0;
+	while (depth) {
+		ut32 cur = stack[depth - 1];
+		ut32 nth = pos[depth - 1];
+		if (nth == rz_graph_csr_out_degree(g, cur)) {
+			color[cur] = BLACK_COLOR;
+			if (vis->finish_node) {
+				vis->finish_node(cur, vis);
+			}
+			depth--;
+			continue;
+		}
+		pos[depth - 1]++;
+		ut32 to = rz_graph_csr_out_nodes(g, cur)[nth];
+		switch (color[to]) {
+		case WHITE_COLOR:
+			if (vis->tree_edge) {
+				vis->tree_edge(cur, to, nth, vis);
+			}
+			color[to] = GRAY_COLOR;
+			if (vis->discover_node) {
+				vis->discover_node(to, vis);
+			}
+			stack[depth] = to;
+			pos[depth++] = 0;
+			break;
+		case GRAY_COLOR:
+			if (vis->back_edge) {
+				vis->back_edge(cur, to, nth, vis);
+			}
+			break;
+		default:
+			if (vis->fcross_edge) {
+				vis->fcross_edge(cur, to, nth, vis);
+			}
+			break;
+		}
+	}
+}
+
+static void dfs(const RzGraphCSR *g, ut32 start, RzGraphCSRVisitor *vis) {
+	ut8 *color = RZ_NEWS0(ut8, g->n_nodes);
+	ut32 *stack = RZ_NEWS(ut32, g->n_nodes);
+	ut32 *pos = RZ_NEWS(ut32, g->n_nodes);
+	if (color && stack && pos) {
+		if (start != UT32_MAX) {
+			dfs_node(g, start, vis, color, stack, pos);
+		} else {
+			for (ut32 i = 0; i < g->n_nodes; i++) {
+				if (color[i] == WHITE_COLOR) {
+					dfs_node(g, i, vis, color, stack, pos);
+				}
+			}
+		}
+	}
+	free(color);
+	free(stack);
+	free(pos);
+}
+
+/**
+ * \brief Depth first visit of the nodes reachable from \p n
+ *
+ * The successors of each node are visited in order and every edge is passed
+ * to one of the edge callbacks of \p vis, depending on the color of its
+ * destination when it is reached.
+ */
+RZ_API void rz_graph_csr_dfs_node(RZ_NONNULL const RzGraphCSR *g, ut32 n, RZ_NONNULL RzGraphCSRVisitor *vis) {
+	rz_return_if_fail(g && vis);
+	if (n >= g->n_nodes) {
+		return;
+	}
+	dfs(g, n, vis);
+}
+
+/**
+ * \brief Depth first visit of all the nodes, like rz_graph_csr_dfs_node()
+ * starting from every node not visited yet, in index order.
+ */
+RZ_API void rz_graph_csr_dfs(RZ_NONNULL const RzGraphCSR *g, RZ_NONNULL RzGraphCSRVisitor *vis) {
+	rz_return_if_fail(g && vis);
+	if (g->n_nodes) {
+		dfs(g, UT32_MAX, vis);
+	}
+}
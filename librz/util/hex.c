@@ -6,17 +6,44 @@
 #include <stdio.h>
 #include <ctype.h>
 
+// the two digits of every byte, so that a byte is printed with a single copy
+static const char hex_pairs[513] =
+	"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+	"202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+	"404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+	"606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+	"808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+	"a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+	"c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+	"e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+// value of every hex digit, 0xff for the other characters
+static const ut8 hex_nibbles[256] = {
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
 /* int c; ret = hex_to_byte(&c, 'c'); */
 RZ_API bool rz_hex_to_byte(ut8 *val, ut8 c) {
-	if (IS_DIGIT(c)) {
-		*val = (ut8)(*val) * 16 + (c - '0');
-	} else if (c >= 'A' && c <= 'F') {
-		*val = (ut8)(*val) * 16 + (c - 'A' + 10);
-	} else if (c >= 'a' && c <= 'f') {
-		*val = (ut8)(*val) * 16 + (c - 'a' + 10);
-	} else {
+	ut8 nibble = hex_nibbles[c];
+	if (nibble == 0xff) {
 		return 1;
 	}
+	*val = (ut8)(*val) * 16 + nibble;
 	return 0;
 }
 
@@ -381,13 +408,11 @@ RZ_API int rz_hex_pair2bin(const char *arg) {
 
 RZ_API int rz_hex_bin2str(const ut8 *in, int len, char *out) {
 	int i, idx;
-	char tmp[8];
 	if (len < 0) {
 		return 0;
 	}
 	for (idx = i = 0; i < len; i++, idx += 2) {
-		snprintf(tmp, sizeof(tmp), "%02x", in[i]);
-		memcpy(out + idx, tmp, 2);
+		memcpy(out + idx, hex_pairs + in[i] * 2, 2);
 	}
 	out[idx] = 0;
 	return len;
@@ -414,7 +439,7 @@ RZ_API void rz_hex_ut2st_str(const ut32 in, RZ_INOUT char *out, const int len) {
 
 RZ_API char *rz_hex_bin2strdup(const ut8 *in, int len) {
 	int i, idx;
-	char tmp[5], *out;
+	char *out;
 
 	if ((len + 1) * 2 < len) {
 		return NULL;
@@ -424,8 +449,7 @@ RZ_API char *rz_hex_bin2strdup(const ut8 *in, int len) {
 		return NULL;
 	}
 	for (i = idx = 0; i < len; i++, idx += 2) {
-		snprintf(tmp, sizeof(tmp), "%02x", in[i]);
-		memcpy(out + idx, tmp, 2);
+		memcpy(out + idx, hex_pairs + in[i] * 2, 2);
 	}
 	out[idx] = 0;
 	return out;
@@ -450,7 +474,17 @@ RZ_API int rz_hex_str2bin(const char *in, ut8 *out) {
 		if (*in == '0' && in[1] == 'x') {
 			in += 2;
 		}
-		/* read hex digits */
+		/* read hex digits, a whole byte at a time while aligned */
+		if (!(nibbles % 2)) {
+			ut8 hi, lo;
+			while ((hi = hex_nibbles[(ut8)in[0]]) != 0xff && (lo = hex_nibbles[(ut8)in[1]]) != 0xff) {
+				if (out) {
+					out[nibbles / 2] = hi << 4 | lo;
+				}
+				nibbles += 2;
+				in += 2;
+			}
+		}
 		while (!rz_hex_to_byte(out ? &out[nibbles / 2] : &tmp, *in)) {
 			nibbles++;
 			in++;
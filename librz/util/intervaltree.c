@@ -136,6 +136,56 @@ RZ_API bool rz_interval_tree_insert(RzIntervalTree *tree, ut64 start, ut64 end,
 	return r;
 }
 
+/**
+ * \brief Inserts all the \p entries at once, in O(n) when they are sorted by start and the tree is empty
+ *
+ * Otherwise the entries are inserted one by one, which gives the same tree
+ * contents in O(n log(n)).
+ *
+ * \return false if some entry could not be inserted
+ */
+RZ_API bool rz_interval_tree_bulk_load(RzIntervalTree *tree, RZ_NULLABLE const RzIntervalTreeEntry *entries, size_t count) {
+	rz_return_val_if_fail(tree && (entries || !count), false);
+	bool sorted = !tree->root;
+	for (size_t i = 0; sorted && i + 1 < count; i++) {
+		sorted = entries[i].start <= entries[i + 1].start;
+	}
+	RBNode **nodes = sorted && count ? RZ_NEWS(RBNode *, count) : NULL;
+	if (!nodes) {
+		bool ret = true;
+		for (size_t i = 0; i < count; i++) {
+			ret &= rz_interval_tree_insert(tree, entries[i].start, entries[i].end, entries[i].data);
+		}
+		return ret;
+	}
+	size_t i;
+	for (i = 0; i < count; i++) {
+		if (entries[i].end < entries[i].start) {
+			RZ_LOG_ERROR("interval tree: the end of the interval is lower than its start\n");
+			break;
+		}
+		RzIntervalNode *node = RZ_NEW0(RzIntervalNode);
+		if (!node) {
+			break;
+		}
+		node->start = entries[i].start;
+		node->end = entries[i].end;
+		node->data = entries[i].data;
+		nodes[i] = &node->node;
+	}
+	RBNode *root = NULL;
+	if (i < count || !rz_rbtree_aug_bulk_load(&root, nodes, count, node_max)) {
+		while (i) {
+			free(unwrap(nodes[--i]));
+		}
+		free(nodes);
+		return false;
+	}
+	free(nodes);
+	tree->root = unwrap(root);
+	return true;
+}
+
 RZ_API bool rz_interval_tree_delete(RzIntervalTree *tree, RzIntervalNode *node, bool free) {
 	RBNode *root = &tree->root->node;
 	RBIter path_cache = { 0 };
@@ -9,6 +9,7 @@
 #include <rz_util/rz_json.h>
 #include <rz_util/rz_assert.h>
 #include <rz_util/rz_pj.h>
+#include <sdb.h>
 
 #if 0
 // optional error printing
@@ -21,6 +22,9 @@
 	} while (0)
 #endif
 
+// objects with fewer members are searched linearly
+#define RZ_JSON_INDEX_MIN 16
+
 static RzJson *json_new(void) {
 	return RZ_NEW0(RzJson);
 }
@@ -54,6 +58,7 @@ RZ_API void rz_json_free(RzJson *js) {
 			rz_json_free(p);
 			p = p1;
 		}
+		ht_pp_free(js->children.index);
 	}
 	free(js);
 }
@@ -62,7 +67,17 @@ static char *unescape_string(char *s, char **end) {
 	char *p = s;
 	char *d = s;
 	char c;
-	while ((c = *p++)) {
+	while (true) {
+		// plain characters only need moving once an escape has shrunk the string
+		size_t plain = strcspn(p, "\"\\");
+		if (d != p) {
+			memmove(d, p, plain);
+		}
+		d += plain;
+		p += plain;
+		if (!(c = *p++)) {
+			break;
+		}
 		if (c == '"') {
 			*d = '\0';
 			*end = p;
@@ -131,8 +146,6 @@ static char *unescape_string(char *s, char **end) {
 				*d++ = c;
 				break;
 			}
-		} else {
-			*d++ = c;
 		}
 	}
 	RZ_JSON_REPORT_ERROR("no closing quote for string", s);
@@ -390,12 +403,53 @@ RZ_API RzJson *rz_json_parse(char *text) {
 	return js.children.first;
 }
 
+/**
+ * Map the keys of \p json to its members, the first one winning for
+ * duplicate keys like with the linear search.
+ */
+static HtPP *build_index(RzJson *json) {
+	HtPPOptions opt = {
+		.cmp = (HtPPListComparator)strcmp,
+		.hashfn = (HtPPHashFunction)sdb_hash,
+		.calcsizeK = (HtPPCalcSizeK)strlen,
+		.elem_size = sizeof(HtPPKv),
+	};
+	HtPP *index = ht_pp_new_opt(&opt);
+	if (!index) {
+		return NULL;
+	}
+	RzJson *js;
+	for (js = json->children.first; js; js = js->next) {
+		if (js->key) {
+			ht_pp_insert(index, js->key, js);
+		}
+	}
+	return index;
+}
+
 // getter with explicit size parameter, since in rz_json_get_path our key is
 // not zero-terminated.
 static const RzJson *rz_json_get_len(const RzJson *json, const char *key, size_t keysize) {
+	if (json->type != RZ_JSON_OBJECT) {
+		return NULL;
+	}
+	if (json->children.count >= RZ_JSON_INDEX_MIN) {
+		if (!json->children.index) {
+			((RzJson *)json)->children.index = build_index((RzJson *)json);
+		}
+		char buf[128];
+		if (json->children.index && (!key[keysize] || keysize < sizeof(buf))) {
+			if (key[keysize]) {
+				memcpy(buf, key, keysize);
+				buf[keysize] = '\0';
+				key = buf;
+			}
+			return ht_pp_find(json->children.index, key, NULL);
+		}
+	}
 	RzJson *js;
 	for (js = json->children.first; js; js = js->next) {
-		if (js->key && !strncmp(js->key, key, keysize)) {
+		if (js->key && !strncmp(js->key, key, keysize) && !js->key[keysize]) {
 			return js;
 		}
 	}
@@ -407,6 +461,9 @@ RZ_API const RzJson *rz_json_get(const RzJson *json, const char *key) {
 }
 
 RZ_API const RzJson *rz_json_item(const RzJson *json, size_t idx) {
+	if (json->type != RZ_JSON_ARRAY && json->type != RZ_JSON_OBJECT) {
+		return NULL;
+	}
 	RzJson *js;
 	for (js = json->children.first; js; js = js->next) {
 		if (!idx--) {
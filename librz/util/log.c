@@ -15,6 +15,7 @@ static int cfg_logtraplvl = RZ_LOGLVL_FATAL; // Log trap level
 static bool cfg_logsrcinfo = false; // Print out debug source info with the output
 static bool cfg_logcolors = false; // Output colored log text based on level
 static char cfg_logfile[LOG_CONFIGSTR_SIZE] = ""; // Output text to filename
+static FILE *log_file = NULL; // cfg_logfile, opened by the first message
 static const char *level_tags[] = { // Log level to tag string lookup array
 	[RZ_LOGLVL_SILLY] = "SILLY",
 	[RZ_LOGLVL_VERBOSE] = "VERBOSE",
@@ -37,6 +38,10 @@ RZ_API void rz_log_set_traplevel(RzLogLevel level) {
 RZ_API void rz_log_set_file(const char *filename) {
 	int value_len = rz_str_nlen(filename, LOG_CONFIGSTR_SIZE) + 1;
 	strncpy(cfg_logfile, filename, value_len);
+	if (log_file) {
+		fclose(log_file);
+		log_file = NULL;
+	}
 }
 
 RZ_API void rz_log_set_srcinfo(bool show_info) {
@@ -47,6 +52,13 @@ RZ_API void rz_log_set_colors(bool show_info) {
 	cfg_logcolors = show_info;
 }
 
+/**
+ * \brief Check if messages of \p level are printed or trap, the RZ_LOG_* macros skip the other ones
+ */
+RZ_API bool rz_log_level_enabled(RzLogLevel level) {
+	return level >= cfg_loglvl || level >= cfg_logtraplvl;
+}
+
 /**
  * \brief Add a logging callback
  * \param cbfunc RzLogCallback style function to be called
@@ -75,7 +87,7 @@ RZ_API void rz_vlog(const char *funcname, const char *filename,
 	va_list args_copy;
 	va_copy(args_copy, args);
 
-	if (level < cfg_loglvl && level < cfg_logtraplvl) {
+	if (!rz_log_level_enabled(level)) {
 		// Don't print if output level is lower than current level
 		// Don't ignore fatal/trap errors
 		va_end(args_copy);
@@ -110,13 +122,16 @@ RZ_API void rz_vlog(const char *funcname, const char *filename,
 
 	// Log to file if enabled
 	if (cfg_logfile[0] != 0x00) {
-		FILE *file = rz_sys_fopen(cfg_logfile, "a+"); // TODO: Optimize (static? Needs to remake on cfg change though)
-		if (!file) {
-			file = rz_sys_fopen(cfg_logfile, "w+");
+		if (!log_file) {
+			// kept open until the file changes
+			log_file = rz_sys_fopen(cfg_logfile, "a+");
+			if (!log_file) {
+				log_file = rz_sys_fopen(cfg_logfile, "w+");
+			}
 		}
-		if (file) {
-			fprintf(file, "%s", output_buf);
-			fclose(file);
+		if (log_file) {
+			fputs(output_buf, log_file);
+			fflush(log_file);
 		} else {
 			eprintf("%s failed to write to file: %s\n", MACRO_LOG_FUNC, cfg_logfile);
 		}
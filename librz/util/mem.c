@@ -244,14 +244,17 @@ RZ_API void rz_mem_swapendian(ut8 *dest, const ut8 *orig, int size) {
 // RZ_DOC rz_mem_mem: Finds the needle of nlen size into the haystack of hlen size
 // RZ_UNIT printf("%s\n", rz_mem_mem("food is pure lame", 20, "is", 2));
 RZ_API const ut8 *rz_mem_mem(const ut8 *haystack, int hlen, const ut8 *needle, int nlen) {
-	int i, until = hlen - nlen + 1;
-	if (hlen < 1 || nlen < 1) {
+	if (hlen < 1 || nlen < 1 || nlen > hlen) {
 		return NULL;
 	}
-	for (i = 0; i < until; i++) {
-		if (!memcmp(haystack + i, needle, nlen)) {
-			return haystack + i;
+	// memchr() of the libc is vectorized, only compare where the first and last bytes match
+	const ut8 *until = haystack + hlen - nlen;
+	const ut8 *p = haystack;
+	while (p <= until && (p = memchr(p, needle[0], until - p + 1))) {
+		if (p[nlen - 1] == needle[nlen - 1] && !memcmp(p, needle, nlen)) {
+			return p;
 		}
+		p++;
 	}
 	return NULL;
 }
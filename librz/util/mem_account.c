@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "thread.h"
+#include <rz_util.h>
+#include <rz_constructor.h>
+
+typedef struct {
+	RzMemAccountCategory cat;
+	size_t size;
+} TrackedBlock;
+
+typedef struct {
+	RzThreadLock *lock;
+	HtUP *blocks; ///< pointer => TrackedBlock *
+	RzMemAccountStats stats[RZ_MEM_ACCOUNT_COUNT];
+} MemAccount;
+
+static MemAccount *account;
+
+static const char *category_names[RZ_MEM_ACCOUNT_COUNT] = {
+	[RZ_MEM_ACCOUNT_ANALYSIS] = "analysis",
+	[RZ_MEM_ACCOUNT_BIN] = "bin",
+	[RZ_MEM_ACCOUNT_FLAG] = "flag",
+	[RZ_MEM_ACCOUNT_IO_CACHE] = "io.cache",
+	[RZ_MEM_ACCOUNT_CONS] = "cons",
+	[RZ_MEM_ACCOUNT_SDB] = "sdb",
+};
+
+static void block_kv_free(HtUPKv *kv) {
+	free(kv->value);
+}
+
+static void account_free(MemAccount *a) {
+	if (!a) {
+		return;
+	}
+	ht_up_free(a->blocks);
+	rz_th_lock_free(a->lock);
+	free(a);
+}
+
+static MemAccount *account_new(void) {
+	MemAccount *a = RZ_NEW0(MemAccount);
+	if (!a) {
+		return NULL;
+	}
+	a->lock = rz_th_lock_new(false);
+	a->blocks = ht_up_new(NULL, block_kv_free, NULL);
+	if (!a->lock || !a->blocks) {
+		account_free(a);
+		return NULL;
+	}
+	return a;
+}
+
+static RzThreadOnce account_once = RZ_THREAD_ONCE_INIT;
+
+static void account_init(void) {
+	account = account_new();
+}
+
+#ifdef RZ_HAS_CONSTRUCTORS
+#ifdef RZ_DEFINE_DESTRUCTOR_NEEDS_PRAGMA
+#pragma RZ_DEFINE_DESTRUCTOR_PRAGMA_ARGS(mem_account_destructor)
+#endif
+RZ_DEFINE_DESTRUCTOR(mem_account_destructor)
+static void mem_account_destructor(void) {
+	account_free(account);
+	account = NULL;
+}
+#endif
+
+static MemAccount *account_get(void) {
+	if (!WITH_MEM_ACCOUNTING) {
+		return NULL;
+	}
+	rz_th_once(&account_once, account_init);
+	return account;
+}
+
+/**
+ * \brief Whether rizin was built with allocation accounting (-Dmem_accounting=true)
+ */
+RZ_API bool rz_mem_account_enabled(void) {
+	return WITH_MEM_ACCOUNTING;
+}
+
+RZ_API const char *rz_mem_account_category_name(RzMemAccountCategory cat) {
+	rz_return_val_if_fail(cat < RZ_MEM_ACCOUNT_COUNT, NULL);
+	return category_names[cat];
+}
+
+/**
+ * \brief Count \p size bytes at \p ptr as alive in \p cat
+ *
+ * Tracking a pointer again replaces its category and size, e.g. after a realloc
+ * that returned the same pointer, without counting another object.
+ */
+RZ_API void rz_mem_account_track(RzMemAccountCategory cat, RZ_NULLABLE const void *ptr, size_t size) {
+	rz_return_if_fail(cat < RZ_MEM_ACCOUNT_COUNT);
+	MemAccount *a = account_get();
+	if (!a || !ptr) {
+		return;
+	}
+	rz_th_lock_enter(a->lock);
+	TrackedBlock *block = ht_up_find(a->blocks, (ut64)(size_t)ptr, NULL);
+	if (block) {
+		RzMemAccountStats *old = &a->stats[block->cat];
+		old->live_bytes -= block->size;
+		old->live_objects--;
+	} else {
+		block = RZ_NEW(TrackedBlock);
+		if (!block || !ht_up_insert(a->blocks, (ut64)(size_t)ptr, block)) {
+			free(block);
+			rz_th_lock_leave(a->lock);
+			return;
+		}
+		a->stats[cat].total_objects++;
+	}
+	block->cat = cat;
+	block->size = size;
+	RzMemAccountStats *stats = &a->stats[cat];
+	stats->live_bytes += size;
+	stats->live_objects++;
+	if (stats->live_bytes > stats->peak_bytes) {
+		stats->peak_bytes = stats->live_bytes;
+	}
+	rz_th_lock_leave(a->lock);
+}
+
+/**
+ * \brief Stop counting \p ptr, to be called before it is freed
+ */
+RZ_API void rz_mem_account_untrack(RZ_NULLABLE const void *ptr) {
+	MemAccount *a = account_get();
+	if (!a || !ptr) {
+		return;
+	}
+	rz_th_lock_enter(a->lock);
+	TrackedBlock *block = ht_up_find(a->blocks, (ut64)(size_t)ptr, NULL);
+	if (block) {
+		RzMemAccountStats *stats = &a->stats[block->cat];
+		stats->live_bytes -= block->size;
+		stats->live_objects--;
+		ht_up_delete(a->blocks, (ut64)(size_t)ptr);
+	}
+	rz_th_lock_leave(a->lock);
+}
+
+RZ_API void rz_mem_account_stats(RzMemAccountCategory cat, RZ_NONNULL RZ_OUT RzMemAccountStats *stats) {
+	rz_return_if_fail(cat < RZ_MEM_ACCOUNT_COUNT && stats);
+	MemAccount *a = account_get();
+	if (!a) {
+		memset(stats, 0, sizeof(*stats));
+		return;
+	}
+	rz_th_lock_enter(a->lock);
+	*stats = a->stats[cat];
+	rz_th_lock_leave(a->lock);
+}
@@ -4,10 +4,41 @@
 #include <rz_util.h>
 #include <rz_util/rz_print.h>
 
+/* json escape sequence of every ascii char, empty if it is written as it is */
+static const char json_esc[0x80][7] = {
+	"\\u0000", "\\u0001", "\\u0002", "\\u0003", "\\u0004", "\\u0005", "\\u0006", "\\u0007",
+	"\\b", "\\t", "\\n", "\\u000b", "\\f", "\\r", "\\u000e", "\\u000f",
+	"\\u0010", "\\u0011", "\\u0012", "\\u0013", "\\u0014", "\\u0015", "\\u0016", "\\u0017",
+	"\\u0018", "\\u0019", "\\u001a", "\\u001b", "\\u001c", "\\u001d", "\\u001e", "\\u001f",
+	"", "", "\\\"", "", "", "", "", "",
+	"", "", "", "", "", "", "", "",
+	"", "", "", "", "", "", "", "",
+	"", "", "", "", "", "", "", "",
+	"", "", "", "", "", "", "", "",
+	"", "", "", "", "", "", "", "",
+	"", "", "", "", "", "", "", "",
+	"", "", "", "", "\\\\", "", "", "",
+	"", "", "", "", "", "", "", "",
+	"", "", "", "", "", "", "", "",
+	"", "", "", "", "", "", "", "",
+	"", "", "", "", "", "", "", "\\u007f",
+};
+
+static void pj_append(PJ *j, const char *s, size_t len) {
+	rz_strbuf_append_n(&j->sb, s, len);
+	if (j->sink && rz_strbuf_length(&j->sb) >= j->sink_threshold) {
+		pj_flush(j);
+	}
+}
+
+static void pj_char(PJ *j, char c) {
+	pj_append(j, &c, 1);
+}
+
 RZ_API void pj_raw(PJ *j, const char *msg) {
 	rz_return_if_fail(j && msg);
 	if (*msg) {
-		rz_strbuf_append(&j->sb, msg);
+		pj_append(j, msg, strlen(msg));
 	}
 }
 
@@ -15,13 +46,75 @@ static void pj_comma(PJ *j) {
 	rz_return_if_fail(j);
 	if (!j->is_key) {
 		if (!j->is_first) {
-			pj_raw(j, ",");
+			pj_char(j, ',');
 		}
 	}
 	j->is_first = false;
 	j->is_key = false;
 }
 
+static void pj_hex4(PJ *j, RzRune r) {
+	char u[6] = { '\\', 'u' };
+	int i;
+	for (i = 0; i < 4; i++) {
+		u[2 + i] = "0123456789abcdef"[(r >> (12 - 4 * i)) & 0xf];
+	}
+	pj_append(j, u, sizeof(u));
+}
+
+/*
+ * Same output as rz_str_escape_utf8_for_json(), but written straight into
+ * the buffer and copying runs of plain chars at once.
+ */
+static void pj_escape(PJ *j, const char *str) {
+	const ut8 *p = (const ut8 *)str;
+	const ut8 *end = p + strlen(str);
+	const ut8 *run = p;
+	while (p < end) {
+		if (*p < 0x80) {
+			const char *esc = json_esc[*p];
+			if (*esc) {
+				pj_append(j, (const char *)run, p - run);
+				pj_append(j, esc, esc[1] == 'u' ? 6 : 2);
+				run = p + 1;
+			}
+			p++;
+			continue;
+		}
+		RzRune ch;
+		int n = rz_utf8_decode(p, end - p, &ch);
+		if (n && rz_rune_is_printable(ch)) {
+			p += n;
+			continue;
+		}
+		pj_append(j, (const char *)run, p - run);
+		if (n == 4) {
+			ch -= 0x10000;
+			pj_hex4(j, 0xd800 + (ch >> 10 & 0x3ff));
+			pj_hex4(j, 0xdc00 + (ch & 0x3ff));
+		} else if (n) {
+			pj_hex4(j, ch);
+		}
+		// invalid utf-8 is dropped
+		p += n ? n : 1;
+		run = p;
+	}
+	pj_append(j, (const char *)run, p - run);
+}
+
+static void pj_number(PJ *j, ut64 n, bool neg) {
+	char buf[24];
+	char *p = buf + sizeof(buf);
+	do {
+		*--p = '0' + n % 10;
+		n /= 10;
+	} while (n);
+	if (neg) {
+		*--p = '-';
+	}
+	pj_append(j, p, buf + sizeof(buf) - p);
+}
+
 RZ_API PJ *pj_new(void) {
 	PJ *j = RZ_NEW0(PJ);
 	if (j) {
@@ -39,6 +132,45 @@ RZ_API void pj_free(PJ *pj) {
 	free(pj);
 }
 
+/**
+ * \brief Hand the json written so far to \p sink whenever more than \p threshold bytes are buffered
+ *
+ * Big documents then never have to be held in memory as a whole. Once a
+ * sink is set, pj_string() and pj_drain() only return what has not been
+ * flushed yet, and pj_flush() has to be called once the document is done.
+ */
+RZ_API void pj_set_sink(RZ_NONNULL PJ *j, RZ_NULLABLE PJSink sink, void *user, size_t threshold) {
+	rz_return_if_fail(j);
+	j->sink = sink;
+	j->sink_user = user;
+	j->sink_threshold = threshold;
+}
+
+/**
+ * \brief Pass everything buffered to the sink of \p j, if any
+ */
+RZ_API void pj_flush(RZ_NONNULL PJ *j) {
+	rz_return_if_fail(j);
+	if (!j->sink || rz_strbuf_is_empty(&j->sb)) {
+		return;
+	}
+	j->sink(j->sink_user, rz_strbuf_get(&j->sb), rz_strbuf_length(&j->sb));
+	// keep the allocation around for the next round
+	j->sb.len = 0;
+	*rz_strbuf_get(&j->sb) = 0;
+}
+
+/**
+ * \brief Hint that about \p size more bytes are going to be written
+ */
+RZ_API void pj_reserve(RZ_NONNULL PJ *j, size_t size) {
+	rz_return_if_fail(j);
+	if (j->sink) {
+		size = RZ_MIN(size, j->sink_threshold);
+	}
+	rz_strbuf_reserve(&j->sb, rz_strbuf_length(&j->sb) + size);
+}
+
 RZ_API void pj_reset(PJ *j) {
 	rz_return_if_fail(j);
 	rz_strbuf_set(&j->sb, "");
@@ -63,8 +195,7 @@ static PJ *pj_begin(PJ *j, char type) {
 		if (!j || j->level >= RZ_PRINT_JSON_DEPTH_LIMIT) {
 			return NULL;
 		}
-		char msg[2] = { type, 0 };
-		pj_raw(j, msg);
+		pj_char(j, type);
 		j->braces[j->level] = (type == '{') ? '}' : ']';
 		j->level++;
 		j->is_first = true;
@@ -90,14 +221,12 @@ RZ_API PJ *pj_end(PJ *j) {
 		return j;
 	}
 	if (--j->level < 1) {
-		char msg[2] = { j->braces[j->level], 0 };
-		pj_raw(j, msg);
+		pj_char(j, j->braces[j->level]);
 		j->level = 0;
 		return j;
 	}
 	j->is_first = false;
-	char msg[2] = { j->braces[j->level], 0 };
-	pj_raw(j, msg);
+	pj_char(j, j->braces[j->level]);
 	return j;
 }
 
@@ -105,7 +234,7 @@ RZ_API PJ *pj_k(PJ *j, const char *k) {
 	rz_return_val_if_fail(j && k, j);
 	j->is_key = false;
 	pj_s(j, k);
-	pj_raw(j, ":");
+	pj_char(j, ':');
 	j->is_first = false;
 	j->is_key = true;
 	return j;
@@ -197,28 +326,16 @@ RZ_API PJ *pj_b(PJ *j, bool v) {
 RZ_API PJ *pj_s(PJ *j, const char *k) {
 	rz_return_val_if_fail(j && k, j);
 	pj_comma(j);
-	pj_raw(j, "\"");
-	char *ek = rz_str_escape_utf8_for_json(k, -1);
-	if (ek) {
-		pj_raw(j, ek);
-		free(ek);
-	} else {
-		eprintf("cannot escape string\n");
-	}
-	pj_raw(j, "\"");
+	pj_char(j, '"');
+	pj_escape(j, k);
+	pj_char(j, '"');
 	return j;
 }
 
 RZ_API PJ *pj_S(PJ *j, const char *k) {
 	rz_return_val_if_fail(j && k, j);
 	pj_comma(j);
-	char *ek = rz_str_escape_utf8_for_json(k, -1);
-	if (ek) {
-		pj_raw(j, ek);
-		free(ek);
-	} else {
-		eprintf("cannot escape string\n");
-	}
+	pj_escape(j, k);
 	return j;
 }
 
@@ -252,16 +369,14 @@ RZ_API PJ *pj_j(PJ *j, const char *k) {
 RZ_API PJ *pj_n(PJ *j, ut64 n) {
 	rz_return_val_if_fail(j, j);
 	pj_comma(j);
-	char s[64] = { 0 };
-	pj_raw(j, rz_strf(s, "%" PFMT64u, n));
+	pj_number(j, n, false);
 	return j;
 }
 
 RZ_API PJ *pj_N(PJ *j, st64 n) {
 	rz_return_val_if_fail(j, NULL);
 	pj_comma(j);
-	char s[64] = { 0 };
-	pj_raw(j, rz_strf(s, "%" PFMT64d, n));
+	pj_number(j, n < 0 ? 0 - (ut64)n : (ut64)n, n < 0);
 	return j;
 }
 
@@ -284,8 +399,7 @@ RZ_API PJ *pj_d(PJ *j, double d) {
 RZ_API PJ *pj_i(PJ *j, int i) {
 	if (j) {
 		pj_comma(j);
-		char s[64] = { 0 };
-		pj_raw(j, rz_strf(s, "%d", i));
+		pj_number(j, i < 0 ? 0 - (ut64)i : (ut64)i, i < 0);
 	}
 	return j;
 }
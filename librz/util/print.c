@@ -512,6 +512,59 @@ RZ_API void rz_print_section(RzPrint *p, ut64 at) {
 	}
 }
 
+/*
+ * The rows of a plain "px" are built in a buffer and printed at once,
+ * printing each byte on its own costs several callbacks for it.
+ * The output is the same as the one of rz_print_byte().
+ */
+static void hexdump_append_byte(RzPrint *p, RzStrBuf *sb, const char *digits, size_t n, ut8 ch) {
+	const char *color = (p->flags & RZ_PRINT_FLAGS_COLOR) ? rz_print_byte_color(p, ch) : NULL;
+	if (color) {
+		rz_strbuf_append(sb, color);
+	}
+	rz_strbuf_append_n(sb, digits, n);
+	if (color) {
+		rz_strbuf_append_n(sb, Color_RESET, strlen(Color_RESET));
+	}
+}
+
+/* hex column of a row in base 16, without cursor nor alignment, returns where it stopped */
+static size_t hexdump_hex_row(RzPrint *p, RzStrBuf *sb, const ut8 *buf, size_t i, size_t len, int inc, bool compact, bool pairs, int rows) {
+	static const char digits[] = "0123456789abcdef";
+	size_t j;
+	for (j = i; j < i + inc; j++) {
+		if (j >= len) {
+			if (compact) {
+				break;
+			}
+			rz_strbuf_append(sb, j % 2 ? "   " : "  ");
+			continue;
+		}
+		char pair[2] = { digits[buf[j] >> 4], digits[buf[j] & 0xf] };
+		hexdump_append_byte(p, sb, pair, 2, buf[j]);
+		if (pairs && !compact && (inc & 1)) {
+			bool mustspace = (rows % 2) ? !(j & 1) : (j & 1);
+			if (mustspace) {
+				rz_strbuf_append_n(sb, " ", 1);
+			}
+		} else if (((j - i) % 2 || !pairs) && !compact) {
+			rz_strbuf_append_n(sb, " ", 1);
+		}
+	}
+	return j;
+}
+
+/* ascii column of a row, without alignment nor unallocated bytes, returns where it stopped */
+static size_t hexdump_ascii_row(RzPrint *p, RzStrBuf *sb, const ut8 *buf, size_t i, size_t len, int inc) {
+	size_t end = RZ_MIN(i + inc, len);
+	size_t j;
+	for (j = i; j < end; j++) {
+		char ch = IS_PRINTABLE(buf[j]) ? buf[j] : '.';
+		hexdump_append_byte(p, sb, &ch, 1, buf[j]);
+	}
+	return j;
+}
+
 RZ_API void rz_print_hexdump(RzPrint *p, ut64 addr, const ut8 *buf, int len, int base, int step, size_t zoomsz) {
 	rz_return_if_fail(p && buf && len > 0);
 	PrintfCallback printfmt = (PrintfCallback)printf;
@@ -731,6 +784,9 @@ RZ_API void rz_print_hexdump(RzPrint *p, ut64 addr, const ut8 *buf, int len, int
 	bool printValue = true;
 	bool oPrintValue = true;
 	bool isPxr = (p && p->flags & RZ_PRINT_FLAGS_REFS);
+	bool fast_rows = p && base == 16 && col == 0 && !use_align && !use_unalloc && !hex_style && !p->cur_enabled;
+	RzStrBuf row;
+	rz_strbuf_init(&row);
 
 	for (i = j = 0; i < len; i += (stride ? stride : inc)) {
 		if (p && p->cons && p->cons->context && p->cons->context->breaked) {
@@ -775,170 +831,176 @@ RZ_API void rz_print_hexdump(RzPrint *p, ut64 addr, const ut8 *buf, int len, int
 			if (!compact && !isPxr) {
 				print((col == 1) ? "|" : " ");
 			}
-			for (j = i; j < i + inc; j++) {
-				if (j != i && use_align && rowbytes == inc) {
-					int sz = (p && p->offsize) ? p->offsize(p->user, addr + j) : -1;
-					if (sz >= 0) {
-						rowbytes = bytes;
-					}
-				}
-				if (row_have_cursor == -1) {
-					if (rz_print_cursor_pointer(p, j, 1)) {
-						row_have_cursor = j - i;
-						row_have_addr = addr + j;
+			if (fast_rows) {
+				rz_strbuf_set(&row, "");
+				j = hexdump_hex_row(p, &row, buf, i, len, inc, compact, pairs, rows);
+				print(rz_strbuf_get(&row));
+			} else {
+				for (j = i; j < i + inc; j++) {
+					if (j != i && use_align && rowbytes == inc) {
+						int sz = (p && p->offsize) ? p->offsize(p->user, addr + j) : -1;
+						if (sz >= 0) {
+							rowbytes = bytes;
+						}
 					}
-				}
-				if (!compact && ((j >= len) || bytes >= rowbytes)) {
-					if (col == 1) {
-						if (j + 1 >= inc + i) {
-							print(j % 2 ? "  |" : "| ");
-						} else {
-							print(j % 2 ? "   " : "  ");
+					if (row_have_cursor == -1) {
+						if (rz_print_cursor_pointer(p, j, 1)) {
+							row_have_cursor = j - i;
+							row_have_addr = addr + j;
 						}
-					} else {
-						if (base == 32) {
-							print((j % 4) ? "   " : "  ");
-						} else if (base == 10) {
-							print(j % 2 ? "     " : "  ");
+					}
+					if (!compact && ((j >= len) || bytes >= rowbytes)) {
+						if (col == 1) {
+							if (j + 1 >= inc + i) {
+								print(j % 2 ? "  |" : "| ");
+							} else {
+								print(j % 2 ? "   " : "  ");
+							}
 						} else {
-							print(j % 2 ? "   " : "  ");
+							if (base == 32) {
+								print((j % 4) ? "   " : "  ");
+							} else if (base == 10) {
+								print(j % 2 ? "     " : "  ");
+							} else {
+								print(j % 2 ? "   " : "  ");
+							}
 						}
-					}
-					continue;
-				}
-				const char *hl = (hex_style && p && p->offname(p->user, addr + j)) ? Color_INVERT : NULL;
-				if (hl) {
-					print(hl);
-				}
-				if (p && (base == 32 || base == 64)) {
-					int left = len - i;
-					/* TODO: check step. it should be 2/4 for base(32) and 8 for
-					 *       base(64) */
-					ut64 n = 0;
-					size_t sz_n = (base == 64)
-						? sizeof(ut64)
-						: (step == 2)
-						? sizeof(ut16)
-						: sizeof(ut32);
-					sz_n = RZ_MIN(left, sz_n);
-					if (j + sz_n > len) {
-						// oob
-						j += sz_n;
 						continue;
 					}
-					rz_mem_swaporcopy((ut8 *)&n, buf + j, sz_n, p && p->big_endian);
-					rz_print_cursor(p, j, sz_n, 1);
-					// stub for colors
-					if (p && p->colorfor) {
-						if (!p->iob.addr_is_mapped(p->iob.io, addr + j)) {
-							a = p->cons->context->pal.ai_unmap;
-						} else {
-							a = p->colorfor(p->user, n, true);
+					const char *hl = (hex_style && p && p->offname(p->user, addr + j)) ? Color_INVERT : NULL;
+					if (hl) {
+						print(hl);
+					}
+					if (p && (base == 32 || base == 64)) {
+						int left = len - i;
+						/* TODO: check step. it should be 2/4 for base(32) and 8 for
+						 *       base(64) */
+						ut64 n = 0;
+						size_t sz_n = (base == 64)
+							? sizeof(ut64)
+							: (step == 2)
+							? sizeof(ut16)
+							: sizeof(ut32);
+						sz_n = RZ_MIN(left, sz_n);
+						if (j + sz_n > len) {
+							// oob
+							j += sz_n;
+							continue;
 						}
-						if (a && *a) {
-							b = Color_RESET;
+						rz_mem_swaporcopy((ut8 *)&n, buf + j, sz_n, p && p->big_endian);
+						rz_print_cursor(p, j, sz_n, 1);
+						// stub for colors
+						if (p && p->colorfor) {
+							if (!p->iob.addr_is_mapped(p->iob.io, addr + j)) {
+								a = p->cons->context->pal.ai_unmap;
+							} else {
+								a = p->colorfor(p->user, n, true);
+							}
+							if (a && *a) {
+								b = Color_RESET;
+							} else {
+								a = b = "";
+							}
 						} else {
 							a = b = "";
 						}
-					} else {
-						a = b = "";
-					}
-					printValue = true;
-					bool hasNull = false;
-					if (isPxr) {
-						if (n == 0) {
-							if (oPrintValue) {
-								hasNull = true;
+						printValue = true;
+						bool hasNull = false;
+						if (isPxr) {
+							if (n == 0) {
+								if (oPrintValue) {
+									hasNull = true;
+								}
+								printValue = false;
 							}
-							printValue = false;
-						}
-					}
-					if (printValue) {
-						if (use_offset && !hasNull && isPxr) {
-							rz_print_section(p, at);
-							rz_print_addr(p, addr + j * zoomsz);
 						}
-						if (base == 64) {
-							printfmt("%s0x%016" PFMT64x "%s  ", a, (ut64)n, b);
-						} else if (step == 2) {
-							printfmt("%s0x%04x%s ", a, (ut16)n, b);
+						if (printValue) {
+							if (use_offset && !hasNull && isPxr) {
+								rz_print_section(p, at);
+								rz_print_addr(p, addr + j * zoomsz);
+							}
+							if (base == 64) {
+								printfmt("%s0x%016" PFMT64x "%s  ", a, (ut64)n, b);
+							} else if (step == 2) {
+								printfmt("%s0x%04x%s ", a, (ut16)n, b);
+							} else {
+								printfmt("%s0x%08x%s ", a, (ut32)n, b);
+							}
 						} else {
-							printfmt("%s0x%08x%s ", a, (ut32)n, b);
+							if (hasNull) {
+								const char *n = p->offname(p->user, addr + j);
+								rz_print_section(p, at);
+								rz_print_addr(p, addr + j * zoomsz);
+								printfmt("..[ null bytes ]..   00000000 %s\n", n ? n : "");
+							}
 						}
-					} else {
-						if (hasNull) {
-							const char *n = p->offname(p->user, addr + j);
-							rz_print_section(p, at);
-							rz_print_addr(p, addr + j * zoomsz);
-							printfmt("..[ null bytes ]..   00000000 %s\n", n ? n : "");
+						rz_print_cursor(p, j, sz_n, 0);
+						oPrintValue = printValue;
+						j += step - 1;
+					} else if (base == -8) {
+						long long w = rz_read_ble64(buf + j, p && p->big_endian);
+						rz_print_cursor(p, j, 8, 1);
+						printfmt("%23" PFMT64d " ", w);
+						rz_print_cursor(p, j, 8, 0);
+						j += 7;
+					} else if (base == -1) {
+						st8 w = rz_read_ble8(buf + j);
+						rz_print_cursor(p, j, 1, 1);
+						printfmt("%4d ", w);
+						rz_print_cursor(p, j, 1, 0);
+					} else if (base == -10) {
+						if (j + 1 < len) {
+							st16 w = rz_read_ble16(buf + j, p && p->big_endian);
+							rz_print_cursor(p, j, 2, 1);
+							printfmt("%7d ", w);
+							rz_print_cursor(p, j, 2, 0);
 						}
-					}
-					rz_print_cursor(p, j, sz_n, 0);
-					oPrintValue = printValue;
-					j += step - 1;
-				} else if (base == -8) {
-					long long w = rz_read_ble64(buf + j, p && p->big_endian);
-					rz_print_cursor(p, j, 8, 1);
-					printfmt("%23" PFMT64d " ", w);
-					rz_print_cursor(p, j, 8, 0);
-					j += 7;
-				} else if (base == -1) {
-					st8 w = rz_read_ble8(buf + j);
-					rz_print_cursor(p, j, 1, 1);
-					printfmt("%4d ", w);
-					rz_print_cursor(p, j, 1, 0);
-				} else if (base == -10) {
-					if (j + 1 < len) {
-						st16 w = rz_read_ble16(buf + j, p && p->big_endian);
-						rz_print_cursor(p, j, 2, 1);
-						printfmt("%7d ", w);
-						rz_print_cursor(p, j, 2, 0);
-					}
-					j += 1;
-				} else if (base == 10) { // "pxd"
-					if (j + 3 < len) {
-						int w = rz_read_ble32(buf + j, p && p->big_endian);
-						rz_print_cursor(p, j, 4, 1);
-						printfmt("%13d ", w);
-						rz_print_cursor(p, j, 4, 0);
-					}
-					j += 3;
-				} else {
-					if (j >= len) {
-						break;
-					}
-					if (use_unalloc && !p->iob.is_valid_offset(p->iob.io, addr + j, false)) {
-						char ch = p->io_unalloc_ch;
-						char dbl_ch_str[] = { ch, ch, 0 };
-						p->cb_printf("%s", dbl_ch_str);
+						j += 1;
+					} else if (base == 10) { // "pxd"
+						if (j + 3 < len) {
+							int w = rz_read_ble32(buf + j, p && p->big_endian);
+							rz_print_cursor(p, j, 4, 1);
+							printfmt("%13d ", w);
+							rz_print_cursor(p, j, 4, 0);
+						}
+						j += 3;
 					} else {
-						rz_print_byte(p, bytefmt, j, buf[j]);
-					}
-					if (pairs && !compact && (inc & 1)) {
-						bool mustspace = (rows % 2) ? !(j & 1) : (j & 1);
-						if (mustspace) {
-							print(" ");
+						if (j >= len) {
+							break;
 						}
-					} else if (bytes % 2 || !pairs) {
-						if (col == 1) {
-							if (j + 1 < inc + i) {
+						if (use_unalloc && !p->iob.is_valid_offset(p->iob.io, addr + j, false)) {
+							char ch = p->io_unalloc_ch;
+							char dbl_ch_str[] = { ch, ch, 0 };
+							p->cb_printf("%s", dbl_ch_str);
+						} else {
+							rz_print_byte(p, bytefmt, j, buf[j]);
+						}
+						if (pairs && !compact && (inc & 1)) {
+							bool mustspace = (rows % 2) ? !(j & 1) : (j & 1);
+							if (mustspace) {
+								print(" ");
+							}
+						} else if (bytes % 2 || !pairs) {
+							if (col == 1) {
+								if (j + 1 < inc + i) {
+									if (!compact) {
+										print(" ");
+									}
+								} else {
+									print("|");
+								}
+							} else {
 								if (!compact) {
 									print(" ");
 								}
-							} else {
-								print("|");
-							}
-						} else {
-							if (!compact) {
-								print(" ");
 							}
 						}
 					}
+					if (hl) {
+						print(Color_RESET);
+					}
+					bytes++;
 				}
-				if (hl) {
-					print(Color_RESET);
-				}
-				bytes++;
 			}
 		}
 		if (printValue) {
@@ -953,7 +1015,11 @@ RZ_API void rz_print_hexdump(RzPrint *p, ut64 addr, const ut8 *buf, int len, int
 			} else {
 				print((col == 2) ? "|" : " ");
 			}
-			if (!p || !(p->flags & RZ_PRINT_FLAGS_NONASCII)) {
+			if (fast_rows && !(p->flags & RZ_PRINT_FLAGS_NONASCII)) {
+				rz_strbuf_set(&row, "");
+				j = hexdump_ascii_row(p, &row, buf, i, len, inc);
+				print(rz_strbuf_get(&row));
+			} else if (!p || !(p->flags & RZ_PRINT_FLAGS_NONASCII)) {
 				bytes = 0;
 				size_t end = i + inc;
 				for (j = i; j < end; j++) {
@@ -1069,6 +1135,7 @@ RZ_API void rz_print_hexdump(RzPrint *p, ut64 addr, const ut8 *buf, int len, int
 			}
 		}
 	}
+	rz_strbuf_fini(&row);
 }
 
 static const char *getbytediff(RzPrint *p, char *fmt, ut8 a, ut8 b) {
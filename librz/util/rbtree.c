@@ -231,6 +231,47 @@ RZ_API bool rz_rbtree_aug_insert(RBNode **root, void *data, RBNode *node, RBComp
 	return done;
 }
 
+static RBNode *bulk_load(RBNode **nodes, size_t count, int depth, int red_depth, RBNodeSum sum) {
+	if (!count) {
+		return NULL;
+	}
+	size_t mid = count / 2;
+	RBNode *node = nodes[mid];
+	node->child[0] = bulk_load(nodes, mid, depth + 1, red_depth, sum);
+	node->child[1] = bulk_load(nodes + mid + 1, count - mid - 1, depth + 1, red_depth, sum);
+	node->red = depth && depth == red_depth;
+	if (sum) {
+		sum(node);
+	}
+	return node;
+}
+
+/**
+ * \brief Builds a balanced tree holding \p nodes in O(n)
+ *
+ * Splitting the nodes in halves keeps every path from the root to a leaf
+ * of the same length, give or take one: only the deepest level may be
+ * incomplete, so it is colored red and all the others black.
+ *
+ * \param root  The tree, which must be empty
+ * \param nodes The nodes to insert, already sorted as the tree comparator would do
+ * \param count The number of nodes
+ * \param sum   The augmentation callback, or NULL
+ */
+RZ_API bool rz_rbtree_aug_bulk_load(RBNode **root, RBNode **nodes, size_t count, RBNodeSum sum) {
+	rz_return_val_if_fail(root && !*root && (nodes || !count), false);
+	int height = 0;
+	for (size_t n = count; n; n >>= 1) {
+		height++;
+	}
+	if (height > RZ_RBTREE_MAX_HEIGHT) {
+		RZ_LOG_ERROR("Red-black tree depth is too big\n");
+		return false;
+	}
+	*root = bulk_load(nodes, count, 0, height - 1, sum);
+	return true;
+}
+
 /// Returns true if the sum has been updated, false if node has not been found
 RZ_API bool rz_rbtree_aug_update_sum(RBNode *root, void *data, RBNode *node, RBComparator cmp, void *cmp_user, RBNodeSum sum) {
 	size_t dep = 0;
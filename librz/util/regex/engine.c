@@ -90,6 +90,9 @@ static char *backref(struct match *, char *, char *, sopno, sopno, sopno, int);
 static char *fast(struct match *, char *, char *, sopno, sopno);
 static char *slow(struct match *, char *, char *, sopno, sopno);
 static states step(struct re_guts *, sopno, sopno, states, int, states);
+#ifdef SNAMES
+static bool dfafast(struct match *, char *, char *, sopno, sopno, char **);
+#endif
 #define MAX_RECURSION 100
 #define BOL           (OUT + 1)
 #define EOL           (BOL + 1)
@@ -156,11 +159,11 @@ matcher(struct re_guts *g, char *string, size_t nmatch, RzRegexMatch pmatch[],
 
 	/* prescreening; this does wonders for this rather slow code */
 	if (g->must != NULL) {
-		for (dp = start; dp < stop; dp++)
-			if (*dp == g->must[0] && stop - dp >= g->mlen &&
+		for (dp = start; (dp = memchr(dp, g->must[0], stop - dp)); dp++)
+			if (stop - dp >= g->mlen &&
 				memcmp(dp, g->must, (size_t)g->mlen) == 0)
 				break;
-		if (dp == stop) /* we didn't find g->must */
+		if (!dp) /* we didn't find g->must */
 			return (RZ_REGEX_NOMATCH);
 	}
 
@@ -725,6 +728,16 @@ fast(struct match *m, char *start, char *stop, sopno startst, sopno stopst) {
 	int i;
 	char *coldp; /* last p after which no match was underway */
 
+#ifdef SNAMES
+	if (m->g->dfa && rz_th_lock_tryenter(m->g->dfa->lock)) {
+		bool done = dfafast(m, start, stop, startst, stopst, &p);
+		rz_th_lock_leave(m->g->dfa->lock);
+		if (done) {
+			return p;
+		}
+		p = start;
+	}
+#endif
 	CLEAR(st);
 	SET1(st, startst);
 	st = step(m->g, startst, stopst, st, NOTHING, st);
@@ -1001,6 +1014,109 @@ step(struct re_guts *g,
 	return (aft);
 }
 
+#ifdef SNAMES
+/*
+ - dfastate - DFA state of a set of states, added if not there yet
+ *
+ * A full cache is flushed, keeping only the fresh start state 0.
+ * Returns -1 if out of memory.
+ */
+static int
+dfastate(struct re_dfa *dfa, states st, bool *flushed) {
+	int i;
+
+	*flushed = false;
+	for (i = 0; i < dfa->nsets; i++) {
+		if (EQ((states)dfa->sets[i], st)) {
+			return i;
+		}
+	}
+	if (dfa->nsets == DFA_STATES_MAX) {
+		dfa->nsets = 1;
+		memset(dfa->next, 0xff, 256 * sizeof(st16));
+		*flushed = true;
+	}
+	if (dfa->nsets == dfa->size) {
+		int size = dfa->size ? dfa->size * 2 : 8;
+		unsigned long *sets = realloc(dfa->sets, size * sizeof(unsigned long));
+		if (!sets) {
+			return -1;
+		}
+		dfa->sets = sets;
+		st16 *next = realloc(dfa->next, size * 256 * sizeof(st16));
+		if (!next) {
+			return -1;
+		}
+		dfa->next = next;
+		dfa->size = size;
+	}
+	i = dfa->nsets++;
+	dfa->sets[i] = (unsigned long)st;
+	memset(dfa->next + i * 256, 0xff, 256 * sizeof(st16));
+	return i;
+}
+
+/*
+ - dfafast - fast() over the DFA cache, the caller holds its lock
+ *
+ * Returns false if the cache could not grow, leaving the work to fast().
+ */
+static bool
+dfafast(struct match *m, char *start, char *stop, sopno startst, sopno stopst, char **endp) {
+	struct re_guts *g = m->g;
+	struct re_dfa *dfa = g->dfa;
+	states st;
+	states fresh;
+	states tmp;
+	char *p = start;
+	char *coldp = NULL;
+	bool flushed;
+	int d = 0;
+	int nd;
+
+	CLEAR(fresh);
+	SET1(fresh, startst);
+	fresh = step(g, startst, stopst, fresh, NOTHING, fresh);
+	if (!dfa->nsets && dfastate(dfa, fresh, &flushed) < 0) {
+		return false;
+	}
+	ASSIGN(st, fresh);
+	for (;;) {
+		if (d == 0)
+			coldp = p;
+		if (ISSET(st, stopst) || p == stop)
+			break;
+		nd = dfa->next[d * 256 + (ut8)*p];
+		if (nd == DFA_UNKNOWN) {
+			tmp = step(g, startst, stopst, st, *p, fresh);
+			if (!EQ(step(g, startst, stopst, tmp, NOTHING, tmp), tmp)) {
+				/* same bail out as fast() */
+				ASSIGN(st, tmp);
+				break;
+			}
+			nd = dfastate(dfa, tmp, &flushed);
+			if (nd < 0) {
+				return false;
+			}
+			if (!flushed || d == 0) {
+				dfa->next[d * 256 + (ut8)*p] = nd;
+			}
+		}
+		d = nd;
+		st = (states)dfa->sets[d];
+		p++;
+	}
+
+	*endp = NULL;
+	if (coldp) {
+		m->coldp = coldp;
+		if (ISSET(st, stopst))
+			*endp = p + 1;
+	}
+	return true;
+}
+#endif
+
 #ifdef REDEBUG
 /*
  - print - print a set of states
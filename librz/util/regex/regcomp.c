@@ -106,6 +106,8 @@ static void enlarge(struct parse *, sopno);
 static void stripsnug(struct parse *, struct re_guts *);
 static void findmust(struct parse *, struct re_guts *);
 static sopno pluscount(struct parse *, struct re_guts *);
+static void dfasetup(struct parse *, struct re_guts *);
+static void dfafree(struct re_dfa *);
 
 static char nuls[10]; /* place to point scanner in event of error */
 
@@ -220,6 +222,9 @@ RZ_API int rz_regex_flags(const char *f) {
 	if (strchr(f, 'd')) {
 		flags |= RZ_REGEX_DUMP;
 	}
+	if (strchr(f, 'D')) {
+		flags |= RZ_REGEX_NODFA;
+	}
 	return flags;
 }
 
@@ -243,6 +248,7 @@ RZ_API void rz_regex_fini(RzRegex *preg) {
 	free(g->sets);
 	free(g->setbits);
 	free(g->must);
+	dfafree(g->dfa);
 	free(g);
 }
 
@@ -359,6 +365,7 @@ RZ_API int rz_regex_comp(RzRegex *preg, const char *pattern, int cflags) {
 	stripsnug(p, g);
 	findmust(p, g);
 	g->nplus = pluscount(p, g);
+	dfasetup(p, g);
 	g->magic = MAGIC2;
 	preg->re_nsub = g->nsub;
 	preg->re_g = g;
@@ -1759,3 +1766,51 @@ pluscount(struct parse *p, struct re_guts *g) {
 	}
 	return (maxnest);
 }
+
+/*
+ - dfasetup - give a DFA cache to the patterns which can use one
+ *
+ * The transitions themselves are only computed while matching.
+ */
+static void
+dfasetup(struct parse *p, struct re_guts *g) {
+	sop *scan;
+	sop s;
+
+	if (p->error != 0 || g->iflags & BAD || g->cflags & RZ_REGEX_NODFA) {
+		return;
+	}
+	/* the DFA only knows the characters, not what surrounds them */
+	if (g->backrefs || g->nbol || g->neol || g->nstates > CHAR_BIT * sizeof(long)) {
+		return;
+	}
+	scan = g->strip + 1;
+	do {
+		s = *scan++;
+		if (OP(s) == OBOW || OP(s) == OEOW) {
+			return;
+		}
+	} while (OP(s) != OEND);
+
+	struct re_dfa *dfa = RZ_NEW0(struct re_dfa);
+	if (!dfa) {
+		return;
+	}
+	dfa->lock = rz_th_lock_new(false);
+	if (!dfa->lock) {
+		free(dfa);
+		return;
+	}
+	g->dfa = dfa;
+}
+
+static void
+dfafree(struct re_dfa *dfa) {
+	if (!dfa) {
+		return;
+	}
+	rz_th_lock_free(dfa->lock);
+	free(dfa->sets);
+	free(dfa->next);
+	free(dfa);
+}
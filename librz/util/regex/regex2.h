@@ -38,6 +38,8 @@
 /*
  * internals of regex_t
  */
+
+#include <rz_th.h>
 #define MAGIC1 ((('r' ^ 0200) << 8) | 'e')
 
 /*
@@ -120,6 +122,26 @@ typedef struct {
 /* stuff for character categories */
 typedef unsigned char cat_t;
 
+/*
+ * Lazily built DFA of the patterns fitting the small state representation
+ * and needing no context (no anchors, word boundaries or back references).
+ * Each DFA state is a set of strip states, its transitions are computed
+ * with step() the first time a byte is seen in it and cached afterwards,
+ * so matching costs a table lookup per byte. State 0 is the fresh start.
+ * The cache is shared by the users of the compiled regex, the one holding
+ * the lock uses it while the others fall back to stepping the sets.
+ */
+#define DFA_STATES_MAX 128
+#define DFA_UNKNOWN    (-1)
+
+struct re_dfa {
+	RzThreadLock *lock;
+	unsigned long *sets; /* -> unsigned long [size], strip states of each DFA state */
+	st16 *next; /* -> st16 [size][256], DFA_UNKNOWN until computed */
+	int nsets; /* DFA states in use */
+	int size; /* DFA states allocated */
+};
+
 /*
  * main compiled-expression structure
  */
@@ -148,6 +170,7 @@ struct re_guts {
 	size_t nsub; /* copy of re_nsub */
 	int backrefs; /* does it use back references? */
 	sopno nplus; /* how deep does it nest +s? */
+	struct re_dfa *dfa; /* NULL if the pattern cannot use one */
 	/* catspace must be last */
 	cat_t catspace[1]; /* actually [NC] */
 };
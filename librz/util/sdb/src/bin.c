@@ -0,0 +1,391 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: MIT
+
+#include "sdb.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#if HAVE_HEADER_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+#include "sdb_private.h"
+
+/**
+ * *****************
+ * Binary SDB Format
+ * *****************
+ *
+ * All integers are little endian. The file starts with a fixed header:
+ *
+ *   ut8[8] magic       "\x7fSDBBIN\n"
+ *   ut32   version     SDB_BIN_VERSION
+ *   ut32   sections    number of entries in the section table
+ *   ut64   table       offset of the section table
+ *
+ * Every namespace (including the root) is stored as one section: a contiguous
+ * run of entries, each one being
+ *
+ *   ut32   key_len
+ *   ut8[]  key, followed by a '\0'
+ *   ut32   value_len
+ *   ut8[]  value, followed by a '\0'
+ *
+ * Nothing is escaped. Because the strings are terminated, they can be used
+ * directly from a mapped file without copying.
+ *
+ * The section table at the end of the file holds one record per section:
+ *
+ *   ut32   parent      index of the parent section, UT32_MAX for the root
+ *   ut32   name_len
+ *   ut8[]  name, followed by a '\0'
+ *   ut64   offset      offset of the section's entries
+ *   ut64   size        size of the section's entries in bytes
+ *   ut32   count       number of entries of the section
+ *
+ * The root section is always first, and every section comes after its parent.
+ * Since each namespace can be located from the table alone, a reader only
+ * has to touch the sections it needs.
+ */
+
+#define SDB_BIN_HEADER_SIZE 24
+#define SDB_BIN_NO_PARENT   UT32_MAX
+
+static const ut8 sdb_bin_magic[8] = { 0x7f, 'S', 'D', 'B', 'B', 'I', 'N', '\n' };
+
+typedef struct {
+	ut32 parent;
+	const char *name;
+	ut64 offset;
+	ut64 size;
+	ut32 count;
+} BinSection;
+
+typedef struct {
+	int fd;
+	bool failed;
+	ut64 offset; // bytes written to the file so far
+	size_t len; // bytes pending in buf
+	ut8 buf[0x10000];
+	BinSection *sections;
+	size_t sections_count;
+	size_t sections_size;
+} BinWriter;
+
+static void writer_flush(BinWriter *w) {
+	if (w->len && !w->failed && write(w->fd, w->buf, w->len) != (ssize_t)w->len) {
+		w->failed = true;
+	}
+	w->len = 0;
+}
+
+static void writer_write(BinWriter *w, const void *data, size_t len) {
+	w->offset += len;
+	if (w->len + len > sizeof(w->buf)) {
+		writer_flush(w);
+		if (len > sizeof(w->buf)) {
+			if (!w->failed && write(w->fd, data, len) != (ssize_t)len) {
+				w->failed = true;
+			}
+			return;
+		}
+	}
+	memcpy(w->buf + w->len, data, len);
+	w->len += len;
+}
+
+static void writer_write_le32(BinWriter *w, ut32 v) {
+	ut8 tmp[4];
+	rz_write_le32(tmp, v);
+	writer_write(w, tmp, sizeof(tmp));
+}
+
+static void writer_write_le64(BinWriter *w, ut64 v) {
+	ut8 tmp[8];
+	rz_write_le64(tmp, v);
+	writer_write(w, tmp, sizeof(tmp));
+}
+
+static void writer_write_str(BinWriter *w, const char *s) {
+	size_t len = strlen(s);
+	writer_write_le32(w, (ut32)len);
+	writer_write(w, s, len + 1);
+}
+
+static BinSection *writer_add_section(BinWriter *w, ut32 parent, const char *name) {
+	if (w->sections_count == w->sections_size) {
+		size_t size = w->sections_size ? w->sections_size * 2 : 16;
+		BinSection *sections = realloc(w->sections, size * sizeof(BinSection));
+		if (!sections) {
+			w->failed = true;
+			return NULL;
+		}
+		w->sections = sections;
+		w->sections_size = size;
+	}
+	BinSection *sec = &w->sections[w->sections_count++];
+	sec->parent = parent;
+	sec->name = name;
+	sec->offset = w->offset;
+	sec->size = 0;
+	sec->count = 0;
+	return sec;
+}
+
+static int cmp_ns(const void *a, const void *b) {
+	const SdbNs *nsa = a;
+	const SdbNs *nsb = b;
+	return strcmp(nsa->name, nsb->name);
+}
+
+static void bin_save_kv(BinWriter *w, ut32 index, const char *k, const char *v) {
+	writer_write_str(w, k);
+	writer_write_str(w, v);
+	// sections may move on realloc, so always go through the index
+	w->sections[index].count++;
+}
+
+static bool bin_save_kv_cb(void *user, const char *k, const char *v) {
+	BinWriter *w = user;
+	bin_save_kv(w, (ut32)(w->sections_count - 1), k, v);
+	return true;
+}
+
+static void bin_save(BinWriter *w, Sdb *s, bool sort, ut32 parent, const char *name) {
+	if (!writer_add_section(w, parent, name)) {
+		return;
+	}
+	ut32 index = (ut32)(w->sections_count - 1);
+	if (sort) {
+		SdbList *l = sdb_foreach_list(s, true);
+		SdbKv *kv;
+		SdbListIter *it;
+		ls_foreach (l, it, kv) {
+			bin_save_kv(w, index, sdbkv_key(kv), sdbkv_value(kv));
+		}
+		ls_free(l);
+	} else {
+		sdb_foreach(s, bin_save_kv_cb, w);
+	}
+	w->sections[index].size = w->offset - w->sections[index].offset;
+
+	SdbList *l = s->ns;
+	if (sort) {
+		l = ls_clone(l);
+		ls_sort(l, cmp_ns);
+	}
+	SdbNs *ns;
+	SdbListIter *it;
+	ls_foreach (l, it, ns) {
+		bin_save(w, ns->sdb, sort, index, ns->name);
+	}
+	if (l != s->ns) {
+		ls_free(l);
+	}
+}
+
+/**
+ * \brief Write \p s and all of its namespaces to \p fd in the binary format
+ *
+ * \p fd must be seekable since the header is written last.
+ */
+RZ_API bool sdb_bin_save_fd(Sdb *s, int fd, bool sort) {
+	BinWriter *w = RZ_NEW0(BinWriter);
+	if (!w) {
+		return false;
+	}
+	w->fd = fd;
+	ut8 header[SDB_BIN_HEADER_SIZE] = { 0 };
+	writer_write(w, header, sizeof(header));
+	bin_save(w, s, sort, SDB_BIN_NO_PARENT, "");
+
+	ut64 table = w->offset;
+	for (size_t i = 0; i < w->sections_count; i++) {
+		BinSection *sec = &w->sections[i];
+		writer_write_le32(w, sec->parent);
+		writer_write_str(w, sec->name);
+		writer_write_le64(w, sec->offset);
+		writer_write_le64(w, sec->size);
+		writer_write_le32(w, sec->count);
+	}
+	writer_flush(w);
+
+	memcpy(header, sdb_bin_magic, sizeof(sdb_bin_magic));
+	rz_write_le32(header + 8, SDB_BIN_VERSION);
+	rz_write_le32(header + 12, (ut32)w->sections_count);
+	rz_write_le64(header + 16, table);
+	bool r = !w->failed && lseek(fd, 0, SEEK_SET) == 0 && write(fd, header, sizeof(header)) == sizeof(header);
+	free(w->sections);
+	free(w);
+	return r;
+}
+
+RZ_API bool sdb_bin_save(Sdb *s, const char *file, bool sort) {
+	int fd = open(file, O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0644);
+	if (fd < 0) {
+		return false;
+	}
+	bool r = sdb_bin_save_fd(s, fd, sort);
+	close(fd);
+	return r;
+}
+
+/**
+ * \brief Tell whether \p buf starts with the header of the binary format
+ */
+RZ_API bool sdb_bin_check_buf(const ut8 *buf, size_t sz) {
+	return sz >= SDB_BIN_HEADER_SIZE && !memcmp(buf, sdb_bin_magic, sizeof(sdb_bin_magic));
+}
+
+/**
+ * \brief Tell whether \p file is in the binary format
+ */
+RZ_API bool sdb_bin_check(const char *file) {
+	int fd = open(file, O_RDONLY | O_BINARY);
+	if (fd < 0) {
+		return false;
+	}
+	ut8 header[SDB_BIN_HEADER_SIZE];
+	bool r = read(fd, header, sizeof(header)) == sizeof(header) && sdb_bin_check_buf(header, sizeof(header));
+	close(fd);
+	return r;
+}
+
+typedef struct {
+	const ut8 *buf;
+	size_t sz;
+	size_t pos;
+} BinReader;
+
+static bool reader_le32(BinReader *r, ut32 *v) {
+	if (r->sz - r->pos < 4) {
+		return false;
+	}
+	*v = rz_read_le32(r->buf + r->pos);
+	r->pos += 4;
+	return true;
+}
+
+static bool reader_le64(BinReader *r, ut64 *v) {
+	if (r->sz - r->pos < 8) {
+		return false;
+	}
+	*v = rz_read_le64(r->buf + r->pos);
+	r->pos += 8;
+	return true;
+}
+
+static bool reader_str(BinReader *r, const char **s) {
+	ut32 len;
+	if (!reader_le32(r, &len) || r->sz - r->pos <= len || r->buf[r->pos + len]) {
+		return false;
+	}
+	*s = (const char *)r->buf + r->pos;
+	r->pos += (size_t)len + 1;
+	return true;
+}
+
+static bool bin_load_section(Sdb *db, const ut8 *buf, ut64 offset, ut64 size, ut32 count) {
+	BinReader r = { buf + offset, size, 0 };
+	for (ut32 i = 0; i < count; i++) {
+		const char *k, *v;
+		if (!reader_str(&r, &k) || !reader_str(&r, &v)) {
+			return false;
+		}
+		if (!*k || !*v) {
+			continue;
+		}
+		sdb_set(db, k, v, 0);
+	}
+	return r.pos == r.sz;
+}
+
+/**
+ * \brief Load the contents of \p buf in the binary format into \p s
+ *
+ * The buffer is only read, all strings are copied into \p s.
+ */
+RZ_API bool sdb_bin_load_buf(Sdb *s, const ut8 *buf, size_t sz) {
+	if (!sdb_bin_check_buf(buf, sz) || rz_read_le32(buf + 8) != SDB_BIN_VERSION) {
+		return false;
+	}
+	ut32 count = rz_read_le32(buf + 12);
+	ut64 table = rz_read_le64(buf + 16);
+	// every record takes at least 29 bytes, this also bounds the allocation below
+	if (!count || table < SDB_BIN_HEADER_SIZE || table > sz || (sz - table) / 29 < count) {
+		return false;
+	}
+	Sdb **dbs = RZ_NEWS(Sdb *, count);
+	if (!dbs) {
+		return false;
+	}
+	bool ret = false;
+	BinReader r = { buf, sz, (size_t)table };
+	for (ut32 i = 0; i < count; i++) {
+		ut32 parent, entries;
+		const char *name;
+		ut64 offset, size;
+		if (!reader_le32(&r, &parent) || !reader_str(&r, &name) ||
+			!reader_le64(&r, &offset) || !reader_le64(&r, &size) || !reader_le32(&r, &entries)) {
+			goto beach;
+		}
+		if (!i) {
+			if (parent != SDB_BIN_NO_PARENT) {
+				goto beach;
+			}
+			dbs[i] = s;
+		} else {
+			if (parent >= i || !*name) {
+				goto beach;
+			}
+			dbs[i] = sdb_ns(dbs[parent], name, 1);
+			if (!dbs[i]) {
+				goto beach;
+			}
+		}
+		if (offset < SDB_BIN_HEADER_SIZE || offset > table || size > table - offset ||
+			!bin_load_section(dbs[i], buf, offset, size, entries)) {
+			goto beach;
+		}
+	}
+	ret = true;
+beach:
+	free(dbs);
+	return ret;
+}
+
+RZ_API bool sdb_bin_load(Sdb *s, const char *file) {
+	int fd = open(file, O_RDONLY | O_BINARY);
+	if (fd < 0) {
+		return false;
+	}
+	bool r = false;
+	struct stat st;
+	if (fstat(fd, &st) || st.st_size < SDB_BIN_HEADER_SIZE) {
+		goto beach;
+	}
+#if HAVE_HEADER_SYS_MMAN_H
+	ut8 *x = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (x == MAP_FAILED) {
+		goto beach;
+	}
+#else
+	ut8 *x = calloc(1, st.st_size);
+	if (!x) {
+		goto beach;
+	}
+	if (read(fd, x, st.st_size) != st.st_size) {
+		free(x);
+		goto beach;
+	}
+#endif
+	r = sdb_bin_load_buf(s, x, st.st_size);
+#if HAVE_HEADER_SYS_MMAN_H
+	munmap(x, st.st_size);
+#else
+	free(x);
+#endif
+beach:
+	close(fd);
+	return r;
+}
@@ -150,12 +150,10 @@ RZ_API void Ht_(free)(HtName_(Ht) * ht) {
 	free(ht);
 }
 
-// Increases the size of the hashtable by 2.
-static void internal_ht_grow(HtName_(Ht) * ht) {
+// Moves all the elements to a table of sz buckets.
+static void internal_ht_resize(HtName_(Ht) * ht, ut32 sz, ut32 idx) {
 	HtName_(Ht) * ht2;
 	HtName_(Ht) swap;
-	ut32 idx = next_idx(ht->prime_idx);
-	ut32 sz = compute_size(idx, ht->size * 2);
 	ut32 i;
 
 	ht2 = internal_ht_new(sz, idx, &ht->opt);
@@ -183,6 +181,29 @@ static void internal_ht_grow(HtName_(Ht) * ht) {
 	Ht_(free)(ht2);
 }
 
+// Increases the size of the hashtable by 2.
+static void internal_ht_grow(HtName_(Ht) * ht) {
+	ut32 idx = next_idx(ht->prime_idx);
+	internal_ht_resize(ht, compute_size(idx, ht->size * 2), idx);
+}
+
+// Makes room for count elements in total, so inserting them doesn't grow the hashtable.
+RZ_API void Ht_(reserve)(HtName_(Ht) * ht, ut32 count) {
+	if (count <= LOAD_FACTOR * ht->size) {
+		return;
+	}
+	ut32 idx = ht->prime_idx;
+	ut32 sz = ht->size;
+	while (sz < count) {
+		ut32 next = compute_size(idx = next_idx(idx), sz * 2);
+		if (next <= sz) {
+			break;
+		}
+		sz = next;
+	}
+	internal_ht_resize(ht, sz, idx);
+}
+
 static void check_growing(HtName_(Ht) * ht) {
 	if (ht->count >= LOAD_FACTOR * ht->size) {
 		internal_ht_grow(ht);
@@ -49,9 +49,33 @@
 #define HT_NULL_VALUE  0
 #endif
 
+#ifdef HT_OPEN_ADDRESSING
+/*
+ * The open addressing tables (e.g. HtUPO) have the same API as the chained
+ * ones, with an "O" appended to the names of the table and the functions.
+ * They share the Kv and Options types, so callers can switch between them.
+ */
+#undef HtName_
+#undef Ht_
+#if HT_TYPE == 1
+#define HtName_(name) name##PPO
+#define Ht_(name)     ht_ppo_##name
+#elif HT_TYPE == 2
+#define HtName_(name) name##UPO
+#define Ht_(name)     ht_upo_##name
+#elif HT_TYPE == 3
+#define HtName_(name) name##UUO
+#define Ht_(name)     ht_uuo_##name
+#else
+#define HtName_(name) name##PUO
+#define Ht_(name)     ht_puo_##name
+#endif
+#endif
+
 #include "ls.h"
 #include <rz_types.h>
 
+#ifndef HT_OPEN_ADDRESSING
 /* Kv represents a single key/value element in the hashtable */
 typedef struct Ht_(kv) {
 	KEY_TYPE key;
@@ -106,6 +130,23 @@ typedef struct Ht_(t) {
 	opt;
 }
 HtName_(Ht);
+#else
+/*
+ * Open addressing hashtable: the slots are probed by groups of 16, each
+ * slot having a control byte telling whether it is empty, deleted or full,
+ * in which case it holds 7 bits of the hash.
+ */
+typedef struct Ht_(t) {
+	ut32 size; // number of slots, a power of 2 multiple of the group size.
+	ut32 count; // number of stored elements.
+	ut32 deleted; // number of deleted slots (tombstones).
+	ut8 *ctrl; // control byte of each slot.
+	HT_(Kv) * table; // slots, each one opt.elem_size bytes large.
+	HT_(Options)
+	opt;
+}
+HtName_(Ht);
+#endif
 
 // Create a new Ht with the provided Options
 RZ_API HtName_(Ht) * Ht_(new_opt)(HT_(Options) * opt);
@@ -128,4 +169,6 @@ RZ_API VALUE_TYPE Ht_(find)(HtName_(Ht) * ht, const KEY_TYPE key, bool *found);
 RZ_API void Ht_(foreach)(HtName_(Ht) * ht, HT_(ForeachCallback) cb, void *user);
 
 RZ_API HT_(Kv) * Ht_(find_kv)(HtName_(Ht) * ht, const KEY_TYPE key, bool *found);
+// Makes room for count elements in total, so inserting them doesn't grow the hashtable.
+RZ_API void Ht_(reserve)(HtName_(Ht) * ht, ut32 count);
 RZ_API bool Ht_(insert_kv)(HtName_(Ht) * ht, HT_(Kv) * kv, bool update);
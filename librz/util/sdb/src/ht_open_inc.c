@@ -0,0 +1,447 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*
+ * Open addressing implementation of the hashtables declared in ht_inc.h
+ * (with HT_OPEN_ADDRESSING defined).
+ *
+ * The elements live directly in a power of 2 array of slots, so finding a
+ * key needs no pointer chasing. Each slot has a control byte: EMPTY,
+ * DELETED or the 7 lower bits of the hash (h2) when full. The slots are
+ * probed by groups of HT_GROUP_SIZE, comparing the h2 of a whole group at
+ * once (with SSE2 when available), and only the slots whose h2 matches
+ * are compared with the key. A probe stops at the first group having an
+ * EMPTY slot, which is why deleting a slot may leave a DELETED tombstone.
+ */
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HT_USE_SSE2 1
+#endif
+
+#define HT_GROUP_SIZE      16
+#define HT_CTRL_EMPTY      ((ut8)0x80)
+#define HT_CTRL_DELETED    ((ut8)0xfe)
+#define HT_CTRL_IS_FULL(c) (!((c)&0x80))
+
+static inline ut32 hashfn(HtName_(Ht) * ht, const KEY_TYPE k) {
+	ut32 h = ht->opt.hashfn ? ht->opt.hashfn(k) : KEY_TO_HASH(k);
+	// the default hashes of the numeric keys are the keys themselves,
+	// so spread them before using the low bits as h2 and the rest as index
+	return (ut32)(((ut64)h * 0x9e3779b97f4a7c15ULL) >> 32);
+}
+
+static inline KEY_TYPE dupkey(HtName_(Ht) * ht, const KEY_TYPE k) {
+	return ht->opt.dupkey ? ht->opt.dupkey(k) : (KEY_TYPE)k;
+}
+
+static inline VALUE_TYPE dupval(HtName_(Ht) * ht, const VALUE_TYPE v) {
+	return ht->opt.dupvalue ? ht->opt.dupvalue(v) : (VALUE_TYPE)v;
+}
+
+static inline ut32 calcsize_key(HtName_(Ht) * ht, const KEY_TYPE k) {
+	return ht->opt.calcsizeK ? ht->opt.calcsizeK(k) : 0;
+}
+
+static inline ut32 calcsize_val(HtName_(Ht) * ht, const VALUE_TYPE v) {
+	return ht->opt.calcsizeV ? ht->opt.calcsizeV(v) : 0;
+}
+
+static inline void freefn(HtName_(Ht) * ht, HT_(Kv) * kv) {
+	if (ht->opt.freefn) {
+		ht->opt.freefn(kv);
+	}
+}
+
+static inline bool is_kv_equal(HtName_(Ht) * ht, const KEY_TYPE key, const ut32 key_len, const HT_(Kv) * kv) {
+	if (key_len != kv->key_len) {
+		return false;
+	}
+
+	bool res = key == kv->key;
+	if (!res && ht->opt.cmp) {
+		res = !ht->opt.cmp(key, kv->key);
+	}
+	return res;
+}
+
+static inline HT_(Kv) * kv_at(HtName_(Ht) * ht, ut32 i) {
+	return (HT_(Kv) *)((char *)ht->table + (size_t)i * ht->opt.elem_size);
+}
+
+#ifndef HT_USE_SSE2
+// Gathers the top bits of the 8 bytes of t into a byte, the first byte in the lowest bit.
+static inline ut32 word_mask(ut64 t) {
+	return (ut32)((((t >> 7) & 0x0101010101010101ULL) * 0x0102040810204080ULL) >> 56);
+}
+#endif
+
+// Returns a bitmask of the slots of the group whose control byte is c.
+static inline ut32 group_match(const ut8 *group, ut8 c) {
+#ifdef HT_USE_SSE2
+	__m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+	return (ut32)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)c)));
+#else
+	const ut64 ones = 0x0101010101010101ULL;
+	ut32 mask = 0;
+	for (ut32 i = 0; i < HT_GROUP_SIZE; i += 8) {
+		ut64 x = rz_read_le64(group + i) ^ (ones * c);
+		// exact zero byte detection, 0x80 in every byte equal to c
+		ut64 t = ~(((x & (0x7f * ones)) + 0x7f * ones) | x | (0x7f * ones));
+		mask |= word_mask(t) << i;
+	}
+	return mask;
+#endif
+}
+
+// Returns a bitmask of the slots of the group which are empty or deleted.
+static inline ut32 group_match_free(const ut8 *group) {
+#ifdef HT_USE_SSE2
+	__m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+	return (ut32)_mm_movemask_epi8(ctrl);
+#else
+	ut32 mask = 0;
+	for (ut32 i = 0; i < HT_GROUP_SIZE; i += 8) {
+		mask |= word_mask(rz_read_le64(group + i) & 0x8080808080808080ULL) << i;
+	}
+	return mask;
+#endif
+}
+
+static inline ut32 lowest_bit(ut32 mask) {
+#if defined(__GNUC__)
+	return (ut32)__builtin_ctz(mask);
+#else
+	ut32 i = 0;
+	while (!(mask & 1)) {
+		mask >>= 1;
+		i++;
+	}
+	return i;
+#endif
+}
+
+static inline ut8 hash_h2(ut32 hash) {
+	return hash & 0x7f;
+}
+
+static inline ut32 hash_group(HtName_(Ht) * ht, ut32 hash) {
+	return (hash >> 7) & (ht->size / HT_GROUP_SIZE - 1);
+}
+
+// Triangular probing visits every group once when their number is a power of 2.
+#define GROUP_PROBE_FOREACH(ht, hash, g, step) \
+	for ((g) = hash_group(ht, hash), (step) = 0; (step) < (ht)->size / HT_GROUP_SIZE; \
+		(step)++, (g) = ((g) + (step)) & ((ht)->size / HT_GROUP_SIZE - 1))
+
+// Returns the slot holding the key, or UT32_MAX.
+static ut32 find_slot(HtName_(Ht) * ht, const KEY_TYPE key, ut32 key_len, ut32 hash) {
+	ut8 h2 = hash_h2(hash);
+	ut32 g, step;
+	GROUP_PROBE_FOREACH(ht, hash, g, step) {
+		const ut8 *group = ht->ctrl + g * HT_GROUP_SIZE;
+		for (ut32 mask = group_match(group, h2); mask; mask &= mask - 1) {
+			ut32 slot = g * HT_GROUP_SIZE + lowest_bit(mask);
+			if (is_kv_equal(ht, key, key_len, kv_at(ht, slot))) {
+				return slot;
+			}
+		}
+		if (group_match(group, HT_CTRL_EMPTY)) {
+			break;
+		}
+	}
+	return UT32_MAX;
+}
+
+// Returns the first empty or deleted slot on the probe sequence of hash.
+static ut32 find_free_slot(HtName_(Ht) * ht, ut32 hash) {
+	ut32 g, step;
+	GROUP_PROBE_FOREACH(ht, hash, g, step) {
+		ut32 mask = group_match_free(ht->ctrl + g * HT_GROUP_SIZE);
+		if (mask) {
+			return g * HT_GROUP_SIZE + lowest_bit(mask);
+		}
+	}
+	return UT32_MAX;
+}
+
+static bool internal_ht_alloc(HtName_(Ht) * ht, ut32 size) {
+	ht->ctrl = malloc(size);
+	ht->table = calloc(size, ht->opt.elem_size);
+	if (!ht->ctrl || !ht->table) {
+		free(ht->ctrl);
+		free(ht->table);
+		return false;
+	}
+	memset(ht->ctrl, HT_CTRL_EMPTY, size);
+	ht->size = size;
+	ht->count = 0;
+	ht->deleted = 0;
+	return true;
+}
+
+// Returns the number of slots needed to hold n elements with a load factor of 7/8.
+static ut32 slots_for(ut32 n) {
+	ut64 need = (ut64)n * 8 / 7 + 1;
+	ut64 size = HT_GROUP_SIZE;
+	while (size < need && size < (1ULL << 31)) {
+		size <<= 1;
+	}
+	return (ut32)size;
+}
+
+// Create a new hashtable and return a pointer to it.
+// size - minimum number of elements the hashtable can hold without growing
+// opt  - the options of the hashtable, see HT_(Options)
+static HtName_(Ht) * internal_ht_new(ut32 size, HT_(Options) * opt) {
+	HtName_(Ht) *ht = calloc(1, sizeof(*ht));
+	if (!ht) {
+		return NULL;
+	}
+	ht->opt = *opt;
+	// if not provided, assume we are dealing with a regular HtName_(Ht), with
+	// HT_(Kv) as elements
+	if (ht->opt.elem_size == 0) {
+		ht->opt.elem_size = sizeof(HT_(Kv));
+	}
+	if (!internal_ht_alloc(ht, slots_for(size))) {
+		free(ht);
+		return NULL;
+	}
+	return ht;
+}
+
+RZ_API HtName_(Ht) * Ht_(new_opt)(HT_(Options) * opt) {
+	return internal_ht_new(0, opt);
+}
+
+RZ_API void Ht_(free)(HtName_(Ht) * ht) {
+	if (!ht) {
+		return;
+	}
+	if (ht->opt.freefn) {
+		for (ut32 i = 0; i < ht->size; i++) {
+			if (HT_CTRL_IS_FULL(ht->ctrl[i])) {
+				ht->opt.freefn(kv_at(ht, i));
+			}
+		}
+	}
+	free(ht->ctrl);
+	free(ht->table);
+	free(ht);
+}
+
+static void place_kv(HtName_(Ht) * ht, ut32 slot, ut32 hash, const HT_(Kv) * kv) {
+	if (ht->ctrl[slot] == HT_CTRL_DELETED) {
+		ht->deleted--;
+	}
+	ht->ctrl[slot] = hash_h2(hash);
+	memcpy(kv_at(ht, slot), kv, ht->opt.elem_size);
+	ht->count++;
+}
+
+// Rehashes all the elements in a table of size slots (dropping the tombstones).
+static bool internal_ht_rehash(HtName_(Ht) * ht, ut32 size) {
+	HtName_(Ht) old = *ht;
+	if (!internal_ht_alloc(ht, size)) {
+		*ht = old;
+		return false;
+	}
+	for (ut32 i = 0; i < old.size; i++) {
+		if (HT_CTRL_IS_FULL(old.ctrl[i])) {
+			HT_(Kv) *kv = (HT_(Kv) *)((char *)old.table + (size_t)i * ht->opt.elem_size);
+			ut32 hash = hashfn(ht, kv->key);
+			place_kv(ht, find_free_slot(ht, hash), hash, kv);
+		}
+	}
+	free(old.ctrl);
+	free(old.table);
+	return true;
+}
+
+// Makes room for one more element, keeping at least 1/8 of the slots empty.
+static bool check_growing(HtName_(Ht) * ht) {
+	if ((ut64)(ht->count + ht->deleted + 1) * 8 <= (ut64)ht->size * 7) {
+		return true;
+	}
+	// when the tombstones are many, rehashing in place is enough
+	ut32 size = ht->deleted > ht->count ? ht->size : ht->size * 2;
+	if (size < ht->size || !internal_ht_rehash(ht, size)) {
+		// we can't grow the ht anymore: keep using it till there are no free slots
+		return ht->count < ht->size;
+	}
+	return true;
+}
+
+// Makes room for count elements in total, so inserting them doesn't grow the hashtable.
+RZ_API void Ht_(reserve)(HtName_(Ht) * ht, ut32 count) {
+	ut32 size = slots_for(count);
+	if (size > ht->size) {
+		internal_ht_rehash(ht, size);
+	}
+}
+
+// Returns the slot where the element with key must be written, NULL if it
+// already exists and update is false. On update, the old element is freed.
+static HT_(Kv) * reserve_kv(HtName_(Ht) * ht, const KEY_TYPE key, const ut32 key_len, bool update) {
+	ut32 hash = hashfn(ht, key);
+	ut32 slot = find_slot(ht, key, key_len, hash);
+	if (slot != UT32_MAX) {
+		if (!update) {
+			return NULL;
+		}
+		HT_(Kv) *kv = kv_at(ht, slot);
+		freefn(ht, kv);
+		return kv;
+	}
+	if (!check_growing(ht)) {
+		return NULL;
+	}
+	slot = find_free_slot(ht, hash);
+	if (slot == UT32_MAX) {
+		return NULL;
+	}
+	if (ht->ctrl[slot] == HT_CTRL_DELETED) {
+		ht->deleted--;
+	}
+	ht->ctrl[slot] = hash_h2(hash);
+	ht->count++;
+	return kv_at(ht, slot);
+}
+
+RZ_API bool Ht_(insert_kv)(HtName_(Ht) * ht, HT_(Kv) * kv, bool update) {
+	HT_(Kv) *kv_dst = reserve_kv(ht, kv->key, kv->key_len, update);
+	if (!kv_dst) {
+		return false;
+	}
+
+	memcpy(kv_dst, kv, ht->opt.elem_size);
+	return true;
+}
+
+static bool insert_update(HtName_(Ht) * ht, const KEY_TYPE key, VALUE_TYPE value, bool update) {
+	ut32 key_len = calcsize_key(ht, key);
+	HT_(Kv) *kv_dst = reserve_kv(ht, key, key_len, update);
+	if (!kv_dst) {
+		return false;
+	}
+
+	kv_dst->key = dupkey(ht, key);
+	kv_dst->key_len = key_len;
+	kv_dst->value = dupval(ht, value);
+	kv_dst->value_len = calcsize_val(ht, value);
+	return true;
+}
+
+// Inserts the key value pair key, value into the hashtable.
+// Doesn't allow for "update" of the value.
+RZ_API bool Ht_(insert)(HtName_(Ht) * ht, const KEY_TYPE key, VALUE_TYPE value) {
+	return insert_update(ht, key, value, false);
+}
+
+// Inserts the key value pair key, value into the hashtable.
+// Does allow for "update" of the value.
+RZ_API bool Ht_(update)(HtName_(Ht) * ht, const KEY_TYPE key, VALUE_TYPE value) {
+	return insert_update(ht, key, value, true);
+}
+
+static void delete_slot(HtName_(Ht) * ht, ut32 slot) {
+	// a probe never goes past a group with an empty slot, so such a group
+	// doesn't need a tombstone to keep the following groups reachable
+	const ut8 *group = ht->ctrl + (slot / HT_GROUP_SIZE) * HT_GROUP_SIZE;
+	if (group_match(group, HT_CTRL_EMPTY)) {
+		ht->ctrl[slot] = HT_CTRL_EMPTY;
+	} else {
+		ht->ctrl[slot] = HT_CTRL_DELETED;
+		ht->deleted++;
+	}
+	ht->count--;
+}
+
+// Update the key of an element that has old_key as key and replace it with new_key
+RZ_API bool Ht_(update_key)(HtName_(Ht) * ht, const KEY_TYPE old_key, const KEY_TYPE new_key) {
+	// First look for the value associated with old_key
+	bool found;
+	VALUE_TYPE value = Ht_(find)(ht, old_key, &found);
+	if (!found) {
+		return false;
+	}
+
+	// Associate the existing value with new_key
+	bool inserted = insert_update(ht, new_key, value, false);
+	if (!inserted) {
+		return false;
+	}
+
+	// Remove the old_key kv, paying attention to not double free the value
+	const ut32 old_key_len = calcsize_key(ht, old_key);
+	ut32 slot = find_slot(ht, old_key, old_key_len, hashfn(ht, old_key));
+	if (slot == UT32_MAX) {
+		return false;
+	}
+	HT_(Kv) *kv = kv_at(ht, slot);
+	if (!ht->opt.dupvalue) {
+		// do not free the value part if dupvalue is not
+		// set, because the old value has been
+		// associated with the new key and it should not
+		// be freed
+		kv->value = HT_NULL_VALUE;
+		kv->value_len = 0;
+	}
+	freefn(ht, kv);
+	delete_slot(ht, slot);
+	return true;
+}
+
+// Returns the corresponding SdbKv entry from the key.
+// If `found` is not NULL, it will be set to true if the entry was found, false
+// otherwise.
+RZ_API HT_(Kv) * Ht_(find_kv)(HtName_(Ht) * ht, const KEY_TYPE key, bool *found) {
+	if (found) {
+		*found = false;
+	}
+	if (!ht) {
+		return NULL;
+	}
+
+	ut32 slot = find_slot(ht, key, calcsize_key(ht, key), hashfn(ht, key));
+	if (slot == UT32_MAX) {
+		return NULL;
+	}
+	if (found) {
+		*found = true;
+	}
+	return kv_at(ht, slot);
+}
+
+// Looks up the corresponding value from the key.
+// If `found` is not NULL, it will be set to true if the entry was found, false
+// otherwise.
+RZ_API VALUE_TYPE Ht_(find)(HtName_(Ht) * ht, const KEY_TYPE key, bool *found) {
+	HT_(Kv) *res = Ht_(find_kv)(ht, key, found);
+	return res ? res->value : HT_NULL_VALUE;
+}
+
+// Deletes a entry from the hash table from the key, if the pair exists.
+RZ_API bool Ht_(delete)(HtName_(Ht) * ht, const KEY_TYPE key) {
+	ut32 slot = find_slot(ht, key, calcsize_key(ht, key), hashfn(ht, key));
+	if (slot == UT32_MAX) {
+		return false;
+	}
+	freefn(ht, kv_at(ht, slot));
+	delete_slot(ht, slot);
+	return true;
+}
+
+// The slots never move while iterating, so cb can delete the current element.
+RZ_API void Ht_(foreach)(HtName_(Ht) * ht, HT_(ForeachCallback) cb, void *user) {
+	for (ut32 i = 0; i < ht->size; i++) {
+		if (!HT_CTRL_IS_FULL(ht->ctrl[i])) {
+			continue;
+		}
+		HT_(Kv) *kv = kv_at(ht, i);
+		if (!cb(user, kv->key, kv->value)) {
+			return;
+		}
+	}
+}
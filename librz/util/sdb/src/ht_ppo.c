@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "sdb.h"
+#include "ht_ppo.h"
+#include "ht_open_inc.c"
+
+static HtName_(Ht) * internal_ht_default_new(ut32 size, HT_(DupValue) valdup, HT_(KvFreeFunc) pair_free, HT_(CalcSizeV) calcsizeV) {
+	HT_(Options)
+	opt = {
+		.cmp = (HT_(ListComparator))strcmp,
+		.hashfn = (HT_(HashFunction))sdb_hash,
+		.dupkey = (HT_(DupKey))strdup,
+		.dupvalue = valdup,
+		.calcsizeK = (HT_(CalcSizeK))strlen,
+		.calcsizeV = calcsizeV,
+		.freefn = pair_free,
+		.elem_size = sizeof(HT_(Kv)),
+	};
+	return internal_ht_new(size, &opt);
+}
+
+// creates a default HtPPO that has strings as keys
+RZ_API HtName_(Ht) * Ht_(new)(HT_(DupValue) valdup, HT_(KvFreeFunc) pair_free, HT_(CalcSizeV) calcsizeV) {
+	return internal_ht_default_new(0, valdup, pair_free, calcsizeV);
+}
+
+static void free_kv_key(HT_(Kv) * kv) {
+	free(kv->key);
+}
+
+// creates a default HtPPO that has strings as keys but does not dup, nor free the values
+RZ_API HtName_(Ht) * Ht_(new0)(void) {
+	return Ht_(new)(NULL, free_kv_key, NULL);
+}
+
+RZ_API HtName_(Ht) * Ht_(new_size)(ut32 initial_size, HT_(DupValue) valdup, HT_(KvFreeFunc) pair_free, HT_(CalcSizeV) calcsizeV) {
+	return internal_ht_default_new(initial_size, valdup, pair_free, calcsizeV);
+}
@@ -0,0 +1,32 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef SDB_HT_PPO_H
+#define SDB_HT_PPO_H
+
+#include "ht_pp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * This header provides an open addressing hashtable HtPPO that has void* as
+ * key and void* as value, with the same API and the same HtPPKv elements
+ * of HtPP. The API functions starts with "ht_ppo_".
+ */
+#define HT_TYPE 1
+#define HT_OPEN_ADDRESSING
+#include "ht_inc.h"
+
+RZ_API HtName_(Ht) * Ht_(new0)(void);
+RZ_API HtName_(Ht) * Ht_(new)(HT_(DupValue) valdup, HT_(KvFreeFunc) pair_free, HT_(CalcSizeV) valueSize);
+RZ_API HtName_(Ht) * Ht_(new_size)(ut32 initial_size, HT_(DupValue) valdup, HT_(KvFreeFunc) pair_free, HT_(CalcSizeV) valueSize);
+#undef HT_OPEN_ADDRESSING
+#undef HT_TYPE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,26 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "sdb.h"
+#include "ht_puo.h"
+#include "ht_open_inc.c"
+
+static void free_kv_key(HT_(Kv) * kv) {
+	free(kv->key);
+}
+
+// creates a default HtPUO that has strings as keys
+RZ_API HtName_(Ht) * Ht_(new0)(void) {
+	HT_(Options)
+	opt = {
+		.cmp = (HT_(ListComparator))strcmp,
+		.hashfn = (HT_(HashFunction))sdb_hash,
+		.dupkey = (HT_(DupKey))strdup,
+		.dupvalue = NULL,
+		.calcsizeK = (HT_(CalcSizeK))strlen,
+		.calcsizeV = NULL,
+		.freefn = free_kv_key,
+		.elem_size = sizeof(HT_(Kv)),
+	};
+	return Ht_(new_opt)(&opt);
+}
@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef SDB_HT_PUO_H
+#define SDB_HT_PUO_H
+
+#include "ht_pu.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * This header provides an open addressing hashtable HtPUO that has void* as
+ * key and ut64 as value, with the same API and the same HtPUKv elements
+ * of HtPU. The API functions starts with "ht_puo_".
+ */
+#define HT_TYPE 4
+#define HT_OPEN_ADDRESSING
+#include "ht_inc.h"
+
+RZ_API HtName_(Ht) * Ht_(new0)(void);
+#undef HT_OPEN_ADDRESSING
+#undef HT_TYPE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
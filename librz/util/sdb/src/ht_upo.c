@@ -0,0 +1,33 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "ht_upo.h"
+#include "ht_open_inc.c"
+
+static HtName_(Ht) * internal_ht_default_new(ut32 size, HT_(DupValue) valdup, HT_(KvFreeFunc) pair_free, HT_(CalcSizeV) calcsizeV) {
+	HT_(Options)
+	opt = {
+		.cmp = NULL,
+		.hashfn = NULL,
+		.dupkey = NULL,
+		.dupvalue = valdup,
+		.calcsizeK = NULL,
+		.calcsizeV = calcsizeV,
+		.freefn = pair_free,
+		.elem_size = sizeof(HT_(Kv)),
+	};
+	return internal_ht_new(size, &opt);
+}
+
+RZ_API HtName_(Ht) * Ht_(new)(HT_(DupValue) valdup, HT_(KvFreeFunc) pair_free, HT_(CalcSizeV) calcsizeV) {
+	return internal_ht_default_new(0, valdup, pair_free, calcsizeV);
+}
+
+// creates a default HtUPO that does not dup, nor free the values
+RZ_API HtName_(Ht) * Ht_(new0)(void) {
+	return Ht_(new)(NULL, NULL, NULL);
+}
+
+RZ_API HtName_(Ht) * Ht_(new_size)(ut32 initial_size, HT_(DupValue) valdup, HT_(KvFreeFunc) pair_free, HT_(CalcSizeV) calcsizeV) {
+	return internal_ht_default_new(initial_size, valdup, pair_free, calcsizeV);
+}
@@ -0,0 +1,19 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "ht_uuo.h"
+#include "ht_open_inc.c"
+
+RZ_API HtName_(Ht) * Ht_(new0)(void) {
+	HT_(Options)
+	opt = {
+		.cmp = NULL,
+		.hashfn = NULL,
+		.dupkey = NULL,
+		.dupvalue = NULL,
+		.calcsizeK = NULL,
+		.calcsizeV = NULL,
+		.freefn = NULL
+	};
+	return Ht_(new_opt)(&opt);
+}
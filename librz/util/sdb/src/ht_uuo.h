@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef SDB_HT_UUO_H
+#define SDB_HT_UUO_H
+
+#include "ht_uu.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * This header provides an open addressing hashtable HtUUO that has ut64 as
+ * key and ut64 as value, with the same API and the same HtUUKv elements
+ * of HtUU. The API functions starts with "ht_uuo_".
+ */
+#define HT_TYPE 3
+#define HT_OPEN_ADDRESSING
+#include "ht_inc.h"
+
+RZ_API HtName_(Ht) * Ht_(new0)(void);
+#undef HT_OPEN_ADDRESSING
+#undef HT_TYPE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
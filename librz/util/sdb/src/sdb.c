@@ -191,6 +191,9 @@ static void sdb_fini(Sdb *s, int donull) {
 	free(s->path);
 	ls_free(s->ns);
 	sdb_ht_free(s->ht);
+	// the arena only holds strings of the hashtable, so it goes with it
+	sdb_arena_free(s->arena);
+	s->arena = NULL;
 	sdb_journal_close(s);
 	if (s->fd != -1) {
 		close(s->fd);
@@ -439,6 +442,8 @@ RZ_API void sdb_reset(Sdb *s) {
 	sdb_close(s);
 	/* empty memory hashtable */
 	sdb_ht_free(s->ht);
+	sdb_arena_free(s->arena);
+	s->arena = NULL;
 	s->ht = sdb_ht_new();
 }
 
@@ -564,18 +569,26 @@ static ut32 sdb_set_internal(Sdb *s, const char *key, char *val, int owned, ut32
 				return kv->cas;
 			}
 			kv->cas = cas = nextcas();
+			// the values in the arena are copied on write
+			bool in_arena = kv->arena & SDB_KV_ARENA_VALUE;
 			if (owned) {
 				kv->base.value_len = vlen;
-				free(kv->base.value);
+				if (!in_arena) {
+					free(kv->base.value);
+				}
 				kv->base.value = val; // owned
 			} else {
-				if ((ut32)vlen > kv->base.value_len) {
-					free(kv->base.value);
+				if ((ut32)vlen > kv->base.value_len || in_arena) {
+					if (!in_arena) {
+						free(kv->base.value);
+					}
 					kv->base.value = malloc(vlen + 1);
 				}
 				memcpy(kv->base.value, val, vlen + 1);
 				kv->base.value_len = vlen;
 			}
+			kv->arena &= ~SDB_KV_ARENA_VALUE;
+			sdbkv_mem_track(kv);
 		} else {
 			sdb_ht_delete(s->ht, key);
 		}
@@ -604,6 +617,29 @@ static ut32 sdb_set_internal(Sdb *s, const char *key, char *val, int owned, ut32
 	return 0;
 }
 
+/**
+ * \brief Insert \p key with \p val, both living in the arena of \p s, unless \p key is in memory already
+ *
+ * \return false if nothing was inserted, then the caller must use sdb_set()
+ */
+RZ_IPI bool sdb_set_arena(Sdb *s, char *key, ut32 klen, char *val, ut32 vlen) {
+	if (s->journal != -1) {
+		return false;
+	}
+	SdbKv kv = { { 0 } };
+	kv.base.key = key;
+	kv.base.key_len = klen;
+	kv.base.value = val;
+	kv.base.value_len = vlen;
+	kv.arena = SDB_KV_ARENA_KEY | SDB_KV_ARENA_VALUE;
+	kv.cas = nextcas();
+	if (!sdb_ht_insert_kvp(s->ht, &kv, false)) {
+		return false;
+	}
+	sdb_hook_call(s, key, val);
+	return true;
+}
+
 RZ_API int sdb_set_owned(Sdb *s, const char *key, char *val, ut32 cas) {
 	return sdb_set_internal(s, key, val, 1, cas);
 }
@@ -60,6 +60,8 @@ extern char *strdup(const char *);
 #define SDB_LIST_UNSORTED 0
 #define SDB_LIST_SORTED   1
 
+typedef struct sdb_arena_t SdbArena;
+
 typedef struct sdb_t {
 	char *dir; // path+name
 	char *path;
@@ -83,6 +85,7 @@ typedef struct sdb_t {
 	SdbList *hooks;
 	ut32 depth;
 	bool timestamped;
+	SdbArena *arena; ///< keys and values loaded by sdb_text_load_buf(), see text.c
 } Sdb;
 
 typedef struct sdb_ns_t {
@@ -196,6 +199,15 @@ RZ_API bool sdb_text_save(Sdb *s, const char *file, bool sort);
 RZ_API bool sdb_text_load_buf(Sdb *s, char *buf, size_t sz);
 RZ_API bool sdb_text_load(Sdb *s, const char *file);
 
+/* binary sdb files */
+#define SDB_BIN_VERSION 1
+RZ_API bool sdb_bin_save_fd(Sdb *s, int fd, bool sort);
+RZ_API bool sdb_bin_save(Sdb *s, const char *file, bool sort);
+RZ_API bool sdb_bin_check_buf(const ut8 *buf, size_t sz);
+RZ_API bool sdb_bin_check(const char *file);
+RZ_API bool sdb_bin_load_buf(Sdb *s, const ut8 *buf, size_t sz);
+RZ_API bool sdb_bin_load(Sdb *s, const char *file);
+
 /* iterate */
 RZ_API void sdb_dump_begin(Sdb *s);
 RZ_API SdbKv *sdb_dump_next(Sdb *s);
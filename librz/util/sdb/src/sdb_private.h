@@ -4,6 +4,8 @@
 #ifndef SDB_PRIVATE_H_
 #define SDB_PRIVATE_H_
 
+#include "sdb.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -18,6 +20,10 @@ extern "C" {
 #define write_(fd, buf, count) SDB_V_NOT(write(fd, buf, count), -1)
 #define read_(fd, buf, count)  SDB_V_NOT(read(fd, buf, count), -1)
 
+RZ_IPI void sdbkv_mem_track(SdbKv *kv);
+RZ_IPI bool sdb_set_arena(Sdb *s, char *key, ut32 klen, char *val, ut32 vlen);
+RZ_IPI void sdb_arena_free(SdbArena *arena);
+
 static inline int seek_set(int fd, off_t pos) {
 	return ((fd == -1) || (lseek(fd, (off_t)pos, SEEK_SET) == -1)) ? 0 : 1;
 }
@@ -1,11 +1,27 @@
 // SPDX-FileCopyrightText: 2011-2020 pancake <pancake@nopcode.org>
 // SPDX-License-Identifier: MIT
 
-#include "sdbht.h"
+#include <rz_util/rz_mem_account.h>
+#include "sdb.h"
+#include "sdb_private.h"
+
+/**
+ * \brief Count \p kv, which lives in a sdb hashtable, in the sdb memory accounting
+ *
+ * The key is used to identify the pair since the SdbKv itself is copied into the table.
+ */
+RZ_IPI void sdbkv_mem_track(SdbKv *kv) {
+	RZ_MEM_TRACK(RZ_MEM_ACCOUNT_SDB, sdbkv_key(kv), sizeof(SdbKv) + sdbkv_key_len(kv) + sdbkv_value_len(kv) + 2);
+}
 
 void sdbkv_fini(SdbKv *kv) {
-	free(kv->base.key);
-	free(kv->base.value);
+	RZ_MEM_UNTRACK(kv->base.key);
+	if (!(kv->arena & SDB_KV_ARENA_KEY)) {
+		free(kv->base.key);
+	}
+	if (!(kv->arena & SDB_KV_ARENA_VALUE)) {
+		free(kv->base.value);
+	}
 }
 
 RZ_API HtPP *sdb_ht_new(void) {
@@ -32,7 +48,12 @@ static bool sdb_ht_internal_insert(HtPP *ht, const char *key, const char *value,
 	kvp.base.key_len = strlen(kvp.base.key);
 	kvp.base.value_len = strlen(kvp.base.value);
 	kvp.expire = 0;
-	return ht_pp_insert_kv(ht, (HtPPKv *)&kvp, update);
+	if (!ht_pp_insert_kv(ht, (HtPPKv *)&kvp, update)) {
+		// not taken by the table, the caller of sdb_ht_insert() can't free them
+		goto err;
+	}
+	sdbkv_mem_track(&kvp);
+	return true;
 
 err:
 	free(kvp.base.key);
@@ -45,7 +66,11 @@ RZ_API bool sdb_ht_insert(HtPP *ht, const char *key, const char *value) {
 }
 
 RZ_API bool sdb_ht_insert_kvp(HtPP *ht, SdbKv *kvp, bool update) {
-	return ht_pp_insert_kv(ht, (HtPPKv *)kvp, update);
+	if (!ht_pp_insert_kv(ht, (HtPPKv *)kvp, update)) {
+		return false;
+	}
+	sdbkv_mem_track(kvp);
+	return true;
 }
 
 RZ_API bool sdb_ht_update(HtPP *ht, const char *key, const char *value) {
@@ -10,11 +10,15 @@
 extern "C" {
 #endif
 
+#define SDB_KV_ARENA_KEY   (1 << 0)
+#define SDB_KV_ARENA_VALUE (1 << 1)
+
 /** keyvalue pair **/
 typedef struct sdb_kv {
 	// sub of HtPPKv so we can cast safely
 	HtPPKv base;
 	ut32 cas;
+	ut8 arena; ///< SDB_KV_ARENA_* flags of the strings living in the arena of the sdb, which are not freed
 	ut64 expire;
 } SdbKv;
 
@@ -206,70 +206,61 @@ RZ_API bool sdb_text_save(Sdb *s, const char *file, bool sort) {
 	return r;
 }
 
-typedef enum {
-	STATE_NEWLINE,
-	STATE_PATH,
-	STATE_KEY,
-	STATE_VALUE
-} LoadState;
+/*
+ * The loaded keys and values are copied into an arena owned by the Sdb: big
+ * chunks of memory that are only freed with the hashtable, instead of two
+ * allocations per entry. The SdbKv flags which of its strings live there,
+ * a value set again later is copied to its own allocation then.
+ */
 
-typedef struct {
-	bool eof;
-	char *buf;
-	size_t bufsz;
-	Sdb *root_db;
-	Sdb *cur_db; // current namespace, changes when encountering a path line
-	size_t pos; // current processing position in the buffer
-	size_t line_begin;
-	size_t token_begin; // beginning of the currently processed token in the buffer
-	size_t shift; // amount to shift chars to the left (from unescaping)
-	SdbList /*<size_t>*/ *path;
-	LoadState state;
-	bool unescape; // whether the prev char was a backslash, i.e. the current one is escaped
-} LoadCtx;
+#define SDB_ARENA_CHUNK_SIZE (64 * 1024)
 
-// to be called at the end of a line.
-// save all the data processed from the line into the database.
-// assumes that the ctx->buf is allocated until ctx->buf[ctx->pos] inclusive!
-static void load_process_line(LoadCtx *ctx) {
-	ctx->unescape = false;
-	// finish up the line
-	ctx->buf[ctx->pos - ctx->shift] = '\0';
-	switch (ctx->state) {
-	case STATE_PATH: {
-		ls_push(ctx->path, (void *)ctx->token_begin);
-		SdbListIter *it;
-		void *token_off_tmp;
-		ctx->cur_db = ctx->root_db;
-		ls_foreach (ctx->path, it, token_off_tmp) {
-			size_t token_off = (size_t)token_off_tmp;
-			if (!ctx->buf[token_off]) {
-				continue;
-			}
-			ctx->cur_db = sdb_ns(ctx->cur_db, ctx->buf + token_off, 1);
-			if (!ctx->cur_db) {
-				ctx->cur_db = ctx->root_db;
-				break;
-			}
-		}
-		ls_destroy(ctx->path);
-		break;
+struct sdb_arena_t {
+	SdbArena *next; ///< chunks allocated before this one
+	size_t size;
+	size_t used;
+	char data[];
+};
+
+RZ_IPI void sdb_arena_free(SdbArena *arena) {
+	while (arena) {
+		SdbArena *next = arena->next;
+		free(arena);
+		arena = next;
 	}
-	case STATE_VALUE: {
-		const char *k = ctx->buf + ctx->line_begin;
-		const char *v = ctx->buf + ctx->token_begin;
-		if (!*k || !*v) {
-			break;
-		}
-		sdb_set(ctx->cur_db, k, v, 0);
-		break;
+}
+
+static char *arena_alloc(Sdb *s, size_t size) {
+	SdbArena *chunk = s->arena;
+	if (chunk && chunk->size - chunk->used >= size) {
+		char *r = chunk->data + chunk->used;
+		chunk->used += size;
+		return r;
 	}
-	default:
-		break;
+	size_t chunk_size = RZ_MAX(size, SDB_ARENA_CHUNK_SIZE);
+	SdbArena *fresh = malloc(sizeof(SdbArena) + chunk_size);
+	if (!fresh) {
+		return NULL;
+	}
+	fresh->size = chunk_size;
+	fresh->used = size;
+	if (chunk && size > SDB_ARENA_CHUNK_SIZE) {
+		// keep filling the current chunk, the big one is full already
+		fresh->next = chunk->next;
+		chunk->next = fresh;
+	} else {
+		fresh->next = chunk;
+		s->arena = fresh;
+	}
+	return fresh->data;
+}
+
+// Gives back the last size bytes allocated from the current chunk, if r is the last allocation.
+static void arena_unalloc(Sdb *s, char *r, size_t size) {
+	SdbArena *chunk = s->arena;
+	if (chunk && r + size == chunk->data + chunk->used) {
+		chunk->used -= size;
 	}
-	// prepare for next line
-	ctx->shift = 0;
-	ctx->state = STATE_NEWLINE;
 }
 
 static inline char unescape_raw_char(char c) {
@@ -285,121 +276,144 @@ static inline char unescape_raw_char(char c) {
 	}
 }
 
-static void load_process_single_char(LoadCtx *ctx) {
-	char c = ctx->buf[ctx->pos];
-	if (c == '\n' || c == '\r') {
-		load_process_line(ctx);
-		ctx->pos++;
-		return;
-	}
-
-	if (ctx->state == STATE_NEWLINE) {
-		ctx->line_begin = ctx->pos;
-		// at the start of a line, decide whether it's a path or a k=v
-		// by whether there is a leading slash.
-		if (c == '/') {
-			ctx->state = STATE_PATH;
-			ctx->token_begin = ctx->pos + 1;
-			ctx->pos++;
-			c = ctx->buf[ctx->pos];
-			return;
+// Unescapes the text in [src, end) into dst until the first unescaped stop char, -1 for none.
+// Returns the position after the stop char, NULL if there is none, and the unescaped length in len.
+static const char *unescape_until(char *dst, size_t *len, const char *src, const char *end, int stop) {
+	size_t n = 0;
+	while (src < end) {
+		char c = *src++;
+		if (c == '\\') {
+			if (src == end) {
+				// a trailing backslash escapes nothing
+				break;
+			}
+			dst[n++] = unescape_raw_char(*src++);
+		} else if (c == stop) {
+			*len = n;
+			return src;
+		} else {
+			dst[n++] = c;
 		}
-		ctx->state = STATE_KEY;
 	}
+	*len = n;
+	return NULL;
+}
 
-	if (ctx->unescape) {
-		ctx->buf[ctx->pos - ctx->shift] = unescape_raw_char(c);
-		ctx->unescape = false;
-	} else if (c == '\\') {
-		// got a backslash, the next char, unescape in the next iteration or die!
-		ctx->shift++;
-		ctx->unescape = true;
-	} else if (ctx->state == STATE_PATH && c == '/') {
-		// new path token
-		ctx->buf[ctx->pos - ctx->shift] = '\0';
-		ls_push(ctx->path, (void *)ctx->token_begin);
-		ctx->token_begin = ctx->pos + 1;
-		ctx->shift = 0;
-	} else if (ctx->state == STATE_KEY && c == '=') {
-		// switch from key to value mode
-		ctx->buf[ctx->pos - ctx->shift] = '\0';
-		ctx->token_begin = ctx->pos + 1;
-		ctx->shift = 0;
-		ctx->state = STATE_VALUE;
-	} else if (ctx->shift) {
-		// just some char, shift it back if necessary
-		ctx->buf[ctx->pos - ctx->shift] = c;
+// Returns the number of lines in [p, end) before the next path line, for pre-sizing the hashtable.
+static ut32 section_lines(const char *p, const char *end) {
+	ut32 n = 0;
+	while (p < end && *p != '/') {
+		n++;
+		const char *nl = memchr(p, '\n', end - p);
+		if (!nl) {
+			break;
+		}
+		p = nl + 1;
 	}
-	ctx->pos++;
+	return n;
 }
 
-static bool load_process_final_line(LoadCtx *ctx) {
-	// load_process_line needs ctx.buf[ctx.pos] to be allocated!
-	// so we need room for one additional byte after the buffer.
-	size_t linesz = ctx->bufsz - ctx->line_begin;
-	char *linebuf = malloc(linesz + 1);
-	if (!linebuf) {
-		return false;
+static Sdb *load_path(Sdb *root, const char *line, const char *end) {
+	char *token = malloc(end - line + 1);
+	if (!token) {
+		return root;
 	}
-	memcpy(linebuf, ctx->buf + ctx->line_begin, linesz);
-	ctx->buf = linebuf;
-	// shift everything by the size we skipped
-	ctx->bufsz -= ctx->line_begin;
-	ctx->pos = linesz;
-	ctx->token_begin -= ctx->line_begin;
-	SdbListIter *it;
-	void *token_off_tmp;
-	ls_foreach (ctx->path, it, token_off_tmp) {
-		it->data = (void *)((size_t)token_off_tmp - ctx->line_begin);
+	Sdb *db = root;
+	while (line < end) {
+		size_t len;
+		line = unescape_until(token, &len, line, end, '/');
+		if (!line) {
+			line = end;
+		}
+		if (!len) {
+			continue;
+		}
+		token[len] = '\0';
+		db = sdb_ns(db, token, 1);
+		if (!db) {
+			db = root;
+			break;
+		}
 	}
-	ctx->line_begin = 0;
-	load_process_line(ctx);
-	free(linebuf);
-	ctx->buf = NULL;
-	return true;
-}
-
-static void load_ctx_fini(LoadCtx *ctx) {
-	ls_free(ctx->path);
+	free(token);
+	return db;
 }
 
-static bool load_ctx_init(LoadCtx *ctx, Sdb *s, char *buf, size_t sz) {
-	ctx->eof = false;
-	ctx->buf = buf;
-	ctx->bufsz = sz;
-	ctx->root_db = s;
-	ctx->cur_db = s;
-	ctx->pos = 0;
-	ctx->line_begin = 0;
-	ctx->token_begin = 0;
-	ctx->shift = 0;
-	ctx->path = ls_new();
-	ctx->state = STATE_NEWLINE;
-	ctx->unescape = false;
-	if (!ctx->buf || !ctx->path) {
-		load_ctx_fini(ctx);
-		return false;
+static void load_kv(Sdb *db, const char *line, const char *end) {
+	size_t linesz = end - line;
+	// key, '\0', value, '\0' take at most one byte more than the line, which has a '='
+	char *k = arena_alloc(db, linesz + 1);
+	if (!k) {
+		return;
 	}
-	return true;
-}
-
-RZ_API bool sdb_text_load_buf(Sdb *s, char *buf, size_t sz) {
-	if (!sz) {
-		return true;
+	size_t klen, vlen;
+	const char *eq;
+	if (!memchr(line, '\\', linesz)) {
+		eq = memchr(line, '=', linesz);
+		if (!eq) {
+			arena_unalloc(db, k, linesz + 1);
+			return;
+		}
+		klen = eq - line;
+		vlen = end - eq - 1;
+		memcpy(k, line, linesz);
+		eq++;
+	} else {
+		eq = unescape_until(k, &klen, line, end, '=');
+		if (!eq) {
+			arena_unalloc(db, k, linesz + 1);
+			return;
+		}
+		unescape_until(k + klen + 1, &vlen, eq, end, -1);
 	}
-	LoadCtx ctx;
-	if (!load_ctx_init(&ctx, s, buf, sz)) {
-		return false;
+	char *v = k + klen + 1;
+	k[klen] = '\0';
+	v[vlen] = '\0';
+	if (!klen || !vlen) {
+		arena_unalloc(db, k, linesz + 1);
+		return;
 	}
-	bool ret = true;
-	while (ctx.pos < ctx.bufsz) {
-		load_process_single_char(&ctx);
+	if (!sdb_set_arena(db, k, klen, v, vlen)) {
+		sdb_set(db, k, v, 0);
+		arena_unalloc(db, k, linesz + 1);
 	}
-	if (ctx.line_begin < ctx.bufsz && ctx.state != STATE_NEWLINE) {
-		load_process_final_line(&ctx);
+}
+
+/**
+ * \brief Load the plaintext sdb in \p buf into \p s, see the format above
+ *
+ * The lines are found with memchr() and the keys and values copied once, into
+ * the arena of their namespace. \p buf is not modified.
+ */
+RZ_API bool sdb_text_load_buf(Sdb *s, char *buf, size_t sz) {
+	const char *p = buf;
+	const char *end = buf + sz;
+	Sdb *db = s;
+	bool section = true;
+	while (p < end) {
+		if (section) {
+			ht_pp_reserve(db->ht, db->ht->count + section_lines(p, end));
+			section = false;
+		}
+		const char *nl = memchr(p, '\n', end - p);
+		const char *eol = nl ? nl : end;
+		// '\r' is escaped when saving, a raw one ends the line too
+		const char *cr = memchr(p, '\r', eol - p);
+		if (cr) {
+			eol = cr;
+			nl = cr;
+		}
+		if (eol > p) {
+			if (*p == '/') {
+				db = load_path(s, p + 1, eol);
+				section = true;
+			} else {
+				load_kv(db, p, eol);
+			}
+		}
+		p = nl ? nl + 1 : end;
 	}
-	load_ctx_fini(&ctx);
-	return ret;
+	return true;
 }
 
 RZ_API bool sdb_text_load(Sdb *s, const char *file) {
@@ -413,7 +427,7 @@ RZ_API bool sdb_text_load(Sdb *s, const char *file) {
 		goto beach;
 	}
 #if HAVE_HEADER_SYS_MMAN_H
-	char *x = mmap(0, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	char *x = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
 	if (x == MAP_FAILED) {
 		goto beach;
 	}
@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util/rz_serialize.h>
+#include <rz_util.h>
+
+static void json_entry_fini(void *e, void *user) {
+	RzSerializeJsonEntry *entry = e;
+	rz_json_free(entry->json);
+	free(entry->json_str);
+	free(entry->key);
+}
+
+static bool json_entry_collect_cb(void *user, const char *k, const char *v) {
+	RzVector *entries = user;
+	RzSerializeJsonEntry *entry = rz_vector_push(entries, NULL);
+	if (!entry) {
+		return false;
+	}
+	entry->key = strdup(k);
+	entry->json_str = strdup(v);
+	entry->json = NULL;
+	entry->parsed = false;
+	return entry->key && entry->json_str;
+}
+
+/**
+ * \brief Copy all the entries of \p db to be parsed by rz_serialize_json_entries_parse()
+ *
+ * The entries keep the iteration order of sdb_foreach(), so installing them in
+ * order gives the same result as loading from inside the sdb_foreach() callback.
+ *
+ * \param entries Uninitialized vector to fill, to be finalized with rz_serialize_json_entries_fini() in any case
+ */
+RZ_API bool rz_serialize_json_entries_init(RZ_NONNULL RZ_OUT RzVector /*<RzSerializeJsonEntry>*/ *entries, RZ_NONNULL Sdb *db) {
+	rz_return_val_if_fail(entries && db, false);
+	rz_vector_init(entries, sizeof(RzSerializeJsonEntry), json_entry_fini, NULL);
+	if (!rz_vector_reserve(entries, sdb_count(db)) && sdb_count(db)) {
+		return false;
+	}
+	return sdb_foreach(db, json_entry_collect_cb, entries);
+}
+
+RZ_API void rz_serialize_json_entries_fini(RZ_NULLABLE RzVector /*<RzSerializeJsonEntry>*/ *entries) {
+	if (!entries) {
+		return;
+	}
+	rz_vector_fini(entries);
+}
+
+typedef struct {
+	RzVector **entries;
+	size_t count;
+	size_t *starts; ///< index of the first entry of each vector among all of them, count + 1 items
+} JsonParseCtx;
+
+static void json_entry_parse(RzSerializeJsonEntry *entry) {
+	if (entry->parsed) {
+		return;
+	}
+	entry->json = rz_json_parse(entry->json_str);
+	entry->parsed = true;
+}
+
+static void json_entries_parse_range(size_t from, size_t to, void *user) {
+	JsonParseCtx *ctx = user;
+	// last vector starting at or before from
+	size_t v = 0;
+	while (v + 1 < ctx->count && ctx->starts[v + 1] <= from) {
+		v++;
+	}
+	for (size_t i = from; i < to; i++) {
+		while (i >= ctx->starts[v + 1]) {
+			v++;
+		}
+		json_entry_parse(rz_vector_index_ptr(ctx->entries[v], i - ctx->starts[v]));
+	}
+}
+
+/**
+ * \brief Parse the values of the entries of several namespaces at once
+ *
+ * Parsing doesn't depend on anything but the value itself, so the entries of
+ * all the namespaces are spread over \p pool together.
+ *
+ * \param entries Vectors filled by rz_serialize_json_entries_init()
+ * \param count Number of vectors in \p entries
+ * \param pool Workers to parse on, the entries are parsed by the caller if NULL
+ */
+RZ_API void rz_serialize_json_entries_parse(RZ_NONNULL RzVector /*<RzSerializeJsonEntry>*/ **entries, size_t count, RZ_NULLABLE RzThreadTaskPool *pool) {
+	rz_return_if_fail(entries || !count);
+	size_t *starts = RZ_NEWS(size_t, count + 1);
+	if (!starts) {
+		pool = NULL;
+	} else {
+		starts[0] = 0;
+		for (size_t i = 0; i < count; i++) {
+			starts[i + 1] = starts[i] + rz_vector_len(entries[i]);
+		}
+	}
+	JsonParseCtx ctx = { entries, count, starts };
+	if (pool && count && starts[count] > 1) {
+		// on failure or break some ranges may be left, they are parsed below
+		rz_th_task_pool_parallel_for(pool, 0, starts[count], 0, json_entries_parse_range, &ctx);
+	}
+	free(starts);
+	for (size_t i = 0; i < count; i++) {
+		RzSerializeJsonEntry *entry;
+		rz_vector_foreach(entries[i], entry) {
+			json_entry_parse(entry);
+		}
+	}
+}
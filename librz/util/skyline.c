@@ -54,6 +54,7 @@ RZ_API bool rz_skyline_add(RzSkyline *skyline, RzInterval itv, void *user) {
 		}
 	}
 	rz_vector_insert(skyline_vec, slot, &new_part);
+	skyline->generation++;
 	return true;
 }
 
@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util/rz_slab.h>
+#include <rz_util/rz_assert.h>
+
+/**
+ * \file slab.c
+ * RzSlab hands out objects of a single size taken from chunks holding many
+ * of them, so allocating and freeing millions of small objects of the same
+ * type costs a few big allocations instead of millions of small ones.
+ */
+
+/**
+ * \brief Creates an empty slab
+ *
+ * \param elem_size   The size of the objects
+ * \param chunk_elems The number of objects allocated at once when the slab is out of free objects
+ */
+RZ_API RZ_OWN RzSlab *rz_slab_new(size_t elem_size, size_t chunk_elems) {
+	rz_return_val_if_fail(elem_size && chunk_elems, NULL);
+	// every object must be big and aligned enough to hold the free list pointer
+	size_t align = sizeof(void *);
+	elem_size = (elem_size + align - 1) & ~(align - 1);
+	if (chunk_elems > SIZE_MAX / elem_size) {
+		return NULL;
+	}
+	RzSlab *slab = RZ_NEW0(RzSlab);
+	if (!slab) {
+		return NULL;
+	}
+	slab->elem_size = elem_size;
+	slab->chunk_elems = chunk_elems;
+	rz_pvector_init(&slab->chunks, free);
+	return slab;
+}
+
+/**
+ * \brief Frees the slab together with all the objects it handed out
+ */
+RZ_API void rz_slab_free(RZ_NULLABLE RzSlab *slab) {
+	if (!slab) {
+		return;
+	}
+	rz_pvector_fini(&slab->chunks);
+	free(slab);
+}
+
+#define CHUNK_CMP(x, y) ((const ut8 *)(x) < (const ut8 *)(y) ? -1 : ((const ut8 *)(x) > (const ut8 *)(y) ? 1 : 0))
+
+static bool slab_grow(RzSlab *slab) {
+	ut8 *chunk = malloc(slab->elem_size * slab->chunk_elems);
+	if (!chunk) {
+		return false;
+	}
+	// keep the chunks sorted to look them up in rz_slab_owns()
+	size_t index;
+	rz_pvector_lower_bound(&slab->chunks, chunk, index, CHUNK_CMP);
+	if (!rz_pvector_insert(&slab->chunks, index, chunk)) {
+		free(chunk);
+		return false;
+	}
+	// objects are handed out from the start of the fresh chunk,
+	// so there is no need to thread them all in the free list
+	slab->last_chunk = chunk;
+	slab->fresh = slab->chunk_elems;
+	return true;
+}
+
+/**
+ * \brief Allocates a zeroed object from the slab
+ *
+ * \return The object, to be released with rz_slab_release(), or NULL on allocation failure
+ */
+RZ_API RZ_OWN void *rz_slab_alloc(RZ_NONNULL RzSlab *slab) {
+	rz_return_val_if_fail(slab, NULL);
+	void *ptr = slab->free_list;
+	if (ptr) {
+		slab->free_list = *(void **)ptr;
+	} else {
+		if (!slab->fresh && !slab_grow(slab)) {
+			return NULL;
+		}
+		ptr = slab->last_chunk + (slab->chunk_elems - slab->fresh) * slab->elem_size;
+		slab->fresh--;
+	}
+	slab->used++;
+	memset(ptr, 0, slab->elem_size);
+	return ptr;
+}
+
+/**
+ * \brief Gives an object allocated by rz_slab_alloc() back to the slab
+ */
+RZ_API void rz_slab_release(RZ_NONNULL RzSlab *slab, RZ_NULLABLE void *ptr) {
+	rz_return_if_fail(slab);
+	if (!ptr) {
+		return;
+	}
+	rz_return_if_fail(slab->used);
+	*(void **)ptr = slab->free_list;
+	slab->free_list = ptr;
+	slab->used--;
+}
+
+/**
+ * \brief Tells whether \p ptr is an object of one of the chunks of the slab, in O(log(chunks))
+ */
+RZ_API bool rz_slab_owns(RZ_NONNULL RzSlab *slab, RZ_NULLABLE const void *ptr) {
+	rz_return_val_if_fail(slab, false);
+	if (!ptr) {
+		return false;
+	}
+	size_t index;
+	rz_pvector_upper_bound(&slab->chunks, ptr, index, CHUNK_CMP);
+	if (!index) {
+		return false;
+	}
+	const ut8 *chunk = rz_pvector_at(&slab->chunks, index - 1);
+	size_t offset = (const ut8 *)ptr - chunk;
+	return offset < slab->elem_size * slab->chunk_elems && !(offset % slab->elem_size);
+}
+
+/**
+ * \brief Fills \p stats with the memory used by the slab
+ */
+RZ_API void rz_slab_stats(RZ_NONNULL RzSlab *slab, RZ_NONNULL RzSlabStats *stats) {
+	rz_return_if_fail(slab && stats);
+	stats->used = slab->used;
+	stats->used_bytes = slab->used * slab->elem_size;
+	stats->chunks = rz_pvector_len(&slab->chunks);
+	stats->reserved_bytes = stats->chunks * slab->chunk_elems * slab->elem_size;
+}
@@ -1107,6 +1107,35 @@ RZ_API char *rz_str_appendch(char *x, char y) {
 	return rz_str_append(x, b);
 }
 
+// replace every key in one pass, instead of moving the whole tail of str for each of them
+static char *replace_all(char *str, size_t slen, const char *key, size_t klen, const char *val, size_t vlen) {
+	size_t count = 0;
+	const char *p;
+	for (p = str; (p = strstr(p, key)); p += klen) {
+		count++;
+	}
+	if (!count) {
+		return str;
+	}
+	char *out = malloc(slen - count * klen + count * vlen + 1);
+	if (!out) {
+		free(str);
+		return NULL;
+	}
+	char *o = out;
+	const char *q = str;
+	while ((p = strstr(q, key))) {
+		memcpy(o, q, p - q);
+		o += p - q;
+		memcpy(o, val, vlen);
+		o += vlen;
+		q = p + klen;
+	}
+	strcpy(o, q);
+	free(str);
+	return out;
+}
+
 RZ_API char *rz_str_replace(char *str, const char *key, const char *val, int g) {
 	if (g == 'i') {
 		return rz_str_replace_icase(str, key, val, g, true);
@@ -1125,6 +1154,9 @@ RZ_API char *rz_str_replace(char *str, const char *key, const char *val, int g)
 		return str;
 	}
 	slen = strlen(str);
+	if (g && vlen != klen && klen > 0) {
+		return replace_all(str, slen, key, klen, val, vlen);
+	}
 	char *q = str;
 	for (;;) {
 		p = strstr(q, key);
@@ -1922,18 +1954,17 @@ static size_t __str_ansi_length(char const *str) {
 /* ansi helpers */
 RZ_API size_t rz_str_ansi_nlen(const char *str, size_t slen) {
 	size_t i = 0, len = 0;
-	if (slen > 0) {
-		while (str[i] && i < slen) {
-			size_t chlen = __str_ansi_length(str + i);
-			if (chlen == 1) {
-				len++;
-			}
-			i += chlen;
+	size_t end = slen > 0 ? rz_str_nlen(str, slen) : strlen(str);
+	while (i < end) {
+		// everything up to the next escape counts, memchr() skips there at vector speed
+		const char *esc = memchr(str + i, 0x1b, end - i);
+		if (!esc) {
+			len += end - i;
+			break;
 		}
-		return len > 0 ? len : 1;
-	}
-	while (str[i]) {
-		size_t chlen = __str_ansi_length(str + i);
+		len += esc - (str + i);
+		i = esc - str;
+		size_t chlen = __str_ansi_length(esc);
 		if (chlen == 1) {
 			len++;
 		}
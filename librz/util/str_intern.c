@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "thread.h"
+#include <rz_util.h>
+#include <rz_constructor.h>
+
+/*
+ * Each string is allocated right after its reference count, the table maps
+ * the strings to nothing and only serves to find them.
+ */
+typedef struct {
+	size_t refs;
+	char str[];
+} InternedStr;
+
+struct rz_str_intern_t {
+	HtPP *ht;
+	RzThreadLock *lock;
+};
+
+#define INTERNED(s) ((InternedStr *)((char *)(s) - offsetof(InternedStr, str)))
+
+static void interned_free(HtPPKv *kv) {
+	free(INTERNED(kv->key));
+}
+
+RZ_API RZ_OWN RzStrIntern *rz_str_intern_new(void) {
+	RzStrIntern *pool = RZ_NEW0(RzStrIntern);
+	if (!pool) {
+		return NULL;
+	}
+	HtPPOptions opt = {
+		.cmp = (HtPPListComparator)strcmp,
+		.hashfn = (HtPPHashFunction)sdb_hash,
+		.calcsizeK = (HtPPCalcSizeK)strlen,
+		.freefn = interned_free,
+		.elem_size = sizeof(HtPPKv),
+	};
+	pool->ht = ht_pp_new_opt(&opt);
+	pool->lock = rz_th_lock_new(false);
+	if (!pool->ht || !pool->lock) {
+		rz_str_intern_free(pool);
+		return NULL;
+	}
+	return pool;
+}
+
+RZ_API void rz_str_intern_free(RZ_NULLABLE RzStrIntern *pool) {
+	if (!pool) {
+		return;
+	}
+	ht_pp_free(pool->ht);
+	rz_th_lock_free(pool->lock);
+	free(pool);
+}
+
+static RzStrIntern *global_pool;
+
+static RzThreadOnce global_pool_once = RZ_THREAD_ONCE_INIT;
+
+static void global_pool_init(void) {
+	global_pool = rz_str_intern_new();
+}
+
+#ifdef RZ_HAS_CONSTRUCTORS
+#ifdef RZ_DEFINE_DESTRUCTOR_NEEDS_PRAGMA
+#pragma RZ_DEFINE_DESTRUCTOR_PRAGMA_ARGS(str_intern_destructor)
+#endif
+RZ_DEFINE_DESTRUCTOR(str_intern_destructor)
+static void str_intern_destructor(void) {
+	rz_str_intern_free(global_pool);
+	global_pool = NULL;
+}
+#endif
+
+/**
+ * \brief Get the pool shared by the whole process, so names coming from
+ * different libraries are stored only once
+ */
+RZ_API RZ_BORROW RzStrIntern *rz_str_intern_global(void) {
+	rz_th_once(&global_pool_once, global_pool_init);
+	return global_pool;
+}
+
+/**
+ * \brief Get the interned copy of \p str and take a reference to it
+ *
+ * \return the same pointer for all equal strings, until all references are put back
+ */
+RZ_API RZ_NULLABLE const char *rz_str_intern_get(RZ_NONNULL RzStrIntern *pool, RZ_NULLABLE const char *str) {
+	rz_return_val_if_fail(pool, NULL);
+	if (!str) {
+		return NULL;
+	}
+	rz_th_lock_enter(pool->lock);
+	HtPPKv *kv = ht_pp_find_kv(pool->ht, str, NULL);
+	if (kv) {
+		INTERNED(kv->key)->refs++;
+		rz_th_lock_leave(pool->lock);
+		return kv->key;
+	}
+	size_t len = strlen(str);
+	InternedStr *s = malloc(sizeof(InternedStr) + len + 1);
+	if (!s) {
+		rz_th_lock_leave(pool->lock);
+		return NULL;
+	}
+	s->refs = 1;
+	memcpy(s->str, str, len + 1);
+	if (!ht_pp_insert(pool->ht, s->str, NULL)) {
+		free(s);
+		rz_th_lock_leave(pool->lock);
+		return NULL;
+	}
+	rz_th_lock_leave(pool->lock);
+	return s->str;
+}
+
+/**
+ * \brief Take another reference to \p str, which must have been interned in \p pool
+ *
+ * Same as rz_str_intern_get(), without looking the string up.
+ */
+RZ_API RZ_NULLABLE const char *rz_str_intern_ref(RZ_NONNULL RzStrIntern *pool, RZ_NULLABLE const char *str) {
+	rz_return_val_if_fail(pool, NULL);
+	if (!str) {
+		return NULL;
+	}
+	rz_th_lock_enter(pool->lock);
+	INTERNED(str)->refs++;
+	rz_th_lock_leave(pool->lock);
+	return str;
+}
+
+/**
+ * \brief Give back a reference to \p str, which must have been interned in \p pool
+ *
+ * The string is freed once its last reference is put back.
+ */
+RZ_API void rz_str_intern_put(RZ_NONNULL RzStrIntern *pool, RZ_NULLABLE const char *str) {
+	rz_return_if_fail(pool);
+	if (!str) {
+		return;
+	}
+	rz_th_lock_enter(pool->lock);
+	if (!--INTERNED(str)->refs) {
+		ht_pp_delete(pool->ht, str);
+	}
+	rz_th_lock_leave(pool->lock);
+}
+
+/**
+ * \brief Get the number of distinct strings in \p pool
+ */
+RZ_API size_t rz_str_intern_count(RZ_NONNULL RzStrIntern *pool) {
+	rz_return_val_if_fail(pool, 0);
+	rz_th_lock_enter(pool->lock);
+	size_t count = pool->ht->count;
+	rz_th_lock_leave(pool->lock);
+	return count;
+}
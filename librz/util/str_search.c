@@ -347,6 +347,117 @@ static inline bool can_be_ebcdic(const ut8 *buf, ut64 size) {
 	return buf[0] < 0x20 || buf[0] > 0x3f;
 }
 
+#define DEAD_8BIT    (1 << 0) ///< no string starts at the byte in RZ_STRING_ENC_8BIT/UTF8 mode
+#define DEAD_GUESS   (1 << 1) ///< same in guess mode, if the byte is 0 or < 0x80 the next bytes matter too
+#define DEAD_UTF16LE (1 << 2) ///< same in RZ_STRING_ENC_UTF16LE mode, if the next byte is 0
+
+static bool rune_starts_string(RzRune r) {
+	return (rz_rune_is_printable(r) && r != '\\') || (r && r < 0x100 && is_c_escape_sequence((char)r));
+}
+
+/**
+ * Classify the bytes at which process_one_string() and the guessing
+ * probes of rz_scan_strings_raw() are bound to fail, so the scan can step
+ * over them without calling the decoders. The classes are computed with
+ * the very same decoders, so they can't get out of sync.
+ */
+static void dead_bytes_init(ut8 dead[256]) {
+	for (int b = 0; b < 256; b++) {
+		ut8 c = (ut8)b;
+		RzRune r = 0;
+		int rc = rz_utf8_decode(&c, 1, &r);
+		dead[b] = 0;
+		if (!rc || !rune_starts_string(r)) {
+			dead[b] |= DEAD_8BIT;
+		}
+		if (!rune_starts_string(c)) {
+			dead[b] |= DEAD_UTF16LE;
+		}
+		RzRune ebcdic = 0;
+		rz_str_ibm037_to_unicode(c, &ebcdic);
+		if ((dead[b] & DEAD_8BIT) && can_be_ebcdic(&c, 1) && !rz_rune_is_printable(ebcdic)) {
+			dead[b] |= DEAD_GUESS;
+		}
+	}
+	// a 2 bytes sequence may still decode to a rune
+	for (int b = 0xc2; b < 0xf8; b++) {
+		dead[b] &= ~(DEAD_8BIT | DEAD_GUESS);
+	}
+}
+
+static ut64 zero_run_end(const ut8 *buf, ut64 from, ut64 needle, ut64 to) {
+	while (to - needle >= 8 && !rz_read_le64(buf + needle - from)) {
+		needle += 8;
+	}
+	while (needle < to && !buf[needle - from]) {
+		needle++;
+	}
+	return needle;
+}
+
+/**
+ * Get the first offset from \p needle on where a string of \p type could
+ * start, as far as the byte classes in \p dead tell.
+ * Runs of 0x00 and 0xff, the most common padding, are skipped 8 bytes at a time.
+ */
+static ut64 skip_dead_bytes(const ut8 dead[256], RzStrEnc type, const ut8 *buf, ut64 from, ut64 needle, ut64 to) {
+	while (needle < to) {
+		const ut8 *p = buf + needle - from;
+		const ut64 size = to - needle;
+		switch (type) {
+		case RZ_STRING_ENC_GUESS:
+			if (!p[0]) {
+				// the utf16/utf32 probes need some non zero byte within the first 7 ones
+				if (!(dead[0] & DEAD_GUESS)) {
+					return needle;
+				}
+				ut64 end = zero_run_end(buf, from, needle, to);
+				if (end == to) {
+					return to;
+				}
+				if (end - needle < 7) {
+					return needle;
+				}
+				needle = end - 6;
+				continue;
+			}
+			if (!(dead[p[0]] & DEAD_GUESS) || (p[0] < 0x80 && size > 1 && !p[1])) {
+				// ascii bytes followed by 0 may start utf16le/utf32le strings
+				return needle;
+			}
+			break;
+		case RZ_STRING_ENC_8BIT:
+		case RZ_STRING_ENC_UTF8:
+			if (!(dead[p[0]] & DEAD_8BIT)) {
+				return needle;
+			}
+			break;
+		case RZ_STRING_ENC_UTF16LE:
+			if (!p[0]) {
+				ut64 end = zero_run_end(buf, from, needle, to);
+				if (end - needle < 2) {
+					return needle;
+				}
+				needle = end - 1;
+				continue;
+			}
+			if (size < 2 || p[1] || !(dead[p[0]] & DEAD_UTF16LE)) {
+				return needle;
+			}
+			break;
+		default:
+			return needle;
+		}
+		if (p[0] == 0xff && size >= 8 && rz_read_le64(p) == UT64_MAX) {
+			// every position of a 0xff run is dead when one is
+			needle += 8;
+			continue;
+		}
+		needle++;
+	}
+	return needle;
+}
+
 /**
  * \brief Look for strings in an RzBuffer.
  * \param buf Pointer to a raw buffer to scan
@@ -383,7 +494,25 @@ RZ_API int rz_scan_strings_raw(const ut8 *buf, RzList *list, const RzUtilStrScan
 	const ut8 *ptr = NULL;
 	ut64 size = 0;
 	int skip_ibm037 = 0;
+	ut8 dead[256];
+	const bool skip_dead = opt->min_str_length > 0 &&
+		(type == RZ_STRING_ENC_GUESS || type == RZ_STRING_ENC_8BIT || type == RZ_STRING_ENC_UTF8 || type == RZ_STRING_ENC_UTF16LE);
+	if (skip_dead) {
+		dead_bytes_init(dead);
+	}
 	while (needle < to) {
+		if (skip_dead) {
+			ut64 next = skip_dead_bytes(dead, type, buf, from, needle, to);
+			if (next != needle) {
+				// on each skipped offset the ibm037 probe either counted down or failed and reset the counter
+				st64 skipped = next - needle;
+				skip_ibm037 = skip_ibm037 > skipped ? skip_ibm037 - skipped : 0;
+				needle = next;
+				if (needle >= to) {
+					break;
+				}
+			}
+		}
 		ptr = buf + needle - from;
 		size = to - needle;
 		--skip_ibm037;
@@ -537,6 +666,13 @@ RZ_API int rz_scan_strings(RzBuffer *buf_to_scan, RzList *list, const RzUtilStrS
 	}
 
 	ut64 len = to - from;
+	ut64 borrowed = len;
+	const ut8 *data = rz_buf_borrow_at(buf_to_scan, from, &borrowed);
+	if (data && borrowed == len) {
+		// the buffer is in memory already, no need for a copy
+		return rz_scan_strings_raw(data, list, opt, from, to, type);
+	}
+
 	ut8 *buf = calloc(len, 1);
 	if (!buf) {
 		return -1;
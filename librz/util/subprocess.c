@@ -647,6 +647,8 @@ RZ_API RzSubprocessOutput *rz_subprocess_drain(RzSubprocess *proc) {
 	out->out = rz_subprocess_out(proc, &out->out_len);
 	out->err = rz_subprocess_err(proc, &out->err_len);
 	out->ret = proc->ret;
+	out->timeout = false;
+	out->peak_rss = 0;
 	return out;
 }
 
@@ -678,10 +680,18 @@ struct rz_subprocess_t {
 	int stderr_fd;
 	int killpipe[2];
 	int ret;
+	ut64 peak_rss; ///< in KiB, filled when the child is reaped
 	RzStrBuf out;
 	RzStrBuf err;
 };
 
+#if __linux__ || __APPLE__ || __BSD__
+#include <sys/resource.h>
+#define HAVE_WAIT4 1
+#else
+#define HAVE_WAIT4 0
+#endif
+
 static RzPVector subprocs;
 static RzThreadLock *subprocs_mutex;
 static int sigchld_pipe[2];
@@ -718,7 +728,12 @@ static void *sigchld_th(void *th) {
 		}
 		while (true) {
 			int wstat;
+#if HAVE_WAIT4
+			struct rusage ru = { 0 };
+			pid_t pid = wait4(-1, &wstat, WNOHANG, &ru);
+#else
 			pid_t pid = waitpid(-1, &wstat, WNOHANG);
+#endif
 			if (pid <= 0)
 				break;
 
@@ -742,6 +757,13 @@ static void *sigchld_th(void *th) {
 			} else {
 				proc->ret = -1;
 			}
+#if HAVE_WAIT4
+#if __APPLE__
+			proc->peak_rss = (ut64)ru.ru_maxrss / 1024; // bytes on macOS
+#else
+			proc->peak_rss = (ut64)ru.ru_maxrss;
+#endif
+#endif
 			ut8 r = 0;
 			rz_xwrite(proc->killpipe[1], &r, 1);
 			subprocess_unlock();
@@ -1231,6 +1253,7 @@ RZ_API RzSubprocessOutput *rz_subprocess_drain(RzSubprocess *proc) {
 		out->err = rz_subprocess_err(proc, &out->err_len);
 		out->ret = proc->ret;
 		out->timeout = false;
+		out->peak_rss = proc->peak_rss;
 	}
 	subprocess_unlock();
 	return out;
@@ -3,17 +3,46 @@
 
 #include <rz_util/rz_table.h>
 #include "rz_cons.h"
+#include <ht_pu.h>
 
-// cant do that without globals because RzList doesnt have void *user :(
-static int Gnth = 0;
-static RzListComparator Gcmp = NULL;
+/*
+ * rz_num_get() is a whole expression parser, but number cells are nearly
+ * always plain decimal or 0x-prefixed hex, which strtoull reads the same way.
+ */
+static ut64 table_num(const char *s) {
+	if (!s) {
+		return 0;
+	}
+	const char *p = s;
+	int base = 10;
+	if (p[0] == '0' && p[1] == 'x' && p[2]) {
+		p += 2;
+		base = 16;
+		while (isxdigit((ut8)*p)) {
+			p++;
+		}
+	} else if (IS_DIGIT(*p) && (*p != '0' || !p[1])) {
+		// a leading 0 means octal to rz_num_get
+		while (IS_DIGIT(*p)) {
+			p++;
+		}
+	} else {
+		return rz_num_get(NULL, s);
+	}
+	if (*p) {
+		return rz_num_get(NULL, s);
+	}
+	return strtoull(base == 16 ? s + 2 : s, NULL, base);
+}
 
 static int sortString(const void *a, const void *b) {
 	return strcmp(a, b);
 }
 
 static int sortNumber(const void *a, const void *b) {
-	return rz_num_get(NULL, a) - rz_num_get(NULL, b);
+	ut64 na = table_num(a);
+	ut64 nb = table_num(b);
+	return na < nb ? -1 : na > nb;
 }
 
 // maybe just index by name instead of exposing those symbols as global
@@ -472,7 +501,6 @@ static int __strbuf_append_col_aligned(RzStrBuf *sb, RzTableColumn *col, const c
 	if (nopad) {
 		rz_strbuf_appendf(sb, "%s", str);
 	} else {
-		char *pad = "";
 		int padlen = 0;
 		int len1 = rz_str_len_utf8(str);
 		int len2 = rz_str_len_utf8_ansi(str);
@@ -481,16 +509,13 @@ static int __strbuf_append_col_aligned(RzStrBuf *sb, RzTableColumn *col, const c
 				padlen = col->width - len2;
 			}
 		}
+		// the padding for escape sequences is printed as a field width, no need to build it
 		switch (col->align) {
 		case RZ_TABLE_ALIGN_LEFT:
-			pad = rz_str_repeat(" ", padlen);
-			rz_strbuf_appendf(sb, "%-*s%s", col->width, str, pad);
-			free(pad);
+			rz_strbuf_appendf(sb, "%-*s%*s", col->width, str, padlen, "");
 			break;
 		case RZ_TABLE_ALIGN_RIGHT:
-			pad = rz_str_repeat(" ", padlen);
-			rz_strbuf_appendf(sb, "%s%*s ", pad, col->width, str);
-			free(pad);
+			rz_strbuf_appendf(sb, "%*s%*s ", padlen, "", col->width, str);
 			break;
 		case RZ_TABLE_ALIGN_CENTER: {
 			int pad = (col->width - len2) / 2;
@@ -680,16 +705,17 @@ RZ_API void rz_table_filter(RzTable *t, int nth, int op, const char *un) {
 		uv = page_items * (page);
 	}
 	size_t nrow = 0;
-	ut32 i;
-	for (i = 0; i < rz_vector_len(t->rows); i++) {
+	// only the comparisons look at the value of the cell
+	bool numeric = op == '+' || op == '>' || op == ')' || op == '<' || op == '(' || op == '=' || op == '!';
+	// matching rows are moved down over the dropped ones, in a single pass
+	size_t i, kept = 0, len = rz_vector_len(t->rows);
+	for (i = 0; i < len; i++) {
 		row = rz_vector_index_ptr(t->rows, i);
-		const char *nn = nth < 0 ? NULL : rz_pvector_at(row->items, nth);
-		ut64 nv = rz_num_math(NULL, nn);
+		const char *nn = nth >= 0 && nth < rz_pvector_len(row->items) ? rz_pvector_at(row->items, nth) : NULL;
+		ut64 nv = numeric ? table_num(nn) : 0;
 		bool match = true;
-		RzTableRow *del_row = RZ_NEW(RzTableRow);
-		if (!del_row) {
-			RZ_LOG_ERROR("Failed to allocate memory.\n");
-			return;
+		if (!nn) {
+			nn = "";
 		}
 		switch (op) {
 		case 'p':
@@ -733,7 +759,7 @@ RZ_API void rz_table_filter(RzTable *t, int nth, int op, const char *un) {
 			match = (nv <= uv);
 			break;
 		case '=':
-			if (nv == 0 && nn != NULL) {
+			if (nv == 0) {
 				match = !strcmp(nn, un);
 			} else {
 				match = (nv == uv);
@@ -762,53 +788,109 @@ RZ_API void rz_table_filter(RzTable *t, int nth, int op, const char *un) {
 			break;
 		}
 		if (!match) {
-			rz_vector_remove_at(t->rows, i--, del_row);
-			rz_table_row_fini(del_row);
+			rz_table_row_fini(row);
+			continue;
+		}
+		if (kept != i) {
+			memcpy(rz_vector_index_ptr(t->rows, kept), row, sizeof(RzTableRow));
 		}
-		RZ_FREE(del_row);
+		kept++;
 	}
+	rz_vector_remove_range(t->rows, kept, len - kept, NULL);
 	if (op == '+') {
 		rz_table_add_rowf(t, "u", sum);
 	}
 }
 
-static int cmp(const void *_a, const void *_b) {
-	RzTableRow *a = (RzTableRow *)_a;
-	RzTableRow *b = (RzTableRow *)_b;
-	const char *wa = rz_pvector_at(a->items, Gnth);
-	const char *wb = rz_pvector_at(b->items, Gnth);
-	int res = Gcmp(wa, wb);
-	return res;
+typedef enum {
+	SORT_BY_STRING,
+	SORT_BY_NUMBER,
+	SORT_BY_LENGTH,
+	SORT_BY_CALLBACK, ///< column types with their own comparator
+} SortKind;
+
+typedef struct {
+	SortKind kind;
+	RzListComparator cmp;
+	bool dec;
+} SortCtx;
+
+/*
+ * The cell is decoded once per row instead of once per comparison, and the
+ * row index breaks ties so the sort is stable.
+ */
+typedef struct {
+	const SortCtx *ctx;
+	const char *str;
+	ut64 num;
+	size_t idx;
+} SortKey;
+
+static int sort_key_cmp(const void *_a, const void *_b) {
+	const SortKey *a = _a, *b = _b;
+	int r;
+	switch (a->ctx->kind) {
+	case SORT_BY_STRING: r = strcmp(a->str, b->str); break;
+	case SORT_BY_CALLBACK: r = a->ctx->cmp(a->str, b->str); break;
+	default: r = a->num < b->num ? -1 : a->num > b->num; break;
+	}
+	if (r) {
+		return a->ctx->dec ? -r : r;
+	}
+	return a->idx < b->idx ? -1 : a->idx > b->idx;
 }
 
-RZ_API void rz_table_sort(RzTable *t, int nth, bool dec) {
-	RzTableColumn *col = rz_vector_index_ptr(t->cols, nth);
-	if (col) {
-		Gnth = nth;
-		if (col->type && col->type->cmp) {
-			Gcmp = col->type->cmp;
-			rz_vector_sort(t->rows, cmp, dec);
-		}
-		Gnth = 0;
-		Gcmp = NULL;
+static void table_sort_by(RzTable *t, int nth, const SortCtx *ctx) {
+	size_t i, len = rz_vector_len(t->rows);
+	if (len < 2) {
+		return;
 	}
+	SortKey *keys = RZ_NEWS(SortKey, len);
+	RzTableRow *sorted = RZ_NEWS(RzTableRow, len);
+	if (!keys || !sorted) {
+		free(keys);
+		free(sorted);
+		return;
+	}
+	for (i = 0; i < len; i++) {
+		RzTableRow *row = rz_vector_index_ptr(t->rows, i);
+		const char *str = nth < rz_pvector_len(row->items) ? rz_pvector_at(row->items, nth) : NULL;
+		SortKey *k = &keys[i];
+		k->ctx = ctx;
+		k->str = str ? str : "";
+		k->num = ctx->kind == SORT_BY_NUMBER ? table_num(k->str) : ctx->kind == SORT_BY_LENGTH ? strlen(k->str) : 0;
+		k->idx = i;
+	}
+	qsort(keys, len, sizeof(SortKey), sort_key_cmp);
+	for (i = 0; i < len; i++) {
+		memcpy(&sorted[i], rz_vector_index_ptr(t->rows, keys[i].idx), sizeof(RzTableRow));
+	}
+	memcpy(rz_vector_index_ptr(t->rows, 0), sorted, len * sizeof(RzTableRow));
+	free(sorted);
+	free(keys);
 }
 
-static int cmplen(const void *_a, const void *_b) {
-	RzTableRow *a = (RzTableRow *)_a;
-	RzTableRow *b = (RzTableRow *)_b;
-	const char *wa = rz_pvector_at(a->items, Gnth);
-	const char *wb = rz_pvector_at(b->items, Gnth);
-	int res = strlen(wa) - strlen(wb);
-	return res;
+RZ_API void rz_table_sort(RzTable *t, int nth, bool dec) {
+	RzTableColumn *col = rz_vector_index_ptr(t->cols, nth);
+	if (!col || !col->type || !col->type->cmp) {
+		return;
+	}
+	SortCtx ctx = { .cmp = col->type->cmp, .dec = dec };
+	if (col->type->cmp == sortString) {
+		ctx.kind = SORT_BY_STRING;
+	} else if (col->type->cmp == sortNumber) {
+		ctx.kind = SORT_BY_NUMBER;
+	} else {
+		ctx.kind = SORT_BY_CALLBACK;
+	}
+	table_sort_by(t, nth, &ctx);
 }
 
 RZ_API void rz_table_sortlen(RzTable *t, int nth, bool dec) {
 	RzTableColumn *col = rz_vector_index_ptr(t->cols, nth);
 	if (col) {
-		Gnth = nth;
-		rz_vector_sort(t->rows, cmplen, dec);
-		Gnth = 0;
+		SortCtx ctx = { .kind = SORT_BY_LENGTH, .dec = dec };
+		table_sort_by(t, nth, &ctx);
 	}
 }
 
@@ -843,7 +925,71 @@ RZ_API void rz_table_uniq(RzTable *t) {
 	rz_table_group(t, -1, NULL);
 }
 
+/*
+ * Build a string that is equal for two rows exactly when rz_rows_cmp() says
+ * they are, or return false if a column type does not allow it.
+ */
+static bool row_group_key(RzStrBuf *sb, RzPVector *items, RzVector *cols, int nth) {
+	size_t i;
+	rz_strbuf_set(sb, "");
+	rz_strbuf_appendf(sb, "%" PFMT64u, (ut64)rz_pvector_len(items));
+	for (i = 0; i < rz_pvector_len(items) && i < rz_vector_len(cols); i++) {
+		if (nth != -1 && i != nth) {
+			continue;
+		}
+		RzTableColumn *col = rz_vector_index_ptr(cols, i);
+		const char *item = rz_pvector_at(items, i);
+		if (col->type->cmp == sortNumber) {
+			rz_strbuf_appendf(sb, "|%" PFMT64x, table_num(item));
+		} else if (col->type->cmp == sortString) {
+			rz_strbuf_appendf(sb, "|%" PFMT64u ":%s", (ut64)strlen(item), item);
+		} else {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool table_group_hashed(RzTable *t, int nth, RzTableSelector fcn) {
+	size_t i, kept = 0, len = rz_vector_len(t->rows);
+	HtPU *seen = ht_pu_new0();
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	bool ok = seen != NULL;
+	for (i = 0; ok && i < len; i++) {
+		RzTableRow *row = rz_vector_index_ptr(t->rows, i);
+		if (!row_group_key(&sb, row->items, t->cols, nth)) {
+			// nothing was dropped yet, the slow path can take over
+			ok = false;
+			break;
+		}
+		bool found = false;
+		ut64 first = ht_pu_find(seen, rz_strbuf_get(&sb), &found);
+		if (found) {
+			if (fcn) {
+				fcn(rz_vector_index_ptr(t->rows, first), row, nth);
+			}
+			rz_table_row_fini(row);
+			continue;
+		}
+		ht_pu_insert(seen, rz_strbuf_get(&sb), kept);
+		if (kept != i) {
+			memcpy(rz_vector_index_ptr(t->rows, kept), row, sizeof(RzTableRow));
+		}
+		kept++;
+	}
+	if (ok) {
+		rz_vector_remove_range(t->rows, kept, len - kept, NULL);
+	}
+	rz_strbuf_fini(&sb);
+	ht_pu_free(seen);
+	return ok;
+}
+
 RZ_API void rz_table_group(RzTable *t, int nth, RzTableSelector fcn) {
+	if (table_group_hashed(t, nth, fcn)) {
+		return;
+	}
 	RzTableRow *row, *uniq_row, *del_row = RZ_NEW(RzTableRow);
 	RzVector *rows = t->rows;
 	ut32 i, j;
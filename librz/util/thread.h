@@ -19,6 +19,8 @@
 #define RZ_TH_COND_T CONDITION_VARIABLE
 #define RZ_TH_SEM_T  HANDLE
 #define RZ_TH_RET_T  DWORD WINAPI
+#define RZ_TH_ONCE_T INIT_ONCE
+#define RZ_TH_ONCE_INIT INIT_ONCE_STATIC_INIT
 #elif HAVE_PTHREAD
 #define __GNU
 #include <semaphore.h>
@@ -45,6 +47,8 @@
 #define RZ_TH_COND_T pthread_cond_t
 #define RZ_TH_SEM_T  sem_t *
 #define RZ_TH_RET_T  void *
+#define RZ_TH_ONCE_T pthread_once_t
+#define RZ_TH_ONCE_INIT PTHREAD_ONCE_INIT
 #else
 #error Threading library only supported for pthread and w32
 #endif
@@ -88,6 +92,10 @@ struct rz_th_t {
 	void *retv; ///< Thread return value.
 };
 
+typedef RZ_TH_ONCE_T RzThreadOnce;
+#define RZ_THREAD_ONCE_INIT RZ_TH_ONCE_INIT
+
 RZ_IPI RZ_TH_TID rz_th_self(void);
+RZ_IPI void rz_th_once(RZ_NONNULL RzThreadOnce *once, RZ_NONNULL void (*init)(void));
 
 #endif /* RZ_THREAD_INTERNAL_H */
@@ -0,0 +1,32 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "thread.h"
+
+#if __WINDOWS__
+static BOOL CALLBACK once_callback(PINIT_ONCE once, PVOID param, PVOID *ctx) {
+	void (*init)(void) = (void (*)(void))param;
+	init();
+	return TRUE;
+}
+#endif
+
+/**
+ * \brief Runs \p init exactly once for the given \p once, even when called by several threads
+ *
+ * Meant for process wide state which is created on its first use: rizin may
+ * be built by a compiler without constructor support (see rz_constructor.h),
+ * so the state cannot be created before main() and the first callers can be
+ * any threads racing for it. All callers return only after \p init has
+ * completed, so the state it sets up can be read without further locking.
+ *
+ * \p once must be a static RzThreadOnce set to RZ_THREAD_ONCE_INIT.
+ */
+RZ_IPI void rz_th_once(RZ_NONNULL RzThreadOnce *once, RZ_NONNULL void (*init)(void)) {
+	rz_return_if_fail(once && init);
+#if __WINDOWS__
+	InitOnceExecuteOnce(once, once_callback, (PVOID)init, NULL);
+#else
+	pthread_once(once, init);
+#endif
+}
@@ -0,0 +1,257 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_th.h>
+#include <rz_util/rz_sys.h>
+#include "thread.h"
+
+/**
+ * \file thread_ring.c
+ * RzThreadRing is a bounded lock-free FIFO queue for multiple producers and consumers.
+ *
+ * It has the same shape as RzThreadQueue, but it never takes a lock nor
+ * allocates memory when pushing or popping, which makes it a better fit
+ * for the fine-grained tasks pushed and popped at a high rate.
+ * Each cell stores a sequence number telling whether the cell is free for
+ * the push at that position or ready for the pop at that position, so
+ * producers and consumers only contend on the head and tail counters.
+ *
+ * rz_th_ring_new      Allocates a RzThreadRing which can hold at least the given number of elements.
+ * rz_th_ring_push     Appends an element to the ring unless it is full.
+ * rz_th_ring_pop      Pops the oldest element from the ring, but returns NULL when is empty.
+ * rz_th_ring_wait_pop Pops the oldest element from the ring, backing off till an element is available.
+ * rz_th_ring_free     Frees a RzThreadRing structure, if the ring is not empty, it frees the elements with the provided qfree function.
+ */
+
+#define RING_CACHE_LINE 64
+// number of failed pops busy spinning before yielding the thread
+#define RING_SPIN_POPS 64
+// longest sleep between two failed pops, in microseconds
+#define RING_MAX_SLEEP 1000
+
+typedef struct {
+	size_t seq;
+	void *user;
+} RzThreadRingCell;
+
+struct rz_th_ring_t {
+	RzThreadRingCell *cells;
+	size_t mask;
+	RzListFree qfree;
+	ut8 pad0[RING_CACHE_LINE];
+	size_t head; ///< next position to push to
+	ut8 pad1[RING_CACHE_LINE - sizeof(size_t)];
+	size_t tail; ///< next position to pop from
+	ut8 pad2[RING_CACHE_LINE - sizeof(size_t)];
+};
+
+#if defined(_MSC_VER)
+static inline size_t ring_load(size_t *p) {
+	return (size_t)InterlockedCompareExchangePointer((PVOID volatile *)p, NULL, NULL);
+}
+
+static inline void ring_store(size_t *p, size_t value) {
+	InterlockedExchangePointer((PVOID volatile *)p, (PVOID)value);
+}
+
+static inline bool ring_cas(size_t *p, size_t expected, size_t desired) {
+	return InterlockedCompareExchangePointer((PVOID volatile *)p, (PVOID)desired, (PVOID)expected) == (PVOID)expected;
+}
+#else
+static inline size_t ring_load(size_t *p) {
+	return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void ring_store(size_t *p, size_t value) {
+	__atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+static inline bool ring_cas(size_t *p, size_t expected, size_t desired) {
+	return __atomic_compare_exchange_n(p, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+#endif
+
+/**
+ * \brief  Allocates and initializes a new lock-free fifo queue
+ *
+ * \param  capacity  The minimum number of elements the ring can hold, rounded up to a power of 2
+ * \param  qfree     Pointer to a custom free function to free the ring if not empty.
+ *
+ * \return On success returns a valid pointer, otherwise NULL
+ */
+RZ_API RZ_OWN RzThreadRing *rz_th_ring_new(size_t capacity, RZ_NULLABLE RzListFree qfree) {
+	rz_return_val_if_fail(capacity > 0 && capacity <= (SIZE_MAX >> 2), NULL);
+	size_t size = 2;
+	while (size < capacity) {
+		size <<= 1;
+	}
+
+	RzThreadRing *ring = RZ_NEW0(RzThreadRing);
+	if (!ring) {
+		return NULL;
+	}
+	ring->cells = RZ_NEWS(RzThreadRingCell, size);
+	if (!ring->cells) {
+		free(ring);
+		return NULL;
+	}
+	for (size_t i = 0; i < size; i++) {
+		ring->cells[i].seq = i;
+		ring->cells[i].user = NULL;
+	}
+	ring->mask = size - 1;
+	ring->qfree = qfree;
+	return ring;
+}
+
+/**
+ * \brief  Frees a RzThreadRing structure, no other thread must be using it
+ *
+ * \param  ring The RzThreadRing to free
+ */
+RZ_API void rz_th_ring_free(RZ_NULLABLE RzThreadRing *ring) {
+	if (!ring) {
+		return;
+	}
+	void *user = NULL;
+	while ((user = rz_th_ring_pop(ring))) {
+		if (ring->qfree) {
+			ring->qfree(user);
+		}
+	}
+	free(ring->cells);
+	free(ring);
+}
+
+/**
+ * \brief  Returns the number of elements the ring can hold
+ *
+ * \param  ring The RzThreadRing to check
+ */
+RZ_API size_t rz_th_ring_capacity(RZ_NONNULL RzThreadRing *ring) {
+	rz_return_val_if_fail(ring, 0);
+	return ring->mask + 1;
+}
+
+/**
+ * \brief  Appends a new element to the ring
+ *
+ * \param  ring The RzThreadRing to push to
+ * \param  user The non-null pointer to push to the ring
+ *
+ * \return On success returns true, otherwise false (the ring is full)
+ */
+RZ_API bool rz_th_ring_push(RZ_NONNULL RzThreadRing *ring, RZ_NONNULL void *user) {
+	rz_return_val_if_fail(ring && user, false);
+
+	RzThreadRingCell *cell = NULL;
+	size_t pos = ring_load(&ring->head);
+	for (;;) {
+		cell = &ring->cells[pos & ring->mask];
+		size_t seq = ring_load(&cell->seq);
+		st64 diff = (st64)(seq - pos);
+		if (!diff) {
+			if (ring_cas(&ring->head, pos, pos + 1)) {
+				break;
+			}
+			pos = ring_load(&ring->head);
+		} else if (diff < 0) {
+			// the cell still holds the element pushed a lap before
+			return false;
+		} else {
+			// another producer took this position
+			pos = ring_load(&ring->head);
+		}
+	}
+	cell->user = user;
+	ring_store(&cell->seq, pos + 1);
+	return true;
+}
+
+/**
+ * \brief  Removes the oldest element from the ring, but does not awaits when empty.
+ *
+ * \param  ring The RzThreadRing to pop from
+ *
+ * \return On success returns a valid pointer, otherwise NULL
+ */
+RZ_API RZ_OWN void *rz_th_ring_pop(RZ_NONNULL RzThreadRing *ring) {
+	rz_return_val_if_fail(ring, NULL);
+
+	RzThreadRingCell *cell = NULL;
+	size_t pos = ring_load(&ring->tail);
+	for (;;) {
+		cell = &ring->cells[pos & ring->mask];
+		size_t seq = ring_load(&cell->seq);
+		st64 diff = (st64)(seq - (pos + 1));
+		if (!diff) {
+			if (ring_cas(&ring->tail, pos, pos + 1)) {
+				break;
+			}
+			pos = ring_load(&ring->tail);
+		} else if (diff < 0) {
+			// nothing was pushed at this position yet
+			return NULL;
+		} else {
+			// another consumer took this position
+			pos = ring_load(&ring->tail);
+		}
+	}
+	void *user = cell->user;
+	ring_store(&cell->seq, pos + ring->mask + 1);
+	return user;
+}
+
+/**
+ * \brief  Removes the oldest element from the ring, backing off till one is available.
+ *
+ * The thread first spins, then yields and finally sleeps for increasing
+ * intervals, so a consumer waiting on an idle ring doesn't burn a core.
+ *
+ * \param  ring The RzThreadRing to pop from
+ *
+ * \return Returns the popped pointer
+ */
+RZ_API RZ_OWN void *rz_th_ring_wait_pop(RZ_NONNULL RzThreadRing *ring) {
+	rz_return_val_if_fail(ring, NULL);
+
+	void *user = NULL;
+	int sleep = 1;
+	for (size_t tries = 0; !(user = rz_th_ring_pop(ring)); tries++) {
+		if (tries < RING_SPIN_POPS) {
+			continue;
+		} else if (tries < 2 * RING_SPIN_POPS) {
+			rz_th_yield();
+			continue;
+		}
+		rz_sys_usleep(sleep);
+		sleep = RZ_MIN(sleep * 2, RING_MAX_SLEEP);
+	}
+	return user;
+}
+
+/**
+ * \brief  Returns true if the ring is empty (thread-safe, but other threads may change it right after)
+ *
+ * \param  ring The RzThreadRing to check
+ *
+ * \return When empty returns true, otherwise false
+ */
+RZ_API bool rz_th_ring_is_empty(RZ_NONNULL RzThreadRing *ring) {
+	rz_return_val_if_fail(ring, false);
+	size_t tail = ring_load(&ring->tail);
+	return ring_load(&ring->cells[tail & ring->mask].seq) != tail + 1;
+}
+
+/**
+ * \brief  Returns true if the ring is full (thread-safe, but other threads may change it right after)
+ *
+ * \param  ring The RzThreadRing to check
+ *
+ * \return When full returns true, otherwise false
+ */
+RZ_API bool rz_th_ring_is_full(RZ_NONNULL RzThreadRing *ring) {
+	rz_return_val_if_fail(ring, false);
+	size_t head = ring_load(&ring->head);
+	return ring_load(&ring->cells[head & ring->mask].seq) != head;
+}
@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "thread.h"
+
+/**
+ * \file thread_rwlock.c
+ * RzThreadRWLock is a reader/writer lock: any number of readers can hold it
+ * at the same time, while a writer holds it alone.
+ *
+ * It is phase fair: when a writer leaves, the readers that were waiting at
+ * that moment are let in before the next writer, and new readers wait as long
+ * as a writer is waiting. A writer releasing and taking the lock again right
+ * away thus lets the waiting readers run instead of starving them.
+ * The lock is not recursive on either side.
+ *
+ * rz_th_rwlock_new         Allocates a RzThreadRWLock.
+ * rz_th_rwlock_read_enter  Takes the lock as a reader, waiting for the writers.
+ * rz_th_rwlock_read_leave  Releases the lock taken as a reader.
+ * rz_th_rwlock_write_enter Takes the lock as the writer, waiting for the readers and the other writers.
+ * rz_th_rwlock_write_leave Releases the lock taken as the writer.
+ * rz_th_rwlock_has_waiting_readers Tells whether readers are waiting for the writer.
+ * rz_th_rwlock_free        Frees a RzThreadRWLock.
+ */
+
+struct rz_th_rwlock_t {
+	RzThreadLock *lock; ///< protects all the fields below
+	RzThreadCond *cond; ///< signaled when the lock may be taken by someone else
+	size_t readers; ///< readers holding the lock
+	size_t readers_waiting;
+	size_t readers_admitted; ///< waiting readers let in by the last writer, not entered yet
+	size_t writers_waiting;
+	bool writer;
+};
+
+/**
+ * \brief  Allocates and initializes a new reader/writer lock
+ *
+ * \return On success returns a valid pointer, otherwise NULL
+ */
+RZ_API RZ_OWN RzThreadRWLock *rz_th_rwlock_new(void) {
+	RzThreadRWLock *rwl = RZ_NEW0(RzThreadRWLock);
+	if (!rwl) {
+		return NULL;
+	}
+	rwl->lock = rz_th_lock_new(false);
+	rwl->cond = rz_th_cond_new();
+	if (!rwl->lock || !rwl->cond) {
+		rz_th_rwlock_free(rwl);
+		return NULL;
+	}
+	return rwl;
+}
+
+/**
+ * \brief  Frees a RzThreadRWLock, which must not be held by anyone
+ *
+ * \param  rwl  The RzThreadRWLock to free
+ */
+RZ_API void rz_th_rwlock_free(RZ_NULLABLE RzThreadRWLock *rwl) {
+	if (!rwl) {
+		return;
+	}
+	rz_th_cond_free(rwl->cond);
+	rz_th_lock_free(rwl->lock);
+	free(rwl);
+}
+
+/**
+ * \brief  Takes the lock as a reader, waiting while a writer holds it or waits for it
+ *
+ * \param  rwl  The RzThreadRWLock to take
+ */
+RZ_API void rz_th_rwlock_read_enter(RZ_NONNULL RzThreadRWLock *rwl) {
+	rz_return_if_fail(rwl);
+	rz_th_lock_enter(rwl->lock);
+	rwl->readers_waiting++;
+	while (rwl->writer || (rwl->writers_waiting && !rwl->readers_admitted)) {
+		rz_th_cond_wait(rwl->cond, rwl->lock);
+	}
+	rwl->readers_waiting--;
+	if (rwl->readers_admitted) {
+		rwl->readers_admitted--;
+	}
+	rwl->readers++;
+	rz_th_lock_leave(rwl->lock);
+}
+
+/**
+ * \brief  Releases the lock taken with rz_th_rwlock_read_enter()
+ *
+ * \param  rwl  The RzThreadRWLock to release
+ */
+RZ_API void rz_th_rwlock_read_leave(RZ_NONNULL RzThreadRWLock *rwl) {
+	rz_return_if_fail(rwl);
+	rz_th_lock_enter(rwl->lock);
+	rwl->readers--;
+	if (!rwl->readers) {
+		rz_th_cond_signal_all(rwl->cond);
+	}
+	rz_th_lock_leave(rwl->lock);
+}
+
+/**
+ * \brief  Takes the lock as the writer, waiting for the readers holding or let in and the other writers
+ *
+ * \param  rwl  The RzThreadRWLock to take
+ */
+RZ_API void rz_th_rwlock_write_enter(RZ_NONNULL RzThreadRWLock *rwl) {
+	rz_return_if_fail(rwl);
+	rz_th_lock_enter(rwl->lock);
+	rwl->writers_waiting++;
+	while (rwl->writer || rwl->readers || rwl->readers_admitted) {
+		rz_th_cond_wait(rwl->cond, rwl->lock);
+	}
+	rwl->writers_waiting--;
+	rwl->writer = true;
+	rz_th_lock_leave(rwl->lock);
+}
+
+/**
+ * \brief  Releases the lock taken with rz_th_rwlock_write_enter(), letting the waiting readers in first
+ *
+ * \param  rwl  The RzThreadRWLock to release
+ */
+RZ_API void rz_th_rwlock_write_leave(RZ_NONNULL RzThreadRWLock *rwl) {
+	rz_return_if_fail(rwl);
+	rz_th_lock_enter(rwl->lock);
+	rwl->writer = false;
+	rwl->readers_admitted = rwl->readers_waiting;
+	rz_th_cond_signal_all(rwl->cond);
+	rz_th_lock_leave(rwl->lock);
+}
+
+/**
+ * \brief  Tells whether readers are waiting to take the lock
+ *
+ * Meant for a writer holding the lock for long, to know when it is worth
+ * releasing it for a while.
+ *
+ * \param  rwl  The RzThreadRWLock to check
+ */
+RZ_API bool rz_th_rwlock_has_waiting_readers(RZ_NONNULL RzThreadRWLock *rwl) {
+	rz_return_val_if_fail(rwl, false);
+	rz_th_lock_enter(rwl->lock);
+	bool waiting = rwl->readers_waiting > 0;
+	rz_th_lock_leave(rwl->lock);
+	return waiting;
+}
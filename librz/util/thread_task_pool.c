@@ -0,0 +1,469 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_th.h>
+#include "thread.h"
+
+/**
+ * \file thread_task_pool.c
+ * RzThreadTaskPool runs submitted tasks on a set of persistent workers.
+ *
+ * Unlike RzThreadPool, the threads are owned by the pool and are reused
+ * for every task, so a subsystem only has to submit its work instead of
+ * spawning and joining its own threads.
+ *
+ * Each worker has its own deque: tasks are submitted round-robin to the
+ * workers, a worker runs the most recent task of its own deque and, when
+ * that is empty, steals the oldest task of the others. A thread waiting
+ * on a future runs the queued tasks too, so tasks can submit subtasks and
+ * wait for them without starving the pool.
+ *
+ * Cancellation is cooperative: the break callback is checked before
+ * running each task and the tasks are expected to poll
+ * rz_th_task_pool_is_breaked() while running.
+ */
+
+typedef struct rz_th_task_t {
+	RzThreadFunction function;
+	void *user;
+	RzThreadFuture *future;
+} RzThreadTask;
+
+typedef struct rz_th_task_deque_t {
+	RzThreadLock *lock;
+	RzThreadTask *tasks; ///< circular buffer
+	size_t capacity;
+	size_t first;
+	size_t length;
+} RzThreadTaskDeque;
+
+typedef struct rz_th_task_worker_t {
+	RzThreadTaskPool *pool;
+	size_t index;
+	RzThread *thread;
+} RzThreadTaskWorker;
+
+struct rz_th_task_pool_t {
+	size_t size;
+	RzThreadTaskWorker *workers;
+	RzThreadTaskDeque *deques;
+	RzThreadLock *lock; ///< protects the fields below
+	RzThreadCond *cond; ///< signaled when a task is submitted or on shutdown
+	size_t pending; ///< number of tasks in the deques
+	size_t next; ///< deque receiving the next submitted task
+	bool shutdown;
+	RzThreadBreakCallback is_breaked;
+	void *break_user;
+};
+
+struct rz_th_future_t {
+	RzThreadLock *lock;
+	RzThreadCond *cond;
+	bool done;
+	bool cancelled;
+	void *retv;
+};
+
+static bool deque_init(RzThreadTaskDeque *deque) {
+	deque->lock = rz_th_lock_new(false);
+	return deque->lock != NULL;
+}
+
+static void deque_fini(RzThreadTaskDeque *deque) {
+	rz_th_lock_free(deque->lock);
+	free(deque->tasks);
+}
+
+static bool deque_push(RzThreadTaskDeque *deque, const RzThreadTask *task) {
+	bool ret = true;
+	rz_th_lock_enter(deque->lock);
+	if (deque->length == deque->capacity) {
+		size_t capacity = deque->capacity ? deque->capacity * 2 : 16;
+		RzThreadTask *tasks = RZ_NEWS(RzThreadTask, capacity);
+		if (!tasks) {
+			ret = false;
+			goto end;
+		}
+		for (size_t i = 0; i < deque->length; i++) {
+			tasks[i] = deque->tasks[(deque->first + i) % deque->capacity];
+		}
+		free(deque->tasks);
+		deque->tasks = tasks;
+		deque->capacity = capacity;
+		deque->first = 0;
+	}
+	deque->tasks[(deque->first + deque->length) % deque->capacity] = *task;
+	deque->length++;
+end:
+	rz_th_lock_leave(deque->lock);
+	return ret;
+}
+
+/**
+ * Takes the most recent task when \p newest is set (the owner side),
+ * otherwise the oldest one (the stealing side).
+ */
+static bool deque_take(RzThreadTaskDeque *deque, RzThreadTask *task, bool newest) {
+	bool ret = false;
+	rz_th_lock_enter(deque->lock);
+	if (deque->length) {
+		if (newest) {
+			*task = deque->tasks[(deque->first + deque->length - 1) % deque->capacity];
+		} else {
+			*task = deque->tasks[deque->first];
+			deque->first = (deque->first + 1) % deque->capacity;
+		}
+		deque->length--;
+		ret = true;
+	}
+	rz_th_lock_leave(deque->lock);
+	return ret;
+}
+
+/**
+ * Takes a task from the deque of the worker \p index or steals one from
+ * the other workers; any index out of range only steals.
+ */
+static bool pool_take_task(RzThreadTaskPool *pool, size_t index, RzThreadTask *task) {
+	bool found = index < pool->size && deque_take(&pool->deques[index], task, true);
+	for (size_t i = 1; !found && i <= pool->size; i++) {
+		size_t victim = (index + i) % pool->size;
+		found = victim != index && deque_take(&pool->deques[victim], task, false);
+	}
+	if (found) {
+		rz_th_lock_enter(pool->lock);
+		pool->pending--;
+		rz_th_lock_leave(pool->lock);
+	}
+	return found;
+}
+
+static void future_complete(RzThreadFuture *future, void *retv, bool cancelled) {
+	rz_th_lock_enter(future->lock);
+	future->retv = retv;
+	future->cancelled = cancelled;
+	future->done = true;
+	rz_th_cond_signal_all(future->cond);
+	rz_th_lock_leave(future->lock);
+}
+
+static void pool_run_task(RzThreadTaskPool *pool, RzThreadTask *task) {
+	if (rz_th_task_pool_is_breaked(pool)) {
+		future_complete(task->future, NULL, true);
+		return;
+	}
+	void *retv = task->function(task->user);
+	future_complete(task->future, retv, false);
+}
+
+static void *pool_worker_main(RzThreadTaskWorker *worker) {
+	RzThreadTaskPool *pool = worker->pool;
+	RzThreadTask task;
+	for (;;) {
+		if (pool_take_task(pool, worker->index, &task)) {
+			pool_run_task(pool, &task);
+			continue;
+		}
+		rz_th_lock_enter(pool->lock);
+		while (!pool->pending && !pool->shutdown) {
+			rz_th_cond_wait(pool->cond, pool->lock);
+		}
+		bool stop = pool->shutdown && !pool->pending;
+		rz_th_lock_leave(pool->lock);
+		if (stop) {
+			break;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * \brief  Allocates a pool of persistent workers
+ *
+ * \param  max_threads The maximum number of workers, RZ_THREAD_POOL_ALL_CORES for one per physical core
+ *
+ * \return On success returns a valid pointer, otherwise NULL
+ */
+RZ_API RZ_OWN RzThreadTaskPool *rz_th_task_pool_new(size_t max_threads) {
+	RzThreadTaskPool *pool = RZ_NEW0(RzThreadTaskPool);
+	if (!pool) {
+		return NULL;
+	}
+	size_t size = rz_th_request_physical_cores(max_threads);
+	pool->workers = RZ_NEWS0(RzThreadTaskWorker, size);
+	pool->deques = RZ_NEWS0(RzThreadTaskDeque, size);
+	pool->lock = rz_th_lock_new(false);
+	pool->cond = rz_th_cond_new();
+	if (!pool->workers || !pool->deques || !pool->lock || !pool->cond) {
+		goto fail;
+	}
+	for (size_t i = 0; i < size; i++) {
+		if (!deque_init(&pool->deques[i])) {
+			goto fail;
+		}
+		pool->size++;
+	}
+	for (size_t i = 0; i < size; i++) {
+		RzThreadTaskWorker *worker = &pool->workers[i];
+		worker->pool = pool;
+		worker->index = i;
+		worker->thread = rz_th_new((RzThreadFunction)pool_worker_main, worker);
+		if (!worker->thread) {
+			goto fail;
+		}
+	}
+	return pool;
+
+fail:
+	RZ_LOG_ERROR("thread: cannot allocate the task pool\n");
+	rz_th_task_pool_free(pool);
+	return NULL;
+}
+
+/**
+ * \brief  Runs the tasks still queued, stops the workers and frees the pool
+ *
+ * \param  pool The RzThreadTaskPool to free
+ */
+RZ_API void rz_th_task_pool_free(RZ_NULLABLE RzThreadTaskPool *pool) {
+	if (!pool) {
+		return;
+	}
+	if (pool->lock && pool->cond) {
+		rz_th_lock_enter(pool->lock);
+		pool->shutdown = true;
+		rz_th_cond_signal_all(pool->cond);
+		rz_th_lock_leave(pool->lock);
+	}
+	for (size_t i = 0; pool->workers && i < pool->size; i++) {
+		if (pool->workers[i].thread) {
+			rz_th_wait(pool->workers[i].thread);
+			rz_th_free(pool->workers[i].thread);
+		}
+	}
+	for (size_t i = 0; i < pool->size; i++) {
+		deque_fini(&pool->deques[i]);
+	}
+	free(pool->workers);
+	free(pool->deques);
+	rz_th_lock_free(pool->lock);
+	rz_th_cond_free(pool->cond);
+	free(pool);
+}
+
+/**
+ * \brief  Returns the number of workers of the pool (always >= 1)
+ */
+RZ_API size_t rz_th_task_pool_size(RZ_NONNULL RzThreadTaskPool *pool) {
+	rz_return_val_if_fail(pool, 1);
+	return pool->size;
+}
+
+/**
+ * \brief  Sets the callback telling whether the running tasks should stop
+ *
+ * Once it returns true, queued tasks are not run anymore and their futures
+ * are marked as cancelled, the running ones should notice it through
+ * rz_th_task_pool_is_breaked().
+ *
+ * \param  pool        The RzThreadTaskPool to use
+ * \param  is_breaked  The callback, or NULL to never cancel the tasks
+ * \param  user        The user pointer passed to the callback
+ */
+RZ_API void rz_th_task_pool_set_break_callback(RZ_NONNULL RzThreadTaskPool *pool, RZ_NULLABLE RzThreadBreakCallback is_breaked, RZ_NULLABLE void *user) {
+	rz_return_if_fail(pool);
+	rz_th_lock_enter(pool->lock);
+	pool->is_breaked = is_breaked;
+	pool->break_user = user;
+	rz_th_lock_leave(pool->lock);
+}
+
+/**
+ * \brief  Returns true when the break callback of the pool requested to stop
+ */
+RZ_API bool rz_th_task_pool_is_breaked(RZ_NONNULL RzThreadTaskPool *pool) {
+	rz_return_val_if_fail(pool, true);
+	rz_th_lock_enter(pool->lock);
+	RzThreadBreakCallback is_breaked = pool->is_breaked;
+	void *user = pool->break_user;
+	rz_th_lock_leave(pool->lock);
+	return is_breaked && is_breaked(user);
+}
+
+/**
+ * \brief  Queues \p function to be run with \p user on one of the workers
+ *
+ * \param  pool      The RzThreadTaskPool to use
+ * \param  function  The task to run
+ * \param  user      The user pointer passed to the task
+ *
+ * \return The future of the task to wait for and free, NULL on failure
+ */
+RZ_API RZ_OWN RzThreadFuture *rz_th_task_pool_submit(RZ_NONNULL RzThreadTaskPool *pool, RZ_NONNULL RzThreadFunction function, RZ_NULLABLE void *user) {
+	rz_return_val_if_fail(pool && function, NULL);
+	RzThreadFuture *future = RZ_NEW0(RzThreadFuture);
+	if (!future) {
+		return NULL;
+	}
+	future->lock = rz_th_lock_new(false);
+	future->cond = rz_th_cond_new();
+	if (!future->lock || !future->cond) {
+		goto fail;
+	}
+
+	RzThreadTask task = { .function = function, .user = user, .future = future };
+	rz_th_lock_enter(pool->lock);
+	size_t index = pool->next++ % pool->size;
+	bool queued = !pool->shutdown && deque_push(&pool->deques[index], &task);
+	if (queued) {
+		pool->pending++;
+		rz_th_cond_signal(pool->cond);
+	}
+	rz_th_lock_leave(pool->lock);
+	if (!queued) {
+		goto fail;
+	}
+	return future;
+
+fail:
+	rz_th_lock_free(future->lock);
+	rz_th_cond_free(future->cond);
+	free(future);
+	return NULL;
+}
+
+/**
+ * \brief  Returns true when the task of the future has finished (or has been cancelled)
+ */
+RZ_API bool rz_th_future_is_done(RZ_NONNULL RzThreadFuture *future) {
+	rz_return_val_if_fail(future, false);
+	rz_th_lock_enter(future->lock);
+	bool done = future->done;
+	rz_th_lock_leave(future->lock);
+	return done;
+}
+
+/**
+ * \brief  Returns true when the task of the future was not run because the pool was breaked
+ */
+RZ_API bool rz_th_future_is_cancelled(RZ_NONNULL RzThreadFuture *future) {
+	rz_return_val_if_fail(future, false);
+	rz_th_lock_enter(future->lock);
+	bool cancelled = future->cancelled;
+	rz_th_lock_leave(future->lock);
+	return cancelled;
+}
+
+/**
+ * \brief  Awaits the end of the task of the future, running the queued tasks of \p pool meanwhile
+ *
+ * \param  pool    The RzThreadTaskPool the task was submitted to
+ * \param  future  The RzThreadFuture to wait for
+ *
+ * \return The value returned by the task, NULL if it was cancelled
+ */
+RZ_API void *rz_th_future_wait(RZ_NONNULL RzThreadTaskPool *pool, RZ_NONNULL RzThreadFuture *future) {
+	rz_return_val_if_fail(pool && future, NULL);
+	RzThreadTask task;
+	while (!rz_th_future_is_done(future)) {
+		if (pool_take_task(pool, SIZE_MAX, &task)) {
+			pool_run_task(pool, &task);
+			continue;
+		}
+		// every task left is already running, one of them is ours
+		rz_th_lock_enter(future->lock);
+		while (!future->done) {
+			rz_th_cond_wait(future->cond, future->lock);
+		}
+		rz_th_lock_leave(future->lock);
+	}
+	rz_th_lock_enter(future->lock);
+	void *retv = future->retv;
+	rz_th_lock_leave(future->lock);
+	return retv;
+}
+
+/**
+ * \brief  Frees a future, its task must be done
+ */
+RZ_API void rz_th_future_free(RZ_NULLABLE RzThreadFuture *future) {
+	if (!future) {
+		return;
+	}
+	rz_return_if_fail(rz_th_future_is_done(future));
+	rz_th_lock_free(future->lock);
+	rz_th_cond_free(future->cond);
+	free(future);
+}
+
+typedef struct {
+	RzThreadRangeFunction function;
+	void *user;
+	size_t from;
+	size_t to;
+} RzThreadRange;
+
+static void *pool_range_task(RzThreadRange *range) {
+	range->function(range->from, range->to, range->user);
+	return NULL;
+}
+
+/**
+ * \brief  Calls \p function over [from, to) split in ranges of \p grain indexes run in parallel
+ *
+ * The caller runs the queued tasks too while waiting, so this can also be
+ * called from a task running on the pool.
+ *
+ * \param  pool      The RzThreadTaskPool to use
+ * \param  from      The first index
+ * \param  to        The index after the last one
+ * \param  grain     The number of indexes of each range, 0 to let the pool choose
+ * \param  function  The function to call on each range
+ * \param  user      The user pointer passed to the function
+ *
+ * \return true if every range has been processed, false when the pool was breaked or on failure
+ */
+RZ_API bool rz_th_task_pool_parallel_for(RZ_NONNULL RzThreadTaskPool *pool, size_t from, size_t to, size_t grain, RZ_NONNULL RzThreadRangeFunction function, RZ_NULLABLE void *user) {
+	rz_return_val_if_fail(pool && function, false);
+	if (from >= to) {
+		return true;
+	}
+	size_t count = to - from;
+	if (!grain) {
+		// a few ranges per worker, so they can balance the load by stealing
+		grain = RZ_MAX(count / (pool->size * 4), 1);
+	}
+	size_t n_ranges = (count + grain - 1) / grain;
+	RzThreadRange *ranges = RZ_NEWS(RzThreadRange, n_ranges);
+	RzThreadFuture **futures = RZ_NEWS0(RzThreadFuture *, n_ranges);
+	if (!ranges || !futures) {
+		free(ranges);
+		free(futures);
+		return false;
+	}
+
+	bool ret = true;
+	for (size_t i = 0; i < n_ranges; i++) {
+		ranges[i].function = function;
+		ranges[i].user = user;
+		ranges[i].from = from + i * grain;
+		ranges[i].to = RZ_MIN(ranges[i].from + grain, to);
+		futures[i] = rz_th_task_pool_submit(pool, (RzThreadFunction)pool_range_task, &ranges[i]);
+		if (!futures[i]) {
+			// run it here, the range must be processed anyway
+			ret = false;
+			pool_range_task(&ranges[i]);
+		}
+	}
+	for (size_t i = 0; i < n_ranges; i++) {
+		if (!futures[i]) {
+			continue;
+		}
+		rz_th_future_wait(pool, futures[i]);
+		ret &= !rz_th_future_is_cancelled(futures[i]);
+		rz_th_future_free(futures[i]);
+	}
+	free(futures);
+	free(ranges);
+	return ret && !rz_th_task_pool_is_breaked(pool);
+}
@@ -0,0 +1,202 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "thread.h"
+#include <rz_util.h>
+#include <rz_constructor.h>
+#if __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+typedef struct {
+	char *name; ///< NULL for the end events
+	const char *cat; ///< static string
+	ut64 ts; ///< microseconds, see rz_time_now_mono()
+	ut64 tid;
+} TraceEvent;
+
+typedef struct {
+	RzThreadLock *lock;
+	RzVector /*<TraceEvent>*/ events;
+} Tracing;
+
+static Tracing *tracing;
+static volatile bool tracing_enabled;
+
+static void trace_event_fini(void *e, void *user) {
+	free(((TraceEvent *)e)->name);
+}
+
+static Tracing *tracing_new(void) {
+	Tracing *t = RZ_NEW0(Tracing);
+	if (!t) {
+		return NULL;
+	}
+	t->lock = rz_th_lock_new(false);
+	if (!t->lock) {
+		free(t);
+		return NULL;
+	}
+	rz_vector_init(&t->events, sizeof(TraceEvent), trace_event_fini, NULL);
+	return t;
+}
+
+static void tracing_free(Tracing *t) {
+	if (!t) {
+		return;
+	}
+	rz_vector_fini(&t->events);
+	rz_th_lock_free(t->lock);
+	free(t);
+}
+
+static RzThreadOnce tracing_once = RZ_THREAD_ONCE_INIT;
+
+static void tracing_init(void) {
+	tracing = tracing_new();
+}
+
+#ifdef RZ_HAS_CONSTRUCTORS
+#ifdef RZ_DEFINE_DESTRUCTOR_NEEDS_PRAGMA
+#pragma RZ_DEFINE_DESTRUCTOR_PRAGMA_ARGS(tracing_destructor)
+#endif
+RZ_DEFINE_DESTRUCTOR(tracing_destructor)
+static void tracing_destructor(void) {
+	tracing_enabled = false;
+	tracing_free(tracing);
+	tracing = NULL;
+}
+#endif
+
+static Tracing *tracing_get(void) {
+	rz_th_once(&tracing_once, tracing_init);
+	return tracing;
+}
+
+static ut64 current_tid(void) {
+#if __WINDOWS__
+	return GetCurrentThreadId();
+#elif __linux__ && defined(SYS_gettid)
+	return syscall(SYS_gettid);
+#else
+	return (ut64)(size_t)rz_th_self();
+#endif
+}
+
+static void tracing_push(const char *cat, const char *name) {
+	Tracing *t = tracing_get();
+	if (!t) {
+		return;
+	}
+	TraceEvent e = {
+		.cat = cat,
+		.ts = rz_time_now_mono(),
+		.tid = current_tid()
+	};
+	rz_th_lock_enter(t->lock);
+	if (rz_vector_len(&t->events) < RZ_TRACING_MAX_EVENTS) {
+		e.name = name ? strdup(name) : NULL;
+		if (!name || e.name) {
+			rz_vector_push(&t->events, &e);
+		}
+	}
+	rz_th_lock_leave(t->lock);
+}
+
+/**
+ * \brief Start or stop recording the trace events, the recorded ones are kept
+ */
+RZ_API void rz_tracing_enable(bool enable) {
+	if (enable && !tracing_get()) {
+		return;
+	}
+	tracing_enabled = enable;
+}
+
+RZ_API bool rz_tracing_is_enabled(void) {
+	return tracing_enabled;
+}
+
+/**
+ * \brief Record the start of the span \p name of the category \p cat on the current thread
+ *
+ * \param cat static string, not copied
+ * \param name copied
+ */
+RZ_API void rz_tracing_begin(RZ_NONNULL const char *cat, RZ_NONNULL const char *name) {
+	rz_return_if_fail(cat && name);
+	if (!tracing_enabled) {
+		return;
+	}
+	tracing_push(cat, name);
+}
+
+/**
+ * \brief Record the end of the last span begun on the current thread
+ */
+RZ_API void rz_tracing_end(RZ_NONNULL const char *cat) {
+	rz_return_if_fail(cat);
+	if (!tracing_enabled) {
+		return;
+	}
+	tracing_push(cat, NULL);
+}
+
+/**
+ * \brief Drop all the recorded events
+ */
+RZ_API void rz_tracing_reset(void) {
+	Tracing *t = tracing_get();
+	if (!t) {
+		return;
+	}
+	rz_th_lock_enter(t->lock);
+	rz_vector_clear(&t->events);
+	rz_th_lock_leave(t->lock);
+}
+
+RZ_API size_t rz_tracing_count(void) {
+	Tracing *t = tracing_get();
+	if (!t) {
+		return 0;
+	}
+	rz_th_lock_enter(t->lock);
+	size_t count = rz_vector_len(&t->events);
+	rz_th_lock_leave(t->lock);
+	return count;
+}
+
+/**
+ * \brief Export the recorded events as a Chrome trace JSON object
+ */
+RZ_API RZ_OWN char *rz_tracing_to_json(void) {
+	Tracing *t = tracing_get();
+	PJ *pj = pj_new();
+	if (!t || !pj) {
+		pj_free(pj);
+		return NULL;
+	}
+	int pid = rz_sys_getpid();
+	pj_o(pj);
+	pj_ka(pj, "traceEvents");
+	rz_th_lock_enter(t->lock);
+	TraceEvent *e;
+	rz_vector_foreach(&t->events, e) {
+		pj_o(pj);
+		if (e->name) {
+			pj_ks(pj, "name", e->name);
+		}
+		pj_ks(pj, "cat", e->cat);
+		pj_ks(pj, "ph", e->name ? "B" : "E");
+		pj_kn(pj, "ts", e->ts);
+		pj_kn(pj, "pid", pid);
+		pj_kn(pj, "tid", e->tid);
+		pj_end(pj);
+	}
+	rz_th_lock_leave(t->lock);
+	pj_end(pj);
+	pj_ks(pj, "displayTimeUnit", "ms");
+	pj_end(pj);
+	return pj_drain(pj);
+}
@@ -14,6 +14,25 @@
 #define SZ 1024
 static const char cb64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 static const char cd64[] = "|$$$}rstuvwxyz{$$$$$$$>?@ABCDEFGHIJKLMNOPQRSTUVW$$$$$$XYZ[\\]^_`abcdefghijklmnopq";
+// value of every symbol of the alphabet, 0xff for padding and invalid characters
+static const ut8 dec64[256] = {
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+	0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+	0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+	0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
 
 static void local_b64_encode(const ut8 in[3], char out[4], int len) {
 	if (len < 1) {
@@ -51,6 +70,15 @@ RZ_API int rz_base64_decode(ut8 *bout, const char *bin, int len) {
 		len = strlen(bin);
 	}
 	for (in = out = 0; in + 3 < len; in += 4) {
+		const ut8 *q = (const ut8 *)bin + in;
+		ut8 a = dec64[q[0]], b = dec64[q[1]], c = dec64[q[2]], d = dec64[q[3]];
+		if (!((a | b | c | d) & 0x80)) {
+			// four symbols, no padding
+			bout[out++] = a << 2 | b >> 4;
+			bout[out++] = b << 4 | c >> 2;
+			bout[out++] = c << 6 | d;
+			continue;
+		}
 		int ret = local_b64_decode(bin + in, bout + out);
 		if (ret < 1) {
 			return -1;
@@ -81,9 +109,16 @@ RZ_API ut8 *rz_base64_decode_dyn(const char *in, int len) {
 RZ_API size_t rz_base64_encode(char *bout, const ut8 *bin, size_t sz) {
 	rz_return_val_if_fail(bin, 0);
 	size_t in, out;
-	for (in = out = 0; in < sz; in += 3, out += 4) {
-		local_b64_encode(bin + in, (char *)bout + out,
-			(sz - in) > 3 ? 3 : sz - in);
+	for (in = out = 0; sz - in >= 3; in += 3, out += 4) {
+		ut32 v = (ut32)bin[in] << 16 | (ut32)bin[in + 1] << 8 | bin[in + 2];
+		bout[out] = cb64[v >> 18];
+		bout[out + 1] = cb64[(v >> 12) & 0x3f];
+		bout[out + 2] = cb64[(v >> 6) & 0x3f];
+		bout[out + 3] = cb64[v & 0x3f];
+	}
+	if (in < sz) {
+		local_b64_encode(bin + in, (char *)bout + out, sz - in);
+		out += 4;
 	}
 	bout[out] = 0;
 	return out;
@@ -19,6 +19,7 @@
 #define GDB_REMOTE_TYPE_GDB  0
 #define GDB_REMOTE_TYPE_LLDB 1
 #define GDB_MAX_PKTSZ        4
+#define GDB_PKTSZ_LIMIT      0x20000
 
 /*!
  * Structure that saves a gdb message
@@ -176,6 +177,7 @@ typedef struct libgdbr_t {
 	int pid; // little endian
 	int tid; // little endian
 	int page_size; // page size for target (useful for qemu)
+	ut64 mem_gen; // bumped whenever the target may have run, memory read before is stale
 	bool attached; // Remote server attached to process or created
 	libgdbr_stub_features_t stub_features;
 
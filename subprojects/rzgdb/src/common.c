@@ -19,8 +19,8 @@ int handle_qSupported(libgdbr_t *g) {
 	tok = strtok(g->data, ";");
 	while (tok) {
 		if (rz_str_startswith(tok, "PacketSize=")) {
-			// Largest packet size we support is 2048
-			g->stub_features.pkt_sz = RZ_MIN(strtoul(tok + strlen("PacketSize="), NULL, 16), 2048);
+			// Memory reads are split by this size, keep it sane but don't waste what the stub offers
+			g->stub_features.pkt_sz = RZ_MIN(strtoul(tok + strlen("PacketSize="), NULL, 16), GDB_PKTSZ_LIMIT);
 			// Shouldn't be smaller than 64 (Erroneous 0 etc.)
 			g->stub_features.pkt_sz = RZ_MAX(g->stub_features.pkt_sz, 64);
 		} else if (rz_str_startswith(tok, "qXfer:")) {
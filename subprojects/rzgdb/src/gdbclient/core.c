@@ -309,6 +309,7 @@ int gdbr_select(libgdbr_t *g, int pid, int tid) {
 		goto end;
 	}
 	reg_cache.valid = false;
+	g->mem_gen++;
 	g->pid = pid;
 	g->tid = tid;
 	strcpy(cmd, "Hg");
@@ -411,6 +412,7 @@ int gdbr_check_extended_mode(libgdbr_t *g) {
 	}
 	g->stop_reason.is_valid = false;
 	reg_cache.valid = false;
+	g->mem_gen++;
 	// Activate extended mode if possible.
 	ret = send_msg(g, "!");
 	if (ret < 0) {
@@ -450,6 +452,7 @@ int gdbr_attach(libgdbr_t *g, int pid) {
 	}
 	g->stop_reason.is_valid = false;
 	reg_cache.valid = false;
+	g->mem_gen++;
 
 	if (g->stub_features.extended_mode == -1) {
 		gdbr_check_extended_mode(g);
@@ -504,6 +507,7 @@ int gdbr_detach(libgdbr_t *g) {
 	}
 
 	reg_cache.valid = false;
+	g->mem_gen++;
 	g->stop_reason.is_valid = false;
 	ret = send_msg(g, "D");
 	if (ret < 0) {
@@ -531,6 +535,7 @@ int gdbr_detach_pid(libgdbr_t *g, int pid) {
 	}
 
 	reg_cache.valid = false;
+	g->mem_gen++;
 	g->stop_reason.is_valid = false;
 
 	buffer_size = strlen(CMD_DETACH_MP) + (sizeof(pid) * 2) + 1;
@@ -581,6 +586,7 @@ int gdbr_kill(libgdbr_t *g) {
 	}
 
 	reg_cache.valid = false;
+	g->mem_gen++;
 	g->stop_reason.is_valid = false;
 
 	if (g->stub_features.multiprocess) {
@@ -616,6 +622,7 @@ int gdbr_kill_pid(libgdbr_t *g, int pid) {
 	}
 
 	reg_cache.valid = false;
+	g->mem_gen++;
 	g->stop_reason.is_valid = false;
 
 	buffer_size = strlen(CMD_KILL_MP) + (sizeof(pid) * 2) + 1;
@@ -724,10 +731,66 @@ end:
 	return ret;
 }
 
-static int gdbr_read_memory_page(libgdbr_t *g, ut64 address, ut8 *buf, int len) {
-	char command[128] = { 0 };
-	int last, ret_len, pkt;
-	ret_len = 0;
+#define READ_MEMORY_PIPELINE 8
+
+static int send_read_memory(libgdbr_t *g, ut64 address, int len) {
+	char command[128];
+	if (snprintf(command, sizeof(command), "%s%" PFMT64x ",%x", CMD_READMEM, address, len) < 0) {
+		return -1;
+	}
+	return send_msg(g, command);
+}
+
+/**
+ * Read the reply of a memory read of \p len bytes into \p buf.
+ * Returns the number of bytes the stub sent, 0 if it refused the read or -1
+ * if the connection failed.
+ */
+static int recv_read_memory(libgdbr_t *g, ut8 *buf, int len) {
+	if (read_packet(g, false) < 0) {
+		return -1;
+	}
+	if (handle_m(g) < 0) {
+		return 0;
+	}
+	int n = RZ_MIN(g->data_len, len);
+	memcpy(buf, g->data, n);
+	return n;
+}
+
+static ut64 page_left(libgdbr_t *g, ut64 address) {
+	ut64 page_size = g->page_size > 0 ? g->page_size : 4096;
+	return page_size - (address & (page_size - 1));
+}
+
+/*
+ * The size of the next request at address: as big as the packet size
+ * allows, ending on a page boundary when it spans more than one page so
+ * that a page the stub can't read only fails its own request.
+ */
+static int read_memory_chunk(libgdbr_t *g, ut64 address, int len, int data_sz) {
+	ut64 page_size = g->page_size > 0 ? g->page_size : 4096;
+	ut64 left = page_left(g, address);
+	if (data_sz > left && data_sz > page_size) {
+		data_sz = (int)(left + ((data_sz - left) / page_size) * page_size);
+	}
+	return RZ_MIN(len, data_sz);
+}
+
+/**
+ * \brief Read target memory with as few round trips as possible
+ *
+ * Requests are as big as the stub's PacketSize allows. In no-ack mode up
+ * to READ_MEMORY_PIPELINE requests are sent before waiting for the
+ * replies, which the stub sends in order.
+ *
+ * \return the number of bytes read from the start of the range, reading stops at the first page the stub refuses
+ */
+int gdbr_read_memory(libgdbr_t *g, ut64 address, ut8 *buf, int len) {
+	struct {
+		int off, len;
+	} reqs[READ_MEMORY_PIPELINE];
+	int done = 0;
 
 	if (!g) {
 		return -1;
@@ -735,126 +798,58 @@ static int gdbr_read_memory_page(libgdbr_t *g, ut64 address, ut8 *buf, int len)
 	if (len < 1) {
 		return len;
 	}
-
 	if (!gdbr_lock_enter(g)) {
 		goto end;
 	}
-
 	g->stub_features.pkt_sz = RZ_MAX(g->stub_features.pkt_sz, GDB_MAX_PKTSZ);
 	int data_sz = g->stub_features.pkt_sz / 2;
-	int num_pkts = len / data_sz;
-	last = len % data_sz;
-	ret_len = 0;
-	for (pkt = 0; pkt < num_pkts; pkt++) {
-		if (snprintf(command, sizeof(command) - 1,
-			    "%s%" PFMT64x ",%" PFMT64x, CMD_READMEM,
-			    (ut64)address + (pkt * data_sz),
-			    (ut64)data_sz) < 0) {
-			ret_len = -1;
-			goto end;
+	// after a request spanning several pages failed, the readable part is found one page at a time
+	bool single = false;
+	while (done < len) {
+		int depth = g->no_ack && !single ? READ_MEMORY_PIPELINE : 1;
+		int n, off = done;
+		for (n = 0; n < depth && off < len; n++) {
+			int sz = single
+				? (int)RZ_MIN(RZ_MIN((ut64)(len - off), page_left(g, address + off)), (ut64)data_sz)
+				: read_memory_chunk(g, address + off, len - off, data_sz);
+			if (send_read_memory(g, address + off, sz) < 0) {
+				break;
+			}
+			reqs[n].off = off;
+			reqs[n].len = sz;
+			off += sz;
 		}
-		if (send_msg(g, command) < 0) {
-			ret_len = -1;
+		if (!n) {
 			goto end;
 		}
-		if (read_packet(g, false) < 0) {
-			ret_len = -1;
-			goto end;
+		int i, failed = -1, failed_got = 0;
+		for (i = 0; i < n; i++) {
+			int got = recv_read_memory(g, buf + reqs[i].off, reqs[i].len);
+			if (got < 0) {
+				// the replies still in flight can't be matched anymore
+				goto end;
+			}
+			if (failed < 0) {
+				done += got;
+				if (got < reqs[i].len) {
+					failed = i;
+					failed_got = got;
+				}
+			}
 		}
-		if (handle_m(g) < 0) {
-			ret_len = -1;
-			goto end;
+		if (failed < 0 || failed_got > 0) {
+			// all good, or a short reply and the rest is asked for again
+			single = false;
+			continue;
 		}
-		int delta = (pkt * data_sz);
-
-		if (delta > len) {
-			eprintf("oops\n");
+		if (single || reqs[failed].len <= page_left(g, address + reqs[failed].off)) {
 			break;
 		}
-		int left = RZ_MIN(g->data_len, len - delta);
-		if (left > 0) {
-			memcpy(buf + delta, g->data, left);
-			ret_len += g->data_len;
-		}
+		single = true;
 	}
-	if (last) {
-		if (snprintf(command, sizeof(command) - 1,
-			    "%s%016" PFMT64x ",%" PFMT64x, CMD_READMEM,
-			    (ut64)(address + (num_pkts * data_sz)),
-			    (ut64)last) < 0) {
-			ret_len = -1;
-			goto end;
-		}
-		if (send_msg(g, command) < 0) {
-			ret_len = -1;
-			goto end;
-		}
-		if (read_packet(g, false) < 0) {
-			ret_len = -1;
-			goto end;
-		}
-		if (handle_m(g) < 0) {
-			ret_len = -1;
-			goto end;
-		}
-		int delta = num_pkts * data_sz;
-		int left = RZ_MIN(g->data_len, len - delta);
-		if (left > 0) {
-			memcpy(buf + delta, g->data, left);
-			ret_len += g->data_len;
-		}
-	}
-end:
-	gdbr_lock_leave(g);
-	return ret_len;
-}
-
-int gdbr_read_memory(libgdbr_t *g, ut64 address, ut8 *buf, int len) {
-	int ret_len, ret, tmp;
-	int page_size = g->page_size;
-	ret_len = 0;
-
-	if (!gdbr_lock_enter(g)) {
-		goto end;
-	}
-
-	// Read and round up to page size
-	tmp = page_size - (address & (page_size - 1));
-	if (tmp >= len) {
-		ret_len = gdbr_read_memory_page(g, address, buf, len);
-		goto end;
-	}
-	if ((ret = gdbr_read_memory_page(g, address, buf, tmp)) != tmp) {
-		ret_len = ret;
-		goto end;
-	}
-	len -= tmp;
-	address += tmp;
-	buf += tmp;
-	ret_len += ret;
-	// Read complete pages
-	while (len > page_size) {
-		if ((ret = gdbr_read_memory_page(g, address, buf, page_size)) != page_size) {
-			if (ret < 1) {
-				goto end;
-			}
-			ret_len += ret;
-			goto end;
-		}
-		len -= page_size;
-		address += page_size;
-		buf += page_size;
-		ret_len += page_size;
-	}
-	// Read left-overs
-	if ((ret = gdbr_read_memory_page(g, address, buf, len)) < 0) {
-		goto end;
-	}
-
-	ret_len += ret;
 end:
 	gdbr_lock_leave(g);
-	return ret_len;
+	return done > 0 ? done : -1;
 }
 
 int gdbr_write_memory(libgdbr_t *g, ut64 address, const uint8_t *data, ut64 len) {
@@ -972,6 +967,10 @@ end:
 	return ret;
 }
 
+static bool reply_ok(libgdbr_t *g) {
+	return g->data_len == 2 && !strncmp(g->data, "OK", 2);
+}
+
 int gdbr_write_bin_registers(libgdbr_t *g, const char *regs, int len) {
 	int ret = -1;
 	uint64_t buffer_size = 0;
@@ -987,6 +986,11 @@ int gdbr_write_bin_registers(libgdbr_t *g, const char *regs, int len) {
 
 	buffer_size = len * 2 + 8;
 	reg_cache.valid = false;
+	// regs may be g->data, which the reply overwrites
+	bool cache = reg_cache.init && len <= reg_cache.maxlen;
+	if (cache) {
+		memcpy(reg_cache.buf, regs, len);
+	}
 
 	command = calloc(buffer_size, sizeof(char));
 	if (!command) {
@@ -1005,6 +1009,11 @@ int gdbr_write_bin_registers(libgdbr_t *g, const char *regs, int len) {
 		ret = -1;
 		goto end;
 	}
+	if (cache && reply_ok(g)) {
+		// the target now holds exactly what we sent, no need to ask for it again
+		reg_cache.buflen = len;
+		reg_cache.valid = true;
+	}
 
 	ret = 0;
 end:
@@ -1025,7 +1034,6 @@ int gdbr_write_register(libgdbr_t *g, int index, char *value, int len) {
 		goto end;
 	}
 
-	reg_cache.valid = false;
 	ret = snprintf(command, sizeof(command) - 1, "%s%x=", CMD_WRITEREG, index);
 	if (len + ret >= sizeof(command)) {
 		eprintf("command is too small\n");
@@ -1048,9 +1056,19 @@ int gdbr_write_register(libgdbr_t *g, int index, char *value, int len) {
 		ret = -1;
 		goto end;
 	}
+	int offset = g->registers[index].offset / 8;
+	if (reply_ok(g) && reg_cache.valid && offset + len <= reg_cache.buflen) {
+		// patch the cached 'g' reply instead of fetching all registers again
+		memcpy(reg_cache.buf + offset, value, len);
+	} else {
+		reg_cache.valid = false;
+	}
 
 	ret = 0;
 end:
+	if (ret < 0) {
+		reg_cache.valid = false;
+	}
 	gdbr_lock_leave(g);
 	return ret;
 }
@@ -1272,6 +1290,7 @@ int send_vcont(libgdbr_t *g, const char *command, const char *thread_id) {
 		goto end;
 	}
 	reg_cache.valid = false;
+	g->mem_gen++;
 	g->stop_reason.is_valid = false;
 	ret = send_msg(g, tmp);
 	if (ret < 0) {
@@ -1590,6 +1609,7 @@ int gdbr_send_qRcmd(libgdbr_t *g, const char *cmd, PrintfCallback cb_printf) {
 	}
 	g->stop_reason.is_valid = false;
 	reg_cache.valid = false;
+	g->mem_gen++;
 	pack_hex(cmd, strlen(cmd), buf + 6);
 	if ((ret = send_msg(g, buf)) < 0) {
 		goto end;
@@ -61,7 +61,7 @@ static int unpack(libgdbr_t *g, struct parse_ctx *ctx, int len) {
 					(g->read_buff[i + 1] == '+' && g->read_buff[i + 2] == '$')) {
 					// Packets clubbed together
 					g->read_len = len - i - 1;
-					memcpy(g->read_buff, g->read_buff + i + 1, g->read_len);
+					memmove(g->read_buff, g->read_buff + i + 1, g->read_len);
 					g->read_buff[g->read_len] = '\0';
 					return 0;
 				}
@@ -149,8 +149,13 @@ int read_packet(libgdbr_t *g, bool vcont) {
 	}
 	g->data_len = 0;
 	if (g->read_len > 0) {
-		if (unpack(g, &ctx, g->read_len) == 0) {
-			// TODO: Evaluate if partial packets are clubbed
+		int len = g->read_len;
+		g->read_len = 0;
+		ret = unpack(g, &ctx, len);
+		if (ret < 0) {
+			return -1;
+		}
+		if (!ret) {
 			g->data[g->data_len] = '\0';
 			if (g->server_debug) {
 				eprintf("getpkt (\"%s\");  %s\n", g->data,
@@ -158,8 +163,8 @@ int read_packet(libgdbr_t *g, bool vcont) {
 			}
 			return 0;
 		}
+		// the start of a packet was left over from the last read, ctx continues with the rest
 	}
-	g->data_len = 0;
 	for (i = 0; i < g->num_retries && !g->isbreaked; vcont ? 0 : i++) {
 		ret = rz_socket_ready(g->sock, 0, READ_TIMEOUT);
 		if (ret == 0 && !vcont) {
@@ -212,23 +217,24 @@ int pack(libgdbr_t *g, const char *msg) {
 		return -1;
 	}
 	msg_len = strlen(msg);
-	if (msg_len > g->send_max + 5) {
-		eprintf("%s: message too long: %s", __func__, msg);
-		return -1;
-	}
 	if (!g->send_buff) {
 		return -1;
 	}
+	// worst case every char is escaped, plus '$', "#xx" and the terminator
+	if (msg_len * 2 + 5 > g->send_max) {
+		char *buff = realloc(g->send_buff, msg_len * 2 + 5);
+		if (!buff) {
+			return -1;
+		}
+		g->send_buff = buff;
+		g->send_max = msg_len * 2 + 5;
+	}
 	g->send_buff[0] = '$';
 	g->send_len = 1;
 	src = msg;
 	while (*src) {
 		if (*src == '#' || *src == '$' || *src == '}') {
 			msg_len += 1;
-			if (msg_len > g->send_max + 5) {
-				eprintf("%s: message too long: %s", __func__, msg);
-				return -1;
-			}
 			g->send_buff[g->send_len++] = '}';
 			g->send_buff[g->send_len++] = *src++ ^ 0x20;
 			continue;
@@ -116,6 +116,8 @@ bool winkd_set_target(RZ_BORROW RZ_NONNULL WindCtx *ctx, ut32 pid, ut32 tid) {
 			if (p->uniqueid == pid) {
 				found = true;
 				ctx->target = *p;
+				// user addresses now go through another directory table
+				ctx->mem_gen++;
 				break;
 			}
 		}
@@ -580,16 +582,29 @@ int winkd_op_at_uva(RZ_BORROW RZ_NONNULL WindCtx *ctx, ut64 address, ut8 *buf, i
 			offset += restOfPage;
 			continue;
 		}
+		// go on with the next pages as long as they are physically contiguous
+		ut32 len = RZ_MIN(count - offset, restOfPage);
+		ut64 next_pa;
+		while (offset + len < count && winkd_va_to_pa(ctx, ctx->target.dir_base_table, address + len, &next_pa) && next_pa == pa + len) {
+			len += RZ_MIN(count - offset - len, 0x1000);
+		}
 		int result;
 		if (write) {
-			result = ctx->write_at_physical(ctx->user, pa, buf + offset, RZ_MIN(count - offset, restOfPage));
+			result = ctx->write_at_physical(ctx->user, pa, buf + offset, len);
 		} else {
-			result = ctx->read_at_physical(ctx->user, pa, buf + offset, RZ_MIN(count - offset, restOfPage));
+			result = ctx->read_at_physical(ctx->user, pa, buf + offset, len);
+		}
+		if (result <= 0) {
+			break;
 		}
 		address += result;
 		offset += result;
 		total += result;
 	}
+	if (write) {
+		// the page tables may have been written
+		winkd_tlb_flush(ctx);
+	}
 	return total;
 }
 
@@ -854,6 +869,21 @@ static inline bool is_page_large(RZ_BORROW RZ_NONNULL WindCtx *ctx, ut64 page_de
 	return page_descriptor & PTE_LARGEPAGE;
 }
 
+static bool tlb_lookup(RZ_BORROW RZ_NONNULL WindCtx *ctx, WindTlbEntry *cache, ut64 dtb, ut64 key, WindTlbEntry **slot) {
+	WindTlbEntry *e = &cache[(key ^ (dtb >> 12)) & (WINKD_TLB_SIZE - 1)];
+	*slot = e;
+	return e->valid && e->gen == ctx->tlb_gen && e->dtb == dtb && e->va == key;
+}
+
+static void tlb_fill(RZ_BORROW RZ_NONNULL WindCtx *ctx, WindTlbEntry *e, ut64 dtb, ut64 key, ut64 pa, bool large) {
+	e->dtb = dtb;
+	e->va = key;
+	e->pa = pa;
+	e->large = large;
+	e->gen = ctx->tlb_gen;
+	e->valid = true;
+}
+
 // http://blogs.msdn.com/b/ntdebugging/archive/2010/02/05/understanding-pte-part-1-let-s-get-physical.aspx
 // http://blogs.msdn.com/b/ntdebugging/archive/2010/04/14/understanding-pte-part2-flags-and-large-pages.aspx
 // http://blogs.msdn.com/b/ntdebugging/archive/2010/06/22/part-3-understanding-pte-non-pae-and-x64.aspx
@@ -861,6 +891,13 @@ bool winkd_va_to_pa(RZ_BORROW RZ_NONNULL WindCtx *ctx, ut64 directory_table, ut6
 	ut64 pml4i, pdpi, pdi, pti;
 	ut64 tmp, mask;
 
+	// every level of the walk is a round trip to the target, look for a cached translation first
+	WindTlbEntry *page;
+	if (tlb_lookup(ctx, ctx->tlb, directory_table, va >> 12, &page)) {
+		*pa = page->pa | (va & 0xfff);
+		return true;
+	}
+
 	if (ctx->is_64bit) {
 		pti = (va >> 12) & 0x1ff;
 		pdi = (va >> 21) & 0x1ff;
@@ -884,48 +921,61 @@ bool winkd_va_to_pa(RZ_BORROW RZ_NONNULL WindCtx *ctx, ut64 directory_table, ut6
 		mask = 0xfffff000;
 	}
 
-	tmp = directory_table;
-	tmp &= ~0x1f;
+	const int read_size = ctx->is_pae ? 8 : 4;
+	// The page size differs between pae and non-pae systems, the former points to 2MB pages while
+	// the latter points to 4MB pages
+	const ut64 large_mask = ctx->is_pae ? 0x1fffff : 0x3fffff;
+
+	WindTlbEntry *pt;
+	const ut64 pt_key = va >> (ctx->is_64bit || ctx->is_pae ? 21 : 22);
+	if (!tlb_lookup(ctx, ctx->pt_cache, directory_table, pt_key, &pt)) {
+		tmp = directory_table;
+		tmp &= ~0x1f;
+
+		if (ctx->is_64bit) {
+			// PML4 lookup
+			if (!ctx->read_at_physical(ctx->user, tmp + pml4i * 8, (ut8 *)&tmp, 8)) {
+				return false;
+			}
+			tmp &= mask;
+		}
 
-	if (ctx->is_64bit) {
-		// PML4 lookup
-		if (!ctx->read_at_physical(ctx->user, tmp + pml4i * 8, (ut8 *)&tmp, 8)) {
-			return false;
+		if (ctx->is_pae) {
+			// PDPT lookup
+			if (!ctx->read_at_physical(ctx->user, tmp + pdpi * 8, (ut8 *)&tmp, 8)) {
+				return false;
+			}
+			tmp &= mask;
 		}
-		tmp &= mask;
-	}
 
-	if (ctx->is_pae) {
-		// PDPT lookup
-		if (!ctx->read_at_physical(ctx->user, tmp + pdpi * 8, (ut8 *)&tmp, 8)) {
+		// PDT lookup
+		if (!ctx->read_at_physical(ctx->user, tmp + pdi * read_size, (ut8 *)&tmp, read_size)) {
 			return false;
 		}
-		tmp &= mask;
-	}
 
-	const int read_size = ctx->is_pae ? 8 : 4;
-
-	// PDT lookup
-	if (!ctx->read_at_physical(ctx->user, tmp + pdi * read_size, (ut8 *)&tmp, read_size)) {
-		return false;
+		// Large page entry
+		if (is_page_large(ctx, tmp)) {
+			tmp = (tmp << 16) >> 16;
+			tlb_fill(ctx, pt, directory_table, pt_key, tmp & ~large_mask, true);
+		} else {
+			tlb_fill(ctx, pt, directory_table, pt_key, tmp & mask, false);
+		}
 	}
 
-	// Large page entry
-	// The page size differs between pae and non-pae systems, the former points to 2MB pages while
-	// the latter points to 4MB pages
-	if (is_page_large(ctx, tmp)) {
-		tmp = (tmp << 16) >> 16;
-		*pa = ctx->is_pae ? (tmp & (~0x1fffff)) | (va & 0x1fffff) : (tmp & (~0x3fffff)) | (va & 0x3fffff);
+	if (pt->large) {
+		*pa = pt->pa | (va & large_mask);
 		return true;
 	}
 
 	// PT lookup
-	if (!ctx->read_at_physical(ctx->user, (tmp & mask) + pti * read_size, (ut8 *)&tmp, read_size)) {
+	tmp = 0;
+	if (!ctx->read_at_physical(ctx->user, pt->pa + pti * read_size, (ut8 *)&tmp, read_size)) {
 		return false;
 	}
 
 	if (tmp & PTE_VALID) {
 		*pa = (tmp & mask) | (va & 0xfff);
+		tlb_fill(ctx, page, directory_table, va >> 12, tmp & mask, false);
 		return true;
 	}
 
@@ -1172,6 +1222,9 @@ int winkd_continue(RZ_BORROW RZ_NONNULL KdCtx *ctx, bool handled) {
 	rz_list_free(ctx->tlist_cache);
 	ctx->tlist_cache = NULL;
 	ctx->context_cache_valid = false;
+	// the target runs, nothing read from it so far can be trusted anymore
+	ctx->windctx.mem_gen++;
+	winkd_tlb_flush(&ctx->windctx);
 	winkd_lock_leave(ctx);
 	return ret == KD_E_OK;
 }
@@ -1388,6 +1441,8 @@ int winkd_write_at(RZ_BORROW RZ_NONNULL KdCtx *ctx, const ut64 offset, RZ_BORROW
 	if (!ctx || !ctx->desc || !ctx->syncd) {
 		return 0;
 	}
+	// the page tables may be written
+	winkd_tlb_flush(&ctx->windctx);
 
 	int payload = RZ_MIN(count, KD_MAX_PAYLOAD - sizeof(kd_req_t));
 	req.req = DbgKdWriteVirtualMemoryApi;
@@ -1412,6 +1467,8 @@ int winkd_write_at_phys(RZ_BORROW RZ_NONNULL KdCtx *ctx, const ut64 offset, RZ_B
 	if (!ctx || !ctx->desc || !ctx->syncd) {
 		return 0;
 	}
+	// the page tables may be written
+	winkd_tlb_flush(&ctx->windctx);
 
 	int payload = RZ_MIN(count, KD_MAX_PAYLOAD - sizeof(kd_req_t));
 
@@ -73,6 +73,21 @@ typedef struct {
 	int f[O_Max];
 } Profile;
 
+#define WINKD_TLB_SIZE 512 ///< entries of each translation cache, a power of 2
+
+/**
+ * Translation cache entry, mapping the page (or page table) of a virtual
+ * address in a directory table to its physical address.
+ */
+typedef struct {
+	ut64 dtb;
+	ut64 va; ///< va >> shift of the cache
+	ut64 pa; ///< physical base of the page or page table
+	ut32 gen; ///< WindCtx.tlb_gen the entry was filled at
+	bool large; ///< pa is the base of a large page
+	bool valid;
+} WindTlbEntry;
+
 typedef int WindReadAt(RZ_NONNULL void *user, ut64 address, RZ_BORROW RZ_NONNULL RZ_OUT ut8 *buf, int count);
 typedef int WindWriteAt(RZ_NONNULL void *user, ut64 address, RZ_BORROW RZ_NONNULL RZ_IN const ut8 *buf, int count);
 
@@ -90,6 +105,10 @@ typedef struct _WindCtx {
 	bool is_arm;
 	WindProc target;
 	WindThread target_thread;
+	ut64 mem_gen; ///< bumped whenever the memory seen through the target may have changed
+	ut32 tlb_gen; ///< bumped to flush the translation caches
+	WindTlbEntry tlb[WINKD_TLB_SIZE]; ///< 4K page translations
+	WindTlbEntry pt_cache[WINKD_TLB_SIZE]; ///< page tables of 2/4M regions, so neighbour pages are a single read away
 } WindCtx;
 
 typedef struct _KdCtx {
@@ -138,6 +157,13 @@ static inline ut64 winkd_read_ptr_at(RZ_BORROW RZ_NONNULL WindCtx *ctx, RZ_BORRO
 	return ctx->is_64bit ? rz_read_le64(ptr_buf) : rz_read_le32(ptr_buf);
 }
 
+/**
+ * \brief Forget all cached translations, after page tables may have changed
+ */
+static inline void winkd_tlb_flush(RZ_BORROW RZ_NONNULL WindCtx *ctx) {
+	ctx->tlb_gen++;
+}
+
 static inline void winkd_ctx_fini(RZ_BORROW RZ_NONNULL WindCtx *ctx) {
 	free(ctx->user);
 	free(ctx->profile);
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+// Minimal benchmark harness, the counterpart of minunit.h for test/bench.
+//
+// Each benchmark is a function running its workload b->iterations times
+// between bench_timer_start() and bench_timer_stop(), so that setup and
+// teardown are not measured. Every result is printed on stdout as a line of
+// JSON and also appended to $RZ_BENCH_OUTPUT when set:
+//
+//   {"bench":"ht_up_insert","iterations":1000000,"time_us":81234,"ns_per_iter":81.234,"mb_per_sec":0}
+//
+// $RZ_BENCH_SCALE multiplies the iterations, e.g. 0.01 for a quick smoke run.
+// A benchmark skips itself by setting b->iterations to 0 and returning true.
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <rz_util.h>
+
+typedef struct {
+	const char *name;
+	ut64 iterations;
+	ut64 bytes; ///< bytes processed by one iteration, for the throughput
+	ut64 start;
+	ut64 elapsed; ///< microseconds
+} Bench;
+
+static int bench_failed = 0;
+static int bench_count = 0;
+
+#define bench_timer_start(b) ((b)->start = rz_time_now_mono())
+#define bench_timer_stop(b)  ((b)->elapsed += rz_time_now_mono() - (b)->start)
+
+#define bench_fail(message) \
+	do { \
+		fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, message); \
+		return false; \
+	} while (0)
+
+static ut64 bench_scaled(ut64 iterations) {
+	char *scale = rz_sys_getenv("RZ_BENCH_SCALE");
+	if (RZ_STR_ISNOTEMPTY(scale)) {
+		double s = strtod(scale, NULL);
+		if (s > 0) {
+			iterations = RZ_MAX(1, (ut64)(iterations * s));
+		}
+	}
+	free(scale);
+	return iterations;
+}
+
+static void bench_report(const Bench *b) {
+	if (!b->iterations) {
+		// skipped, e.g. because its inputs are missing
+		return;
+	}
+	PJ *pj = pj_new();
+	if (!pj) {
+		return;
+	}
+	pj_o(pj);
+	pj_ks(pj, "bench", b->name);
+	pj_kn(pj, "iterations", b->iterations);
+	pj_kn(pj, "time_us", b->elapsed);
+	pj_kd(pj, "ns_per_iter", b->elapsed * 1000.0 / b->iterations);
+	pj_kd(pj, "mb_per_sec", b->elapsed ? (double)b->bytes * b->iterations / b->elapsed : 0.0);
+	pj_end(pj);
+	char *line = rz_str_newf("%s\n", pj_string(pj));
+	pj_free(pj);
+	if (!line) {
+		return;
+	}
+	fputs(line, stdout);
+	fflush(stdout);
+	char *output = rz_sys_getenv("RZ_BENCH_OUTPUT");
+	if (RZ_STR_ISNOTEMPTY(output)) {
+		rz_file_dump(output, (const ut8 *)line, strlen(line), true);
+	}
+	free(output);
+	free(line);
+}
+
+#define bench_run_named(fn, bname, iters) \
+	do { \
+		Bench b = { .name = bname, .iterations = bench_scaled(iters) }; \
+		bench_count++; \
+		if (fn(&b)) { \
+			bench_report(&b); \
+		} else { \
+			fprintf(stderr, "%s failed\n", bname); \
+			bench_failed++; \
+		} \
+	} while (0)
+
+#define bench_run(fn, iters) bench_run_named(fn, #fn, iters)
+
+#define bench_main(func) \
+	int main(int argc, char **argv) { \
+		return func(); \
+	}
+
+#endif
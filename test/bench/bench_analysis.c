@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+#include "bench.h"
+
+// a typical x86-64 function body
+static const ut8 x86_64_code[] = {
+	0x55, // push rbp
+	0x48, 0x89, 0xe5, // mov rbp, rsp
+	0x48, 0x83, 0xec, 0x20, // sub rsp, 0x20
+	0x89, 0x7d, 0xec, // mov dword [rbp - 0x14], edi
+	0x48, 0x89, 0x75, 0xe0, // mov qword [rbp - 0x20], rsi
+	0x8b, 0x45, 0xec, // mov eax, dword [rbp - 0x14]
+	0x83, 0xc0, 0x01, // add eax, 1
+	0x89, 0x45, 0xfc, // mov dword [rbp - 4], eax
+	0x48, 0x8d, 0x3d, 0x10, 0x00, 0x00, 0x00, // lea rdi, [rip + 0x10]
+	0xe8, 0x00, 0x00, 0x00, 0x00, // call 0
+	0x83, 0x7d, 0xfc, 0x0a, // cmp dword [rbp - 4], 0xa
+	0x7e, 0xe6, // jle
+	0x8b, 0x45, 0xfc, // mov eax, dword [rbp - 4]
+	0xc9, // leave
+	0xc3, // ret
+};
+
+static RzAnalysis *analysis_new(const char *arch, int bits) {
+	RzAnalysis *analysis = rz_analysis_new();
+	if (!analysis) {
+		return NULL;
+	}
+	rz_analysis_use(analysis, arch);
+	rz_analysis_set_bits(analysis, bits);
+	return analysis;
+}
+
+static bool decode(Bench *b, RzAnalysisOpMask mask) {
+	RzAnalysis *analysis = analysis_new("x86", 64);
+	if (!analysis) {
+		bench_fail("rz_analysis_new");
+	}
+	RzAnalysisOp op;
+	size_t off = 0, total = 0;
+	bench_timer_start(b);
+	for (ut64 i = 0; i < b->iterations; i++) {
+		rz_analysis_op_init(&op);
+		int size = rz_analysis_op(analysis, &op, 0x1000 + off, x86_64_code + off, sizeof(x86_64_code) - off, mask);
+		rz_analysis_op_fini(&op);
+		if (size < 1) {
+			break;
+		}
+		total += size;
+		off = (off + size) % sizeof(x86_64_code);
+	}
+	bench_timer_stop(b);
+	rz_analysis_free(analysis);
+	b->bytes = total / b->iterations;
+	return total > 0;
+}
+
+static bool bench_analysis_op_basic(Bench *b) {
+	return decode(b, RZ_ANALYSIS_OP_MASK_BASIC);
+}
+
+static bool bench_analysis_op_esil(Bench *b) {
+	return decode(b, RZ_ANALYSIS_OP_MASK_BASIC | RZ_ANALYSIS_OP_MASK_ESIL);
+}
+
+static bool bench_analysis_op_il(Bench *b) {
+	return decode(b, RZ_ANALYSIS_OP_MASK_BASIC | RZ_ANALYSIS_OP_MASK_IL);
+}
+
+static bool bench_analysis_op_all(Bench *b) {
+	return decode(b, RZ_ANALYSIS_OP_MASK_ALL);
+}
+
+static int all_benches(void) {
+	bench_run(bench_analysis_op_basic, 0x100000);
+	bench_run(bench_analysis_op_esil, 0x40000);
+	bench_run(bench_analysis_op_il, 0x40000);
+	bench_run(bench_analysis_op_all, 0x40000);
+	return bench_failed;
+}
+
+bench_main(all_benches)
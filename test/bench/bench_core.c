@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+// Macro benchmarks on a pinned set of binaries of test/bins, which are
+// skipped when the binaries were not fetched.
+
+#include <rz_core.h>
+#include <rz_project.h>
+#include "bench.h"
+
+static const char *pinned_bins[] = {
+	"bins/elf/ls",
+	"bins/elf/analysis/x86-helloworld-gcc",
+	"bins/mach0/ls-osx-x86_64",
+	"bins/pe/base.exe",
+};
+
+static RzCore *core_open(const char *path) {
+	if (!rz_file_exists(path)) {
+		eprintf("skipping %s, test/bins are not available\n", path);
+		return NULL;
+	}
+	RzCore *core = rz_core_new();
+	if (!core) {
+		return NULL;
+	}
+	rz_config_set_b(core->config, "scr.interactive", false);
+	rz_config_set_b(core->config, "scr.color", false);
+	RzCoreFile *cf = rz_core_file_open(core, path, RZ_PERM_R, 0);
+	if (!cf || !rz_core_bin_load(core, path, 0)) {
+		rz_core_free(core);
+		return NULL;
+	}
+	return core;
+}
+
+static bool cmd(Bench *b, const char *path, const char *prepare, const char *command) {
+	RzCore *core = core_open(path);
+	if (!core) {
+		// not a failure, the binaries are fetched separately
+		b->iterations = 0;
+		return true;
+	}
+	if (prepare) {
+		free(rz_core_cmd_str(core, prepare));
+	}
+	b->bytes = rz_io_size(core->io);
+	for (ut64 i = 0; i < b->iterations; i++) {
+		bench_timer_start(b);
+		char *out = rz_core_cmd_str(core, command);
+		bench_timer_stop(b);
+		free(out);
+	}
+	rz_core_free(core);
+	return true;
+}
+
+static bool bench_aaa(Bench *b) {
+	ut64 iterations = b->iterations;
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(pinned_bins); i++) {
+		Bench bin = { .iterations = iterations };
+		char *name = rz_str_newf("%s %s", b->name, rz_file_basename(pinned_bins[i]));
+		bin.name = name;
+		bool ok = cmd(&bin, pinned_bins[i], NULL, "aaa");
+		if (ok && bin.iterations) {
+			bench_report(&bin);
+		}
+		free(name);
+		if (!ok) {
+			return false;
+		}
+	}
+	// the binaries are reported one by one
+	b->iterations = 0;
+	return true;
+}
+
+static bool bench_izz(Bench *b) {
+	return cmd(b, pinned_bins[0], NULL, "izz");
+}
+
+static bool bench_search_hex(Bench *b) {
+	return cmd(b, pinned_bins[0], "e search.in=file", "/x 31ed4989d15e");
+}
+
+static bool bench_print_disasm(Bench *b) {
+	return cmd(b, pinned_bins[0], "aa", "pd 4096 @ entry0");
+}
+
+static bool bench_project_save_load(Bench *b) {
+	RzCore *core = core_open(pinned_bins[0]);
+	if (!core) {
+		b->iterations = 0;
+		return true;
+	}
+	free(rz_core_cmd_str(core, "aaa"));
+	char *tmpdir = rz_file_tmpdir();
+	char *prj = rz_file_path_join(tmpdir, "bench_project.rzdb");
+	free(tmpdir);
+	bool ok = true;
+	for (ut64 i = 0; i < b->iterations && ok; i++) {
+		bench_timer_start(b);
+		ok = rz_project_save_file(core, prj, true) == RZ_PROJECT_ERR_SUCCESS;
+		RzCore *loaded = rz_core_new();
+		RzSerializeResultInfo *res = rz_serialize_result_info_new();
+		ok = ok && loaded && res && rz_project_load_file(loaded, prj, true, res) == RZ_PROJECT_ERR_SUCCESS;
+		bench_timer_stop(b);
+		rz_serialize_result_info_free(res);
+		rz_core_free(loaded);
+	}
+	rz_file_rm(prj);
+	free(prj);
+	rz_core_free(core);
+	return ok;
+}
+
+static int all_benches(void) {
+	bench_run_named(bench_aaa, "aaa", 1);
+	bench_run_named(bench_izz, "izz", 4);
+	bench_run_named(bench_search_hex, "/x", 4);
+	bench_run_named(bench_print_disasm, "pd", 8);
+	bench_run_named(bench_project_save_load, "project save/load", 1);
+	return bench_failed;
+}
+
+bench_main(all_benches)
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_io.h>
+#include "bench.h"
+
+#define IO_SIZE 0x100000
+
+static RzIO *io_new(void) {
+	RzIO *io = rz_io_new();
+	if (!io) {
+		return NULL;
+	}
+	char uri[32];
+	snprintf(uri, sizeof(uri), "malloc://0x%x", IO_SIZE);
+	RzIODesc *desc = rz_io_open_at(io, uri, RZ_PERM_R, 0644, 0x400000, NULL);
+	if (!desc) {
+		rz_io_free(io);
+		return NULL;
+	}
+	io->va = true;
+	return io;
+}
+
+static bool read_at(Bench *b, int len) {
+	RzIO *io = io_new();
+	ut8 *buf = malloc(len);
+	if (!io || !buf) {
+		free(buf);
+		rz_io_free(io);
+		bench_fail("rz_io_new");
+	}
+	b->bytes = len;
+	ut64 span = IO_SIZE - len;
+	bool ok = true;
+	bench_timer_start(b);
+	for (ut64 i = 0; i < b->iterations; i++) {
+		// stride over the whole map, like the analysis walking code
+		ok &= rz_io_read_at(io, 0x400000 + (i * 0x1003) % span, buf, len);
+	}
+	bench_timer_stop(b);
+	free(buf);
+	rz_io_free(io);
+	return ok;
+}
+
+static bool bench_io_read_at_16(Bench *b) {
+	return read_at(b, 16);
+}
+
+static bool bench_io_read_at_4k(Bench *b) {
+	return read_at(b, 0x1000);
+}
+
+static bool bench_io_read_at_unmapped(Bench *b) {
+	RzIO *io = io_new();
+	if (!io) {
+		bench_fail("rz_io_new");
+	}
+	ut8 buf[16];
+	bench_timer_start(b);
+	for (ut64 i = 0; i < b->iterations; i++) {
+		rz_io_read_at(io, i * 0x10, buf, sizeof(buf));
+	}
+	bench_timer_stop(b);
+	rz_io_free(io);
+	return true;
+}
+
+static int all_benches(void) {
+	bench_run(bench_io_read_at_16, 0x1000000);
+	bench_run(bench_io_read_at_4k, 0x100000);
+	bench_run(bench_io_read_at_unmapped, 0x1000000);
+	return bench_failed;
+}
+
+bench_main(all_benches)
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_search.h>
+#include "bench.h"
+
+#define SEARCH_BUF_SIZE 0x400000
+
+static int hit_cb(RzSearchKeyword *kw, void *user, ut64 where) {
+	(*(ut64 *)user)++;
+	return 1;
+}
+
+static ut8 *search_buf_new(void) {
+	ut8 *buf = malloc(SEARCH_BUF_SIZE);
+	if (!buf) {
+		return NULL;
+	}
+	ut32 seed = 0xbeef;
+	for (size_t i = 0; i < SEARCH_BUF_SIZE; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 24;
+	}
+	return buf;
+}
+
+static bool search(Bench *b, const char **kws, const char *binmask, size_t count) {
+	ut8 *buf = search_buf_new();
+	RzSearch *s = rz_search_new(RZ_SEARCH_KEYWORD);
+	if (!buf || !s) {
+		free(buf);
+		rz_search_free(s);
+		bench_fail("rz_search_new");
+	}
+	ut64 hits = 0;
+	rz_search_set_callback(s, hit_cb, &hits);
+	for (size_t i = 0; i < count; i++) {
+		rz_search_kw_add(s, rz_search_keyword_new_hex(kws[i], binmask, NULL));
+	}
+	b->bytes = SEARCH_BUF_SIZE;
+	bool ok = true;
+	for (ut64 i = 0; i < b->iterations && ok; i++) {
+		rz_search_begin(s);
+		bench_timer_start(b);
+		ok = rz_search_update(s, 0, buf, SEARCH_BUF_SIZE) != -1;
+		bench_timer_stop(b);
+	}
+	rz_search_free(s);
+	free(buf);
+	return ok;
+}
+
+static bool bench_search_update_1kw(Bench *b) {
+	const char *kws[] = { "31ed4989d15e" };
+	return search(b, kws, NULL, RZ_ARRAY_SIZE(kws));
+}
+
+/* any binmask turns off the first and last byte filter, this one ignores a
+ * single bit, so this is the byte by byte scan the filter replaced */
+static bool bench_search_update_1kw_bytewise(Bench *b) {
+	const char *kws[] = { "31ed4989d15e" };
+	return search(b, kws, "fffffffffffe", RZ_ARRAY_SIZE(kws));
+}
+
+static bool bench_search_update_16kw(Bench *b) {
+	const char *kws[] = {
+		"31ed4989d15e", "554889e5", "c3", "e8000000",
+		"48895c24", "4883ec08", "ffd0", "0f1f4000",
+		"cccccccc", "90909090", "deadbeef", "7f454c46",
+		"4d5a9000", "cafebabe", "feedface", "00000000"
+	};
+	return search(b, kws, NULL, RZ_ARRAY_SIZE(kws));
+}
+
+static int all_benches(void) {
+	bench_run(bench_search_update_1kw, 16);
+	bench_run(bench_search_update_1kw_bytewise, 16);
+	bench_run(bench_search_update_16kw, 8);
+	return bench_failed;
+}
+
+bench_main(all_benches)
@@ -0,0 +1,205 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include <ht_upo.h>
+#include "bench.h"
+
+#define HT_KEYS 0x100000
+
+static bool bench_ht_up_insert(Bench *b) {
+	for (ut64 i = 0; i < b->iterations / HT_KEYS + 1; i++) {
+		HtUP *ht = ht_up_new0();
+		if (!ht) {
+			bench_fail("ht_up_new0");
+		}
+		bench_timer_start(b);
+		for (ut64 k = 0; k < HT_KEYS; k++) {
+			ht_up_insert(ht, k * 0x10, (void *)(size_t)k);
+		}
+		bench_timer_stop(b);
+		ht_up_free(ht);
+	}
+	b->iterations = (b->iterations / HT_KEYS + 1) * HT_KEYS;
+	return true;
+}
+
+static bool bench_ht_up_find(Bench *b) {
+	HtUP *ht = ht_up_new0();
+	if (!ht) {
+		bench_fail("ht_up_new0");
+	}
+	for (ut64 k = 0; k < HT_KEYS; k++) {
+		ht_up_insert(ht, k * 0x10, (void *)(size_t)k);
+	}
+	size_t found = 0;
+	bench_timer_start(b);
+	for (ut64 i = 0; i < b->iterations; i++) {
+		bool hit;
+		ht_up_find(ht, (i % (2 * HT_KEYS)) * 0x10, &hit);
+		found += hit;
+	}
+	bench_timer_stop(b);
+	ht_up_free(ht);
+	return found > 0;
+}
+
+static bool bench_ht_up_delete(Bench *b) {
+	for (ut64 i = 0; i < b->iterations / HT_KEYS + 1; i++) {
+		HtUP *ht = ht_up_new0();
+		if (!ht) {
+			bench_fail("ht_up_new0");
+		}
+		for (ut64 k = 0; k < HT_KEYS; k++) {
+			ht_up_insert(ht, k * 0x10, (void *)(size_t)k);
+		}
+		bench_timer_start(b);
+		for (ut64 k = 0; k < HT_KEYS; k++) {
+			ht_up_delete(ht, k * 0x10);
+		}
+		bench_timer_stop(b);
+		ht_up_free(ht);
+	}
+	b->iterations = (b->iterations / HT_KEYS + 1) * HT_KEYS;
+	return true;
+}
+
+/* the open addressing HtUPO, on the same workloads as HtUP above */
+
+static bool bench_ht_upo_insert(Bench *b) {
+	for (ut64 i = 0; i < b->iterations / HT_KEYS + 1; i++) {
+		HtUPO *ht = ht_upo_new0();
+		if (!ht) {
+			bench_fail("ht_upo_new0");
+		}
+		bench_timer_start(b);
+		for (ut64 k = 0; k < HT_KEYS; k++) {
+			ht_upo_insert(ht, k * 0x10, (void *)(size_t)k);
+		}
+		bench_timer_stop(b);
+		ht_upo_free(ht);
+	}
+	b->iterations = (b->iterations / HT_KEYS + 1) * HT_KEYS;
+	return true;
+}
+
+static bool bench_ht_upo_find(Bench *b) {
+	HtUPO *ht = ht_upo_new0();
+	if (!ht) {
+		bench_fail("ht_upo_new0");
+	}
+	for (ut64 k = 0; k < HT_KEYS; k++) {
+		ht_upo_insert(ht, k * 0x10, (void *)(size_t)k);
+	}
+	size_t found = 0;
+	bench_timer_start(b);
+	for (ut64 i = 0; i < b->iterations; i++) {
+		bool hit;
+		ht_upo_find(ht, (i % (2 * HT_KEYS)) * 0x10, &hit);
+		found += hit;
+	}
+	bench_timer_stop(b);
+	ht_upo_free(ht);
+	return found > 0;
+}
+
+static bool bench_ht_upo_delete(Bench *b) {
+	for (ut64 i = 0; i < b->iterations / HT_KEYS + 1; i++) {
+		HtUPO *ht = ht_upo_new0();
+		if (!ht) {
+			bench_fail("ht_upo_new0");
+		}
+		for (ut64 k = 0; k < HT_KEYS; k++) {
+			ht_upo_insert(ht, k * 0x10, (void *)(size_t)k);
+		}
+		bench_timer_start(b);
+		for (ut64 k = 0; k < HT_KEYS; k++) {
+			ht_upo_delete(ht, k * 0x10);
+		}
+		bench_timer_stop(b);
+		ht_upo_free(ht);
+	}
+	b->iterations = (b->iterations / HT_KEYS + 1) * HT_KEYS;
+	return true;
+}
+
+static bool bench_ht_pp_find(Bench *b) {
+	HtPP *ht = ht_pp_new0();
+	char **keys = RZ_NEWS(char *, HT_KEYS / 16);
+	if (!ht || !keys) {
+		free(keys);
+		ht_pp_free(ht);
+		bench_fail("ht_pp_new0");
+	}
+	for (ut64 k = 0; k < HT_KEYS / 16; k++) {
+		keys[k] = rz_str_newf("sym.imp.function_%" PFMT64u, k);
+		ht_pp_insert(ht, keys[k], keys[k]);
+	}
+	size_t found = 0;
+	bench_timer_start(b);
+	for (ut64 i = 0; i < b->iterations; i++) {
+		found += ht_pp_find(ht, keys[i % (HT_KEYS / 16)], NULL) != NULL;
+	}
+	bench_timer_stop(b);
+	for (ut64 k = 0; k < HT_KEYS / 16; k++) {
+		free(keys[k]);
+	}
+	free(keys);
+	ht_pp_free(ht);
+	return found == b->iterations;
+}
+
+#define STR_BUF_SIZE 0x400000
+
+static void detected_string_free(void *s) {
+	rz_detected_string_free(s);
+}
+
+static bool bench_scan_strings_raw(Bench *b) {
+	ut8 *buf = malloc(STR_BUF_SIZE);
+	if (!buf) {
+		bench_fail("malloc");
+	}
+	// binary noise with a few ascii and utf-16 strings every page
+	ut32 seed = 0x1234;
+	for (size_t i = 0; i < STR_BUF_SIZE; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 24;
+	}
+	for (size_t i = 0; i + 0x100 < STR_BUF_SIZE; i += 0x1000) {
+		memcpy(buf + i, "Usage: %s [-options] file\n", 27);
+		memcpy(buf + i + 0x80, "C\0o\0n\0f\0i\0g\0u\0r\0e\0\0", 20);
+	}
+	RzUtilStrScanOptions opt = {
+		.buf_size = 2048,
+		.max_uni_blocks = 4,
+		.min_str_length = 5,
+		.prefer_big_endian = false,
+		.check_ascii_freq = true,
+	};
+	b->bytes = STR_BUF_SIZE;
+	bool ok = true;
+	for (ut64 i = 0; i < b->iterations && ok; i++) {
+		RzList *list = rz_list_newf(detected_string_free);
+		bench_timer_start(b);
+		ok = list && rz_scan_strings_raw(buf, list, &opt, 0, STR_BUF_SIZE, RZ_STRING_ENC_GUESS) > 0;
+		bench_timer_stop(b);
+		rz_list_free(list);
+	}
+	free(buf);
+	return ok;
+}
+
+static int all_benches(void) {
+	bench_run(bench_ht_up_insert, 0x400000);
+	bench_run(bench_ht_up_find, 0x1000000);
+	bench_run(bench_ht_up_delete, 0x400000);
+	bench_run(bench_ht_upo_insert, 0x400000);
+	bench_run(bench_ht_upo_find, 0x1000000);
+	bench_run(bench_ht_upo_delete, 0x400000);
+	bench_run(bench_ht_pp_find, 0x400000);
+	bench_run(bench_scan_strings_raw, 8);
+	return bench_failed;
+}
+
+bench_main(all_benches)
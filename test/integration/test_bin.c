@@ -111,21 +111,22 @@ bool test_rz_bin_reloc_storage(void) {
 	RzBinReloc *r3 = add_reloc(l, 0x1003, 0x1006, 0x200c);
 	mu_assert_notnull(r3, "reloc");
 	RzBinRelocStorage *relocs = rz_bin_reloc_storage_new(l);
+	// the storage keeps its own copies of the relocs, r0 to r3 are gone now
 
 	RzBinReloc *r = rz_bin_reloc_storage_get_reloc_in(relocs, 0xfff, 1);
 	mu_assert_null(r, "reloc in");
 	r = rz_bin_reloc_storage_get_reloc_in(relocs, 0xfff, 2);
-	mu_assert_ptreq(r, r0, "reloc in");
+	mu_assert_eq(r ? r->vaddr : UT64_MAX, 0x1000, "reloc in");
 	r = rz_bin_reloc_storage_get_reloc_in(relocs, 0x1000, 1);
-	mu_assert_ptreq(r, r0, "reloc in");
+	mu_assert_eq(r ? r->vaddr : UT64_MAX, 0x1000, "reloc in");
 	r = rz_bin_reloc_storage_get_reloc_in(relocs, 0x1002, 1);
 	mu_assert_null(r, "reloc in");
 	r = rz_bin_reloc_storage_get_reloc_in(relocs, 0x1002, 10);
-	mu_assert_ptreq(r, r1, "reloc in");
+	mu_assert_eq(r ? r->vaddr : UT64_MAX, 0x1003, "reloc in");
 	r = rz_bin_reloc_storage_get_reloc_in(relocs, 0x1003, 10);
-	mu_assert_ptreq(r, r1, "reloc in");
+	mu_assert_eq(r ? r->vaddr : UT64_MAX, 0x1003, "reloc in");
 	r = rz_bin_reloc_storage_get_reloc_in(relocs, 0x1006, 8);
-	mu_assert_ptreq(r, r3, "reloc in");
+	mu_assert_eq(r ? r->vaddr : UT64_MAX, 0x1006, "reloc in");
 	r = rz_bin_reloc_storage_get_reloc_in(relocs, 0x1007, 8);
 	mu_assert_null(r, "reloc in");
 	r = rz_bin_reloc_storage_get_reloc_in(relocs, 0x2004, 8);
@@ -140,17 +141,17 @@ bool test_rz_bin_reloc_storage(void) {
 	r = rz_bin_reloc_storage_get_reloc_to(relocs, 0x2003);
 	mu_assert_null(r, "reloc to");
 	r = rz_bin_reloc_storage_get_reloc_to(relocs, 0x2004);
-	mu_assert_ptreq(r, r0, "reloc to");
+	mu_assert_eq(r ? r->vaddr : UT64_MAX, 0x1000, "reloc to");
 	r = rz_bin_reloc_storage_get_reloc_to(relocs, 0x2005);
 	mu_assert_null(r, "reloc to");
 	r = rz_bin_reloc_storage_get_reloc_to(relocs, 0x2007);
 	mu_assert_null(r, "reloc to");
 	r = rz_bin_reloc_storage_get_reloc_to(relocs, 0x2008);
-	mu_assert_ptreq(r, r1, "reloc to");
+	mu_assert_eq(r ? r->vaddr : UT64_MAX, 0x1003, "reloc to");
 	r = rz_bin_reloc_storage_get_reloc_to(relocs, 0x2009);
 	mu_assert_null(r, "reloc to");
 	r = rz_bin_reloc_storage_get_reloc_to(relocs, 0x200c);
-	mu_assert_ptreq(r, r3, "reloc to");
+	mu_assert_eq(r ? r->vaddr : UT64_MAX, 0x1006, "reloc to");
 	r = rz_bin_reloc_storage_get_reloc_to(relocs, 0x200d);
 	mu_assert_null(r, "reloc to");
 
@@ -158,6 +159,43 @@ bool test_rz_bin_reloc_storage(void) {
 	mu_end;
 }
 
+bool test_rz_bin_reloc_storage_pages(void) {
+	// relocs spread over many pages with big holes, to exercise the page index
+	RzList *l = rz_list_new();
+	ut64 vaddrs[0x400];
+	ut64 vaddr = 0x10000;
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(vaddrs); i++) {
+		vaddr += (i % 7 == 0) ? 0x123456 : (i % 3) * 8 + 4;
+		vaddrs[i] = vaddr;
+		add_reloc(l, i, vaddr, i % 5 ? vaddr + 0x1000 : UT64_MAX);
+	}
+	RzBinRelocStorage *relocs = rz_bin_reloc_storage_new(l);
+	mu_assert_eq(relocs->relocs_count, RZ_ARRAY_SIZE(vaddrs), "relocs count");
+	mu_assert_true(relocs->vaddr_pages.count <= relocs->relocs_count, "pages count");
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(vaddrs); i++) {
+		RzBinReloc *r = rz_bin_reloc_storage_get_reloc_in(relocs, vaddrs[i], 1);
+		mu_assert_notnull(r, "reloc in");
+		mu_assert_eq(r->vaddr, vaddrs[i], "reloc in");
+		r = rz_bin_reloc_storage_get_reloc_in(relocs, vaddrs[i] - 3, 4);
+		mu_assert_notnull(r, "reloc in");
+		mu_assert_eq(r->vaddr, vaddrs[i], "reloc in");
+		r = rz_bin_reloc_storage_get_reloc_in(relocs, vaddrs[i] + 1, 3);
+		mu_assert_null(r, "reloc in");
+		r = rz_bin_reloc_storage_get_reloc_to(relocs, vaddrs[i] + 0x1000);
+		if (i % 5) {
+			mu_assert_notnull(r, "reloc to");
+			mu_assert_eq(r->vaddr, vaddrs[i], "reloc to");
+		} else {
+			mu_assert_true(!r || r->vaddr != vaddrs[i], "reloc to");
+		}
+	}
+	mu_assert_null(rz_bin_reloc_storage_get_reloc_in(relocs, 0, 0x10000), "reloc in");
+	mu_assert_null(rz_bin_reloc_storage_get_reloc_in(relocs, vaddr + 1, 0x10000), "reloc in");
+	mu_assert_null(rz_bin_reloc_storage_get_reloc_to(relocs, UT64_MAX), "reloc to");
+	rz_bin_reloc_storage_free(relocs);
+	mu_end;
+}
+
 typedef struct {
 	RzList /*<RzBinFile>*/ *expect; /// things whose delete events are expected now
 	bool failed_unexpected;
@@ -335,9 +373,98 @@ bool test_rz_bin_p2v2p(void) {
 	mu_end;
 }
 
+bool test_rz_bin_lazy(void) {
+	RzBin *bin = rz_bin_new();
+	RzIO *io = rz_io_new();
+	rz_io_bind(io, &bin->iob);
+	bin->lazy = true;
+
+	RzBinOptions opt = { 0 };
+	rz_bin_options_init(&opt, 0, 0, 0, false);
+	RzBinFile *bf = rz_bin_open(bin, "bins/elf/ioli/crackme0x00", &opt);
+	mu_assert_notnull(bf, "crackme0x00 binary could not be opened");
+	RzBinObject *obj = rz_bin_cur_object(bin);
+	mu_assert_null(obj->imports, "imports not loaded yet");
+	mu_assert_null(obj->symbols, "symbols not loaded yet");
+	mu_assert_null(obj->relocs, "relocs not loaded yet");
+	mu_assert_notnull(rz_bin_object_get_info(obj), "info is loaded eagerly");
+
+	const RzList *imports = rz_bin_object_get_imports(obj);
+	mu_assert_eq(rz_list_length(imports), 5, "rz_bin_object_get_imports");
+	mu_assert_null(obj->symbols, "symbols still not loaded");
+	const RzList *symbols = rz_bin_object_get_symbols(obj);
+	mu_assert_notnull(symbols, "rz_bin_object_get_symbols");
+	mu_assert_ptreq(rz_bin_object_get_symbols(obj), symbols, "symbols are loaded only once");
+	RzBinImport *import = rz_list_first(imports);
+	mu_assert_notnull(rz_bin_object_get_symbol_of_import(obj, import), "symbol of import");
+	mu_assert_notnull(rz_bin_object_get_relocs(obj), "rz_bin_object_get_relocs");
+	mu_assert_eq(rz_bin_object_get_language(obj), RZ_BIN_LANGUAGE_C, "rz_bin_object_get_language");
+
+	rz_bin_free(bin);
+	rz_io_free(io);
+	mu_end;
+}
+
+static size_t open_and_count_symbols(const char *cache_dir, size_t *imports, size_t *relocs) {
+	RzBin *bin = rz_bin_new();
+	RzIO *io = rz_io_new();
+	rz_io_bind(io, &bin->iob);
+	bin->cache_dir = strdup(cache_dir);
+
+	RzBinOptions opt = { 0 };
+	rz_bin_options_init(&opt, 0, 0, 0, false);
+	size_t symbols = 0;
+	RzBinFile *bf = rz_bin_open(bin, "bins/elf/ioli/crackme0x00", &opt);
+	if (bf) {
+		RzBinObject *obj = rz_bin_cur_object(bin);
+		symbols = rz_list_length(rz_bin_object_get_symbols(obj));
+		*imports = rz_list_length(rz_bin_object_get_imports(obj));
+		RzBinRelocStorage *storage = rz_bin_object_get_relocs(obj);
+		*relocs = storage ? storage->relocs_count : 0;
+	}
+	rz_bin_free(bin);
+	rz_io_free(io);
+	return symbols;
+}
+
+bool test_rz_bin_cache(void) {
+	char *tmpdir = rz_file_tmpdir();
+	char *cache_dir = rz_file_path_join(tmpdir, "rz_bin_cache_test");
+	free(tmpdir);
+
+	size_t imports, relocs;
+	size_t symbols = open_and_count_symbols(cache_dir, &imports, &relocs);
+	mu_assert_neq(symbols, 0, "symbols parsed");
+	RzList *entries = rz_sys_dir(cache_dir);
+	RzListIter *it;
+	char *entry, *cache_file = NULL;
+	rz_list_foreach (entries, it, entry) {
+		if (*entry != '.') {
+			cache_file = rz_file_path_join(cache_dir, entry);
+		}
+	}
+	rz_list_free(entries);
+	mu_assert_notnull(cache_file, "cache entry written");
+
+	size_t cached_imports, cached_relocs;
+	size_t cached_symbols = open_and_count_symbols(cache_dir, &cached_imports, &cached_relocs);
+	mu_assert_eq(cached_symbols, symbols, "symbols from the cache");
+	mu_assert_eq(cached_imports, imports, "imports from the cache");
+	mu_assert_eq(cached_relocs, relocs, "relocs from the cache");
+
+	rz_file_rm(cache_file);
+	rz_file_rm(cache_dir);
+	free(cache_file);
+	free(cache_dir);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_rz_bin);
+	mu_run_test(test_rz_bin_lazy);
+	mu_run_test(test_rz_bin_cache);
 	mu_run_test(test_rz_bin_reloc_storage);
+	mu_run_test(test_rz_bin_reloc_storage_pages);
 	mu_run_test(test_rz_bin_file_delete);
 	mu_run_test(test_rz_bin_file_delete_all);
 	mu_run_test(test_rz_bin_sections_mapping);
@@ -29,7 +29,7 @@ bool test_bin_vfiles() {
 	mu_assert_notnull(bf->o->relocs, "relocs");
 	RzBinReloc *reloc = NULL;
 	for (size_t i = 0; i < bf->o->relocs->relocs_count; i++) {
-		RzBinReloc *r = bf->o->relocs->relocs[i];
+		RzBinReloc *r = &bf->o->relocs->relocs[i];
 		if (!r->import) {
 			continue;
 		}
@@ -424,10 +424,78 @@ bool test_dwarf2_big_endian(void) {
 	mu_end;
 }
 
+bool test_dwarf_parse_info_parallel_lazy(void) {
+	RzBin *bin = rz_bin_new();
+	RzIO *io = rz_io_new();
+	rz_io_bind(io, &bin->iob);
+
+	RzBinOptions opt = { 0 };
+	rz_bin_options_init(&opt, 0, 0, 0, false);
+	RzBinFile *bf = rz_bin_open(bin, "bins/elf/dwarf4_many_comp_units.elf", &opt);
+	mu_assert_notnull(bf, "couldn't open file");
+
+	RzBinDwarfDebugAbbrev *da = rz_bin_dwarf_parse_abbrev(bin->cur);
+	RzBinDwarfDebugInfo *info = rz_bin_dwarf_parse_info(bin->cur, da);
+	mu_assert_notnull(info, "Failed parsing of debug_info");
+	RzThreadTaskPool *pool = rz_th_task_pool_new(2);
+	mu_assert_notnull(pool, "task pool");
+	RzBinDwarfDebugInfo *pinfo = rz_bin_dwarf_parse_info_parallel(bin->cur, da, pool);
+	mu_assert_notnull(pinfo, "Failed parallel parsing of debug_info");
+	RzBinDwarfDebugInfo *linfo = rz_bin_dwarf_parse_info_lazy(bin->cur, da);
+	mu_assert_notnull(linfo, "Failed lazy parsing of debug_info");
+
+	mu_assert_eq(pinfo->count, info->count, "parallel unit count");
+	mu_assert_eq(pinfo->n_dwarf_dies, info->n_dwarf_dies, "parallel die count");
+	mu_assert_eq(linfo->count, info->count, "lazy unit count");
+	mu_assert_eq(linfo->n_dwarf_dies, 0, "lazy units not decoded yet");
+	mu_assert_eq(linfo->comp_units[1].count, 0, "lazy unit not decoded yet");
+	mu_assert_eq(linfo->line_info_offset_comp_dir->count, info->line_info_offset_comp_dir->count, "lazy comp dirs");
+
+	// a DIE of the second unit decodes it
+	RzBinDwarfDie *die = &info->comp_units[1].dies[3];
+	RzBinDwarfDie *ldie = rz_bin_dwarf_debug_info_get_die(linfo, die->offset);
+	mu_assert_notnull(ldie, "lazy die");
+	mu_assert_eq(ldie->tag, die->tag, "lazy die tag");
+	mu_assert_eq(linfo->comp_units[1].count, info->comp_units[1].count, "lazy unit decoded");
+	mu_assert_eq(linfo->comp_units[0].count, 0, "other lazy unit not decoded");
+
+	for (size_t i = 0; i < info->count; i++) {
+		RzBinDwarfCompUnit *unit = &info->comp_units[i];
+		RzBinDwarfCompUnit *punit = &pinfo->comp_units[i];
+		RzBinDwarfCompUnit *lunit = rz_bin_dwarf_debug_info_get_unit(linfo, i);
+		mu_assert_notnull(lunit, "lazy unit");
+		mu_assert_eq(punit->offset, unit->offset, "parallel unit offset");
+		mu_assert_eq(punit->count, unit->count, "parallel unit dies");
+		mu_assert_eq(lunit->count, unit->count, "lazy unit dies");
+		for (size_t j = 0; j < unit->count; j++) {
+			mu_assert_eq(punit->dies[j].offset, unit->dies[j].offset, "parallel die offset");
+			mu_assert_eq(punit->dies[j].count, unit->dies[j].count, "parallel die attributes");
+			mu_assert_eq(lunit->dies[j].offset, unit->dies[j].offset, "lazy die offset");
+			mu_assert_eq(lunit->dies[j].tag, unit->dies[j].tag, "lazy die tag");
+		}
+	}
+	mu_assert_eq(linfo->n_dwarf_dies, info->n_dwarf_dies, "lazy die count");
+
+	rz_bin_dwarf_debug_info_unload_unit(linfo, 0);
+	mu_assert_eq(linfo->comp_units[0].count, 0, "unloaded unit");
+	mu_assert_null(ht_up_find(linfo->lookup_table, info->comp_units[0].dies[1].offset, NULL), "unloaded die");
+	mu_assert_notnull(rz_bin_dwarf_debug_info_get_die(linfo, info->comp_units[0].dies[1].offset), "reloaded die");
+
+	rz_bin_dwarf_debug_info_free(linfo);
+	rz_bin_dwarf_debug_info_free(pinfo);
+	rz_th_task_pool_free(pool);
+	rz_bin_dwarf_debug_info_free(info);
+	rz_bin_dwarf_debug_abbrev_free(da);
+	rz_bin_free(bin);
+	rz_io_free(io);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_dwarf3_c);
 	mu_run_test(test_dwarf4_cpp_multiple_modules);
 	mu_run_test(test_dwarf2_big_endian);
+	mu_run_test(test_dwarf_parse_info_parallel_lazy);
 	return tests_passed != tests_run;
 }
 
@@ -35,11 +35,13 @@ bool test_pdb_tpi_cpp(void) {
 	mu_assert_notnull(stream, "TPIs stream not found in current PDB");
 	mu_assert_eq(stream->header.HeaderSize + stream->header.TypeRecordBytes, 117156, "Wrong TPI size");
 	mu_assert_eq(stream->header.TypeIndexBegin, 0x1000, "Wrong beginning index");
-	RBIter it;
-	RzPdbTpiType *type;
-
-	rz_rbtree_foreach (stream->types, it, type, RzPdbTpiType, rb) {
-		mu_assert_notnull(type, "RzPdbTpiType is null in RBTree.");
+	// records are only decoded when asked for
+	mu_assert_null(stream->types, "decoded types before use");
+	mu_assert_eq(rz_bin_pdb_get_type_leaf(stream, 0x1028), LF_PROCEDURE, "Incorrect leaf type before decoding");
+	mu_assert_null(stream->types, "decoded types while reading the leaf type");
+	for (ut32 index = stream->header.TypeIndexBegin; index < stream->header.TypeIndexEnd; index++) {
+		RzPdbTpiType *type = rz_bin_pdb_get_type_by_index(stream, index);
+		mu_assert_notnull(type, "RzPdbTpiType is null.");
 		if (type->type_index == 0x1028) {
 			mu_assert_eq(type->leaf_type, LF_PROCEDURE, "Incorrect data type");
 			RzPdbTpiType *arglist;
@@ -213,10 +215,9 @@ bool test_pdb_tpi_rust(void) {
 	mu_assert_notnull(stream, "TPIs stream not found in current PDB");
 	mu_assert_eq(stream->header.HeaderSize + stream->header.TypeRecordBytes, 305632, "Wrong TPI size");
 	mu_assert_eq(stream->header.TypeIndexBegin, 0x1000, "Wrong beginning index");
-	RBIter it;
-	RzPdbTpiType *type;
-
-	rz_rbtree_foreach (stream->types, it, type, RzPdbTpiType, rb) {
+	for (ut32 index = stream->header.TypeIndexBegin; index < stream->header.TypeIndexEnd; index++) {
+		RzPdbTpiType *type = rz_bin_pdb_get_type_by_index(stream, index);
+		mu_assert_notnull(type, "RzPdbTpiType is null.");
 		if (type->type_index == 0x101B) {
 			mu_assert_eq(type->leaf_type, LF_PROCEDURE, "Incorrect data type");
 			RzPdbTpiType *arglist;
@@ -456,10 +457,9 @@ bool test_pdb_tpi_cpp_vs2019(void) {
 	mu_assert_notnull(stream, "TPIs stream not found in current PDB");
 	mu_assert_eq(stream->header.HeaderSize + stream->header.TypeRecordBytes, 233588, "Wrong TPI size");
 	mu_assert_eq(stream->header.TypeIndexBegin, 0x1000, "Wrong beginning index");
-	RBIter it;
-	RzPdbTpiType *type;
-
-	rz_rbtree_foreach (stream->types, it, type, RzPdbTpiType, rb) {
+	for (ut32 index = stream->header.TypeIndexBegin; index < stream->header.TypeIndexEnd; index++) {
+		RzPdbTpiType *type = rz_bin_pdb_get_type_by_index(stream, index);
+		mu_assert_notnull(type, "RzPdbTpiType is null.");
 		if (type->type_index == 0x1A5F) {
 			mu_assert_eq(type->leaf_type, LF_PROCEDURE, "Incorrect data type");
 			RzPdbTpiType *arglist;
@@ -710,10 +710,9 @@ bool test_pdb_tpi_arm(void) {
 	mu_assert_notnull(stream, "TPIs stream not found in current PDB");
 	mu_assert_eq(stream->header.HeaderSize + stream->header.TypeRecordBytes, 454428, "Wrong TPI size");
 	mu_assert_eq(stream->header.TypeIndexBegin, 0x1000, "Wrong beginning index");
-	RBIter it;
-	RzPdbTpiType *type;
-
-	rz_rbtree_foreach (stream->types, it, type, RzPdbTpiType, rb) {
+	for (ut32 index = stream->header.TypeIndexBegin; index < stream->header.TypeIndexEnd; index++) {
+		RzPdbTpiType *type = rz_bin_pdb_get_type_by_index(stream, index);
+		mu_assert_notnull(type, "RzPdbTpiType is null.");
 		if (type->type_index == 0x1A56) {
 			mu_assert_eq(type->leaf_type, LF_PROCEDURE, "Incorrect data type");
 			RzPdbTpiType *arglist;
@@ -0,0 +1,45 @@
+#!/usr/bin/env python3
+# Speaks the framed rzpipe protocol (see RZPIPE_FRAMED_HELLO) by hand
+
+import os
+import struct
+
+fd_in = int(os.environ["RZ_PIPE_IN"])
+fd_out = int(os.environ["RZ_PIPE_OUT"])
+
+
+def recv_all(size):
+    data = b""
+    while len(data) < size:
+        chunk = os.read(fd_in, size - len(data))
+        if not chunk:
+            raise EOFError
+        data += chunk
+    return data
+
+
+def recv():
+    size, status = struct.unpack("<IB", recv_all(5))
+    return status, recv_all(size)
+
+
+def frame(kind, payload):
+    return struct.pack("<IB", len(payload), ord(kind)) + payload
+
+
+print("offered:", os.environ.get("RZ_PIPE_FRAMED"))
+os.write(fd_out, b"\x00rzpipe-framed-1\n")
+status, payload = recv()
+print("hello:", status, payload.decode())
+
+# pipelined, the responses come back in order
+cmds = [b"?e one", b"p8 4 @ 0x10", b"?e three"]
+os.write(fd_out, b"".join(frame("c", cmd) for cmd in cmds))
+for cmd in cmds:
+    status, payload = recv()
+    print(status, payload.decode().strip())
+
+# raw bytes, not hex
+os.write(fd_out, frame("r", struct.pack("<QI", 0x10, 4)))
+status, payload = recv()
+print(status, payload.hex())
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+// Client run by test_rzpipe through "#!pipe", it sets a flag in the host
+// for every check that passed.
+
+#include <rz_socket.h>
+#include <rz_util.h>
+
+#define BATCH_SIZE 1000
+#define READ_SIZE  5000
+#define SHM_SIZE   0x1000
+
+static bool check_batch(RzPipe *rzp) {
+	const char *cmds[BATCH_SIZE];
+	for (size_t i = 0; i < BATCH_SIZE; i++) {
+		cmds[i] = rz_str_newf("?vi %" PFMTSZu, i);
+	}
+	// more than RZPIPE_BATCH_WINDOW bytes of requests
+	RzPVector *res = rzpipe_cmd_batch(rzp, cmds, BATCH_SIZE);
+	bool ok = res && rz_pvector_len(res) == BATCH_SIZE;
+	for (size_t i = 0; i < BATCH_SIZE; i++) {
+		char *exp = rz_str_newf("%" PFMTSZu "\n", i);
+		ok = ok && !strcmp(rz_pvector_at(res, i), exp);
+		free(exp);
+		free((char *)cmds[i]);
+	}
+	rz_pvector_free(res);
+	return ok;
+}
+
+static bool same_as_p8(RzPipe *rzp, ut64 addr, const ut8 *buf, int len) {
+	ut8 *exp = malloc(len);
+	char *hex = rzpipe_cmdf(rzp, "p8 %d @ 0x%" PFMT64x, len, addr);
+	bool ok = buf && exp && hex &&
+		rz_hex_str2bin(rz_str_trim_tail(hex), exp) == len &&
+		!memcmp(buf, exp, len);
+	free(hex);
+	free(exp);
+	return ok;
+}
+
+static bool check_read_at(RzPipe *rzp) {
+	ut8 *buf = malloc(READ_SIZE);
+	bool ok = buf && rzpipe_read_at(rzp, 0x10, buf, READ_SIZE) == READ_SIZE &&
+		same_as_p8(rzp, 0x10, buf, READ_SIZE);
+	free(buf);
+	return ok;
+}
+
+static bool check_shm(RzPipe *rzp) {
+	if (!rzpipe_shm_open(rzp, SHM_SIZE)) {
+		return false;
+	}
+	bool ok = same_as_p8(rzp, 0x123, rzpipe_shm_read_at(rzp, 0x123, SHM_SIZE), SHM_SIZE);
+	// rzpipe_read_at() goes through the segment when it fits
+	ut8 buf[0x800];
+	ok = ok && rzpipe_read_at(rzp, 0x1234, buf, sizeof(buf)) == sizeof(buf) &&
+		same_as_p8(rzp, 0x1234, buf, sizeof(buf));
+	// too big for the segment
+	ok = ok && !rzpipe_shm_read_at(rzp, 0, SHM_SIZE + 1);
+	rzpipe_shm_close(rzp);
+	return ok && !rzp->shm;
+}
+
+int main(int argc, char **argv) {
+	RzPipe *rzp = rzpipe_open(NULL);
+	if (!rzp) {
+		return 1;
+	}
+	if (rzp->framed) {
+		free(rzpipe_cmd(rzp, "f framed"));
+	}
+	if (check_batch(rzp)) {
+		free(rzpipe_cmd(rzp, "f batch"));
+	}
+	if (check_read_at(rzp)) {
+		free(rzpipe_cmd(rzp, "f read_at"));
+	}
+	if (check_shm(rzp)) {
+		free(rzpipe_cmd(rzp, "f shm"));
+	}
+	rzpipe_close(rzp);
+	return 0;
+}
@@ -569,6 +569,73 @@ bool test_rz_analysis_block_successors() {
 	mu_end;
 }
 
+typedef struct {
+	size_t outer;
+	size_t inner;
+} RecurseCount;
+
+static bool count_inner_cb(RzAnalysisBlock *block, void *user) {
+	((RecurseCount *)user)->inner++;
+	return true;
+}
+
+static bool count_outer_cb(RzAnalysisBlock *block, void *user) {
+	RecurseCount *count = user;
+	count->outer++;
+	// traversals started from the callback must keep their own visited set
+	rz_analysis_block_recurse(block, count_inner_cb, count);
+	return true;
+}
+
+static bool count_cb(RzAnalysisBlock *block, void *user) {
+	(*(size_t *)user)++;
+	return true;
+}
+
+bool test_rz_analysis_block_recurse() {
+	RzAnalysis *analysis = rz_analysis_new();
+	RzAnalysisBlock *a = rz_analysis_create_block(analysis, 0x10, 0x10);
+	RzAnalysisBlock *b = rz_analysis_create_block(analysis, 0x20, 0x10);
+	RzAnalysisBlock *c = rz_analysis_create_block(analysis, 0x30, 0x10);
+	a->jump = 0x20;
+	a->fail = 0x30;
+	b->jump = 0x30;
+	c->jump = 0x10;
+
+	RecurseCount count = { 0 };
+	mu_assert_true(rz_analysis_block_recurse(a, count_outer_cb, &count), "recurse");
+	mu_assert_eq(count.outer, 3, "outer visits");
+	mu_assert_eq(count.inner, 9, "inner visits");
+
+	size_t n = 0;
+	rz_analysis_block_recurse_depth_first(a, count_cb, NULL, &n);
+	mu_assert_eq(n, 3, "depth first visits");
+
+	// the successors looked up before must not be used after the blocks change
+	rz_analysis_block_unref(b);
+	n = 0;
+	rz_analysis_block_recurse(a, count_cb, &n);
+	mu_assert_eq(n, 2, "visits after delete");
+	b = rz_analysis_create_block(analysis, 0x20, 0x8);
+	b->jump = 0x40;
+	RzAnalysisBlock *d = rz_analysis_create_block(analysis, 0x40, 0x10);
+	n = 0;
+	rz_analysis_block_recurse_followthrough(a, count_cb, &n);
+	mu_assert_eq(n, 4, "visits after create");
+	mu_assert_true(rz_analysis_block_relocate(d, 0x50, 0x10), "relocate");
+	n = 0;
+	rz_analysis_block_recurse(a, count_cb, &n);
+	mu_assert_eq(n, 3, "visits after relocate");
+
+	rz_analysis_block_unref(a);
+	rz_analysis_block_unref(b);
+	rz_analysis_block_unref(c);
+	rz_analysis_block_unref(d);
+	assert_block_leaks(analysis);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
 bool test_rz_analysis_block_automerge() {
 	size_t i;
 	for (i = 0; i < SAMPLES; i++) {
@@ -753,6 +820,7 @@ int all_tests() {
 	mu_run_test(test_rz_analysis_block_relocate);
 	mu_run_test(test_rz_analysis_block_query);
 	mu_run_test(test_rz_analysis_block_successors);
+	mu_run_test(test_rz_analysis_block_recurse);
 	mu_run_test(test_rz_analysis_block_automerge);
 	mu_run_test(test_rz_analysis_block_analyze_ops);
 	return tests_passed != tests_run;
@@ -168,6 +168,113 @@ bool test_rz_analysis_function_labels() {
 	mu_end;
 }
 
+bool test_rz_analysis_function_cfg() {
+	RzAnalysis *analysis = rz_analysis_new();
+	RzAnalysisFunction *f = rz_analysis_create_function(analysis, "loops", 0x100, 0, NULL);
+	ut64 addrs[] = { 0x100, 0x110, 0x120, 0x130, 0x140, 0x150 };
+	RzAnalysisBlock *b[6];
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(addrs); i++) {
+		b[i] = rz_analysis_create_block(analysis, addrs[i], 0x10);
+		rz_analysis_function_add_block(f, b[i]);
+	}
+	// 0x110 is the header of the outer loop, 0x120 of the inner one, 0x150 is unreachable
+	b[0]->jump = 0x110;
+	b[1]->jump = 0x120;
+	b[1]->fail = 0x140;
+	b[2]->jump = 0x130;
+	b[3]->jump = 0x120;
+	b[3]->fail = 0x110;
+	b[5]->jump = 0x140;
+	assert_invariants(analysis);
+
+	const RzAnalysisFunctionCFG *cfg = rz_analysis_function_get_cfg(f);
+	mu_assert_notnull(cfg, "cfg");
+	mu_assert_eq(cfg->graph->n_nodes, 6, "cfg blocks");
+	mu_assert_eq(cfg->graph->n_edges, 7, "cfg edges");
+	mu_assert_eq(cfg->entry, 0, "cfg entry");
+	mu_assert_ptreq(rz_analysis_function_get_cfg(f), cfg, "cfg cached");
+
+	mu_assert_null(rz_analysis_function_idom(f, 0x100), "idom entry");
+	mu_assert_ptreq(rz_analysis_function_idom(f, 0x110), b[0], "idom");
+	mu_assert_ptreq(rz_analysis_function_idom(f, 0x120), b[1], "idom");
+	mu_assert_ptreq(rz_analysis_function_idom(f, 0x130), b[2], "idom");
+	mu_assert_ptreq(rz_analysis_function_idom(f, 0x140), b[1], "idom");
+	mu_assert_null(rz_analysis_function_idom(f, 0x150), "idom unreachable");
+	mu_assert_true(rz_analysis_function_dominates(f, 0x110, 0x130), "dominates");
+	mu_assert_true(rz_analysis_function_dominates(f, 0x120, 0x120), "dominates itself");
+	mu_assert_false(rz_analysis_function_dominates(f, 0x120, 0x140), "doesn't dominate");
+	mu_assert_false(rz_analysis_function_dominates(f, 0x100, 0x150), "unreachable");
+
+	mu_assert_eq(cfg->n_loops, 2, "loops");
+	mu_assert_null(rz_analysis_function_loop_header(f, 0x100), "no loop");
+	mu_assert_ptreq(rz_analysis_function_loop_header(f, 0x110), b[1], "outer header");
+	mu_assert_ptreq(rz_analysis_function_loop_header(f, 0x130), b[2], "inner header");
+	mu_assert_eq(cfg->loop_parent[2], 1, "nested loop");
+	mu_assert_eq(rz_analysis_function_loop_depth(f, 0x110), 1, "depth");
+	mu_assert_eq(rz_analysis_function_loop_depth(f, 0x130), 2, "depth");
+	mu_assert_eq(rz_analysis_function_loop_depth(f, 0x140), 0, "depth");
+
+	ut32 scc = rz_analysis_function_scc(f, 0x110);
+	mu_assert_eq(rz_analysis_function_scc(f, 0x120), scc, "same scc");
+	mu_assert_eq(rz_analysis_function_scc(f, 0x130), scc, "same scc");
+	mu_assert_eq(cfg->n_sccs, 4, "sccs");
+	mu_assert_true(rz_analysis_function_scc(f, 0x100) > scc, "scc order");
+	mu_assert_true(rz_analysis_function_scc(f, 0x140) < scc, "scc order");
+	mu_assert_eq(rz_analysis_function_scc(f, 0x160), UT32_MAX, "no block");
+
+	// successors are often assigned directly
+	b[3]->fail = UT64_MAX;
+	cfg = rz_analysis_function_get_cfg(f);
+	mu_assert_eq(cfg->n_loops, 1, "loops after change");
+	mu_assert_null(rz_analysis_function_loop_header(f, 0x110), "no outer loop");
+
+	rz_analysis_function_remove_block(f, b[2]);
+	mu_assert_null(f->cfg, "invalidated");
+	mu_assert_null(rz_analysis_function_idom(f, 0x130), "idom unreachable");
+
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(addrs); i++) {
+		rz_analysis_block_unref(b[i]);
+	}
+	assert_leaks(analysis);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+bool test_rz_analysis_task_items_new(void) {
+	RzAnalysis *analysis = rz_analysis_new();
+	RzAnalysisFunction *f = rz_analysis_create_function(analysis, "switchy", 0x1000, RZ_ANALYSIS_FCN_TYPE_NULL, NULL);
+	mu_assert_notnull(f, "create function");
+	RzVector tasks;
+	rz_vector_init(&tasks, sizeof(RzAnalysisTaskItem), NULL, NULL);
+	mu_assert_true(rz_analysis_task_item_new(analysis, &tasks, f, NULL, 0x1010), "single task");
+
+	// enough cases to use the lookup table, with duplicates as in real switches
+	ut64 cases[64];
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(cases); i++) {
+		cases[i] = 0x1000 + (i % 40) * 0x10;
+	}
+	mu_assert_true(rz_analysis_task_items_new(analysis, &tasks, f, NULL, cases, RZ_ARRAY_SIZE(cases)), "bulk tasks");
+	mu_assert_eq(rz_vector_len(&tasks), 40, "duplicates and already queued addresses are skipped");
+	RzAnalysisTaskItem *it = rz_vector_index_ptr(&tasks, 0);
+	mu_assert_eq(it->start_address, 0x1010, "queued task kept first");
+	for (size_t i = 1; i < 40; i++) {
+		it = rz_vector_index_ptr(&tasks, i);
+		ut64 expect = 0x1000 + (i == 1 ? 0 : i) * 0x10;
+		mu_assert_eq(it->start_address, expect, "tasks added in case order");
+		mu_assert_ptreq(it->fcn, f, "task function");
+	}
+
+	// few cases take the same path as rz_analysis_task_item_new()
+	ut64 few[] = { 0x2000, 0x1000, 0x2000 };
+	rz_vector_clear(&tasks);
+	mu_assert_true(rz_analysis_task_items_new(analysis, &tasks, f, NULL, few, RZ_ARRAY_SIZE(few)), "few tasks");
+	mu_assert_eq(rz_vector_len(&tasks), 2, "few tasks deduplicated");
+
+	rz_vector_fini(&tasks);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
 bool test_dll_names(void) {
 	RzTypeDB *typedb = rz_type_db_new();
 	mu_assert_notnull(typedb, "Couldn't create new RzTypeDB");
@@ -325,6 +432,8 @@ bool test_initial_underscore(void) {
 int all_tests() {
 	mu_run_test(test_rz_analysis_function_relocate);
 	mu_run_test(test_rz_analysis_function_labels);
+	mu_run_test(test_rz_analysis_function_cfg);
+	mu_run_test(test_rz_analysis_task_items_new);
 	mu_run_test(test_ignore_prefixes);
 	mu_run_test(test_remove_rz_prefixes);
 	mu_run_test(test_dll_names);
@@ -593,6 +593,43 @@ bool test_meta_spaces() {
 	mu_end;
 }
 
+bool test_meta_dirty() {
+	RzAnalysis *analysis = rz_analysis_new();
+	ut64 from, to;
+
+	ut64 gen = rz_analysis_generation(analysis);
+	mu_assert_true(rz_analysis_dirty_since(analysis, gen, &from, &to), "dirty known");
+	mu_assert_eq(from, UT64_MAX, "nothing changed");
+	mu_assert_eq(to, 0, "nothing changed");
+
+	rz_meta_set(analysis, RZ_META_TYPE_DATA, 0x100, 4, NULL);
+	rz_meta_set_string(analysis, RZ_META_TYPE_COMMENT, 0x200, "vanilla");
+	mu_assert_eq(analysis->gen.meta, 2, "meta generation");
+	mu_assert_eq(rz_analysis_generation(analysis), gen + 2, "total generation");
+	mu_assert_true(rz_analysis_dirty_since(analysis, gen, &from, &to), "dirty known");
+	mu_assert_eq(from, 0x100, "dirty from");
+	mu_assert_eq(to, 0x200, "dirty to");
+
+	gen = rz_analysis_generation(analysis);
+	rz_meta_del(analysis, RZ_META_TYPE_DATA, 0x102, 1);
+	mu_assert_true(rz_analysis_dirty_since(analysis, gen, &from, &to), "dirty known");
+	mu_assert_eq(from, 0x100, "whole deleted item");
+	mu_assert_eq(to, 0x103, "whole deleted item");
+
+	gen = rz_analysis_generation(analysis);
+	rz_meta_del(analysis, RZ_META_TYPE_DATA, 0x1000, 1);
+	mu_assert_eq(rz_analysis_generation(analysis), gen, "nothing deleted");
+
+	rz_analysis_hint_set_bits(analysis, 0x300, 16);
+	mu_assert_eq(analysis->gen.hints, 1, "hints generation");
+	mu_assert_true(rz_analysis_dirty_since(analysis, gen, &from, &to), "dirty known");
+	mu_assert_eq(from, 0x300, "ranged hint from");
+	mu_assert_eq(to, UT64_MAX, "ranged hint to the end");
+
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_meta_set);
 	mu_run_test(test_meta_get_at);
@@ -603,6 +640,7 @@ bool all_tests() {
 	mu_run_test(test_meta_del);
 	mu_run_test(test_meta_rebase);
 	mu_run_test(test_meta_spaces);
+	mu_run_test(test_meta_dirty);
 	return tests_passed != tests_run;
 }
 
@@ -97,6 +97,99 @@ bool test_rz_analysis_op_val() {
 	mu_end;
 }
 
+bool test_rz_analysis_op_cache() {
+	RzAnalysis *analysis = rz_analysis_new();
+	RzAnalysisOp op;
+	SWITCH_TO_ARCH_BITS("x86", 64);
+	rz_analysis_op_cache_enable(analysis, true);
+	ut8 buf[] = { 0x48, 0x8b, 0x44, 0x0b, 0x04 }; // mov rax, [rbx+rcx+4]
+	int len = rz_analysis_op(analysis, &op, 0x1000, buf, sizeof(buf), RZ_ANALYSIS_OP_MASK_VAL);
+	mu_assert_eq(len, 5, "Op is of size 5");
+	rz_analysis_op_fini(&op);
+	mu_assert_eq(analysis->op_cache.misses, 1, "first decoding is a miss");
+	mu_assert_eq(analysis->op_cache.hits, 0, "no hits yet");
+
+	len = rz_analysis_op(analysis, &op, 0x1000, buf, sizeof(buf), RZ_ANALYSIS_OP_MASK_VAL);
+	mu_assert_eq(len, 5, "cached op is of size 5");
+	mu_assert_eq(analysis->op_cache.hits, 1, "second decoding is a hit");
+	mu_assert_eq(op.addr, 0x1000, "cached op addr");
+	mu_assert_eq(op.dst->type, RZ_ANALYSIS_VAL_REG, "Destination should be reg");
+	mu_assert_streq(op.dst->reg->name, "rax", "Dst reg should be rax");
+	mu_assert_streq(op.src[0]->regdelta->name, "rcx", "Source reg delta should be rcx");
+	mu_assert_eq(op.src[0]->delta, 4, "Source delta should be 4");
+	rz_analysis_op_fini(&op);
+
+	// different mask or different bytes must not hit
+	len = rz_analysis_op(analysis, &op, 0x1000, buf, sizeof(buf), RZ_ANALYSIS_OP_MASK_BASIC);
+	rz_analysis_op_fini(&op);
+	mu_assert_eq(analysis->op_cache.hits, 1, "other mask is a miss");
+	buf[4] = 0x08;
+	len = rz_analysis_op(analysis, &op, 0x1000, buf, sizeof(buf), RZ_ANALYSIS_OP_MASK_VAL);
+	mu_assert_eq(analysis->op_cache.hits, 1, "patched bytes are a miss");
+	mu_assert_eq(op.src[0]->delta, 8, "Source delta should be 8");
+	rz_analysis_op_fini(&op);
+
+	// switching arch drops everything
+	SWITCH_TO_ARCH_BITS("arm", 64);
+	SWITCH_TO_ARCH_BITS("x86", 64);
+	len = rz_analysis_op(analysis, &op, 0x1000, buf, sizeof(buf), RZ_ANALYSIS_OP_MASK_VAL);
+	rz_analysis_op_fini(&op);
+	mu_assert_eq(analysis->op_cache.hits, 1, "cache is flushed on plugin change");
+
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+bool test_rz_analysis_op_cache_file() {
+	RzAnalysis *analysis = rz_analysis_new();
+	RzAnalysisOp op;
+	SWITCH_TO_ARCH_BITS("x86", 64);
+	rz_analysis_op_cache_enable(analysis, true);
+	ut8 buf[] = { 0x48, 0x8b, 0x44, 0x0b, 0x04, 0xe8, 0x10, 0x00, 0x00, 0x00 }; // mov rax, [rbx+rcx+4]; call 0x101a
+	rz_analysis_op(analysis, &op, 0x1000, buf, 5, RZ_ANALYSIS_OP_MASK_VAL | RZ_ANALYSIS_OP_MASK_ESIL);
+	char *esil = rz_strbuf_drain_nofree(&op.esil);
+	rz_analysis_op_fini(&op);
+	rz_analysis_op(analysis, &op, 0x1005, buf + 5, 5, RZ_ANALYSIS_OP_MASK_BASIC);
+	rz_analysis_op_fini(&op);
+	char *path = rz_file_temp("opcache");
+	mu_assert_true(rz_analysis_op_cache_save(analysis, path), "save");
+	rz_analysis_free(analysis);
+
+	// next session
+	analysis = rz_analysis_new();
+	SWITCH_TO_ARCH_BITS("x86", 64);
+	mu_assert_false(rz_analysis_op_cache_load(analysis, path), "nothing loaded while disabled");
+	rz_analysis_op_cache_enable(analysis, true);
+	mu_assert_true(rz_analysis_op_cache_load(analysis, path), "load");
+	int len = rz_analysis_op(analysis, &op, 0x1000, buf, 5, RZ_ANALYSIS_OP_MASK_VAL | RZ_ANALYSIS_OP_MASK_ESIL);
+	mu_assert_eq(analysis->op_cache.hits, 1, "loaded op is a hit");
+	mu_assert_eq(len, 5, "loaded op is of size 5");
+	mu_assert_eq(op.type, RZ_ANALYSIS_OP_TYPE_MOV, "loaded op type");
+	mu_assert_streq(op.dst->reg->name, "rax", "Dst reg should be rax");
+	mu_assert_ptreq(op.dst->reg, rz_reg_get(analysis->reg, "rax", -1), "registers are looked up again");
+	mu_assert_streq(op.src[0]->regdelta->name, "rcx", "Source reg delta should be rcx");
+	mu_assert_eq(op.src[0]->delta, 4, "Source delta should be 4");
+	mu_assert_streq(rz_strbuf_get(&op.esil), esil, "loaded esil");
+	rz_analysis_op_fini(&op);
+	len = rz_analysis_op(analysis, &op, 0x1005, buf + 5, 5, RZ_ANALYSIS_OP_MASK_BASIC);
+	mu_assert_eq(analysis->op_cache.hits, 2, "loaded op is a hit");
+	mu_assert_eq(op.type, RZ_ANALYSIS_OP_TYPE_CALL, "loaded op type");
+	mu_assert_eq(op.jump, 0x101a, "loaded op jump");
+	mu_assert_eq(op.fail, 0x100a, "loaded op fail");
+	rz_analysis_op_fini(&op);
+
+	// other arch, nothing is loaded
+	SWITCH_TO_ARCH_BITS("arm", 64);
+	mu_assert_false(rz_analysis_op_cache_load(analysis, path), "saved for another plugin");
+	mu_assert_null(analysis->op_cache.entries, "nothing loaded");
+
+	rz_file_rm(path);
+	free(path);
+	free(esil);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
 bool test_rz_core_analysis_bytes() {
 	RzCore *core = rz_core_new();
 	rz_core_set_asm_configs(core, "x86", 64, 0);
@@ -164,6 +257,8 @@ bool test_rz_core_print_disasm() {
 
 int all_tests() {
 	mu_run_test(test_rz_analysis_op_val);
+	mu_run_test(test_rz_analysis_op_cache);
+	mu_run_test(test_rz_analysis_op_cache_file);
 	mu_run_test(test_rz_core_analysis_bytes);
 	mu_run_test(test_rz_core_print_disasm);
 	return tests_passed != tests_run;
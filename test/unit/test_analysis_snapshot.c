@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+#include "minunit.h"
+
+static RzAnalysis *analysis_setup(void) {
+	RzAnalysis *analysis = rz_analysis_new();
+	RzAnalysisFunction *f = rz_analysis_create_function(analysis, "main", 0x1000, RZ_ANALYSIS_FCN_TYPE_FCN, NULL);
+	RzAnalysisFunction *g = rz_analysis_create_function(analysis, "sym.shared", 0x2000, RZ_ANALYSIS_FCN_TYPE_SYM, NULL);
+	RzAnalysisBlock *a = rz_analysis_create_block(analysis, 0x1000, 0x10);
+	RzAnalysisBlock *b = rz_analysis_create_block(analysis, 0x1010, 0x20);
+	RzAnalysisBlock *c = rz_analysis_create_block(analysis, 0x2000, 0x8);
+	rz_analysis_function_add_block(f, a);
+	rz_analysis_function_add_block(f, b);
+	rz_analysis_function_add_block(g, b);
+	rz_analysis_function_add_block(g, c);
+	rz_analysis_block_unref(a);
+	rz_analysis_block_unref(b);
+	rz_analysis_block_unref(c);
+	rz_analysis_xrefs_set(analysis, 0x1004, 0x2000, RZ_ANALYSIS_XREF_TYPE_CALL);
+	rz_analysis_xrefs_set(analysis, 0x1014, 0x2000, RZ_ANALYSIS_XREF_TYPE_CALL);
+	rz_analysis_xrefs_set(analysis, 0x1014, 0x3000, RZ_ANALYSIS_XREF_TYPE_DATA);
+	return analysis;
+}
+
+bool test_analysis_snapshot_tables(void) {
+	RzAnalysis *analysis = analysis_setup();
+	mu_assert_null(rz_analysis_snapshot_acquire(analysis), "nothing published yet");
+	mu_assert_true(rz_analysis_snapshot_publish(analysis), "publish");
+	RzAnalysisSnapshot *snap = rz_analysis_snapshot_acquire(analysis);
+	mu_assert_notnull(snap, "acquire");
+	mu_assert_eq(rz_analysis_snapshot_generation(snap), rz_analysis_generation(analysis), "generation");
+
+	size_t count;
+	const RzAnalysisSnapshotFunction *fcns = rz_analysis_snapshot_functions(snap, &count);
+	mu_assert_eq(count, 2, "functions");
+	mu_assert_eq(fcns[0].addr, 0x1000, "sorted functions");
+	mu_assert_streq(fcns[0].name, "main", "name");
+	mu_assert_eq(fcns[0].min_addr, 0x1000, "min addr");
+	mu_assert_eq(fcns[0].max_addr, 0x1030, "max addr");
+	mu_assert_eq(fcns[0].blocks_count, 2, "blocks of main");
+	mu_assert_eq(fcns[0].blocks[1], 0x1010, "sorted blocks");
+	mu_assert_eq(fcns[1].addr, 0x2000, "sorted functions");
+	mu_assert_eq(fcns[1].type, RZ_ANALYSIS_FCN_TYPE_SYM, "type");
+	mu_assert_ptreq(rz_analysis_snapshot_function_at(snap, 0x2000), &fcns[1], "function at");
+	mu_assert_null(rz_analysis_snapshot_function_at(snap, 0x1010), "no function at");
+
+	RzPVector *blocks = rz_analysis_snapshot_blocks_in(snap, 0x1018);
+	mu_assert_eq(rz_pvector_len(blocks), 1, "blocks in");
+	const RzAnalysisSnapshotBlock *block = rz_pvector_at(blocks, 0);
+	mu_assert_eq(block->addr, 0x1010, "block addr");
+	mu_assert_eq(block->size, 0x20, "block size");
+	mu_assert_eq(block->fcns_count, 2, "shared block");
+	mu_assert_eq(block->fcns[0], 0x1000, "sorted functions of the block");
+	mu_assert_eq(block->fcns[1], 0x2000, "sorted functions of the block");
+	rz_pvector_free(blocks);
+	blocks = rz_analysis_snapshot_blocks_in(snap, 0x1030);
+	mu_assert_eq(rz_pvector_len(blocks), 0, "no block in");
+	rz_pvector_free(blocks);
+
+	RzPVector *in = rz_analysis_snapshot_functions_in(snap, 0x1018);
+	mu_assert_eq(rz_pvector_len(in), 2, "functions in");
+	mu_assert_ptreq(rz_pvector_at(in, 0), &fcns[0], "functions in");
+	mu_assert_ptreq(rz_pvector_at(in, 1), &fcns[1], "functions in");
+	rz_pvector_free(in);
+
+	const RzAnalysisXRef *xrefs = rz_analysis_snapshot_xrefs_to(snap, 0x2000, &count);
+	mu_assert_eq(count, 2, "xrefs to");
+	mu_assert_eq(xrefs[0].from, 0x1004, "sorted by source");
+	mu_assert_eq(xrefs[1].from, 0x1014, "sorted by source");
+	xrefs = rz_analysis_snapshot_xrefs_from(snap, 0x1014, &count);
+	mu_assert_eq(count, 2, "xrefs from");
+	mu_assert_eq(xrefs[0].to, 0x2000, "sorted by destination");
+	mu_assert_eq(xrefs[1].to, 0x3000, "sorted by destination");
+	mu_assert_eq(xrefs[1].type, RZ_ANALYSIS_XREF_TYPE_DATA, "type");
+	mu_assert_null(rz_analysis_snapshot_xrefs_from(snap, 0x2000, &count), "no xrefs from");
+	mu_assert_eq(count, 0, "no xrefs from");
+
+	rz_analysis_snapshot_release(snap);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+bool test_analysis_snapshot_publish(void) {
+	RzAnalysis *analysis = analysis_setup();
+	rz_analysis_snapshot_publish(analysis);
+	RzAnalysisSnapshot *first = rz_analysis_snapshot_acquire(analysis);
+	mu_assert_true(rz_analysis_snapshot_publish(analysis), "publish unchanged");
+	RzAnalysisSnapshot *same = rz_analysis_snapshot_acquire(analysis);
+	mu_assert_ptreq(same, first, "nothing changed, nothing published");
+	rz_analysis_snapshot_release(same);
+
+	// only the xrefs change, the functions and blocks are shared
+	rz_analysis_xref_del(analysis, 0x1004, 0x2000);
+	rz_analysis_snapshot_publish(analysis);
+	RzAnalysisSnapshot *second = rz_analysis_snapshot_acquire(analysis);
+	mu_assert_ptrneq(second, first, "new snapshot");
+	size_t count, count2;
+	const RzAnalysisSnapshotFunction *fcns = rz_analysis_snapshot_functions(first, &count);
+	mu_assert_ptreq(rz_analysis_snapshot_functions(second, &count2), fcns, "functions shared");
+	rz_analysis_snapshot_xrefs_to(second, 0x2000, &count);
+	mu_assert_eq(count, 1, "deleted xref");
+	rz_analysis_snapshot_xrefs_to(first, 0x2000, &count);
+	mu_assert_eq(count, 2, "older snapshot unchanged");
+
+	// the functions change, the xrefs are shared
+	rz_analysis_function_rename(rz_analysis_get_function_at(analysis, 0x1000), "entry0");
+	rz_analysis_snapshot_publish(analysis);
+	RzAnalysisSnapshot *third = rz_analysis_snapshot_acquire(analysis);
+	mu_assert_streq(rz_analysis_snapshot_function_at(third, 0x1000)->name, "entry0", "renamed");
+	mu_assert_streq(rz_analysis_snapshot_function_at(second, 0x1000)->name, "main", "older snapshot unchanged");
+	const RzAnalysisXRef *xrefs = rz_analysis_snapshot_xrefs_to(second, 0x2000, &count);
+	mu_assert_ptreq(rz_analysis_snapshot_xrefs_to(third, 0x2000, &count2), xrefs, "xrefs shared");
+
+	// so do the bits and the type
+	RzAnalysisFunction *shared = rz_analysis_get_function_at(analysis, 0x2000);
+	rz_analysis_function_set_bits(shared, 16);
+	rz_analysis_function_set_fcntype(shared, RZ_ANALYSIS_FCN_TYPE_INT);
+	rz_analysis_snapshot_publish(analysis);
+	RzAnalysisSnapshot *fourth = rz_analysis_snapshot_acquire(analysis);
+	mu_assert_eq(rz_analysis_snapshot_function_at(fourth, 0x2000)->bits, 16, "bits");
+	mu_assert_eq(rz_analysis_snapshot_function_at(fourth, 0x2000)->type, RZ_ANALYSIS_FCN_TYPE_INT, "type");
+	mu_assert_eq(rz_analysis_snapshot_function_at(third, 0x2000)->type, RZ_ANALYSIS_FCN_TYPE_SYM, "older snapshot unchanged");
+	rz_analysis_snapshot_release(fourth);
+
+	// snapshots outlive the analysis
+	rz_analysis_free(analysis);
+	mu_assert_streq(rz_analysis_snapshot_function_at(first, 0x2000)->name, "sym.shared", "still readable");
+	rz_analysis_snapshot_release(first);
+	rz_analysis_snapshot_release(second);
+	rz_analysis_snapshot_release(third);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_analysis_snapshot_tables);
+	mu_run_test(test_analysis_snapshot_publish);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
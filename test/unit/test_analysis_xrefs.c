@@ -21,8 +21,98 @@ bool test_rz_analysis_xrefs_count() {
 	mu_end;
 }
 
+static bool collect_cb(void *user, const RzAnalysisXRef *xref) {
+	rz_vector_push(user, (void *)xref);
+	return true;
+}
+
+bool test_rz_analysis_xrefs_foreach() {
+	RzAnalysis *analysis = rz_analysis_new();
+	// enough xrefs to go through several merges of the write buffer
+	for (ut64 i = 0; i < 0x4000; i++) {
+		rz_analysis_xrefs_set(analysis, 0x1000 + i * 4, 0x100000 + (i % 0x10) * 0x100, RZ_ANALYSIS_XREF_TYPE_CALL);
+	}
+	mu_assert_eq(rz_analysis_xrefs_count(analysis), 0x4000, "xrefs count");
+	// update, delete and reinsert
+	rz_analysis_xrefs_set(analysis, 0x1000, 0x100000, RZ_ANALYSIS_XREF_TYPE_CODE);
+	rz_analysis_xref_del(analysis, 0x1004, 0x100100);
+	rz_analysis_xref_del(analysis, 0x1008, 0x100200);
+	rz_analysis_xrefs_set(analysis, 0x1008, 0x100200, RZ_ANALYSIS_XREF_TYPE_DATA);
+	mu_assert_eq(rz_analysis_xrefs_count(analysis), 0x3fff, "xrefs count after del");
+
+	RzVector v;
+	rz_vector_init(&v, sizeof(RzAnalysisXRef), NULL, NULL);
+	rz_analysis_xrefs_foreach_from(analysis, 0x1000, collect_cb, &v);
+	mu_assert_eq(rz_vector_len(&v), 1, "xrefs from 0x1000");
+	RzAnalysisXRef *xref = rz_vector_index_ptr(&v, 0);
+	mu_assert_eq(xref->to, 0x100000, "to");
+	mu_assert_eq(xref->type, RZ_ANALYSIS_XREF_TYPE_CODE, "updated type");
+	rz_vector_clear(&v);
+	rz_analysis_xrefs_foreach_from(analysis, 0x1004, collect_cb, &v);
+	mu_assert_eq(rz_vector_len(&v), 0, "deleted xref");
+	rz_vector_clear(&v);
+
+	rz_analysis_xrefs_foreach_to(analysis, 0x100200, collect_cb, &v);
+	mu_assert_eq(rz_vector_len(&v), 0x400, "xrefs to 0x100200");
+	ut64 prev = 0;
+	rz_vector_foreach(&v, xref) {
+		mu_assert_eq(xref->to, 0x100200, "to");
+		mu_assert_true(xref->from > prev, "sorted by from");
+		prev = xref->from;
+	}
+	xref = rz_vector_index_ptr(&v, 0);
+	mu_assert_eq(xref->type, RZ_ANALYSIS_XREF_TYPE_DATA, "reinserted type");
+	rz_vector_clear(&v);
+
+	rz_analysis_xrefs_foreach(analysis, collect_cb, &v);
+	mu_assert_eq(rz_vector_len(&v), 0x3fff, "all xrefs");
+	rz_vector_fini(&v);
+
+	RzList *list = rz_analysis_xrefs_get_to(analysis, 0x100100);
+	mu_assert_eq(rz_list_length(list), 0x3ff, "xrefs to 0x100100");
+	rz_list_free(list);
+
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+bool test_rz_analysis_xrefs_del_from_range() {
+	RzAnalysis *analysis = rz_analysis_new();
+	for (ut64 i = 0; i < 0x2000; i++) {
+		rz_analysis_xrefs_set(analysis, 0x1000 + i * 4, 0x100000 + (i % 0x10) * 0x100, RZ_ANALYSIS_XREF_TYPE_CALL);
+		rz_analysis_xrefs_set(analysis, 0x1000 + i * 4, 0x200000, RZ_ANALYSIS_XREF_TYPE_DATA);
+	}
+	// some pending changes on top of the merged array
+	rz_analysis_xref_del(analysis, 0x2000, 0x200000);
+	rz_analysis_xrefs_set(analysis, 0x2002, 0x200000, RZ_ANALYSIS_XREF_TYPE_DATA);
+	mu_assert_eq(rz_analysis_xrefs_count(analysis), 0x4000, "xrefs count");
+
+	mu_assert_eq(rz_analysis_xrefs_del_from_range(analysis, 0x2000, 0x2010), 8, "deleted xrefs");
+	mu_assert_eq(rz_analysis_xrefs_count(analysis), 0x4000 - 8, "xrefs count after del");
+	RzList *list = rz_analysis_xrefs_get_from(analysis, 0x2002);
+	mu_assert_null(list, "xrefs from 0x2002");
+	list = rz_analysis_xrefs_get_from(analysis, 0x1ffc);
+	mu_assert_eq(rz_list_length(list), 2, "xrefs from 0x1ffc");
+	rz_list_free(list);
+	list = rz_analysis_xrefs_get_from(analysis, 0x2010);
+	mu_assert_eq(rz_list_length(list), 2, "xrefs from 0x2010");
+	rz_list_free(list);
+	list = rz_analysis_xrefs_get_to(analysis, 0x200000);
+	mu_assert_eq(rz_list_length(list), 0x2000 - 4, "xrefs to 0x200000");
+	rz_list_free(list);
+
+	mu_assert_eq(rz_analysis_xrefs_del_from_range(analysis, 0x2010, 0x2010), 0, "empty range");
+	mu_assert_eq(rz_analysis_xrefs_del_from_range(analysis, 0, UT64_MAX), 0x4000 - 8, "delete all");
+	mu_assert_eq(rz_analysis_xrefs_count(analysis), 0, "no xrefs left");
+
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_analysis_xrefs_count);
+	mu_run_test(test_rz_analysis_xrefs_foreach);
+	mu_run_test(test_rz_analysis_xrefs_del_from_range);
 	return tests_passed != tests_run;
 }
 
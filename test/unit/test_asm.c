@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_asm.h>
+#include "minunit.h"
+
+static bool batch_matches_single(RzAsm *a, const ut8 *buf, int len, int max, int expected) {
+	RzAsmInsn insns[16];
+	RzStrBuf text;
+	rz_strbuf_init(&text);
+	rz_asm_set_pc(a, 0x1000);
+	int count = rz_asm_disassemble_batch(a, buf, len, insns, max, &text);
+	mu_assert_eq(a->pc, 0x1000, "pc is left unchanged");
+	int idx = 0;
+	for (int i = 0; i < count; i++) {
+		RzAsmOp op;
+		rz_asm_set_pc(a, 0x1000 + idx);
+		int ret = rz_asm_disassemble(a, &op, buf + idx, len - idx);
+		mu_assert_eq(insns[i].addr, 0x1000 + idx, "address");
+		mu_assert_eq(insns[i].invalid, ret < 1, "invalid");
+		mu_assert_eq(insns[i].size, ret < 1 ? 1 : ret, "size");
+		mu_assert_streq(rz_strbuf_get(&text) + insns[i].asm_off, rz_asm_op_get_asm(&op), "text");
+		rz_asm_op_fini(&op);
+		idx += insns[i].size;
+	}
+	rz_strbuf_fini(&text);
+	mu_assert_eq(count, expected, "batch size");
+	return true;
+}
+
+bool test_rz_asm_disassemble_batch(void) {
+	RzAsm *a = rz_asm_new();
+	rz_asm_use(a, "x86");
+	rz_asm_set_bits(a, 64);
+	// push rbp; mov rbp, rsp; mov dword [rbp - 4], edi; ud2; invalid; invalid; je 0x1000; ret
+	const ut8 buf[] = "\x55\x48\x89\xe5\x89\x7d\xfc\x0f\x0b\x06\x07\x74\xf3\xc3";
+	const int len = sizeof(buf) - 1;
+	mu_assert_true(batch_matches_single(a, buf, len, 16, 8), "whole buffer");
+	mu_assert_true(batch_matches_single(a, buf, len, 3, 3), "stops at the limit");
+	mu_assert_true(batch_matches_single(a, buf, 6, 16, 4), "truncated instruction");
+
+	RzAsmInsn insns[16];
+	rz_asm_set_pc(a, 0);
+	int count = rz_asm_disassemble_batch(a, buf, len, insns, RZ_ARRAY_SIZE(insns), NULL);
+	mu_assert_eq(count, 8, "instructions without text");
+	mu_assert_eq(insns[0].asm_off, -1, "no text");
+	mu_assert_eq(insns[2].size, 3, "size without text");
+
+	rz_asm_set_syntax(a, RZ_ASM_SYNTAX_JZ);
+	mu_assert_true(batch_matches_single(a, buf, len, 16, 8), "jz syntax");
+	rz_asm_free(a);
+	mu_end;
+}
+
+bool test_rz_asm_code_equ_replace(void) {
+	RzAsmCode *code = rz_asm_code_new();
+	rz_asm_code_set_equ(code, "FOO", "0x10");
+	rz_asm_code_set_equ(code, "BAR", "FOO0");
+	rz_asm_code_set_equ(code, "A", "BAR1");
+	char *str = rz_asm_code_equ_replace(code, strdup("mov rax, BAR"));
+	mu_assert_streq(str, "mov rax, FOO0", "earlier equs are not applied to replacements");
+	free(str);
+	str = rz_asm_code_equ_replace(code, strdup("mov rax, A"));
+	mu_assert_streq(str, "mov rax, BAR1", "in definition order");
+	free(str);
+	str = rz_asm_code_equ_replace(code, strdup("mov rax, FOOFOO"));
+	mu_assert_streq(str, "mov rax, 0x100x10", "every occurrence");
+	free(str);
+	rz_asm_code_set_equ(code, "FOO", "0x20");
+	mu_assert_eq(rz_list_length(code->equs), 3, "redefined in place");
+	str = rz_asm_code_equ_replace(code, strdup("A"));
+	mu_assert_streq(str, "BAR1", "redefinition keeps the order");
+	free(str);
+	str = rz_asm_code_equ_replace(code, strdup("add FOO, 1"));
+	mu_assert_streq(str, "add 0x20, 1", "redefined value");
+	free(str);
+	rz_asm_code_free(code);
+	mu_end;
+}
+
+bool test_rz_asm_massemble_labels(void) {
+	RzAsm *a = rz_asm_new();
+	rz_asm_use(a, "x86.nz");
+	rz_asm_set_bits(a, 64);
+	rz_asm_set_pc(a, 0x1000);
+	RzAsmCode *code = rz_asm_massemble(a, "nop\nloop:\nmov eax, 1\ncall fn\njmp loop\nfn:\nret\n");
+	mu_assert_notnull(code, "assembled");
+	char *hex = rz_asm_code_get_hex(code);
+	mu_assert_streq(hex, "90b801000000e802000000ebf4c3", "labels resolved");
+	free(hex);
+	rz_asm_code_free(code);
+	rz_asm_free(a);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_rz_asm_disassemble_batch);
+	mu_run_test(test_rz_asm_code_equ_replace);
+	mu_run_test(test_rz_asm_massemble_labels);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
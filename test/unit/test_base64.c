@@ -53,12 +53,37 @@ int test_rz_base64_encode(void) {
 	mu_end;
 }
 
+bool test_rz_base64_roundtrip(void) {
+	ut8 bin[256];
+	char enc[400];
+	ut8 dec[300];
+	for (int i = 0; i < sizeof(bin); i++) {
+		bin[i] = i * 7;
+	}
+	for (int sz = 0; sz < 40; sz++) {
+		size_t n = rz_base64_encode(enc, bin, sz);
+		mu_assert_eq(n, (sz + 2) / 3 * 4, "encoded length");
+		if (!sz) {
+			continue;
+		}
+		mu_assert_eq(rz_base64_decode(dec, enc, -1), sz, "decoded length");
+		mu_assert_memeq(dec, bin, sz, "decoded data");
+	}
+	rz_base64_encode(enc, bin, sizeof(bin));
+	mu_assert_eq(rz_base64_decode(dec, enc, -1), (int)sizeof(bin), "decoded length");
+	mu_assert_memeq(dec, bin, sizeof(bin), "decoded data");
+	enc[100] = '!';
+	mu_assert_eq(rz_base64_decode(dec, enc, -1), -1, "invalid character in the middle");
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_base64_decode_dyn);
 	mu_run_test(test_rz_base64_decode);
 	mu_run_test(test_rz_base64_decode_invalid);
 	mu_run_test(test_rz_base64_encode_dyn);
 	mu_run_test(test_rz_base64_encode);
+	mu_run_test(test_rz_base64_roundtrip);
 	return tests_passed != tests_run;
 }
 
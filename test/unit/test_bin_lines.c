@@ -418,12 +418,101 @@ bool test_source_line_info_query() {
 	mu_end;
 }
 
+typedef struct {
+	RzBinSourceLineSample samples[0x400];
+	size_t count;
+} CollectedSamples;
+
+static bool collect_sample_cb(void *user, const RzBinSourceLineSample *sample) {
+	CollectedSamples *c = user;
+	if (c->count >= RZ_ARRAY_SIZE(c->samples)) {
+		return false;
+	}
+	c->samples[c->count++] = *sample;
+	return true;
+}
+
+static bool sample_eq(const RzBinSourceLineSample *a, const RzBinSourceLineSample *b) {
+	return a->address == b->address && a->line == b->line && a->column == b->column &&
+		((!a->file && !b->file) || (a->file && b->file && !strcmp(a->file, b->file)));
+}
+
+bool test_source_line_index_fuzz() {
+	static const char *test_filenames[] = {
+		"into.c",
+		"the.c",
+		"black.c"
+	};
+
+	RzBinSourceLineIndexBuilder *empty = rz_bin_source_line_index_builder_new();
+	mu_assert_notnull(empty, "builder");
+	RzBinSourceLineIndex *index = rz_bin_source_line_index_builder_build_and_free(empty);
+	mu_assert_notnull(index, "index");
+	mu_assert_eq(rz_bin_source_line_index_count(index), 0, "samples count");
+	rz_bin_source_line_index_free(index);
+
+#define FUZZ_COUNT 100
+	for (size_t f = 0; f < FUZZ_COUNT; f++) {
+#undef FUZZ_COUNT
+		// the index must hold exactly what the plain builder makes from the same samples
+		RzBinSourceLineInfoBuilder bob;
+		rz_bin_source_line_info_builder_init(&bob);
+		RzBinSourceLineIndexBuilder *builder = rz_bin_source_line_index_builder_new();
+		mu_assert_notnull(builder, "builder");
+#define SAMPLES_COUNT 0x300
+		for (size_t i = 0; i < SAMPLES_COUNT; i++) {
+			RzBinSourceLineSample s = { 0 };
+			// mostly increasing addresses, like the line programs, with some jumps back
+			s.address = rand() % 8 ? 0x1000 + i + rand() % 4 : 0x1000 + rand() % SAMPLES_COUNT;
+			if (rand() % 10 > 2) {
+				s.line = rand() % 0x1000;
+				s.column = rand() % 16;
+				s.file = rand() % 10 == 0 ? NULL : test_filenames[rand() % RZ_ARRAY_SIZE(test_filenames)];
+			}
+			rz_bin_source_line_info_builder_push_sample(&bob, s.address, s.line, s.column, s.file);
+			mu_assert_true(rz_bin_source_line_index_builder_push_sample(builder, &s), "push sample");
+		}
+		RzBinSourceLineInfo *li = rz_bin_source_line_info_builder_build_and_fini(&bob);
+		index = rz_bin_source_line_index_builder_build_and_free(builder);
+		mu_assert_notnull(index, "index");
+		mu_assert_eq(rz_bin_source_line_index_count(index), li->samples_count, "samples count");
+
+		CollectedSamples *c = RZ_NEW0(CollectedSamples);
+		rz_bin_source_line_index_foreach(index, collect_sample_cb, c);
+		mu_assert_eq(c->count, li->samples_count, "foreach count");
+		for (size_t i = 0; i < c->count; i++) {
+			mu_assert_true(sample_eq(&c->samples[i], &li->samples[i]), "foreach sample");
+		}
+
+		RzBinSourceLineIndex *converted = rz_bin_source_line_index_new_from_info(li);
+		mu_assert_notnull(converted, "converted index");
+		for (ut64 addr = 0xff0; addr < 0x1000 + SAMPLES_COUNT + 0x10; addr++) {
+			c->count = 0;
+			rz_bin_source_line_index_foreach_at(addr & 1 ? index : converted, addr, collect_sample_cb, c);
+			size_t i = 0;
+			for (const RzBinSourceLineSample *s = rz_bin_source_line_info_get_first_at(li, addr);
+				s; s = rz_bin_source_line_info_get_next(li, s), i++) {
+				mu_assert_true(i < c->count, "foreach_at count");
+				mu_assert_true(sample_eq(&c->samples[i], s), "foreach_at sample");
+			}
+			mu_assert_eq(i, c->count, "foreach_at count");
+		}
+#undef SAMPLES_COUNT
+		free(c);
+		rz_bin_source_line_index_free(converted);
+		rz_bin_source_line_index_free(index);
+		rz_bin_source_line_info_free(li);
+	}
+	mu_end;
+}
+
 bool all_tests() {
 	srand(time(0));
 	mu_run_test(test_source_line_info_builder_empty);
 	mu_run_test(test_source_line_info_builder);
 	mu_run_test(test_source_line_info_builder_fuzz);
 	mu_run_test(test_source_line_info_query);
+	mu_run_test(test_source_line_index_fuzz);
 	return tests_passed != tests_run;
 }
 
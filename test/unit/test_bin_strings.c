@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_bin.h>
+#include "minunit.h"
+
+static RzBinString *string_new(const char *str, ut64 vaddr, ut64 paddr, ut32 size) {
+	RzBinString *bstr = RZ_NEW0(RzBinString);
+	bstr->string = strdup(str);
+	bstr->vaddr = vaddr;
+	bstr->paddr = paddr;
+	bstr->size = size;
+	bstr->length = size;
+	return bstr;
+}
+
+bool test_rz_bin_object_get_string_in(void) {
+	RzList *list = rz_list_newf(rz_bin_string_free);
+	rz_list_append(list, string_new("world", 0x1100, 0x100, 6));
+	rz_list_append(list, string_new("hello", 0x1000, 0x0, 6));
+	rz_list_append(list, string_new("a long one", 0x1200, 0x200, 0x40));
+	rz_list_append(list, string_new("inside", 0x1210, 0x210, 4));
+	RzBinObject obj = { 0 };
+	obj.strings = rz_bin_string_database_new(list);
+
+	RzBinString *bstr = rz_bin_object_get_string_in(&obj, 0x1003, true);
+	mu_assert_notnull(bstr, "string in the middle");
+	mu_assert_streq(bstr->string, "hello", "string in the middle");
+	mu_assert_null(rz_bin_object_get_string_in(&obj, 0x1006, true), "right after a string");
+	mu_assert_null(rz_bin_object_get_string_in(&obj, 0xfff, true), "before all the strings");
+	bstr = rz_bin_object_get_string_in(&obj, 0x105, false);
+	mu_assert_notnull(bstr, "by physical address");
+	mu_assert_streq(bstr->string, "world", "by physical address");
+	bstr = rz_bin_object_get_string_in(&obj, 0x1212, true);
+	mu_assert_streq(bstr->string, "inside", "the closest string is preferred");
+	bstr = rz_bin_object_get_string_in(&obj, 0x1220, true);
+	mu_assert_notnull(bstr, "string overlapping the next one");
+	mu_assert_streq(bstr->string, "a long one", "string overlapping the next one");
+
+	rz_bin_string_database_add(obj.strings, string_new("added", 0x1300, 0x300, 8));
+	bstr = rz_bin_object_get_string_in(&obj, 0x1307, true);
+	mu_assert_notnull(bstr, "string added after a lookup");
+	mu_assert_streq(bstr->string, "added", "string added after a lookup");
+	rz_bin_string_database_remove(obj.strings, 0x1000, true);
+	mu_assert_null(rz_bin_object_get_string_in(&obj, 0x1003, true), "removed string");
+	mu_assert_null(rz_bin_object_get_string_at(&obj, 0x1003, true), "exact lookup only");
+
+	rz_bin_string_database_free(obj.strings);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_rz_bin_object_get_string_in);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
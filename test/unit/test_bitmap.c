@@ -28,8 +28,69 @@ bool test_rz_bitmap_set(void) {
 	mu_end;
 }
 
+bool test_rz_bitmap_range(void) {
+	RzBitmap *bitmap = rz_bitmap_new(300);
+	rz_bitmap_set_range(bitmap, 3, 5);
+	mu_assert_eq(rz_bitmap_count(bitmap, 0, 300), 2, "bits in a word");
+	rz_bitmap_set_range(bitmap, 60, 200);
+	mu_assert_eq(rz_bitmap_count(bitmap, 0, 300), 142, "bits across words");
+	mu_assert_eq(rz_bitmap_count(bitmap, 64, 128), 64, "whole word");
+	mu_assert_eq(rz_bitmap_count(bitmap, 4, 61), 2, "partial words");
+	mu_assert_eq(rz_bitmap_test(bitmap, 59), false, "before the range");
+	mu_assert_eq(rz_bitmap_test(bitmap, 199), true, "end of the range");
+	mu_assert_eq(rz_bitmap_test(bitmap, 200), false, "after the range");
+	rz_bitmap_unset_range(bitmap, 100, 1000);
+	mu_assert_eq(rz_bitmap_count(bitmap, 0, 300), 42, "unset clamped to the length");
+	rz_bitmap_set_range(bitmap, 250, 1000);
+	mu_assert_eq(rz_bitmap_count(bitmap, 0, 1000), 92, "set clamped to the length");
+	rz_bitmap_free(bitmap);
+	mu_end;
+}
+
+bool test_rz_bitmap_next(void) {
+	RzBitmap *bitmap = rz_bitmap_new(300);
+	mu_assert_eq(rz_bitmap_next_set(bitmap, 0), 300, "nothing set");
+	mu_assert_eq(rz_bitmap_next_unset(bitmap, 7), 7, "unset");
+	rz_bitmap_set(bitmap, 5);
+	rz_bitmap_set_range(bitmap, 130, 299);
+	mu_assert_eq(rz_bitmap_next_set(bitmap, 0), 5, "first set");
+	mu_assert_eq(rz_bitmap_next_set(bitmap, 5), 5, "from a set bit");
+	mu_assert_eq(rz_bitmap_next_set(bitmap, 6), 130, "across words");
+	mu_assert_eq(rz_bitmap_next_unset(bitmap, 130), 299, "end of a run");
+	mu_assert_eq(rz_bitmap_next_set(bitmap, 299), 300, "none after");
+	rz_bitmap_set(bitmap, 299);
+	mu_assert_eq(rz_bitmap_next_unset(bitmap, 130), 300, "none unset after");
+	mu_assert_eq(rz_bitmap_next_set(bitmap, 1000), 300, "out of the bitmap");
+	rz_bitmap_free(bitmap);
+	mu_end;
+}
+
+bool test_rz_bitmap_or_and(void) {
+	RzBitmap *a = rz_bitmap_new(1000);
+	RzBitmap *b = rz_bitmap_new(1000);
+	RzBitmap *c = rz_bitmap_new(999);
+	rz_bitmap_set_range(a, 0, 500);
+	rz_bitmap_set_range(b, 400, 1000);
+	mu_assert_false(rz_bitmap_or(a, c), "different lengths");
+	mu_assert_true(rz_bitmap_and(a, b), "and");
+	mu_assert_eq(rz_bitmap_count(a, 0, 1000), 100, "intersection");
+	mu_assert_eq(rz_bitmap_next_set(a, 0), 400, "intersection");
+	rz_bitmap_unset_range(b, 990, 1000);
+	rz_bitmap_set_range(a, 0, 10);
+	mu_assert_true(rz_bitmap_or(a, b), "or");
+	mu_assert_eq(rz_bitmap_count(a, 0, 1000), 600, "union");
+	mu_assert_eq(rz_bitmap_next_unset(a, 0), 10, "union");
+	rz_bitmap_free(a);
+	rz_bitmap_free(b);
+	rz_bitmap_free(c);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_bitmap_set);
+	mu_run_test(test_rz_bitmap_range);
+	mu_run_test(test_rz_bitmap_next);
+	mu_run_test(test_rz_bitmap_or_and);
 	return tests_passed != tests_run;
 }
 
@@ -1104,6 +1104,46 @@ bool test_rz_bv_copy_nbits(void) {
 	mu_end;
 }
 
+bool test_rz_bv_small_arith(void) {
+	bool carry;
+	RzBitVector *x = rz_bv_new_from_ut64(12, 0xf00);
+	RzBitVector *y = rz_bv_new_from_ut64(12, 0x200);
+	RzBitVector *r = rz_bv_add(x, y, &carry);
+	mu_assert_eq(rz_bv_to_ut64(r), 0x100, "add wraps around");
+	mu_assert_true(carry, "add carry");
+	rz_bv_free(r);
+	r = rz_bv_sub(y, x, &carry);
+	mu_assert_eq(rz_bv_to_ut64(r), 0x300, "sub wraps around");
+	mu_assert_false(carry, "sub borrow");
+	rz_bv_free(r);
+	r = rz_bv_mul(x, y);
+	mu_assert_eq(rz_bv_to_ut64(r), 0, "mul wraps around");
+	rz_bv_free(r);
+	r = rz_bv_neg(y);
+	mu_assert_eq(rz_bv_to_ut64(r), 0xe00, "neg");
+	rz_bv_free(r);
+	rz_bv_toggle_all(x);
+	mu_assert_eq(rz_bv_to_ut64(x), 0xff, "toggle all keeps the length");
+	rz_bv_lshift_fill(x, 4, true);
+	mu_assert_eq(rz_bv_to_ut64(x), 0xfff, "lshift fill");
+	rz_bv_rshift_fill(x, 8, false);
+	mu_assert_eq(rz_bv_to_ut64(x), 0xf, "rshift fill");
+	rz_bv_free(x);
+	rz_bv_free(y);
+
+	x = rz_bv_new_from_ut64(64, UT64_MAX);
+	y = rz_bv_new_from_ut64(64, 1);
+	r = rz_bv_add(x, y, &carry);
+	mu_assert_true(rz_bv_is_zero_vector(r), "add 64 wraps around");
+	mu_assert_true(carry, "add 64 carry");
+	rz_bv_free(r);
+	mu_assert_eq(rz_bv_clz(y), 63, "clz 64");
+	mu_assert_eq(rz_bv_ctz(x), 0, "ctz 64");
+	rz_bv_free(x);
+	rz_bv_free(y);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_rz_bv_init32);
 	mu_run_test(test_rz_bv_init64);
@@ -1128,6 +1168,7 @@ bool all_tests() {
 	mu_run_test(test_rz_bv_set_all);
 	mu_run_test(test_rz_bv_set_to_bytes_le);
 	mu_run_test(test_rz_bv_copy_nbits);
+	mu_run_test(test_rz_bv_small_arith);
 
 	return tests_passed != tests_run;
 }
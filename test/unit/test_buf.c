@@ -730,6 +730,72 @@ bool test_rz_buf_sparse_write_bridge_over_inside(void) {
 	mu_end;
 }
 
+bool test_rz_buf_sparse_write_adjacent(void) {
+	RzBuffer *b = rz_buf_new_sparse(0x42);
+	mu_assert_notnull(b, "rz_buf_new_sparse failed");
+
+	// byte by byte writes grow a single chunk
+	for (ut64 i = 0; i < 0x100; i++) {
+		ut8 v = i;
+		rz_buf_write_at(b, 0x1000 + i, &v, 1);
+	}
+	size_t count;
+	const RzBufferSparseChunk *chunks = rz_buf_sparse_get_chunks(b, &count);
+	mu_assert_eq(count, 1, "chunks count");
+	mu_assert_eq(chunks[0].from, 0x1000, "chunk from");
+	mu_assert_eq(chunks[0].to, 0x10ff, "chunk to");
+	mu_assert_eq(chunks[0].data[0x80], 0x80, "chunk data");
+
+	// a write right before a chunk is merged into it
+	rz_buf_write_at(b, 0xffe, (const ut8 *)"ab", 2);
+	chunks = rz_buf_sparse_get_chunks(b, &count);
+	mu_assert_eq(count, 1, "chunks count");
+	mu_assert_eq(chunks[0].from, 0xffe, "chunk from");
+	mu_assert_eq(chunks[0].to, 0x10ff, "chunk to");
+	mu_assert_memeq(chunks[0].data, (const ut8 *)"ab\x00\x01", 4, "chunk data");
+
+	rz_buf_free(b);
+	mu_end;
+}
+
+bool test_rz_buf_sparse_write_big(void) {
+	RzBuffer *b = rz_buf_new_sparse(0x42);
+	mu_assert_notnull(b, "rz_buf_new_sparse failed");
+
+	// big writes are split into chunks of bounded size
+	size_t size = 0x28000;
+	ut8 *data = malloc(size);
+	mu_assert_notnull(data, "malloc");
+	for (size_t i = 0; i < size; i++) {
+		data[i] = i * 7;
+	}
+	st64 r = rz_buf_write_at(b, 0x100, data, size);
+	mu_assert_eq(r, size, "written size");
+	size_t count;
+	const RzBufferSparseChunk *chunks = rz_buf_sparse_get_chunks(b, &count);
+	mu_assert_eq(count, 3, "chunks count");
+	mu_assert_eq(chunks[0].from, 0x100, "chunk from");
+	mu_assert_eq(chunks[1].from, chunks[0].to + 1, "chunks are contiguous");
+	mu_assert_eq(chunks[2].from, chunks[1].to + 1, "chunks are contiguous");
+	mu_assert_eq(chunks[2].to, 0x100 + size - 1, "chunk to");
+
+	ut8 *out = malloc(size + 2);
+	mu_assert_notnull(out, "malloc");
+	r = rz_buf_read_at(b, 0xff, out, size + 2);
+	mu_assert_eq(r, size + 1, "read size");
+	mu_assert_eq(out[0], 0x42, "byte before");
+	mu_assert_memeq(out + 1, data, size, "data across the chunks");
+	mu_assert_eq(out[size + 1], 0x42, "byte after");
+
+	mu_assert_true(rz_buf_sparse_populated_in(b, 0x10000, 0x10000), "populated inside");
+	mu_assert_false(rz_buf_sparse_populated_in(b, 0x100 + size, UT64_MAX), "not populated after");
+
+	free(out);
+	free(data);
+	rz_buf_free(b);
+	mu_end;
+}
+
 bool test_rz_buf_sparse_resize(void) {
 	RzBuffer *b = rz_buf_new_sparse(0xff);
 	rz_buf_write(b, (ut8 *)"aaaa", 4);
@@ -1026,6 +1092,130 @@ bool test_rz_buf_sparse_overlay_size(void) {
 	mu_end;
 }
 
+bool test_rz_buf_cow(void) {
+	const size_t base_size = 3 * RZ_BUF_COW_PAGE_SIZE;
+	ut8 *data = malloc(base_size);
+	ut8 *tmp = malloc(base_size);
+	mu_assert_notnull(data, "malloc");
+	mu_assert_notnull(tmp, "malloc");
+	for (size_t i = 0; i < base_size; i++) {
+		data[i] = i;
+	}
+	RzBuffer *base = rz_buf_new_with_bytes(data, base_size);
+	rz_buf_set_overflow_byte(base, 0x42);
+	RzBuffer *b = rz_buf_new_cow(base);
+	mu_assert_notnull(b, "rz_buf_new_cow failed");
+	mu_assert_eq(rz_buf_size(b), base_size, "size of base");
+
+	// across a page boundary
+	st64 r = rz_buf_write_at(b, RZ_BUF_COW_PAGE_SIZE - 2, (const ut8 *)"Lemon", 5);
+	mu_assert_eq(r, 5, "write success");
+	r = rz_buf_read_at(b, RZ_BUF_COW_PAGE_SIZE - 4, tmp, 9);
+	mu_assert_eq(r, 9, "read success");
+	mu_assert_memeq(tmp, (const ut8 *)"\xfc\xfdLemon\x03\x04", 9, "read combined");
+	rz_buf_read_at(base, RZ_BUF_COW_PAGE_SIZE - 2, tmp, 5);
+	mu_assert_memeq(tmp, (const ut8 *)"\xfe\xff\x00\x01\x02", 5, "base untouched");
+
+	RzVector *pages = rz_buf_cow_get_pages(b);
+	mu_assert_eq(rz_vector_len(pages), 2, "pages count");
+	mu_assert_eq(*(ut64 *)rz_vector_index_ptr(pages, 0), 0, "page");
+	mu_assert_eq(*(ut64 *)rz_vector_index_ptr(pages, 1), RZ_BUF_COW_PAGE_SIZE, "page");
+	rz_vector_free(pages);
+
+	// beyond the base
+	rz_buf_write_at(b, base_size + 2, (const ut8 *)"Tea", 3);
+	mu_assert_eq(rz_buf_size(b), base_size + 5, "size of writes");
+	rz_buf_read_at(b, base_size - 1, tmp, 6);
+	mu_assert_memeq(tmp, (const ut8 *)"\xff\x42\x42Tea", 6, "read beyond base");
+
+	// snapshot and restore
+	RzBufferCowSnapshot *snap = rz_buf_cow_snapshot(b);
+	mu_assert_notnull(snap, "snapshot");
+	rz_buf_write_at(b, RZ_BUF_COW_PAGE_SIZE, (const ut8 *)"Orange", 6);
+	rz_buf_write_at(b, 2 * RZ_BUF_COW_PAGE_SIZE + 1, (const ut8 *)"Lime", 4);
+	rz_buf_read_at(b, RZ_BUF_COW_PAGE_SIZE - 2, tmp, 8);
+	mu_assert_memeq(tmp, (const ut8 *)"LeOrange", 8, "read after snapshot");
+	mu_assert_true(rz_buf_cow_restore(b, snap), "restore");
+	rz_buf_read_at(b, RZ_BUF_COW_PAGE_SIZE - 2, tmp, 8);
+	mu_assert_memeq(tmp, (const ut8 *)"Lemon\x03\x04\x05", 8, "read restored");
+	rz_buf_read_at(b, 2 * RZ_BUF_COW_PAGE_SIZE, tmp, 6);
+	mu_assert_memeq(tmp, (const ut8 *)"\x00\x01\x02\x03\x04\x05", 6, "read restored unpopulated");
+	rz_buf_write_at(b, 0, (const ut8 *)"Kiwi", 4);
+	mu_assert_true(rz_buf_cow_restore(b, snap), "restore again");
+	rz_buf_read_at(b, 0, tmp, 4);
+	mu_assert_memeq(tmp, (const ut8 *)"\x00\x01\x02\x03", 4, "read restored again");
+	rz_buf_cow_snapshot_free(snap);
+
+	// commit into the base
+	rz_buf_write_at(b, 2 * RZ_BUF_COW_PAGE_SIZE + 1, (const ut8 *)"Lime", 4);
+	mu_assert_true(rz_buf_cow_commit(b), "commit");
+	pages = rz_buf_cow_get_pages(b);
+	mu_assert_eq(rz_vector_len(pages), 0, "pages committed");
+	rz_vector_free(pages);
+	rz_buf_read_at(base, RZ_BUF_COW_PAGE_SIZE - 2, tmp, 7);
+	mu_assert_memeq(tmp, (const ut8 *)"Lemon\x03\x04", 7, "base committed");
+	rz_buf_read_at(base, 2 * RZ_BUF_COW_PAGE_SIZE, tmp, 6);
+	mu_assert_memeq(tmp, (const ut8 *)"\x00Lime\x05", 6, "base committed");
+	rz_buf_read_at(base, base_size - 1, tmp, 6);
+	mu_assert_memeq(tmp, (const ut8 *)"\xff\x42\x42Tea", 6, "base committed beyond");
+
+	// reset drops everything not committed
+	rz_buf_write_at(b, 0, (const ut8 *)"Kiwi", 4);
+	rz_buf_cow_reset(b);
+	pages = rz_buf_cow_get_pages(b);
+	mu_assert_eq(rz_vector_len(pages), 0, "reset");
+	rz_vector_free(pages);
+	rz_buf_read_at(b, 0, tmp, 4);
+	mu_assert_memeq(tmp, (const ut8 *)"\x00\x01\x02\x03", 4, "read after reset");
+
+	rz_buf_free(b);
+	rz_buf_free(base);
+	free(data);
+	free(tmp);
+	mu_end;
+}
+
+bool test_rz_buf_inflate(void) {
+	// several checkpoints worth of data
+	const int size = 3 << 20;
+	ut8 *data = malloc(size);
+	ut8 *tmp = malloc(0x20000);
+	mu_assert_notnull(data, "malloc");
+	mu_assert_notnull(tmp, "malloc");
+	ut32 seed = 1;
+	for (int i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		data[i] = 'a' + (seed >> 16) % 13;
+	}
+	int zlen = 0;
+	ut8 *z = rz_deflate(data, size, NULL, &zlen);
+	mu_assert_notnull(z, "deflate");
+	RzBuffer *zb = rz_buf_new_with_pointers(z, zlen, true);
+	RzBuffer *b = rz_buf_new_inflate(zb);
+	mu_assert_notnull(b, "rz_buf_new_inflate failed");
+	mu_assert_eq(rz_buf_size(b), size, "decompressed size");
+
+	const ut64 offs[] = { 0, size - 5, 1 << 20, 7, (1 << 20) - 3, 2500000, 100, size - 0x10000 };
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(offs); i++) {
+		ut64 len = RZ_MIN(0x20000, size - offs[i]);
+		st64 r = rz_buf_read_at(b, offs[i], tmp, len);
+		mu_assert_eq(r, len, "read length");
+		mu_assert_memeq(tmp, data + offs[i], len, "read contents");
+	}
+	mu_assert_eq(rz_buf_read_at(b, size, tmp, 10), 0, "read at the end");
+	mu_assert_true(rz_buf_write_at(b, 0, (const ut8 *)"x", 1) < 0, "read only");
+
+	RzBuffer *bad = rz_buf_new_with_bytes((const ut8 *)"not compressed", 14);
+	mu_assert_null(rz_buf_new_inflate(bad), "not a stream");
+
+	rz_buf_free(bad);
+	rz_buf_free(b);
+	rz_buf_free(zb);
+	free(data);
+	free(tmp);
+	mu_end;
+}
+
 bool test_rz_buf_bytes_steal(void) {
 	RzBuffer *b;
 	const char *content = "Something To\nSay Here..";
@@ -1359,6 +1549,7 @@ bool test_rz_buf_fwd_scan(void) {
 	mu_assert_true(test_rz_buf_fwd_scan_helper(b), "rz_buf_fwd_scan with whole buffer available failed");
 	RzBufferMethods methods = *b->methods;
 	methods.get_whole_buf = NULL;
+	methods.borrow = NULL;
 	b->methods = &methods;
 	mu_assert_true(test_rz_buf_fwd_scan_helper(b), "rz_buf_fwd_scan with whole buffer unavailable failed");
 	ut8 zero_buf[0x1000 - 4] = { 0 };
@@ -1377,6 +1568,62 @@ bool test_rz_buf_fwd_scan(void) {
 	mu_end;
 }
 
+bool test_rz_buf_borrow(void) {
+	RzBuffer *b = rz_buf_new_with_bytes((ut8 *)"ABCDEFGH", 8);
+	ut64 len = 4;
+	const ut8 *data = rz_buf_borrow_at(b, 2, &len);
+	mu_assert_notnull(data, "bytes can be borrowed");
+	mu_assert_eq(len, 4, "borrowed len");
+	mu_assert_memeq(data, (ut8 *)"CDEF", 4, "borrowed data");
+	len = 0x100;
+	data = rz_buf_borrow_at(b, 6, &len);
+	mu_assert_eq(len, 2, "borrowed len is clamped to the end");
+	mu_assert_memeq(data, (ut8 *)"GH", 2, "borrowed data");
+	len = 1;
+	mu_assert_null(rz_buf_borrow_at(b, 8, &len), "nothing past the end");
+
+	RzBuffer *slice = rz_buf_new_slice(b, 4, 3);
+	len = 0x100;
+	data = rz_buf_borrow_at(slice, 1, &len);
+	mu_assert_eq(len, 2, "borrowed len is clamped to the slice");
+	mu_assert_memeq(data, (ut8 *)"FG", 2, "borrowed data");
+	rz_buf_free(slice);
+	rz_buf_free(b);
+
+	RzBuffer *sparse = rz_buf_new_sparse(0xff);
+	rz_buf_write_at(sparse, 0, (ut8 *)"ABCD", 4);
+	len = 4;
+	mu_assert_null(rz_buf_borrow_at(sparse, 0, &len), "sparse buffers can't be borrowed");
+	rz_buf_free(sparse);
+
+	RzIO *io = rz_io_new();
+	io->va = true;
+	RzIODesc *desc = rz_io_open_at(io, "hex://0102030405060708", RZ_PERM_RW, 0644, 0x10, NULL);
+	mu_assert_notnull(desc, "file should be opened");
+	RzIOBind bnd;
+	rz_io_bind(io, &bnd);
+	b = rz_buf_new_with_io(&bnd);
+	len = 0x100;
+	data = rz_buf_borrow_at(b, 0x12, &len);
+	mu_assert_notnull(data, "mapped memory can be borrowed");
+	mu_assert_eq(len, 6, "borrowed len is clamped to the map");
+	mu_assert_memeq(data, (ut8 *)"\x03\x04\x05\x06\x07\x08", 6, "borrowed data");
+	len = 4;
+	mu_assert_null(rz_buf_borrow_at(b, 0x4, &len), "unmapped memory can't be borrowed");
+
+	rz_io_cache_write(io, 0x14, (ut8 *)"\xaa", 1);
+	io->cached = RZ_PERM_R;
+	len = 6;
+	data = rz_buf_borrow_at(b, 0x12, &len);
+	mu_assert_eq(len, 2, "borrowed len stops at io.cache data");
+	len = 1;
+	mu_assert_null(rz_buf_borrow_at(b, 0x14, &len), "io.cache data can't be borrowed");
+
+	rz_buf_free(b);
+	rz_io_free(io);
+	mu_end;
+}
+
 int all_tests() {
 	time_t seed = time(0);
 	printf("Jamie Seed: %llu\n", (unsigned long long)seed);
@@ -1399,12 +1646,16 @@ int all_tests() {
 	mu_run_test(test_rz_buf_sparse_write_bridge_exact);
 	mu_run_test(test_rz_buf_sparse_write_bridge_over_outside);
 	mu_run_test(test_rz_buf_sparse_write_bridge_over_inside);
+	mu_run_test(test_rz_buf_sparse_write_adjacent);
+	mu_run_test(test_rz_buf_sparse_write_big);
 	mu_run_test(test_rz_buf_sparse_resize);
 	mu_run_test(test_rz_buf_sparse_fuzz);
 	mu_run_test(test_rz_buf_sparse_overlay);
 	mu_run_test(test_rz_buf_sparse_populated_in);
 	mu_run_test(test_rz_buf_sparse_size);
 	mu_run_test(test_rz_buf_sparse_overlay_size);
+	mu_run_test(test_rz_buf_cow);
+	mu_run_test(test_rz_buf_inflate);
 	mu_run_test(test_rz_buf_bytes_steal);
 	mu_run_test(test_rz_buf_format);
 	mu_run_test(test_rz_buf_get_string);
@@ -1415,6 +1666,7 @@ int all_tests() {
 	mu_run_test(test_rz_buf_whole_buf);
 	mu_run_test(test_rz_buf_whole_buf_alloc);
 	mu_run_test(test_rz_buf_fwd_scan);
+	mu_run_test(test_rz_buf_borrow);
 	return tests_passed != tests_run;
 }
 
@@ -52,9 +52,35 @@ bool test_config_lock() {
 	mu_end;
 }
 
+bool test_config_desc() {
+	static const char static_desc[] = "Static description";
+	RzConfig *cfg = rz_config_new(NULL);
+	RzConfigNode *node = rz_config_set(cfg, "foo.bar", "bla");
+	rz_config_node_desc_static(node, static_desc);
+	mu_assert_ptreq(node->desc, static_desc, "static description is not copied");
+
+	RzConfig *clone = rz_config_clone(cfg);
+	RzConfigNode *cnode = rz_config_node_get(clone, "foo.bar");
+	mu_assert_notnull(cnode, "cloned node");
+	mu_assert_ptrneq(cnode->desc, static_desc, "cloned description is copied");
+	mu_assert_streq(cnode->desc, static_desc, "cloned description");
+	rz_config_free(clone);
+
+	char *desc = strdup("Dynamic description");
+	rz_config_node_desc(node, desc);
+	free(desc);
+	mu_assert_streq(rz_config_desc(cfg, "foo.bar", NULL), "Dynamic description", "description is copied once changed");
+
+	rz_config_rm(cfg, "foo.bar");
+	mu_assert_null(rz_config_node_get(cfg, "foo.bar"), "removed node");
+	rz_config_free(cfg);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_config);
 	mu_run_test(test_config_lock);
+	mu_run_test(test_config_desc);
 	return tests_passed != tests_run;
 }
 
@@ -306,6 +306,106 @@ bool test_line_kill_word(void) {
 	mu_end;
 }
 
+static char *visual_write_out(FILE *f, const char *frame) {
+	char *buf = strdup(frame);
+	long start = ftell(f);
+	rz_cons_visual_write(buf);
+	free(buf);
+	fseek(f, 0, SEEK_END);
+	long end = ftell(f);
+	char *out = calloc(1, end - start + 1);
+	fseek(f, start, SEEK_SET);
+	if (out && end > start) {
+		fread(out, 1, end - start, f);
+	}
+	fseek(f, end, SEEK_SET);
+	return out;
+}
+
+bool test_cons_damage(void) {
+	RzCons *cons = rz_cons_new();
+	FILE *f = tmpfile();
+	mu_assert_notnull(f, "tmpfile");
+	int fdout = cons->fdout;
+	cons->fdout = fileno(f);
+	cons->rows = 3;
+	cons->columns = 8;
+	cons->blankline = false;
+	cons->damage = true;
+	rz_cons_screen_invalidate();
+
+	char *out = visual_write_out(f, "\x1b[0;0Haaa\nbbb\nccc\n");
+	mu_assert_streq(out,
+		"\x1b[1;1H\x1b[0maaa\x1b[0K"
+		"\x1b[2;1H\x1b[0mbbb\x1b[0K"
+		"\x1b[3;1H\x1b[0mccc\x1b[0K",
+		"first frame is written entirely");
+	free(out);
+	out = visual_write_out(f, "\x1b[0;0Haaa\nbbb\nccc\n");
+	mu_assert_streq(out, "", "same frame writes nothing");
+	free(out);
+	out = visual_write_out(f, "\x1b[0;0Haaa\nbXb\nccc\n");
+	mu_assert_streq(out, "\x1b[2;2H\x1b[0mXb\x1b[0K", "only the changed part of the row");
+	free(out);
+	rz_cons_screen_invalidate();
+	out = visual_write_out(f, "\x1b[0;0Haaa\nbXb\nccc\n");
+	mu_assert_eq(strlen(out), 51, "everything after invalidation");
+	free(out);
+
+	cons->damage = false;
+	cons->fdout = fdout;
+	fclose(f);
+	rz_cons_free();
+	mu_end;
+}
+
+bool test_cons_grep_parallel(void) {
+	RzCons *cons = rz_cons_new();
+	cons->num = rz_num_new(NULL, NULL, NULL);
+	// bigger than what is grepped on a single thread
+	RzStrBuf *expect = rz_strbuf_new("");
+	RzStrBuf *expect_icase = rz_strbuf_new("");
+	int lines = 0, lines_icase = 0;
+	for (int i = 0; i < 200000; i++) {
+		const char *kind = i % 7 ? (i % 5 ? "mov" : "CALL") : "call";
+		rz_cons_printf("0x%08x      " Color_GREEN "%s" Color_RESET " eax, %d\n", i, kind, i);
+		if (!strcmp(kind, "call")) {
+			rz_strbuf_appendf(expect, "0x%08x      %s eax, %d\n", i, kind, i);
+			lines++;
+		}
+		if (strcmp(kind, "mov")) {
+			rz_strbuf_appendf(expect_icase, "0x%08x      %s eax, %d\n", i, kind, i);
+			lines_icase++;
+		}
+	}
+	rz_cons_newline();
+	char *out = rz_cons_get_buffer_dup();
+	mu_assert_true(strlen(out) > (4 << 20), "big output");
+	rz_cons_grep("call");
+	mu_assert_streq(rz_cons_get_buffer(), rz_strbuf_get(expect), "grep in order");
+	mu_assert_eq(cons->lines, lines, "grepped lines");
+	rz_cons_reset();
+
+	rz_cons_strcat(out);
+	rz_cons_grep("+call?");
+	char count[16];
+	mu_assert_streq(rz_cons_get_buffer(), rz_strf(count, "%d\n", lines_icase), "count case insensitive");
+	rz_cons_reset();
+
+	rz_cons_strcat(out);
+	rz_cons_grep("+call");
+	mu_assert_streq(rz_cons_get_buffer(), rz_strbuf_get(expect_icase), "case insensitive grep in order");
+	rz_cons_reset();
+
+	free(out);
+	rz_strbuf_free(expect);
+	rz_strbuf_free(expect_icase);
+	rz_num_free(cons->num);
+	cons->num = NULL;
+	rz_cons_free();
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_rz_cons);
 	mu_run_test(test_cons_to_html);
@@ -313,6 +413,8 @@ bool all_tests() {
 	mu_run_test(test_line_onecompletion);
 	mu_run_test(test_line_multicompletion);
 	mu_run_test(test_line_kill_word);
+	mu_run_test(test_cons_damage);
+	mu_run_test(test_cons_grep_parallel);
 	return tests_passed != tests_run;
 }
 
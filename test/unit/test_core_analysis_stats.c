@@ -51,8 +51,60 @@ bool test_stats_bounds(void) {
 	mu_end;
 }
 
+static RzCoreAnalysisStatsItem *stats_at(RzCoreAnalysisStats *as, size_t i) {
+	return rz_vector_index_ptr(&as->blocks, i);
+}
+
+bool test_stats_cached(void) {
+	RzCore *core = rz_core_new();
+	rz_flag_set(core->flags, "first", 0x10, 1);
+
+	RzCoreAnalysisStats *as = rz_core_analysis_get_stats(core, 0, 0xff, 0x20);
+	mu_assert_notnull(as, "stats");
+	mu_assert_eq(stats_at(as, 0)->flags, 1, "flags");
+	mu_assert_eq(stats_at(as, 2)->strings, 0, "strings");
+	rz_core_analysis_stats_free(as);
+
+	// same overview again, the changes in between must show up
+	rz_flag_set(core->flags, "second", 0x30, 1);
+	rz_meta_set_string(core->analysis, RZ_META_TYPE_STRING, 0x45, "elephant");
+	RzAnalysisFunction *fcn = rz_analysis_create_function(core->analysis, "fcn", 0x60, RZ_ANALYSIS_FCN_TYPE_FCN, NULL);
+	RzAnalysisBlock *block = rz_analysis_create_block(core->analysis, 0x60, 0x30);
+	rz_analysis_function_add_block(fcn, block);
+	rz_analysis_block_unref(block);
+	as = rz_core_analysis_get_stats(core, 0, 0xff, 0x20);
+	mu_assert_notnull(as, "stats");
+	mu_assert_eq(stats_at(as, 0)->flags, 1, "flags");
+	mu_assert_eq(stats_at(as, 1)->flags, 1, "added flag");
+	mu_assert_eq(stats_at(as, 2)->strings, 1, "added string");
+	mu_assert_eq(stats_at(as, 3)->functions, 1, "added function");
+	mu_assert_eq(stats_at(as, 3)->blocks, 1, "added block");
+	mu_assert_eq(stats_at(as, 3)->in_functions, 1, "in function");
+	mu_assert_eq(stats_at(as, 4)->in_functions, 1, "in function");
+	mu_assert_eq(stats_at(as, 5)->in_functions, 0, "not in function");
+	stats_at(as, 0)->youarehere = 1;
+	rz_core_analysis_stats_free(as);
+
+	rz_flag_unset_name(core->flags, "first");
+	rz_analysis_function_delete(fcn);
+	as = rz_core_analysis_get_stats(core, 0, 0xff, 0x20);
+	mu_assert_notnull(as, "stats");
+	mu_assert_eq(stats_at(as, 0)->youarehere, 0, "returned stats are copies");
+	mu_assert_eq(stats_at(as, 0)->flags, 0, "removed flag");
+	mu_assert_eq(stats_at(as, 1)->flags, 1, "flags");
+	mu_assert_eq(stats_at(as, 2)->strings, 1, "strings");
+	mu_assert_eq(stats_at(as, 3)->functions, 0, "removed function");
+	mu_assert_eq(stats_at(as, 3)->blocks, 0, "removed function");
+	mu_assert_eq(stats_at(as, 4)->in_functions, 0, "removed function");
+	rz_core_analysis_stats_free(as);
+
+	rz_core_free(core);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_stats_bounds);
+	mu_run_test(test_stats_cached);
 	return tests_passed != tests_run;
 }
 
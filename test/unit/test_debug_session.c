@@ -75,8 +75,9 @@ RzDebugSession *ref_session() {
 	snap->perm = 7;
 	snap->user = 0;
 	snap->shared = true;
-	snap->data = malloc(snap->size);
-	memset(snap->data, 0xf0, snap->size);
+	ut8 data[0x100];
+	memset(data, 0xf0, sizeof(data));
+	rz_debug_snap_set_data(snap, data, NULL);
 	rz_list_append(checkpoint.snaps, snap);
 	rz_vector_push(s->checkpoints, &checkpoint);
 
@@ -91,20 +92,6 @@ static void diff_cb(const SdbDiff *diff, void *user) {
 	printf("%s\n", buf);
 }
 
-static bool test_session_save(void) {
-	Sdb *expected = ref_db();
-	Sdb *actual = sdb_new0();
-	RzDebugSession *s = ref_session();
-	rz_debug_session_serialize(s, actual);
-
-	mu_assert("save", sdb_diff(expected, actual, diff_cb, NULL));
-
-	sdb_free(actual);
-	sdb_free(expected);
-	rz_debug_session_free(s);
-	mu_end;
-}
-
 static bool compare_registers_cb(void *user, const ut64 key, const void *value) {
 	RzDebugChangeReg *actual_reg, *expected_reg;
 	HtUP *ref = user;
@@ -157,16 +144,16 @@ static bool snap_eq(RzDebugSnap *actual, RzDebugSnap *expected) {
 	mu_assert_eq(actual->perm, expected->perm, "snap perm");
 	mu_assert_eq(actual->user, expected->user, "snap user");
 	mu_assert_eq(actual->shared, expected->shared, "snap shared");
-	mu_assert_memeq(actual->data, expected->data, expected->size, "snap data");
+	ut8 *actual_data = rz_debug_snap_data(actual);
+	ut8 *expected_data = rz_debug_snap_data(expected);
+	mu_assert("snap data null", actual_data && expected_data);
+	mu_assert_memeq(actual_data, expected_data, expected->size, "snap data");
+	free(actual_data);
+	free(expected_data);
 	return true;
 }
 
-static bool test_session_load(void) {
-	RzDebugSession *ref = ref_session();
-	RzDebugSession *s = rz_debug_session_new();
-	Sdb *db = ref_db();
-	rz_debug_session_deserialize(s, db);
-
+static bool session_eq(RzDebugSession *s, RzDebugSession *ref) {
 	mu_assert_eq(s->maxcnum, ref->maxcnum, "maxcnum");
 	// Registers
 	ht_up_foreach(s->registers, compare_registers_cb, ref->registers);
@@ -188,9 +175,43 @@ static bool test_session_load(void) {
 		while (actual_snaps_iter && expected_snaps_iter) {
 			RzDebugSnap *actual_snap = rz_list_iter_get(actual_snaps_iter);
 			RzDebugSnap *expected_snap = rz_list_iter_get(expected_snaps_iter);
-			snap_eq(actual_snap, expected_snap);
+			mu_assert("snap", snap_eq(actual_snap, expected_snap));
 		}
+		mu_assert("snaps length", !actual_snaps_iter && !expected_snaps_iter);
 	}
+	return true;
+}
+
+static bool test_session_save(void) {
+	Sdb *expected = ref_db();
+	Sdb *actual = sdb_new0();
+	RzDebugSession *s = ref_session();
+	rz_debug_session_serialize(s, actual);
+
+	mu_assert_eq(sdb_num_get(actual, "maxcnum", 0), 1, "maxcnum");
+	mu_assert("save registers", sdb_diff(sdb_ns(expected, "registers", false), sdb_ns(actual, "registers", false), diff_cb, NULL));
+	mu_assert("save memory", sdb_diff(sdb_ns(expected, "memory", false), sdb_ns(actual, "memory", false), diff_cb, NULL));
+	// snapshot data is compressed, check that it loads back
+	const char *chkpt = sdb_const_get(sdb_ns(actual, "checkpoints", false), "0x0", 0);
+	mu_assert("compressed snap", chkpt && strstr(chkpt, "\"zdata\":"));
+	RzDebugSession *loaded = rz_debug_session_new();
+	rz_debug_session_deserialize(loaded, actual);
+	mu_assert("session round trip", session_eq(loaded, s));
+
+	rz_debug_session_free(loaded);
+	sdb_free(actual);
+	sdb_free(expected);
+	rz_debug_session_free(s);
+	mu_end;
+}
+
+static bool test_session_load(void) {
+	RzDebugSession *ref = ref_session();
+	RzDebugSession *s = rz_debug_session_new();
+	Sdb *db = ref_db();
+	rz_debug_session_deserialize(s, db);
+
+	mu_assert("session", session_eq(s, ref));
 
 	sdb_free(db);
 	rz_debug_session_free(s);
@@ -198,9 +219,83 @@ static bool test_session_load(void) {
 	mu_end;
 }
 
+static bool test_snap_shared_pages(void) {
+	ut8 data[RZ_DEBUG_SNAP_PAGE_SIZE * 2 + 0x10];
+	memset(data, 0x41, sizeof(data));
+	RzDebugSnap *a = RZ_NEW0(RzDebugSnap);
+	a->addr = 0x10000;
+	a->size = sizeof(data);
+	mu_assert("set a", rz_debug_snap_set_data(a, data, NULL));
+	mu_assert_eq(a->pages_count, 3, "pages count");
+
+	data[RZ_DEBUG_SNAP_PAGE_SIZE + 1] = 0x42;
+	RzDebugSnap *b = RZ_NEW0(RzDebugSnap);
+	b->addr = 0x10000;
+	b->size = sizeof(data);
+	mu_assert("set b", rz_debug_snap_set_data(b, data, a));
+	mu_assert_ptreq(b->pages[0], a->pages[0], "unchanged page shared");
+	mu_assert_ptrneq(b->pages[1], a->pages[1], "changed page copied");
+	mu_assert_ptreq(b->pages[2], a->pages[2], "short last page shared");
+	mu_assert_eq(a->pages[0]->refs, 2, "refs");
+
+	rz_debug_snap_free(a);
+	ut8 *b_data = rz_debug_snap_data(b);
+	mu_assert_memeq(b_data, data, sizeof(data), "data");
+	free(b_data);
+	rz_debug_snap_free(b);
+	mu_end;
+}
+
+static bool test_snap_diff(void) {
+	const size_t size = RZ_DEBUG_SNAP_PAGE_SIZE * 200;
+	ut8 *data = malloc(size);
+	memset(data, 0x41, size);
+	RzDebug dbg = { 0 };
+	dbg.hash = rz_hash_new();
+	RzThreadTaskPool *pool = rz_th_task_pool_new(2);
+
+	RzDebugSnap *a = RZ_NEW0(RzDebugSnap);
+	a->size = size;
+	rz_debug_snap_set_data(a, data, NULL);
+	data[RZ_DEBUG_SNAP_PAGE_SIZE * 7] = 0x42;
+	data[RZ_DEBUG_SNAP_PAGE_SIZE * 150 + 3] = 0x42;
+	RzDebugSnap *b = RZ_NEW0(RzDebugSnap);
+	b->size = size;
+	rz_debug_snap_set_data(b, data, a);
+	// same bytes as b without any shared page
+	RzDebugSnap *c = RZ_NEW0(RzDebugSnap);
+	c->size = size;
+	rz_debug_snap_set_data(c, data, NULL);
+
+	RzBitmap *changed = rz_debug_snap_diff(&dbg, a, b, pool);
+	mu_assert_notnull(changed, "diff");
+	for (ut32 i = 0; i < a->pages_count; i++) {
+		mu_assert_eq(rz_bitmap_test(changed, i), i == 7 || i == 150, "changed page");
+	}
+	rz_bitmap_free(changed);
+	mu_assert_false(rz_debug_snap_is_equal(&dbg, a, b), "a != b");
+	mu_assert_true(rz_debug_snap_is_equal(&dbg, b, c), "b == c");
+
+	RzDebugSnap *d = RZ_NEW0(RzDebugSnap);
+	d->size = RZ_DEBUG_SNAP_PAGE_SIZE;
+	rz_debug_snap_set_data(d, data, NULL);
+	mu_assert_null(rz_debug_snap_diff(&dbg, a, d, NULL), "different sizes");
+
+	rz_debug_snap_free(a);
+	rz_debug_snap_free(b);
+	rz_debug_snap_free(c);
+	rz_debug_snap_free(d);
+	rz_th_task_pool_free(pool);
+	rz_hash_free(dbg.hash);
+	free(data);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_session_save);
 	mu_run_test(test_session_load);
+	mu_run_test(test_snap_shared_pages);
+	mu_run_test(test_snap_diff);
 	return tests_passed != tests_run;
 }
 
@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2026 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_demangler.h>
+#include <rz_util.h>
+#include "minunit.h"
+
+static int handler_calls;
+
+static char *upper_handler(const char *symbol) {
+	handler_calls++;
+	if (!strcmp(symbol, "nope")) {
+		return NULL;
+	}
+	char *r = strdup(symbol);
+	rz_str_case(r, true);
+	return r;
+}
+
+bool test_demangler_cache(void) {
+	RzDemangler *dem = rz_demangler_new();
+	mu_assert_notnull(dem, "demangler");
+	handler_calls = 0;
+
+	char *r = rz_demangler_resolve_cached(dem, "abc", "test", upper_handler);
+	mu_assert_streq_free(r, "ABC", "demangled");
+	r = rz_demangler_resolve_cached(dem, "abc", "test", upper_handler);
+	mu_assert_streq_free(r, "ABC", "demangled from the cache");
+	mu_assert_eq(handler_calls, 1, "demangled once");
+
+	r = rz_demangler_resolve_cached(dem, "abc", "other", upper_handler);
+	mu_assert_streq_free(r, "ABC", "demangled");
+	mu_assert_eq(handler_calls, 2, "languages are cached separately");
+
+	r = rz_demangler_resolve_cached(dem, "nope", "test", upper_handler);
+	mu_assert_null(r, "not demangled");
+	r = rz_demangler_resolve_cached(dem, "nope", "test", upper_handler);
+	mu_assert_null(r, "not demangled");
+	mu_assert_eq(handler_calls, 3, "failures are cached too");
+
+	rz_demangler_cache_clear(dem);
+	r = rz_demangler_resolve_cached(dem, "abc", "test", upper_handler);
+	mu_assert_streq_free(r, "ABC", "demangled");
+	mu_assert_eq(handler_calls, 4, "cache cleared");
+
+	rz_demangler_cache_set_size(dem, 0);
+	r = rz_demangler_resolve_cached(dem, "abc", "test", upper_handler);
+	mu_assert_streq_free(r, "ABC", "demangled");
+	mu_assert_eq(handler_calls, 5, "cache disabled");
+
+	rz_demangler_free(dem);
+	mu_end;
+}
+
+bool test_demangler_cache_bounded(void) {
+	RzDemangler *dem = rz_demangler_new();
+	mu_assert_notnull(dem, "demangler");
+	rz_demangler_cache_set_size(dem, 4);
+	handler_calls = 0;
+
+	char name[16];
+	for (int i = 0; i < 100; i++) {
+		snprintf(name, sizeof(name), "sym%d", i);
+		free(rz_demangler_resolve_cached(dem, name, "test", upper_handler));
+		// sym0 is used all the time, so it never leaves the cache
+		char *r = rz_demangler_resolve_cached(dem, "sym0", "test", upper_handler);
+		mu_assert_streq_free(r, "SYM0", "demangled");
+		mu_assert_true(dem->cache->count + (dem->cache_old ? dem->cache_old->count : 0) <= 8, "bounded");
+	}
+	mu_assert_eq(handler_calls, 100, "sym0 demangled once");
+
+	free(rz_demangler_resolve_cached(dem, "sym1", "test", upper_handler));
+	mu_assert_eq(handler_calls, 101, "sym1 evicted");
+	rz_demangler_free(dem);
+	mu_end;
+}
+
+static char *dup_handler(const char *symbol) {
+	return strdup(symbol);
+}
+
+typedef struct {
+	RzDemangler *dem;
+	bool ok;
+} ThreadCtx;
+
+static void *demangle_th(void *user) {
+	ThreadCtx *ctx = user;
+	char name[16];
+	for (int i = 0; i < 2000; i++) {
+		snprintf(name, sizeof(name), "s%d", i % 300);
+		char *r = rz_demangler_resolve_cached(ctx->dem, name, "test", dup_handler);
+		if (!r || strcmp(r, name)) {
+			ctx->ok = false;
+		}
+		free(r);
+	}
+	return NULL;
+}
+
+bool test_demangler_cache_threads(void) {
+	RzDemangler *dem = rz_demangler_new();
+	mu_assert_notnull(dem, "demangler");
+	rz_demangler_cache_set_size(dem, 100);
+	ThreadCtx ctx[4];
+	RzThread *th[4];
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(th); i++) {
+		ctx[i] = (ThreadCtx){ .dem = dem, .ok = true };
+		th[i] = rz_th_new(demangle_th, &ctx[i]);
+		mu_assert_notnull(th[i], "thread");
+	}
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(th); i++) {
+		rz_th_wait(th[i]);
+		rz_th_free(th[i]);
+		mu_assert_true(ctx[i].ok, "consistent results");
+	}
+	rz_demangler_free(dem);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_demangler_cache);
+	mu_run_test(test_demangler_cache_bounded);
+	mu_run_test(test_demangler_cache_threads);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
@@ -24,6 +24,10 @@ static struct {
 	R("foo", "foobar", 3, 3),
 	R("wallaby", "wallet", 5, 3),
 	R("identity", "identity", 0, 0),
+	R("The quick brown fox jumps over the lazy dog, then takes a long nap under the old oak tree.",
+		"A quick brown cat jumped over the lazy dogs, then took a short nap under an old oak tree!", 33, 21),
+	R("0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789abcdefghijklmnopqrstuvwxyz",
+		"abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789", 40, 40),
 	{ NULL, NULL, 0, 0 }
 };
 
@@ -46,6 +50,27 @@ bool test_rz_diff_distances(void) {
 	mu_end;
 }
 
+bool test_rz_diff_levenstein_max(void) {
+	ut32 distance;
+	double similarity;
+
+	for (ut32 i = 0; tests[i].a; i++) {
+		size_t la = strlen((const char *)tests[i].a);
+		size_t lb = strlen((const char *)tests[i].b);
+		ut32 expected = tests[i].levenstein;
+
+		mu_assert_true(rz_diff_levenstein_distance_max(tests[i].a, la, tests[i].b, lb, expected, &distance, NULL), "rz_diff_levenstein_distance_max");
+		mu_assert_eq(distance, expected, "levenstein distance within max");
+		if (!expected) {
+			continue;
+		}
+		mu_assert_true(rz_diff_levenstein_distance_max(tests[i].a, la, tests[i].b, lb, expected - 1, &distance, &similarity), "rz_diff_levenstein_distance_max");
+		mu_assert_eq(distance, UT32_MAX, "levenstein distance above max");
+		mu_assert_true(similarity == 0.0, "levenstein similarity above max");
+	}
+	mu_end;
+}
+
 bool test_rz_diff_unified_lines(void) {
 	RzDiff *diff = NULL;
 	char *result = NULL;
@@ -257,10 +282,134 @@ bool test_rz_diff_unified_bytes(void) {
 	mu_end;
 }
 
+bool test_rz_diff_large_bytes(void) {
+	const ut32 size = 0x40000;
+	ut8 *a = malloc(size);
+	ut8 *b = malloc(size);
+	mu_assert_notnull(a, "malloc a");
+	mu_assert_notnull(b, "malloc b");
+
+	ut32 seed = 0x1337;
+	for (ut32 i = 0; i < size; i++) {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		a[i] = seed;
+	}
+	// 16 bytes replaced at 0x1000 and 0x40 bytes deleted at 0x20000
+	memset(a + 0x1000, 0x00, 0x10);
+	memset(a + 0x20000, 0x55, 0x40);
+	a[0x1ffff] = 0x00;
+	a[0x20040] = 0x00;
+	memcpy(b, a, 0x20000);
+	memset(b + 0x1000, 0xff, 0x10);
+	memcpy(b + 0x20000, a + 0x20040, size - 0x20040);
+
+	RzDiff *diff = rz_diff_bytes_new(a, size, b, size - 0x40, NULL);
+	mu_assert_notnull(diff, "rz_diff_bytes_new");
+	RzList *ops = rz_diff_opcodes_new(diff);
+	mu_assert_notnull(ops, "rz_diff_opcodes_new");
+	mu_assert_eq(rz_list_length(ops), 5, "opcodes count");
+
+	static const RzDiffOp expected[] = {
+		{ RZ_DIFF_OP_EQUAL, 0, 0x1000, 0, 0x1000 },
+		{ RZ_DIFF_OP_REPLACE, 0x1000, 0x1010, 0x1000, 0x1010 },
+		{ RZ_DIFF_OP_EQUAL, 0x1010, 0x20000, 0x1010, 0x20000 },
+		{ RZ_DIFF_OP_DELETE, 0x20000, 0x20040, 0x20000, 0x20000 },
+		{ RZ_DIFF_OP_EQUAL, 0x20040, 0x40000, 0x20000, 0x3ffc0 },
+	};
+	ut32 i = 0;
+	RzListIter *it;
+	RzDiffOp *op;
+	rz_list_foreach (ops, it, op) {
+		mu_assert_eq(op->type, expected[i].type, "opcode type");
+		mu_assert_eq(op->a_beg, expected[i].a_beg, "opcode a_beg");
+		mu_assert_eq(op->a_end, expected[i].a_end, "opcode a_end");
+		mu_assert_eq(op->b_beg, expected[i].b_beg, "opcode b_beg");
+		mu_assert_eq(op->b_end, expected[i].b_end, "opcode b_end");
+		i++;
+	}
+	rz_list_free(ops);
+
+	double ratio = 0;
+	mu_assert_true(rz_diff_ratio(diff, &ratio), "rz_diff_ratio");
+	mu_assert_true(fabs(ratio - (2.0 * (size - 0x50)) / (2 * size - 0x40)) < 1e-9, "ratio");
+
+	rz_diff_free(diff);
+	free(a);
+	free(b);
+	mu_end;
+}
+
+bool test_rz_diff_large_lines(void) {
+	const ut32 count = 0x5000;
+	RzStrBuf *sa = rz_strbuf_new(NULL);
+	RzStrBuf *sb = rz_strbuf_new(NULL);
+	for (ut32 i = 0; i < count; i++) {
+		// blank lines are repeated all over the inputs
+		char line[32];
+		if (i % 8 == 3) {
+			strcpy(line, "\n");
+		} else {
+			snprintf(line, sizeof(line), "line %u\n", i);
+		}
+		rz_strbuf_append(sa, line);
+		// line 100 replaced, 3 lines inserted at 0x2000 and 16 lines deleted at 0x3000
+		if (i == 0x2000) {
+			rz_strbuf_append(sb, "new 1\nnew 2\nnew 3\n");
+		}
+		if (i == 100) {
+			rz_strbuf_append(sb, "changed\n");
+		} else if (i < 0x3000 || i >= 0x3010) {
+			rz_strbuf_append(sb, line);
+		}
+	}
+
+	RzDiff *diff = rz_diff_lines_new(rz_strbuf_get(sa), rz_strbuf_get(sb), NULL);
+	mu_assert_notnull(diff, "rz_diff_lines_new");
+	RzList *ops = rz_diff_opcodes_new(diff);
+	mu_assert_notnull(ops, "rz_diff_opcodes_new");
+	mu_assert_eq(rz_list_length(ops), 7, "opcodes count");
+
+	static const RzDiffOp expected[] = {
+		{ RZ_DIFF_OP_EQUAL, 0, 100, 0, 100 },
+		{ RZ_DIFF_OP_REPLACE, 100, 101, 100, 101 },
+		{ RZ_DIFF_OP_EQUAL, 101, 0x2000, 101, 0x2000 },
+		{ RZ_DIFF_OP_INSERT, 0x2000, 0x2000, 0x2000, 0x2003 },
+		{ RZ_DIFF_OP_EQUAL, 0x2000, 0x3000, 0x2003, 0x3003 },
+		{ RZ_DIFF_OP_DELETE, 0x3000, 0x3010, 0x3003, 0x3003 },
+		{ RZ_DIFF_OP_EQUAL, 0x3010, 0x5000, 0x3003, 0x4ff3 },
+	};
+	ut32 i = 0;
+	RzListIter *it;
+	RzDiffOp *op;
+	rz_list_foreach (ops, it, op) {
+		mu_assert_eq(op->type, expected[i].type, "opcode type");
+		mu_assert_eq(op->a_beg, expected[i].a_beg, "opcode a_beg");
+		mu_assert_eq(op->a_end, expected[i].a_end, "opcode a_end");
+		mu_assert_eq(op->b_beg, expected[i].b_beg, "opcode b_beg");
+		mu_assert_eq(op->b_end, expected[i].b_end, "opcode b_end");
+		i++;
+	}
+	rz_list_free(ops);
+
+	double ratio = 0;
+	mu_assert_true(rz_diff_ratio(diff, &ratio), "rz_diff_ratio");
+	mu_assert_true(fabs(ratio - (2.0 * (count - 17)) / (2 * count - 13)) < 1e-9, "ratio");
+
+	rz_diff_free(diff);
+	rz_strbuf_free(sa);
+	rz_strbuf_free(sb);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_diff_distances);
+	mu_run_test(test_rz_diff_levenstein_max);
 	mu_run_test(test_rz_diff_unified_lines);
 	mu_run_test(test_rz_diff_unified_bytes);
+	mu_run_test(test_rz_diff_large_bytes);
+	mu_run_test(test_rz_diff_large_lines);
 	return tests_passed != tests_run;
 }
 
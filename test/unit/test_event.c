@@ -27,6 +27,7 @@ bool test_rz_event(void) {
 
 	RzEventCallbackHandle handle_all = rz_event_hook(ev, RZ_EVENT_ALL, callback_test, &acc_all);
 	RzEventCallbackHandle handle_specific = rz_event_hook(ev, RZ_EVENT_META_SET, callback_test, &acc_specific);
+	mu_assert_eq(ev->hooked, 2, "hooks counted");
 
 	rz_event_send(ev, RZ_EVENT_META_DEL, (void *)(size_t)0x4242);
 
@@ -62,6 +63,7 @@ bool test_rz_event(void) {
 	mu_assert_eq(acc_specific.count, 2, "specific count after event after being removed");
 	mu_assert_eq(acc_specific.last_type, RZ_EVENT_META_SET, "specific type after event after being removed");
 	mu_assert_ptreq(acc_specific.last_data, (void *)0xc0ffee, "specific type after event after being removed");
+	mu_assert_eq(ev->hooked, 0, "hooks uncounted");
 
 	rz_event_free(ev);
 
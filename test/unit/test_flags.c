@@ -131,10 +131,145 @@ bool test_rz_flag_get_at() {
 	mu_end;
 }
 
+static bool collect_offset(RzFlagItem *fi, void *user) {
+	rz_vector_push(user, &fi->offset);
+	return true;
+}
+
+bool test_rz_flag_unordered(void) {
+	RzFlag *flag = rz_flag_new();
+	rz_flag_set(flag, "c", 0x300, 0);
+	rz_flag_set(flag, "a", 0x100, 0);
+	rz_flag_set(flag, "d", 0x400, 0);
+	rz_flag_set(flag, "b", 0x200, 0);
+	rz_flag_set(flag, "b2", 0x200, 0);
+
+	RzFlagItem *fi = rz_flag_get_at(flag, 0x2ff, true);
+	mu_assert_notnull(fi, "closest flag");
+	mu_assert_eq(fi->offset, 0x200, "closest flag");
+	mu_assert_eq(rz_list_length(rz_flag_get_list(flag, 0x200)), 2, "flags at offset");
+
+	rz_flag_set(flag, "c", 0x50, 0);
+	fi = rz_flag_get_at(flag, 0x3ff, true);
+	mu_assert_eq(fi->offset, 0x200, "moved flag");
+	fi = rz_flag_get_at(flag, 0x60, true);
+	mu_assert_streq(fi->name, "c", "moved flag");
+
+	RzVector offsets;
+	rz_vector_init(&offsets, sizeof(ut64), NULL, NULL);
+	rz_flag_foreach(flag, collect_offset, &offsets);
+	ut64 expect[] = { 0x50, 0x100, 0x200, 0x200, 0x400 };
+	mu_assert_eq(rz_vector_len(&offsets), RZ_ARRAY_SIZE(expect), "foreach count");
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(expect); i++) {
+		mu_assert_eq(*(ut64 *)rz_vector_index_ptr(&offsets, i), expect[i], "foreach order");
+	}
+	rz_vector_clear(&offsets);
+	rz_flag_foreach_range(flag, 0x100, 0x3ff, collect_offset, &offsets);
+	mu_assert_eq(rz_vector_len(&offsets), 3, "foreach range");
+	rz_vector_fini(&offsets);
+
+	rz_flag_free(flag);
+	mu_end;
+}
+
+static bool unset_some(RzFlagItem *fi, void *user) {
+	if (fi->offset & 0x20) {
+		rz_flag_unset(user, fi);
+	}
+	return true;
+}
+
+bool test_rz_flag_unordered_many(void) {
+	RzFlag *flag = rz_flag_new();
+	char name[32];
+	// enough out of order offsets and removals to go through several merges
+	for (ut64 i = 0; i < 0x2000; i++) {
+		ut64 off = ((i * 0x9e5) & 0x1fff) << 4;
+		snprintf(name, sizeof(name), "f.%" PFMT64x, off);
+		rz_flag_set(flag, name, off, 0);
+		RzFlagItem *fi = rz_flag_get_at(flag, off + 8, true);
+		mu_assert_notnull(fi, "closest flag");
+		mu_assert_eq(fi->offset, off, "closest flag");
+		if (i & 1) {
+			mu_assert_true(rz_flag_unset_name(flag, name), "unset");
+			mu_assert_null(rz_flag_get_at(flag, off, false), "unset flag");
+		}
+	}
+	mu_assert_eq(rz_flag_count(flag, NULL), 0x1000, "flag count");
+
+	RzVector offsets;
+	rz_vector_init(&offsets, sizeof(ut64), NULL, NULL);
+	rz_flag_foreach(flag, collect_offset, &offsets);
+	mu_assert_eq(rz_vector_len(&offsets), 0x1000, "foreach count");
+	for (size_t i = 1; i < rz_vector_len(&offsets); i++) {
+		mu_assert_true(*(ut64 *)rz_vector_index_ptr(&offsets, i - 1) < *(ut64 *)rz_vector_index_ptr(&offsets, i), "foreach order");
+	}
+
+	// removing from the callbacks
+	rz_flag_foreach(flag, unset_some, flag);
+	rz_vector_clear(&offsets);
+	rz_flag_foreach(flag, collect_offset, &offsets);
+	mu_assert_eq(rz_vector_len(&offsets), 0x800, "foreach count after unset");
+	rz_vector_fini(&offsets);
+
+	RzFlagItem *fi = rz_flag_get_at(flag, 0x1003f, true);
+	mu_assert_notnull(fi, "closest flag after unset");
+	mu_assert_eq(fi->offset, 0x10000, "closest flag after unset");
+
+	rz_flag_free(flag);
+	mu_end;
+}
+
+static bool collect_name(RzFlagItem *fi, void *user) {
+	rz_pvector_push(user, fi->name);
+	return true;
+}
+
+bool test_rz_flag_name_prefix(void) {
+	RzFlag *flag = rz_flag_new();
+	rz_flag_set(flag, "sym.main", 0x100, 0);
+	rz_flag_set(flag, "str.hello", 0x50, 0);
+	rz_flag_set(flag, "sym.imp.puts", 0x200, 0);
+	rz_flag_set(flag, "sym.exit", 0x300, 0);
+	rz_flag_set(flag, "section.text", 0x10, 0);
+
+	RzPVector names;
+	rz_pvector_init(&names, NULL);
+	rz_flag_foreach_name_prefix(flag, "sym.", -1, collect_name, &names);
+	mu_assert_eq(rz_pvector_len(&names), 3, "prefix count");
+	mu_assert_streq(rz_pvector_at(&names, 0), "sym.exit", "name order");
+	mu_assert_streq(rz_pvector_at(&names, 1), "sym.imp.puts", "name order");
+	mu_assert_streq(rz_pvector_at(&names, 2), "sym.main", "name order");
+
+	rz_pvector_clear(&names);
+	rz_flag_foreach_name_prefix(flag, "sxxx", 1, collect_name, &names);
+	mu_assert_eq(rz_pvector_len(&names), 5, "prefix length");
+	rz_pvector_clear(&names);
+	rz_flag_foreach_name_prefix(flag, "sz", -1, collect_name, &names);
+	mu_assert_eq(rz_pvector_len(&names), 0, "no match");
+
+	// the names are sorted again after changes
+	rz_flag_unset_name(flag, "sym.imp.puts");
+	rz_flag_rename(flag, rz_flag_get(flag, "str.hello"), "sym.hello");
+	rz_flag_set(flag, "sym.a", 0x400, 0);
+	rz_pvector_clear(&names);
+	rz_flag_foreach_name_prefix(flag, "sym.", -1, collect_name, &names);
+	mu_assert_eq(rz_pvector_len(&names), 4, "prefix count after changes");
+	mu_assert_streq(rz_pvector_at(&names, 0), "sym.a", "added");
+	mu_assert_streq(rz_pvector_at(&names, 2), "sym.hello", "renamed");
+	rz_pvector_fini(&names);
+
+	rz_flag_free(flag);
+	mu_end;
+}
+
 int all_tests(void) {
 	mu_run_test(test_rz_flag_get_set);
 	mu_run_test(test_rz_flag_by_spaces);
 	mu_run_test(test_rz_flag_get_at);
+	mu_run_test(test_rz_flag_unordered);
+	mu_run_test(test_rz_flag_unordered_many);
+	mu_run_test(test_rz_flag_name_prefix);
 	return tests_passed != tests_run;
 }
 
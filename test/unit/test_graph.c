@@ -141,8 +141,95 @@ static bool test_legacy_graph(void) {
 	mu_end;
 }
 
+static void csr_finish(ut32 n, RzGraphCSRVisitor *vis) {
+	rz_vector_push(vis->data, &n);
+}
+
+static void csr_back_edge(ut32 from, ut32 to, ut32 nth, RzGraphCSRVisitor *vis) {
+	ut32 *back = vis->data;
+	back[0] = from;
+	back[1] = to;
+	back[2] = nth;
+}
+
+static bool test_graph_csr(void) {
+	RzGraphCSRBuilder *b = rz_graph_csr_builder_new();
+	mu_assert_notnull(b, "builder");
+	for (size_t i = 0; i < 5; i++) {
+		mu_assert_eq(rz_graph_csr_builder_add_node(b, (void *)(i + 1)), i, "add_node");
+	}
+	mu_assert_true(rz_graph_csr_builder_add_edge(b, 0, 2), "edge 0 2");
+	mu_assert_true(rz_graph_csr_builder_add_edge(b, 0, 1), "edge 0 1");
+	mu_assert_true(rz_graph_csr_builder_add_edge(b, 1, 3), "edge 1 3");
+	mu_assert_true(rz_graph_csr_builder_add_edge(b, 2, 3), "edge 2 3");
+	mu_assert_true(rz_graph_csr_builder_add_edge(b, 3, 0), "edge 3 0");
+	mu_assert_false(rz_graph_csr_builder_add_edge(b, 3, 5), "edge to missing node");
+	RzGraphCSR *g = rz_graph_csr_builder_build(b);
+	rz_graph_csr_builder_free(b);
+	mu_assert_notnull(g, "build");
+	mu_assert_eq(g->n_nodes, 5, "n_nodes");
+	mu_assert_eq(g->n_edges, 5, "n_edges");
+	mu_assert_ptreq(g->data[4], (void *)5, "data");
+	mu_assert_eq(rz_graph_csr_out_degree(g, 0), 2, "out degree");
+	mu_assert_eq(rz_graph_csr_out_nodes(g, 0)[0], 2, "out order");
+	mu_assert_eq(rz_graph_csr_out_nodes(g, 0)[1], 1, "out order");
+	mu_assert_eq(rz_graph_csr_in_degree(g, 3), 2, "in degree");
+	mu_assert_eq(rz_graph_csr_in_nodes(g, 3)[0], 1, "in order");
+	mu_assert_eq(rz_graph_csr_in_nodes(g, 3)[1], 2, "in order");
+	mu_assert_eq(rz_graph_csr_out_degree(g, 4), 0, "isolated");
+	mu_assert_true(rz_graph_csr_adjacent(g, 3, 0), "adjacent");
+	mu_assert_false(rz_graph_csr_adjacent(g, 0, 3), "not adjacent");
+
+	RzVector finished;
+	rz_vector_init(&finished, sizeof(ut32), NULL, NULL);
+	RzGraphCSRVisitor vis = { 0 };
+	vis.data = &finished;
+	vis.finish_node = csr_finish;
+	rz_graph_csr_dfs(g, &vis);
+	ut32 exp_finished[] = { 3, 2, 1, 0, 4 };
+	mu_assert_eq(rz_vector_len(&finished), 5, "finished all");
+	mu_assert_memeq(finished.a, (ut8 *)exp_finished, sizeof(exp_finished), "finish order");
+	rz_vector_fini(&finished);
+
+	ut32 back[3] = { 0 };
+	RzGraphCSRVisitor back_vis = { 0 };
+	back_vis.data = back;
+	back_vis.back_edge = csr_back_edge;
+	rz_graph_csr_dfs_node(g, 1, &back_vis);
+	mu_assert_eq(back[0], 0, "back edge from");
+	mu_assert_eq(back[1], 1, "back edge to");
+	mu_assert_eq(back[2], 1, "back edge nth");
+	rz_graph_csr_free(g);
+
+	RzGraph *lg = rz_graph_new();
+	RzGraphNode *n0 = rz_graph_add_node(lg, (void *)1);
+	RzGraphNode *n1 = rz_graph_add_node(lg, (void *)2);
+	RzGraphNode *n2 = rz_graph_add_node(lg, (void *)3);
+	RzGraphNode *n3 = rz_graph_add_node(lg, (void *)4);
+	rz_graph_add_edge(lg, n0, n1);
+	rz_graph_add_edge(lg, n1, n2);
+	rz_graph_add_edge(lg, n0, n3);
+	rz_graph_add_edge(lg, n3, n2);
+	rz_graph_del_node(lg, n1);
+	g = rz_graph_csr_new_from_graph(lg);
+	mu_assert_notnull(g, "from graph");
+	mu_assert_eq(g->n_nodes, 3, "from graph n_nodes");
+	mu_assert_eq(g->n_edges, 2, "from graph n_edges");
+	mu_assert_eq(rz_graph_csr_index(g, n0), 0, "index n0");
+	mu_assert_eq(rz_graph_csr_index(g, n3), 2, "index n3");
+	mu_assert_ptreq(g->nodes[1], n2, "node n2");
+	mu_assert_ptreq(g->data[2], (void *)4, "data n3");
+	mu_assert_true(rz_graph_csr_adjacent(g, 0, 2), "n0 -> n3");
+	mu_assert_true(rz_graph_csr_adjacent(g, 2, 1), "n3 -> n2");
+	mu_assert_eq(rz_graph_csr_in_degree(g, 1), 1, "in n2");
+	rz_graph_csr_free(g);
+	rz_graph_free(lg);
+	mu_end;
+}
+
 static int all_tests() {
 	mu_run_test(test_legacy_graph);
+	mu_run_test(test_graph_csr);
 	return tests_passed != tests_run;
 }
 
@@ -237,11 +237,69 @@ bool test_message_digest_small_block_stringified() {
 	mu_end;
 }
 
+bool test_message_digest_small_blocks() {
+	char message[256];
+	RzHash *rh = rz_hash_new();
+	const char *algos[] = { "md5", "sha1", "sha256", "crc32" };
+	const ut8 *buffers[] = { (const ut8 *)"password", (const ut8 *)"HelloWorld", (const ut8 *)"" };
+	const ut64 sizes[] = { 8, 10, 0 };
+
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(algos); ++i) {
+		RzHashSize digest_size = 0;
+		ut8 *digests = rz_hash_cfg_calculate_small_blocks(rh, algos[i], buffers, sizes, RZ_ARRAY_SIZE(buffers), &digest_size);
+		snprintf(message, sizeof(message), "calculate %s digests", algos[i]);
+		mu_assert_notnull(digests, message);
+		for (size_t j = 0; j < RZ_ARRAY_SIZE(buffers); ++j) {
+			RzHashSize size = 0;
+			ut8 *digest = rz_hash_cfg_calculate_small_block(rh, algos[i], buffers[j], sizes[j], &size);
+			snprintf(message, sizeof(message), "%s digest %zu", algos[i], j);
+			mu_assert_eq(size, digest_size, message);
+			mu_assert_memeq(digests + j * digest_size, digest, size, message);
+			free(digest);
+		}
+		free(digests);
+	}
+	mu_assert_null(rz_hash_cfg_calculate_small_blocks(rh, "nope", buffers, sizes, RZ_ARRAY_SIZE(buffers), NULL), "unknown algorithm");
+	rz_hash_free(rh);
+
+	mu_end;
+}
+
+bool test_entropy_blocks() {
+	RzHash *rh = rz_hash_new();
+	RzThreadTaskPool *pool = rz_th_task_pool_new(2);
+	mu_assert_notnull(pool, "task pool");
+	ut8 data[8 * 0x800];
+	for (size_t i = 0; i < sizeof(data); ++i) {
+		// a block of zeroes, then blocks of growing variety
+		data[i] = i < 0x800 ? 0 : (ut8)((i * 2654435761u) % (i / 0x800 * 32));
+	}
+	double entropies[8];
+	for (int with_pool = 0; with_pool < 2; ++with_pool) {
+		for (int fraction = 0; fraction < 2; ++fraction) {
+			memset(entropies, 0, sizeof(entropies));
+			rz_hash_entropy_blocks(rh, with_pool ? pool : NULL, data, 0x800, RZ_ARRAY_SIZE(entropies), fraction, entropies);
+			for (size_t i = 0; i < RZ_ARRAY_SIZE(entropies); ++i) {
+				const ut8 *block = data + i * 0x800;
+				double expected = fraction ? rz_hash_entropy_fraction(rh, block, 0x800) : rz_hash_entropy(rh, block, 0x800);
+				mu_assert_true(entropies[i] == expected, "entropy of block");
+			}
+		}
+	}
+	mu_assert_true(entropies[0] == 0.0, "entropy of zeroes");
+	rz_th_task_pool_free(pool);
+	rz_hash_free(rh);
+
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_message_digest_configure);
 	mu_run_test(test_message_digest_api_stringified);
 	mu_run_test(test_message_digest_hmac_stringified);
 	mu_run_test(test_message_digest_small_block_stringified);
+	mu_run_test(test_message_digest_small_blocks);
+	mu_run_test(test_entropy_blocks);
 	return tests_passed != tests_run;
 }
 
@@ -165,16 +165,33 @@ bool test_rz_str2bin(void) {
 	mu_assert_eq(rz_hex_str2bin("616263646566", buf), 6, "6 bytes are written");
 	mu_assert_memeq(buf, (ut8 *)"abcdef", 6, "abcdef has been written");
 	mu_assert_eq(rz_hex_str2bin("61626364656", buf), -6, "error should be returned");
+	mu_assert_eq(rz_hex_str2bin("4A4b 4c\n4 d # 4e\n/* 4f */ 50", buf), 5, "5 bytes are written");
+	mu_assert_memeq(buf, (ut8 *)"JKLMP", 5, "JKLMP has been written");
+	mu_assert_eq(rz_hex_str2bin("41424g", buf), 0, "invalid digit");
+	mu_assert_eq(rz_hex_str2bin("414243", NULL), 3, "bytes are only counted");
 	free(buf);
 	mu_end;
 }
 
+bool test_rz_bin2str(void) {
+	char out[16];
+	mu_assert_eq(rz_hex_bin2str((const ut8 *)"\x00\x7f\x80\xa5\xff", 5, out), 5, "5 bytes are read");
+	mu_assert_streq(out, "007f80a5ff", "bytes have been printed");
+	mu_assert_eq(rz_hex_bin2str((const ut8 *)"", 0, out), 0, "nothing is read");
+	mu_assert_streq(out, "", "empty string");
+	char *s = rz_hex_bin2strdup((const ut8 *)"\x01\xfe", 2);
+	mu_assert_streq(s, "01fe", "bytes have been printed");
+	free(s);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_rz_hex_from_c);
 	mu_run_test(test_rz_hex_from_py);
 	mu_run_test(test_rz_hex_from_code);
 	mu_run_test(test_rz_hex_no_code);
 	mu_run_test(test_rz_str2bin);
+	mu_run_test(test_rz_bin2str);
 	return tests_passed != tests_run;
 }
 
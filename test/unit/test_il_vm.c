@@ -868,6 +868,191 @@ static bool test_rzil_vm_op_compare() {
 	mu_end;
 }
 
+static RzILVM *compiled_test_vm(ut8 *data, size_t size, ut64 r0, ut64 r1) {
+	RzILVM *vm = rz_il_vm_new(0x100, 16, false);
+	rz_il_vm_create_global_var(vm, "r0", rz_il_sort_pure_bv(32));
+	rz_il_vm_create_global_var(vm, "r1", rz_il_sort_pure_bv(32));
+	rz_il_vm_create_global_var(vm, "r2", rz_il_sort_pure_bv(8));
+	rz_il_vm_create_global_var(vm, "f", rz_il_sort_pure_bool());
+	rz_il_vm_set_global_var(vm, "r0", rz_il_value_new_bitv(rz_bv_new_from_ut64(32, r0)));
+	rz_il_vm_set_global_var(vm, "r1", rz_il_value_new_bitv(rz_bv_new_from_ut64(32, r1)));
+	RzBuffer *buf = rz_buf_new_with_pointers(data, size, false);
+	rz_il_vm_add_mem(vm, 0, rz_il_mem_new(buf, 16));
+	rz_buf_free(buf);
+	return vm;
+}
+
+static char *compiled_test_state(RzILVM *vm) {
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	const char *vars[] = { "r0", "r1", "r2", "f" };
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(vars); i++) {
+		char *v = rz_il_value_stringify(rz_il_vm_get_var_value(vm, RZ_IL_VAR_KIND_GLOBAL, vars[i]));
+		rz_strbuf_appendf(&sb, "%s=%s ", vars[i], v);
+		free(v);
+	}
+	rz_strbuf_appendf(&sb, "pc=0x%" PFMT64x "\n", rz_bv_to_ut64(vm->pc));
+	RzListIter *it;
+	RzILEvent *ev;
+	rz_list_foreach (vm->events, it, ev) {
+		rz_il_event_stringify(ev, &sb);
+		rz_strbuf_append(&sb, "\n");
+	}
+	return rz_strbuf_drain_nofree(&sb);
+}
+
+/**
+ * Check that compiling and executing \p op gives exactly the same state and events as the tree evaluator
+ */
+static bool compiled_matches_tree(RzILOpEffect *op, ut64 r0, ut64 r1) {
+	ut8 data_tree[] = { 0x10, 0x81, 0x12, 0x42, 0xf4, 0x15, 0x16, 0x17 };
+	ut8 data_comp[sizeof(data_tree)];
+	memcpy(data_comp, data_tree, sizeof(data_tree));
+	RzILVM *vm_tree = compiled_test_vm(data_tree, sizeof(data_tree), r0, r1);
+	RzILVM *vm_comp = compiled_test_vm(data_comp, sizeof(data_comp), r0, r1);
+
+	RzILCompiledEffect *code = rz_il_compile_effect(vm_comp, op);
+	mu_assert_notnull(code, "compiled");
+	bool succ_tree = rz_il_vm_step(vm_tree, op, 0x102);
+	bool succ_comp = rz_il_vm_step_compiled(vm_comp, code, 0x102);
+	mu_assert_eq(succ_comp, succ_tree, "step success");
+	char *state_tree = compiled_test_state(vm_tree);
+	char *state_comp = compiled_test_state(vm_comp);
+	mu_assert_streq(state_comp, state_tree, "state and events");
+	mu_assert_memeq(data_comp, data_tree, sizeof(data_tree), "memory");
+
+	free(state_tree);
+	free(state_comp);
+	rz_il_compiled_effect_free(code);
+	rz_il_vm_free(vm_tree);
+	rz_il_vm_free(vm_comp);
+	return true;
+}
+
+#define VAR(name)      rz_il_op_new_var(name, RZ_IL_VAR_KIND_GLOBAL)
+#define LVAR(name)     rz_il_op_new_var(name, RZ_IL_VAR_KIND_LOCAL)
+#define LET_VAR(name)  rz_il_op_new_var(name, RZ_IL_VAR_KIND_LOCAL_PURE)
+#define BV(len, v)     rz_il_op_new_bitv_from_ut64(len, v)
+#define SET(name, val) rz_il_op_new_set(name, false, val)
+
+static RzILOpEffect *compiled_test_op(size_t i) {
+	switch (i) {
+	case 0:
+		return SET("r0", rz_il_op_new_add(VAR("r0"), rz_il_op_new_mul(VAR("r1"), BV(32, 3))));
+	case 1:
+		return rz_il_op_new_seqn(4,
+			SET("r0", rz_il_op_new_div(VAR("r0"), VAR("r1"))),
+			SET("r1", rz_il_op_new_mod(VAR("r0"), VAR("r1"))),
+			SET("f", rz_il_op_new_sle(VAR("r0"), VAR("r1"))),
+			SET("r2", rz_il_op_new_unsigned(8, rz_il_op_new_sdiv(VAR("r1"), VAR("r0")))));
+	case 2:
+		return rz_il_op_new_seqn(4,
+			SET("r2", rz_il_op_new_unsigned(8, rz_il_op_new_mod(VAR("r0"), VAR("r1")))),
+			SET("r0", rz_il_op_new_smod(VAR("r0"), VAR("r1"))),
+			SET("r1", rz_il_op_new_sub(rz_il_op_new_neg(VAR("r1")), rz_il_op_new_log_not(VAR("r0")))),
+			SET("f", rz_il_op_new_bool_xor(rz_il_op_new_msb(VAR("r0")), rz_il_op_new_lsb(VAR("r1")))));
+	case 3:
+		return rz_il_op_new_seqn(3,
+			SET("r0", rz_il_op_new_shiftl(rz_il_op_new_b1(), VAR("r0"), VAR("r1"))),
+			SET("r1", rz_il_op_new_shiftr_arith(VAR("r1"), rz_il_op_new_unsigned(32, VAR("r2")))),
+			SET("r2", rz_il_op_new_unsigned(8, rz_il_op_new_shiftr(rz_il_op_new_b0(), VAR("r0"), BV(32, 24)))));
+	case 4:
+		return rz_il_op_new_seqn(3,
+			SET("r2", rz_il_op_new_load(0, rz_il_op_new_unsigned(16, rz_il_op_new_log_and(VAR("r0"), BV(32, 7))))),
+			rz_il_op_new_storew(0, BV(16, 2), rz_il_op_new_loadw(0, BV(16, 4), 16)),
+			SET("r1", rz_il_op_new_signed(32, rz_il_op_new_append(VAR("r2"), rz_il_op_new_load(0, BV(16, 1))))));
+	case 5:
+		return rz_il_op_new_seqn(2,
+			rz_il_op_new_set("t", true, rz_il_op_new_log_xor(VAR("r0"), VAR("r1"))),
+			rz_il_op_new_branch(rz_il_op_new_ule(LVAR("t"), BV(32, 0x1000)),
+				SET("r0", rz_il_op_new_let("x", rz_il_op_new_add(LVAR("t"), BV(32, 1)),
+					rz_il_op_new_log_or(LET_VAR("x"), rz_il_op_new_let("x", BV(32, 0x100), LET_VAR("x"))))),
+				rz_il_op_new_jmp(rz_il_op_new_unsigned(16, LVAR("t")))));
+	case 6:
+		return rz_il_op_new_seqn(2,
+			SET("f", rz_il_op_new_bool_or(rz_il_op_new_is_zero(VAR("r1")), rz_il_op_new_bool_inv(rz_il_op_new_eq(VAR("r0"), VAR("r1"))))),
+			SET("r0", rz_il_op_new_ite(VAR("f"), rz_il_op_new_sub(VAR("r0"), VAR("r1")), rz_il_op_new_cast(32, VAR("f"), VAR("r2")))));
+	case 7:
+		return rz_il_op_new_seqn(2,
+			SET("r2", BV(8, 0)),
+			rz_il_op_new_repeat(rz_il_op_new_bool_and(rz_il_op_new_non_zero(VAR("r1")), rz_il_op_new_ult(VAR("r2"), BV(8, 40))),
+				rz_il_op_new_seqn(2,
+					SET("r1", rz_il_op_new_shiftr(rz_il_op_new_b0(), VAR("r1"), BV(32, 1))),
+					SET("r2", rz_il_op_new_add(VAR("r2"), BV(8, 1))))));
+	case 8:
+		return rz_il_op_new_seqn(2,
+			rz_il_op_new_blk("lbl", SET("r0", VAR("r1")), rz_il_op_new_nop()),
+			rz_il_op_new_branch(VAR("f"), rz_il_op_new_goto("lbl"), NULL));
+	default:
+		return NULL;
+	}
+}
+
+#undef VAR
+#undef LVAR
+#undef LET_VAR
+#undef BV
+#undef SET
+
+static bool test_rzil_vm_compiled() {
+	const ut64 operands[][2] = {
+		{ 0, 0 },
+		{ 1, 0 },
+		{ 0x1234, 7 },
+		{ 0xfffffff0, 3 },
+		{ 5, 0xfffffffe },
+		{ 0x80000000, 0xffffffff },
+		{ 0xfffffff9, 0xfffffffd },
+		{ 0xdeadbeef, 33 },
+	};
+	RzILOpEffect *op;
+	for (size_t i = 0; (op = compiled_test_op(i)); i++) {
+		bool match = true;
+		for (size_t j = 0; match && j < RZ_ARRAY_SIZE(operands); j++) {
+			match = compiled_matches_tree(op, operands[j][0], operands[j][1]);
+		}
+		bool random_match = true;
+		ut64 seed = 0x5eed + i;
+		for (size_t j = 0; random_match && j < 64; j++) {
+			seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			ut64 r0 = seed >> 32;
+			seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			ut64 r1 = (seed >> 32) >> (j % 32);
+			random_match = compiled_matches_tree(op, r0, r1);
+		}
+		rz_il_op_effect_free(op);
+		mu_assert_true(match, "compiled matches tree");
+		mu_assert_true(random_match, "compiled matches tree (random)");
+	}
+	mu_end;
+}
+
+static bool test_rzil_vm_compiled_unsupported() {
+	RzILVM *vm = rz_il_vm_new(0, 16, false);
+	rz_il_vm_create_global_var(vm, "r0", rz_il_sort_pure_bv(32));
+	rz_il_vm_create_global_var(vm, "q", rz_il_sort_pure_bv(128));
+
+	// ill-typed
+	RzILOpEffect *op = rz_il_op_new_set("r0", false, rz_il_op_new_bitv_from_ut64(16, 1));
+	mu_assert_null(rz_il_compile_effect(vm, op), "ill-typed");
+	rz_il_op_effect_free(op);
+
+	// too large for native arithmetic
+	op = rz_il_op_new_set("q", false, rz_il_op_new_var("q", RZ_IL_VAR_KIND_GLOBAL));
+	mu_assert_null(rz_il_compile_effect(vm, op), "128 bits");
+	rz_il_op_effect_free(op);
+
+	// local vars can't be shared with the tree evaluator
+	op = rz_il_op_new_seqn(2,
+		rz_il_op_new_set("t", true, rz_il_op_new_bitv_from_ut64(32, 1)),
+		rz_il_op_new_blk("lbl", rz_il_op_new_set("r0", false, rz_il_op_new_var("t", RZ_IL_VAR_KIND_LOCAL)), rz_il_op_new_nop()));
+	mu_assert_null(rz_il_compile_effect(vm, op), "locals with fallback");
+	rz_il_op_effect_free(op);
+
+	rz_il_vm_free(vm);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_rzil_vm_init);
 	mu_run_test(test_rzil_vm_global_vars);
@@ -894,6 +1079,8 @@ bool all_tests() {
 	mu_run_test(test_rzil_vm_op_shiftr);
 	mu_run_test(test_rzil_vm_op_shiftl);
 	mu_run_test(test_rzil_vm_op_compare);
+	mu_run_test(test_rzil_vm_compiled);
+	mu_run_test(test_rzil_vm_compiled_unsupported);
 	return tests_passed != tests_run;
 }
 
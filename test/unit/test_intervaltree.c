@@ -325,6 +325,90 @@ bool test_rz_interval_tree_resize_end_only() {
 	return test_rz_interval_tree_resize(true);
 }
 
+static int black_height(RBNode *node) {
+	if (!node) {
+		return 1;
+	}
+	int left = black_height(node->child[0]);
+	int right = black_height(node->child[1]);
+	if (left < 0 || left != right) {
+		return -1;
+	}
+	if (node->red && ((node->child[0] && node->child[0]->red) || (node->child[1] && node->child[1]->red))) {
+		return -1;
+	}
+	return left + !node->red;
+}
+
+static int entry_start_cmp(const void *a, const void *b) {
+	const RzIntervalTreeEntry *x = a, *y = b;
+	return x->start < y->start ? -1 : (x->start > y->start ? 1 : 0);
+}
+
+bool test_rz_interval_tree_bulk_load() {
+	static const size_t counts[] = { 0, 1, 2, 3, 7, 8, 100, N };
+	TestEntry entries[N];
+	RzIntervalTreeEntry items[N];
+	for (size_t c = 0; c < RZ_ARRAY_SIZE(counts); c++) {
+		size_t count = counts[c];
+		random_entries(entries);
+		for (size_t i = 0; i < count; i++) {
+			items[i].start = entries[i].start;
+			items[i].end = entries[i].end;
+			items[i].data = entries + i;
+		}
+		qsort(items, count, sizeof(items[0]), entry_start_cmp);
+
+		RzIntervalTree tree;
+		rz_interval_tree_init(&tree, free_cb);
+		mu_assert_true(rz_interval_tree_bulk_load(&tree, items, count), "bulk load success");
+		if (!check_invariants(tree.root)) {
+			return false;
+		}
+		mu_assert_true(!tree.root || !tree.root->node.red, "root is black");
+		mu_assert_true(black_height(tree.root ? &tree.root->node : NULL) > 0, "red-black invariants");
+
+		for (size_t i = 0; i < SAMPLES; i++) {
+			ut64 value = rand() % (2 * MAXVAL);
+			rz_interval_tree_all_in(&tree, value, true, probe_cb, NULL);
+			for (size_t j = 0; j < count; j++) {
+				if (value >= entries[j].start && value <= entries[j].end) {
+					entries[j].counter--;
+				}
+			}
+		}
+		for (size_t j = 0; j < count; j++) {
+			mu_assert_eq(entries[j].counter, 0, "counter 0 after reference check");
+		}
+
+		// the tree keeps working as a regular red-black tree
+		for (size_t i = 0; i < count / 2; i++) {
+			RzIntervalNode *node = rz_interval_tree_node_at_data(&tree, entries[i].start, entries + i);
+			mu_assert_notnull(node, "node not null");
+			mu_assert_true(rz_interval_tree_delete(&tree, node, true), "delete success");
+		}
+		TestEntry extra = { .start = 42, .end = 4242 };
+		rz_interval_tree_insert(&tree, extra.start, extra.end, &extra);
+		if (!check_invariants(tree.root)) {
+			return false;
+		}
+		mu_assert_true(black_height(&tree.root->node) > 0, "red-black invariants after changes");
+		rz_interval_tree_fini(&tree);
+	}
+
+	// unsorted entries are inserted one by one
+	RzIntervalTree tree;
+	rz_interval_tree_init(&tree, NULL);
+	RzIntervalTreeEntry unsorted[] = { { 10, 20, NULL }, { 5, 6, (void *)0x1337 }, { 30, 30, NULL } };
+	mu_assert_true(rz_interval_tree_bulk_load(&tree, unsorted, RZ_ARRAY_SIZE(unsorted)), "bulk load success");
+	if (!check_invariants(tree.root)) {
+		return false;
+	}
+	mu_assert_ptreq(rz_interval_tree_at(&tree, 5), (void *)0x1337, "at data");
+	rz_interval_tree_fini(&tree);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_interval_tree_insert_at);
 	mu_run_test(test_rz_interval_tree_in_end_exclusive_point);
@@ -336,6 +420,7 @@ int all_tests() {
 	mu_run_test(test_rz_interval_tree_delete);
 	mu_run_test(test_rz_interval_tree_resize_start_and_end);
 	mu_run_test(test_rz_interval_tree_resize_end_only);
+	mu_run_test(test_rz_interval_tree_bulk_load);
 	return tests_passed != tests_run;
 }
 
@@ -41,10 +41,12 @@ bool test_rz_io_cache(void) {
 	io->cached = RZ_PERM_R;
 	rz_io_read_at(io, 0, buf, sizeof(buf));
 	mu_assert_memeq(buf, (ut8 *)"FFFFFFFFFFFFFFF", sizeof(buf), "IO read with cache doesn't match expected output");
-	rz_io_cache_invalidate(io, 6, 1);
-	memset(buf, 'Z', sizeof(buf));
+	mu_assert_eq(rz_io_cache_invalidate(io, 6, 7), 1, "All writes should have been merged together");
+	memset(buf, 'F', sizeof(buf));
 	rz_io_read_at(io, 0, buf, sizeof(buf));
-	mu_assert_memeq(buf, (ut8 *)"ABAACDZZEFGBBBB", sizeof(buf), "IO read after cache invalidate doesn't match expected output");
+	mu_assert_memeq(buf, (ut8 *)"ZZZZZZZZZZZZZZZ", sizeof(buf), "IO read after cache invalidate doesn't match expected output");
+	mu_assert_true(rz_io_cache_write(io, 0, (ut8 *)"ABAACD", 6), "Cache write at 0 failed");
+	mu_assert_true(rz_io_cache_write(io, 8, (ut8 *)"EFGBBBB", 7), "Cache write at 8 failed");
 	rz_io_cache_commit(io, 0, 15);
 	memset(buf, 'Z', sizeof(buf));
 	io->cached = 0;
@@ -58,6 +60,49 @@ bool test_rz_io_cache(void) {
 	mu_end;
 }
 
+bool test_rz_io_cache_coalesce(void) {
+	RzIO *io = rz_io_new();
+	rz_io_open(io, "malloc://16", RZ_PERM_RW, 0);
+	rz_io_write(io, (ut8 *)"ZZZZZZZZZZZZZZZZ", 16);
+	io->cached = RZ_PERM_RW;
+	rz_io_write_at(io, 2, (ut8 *)"AB", 2);
+	rz_io_write_at(io, 6, (ut8 *)"CD", 2);
+	rz_io_write_at(io, 12, (ut8 *)"EF", 2);
+	rz_io_write_at(io, 4, (ut8 *)"GH", 2);
+	rz_io_write_at(io, 3, (ut8 *)"IJKLM", 5);
+	ut8 buf[16];
+	rz_io_read_at(io, 0, buf, sizeof(buf));
+	mu_assert_memeq(buf, (ut8 *)"ZZAIJKLMZZZZEFZZ", sizeof(buf), "cached data");
+	RBIter it;
+	RzIOCache *c;
+	int n = 0;
+	rz_rbtree_foreach (io->cache, it, c, RzIOCache, rb) {
+		n++;
+	}
+	mu_assert_eq(n, 2, "touching writes are merged");
+	it = rz_rbtree_first(io->cache);
+	c = rz_rbtree_iter_get(&it, RzIOCache, rb);
+	mu_assert_eq(rz_itv_begin(c->itv), 2, "merged extent begin");
+	mu_assert_eq(rz_itv_size(c->itv), 6, "merged extent size");
+	mu_assert_memeq(c->odata, (ut8 *)"ZZZZZZ", 6, "original data is kept once");
+
+	mu_assert_true(rz_io_cache_push(io), "push");
+	rz_io_write_at(io, 0, (ut8 *)"XXXXXXXXXXXXXXXX", 16);
+	rz_io_read_at(io, 0, buf, sizeof(buf));
+	mu_assert_memeq(buf, (ut8 *)"XXXXXXXXXXXXXXXX", sizeof(buf), "cached data after push");
+	mu_assert_true(rz_io_cache_pop(io), "pop");
+	mu_assert_false(rz_io_cache_pop(io), "nothing left to pop");
+	rz_io_read_at(io, 0, buf, sizeof(buf));
+	mu_assert_memeq(buf, (ut8 *)"ZZAIJKLMZZZZEFZZ", sizeof(buf), "cached data after pop");
+
+	rz_io_cache_commit(io, 0, 8);
+	io->cached = 0;
+	rz_io_read_at(io, 0, buf, sizeof(buf));
+	mu_assert_memeq(buf, (ut8 *)"ZZAIJKLMZZZZZZZZ", sizeof(buf), "committed data");
+	rz_io_free(io);
+	mu_end;
+}
+
 bool test_rz_io_mapsplit(void) {
 	RzIO *io = rz_io_new();
 	io->va = true;
@@ -135,6 +180,135 @@ bool test_rz_io_maps_vector(void) {
 	mu_end;
 }
 
+bool test_rz_io_map_get_range(void) {
+	RzIO *io = rz_io_new();
+	io->va = true;
+	rz_io_open_at(io, "malloc://0x100", RZ_PERM_RW, 0644, 0x1000, NULL);
+	RzIOMap *big = rz_io_map_get(io, 0x1000);
+	mu_assert_notnull(big, "big map");
+	RzInterval range;
+	mu_assert_ptreq(rz_io_map_get_range(io, 0x1080, &range), big, "map at 0x1080");
+	mu_assert_eq(range.addr, 0x1000, "range start");
+	mu_assert_eq(range.size, 0x100, "range size");
+
+	// the cached part must not survive the new map shadowing its middle
+	rz_io_open_at(io, "malloc://0x10", RZ_PERM_RW, 0644, 0x1040, NULL);
+	RzIOMap *small = rz_io_map_get(io, 0x1040);
+	mu_assert_ptrneq(small, big, "small map on top");
+	mu_assert_ptreq(rz_io_map_get_range(io, 0x1080, &range), big, "big map after the small one");
+	mu_assert_eq(range.addr, 0x1050, "range start after the small map");
+	mu_assert_eq(range.size, 0xb0, "range size after the small map");
+	mu_assert_ptreq(rz_io_map_get_range(io, 0x1000, &range), big, "big map before the small one");
+	mu_assert_eq(range.size, 0x40, "range size before the small map");
+
+	ut8 buf[0x20];
+	memset(buf, 0xcc, sizeof(buf));
+	rz_io_write_at(io, 0x1030, buf, sizeof(buf));
+	ut8 out[0x20];
+	mu_assert_true(rz_io_read_at(io, 0x1030, out, sizeof(out)), "read across the maps");
+	mu_assert_memeq(out, buf, sizeof(buf), "data across the maps");
+
+	rz_io_map_del(io, small->id);
+	mu_assert_ptreq(rz_io_map_get_range(io, 0x1044, &range), big, "big map again");
+	mu_assert_eq(range.size, 0x100, "whole range again");
+	mu_assert_null(rz_io_map_get_range(io, 0x1100, &range), "nothing after the map");
+
+	rz_io_free(io);
+	mu_end;
+}
+
+bool test_rz_io_readv(void) {
+	RzIO *io = rz_io_new();
+	io->va = true;
+	io->ff = 1;
+	io->Oxff = 0xff;
+	ut8 data[0x100];
+	for (int i = 0; i < sizeof(data); i++) {
+		data[i] = i;
+	}
+	rz_io_open_at(io, "malloc://0x100", RZ_PERM_RW, 0644, 0x1000, NULL);
+	rz_io_write_at(io, 0x1000, data, sizeof(data));
+	rz_io_open_at(io, "malloc://0x10", RZ_PERM_RW, 0644, 0x2000, NULL);
+	rz_io_write_at(io, 0x2000, (const ut8 *)"0123456789abcdef", 0x10);
+
+	ut8 a[4], b[8], c[8], d[4], e[4];
+	RzIOVec vecs[] = {
+		{ 0x2004, a, sizeof(a) },
+		{ 0x1014, c, sizeof(c) },
+		{ 0x1010, b, sizeof(b) }, // overlaps the previous one
+		{ 0x1030, d, sizeof(d) }, // close enough to be read together
+		{ 0x3000, NULL, 0 },
+	};
+	mu_assert_true(rz_io_readv(io, vecs, RZ_ARRAY_SIZE(vecs)), "readv");
+	mu_assert_memeq(a, (const ut8 *)"4567", sizeof(a), "range in the second map");
+	mu_assert_memeq(b, data + 0x10, sizeof(b), "first overlapping range");
+	mu_assert_memeq(c, data + 0x14, sizeof(c), "second overlapping range");
+	mu_assert_memeq(d, data + 0x30, sizeof(d), "close range");
+
+	RzIOVec partial[] = {
+		{ 0x10fe, e, sizeof(e) },
+		{ 0x1000, d, sizeof(d) },
+	};
+	mu_assert_true(rz_io_readv(io, partial, RZ_ARRAY_SIZE(partial)), "readv past the map");
+	mu_assert_memeq(e, (const ut8 *)"\xfe\xff\xff\xff", sizeof(e), "unmapped bytes");
+	mu_assert_memeq(d, data, sizeof(d), "range before");
+
+	rz_io_free(io);
+	mu_end;
+}
+
+bool test_rz_io_readahead(void) {
+	RzIO *io = rz_io_new();
+	io->va = true;
+	io->ff = 1;
+	io->Oxff = 0xff;
+	ut8 data[0x400];
+	for (int i = 0; i < sizeof(data); i++) {
+		data[i] = i * 7;
+	}
+	rz_io_open_at(io, "malloc://0x400", RZ_PERM_RW, 0644, 0x1000, NULL);
+	rz_io_write_at(io, 0x1000, data, sizeof(data));
+
+	// the range goes past the map, the gap must read as with io.ff
+	mu_assert_true(rz_io_readahead_start(io, 0x1000, 0x1420, 0x40, 4, NULL, NULL), "start");
+	ut8 buf[0x30];
+	for (ut64 at = 0x1000; at < 0x1400; at += sizeof(buf)) {
+		int len = RZ_MIN(sizeof(buf), 0x1400 - at);
+		mu_assert_true(rz_io_read_at(io, at, buf, len), "sequential read");
+		mu_assert_memeq(buf, data + at - 0x1000, len, "sequential data");
+	}
+	mu_assert_true(rz_io_read_at(io, 0x1010, buf, 8), "read before the window");
+	mu_assert_memeq(buf, data + 0x10, 8, "data before the window");
+	mu_assert_true(rz_io_read_at(io, 0x13fc, buf, 8), "read past the map");
+	mu_assert_memeq(buf, (const ut8 *)"\xe4\xeb\xf2\xf9\xff\xff\xff\xff", 8, "unmapped bytes");
+
+	// writes drop the blocks already read
+	mu_assert_true(rz_io_read_at(io, 0x1100, buf, 8), "read");
+	mu_assert_true(rz_io_write_at(io, 0x1104, (const ut8 *)"rizin", 5), "write");
+	mu_assert_true(rz_io_read_at(io, 0x1100, buf, 9), "read after write");
+	mu_assert_memeq(buf + 4, (const ut8 *)"rizin", 5, "written data");
+	mu_assert_memeq(buf, data + 0x100, 4, "data before the write");
+
+	// so do the writes to the desc behind the map
+	mu_assert_true(rz_io_read_at(io, 0x1200, buf, 8), "read");
+	mu_assert_eq(rz_io_fd_write_at(io, io->desc->fd, 0x204, (const ut8 *)"rz", 2), 2, "fd write");
+	mu_assert_true(rz_io_read_at(io, 0x1200, buf, 8), "read after fd write");
+	mu_assert_memeq(buf + 4, (const ut8 *)"rz", 2, "data written to the fd");
+	mu_assert_memeq(buf, data + 0x200, 4, "data before the fd write");
+
+	// bigger than the ring
+	ut8 big[0x200];
+	mu_assert_true(rz_io_read_at(io, 0x1000, big, sizeof(big)), "big read");
+	mu_assert_memeq(big, data, 0x100, "big read data");
+
+	rz_io_readahead_stop(io);
+	mu_assert_null(io->readahead, "stopped");
+	mu_assert_true(rz_io_read_at(io, 0x1104, buf, 5), "read after stop");
+	mu_assert_memeq(buf, (const ut8 *)"rizin", 5, "data after stop");
+	rz_io_free(io);
+	mu_end;
+}
+
 bool test_rz_io_pcache(void) {
 	RzIO *io = rz_io_new();
 	io->ff = 1;
@@ -165,6 +339,120 @@ bool test_rz_io_pcache(void) {
 	mu_end;
 }
 
+bool test_rz_io_page_cache(void) {
+	RzIO *io = rz_io_new();
+	io->va = true;
+	rz_io_page_cache_enable(io, true);
+	RzIODesc *desc = rz_io_open_at(io, "malloc://0x3000", RZ_PERM_RW, 0, 0x1000, NULL);
+	mu_assert_notnull(desc, "open");
+	ut8 buf[0x10];
+	mu_assert_true(rz_io_read_at(io, 0x1ffc, buf, 8), "read across pages");
+	mu_assert_eq(io->page_cache.misses, 2, "two pages loaded");
+	mu_assert_eq(io->page_cache.count, 2, "two pages cached");
+	mu_assert_true(rz_io_read_at(io, 0x1000, buf, 8), "read first page again");
+	mu_assert_eq(io->page_cache.hits, 1, "first page hit");
+	mu_assert_eq(io->page_cache.misses, 2, "no more misses");
+
+	mu_assert_true(rz_io_write_at(io, 0x1002, (const ut8 *)"ABCD", 4), "write");
+	mu_assert_eq(io->page_cache.count, 1, "written page invalidated");
+	memset(buf, 0, sizeof(buf));
+	mu_assert_true(rz_io_read_at(io, 0x1000, buf, 8), "read after write");
+	mu_assert_memeq(buf, (const ut8 *)"\0\0ABCD\0\0", 8, "written data visible");
+
+	// reads that go beyond the end of the file are short
+	int r = rz_io_desc_read_at(desc, 0x2ffc, buf, 8);
+	mu_assert_eq(r, 4, "read up to EOF");
+
+	rz_io_page_cache_set_max_pages(io, 1);
+	mu_assert_eq(io->page_cache.count, 1, "evicted down to one page");
+	mu_assert_true(rz_io_read_at(io, 0x2000, buf, 8), "read another page");
+	mu_assert_eq(io->page_cache.count, 1, "bounded");
+	ut64 misses = io->page_cache.misses;
+	mu_assert_true(rz_io_read_at(io, 0x2000, buf, 8), "read most recently used page");
+	mu_assert_eq(io->page_cache.misses, misses, "still cached");
+
+	rz_io_page_cache_enable(io, false);
+	mu_assert_eq(io->page_cache.count, 0, "disabling drops all pages");
+	mu_assert_true(rz_io_read_at(io, 0x1000, buf, 8), "uncached read");
+	mu_assert_memeq(buf, (const ut8 *)"\0\0ABCD\0\0", 8, "same data without cache");
+	rz_io_free(io);
+	mu_end;
+}
+
+static ut8 dbg_mem[0x2000];
+static ut64 dbg_gen;
+
+static bool dbg_check(RzIO *io, const char *path, bool many) {
+	return !strcmp(path, "dbgmem://");
+}
+
+static RzIODesc *dbg_open(RzIO *io, const char *path, int perm, int mode);
+
+static int dbg_read(RzIO *io, RzIODesc *desc, ut8 *buf, int len) {
+	if (io->off >= sizeof(dbg_mem)) {
+		return -1;
+	}
+	len = RZ_MIN(len, sizeof(dbg_mem) - io->off);
+	memcpy(buf, dbg_mem + io->off, len);
+	return len;
+}
+
+static ut64 dbg_lseek(RzIO *io, RzIODesc *desc, ut64 offset, int whence) {
+	return whence == RZ_IO_SEEK_SET ? io->off = offset : io->off;
+}
+
+static ut64 dbg_generation(RzIODesc *desc) {
+	return dbg_gen;
+}
+
+static RzIOPlugin dbg_plugin = {
+	.name = "dbgmem",
+	.uris = "dbgmem://",
+	.check = dbg_check,
+	.open = dbg_open,
+	.read = dbg_read,
+	.lseek = dbg_lseek,
+	.generation = dbg_generation,
+	.isdbg = true
+};
+
+static RzIODesc *dbg_open(RzIO *io, const char *path, int perm, int mode) {
+	return rz_io_desc_new(io, &dbg_plugin, path, perm, mode, NULL);
+}
+
+bool test_rz_io_page_cache_generation(void) {
+	RzIO *io = rz_io_new();
+	rz_io_plugin_add(io, &dbg_plugin);
+	rz_io_page_cache_enable(io, true);
+	RzIODesc *desc = rz_io_open_at(io, "dbgmem://", RZ_PERM_R, 0, 0, NULL);
+	mu_assert_notnull(desc, "open");
+	ut8 buf[4];
+	memcpy(dbg_mem + 0x1000, "AAAA", 4);
+	mu_assert_true(rz_io_read_at(io, 0x1000, buf, 4), "read");
+	mu_assert_eq(io->page_cache.misses, 1, "page loaded");
+
+	// the target changed its memory while stopped, that can't happen
+	memcpy(dbg_mem + 0x1000, "BBBB", 4);
+	mu_assert_true(rz_io_read_at(io, 0x1000, buf, 4), "read again");
+	mu_assert_memeq(buf, (const ut8 *)"AAAA", 4, "served from the cache");
+	mu_assert_eq(io->page_cache.hits, 1, "hit");
+
+	// the target ran
+	dbg_gen++;
+	mu_assert_true(rz_io_read_at(io, 0x1000, buf, 4), "read after run");
+	mu_assert_memeq(buf, (const ut8 *)"BBBB", 4, "pages of the old generation dropped");
+	mu_assert_eq(io->page_cache.misses, 2, "reloaded");
+
+	// debug plugins that can't tell when their target ran are not cached
+	dbg_plugin.generation = NULL;
+	ut64 misses = io->page_cache.misses;
+	mu_assert_true(rz_io_read_at(io, 0x1000, buf, 4), "read without generation");
+	mu_assert_eq(io->page_cache.misses, misses, "cache bypassed");
+	dbg_plugin.generation = dbg_generation;
+	rz_io_free(io);
+	mu_end;
+}
+
 bool test_rz_io_desc_exchange(void) {
 	RzIO *io = rz_io_new();
 	int fd = rz_io_fd_open(io, "malloc://3", RZ_PERM_R, 0),
@@ -632,11 +920,17 @@ bool test_rz_io_map_del_on_close_all(void) {
 
 bool all_tests(void) {
 	mu_run_test(test_rz_io_cache);
+	mu_run_test(test_rz_io_cache_coalesce);
 	mu_run_test(test_rz_io_mapsplit);
 	mu_run_test(test_rz_io_mapsplit2);
 	mu_run_test(test_rz_io_mapsplit3);
 	mu_run_test(test_rz_io_maps_vector);
+	mu_run_test(test_rz_io_map_get_range);
+	mu_run_test(test_rz_io_readv);
+	mu_run_test(test_rz_io_readahead);
 	mu_run_test(test_rz_io_pcache);
+	mu_run_test(test_rz_io_page_cache);
+	mu_run_test(test_rz_io_page_cache_generation);
 	mu_run_test(test_rz_io_desc_exchange);
 	mu_run_test(test_rz_io_priority);
 	mu_run_test(test_rz_io_priority2);
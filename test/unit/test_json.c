@@ -1029,6 +1029,25 @@ static int check_expected_60(RzJson *j) {
 	return MU_PASSED;
 }
 
+static int check_expected_61(RzJson *j) {
+	mu_assert_eq(j->type, RZ_JSON_OBJECT, "object type");
+	mu_assert_eq(j->children.count, 20, "object size");
+	char key[16];
+	for (int i = 0; i < 18; i++) {
+		snprintf(key, sizeof(key), "key%d", i);
+		const RzJson *v = rz_json_get(j, key);
+		mu_assert_notnull(v, key);
+		mu_assert_eq(v->num.u_value, i, "member value");
+	}
+	mu_assert_null(rz_json_get(j, "key"), "keys are not matched by prefix");
+	mu_assert_null(rz_json_get(j, "key100"), "missing key");
+	mu_assert_eq(rz_json_get(j, "dup")->num.u_value, 1, "first duplicate wins");
+	mu_assert_eq(rz_json_get_path(j, ".key17")->num.u_value, 17, "path lookup");
+	mu_assert_eq(rz_json_get_path(j, ".dup")->num.u_value, 1, "path lookup of duplicate");
+	mu_assert_null(rz_json_get_path(j, ".key1.x"), "path into an integer");
+	return MU_PASSED;
+}
+
 JsonTest tests[] = {
 	{ // 0
 		"    {\n      \"some-int\": 195,\n      \"array1\": [ 3, 5.1, -7, \"nin"
@@ -1277,6 +1296,12 @@ JsonTest tests[] = {
 	{ // 60
 		"{\n \"bla\": \"foo\"\n}\n",
 		check_expected_60 },
+	{ // 61
+		"{\"key0\": 0, \"key1\": 1, \"key2\": 2, \"key3\": 3, \"key4\": 4, \"key5\": 5, "
+		"\"key6\": 6, \"key7\": 7, \"key8\": 8, \"key9\": 9, \"key10\": 10, \"key11\": 11, "
+		"\"key12\": 12, \"key13\": 13, \"key14\": 14, \"key15\": 15, \"dup\": 1, "
+		"\"key16\": 16, \"dup\": 2, \"key17\": 17}",
+		check_expected_61 },
 };
 
 static int test_json(int test_number, char *input, int (*check)(RzJson *j)) {
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include "minunit.h"
+
+static bool test_mem_account_track(void) {
+	if (!rz_mem_account_enabled()) {
+		mu_end;
+	}
+	RzMemAccountStats before, stats;
+	rz_mem_account_stats(RZ_MEM_ACCOUNT_FLAG, &before);
+
+	char *a = malloc(16);
+	char *b = malloc(32);
+	rz_mem_account_track(RZ_MEM_ACCOUNT_FLAG, a, 16);
+	rz_mem_account_track(RZ_MEM_ACCOUNT_FLAG, b, 32);
+	rz_mem_account_stats(RZ_MEM_ACCOUNT_FLAG, &stats);
+	mu_assert_eq(stats.live_bytes - before.live_bytes, 48, "live bytes");
+	mu_assert_eq(stats.live_objects - before.live_objects, 2, "live objects");
+	mu_assert_eq(stats.total_objects - before.total_objects, 2, "total objects");
+
+	// tracking again resizes without counting another object
+	rz_mem_account_track(RZ_MEM_ACCOUNT_FLAG, b, 64);
+	rz_mem_account_stats(RZ_MEM_ACCOUNT_FLAG, &stats);
+	mu_assert_eq(stats.live_bytes - before.live_bytes, 80, "resized");
+	mu_assert_eq(stats.live_objects - before.live_objects, 2, "still two objects");
+	mu_assert_eq(stats.total_objects - before.total_objects, 2, "still two in total");
+
+	rz_mem_account_untrack(a);
+	rz_mem_account_untrack(a);
+	rz_mem_account_untrack(b);
+	rz_mem_account_stats(RZ_MEM_ACCOUNT_FLAG, &stats);
+	mu_assert_eq(stats.live_bytes, before.live_bytes, "all untracked");
+	mu_assert_eq(stats.live_objects, before.live_objects, "no objects left");
+	mu_assert_eq(stats.total_objects - before.total_objects, 2, "total is kept");
+	mu_assert_true(stats.peak_bytes - before.live_bytes >= 80, "peak");
+	free(a);
+	free(b);
+	mu_end;
+}
+
+static bool test_mem_account_sdb(void) {
+	if (!rz_mem_account_enabled()) {
+		mu_end;
+	}
+	RzMemAccountStats before, stats;
+	rz_mem_account_stats(RZ_MEM_ACCOUNT_SDB, &before);
+	Sdb *db = sdb_new0();
+	sdb_set(db, "key", "value", 0);
+	sdb_set(db, "other", "v", 0);
+	rz_mem_account_stats(RZ_MEM_ACCOUNT_SDB, &stats);
+	mu_assert_eq(stats.live_objects - before.live_objects, 2, "two pairs");
+	ut64 bytes = stats.live_bytes;
+	sdb_set(db, "key", "a much longer value", 0);
+	rz_mem_account_stats(RZ_MEM_ACCOUNT_SDB, &stats);
+	mu_assert_eq(stats.live_objects - before.live_objects, 2, "still two pairs");
+	mu_assert_eq(stats.live_bytes - bytes, strlen("a much longer value") - strlen("value"), "value grew");
+	sdb_unset(db, "other", 0);
+	sdb_free(db);
+	rz_mem_account_stats(RZ_MEM_ACCOUNT_SDB, &stats);
+	mu_assert_eq(stats.live_objects, before.live_objects, "all freed");
+	mu_assert_eq(stats.live_bytes, before.live_bytes, "no bytes left");
+	mu_end;
+}
+
+static bool test_mem_account_names(void) {
+	for (int i = 0; i < RZ_MEM_ACCOUNT_COUNT; i++) {
+		mu_assert_notnull(rz_mem_account_category_name(i), "name");
+	}
+	mu_assert_streq(rz_mem_account_category_name(RZ_MEM_ACCOUNT_IO_CACHE), "io.cache", "io cache name");
+	mu_end;
+}
+
+static int all_tests(void) {
+	mu_run_test(test_mem_account_track);
+	mu_run_test(test_mem_account_sdb);
+	mu_run_test(test_mem_account_names);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
@@ -22,8 +22,62 @@ bool test_pj_reset() {
 	mu_end;
 }
 
+bool test_pj_escape() {
+	PJ *j = pj_new();
+	pj_a(j);
+	pj_s(j, "plain");
+	pj_s(j, "q\"b\\\n\t\x01\x7f");
+	pj_s(j, "\xc3\xa9\xf0\x9f\x98\x80");
+	pj_s(j, "bad\xffutf8");
+	pj_end(j);
+	mu_assert_streq(pj_string(j), "[\"plain\",\"q\\\"b\\\\\\n\\t\\u0001\\u007f\",\"\xc3\xa9\xf0\x9f\x98\x80\",\"badutf8\"]", "escaped strings");
+	pj_free(j);
+	mu_end;
+}
+
+bool test_pj_numbers() {
+	PJ *j = pj_new();
+	pj_a(j);
+	pj_n(j, 0);
+	pj_n(j, UT64_MAX);
+	pj_N(j, INT64_MIN);
+	pj_N(j, -42);
+	pj_i(j, INT32_MIN);
+	pj_i(j, 1337);
+	pj_end(j);
+	mu_assert_streq(pj_string(j), "[0,18446744073709551615,-9223372036854775808,-42,-2147483648,1337]", "numbers");
+	pj_free(j);
+	mu_end;
+}
+
+static void sink_cb(void *user, const char *s, size_t len) {
+	rz_strbuf_append_n(user, s, len);
+}
+
+bool test_pj_sink() {
+	RzStrBuf out;
+	rz_strbuf_init(&out);
+	PJ *j = pj_new();
+	pj_set_sink(j, sink_cb, &out, 16);
+	pj_o(j);
+	pj_ks(j, "name", "entry0");
+	mu_assert_true(rz_strbuf_length(&out) > 0, "flushed past the threshold");
+	mu_assert_true(strlen(pj_string(j)) < 16, "only the tail is buffered");
+	pj_kn(j, "addr", 0x1000);
+	pj_end(j);
+	pj_flush(j);
+	mu_assert_streq(pj_string(j), "", "nothing left after flush");
+	mu_assert_streq(rz_strbuf_get(&out), "{\"name\":\"entry0\",\"addr\":4096}", "sink got the whole document");
+	pj_free(j);
+	rz_strbuf_fini(&out);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_pj_reset);
+	mu_run_test(test_pj_escape);
+	mu_run_test(test_pj_numbers);
+	mu_run_test(test_pj_sink);
 	return tests_passed != tests_run;
 }
 
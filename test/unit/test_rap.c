@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_core.h>
+#include <rz_socket.h>
+#include "minunit.h"
+
+#define RAP_PORT  "19561"
+#define FILE_SIZE 0x5123
+
+typedef struct {
+	RzCore *core;
+	RzIODesc *listener;
+} RapServer;
+
+static void *serve_th(void *user) {
+	RapServer *srv = user;
+	rz_core_serve(srv->core, srv->listener);
+	return NULL;
+}
+
+static RzSocket *connect_client(void) {
+	RzSocket *s = rz_socket_new(false);
+	if (s && !rz_socket_connect_tcp(s, "127.0.0.1", RAP_PORT, 0)) {
+		rz_socket_free(s);
+		return NULL;
+	}
+	return s;
+}
+
+static bool test_rap_loopback(void) {
+	ut8 *data = malloc(FILE_SIZE);
+	ut8 *buf = malloc(FILE_SIZE);
+	mu_assert("alloc", data && buf);
+	for (size_t i = 0; i < FILE_SIZE; i++) {
+		data[i] = i * 13 + (i >> 8);
+	}
+	char *path = rz_file_temp("rap");
+	mu_assert_true(rz_file_dump(path, data, FILE_SIZE, false), "write the served file");
+
+	// what "=:" runs, listening before any client connects
+	RzCore *srv = rz_core_new();
+	rz_config_set_b(srv->config, "rap.loop", true);
+	RapServer server = { srv, rz_io_open_nomap(srv->io, "rap://:" RAP_PORT, RZ_PERM_RW, 0644) };
+	mu_assert_notnull(server.listener, "listen");
+	RzThread *th = rz_th_new(serve_th, &server);
+	mu_assert_notnull(th, "server thread");
+
+	// an old client, without RAP_OPEN_CAPS
+	RzSocket *s = connect_client();
+	mu_assert_notnull(s, "connect");
+	int fd = rz_socket_rap_client_open(s, path, RZ_PERM_R);
+	mu_assert_eq(fd, rz_io_fd_get_current(srv->io), "fd of the file opened by the server");
+	memset(buf, 0, FILE_SIZE);
+	mu_assert_eq(rz_socket_rap_client_read_at(s, 0, 0, buf, FILE_SIZE), FILE_SIZE, "read without caps");
+	mu_assert_memeq(buf, data, FILE_SIZE, "data read without caps");
+	rz_socket_free(s);
+
+	s = connect_client();
+	mu_assert_notnull(s, "reconnect");
+	ut32 caps = 0;
+	fd = rz_socket_rap_client_open_caps(s, path, RZ_PERM_R, &caps);
+	mu_assert_eq(fd, rz_io_fd_get_current(srv->io), "fd of the file opened by the server");
+	mu_assert_true(caps & RAP_CAP_READV, "server capabilities");
+	memset(buf, 0, FILE_SIZE);
+	mu_assert_eq(rz_socket_rap_client_read_at(s, caps, 0x10, buf, FILE_SIZE - 0x10), FILE_SIZE - 0x10, "read with caps");
+	mu_assert_memeq(buf, data + 0x10, FILE_SIZE - 0x10, "data read with caps");
+	memset(buf, 0, FILE_SIZE);
+	RzSocketRapIov iov[] = {
+		{ .addr = 0x4000, .buf = buf, .len = 0x1000 },
+		{ .addr = 0x7, .buf = buf + 0x1000, .len = 0x2345 },
+	};
+	mu_assert_true(rz_socket_rap_client_readv(s, caps, iov, RZ_ARRAY_SIZE(iov)), "readv");
+	mu_assert_memeq(buf, data + 0x4000, 0x1000, "first range");
+	mu_assert_memeq(buf + 0x1000, data + 0x7, 0x2345, "second range");
+	// the server stops when this client goes away
+	rz_config_set_b(srv->config, "rap.loop", false);
+	rz_socket_free(s);
+
+	rz_th_wait(th);
+	rz_th_free(th);
+	rz_core_free(srv);
+	rz_file_rm(path);
+	free(path);
+	free(buf);
+	free(data);
+	mu_end;
+}
+
+static int all_tests(void) {
+	mu_run_test(test_rap_loopback);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
@@ -170,6 +170,38 @@ bool test_rz_reg_get(void) {
 	mu_end;
 }
 
+bool test_rz_reg_get_any_type(void) {
+	RzReg *reg = rz_reg_new();
+	mu_assert_notnull(reg, "rz_reg_new () failed");
+
+	bool success = rz_reg_set_profile_string(reg,
+		"=PC	eip\n\
+		fpu		dup		.32	304	0\n\
+		gpr		eip		.32	0	0\n\
+		gpr		dup		.32	32	0");
+	mu_assert_true(success, "define eip and dup twice");
+
+	RzRegItem *r = rz_reg_get(reg, "dup", -1);
+	mu_assert_notnull(r, "found dup");
+	mu_assert_eq(r->type, RZ_REG_TYPE_GPR, "the gpr one comes first");
+	r = rz_reg_get(reg, "PC", -1);
+	mu_assert_notnull(r, "found PC");
+	mu_assert_streq(r->name, "eip", "PC resolved to its register");
+	mu_assert_null(rz_reg_get(reg, "eax", -1), "no eax");
+
+	success = rz_reg_set_profile_string(reg,
+		"=PC	rip\n\
+		gpr		rip		.64	0	0");
+	mu_assert_true(success, "define rip");
+	mu_assert_null(rz_reg_get(reg, "eip", -1), "eip is gone with the old profile");
+	r = rz_reg_get(reg, "PC", -1);
+	mu_assert_notnull(r, "found PC");
+	mu_assert_streq(r->name, "rip", "PC resolved to the new register");
+
+	rz_reg_free(reg);
+	mu_end;
+}
+
 bool test_rz_reg_get_list(void) {
 	RzReg *reg;
 	const RzList *l;
@@ -237,6 +269,34 @@ bool test_rz_reg_get_pack(void) {
 	mu_end;
 }
 
+bool test_rz_reg_get_pack_bytes(void) {
+	RzReg *reg = rz_reg_new();
+	mu_assert_notnull(reg, "rz_reg_new () failed");
+	rz_reg_set_profile_string(reg,
+		"xmm    ymm0	.256	0	32\n\
+		xmm    xmm0	.128	0	16\n\
+		gpr    flag	.1	0	0");
+
+	RzRegItem *ymm0 = rz_reg_get(reg, "ymm0", RZ_REG_TYPE_XMM);
+	ut8 lane[16], whole[32];
+	for (int i = 0; i < 16; i++) {
+		lane[i] = i + 1;
+	}
+	mu_assert_true(rz_reg_set_pack_bytes(reg, ymm0, 1, 16, lane), "set upper lane");
+	mu_assert_true(rz_reg_get_pack_bytes(reg, ymm0, 0, 0, whole), "get whole register");
+	const ut8 expect[32] = { 0 };
+	mu_assert_memeq(whole, expect, 16, "lower lane untouched");
+	mu_assert_memeq(whole + 16, lane, 16, "upper lane");
+	mu_assert_eq(rz_reg_get_pack(reg, ymm0, 2, 64), 0x0807060504030201, "same bytes as the packed value");
+
+	mu_assert_false(rz_reg_get_pack_bytes(reg, ymm0, 2, 16, lane), "lane beyond the register");
+	RzRegItem *flag = rz_reg_get(reg, "flag", RZ_REG_TYPE_GPR);
+	mu_assert_false(rz_reg_get_pack_bytes(reg, flag, 0, 0, lane), "not byte sized");
+
+	rz_reg_free(reg);
+	mu_end;
+}
+
 bool test_rz_reg_get_bv(void) {
 	RzReg *reg = rz_reg_new();
 	mu_assert_notnull(reg, "rz_reg_new () failed");
@@ -410,16 +470,44 @@ bool test_rz_reg_set_bv(void) {
 	mu_end;
 }
 
+bool test_rz_reg_arena_push_pop(void) {
+	RzReg *reg = rz_reg_new();
+	mu_assert_notnull(reg, "rz_reg_new () failed");
+	rz_reg_set_profile_string(reg, "gpr eax .32 0 0\ngpr ebx .32 4 0");
+
+	rz_reg_setv(reg, "eax", 0x1234);
+	int depth = rz_reg_arena_push(reg);
+	mu_assert_eq(rz_reg_getv(reg, "eax"), 0x1234, "pushed arena keeps the values");
+	rz_reg_setv(reg, "eax", 0x5678);
+	rz_reg_arena_pop(reg);
+	mu_assert_eq(rz_reg_getv(reg, "eax"), 0x1234, "pop restores the values");
+
+	// the popped arena is reused, its old content must not leak
+	RzRegArena *popped = rz_pvector_tail(reg->regset[RZ_REG_TYPE_GPR].spare);
+	mu_assert_eq(rz_reg_arena_push(reg), depth, "same depth");
+	mu_assert_ptreq(reg->regset[RZ_REG_TYPE_GPR].arena, popped, "arena reused");
+	mu_assert_eq(rz_reg_getv(reg, "eax"), 0x1234, "reused arena holds the current values");
+	rz_reg_setv(reg, "ebx", 1);
+	rz_reg_arena_pop(reg);
+	mu_assert_eq(rz_reg_getv(reg, "ebx"), 0, "pop restores the values");
+
+	rz_reg_free(reg);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_reg_set_name);
 	mu_run_test(test_rz_reg_set_profile_string);
 	mu_run_test(test_rz_reg_get_value_gpr);
 	mu_run_test(test_rz_reg_get_value_flag);
 	mu_run_test(test_rz_reg_get);
+	mu_run_test(test_rz_reg_get_any_type);
 	mu_run_test(test_rz_reg_get_list);
 	mu_run_test(test_rz_reg_get_pack);
+	mu_run_test(test_rz_reg_get_pack_bytes);
 	mu_run_test(test_rz_reg_get_bv);
 	mu_run_test(test_rz_reg_set_bv);
+	mu_run_test(test_rz_reg_arena_push_pop);
 	return tests_passed != tests_run;
 }
 
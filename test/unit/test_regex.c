@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include "minunit.h"
+
+static const char *patterns[] = {
+	"abc",
+	"a.c",
+	"a*",
+	"(ab|cd)+e",
+	"[0-9]+",
+	"[a-z]+[0-9]{2,4}",
+	"x?y*z",
+	"(a|b)*abb",
+	"[^ ]+ [^ ]+",
+	"hello|world|foo",
+	"\\.text",
+	"(aa|a)(bb|b)c",
+	"[[:alpha:]]+[[:digit:]]",
+	"ab{3}",
+	"(x|y)?z+",
+	"^abc",
+	"abc$",
+	"[[:<:]]foo",
+	"(a)\\1",
+};
+
+static const char *texts[] = {
+	"",
+	"abc",
+	"xxabcxxabc",
+	"aaaa",
+	"abcdabcde cdcde",
+	"phone 555-1234 or 0123",
+	"ab12 abc123 abcd12345",
+	"zzz xyyz yz xz",
+	"ababababb aabb",
+	"one two three",
+	"say hello to the world, foo",
+	".data .text .bss",
+	"aabbc abc abbc",
+	"ALPHA9 beta Gamma42",
+	"abbb abbbb ab",
+	"foo abcfoo abc",
+	"aa a",
+};
+
+static bool regex_same(const char *pattern, const char *flags, const char *text, size_t len) {
+	char dfa_flags[8], nodfa_flags[8];
+	snprintf(dfa_flags, sizeof(dfa_flags), "e%s", flags);
+	snprintf(nodfa_flags, sizeof(nodfa_flags), "eD%s", flags);
+	RzRegex *dfa = rz_regex_new(pattern, dfa_flags);
+	RzRegex *nodfa = rz_regex_new(pattern, nodfa_flags);
+	mu_assert_notnull(dfa, pattern);
+	mu_assert_notnull(nodfa, pattern);
+	// walk the text like a search does, so the cache is reused across calls
+	size_t from = 0;
+	while (from <= len) {
+		RzRegexMatch a = { .rm_so = from, .rm_eo = len };
+		RzRegexMatch b = { .rm_so = from, .rm_eo = len };
+		int ra = rz_regex_exec(dfa, text, 1, &a, RZ_REGEX_STARTEND);
+		int rb = rz_regex_exec(nodfa, text, 1, &b, RZ_REGEX_STARTEND);
+		mu_assert_eq(ra, rb, pattern);
+		if (ra) {
+			break;
+		}
+		mu_assert_eq(a.rm_so, b.rm_so, pattern);
+		mu_assert_eq(a.rm_eo, b.rm_eo, pattern);
+		// without the match offsets
+		RzRegexMatch c = { .rm_so = from, .rm_eo = len };
+		RzRegexMatch d = { .rm_so = from, .rm_eo = len };
+		mu_assert_eq(rz_regex_exec(dfa, text, 0, &c, RZ_REGEX_STARTEND), rz_regex_exec(nodfa, text, 0, &d, RZ_REGEX_STARTEND), pattern);
+		from = a.rm_eo > a.rm_so ? a.rm_eo : a.rm_eo + 1;
+	}
+	rz_regex_free(dfa);
+	rz_regex_free(nodfa);
+	return true;
+}
+
+bool test_regex_dfa_corpus(void) {
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(patterns); i++) {
+		for (size_t j = 0; j < RZ_ARRAY_SIZE(texts); j++) {
+			if (!regex_same(patterns[i], "", texts[j], strlen(texts[j]))) {
+				return false;
+			}
+			if (!regex_same(patterns[i], "i", texts[j], strlen(texts[j]))) {
+				return false;
+			}
+		}
+	}
+	mu_end;
+}
+
+bool test_regex_dfa_binary(void) {
+	// more distinct states than the cache holds, and bytes past ascii
+	ut8 buf[0x1000];
+	ut32 seed = 1;
+	for (size_t i = 0; i < sizeof(buf); i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = (seed >> 16) & 0xff;
+	}
+	memcpy(buf + 0x800, "key=0123456789", 14);
+	const char *binary_patterns[] = {
+		"key=[0-9]+",
+		"[\x80-\xff]{3}",
+		"(a|b|c|d|e|f|g|h)(i|j|k|l|m|n|o|p)(q|r|s|t)",
+		"[0-9a-f][0-9a-f][0-9a-f][0-9a-f]",
+		".{7}x",
+	};
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(binary_patterns); i++) {
+		if (!regex_same(binary_patterns[i], "", (const char *)buf, sizeof(buf))) {
+			return false;
+		}
+	}
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_regex_dfa_corpus);
+	mu_run_test(test_regex_dfa_binary);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
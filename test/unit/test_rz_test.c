@@ -5,6 +5,7 @@
 #include "../../binrz/rz-test/rz-test.c"
 #include "../../binrz/rz-test/load.c"
 #include "../../binrz/rz-test/run.c"
+#include "../../binrz/rz-test/perf.c"
 #undef main
 
 #include "minunit.h"
@@ -188,9 +189,65 @@ bool test_rz_test_fix(void) {
 	mu_end;
 }
 
+bool test_rz_test_budget(void) {
+	RzTestDatabase *db = rz_test_test_database_new();
+	database_load(db, "unit/rz_test_cmd_test_budget", 1);
+	mu_assert_eq(rz_pvector_len(&db->tests), 1, "tests count");
+	RzTest *test = rz_pvector_at(&db->tests, 0);
+	RzCmdTest *cmd_test = test->cmd_test;
+	mu_assert_true(cmd_test->max_time.set, "max time set");
+	mu_assert_eq(cmd_test->max_time.value, 500, "max time");
+	mu_assert_true(cmd_test->max_rss.set, "max rss set");
+	mu_assert_eq(cmd_test->max_rss.value, 65536, "max rss");
+
+	RzTestResultInfo result = { .test = test, .result = RZ_TEST_RESULT_OK, .time_elapsed = 400000, .peak_rss = 30000 };
+	mu_assert_true(rz_test_check_cmd_budget(cmd_test, &result), "within budget");
+	result.time_elapsed = 600000;
+	mu_assert_false(rz_test_check_cmd_budget(cmd_test, &result), "over time budget");
+	result.time_elapsed = 400000;
+	result.peak_rss = 70000;
+	mu_assert_false(rz_test_check_cmd_budget(cmd_test, &result), "over rss budget");
+
+	rz_test_test_database_free(db);
+	mu_end;
+}
+
+bool test_rz_test_baseline(void) {
+	RzTestBaseline *baseline = rz_test_baseline_new();
+	mu_assert_true(rz_test_baseline_load(baseline, "unit/rz_test_baseline"), "load");
+
+	RzCmdTest cmd_test = { 0 };
+	cmd_test.name.value = "budget";
+	RzTest test = { .path = "/somewhere/test/db/cmd/cmd_foo", .type = RZ_TEST_TYPE_CMD, .cmd_test = &cmd_test };
+	char *key = rz_test_baseline_key(&test);
+	mu_assert_streq(key, "cmd/cmd_foo\tbudget", "key");
+	free(key);
+
+	RzTestPerfEntry *base = rz_test_baseline_get(baseline, &test);
+	mu_assert_notnull(base, "baseline entry");
+	mu_assert_eq(base->time_elapsed, 200000, "baseline time");
+	mu_assert_eq(base->peak_rss, 40000, "baseline rss");
+
+	RzTestResultInfo result = { .test = &test, .result = RZ_TEST_RESULT_OK, .time_elapsed = 240000, .peak_rss = 41000 };
+	bool time, rss;
+	mu_assert_false(rz_test_perf_regressed(base, &result, 25, &time, &rss), "within tolerance");
+	result.time_elapsed = 400000;
+	mu_assert_true(rz_test_perf_regressed(base, &result, 25, &time, &rss), "time regressed");
+	mu_assert_true(time, "time flag");
+	mu_assert_false(rss, "rss flag");
+	mu_assert_false(rz_test_perf_regressed(base, &result, 150, &time, &rss), "within larger tolerance");
+
+	cmd_test.name.value = "unknown";
+	mu_assert_null(rz_test_baseline_get(baseline, &test), "no baseline entry");
+	rz_test_baseline_free(baseline);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_test_database_load_cmd);
 	mu_run_test(test_rz_test_fix);
+	mu_run_test(test_rz_test_budget);
+	mu_run_test(test_rz_test_baseline);
 	return tests_passed != tests_run;
 }
 
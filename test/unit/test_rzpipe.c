@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_core.h>
+#include <rz_socket.h>
+#include "minunit.h"
+
+#define DATA_SIZE 8192
+
+static char tmp_path[1000];
+
+static const char *get_auxiliary_path(const char *s) {
+	char *p = rz_sys_pid_to_path(rz_sys_getpid());
+	char *pp = (char *)rz_str_lchr(p, RZ_SYS_DIR[0]);
+	if (pp) {
+		*pp = '\0';
+	}
+	snprintf(tmp_path, sizeof(tmp_path), "%s%s%s%s%s", p, RZ_SYS_DIR, "auxiliary", RZ_SYS_DIR, s);
+	free(p);
+	return tmp_path;
+}
+
+static RzCore *core_with_data(void) {
+	RzCore *core = rz_core_new();
+	if (!core || !rz_core_file_open(core, "malloc://8192", RZ_PERM_RW, 0)) {
+		rz_core_free(core);
+		return NULL;
+	}
+	ut8 *buf = malloc(DATA_SIZE);
+	if (!buf) {
+		rz_core_free(core);
+		return NULL;
+	}
+	for (size_t i = 0; i < DATA_SIZE; i++) {
+		buf[i] = i * 7 + (i >> 8);
+	}
+	rz_io_write_at(core->io, 0, buf, DATA_SIZE);
+	free(buf);
+	return core;
+}
+
+static bool test_rzpipe_framed(void) {
+#if __UNIX__
+	RzCore *core = core_with_data();
+	mu_assert_notnull(core, "core");
+	char *cmd = rz_str_newf("#!pipe %s", get_auxiliary_path("rzpipe-framed"));
+	rz_core_cmd0(core, cmd);
+	free(cmd);
+	mu_assert_notnull(rz_flag_get(core->flags, "framed"), "framed protocol negotiated");
+	mu_assert_notnull(rz_flag_get(core->flags, "batch"), "pipelined commands");
+	mu_assert_notnull(rz_flag_get(core->flags, "read_at"), "raw read matches p8");
+#if HAVE_SHM_OPEN
+	mu_assert_notnull(rz_flag_get(core->flags, "shm"), "read through shared memory matches p8");
+#endif
+	char *framed = rz_sys_getenv(RZPIPE_FRAMED_ENV);
+	mu_assert_null(framed, "framed protocol only offered to the script");
+	rz_core_free(core);
+#else
+	mu_ignore;
+#endif
+	mu_end;
+}
+
+static int all_tests(void) {
+	mu_run_test(test_rzpipe_framed);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
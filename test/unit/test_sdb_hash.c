@@ -7,6 +7,10 @@
 #include <ht_up.h>
 #include <ht_pp.h>
 #include <ht_pu.h>
+#include <ht_ppo.h>
+#include <ht_upo.h>
+#include <ht_uuo.h>
+#include <ht_puo.h>
 
 typedef struct _test_struct {
 	char *name;
@@ -536,6 +540,86 @@ bool test_ht_pu_ops(void) {
 	mu_end;
 }
 
+static bool upo_count_cb(void *user, const ut64 key, const void *v) {
+	(*(ut32 *)user)++;
+	return true;
+}
+
+static bool upo_delete_cb(void *user, const ut64 key, const void *v) {
+	ht_upo_delete((HtUPO *)user, key);
+	return true;
+}
+
+bool test_ht_upo_ops(void) {
+	HtUPO *ht = ht_upo_new((HtUPDupValue)strdup, free_up_value, NULL);
+	mu_assert_false(ht_upo_delete(ht, 0), "nothing should be deleted");
+	mu_assert_true(ht_upo_insert(ht, 0, "value0"), "0 should be inserted");
+	mu_assert_false(ht_upo_insert(ht, 0, "other"), "0 already exists");
+	mu_assert_true(ht_upo_update(ht, 0, "value1"), "0 should be updated");
+	mu_assert_streq(ht_upo_find(ht, 0, NULL), "value1", "value1 should be at 0");
+
+	// grows, and keeps every element reachable through deletions
+	char buf[32];
+	for (ut64 i = 1; i < 10000; i++) {
+		snprintf(buf, sizeof(buf), "%" PFMT64u, i);
+		mu_assert_true(ht_upo_insert(ht, i << 12, buf), "element should be inserted");
+	}
+	mu_assert_eq(ht->count, 10000, "all elements should be there");
+	for (ut64 i = 1; i < 10000; i += 2) {
+		mu_assert_true(ht_upo_delete(ht, i << 12), "odd element should be deleted");
+	}
+	bool found = true;
+	ht_upo_find(ht, 3 << 12, &found);
+	mu_assert_false(found, "deleted element should not be found");
+	bool all = true;
+	for (ut64 i = 2; i < 10000; i += 2) {
+		snprintf(buf, sizeof(buf), "%" PFMT64u, i);
+		const char *v = ht_upo_find(ht, i << 12, &found);
+		all &= found && v && !strcmp(v, buf);
+	}
+	mu_assert_true(all, "even elements should be found");
+
+	mu_assert_true(ht_upo_update_key(ht, 2 << 12, 1), "key should be updated");
+	mu_assert_streq(ht_upo_find(ht, 1, NULL), "2", "value should be moved to the new key");
+	mu_assert_null(ht_upo_find(ht, 2 << 12, NULL), "old key should be deleted");
+
+	ut32 count = 0;
+	ht_upo_foreach(ht, upo_count_cb, &count);
+	mu_assert_eq(count, ht->count, "foreach should visit every element");
+	ht_upo_foreach(ht, upo_delete_cb, ht);
+	mu_assert_eq(ht->count, 0, "foreach can delete the current element");
+	ht_upo_foreach(ht, (HtUPForeachCallback)should_not_be_caled, NULL);
+	ht_upo_free(ht);
+	mu_end;
+}
+
+bool test_ht_open_types(void) {
+	bool found;
+	HtPPO *pp = ht_ppo_new0();
+	ht_ppo_insert(pp, "key1", "value1");
+	ht_ppo_insert(pp, "key2", "value2");
+	mu_assert_streq(ht_ppo_find(pp, "key2", NULL), "value2", "value2 should be retrieved");
+	mu_assert_true(ht_ppo_delete(pp, "key1"), "key1 should be deleted");
+	mu_assert_null(ht_ppo_find(pp, "key1", &found), "key1 should be gone");
+	mu_assert_false(found, "found should be false");
+	ht_ppo_free(pp);
+
+	HtUUO *uu = ht_uuo_new0();
+	for (ut64 i = 0; i < 1000; i++) {
+		ht_uuo_insert(uu, i, i * 3);
+	}
+	mu_assert_eq(ht_uuo_find(uu, 333, &found), 999, "999 should be retrieved");
+	mu_assert_true(found, "found should be true");
+	ht_uuo_free(uu);
+
+	HtPUO *pu = ht_puo_new0();
+	mu_assert_true(ht_puo_insert(pu, "key1", 0xcafebabe), "key1 should be inserted");
+	mu_assert_true(ht_puo_update(pu, "key1", 0xdeadbeef), "key1 should be updated");
+	mu_assert_eq(ht_puo_find(pu, "key1", NULL), 0xdeadbeef, "0xdeadbeef should be retrieved");
+	ht_puo_free(pu);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_ht_insert_lookup);
 	mu_run_test(test_ht_update_lookup);
@@ -556,6 +640,8 @@ int all_tests() {
 	mu_run_test(test_foreach_delete);
 	mu_run_test(test_update_key);
 	mu_run_test(test_ht_pu_ops);
+	mu_run_test(test_ht_upo_ops);
+	mu_run_test(test_ht_open_types);
 	return tests_passed != tests_run;
 }
 
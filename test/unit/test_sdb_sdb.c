@@ -6,6 +6,7 @@
 #include <fcntl.h>
 #include <stdio.h>
 #include <rz_util/rz_file.h>
+#include <rz_util/rz_strbuf.h>
 
 static bool foreach_delete_cb(void *user, const char *key, const char *val) {
 	if (strcmp(key, "bar")) {
@@ -549,6 +550,83 @@ bool test_sdb_text_load_file() {
 	mu_end;
 }
 
+bool test_sdb_text_load_update() {
+	RzStrBuf *sb = rz_strbuf_new("/\ndup=first\ndup=second\nesc\\=aped=v\\nal\n");
+	for (int i = 0; i < 10000; i++) {
+		rz_strbuf_appendf(sb, "key%d=value%d\n", i, i);
+	}
+	rz_strbuf_append(sb, "/ns\ninner=1\n");
+	Sdb *db = sdb_new0();
+	sdb_set(db, "before", "set", 0);
+	mu_assert_true(sdb_text_load_buf(db, (char *)rz_strbuf_get(sb), rz_strbuf_length(sb)), "load success");
+	rz_strbuf_free(sb);
+	mu_assert_streq(sdb_const_get(db, "before", NULL), "set", "kept");
+	mu_assert_streq(sdb_const_get(db, "dup", NULL), "second", "last one wins");
+	mu_assert_streq(sdb_const_get(db, "esc=aped", NULL), "v\nal", "unescaped");
+	mu_assert_streq(sdb_const_get(db, "key9999", NULL), "value9999", "loaded");
+	mu_assert_streq(sdb_const_get(sdb_ns(db, "ns", false), "inner", NULL), "1", "namespace");
+	// the loaded values are copied on write
+	sdb_set(db, "key1", "v", 0);
+	sdb_set(db, "key2", "a longer value than before", 0);
+	sdb_set_owned(db, "key3", strdup("owned"), 0);
+	sdb_unset(db, "key4", 0);
+	mu_assert_streq(sdb_const_get(db, "key1", NULL), "v", "shorter update");
+	mu_assert_streq(sdb_const_get(db, "key2", NULL), "a longer value than before", "longer update");
+	mu_assert_streq(sdb_const_get(db, "key3", NULL), "owned", "owned update");
+	mu_assert_null(sdb_const_get(db, "key4", NULL), "unset");
+	mu_assert_streq(sdb_const_get(db, "key5", NULL), "value5", "untouched");
+	sdb_reset(db);
+	mu_assert_null(sdb_const_get(db, "key5", NULL), "reset");
+	sdb_free(db);
+	mu_end;
+}
+
+bool test_sdb_bin_save_load() {
+	Sdb *ref_db = text_ref_db();
+	mu_assert_true(sdb_bin_save(ref_db, ".bin_save_load", true), "save success");
+	mu_assert_true(sdb_bin_check(".bin_save_load"), "check binary");
+
+	Sdb *db = sdb_new0();
+	bool succ = sdb_bin_load(db, ".bin_save_load");
+	unlink(".bin_save_load");
+
+	mu_assert_true(succ, "load success");
+	bool eq = sdb_diff(ref_db, db, diff_cb, NULL);
+	sdb_free(ref_db);
+	sdb_free(db);
+	mu_assert_true(eq, "load correct");
+	mu_end;
+}
+
+bool test_sdb_bin_load_broken() {
+	Sdb *ref_db = text_ref_db();
+	int fd = tmpfile_new(".bin_load_broken", NULL, 0);
+	bool succ = sdb_bin_save_fd(ref_db, fd, false);
+	sdb_free(ref_db);
+	mu_assert_true(succ, "save success");
+	off_t sz = lseek(fd, 0, SEEK_END);
+	ut8 *buf = malloc(sz);
+	lseek(fd, 0, SEEK_SET);
+	mu_assert_eq(read(fd, buf, sz), sz, "read back");
+	close(fd);
+	unlink(".bin_load_broken");
+
+	Sdb *db = sdb_new0();
+	mu_assert_true(sdb_bin_load_buf(db, buf, sz), "load full");
+	sdb_free(db);
+	for (off_t i = 0; i < sz; i++) {
+		db = sdb_new0();
+		succ = sdb_bin_load_buf(db, buf, i);
+		sdb_free(db);
+		mu_assert_false(succ, "truncated load fails");
+	}
+	char *text = strdup(text_ref);
+	mu_assert_false(sdb_bin_check_buf((ut8 *)text, strlen(text)), "text is not binary");
+	free(text);
+	free(buf);
+	mu_end;
+}
+
 int all_tests() {
 	// XXX two bugs found with crash
 	mu_run_test(test_sdb_namespace);
@@ -571,6 +649,9 @@ int all_tests() {
 	mu_run_test(test_sdb_text_load_broken);
 	mu_run_test(test_sdb_text_load_path_last_line);
 	mu_run_test(test_sdb_text_load_file);
+	mu_run_test(test_sdb_text_load_update);
+	mu_run_test(test_sdb_bin_save_load);
+	mu_run_test(test_sdb_bin_load_broken);
 	return tests_passed != tests_run;
 }
 
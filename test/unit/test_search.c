@@ -0,0 +1,271 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_search.h>
+#include "minunit.h"
+
+static int hit_cb(RzSearchKeyword *kw, void *user, ut64 addr) {
+	RzStrBuf *sb = user;
+	rz_strbuf_appendf(sb, "%d@0x%" PFMT64x ",", kw->kwidx, addr);
+	return 1;
+}
+
+static ut32 rnd(ut32 *seed) {
+	*seed = *seed * 1103515245 + 12345;
+	return (*seed >> 16) & 0x7fff;
+}
+
+static void add_random_keywords(RzSearch *s, int n) {
+	ut32 seed = 1337;
+	for (int i = 0; i < n; i++) {
+		ut8 kw[8], bm[8];
+		int kwlen = 1 + rnd(&seed) % 4;
+		for (int j = 0; j < kwlen; j++) {
+			kw[j] = "aAbB\x00\xff"[rnd(&seed) % 6];
+			bm[j] = rnd(&seed) % 4 ? 0xff : 0x0f;
+		}
+		RzSearchKeyword *k = rz_search_keyword_new(kw, kwlen, i % 3 ? NULL : bm, kwlen, NULL);
+		k->icase = i % 5 == 0;
+		rz_search_kw_add(s, k);
+	}
+}
+
+static char *search_hits(const ut8 *buf, int len, int block, bool overlap, bool automaton) {
+	RzSearch *s = rz_search_new(RZ_SEARCH_KEYWORD);
+	RzStrBuf *sb = rz_strbuf_new(NULL);
+	s->overlap = overlap;
+	s->contiguous = true;
+	s->ac_min_kws = automaton ? 1 : 0;
+	rz_search_set_callback(s, hit_cb, sb);
+	add_random_keywords(s, 60);
+	rz_search_kw_add(s, rz_search_keyword_new((ut8 *)"\x00\x00", 2, (ut8 *)"\x00\x00", 2, NULL));
+	rz_search_begin(s);
+	for (int off = 0; off < len; off += block) {
+		rz_search_update(s, off, buf + off, RZ_MIN(block, len - off));
+	}
+	rz_search_free(s);
+	return rz_strbuf_drain(sb);
+}
+
+bool test_rz_search_keyword_automaton(void) {
+	ut8 buf[0x800];
+	ut32 seed = 42;
+	for (int i = 0; i < sizeof(buf); i++) {
+		buf[i] = "aAbBc\x00\xff\x0f"[rnd(&seed) % 8];
+	}
+	int blocks[] = { 0x800, 0x100, 3 };
+	for (int i = 0; i < RZ_ARRAY_SIZE(blocks); i++) {
+		for (int overlap = 0; overlap < 2; overlap++) {
+			char *brute = search_hits(buf, sizeof(buf), blocks[i], overlap, false);
+			char *ac = search_hits(buf, sizeof(buf), blocks[i], overlap, true);
+			mu_assert_true(strlen(brute) > 1000, "there should be many hits");
+			mu_assert_streq(ac, brute, "the automaton finds the same hits in the same order");
+			free(brute);
+			free(ac);
+		}
+	}
+	mu_end;
+}
+
+bool test_rz_search_keyword_single(void) {
+	ut8 buf[0x1000];
+	ut32 seed = 7;
+	for (int i = 0; i < sizeof(buf); i++) {
+		buf[i] = "abc"[rnd(&seed) % 3];
+	}
+	for (int kwlen = 1; kwlen < 12; kwlen++) {
+		for (int overlap = 0; overlap < 2; overlap++) {
+			const ut8 *kw = buf + rnd(&seed) % (sizeof(buf) - kwlen);
+			RzSearch *s = rz_search_new(RZ_SEARCH_KEYWORD);
+			RzStrBuf *sb = rz_strbuf_new(NULL);
+			s->overlap = overlap;
+			s->contiguous = true;
+			rz_search_set_callback(s, hit_cb, sb);
+			rz_search_kw_add(s, rz_search_keyword_new(kw, kwlen, NULL, 0, NULL));
+			rz_search_begin(s);
+			for (int off = 0; off < sizeof(buf); off += 0x100) {
+				rz_search_update(s, off, buf + off, 0x100);
+			}
+			RzStrBuf *expect = rz_strbuf_new(NULL);
+			for (int i = 0; i + kwlen <= sizeof(buf); i++) {
+				if (!memcmp(buf + i, kw, kwlen)) {
+					rz_strbuf_appendf(expect, "0@0x%x,", i);
+					if (!overlap) {
+						i += kwlen - 1;
+					}
+				}
+			}
+			mu_assert_streq(rz_strbuf_get(sb), rz_strbuf_get(expect), "hits of a single keyword");
+			rz_strbuf_free(expect);
+			rz_strbuf_free(sb);
+			rz_search_free(s);
+		}
+	}
+	mu_end;
+}
+
+bool test_rz_search_keyword_overlap_blocks(void) {
+	RzSearch *s = rz_search_new(RZ_SEARCH_KEYWORD);
+	RzStrBuf *sb = rz_strbuf_new(NULL);
+	s->overlap = true;
+	s->contiguous = true;
+	rz_search_set_callback(s, hit_cb, sb);
+	rz_search_kw_add(s, rz_search_keyword_new((ut8 *)"AA", 2, NULL, 0, NULL));
+	rz_search_kw_add(s, rz_search_keyword_new((ut8 *)"AAAA", 4, NULL, 0, NULL));
+	rz_search_begin(s);
+	rz_search_update(s, 0, (ut8 *)"AAAA", 4);
+	rz_search_update(s, 4, (ut8 *)"AAAA", 4);
+	mu_assert_streq(rz_strbuf_get(sb), "0@0x0,0@0x1,0@0x2,1@0x0,0@0x3,0@0x4,0@0x5,0@0x6,1@0x1,1@0x2,1@0x3,1@0x4,",
+		"hits crossing blocks are reported once");
+	rz_strbuf_free(sb);
+	rz_search_free(s);
+	mu_end;
+}
+
+static int count_hit_cb(RzSearchKeyword *kw, void *user, ut64 addr) {
+	RzStrBuf *sb = user;
+	rz_strbuf_appendf(sb, "%d:%d@0x%" PFMT64x ",", kw->kwidx, kw->count, addr);
+	return 1;
+}
+
+static char *parallel_hits(const ut8 *buf, ut64 len, int n_kws, bool overlap, ut64 maxhits, size_t threads) {
+	RzSearch *s = rz_search_new(RZ_SEARCH_KEYWORD);
+	RzStrBuf *sb = rz_strbuf_new(NULL);
+	s->overlap = overlap;
+	s->contiguous = true;
+	s->maxhits = maxhits;
+	rz_search_set_callback(s, count_hit_cb, sb);
+	add_random_keywords(s, n_kws);
+	rz_search_begin(s);
+	// two updates, so the data left over between them is exercised too
+	ut64 half = 0x100 * (len / 0x200) + 3;
+	rz_search_update_parallel(s, 0, buf, half, 0x100, threads);
+	rz_search_update_parallel(s, half, buf + half, len - half, 0x100, threads);
+	rz_strbuf_appendf(sb, "nhits=%" PFMT64u, s->nhits);
+	rz_search_free(s);
+	return rz_strbuf_drain(sb);
+}
+
+bool test_rz_search_update_parallel(void) {
+	const ut64 len = 0x140000;
+	ut8 *buf = malloc(len);
+	ut32 seed = 99;
+	for (ut64 i = 0; i < len; i++) {
+		buf[i] = "aAbBcdefghijkl\x00\xff"[rnd(&seed) % 16];
+	}
+	int n_kws[] = { 3, 60 };
+	ut64 maxhits[] = { 0, 5000 };
+	for (int k = 0; k < RZ_ARRAY_SIZE(n_kws); k++) {
+		for (int m = 0; m < RZ_ARRAY_SIZE(maxhits); m++) {
+			for (int overlap = 0; overlap < 2; overlap++) {
+				char *serial = parallel_hits(buf, len, n_kws[k], overlap, maxhits[m], 1);
+				char *parallel = parallel_hits(buf, len, n_kws[k], overlap, maxhits[m], 4);
+				mu_assert_true(strlen(serial) > 10000, "there should be many hits");
+				mu_assert_streq(parallel, serial, "the threads find the same hits in the same order");
+				free(serial);
+				free(parallel);
+			}
+		}
+	}
+	free(buf);
+	mu_end;
+}
+
+static void add_gram_keywords(RzSearch *s, const ut8 *buf, ut64 len, int n) {
+	ut32 seed = 4242;
+	for (int i = 0; i < n; i++) {
+		ut8 kw[16], bm[16];
+		int kwlen = 4 + rnd(&seed) % 12;
+		// half of the keywords are taken from the data, so they have hits
+		ut64 at = rnd(&seed) * (ut64)rnd(&seed) % (len - kwlen);
+		if (i % 4 == 1) {
+			// a match crossing two blocks
+			at = RZ_MIN(at | 0xfe, len - 0x102);
+		}
+		for (int j = 0; j < kwlen; j++) {
+			kw[j] = i % 2 ? buf[at + j] : rnd(&seed);
+			bm[j] = j < 4 || rnd(&seed) % 3 ? 0xff : 0xf0;
+		}
+		RzSearchKeyword *k = rz_search_keyword_new(kw, kwlen, i % 3 ? NULL : bm, kwlen, NULL);
+		k->icase = i % 5 == 0;
+		rz_search_kw_add(s, k);
+	}
+}
+
+static char *gram_index_hits(const ut8 *buf, ut64 len, RzSearchGramIndex *idx, int n_kws, bool overlap, ut64 *scanned) {
+	RzSearch *s = rz_search_new(RZ_SEARCH_KEYWORD);
+	RzStrBuf *sb = rz_strbuf_new(NULL);
+	s->overlap = overlap;
+	s->contiguous = true;
+	rz_search_set_callback(s, count_hit_cb, sb);
+	add_gram_keywords(s, buf, len, n_kws);
+	rz_search_begin(s);
+	RzVector ranges;
+	rz_vector_init(&ranges, sizeof(RzInterval), NULL, NULL);
+	if (!idx || !rz_search_gram_index_ranges(idx, s, 0, len, 0x100, &ranges)) {
+		RzInterval all = { 0, len };
+		rz_vector_push(&ranges, &all);
+	}
+	*scanned = 0;
+	RzInterval *itv;
+	rz_vector_foreach(&ranges, itv) {
+		for (ut64 off = itv->addr; off < rz_itv_end(*itv); off += 0x100) {
+			rz_search_update(s, off, buf + off, RZ_MIN(0x100, rz_itv_end(*itv) - off));
+		}
+		*scanned += itv->size;
+	}
+	rz_vector_fini(&ranges);
+	rz_search_free(s);
+	return rz_strbuf_drain(sb);
+}
+
+bool test_rz_search_gram_index(void) {
+	const ut64 len = 0x40000;
+	ut8 *buf = malloc(len);
+	ut32 seed = 31337;
+	for (ut64 i = 0; i < len; i++) {
+		buf[i] = i & 0x1000 ? rnd(&seed) : "aAbBcC\x00\xff"[rnd(&seed) % 8];
+	}
+	ut64 max_mem[] = { UT64_MAX, 0x10000, 0 };
+	for (int m = 0; m < RZ_ARRAY_SIZE(max_mem); m++) {
+		RzSearchGramIndex *idx = rz_search_gram_index_new(0, len, max_mem[m]);
+		for (ut64 off = 0; off < len; off += 0x1001) {
+			mu_assert_true(rz_search_gram_index_feed(idx, buf + off, RZ_MIN(0x1001, len - off)), "feed the index");
+		}
+		mu_assert_true(rz_search_gram_index_complete(idx), "whole range fed");
+		ut64 size;
+		ut8 *ser = rz_search_gram_index_serialize(idx, &size);
+		rz_search_gram_index_free(idx);
+		idx = rz_search_gram_index_deserialize(ser, size, max_mem[m], NULL);
+		free(ser);
+		mu_assert_notnull(idx, "deserialized index");
+		int n_kws[] = { 1, 2, 30 };
+		for (int k = 0; k < RZ_ARRAY_SIZE(n_kws); k++) {
+			for (int overlap = 0; overlap < 2; overlap++) {
+				ut64 scanned_all, scanned;
+				char *linear = gram_index_hits(buf, len, NULL, n_kws[k], overlap, &scanned_all);
+				char *indexed = gram_index_hits(buf, len, idx, n_kws[k], overlap, &scanned);
+				mu_assert_streq(indexed, linear, "the index gives the same hits in the same order");
+				if (n_kws[k] == 1 && max_mem[m] == UT64_MAX) {
+					mu_assert_true(scanned < scanned_all / 2, "most of the data is skipped");
+				}
+				free(linear);
+				free(indexed);
+			}
+		}
+		rz_search_gram_index_free(idx);
+	}
+	free(buf);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_rz_search_keyword_automaton);
+	mu_run_test(test_rz_search_keyword_single);
+	mu_run_test(test_rz_search_keyword_overlap_blocks);
+	mu_run_test(test_rz_search_update_parallel);
+	mu_run_test(test_rz_search_gram_index);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
@@ -1494,6 +1494,41 @@ bool test_analysis_save() {
 	mu_end;
 }
 
+bool test_analysis_save_cached() {
+	RzAnalysis *analysis = rz_analysis_new();
+	rz_analysis_xrefs_set(analysis, 0x42, 1337, RZ_ANALYSIS_XREF_TYPE_CALL);
+	rz_meta_set_string(analysis, RZ_META_TYPE_COMMENT, 0x1337, "some comment");
+	rz_analysis_hint_set_arch(analysis, 4321, "arm");
+
+	Sdb *first = sdb_new0();
+	rz_serialize_analysis_save(first, analysis);
+	Sdb *second = sdb_new0();
+	rz_serialize_analysis_save(second, analysis);
+	assert_sdb_eq(second, first, "unchanged namespaces copied from the previous save");
+
+	rz_analysis_xrefs_set(analysis, 1337, 0xc0ffee, RZ_ANALYSIS_XREF_TYPE_DATA);
+	rz_meta_set_string(analysis, RZ_META_TYPE_COMMENT, 0x1337, "other comment");
+	rz_analysis_hint_unset_arch(analysis, 4321);
+	rz_spaces_set(&analysis->meta_spaces, "lounge");
+	Sdb *third = sdb_new0();
+	rz_serialize_analysis_save(third, analysis);
+
+	Sdb *expected = sdb_new0();
+	rz_serialize_analysis_xrefs_save(sdb_ns(expected, "xrefs", true), analysis);
+	rz_serialize_analysis_meta_save(sdb_ns(expected, "meta", true), analysis);
+	rz_serialize_analysis_hints_save(sdb_ns(expected, "hints", true), analysis);
+	assert_sdb_eq(sdb_ns(third, "xrefs", false), sdb_ns(expected, "xrefs", false), "changed xrefs saved again");
+	assert_sdb_eq(sdb_ns(third, "meta", false), sdb_ns(expected, "meta", false), "changed meta saved again");
+	assert_sdb_eq(sdb_ns(third, "hints", false), sdb_ns(expected, "hints", false), "changed hints saved again");
+
+	sdb_free(first);
+	sdb_free(second);
+	sdb_free(third);
+	sdb_free(expected);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
 bool test_analysis_load() {
 	RzAnalysis *analysis = rz_analysis_new();
 
@@ -1574,6 +1609,7 @@ int all_tests() {
 	mu_run_test(test_analysis_cc_save);
 	mu_run_test(test_analysis_cc_load);
 	mu_run_test(test_analysis_save);
+	mu_run_test(test_analysis_save_cached);
 	mu_run_test(test_analysis_load);
 	return tests_passed != tests_run;
 }
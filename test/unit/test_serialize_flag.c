@@ -171,10 +171,10 @@ static bool flag_cmp_cb(RzFlagItem *fi, void *user) {
 	return true;
 }
 
-static bool test_load(Sdb *db, RzFlag *ref) {
+static bool test_load(Sdb *db, RzFlag *ref, RzThreadTaskPool *pool) {
 	RzFlag *flag = rz_flag_new();
 
-	bool loaded = rz_serialize_flag_load(db, flag, NULL);
+	bool loaded = pool ? rz_serialize_flag_load_parallel(db, flag, pool, NULL) : rz_serialize_flag_load(db, flag, NULL);
 	sdb_free(db);
 	mu_assert("load success", loaded);
 
@@ -227,14 +227,26 @@ static bool test_load(Sdb *db, RzFlag *ref) {
 
 TEST_CALL(test_flag_0_save, test_save(ref_0_flag(), ref_0_db()));
 TEST_CALL(test_flag_1_save, test_save(ref_1_flag(), ref_1_db()));
-TEST_CALL(test_flag_0_load, test_load(ref_0_db(), ref_0_flag()));
-TEST_CALL(test_flag_1_load, test_load(ref_1_db(), ref_1_flag()));
+TEST_CALL(test_flag_0_load, test_load(ref_0_db(), ref_0_flag(), NULL));
+TEST_CALL(test_flag_1_load, test_load(ref_1_db(), ref_1_flag(), NULL));
+
+bool test_flag_1_load_parallel() {
+	RzThreadTaskPool *pool = rz_th_task_pool_new(2);
+	mu_assert_notnull(pool, "task pool");
+	bool ok = test_load(ref_1_db(), ref_1_flag(), pool);
+	rz_th_task_pool_free(pool);
+	if (!ok) {
+		return false;
+	}
+	mu_end;
+}
 
 int all_tests() {
 	mu_run_test(test_flag_0_save);
 	mu_run_test(test_flag_1_save);
 	mu_run_test(test_flag_0_load);
 	mu_run_test(test_flag_1_load);
+	mu_run_test(test_flag_1_load_parallel);
 	return tests_passed != tests_run;
 }
 
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include "minunit.h"
+
+typedef struct {
+	ut64 a;
+	ut8 b;
+} SlabTest;
+
+bool test_rz_slab_alloc_release(void) {
+	RzSlab *slab = rz_slab_new(sizeof(SlabTest), 4);
+	mu_assert_notnull(slab, "slab");
+	mu_assert_eq(slab->elem_size % sizeof(void *), 0, "aligned size");
+
+	SlabTest *objs[10];
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(objs); i++) {
+		objs[i] = rz_slab_alloc(slab);
+		mu_assert_notnull(objs[i], "alloc");
+		mu_assert_eq(objs[i]->a, 0, "zeroed");
+		objs[i]->a = i;
+		objs[i]->b = 0xff;
+		mu_assert_true(rz_slab_owns(slab, objs[i]), "owned");
+	}
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(objs); i++) {
+		mu_assert_eq(objs[i]->a, i, "objects don't overlap");
+	}
+
+	RzSlabStats stats;
+	rz_slab_stats(slab, &stats);
+	mu_assert_eq(stats.used, 10, "used");
+	mu_assert_eq(stats.chunks, 3, "chunks");
+	mu_assert_eq(stats.used_bytes, 10 * slab->elem_size, "used bytes");
+	mu_assert_eq(stats.reserved_bytes, 12 * slab->elem_size, "reserved bytes");
+
+	SlabTest local;
+	mu_assert_false(rz_slab_owns(slab, &local), "not owned");
+	mu_assert_false(rz_slab_owns(slab, (ut8 *)objs[0] + 1), "not an object start");
+	mu_assert_false(rz_slab_owns(slab, NULL), "NULL");
+
+	rz_slab_release(slab, objs[3]);
+	rz_slab_release(slab, objs[7]);
+	rz_slab_release(slab, NULL);
+	rz_slab_stats(slab, &stats);
+	mu_assert_eq(stats.used, 8, "used after release");
+
+	// released objects are reused before growing
+	SlabTest *again = rz_slab_alloc(slab);
+	mu_assert_ptreq(again, objs[7], "last released first");
+	mu_assert_eq(again->a, 0, "zeroed");
+	again = rz_slab_alloc(slab);
+	mu_assert_ptreq(again, objs[3], "reused");
+	rz_slab_stats(slab, &stats);
+	mu_assert_eq(stats.chunks, 3, "no new chunk");
+
+	rz_slab_free(slab);
+	mu_end;
+}
+
+bool test_rz_slab_many(void) {
+	RzSlab *slab = rz_slab_new(24, 64);
+	RzPVector objs;
+	rz_pvector_init(&objs, NULL);
+	for (size_t round = 0; round < 4; round++) {
+		for (size_t i = 0; i < 1000; i++) {
+			ut64 *obj = rz_slab_alloc(slab);
+			mu_assert_notnull(obj, "alloc");
+			*obj = (ut64)(size_t)obj;
+			rz_pvector_push(&objs, obj);
+		}
+		// release every other object
+		for (size_t i = rz_pvector_len(&objs); i >= 2; i -= 2) {
+			rz_slab_release(slab, rz_pvector_at(&objs, i - 1));
+			rz_pvector_remove_at(&objs, i - 1);
+		}
+	}
+	void **it;
+	rz_pvector_foreach (&objs, it) {
+		ut64 *obj = *it;
+		mu_assert_eq(*obj, (ut64)(size_t)obj, "object intact");
+		mu_assert_true(rz_slab_owns(slab, obj), "owned");
+	}
+	RzSlabStats stats;
+	rz_slab_stats(slab, &stats);
+	mu_assert_eq(stats.used, rz_pvector_len(&objs), "used");
+	mu_assert_true(stats.reserved_bytes >= stats.used_bytes, "reserved");
+	rz_pvector_fini(&objs);
+	rz_slab_free(slab);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_rz_slab_alloc_release);
+	mu_run_test(test_rz_slab_many);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
@@ -39,6 +39,12 @@ bool test_rz_str_replace(void) {
 	str = rz_str_replace(strdup("hello horld"), "h", "hello", 0);
 	mu_assert_streq(str, "helloello horld", "error, replace char multi failed");
 	free(str);
+	str = rz_str_replace(strdup("aaaaa"), "aa", "b", 1);
+	mu_assert_streq(str, "bba", "replace all, no overlap");
+	free(str);
+	str = rz_str_replace(strdup("xyz"), "ab", "c", 1);
+	mu_assert_streq(str, "xyz", "replace all, no key");
+	free(str);
 	mu_end;
 }
 
@@ -339,6 +345,25 @@ bool test_rz_str_ansi_len(void) {
 			      "2");
 	mu_assert_eq(len, 10, "len(ascii + 4 byte utf-8 counted as 4 chars)");
 
+	len = rz_str_ansi_len("\x1b[31mred\x1b[0m and \x1b#1qplain\x1b");
+	mu_assert_eq(len, 14, "len(ansi at both ends, lone escape counted)");
+
+	len = rz_str_ansi_nlen("ab\x1b[0mcdef", 8);
+	mu_assert_eq(len, 4, "nlen(stops after the given bytes)");
+
+	len = rz_str_ansi_nlen("ab\x1b[0mcdef", 100);
+	mu_assert_eq(len, 6, "nlen(stops at the terminator)");
+
+	mu_end;
+}
+
+bool test_rz_mem_mem(void) {
+	const ut8 *hay = (const ut8 *)"abcabdabe";
+	mu_assert_ptreq(rz_mem_mem(hay, 9, (const ut8 *)"abd", 3), hay + 3, "found in the middle");
+	mu_assert_ptreq(rz_mem_mem(hay, 9, (const ut8 *)"abe", 3), hay + 6, "found at the end");
+	mu_assert_ptreq(rz_mem_mem(hay, 8, (const ut8 *)"abe", 3), NULL, "not past hlen");
+	mu_assert_ptreq(rz_mem_mem(hay, 9, (const ut8 *)"a", 1), hay, "single byte");
+	mu_assert_ptreq(rz_mem_mem(hay, 2, (const ut8 *)"abc", 3), NULL, "needle longer than haystack");
 	mu_end;
 }
 
@@ -490,6 +515,32 @@ bool test_rz_str_constpool(void) {
 	mu_end;
 }
 
+bool test_rz_str_intern(void) {
+	RzStrIntern *pool = rz_str_intern_new();
+	mu_assert_notnull(pool, "pool new");
+
+	char *a_ref = strdup("deliverance");
+	const char *a = rz_str_intern_get(pool, a_ref);
+	mu_assert_ptrneq(a, a_ref, "interned != ref");
+	mu_assert_streq(a, a_ref, "interned == ref (strcmp)");
+	mu_assert_ptreq(rz_str_intern_get(pool, a_ref), a, "same on re-get");
+	free(a_ref);
+	mu_assert_ptreq(rz_str_intern_ref(pool, a), a, "ref");
+	const char *b = rz_str_intern_get(pool, "foonation");
+	mu_assert_ptrneq(b, a, "distinct strings");
+	mu_assert_eq(rz_str_intern_count(pool), 2, "count");
+
+	rz_str_intern_put(pool, a);
+	rz_str_intern_put(pool, a);
+	mu_assert_streq(a, "deliverance", "still referenced");
+	rz_str_intern_put(pool, a);
+	mu_assert_eq(rz_str_intern_count(pool), 1, "freed on last put");
+	mu_assert_null(rz_str_intern_get(pool, NULL), "null");
+
+	rz_str_intern_free(pool);
+	mu_end;
+}
+
 bool test_rz_str_format_msvc_argv() {
 	// Examples from http://daviddeley.com/autohotkey/parameters/parameters.htm#WINCRULES
 	const char *a = "CallMePancake";
@@ -773,6 +824,7 @@ bool all_tests() {
 	mu_run_test(test_rz_sub_str_rchr);
 	mu_run_test(test_rz_str_rchr);
 	mu_run_test(test_rz_str_ansi_len);
+	mu_run_test(test_rz_mem_mem);
 	mu_run_test(test_rz_str_len_utf8_ansi);
 	mu_run_test(test_rz_str_utf8_charsize);
 	mu_run_test(test_rz_str_utf8_charsize_prev);
@@ -780,6 +832,7 @@ bool all_tests() {
 	mu_run_test(test_rz_str_escape_sh);
 	mu_run_test(test_rz_str_unescape);
 	mu_run_test(test_rz_str_constpool);
+	mu_run_test(test_rz_str_intern);
 	mu_run_test(test_rz_str_format_msvc_argv);
 	mu_run_test(test_rz_str_str_xy);
 	mu_run_test(test_rz_str_wrap);
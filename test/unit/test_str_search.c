@@ -343,6 +343,48 @@ bool test_rz_scan_strings_extended_ascii(void) {
 	mu_end;
 }
 
+bool test_rz_scan_strings_padding(void) {
+	ut8 *buf = calloc(0x1000, 1);
+	memset(buf + 0x100, 0xff, 0x100);
+	memcpy(buf + 0x203, "padded ascii", 12);
+	memcpy(buf + 0x401, "w\0i\0d\0e\0 \0s\0t\0r\0", 16);
+	memcpy(buf + 0x607, "\0\0\0b\0\0\0i\0\0\0g\0\0\0!", 16);
+	memset(buf + 0x800, 0x01, 0x10);
+	memcpy(buf + 0xff8, "tail", 4);
+
+	g_opt.prefer_big_endian = false;
+	RzList *str_list = rz_list_newf((RzListFree)rz_detected_string_free);
+	int n = rz_scan_strings_raw(buf, str_list, &g_opt, 0, 0x1000, RZ_STRING_ENC_GUESS);
+	mu_assert_eq(n, 4, "strings between padding, number of strings");
+	RzDetectedString *s = rz_list_get_n(str_list, 0);
+	mu_assert_streq(s->string, "padded ascii", "ascii string");
+	mu_assert_eq(s->addr, 0x203, "ascii string address");
+	s = rz_list_get_n(str_list, 1);
+	mu_assert_streq(s->string, "wide str", "utf16le string");
+	mu_assert_eq(s->addr, 0x401, "utf16le string address");
+	mu_assert_eq(s->type, RZ_STRING_ENC_UTF16LE, "utf16le string type");
+	s = rz_list_get_n(str_list, 2);
+	mu_assert_streq(s->string, "big!", "utf32 string");
+	mu_assert_eq(s->addr, 0x60a, "utf32 string address");
+	mu_assert_eq(s->type, RZ_STRING_ENC_UTF32LE, "utf32 string type");
+	s = rz_list_get_n(str_list, 3);
+	mu_assert_streq(s->string, "tail", "string at the end of the buffer");
+	mu_assert_eq(s->addr, 0xff8, "string at the end of the buffer address");
+	rz_list_purge(str_list);
+
+	n = rz_scan_strings_raw(buf, str_list, &g_opt, 0, 0x1000, RZ_STRING_ENC_UTF16LE);
+	mu_assert_eq(n, 3, "utf16le strings between padding, number of strings");
+	s = rz_list_get_n(str_list, 1);
+	mu_assert_eq(s->addr, 0x400, "utf16le string address");
+	mu_assert_eq(s->size, 18, "utf16le string size");
+	s = rz_list_get_n(str_list, 2);
+	mu_assert_eq(s->addr, 0x7ff, "utf16le string right after a run of zeros");
+
+	rz_list_free(str_list);
+	free(buf);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_rz_scan_strings_detect_ascii);
 	mu_run_test(test_rz_scan_strings_detect_ibm037);
@@ -354,6 +396,7 @@ bool all_tests() {
 	mu_run_test(test_rz_scan_strings_detect_utf32_be);
 	mu_run_test(test_rz_scan_strings_utf16_be);
 	mu_run_test(test_rz_scan_strings_extended_ascii);
+	mu_run_test(test_rz_scan_strings_padding);
 
 	return tests_passed != tests_run;
 }
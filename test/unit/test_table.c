@@ -114,6 +114,57 @@ bool test_rz_table_sort1(void) {
 	mu_end;
 }
 
+bool test_rz_table_sort_stable(void) {
+	RzTable *t = rz_table_new();
+	RzTableColumnType *typeString = rz_table_type("string");
+	RzTableColumnType *typeNumber = rz_table_type("number");
+	rz_table_add_column(t, typeString, "name", 0);
+	rz_table_add_column(t, typeNumber, "addr", 0);
+	rz_table_add_row(t, "a", "0x10", NULL);
+	rz_table_add_row(t, "b", "16", NULL);
+	rz_table_add_row(t, "c", "0x9", NULL);
+	rz_table_add_row(t, "d", "0xffffffffffffff00", NULL);
+	rz_table_add_row(t, "e", "1", NULL);
+
+	rz_table_sort(t, 1, false);
+	char *s = rz_table_tostring(t);
+	mu_assert_streq(s,
+		"name addr               \n"
+		"------------------------\n"
+		"e    1\n"
+		"c    0x9\n"
+		"a    0x10\n"
+		"b    16\n"
+		"d    0xffffffffffffff00\n",
+		"numbers are compared by value, equal ones keep their order");
+	free(s);
+
+	rz_table_sort(t, 1, true);
+	s = rz_table_tostring(t);
+	mu_assert_streq(s,
+		"name addr               \n"
+		"------------------------\n"
+		"d    0xffffffffffffff00\n"
+		"a    0x10\n"
+		"b    16\n"
+		"c    0x9\n"
+		"e    1\n",
+		"decreasing sort keeps equal rows in order too");
+	free(s);
+
+	rz_table_filter(t, 1, '<', "0x10");
+	s = rz_table_tostring(t);
+	mu_assert_streq(s,
+		"name addr \n"
+		"----------\n"
+		"c    0x9\n"
+		"e    1\n",
+		"filter keeps the matching rows in order");
+	free(s);
+	rz_table_free(t);
+	mu_end;
+}
+
 bool test_rz_table_uniq(void) {
 	RzTable *t = __table_test_data1();
 
@@ -353,6 +404,7 @@ bool all_tests() {
 	mu_run_test(test_rz_table_column_type);
 	mu_run_test(test_rz_table_tostring);
 	mu_run_test(test_rz_table_sort1);
+	mu_run_test(test_rz_table_sort_stable);
 	mu_run_test(test_rz_table_uniq);
 	mu_run_test(test_rz_table_group);
 	mu_run_test(test_rz_table_columns);
@@ -238,9 +238,85 @@ static bool test_task(void) {
 	mu_end;
 }
 
+typedef struct concurrent_ctx_t {
+	RzThreadLock *lock;
+	int entered; ///< concurrent runners that have started
+	int expected; ///< concurrent runners that must run at the same time
+} ConcurrentCtx;
+
+static void concurrent_runner(RzCoreTaskScheduler *sched, void *user) {
+	ConcurrentCtx *ctx = user;
+	rz_th_lock_enter(ctx->lock);
+	ctx->entered++;
+	rz_th_lock_leave(ctx->lock);
+	// only returns once the other concurrent runners are running at the same time
+	while (true) {
+		rz_th_lock_enter(ctx->lock);
+		bool all = ctx->entered >= ctx->expected;
+		rz_th_lock_leave(ctx->lock);
+		if (all) {
+			break;
+		}
+		rz_sys_usleep(1000);
+	}
+}
+
+static bool test_task_concurrent(void) {
+	ConcurrentCtx ctx = { 0 };
+	ctx.lock = rz_th_lock_new(false);
+	ctx.expected = 1;
+
+	RzCoreTaskScheduler sched;
+	rz_core_task_scheduler_init(&sched, NULL, NULL, NULL, NULL);
+	rz_core_task_sync_begin(&sched);
+
+	RzCoreTask *a = rz_core_task_new(&sched, concurrent_runner, NULL, &ctx);
+	rz_core_task_set_concurrent(a, true);
+	int a_id = a->id;
+	rz_core_task_enqueue(&sched, a);
+	a = NULL; // ownership moved to the scheduler, don't touch anymore!
+
+	// the main task is running, so a waits until it yields
+	while (!rz_th_rwlock_has_waiting_readers(sched.state_lock)) {
+		rz_sys_usleep(1000);
+	}
+	rz_th_lock_enter(ctx.lock);
+	mu_assert_eq(ctx.entered, 0, "concurrent task waits for the main task");
+	rz_th_lock_leave(ctx.lock);
+	rz_core_task_yield(&sched);
+	rz_th_lock_enter(ctx.lock);
+	mu_assert_eq(ctx.entered, 1, "concurrent task ran while the main task yielded");
+	rz_th_lock_leave(ctx.lock);
+	rz_core_task_join(&sched, rz_core_task_self(&sched), a_id);
+	rz_core_task_del(&sched, a_id);
+
+	// these would wait for each other forever if they didn't run at the same time
+	ctx.entered = 0;
+	ctx.expected = 3;
+	int ids[3];
+	for (size_t i = 0; i < 3; i++) {
+		RzCoreTask *task = rz_core_task_new(&sched, concurrent_runner, NULL, &ctx);
+		rz_core_task_set_concurrent(task, true);
+		ids[i] = task->id;
+		rz_core_task_enqueue(&sched, task);
+	}
+	rz_core_task_join(&sched, rz_core_task_self(&sched), -1);
+	mu_assert_eq(ctx.entered, 3, "concurrent tasks ran at the same time");
+	for (size_t i = 0; i < 3; i++) {
+		rz_core_task_del(&sched, ids[i]);
+	}
+	mu_assert_eq(rz_core_task_running_tasks_count(&sched), 0, "no task left");
+
+	rz_core_task_sync_end(&sched);
+	rz_core_task_scheduler_fini(&sched);
+	rz_th_lock_free(ctx.lock);
+	mu_end;
+}
+
 // This test is best served with helgrind
 static int all_tests(void) {
 	mu_run_test(test_task);
+	mu_run_test(test_task_concurrent);
 	return tests_passed != tests_run;
 }
 
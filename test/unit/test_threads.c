@@ -33,6 +33,11 @@ void *thread_queue_push_timed(RzThreadQueue *queue) {
 	return rz_th_queue_push(queue, queue, true) ? queue : NULL;
 }
 
+void *thread_ring_push_timed(RzThreadRing *ring) {
+	rz_sys_sleep(2);
+	return rz_th_ring_push(ring, ring) ? ring : NULL;
+}
+
 bool test_thread_queue(void) {
 	// test limited queue
 	void *head = (void *)"aaaaaa";
@@ -81,9 +86,279 @@ bool test_thread_queue(void) {
 	mu_end;
 }
 
+bool test_thread_ring(void) {
+	void *a = (void *)"aaaaaa";
+	void *b = (void *)"bbbbbb";
+	void *c = (void *)"cccccc";
+	RzThreadRing *ring = rz_th_ring_new(3, NULL);
+	mu_assert_notnull(ring, "rz_th_ring_new(3) null check");
+	mu_assert_eq(rz_th_ring_capacity(ring), 4, "capacity is rounded up to a power of 2");
+	mu_assert_true(rz_th_ring_is_empty(ring), "ring is empty");
+	mu_assert_null(rz_th_ring_pop(ring), "empty ring pops nothing");
+	mu_assert_true(rz_th_ring_push(ring, a), "ring pushed new element");
+	mu_assert_true(rz_th_ring_push(ring, b), "ring pushed new element");
+	mu_assert_true(rz_th_ring_push(ring, c), "ring pushed new element");
+	mu_assert_true(rz_th_ring_push(ring, a), "ring pushed new element");
+	mu_assert_true(rz_th_ring_is_full(ring), "ring is full");
+	mu_assert_false(rz_th_ring_push(ring, b), "ring cannot push a new element");
+	mu_assert_ptreq(rz_th_ring_pop(ring), a, "ring pops the oldest element");
+	mu_assert_ptreq(rz_th_ring_pop(ring), b, "ring pops the oldest element");
+	mu_assert_false(rz_th_ring_is_full(ring), "ring is not full");
+	mu_assert_false(rz_th_ring_is_empty(ring), "ring is not empty");
+	// wraps around
+	mu_assert_true(rz_th_ring_push(ring, b), "ring pushed new element");
+	mu_assert_ptreq(rz_th_ring_pop(ring), c, "ring pops the oldest element");
+	mu_assert_ptreq(rz_th_ring_pop(ring), a, "ring pops the oldest element");
+	mu_assert_ptreq(rz_th_ring_wait_pop(ring), b, "ring pops the oldest element");
+	mu_assert_true(rz_th_ring_is_empty(ring), "ring is empty");
+	rz_th_ring_free(ring);
+
+	// elements left in the ring are freed
+	ring = rz_th_ring_new(8, free);
+	mu_assert_true(rz_th_ring_push(ring, strdup("x")), "ring pushed new element");
+	mu_assert_true(rz_th_ring_push(ring, strdup("y")), "ring pushed new element");
+	rz_th_ring_free(ring);
+
+	// test wait pop
+	ring = rz_th_ring_new(8, NULL);
+	RzThread *th = rz_th_new((RzThreadFunction)thread_ring_push_timed, ring);
+	mu_assert_notnull(th, "rz_th_new(thread_ring_push_timed, ring) null check");
+	ut64 start = rz_time_now();
+	void *user = rz_th_ring_wait_pop(ring);
+	ut64 diff = rz_time_now() - start;
+	rz_th_wait(th);
+	mu_assert_ptreq(user, ring, "rz_th_ring_wait_pop(ring) is ring");
+	mu_assert_true(diff >= 1500000, "ring did wait for value.");
+	rz_th_free(th);
+	rz_th_ring_free(ring);
+	mu_end;
+}
+
+#define RING_THREADS 4
+#define RING_ITEMS   20000
+
+typedef struct {
+	RzThreadRing *ring;
+	size_t id;
+	ut64 sum;
+} RingThreadData;
+
+static void *thread_ring_producer(RingThreadData *data) {
+	for (size_t i = 0; i < RING_ITEMS; i++) {
+		// values are never 0, which would be a NULL pointer
+		size_t value = data->id * RING_ITEMS + i + 1;
+		while (!rz_th_ring_push(data->ring, (void *)value)) {
+			rz_th_yield();
+		}
+	}
+	return NULL;
+}
+
+static void *thread_ring_consumer(RingThreadData *data) {
+	for (size_t i = 0; i < RING_ITEMS; i++) {
+		data->sum += (size_t)rz_th_ring_wait_pop(data->ring);
+	}
+	return NULL;
+}
+
+bool test_thread_ring_mpmc(void) {
+	// a small ring, so producers often find it full
+	RzThreadRing *ring = rz_th_ring_new(16, NULL);
+	mu_assert_notnull(ring, "rz_th_ring_new(16) null check");
+	RingThreadData data[2 * RING_THREADS] = { 0 };
+	RzThread *threads[2 * RING_THREADS] = { 0 };
+	for (size_t i = 0; i < 2 * RING_THREADS; i++) {
+		data[i].ring = ring;
+		data[i].id = i;
+		RzThreadFunction fn = (RzThreadFunction)(i < RING_THREADS ? thread_ring_producer : thread_ring_consumer);
+		threads[i] = rz_th_new(fn, &data[i]);
+		mu_assert_notnull(threads[i], "rz_th_new null check");
+	}
+	ut64 sum = 0;
+	for (size_t i = 0; i < 2 * RING_THREADS; i++) {
+		rz_th_wait(threads[i]);
+		rz_th_free(threads[i]);
+		sum += data[i].sum;
+	}
+	ut64 n = RING_THREADS * RING_ITEMS;
+	mu_assert_eq(sum, n * (n + 1) / 2, "every pushed element is popped exactly once");
+	mu_assert_true(rz_th_ring_is_empty(ring), "ring is empty");
+	rz_th_ring_free(ring);
+	mu_end;
+}
+
+#define RWLOCK_THREADS 4
+#define RWLOCK_ROUNDS  1000
+
+typedef struct {
+	RzThreadRWLock *rwl;
+	size_t first; ///< always equal to second outside of the writers
+	size_t second;
+} RWLockData;
+
+static void *thread_rwlock_reader(RWLockData *data) {
+	bool consistent = true;
+	for (size_t i = 0; i < RWLOCK_ROUNDS; i++) {
+		rz_th_rwlock_read_enter(data->rwl);
+		size_t first = data->first;
+		rz_th_yield();
+		consistent &= first == data->second;
+		rz_th_rwlock_read_leave(data->rwl);
+	}
+	return consistent ? data : NULL;
+}
+
+static void *thread_rwlock_writer(RWLockData *data) {
+	for (size_t i = 0; i < RWLOCK_ROUNDS; i++) {
+		rz_th_rwlock_write_enter(data->rwl);
+		data->first++;
+		rz_th_yield();
+		data->second++;
+		rz_th_rwlock_write_leave(data->rwl);
+	}
+	return NULL;
+}
+
+static void *thread_rwlock_read_once(RWLockData *data) {
+	rz_th_rwlock_read_enter(data->rwl);
+	rz_th_rwlock_read_leave(data->rwl);
+	return data;
+}
+
+bool test_thread_rwlock(void) {
+	RWLockData data = { 0 };
+	data.rwl = rz_th_rwlock_new();
+	mu_assert_notnull(data.rwl, "rz_th_rwlock_new null check");
+
+	// readers don't exclude each other
+	rz_th_rwlock_read_enter(data.rwl);
+	RzThread *th = rz_th_new((RzThreadFunction)thread_rwlock_read_once, &data);
+	mu_assert_notnull(th, "rz_th_new null check");
+	rz_th_wait(th);
+	mu_assert_ptreq(rz_th_get_retv(th), &data, "second reader entered");
+	rz_th_free(th);
+	rz_th_rwlock_read_leave(data.rwl);
+
+	RzThread *threads[2 * RWLOCK_THREADS] = { 0 };
+	for (size_t i = 0; i < 2 * RWLOCK_THREADS; i++) {
+		RzThreadFunction fn = (RzThreadFunction)(i % 2 ? thread_rwlock_reader : thread_rwlock_writer);
+		threads[i] = rz_th_new(fn, &data);
+		mu_assert_notnull(threads[i], "rz_th_new null check");
+	}
+	bool consistent = true;
+	for (size_t i = 0; i < 2 * RWLOCK_THREADS; i++) {
+		rz_th_wait(threads[i]);
+		if (i % 2) {
+			consistent &= rz_th_get_retv(threads[i]) == &data;
+		}
+		rz_th_free(threads[i]);
+	}
+	mu_assert_eq(data.first, RWLOCK_THREADS * RWLOCK_ROUNDS, "every write is done");
+	mu_assert_eq(data.second, RWLOCK_THREADS * RWLOCK_ROUNDS, "every write is done");
+	mu_assert_true(consistent, "readers never see a write in progress");
+
+	// a writer leaving lets the waiting readers in
+	rz_th_rwlock_write_enter(data.rwl);
+	mu_assert_false(rz_th_rwlock_has_waiting_readers(data.rwl), "no reader is waiting");
+	th = rz_th_new((RzThreadFunction)thread_rwlock_read_once, &data);
+	mu_assert_notnull(th, "rz_th_new null check");
+	while (!rz_th_rwlock_has_waiting_readers(data.rwl)) {
+		rz_th_yield();
+	}
+	rz_th_rwlock_write_leave(data.rwl);
+	rz_th_rwlock_write_enter(data.rwl);
+	rz_th_rwlock_write_leave(data.rwl);
+	rz_th_wait(th);
+	mu_assert_ptreq(rz_th_get_retv(th), &data, "waiting reader entered");
+	rz_th_free(th);
+
+	rz_th_rwlock_free(data.rwl);
+	mu_end;
+}
+
+static void *task_square(size_t *value) {
+	*value *= *value;
+	return value;
+}
+
+static void *task_nested(RzThreadTaskPool *pool) {
+	// waiting from a worker must run the subtask instead of deadlocking
+	size_t value = 7;
+	RzThreadFuture *future = rz_th_task_pool_submit(pool, (RzThreadFunction)task_square, &value);
+	if (!future) {
+		return NULL;
+	}
+	rz_th_future_wait(pool, future);
+	rz_th_future_free(future);
+	return value == 49 ? pool : NULL;
+}
+
+static void range_fill(size_t from, size_t to, size_t *values) {
+	for (size_t i = from; i < to; i++) {
+		values[i] = i * 2;
+	}
+}
+
+static bool task_always_breaked(void *user) {
+	return true;
+}
+
+bool test_thread_task_pool(void) {
+	RzThreadTaskPool *pool = rz_th_task_pool_new(4);
+	mu_assert_notnull(pool, "rz_th_task_pool_new(4) null check");
+	mu_assert_true(rz_th_task_pool_size(pool) >= 1, "pool has at least one worker");
+
+	size_t values[64];
+	RzThreadFuture *futures[64];
+	for (size_t i = 0; i < 64; i++) {
+		values[i] = i;
+		futures[i] = rz_th_task_pool_submit(pool, (RzThreadFunction)task_square, &values[i]);
+		mu_assert_notnull(futures[i], "rz_th_task_pool_submit null check");
+	}
+	for (size_t i = 0; i < 64; i++) {
+		mu_assert_ptreq(rz_th_future_wait(pool, futures[i]), &values[i], "future returns the task value");
+		mu_assert_true(rz_th_future_is_done(futures[i]), "future is done");
+		mu_assert_false(rz_th_future_is_cancelled(futures[i]), "future is not cancelled");
+		mu_assert_eq(values[i], i * i, "task has been run once");
+		rz_th_future_free(futures[i]);
+	}
+
+	RzThreadFuture *future = rz_th_task_pool_submit(pool, (RzThreadFunction)task_nested, pool);
+	mu_assert_ptreq(rz_th_future_wait(pool, future), pool, "nested task has been run");
+	rz_th_future_free(future);
+
+	size_t filled[1000] = { 0 };
+	mu_assert_true(rz_th_task_pool_parallel_for(pool, 0, 1000, 0, (RzThreadRangeFunction)range_fill, filled), "parallel_for succeeded");
+	bool all = true;
+	for (size_t i = 0; i < 1000; i++) {
+		all &= filled[i] == i * 2;
+	}
+	mu_assert_true(all, "parallel_for processed every index");
+	mu_assert_true(rz_th_task_pool_parallel_for(pool, 10, 10, 0, (RzThreadRangeFunction)range_fill, filled), "empty range succeeded");
+
+	rz_th_task_pool_set_break_callback(pool, task_always_breaked, NULL);
+	mu_assert_true(rz_th_task_pool_is_breaked(pool), "pool is breaked");
+	values[0] = 3;
+	future = rz_th_task_pool_submit(pool, (RzThreadFunction)task_square, &values[0]);
+	mu_assert_null(rz_th_future_wait(pool, future), "cancelled future returns NULL");
+	mu_assert_true(rz_th_future_is_cancelled(future), "future is cancelled");
+	mu_assert_eq(values[0], 3, "cancelled task has not been run");
+	rz_th_future_free(future);
+	mu_assert_false(rz_th_task_pool_parallel_for(pool, 0, 1000, 10, (RzThreadRangeFunction)range_fill, filled), "breaked parallel_for fails");
+	rz_th_task_pool_set_break_callback(pool, NULL, NULL);
+	mu_assert_false(rz_th_task_pool_is_breaked(pool), "pool is not breaked");
+
+	rz_th_task_pool_free(pool);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_thread_pool_cores);
 	mu_run_test(test_thread_queue);
+	mu_run_test(test_thread_ring);
+	mu_run_test(test_thread_ring_mpmc);
+	mu_run_test(test_thread_rwlock);
+	mu_run_test(test_thread_task_pool);
 	return tests_passed != tests_run;
 }
 
@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include "minunit.h"
+
+static bool test_tracing_disabled(void) {
+	rz_tracing_reset();
+	mu_assert_false(rz_tracing_is_enabled(), "disabled by default");
+	RZ_TRACE_BEGIN("test", "nothing");
+	RZ_TRACE_END("test");
+	mu_assert_eq(rz_tracing_count(), 0, "nothing recorded while disabled");
+	mu_end;
+}
+
+static bool test_tracing_json(void) {
+	rz_tracing_reset();
+	rz_tracing_enable(true);
+	RZ_TRACE_BEGIN("cmd", "pd 1");
+	RZ_TRACE_BEGIN("io", "read \"x\"");
+	RZ_TRACE_END("io");
+	RZ_TRACE_END("cmd");
+	rz_tracing_enable(false);
+	RZ_TRACE_BEGIN("cmd", "dropped");
+	mu_assert_eq(rz_tracing_count(), 4, "recorded events");
+
+	char *json = rz_tracing_to_json();
+	mu_assert_notnull(json, "json");
+	RzJson *j = rz_json_parse(json);
+	mu_assert_notnull(j, "valid json");
+	const RzJson *events = rz_json_get(j, "traceEvents");
+	mu_assert_notnull(events, "traceEvents");
+	mu_assert_eq(events->children.count, 4, "events");
+	const RzJson *e = rz_json_item(events, 1);
+	mu_assert_streq(rz_json_get(e, "name")->str_value, "read \"x\"", "name");
+	mu_assert_streq(rz_json_get(e, "cat")->str_value, "io", "cat");
+	mu_assert_streq(rz_json_get(e, "ph")->str_value, "B", "begin");
+	e = rz_json_item(events, 3);
+	mu_assert_null(rz_json_get(e, "name"), "end has no name");
+	mu_assert_streq(rz_json_get(e, "ph")->str_value, "E", "end");
+	ut64 ts0 = rz_json_get(rz_json_item(events, 0), "ts")->num.u_value;
+	ut64 ts3 = rz_json_get(e, "ts")->num.u_value;
+	mu_assert_true(ts0 <= ts3, "monotonic timestamps");
+	mu_assert_eq(rz_json_get(rz_json_item(events, 0), "tid")->num.u_value, rz_json_get(e, "tid")->num.u_value, "same thread");
+	rz_json_free(j);
+	free(json);
+
+	rz_tracing_reset();
+	mu_assert_eq(rz_tracing_count(), 0, "reset");
+	mu_end;
+}
+
+static int all_tests(void) {
+	mu_run_test(test_tracing_disabled);
+	mu_run_test(test_tracing_json);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)